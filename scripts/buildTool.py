@@ -442,7 +442,8 @@ def installDependencies():
                                                 'qttools5-dev',
                                                 'qttools5-dev-tools',
                                                 'rpm',
-                                                'rpmlint']
+                                                'rpmlint',
+                                                'zlib1g-dev']
             )
          )
 
@@ -795,6 +796,7 @@ def installDependencies():
                         'mingw-w64-' + arch + '-toolchain',
                         'mingw-w64-' + arch + '-xalan-c',
                         'mingw-w64-' + arch + '-xerces-c',
+                        'mingw-w64-' + arch + '-zlib',
                         'mingw-w64-' + arch + '-angleproject'] # See comment above
          for packageToInstall in installList:
             log.debug('Installing ' + packageToInstall)
@@ -18,7 +18,9 @@
 #include "Algorithms.h"
 
 #include <algorithm> // Of course we stand on the shoulders of the standard library, rather than reinvent the wheel
+#include <array>
 #include <cmath>
+#include <optional>
 
 #include <QDebug>
 #include <QVector>
@@ -53,6 +55,11 @@ namespace {
       Polynomial() << -616.868 << 1111.14 << -630.272 << 135.997
    };
 
+   //! The same cubic as \c platoFromSG_20C20C, but evaluated by Horner's method, and without the overhead of a vector
+   constexpr double platoFromSg(double const sg) {
+      return ((135.997 * sg - 630.272) * sg + 1111.14) * sg - 616.868;
+   }
+
    // Water density polynomial, given in kg/L as a function of degrees C.
    // 1.80544064e-8*x^3 - 6.268385468e-6*x^2 + 3.113930471e-5*x + 0.999924134
    Polynomial const waterDensityPoly_C {
@@ -176,6 +183,173 @@ namespace {
       return positionInRange * (getTo(*firstLarger) - getTo(*lastSmaller)) + getTo(*lastSmaller);
    }
 
+   /**
+    * \brief Converts Plato to SG.  Table steps are 0.05 °P, at which the interpolation error is less than 1e-8, ie well
+    *        inside \c ROOT_PRECISION.
+    */
+   PolynomialInverse const & sgFromPlato() {
+      static PolynomialInverse const inverse{
+         platoFromSG_20C20C,
+         minPlausibleSpecificGravity,
+         maxPlausibleSpecificGravity,
+         static_cast<int>((platoFromSg(maxPlausibleSpecificGravity) - platoFromSg(minPlausibleSpecificGravity)) / 0.05)
+      };
+      return inverse;
+   }
+
+   /**
+    * \brief In \c Algorithms::ogFgToPlato, we need to solve
+    *           fg = sgFromStartingPlato + 0.00574*cp + 0.00003344*cp^2 + 0.000000086*cp^3
+    *        for the current Plato, cp.  So this is the inverse of the part that depends on cp, over a range (in steps
+    *        of 0.05 °P) that covers anything we'd see in practice.  (Its derivative is always positive, so it is
+    *        strictly increasing.)
+    */
+   PolynomialInverse const & currentPlatoFromGravityContribution() {
+      static PolynomialInverse const inverse{Polynomial() << 0.0 << 0.00574 << 0.00003344 << 0.000000086,
+                                             -10.0,
+                                             40.0,
+                                             1000};
+      return inverse;
+   }
+
+   /**
+    * \brief Constant-time version of the look-up that \c interpolatedConversion does (by binary search) on one column
+    *        of \c Measurement::sucroseConversions.
+    *
+    *        We divide the range of the column into equal buckets, each narrower than the smallest gap between rows,
+    *        and remember, for each bucket, the last row at or below the start of the bucket.  For a value in the
+    *        bucket, the rows either side of it are then that row and the next, or the next and the one after.  Either
+    *        way, we interpolate between the same two rows as \c interpolatedConversion does, so get the same answer.
+    */
+   class SucroseColumnIndex {
+   public:
+      using Column = double Measurement::SucroseConversion::*;
+
+      SucroseColumnIndex(Column const fromColumn) :
+         m_fromColumn {fromColumn},
+         m_min        {Measurement::sucroseConversions[0].*fromColumn},
+         m_max        {Measurement::sucroseConversions[Measurement::sucroseConversions_size - 1].*fromColumn},
+         m_bucketWidth{0.0},
+         m_lowerRows  {} {
+         auto const & rows = Measurement::sucroseConversions;
+         double smallestGap = this->m_max - this->m_min;
+         for (size_t row = 1; row < Measurement::sucroseConversions_size; ++row) {
+            smallestGap = std::min(smallestGap, rows[row].*fromColumn - rows[row - 1].*fromColumn);
+         }
+         // It's a coding error if the table isn't strictly increasing in this column
+         Q_ASSERT(smallestGap > 0.0);
+         this->m_bucketWidth = smallestGap / 2.0;
+
+         size_t const numBuckets = static_cast<size_t>((this->m_max - this->m_min) / this->m_bucketWidth) + 1;
+         this->m_lowerRows.reserve(numBuckets);
+         size_t row = 0;
+         for (size_t bucket = 0; bucket < numBuckets; ++bucket) {
+            double const bucketStart = this->m_min + bucket * this->m_bucketWidth;
+            while (row + 1 < Measurement::sucroseConversions_size && rows[row + 1].*fromColumn <= bucketStart) {
+               ++row;
+            }
+            this->m_lowerRows.push_back(row);
+         }
+         return;
+      }
+
+      /**
+       * \return The value of \c toColumn interpolated for \c value of the "from" column, or \c std::nullopt if
+       *         \c value is outside the range of the table (in which case the caller should fall back to
+       *         \c interpolatedConversion, which knows what to do).
+       */
+      std::optional<double> convert(double const value, Column const toColumn) const {
+         if (!(value >= this->m_min && value < this->m_max)) {
+            return std::nullopt;
+         }
+         auto const & rows = Measurement::sucroseConversions;
+         size_t const bucket = std::min(static_cast<size_t>((value - this->m_min) / this->m_bucketWidth),
+                                        this->m_lowerRows.size() - 1);
+         size_t row = this->m_lowerRows[bucket];
+         // Because value < m_max, the loop stops at the last row at the latest, so row + 1 is always valid.  The first
+         // loop is just to be safe against rounding in the bucket calculation.
+         while (row > 0 && rows[row].*this->m_fromColumn > value) {
+            --row;
+         }
+         while (rows[row + 1].*this->m_fromColumn <= value) {
+            ++row;
+         }
+         auto const & lower = rows[row];
+         auto const & upper = rows[row + 1];
+         double const positionInRange =
+            (value - lower.*this->m_fromColumn) / (upper.*this->m_fromColumn - lower.*this->m_fromColumn);
+         return positionInRange * (upper.*toColumn - lower.*toColumn) + lower.*toColumn;
+      }
+
+   private:
+      Column const m_fromColumn;
+      double const m_min;
+      double const m_max;
+      double m_bucketWidth;
+      std::vector<size_t> m_lowerRows;
+   };
+
+   SucroseColumnIndex const & sgColumnIndex() {
+      static SucroseColumnIndex const index{&Measurement::SucroseConversion::apparentSgAt2020C};
+      return index;
+   }
+
+   SucroseColumnIndex const & brixColumnIndex() {
+      static SucroseColumnIndex const index{&Measurement::SucroseConversion::degreesBrix};
+      return index;
+   }
+
+   template<typename Conversion>
+   void convertAll(std::span<double const> input, std::span<double> output, Conversion conversion) {
+      Q_ASSERT(input.size() == output.size());
+      for (size_t ii = 0; ii < input.size(); ++ii) {
+         output[ii] = conversion(input[ii]);
+      }
+      return;
+   }
+
+   /**
+    * \brief Philip Lee's approximation of beer color from a color swatch and curve fitting.  Use \c srmPalette rather
+    *        than calling this directly.
+    */
+   constexpr QRgb srmToRgb(double const srm) {
+      //==========My approximation from a photo and spreadsheet===========
+      //double red = 232.9 * pow( (double)0.93, srm );
+      //double green = (double)-106.25 * log(srm) + 280.9;
+      //
+      //int r = (int)Algorithms::round(red);
+      //int g = (int)Algorithms::round(green);
+      //int b = 0;
+
+      int r = 0.5 + (272.098 - 5.80255*srm); if( r > 253.0 ) r = 253.0;
+      int g = (srm > 35)? 0 : 0.5 + (2.41975e2 - 1.3314e1*srm + 1.881895e-1*srm*srm);
+      int b = 0.5 + (179.3 - 28.7*srm);
+
+      return qRgb(std::clamp(r, 0, 255), std::clamp(g, 0, 255), std::clamp(b, 0, 255));
+   }
+
+   //
+   // Beer colors get drawn a lot (eg every recalculation of a recipe sets its color), so we look them up in a table,
+   // worked out at compile time, at 0.1 SRM intervals.  Above about 47 SRM, everything is black, so we only need to go
+   // up to 50 SRM.
+   //
+   constexpr double srmPaletteStep = 0.1;
+   constexpr std::size_t srmPaletteSize = 501;
+   constexpr double srmPaletteMax = srmPaletteStep * (srmPaletteSize - 1);
+
+   constexpr std::array<QRgb, srmPaletteSize> srmPalette = [] {
+      std::array<QRgb, srmPaletteSize> palette{};
+      for (std::size_t ii = 0; ii < srmPaletteSize; ++ii) {
+         palette[ii] = srmToRgb(static_cast<double>(ii) * srmPaletteStep);
+      }
+      return palette;
+   }();
+
+   //! Linear interpolation between two color channel values
+   int interpolateChannel(int const lower, int const upper, double const fraction) {
+      return static_cast<int>(0.5 + lower + fraction * (upper - lower));
+   }
+
 }
 
 Polynomial::Polynomial() :
@@ -218,26 +392,28 @@ double & Polynomial::operator[] (size_t n) {
 }
 
 double Polynomial::eval(double x) const {
+   // Horner's method
    double ret = 0.0;
-
-   for(size_t i = order(); i > 0; --i) {
-      ret += m_coeffs[i] * intPow( x, i );
+   for (auto coeff = m_coeffs.crbegin(); coeff != m_coeffs.crend(); ++coeff) {
+      ret = ret * x + *coeff;
    }
-   ret += m_coeffs[0];
-
    return ret;
 }
 
 double Polynomial::rootFind( double x0, double x1 ) const {
    double guesses[] = { x0, x1 };
+   // Values of the polynomial at the guesses, so we only need one new evaluation per iteration
+   double values[] = { eval(x0), eval(x1) };
    double newGuess = x0;
    double maxAllowableSeparation = qAbs( x0 - x1 ) * 1e3;
 
    while( qAbs( guesses[0] - guesses[1] ) > ROOT_PRECISION ) {
-      newGuess = guesses[1] - (guesses[1] - guesses[0]) * eval(guesses[1]) / ( eval(guesses[1]) - eval(guesses[0]) );
+      newGuess = guesses[1] - (guesses[1] - guesses[0]) * values[1] / ( values[1] - values[0] );
 
       guesses[0] = guesses[1];
       guesses[1] = newGuess;
+      values[0] = values[1];
+      values[1] = eval(newGuess);
 
       if( qAbs( guesses[0] - guesses[1] ) > maxAllowableSeparation ) {
          return HUGE_VAL;
@@ -247,6 +423,60 @@ double Polynomial::rootFind( double x0, double x1 ) const {
    return newGuess;
 }
 
+PolynomialInverse::PolynomialInverse(Polynomial const & polynomial,
+                                     double const xMin,
+                                     double const xMax,
+                                     int const numSteps) :
+   m_polynomial{polynomial},
+   m_xMin      {xMin},
+   m_xMax      {xMax},
+   m_yMin      {polynomial.eval(xMin)},
+   // If the polynomial is decreasing, this will be negative, which is fine
+   m_yStep     {(polynomial.eval(xMax) - polynomial.eval(xMin)) / numSteps},
+   m_numSteps  {numSteps},
+   m_x         {} {
+   Q_ASSERT(numSteps > 0);
+   Q_ASSERT(this->m_yStep != 0.0);
+   this->m_x.reserve(numSteps + 1);
+   for (int ii = 0; ii <= numSteps; ++ii) {
+      Polynomial shifted{polynomial};
+      shifted[0] -= this->m_yMin + ii * this->m_yStep;
+      this->m_x.push_back(shifted.rootFind(xMin, xMax));
+      // If the root finding failed, the polynomial probably isn't monotonic over the range, which is a coding error
+      Q_ASSERT(std::isfinite(this->m_x.back()));
+   }
+   return;
+}
+
+std::optional<double> PolynomialInverse::lookUp(double const y) const {
+   double const position = (y - this->m_yMin) / this->m_yStep;
+   // Written this way round so that NaN is also treated as out of range
+   if (!(position >= 0.0 && position < this->m_numSteps)) {
+      return std::nullopt;
+   }
+   int const index = static_cast<int>(position);
+   double const fraction = position - index;
+   return this->m_x[index] + fraction * (this->m_x[index + 1] - this->m_x[index]);
+}
+
+double PolynomialInverse::operator()(double const y) const {
+   std::optional<double> const x = this->lookUp(y);
+   if (x) {
+      return *x;
+   }
+   Polynomial shifted{this->m_polynomial};
+   shifted[0] -= y;
+   return shifted.rootFind(this->m_xMin, this->m_xMax);
+}
+
+void PolynomialInverse::operator()(std::span<double const> y, std::span<double> x) const {
+   Q_ASSERT(y.size() == x.size());
+   for (size_t ii = 0; ii < y.size(); ++ii) {
+      x[ii] = (*this)(y[ii]);
+   }
+   return;
+}
+
 //╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
 
 bool Algorithms::isNan(double d) {
@@ -267,41 +497,28 @@ double Algorithms::hydrometer15CCorrection( double celsius )
 }
 
 QColor Algorithms::srmToColor(double srm) {
-   QColor ret;
-
-   //==========My approximation from a photo and spreadsheet===========
-   //double red = 232.9 * pow( (double)0.93, srm );
-   //double green = (double)-106.25 * log(srm) + 280.9;
-   //
-   //int r = (int)Algorithms::round(red);
-   //int g = (int)Algorithms::round(green);
-   //int b = 0;
-
-   // Philip Lee's approximation from a color swatch and curve fitting.
-   int r = 0.5 + (272.098 - 5.80255*srm); if( r > 253.0 ) r = 253.0;
-   int g = (srm > 35)? 0 : 0.5 + (2.41975e2 - 1.3314e1*srm + 1.881895e-1*srm*srm);
-   int b = 0.5 + (179.3 - 28.7*srm);
-
-   r = (r < 0) ? 0 : ((r > 255)? 255 : r);
-   g = (g < 0) ? 0 : ((g > 255)? 255 : g);
-   b = (b < 0) ? 0 : ((b > 255)? 255 : b);
-   ret.setRgb( r, g, b );
+   // Note that this test is written so that NaN also goes to the slow path
+   if (!(srm >= 0.0 && srm < srmPaletteMax)) {
+      return QColor{srmToRgb(srm)};
+   }
 
-   return ret;
+   double const position = srm / srmPaletteStep;
+   // Rounding in the division could just about give us the last entry, so make sure there is always one above
+   std::size_t const index = std::min(static_cast<std::size_t>(position), srmPaletteSize - 2);
+   double const fraction = position - static_cast<double>(index);
+   QRgb const lower = srmPalette[index];
+   QRgb const upper = srmPalette[index + 1];
+   return QColor{interpolateChannel(qRed  (lower), qRed  (upper), fraction),
+                 interpolateChannel(qGreen(lower), qGreen(upper), fraction),
+                 interpolateChannel(qBlue (lower), qBlue (upper), fraction)};
 }
 
 double Algorithms::SG_20C20C_toPlato(double sg) {
-   return platoFromSG_20C20C.eval(sg);
+   return platoFromSg(sg);
 }
 
 double Algorithms::PlatoToSG_20C20C(double plato) {
-   // Copy the polynomial, cuz we need to alter it.
-   Polynomial poly(platoFromSG_20C20C);
-
-   // After this, finding the root of the polynomial will be finding the SG.
-   poly[0] -= plato;
-
-   return poly.rootFind(minPlausibleSpecificGravity, maxPlausibleSpecificGravity);
+   return sgFromPlato()(plato);
 }
 
 double Algorithms::SgAt20CToBrix(double sg) {
@@ -347,6 +564,12 @@ double Algorithms::SgAt20CToBrix(double sg) {
    // The advantage of using std::lower_bound over std::find_if is that, provided you give it random-access iterators,
    // the former does O(log N) binary search rather than O(N) linear search.
    //
+   // Usually sgColumnIndex does this in constant time, but it leaves the edge cases to interpolatedConversion
+   std::optional<double> const brix = sgColumnIndex().convert(sg, &Measurement::SucroseConversion::degreesBrix);
+   if (brix) {
+      return *brix;
+   }
+
    Measurement::SucroseConversion const searchingFor{0, 0, sg};
    return interpolatedConversion(
       &Measurement::sucroseConversions[0],
@@ -392,6 +615,11 @@ double Algorithms::BrixToSgAt20C(double brix) {
    //
    // However, instead, we use the same approach as in SgAt20CToBrix of interpolating the USDA observed data.
    //
+   std::optional<double> const sg = brixColumnIndex().convert(brix, &Measurement::SucroseConversion::apparentSgAt2020C);
+   if (sg) {
+      return *sg;
+   }
+
    Measurement::SucroseConversion const searchingFor{0, brix, 0};
 
    return interpolatedConversion(
@@ -407,6 +635,26 @@ double Algorithms::BrixToSgAt20C(double brix) {
 
 }
 
+void Algorithms::SG_20C20C_toPlato(std::span<double const> input, std::span<double> output) {
+   convertAll(input, output, [](double const sg) { return platoFromSg(sg); });
+   return;
+}
+
+void Algorithms::PlatoToSG_20C20C(std::span<double const> input, std::span<double> output) {
+   sgFromPlato()(input, output);
+   return;
+}
+
+void Algorithms::SgAt20CToBrix(std::span<double const> input, std::span<double> output) {
+   convertAll(input, output, [](double const sg) { return Algorithms::SgAt20CToBrix(sg); });
+   return;
+}
+
+void Algorithms::BrixToSgAt20C(std::span<double const> input, std::span<double> output) {
+   convertAll(input, output, [](double const brix) { return Algorithms::BrixToSgAt20C(brix); });
+   return;
+}
+
 double Algorithms::getPlato(double sugar_kg, double wort_l) {
    double water_kg = wort_l - sugar_kg/PhysicalConstants::sucroseDensity_kgL; // Assumes sucrose vol and water vol add to wort vol.
 
@@ -451,9 +699,15 @@ double Algorithms::sgByStartingPlato(double startingPlato, double currentPlato)
 double Algorithms::ogFgToPlato(double og, double fg) {
    double sp = SG_20C20C_toPlato( og );
 
+   double const sgFromStartingPlato = 1.001843 - 0.002318474*sp - 0.000007775*sp*sp - 0.000000034*sp*sp*sp;
+   std::optional<double> const currentPlato = currentPlatoFromGravityContribution().lookUp(fg - sgFromStartingPlato);
+   if (currentPlato) {
+      return *currentPlato;
+   }
+
    Polynomial poly(
       Polynomial()
-         << 1.001843 - 0.002318474*sp - 0.000007775*sp*sp - 0.000000034*sp*sp*sp - fg
+         << sgFromStartingPlato - fg
          << 0.00574 << 0.00003344 << 0.000000086
    );
 
@@ -463,7 +717,7 @@ double Algorithms::ogFgToPlato(double og, double fg) {
 double Algorithms::refractiveIndex(double plato) {
    // Implements the method found at:
    // http://primetab.com/formulas.html
-   return 1.33302 + 0.001427193*plato + 0.000005791157*plato*plato;
+   return 1.33302 + (0.001427193 + 0.000005791157*plato)*plato;
 }
 
 double Algorithms::realExtract(double sg, double plato) {
@@ -22,6 +22,8 @@
 
 #include <cmath>
 #include <limits> // For std::numeric_limits
+#include <optional>
+#include <span>
 #include <string.h>
 #include <vector>
 
@@ -78,6 +80,46 @@ private:
    std::vector<double> m_coeffs;
 };
 
+/*!
+ * \brief The inverse of a \c Polynomial that is strictly monotonic over some range, for when we need to invert it a
+ *        lot (eg converting Plato to SG).
+ *
+ *        On construction, we find (with \c Polynomial::rootFind) the x values for evenly-spaced y values covering the
+ *        range.  After that, inverting is just a linear interpolation in that table.  For y values outside the table,
+ *        we fall back to \c Polynomial::rootFind.
+ */
+class PolynomialInverse {
+public:
+   /**
+    * \param polynomial The polynomial to invert.  Must be strictly monotonic between \c xMin and \c xMax.
+    * \param xMin
+    * \param xMax
+    * \param numSteps Number of intervals in the table.  Interpolation error goes down with the square of this.
+    */
+   PolynomialInverse(Polynomial const & polynomial, double const xMin, double const xMax, int const numSteps);
+
+   /**
+    * \return x such that \c polynomial(x) is \c y, or \c std::nullopt if \c y is outside the table.  (This is for
+    *         callers who want their own fallback.)
+    */
+   std::optional<double> lookUp(double const y) const;
+
+   //! \return x such that \c polynomial(x) is \c y, or \c HUGE_VAL if \c Polynomial::rootFind fails
+   double operator()(double const y) const;
+
+   //! \brief Batch version of the above.  \c y and \c x must be the same size (and may be the same array).
+   void operator()(std::span<double const> y, std::span<double> x) const;
+
+private:
+   Polynomial const m_polynomial;
+   double const m_xMin;
+   double const m_xMax;
+   double const m_yMin;
+   double const m_yStep;
+   int const m_numSteps;
+   std::vector<double> m_x;
+};
+
 /*!
  * \namespace Algorithms
  *
@@ -117,6 +159,15 @@ namespace Algorithms {
    //! \brief Convert Brix to Specific Gravity (measured at 20°C)
    double BrixToSgAt20C(double brix);
 
+   /**
+    * \brief Batch versions of the above four conversions, for when we have a lot of gravities to convert.  \c input and
+    *        \c output must be the same size (and may be the same array).
+    */
+   void SG_20C20C_toPlato(std::span<double const> input, std::span<double> output);
+   void PlatoToSG_20C20C (std::span<double const> input, std::span<double> output);
+   void SgAt20CToBrix    (std::span<double const> input, std::span<double> output);
+   void BrixToSgAt20C    (std::span<double const> input, std::span<double> output);
+
    //! \returns water density in kg/L at temperature \b celsius
    double getWaterDensity_kgL( double celsius );
    //! \returns additive correction to the 15C hydrometer reading if read at \b celsius
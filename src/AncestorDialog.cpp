@@ -36,6 +36,7 @@
 #include "MainWindow.h"
 #include "model/NamedEntity.h"
 #include "model/Recipe.h"
+#include "RecipeDiff.h"
 
 AncestorDialog::AncestorDialog(QWidget * parent) : QDialog(parent) {
 
@@ -126,9 +127,30 @@ void AncestorDialog::connectDescendant() {
    return;
 }
 
+void AncestorDialog::showChanges(Recipe const & recipe) {
+   QString html;
+   Recipe const * later = &recipe;
+   for (Recipe const * earlier : recipe.ancestors()) {
+      html += QString("<h3>%1</h3>").arg(
+         tr("From \"%1\" (#%2) to \"%3\" (#%4)").arg(earlier->name())
+                                                .arg(earlier->key())
+                                                .arg(later->name())
+                                                .arg(later->key()).toHtmlEscaped()
+      );
+      html += RecipeDiff::toHtml(RecipeDiff::diff(*earlier, *later));
+      later = earlier;
+   }
+   if (html.isEmpty()) {
+      html = QString("<p>%1</p>").arg(tr("%1 has no earlier versions").arg(recipe.name()).toHtmlEscaped());
+   }
+   textBrowser_changes->setHtml(html);
+   return;
+}
+
 void AncestorDialog::setAncestor(Recipe * anc) {
    comboBox_ancestor->setCurrentText(anc->name());
    buildDescendantBox(anc);
+   this->showChanges(*anc);
 
    comboBox_descendant->setEnabled(true);
    activateButton();
@@ -140,6 +162,7 @@ void AncestorDialog::ancestorSelected([[maybe_unused]] int ndx) {
    comboBox_descendant->setEnabled(true);
 
    buildDescendantBox(ancestor);
+   this->showChanges(*ancestor);
 
    activateButton();
    return;
@@ -58,6 +58,8 @@ private:
 
    void buildAncestorBox();
    void buildDescendantBox(Recipe * ignore);
+   //! \brief Show, for \c recipe and each of its ancestors, what changed from the version before (see \c RecipeDiff)
+   void showChanges(Recipe const & recipe);
    static bool recipeLessThan(Recipe * right, Recipe * left);
 };
 
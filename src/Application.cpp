@@ -54,6 +54,8 @@
 #include "BtSplashScreen.h"
 #include "config.h"
 #include "database/Database.h"
+#include "database/ObjectStoreTyped.h"
+#include "database/SensorReadings.h"
 #include "Localization.h"
 #include "MainWindow.h"
 #include "measurement/ColorMethods.h"
@@ -71,6 +73,7 @@
 #include "model/Water.h"
 #include "model/Yeast.h"
 #include "PersistentSettings.h"
+#include "utils/Diagnostics.h"
 
 // Needed for kill(2)
 #if defined(Q_OS_UNIX)
@@ -427,7 +430,10 @@ bool Application::initialize() {
    // Make sure all the necessary directories and files we need exist before starting.
    ensureDirectoriesExist();
 
-   Application::readSystemOptions();
+   {
+      Diagnostics::ScopedStartupPhaseTimer phaseTimer{"Read system options"};
+      Application::readSystemOptions();
+   }
 
    Localization::loadTranslations(); // Do internationalization.
 
@@ -458,7 +464,10 @@ void Application::cleanup() {
    // Should I do qApp->removeTranslator() first?
    MainWindow::DeleteMainWindow();
 
+   // The snapshot has to be read from the DB before we close it, but its marker can only be worked out afterwards
+   QByteArray const objectStoreSnapshot = MakeObjectStoreSnapshot();
    Database::instance().unload();
+   SaveObjectStoreSnapshot(objectStoreSnapshot);
    return;
 }
 
@@ -477,19 +486,36 @@ int Application::run() {
    BtSplashScreen splashScreen;
    splashScreen.show();
    qApp->processEvents();
+   Diagnostics::setStartupPhaseListener(
+      [&splashScreen](char const * phaseName) { splashScreen.showPhase(phaseName); return; }
+   );
    if (!Application::initialize()) {
+      Diagnostics::setStartupPhaseListener({});
       cleanup();
       return 1;
    }
-   Database::instance().checkForNewDefaultData();
+   {
+      Diagnostics::ScopedStartupPhaseTimer phaseTimer{"Check for new default data"};
+      Database::instance().checkForNewDefaultData();
+   }
 
    // .:TBD:. Could maybe move the calls to init and setVisible inside createMainWindowInstance() in MainWindow.cpp
-   MainWindow & mainWindow = MainWindow::instance();
-   mainWindow.init();
-   mainWindow.setVisible(true);
-   splashScreen.finish(&mainWindow);
+   MainWindow * mainWindow = nullptr;
+   {
+      Diagnostics::ScopedStartupPhaseTimer phaseTimer{"Create main window"};
+      mainWindow = &MainWindow::instance();
+   }
+   {
+      Diagnostics::ScopedStartupPhaseTimer phaseTimer{"Initialise main window"};
+      mainWindow->init();
+   }
+   mainWindow->setVisible(true);
+   Diagnostics::setStartupPhaseListener({});
+   splashScreen.finish(mainWindow);
+   qInfo().noquote() << Diagnostics::startupSummary();
 
-   initiateCheckForNewVersion(&mainWindow);
+   initiateCheckForNewVersion(mainWindow);
+   SensorReadings::startListening();
    do {
       ret = qApp->exec();
    } while (ret == 1000);
@@ -513,6 +539,7 @@ void Application::readSystemOptions() {
 
    //===================IBU===================
    IbuMethods::loadIbuFormula();
+   IbuMethods::loadHopAdjustments();
 
    //========================Color Formula======================
    ColorMethods::loadColorFormulaSettings();
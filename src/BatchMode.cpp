@@ -0,0 +1,246 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * BatchMode.cpp is part of Brewtarget, and is copyright the following authors 2024:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#include "BatchMode.h"
+
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QList>
+#include <QPair>
+#include <QTextStream>
+#include <QVector>
+
+#include "Application.h"
+#include "database/Database.h"
+#include "database/ObjectStoreTyped.h"
+#include "database/ObjectStoreWrapper.h"
+#include "database/SearchIndex.h"
+#include "database/SyntheticData.h"
+#include "Logging.h"
+#include "model/Recipe.h"
+#include "serialization/ImportExport.h"
+#include "utils/Diagnostics.h"
+
+namespace {
+   /**
+    * \brief Times the steps of a batch run, so we can report on them at the end
+    */
+   class StepTimer {
+   public:
+      StepTimer() : m_timer{}, m_timings{} {
+         return;
+      }
+
+      /**
+       * \brief Do \c step (which returns \c true if it succeeded), timing how long it takes
+       */
+      template<class Functor>
+      bool time(QString const & stepName, Functor && step) {
+         qInfo() << Q_FUNC_INFO << "Starting" << stepName;
+         this->m_timer.start();
+         bool const succeeded = step();
+         qint64 const elapsed_ms = this->m_timer.elapsed();
+         qInfo() << Q_FUNC_INFO << stepName << (succeeded ? "succeeded" : "FAILED") << "in" << elapsed_ms << "ms";
+         this->m_timings.append(qMakePair(stepName, elapsed_ms));
+         return succeeded;
+      }
+
+      void writeTo(QTextStream & out) const {
+         qint64 total_ms = 0;
+         out << "Timings (ms):" << Qt::endl;
+         for (auto const & [stepName, elapsed_ms] : this->m_timings) {
+            out << "   " << qSetFieldWidth(10) << Qt::right << elapsed_ms << qSetFieldWidth(0) << Qt::left << "  " <<
+                   stepName << Qt::endl;
+            total_ms += elapsed_ms;
+         }
+         out << "   " << qSetFieldWidth(10) << Qt::right << total_ms << qSetFieldWidth(0) << Qt::left << "  " <<
+                "Total" << Qt::endl;
+         return;
+      }
+
+   private:
+      QElapsedTimer m_timer;
+      QVector<QPair<QString, qint64>> m_timings;
+   };
+
+   bool generateSyntheticData(int const numRecipes, quint32 const seed, QTextStream & out) {
+      SyntheticData::Summary const summary = SyntheticData::generate(SyntheticData::Parameters{numRecipes, seed});
+      out << "Generated " << summary.recipes << " recipes (" << summary.oldVersions << " of them old versions), " <<
+             summary.ingredients << " ingredients, " << summary.additions << " additions, " << summary.mashSteps <<
+             " mash steps, " << summary.brewNotes << " brew notes and " << summary.inventories <<
+             " inventory items from seed " << seed << " (fingerprint " << Qt::hex << summary.fingerprint << Qt::dec <<
+             ")" << Qt::endl;
+      return summary.succeeded;
+   }
+
+   bool importFiles(QStringList const & filesToImport, QTextStream & out) {
+      bool allSucceeded = true;
+      for (auto const & result : ImportExport::importFiles(filesToImport)) {
+         out << (result.succeeded ? "Imported " : "FAILED to import ") << result.fileName << Qt::endl;
+         if (!result.userMessage.isEmpty()) {
+            out << result.userMessage << Qt::endl;
+         }
+         allSucceeded &= result.succeeded;
+      }
+      return allSucceeded;
+   }
+
+   bool importChanges(QString const & changesToImport, QTextStream & out) {
+      QString userMessage;
+      bool const succeeded = ImportExport::importChanges(changesToImport, userMessage);
+      out << (succeeded ? "Imported changes from " : "FAILED to import changes from ") << changesToImport << Qt::endl;
+      if (!userMessage.isEmpty()) {
+         out << userMessage << Qt::endl;
+      }
+      return succeeded;
+   }
+
+   bool recalculateRecipes(QTextStream & out) {
+      // As when importing, we don't want to be creating new versions of recipes just because we recalculated them
+      RecipeHelper::SuspendRecipeVersioning suspendRecipeVersioning;
+      int numRecalculated = 0;
+      for (Recipe * recipe : ObjectStoreWrapper::getAllRaw<Recipe>()) {
+         if (!recipe->deleted()) {
+            recipe->recalcAll();
+            ++numRecalculated;
+         }
+      }
+      out << "Recalculated " << numRecalculated << " recipes" << Qt::endl;
+      return true;
+   }
+
+   bool exportRecipes(QString const & recipeExportFile, QTextStream & out) {
+      QList<Recipe const *> recipes;
+      for (Recipe const * recipe : ObjectStoreWrapper::getAllDisplayableRaw<Recipe>()) {
+         recipes.append(recipe);
+      }
+      if (recipes.isEmpty()) {
+         out << "No recipes to export" << Qt::endl;
+         return true;
+      }
+      bool const succeeded = ImportExport::exportToNamedFile(recipeExportFile, &recipes);
+      out << (succeeded ? "Exported " : "FAILED to export ") << recipes.size() << " recipes to " << recipeExportFile <<
+             Qt::endl;
+      return succeeded;
+   }
+
+   bool exportChanges(QString const & changesExportFile, qint64 const sinceCounter, QTextStream & out) {
+      qint64 upToCounter = sinceCounter;
+      bool const succeeded = ImportExport::exportChangesSince(changesExportFile, sinceCounter, upToCounter);
+      out << (succeeded ? "Exported " : "FAILED to export ") << "changes since " << sinceCounter << " to " <<
+             changesExportFile << Qt::endl;
+      if (succeeded) {
+         // This is what the next run needs to be given, so make it easy for a script to pick out
+         out << "Next change counter: " << upToCounter << Qt::endl;
+      }
+      return succeeded;
+   }
+
+   bool checkDatabase(bool const repair, QTextStream & out) {
+      bool succeeded = Database::instance().checkIntegrity(out);
+
+      DatabaseIntegrityReport const report = CheckDatabaseIntegrity(repair);
+      for (DatabaseIntegrityProblem const & problem : report.problems) {
+         out << problem.description << ": " << problem.ids.size() << " object(s), eg #" << problem.ids.first() <<
+                Qt::endl;
+      }
+      if (!report.checksSucceeded) {
+         out << "Some integrity checks could not be run (see log)" << Qt::endl;
+      }
+      if (report.repaired) {
+         out << "Repaired " << report.rowsRepaired << " row(s)" << Qt::endl;
+      } else if (repair && !report.problems.isEmpty()) {
+         out << "FAILED to repair database (see log)" << Qt::endl;
+      }
+      succeeded &= report.checksSucceeded && (report.problems.isEmpty() || report.repaired);
+
+      out << "Database integrity check " << (succeeded ? "passed" : "FAILED") << Qt::endl;
+      return succeeded;
+   }
+}
+
+int BatchMode::run(Options const & options) {
+   QTextStream out{stdout};
+   StepTimer stepTimer;
+
+   // Nothing we do from here on should pop up a dialog
+   Application::setInteractive(false);
+
+   bool succeeded = stepTimer.time("Initialise database", []() { return Application::initialize(); });
+   if (succeeded) {
+      QString errorMessage;
+      succeeded = stepTimer.time("Load object stores", [&errorMessage]() {
+         return InitialiseAllObjectStores(errorMessage);
+      });
+      if (!succeeded) {
+         out << errorMessage << Qt::endl;
+      }
+   }
+
+   if (succeeded) {
+      // See comment in Recipe.h.  (MainWindow::init does this in normal, interactive, running.)
+      Recipe::connectSignalsForAllRecipes();
+      // Similarly, anything we import needs to go in the search index
+      SearchIndex::startMaintaining();
+
+      //
+      // If one step fails, there's no harm in trying the others, and, for a scheduled job, it's probably more useful to
+      // do as much as we can.
+      //
+      if (options.syntheticRecipes > 0) {
+         succeeded &= stepTimer.time("Generate synthetic data", [&]() {
+            return generateSyntheticData(options.syntheticRecipes, options.syntheticSeed, out);
+         });
+      }
+      if (!options.filesToImport.isEmpty()) {
+         succeeded &= stepTimer.time("Import files", [&]() { return importFiles(options.filesToImport, out); });
+      }
+      if (!options.changesToImport.isEmpty()) {
+         succeeded &= stepTimer.time("Import changes", [&]() { return importChanges(options.changesToImport, out); });
+      }
+      if (options.recalculateRecipes) {
+         succeeded &= stepTimer.time("Recalculate recipes", [&]() { return recalculateRecipes(out); });
+      }
+      if (!options.recipeExportFile.isEmpty()) {
+         succeeded &= stepTimer.time("Export recipes", [&]() { return exportRecipes(options.recipeExportFile, out); });
+      }
+      if (!options.changesExportFile.isEmpty()) {
+         succeeded &= stepTimer.time("Export changes", [&]() {
+            return exportChanges(options.changesExportFile, options.changesSinceCounter, out);
+         });
+      }
+      if (options.checkDatabase) {
+         succeeded &= stepTimer.time("Check database", [&]() {
+            return checkDatabase(options.repairDatabase, out);
+         });
+      }
+   }
+
+   // There's no event loop to do this for us
+   SearchIndex::flushPendingUpdates();
+
+   // This needs to happen before we clean up, as the counters include what's in the object stores
+   if (options.printDiagnostics) {
+      out << Diagnostics::format(Diagnostics::takeSnapshot());
+   }
+
+   stepTimer.time("Clean up", []() { Application::cleanup(); return true; });
+
+   if (options.printTimings) {
+      stepTimer.writeTo(out);
+   }
+
+   return succeeded ? EXIT_SUCCESS : EXIT_FAILURE;
+}
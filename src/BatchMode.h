@@ -0,0 +1,73 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * BatchMode.h is part of Brewtarget, and is copyright the following authors 2024:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#ifndef BATCHMODE_H
+#define BATCHMODE_H
+#pragma once
+
+#include <QString>
+#include <QtGlobal>
+#include <QStringList>
+
+/**
+ * \brief Running the program without a user interface, to do things like import files, export recipes, recalculate
+ *        recipes and check the DB (eg as a scheduled job on a server with no display).  This is what happens when the
+ *        program is started with the \c --batch command line option.
+ *
+ *        Only a \c QCoreApplication is created in this mode, so nothing here (or anything it calls) can create widgets
+ *        or show dialogs.  \c Application::isInteractive is \c false throughout.
+ */
+namespace BatchMode {
+
+   /**
+    * \brief What to do.  The steps are done in the order they are listed here, so, eg, recipes that are imported will
+    *        be included in the export.
+    */
+   struct Options {
+      //! If more than 0, generate this many synthetic recipes (see \c SyntheticData), eg to make a DB for benchmarks
+      int syntheticRecipes = 0;
+      quint32 syntheticSeed = 1;
+      //! BeerXML/BeerJSON files to import (in parallel, as for \c ImportExport::importFiles)
+      QStringList filesToImport;
+      //! If not empty, a delta export from another database to import (see \c ImportExport::importChanges)
+      QString changesToImport;
+      //! Recalculate (and store) the calculated values of all recipes
+      bool recalculateRecipes = false;
+      //! If not empty, export all recipes to this file (in the format determined by its extension)
+      QString recipeExportFile;
+      //! If not empty, export what has changed since \c changesSinceCounter to this file (see
+      //! \c ImportExport::exportChangesSince)
+      QString changesExportFile;
+      qint64 changesSinceCounter = 0;
+      //! Run \c Database::checkIntegrity and \c CheckDatabaseIntegrity
+      bool checkDatabase = false;
+      //! With \c checkDatabase, also repair what \c CheckDatabaseIntegrity finds
+      bool repairDatabase = false;
+      //! At the end, print how long each step took
+      bool printTimings = false;
+      //! At the end (but before cleaning up), print the diagnostic counters (see \c Diagnostics)
+      bool printDiagnostics = false;
+   };
+
+   /**
+    * \brief Initialise the DB and object stores (without any UI), do what \c options asks, then clean up.  What happened
+    *        is written to stdout.
+    *
+    * \return Exit code for the program
+    */
+   int run(Options const & options);
+}
+
+#endif
@@ -62,20 +62,36 @@ void BeerColorWidget::paintEvent(QPaintEvent *) {
 
    int x1 = (size().width() - 90) / 2;
    int y1 = 0;
-   QRect rect;
-   rect.setCoords(x1, y1, x1+87, y1+130);
 
-   QPainter painter(this);
-   painter.setBrush(color);
-   painter.drawRect(rect);
+   qreal const pixelRatio = this->devicePixelRatioF();
+   if (this->swatch.isNull() || this->swatch.devicePixelRatio() != pixelRatio) {
+      // Allow an extra pixel each way for the pen drawing the outline of the rectangle
+      QSize const swatchSize = glass.size().expandedTo(QSize(89, 132));
+      this->swatch = QPixmap(swatchSize * pixelRatio);
+      this->swatch.setDevicePixelRatio(pixelRatio);
+      this->swatch.fill(Qt::transparent);
+
+      QRect rect;
+      rect.setCoords(0, 0, 87, 130);
+
+      QPainter swatchPainter(&this->swatch);
+      swatchPainter.setBrush(color);
+      swatchPainter.drawRect(rect);
+      swatchPainter.drawImage(QPoint(0, 0), glass);
+   }
 
-   painter.drawImage(QPoint(x1,y1), glass);
+   QPainter painter(this);
+   painter.drawPixmap(QPoint(x1, y1), this->swatch);
    return;
 }
 
 void BeerColorWidget::setColor(QColor newColor) {
+   if (newColor == color && !this->swatch.isNull()) {
+      return;
+   }
    color = QColor(newColor);
+   this->swatch = QPixmap();
 
-   repaint();
+   update();
    return;
 }
@@ -23,6 +23,7 @@
 #include <QImage>
 #include <QMetaProperty>
 #include <QPaintEvent>
+#include <QPixmap>
 #include <QVariant>
 #include <QWidget>
 
@@ -51,6 +52,11 @@ protected:
    QColor color;
 private:
    QImage glass;
+   /**
+    * \brief The glass filled with \c color, which we draw once and then reuse for every repaint until the color
+    *        changes.  (Recipes emit lots of \c changed signals, most of which don't change the color.)
+    */
+   QPixmap swatch;
    void showColor();
 
    Recipe* recObs;
@@ -36,6 +36,9 @@ BrewDayFormatter::BrewDayFormatter(QObject * parent)
 }
 
 void BrewDayFormatter::setRecipe(Recipe * recipe) {
+   if (recipe != recObs) {
+      instructionFragments.clear();
+   }
    recObs = recipe;
 }
 
@@ -197,57 +200,83 @@ QString BrewDayFormatter::buildInstructionHtml() {
              .arg(tr("Step"));
 
    QList<Instruction *> instructions = recObs->instructions();
+   // Rebuilding the cache as we go also drops anything cached for instructions that are no longer in the recipe
+   QHash<int, InstructionFragment> usedFragments;
+   usedFragments.reserve(instructions.size());
    int size = instructions.size();
    for (int i = 0; i < size; ++i) {
-      QString stepTime, tmp;
-      QList<QString> reagents;
-
       Instruction * ins = instructions[i];
-
-      if (ins->interval() > 0.0) {
-         stepTime = Measurement::displayAmount(Measurement::Amount{ins->interval(), Measurement::Units::minutes}, 0);
-      } else {
-         stepTime = "--";
+      QString const fragment = instructionFragment(*ins);
+      if (instructionFragments.contains(ins->key())) {
+         usedFragments.insert(ins->key(), instructionFragments.value(ins->key()));
       }
 
-      tmp = "";
+      // The row class depends on the position of the instruction, so it isn't part of the cached fragment
+      QString altTag = i % 2 ? "alt" : "norm";
+      middle += QString("<tr class=\"%1\"><td class=\"check\"></td>%2</tr>").arg(altTag, fragment);
+   }
+   instructionFragments.swap(usedFragments);
+   middle += "</table>";
 
-      // TODO: comparing ins->name() with these untranslated strings means this
-      // doesn't work in other languages. Find a better way.
-      if (ins->name() == tr("Add grains")) {
-         reagents = recObs->getReagents(recObs->fermentableAdditions());
-      } else if (ins->name() == tr("Heat water")) {
-         if (recObs->mash()) {
-            reagents = recObs->getReagents(recObs->mash()->mashSteps());
-         }
-      } else {
-         reagents = ins->reagents();
-      }
+   return middle;
+}
 
-      if (reagents.size() > 1) {
-         tmp = QString("<ul>");
-         for (int j = 0; j < reagents.size(); j++) {
-            tmp += QString("<li>%1</li>")
-                   .arg(reagents.at(j));
-         }
-         tmp += QString("</ul>");
-      } else if (reagents.size() == 1) {
-         tmp = reagents.at(0);
-      } else {
-         tmp = ins->directions();
+QString BrewDayFormatter::instructionFragment(Instruction & ins) {
+   // TODO: comparing ins.name() with these untranslated strings means this
+   // doesn't work in other languages. Find a better way.
+   QList<QString> reagents;
+   bool const usesRecipeReagents = (ins.name() == tr("Add grains") || ins.name() == tr("Heat water"));
+   if (ins.name() == tr("Add grains")) {
+      reagents = recObs->getReagents(recObs->fermentableAdditions());
+   } else if (ins.name() == tr("Heat water")) {
+      if (recObs->mash()) {
+         reagents = recObs->getReagents(recObs->mash()->mashSteps());
+      }
+   } else {
+      reagents = ins.reagents();
+      // The reagents for this instruction are its own, so we can use what we cached last time unless it has changed
+      auto const cached = instructionFragments.constFind(ins.key());
+      if (cached != instructionFragments.cend() &&
+          cached->changeCount == ins.changeCount() &&
+          cached->numReagents == reagents.size()) {
+         return cached->html;
       }
+   }
 
-      QString altTag = i % 2 ? "alt" : "norm";
+   QString stepTime;
+   if (ins.interval() > 0.0) {
+      stepTime = Measurement::displayAmount(Measurement::Amount{ins.interval(), Measurement::Units::minutes}, 0);
+   } else {
+      stepTime = "--";
+   }
 
-      middle += QString("<tr class=\"%1\"><td class=\"check\"></td><td class=\"time\">%2</td><td align=\"step\">%3 : %4</td></tr>")
-                .arg(altTag)
-                .arg(stepTime)
-                .arg(ins->name())
-                .arg(tmp);
+   QString tmp = "";
+   if (reagents.size() > 1) {
+      tmp = QString("<ul>");
+      for (int j = 0; j < reagents.size(); j++) {
+         tmp += QString("<li>%1</li>")
+                .arg(reagents.at(j));
+      }
+      tmp += QString("</ul>");
+   } else if (reagents.size() == 1) {
+      tmp = reagents.at(0);
+   } else {
+      tmp = ins.directions();
    }
-   middle += "</table>";
 
-   return middle;
+   QString html = QString("<td class=\"time\">%1</td><td align=\"step\">%2 : %3</td>")
+                  .arg(stepTime)
+                  .arg(ins.name())
+                  .arg(tmp);
+
+   // The recipe-wide reagents (grain bill, mash steps) can change without the instruction changing, so we don't cache
+   if (usesRecipeReagents) {
+      instructionFragments.remove(ins.key());
+   } else {
+      instructionFragments.insert(ins.key(),
+                                  InstructionFragment{ins.changeCount(), static_cast<int>(reagents.size()), html});
+   }
+   return html;
 }
 
 QList<QStringList> BrewDayFormatter::buildInstructionList() {
@@ -21,6 +21,7 @@
 #define BREWDAYFORMATTER_H
 #pragma once
 
+#include <QHash>
 #include <QList>
 #include <QObject>
 #include <QStringList>
@@ -53,7 +54,6 @@ public:
     */
    QString buildHtml();
 
-private:
    /**
     * @brief Create HTML string containing the basic information about the recipe
     *
@@ -62,6 +62,7 @@ private:
     */
    QString buildTitleHtml(bool includeImage = true);
 
+private:
    /**
     * @brief Creates a list of string-lists that contains the data about the basic information about the recipe.
     *
@@ -90,8 +91,25 @@ public:
     */
    QString buildFooterHtml();
 private:
+   /**
+    * @brief The time and step cells of the row for one instruction in the table from \c buildInstructionHtml.
+    *        These are cached (see \c instructionFragments) so that, when one instruction changes (eg gets checked
+    *        off on brew day), re-rendering the table only has to redo the row for that instruction.
+    */
+   QString instructionFragment(Instruction & ins);
+
    Recipe *recObs;
    QString cssName;
+
+   struct InstructionFragment {
+      //! \c NamedEntity::changeCount of the instruction when we rendered it
+      unsigned int changeCount;
+      //! Reagents are not properties, so changing them doesn't change \c changeCount
+      int          numReagents;
+      QString      html;
+   };
+   //! Cached results of \c instructionFragment, keyed by \c Instruction::key
+   QHash<int, InstructionFragment> instructionFragments;
 };
 
 #endif
@@ -40,27 +40,9 @@
 #include "PersistentSettings.h"
 #include "TimerWidget.h"
 
-namespace {
-   QString styleName(Style const * style) {
-      if (!style) {
-         return "unknown";
-      }
-
-      return style->name();
-   }
-
-   QString boilTime(Equipment const * equipment) {
-      if (!equipment) {
-         return "unknown";
-      }
-
-      return Measurement::displayAmount(Measurement::Amount{equipment->boilTime_min().value_or(Equipment::default_boilTime_mins), Measurement::Units::minutes});
-   }
-}
-
-
 BrewDayScrollWidget::BrewDayScrollWidget(QWidget* parent) : QWidget{parent},
-                                                            recObs{nullptr} {
+                                                            recObs{nullptr},
+                                                            formatter{new BrewDayFormatter(this)} {
    this->setupUi(this);
    this->setObjectName("BrewDayScrollWidget");
 
@@ -78,7 +60,11 @@ BrewDayScrollWidget::BrewDayScrollWidget(QWidget* parent) : QWidget{parent},
 BrewDayScrollWidget::~BrewDayScrollWidget() = default;
 
 void BrewDayScrollWidget::saveInstruction() {
-  this->recObs->instructions()[ listWidget->currentRow() ]->setDirections( btTextEdit->toPlainText() );
+  int row = listWidget->currentRow();
+  if (row < 0 || row >= recIns.size()) {
+     return;
+  }
+  recIns[row]->setDirections( btTextEdit->toPlainText() );
   return;
 }
 
@@ -193,10 +179,11 @@ void BrewDayScrollWidget::print(QPrinter *mainPrinter, int action, QFile* outFil
    }
 
    // Start building the document to be printed.  The HTML doesn't work with
-   // the image since it is a compiled resource
-   QString pDoc = buildTitleTable(action != HTML);
-   pDoc += buildInstructionTable();
-   pDoc += buildFooterTable();
+   // the image since it is a compiled resource.  The formatter only re-renders
+   // the instructions that have changed since it was last called.
+   QString pDoc = formatter->buildTitleHtml(action != HTML);
+   pDoc += formatter->buildInstructionHtml();
+   pDoc += formatter->buildFooterHtml();
 
    pDoc += tr("<h2>Notes</h2>");
    if (this->recObs->notes() != "" )
@@ -224,6 +211,7 @@ void BrewDayScrollWidget::setRecipe(Recipe* rec) {
    }
 
    this->recObs = rec;
+   this->formatter->setRecipe(rec);
    connect(this->recObs, &Recipe::changed, this, &BrewDayScrollWidget::acceptChanges);
 
    recIns = this->recObs->instructions();
@@ -291,14 +279,30 @@ void BrewDayScrollWidget::acceptChanges(QMetaProperty prop, QVariant /*value*/)
 }
 
 void BrewDayScrollWidget::acceptInsChanges(QMetaProperty prop, QVariant /*value*/) {
+   //
+   // Only the list items (and, when printing, the HTML rows -- see BrewDayFormatter) for the instruction(s) affected
+   // get updated here.  Rebuilding the whole list on every change makes checking off steps on a long list sluggish.
+   //
+   Instruction * ins = qobject_cast<Instruction *>(this->sender());
+   int const row = ins ? recIns.indexOf(ins) : -1;
    QString propName = prop.name();
    if (propName == "instructionNumber") {
-      // The order changed, so resort our internal list.
+      // The order changed, so resort our internal list.  All the list items keep their place, but some get new text.
+      Instruction * current = listWidget->currentRow() >= 0 ? recIns.value(listWidget->currentRow()) : nullptr;
       std::sort(recIns.begin(), recIns.end(), insPtrLtByNumber);
-      showChanges();
+      refreshListItems();
+      if (current) {
+         listWidget->setCurrentRow(recIns.indexOf(current));
+      }
+   } else if (propName == PropertyNames::NamedEntity::name) {
+      if (row >= 0 && row < listWidget->count()) {
+         listWidget->item(row)->setText(listItemText(*ins));
+      }
    } else if (propName == PropertyNames::Instruction::directions) {
-      // This will make the displayed text directions update.
-      listWidget->setCurrentRow(listWidget->currentRow());
+      // If the change didn't come from the user typing in the edit box, we need to show the new directions
+      if (row >= 0 && row == listWidget->currentRow() && btTextEdit->toPlainText() != ins->directions()) {
+         showInstruction(row);
+      }
    }
    return;
 }
@@ -326,9 +330,7 @@ void BrewDayScrollWidget::repopulateListWidget() {
    }
 
    foreach( Instruction* ins, this->recIns ) {
-      //QString text = tr("Step %1: %2").arg(i).arg(ins->name());
-      QString text = tr("Step %1: %2").arg(ins->instructionNumber()).arg(ins->name());
-      listWidget->addItem(new QListWidgetItem(text));
+      listWidget->addItem(new QListWidgetItem(listItemText(*ins)));
    }
 
    if (this->recIns.size() > 0 ) {
@@ -339,149 +341,23 @@ void BrewDayScrollWidget::repopulateListWidget() {
    return;
 }
 
-QString BrewDayScrollWidget::buildTitleTable(bool includeImage) {
-   // Do the style sheet first
-   if (this->cssName == nullptr) {
-      this->cssName = ":/css/brewday.css";
-   }
-
-   QString header = Html::createHeader(BrewDayScrollWidget::tr("Brewday"), cssName);
-
-   QString body = QString("<h1>%1</h1>").arg(recObs->name());
-   if (includeImage) {
-      body += QString("<img src=\"%1\" />").arg("qrc:/images/title.svg");
+void BrewDayScrollWidget::refreshListItems() {
+   if (this->listWidget->count() != this->recIns.size()) {
+      // Not just a reordering, so start again
+      this->repopulateListWidget();
+      return;
    }
 
-   // Build the top table
-   // Build the first row: Style and Date
-   body += "<table id=\"title\">";
-   body += QString("<tr><td class=\"left\">%1</td>")
-         .arg(tr("Style"));
-   body += QString("<td class=\"value\">%1</td>")
-           .arg(styleName(recObs->style().get()));
-   body += QString("<td class=\"right\">%1</td>")
-         .arg(tr("Date"));
-   body += QString("<td class=\"value\">%1</td></tr>")
-           .arg(QDate::currentDate().toString());
-
-   // second row:  boil time and efficiency.
-   body += QString("<tr><td class=\"left\">%1</td><td class=\"value\">%2</td><td class=\"right\">%3</td><td class=\"value\">%4</td></tr>")
-            .arg(tr("Boil Time"))
-            .arg(boilTime(recObs->equipment().get()))
-            .arg(tr("Efficiency"))
-            .arg(Measurement::displayQuantity(recObs->efficiency_pct(), 0));
-
-   // third row: pre-Boil Volume and Preboil Gravity
-   body += QString("<tr><td class=\"left\">%1</td><td class=\"value\">%2</td><td class=\"right\">%3</td><td class=\"value\">%4</td></tr>")
-            .arg(tr("Boil Volume"))
-            .arg(Measurement::displayAmount(Measurement::Amount{recObs->boilVolume_l(), Measurement::Units::liters}, 2))
-            .arg(tr("Preboil Gravity"))
-            .arg(Measurement::displayAmount(Measurement::Amount{recObs->boilGrav(), Measurement::Units::specificGravity}, 3));
-
-   // fourth row: Final volume and starting gravity
-   body += QString("<tr><td class=\"left\">%1</td><td class=\"value\">%2</td><td class=\"right\">%3</td><td class=\"value\">%4</td></tr>")
-            .arg(tr("Final Volume"))
-            .arg(Measurement::displayAmount(Measurement::Amount{recObs->finalVolume_l(), Measurement::Units::liters}, 2))
-            .arg(tr("Starting Gravity"))
-            .arg(Measurement::displayAmount(Measurement::Amount{recObs->og(), Measurement::Units::specificGravity}, 3));
-
-   // fifth row: IBU and Final gravity
-   body += QString("<tr><td class=\"left\">%1</td><td class=\"value\">%2</td><td class=\"right\">%3</td><td class=\"value\">%4</tr>")
-            .arg(tr("IBU"))
-            .arg( Measurement::displayQuantity(recObs->IBU(), 1))
-            .arg(tr("Final Gravity"))
-            .arg(Measurement::displayAmount(Measurement::Amount{recObs->fg(), Measurement::Units::specificGravity}, 3));
-
-   // sixth row: ABV and estimate calories
-   bool metricVolume = (
-      Measurement::getDisplayUnitSystem(Measurement::PhysicalQuantity::Volume) ==
-      Measurement::UnitSystems::volume_Metric
-   );
-   body += QString("<tr><td class=\"left\">%1</td><td class=\"value\">%2%</td><td class=\"right\">%3</td><td class=\"value\">%4</tr>")
-            .arg(tr("ABV"))
-            .arg(Measurement::displayQuantity(recObs->ABV_pct(), 1) )
-            .arg(metricVolume ? tr("Estimated calories (per 33 cl)") : tr("Estimated calories (per 12 oz)"))
-            .arg(Measurement::displayQuantity(metricVolume ? this->recObs->caloriesPer33cl() : this->recObs->caloriesPerUs12oz(), 0) );
-
-   body += "</table>";
-
-   return header + body;
-}
-
-QString BrewDayScrollWidget::buildInstructionTable() {
-   QString middle = QString("<h2>%1</h2>").arg(tr("Instructions"));
-   middle += QString("<table id=\"steps\">");
-   middle += QString("<tr><th class=\"check\">%1</th><th class=\"time\">%2</th><th class=\"step\">%3</th></tr>")
-         .arg(tr("Completed"))
-         .arg(tr("Time"))
-         .arg(tr("Step"));
-
-   QList<Instruction*> instructions = this->recObs->instructions();
-   auto mashSteps = this->recObs->mash()->mashSteps();
-   int size = instructions.size();
-   for (int i = 0; i < size; ++i ) {
-
-      Instruction* ins = instructions[i];
-
-      QString stepTime;
-      if (ins->interval() > 0.0 ) {
-         stepTime = Measurement::displayAmount(Measurement::Amount{ins->interval(), Measurement::Units::minutes}, 0);
-      } else {
-         stepTime = "--";
-      }
-
-      QString tmp = "";
-
-      // TODO: comparing ins->name() with these untranslated strings means this
-      // doesn't work in other languages. Find a better way.
-      QList<QString> reagents;
-      if ( ins->name() == tr("Add grains") ) {
-         reagents = this->recObs->getReagents( this->recObs->fermentableAdditions() );
-      } else if ( ins->name() == tr("Heat water") ) {
-         reagents = this->recObs->getReagents( this->recObs->mash()->mashSteps() );
-      } else {
-         reagents = ins->reagents();
-      }
-
-      if ( reagents.size() > 1 ) {
-         tmp = QString("<ul>");
-         for (int j = 0; j < reagents.size(); j++ ) {
-            tmp += QString("<li>%1</li>")
-                   .arg(reagents.at(j));
-         }
-         tmp += QString("</ul>");
-      } else if ( reagents.size() == 1 ) {
-         tmp = reagents.at(0);
-      } else {
-         tmp = ins->directions();
+   for (int ii = 0; ii < this->recIns.size(); ++ii) {
+      QString const text = listItemText(*this->recIns[ii]);
+      QListWidgetItem * item = this->listWidget->item(ii);
+      if (item->text() != text) {
+         item->setText(text);
       }
-
-      QString altTag = i % 2 ? "alt" : "norm";
-
-      middle += QString("<tr class=\"%1\"><td class=\"check\"></td><td class=\"time\">%2</td><td align=\"step\">%3 : %4</td></tr>")
-               .arg(altTag)
-               .arg(stepTime)
-               .arg(ins->name())
-               .arg(tmp);
    }
-   middle += "</table>";
-
-   return middle;
+   return;
 }
 
-QString BrewDayScrollWidget::buildFooterTable() {
-   QString bottom = QString("<table id=\"notes\">");
-   bottom += QString("<tr><td class=\"left\">%1:</td><td class=\"value\"></td><td class=\"right\">%2:</td><td class=\"value\"></td></tr>")
-         .arg(tr("Actual PreBoil Volume"))
-         .arg(tr("Actual PreBoil Gravity"));
-
-   bottom += QString("<tr><td class=\"left\">%1:</td><td class=\"value\"></td><td class=\"right\">%2:</td><td class=\"value\"></td></tr>")
-         .arg(tr("PostBoil Volume"))
-         .arg(tr("PostBoil Gravity"));
-
-   bottom += QString("<tr><td class=\"left\">%1:</td><td class=\"value\"></tr>")
-         .arg(tr("Volume into fermenter"));
-   bottom += "</table>";
-
-   return bottom;
+QString BrewDayScrollWidget::listItemText(Instruction const & ins) const {
+   return tr("Step %1: %2").arg(ins.instructionNumber()).arg(ins.name());
 }
@@ -36,6 +36,7 @@
 #include <QVariant>
 #include <QWidget>
 
+#include "BrewDayFormatter.h"
 #include "model/Recipe.h"
 
 
@@ -86,21 +87,20 @@ private:
    void showChanges();
    //! Repopulate the list widget with all the instructions.
    void repopulateListWidget();
+   //! Update the text of the list widget items, in place, from \c recIns.
+   void refreshListItems();
+   QString listItemText(Instruction const & ins) const;
    void clear();
 
-   QString buildTitleTable(bool includeImage = true);
-   QString buildInstructionTable();
-   QString buildFooterTable();
-
    Recipe* recObs;
    QPrinter* printer;
    QTextBrowser* doc;
+   //! Builds the HTML for printing, caching what it can between calls.
+   BrewDayFormatter* formatter;
 
    //! Internal list of recipe instructions, always sorted by instruction number.
    QList<Instruction*> recIns;
 
-   QString cssName;
-
 private slots:
    bool loadComplete(bool ok);
    void showInstruction(int insNdx);
@@ -0,0 +1,356 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * BrewNoteAnalytics.cpp is part of Brewtarget, and is copyright the following authors 2024:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#include "BrewNoteAnalytics.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QHash>
+#include <QObject>
+#include <QThread>
+
+#include "database/ObjectStoreWrapper.h"
+#include "Logging.h"
+#include "model/BrewNote.h"
+#include "model/Recipe.h"
+
+namespace {
+
+   //! Brew day we store for brew notes without a (valid) brew date, so that they sort before all the others
+   qint64 constexpr noBrewDay = std::numeric_limits<qint64>::min();
+
+   double valueOf(BrewNote const & brewNote, BrewNoteAnalytics::Metric const metric) {
+      switch (metric) {
+         case BrewNoteAnalytics::Metric::effIntoBK_pct   : return brewNote.effIntoBK_pct   ();
+         case BrewNoteAnalytics::Metric::brewhouseEff_pct: return brewNote.brewhouseEff_pct();
+         case BrewNoteAnalytics::Metric::attenuation_pct : return brewNote.attenuation     ();
+         case BrewNoteAnalytics::Metric::og              : return brewNote.og              ();
+         case BrewNoteAnalytics::Metric::fg              : return brewNote.fg              ();
+         case BrewNoteAnalytics::Metric::volumeIntoBK_l  : return brewNote.volumeIntoBK_l  ();
+         case BrewNoteAnalytics::Metric::volumeIntoFerm_l: return brewNote.volumeIntoFerm_l();
+         case BrewNoteAnalytics::Metric::finalVolume_l   : return brewNote.finalVolume_l   ();
+      }
+      // It's a coding error if we get here
+      qCritical() << Q_FUNC_INFO << "Unhandled metric" << static_cast<int>(metric);
+      Q_ASSERT(false);
+      return 0.0;
+   }
+
+   int equipmentIdOf(BrewNote const & brewNote) {
+      Recipe const * recipe = ObjectStoreWrapper::getByIdRaw<Recipe>(brewNote.recipeId());
+      return recipe ? recipe->getEquipmentId() : -1;
+   }
+
+   /**
+    * \brief The columns.  Row \c i of every vector belongs to brew note \c brewNoteIds[i].  Rows are in no particular
+    *        order, because removing a brew note moves the last row into its place.
+    */
+   struct Cache {
+      bool                 built = false;
+      std::vector<int>     brewNoteIds;
+      std::vector<int>     recipeIds;
+      std::vector<int>     equipmentIds;
+      //! Brew date as a Julian day, or \c noBrewDay
+      std::vector<qint64>  brewDays;
+      std::array<std::vector<double>, BrewNoteAnalytics::numMetrics> metrics;
+      QHash<int, int>      rowOfBrewNote;
+
+      std::vector<double> const & column(BrewNoteAnalytics::Metric const metric) const {
+         return this->metrics[static_cast<std::size_t>(metric)];
+      }
+
+      void setRow(BrewNote const & brewNote) {
+         int const brewNoteId = brewNote.key();
+         if (brewNote.deleted()) {
+            this->removeRow(brewNoteId);
+            return;
+         }
+         int row = this->rowOfBrewNote.value(brewNoteId, -1);
+         if (row < 0) {
+            row = static_cast<int>(this->brewNoteIds.size());
+            this->rowOfBrewNote.insert(brewNoteId, row);
+            this->brewNoteIds .push_back(brewNoteId);
+            this->recipeIds   .push_back(-1);
+            this->equipmentIds.push_back(-1);
+            this->brewDays    .push_back(noBrewDay);
+            for (auto & metricColumn : this->metrics) {
+               metricColumn.push_back(0.0);
+            }
+         }
+         QDate const brewDate = brewNote.brewDate();
+         this->recipeIds   [row] = brewNote.recipeId();
+         this->equipmentIds[row] = equipmentIdOf(brewNote);
+         this->brewDays    [row] = brewDate.isValid() ? brewDate.toJulianDay() : noBrewDay;
+         for (int ii = 0; ii < BrewNoteAnalytics::numMetrics; ++ii) {
+            this->metrics[static_cast<std::size_t>(ii)][row] =
+               valueOf(brewNote, static_cast<BrewNoteAnalytics::Metric>(ii));
+         }
+         return;
+      }
+
+      void removeRow(int const brewNoteId) {
+         auto const existingRow = this->rowOfBrewNote.constFind(brewNoteId);
+         if (existingRow == this->rowOfBrewNote.cend()) {
+            return;
+         }
+         int const row     = *existingRow;
+         int const lastRow = static_cast<int>(this->brewNoteIds.size()) - 1;
+         this->rowOfBrewNote.remove(brewNoteId);
+         if (row != lastRow) {
+            this->brewNoteIds [row] = this->brewNoteIds [lastRow];
+            this->recipeIds   [row] = this->recipeIds   [lastRow];
+            this->equipmentIds[row] = this->equipmentIds[lastRow];
+            this->brewDays    [row] = this->brewDays    [lastRow];
+            for (auto & metricColumn : this->metrics) {
+               metricColumn[row] = metricColumn[lastRow];
+            }
+            this->rowOfBrewNote.insert(this->brewNoteIds[row], row);
+         }
+         this->brewNoteIds .pop_back();
+         this->recipeIds   .pop_back();
+         this->equipmentIds.pop_back();
+         this->brewDays    .pop_back();
+         for (auto & metricColumn : this->metrics) {
+            metricColumn.pop_back();
+         }
+         return;
+      }
+
+      //! When a recipe's equipment changes, so does the equipment of all its brew notes
+      void setEquipmentOfRecipe(int const recipeId, int const equipmentId) {
+         std::size_t const numRows = this->recipeIds.size();
+         for (std::size_t row = 0; row < numRows; ++row) {
+            if (this->recipeIds[row] == recipeId) {
+               this->equipmentIds[row] = equipmentId;
+            }
+         }
+         return;
+      }
+
+      void connectStoreSignals() {
+         auto & brewNoteStore = ObjectStoreTyped<BrewNote>::getInstance();
+         QObject::connect(&brewNoteStore, &ObjectStoreTyped<BrewNote>::signalObjectInserted,
+                          QCoreApplication::instance(), [this](int brewNoteId) {
+            this->refresh(brewNoteId);
+            return;
+         });
+         QObject::connect(&brewNoteStore, &ObjectStoreTyped<BrewNote>::signalPropertyChanged,
+                          QCoreApplication::instance(), [this](int brewNoteId, BtStringConst const &) {
+            this->refresh(brewNoteId);
+            return;
+         });
+         QObject::connect(&brewNoteStore, &ObjectStoreTyped<BrewNote>::signalObjectDeleted,
+                          QCoreApplication::instance(), [this](int brewNoteId, std::shared_ptr<QObject>) {
+            this->removeRow(brewNoteId);
+            return;
+         });
+
+         auto & recipeStore = ObjectStoreTyped<Recipe>::getInstance();
+         QObject::connect(&recipeStore, &ObjectStoreTyped<Recipe>::signalPropertyChanged,
+                          QCoreApplication::instance(), [this](int recipeId, BtStringConst const & propertyName) {
+            if (propertyName == PropertyNames::Recipe::equipmentId) {
+               Recipe const * recipe = ObjectStoreWrapper::getByIdRaw<Recipe>(recipeId);
+               this->setEquipmentOfRecipe(recipeId, recipe ? recipe->getEquipmentId() : -1);
+            }
+            return;
+         });
+         return;
+      }
+
+      void refresh(int const brewNoteId) {
+         BrewNote const * brewNote = ObjectStoreWrapper::getByIdRaw<BrewNote>(brewNoteId);
+         if (brewNote) {
+            this->setRow(*brewNote);
+         } else {
+            this->removeRow(brewNoteId);
+         }
+         return;
+      }
+   };
+
+   Cache & cache() {
+      // It's a coding error to call this other than on the main thread, as that's the thread that owns the brew notes
+      Q_ASSERT(QThread::currentThread() == QCoreApplication::instance()->thread());
+
+      static Cache theCache;
+      if (!theCache.built) {
+         theCache.built = true;
+         theCache.connectStoreSignals();
+         for (BrewNote const * brewNote : ObjectStoreWrapper::getAllRaw<BrewNote>()) {
+            theCache.setRow(*brewNote);
+         }
+         qCDebug(Logging::recipe) << Q_FUNC_INFO << "Cached metrics for" << theCache.brewNoteIds.size() << "brew notes";
+      }
+      return theCache;
+   }
+
+   /**
+    * \return For every row, whether it is for \c equipmentId.  This, and the loop in \c summarise, are deliberately
+    *         branch-free so that the compiler can vectorise them.
+    */
+   std::vector<unsigned char> equipmentMask(Cache const & theCache, std::optional<int> const equipmentId) {
+      std::size_t const numRows = theCache.equipmentIds.size();
+      std::vector<unsigned char> mask(numRows, 1);
+      if (equipmentId) {
+         int const wanted = *equipmentId;
+         int const * ids = theCache.equipmentIds.data();
+         for (std::size_t row = 0; row < numRows; ++row) {
+            mask[row] = static_cast<unsigned char>(ids[row] == wanted);
+         }
+      }
+      return mask;
+   }
+}
+
+QString BrewNoteAnalytics::metricName(BrewNoteAnalytics::Metric const metric) {
+   switch (metric) {
+      case BrewNoteAnalytics::Metric::effIntoBK_pct   : return QObject::tr("Efficiency into Boil Kettle");
+      case BrewNoteAnalytics::Metric::brewhouseEff_pct: return QObject::tr("Brewhouse Efficiency"       );
+      case BrewNoteAnalytics::Metric::attenuation_pct : return QObject::tr("Attenuation"                );
+      case BrewNoteAnalytics::Metric::og              : return QObject::tr("OG"                         );
+      case BrewNoteAnalytics::Metric::fg              : return QObject::tr("FG"                         );
+      case BrewNoteAnalytics::Metric::volumeIntoBK_l  : return QObject::tr("Volume into Boil Kettle"    );
+      case BrewNoteAnalytics::Metric::volumeIntoFerm_l: return QObject::tr("Volume into Fermenter"      );
+      case BrewNoteAnalytics::Metric::finalVolume_l   : return QObject::tr("Final Volume"               );
+   }
+   // It's a coding error if we get here
+   qCritical() << Q_FUNC_INFO << "Unhandled metric" << static_cast<int>(metric);
+   Q_ASSERT(false);
+   return QString{};
+}
+
+int BrewNoteAnalytics::size() {
+   return static_cast<int>(cache().brewNoteIds.size());
+}
+
+BrewNoteAnalytics::Summary BrewNoteAnalytics::summarise(BrewNoteAnalytics::Metric const metric,
+                                                       std::optional<int> const equipmentId,
+                                                       QDate const since) {
+   Cache const & theCache = cache();
+   std::vector<unsigned char> const mask = equipmentMask(theCache, equipmentId);
+   std::vector<double> const & values = theCache.column(metric);
+   qint64 const sinceDay = since.isValid() ? since.toJulianDay() : noBrewDay;
+
+   std::size_t const numRows = values.size();
+   double const * value = values.data();
+   qint64 const * brewDay = theCache.brewDays.data();
+   double count = 0.0;
+   double sum   = 0.0;
+   double sumSq = 0.0;
+   double min   =  std::numeric_limits<double>::infinity();
+   double max   = -std::numeric_limits<double>::infinity();
+   for (std::size_t row = 0; row < numRows; ++row) {
+      bool const included = mask[row] & (brewDay[row] >= sinceDay) & (value[row] > 0.0);
+      double const weight = included ? 1.0 : 0.0;
+      count += weight;
+      sum   += weight * value[row];
+      sumSq += weight * value[row] * value[row];
+      min    = included ? std::min(min, value[row]) : min;
+      max    = included ? std::max(max, value[row]) : max;
+   }
+
+   if (count == 0.0) {
+      return Summary{0, 0.0, 0.0, 0.0, 0.0};
+   }
+   double const mean = sum / count;
+   return Summary{static_cast<int>(count), mean, min, max, std::sqrt(std::max(0.0, sumSq / count - mean * mean))};
+}
+
+std::optional<double> BrewNoteAnalytics::rollingEfficiency_pct(int const equipmentId, int const window) {
+   Cache const & theCache = cache();
+   std::vector<double> const & efficiencies = theCache.column(BrewNoteAnalytics::Metric::brewhouseEff_pct);
+
+   std::vector<int> rows;
+   std::size_t const numRows = efficiencies.size();
+   for (std::size_t row = 0; row < numRows; ++row) {
+      if (theCache.equipmentIds[row] == equipmentId && efficiencies[row] > 0.0) {
+         rows.push_back(static_cast<int>(row));
+      }
+   }
+   if (rows.empty() || window <= 0) {
+      return std::nullopt;
+   }
+
+   //
+   // We only need the most recent batches to be at the front, not for the whole lot to be sorted.  Brew notes for the
+   // same day are ordered by ID, on the basis that the later one was probably brewed later.
+   //
+   if (static_cast<int>(rows.size()) > window) {
+      std::nth_element(rows.begin(), rows.begin() + window, rows.end(), [&theCache](int const lhs, int const rhs) {
+         if (theCache.brewDays[lhs] != theCache.brewDays[rhs]) {
+            return theCache.brewDays[lhs] > theCache.brewDays[rhs];
+         }
+         return theCache.brewNoteIds[lhs] > theCache.brewNoteIds[rhs];
+      });
+      rows.resize(window);
+   }
+
+   double sum = 0.0;
+   for (int const row : rows) {
+      sum += efficiencies[row];
+   }
+   return sum / static_cast<double>(rows.size());
+}
+
+QVector<BrewNoteAnalytics::EquipmentEfficiency> BrewNoteAnalytics::efficiencyByEquipment(int const window) {
+   Cache const & theCache = cache();
+
+   QHash<int, int>    numBrewNotes;
+   QHash<int, qint64> lastBrewDay;
+   for (std::size_t row = 0; row < theCache.equipmentIds.size(); ++row) {
+      int const equipmentId = theCache.equipmentIds[row];
+      if (equipmentId <= 0) {
+         continue;
+      }
+      ++numBrewNotes[equipmentId];
+      auto const existing = lastBrewDay.constFind(equipmentId);
+      if (existing == lastBrewDay.cend() || *existing < theCache.brewDays[row]) {
+         lastBrewDay.insert(equipmentId, theCache.brewDays[row]);
+      }
+   }
+
+   QList<int> equipmentIds = numBrewNotes.keys();
+   std::sort(equipmentIds.begin(), equipmentIds.end());
+
+   QVector<EquipmentEfficiency> results;
+   results.reserve(equipmentIds.size());
+   for (int const equipmentId : equipmentIds) {
+      qint64 const brewDay = lastBrewDay.value(equipmentId);
+      results.append(EquipmentEfficiency{
+         equipmentId,
+         numBrewNotes.value(equipmentId),
+         BrewNoteAnalytics::summarise(BrewNoteAnalytics::Metric::brewhouseEff_pct, equipmentId),
+         BrewNoteAnalytics::summarise(BrewNoteAnalytics::Metric::effIntoBK_pct   , equipmentId),
+         BrewNoteAnalytics::summarise(BrewNoteAnalytics::Metric::attenuation_pct , equipmentId),
+         BrewNoteAnalytics::rollingEfficiency_pct(equipmentId, window),
+         brewDay == noBrewDay ? QDate{} : QDate::fromJulianDay(brewDay)
+      });
+   }
+   return results;
+}
+
+std::optional<double> BrewNoteAnalytics::calibratedEfficiency_pct(Recipe const & recipe, int const window) {
+   int const equipmentId = recipe.getEquipmentId();
+   if (equipmentId <= 0) {
+      return std::nullopt;
+   }
+   return BrewNoteAnalytics::rollingEfficiency_pct(equipmentId, window);
+}
@@ -0,0 +1,115 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * BrewNoteAnalytics.h is part of Brewtarget, and is copyright the following authors 2024:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#ifndef BREWNOTEANALYTICS_H
+#define BREWNOTEANALYTICS_H
+#pragma once
+
+#include <optional>
+
+#include <QDate>
+#include <QString>
+#include <QVector>
+
+class Recipe;
+
+/**
+ * \brief Cross-batch statistics over the measured values in brew notes, eg how the efficiency of each piece of
+ *        equipment has been trending, and what efficiency a new recipe on that equipment should therefore assume.
+ *
+ *        Rather than going through every \c BrewNote object and calling its getters for each question, we keep a
+ *        columnar cache: one contiguous array per metric, plus arrays of keys (brew note, recipe, equipment and brew
+ *        date), with the same row in each array belonging to the same brew note.  An aggregation is then a single pass
+ *        over a couple of arrays of numbers, written without branches so that the compiler can vectorise it, which
+ *        keeps even years' worth of brew notes effectively instant.
+ *
+ *        The cache is built the first time it is used, and thereafter kept up to date from the brew note and recipe
+ *        object store signals.  (Brew notes do not record which equipment they were brewed on, so we use the
+ *        equipment of the recipe they belong to.)
+ *
+ *        A measured value of zero (or less) means it was not entered, so such values are left out of aggregations.
+ *
+ *        All functions must be called on the main thread.
+ */
+namespace BrewNoteAnalytics {
+
+   enum class Metric {
+      effIntoBK_pct   ,
+      brewhouseEff_pct,
+      attenuation_pct ,
+      og              ,
+      fg              ,
+      volumeIntoBK_l  ,
+      volumeIntoFerm_l,
+      finalVolume_l   ,
+   };
+   int constexpr numMetrics = 8;
+
+   //! \return Translated display name of \c metric
+   QString metricName(Metric const metric);
+
+   //! Number of most recent batches used, by default, when working out rolling efficiency
+   int constexpr defaultWindow = 5;
+
+   struct Summary {
+      //! Number of brew notes with the metric set.  Other fields are only meaningful if this is non-zero.
+      int    count;
+      double mean;
+      double min;
+      double max;
+      double stdDev;
+   };
+
+   struct EquipmentEfficiency {
+      int     equipmentId;
+      int     numBrewNotes;
+      //! Over all brew notes for the equipment
+      Summary brewhouseEff_pct;
+      Summary effIntoBK_pct;
+      Summary attenuation_pct;
+      //! Mean brewhouse efficiency over the most recent batches, if there are any with it set
+      std::optional<double> rollingEff_pct;
+      QDate   lastBrewDate;
+   };
+
+   //! \return Number of brew notes in the cache (after building it if necessary)
+   int size();
+
+   /**
+    * \brief Summarise \c metric over all brew notes, or just those for one piece of equipment and/or brewed on or after
+    *        a given date
+    */
+   Summary summarise(Metric const metric,
+                     std::optional<int> const equipmentId = std::nullopt,
+                     QDate const since = QDate{});
+
+   /**
+    * \return Mean brewhouse efficiency over the \c window most recent brew notes (with brewhouse efficiency set) for
+    *         \c equipmentId, or \c std::nullopt if there are none
+    */
+   std::optional<double> rollingEfficiency_pct(int const equipmentId, int const window = defaultWindow);
+
+   //! \return Stats for every piece of equipment that has at least one brew note
+   QVector<EquipmentEfficiency> efficiencyByEquipment(int const window = defaultWindow);
+
+   /**
+    * \return The efficiency \c recipe should use, based on the rolling efficiency of its equipment, or
+    *         \c std::nullopt if it has no equipment or there are no brew notes to go on
+    */
+   std::optional<double> calibratedEfficiency_pct(Recipe const & recipe, int const window = defaultWindow);
+
+}
+
+#endif
@@ -0,0 +1,226 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * BrewNoteAnalyticsDialog.cpp is part of Brewtarget, and is copyright the following authors 2024:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#include "BrewNoteAnalyticsDialog.h"
+
+#include <QEvent>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QLabel>
+#include <QLocale>
+#include <QPushButton>
+#include <QSpinBox>
+#include <QTreeWidget>
+#include <QTreeWidgetItem>
+#include <QVBoxLayout>
+#include <QWidget>
+
+#include "BrewNoteAnalytics.h"
+#include "database/ObjectStoreWrapper.h"
+#include "model/Equipment.h"
+#include "model/Recipe.h"
+
+namespace {
+   enum Column {
+      EquipmentName,
+      NumBrewNotes,
+      LastBrewed,
+      RollingEfficiency,
+      BrewhouseEfficiency,
+      EfficiencyIntoBK,
+      Attenuation,
+      NumColumns
+   };
+
+   QString formatPercent(double const value_pct) {
+      return QString::number(value_pct, 'f', 1) + "%";
+   }
+
+   //! Mean ± standard deviation, or blank if there's nothing to summarise
+   QString formatSummary(BrewNoteAnalytics::Summary const & summary) {
+      if (summary.count == 0) {
+         return QString{};
+      }
+      return QString{"%1 ± %2"}.arg(formatPercent(summary.mean)).arg(QString::number(summary.stdDev, 'f', 1));
+   }
+}
+
+// This private implementation class holds all private non-virtual members of BrewNoteAnalyticsDialog
+class BrewNoteAnalyticsDialog::impl {
+
+public:
+
+   /**
+    * Constructor
+    *
+    * As with DiagnosticsDialog, it's safe to pass in a reference to BrewNoteAnalyticsDialog from its constructor
+    * because there is nothing else in that class to initialise by the time this pimpl constructor is being called.
+    */
+   impl(BrewNoteAnalyticsDialog & brewNoteAnalyticsDialog) :
+      self           {brewNoteAnalyticsDialog},
+      stats          {new QTreeWidget{}},
+      windowLabel    {new QLabel{}},
+      windowSize     {new QSpinBox{}},
+      recipeStatus   {new QLabel{}},
+      calibrateButton{new QPushButton{}},
+      layout         {new QVBoxLayout{&brewNoteAnalyticsDialog}},
+      recipeId       {-1},
+      suggested_pct  {std::nullopt} {
+      this->stats->setRootIsDecorated(false);
+      this->stats->setColumnCount(NumColumns);
+      this->stats->setSortingEnabled(true);
+      this->stats->header()->setSectionResizeMode(QHeaderView::ResizeToContents);
+      this->stats->setMinimumSize(720, 320);
+
+      this->windowSize->setRange(1, 100);
+      this->windowSize->setValue(BrewNoteAnalytics::defaultWindow);
+      this->windowLabel->setBuddy(this->windowSize.get());
+
+      // The sub-layouts are owned by the main layout once they are added to it
+      auto windowLayout = new QHBoxLayout{};
+      windowLayout->addWidget(this->windowLabel.get());
+      windowLayout->addWidget(this->windowSize.get());
+      windowLayout->addStretch();
+      auto recipeLayout = new QHBoxLayout{};
+      recipeLayout->addWidget(this->recipeStatus.get(), 1);
+      recipeLayout->addWidget(this->calibrateButton.get());
+
+      this->layout->addLayout(windowLayout);
+      this->layout->addWidget(this->stats.get());
+      this->layout->addLayout(recipeLayout);
+
+      QObject::connect(this->windowSize.get(), QOverload<int>::of(&QSpinBox::valueChanged), &brewNoteAnalyticsDialog,
+                       [this](int) {
+         this->refresh();
+         return;
+      });
+      QObject::connect(this->calibrateButton.get(), &QPushButton::clicked, &brewNoteAnalyticsDialog, [this]() {
+         Recipe * recipe = ObjectStoreWrapper::getByIdRaw<Recipe>(this->recipeId);
+         if (recipe && this->suggested_pct) {
+            emit this->self.calibrateRecipe(recipe, *this->suggested_pct);
+            this->updateRecipeStatus();
+         }
+         return;
+      });
+
+      this->setText();
+      return;
+   }
+
+   ~impl() = default;
+
+   /**
+    * Set the (translatable) parts of the dialog
+    */
+   void setText() {
+      this->self.setWindowTitle(BrewNoteAnalyticsDialog::tr("Brew Note Analytics"));
+      this->windowLabel->setText(BrewNoteAnalyticsDialog::tr("Rolling efficiency over last"));
+      this->windowSize->setSuffix(BrewNoteAnalyticsDialog::tr(" batches"));
+      this->calibrateButton->setText(BrewNoteAnalyticsDialog::tr("Calibrate Recipe Efficiency"));
+      this->stats->setHeaderLabels({BrewNoteAnalyticsDialog::tr("Equipment"),
+                                    BrewNoteAnalyticsDialog::tr("Brew Notes"),
+                                    BrewNoteAnalyticsDialog::tr("Last Brewed"),
+                                    BrewNoteAnalyticsDialog::tr("Rolling Efficiency"),
+                                    BrewNoteAnalyticsDialog::tr("Brewhouse Efficiency"),
+                                    BrewNoteAnalyticsDialog::tr("Efficiency into BK"),
+                                    BrewNoteAnalyticsDialog::tr("Attenuation")});
+      this->updateRecipeStatus();
+      return;
+   }
+
+   void refresh() {
+      this->stats->clear();
+      for (auto const & equipmentStats : BrewNoteAnalytics::efficiencyByEquipment(this->windowSize->value())) {
+         Equipment const * equipment = ObjectStoreWrapper::getByIdRaw<Equipment>(equipmentStats.equipmentId);
+         auto item = new QTreeWidgetItem{this->stats.get()};
+         item->setText(EquipmentName      , equipment ? equipment->name() :
+                                                        QString{"#%1"}.arg(equipmentStats.equipmentId));
+         item->setText(NumBrewNotes       , QString::number(equipmentStats.numBrewNotes));
+         item->setText(LastBrewed         , QLocale{}.toString(equipmentStats.lastBrewDate, QLocale::ShortFormat));
+         item->setText(RollingEfficiency  , equipmentStats.rollingEff_pct ?
+                                               formatPercent(*equipmentStats.rollingEff_pct) : QString{});
+         item->setText(BrewhouseEfficiency, formatSummary(equipmentStats.brewhouseEff_pct));
+         item->setText(EfficiencyIntoBK   , formatSummary(equipmentStats.effIntoBK_pct));
+         item->setText(Attenuation        , formatSummary(equipmentStats.attenuation_pct));
+         for (int column = NumBrewNotes; column < NumColumns; ++column) {
+            item->setTextAlignment(column, static_cast<int>(Qt::AlignRight | Qt::AlignVCenter));
+         }
+      }
+      this->updateRecipeStatus();
+      return;
+   }
+
+   void updateRecipeStatus() {
+      Recipe const * recipe = ObjectStoreWrapper::getByIdRaw<Recipe>(this->recipeId);
+      this->suggested_pct = recipe ? BrewNoteAnalytics::calibratedEfficiency_pct(*recipe, this->windowSize->value()) :
+                                     std::nullopt;
+      this->calibrateButton->setEnabled(this->suggested_pct.has_value());
+      if (!recipe) {
+         this->recipeStatus->setText(QString{});
+      } else if (!this->suggested_pct) {
+         this->recipeStatus->setText(
+            BrewNoteAnalyticsDialog::tr("No brew notes with a measured efficiency for the equipment of \"%1\"").arg(
+               recipe->name()
+            )
+         );
+      } else {
+         this->recipeStatus->setText(
+            BrewNoteAnalyticsDialog::tr("\"%1\" assumes %2 efficiency; its equipment has been achieving %3").arg(
+               recipe->name()
+            ).arg(formatPercent(recipe->efficiency_pct())).arg(formatPercent(*this->suggested_pct))
+         );
+      }
+      return;
+   }
+
+   BrewNoteAnalyticsDialog & self;
+   std::unique_ptr<QTreeWidget> stats;
+   std::unique_ptr<QLabel>      windowLabel;
+   std::unique_ptr<QSpinBox>    windowSize;
+   std::unique_ptr<QLabel>      recipeStatus;
+   std::unique_ptr<QPushButton> calibrateButton;
+   std::unique_ptr<QVBoxLayout> layout;
+   //! The recipe the calibrate button applies to, if any
+   int                          recipeId;
+   std::optional<double>        suggested_pct;
+};
+
+
+BrewNoteAnalyticsDialog::BrewNoteAnalyticsDialog(QWidget * parent) : QDialog(parent),
+                                                                     pimpl{std::make_unique<impl>(*this)} {
+   this->setObjectName("brewNoteAnalyticsDialog");
+   return;
+}
+
+// See https://herbsutter.com/gotw/_100/ for why we need to explicitly define the destructor here (and not in the
+// header file)
+BrewNoteAnalyticsDialog::~BrewNoteAnalyticsDialog() = default;
+
+void BrewNoteAnalyticsDialog::showForRecipe(Recipe * recipe) {
+   this->pimpl->recipeId = recipe ? recipe->key() : -1;
+   this->pimpl->refresh();
+   this->show();
+   this->raise();
+   return;
+}
+
+void BrewNoteAnalyticsDialog::changeEvent(QEvent * event) {
+   if (event->type() == QEvent::LanguageChange) {
+      this->pimpl->setText();
+   }
+   // Pass the event down to the base class
+   QDialog::changeEvent(event);
+   return;
+}
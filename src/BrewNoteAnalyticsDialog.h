@@ -0,0 +1,63 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * BrewNoteAnalyticsDialog.h is part of Brewtarget, and is copyright the following authors 2024:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#ifndef BREWNOTEANALYTICSDIALOG_H
+#define BREWNOTEANALYTICSDIALOG_H
+#pragma once
+
+#include <memory> // For PImpl
+
+#include <QDialog>
+
+class QEvent;
+class QWidget;
+class Recipe;
+
+/*!
+ * \class BrewNoteAnalyticsDialog
+ *
+ * \brief Shows, for each piece of equipment, the efficiency and attenuation actually achieved according to brew notes
+ *        (see \c BrewNoteAnalytics), and offers to set the current recipe's efficiency from the rolling efficiency of
+ *        its equipment.
+ */
+class BrewNoteAnalyticsDialog : public QDialog {
+   Q_OBJECT
+
+public:
+   BrewNoteAnalyticsDialog(QWidget * parent = nullptr);
+   ~BrewNoteAnalyticsDialog();
+
+   /**
+    * \brief Refresh the stats and show the dialog.  \c recipe, which may be null, is the one the "calibrate" button
+    *        applies to.
+    */
+   void showForRecipe(Recipe * recipe);
+
+   virtual void changeEvent(QEvent * event);
+
+signals:
+   /**
+    * \brief Emitted when the user asks for \c recipe's efficiency to be set to \c efficiency_pct.  It's up to the
+    *        receiver to make the change (so that it can be undone).
+    */
+   void calibrateRecipe(Recipe * recipe, double efficiency_pct);
+
+private:
+   // Private implementation details - see https://herbsutter.com/gotw/_100/
+   class impl;
+   std::unique_ptr<impl> pimpl;
+};
+
+#endif
@@ -0,0 +1,339 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * BrewScheduler.cpp is part of Brewtarget, and is copyright the following authors 2024:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#include "BrewScheduler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <set>
+#include <utility>
+
+#include <QHash>
+
+#include "FermentationSimulator.h"
+#include "model/Boil.h"
+#include "model/Fermentation.h"
+#include "model/FermentationStep.h"
+#include "model/Mash.h"
+#include "model/Recipe.h"
+
+namespace {
+   qint64 constexpr beginningOfTime = std::numeric_limits<qint64>::min();
+   qint64 constexpr endOfTime       = std::numeric_limits<qint64>::max();
+
+   struct Occupancy {
+      qint64 end_ms;
+      int    batchId;
+   };
+
+   //! Start time -> occupancy, for one vessel.  (See class comment in header for why this is enough.)
+   using Occupancies = std::map<qint64, Occupancy>;
+
+   /**
+    * \return The earliest time, not before \c from_ms, at which the vessel is free for \c duration_ms
+    */
+   qint64 nextFree(Occupancies const & occupancies, qint64 from_ms, qint64 const duration_ms) {
+      auto next = occupancies.upper_bound(from_ms);
+      if (next != occupancies.cbegin()) {
+         auto const previous = std::prev(next);
+         from_ms = std::max(from_ms, previous->second.end_ms);
+      }
+      for (; next != occupancies.cend() && next->first < from_ms + duration_ms; ++next) {
+         from_ms = std::max(from_ms, next->second.end_ms);
+      }
+      return from_ms;
+   }
+
+   bool fits(BrewScheduler::Vessel const & vessel, BrewScheduler::Requirements const & requirements) {
+      return vessel.capacity_l <= 0.0 || requirements.batchSize_l <= vessel.capacity_l;
+   }
+
+   qint64 toMilliseconds(double const amount, double const millisecondsPerUnit) {
+      return std::llround(std::max(0.0, amount) * millisecondsPerUnit);
+   }
+}
+
+// This private implementation class holds all private non-virtual members of BrewScheduler
+class BrewScheduler::impl {
+public:
+   struct VesselState {
+      Vessel      vessel;
+      Occupancies occupancies;
+   };
+
+   struct Batch {
+      Requirements           requirements;
+      qint64                 notBefore_ms;
+      std::optional<Booking> booking;
+   };
+
+   //! Batches are planned in order of earliest start and then ID
+   using PlanningKey = std::pair<qint64, int>;
+
+   impl() :
+      m_vessels{},
+      m_batches{},
+      m_planningOrder{} {
+      return;
+   }
+
+   ~impl() = default;
+
+   std::optional<Booking> place(Requirements const & requirements, qint64 const notBefore_ms) const {
+      //
+      // Each time round the loop, we find the earliest time, from candidateStart_ms on, that a brewhouse is free, and
+      // then the earliest time, from that one on, that a fermenter is free straight after brew day.  Neither can be
+      // earlier than the slot we are looking for, so if they agree we've found it, and otherwise we try again from
+      // the later one.  Each time round the loop moves on to the end of at least one booking, so this terminates.
+      //
+      qint64 const brewDay_ms = requirements.brewDay_ms;
+      qint64 candidateStart_ms = notBefore_ms;
+      while (true) {
+         qint64 brewhouseFree_ms = endOfTime;
+         int brewhouseId = -1;
+         qint64 fermenterFree_ms = endOfTime;
+         int fermenterId = -1;
+         // m_vessels is ordered by ID, so, of the vessels free at the same time, we pick the one with the lowest ID
+         for (auto const & [vesselId, state] : this->m_vessels) {
+            if (state.vessel.kind == VesselKind::Brewhouse && fits(state.vessel, requirements)) {
+               qint64 const free_ms = nextFree(state.occupancies, candidateStart_ms, brewDay_ms);
+               if (free_ms < brewhouseFree_ms) {
+                  brewhouseFree_ms = free_ms;
+                  brewhouseId = vesselId;
+               }
+            }
+         }
+         if (brewhouseId < 0) {
+            return std::nullopt;
+         }
+         for (auto const & [vesselId, state] : this->m_vessels) {
+            if (state.vessel.kind == VesselKind::Fermenter && fits(state.vessel, requirements)) {
+               qint64 const free_ms =
+                  nextFree(state.occupancies, brewhouseFree_ms + brewDay_ms, requirements.fermentation_ms) - brewDay_ms;
+               if (free_ms < fermenterFree_ms) {
+                  fermenterFree_ms = free_ms;
+                  fermenterId = vesselId;
+               }
+            }
+         }
+         if (fermenterId < 0) {
+            return std::nullopt;
+         }
+         if (fermenterFree_ms == brewhouseFree_ms) {
+            return Booking{brewhouseId,
+                           fermenterId,
+                           brewhouseFree_ms,
+                           brewhouseFree_ms + brewDay_ms,
+                           brewhouseFree_ms + brewDay_ms + requirements.fermentation_ms};
+         }
+         candidateStart_ms = fermenterFree_ms;
+      }
+   }
+
+   void occupy(int const vesselId, qint64 const start_ms, qint64 const end_ms, int const batchId) {
+      // An empty interval doesn't occupy anything (and might share its start time with the next booking)
+      if (start_ms < end_ms) {
+         this->m_vessels[vesselId].occupancies.emplace(start_ms, Occupancy{end_ms, batchId});
+      }
+      return;
+   }
+
+   void vacate(int const vesselId, qint64 const start_ms, int const batchId) {
+      auto vessel = this->m_vessels.find(vesselId);
+      if (vessel != this->m_vessels.end()) {
+         auto occupancy = vessel->second.occupancies.find(start_ms);
+         if (occupancy != vessel->second.occupancies.end() && occupancy->second.batchId == batchId) {
+            vessel->second.occupancies.erase(occupancy);
+         }
+      }
+      return;
+   }
+
+   void book(int const batchId, Booking const & booking) {
+      this->occupy(booking.brewhouseId, booking.start_ms,      booking.brewDayEnd_ms, batchId);
+      this->occupy(booking.fermenterId, booking.brewDayEnd_ms, booking.end_ms,        batchId);
+      return;
+   }
+
+   void unbook(int const batchId, Batch const & batch) {
+      if (batch.booking) {
+         this->vacate(batch.booking->brewhouseId, batch.booking->start_ms,      batchId);
+         this->vacate(batch.booking->fermenterId, batch.booking->brewDayEnd_ms, batchId);
+      }
+      return;
+   }
+
+   /**
+    * \brief Re-plan the batches from \c fromKey on in the planning order.  Occupancy before \c changedFrom_ms is
+    *        assumed to be the same as when they were last planned, so batches whose bookings end by then stay where
+    *        they are -- unless \c replanAll is set, eg because the vessels have changed.  Batch \c changedBatchId,
+    *        if set, is always re-planned, because its requirements have changed.
+    *
+    * \param changedIds IDs of batches whose bookings change are appended to this
+    */
+   void replanFrom(PlanningKey const & fromKey,
+                   qint64 changedFrom_ms,
+                   bool const replanAll,
+                   std::optional<int> const changedBatchId,
+                   QVector<int> & changedIds) {
+      auto const first = this->m_planningOrder.lower_bound(fromKey);
+      for (auto ii = first; ii != this->m_planningOrder.end(); ++ii) {
+         this->unbook(ii->second, this->m_batches[ii->second]);
+      }
+
+      for (auto ii = first; ii != this->m_planningOrder.end(); ++ii) {
+         int const batchId = ii->second;
+         Batch & batch = this->m_batches[batchId];
+         std::optional<Booking> const oldBooking = batch.booking;
+         // A batch that didn't fit in any vessel still won't, as long as the vessels are the same
+         if (!replanAll && batchId != changedBatchId && (!oldBooking || oldBooking->end_ms <= changedFrom_ms)) {
+            if (oldBooking) {
+               this->book(batchId, *oldBooking);
+            }
+            continue;
+         }
+
+         batch.booking = this->place(batch.requirements, batch.notBefore_ms);
+         if (batch.booking) {
+            this->book(batchId, *batch.booking);
+         }
+         if (batch.booking != oldBooking) {
+            changedIds.append(batchId);
+            if (oldBooking) {
+               changedFrom_ms = std::min(changedFrom_ms, oldBooking->start_ms);
+            }
+            if (batch.booking) {
+               changedFrom_ms = std::min(changedFrom_ms, batch.booking->start_ms);
+            }
+         }
+      }
+      return;
+   }
+
+   QVector<int> replanEverything() {
+      QVector<int> changedIds;
+      this->replanFrom(PlanningKey{beginningOfTime, std::numeric_limits<int>::min()},
+                       beginningOfTime,
+                       true,
+                       std::nullopt,
+                       changedIds);
+      return changedIds;
+   }
+
+   //! Vessel ID -> vessel, ordered by ID
+   std::map<int, VesselState> m_vessels;
+   QHash<int, Batch> m_batches;
+   //! Planning key -> batch ID
+   std::map<PlanningKey, int> m_planningOrder;
+};
+
+BrewScheduler::BrewScheduler() : pimpl{std::make_unique<impl>()} {
+   return;
+}
+
+// See https://herbsutter.com/gotw/_100/ for why we need to explicitly define the destructor here (and not in the
+// header file)
+BrewScheduler::~BrewScheduler() = default;
+
+BrewScheduler::Requirements BrewScheduler::requirementsFor(Recipe & recipe) {
+   double brewDay_mins = 0.0;
+   if (auto mash = recipe.mash()) {
+      brewDay_mins += mash->totalTime();
+   }
+   if (auto boil = recipe.boil()) {
+      brewDay_mins += boil->boilTime_mins();
+   }
+   double fermentation_days = 0.0;
+   if (auto fermentation = recipe.fermentation()) {
+      for (auto const & step : fermentation->fermentationSteps()) {
+         fermentation_days += step->stepTime_days().value_or(0.0);
+      }
+   }
+   if (fermentation_days <= 0.0) {
+      auto const simulated = FermentationSimulator::simulate(FermentationSimulator::inputsFor(recipe));
+      fermentation_days = simulated.timeToTerminal_days.value_or(0.0);
+   }
+   return Requirements{toMilliseconds(brewDay_mins, 60.0 * 1000.0),
+                       toMilliseconds(fermentation_days, 24.0 * 60.0 * 60.0 * 1000.0),
+                       recipe.batchSize_l()};
+}
+
+QVector<int> BrewScheduler::setVessel(Vessel const & vessel) {
+   this->pimpl->m_vessels[vessel.id].vessel = vessel;
+   return this->pimpl->replanEverything();
+}
+
+QVector<int> BrewScheduler::removeVessel(int const vesselId) {
+   this->pimpl->m_vessels.erase(vesselId);
+   return this->pimpl->replanEverything();
+}
+
+QVector<int> BrewScheduler::setBatch(int const batchId, Requirements const & requirements, qint64 const notBefore_ms) {
+   impl::PlanningKey fromKey{notBefore_ms, batchId};
+   qint64 changedFrom_ms = endOfTime;
+   auto batch = this->pimpl->m_batches.find(batchId);
+   if (batch == this->pimpl->m_batches.end()) {
+      batch = this->pimpl->m_batches.insert(batchId, impl::Batch{requirements, notBefore_ms, std::nullopt});
+   } else {
+      impl::PlanningKey const oldKey{batch->notBefore_ms, batchId};
+      fromKey = std::min(fromKey, oldKey);
+      this->pimpl->m_planningOrder.erase(oldKey);
+      this->pimpl->unbook(batchId, *batch);
+      if (batch->booking) {
+         changedFrom_ms = batch->booking->start_ms;
+      }
+      batch->requirements = requirements;
+      batch->notBefore_ms = notBefore_ms;
+   }
+   this->pimpl->m_planningOrder.emplace(impl::PlanningKey{notBefore_ms, batchId}, batchId);
+
+   QVector<int> changedIds;
+   this->pimpl->replanFrom(fromKey, changedFrom_ms, false, batchId, changedIds);
+   return changedIds;
+}
+
+QVector<int> BrewScheduler::removeBatch(int const batchId) {
+   QVector<int> changedIds;
+   auto batch = this->pimpl->m_batches.find(batchId);
+   if (batch == this->pimpl->m_batches.end()) {
+      return changedIds;
+   }
+   impl::PlanningKey const key{batch->notBefore_ms, batchId};
+   this->pimpl->m_planningOrder.erase(key);
+   this->pimpl->unbook(batchId, *batch);
+   std::optional<Booking> const oldBooking = batch->booking;
+   this->pimpl->m_batches.erase(batch);
+   if (oldBooking) {
+      changedIds.append(batchId);
+      this->pimpl->replanFrom(key, oldBooking->start_ms, false, std::nullopt, changedIds);
+   }
+   return changedIds;
+}
+
+std::optional<BrewScheduler::Booking> BrewScheduler::booking(int const batchId) const {
+   auto const batch = this->pimpl->m_batches.constFind(batchId);
+   if (batch == this->pimpl->m_batches.cend()) {
+      return std::nullopt;
+   }
+   return batch->booking;
+}
+
+std::optional<BrewScheduler::Booking> BrewScheduler::earliestSlot(Requirements const & requirements,
+                                                                  qint64 const notBefore_ms) const {
+   return this->pimpl->place(requirements, notBefore_ms);
+}
@@ -0,0 +1,133 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * BrewScheduler.h is part of Brewtarget, and is copyright the following authors 2024:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#ifndef BREWSCHEDULER_H
+#define BREWSCHEDULER_H
+#pragma once
+
+#include <memory> // For PImpl
+#include <optional>
+
+#include <QVector>
+#include <QtGlobal>
+
+class Recipe;
+
+/**
+ * \brief Plans which brewhouse (ie \c Equipment) and which fermenter each planned batch uses, and when.
+ *
+ *        A batch occupies a brewhouse for its brew day (mash plus boil), and then a fermenter, big enough for its batch
+ *        size, for all its fermentation steps.  Batches are placed greedily, in order of the earliest time they can
+ *        start (and then of ID), each at the earliest time from then on that a brewhouse and, straight after, a
+ *        fermenter are both free.
+ *
+ *        For each vessel, we keep an index of its occupancy, ordered by start time.  Because a vessel is only ever
+ *        booked for one batch at a time, its intervals never overlap, so this ordered map is all the interval tree we
+ *        need: finding what overlaps a given time is a single logarithmic lookup followed by a walk along the
+ *        (adjacent) intervals that are actually in the way.
+ *
+ *        Changing, adding or removing a batch only re-plans the batches after it in the planning order, and, of those,
+ *        only the ones whose bookings reach past the earliest time at which occupancy has changed.  (Any other batch
+ *        would be placed exactly where it already is, because everything it could have seen while being placed is
+ *        the same as before.)
+ *
+ *        Times are milliseconds since the epoch, as for \c QDateTime::toMSecsSinceEpoch.  Vessel and batch IDs are
+ *        chosen by the caller -- eg an \c Equipment key for a brewhouse.
+ */
+class BrewScheduler {
+public:
+   enum class VesselKind {
+      Brewhouse,
+      Fermenter,
+   };
+
+   struct Vessel {
+      int        id;
+      VesselKind kind;
+      double     capacity_l;
+   };
+
+   //! What a batch needs
+   struct Requirements {
+      qint64 brewDay_ms      = 0;
+      qint64 fermentation_ms = 0;
+      double batchSize_l     = 0.0;
+   };
+
+   struct Booking {
+      int    brewhouseId;
+      int    fermenterId;
+      qint64 start_ms;
+      //! Also when it moves into the fermenter
+      qint64 brewDayEnd_ms;
+      qint64 end_ms;
+
+      bool operator==(Booking const & other) const = default;
+   };
+
+   BrewScheduler();
+   ~BrewScheduler();
+
+   /**
+    * \return The requirements of a batch of \c recipe: brew day is mash plus boil time, and fermentation the sum of the
+    *         times of its fermentation steps.  If the fermentation steps don't say how long they take, we use the time
+    *         \c FermentationSimulator predicts for the yeast to reach terminal gravity.  (Non-const because
+    *         \c FermentationSimulator::inputsFor needs the recipe's gravities.)
+    */
+   static Requirements requirementsFor(Recipe & recipe);
+
+   /**
+    * \brief Add a vessel or, if there is already one with the same ID, replace it.  Since this can change where any
+    *        batch goes, the whole plan is redone.
+    *
+    * \return IDs of the batches whose bookings changed
+    */
+   QVector<int> setVessel(Vessel const & vessel);
+
+   //! \return IDs of the batches whose bookings changed
+   QVector<int> removeVessel(int const vesselId);
+
+   /**
+    * \brief Add a batch, that can't start before \c notBefore_ms, to the plan or, if there is already a batch with the
+    *        same ID, change it.
+    *
+    * \return IDs of the batches whose bookings changed
+    */
+   QVector<int> setBatch(int const batchId, Requirements const & requirements, qint64 const notBefore_ms);
+
+   //! \return IDs of the batches whose bookings changed
+   QVector<int> removeBatch(int const batchId);
+
+   /**
+    * \return Where batch \c batchId is booked, or \c std::nullopt if it isn't in the plan or there is no vessel that
+    *         it fits in.
+    */
+   std::optional<Booking> booking(int const batchId) const;
+
+   /**
+    * \brief Answer "when is the first slot for this batch?" without changing the plan -- ie as though it were added
+    *        after all the batches already planned.
+    *
+    * \return \c std::nullopt if there is no brewhouse or fermenter the batch fits in
+    */
+   std::optional<Booking> earliestSlot(Requirements const & requirements, qint64 const notBefore_ms) const;
+
+private:
+   // Private implementation details - see https://herbsutter.com/gotw/_100/
+   class impl;
+   std::unique_ptr<impl> pimpl;
+};
+
+#endif
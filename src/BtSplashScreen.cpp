@@ -17,6 +17,7 @@
  ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
 #include "BtSplashScreen.h"
 
+#include <QCoreApplication>
 #include <QPixmap>
 
 #include "config.h"
@@ -44,3 +45,10 @@ BtSplashScreen::BtSplashScreen(QScreen* parent) :
 void BtSplashScreen::showMessage(QString const& message) {
    QSplashScreen::showMessage(message, Qt::AlignLeft, Qt::white);
 }
+
+void BtSplashScreen::showPhase(char const * phaseName) {
+   this->showMessage(tr("Loading: %1").arg(phaseName));
+   // We are on the GUI thread, which won't otherwise get back to the event loop until startup is finished
+   QCoreApplication::processEvents();
+   return;
+}
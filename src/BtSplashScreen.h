@@ -40,6 +40,11 @@ public:
 #endif
 
    void showMessage(QString const& message);
+
+   /**
+    * \brief Show that we have got to \c phaseName (see \c Diagnostics::ScopedStartupPhaseTimer) in starting up
+    */
+   void showPhase(char const * phaseName);
 };
 
 #endif
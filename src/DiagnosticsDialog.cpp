@@ -0,0 +1,131 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * DiagnosticsDialog.cpp is part of Brewtarget, and is copyright the following authors 2024:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#include "DiagnosticsDialog.h"
+
+#include <optional>
+
+#include <QEvent>
+#include <QFontDatabase>
+#include <QHideEvent>
+#include <QPlainTextEdit>
+#include <QScrollBar>
+#include <QShowEvent>
+#include <QTimer>
+#include <QVBoxLayout>
+#include <QWidget>
+
+#include "utils/Diagnostics.h"
+
+namespace {
+   int constexpr refreshInterval_ms = 1000;
+}
+
+// This private implementation class holds all private non-virtual members of DiagnosticsDialog
+class DiagnosticsDialog::impl {
+
+public:
+
+   /**
+    * Constructor
+    *
+    * As with HelpDialog, it's safe to pass in a reference to DiagnosticsDialog from its constructor because there is
+    * nothing else in that class to initialise by the time this pimpl constructor is being called.
+    */
+   impl(DiagnosticsDialog & diagnosticsDialog) : text{new QPlainTextEdit{}},
+                                                 layout{new QVBoxLayout{&diagnosticsDialog}},
+                                                 timer{new QTimer{&diagnosticsDialog}},
+                                                 previousSnapshot{std::nullopt} {
+      this->layout->addWidget(this->text.get());
+      this->text->setReadOnly(true);
+      this->text->setLineWrapMode(QPlainTextEdit::NoWrap);
+      // The report is laid out in columns, so it needs a fixed-width font
+      this->text->setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+      this->text->setMinimumSize(640, 480);
+
+      this->timer->setInterval(refreshInterval_ms);
+      QObject::connect(this->timer.get(), &QTimer::timeout, &diagnosticsDialog, [this]() { this->refresh(); });
+
+      this->setText(diagnosticsDialog);
+      return;
+   }
+
+   ~impl() = default;
+
+   /**
+    * Set the (translatable) parts of the dialog
+    */
+   void setText(DiagnosticsDialog & diagnosticsDialog) {
+      diagnosticsDialog.setWindowTitle(DiagnosticsDialog::tr("Diagnostics"));
+      return;
+   }
+
+   /**
+    * Show the latest counters, with rates since the last time we did so
+    */
+   void refresh() {
+      Diagnostics::Snapshot currentSnapshot = Diagnostics::takeSnapshot();
+      // Keep the user's scroll position, otherwise it's impossible to read the bottom of the report
+      int const scrollPosition = this->text->verticalScrollBar()->value();
+      this->text->setPlainText(
+         Diagnostics::format(currentSnapshot, this->previousSnapshot ? &(*this->previousSnapshot) : nullptr)
+      );
+      this->text->verticalScrollBar()->setValue(scrollPosition);
+      this->previousSnapshot = std::move(currentSnapshot);
+      return;
+   }
+
+   std::unique_ptr<QPlainTextEdit> text;
+   std::unique_ptr<QVBoxLayout> layout;
+   std::unique_ptr<QTimer> timer;
+   std::optional<Diagnostics::Snapshot> previousSnapshot;
+
+};
+
+
+DiagnosticsDialog::DiagnosticsDialog(QWidget * parent) : QDialog(parent),
+                                                         pimpl{std::make_unique<impl>(*this)} {
+   this->setObjectName("diagnosticsDialog");
+   return;
+}
+
+// See https://herbsutter.com/gotw/_100/ for why we need to explicitly define the destructor here (and not in the
+// header file)
+DiagnosticsDialog::~DiagnosticsDialog() = default;
+
+
+void DiagnosticsDialog::changeEvent(QEvent * event) {
+   if (event->type() == QEvent::LanguageChange) {
+      this->pimpl->setText(*this);
+   }
+   // Pass the event down to the base class
+   QDialog::changeEvent(event);
+   return;
+}
+
+void DiagnosticsDialog::showEvent(QShowEvent * event) {
+   // We only need to do the work of taking snapshots while someone is looking at them
+   this->pimpl->previousSnapshot.reset();
+   this->pimpl->refresh();
+   this->pimpl->timer->start();
+   QDialog::showEvent(event);
+   return;
+}
+
+void DiagnosticsDialog::hideEvent(QHideEvent * event) {
+   this->pimpl->timer->stop();
+   QDialog::hideEvent(event);
+   return;
+}
@@ -0,0 +1,243 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * FermentationSimulator.cpp is part of Brewtarget, and is copyright the following authors 2024:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#include "FermentationSimulator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include "Algorithms.h"
+#include "model/Fermentation.h"
+#include "model/FermentationStep.h"
+#include "model/Recipe.h"
+#include "model/RecipeAdditionYeast.h"
+#include "model/Yeast.h"
+
+namespace {
+   //
+   // Rates are for a typical ale yeast at the reference temperature.  Cell counts are millions of cells per millilitre
+   // and extract is in degrees Plato.
+   //
+   double constexpr referenceTemp_c        = 20.0;
+   //! Rates double for each 10°C warmer (up to the top of the yeast's range)
+   double constexpr q10                    = 2.0;
+   //! Below the bottom of the yeast's range, activity tails off to nothing over this many degrees
+   double constexpr coldFalloff_c          = 5.0;
+   double constexpr maxGrowthRate_perHour  = 0.1;
+   double constexpr maxCells_millionPerMl  = 80.0;
+   //! Remaining fermentable extract at which uptake is half its maximum rate
+   double constexpr halfSaturation_plato   = 0.5;
+   //! Maximum extract used per hour by one million cells per millilitre
+   double constexpr maxUptake_platoPerHour = 0.0012;
+
+   //! We count fermentation as done once this fraction of the fermentable extract is left
+   double constexpr terminalFraction       = 0.02;
+   //! How long we let an open-ended fermentation run before giving up on it
+   double constexpr openEndedLimit_h       = 60.0 * 24.0;
+
+   //! Time steps per hour.  Temperatures are only worked out once an hour, as schedules don't change faster than that.
+   int    constexpr stepsPerHour           = 4;
+   double constexpr timeStep_h             = 1.0 / stepsPerHour;
+
+   //! Standard pitch rates, in millions of cells per millilitre per degree Plato, for when we don't know the cell count
+   double constexpr alePitchRate           = 0.75;
+   double constexpr lagerPitchRate         = 1.5;
+
+   double activityAt(FermentationSimulator::Inputs const & inputs, double const temp_c) {
+      double const cappedTemp_c = inputs.maxTemperature_c ? std::min(temp_c, *inputs.maxTemperature_c) : temp_c;
+      double activity = std::pow(q10, (cappedTemp_c - referenceTemp_c) / 10.0);
+      if (inputs.minTemperature_c && temp_c < *inputs.minTemperature_c) {
+         activity *= std::max(1.0 - (*inputs.minTemperature_c - temp_c) / coldFalloff_c, 0.0);
+      }
+      return activity;
+   }
+
+   /**
+    * \brief Where one fermentation has got to in its schedule.  Time only goes forwards, so we never need to look back
+    *        at earlier steps.
+    */
+   struct ScheduleCursor {
+      int    stepIndex   = 0;
+      double stepStart_h = 0.0;
+
+      //! \return Temperature at \c time_h, or \c std::nullopt if the schedule has finished by then
+      std::optional<double> tempAt(QVector<FermentationSimulator::Step> const & schedule, double const time_h) {
+         while (this->stepIndex < schedule.size() &&
+                time_h >= this->stepStart_h + schedule.at(this->stepIndex).duration_h) {
+            this->stepStart_h += schedule.at(this->stepIndex).duration_h;
+            ++this->stepIndex;
+         }
+         if (this->stepIndex >= schedule.size()) {
+            return std::nullopt;
+         }
+         FermentationSimulator::Step const & step = schedule.at(this->stepIndex);
+         double const fraction = (time_h - this->stepStart_h) / step.duration_h;
+         return step.startTemp_c + fraction * (step.endTemp_c - step.startTemp_c);
+      }
+   };
+}
+
+FermentationSimulator::Inputs FermentationSimulator::inputsFor(Recipe & recipe) {
+   Inputs inputs{
+      .og_sg                   = recipe.og(),
+      .attainableFg_sg         = recipe.fg(),
+      .pitch_millionCellsPerMl = 0.0,
+   };
+
+   double cells_billions = 0.0;
+   bool isLager = false;
+   for (auto const & yeastAddition : recipe.yeastAdditions()) {
+      cells_billions += yeastAddition->cellCountBillions().value_or(0);
+      Yeast const * yeast = yeastAddition->yeast();
+      if (yeast) {
+         isLager = isLager || yeast->type() == Yeast::Type::Lager;
+         if (!inputs.minTemperature_c && !inputs.maxTemperature_c) {
+            inputs.minTemperature_c = yeast->minTemperature_c();
+            inputs.maxTemperature_c = yeast->maxTemperature_c();
+         }
+      }
+   }
+   double const batchSize_l = recipe.batchSize_l();
+   if (cells_billions > 0.0 && batchSize_l > 0.0) {
+      // Billions of cells per litre is the same as millions per millilitre
+      inputs.pitch_millionCellsPerMl = cells_billions / batchSize_l;
+   } else {
+      inputs.pitch_millionCellsPerMl =
+         (isLager ? lagerPitchRate : alePitchRate) * Algorithms::SG_20C20C_toPlato(inputs.og_sg);
+   }
+   if (inputs.minTemperature_c && inputs.maxTemperature_c) {
+      inputs.openEndedTemp_c = (*inputs.minTemperature_c + *inputs.maxTemperature_c) / 2.0;
+   }
+
+   if (auto fermentation = recipe.fermentation()) {
+      double previousTemp_c = inputs.openEndedTemp_c;
+      for (auto const & fermentationStep : fermentation->fermentationSteps()) {
+         double const duration_h = fermentationStep->stepTime_days().value_or(0.0) * 24.0;
+         double const startTemp_c = fermentationStep->startTemp_c().value_or(previousTemp_c);
+         double const endTemp_c   = fermentationStep->endTemp_c  ().value_or(startTemp_c);
+         previousTemp_c = endTemp_c;
+         if (duration_h > 0.0) {
+            inputs.schedule.append(Step{duration_h, startTemp_c, endTemp_c});
+         }
+      }
+   }
+
+   return inputs;
+}
+
+QVector<FermentationSimulator::Results> FermentationSimulator::simulate(QVector<Inputs> const & inputs) {
+   std::size_t const numLanes = static_cast<std::size_t>(inputs.size());
+   QVector<Results> results;
+   if (numLanes == 0) {
+      return results;
+   }
+
+   //
+   // Each fermentation is a "lane", and its state is spread across parallel arrays (one entry per lane in each), so
+   // that the inner loop below is the same straight-line arithmetic on consecutive doubles for every lane.
+   //
+   std::vector<double> og_sg(numLanes);
+   std::vector<double> attainable_sg(numLanes);
+   for (std::size_t ii = 0; ii < numLanes; ++ii) {
+      og_sg        [ii] = inputs.at(ii).og_sg;
+      attainable_sg[ii] = inputs.at(ii).attainableFg_sg;
+   }
+   std::vector<double> og_plato(numLanes);
+   std::vector<double> attainable_plato(numLanes);
+   Algorithms::SG_20C20C_toPlato(og_sg        , og_plato        );
+   Algorithms::SG_20C20C_toPlato(attainable_sg, attainable_plato);
+
+   std::vector<double> fermentable_plato(numLanes);
+   std::vector<double> terminal_plato   (numLanes);
+   std::vector<double> cells            (numLanes);
+   std::vector<double> activity         (numLanes, 0.0);
+   //! Negative until the lane reaches terminal gravity
+   std::vector<double> terminal_h       (numLanes);
+   std::vector<double> duration_h       (numLanes);
+   std::vector<ScheduleCursor> cursors  (numLanes);
+   double horizon_h = 0.0;
+   for (std::size_t ii = 0; ii < numLanes; ++ii) {
+      fermentable_plato[ii] = std::max(og_plato[ii] - attainable_plato[ii], 0.0);
+      terminal_plato   [ii] = terminalFraction * fermentable_plato[ii];
+      cells            [ii] = std::max(inputs.at(ii).pitch_millionCellsPerMl, 0.0);
+      terminal_h       [ii] = fermentable_plato[ii] > 0.0 ? -1.0 : 0.0;
+      duration_h       [ii] = 0.0;
+      for (Step const & step : inputs.at(ii).schedule) {
+         duration_h[ii] += step.duration_h;
+      }
+      if (inputs.at(ii).schedule.isEmpty()) {
+         duration_h[ii] = openEndedLimit_h;
+      }
+      horizon_h = std::max(horizon_h, duration_h[ii]);
+   }
+
+   for (int hour = 0; hour < horizon_h; ++hour) {
+      // Temperatures (and so activity) for this hour, taken at its midpoint
+      bool anyActive = false;
+      for (std::size_t ii = 0; ii < numLanes; ++ii) {
+         Inputs const & lane = inputs.at(ii);
+         std::optional<double> const temp_c =
+            lane.schedule.isEmpty() ? std::optional<double>{lane.openEndedTemp_c} :
+                                      cursors[ii].tempAt(lane.schedule, hour + 0.5);
+         // An open-ended fermentation stops once it is done.  One with a schedule carries on to the end of it.
+         bool const finished = !temp_c || hour >= duration_h[ii] || (lane.schedule.isEmpty() && terminal_h[ii] >= 0.0);
+         activity[ii] = finished ? 0.0 : activityAt(lane, *temp_c);
+         anyActive = anyActive || activity[ii] > 0.0;
+      }
+      if (!anyActive) {
+         break;
+      }
+
+      for (int step = 0; step < stepsPerHour; ++step) {
+         for (std::size_t ii = 0; ii < numLanes; ++ii) {
+            double const uptake = activity[ii] * cells[ii] *
+                                  fermentable_plato[ii] / (halfSaturation_plato + fermentable_plato[ii]);
+            cells[ii] += timeStep_h * maxGrowthRate_perHour * uptake * (1.0 - cells[ii] / maxCells_millionPerMl);
+            fermentable_plato[ii] = std::max(fermentable_plato[ii] - timeStep_h * maxUptake_platoPerHour * uptake, 0.0);
+         }
+      }
+
+      for (std::size_t ii = 0; ii < numLanes; ++ii) {
+         bool const reachedTerminal = terminal_h[ii] < 0.0 && fermentable_plato[ii] <= terminal_plato[ii];
+         terminal_h[ii] = reachedTerminal ? hour + 1.0 : terminal_h[ii];
+      }
+   }
+
+   std::vector<double> fg_plato(numLanes);
+   for (std::size_t ii = 0; ii < numLanes; ++ii) {
+      fg_plato[ii] = attainable_plato[ii] + fermentable_plato[ii];
+   }
+   std::vector<double> fg_sg(numLanes);
+   Algorithms::PlatoToSG_20C20C(fg_plato, fg_sg);
+
+   results.reserve(static_cast<int>(numLanes));
+   for (std::size_t ii = 0; ii < numLanes; ++ii) {
+      // An open-ended fermentation that finished is, by definition, left long enough to get all the way down
+      bool const reachesAttainable = inputs.at(ii).schedule.isEmpty() && terminal_h[ii] >= 0.0;
+      results.append(
+         Results{
+            .fg_sg               = reachesAttainable ? attainable_sg[ii] : fg_sg[ii],
+            .timeToTerminal_days = terminal_h[ii] >= 0.0 ? std::optional<double>{terminal_h[ii] / 24.0} : std::nullopt,
+         }
+      );
+   }
+   return results;
+}
+
+FermentationSimulator::Results FermentationSimulator::simulate(Inputs const & inputs) {
+   return FermentationSimulator::simulate(QVector<Inputs>{inputs}).at(0);
+}
@@ -0,0 +1,87 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * FermentationSimulator.h is part of Brewtarget, and is copyright the following authors 2024:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#ifndef FERMENTATIONSIMULATOR_H
+#define FERMENTATIONSIMULATOR_H
+#pragma once
+
+#include <optional>
+
+#include <QVector>
+
+class Recipe;
+
+/*!
+ * \brief A simple model of fermentation, for predicting how far a recipe's fermentation schedule gets it towards its
+ *        final gravity, and how long it takes to get there.
+ *
+ *        \c Recipe works out FG just from the yeast's attenuation, which is really the gravity the yeast could get to
+ *        given as long as it needs.  Here we follow the yeast population and the remaining fermentable extract through
+ *        the schedule: cells grow logistically while there is sugar to feed on, sugar is used up in proportion to the
+ *        number of cells (tailing off as it runs out), and both go faster the warmer it is.  It is a rough model, with
+ *        typical textbook rates for an ale yeast, but it is enough to show, eg, that a lager schedule with a short
+ *        primary will finish high, or that pitching more yeast gets you to terminal gravity sooner.
+ *
+ *        Nothing in here touches the model once the inputs have been taken, so it is safe to simulate on any thread.
+ *        Any number of fermentations (eg a whole recipe library, or lots of variants of one schedule) can be
+ *        simulated in one call; they are stepped through time together, with the per-time-step sums laid out as
+ *        straight loops over arrays of doubles that the compiler can vectorise.
+ */
+namespace FermentationSimulator {
+
+   //! One step of the schedule.  Temperature changes linearly from the start to the end of the step.
+   struct Step {
+      double duration_h;
+      double startTemp_c;
+      double endTemp_c;
+   };
+
+   struct Inputs {
+      double og_sg;
+      //! The gravity the yeast would get down to given enough time, ie the FG that \c Recipe calculates
+      double attainableFg_sg;
+      //! Initial yeast cell count, in millions of cells per millilitre of wort
+      double pitch_millionCellsPerMl;
+      //! The yeast's temperature range, if known.  Below the minimum, the yeast soon stops working.
+      std::optional<double> minTemperature_c = std::nullopt;
+      std::optional<double> maxTemperature_c = std::nullopt;
+      /**
+       * \brief If empty, we assume fermentation is left to finish at \c openEndedTemp_c, so the results just tell us
+       *        how long that takes.
+       */
+      QVector<Step> schedule = {};
+      double openEndedTemp_c = 20.0;
+   };
+
+   struct Results {
+      //! Gravity at the end of the schedule
+      double fg_sg;
+      //! How long until (nearly all) the fermentable extract is used up, or \c std::nullopt if the schedule ends first
+      std::optional<double> timeToTerminal_days;
+   };
+
+   /**
+    * \brief Take the inputs for simulating \c recipe's fermentation, from its gravities, yeast additions and
+    *        fermentation steps.  (Non-const because \c Recipe::og and \c Recipe::fg may need to recalculate.)
+    */
+   Inputs inputsFor(Recipe & recipe);
+
+   //! \return The results for each of \c inputs, in the same order
+   QVector<Results> simulate(QVector<Inputs> const & inputs);
+
+   Results simulate(Inputs const & inputs);
+}
+
+#endif
@@ -0,0 +1,176 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * GlobalSearchDialog.cpp is part of Brewtarget, and is copyright the following authors 2024:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#include "GlobalSearchDialog.h"
+
+#include <QElapsedTimer>
+#include <QEvent>
+#include <QHeaderView>
+#include <QLabel>
+#include <QLineEdit>
+#include <QTimer>
+#include <QTreeWidget>
+#include <QTreeWidgetItem>
+#include <QVBoxLayout>
+#include <QWidget>
+
+#include "database/ObjectStore.h"
+#include "database/SearchIndex.h"
+#include "model/NamedEntity.h"
+
+namespace {
+   //! Wait this long after the last keystroke before searching, so we don't search for every prefix of a word
+   int constexpr searchDelay_ms = 150;
+
+   int constexpr maxHitsToShow = 200;
+}
+
+// This private implementation class holds all private non-virtual members of GlobalSearchDialog
+class GlobalSearchDialog::impl {
+
+public:
+
+   /**
+    * Constructor
+    *
+    * As with DiagnosticsDialog, it's safe to pass in a reference to GlobalSearchDialog from its constructor because
+    * there is nothing else in that class to initialise by the time this pimpl constructor is being called.
+    */
+   impl(GlobalSearchDialog & globalSearchDialog) :
+      searchBox  {new QLineEdit{}},
+      hits       {new QTreeWidget{}},
+      status     {new QLabel{}},
+      layout     {new QVBoxLayout{&globalSearchDialog}},
+      searchTimer{new QTimer{&globalSearchDialog}},
+      results    {} {
+      this->layout->addWidget(this->searchBox.get());
+      this->layout->addWidget(this->hits.get());
+      this->layout->addWidget(this->status.get());
+      this->searchBox->setClearButtonEnabled(true);
+      this->hits->setRootIsDecorated(false);
+      this->hits->setColumnCount(3);
+      this->hits->header()->setSectionResizeMode(QHeaderView::ResizeToContents);
+      this->hits->header()->setStretchLastSection(true);
+      this->hits->setMinimumSize(640, 400);
+
+      this->searchTimer->setSingleShot(true);
+      this->searchTimer->setInterval(searchDelay_ms);
+      QObject::connect(this->searchTimer.get(), &QTimer::timeout, &globalSearchDialog, [this]() {
+         this->runSearch();
+         return;
+      });
+      QObject::connect(this->searchBox.get(), &QLineEdit::textEdited, &globalSearchDialog, [this]() {
+         this->searchTimer->start();
+         return;
+      });
+      QObject::connect(this->hits.get(), &QTreeWidget::itemDoubleClicked, &globalSearchDialog,
+                       [this, &globalSearchDialog](QTreeWidgetItem * item, int) {
+         // Items are in the same order as the results
+         int const index = this->hits->indexOfTopLevelItem(item);
+         if (index < 0 || index >= this->results.size()) {
+            return;
+         }
+         SearchIndex::Hit const & hit = this->results.at(index);
+         std::shared_ptr<QObject> object = hit.objectStore->getById(hit.id);
+         NamedEntity * namedEntity = qobject_cast<NamedEntity *>(object.get());
+         if (namedEntity) {
+            emit globalSearchDialog.hitChosen(namedEntity);
+         }
+         return;
+      });
+
+      this->setText(globalSearchDialog);
+      return;
+   }
+
+   ~impl() = default;
+
+   /**
+    * Set the (translatable) parts of the dialog
+    */
+   void setText(GlobalSearchDialog & globalSearchDialog) {
+      globalSearchDialog.setWindowTitle(GlobalSearchDialog::tr("Search"));
+      this->searchBox->setPlaceholderText(GlobalSearchDialog::tr("Search names and notes of everything"));
+      this->hits->setHeaderLabels({GlobalSearchDialog::tr("Type"),
+                                   GlobalSearchDialog::tr("Name"),
+                                   GlobalSearchDialog::tr("Match")});
+      return;
+   }
+
+   void runSearch() {
+      this->searchTimer->stop();
+      this->hits->clear();
+
+      QElapsedTimer timer;
+      timer.start();
+      this->results = SearchIndex::search(this->searchBox->text(), maxHitsToShow);
+      qint64 const elapsed_ms = timer.elapsed();
+
+      for (SearchIndex::Hit const & hit : this->results) {
+         auto item = new QTreeWidgetItem{this->hits.get()};
+         item->setText(0, hit.typeName);
+         item->setText(1, hit.name);
+         // Snippets can span several lines of notes, but we want one line per hit
+         item->setText(2, QString{hit.snippet}.replace('\n', ' '));
+      }
+
+      if (this->searchBox->text().trimmed().isEmpty()) {
+         this->status->clear();
+      } else {
+         this->status->setText(
+            GlobalSearchDialog::tr("%n hit(s) in %1 ms (double-click to show)", "", this->results.size()).arg(
+               elapsed_ms
+            )
+         );
+      }
+      return;
+   }
+
+   std::unique_ptr<QLineEdit>   searchBox;
+   std::unique_ptr<QTreeWidget> hits;
+   std::unique_ptr<QLabel>      status;
+   std::unique_ptr<QVBoxLayout> layout;
+   std::unique_ptr<QTimer>      searchTimer;
+   //! The hits currently shown, in the same order as the items in \c hits
+   QVector<SearchIndex::Hit>    results;
+};
+
+
+GlobalSearchDialog::GlobalSearchDialog(QWidget * parent) : QDialog(parent),
+                                                           pimpl{std::make_unique<impl>(*this)} {
+   this->setObjectName("globalSearchDialog");
+   return;
+}
+
+// See https://herbsutter.com/gotw/_100/ for why we need to explicitly define the destructor here (and not in the
+// header file)
+GlobalSearchDialog::~GlobalSearchDialog() = default;
+
+void GlobalSearchDialog::search(QString const & searchText) {
+   this->pimpl->searchBox->setText(searchText);
+   this->pimpl->runSearch();
+   this->show();
+   this->raise();
+   return;
+}
+
+void GlobalSearchDialog::changeEvent(QEvent * event) {
+   if (event->type() == QEvent::LanguageChange) {
+      this->pimpl->setText(*this);
+   }
+   // Pass the event down to the base class
+   QDialog::changeEvent(event);
+   return;
+}
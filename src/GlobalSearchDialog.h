@@ -0,0 +1,56 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * GlobalSearchDialog.h is part of Brewtarget, and is copyright the following authors 2024:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#ifndef GLOBALSEARCHDIALOG_H
+#define GLOBALSEARCHDIALOG_H
+#pragma once
+
+#include <memory> // For PImpl
+
+#include <QDialog>
+
+class NamedEntity;
+class QEvent;
+class QWidget;
+
+/*!
+ * \class GlobalSearchDialog
+ *
+ * \brief Shows the results of searching the names and notes of all recipes, brew notes and ingredients at once (see
+ *        \c SearchIndex).  Results are updated as the user types.
+ */
+class GlobalSearchDialog : public QDialog {
+   Q_OBJECT
+
+public:
+   GlobalSearchDialog(QWidget * parent = nullptr);
+   ~GlobalSearchDialog();
+
+   //! \brief Search for \c searchText and show the dialog
+   void search(QString const & searchText);
+
+   virtual void changeEvent(QEvent * event);
+
+signals:
+   //! \brief Emitted when the user double-clicks one of the hits
+   void hitChosen(NamedEntity * namedEntity);
+
+private:
+   // Private implementation details - see https://herbsutter.com/gotw/_100/
+   class impl;
+   std::unique_ptr<impl> pimpl;
+};
+
+#endif
@@ -0,0 +1,381 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * GrainBillSolver.cpp is part of Brewtarget, and is copyright the following authors 2024:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#include "GrainBillSolver.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <vector>
+
+#include <QHash>
+
+#include "Algorithms.h"
+#include "Logging.h"
+#include "model/Recipe.h"
+#include "model/RecipeAdditionFermentable.h"
+#include "PhysicalConstants.h"
+
+namespace {
+   //! Weight of the pull towards the starting amounts, relative to the targets
+   double constexpr regularisationWeight = 1.0e-3;
+   //! We stop iterating once no amount changes by more than this fraction of the total weight
+   double constexpr tolerance = 1.0e-9;
+   int constexpr maxSweeps = 1000;
+   //! Sugar retention depends (a little) on the amount of grain, so we re-solve a few times with it updated
+   int constexpr maxRetentionIterations = 4;
+
+   //! All the columns of \c RecipeEvaluator::GrainBill, each of which is proportional to the amount of the addition
+   std::array<QVector<double> RecipeEvaluator::GrainBill::*, 10> constexpr grainBillColumns{
+      &RecipeEvaluator::GrainBill::grain_kg,
+      &RecipeEvaluator::GrainBill::grainInMash_kg,
+      &RecipeEvaluator::GrainBill::addedVolume_l,
+      &RecipeEvaluator::GrainBill::colorWeight_srmKg,
+      &RecipeEvaluator::GrainBill::hoppedExtractWeight_ibuGalPerLbKg,
+      &RecipeEvaluator::GrainBill::sugar_kg,
+      &RecipeEvaluator::GrainBill::sugarIgnoreEfficiency_kg,
+      &RecipeEvaluator::GrainBill::lateSugar_kg,
+      &RecipeEvaluator::GrainBill::lateSugarIgnoreEfficiency_kg,
+      &RecipeEvaluator::GrainBill::nonFermentableSugar_kg,
+   };
+
+   /**
+    * \brief \c snapshot with the amount of each fermentable addition changed from \c from to \c to.  (Rows with a zero
+    *        \c from amount are all zeros already, so we leave them as they are.)
+    */
+   RecipeEvaluator::Snapshot withQuantities(RecipeEvaluator::Snapshot snapshot,
+                                            QVector<double> const & from,
+                                            QVector<double> const & to) {
+      for (auto const column : grainBillColumns) {
+         QVector<double> & values = snapshot.grainBill.*column;
+         for (int row = 0; row < values.size(); ++row) {
+            if (from.at(row) > 0.0) {
+               values[row] *= to.at(row) / from.at(row);
+            }
+         }
+      }
+      snapshot.grainBillTotals = RecipeEvaluator::grainBillTotals(snapshot.grainBill);
+      return snapshot;
+   }
+
+   //! \return Mass of sugar that gives gravity \c og in \c wort_l of wort.  This is the inverse of \c getPlato.
+   double sugarFor_kg(double const og, double const wort_l) {
+      double const plato = Algorithms::SG_20C20C_toPlato(og);
+      return plato * wort_l / (100.0 - plato + plato / PhysicalConstants::sucroseDensity_kgL);
+   }
+
+   /**
+    * \return Total color weight (see \c RecipeEvaluator::GrainBillTotals) that gives \c color_srm.  The MCU to SRM
+    *         conversion depends on the color formula setting, and isn't always easy to invert, so we just use
+    *         bisection, which is fine as it's always increasing.
+    */
+   double colorWeightFor_srmKg(RecipeEvaluator::Snapshot snapshot,
+                               RecipeEvaluator::VolumeEstimates const & volumes,
+                               double const color_srm) {
+      auto colorOf = [&snapshot, &volumes](double const colorWeight_srmKg) {
+         snapshot.grainBillTotals.colorWeight_srmKg = colorWeight_srmKg;
+         return RecipeEvaluator::color_srm(snapshot, volumes);
+      };
+      double low  = 0.0;
+      double high = 1.0;
+      for (int ii = 0; ii < 64 && colorOf(high) < color_srm; ++ii) {
+         low = high;
+         high *= 2.0;
+      }
+      for (int ii = 0; ii < 64; ++ii) {
+         double const middle = (low + high) / 2.0;
+         (colorOf(middle) < color_srm ? low : high) = middle;
+      }
+      return (low + high) / 2.0;
+   }
+
+   /**
+    * \brief The normal equations (H x = f) of a weighted least squares problem, built up one equation at a time
+    */
+   struct NormalEquations {
+      explicit NormalEquations(int const size) :
+         size{size},
+         hessian(static_cast<std::size_t>(size) * size, 0.0),
+         gradient(size, 0.0) {
+         return;
+      }
+
+      //! Add the equation sum(coefficients[jj] * x[jj]) = target, scaled by \c weight
+      void add(std::vector<double> const & coefficients, double const target, double const weight) {
+         double const weightSquared = weight * weight;
+         for (int ii = 0; ii < this->size; ++ii) {
+            if (coefficients[ii] == 0.0) {
+               continue;
+            }
+            for (int jj = 0; jj < this->size; ++jj) {
+               this->hessian[ii * this->size + jj] += weightSquared * coefficients[ii] * coefficients[jj];
+            }
+            this->gradient[ii] += weightSquared * coefficients[ii] * target;
+         }
+         return;
+      }
+
+      /**
+       * \brief Minimise, subject to x >= 0, by projected Gauss-Seidel (ie minimising over one amount at a time and
+       *        clamping it at zero).  This converges for any convex problem with a positive diagonal, which the
+       *        regularisation guarantees, and for a problem this size it's quicker than anything fancier.
+       */
+      void solve(std::vector<double> & x, double const scale) const {
+         for (int sweep = 0; sweep < maxSweeps; ++sweep) {
+            double maxChange = 0.0;
+            for (int ii = 0; ii < this->size; ++ii) {
+               double residual = -this->gradient[ii];
+               for (int jj = 0; jj < this->size; ++jj) {
+                  residual += this->hessian[ii * this->size + jj] * x[jj];
+               }
+               double const newValue = std::max(0.0, x[ii] - residual / this->hessian[ii * this->size + ii]);
+               maxChange = std::max(maxChange, std::abs(newValue - x[ii]));
+               x[ii] = newValue;
+            }
+            if (maxChange <= tolerance * scale) {
+               break;
+            }
+         }
+         return;
+      }
+
+      int const size;
+      std::vector<double> hessian;
+      std::vector<double> gradient;
+   };
+
+   double totalWeight_kg(GrainBillSolver::Inputs const & inputs, QVector<double> const & quantities) {
+      double total_kg = 0.0;
+      for (int row = 0; row < quantities.size(); ++row) {
+         if (inputs.amountIsWeight.at(row)) {
+            total_kg += quantities.at(row);
+         }
+      }
+      return total_kg;
+   }
+}
+
+GrainBillSolver::Inputs GrainBillSolver::inputsFor(Recipe & recipe, RecipeScaling::Plan const & plan) {
+   Inputs inputs{
+      .snapshot       = RecipeEvaluator::snapshotOf(recipe),
+      .additions      = {},
+      .types          = {},
+      .quantities     = {},
+      .amountIsWeight = {},
+      .adjustable     = {},
+   };
+   RecipeEvaluator::Snapshot & snapshot = inputs.snapshot;
+   snapshot.batchSize_l    = plan.batchSize_l;
+   snapshot.efficiency_pct = plan.efficiency_pct;
+   if (plan.equipment) {
+      snapshot.equipment = RecipeEvaluator::snapshotOf(*plan.equipment);
+   }
+   if (snapshot.boil) {
+      snapshot.boil->preBoilSize_l = plan.preBoilSize_l;
+      if (plan.boilTime_mins) {
+         snapshot.boil->boilTime_mins = *plan.boilTime_mins;
+      }
+   }
+   // RecipeScaling::apply resets the mash step amounts so that the user re-runs the mash wizard
+   if (snapshot.mashTotalWater_l) {
+      snapshot.mashTotalWater_l = 0.0;
+   }
+
+   QHash<RecipeAdditionFermentable const *, double> plannedQuantities;
+   for (auto const & [fermentableAddition, quantity] : plan.fermentableQuantities) {
+      plannedQuantities.insert(fermentableAddition.get(), quantity);
+   }
+
+   // We skip the same additions as RecipeEvaluator::snapshotOf, so that we have one entry per row of the grain bill
+   QVector<double> currentQuantities;
+   for (auto const & fermentableAddition : recipe.fermentableAdditions()) {
+      auto const fermentable = fermentableAddition->fermentable();
+      if (!fermentable) {
+         continue;
+      }
+      double const current = fermentableAddition->amount().quantity;
+      double const planned = plannedQuantities.value(fermentableAddition.get(), current);
+      bool const amountIsWeight = fermentableAddition->amountIsWeight();
+      inputs.additions     .append(fermentableAddition);
+      inputs.types         .append(fermentable->type());
+      inputs.quantities    .append(planned);
+      inputs.amountIsWeight.append(amountIsWeight);
+      inputs.adjustable    .append(amountIsWeight && current > 0.0 && planned > 0.0);
+      currentQuantities    .append(current);
+   }
+   if (currentQuantities.size() != snapshot.grainBill.size()) {
+      // This is a coding error
+      qCCritical(Logging::recipe) <<
+         Q_FUNC_INFO << "Have" << currentQuantities.size() << "fermentable additions for" <<
+         snapshot.grainBill.size() << "rows of the grain bill";
+      Q_ASSERT(false);
+   }
+
+   snapshot = withQuantities(snapshot, currentQuantities, inputs.quantities);
+   return inputs;
+}
+
+GrainBillSolver::Solution GrainBillSolver::solve(Inputs const & inputs, Targets const & targets) {
+   int const numRows = inputs.quantities.size();
+   QVector<int> variables;
+   for (int row = 0; row < numRows; ++row) {
+      if (inputs.adjustable.at(row)) {
+         variables.append(row);
+      }
+   }
+   int const numVariables = variables.size();
+
+   QVector<double> quantities = inputs.quantities;
+   // Everything is weighted relative to the starting weight, so the tuning constants don't depend on batch size
+   double const scale_kg = std::max(totalWeight_kg(inputs, quantities), 1.0e-3);
+
+   bool const haveTargets = targets.og || targets.color_srm || !targets.typePercentages.empty();
+   if (haveTargets && numVariables > 0) {
+      //
+      // Contribution of each kilogram of each addition.  Rows with zero amount contribute nothing, and aren't
+      // adjustable, so they don't need an entry.
+      //
+      auto perKg = [&inputs, numRows](QVector<double> const & column) {
+         std::vector<double> result(numRows, 0.0);
+         for (int row = 0; row < numRows; ++row) {
+            if (inputs.quantities.at(row) > 0.0) {
+               result[row] = column.at(row) / inputs.quantities.at(row);
+            }
+         }
+         return result;
+      };
+      RecipeEvaluator::GrainBill const & grainBill = inputs.snapshot.grainBill;
+      std::vector<double> const sugarPerKg                 = perKg(grainBill.sugar_kg);
+      std::vector<double> const sugarIgnoreEfficiencyPerKg = perKg(grainBill.sugarIgnoreEfficiency_kg);
+      std::vector<double> const colorWeightPerKg           = perKg(grainBill.colorWeight_srmKg);
+
+      std::vector<double> coefficients(numVariables);
+      //
+      // Add the equation sum(contribution[row] * quantity[row]) = target, with the contributions of the additions we
+      // can't change moved over to the target side, and scaled so that the error is relative to the target.
+      //
+      auto addEquation = [&](NormalEquations & equations,
+                             auto const & contribution,
+                             double target,
+                             double const weight) {
+         for (int row = 0; row < numRows; ++row) {
+            if (!inputs.adjustable.at(row)) {
+               target -= contribution(row) * quantities.at(row);
+            }
+         }
+         for (int ii = 0; ii < numVariables; ++ii) {
+            coefficients[ii] = contribution(variables.at(ii));
+         }
+         equations.add(coefficients, target, weight);
+         return;
+      };
+
+      for (int iteration = 0; iteration < maxRetentionIterations; ++iteration) {
+         RecipeEvaluator::Snapshot const current = withQuantities(inputs.snapshot, inputs.quantities, quantities);
+         auto const volumes = RecipeEvaluator::volumeEstimates(current, RecipeEvaluator::grains(current));
+         double const efficiency = current.efficiency_pct / 100.0;
+         double const retention  = RecipeEvaluator::sugarRetention(current, volumes);
+
+         NormalEquations equations{numVariables};
+         if (targets.og) {
+            double const target_kg = sugarFor_kg(*targets.og, volumes.finalVolumeNoLosses_l);
+            addEquation(equations,
+                        [&](int const row) {
+                           return efficiency * sugarPerKg[row] + retention * sugarIgnoreEfficiencyPerKg[row];
+                        },
+                        target_kg,
+                        1.0 / std::max(target_kg, 1.0e-6));
+         }
+         if (targets.color_srm) {
+            double const target_srmKg = colorWeightFor_srmKg(current, volumes, *targets.color_srm);
+            addEquation(equations,
+                        [&](int const row) { return colorWeightPerKg[row]; },
+                        target_srmKg,
+                        1.0 / std::max(target_srmKg, 1.0e-6));
+         }
+         for (auto const & [type, percentage] : targets.typePercentages) {
+            // Weight of this type minus the required proportion of the total weight should be zero
+            addEquation(equations,
+                        [&, type = type, percentage = percentage](int const row) {
+                           if (!inputs.amountIsWeight.at(row)) {
+                              return 0.0;
+                           }
+                           return (inputs.types.at(row) == type ? 1.0 : 0.0) - percentage / 100.0;
+                        },
+                        0.0,
+                        1.0 / scale_kg);
+         }
+         //
+         // The pull towards the starting amounts is weighted by one over each amount, so that, as far as the targets
+         // leave them free, the amounts change in proportion (rather than all by the same number of kilograms).
+         //
+         std::fill(coefficients.begin(), coefficients.end(), 0.0);
+         for (int ii = 0; ii < numVariables; ++ii) {
+            double const start_kg = inputs.quantities.at(variables.at(ii));
+            coefficients[ii] = 1.0;
+            equations.add(coefficients, start_kg, regularisationWeight / std::sqrt(start_kg * scale_kg));
+            coefficients[ii] = 0.0;
+         }
+
+         std::vector<double> x(numVariables);
+         for (int ii = 0; ii < numVariables; ++ii) {
+            x[ii] = quantities.at(variables.at(ii));
+         }
+         equations.solve(x, scale_kg);
+
+         double maxChange_kg = 0.0;
+         for (int ii = 0; ii < numVariables; ++ii) {
+            double & quantity = quantities[variables.at(ii)];
+            maxChange_kg = std::max(maxChange_kg, std::abs(x[ii] - quantity));
+            quantity = x[ii];
+         }
+         if (maxChange_kg <= tolerance * scale_kg) {
+            break;
+         }
+      }
+   }
+
+   auto const results =
+      RecipeEvaluator::evaluate(withQuantities(inputs.snapshot, inputs.quantities, quantities));
+   Solution solution{
+      .quantities      = quantities,
+      .og              = results.gravities.og,
+      .color_srm       = results.color_srm,
+      .typePercentages = {},
+   };
+   double const newTotal_kg = totalWeight_kg(inputs, quantities);
+   if (newTotal_kg > 0.0) {
+      for (int row = 0; row < numRows; ++row) {
+         if (inputs.amountIsWeight.at(row)) {
+            solution.typePercentages[inputs.types.at(row)] += quantities.at(row) / newTotal_kg * 100.0;
+         }
+      }
+   }
+   qCDebug(Logging::recipe) <<
+      Q_FUNC_INFO << "Solved for" << numVariables << "of" << numRows << "fermentable amounts, giving OG" <<
+      solution.og << "and color" << solution.color_srm << "SRM";
+   return solution;
+}
+
+void GrainBillSolver::applyTo(RecipeScaling::Plan & plan, Inputs const & inputs, Solution const & solution) {
+   QHash<RecipeAdditionFermentable const *, double> newQuantities;
+   for (int row = 0; row < inputs.additions.size(); ++row) {
+      newQuantities.insert(inputs.additions.at(row).get(), solution.quantities.at(row));
+   }
+   for (auto & [fermentableAddition, quantity] : plan.fermentableQuantities) {
+      quantity = newQuantities.value(fermentableAddition.get(), quantity);
+   }
+   return;
+}
@@ -0,0 +1,102 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * GrainBillSolver.h is part of Brewtarget, and is copyright the following authors 2024:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#ifndef GRAINBILLSOLVER_H
+#define GRAINBILLSOLVER_H
+#pragma once
+
+#include <map>
+#include <memory>
+#include <optional>
+
+#include <QVector>
+
+#include "model/Fermentable.h"
+#include "RecipeEvaluator.h"
+#include "RecipeScaling.h"
+
+class Recipe;
+class RecipeAdditionFermentable;
+
+/**
+ * \brief Working out the amounts of a recipe's fermentables that give a target OG, color and/or mix of fermentable
+ *        types -- ie the opposite of \c RecipeScaling, which starts from the amounts.
+ *
+ *        Everything in the grain bill is linear in the amount of each addition (see \c RecipeEvaluator::GrainBill),
+ *        so, once we have converted the target OG into a mass of sugar and the target color into a total color
+ *        weight, each target is a linear equation in the amounts.  We solve these, weighted by how far out each one
+ *        is relative to its target, as a least squares problem with the amounts constrained to be non-negative.  A
+ *        small pull towards the starting amounts means there is always a unique answer, and that, where the targets
+ *        don't pin down every amount, the result stays close to the original recipe.
+ *
+ *        The problem has one unknown per fermentable addition, so solving it is far quicker than the user can change
+ *        the targets, which means it can be done on the GUI thread every time they do.
+ */
+namespace GrainBillSolver {
+
+   /**
+    * \brief What we are aiming for.  Anything not set is not a target.
+    */
+   struct Targets {
+      std::optional<double>               og;
+      std::optional<double>               color_srm;
+      //! Percentage (by weight) of the grain bill for each type of fermentable
+      std::map<Fermentable::Type, double> typePercentages;
+   };
+
+   struct Inputs {
+      //! The recipe as it will be once the \c RecipeScaling::Plan is applied
+      RecipeEvaluator::Snapshot                           snapshot;
+      //! The addition for each row of \c snapshot.grainBill
+      QVector<std::shared_ptr<RecipeAdditionFermentable>> additions;
+      QVector<Fermentable::Type>                          types;
+      //! Amount of each addition in \c snapshot (ie per the plan), in kilograms (or liters if not measured by weight)
+      QVector<double>                                     quantities;
+      QVector<bool>                                       amountIsWeight;
+      //! Whether we can change each amount.  We leave alone additions measured by volume or of zero amount, as we
+      //! don't know how much each kilogram of them would contribute.
+      QVector<bool>                                       adjustable;
+   };
+
+   struct Solution {
+      //! New amount of each addition, in the same order as \c Inputs::additions
+      QVector<double>                     quantities;
+      double                              og;
+      double                              color_srm;
+      //! Percentage (by weight) of the new grain bill for each type of fermentable in it
+      std::map<Fermentable::Type, double> typePercentages;
+   };
+
+   /**
+    * \brief Take the inputs for solving the grain bill of \c recipe after applying \c plan (which can be a plan to
+    *        scale the recipe to its current equipment and efficiency, ie to leave it as it is).  Must be called on
+    *        the GUI thread.
+    */
+   Inputs inputsFor(Recipe & recipe, RecipeScaling::Plan const & plan);
+
+   /**
+    * \brief Find the fermentable amounts closest to meeting \c targets.  With no targets, this just gives back the
+    *        amounts in \c inputs.
+    */
+   Solution solve(Inputs const & inputs, Targets const & targets);
+
+   /**
+    * \brief Put the amounts from \c solution into \c plan (which should be the plan \c inputs were made from), so
+    *        that the new grain bill is applied along with everything else in one batched update.
+    */
+   void applyTo(RecipeScaling::Plan & plan, Inputs const & inputs, Solution const & solution);
+}
+
+#endif
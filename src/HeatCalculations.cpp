@@ -16,6 +16,8 @@
  ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
 #include "HeatCalculations.h"
 
+#include "PhysicalConstants.h"
+
 double const HeatCalculations::Cw_JKgK = 4184.0;
 double const HeatCalculations::Cw_calGC = 1.0;
 double const HeatCalculations::Cgrain_calGC = 0.4;
@@ -23,3 +25,91 @@ double const HeatCalculations::Cgrain_calGC = 0.4;
 double HeatCalculations::equivalentMCProduct(double m1, double c1, double m2, double c2) {
    return m1 * c1 * (1.0 + (m2 * c2)/(m1 * c1));
 }
+
+HeatCalculations::MashSchedule HeatCalculations::solveMashSchedule(MashScheduleInputs const & inputs) {
+   MashSchedule schedule;
+   if (inputs.steps.empty()) {
+      return schedule;
+   }
+   schedule.steps.reserve(inputs.steps.size());
+
+   double const grainHeat_calC = inputs.grain_kg * Cgrain_calGC;
+   double const tunHeat_calC   = inputs.tunWeight_kg * inputs.tunSpecificHeat_calGC;
+
+   //
+   // First step is the strike infusion, where the water has to bring both the grain and the tun up to temperature
+   //
+   double const strikeTemp_c = inputs.steps.front().stepTemp_c;
+   double massWater_kg = inputs.strikeThickness_LKg * inputs.grain_kg;
+   double const waterHeat_calC = Cw_calGC * massWater_kg;
+   double const strikeWaterTemp_c =
+      grainHeat_calC / waterHeat_calC * (strikeTemp_c - inputs.grainTemp_c) +
+      tunHeat_calC   / waterHeat_calC * (strikeTemp_c - inputs.tunTemp_c) +
+      strikeTemp_c;
+   if (strikeWaterTemp_c > inputs.boilingPoint_c) {
+      schedule.error = MashSchedule::Error::StrikeAboveBoiling;
+      schedule.steps.clear();
+      return schedule;
+   }
+   double totalWater_l = massWater_kg;
+   schedule.steps.push_back(MashStepResult{massWater_kg, strikeWaterTemp_c, totalWater_l / inputs.grain_kg});
+
+   //
+   // For the remaining steps, the tun is already up to temperature, so it's just part of the mash's thermal mass
+   //
+   double mashHeat_calC = grainHeat_calC + tunHeat_calC;
+   // Sum of the amounts of all steps so far (which is what the decoction calculation uses for the water in the mash)
+   double amountsSoFar_l = massWater_kg;
+   for (std::size_t ii = 1; ii < inputs.steps.size(); ++ii) {
+      MashScheduleStep const & step = inputs.steps[ii];
+      double const tempInitial_c = inputs.steps[ii - 1].stepTemp_c;
+      double const tempFinal_c   = step.stepTemp_c;
+
+      switch (step.kind) {
+         case MashScheduleStep::Kind::Temperature:
+            schedule.steps.push_back(MashStepResult{std::nullopt, std::nullopt, totalWater_l / inputs.grain_kg});
+            amountsSoFar_l += step.amount_l;
+            break;
+
+         case MashScheduleStep::Kind::Decoction:
+            {
+               double const equipHeat_calC = inputs.equipAdjust ? tunHeat_calC : 0.0;
+               double const waterAndGrainHeat_calC = amountsSoFar_l * Cw_calGC + grainHeat_calC;
+               // Fraction of the water and grain to take out for decoction
+               double const fraction =
+                  ((waterAndGrainHeat_calC + equipHeat_calC) * (tempFinal_c - tempInitial_c)) /
+                  (waterAndGrainHeat_calC * (inputs.boilingPoint_c - tempFinal_c) +
+                   waterAndGrainHeat_calC * (tempFinal_c - tempInitial_c));
+               if (fraction < 0 || fraction > 1) {
+                  schedule.error = MashSchedule::Error::BadDecoction;
+                  schedule.errorStep = ii;
+                  schedule.badDecoctionFraction = fraction;
+                  schedule.steps.clear();
+                  return schedule;
+               }
+               double const decoction_l =
+                  fraction * (amountsSoFar_l + inputs.grain_kg / PhysicalConstants::grainDensity_kgL);
+               schedule.steps.push_back(MashStepResult{decoction_l, std::nullopt, totalWater_l / inputs.grain_kg});
+               amountsSoFar_l += decoction_l;
+            }
+            break;
+
+         case MashScheduleStep::Kind::Infusion:
+            {
+               // Assume adding boiling water to minimize final volume
+               double const infusionTemp_c = inputs.boilingPoint_c;
+               // The previous infusion is now part of the mash
+               mashHeat_calC += massWater_kg * Cw_calGC;
+               massWater_kg = (mashHeat_calC * (tempFinal_c - tempInitial_c)) /
+                              (Cw_calGC * (infusionTemp_c - tempFinal_c));
+               totalWater_l += massWater_kg;
+               schedule.steps.push_back(MashStepResult{massWater_kg, infusionTemp_c, totalWater_l / inputs.grain_kg});
+               amountsSoFar_l += massWater_kg;
+            }
+            break;
+      }
+   }
+
+   schedule.mashHeatCapacity_calC = mashHeat_calC;
+   return schedule;
+}
@@ -18,6 +18,9 @@
 #define HEATCALCULATIONS_H
 #pragma once
 
+#include <optional>
+#include <vector>
+
 /*!
  * \brief Algorithms and constants related to the thermodynamics of beer.
  */
@@ -33,6 +36,83 @@ namespace HeatCalculations {
    extern double const Cw_JKgK;
    extern double const Cw_calGC;
    extern double const Cgrain_calGC;
+
+   /**
+    * \brief One step of a mash, as far as \c solveMashSchedule is concerned
+    */
+   struct MashScheduleStep {
+      enum class Kind {
+         Infusion,
+         Decoction,
+         //! Direct heating: we don't calculate anything for these
+         Temperature
+      };
+      Kind kind;
+      double stepTemp_c;
+      //! Current amount of the step.  Only used for \c Kind::Temperature steps, whose amounts we don't change.
+      double amount_l;
+   };
+
+   /**
+    * \brief Everything \c solveMashSchedule needs to know about the grain, the tun and the steps.  Callers gather this
+    *        up front (eg from \c Recipe, \c Mash and \c Equipment), so that solving does not touch the model.
+    */
+   struct MashScheduleInputs {
+      double grain_kg;
+      double grainTemp_c;
+      double tunTemp_c;
+      double tunWeight_kg;
+      double tunSpecificHeat_calGC;
+      //! Whether to include the tun in decoction calculations (see \c Mash::equipAdjust)
+      bool   equipAdjust;
+      double boilingPoint_c;
+      //! Water-to-grain ratio of the first (strike) infusion
+      double strikeThickness_LKg;
+      //! First step must be an infusion
+      std::vector<MashScheduleStep> steps;
+   };
+
+   struct MashStepResult {
+      //! Infusion volume or decoction volume, or \c std::nullopt if the step's amount should be left as it is
+      std::optional<double> amount_l;
+      //! Only set for infusions
+      std::optional<double> infuseTemp_c;
+      //! Water-to-grain ratio of the mash once this step's water (if any) has been added
+      double thickness_LKg;
+   };
+
+   struct MashSchedule {
+      enum class Error {
+         None,
+         //! The strike water would need to be above boiling to reach the first step's temperature
+         StrikeAboveBoiling,
+         //! The decoction calculation for \c errorStep gave a nonsensical fraction of the mash
+         BadDecoction
+      };
+      Error error = Error::None;
+      //! Index of the step that caused \c error
+      std::size_t errorStep = 0;
+      //! The fraction of the mash calculated as needing to be decocted at \c errorStep
+      double badDecoctionFraction = 0.0;
+
+      //! One result per input step, unless there was an error
+      std::vector<MashStepResult> steps;
+
+      /**
+       * \brief Heat capacity (cal/°C) of the grain, the tun and all but the last infusion, as needed to work out the
+       *        temperature of a further infusion (eg to top up the last step of a no-sparge mash)
+       */
+      double mashHeatCapacity_calC = 0.0;
+   };
+
+   /**
+    * \brief Compute the whole mash schedule in one pass: for each infusion, the volume and temperature of water to add;
+    *        for each decoction, the volume to draw off; and the mash thickness after each step.
+    *
+    *        As in the rest of this file, we assume 1 litre of water weighs 1 kg.  After the first (strike) infusion,
+    *        further infusions are assumed to be of boiling water, to minimise the volume needed.
+    */
+   MashSchedule solveMashSchedule(MashScheduleInputs const & inputs);
 }
 
 #endif
@@ -0,0 +1,416 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * HopSubstitutionFinder.cpp is part of Brewtarget, and is copyright the following authors 2024:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#include "HopSubstitutionFinder.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include <QHash>
+#include <QRegularExpression>
+#include <QRunnable>
+#include <QSemaphore>
+#include <QThread>
+#include <QThreadPool>
+
+#include "database/ObjectStoreWrapper.h"
+#include "Logging.h"
+#include "measurement/Unit.h"
+#include "model/Recipe.h"
+#include "model/RecipeAdditionHop.h"
+#include "utils/NameFilterIndex.h"
+
+namespace {
+   //! Additions in the boil at most this long before flameout (and any after the boil) are mostly about aroma
+   double constexpr lateAddition_mins = 20.0;
+   //! How much oil composition counts for late additions, and for everything else
+   double constexpr aromaWeightLate  = 1.0;
+   double constexpr aromaWeightEarly = 0.25;
+   //! Oil "distance" (between 0 and 1) we assume when we don't know one of the hops' oils
+   double constexpr unknownOilDistance = 0.5;
+   //! Taken off the score of a hop that the original lists as a substitute (or that lists the original)
+   double constexpr listedSubstituteBonus = 0.3;
+   //! Added to the score for each doubling (or halving) of the amount compared with the original
+   double constexpr amountPenaltyPerDoubling = 0.1;
+   //! We don't suggest using more than this many times (or less than one over this many times) the original amount
+   double constexpr maxAmountRatio = 4.0;
+
+   //! We only search over this many of the best options for each addition
+   int constexpr maxOptionsPerAddition = 30;
+   //! Limit on the number of partial plans we look at, so that a pathological case can't hang the caller
+   long constexpr maxSearchNodes = 1'000'000;
+
+   double inventory_kg(Hop const & hop) {
+      Measurement::Amount const inventory = hop.totalInventory();
+      if (!inventory.unit || inventory.unit->getPhysicalQuantity() != Measurement::PhysicalQuantity::Mass) {
+         return 0.0;
+      }
+      return inventory.unit->toCanonical(inventory.quantity).quantity;
+   }
+
+   HopSubstitutionFinder::HopProfile profileOf(Hop const & hop) {
+      HopSubstitutionFinder::HopProfile profile{
+         .hopId              = hop.key(),
+         .name               = hop.name(),
+         .alpha_pct          = hop.alpha_pct(),
+         .form               = hop.form(),
+         .oils               = {hop.myrcene_pct      ().value_or(0.0),
+                                hop.humulene_pct     ().value_or(0.0),
+                                hop.caryophyllene_pct().value_or(0.0),
+                                hop.farnesene_pct    ().value_or(0.0),
+                                hop.geraniol_pct     ().value_or(0.0),
+                                hop.bPinene_pct      ().value_or(0.0),
+                                hop.linalool_pct     ().value_or(0.0),
+                                hop.limonene_pct     ().value_or(0.0),
+                                hop.nerol_pct        ().value_or(0.0),
+                                hop.pinene_pct       ().value_or(0.0)},
+         .totalOil_mlPer100g = hop.totalOil_mlPer100g(),
+         .substitutes        = {},
+         .inventory_kg       = inventory_kg(hop),
+      };
+
+      double length = 0.0;
+      for (double const oil : profile.oils) {
+         length += oil * oil;
+      }
+      length = std::sqrt(length);
+      if (length > 0.0) {
+         for (double & oil : profile.oils) {
+            oil /= length;
+         }
+      }
+
+      static QRegularExpression const separators{"[,;/]"};
+      for (QString const & substitute : hop.substitutes().split(separators, Qt::SkipEmptyParts)) {
+         QString const folded = NameFilterIndex::fold(substitute.trimmed());
+         if (!folded.isEmpty()) {
+            profile.substitutes.append(folded);
+         }
+      }
+      return profile;
+   }
+
+   bool hasOils(HopSubstitutionFinder::HopProfile const & profile) {
+      return std::any_of(profile.oils.cbegin(), profile.oils.cend(), [](double const oil) { return oil > 0.0; });
+   }
+
+   //! \return 0 for identical oil compositions, up to 1 for nothing in common
+   double oilDistance(HopSubstitutionFinder::HopProfile const & lhs, HopSubstitutionFinder::HopProfile const & rhs) {
+      if (!hasOils(lhs) || !hasOils(rhs)) {
+         return unknownOilDistance;
+      }
+      double similarity = 0.0;
+      for (std::size_t ii = 0; ii < HopSubstitutionFinder::numOils; ++ii) {
+         similarity += lhs.oils[ii] * rhs.oils[ii];
+      }
+      return 1.0 - similarity;
+   }
+
+   bool isListedSubstitute(HopSubstitutionFinder::HopProfile const & original,
+                           HopSubstitutionFinder::HopProfile const & candidate) {
+      return original.substitutes.contains(NameFilterIndex::fold(candidate.name)) ||
+             candidate.substitutes.contains(NameFilterIndex::fold(original.name));
+   }
+
+   bool isLate(RecipeEvaluator::HopAdditionInputs const & hopAddition) {
+      switch (hopAddition.stage) {
+         case RecipeAddition::Stage::Mash:
+            return false;
+         case RecipeAddition::Stage::Boil:
+            return !hopAddition.isFirstWort && hopAddition.addAtTime_mins.value_or(0.0) <= lateAddition_mins;
+         case RecipeAddition::Stage::Fermentation:
+         case RecipeAddition::Stage::Packaging:
+            return true;
+         // No default case as we want the compiler to warn us if we missed one
+      }
+      return false;
+   }
+
+   //! Using one candidate hop in place of one of the additions
+   struct Option {
+      int    candidateIndex;
+      double quantity_kg;
+      double ibus;
+      double score;
+   };
+
+   /**
+    * \brief Work out the options for additions \c inputs.toReplace using candidates [\c firstCandidate,
+    *        \c endCandidate), and put them in \c options, where the option for the ii-th addition to replace and jj-th
+    *        candidate goes in options[ii * numCandidates + jj].
+    */
+   void workOutOptions(HopSubstitutionFinder::Inputs const & inputs,
+                       int const firstCandidate,
+                       int const endCandidate,
+                       std::vector<std::optional<Option>> & options) {
+      int const numCandidates = inputs.candidates.size();
+      int const chunkSize = endCandidate - firstCandidate;
+      QVector<RecipeEvaluator::HopAdditionInputs> trials(chunkSize);
+      QVector<double> ibus(chunkSize);
+
+      for (int ii = 0; ii < inputs.toReplace.size(); ++ii) {
+         int const additionIndex = inputs.toReplace.at(ii);
+         RecipeEvaluator::HopAdditionInputs const & addition = inputs.hopAdditions.at(additionIndex);
+         HopSubstitutionFinder::HopProfile const & original = inputs.originals.at(additionIndex);
+         double const targetIbus = inputs.ibusByHopAddition.value(additionIndex, 0.0);
+         bool const matchIbus = targetIbus > 0.0;
+
+         //
+         // First guess at the amount is by alpha acid (or, if the addition isn't adding bitterness, total oil) and,
+         // for IBU matches, we then correct it by how far out the IBUs are.  Most of the IBU formulas are linear in
+         // the amount of hops, so one correction is usually all it takes.
+         //
+         for (int jj = 0; jj < chunkSize; ++jj) {
+            HopSubstitutionFinder::HopProfile const & candidate = inputs.candidates.at(firstCandidate + jj);
+            RecipeEvaluator::HopAdditionInputs & trial = trials[jj];
+            trial = addition;
+            trial.alpha_pct = candidate.alpha_pct;
+            trial.form      = candidate.form;
+            if (matchIbus) {
+               trial.quantity =
+                  candidate.alpha_pct > 0.0 ? addition.quantity * addition.alpha_pct / candidate.alpha_pct : 0.0;
+            } else if (original.totalOil_mlPer100g.value_or(0.0) > 0.0 &&
+                       candidate.totalOil_mlPer100g.value_or(0.0) > 0.0) {
+               trial.quantity = addition.quantity * *original.totalOil_mlPer100g / *candidate.totalOil_mlPer100g;
+            }
+         }
+         RecipeEvaluator::ibusFromHopAdditions(trials, inputs.equipment, inputs.boil, inputs.og,
+                                               inputs.finalVolumeNoLosses_l, ibus);
+         if (matchIbus) {
+            for (int jj = 0; jj < chunkSize; ++jj) {
+               trials[jj].quantity = ibus[jj] > 0.0 ? trials[jj].quantity * targetIbus / ibus[jj] : 0.0;
+            }
+            RecipeEvaluator::ibusFromHopAdditions(trials, inputs.equipment, inputs.boil, inputs.og,
+                                                  inputs.finalVolumeNoLosses_l, ibus);
+         }
+
+         double const aromaWeight = isLate(addition) ? aromaWeightLate : aromaWeightEarly;
+         for (int jj = 0; jj < chunkSize; ++jj) {
+            int const candidateIndex = firstCandidate + jj;
+            HopSubstitutionFinder::HopProfile const & candidate = inputs.candidates.at(candidateIndex);
+            double const quantity_kg = trials.at(jj).quantity;
+            double const amountRatio = addition.quantity > 0.0 ? quantity_kg / addition.quantity : 0.0;
+            if (candidate.hopId == original.hopId ||
+                quantity_kg <= 0.0 ||
+                quantity_kg > candidate.inventory_kg ||
+                amountRatio > maxAmountRatio ||
+                amountRatio < 1.0 / maxAmountRatio) {
+               continue;
+            }
+            double const score = aromaWeight * oilDistance(original, candidate) +
+                                 amountPenaltyPerDoubling * std::abs(std::log2(amountRatio)) -
+                                 (isListedSubstitute(original, candidate) ? listedSubstituteBonus : 0.0);
+            options[ii * numCandidates + candidateIndex] = Option{candidateIndex, quantity_kg, ibus.at(jj), score};
+         }
+      }
+      return;
+   }
+
+   /**
+    * \brief Branch-and-bound search over one option per addition.  \c best is kept sorted, best first, and holds at
+    *        most \c maxPlans plans.
+    */
+   struct Search {
+      HopSubstitutionFinder::Inputs const & inputs;
+      std::vector<std::vector<Option>> const & optionsByAddition;
+      //! bestRemaining[ii] is the lowest possible total score of additions ii onwards
+      std::vector<double> const & bestRemaining;
+      int const maxPlans;
+      std::vector<double> used_kg;
+      std::vector<Option const *> chosen;
+      QVector<HopSubstitutionFinder::Plan> best;
+      long nodes = 0;
+
+      void search(std::size_t const depth, double const score) {
+         if (++this->nodes > maxSearchNodes) {
+            return;
+         }
+         if (depth == this->optionsByAddition.size()) {
+            this->keep(score);
+            return;
+         }
+         for (Option const & option : this->optionsByAddition[depth]) {
+            double const newScore = score + option.score;
+            // Options are sorted best first, so if this one can't make the cut, nor can any of the rest
+            if (this->best.size() == this->maxPlans &&
+                newScore + this->bestRemaining[depth + 1] >= this->best.last().score) {
+               break;
+            }
+            double const available_kg = this->inputs.candidates.at(option.candidateIndex).inventory_kg;
+            if (this->used_kg[option.candidateIndex] + option.quantity_kg > available_kg) {
+               continue;
+            }
+            this->used_kg[option.candidateIndex] += option.quantity_kg;
+            this->chosen[depth] = &option;
+            this->search(depth + 1, newScore);
+            this->used_kg[option.candidateIndex] -= option.quantity_kg;
+         }
+         return;
+      }
+
+      void keep(double const score) {
+         HopSubstitutionFinder::Plan plan{.substitutions = {}, .score = score};
+         plan.substitutions.reserve(static_cast<int>(this->chosen.size()));
+         for (std::size_t ii = 0; ii < this->chosen.size(); ++ii) {
+            Option const & option = *this->chosen[ii];
+            HopSubstitutionFinder::HopProfile const & candidate = this->inputs.candidates.at(option.candidateIndex);
+            plan.substitutions.append(
+               HopSubstitutionFinder::Substitution{
+                  .additionIndex = this->inputs.toReplace.at(static_cast<int>(ii)),
+                  .hopId         = candidate.hopId,
+                  .hopName       = candidate.name,
+                  .quantity_kg   = option.quantity_kg,
+                  .ibus          = option.ibus,
+                  .score         = option.score,
+               }
+            );
+         }
+         auto const position = std::upper_bound(
+            this->best.begin(), this->best.end(), score,
+            [](double const lhs, HopSubstitutionFinder::Plan const & rhs) { return lhs < rhs.score; }
+         );
+         this->best.insert(position, std::move(plan));
+         if (this->best.size() > this->maxPlans) {
+            this->best.removeLast();
+         }
+         return;
+      }
+   };
+}
+
+HopSubstitutionFinder::Inputs HopSubstitutionFinder::inputsFor(Recipe & recipe) {
+   RecipeEvaluator::Snapshot const snapshot = RecipeEvaluator::snapshotOf(recipe);
+   RecipeEvaluator::Results const results = RecipeEvaluator::evaluate(snapshot);
+   Inputs inputs{
+      .equipment             = snapshot.equipment,
+      .boil                  = snapshot.boil,
+      .og                    = results.gravities.og,
+      .finalVolumeNoLosses_l = results.volumes.finalVolumeNoLosses_l,
+      .hopAdditions          = snapshot.hopAdditions,
+      .originals             = {},
+      .ibusByHopAddition     = results.ibusByHopAddition,
+      .toReplace             = {},
+      .candidates            = {},
+   };
+
+   // Several additions can use the same hop, so it's the total we need that we have to compare with what's in stock
+   auto const hopAdditions = recipe.hopAdditions();
+   QHash<int, double> needed_kg;
+   for (auto const & hopAddition : hopAdditions) {
+      if (Hop const * hop = hopAddition->hop(); hop && hopAddition->amountIsWeight()) {
+         needed_kg[hop->key()] += hopAddition->quantity();
+      }
+   }
+
+   inputs.originals.reserve(hopAdditions.size());
+   for (int ii = 0; ii < hopAdditions.size(); ++ii) {
+      auto const & hopAddition = hopAdditions.at(ii);
+      Hop const * hop = hopAddition->hop();
+      if (!hop) {
+         inputs.originals.append(HopProfile{.hopId = -1, .name = hopAddition->name(), .alpha_pct = 0.0, .form = {},
+                                            .oils = {}, .totalOil_mlPer100g = {}, .substitutes = {},
+                                            .inventory_kg = 0.0});
+         continue;
+      }
+      inputs.originals.append(profileOf(*hop));
+      if (hopAddition->amountIsWeight() && needed_kg.value(hop->key()) > inputs.originals.last().inventory_kg) {
+         inputs.toReplace.append(ii);
+      }
+   }
+
+   for (Hop const * hop : ObjectStoreWrapper::getAllRaw<Hop>()) {
+      if (!hop->deleted() && inventory_kg(*hop) > 0.0) {
+         inputs.candidates.append(profileOf(*hop));
+      }
+   }
+
+   qCDebug(Logging::recipe) <<
+      Q_FUNC_INFO << "Recipe #" << recipe.key() << "has" << inputs.toReplace.size() << "of" << hopAdditions.size() <<
+      "hop additions to replace and" << inputs.candidates.size() << "hops in stock";
+   return inputs;
+}
+
+QVector<HopSubstitutionFinder::Plan> HopSubstitutionFinder::findPlans(Inputs const & inputs, int const maxPlans) {
+   int const numToReplace  = inputs.toReplace.size();
+   int const numCandidates = inputs.candidates.size();
+   if (maxPlans <= 0 || numToReplace == 0 || numCandidates == 0) {
+      return {};
+   }
+
+   //
+   // Work out the options in contiguous chunks of candidates, one chunk per core, so that each chunk makes batched IBU
+   // calls.  As in RecipeEvaluator, the calling thread does one chunk itself and then waits for the pool to do the
+   // rest.  Each chunk only writes its own elements of options, so no locking is needed.
+   //
+   std::vector<std::optional<Option>> options(static_cast<std::size_t>(numToReplace) * numCandidates);
+   int const numChunks = std::clamp(QThread::idealThreadCount(), 1, numCandidates);
+   auto workOutChunk = [&inputs, &options, numCandidates, numChunks](int const chunk) {
+      workOutOptions(inputs, chunk * numCandidates / numChunks, (chunk + 1) * numCandidates / numChunks, options);
+      return;
+   };
+   QSemaphore chunksDone;
+   for (int chunk = 1; chunk < numChunks; ++chunk) {
+      QThreadPool::globalInstance()->start(
+         QRunnable::create([&workOutChunk, &chunksDone, chunk]() {
+            workOutChunk(chunk);
+            chunksDone.release();
+            return;
+         })
+      );
+   }
+   workOutChunk(0);
+   chunksDone.acquire(numChunks - 1);
+
+   // Keep the best options for each addition, best first
+   std::vector<std::vector<Option>> optionsByAddition(numToReplace);
+   std::vector<double> bestRemaining(numToReplace + 1, 0.0);
+   for (int ii = 0; ii < numToReplace; ++ii) {
+      std::vector<Option> & additionOptions = optionsByAddition[ii];
+      for (int jj = 0; jj < numCandidates; ++jj) {
+         if (auto const & option = options[static_cast<std::size_t>(ii) * numCandidates + jj]) {
+            additionOptions.push_back(*option);
+         }
+      }
+      if (additionOptions.empty()) {
+         qCDebug(Logging::recipe) <<
+            Q_FUNC_INFO << "Nothing in stock will do for hop addition #" << inputs.toReplace.at(ii);
+         return {};
+      }
+      std::sort(additionOptions.begin(), additionOptions.end(),
+                [](Option const & lhs, Option const & rhs) { return lhs.score < rhs.score; });
+      if (additionOptions.size() > static_cast<std::size_t>(maxOptionsPerAddition)) {
+         additionOptions.resize(maxOptionsPerAddition);
+      }
+   }
+   for (int ii = numToReplace - 1; ii >= 0; --ii) {
+      bestRemaining[ii] = bestRemaining[ii + 1] + optionsByAddition[ii].front().score;
+   }
+
+   Search search{
+      .inputs            = inputs,
+      .optionsByAddition = optionsByAddition,
+      .bestRemaining     = bestRemaining,
+      .maxPlans          = maxPlans,
+      .used_kg           = std::vector<double>(numCandidates, 0.0),
+      .chosen            = std::vector<Option const *>(numToReplace, nullptr),
+      .best              = {},
+   };
+   search.search(0, 0.0);
+   qCDebug(Logging::recipe) <<
+      Q_FUNC_INFO << "Found" << search.best.size() << "plans for" << numToReplace << "hop additions from" <<
+      numCandidates << "hops in stock, looking at" << search.nodes << "partial plans";
+   return search.best;
+}
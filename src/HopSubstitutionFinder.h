@@ -0,0 +1,117 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * HopSubstitutionFinder.h is part of Brewtarget, and is copyright the following authors 2024:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#ifndef HOPSUBSTITUTIONFINDER_H
+#define HOPSUBSTITUTIONFINDER_H
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <optional>
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include "model/Hop.h"
+#include "RecipeEvaluator.h"
+
+class Recipe;
+
+/*!
+ * \brief Suggests which hops in inventory to use, and how much of each, in place of hops a recipe needs but that we
+ *        don't have enough of.
+ *
+ *        Each hop addition that needs replacing is matched (by amount) on its IBUs or, for additions that don't add
+ *        any bitterness (eg dry hops), on its total oil.  Candidates are then scored on how close their essential oil
+ *        composition is to the original's (which matters more the later the addition), preferring hops the original
+ *        lists in \c Hop::substitutes and amounts not too far from the original.  Lower scores are better.
+ *
+ *        The amounts for all candidates are worked out up front, on the global thread pool, with one batched call to
+ *        \c RecipeEvaluator::ibusFromHopAdditions per chunk of candidates.  We then search over combinations (one
+ *        substitute per addition) for the best plans, subject to not using more of any hop than we have.  The search
+ *        is branch and bound: each addition's options are tried best first, and a partial plan is abandoned as soon as
+ *        its score plus the best possible score of the remaining additions can't beat the worst plan we are keeping.
+ *
+ *        As with \c RecipeEvaluator, the inputs are taken on the GUI thread, after which nothing here touches the
+ *        model, so \c findPlans can be called on any thread.
+ */
+namespace HopSubstitutionFinder {
+
+   //! Number of essential oils we compare
+   constexpr std::size_t numOils = 10;
+
+   //! What we need to know about a hop to compare it with others
+   struct HopProfile {
+      int                      hopId;
+      QString                  name;
+      double                   alpha_pct;
+      std::optional<Hop::Form> form;
+      //! Proportions of myrcene, humulene, etc, scaled to unit length, or all zero if we don't know any of them
+      std::array<double, numOils> oils;
+      std::optional<double>    totalOil_mlPer100g;
+      //! Names from \c Hop::substitutes, folded (see \c NameFilterIndex::fold) for comparison
+      QStringList              substitutes;
+      //! What we have in stock, in kilograms
+      double                   inventory_kg;
+   };
+
+   struct Inputs {
+      std::optional<RecipeEvaluator::EquipmentInputs> equipment;
+      std::optional<RecipeEvaluator::BoilInputs>      boil;
+      double                                          og;
+      double                                          finalVolumeNoLosses_l;
+      //! The recipe's hop additions, in the same order as \c RecipeEvaluator::Snapshot::hopAdditions
+      QVector<RecipeEvaluator::HopAdditionInputs>     hopAdditions;
+      //! The hop used in each addition
+      QVector<HopProfile>                             originals;
+      //! IBUs of each addition as it stands
+      QList<double>                                   ibusByHopAddition;
+      //! Indexes (in \c hopAdditions) of the additions that need replacing
+      QVector<int>                                    toReplace;
+      //! Hops in stock
+      QVector<HopProfile>                             candidates;
+   };
+
+   struct Substitution {
+      //! Index of the addition in \c Inputs::hopAdditions
+      int     additionIndex;
+      int     hopId;
+      QString hopName;
+      double  quantity_kg;
+      double  ibus;
+      double  score;
+   };
+
+   struct Plan {
+      //! One substitution for each of \c Inputs::toReplace, in the same order
+      QVector<Substitution> substitutions;
+      //! Sum of the scores of the substitutions
+      double                score;
+   };
+
+   /**
+    * \brief Take the inputs for finding substitutes for the hops in \c recipe that we don't have enough of in
+    *        inventory.  Must be called on the GUI thread.
+    */
+   Inputs inputsFor(Recipe & recipe);
+
+   /**
+    * \return Up to \c maxPlans plans, best first.  Empty if nothing needs replacing or nothing in stock will do.
+    */
+   QVector<Plan> findPlans(Inputs const & inputs, int const maxPlans);
+}
+
+#endif
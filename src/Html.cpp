@@ -16,7 +16,10 @@
 
 #include "Html.h"
 
+#include <mutex>
+
 #include <QFile>
+#include <QHash>
 #include <QString>
 #include <QTextStream>
 
@@ -25,6 +28,19 @@ namespace Html
 
 QString getCss(const QString& resourceName)
 {
+   //
+   // The CSS resources are compiled in, so they can't change while we're running, and there's no need to read them
+   // more than once.  (This can be called from several threads at once when formatting lots of recipes, hence the
+   // mutex.)
+   //
+   static std::mutex cacheMutex;
+   static QHash<QString, QString> cache;
+   std::lock_guard<std::mutex> lock(cacheMutex);
+   auto const cached = cache.constFind(resourceName);
+   if (cached != cache.cend()) {
+      return *cached;
+   }
+
    QFile cssInput(resourceName);
    QString result;
 
@@ -36,6 +52,7 @@ QString getCss(const QString& resourceName)
          result += inStream.readLine();
       }
    }
+   cache.insert(resourceName, result);
    return result;
 }
 
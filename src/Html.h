@@ -23,7 +23,7 @@ class QString;
 namespace Html {
 
 /*!
- * \return The contents of the CSS resource.
+ * \return The contents of the CSS resource.  Each resource is only read once; after that we return a cached copy.
  * \param recourceName The name of the CSS resource to retreive.
  */
 QString getCss(const QString& recourceName);
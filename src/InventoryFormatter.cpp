@@ -17,10 +17,20 @@
  ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
 #include "InventoryFormatter.h"
 
+#include <algorithm>
+#include <type_traits>
+
+#include <QDebug>
+#include <QHash>
 #include <QList>
 #include <QMap>
+#include <QMultiHash>
+#include <QObject>
 #include <QStringList>
+#include <QTextStream>
+#include <QVector>
 
+#include "database/ObjectStoreTyped.h"
 #include "database/ObjectStoreWrapper.h"
 #include "Html.h"
 #include "Localization.h"
@@ -38,222 +48,254 @@
 
 namespace {
    /**
-    * @brief Create Inventory HTML Header
+    * \brief Total inventory of each ingredient of one type (eg each \c Hop), kept up to date as \c Inventory objects
+    *        are added, deleted or changed, so that producing an inventory report does not mean looking at every
+    *        \c Inventory object (and then looking up its ingredient).
+    *
+    *        We listen to the object store for \c Inv rather than to the individual objects, as the store tells us
+    *        about insertions and deletions as well as changes to the ingredient ID or amount of any inventory item.
     *
-    * @return QString
+    *        At the moment, there is at most one \c Inventory object per ingredient, but we don't rely on that here.
+    *        Amounts for the same ingredient are added together if they are in the same units, and kept separate if
+    *        not (eg if some of a \c Misc is held by weight and some by volume).
     */
-   QString createInventoryHeader() {
-      return Html::createHeader(QObject::tr("Inventory"), ":css/inventory.css") +
-            QString("<h1>%1 &mdash; %2</h1>")
-                  .arg(QObject::tr("Inventory"))
-                  .arg(Localization::displayDateUserFormated(QDate::currentDate()));
-   }
+   template<IsInventory Inv>
+   class InventorySummary {
+   public:
+      using Ingr = typename Inv::IngredientClass;
 
-   /**
-    * \brief Create Inventory HTML Table of \c Fermentable
-    */
-   QString createInventoryTableFermentable() {
-      QString result;
-
-      // Find all the parent Fermentables whose inventory is > 0
-      // (We don't want children because they are just usages of the parents in recipes.)
-///      auto inventory = ObjectStoreWrapper::findAllMatching<Fermentable>(
-///         [](std::shared_ptr<Fermentable> ff) { return (ff->getParent() == nullptr && ff->inventory() > 0.0); }
-///      );
-      auto fermentableInventory = ObjectStoreWrapper::findAllMatching<InventoryFermentable>(
-         [](std::shared_ptr<InventoryFermentable> val) { return val->quantity() > 0.0; }
-      );
-      if (!fermentableInventory.empty()) {
-         result += QString("<h2>%1</h2>").arg(QObject::tr("Fermentables"));
-         result += "<table id=\"fermentables\">";
-         result += QString("<tr>"
-                           "<th align=\"left\" width=\"40%\">%1</th>"
-                           "<th align=\"left\" width=\"60%\">%2</th>"
-                           "</tr>")
-                        .arg(QObject::tr("Name"))
-                        .arg(QObject::tr("Amount"));
-
-///         for (auto fermentable : inventory) {
-///            result += QString("<tr>"
-///                              "<td>%1</td>"
-///                              "<td>%2</td>"
-///                              "</tr>")
-///                           .arg(fermentable->name())
-///                           .arg(Measurement::displayAmount(Measurement::Amount{fermentable->inventory(),
-///                                                                               Measurement::Units::kilograms}));
-///         }
-         for (auto ii : fermentableInventory) {
-            result += QString("<tr>"
-                              "<td>%1</td>"
-                              "<td>%2</td>"
-                              "</tr>")
-                           .arg(ii->fermentable()->name())
-                           .arg(Measurement::displayAmount(ii->amount()));
+      /**
+       * \brief The summary is built the first time it is needed, and maintained from then on
+       */
+      static InventorySummary const & instance() {
+         // Deliberately leaked, as it is connected to object store signals for the life of the program
+         static InventorySummary * summary = new InventorySummary{};
+         return *summary;
+      }
+
+      /**
+       * \return For each ingredient with any (positive) inventory, its total inventory in each unit it is held in.
+       *         Ordered by ingredient ID.
+       */
+      QMap<int, QVector<Measurement::Amount>> const & totals() const {
+         return this->m_totals;
+      }
+
+   private:
+      InventorySummary() :
+         m_contributions{},
+         m_inventoryIdsByIngredient{},
+         m_totals{} {
+         ObjectStoreTyped<Inv> & objectStore = ObjectStoreTyped<Inv>::getInstance();
+         QObject::connect(&objectStore, &ObjectStore::signalObjectInserted, [this](int const id) {
+            this->refresh(id);
+            return;
+         });
+         QObject::connect(&objectStore,
+                          &ObjectStore::signalObjectDeleted,
+                          [this](int const id, [[maybe_unused]] std::shared_ptr<QObject> object) {
+            this->remove(id);
+            return;
+         });
+         QObject::connect(&objectStore,
+                          &ObjectStore::signalPropertyChanged,
+                          [this](int const id, BtStringConst const & propertyName) {
+            if (propertyName == PropertyNames::Inventory::ingredientId ||
+                propertyName == PropertyNames::IngredientAmount::amount ||
+                propertyName == PropertyNames::IngredientAmount::quantity ||
+                propertyName == PropertyNames::IngredientAmount::unit) {
+               this->refresh(id);
+            }
+            return;
+         });
+         QObject::connect(&objectStore, &ObjectStore::signalObjectsChangedInBulk, [this]() {
+            this->rebuild();
+            return;
+         });
+
+         this->rebuild();
+         return;
+      }
+
+      void rebuild() {
+         this->m_contributions.clear();
+         this->m_inventoryIdsByIngredient.clear();
+         this->m_totals.clear();
+         ObjectStoreWrapper::forEach<Inv>([this](Inv const * inventory) {
+            this->add(*inventory);
+            return;
+         });
+         return;
+      }
+
+      //! Re-read the inventory item with the supplied ID (if it still exists)
+      void refresh(int const inventoryId) {
+         this->remove(inventoryId);
+         Inv const * inventory = ObjectStoreWrapper::getByIdRaw<Inv>(inventoryId);
+         if (inventory) {
+            this->add(*inventory);
          }
-         result += "</table>";
+         return;
       }
-      return result;
-   }
 
-   /**
-    * \brief Create Inventory HTML Table of \c Hop
-    */
-   QString createInventoryTableHop() {
-      QString result;
-
-///      auto inventory = ObjectStoreWrapper::findAllMatching<Hop>(
-///         [](std::shared_ptr<Hop> hh) { return (hh->getParent() == nullptr && hh->inventory() > 0.0); }
-///      );
-      auto hopInventory = ObjectStoreWrapper::findAllMatching<InventoryHop>(
-         [](std::shared_ptr<InventoryHop> val) { return val->quantity() > 0.0; }
-      );
-
-      if (!hopInventory.empty()) {
-         result += QString("<h2>%1</h2>").arg(QObject::tr("Hops"));
-         result += "<table id=\"hops\">";
-         result += QString("<tr>"
-                           "<th align=\"left\" width=\"30%\">%1</th>"
-                           "<th align=\"left\" width=\"20%\">%2</th>"
-                           "<th align=\"left\" width=\"50%\">%3</th>"
-                           "</tr>")
-                        .arg(QObject::tr("Name"))
-                        .arg(QObject::tr("Alpha %"))
-                        .arg(QObject::tr("Amount"));
-
-///         for (auto hop : inventory) {
-///            result += QString("<tr>"
-///                              "<td>%1</td>"
-///                              "<td>%2</td>"
-///                              "<td>%3</td>"
-///                              "</tr>")
-///                           .arg(hop->name())
-///                           .arg(hop->alpha_pct())
-///                           .arg(Measurement::displayAmount(Measurement::Amount{hop->inventory(),
-///                                                                               Measurement::Units::kilograms}));
-///         }
-         for (auto ii : hopInventory) {
-            result += QString("<tr>"
-                              "<td>%1</td>"
-                              "<td>%2</td>"
-                              "<td>%3</td>"
-                              "</tr>")
-                           .arg(ii->hop()->name())
-                           .arg(ii->hop()->alpha_pct())
-                           .arg(Measurement::displayAmount(ii->amount()));
+      void add(Inv const & inventory) {
+         Contribution const contribution{inventory.ingredientId(), inventory.amount()};
+         this->m_contributions.insert(inventory.key(), contribution);
+         this->m_inventoryIdsByIngredient.insert(contribution.ingredientId, inventory.key());
+         this->retotal(contribution.ingredientId);
+         return;
+      }
+
+      void remove(int const inventoryId) {
+         auto const contribution = this->m_contributions.find(inventoryId);
+         if (contribution == this->m_contributions.end()) {
+            return;
          }
-         result += "</table>";
+         int const ingredientId = contribution->ingredientId;
+         this->m_contributions.erase(contribution);
+         this->m_inventoryIdsByIngredient.remove(ingredientId, inventoryId);
+         this->retotal(ingredientId);
+         return;
       }
-      return result;
-   }
 
-   /**
-    * \brief Create Inventory HTML Table of \c Misc
-    */
-   QString createInventoryTableMiscellaneous() {
-      QString result;
-
-///      auto inventory = ObjectStoreWrapper::findAllMatching<Misc>(
-///         [](std::shared_ptr<Misc> mm) { return (mm->getParent() == nullptr && mm->inventory() > 0.0); }
-///      );
-      auto inventoryMisc = ObjectStoreWrapper::findAllMatching<InventoryMisc>(
-         [](std::shared_ptr<InventoryMisc> val) { return val->quantity() > 0.0; }
-      );
-      if (!inventoryMisc.empty()) {
-
-         result += QString("<h2>%1</h2>").arg(QObject::tr("Miscellaneous"));
-         result += "<table id=\"misc\">";
-         result += QString("<tr>"
-                           "<th align=\"left\" width=\"40%\">%1</th>"
-                           "<th align=\"left\" width=\"60%\">%2</th>"
-                           "</tr>")
-                        .arg(QObject::tr("Name"))
-                        .arg(QObject::tr("Amount"));
-
-         for (auto ii : inventoryMisc) {
-///            QString const displayAmount = Measurement::displayAmount(
-///               Measurement::Amount{
-///                  ii->inventory(),
-///                  ii->amountIsWeight() ? Measurement::Units::kilograms : Measurement::Units::liters
-///               }
-///            );
-            result += QString("<tr>"
-                              "<td>%1</td>"
-                              "<td>%2</td>"
-                              "</tr>")
-                           .arg(ii->name())
-                           .arg(Measurement::displayAmount(ii->amount()));
+      void retotal(int const ingredientId) {
+         QVector<Measurement::Amount> totals;
+         for (int const inventoryId : this->m_inventoryIdsByIngredient.values(ingredientId)) {
+            Measurement::Amount const & amount = this->m_contributions[inventoryId].amount;
+            auto total = std::find_if(
+               totals.begin(),
+               totals.end(),
+               [&amount](Measurement::Amount const & ii) { return ii.unit == amount.unit; }
+            );
+            if (total == totals.end()) {
+               totals.append(amount);
+            } else {
+               total->quantity += amount.quantity;
+            }
+         }
+         totals.erase(
+            std::remove_if(totals.begin(),
+                           totals.end(),
+                           [](Measurement::Amount const & ii) { return ii.quantity <= 0.0; }),
+            totals.end()
+         );
+
+         if (totals.isEmpty()) {
+            this->m_totals.remove(ingredientId);
+         } else {
+            this->m_totals.insert(ingredientId, totals);
          }
-         result += "</table>";
+         return;
       }
-      return result;
-   }
+
+      struct Contribution {
+         int ingredientId;
+         Measurement::Amount amount;
+      };
+
+      //! What each inventory item adds to the total for its ingredient, indexed by inventory item ID
+      QHash<int, Contribution> m_contributions;
+
+      //! The IDs of the inventory items for each ingredient
+      QMultiHash<int, int> m_inventoryIdsByIngredient;
+
+      //! See \c totals
+      QMap<int, QVector<Measurement::Amount>> m_totals;
+   };
 
    /**
-    * \brief Create Inventory HTML Table of \c Yeast
+    * \brief Write the inventory HTML header to \c out
     */
-   QString createInventoryTableYeast() {
-      QString result;
-///      auto inventory = ObjectStoreWrapper::findAllMatching<Yeast>(
-///         [](std::shared_ptr<Yeast> yy) { return (yy->getParent() == nullptr && yy->inventory() > 0.0); }
-///      );
-      auto inventoryYeast = ObjectStoreWrapper::findAllMatching<InventoryYeast>(
-         [](std::shared_ptr<InventoryYeast> val) { return val->quantity() > 0.0; }
-      );
-      if (!inventoryYeast.empty()) {
-         result += QString("<h2>%1</h2>").arg(QObject::tr("Yeast"));
-         result += "<table id=\"yeast\">";
-         result += QString("<tr>"
-                           "<th align=\"left\" width=\"40%\">%1</th>"
-                           "<th align=\"left\" width=\"60%\">%2</th>"
-                           "</tr>")
-                        .arg(QObject::tr("Name"))
-                        .arg(QObject::tr("Amount"));
-
-         for (auto ii : inventoryYeast) {
-///            QString const displayAmount = Measurement::displayAmount(
-///               Measurement::Amount{
-///                  yeast->inventory(),
-///                  yeast->amountIsWeight() ? Measurement::Units::kilograms : Measurement::Units::liters
-///               }
-///            );
-
-            result += QString("<tr>"
-                              "<td>%1</td>"
-                              "<td>%2</td>"
-                              "</tr>")
-                           .arg(ii->name())
-                           .arg(Measurement::displayAmount(ii->amount()));
-         }
-         result += "</table>";
-      }
-      return result;
+   void writeInventoryHeader(QTextStream & out) {
+      out << Html::createHeader(QObject::tr("Inventory"), ":css/inventory.css") <<
+             QString("<h1>%1 &mdash; %2</h1>")
+                  .arg(QObject::tr("Inventory"))
+                  .arg(Localization::displayDateUserFormated(QDate::currentDate()));
+      return;
    }
 
-
    /**
-    * Create Inventory HTML Body
+    * \brief Write an HTML table of the inventory of one type of ingredient to \c out
+    *
+    * \return \c false if there was no inventory of this type (in which case nothing was written), \c true otherwise
     */
-   QString createInventoryBody(InventoryFormatter::HtmlGenerationFlags flags) {
-      // Only generate users selection of Ingredient inventory.
-      QString result =
-         ((flags & InventoryFormatter::HtmlGenerationFlag::FERMENTABLES ) ? createInventoryTableFermentable() : "") +
-         ((flags & InventoryFormatter::HtmlGenerationFlag::HOPS         ) ? createInventoryTableHop() : "") +
-         ((flags & InventoryFormatter::HtmlGenerationFlag::MISCELLANEOUS) ? createInventoryTableMiscellaneous() : "") +
-         ((flags & InventoryFormatter::HtmlGenerationFlag::YEAST        ) ? createInventoryTableYeast() : "");
-
-      // If user selects no printout or if there are no inventory for the selected ingredients
-      if (result.size() == 0) {
-         result = QObject::tr("No inventory available.");
+   template<IsInventory Inv>
+   bool writeInventoryTableHtml(QTextStream & out, QString const & title, char const * const tableId) {
+      using Ingr = typename InventorySummary<Inv>::Ingr;
+      // For hops, we also show alpha acid
+      constexpr bool isHop = std::is_same_v<Inv, InventoryHop>;
+
+      auto const & totals = InventorySummary<Inv>::instance().totals();
+      if (totals.isEmpty()) {
+         return false;
+      }
+
+      out << "<h2>" << title << "</h2>";
+      out << "<table id=\"" << tableId << "\">";
+      if constexpr (isHop) {
+         out << QString("<tr>"
+                        "<th align=\"left\" width=\"30%\">%1</th>"
+                        "<th align=\"left\" width=\"20%\">%2</th>"
+                        "<th align=\"left\" width=\"50%\">%3</th>"
+                        "</tr>")
+                     .arg(QObject::tr("Name"))
+                     .arg(QObject::tr("Alpha %"))
+                     .arg(QObject::tr("Amount"));
+      } else {
+         out << QString("<tr>"
+                        "<th align=\"left\" width=\"40%\">%1</th>"
+                        "<th align=\"left\" width=\"60%\">%2</th>"
+                        "</tr>")
+                     .arg(QObject::tr("Name"))
+                     .arg(QObject::tr("Amount"));
+      }
+
+      for (auto ii = totals.cbegin(); ii != totals.cend(); ++ii) {
+         Ingr const * ingredient = ObjectStoreWrapper::getByIdRaw<Ingr>(ii.key());
+         if (!ingredient) {
+            qWarning() <<
+               Q_FUNC_INFO << "Inventory refers to non-existent" << Ingr::staticMetaObject.className() << "#" <<
+               ii.key();
+            continue;
+         }
+         for (Measurement::Amount const & amount : ii.value()) {
+            out << "<tr><td>" << ingredient->name() << "</td>";
+            if constexpr (isHop) {
+               out << "<td>" << QString::number(ingredient->alpha_pct()) << "</td>";
+            }
+            out << "<td>" << Measurement::displayAmount(amount) << "</td></tr>";
+         }
       }
+      out << "</table>";
+      return true;
+   }
 
-      return result;
+   //! Quote a CSV field if necessary
+   QString csvField(QString const & field) {
+      if (!field.contains(',') && !field.contains('"') && !field.contains('\n')) {
+         return field;
+      }
+      return QString{field}.replace("\"", "\"\"").prepend('"').append('"');
    }
 
    /**
-    * Create Inventory HTML Footer
+    * \brief Write a CSV line to \c out for each ingredient of one type (and unit) for which we have inventory
     */
-   QString createInventoryFooter() {
-      return Html::createFooter();
+   template<IsInventory Inv>
+   void writeInventoryCsvLines(QTextStream & out, QString const & ingredientType) {
+      using Ingr = typename InventorySummary<Inv>::Ingr;
+      auto const & totals = InventorySummary<Inv>::instance().totals();
+      for (auto ii = totals.cbegin(); ii != totals.cend(); ++ii) {
+         Ingr const * ingredient = ObjectStoreWrapper::getByIdRaw<Ingr>(ii.key());
+         if (!ingredient) {
+            continue;
+         }
+         for (Measurement::Amount const & amount : ii.value()) {
+            out << csvField(ingredientType) << ',' << csvField(ingredient->name()) << ',' <<
+                   QString::number(amount.quantity) << ',' << csvField(amount.unit->name) << '\n';
+         }
+      }
+      return;
    }
 
 }
@@ -269,7 +311,54 @@ namespace {
 ///}
 
 QString InventoryFormatter::createInventoryHtml(HtmlGenerationFlags flags) {
-   return createInventoryHeader() +
-          createInventoryBody(flags) +
-          createInventoryFooter();
+   QString result;
+   QTextStream out{&result};
+   InventoryFormatter::writeInventoryHtml(out, flags);
+   out.flush();
+   return result;
+}
+
+void InventoryFormatter::writeInventoryHtml(QTextStream & out, HtmlGenerationFlags flags) {
+   writeInventoryHeader(out);
+
+   // Only generate users selection of Ingredient inventory.
+   bool wroteAnything = false;
+   if (flags & InventoryFormatter::HtmlGenerationFlag::FERMENTABLES) {
+      wroteAnything |= writeInventoryTableHtml<InventoryFermentable>(out, QObject::tr("Fermentables"), "fermentables");
+   }
+   if (flags & InventoryFormatter::HtmlGenerationFlag::HOPS) {
+      wroteAnything |= writeInventoryTableHtml<InventoryHop>(out, QObject::tr("Hops"), "hops");
+   }
+   if (flags & InventoryFormatter::HtmlGenerationFlag::MISCELLANEOUS) {
+      wroteAnything |= writeInventoryTableHtml<InventoryMisc>(out, QObject::tr("Miscellaneous"), "misc");
+   }
+   if (flags & InventoryFormatter::HtmlGenerationFlag::YEAST) {
+      wroteAnything |= writeInventoryTableHtml<InventoryYeast>(out, QObject::tr("Yeast"), "yeast");
+   }
+
+   // If user selects no printout or if there are no inventory for the selected ingredients
+   if (!wroteAnything) {
+      out << QObject::tr("No inventory available.");
+   }
+
+   out << Html::createFooter();
+   return;
+}
+
+void InventoryFormatter::writeInventoryCsv(QTextStream & out, HtmlGenerationFlags flags) {
+   out << csvField(QObject::tr("Type")) << ',' << csvField(QObject::tr("Name")) << ',' <<
+          csvField(QObject::tr("Quantity")) << ',' << csvField(QObject::tr("Unit")) << '\n';
+   if (flags & InventoryFormatter::HtmlGenerationFlag::FERMENTABLES) {
+      writeInventoryCsvLines<InventoryFermentable>(out, Fermentable::localisedName());
+   }
+   if (flags & InventoryFormatter::HtmlGenerationFlag::HOPS) {
+      writeInventoryCsvLines<InventoryHop>(out, Hop::localisedName());
+   }
+   if (flags & InventoryFormatter::HtmlGenerationFlag::MISCELLANEOUS) {
+      writeInventoryCsvLines<InventoryMisc>(out, Misc::localisedName());
+   }
+   if (flags & InventoryFormatter::HtmlGenerationFlag::YEAST) {
+      writeInventoryCsvLines<InventoryYeast>(out, Yeast::localisedName());
+   }
+   return;
 }
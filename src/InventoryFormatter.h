@@ -24,6 +24,7 @@
 #include <QFlags> // For Q_DECLARE_FLAGS
 
 class QString;
+class QTextStream;
 
 namespace InventoryFormatter {
 
@@ -66,6 +67,18 @@ namespace InventoryFormatter {
     */
    QString createInventoryHtml(HtmlGenerationFlags flags);
 
+   /**
+    * @brief Write the same HTML as \c createInventoryHtml to \c out, a table row at a time, rather than building it
+    *        all up in one string first.
+    */
+   void writeInventoryHtml(QTextStream & out, HtmlGenerationFlags flags);
+
+   /**
+    * @brief Write the selected inventory to \c out as CSV: a header line, then one line per ingredient (and unit)
+    *        giving the ingredient type, name, quantity and unit.
+    */
+   void writeInventoryCsv(QTextStream & out, HtmlGenerationFlags flags);
+
 }
 
 Q_DECLARE_OPERATORS_FOR_FLAGS(InventoryFormatter::HtmlGenerationFlags)
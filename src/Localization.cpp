@@ -18,11 +18,15 @@
  ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
 #include "Localization.h"
 
+#include <array>
+#include <atomic>
 #include <memory>
+#include <optional>
 
 #include <QApplication> // For qApp
 #include <QDebug>
 #include <QDir>
+#include <QFile>
 #include <QLibraryInfo>
 #include <QLocale>
 #include <QTranslator>
@@ -31,6 +35,7 @@
 #include "model/NamedEntity.h"
 #include "PersistentSettings.h"
 #include "utils/BtStringConst.h"
+#include "utils/Diagnostics.h"
 
 //
 // Anonymous namespace for constants, global variables and functions used only in this file
@@ -44,6 +49,19 @@ namespace {
    QTranslator defaultTrans;
    QTranslator btTrans;
 
+   //
+   // The .qm file that btTrans was loaded from.  We map the file into memory rather than reading it, and, because
+   // QTranslator::load(uchar const *, int) uses the data in place rather than copying it, the file has to stay open
+   // (and therefore mapped) for as long as btTrans is using it.
+   //
+   std::unique_ptr<QFile> btTransFile;
+
+   /**
+    * \brief Bumped whenever something happens that might change what \c QLocale() gives us, so that
+    *        \c toDoubleSeparators knows to look them up again.
+    */
+   std::atomic<unsigned int> localeGeneration = 0;
+
    QLocale initSystemLocale() {
       //
       // At the moment, you need to manually edit the config file to set a forced locale (which is a step up from having
@@ -73,11 +91,136 @@ namespace {
          // instead of Localization::getLocale().  Note that QLocale::setDefault() is not reentrant, but that's OK as
          // we are guaranteed to be single-threaded here.
          QLocale::setDefault(forcedLocale);
+         ++localeGeneration;
          return forcedLocale;
       }
       return QLocale::system();
    }
 
+   /**
+    * \brief The separators \c Localization::splitAmount needs to look for.  We get these from the locale once, rather
+    *        than on every call.  (The locale does not change once it has been set up -- see
+    *        \c Localization::getLocale.)
+    */
+   struct NumberSeparators {
+      QString decimalPoint;
+      QString groupSeparator;
+   };
+
+   NumberSeparators const & numberSeparators() {
+      static NumberSeparators const separators{
+         .decimalPoint   = QString{Localization::getLocale().decimalPoint()},
+         .groupSeparator = QString{Localization::getLocale().groupSeparator()},
+      };
+      return separators;
+   }
+
+   //! \return The position of the first non-digit in \c input at or after \c position
+   qsizetype skipDigits(QStringView const input, qsizetype position) {
+      while (position < input.size() && input[position].isDigit()) {
+         ++position;
+      }
+      return position;
+   }
+
+   //! \return \c true if \c input has \c separator at \c position, followed by a digit
+   bool separatorThenDigitAt(QStringView const input, qsizetype const position, QString const & separator) {
+      qsizetype const digitPosition = position + separator.size();
+      return !separator.isEmpty() &&
+             digitPosition < input.size() &&
+             input.mid(position).startsWith(separator) &&
+             input[digitPosition].isDigit();
+   }
+
+   //! \return \c true if \c character is what a regular expression would match with "\w"
+   bool isWordCharacter(QChar const character) {
+      return character.isLetterOrNumber() || character.isMark() || character == '_';
+   }
+
+   /**
+    * \brief The decimal point of the default locale (ie what \c QLocale() gives), which is what
+    *        \c Localization::toDouble parses in.  Constructing a \c QLocale on every call to find this out is a
+    *        noticeable part of the cost of parsing a number, so we cache it, and only look again after
+    *        \c localeGeneration has changed.
+    *
+    *        A decimal point that is not a single UTF-16 code unit is stored as 0, which means \c fastToDouble will not
+    *        attempt to handle any numbers.
+    */
+   struct ToDoubleDecimalPoint {
+      std::atomic<unsigned int> generation = ~0u;
+      std::atomic<char16_t>     decimalPoint = 0;
+   };
+   ToDoubleDecimalPoint toDoubleDecimalPointCache;
+
+   char16_t toDoubleDecimalPoint() {
+      unsigned int const currentGeneration = localeGeneration;
+      if (toDoubleDecimalPointCache.generation != currentGeneration) {
+         QString const decimalPoint{QLocale{}.decimalPoint()};
+         toDoubleDecimalPointCache.decimalPoint = decimalPoint.size() == 1 ? decimalPoint.at(0).unicode() : 0;
+         toDoubleDecimalPointCache.generation = currentGeneration;
+      }
+      return toDoubleDecimalPointCache.decimalPoint;
+   }
+
+   //! Anything longer than this is not a "simple" number as far as \c fastToDouble is concerned
+   constexpr qsizetype maxFastToDoubleLength = 64;
+
+   /**
+    * \brief Quick version of \c Localization::toDouble for the simple, common, case of text consisting only of an
+    *        optional sign, some ASCII digits and, optionally, the locale's decimal point followed by more digits (eg
+    *        "-12,5" in a French locale).  Such text means the same in all locales once the decimal point is replaced
+    *        by '.', so we can parse it in the C locale on a copy on the stack, without needing to construct a
+    *        \c QLocale or allocate a \c QString.
+    *
+    *        Anything else (group separators, exponents, surrounding spaces, etc) is left to the slow path, so we do
+    *        not have to worry about replicating the finer points of \c QLocale::toDouble.
+    *
+    * \return \c std::nullopt if \c text is not simple enough to be handled here
+    */
+   std::optional<double> fastToDouble(QStringView const text) {
+      if (text.isEmpty() || text.size() > maxFastToDoubleLength) {
+         return std::nullopt;
+      }
+
+      char16_t const decimalPoint = toDoubleDecimalPoint();
+      if (decimalPoint == 0) {
+         return std::nullopt;
+      }
+
+      std::array<char16_t, maxFastToDoubleLength> buffer;
+      qsizetype position = 0;
+      if (text[0] == '-' || text[0] == '+') {
+         buffer[position] = text[0].unicode();
+         ++position;
+      }
+
+      qsizetype const firstDigit = position;
+      bool seenDecimalPoint = false;
+      for (; position < text.size(); ++position) {
+         char16_t const character = text[position].unicode();
+         if (character >= u'0' && character <= u'9') {
+            buffer[position] = character;
+         } else if (character == decimalPoint && !seenDecimalPoint && position > firstDigit) {
+            buffer[position] = u'.';
+            seenDecimalPoint = true;
+         } else {
+            return std::nullopt;
+         }
+      }
+      // Need at least one digit, and at least one digit after any decimal point
+      if (position == firstDigit || buffer[position - 1] == u'.') {
+         return std::nullopt;
+      }
+
+      static QLocale const cLocale = QLocale::c();
+      bool ok = false;
+      double const result = cLocale.toDouble(QStringView{buffer.data(), position}, &ok);
+      if (!ok) {
+         return std::nullopt;
+      }
+      return result;
+   }
+
 }
 
 
@@ -126,14 +269,34 @@ QString Localization::displayDateUserFormated(QDate const & date) {
 }
 
 void Localization::setLanguage(QString twoLetterLanguage) {
+   if (btTransFile && twoLetterLanguage == currentLanguage) {
+      // Already loaded
+      return;
+   }
+
+   Diagnostics::ScopedStartupPhaseTimer phaseTimer{"Application translations"};
    currentLanguage = twoLetterLanguage;
+   ++localeGeneration;
    qApp->removeTranslator(&btTrans);
 
-   QString filename = QString("bt_%1").arg(twoLetterLanguage);
    QDir translations = QDir(Application::getResourceDir().canonicalPath() + "/translations_qm");
+   auto newFile = std::make_unique<QFile>(translations.filePath(QString("bt_%1.qm").arg(twoLetterLanguage)));
+   uchar * data = nullptr;
+   if (newFile->open(QIODevice::ReadOnly)) {
+      data = newFile->map(0, newFile->size());
+   }
 
-   if (btTrans.load(filename, translations.canonicalPath())) {
+   //
+   // Loading discards whatever btTrans held before, so, once we get here, it's safe to close the old file (which we do
+   // by replacing btTransFile).
+   //
+   if (data && btTrans.load(data, static_cast<int>(newFile->size()), translations.canonicalPath())) {
       qApp->installTranslator(&btTrans);
+      btTransFile = std::move(newFile);
+   } else {
+      qWarning() << Q_FUNC_INFO << "Could not load" << newFile->fileName() << ":" << newFile->errorString();
+      btTrans.load(nullptr, 0);
+      btTransFile.reset();
    }
    return;
 }
@@ -150,20 +313,68 @@ QString const & Localization::getSystemLanguage() {
 }
 
 bool Localization::hasUnits(QString qstr) {
-   QString decimal = QRegExp::escape(Localization::getLocale().decimalPoint());
-   QString grouping = QRegExp::escape(Localization::getLocale().groupSeparator());
-
-   QRegExp amtUnit("((?:\\d+" + grouping + ")?\\d+(?:" + decimal + "\\d+)?|" + decimal + "\\d+)\\s*(\\w+)?");
-   amtUnit.indexIn(qstr);
-
-   bool result = amtUnit.cap(2).size() > 0;
+   // Units have to start with a "word" character, so, eg, "5 %" does not count as having units
+   Localization::AmountParts const parts = Localization::splitAmount(qstr);
+   bool result = !parts.units.isEmpty() && isWordCharacter(parts.units.front());
 
    qDebug() << Q_FUNC_INFO << qstr << (result ? "has" : "does not have") << "units";
 
    return result;
 }
 
-double Localization::toDouble(QString text, bool* ok) {
+Localization::AmountParts Localization::splitAmount(QStringView const input) {
+   //
+   // This does the same as matching the following regular expression (where G is the grouping separator and D the
+   // decimal point), which is what we used to do, but without having to build or run a regular expression:
+   //
+   //    ((?:\d+G)?\d+(?:D\d+)?|D\d+)\s*(\S+)?
+   //
+   // Note that only one grouping separator is allowed in the number.
+   //
+   NumberSeparators const & separators = numberSeparators();
+
+   for (qsizetype start = 0; start < input.size(); ++start) {
+      qsizetype end = start;
+      if (input[start].isDigit()) {
+         end = skipDigits(input, start);
+         if (separatorThenDigitAt(input, end, separators.groupSeparator)) {
+            end = skipDigits(input, end + separators.groupSeparator.size());
+         }
+         if (separatorThenDigitAt(input, end, separators.decimalPoint)) {
+            end = skipDigits(input, end + separators.decimalPoint.size());
+         }
+      } else if (separatorThenDigitAt(input, start, separators.decimalPoint)) {
+         end = skipDigits(input, start + separators.decimalPoint.size());
+      } else {
+         continue;
+      }
+
+      qsizetype unitsStart = end;
+      while (unitsStart < input.size() && input[unitsStart].isSpace()) {
+         ++unitsStart;
+      }
+      qsizetype unitsEnd = unitsStart;
+      while (unitsEnd < input.size() && !input[unitsEnd].isSpace()) {
+         ++unitsEnd;
+      }
+      return AmountParts{
+         .quantity = input.mid(start, end - start),
+         .units    = input.mid(unitsStart, unitsEnd - unitsStart),
+      };
+   }
+
+   return AmountParts{};
+}
+
+double Localization::toDouble(QStringView const text, bool* ok) {
+   std::optional<double> const quickResult = fastToDouble(text);
+   if (quickResult) {
+      if (ok != nullptr) {
+         *ok = true;
+      }
+      return *quickResult;
+   }
+
    // Try system locale first
    bool success = false;
    QLocale sysDefault = QLocale();
@@ -171,7 +382,7 @@ double Localization::toDouble(QString text, bool* ok) {
 
    // If we failed, try C locale (ie what QString now does by default)
    if (!success) {
-      ret = text.toDouble(&success);
+      ret = text.toString().toDouble(&success);
    }
 
    // If we were asked to return the success, return it here.
@@ -202,7 +413,7 @@ double Localization::toDouble(NamedEntity const & element,
    return 0.0;
 }
 
-double Localization::toDouble(QString text, char const * const caller) {
+double Localization::toDouble(QStringView const text, char const * const caller) {
    bool success = false;
    double ret = Localization::toDouble(text, &success);
 
@@ -220,6 +431,7 @@ void Localization::loadTranslations() {
    }
 
    // Load translators.
+   Diagnostics::ScopedStartupPhaseTimer phaseTimer{"Qt translations"};
    defaultTrans.load("qt_" + Localization::getLocale().name(), QLibraryInfo::location(QLibraryInfo::TranslationsPath));
    if (getCurrentLanguage().isEmpty()) {
       setLanguage(getSystemLanguage());
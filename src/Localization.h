@@ -23,6 +23,7 @@
 #include <QDate>
 #include <QLocale>
 #include <QString>
+#include <QStringView>
 
 class BtStringConst;
 class NamedEntity;
@@ -106,10 +107,13 @@ namespace Localization {
     *        Qt5 changed how QString::toDouble() works in that it will always convert in the C locale.  We are
     *        instructed to use QLocale::toDouble instead, except that will never fall back to the C locale.  This
     *        doesn't really work for us, so this function emulates the old behavior.
+    *
+    *        Plain numbers such as "-12,5" (ie no group separators, exponent or spaces) are parsed directly, using the
+    *        default locale's decimal point, which we cache rather than constructing a \c QLocale every time.
     * \param text
     * \param ok
     */
-   double toDouble(QString text, bool* ok = nullptr);
+   double toDouble(QStringView const text, bool* ok = nullptr);
 
    /**
     * \brief Convenience wrapper around \c toDouble()
@@ -126,7 +130,7 @@ namespace Localization {
     * \param text
     * \param caller Callers should use the \c Q_FUNC_INFO macro to supply this parameter
     */
-   double toDouble(QString text, char const * const caller);
+   double toDouble(QStringView const text, char const * const caller);
 
    /**
     * \brief For a given string, determines whether it is just a number or a number plus units.
@@ -148,6 +152,27 @@ namespace Localization {
     */
    bool hasUnits(QString qstr);
 
+   /**
+    * \brief The parts of an amount string such as "1.234,5 kg", as found by \c splitAmount.  Both parts are views into
+    *        the string that was split, so are only valid as long as it is.
+    */
+   struct AmountParts {
+      //! The number, including any grouping separator and decimal point, or empty if there isn't one
+      QStringView quantity;
+      //! The non-space characters following the number (and any whitespace after it), or empty if there are none
+      QStringView units;
+   };
+
+   /**
+    * \brief Find the first number in \c input, along with whatever units follow it.  This is what underlies
+    *        \c hasUnits and \c Measurement::Unit::splitAmountString, which get called a lot (on every edit of an
+    *        amount field, for instance), so it is a hand-written scanner that does not allocate anything.
+    *
+    *        As in \c hasUnits, the number can be X,XXX.YZ or .YZ (with the decimal point and grouping separator
+    *        of \c getLocale).
+    */
+   AmountParts splitAmount(QStringView input);
+
    /**
     * \brief Load translation files.
     */
@@ -18,12 +18,18 @@
  ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
 #include "Logging.h"
 
+#include <atomic>
+#include <cstring>      // For std::strstr
 #include <sstream>      // For std::ostringstream
+#include <thread>
+#include <vector>
 
 #include <boost/stacktrace.hpp>
 
 #include <QApplication>
 #include <QDebug>
+#include <QElapsedTimer>
+#include <QMap>
 #include <QMutex>
 #include <QMutexLocker>
 #include <QObject>
@@ -31,9 +37,11 @@
 #include <QTextStream>
 #include <QThread>
 #include <QTime>
+#include <QWaitCondition>
 
 #include "config.h"
 #include "PersistentSettings.h"
+#include "utils/BoundedMpscQueue.h"
 
 // Qt has changed how you do endl in writing to a QTextStream
 #if QT_VERSION < QT_VERSION_CHECK(5,14,0)
@@ -49,6 +57,14 @@ namespace {
 
    Logging::Level currentLoggingLevel = Logging::LogLevel_INFO;
 
+   // For Diagnostics.  NB: Messages in our own categories that are below the logging level are discarded by Qt before
+   // they get to us, so don't count towards numMessagesFiltered.
+   std::atomic<qint64> numMessagesLogged{0};
+   std::atomic<qint64> numMessagesFiltered{0};
+
+   // Levels for the categories that have their own (rather than just using currentLoggingLevel)
+   QMap<QString, Logging::Level> categoryLoggingLevels;
+
    // We decompose the log filename into its body and suffix for log rotation
    // The _current_ log file is always "[applicaiton name].log"
    static QString const logFilename = QString{CONFIG_APPLICATION_NAME_LC};
@@ -122,20 +138,155 @@ namespace {
    }
 
    //
-   // This is what actually outputs a message to the log file and/or std::cerr
+   // Everything we need to write out one log message.  We capture this on the thread doing the logging, but leave the
+   // formatting to whichever thread writes it out.  (QString is implicitly shared with atomic reference counting, so
+   // it's safe and cheap to hand over to another thread.)
    //
-   void doLog(const Logging::Level level, const QString message) {
-      QString logEntry = QString{"[%1] (%2) %3 : %4"}.arg(QTime::currentTime().toString(timeFormat))
-                                                     .arg(threadId)
-                                                     .arg(Logging::getStringFromLogLevel(level))
-                                                     .arg(message);
-      QMutexLocker locker(&mutex);
-      if (isLoggingToStderr ||
-          forceStderrLogging) { errStream << logEntry << END_OF_LINE; }
-      if (stream)             {   *stream << logEntry << END_OF_LINE; }
+   struct LogRecord {
+      QTime          time;
+      Logging::Level level;
+      QString        threadId;
+      QString        message;
+      //! Points into the (static) string we got from QMessageLogContext::file, so no copying needed
+      char const *   sourceFile = "";
+      int            line = 0;
+      bool           toStderr = false;
+   };
+
+   QString formatLogEntry(LogRecord const & record) {
+      return QString{"[%1] (%2) %3 : %4  [%5:%6]"}.arg(record.time.toString(timeFormat),
+                                                        record.threadId,
+                                                        Logging::getStringFromLogLevel(record.level),
+                                                        record.message,
+                                                        QString{record.sourceFile},
+                                                        QString::number(record.line));
+   }
+
+   //
+   // This is what actually outputs a message to the log file and/or std::cerr when we are logging synchronously.
+   // Caller is responsible for holding the mutex.
+   //
+   void doLog(LogRecord const & record) {
+      QString const logEntry = formatLogEntry(record);
+      if (record.toStderr) { errStream << logEntry << END_OF_LINE; }
+      if (stream)          {   *stream << logEntry << END_OF_LINE; }
+      return;
+   }
+
+   //! Log records waiting for the writer thread.  Any thread that logs is a producer; the writer is the consumer.
+   BoundedMpscQueue<LogRecord, 4096> logQueue;
+
+   //
+   // The writer thread takes records off logQueue and writes them out in batches, flushing once per batch rather than
+   // once per message.  It is also responsible for rotating and pruning log files, so that that's only checked once
+   // per batch too.
+   //
+   // Until the writer thread is started (and after it's stopped), we log synchronously, as before.  We also do so on
+   // the writer thread itself, which only logs about problems opening log files.
+   //
+   std::thread * writerThread = nullptr;
+   std::atomic<bool> asyncLoggingRunning{false};
+   std::atomic<bool> stopWriter{false};
+   thread_local bool isWriterThread{false};
+
+   //! Number of records the writer has finished writing.  Lets ERROR-level logging wait until it's actually written.
+   std::atomic<std::size_t> numRecordsWritten{0};
+
+   //
+   // When there's nothing to write, the writer thread waits on writerWakeCondition.  Producers only need to take
+   // writerWakeMutex (to signal the condition) if the writer is idle, so, when lots is being logged, they just add to
+   // the queue.  The wait times out anyway, so we don't care about the rare case where a producer adds a record just
+   // as the writer is deciding to go idle.
+   //
+   QMutex writerWakeMutex;
+   QWaitCondition writerWakeCondition;
+   std::atomic<bool> writerIsIdle{false};
+   unsigned long const writerIdleWait_ms = 50;
+
+   //! Most records we'll write in one go
+   std::size_t const maxBatchSize = 512;
+
+   //! Most time an ERROR-level log call waits for the writer thread
+   qint64 const maxWaitForWriter_ms = 1000;
+
+   void wakeWriter() {
+      QMutexLocker wakeLocker(&writerWakeMutex);
+      writerWakeCondition.wakeOne();
       return;
    }
 
+   /**
+    * \brief Where we are logging asynchronously, this is called on the logging thread to hand the record over to the
+    *        writer thread.  If the queue is full, we wait for the writer to catch up rather than drop the record.
+    *
+    * \return Position of the record in the log queue
+    */
+   std::size_t enqueueLogRecord(LogRecord & record) {
+      std::size_t position = 0;
+      while (!logQueue.tryPush(record, position)) {
+         wakeWriter();
+         QThread::yieldCurrentThread();
+      }
+      if (writerIsIdle.load()) {
+         wakeWriter();
+      }
+      return position;
+   }
+
+   /**
+    * \brief Waits (for a reasonable time) until the writer thread has written the log record at \c position.  We use
+    *        this for errors because, if we are about to crash (or, after qFatal, abort), we want to see the message.
+    */
+   void waitForWriter(std::size_t const position) {
+      QElapsedTimer timer;
+      timer.start();
+      wakeWriter();
+      while (numRecordsWritten.load(std::memory_order_acquire) <= position &&
+             timer.elapsed() < maxWaitForWriter_ms) {
+         QThread::yieldCurrentThread();
+      }
+      return;
+   }
+
+   /**
+    * \brief Tells Qt which levels are enabled for each of our logging categories (and the default one).  Qt then stores
+    *        this in each category, so that qCDebug() etc can cheaply check it before evaluating anything else.
+    */
+   void applyLoggingRules() {
+      QString rules;
+      QTextStream rulesStream{&rules};
+      auto addRules = [&rulesStream](QString const & categoryName, Logging::Level const level) {
+         rulesStream <<
+            categoryName << ".debug="   << (level <= Logging::LogLevel_DEBUG   ? "true" : "false") << "\n" <<
+            categoryName << ".info="    << (level <= Logging::LogLevel_INFO    ? "true" : "false") << "\n" <<
+            categoryName << ".warning=" << (level <= Logging::LogLevel_WARNING ? "true" : "false") << "\n" <<
+            categoryName << ".critical=true\n";
+      };
+      addRules("default", currentLoggingLevel);
+      for (QString const & categoryName : Logging::categoryNames) {
+         addRules(categoryName, categoryLoggingLevels.value(categoryName, currentLoggingLevel));
+      }
+      rulesStream.flush();
+      QLoggingCategory::setFilterRules(rules);
+      return;
+   }
+
+   /**
+    * \return \c true if \c categoryName is one of ours, in which case Qt will already have checked the level before
+    *         calling the message handler.
+    */
+   bool isProjectCategory(char const * categoryName) {
+      if (!categoryName) {
+         return false;
+      }
+      for (QString const & projectCategoryName : Logging::categoryNames) {
+         if (projectCategoryName == QLatin1String{categoryName}) {
+            return true;
+         }
+      }
+      return false;
+   }
+
    /**
     * \brief Generates a log file name
     */
@@ -260,6 +411,87 @@ namespace {
       return;
    }
 
+   /**
+    * \brief Writes out a batch of log records and, if necessary, rotates the log file first.  Must only be called from
+    *        one thread at a time.
+    */
+   void writeLogRecords(std::vector<LogRecord> const & batch) {
+      // Check if there is a file actually set yet.  In a rare case if the logfile was not created at initialization,
+      // then we won't be logging to a file, and we cannot do any of the pruning or filename generation.
+      bool needsRotation = false;
+      {
+         QMutexLocker locker(&mutex);
+         needsRotation = stream && logFile.size() >= Logging::logFileSize;
+      }
+      if (needsRotation) {
+         pruneLogFiles();
+         openLogFile();
+      }
+
+      QMutexLocker locker(&mutex);
+      bool wroteToStderr = false;
+      for (LogRecord const & record : batch) {
+         QString const logEntry = formatLogEntry(record);
+         if (record.toStderr) {
+            errStream << logEntry << '\n';
+            wroteToStderr = true;
+         }
+         if (stream) {
+            *stream << logEntry << '\n';
+         }
+      }
+      if (wroteToStderr) {
+         errStream.flush();
+      }
+      if (stream) {
+         stream->flush();
+      }
+      return;
+   }
+
+   /**
+    * \brief Takes up to \c maxBatchSize records off the log queue and writes them out.  Must only be called from one
+    *        thread at a time.
+    *
+    * \param batch Working storage, which we pass in so it doesn't have to be reallocated each time
+    *
+    * \return \c false if there was nothing to write
+    */
+   bool writeQueuedLogRecords(std::vector<LogRecord> & batch) {
+      LogRecord record;
+      while (batch.size() < maxBatchSize && logQueue.tryPop(record)) {
+         batch.push_back(std::move(record));
+      }
+      if (batch.empty()) {
+         return false;
+      }
+      writeLogRecords(batch);
+      numRecordsWritten.store(logQueue.numPopped(), std::memory_order_release);
+      batch.clear();
+      return true;
+   }
+
+   void runLogWriter() {
+      isWriterThread = true;
+      std::vector<LogRecord> batch;
+      batch.reserve(maxBatchSize);
+      for (;;) {
+         if (writeQueuedLogRecords(batch)) {
+            continue;
+         }
+         if (stopWriter.load(std::memory_order_acquire)) {
+            break;
+         }
+         QMutexLocker wakeLocker(&writerWakeMutex);
+         writerIsIdle.store(true);
+         if (logQueue.isEmpty() && !stopWriter.load(std::memory_order_acquire)) {
+            writerWakeCondition.wait(&writerWakeMutex, writerIdleWait_ms);
+         }
+         writerIsIdle.store(false);
+      }
+      return;
+   }
+
    /**
     * \brief Handles all log messages, which should be logged using the standard Qt functions, eg:
     *        qDebug() << "message" << some_variable; //for a debug message!
@@ -267,25 +499,18 @@ namespace {
    void logMessageHandler(QtMsgType qtMsgType, QMessageLogContext const & context, QString const & message) {
       Logging::Level logLevelOfMessage = levelFromQtMsgType(qtMsgType);
       //
-      // First things first!  What logging level has the user chosen.
-      // then, if the file-stream is open and the log file size is to big, we need to prune the old logs and initiate a new logfile.
-      // after that we're all set, Log away!
+      // First things first!  What logging level has the user chosen.  After that, we just capture what we need for the
+      // log entry and hand it to the writer thread, which formats it, writes it out, and takes care of rotating log
+      // files.  This keeps the cost of logging on the calling thread low, even for lots of debug logging.
       //
 
-      // Check that we're set to log this level, this is set by the user options.
-      if (logLevelOfMessage < currentLoggingLevel) {
+      // Check that we're set to log this level, this is set by the user options.  (For our own logging categories, Qt
+      // has already done this check, taking account of any per-category level, by the time we get here.)
+      if (!isProjectCategory(context.category) && logLevelOfMessage < currentLoggingLevel) {
+         numMessagesFiltered.fetch_add(1, std::memory_order_relaxed);
          return;
       }
-
-      // Check if there is a file actually set yet.  In a rare case if the logfile was not created at initialization,
-      // then we won't be logging to a file, the location may not yet have been loaded from the settings, thus only logging to the stderr.
-      // In this case we cannot do any of the pruning or filename generation.
-      if (stream) {
-         if (logFile.size() >= Logging::logFileSize) {
-            pruneLogFiles();
-            openLogFile();
-         }
-      }
+      numMessagesLogged.fetch_add(1, std::memory_order_relaxed);
 
       // Writing the actual log
       //
@@ -297,13 +522,36 @@ namespace {
       //    version : int
       //
       // We don't want to log the full path of the source file, because that might contain private info about the
-      // directory structure on the machine on which the build was done.  We could just show the filename with:
-      //    QString sourceFile = QFileInfo(context.file).fileName();
-      // But we'd like to show the relative path under the src directory (eg database/Database.cpp rather than just
-      // Database.cpp).  (The code here assumes there will not be any subdirectory of src that is also called src,
-      // which seems pretty reasonable.)
-      QString sourceFile = QString{context.file}.split("/src/").last();
-      doLog(logLevelOfMessage, QString("%1  [%2:%3]").arg(message).arg(sourceFile).arg(context.line));
+      // directory structure on the machine on which the build was done.  We'd like to show the relative path under the
+      // src directory (eg database/Database.cpp rather than just Database.cpp), which we can do without any copying by
+      // pointing just after the last "/src/" in the full path.  (The code here assumes there will not be any
+      // subdirectory of src that is also called src, which seems pretty reasonable.)
+      //
+      // Note that context.file can be null (eg in release builds).
+      //
+      char const * sourceFile = context.file ? context.file : "";
+      for (char const * match = std::strstr(sourceFile, "/src/"); match; match = std::strstr(match + 1, "/src/")) {
+         sourceFile = match + std::strlen("/src/");
+      }
+
+      LogRecord record{QTime::currentTime(),
+                       logLevelOfMessage,
+                       threadId,
+                       message,
+                       sourceFile,
+                       context.line,
+                       isLoggingToStderr || forceStderrLogging};
+
+      if (!asyncLoggingRunning.load(std::memory_order_acquire) || isWriterThread) {
+         QMutexLocker locker(&mutex);
+         doLog(record);
+         return;
+      }
+
+      std::size_t const position = enqueueLogRecord(record);
+      if (logLevelOfMessage == Logging::LogLevel_ERROR) {
+         waitForWriter(position);
+      }
       return;
    }
 
@@ -344,6 +592,42 @@ Logging::Level Logging::getLogLevel() {
 void Logging::setLogLevel(Level newLevel) {
    currentLoggingLevel = newLevel;
    PersistentSettings::insert(PersistentSettings::Names::LoggingLevel, Logging::getStringFromLogLevel(currentLoggingLevel));
+   applyLoggingRules();
+   return;
+}
+
+qint64 Logging::getNumMessagesLogged() {
+   return numMessagesLogged.load(std::memory_order_relaxed);
+}
+
+qint64 Logging::getNumMessagesFiltered() {
+   return numMessagesFiltered.load(std::memory_order_relaxed);
+}
+
+std::optional<Logging::Level> Logging::getCategoryLogLevel(QString const & categoryName) {
+   auto match = categoryLoggingLevels.constFind(categoryName);
+   if (match == categoryLoggingLevels.cend()) {
+      return std::nullopt;
+   }
+   return *match;
+}
+
+void Logging::setCategoryLogLevel(QString const & categoryName, std::optional<Level> level) {
+   // It's a coding error if we don't know about the category
+   Q_ASSERT(Logging::categoryNames.contains(categoryName));
+
+   if (level) {
+      categoryLoggingLevels.insert(categoryName, *level);
+   } else {
+      categoryLoggingLevels.remove(categoryName);
+   }
+
+   QVariantMap settingValue;
+   for (auto ii = categoryLoggingLevels.cbegin(); ii != categoryLoggingLevels.cend(); ++ii) {
+      settingValue.insert(ii.key(), Logging::getStringFromLogLevel(ii.value()));
+   }
+   PersistentSettings::insert(PersistentSettings::Names::LoggingCategoryLevels, settingValue);
+   applyLoggingRules();
    return;
 }
 
@@ -353,6 +637,13 @@ bool Logging::getLogInConfigDir() {
 
 namespace Logging {
 
+   Q_LOGGING_CATEGORY(database,      "database"     )
+   Q_LOGGING_CATEGORY(serialization, "serialization")
+   Q_LOGGING_CATEGORY(recipe,        "model.recipe" )
+   Q_LOGGING_CATEGORY(tree,          "ui.tree"      )
+
+   QStringList const categoryNames{"database", "serialization", "model.recipe", "ui.tree"};
+
    // .:TODO:. Make these configurable by the end user in OptionDialog
    // Set the log file size for the rotation.
    int const logFileSize = 500 * 1024;
@@ -366,12 +657,26 @@ bool Logging::initializeLogging() {
    TemporarilyForceStderrLogging temporarilyForceStderrLogging;
 
    currentLoggingLevel = Logging::getLogLevelFromString(PersistentSettings::value(PersistentSettings::Names::LoggingLevel, "INFO").toString());
+   QVariantMap const savedCategoryLevels =
+      PersistentSettings::value(PersistentSettings::Names::LoggingCategoryLevels, QVariantMap{}).toMap();
+   for (auto ii = savedCategoryLevels.cbegin(); ii != savedCategoryLevels.cend(); ++ii) {
+      if (Logging::categoryNames.contains(ii.key())) {
+         categoryLoggingLevels.insert(ii.key(), Logging::getLogLevelFromString(ii.value().toString()));
+      }
+   }
+   applyLoggingRules();
    Logging::setDirectory(
       PersistentSettings::contains(PersistentSettings::Names::LogDirectory) ?
          std::optional<QDir>(PersistentSettings::value(PersistentSettings::Names::LogDirectory).toString()) : std::optional<QDir>(std::nullopt)
    );
 
    qInstallMessageHandler(logMessageHandler);
+
+   if (!writerThread) {
+      stopWriter.store(false);
+      writerThread = new std::thread{runLogWriter};
+      asyncLoggingRunning.store(true, std::memory_order_release);
+   }
    qDebug() << Q_FUNC_INFO << "Logging initialized.  Logs will be written to" << logDirectory.absolutePath();
 
    // It's quite useful on debug builds to check that stack trace logging is working, rather than to find out it's not
@@ -518,6 +823,21 @@ QFileInfoList Logging::getLogFileList() {
 
 
 void Logging::terminateLogging() {
+   if (writerThread) {
+      // Anything logged from here on gets written synchronously.  The writer thread writes out everything already
+      // queued before it finishes.
+      asyncLoggingRunning.store(false, std::memory_order_release);
+      stopWriter.store(true, std::memory_order_release);
+      wakeWriter();
+      writerThread->join();
+      delete writerThread;
+      writerThread = nullptr;
+
+      // In case anything got added to the queue just as we were stopping the writer
+      std::vector<LogRecord> batch;
+      while (writeQueuedLogRecords(batch)) { }
+   }
+
    QMutexLocker locker(&mutex);
    closeLogFile();
    return;
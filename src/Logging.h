@@ -23,7 +23,9 @@
 
 #include <QDir>
 #include <QFileInfoList>
+#include <QLoggingCategory>
 #include <QString>
+#include <QStringList>
 #include <QVector>
 
 /*!
@@ -86,6 +88,50 @@ namespace Logging {
     */
    extern void setLogLevel(Level newLevel);
 
+   /**
+    * \brief Logging categories for the parts of the code that do the most logging.  These are used with \c qCDebug()
+    *        etc (eg \c qCDebug(Logging::database) << ...) rather than \c qDebug() etc, which has two benefits:
+    *           - When a level is turned off for a category, the rest of the logging statement is not evaluated at
+    *             all.  (With plain \c qDebug(), the whole message gets built before being thrown away.)
+    *           - The logging level can be set per category (see \c setCategoryLogLevel) so that, eg, we can debug the
+    *             database layer without also getting all the debug logging from recipe calculations.
+    *
+    *        Log messages that don't specify a category are in Qt's "default" category, which, like any category
+    *        without a level of its own, uses the level set by \c setLogLevel.
+    */
+   Q_DECLARE_LOGGING_CATEGORY(database)
+   Q_DECLARE_LOGGING_CATEGORY(serialization)
+   Q_DECLARE_LOGGING_CATEGORY(recipe)
+   Q_DECLARE_LOGGING_CATEGORY(tree)
+
+   /**
+    * \brief Names of the logging categories above, eg "database", "model.recipe"
+    */
+   extern QStringList const categoryNames;
+
+   /**
+    * \return The logging level set for the named category, or \c std::nullopt if it just uses the overall logging
+    *         level
+    */
+   extern std::optional<Level> getCategoryLogLevel(QString const & categoryName);
+
+   /**
+    * \brief Set (or, if \c level is \c std::nullopt, clear) the logging level for one category.  This is remembered
+    *        in persistent settings.  (Qt's \c QT_LOGGING_RULES environment variable, if set, takes precedence.)
+    */
+   extern void setCategoryLogLevel(QString const & categoryName, std::optional<Level> level);
+
+   /**
+    * \return Number of log messages written (or queued to be written) since the application started
+    */
+   extern qint64 getNumMessagesLogged();
+
+   /**
+    * \return Number of log messages that were discarded because they were below the logging level.  (This does not
+    *         include messages in the categories above, which Qt discards without evaluating them.)
+    */
+   extern qint64 getNumMessagesFiltered();
+
    /**
     * \return \b true if we are logging in the config dir (the default), \b false if we are logging in a directory
     *         configured via \c Logging::setDirectory()
@@ -137,6 +183,9 @@ namespace Logging {
    /**
     * \brief  Initialize logging to utilize the built in logging functionality in QT5
     *         This has to be called before any logging is done, but after PersistentSettings::initialise() is called.
+    *
+    *         This also starts the background thread that writes out log messages.  Until then, messages are written
+    *         synchronously.
     * \return
     */
    extern bool initializeLogging();
@@ -158,7 +207,8 @@ namespace Logging {
    extern QFileInfoList getLogFileList();
 
    /**
-    * \brief Terminate logging
+    * \brief Terminate logging.  Stops the background log writer thread (once it has written out everything already
+    *        logged) and closes the log file.
     */
    extern void terminateLogging();
 
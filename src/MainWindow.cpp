@@ -41,12 +41,16 @@
 #include <algorithm>
 #include <memory>
 #include <mutex> // For std::once_flag etc
+#include <optional>
+#include <utility>
 
 #include <QAction>
+#include <QApplication>
 #include <QBrush>
 #include <QDesktopWidget>
 #include <QFile>
 #include <QFileDialog>
+#include <QHash>
 #include <QIcon>
 #include <QInputDialog>
 #include <QIODevice>
@@ -57,10 +61,14 @@
 #include <QMessageBox>
 #include <QPen>
 #include <QPixmap>
+#include <QShortcut>
+#include <QSqlDatabase>
 #include <QSize>
+#include <QStandardPaths>
 #include <QString>
 #include <QTextStream>
 #include <QtGui>
+#include <QTimer>
 #include <QToolButton>
 #include <QUndoStack>
 #include <QUrl>
@@ -73,12 +81,16 @@
 #include "Algorithms.h"
 #include "AncestorDialog.h"
 #include "Application.h"
+#include "BrewNoteAnalytics.h"
+#include "BrewNoteAnalyticsDialog.h"
 #include "BrewNoteWidget.h"
 #include "BtDatePopup.h"
 #include "model/Folder.h"
 #include "BtHorizontalTabs.h"
 #include "BtTabWidget.h"
 #include "ConverterTool.h"
+#include "DiagnosticsDialog.h"
+#include "GlobalSearchDialog.h"
 #include "HelpDialog.h"
 #include "Html.h"
 #include "HydrometerTool.h"
@@ -92,10 +104,15 @@
 #include "PrimingDialog.h"
 #include "PrintAndPreviewDialog.h"
 #include "RangedSlider.h"
+#include "RecipeComparisonDialog.h"
+#include "RecipeEvaluator.h"
 #include "RecipeFormatter.h"
 #include "RefractoDialog.h"
 #include "ScaleRecipeTool.h"
+#include "ShoppingList.h"
+#include "SimilarRecipesDialog.h"
 #include "StrikeWaterDialog.h"
+#include "StyleConformanceDialog.h"
 #include "TimerMainDialog.h"
 #include "WaterDialog.h"
 #include "catalogs/EquipmentCatalog.h"
@@ -106,7 +123,9 @@
 #include "catalogs/YeastCatalog.h"
 #include "config.h"
 #include "database/Database.h"
+#include "database/DbTransaction.h"
 #include "database/ObjectStoreWrapper.h"
+#include "database/SearchIndex.h"
 #include "editors/BoilEditor.h"
 #include "editors/BoilStepEditor.h"
 #include "editors/EquipmentEditor.h"
@@ -132,10 +151,13 @@
 #include "model/Equipment.h"
 #include "model/Fermentable.h"
 #include "model/Fermentation.h"
+#include "model/Hop.h"
 #include "model/Mash.h"
+#include "model/Misc.h"
 #include "model/Recipe.h"
 #include "model/RecipeAdditionYeast.h"
 #include "model/Style.h"
+#include "model/Water.h"
 #include "model/Yeast.h"
 #include "serialization/ImportExport.h"
 #include "sortFilterProxyModels/FermentableSortFilterProxyModel.h"
@@ -155,8 +177,11 @@
 #include "undoRedo/RelationalUndoableUpdate.h"
 #include "undoRedo/UndoableAddOrRemove.h"
 #include "undoRedo/UndoableAddOrRemoveList.h"
+#include "undoRedo/UndoableInventoryDeduction.h"
 #include "utils/BtStringConst.h"
+#include "utils/Diagnostics.h"
 #include "utils/OptionalHelpers.h"
+#include "utils/Tracing.h"
 
 namespace {
 
@@ -183,6 +208,126 @@ namespace {
       return toolTip;
    }
 
+   //! Default for PersistentSettings::Names::undoLimit.  (A value of 0 means no limit.)
+   int constexpr defaultUndoLimit = 1000;
+
+   /**
+    * \brief The parts of the recipe panel that \c MainWindow::showChanges can update independently of each other.
+    *        These are bit flags, so that we can accumulate several of them before doing the update.
+    */
+   namespace RecipePanel {
+      enum Part : unsigned int {
+         None              = 0,
+         Name              = 1u <<  0,
+         BatchSize         = 1u <<  1,
+         BoilSize          = 1u <<  2,
+         Efficiency        = 1u <<  3,
+         BoilTime          = 1u <<  4,
+         BoilSg            = 1u <<  5,
+         Og                = 1u <<  6,
+         Fg                = 1u <<  7,
+         Abv               = 1u <<  8,
+         Ibu               = 1u <<  9,
+         Color             = 1u << 10,
+         IbuGu             = 1u << 11,
+         Calories          = 1u << 12,
+         MashTable         = 1u << 13,
+         BoilTable         = 1u << 14,
+         FermentationTable = 1u << 15,
+         HopRecalc         = 1u << 16,
+         //! Everything except the tables and the hop recalculation, which we only do when asked to update everything
+         AllWidgets        = (1u << 13) - 1,
+         Everything        = (1u << 17) - 1,
+      };
+
+      /**
+       * \brief For each property of \c Recipe (or its \c Boil) that we get told has changed, the parts of the panel
+       *        that need updating.  Properties not listed here update all the widgets (but not the tables).
+       */
+      QHash<QString, unsigned int> const & partsByProperty() {
+         static QHash<QString, unsigned int> const parts {
+            {*PropertyNames::NamedEntity::name      , Name                                },
+            {*PropertyNames::Recipe::batchSize_l    , BatchSize                           },
+            {*PropertyNames::Recipe::finalVolume_l  , BatchSize                           },
+            {*PropertyNames::Recipe::boilVolume_l   , BoilSize                            },
+            {*PropertyNames::Recipe::efficiency_pct , Efficiency                          },
+            {*PropertyNames::Recipe::boilGrav       , BoilSg                              },
+            {*PropertyNames::Recipe::og             , Og | IbuGu | Calories               },
+            {*PropertyNames::Recipe::fg             , Fg | Calories                       },
+            {*PropertyNames::Recipe::ABV_pct        , Abv                                 },
+            {*PropertyNames::Recipe::IBU            , Ibu | IbuGu                         },
+            {*PropertyNames::Recipe::color_srm      , Color                               },
+            {*PropertyNames::Recipe::caloriesPer33cl, Calories                            },
+            {*PropertyNames::Recipe::style          , Og | Fg | Color                     },
+            {*PropertyNames::Recipe::mash           , MashTable                           },
+            {*PropertyNames::Recipe::fermentation   , FermentationTable                   },
+            {*PropertyNames::Recipe::boil           , BoilSize | BoilTime | BoilTable     },
+            {*PropertyNames::Boil::preBoilSize_l    , BoilSize                            },
+            {*PropertyNames::Boil::boilTime_mins    , BoilTime                            },
+            {*PropertyNames::Boil::boilSteps        , BoilTable                           },
+            // These don't affect anything shown on the panel (other than via the properties above)
+            {*PropertyNames::Recipe::notes          , None                                },
+            {*PropertyNames::Recipe::tasteNotes     , None                                },
+            {*PropertyNames::Recipe::tasteRating    , None                                },
+            {*PropertyNames::Recipe::brewer         , None                                },
+            {*PropertyNames::Recipe::asstBrewer     , None                                },
+            {*PropertyNames::Recipe::date           , None                                },
+            {*PropertyNames::Recipe::locked         , None                                },
+            {*PropertyNames::Recipe::brewNotes      , None                                },
+            {*PropertyNames::Recipe::instructions   , None                                },
+         };
+         return parts;
+      }
+   }
+
+   //! How long the user has to stop typing in a recipe header field before we preview the effect of the change
+   int constexpr recipeHeaderPreviewDelay_ms = 250;
+
+   /**
+    * \brief Several edits to the recipe header fields (batch size, efficiency), done (and undone) together, in one DB
+    *        transaction and with one recalculation of the recipe at the end.  The individual edits are the
+    *        \c SimpleUndoableUpdate children of this command.  See \c MainWindow::commitRecipeHeaderEdits.
+    */
+   class RecipeHeaderUpdate : public QUndoCommand {
+   public:
+      RecipeHeaderUpdate(Recipe & recipe, QString const & description) :
+         QUndoCommand{description},
+         m_recipe{recipe} {
+         return;
+      }
+
+      virtual void redo() override {
+         this->inOneGo([this]() { this->QUndoCommand::redo(); return; });
+         return;
+      }
+
+      virtual void undo() override {
+         this->inOneGo([this]() { this->QUndoCommand::undo(); return; });
+         return;
+      }
+
+   private:
+      template<typename Functor>
+      void inOneGo(Functor const & action) {
+         Database & database = Database::instance();
+         QSqlDatabase connection = database.sqlDatabase();
+         DbTransaction dbTransaction{database, connection, this->text()};
+
+         bool const calcsWereEnabled = this->m_recipe.calcsEnabled();
+         this->m_recipe.setCalcsEnabled(false);
+         action();
+         this->m_recipe.setCalcsEnabled(calcsWereEnabled);
+         if (calcsWereEnabled) {
+            this->m_recipe.recalcAll();
+         }
+
+         dbTransaction.commit();
+         return;
+      }
+
+      Recipe & m_recipe;
+   };
+
    // We only want one instance of MainWindow, but we'd also like to be able to delete it when the program shuts down
    MainWindow * mainWindowInstance = nullptr;
 
@@ -248,7 +393,18 @@ public:
       m_hopAdditionsTableProxy        {nullptr},
       m_miscAdditionsTableProxy       {nullptr},
       m_yeastAdditionsTableProxy      {nullptr},
-      m_styleProxyModel               {nullptr} {
+      m_styleProxyModel               {nullptr},
+      m_pendingRecipePanelParts       {RecipePanel::None} {
+      //
+      // Merging successive edits of the same field (see SimpleUndoableUpdate::mergeWith) keeps the undo stack short in
+      // normal use, but we still cap its length so that a long editing session can't build up unlimited history.  Once
+      // the cap is reached, QUndoStack deletes the oldest commands, which also releases anything they were keeping
+      // alive (eg the removed objects held by UndoableAddOrRemove).  NB: QUndoStack ignores setUndoLimit() unless the
+      // stack is empty, so this has to be done here.
+      //
+      this->m_undoStack->setUndoLimit(
+         PersistentSettings::value(PersistentSettings::Names::undoLimit, defaultUndoLimit).toInt()
+      );
       return;
    }
 
@@ -363,15 +519,17 @@ public:
     * \brief Create the dialogs, including the file dialogs
     *
     *        Most dialogs are initialized in here. That should include any initial configurations as well.
+    *
+    *        The catalogs and the stand-alone tools are NOT created here, because none of them is needed to show the
+    *        main window and, between them, they are a noticeable part of start-up time (each catalog builds a table
+    *        model of every object of its type).  They are instead created on first use by \c getOrCreate() (or one of
+    *        the accessors that wraps it), and any catalogs not yet used are created one at a time once the event loop
+    *        is idle -- see \c warmUpNextCatalog().  The editors and the recipe-specific tools stay here because we
+    *        push the current recipe (or its parts) to them whenever it changes.
     */
    void setupDialogs() {
-      m_aboutDialog            = std::make_unique<AboutDialog           >(&m_self);
-      m_helpDialog             = std::make_unique<HelpDialog            >(&m_self);
-      m_equipCatalog           = std::make_unique<EquipmentCatalog      >(&m_self);
       m_equipEditor            = std::make_unique<EquipmentEditor       >(&m_self);
-      m_fermCatalog            = std::make_unique<FermentableCatalog    >(&m_self);
       m_fermentableEditor      = std::make_unique<FermentableEditor     >(&m_self);
-      m_hopCatalog             = std::make_unique<HopCatalog            >(&m_self);
       m_hopEditor              = std::make_unique<HopEditor             >(&m_self);
       m_mashEditor             = std::make_unique<MashEditor            >(&m_self);
       m_mashStepEditor         = std::make_unique<MashStepEditor        >(&m_self);
@@ -380,28 +538,14 @@ public:
       m_fermentationEditor     = std::make_unique<FermentationEditor    >(&m_self);
       m_fermentationStepEditor = std::make_unique<FermentationStepEditor>(&m_self);
       m_mashWizard             = std::make_unique<MashWizard            >(&m_self);
-      m_miscCatalog            = std::make_unique<MiscCatalog           >(&m_self);
       m_miscEditor             = std::make_unique<MiscEditor            >(&m_self);
-      m_styleCatalog           = std::make_unique<StyleCatalog          >(&m_self);
       m_styleEditor            = std::make_unique<StyleEditor           >(&m_self);
-      m_yeastCatalog           = std::make_unique<YeastCatalog          >(&m_self);
       m_yeastEditor            = std::make_unique<YeastEditor           >(&m_self);
       m_optionDialog           = std::make_unique<OptionDialog          >(&m_self);
       m_recipeScaler           = std::make_unique<ScaleRecipeTool       >(&m_self);
       m_recipeFormatter        = std::make_unique<RecipeFormatter       >(&m_self);
-      m_printAndPreviewDialog  = std::make_unique<PrintAndPreviewDialog >(&m_self);
       m_ogAdjuster             = std::make_unique<OgAdjuster            >(&m_self);
-      m_converterTool          = std::make_unique<ConverterTool         >(&m_self);
-      m_hydrometerTool         = std::make_unique<HydrometerTool        >(&m_self);
-      m_alcoholTool            = std::make_unique<AlcoholTool           >(&m_self);
-      m_timerMainDialog        = std::make_unique<TimerMainDialog       >(&m_self);
-      m_primingDialog          = std::make_unique<PrimingDialog         >(&m_self);
-      m_strikeWaterDialog      = std::make_unique<StrikeWaterDialog     >(&m_self);
-      m_refractoDialog         = std::make_unique<RefractoDialog        >(&m_self);
       m_mashDesigner           = std::make_unique<MashDesigner          >(&m_self);
-      m_pitchDialog            = std::make_unique<PitchDialog           >(&m_self);
-      m_btDatePopup            = std::make_unique<BtDatePopup           >(&m_self);
-      m_waterDialog            = std::make_unique<WaterDialog           >(&m_self);
       m_waterEditor            = std::make_unique<WaterEditor           >(&m_self);
       m_ancestorDialog         = std::make_unique<AncestorDialog        >(&m_self);
 
@@ -415,11 +559,11 @@ public:
     */
    void setupComboBoxes() {
       // Set equipment combo box model.
-      m_equipmentListModel = std::make_unique<EquipmentListModel>(m_self.equipmentComboBox);
+      m_equipmentListModel = EquipmentListModel::shared();
       m_self.equipmentComboBox->setModel(m_equipmentListModel.get());
 
       // Set the style combo box
-      m_styleListModel = std::make_unique<StyleListModel>(m_self.styleComboBox);
+      m_styleListModel = StyleListModel::shared();
       m_styleProxyModel = std::make_unique<StyleSortFilterProxyModel>(m_self.styleComboBox);
       m_styleProxyModel->setDynamicSortFilter(true);
       m_styleProxyModel->setSortLocaleAware(true);
@@ -428,7 +572,7 @@ public:
       m_self.styleComboBox->setModel(m_styleProxyModel.get());
 
       // Set the mash combo box
-      m_mashListModel = std::make_unique<MashListModel>(m_self.mashComboBox);
+      m_mashListModel = MashListModel::shared();
       m_self.mashComboBox->setModel(m_mashListModel.get());
 
       // Nothing to say.
@@ -879,6 +1023,161 @@ public:
       return;
    }
 
+   //! \return The recipes selected in the recipe tree (ignoring any other selected items, such as folders)
+   QList<Recipe *> selectedRecipes() const {
+      QList<Recipe *> recipes;
+      for (auto const & selection : this->m_self.treeView_recipe->selectionModel()->selectedRows()) {
+         auto nodeType = this->m_self.treeView_recipe->type(selection);
+         if (nodeType && *nodeType == TreeNode::Type::Recipe) {
+            recipes.append(this->m_self.treeView_recipe->getItem<Recipe>(selection));
+         }
+      }
+      return recipes;
+   }
+
+   /**
+    * \brief Returns the widget held in \c widget, first creating it if this has not already been done.
+    */
+   template<class Widget>
+   Widget & getOrCreate(std::unique_ptr<Widget> & widget) {
+      if (!widget) {
+         widget = std::make_unique<Widget>(&this->m_self);
+      }
+      return *widget;
+   }
+
+   /**
+    * \brief As \c getOrCreate, but for the catalogs from which ingredients can be added to the current recipe, which
+    *        need to be told on creation whether that is currently allowed.
+    */
+   template<class Catalog>
+   Catalog & getOrCreateIngredientCatalog(std::unique_ptr<Catalog> & catalog) {
+      if (!catalog) {
+         this->getOrCreate(catalog).setEnableAddToRecipe(this->m_catalogsCanAddToRecipe);
+      }
+      return *catalog;
+   }
+
+   FermentableCatalog & fermCatalog () { return this->getOrCreateIngredientCatalog(this->m_fermCatalog ); }
+   HopCatalog         & hopCatalog  () { return this->getOrCreateIngredientCatalog(this->m_hopCatalog  ); }
+   MiscCatalog        & miscCatalog () { return this->getOrCreateIngredientCatalog(this->m_miscCatalog ); }
+   YeastCatalog       & yeastCatalog() { return this->getOrCreateIngredientCatalog(this->m_yeastCatalog); }
+
+   /**
+    * \brief Add the box for searching everything (see \c SearchIndex) to the right-hand end of the toolbar
+    */
+   void setupGlobalSearch() {
+      // The spacer pushes the search box over to the right
+      auto spacer = new QWidget{this->m_self.toolBar};
+      spacer->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Preferred);
+      this->m_self.toolBar->addWidget(spacer);
+
+      this->m_globalSearchBox = new QLineEdit{this->m_self.toolBar};
+      this->m_globalSearchBox->setPlaceholderText(MainWindow::tr("Search everything"));
+      this->m_globalSearchBox->setToolTip(MainWindow::tr("Search the names and notes of all recipes, brew notes and "
+                                                         "ingredients"));
+      this->m_globalSearchBox->setClearButtonEnabled(true);
+      this->m_globalSearchBox->setMaximumWidth(240);
+      this->m_self.toolBar->addWidget(this->m_globalSearchBox);
+
+      QObject::connect(this->m_globalSearchBox, &QLineEdit::returnPressed, &this->m_self, [this]() {
+         bool const firstUse = !this->m_globalSearchDialog;
+         GlobalSearchDialog & dialog = this->getOrCreate(this->m_globalSearchDialog);
+         if (firstUse) {
+            QObject::connect(&dialog, &GlobalSearchDialog::hitChosen, &this->m_self, [this](NamedEntity * hit) {
+               this->showSearchHit(*hit);
+               return;
+            });
+         }
+         dialog.search(this->m_globalSearchBox->text());
+         return;
+      });
+
+      // Ctrl+F is already taken by the fermentables catalog
+      auto findShortcut = new QShortcut{QKeySequence{Qt::CTRL | Qt::SHIFT | Qt::Key_F}, &this->m_self};
+      QObject::connect(findShortcut, &QShortcut::activated, &this->m_self, [this]() {
+         this->m_globalSearchBox->setFocus();
+         this->m_globalSearchBox->selectAll();
+         return;
+      });
+      return;
+   }
+
+   /**
+    * \brief Select a search hit in the relevant tree, switching to that tree's tab.  Recipes are also opened.
+    */
+   void showSearchHit(NamedEntity & hit) {
+      TreeView * tree = nullptr;
+      if (auto recipe = qobject_cast<Recipe *>(&hit)) {
+         this->m_self.setRecipe(recipe);
+         tree = this->m_self.treeView_recipe;
+      }
+      else if (qobject_cast<BrewNote    *>(&hit)) { tree = this->m_self.treeView_recipe; }
+      else if (qobject_cast<Equipment   *>(&hit)) { tree = this->m_self.treeView_equip ; }
+      else if (qobject_cast<Fermentable *>(&hit)) { tree = this->m_self.treeView_ferm  ; }
+      else if (qobject_cast<Hop         *>(&hit)) { tree = this->m_self.treeView_hops  ; }
+      else if (qobject_cast<Misc        *>(&hit)) { tree = this->m_self.treeView_misc  ; }
+      else if (qobject_cast<Style       *>(&hit)) { tree = this->m_self.treeView_style ; }
+      else if (qobject_cast<Water       *>(&hit)) { tree = this->m_self.treeView_water ; }
+      else if (qobject_cast<Yeast       *>(&hit)) { tree = this->m_self.treeView_yeast ; }
+      else {
+         // It's a coding error if SearchIndex returned something we don't have a tree for
+         qCritical() << Q_FUNC_INFO << "Don't know where to show" << hit.metaObject()->className();
+         Q_ASSERT(false);
+         return;
+      }
+
+      for (int ii = 0; ii < this->m_self.tabWidget_Trees->count(); ++ii) {
+         if (this->m_self.tabWidget_Trees->widget(ii)->isAncestorOf(tree)) {
+            this->m_self.tabWidget_Trees->setCurrentIndex(ii);
+            break;
+         }
+      }
+      // setTreeSelection works on whichever tree has focus
+      tree->setFocus();
+      this->m_self.setTreeSelection(tree->findElement(&hit));
+      return;
+   }
+
+   /**
+    * \brief Sets whether ingredients can be added to the current recipe from the catalogs, including ones not yet
+    *        created.
+    */
+   void setCatalogsCanAddToRecipe(bool const enabled) {
+      this->m_catalogsCanAddToRecipe = enabled;
+      if (this->m_fermCatalog ) { this->m_fermCatalog ->setEnableAddToRecipe(enabled); }
+      if (this->m_hopCatalog  ) { this->m_hopCatalog  ->setEnableAddToRecipe(enabled); }
+      if (this->m_miscCatalog ) { this->m_miscCatalog ->setEnableAddToRecipe(enabled); }
+      if (this->m_yeastCatalog) { this->m_yeastCatalog->setEnableAddToRecipe(enabled); }
+      return;
+   }
+
+   /**
+    * \brief Creates the first catalog that does not yet exist and then, if there are others, schedules itself to run
+    *        again next time the event loop is idle.  Doing one catalog per pass means we never hold up the event loop
+    *        for long, so the main window stays responsive while this is going on.
+    */
+   void warmUpNextCatalog() {
+      bool created = false;
+      auto createIfNeeded = [&created](auto && widget, auto && createWidget) {
+         if (!created && !widget) {
+            createWidget();
+            created = true;
+         }
+         return;
+      };
+      createIfNeeded(this->m_hopCatalog  , [this]() { this->hopCatalog  (); return; });
+      createIfNeeded(this->m_fermCatalog , [this]() { this->fermCatalog (); return; });
+      createIfNeeded(this->m_yeastCatalog, [this]() { this->yeastCatalog(); return; });
+      createIfNeeded(this->m_miscCatalog , [this]() { this->miscCatalog (); return; });
+      createIfNeeded(this->m_styleCatalog, [this]() { this->getOrCreate(this->m_styleCatalog); return; });
+      createIfNeeded(this->m_equipCatalog, [this]() { this->getOrCreate(this->m_equipCatalog); return; });
+      if (created) {
+         QTimer::singleShot(0, &this->m_self, [this]() { this->warmUpNextCatalog(); return; });
+      }
+      return;
+   }
+
    //================================================ MEMBER VARIABLES =================================================
 
    MainWindow & m_self;
@@ -906,20 +1205,24 @@ public:
    std::unique_ptr<RecipeAdditionYeastSortFilterProxyModel      > m_yeastAdditionsTableProxy      ;
    std::unique_ptr<StyleSortFilterProxyModel                    > m_styleProxyModel               ;
 
-   // All initialised in setupDialogs
+   // Initialised in setupDialogs, except for the catalogs and stand-alone tools, which are created on first use by
+   // getOrCreate() -- so always access those via getOrCreate() or one of the accessors that wraps it.
    std::unique_ptr<AboutDialog           > m_aboutDialog           ;
    std::unique_ptr<AlcoholTool           > m_alcoholTool           ;
    std::unique_ptr<AncestorDialog        > m_ancestorDialog        ;
    std::unique_ptr<BoilEditor            > m_boilEditor            ;
    std::unique_ptr<BoilStepEditor        > m_boilStepEditor        ;
+   std::unique_ptr<BrewNoteAnalyticsDialog> m_brewNoteAnalyticsDialog;
    std::unique_ptr<BtDatePopup           > m_btDatePopup           ;
    std::unique_ptr<ConverterTool         > m_converterTool         ;
+   std::unique_ptr<DiagnosticsDialog     > m_diagnosticsDialog     ;
    std::unique_ptr<EquipmentCatalog      > m_equipCatalog          ;
    std::unique_ptr<EquipmentEditor       > m_equipEditor           ;
    std::unique_ptr<FermentableCatalog    > m_fermCatalog           ;
    std::unique_ptr<FermentableEditor     > m_fermentableEditor     ;
    std::unique_ptr<FermentationEditor    > m_fermentationEditor    ;
    std::unique_ptr<FermentationStepEditor> m_fermentationStepEditor;
+   std::unique_ptr<GlobalSearchDialog    > m_globalSearchDialog    ;
    std::unique_ptr<HelpDialog            > m_helpDialog            ;
    std::unique_ptr<HopCatalog            > m_hopCatalog            ;
    std::unique_ptr<HopEditor             > m_hopEditor             ;
@@ -935,11 +1238,14 @@ public:
    std::unique_ptr<PitchDialog           > m_pitchDialog           ;
    std::unique_ptr<PrimingDialog         > m_primingDialog         ;
    std::unique_ptr<PrintAndPreviewDialog > m_printAndPreviewDialog ;
+   std::unique_ptr<RecipeComparisonDialog> m_recipeComparisonDialog;
    std::unique_ptr<RecipeFormatter       > m_recipeFormatter       ;
    std::unique_ptr<RefractoDialog        > m_refractoDialog        ;
    std::unique_ptr<ScaleRecipeTool       > m_recipeScaler          ;
+   std::unique_ptr<SimilarRecipesDialog  > m_similarRecipesDialog  ;
    std::unique_ptr<StrikeWaterDialog     > m_strikeWaterDialog     ;
    std::unique_ptr<StyleCatalog          > m_styleCatalog          ;
+   std::unique_ptr<StyleConformanceDialog> m_styleConformanceDialog;
    std::unique_ptr<StyleEditor           > m_styleEditor           ;
    std::unique_ptr<TimerMainDialog       > m_timerMainDialog       ;
    std::unique_ptr<WaterDialog           > m_waterDialog           ;
@@ -947,15 +1253,31 @@ public:
    std::unique_ptr<YeastCatalog          > m_yeastCatalog          ;
    std::unique_ptr<YeastEditor           > m_yeastEditor           ;
 
-   // all things lists should go here
-   std::unique_ptr<EquipmentListModel> m_equipmentListModel;
-   std::unique_ptr<MashListModel     > m_mashListModel     ;
-   std::unique_ptr<StyleListModel    > m_styleListModel    ;
+   //! Whether ingredients can be added to the current recipe from the catalogs -- see \c setCatalogsCanAddToRecipe
+   bool m_catalogsCanAddToRecipe = true;
+
+   //! Owned by the toolbar -- see \c setupGlobalSearch
+   QLineEdit * m_globalSearchBox = nullptr;
+
+   // all things lists should go here.  List models are shared with other windows -- see ListModelBase::shared
+   std::shared_ptr<EquipmentListModel> m_equipmentListModel;
+   std::shared_ptr<MashListModel     > m_mashListModel     ;
+   std::shared_ptr<StyleListModel    > m_styleListModel    ;
 //   std::unique_ptr<WaterListModel> waterListModel;  Appears to be unused...
    std::unique_ptr<NamedMashEditor> m_namedMashEditor;
    std::unique_ptr<NamedMashEditor> m_singleNamedMashEditor;
 
    QString highSS, lowSS, goodSS, boldSS; // Palette replacements
+
+   //! The \c RecipePanel::Part flags of what \c MainWindow::refreshRecipePanel needs to update when it next runs
+   unsigned int m_pendingRecipePanelParts;
+
+   //! Edits to the recipe header fields that are waiting to be committed -- see \c MainWindow::commitRecipeHeaderEdits
+   std::optional<double> m_pendingBatchSize_l     = std::nullopt;
+   std::optional<double> m_pendingEfficiency_pct = std::nullopt;
+
+   //! Restarted on every keystroke in a recipe header field -- see \c MainWindow::previewRecipeHeader
+   QTimer * m_recipeHeaderPreviewTimer = nullptr;
 ///   QPrinter * printer = nullptr;
 
 };
@@ -1016,7 +1338,12 @@ MainWindow::MainWindow(QWidget* parent) : QMainWindow(parent), pimpl{std::make_u
 
    // Now let's ensure all the data is read in from the DB
    QString errorMessage{};
-   if (!InitialiseAllObjectStores(errorMessage)) {
+   bool objectStoresLoaded = false;
+   {
+      Diagnostics::ScopedStartupPhaseTimer phaseTimer{"Load object stores"};
+      objectStoresLoaded = InitialiseAllObjectStores(errorMessage);
+   }
+   if (!objectStoresLoaded) {
       bool bail = true;
       if (Application::isInteractive()) {
          // Can't use QErrorMessage here as it's not flexible enough for what we need
@@ -1051,6 +1378,15 @@ MainWindow::MainWindow(QWidget* parent) : QMainWindow(parent), pimpl{std::make_u
       }
    }
 
+   // If it's a shared DB, we want to see changes other users make to it
+   SubscribeToDatabaseChanges();
+
+   // Keep the full-text search index up to date (and build it if this is the first time we've run with it)
+   SearchIndex::startMaintaining();
+
+   // Every so often, clear out soft-deleted objects that are no longer needed
+   ScheduleDatabaseMaintenance();
+
    // Set the window title and a couple of other strings.  (This replaces the corresponding texts in the mainWindow.ui
    // file.)
    this->setWindowTitle(QString{"%1 - %2"}.arg(CONFIG_APPLICATION_NAME_UC, CONFIG_VERSION_STRING) );
@@ -1076,15 +1412,23 @@ void MainWindow::init() {
 
    this->setupCSS();
    // initialize all of the dialog windows
-   this->pimpl->setupDialogs();
+   {
+      Diagnostics::ScopedStartupPhaseTimer phaseTimer{"Set up dialogs"};
+      this->pimpl->setupDialogs();
+   }
    // initialize the ranged sliders
    this->setupRanges();
    // the dialogs have to be setup before this is called
    this->pimpl->setupComboBoxes();
    // do all the work to configure the tables models and their proxies
-   this->pimpl->setupTables();
+   {
+      Diagnostics::ScopedStartupPhaseTimer phaseTimer{"Set up tables"};
+      this->pimpl->setupTables();
+   }
    // Create the keyboard shortcuts
    this->setupShortCuts();
+   // Search box in the toolbar
+   this->pimpl->setupGlobalSearch();
    // Once more with the context menus too
    this->setupContextMenu();
    // do all the work for checkboxes (just one right now)
@@ -1106,17 +1450,19 @@ void MainWindow::init() {
    // This sets up things that might have been 'remembered' (ie stored in the config file) from a previous run of the
    // program - eg window size, which is stored in MainWindow::closeEvent().
    // Breaks the naming convention, doesn't it?
-   this->restoreSavedState();
+   {
+      Diagnostics::ScopedStartupPhaseTimer phaseTimer{"Restore saved state"};
+      this->restoreSavedState();
+   }
 
    // Moved from Database class
-   Recipe::connectSignalsForAllRecipes();
+   // Mash, Boil and Fermentation connect their steps' signals on first use (see StepOwnerBase::steps()), as, mostly,
+   // do Recipes (see comment in Recipe.h)
+   {
+      Diagnostics::ScopedStartupPhaseTimer phaseTimer{"Connect recipe signals"};
+      Recipe::connectSignalsForAllRecipes();
+   }
    qDebug() << Q_FUNC_INFO << "Recipe signals connected";
-   Mash::connectSignals();
-   qDebug() << Q_FUNC_INFO << "Mash signals connected";
-   Boil::connectSignals();
-   qDebug() << Q_FUNC_INFO << "Boil signals connected";
-   Fermentation::connectSignals();
-   qDebug() << Q_FUNC_INFO << "Fermentation signals connected";
 
    // I do not like this connection here.
    connect(this->pimpl->m_ancestorDialog,  &AncestorDialog::ancestoryChanged, treeView_recipe->model(), &TreeModel::versionedRecipe);
@@ -1127,12 +1473,21 @@ void MainWindow::init() {
    // doing it wrong again.
    // .:TODO:. Change this so we use the newer deleted signal!
    connect(&ObjectStoreTyped<BrewNote>::getInstance(), &ObjectStoreTyped<BrewNote>::signalObjectDeleted, this, &MainWindow::closeBrewNote);
+   // When all the recipes get recalculated in one go, they don't emit individual change signals, so we need to refresh
+   // what we show for the current one.
+   connect(&ObjectStoreTyped<Recipe>::getInstance(),
+           &ObjectStoreTyped<Recipe>::signalObjectsChangedInBulk,
+           this,
+           [this]() { this->showChanges(); return; });
 
    // Set up the pretty tool tip. It doesn't really belong anywhere, so here it is
    // .:TODO:. When we allow users to change databases without restarting, we'll need to make sure to call this whenever
    // the databae is changed (as setToolTip() just takes static text as its parameter).
    label_Brewtarget->setToolTip(getLabelToolTip());
 
+   // Now create, in the background, the catalogs we didn't create up-front -- see comment in setupDialogs()
+   QTimer::singleShot(0, this, [this]() { this->pimpl->warmUpNextCatalog(); return; });
+
    qDebug() << Q_FUNC_INFO << "MainWindow initialisation complete";
    return;
 }
@@ -1386,8 +1741,9 @@ void MainWindow::restoreSavedState() {
 void MainWindow::setupTriggers() {
    // Connect actions defined in *.ui files to methods in code
    connect(actionExit                      , &QAction::triggered, this                                      , &QWidget::close                    ); // > File > Exit
-   connect(actionAbout                     , &QAction::triggered, this->pimpl->m_aboutDialog.get()          , &QWidget::show                     ); // > About > About Brewtarget
-   connect(actionHelp                      , &QAction::triggered, this->pimpl->m_helpDialog.get()           , &QWidget::show                     ); // > About > Help
+   connect(actionAbout                     , &QAction::triggered, this, [this]() { this->pimpl->getOrCreate(this->pimpl->m_aboutDialog).show(); return; }); // > About > About Brewtarget
+   connect(actionHelp                      , &QAction::triggered, this, [this]() { this->pimpl->getOrCreate(this->pimpl->m_helpDialog).show(); return; }); // > About > Help
+   connect(actionDiagnostics               , &QAction::triggered, this, [this]() { this->pimpl->getOrCreate(this->pimpl->m_diagnosticsDialog).show(); return; }); // > About > Diagnostics
 
    connect(actionNewRecipe                 , &QAction::triggered, this                                      , &MainWindow::newRecipe             ); // > File > New Recipe
    connect(actionImportFromXml             , &QAction::triggered, this                                      , &MainWindow::importFiles           ); // > File > Import Recipes
@@ -1395,44 +1751,47 @@ void MainWindow::setupTriggers() {
    connect(actionUndo                      , &QAction::triggered, this                                      , &MainWindow::editUndo              ); // > Edit > Undo
    connect(actionRedo                      , &QAction::triggered, this                                      , &MainWindow::editRedo              ); // > Edit > Redo
    setUndoRedoEnable();
-   connect(actionEquipments                , &QAction::triggered, this->pimpl->m_equipCatalog.get()         , &QWidget::show                     ); // > View > Equipments
+   connect(actionEquipments                , &QAction::triggered, this, [this]() { this->pimpl->getOrCreate(this->pimpl->m_equipCatalog).show(); return; }); // > View > Equipments
    connect(actionMashs                     , &QAction::triggered, this->pimpl->m_namedMashEditor.get()      , &QWidget::show                     ); // > View > Mashs
-   connect(actionStyles                    , &QAction::triggered, this->pimpl->m_styleCatalog.get()         , &QWidget::show                     ); // > View > Styles
-   connect(actionFermentables              , &QAction::triggered, this->pimpl->m_fermCatalog.get()          , &QWidget::show                     ); // > View > Fermentables
-   connect(actionHops                      , &QAction::triggered, this->pimpl->m_hopCatalog.get()           , &QWidget::show                     ); // > View > Hops
-   connect(actionMiscs                     , &QAction::triggered, this->pimpl->m_miscCatalog.get()          , &QWidget::show                     ); // > View > Miscs
-   connect(actionYeasts                    , &QAction::triggered, this->pimpl->m_yeastCatalog.get()         , &QWidget::show                     ); // > View > Yeasts
+   connect(actionStyles                    , &QAction::triggered, this, [this]() { this->pimpl->getOrCreate(this->pimpl->m_styleCatalog).show(); return; }); // > View > Styles
+   connect(actionFermentables              , &QAction::triggered, this, [this]() { this->pimpl->fermCatalog().show(); return; }); // > View > Fermentables
+   connect(actionHops                      , &QAction::triggered, this, [this]() { this->pimpl->hopCatalog().show(); return; }); // > View > Hops
+   connect(actionMiscs                     , &QAction::triggered, this, [this]() { this->pimpl->miscCatalog().show(); return; }); // > View > Miscs
+   connect(actionYeasts                    , &QAction::triggered, this, [this]() { this->pimpl->yeastCatalog().show(); return; }); // > View > Yeasts
    connect(actionOptions                   , &QAction::triggered, this->pimpl->m_optionDialog.get()         , &OptionDialog::show                ); // > Tools > Options
 //   connect( actionManual, &QAction::triggered, this, &MainWindow::openManual);                                               // > About > Manual
    connect(actionScale_Recipe              , &QAction::triggered, this->pimpl->m_recipeScaler.get()         , &QWidget::show                     ); // > Tools > Scale Recipe
    connect(action_recipeToTextClipboard    , &QAction::triggered, this->pimpl->m_recipeFormatter.get()      , &RecipeFormatter::toTextClipboard  ); // > Tools > Recipe to Clipboard as Text
-   connect(actionConvert_Units             , &QAction::triggered, this->pimpl->m_converterTool.get()        , &QWidget::show                     ); // > Tools > Convert Units
-   connect(actionHydrometer_Temp_Adjustment, &QAction::triggered, this->pimpl->m_hydrometerTool.get()       , &QWidget::show                     ); // > Tools > Hydrometer Temp Adjustment
-   connect(actionAlcohol_Percentage_Tool   , &QAction::triggered, this->pimpl->m_alcoholTool.get()          , &QWidget::show                     ); // > Tools > Alcohol
+   connect(actionConvert_Units             , &QAction::triggered, this, [this]() { this->pimpl->getOrCreate(this->pimpl->m_converterTool).show(); return; }); // > Tools > Convert Units
+   connect(actionHydrometer_Temp_Adjustment, &QAction::triggered, this, [this]() { this->pimpl->getOrCreate(this->pimpl->m_hydrometerTool).show(); return; }); // > Tools > Hydrometer Temp Adjustment
+   connect(actionAlcohol_Percentage_Tool   , &QAction::triggered, this, [this]() { this->pimpl->getOrCreate(this->pimpl->m_alcoholTool).show(); return; }); // > Tools > Alcohol
    connect(actionOG_Correction_Help        , &QAction::triggered, this->pimpl->m_ogAdjuster.get()           , &QWidget::show                     ); // > Tools > OG Correction Help
    connect(actionCopy_Recipe               , &QAction::triggered, this                                      , &MainWindow::copyRecipe            ); // > File > Copy Recipe
-   connect(actionPriming_Calculator        , &QAction::triggered, this->pimpl->m_primingDialog.get()        , &QWidget::show                     ); // > Tools > Priming Calculator
-   connect(actionStrikeWater_Calculator    , &QAction::triggered, this->pimpl->m_strikeWaterDialog.get()    , &QWidget::show                     ); // > Tools > Strike Water Calculator
-   connect(actionRefractometer_Tools       , &QAction::triggered, this->pimpl->m_refractoDialog.get()       , &QWidget::show                     ); // > Tools > Refractometer Tools
+   connect(actionPriming_Calculator        , &QAction::triggered, this, [this]() { this->pimpl->getOrCreate(this->pimpl->m_primingDialog).show(); return; }); // > Tools > Priming Calculator
+   connect(actionStrikeWater_Calculator    , &QAction::triggered, this, [this]() { this->pimpl->getOrCreate(this->pimpl->m_strikeWaterDialog).show(); return; }); // > Tools > Strike Water Calculator
+   connect(actionRefractometer_Tools       , &QAction::triggered, this, [this]() { this->pimpl->getOrCreate(this->pimpl->m_refractoDialog).show(); return; }); // > Tools > Refractometer Tools
    connect(actionPitch_Rate_Calculator     , &QAction::triggered, this                                      , &MainWindow::showPitchDialog       ); // > Tools > Pitch Rate Calculator
-   connect(actionTimers                    , &QAction::triggered, this->pimpl->m_timerMainDialog.get()      , &QWidget::show                     ); // > Tools > Timers
+   connect(actionTimers                    , &QAction::triggered, this, [this]() { this->pimpl->getOrCreate(this->pimpl->m_timerMainDialog).show(); return; }); // > Tools > Timers
    connect(actionDeleteSelected            , &QAction::triggered, this                                      , &MainWindow::deleteSelected        );
    connect(actionWater_Chemistry           , &QAction::triggered, this                                      , &MainWindow::showWaterChemistryTool); // > Tools > Water Chemistry
    connect(actionAncestors                 , &QAction::triggered, this                                      , &MainWindow::setAncestor           ); // > Tools > Ancestors
+   connect(actionStyle_Conformance         , &QAction::triggered, this, [this]() { this->pimpl->getOrCreate(this->pimpl->m_styleConformanceDialog).show(); return; }); // > Tools > Style Conformance
+   connect(actionBrewNote_Analytics        , &QAction::triggered, this                                      , &MainWindow::showBrewNoteAnalytics ); // > Tools > Brew Note Analytics
    connect(action_brewit                   , &QAction::triggered, this                                      , &MainWindow::brewItHelper          );
    //One Dialog to rule them all, at least all printing and export.
-   connect(actionPrint                     , &QAction::triggered, this->pimpl->m_printAndPreviewDialog.get(), &QWidget::show                     ); // > File > Print and Preview
+   connect(actionPrint                     , &QAction::triggered, this, [this]() { this->pimpl->getOrCreate(this->pimpl->m_printAndPreviewDialog).show(); return; }); // > File > Print and Preview
 
-   // postgresql cannot backup or restore yet. I would like to find some way
-   // around this, but for now just disable
+   connect( actionBackup_Database, &QAction::triggered, this, &MainWindow::backup );                                    // > File > Database > Backup
+   // postgresql cannot restore yet (backup is a snapshot export -- see Database::backupToFile). I would like to find
+   // some way around this, but for now just disable
    if ( Database::instance().dbType() == Database::DbType::PGSQL ) {
-      actionBackup_Database->setEnabled(false);                                                                         // > File > Database > Backup
       actionRestore_Database->setEnabled(false);                                                                        // > File > Database > Restore
    }
    else {
-      connect( actionBackup_Database, &QAction::triggered, this, &MainWindow::backup );                                 // > File > Database > Backup
       connect( actionRestore_Database, &QAction::triggered, this, &MainWindow::restoreFromBackup );                     // > File > Database > Restore
    }
+   connect(actionCompact_Ingredients, &QAction::triggered, this, &MainWindow::compactDuplicateIngredients);            // > File > Database > Merge Duplicate Ingredient Copies
+   connect(actionCheck_Database     , &QAction::triggered, this, &MainWindow::checkDatabaseIntegrity     );            // > File > Database > Check Database Integrity
    return;
 }
 
@@ -1451,10 +1810,10 @@ void MainWindow::setupClicks() {
    // TODO: Make these buttons!
 //   connect(this->boilButton               , &QAbstractButton::clicked, this->pimpl->m_boilEditor        , &BoilEditor::showEditor);
 //   connect(this->fermentationButton       , &QAbstractButton::clicked, this->pimpl->m_fermentationEditor, &FermentationEditor::showEditor);
-   connect(this->pushButton_addFerm       , &QAbstractButton::clicked, this->pimpl->m_fermCatalog , &QWidget::show         );
-   connect(this->pushButton_addHop        , &QAbstractButton::clicked, this->pimpl->m_hopCatalog  , &QWidget::show         );
-   connect(this->pushButton_addMisc       , &QAbstractButton::clicked, this->pimpl->m_miscCatalog , &QWidget::show         );
-   connect(this->pushButton_addYeast      , &QAbstractButton::clicked, this->pimpl->m_yeastCatalog, &QWidget::show         );
+   connect(this->pushButton_addFerm        , &QAbstractButton::clicked, this, [this]() { this->pimpl->fermCatalog().show(); return; });
+   connect(this->pushButton_addHop         , &QAbstractButton::clicked, this, [this]() { this->pimpl->hopCatalog().show(); return; });
+   connect(this->pushButton_addMisc        , &QAbstractButton::clicked, this, [this]() { this->pimpl->miscCatalog().show(); return; });
+   connect(this->pushButton_addYeast       , &QAbstractButton::clicked, this, [this]() { this->pimpl->yeastCatalog().show(); return; });
    connect(this->pushButton_removeFerm    , &QAbstractButton::clicked, this                       , &MainWindow::removeSelectedFermentableAddition);
    connect(this->pushButton_removeHop     , &QAbstractButton::clicked, this                       , &MainWindow::removeSelectedHopAddition        );
    connect(this->pushButton_removeMisc    , &QAbstractButton::clicked, this                       , &MainWindow::removeSelectedMiscAddition       );
@@ -1511,6 +1870,26 @@ void MainWindow::setupTextEdit() {
    connect(this->lineEdit_batchSize , &SmartLineEdit::textModified, this, &MainWindow::updateRecipeBatchSize);
 ///   connect(this->lineEdit_boilSize  , &SmartLineEdit::textModified, this, &MainWindow::updateRecipeBoilSize);
    connect(this->lineEdit_efficiency, &SmartLineEdit::textModified, this, &MainWindow::updateRecipeEfficiency);
+
+   //
+   // While the user is typing in one of the fields that affect the recipe's calculated values, we show the effect of
+   // what they've typed so far (once they pause), without changing the recipe.  See previewRecipeHeader.
+   //
+   this->pimpl->m_recipeHeaderPreviewTimer = new QTimer(this);
+   this->pimpl->m_recipeHeaderPreviewTimer->setSingleShot(true);
+   this->pimpl->m_recipeHeaderPreviewTimer->setInterval(recipeHeaderPreviewDelay_ms);
+   connect(this->pimpl->m_recipeHeaderPreviewTimer, &QTimer::timeout, this, &MainWindow::previewRecipeHeader);
+   for (SmartLineEdit * field : {this->lineEdit_batchSize, this->lineEdit_efficiency}) {
+      connect(field, &QLineEdit::textEdited, this->pimpl->m_recipeHeaderPreviewTimer, qOverload<>(&QTimer::start));
+   }
+
+   // Edits to those fields are committed together when the user moves on from the recipe panel
+   connect(qApp, &QApplication::focusChanged, this, [this]([[maybe_unused]] QWidget * old, QWidget * now) {
+      if (!now || !this->tab_recipe->isAncestorOf(now)) {
+         this->commitRecipeHeaderEdits();
+      }
+      return;
+   });
    return;
 }
 
@@ -1699,6 +2078,7 @@ void MainWindow::setAncestor()
 
 // Can handle null recipes.
 void MainWindow::setRecipe(Recipe* recipe) {
+   Tracing::Span span{"MainWindow::setRecipe"};
    // Don't like void pointers.
    if (!recipe) {
       return;
@@ -1706,6 +2086,9 @@ void MainWindow::setRecipe(Recipe* recipe) {
 
    qDebug() << Q_FUNC_INFO << "Recipe #" << recipe->key() << ":" << recipe->name();
 
+   // Anything the user typed into the header of the previous recipe belongs to that recipe
+   this->commitRecipeHeaderEdits();
+
    int tabs = 0;
 
    // Make sure this MainWindow is paying attention...
@@ -1717,6 +2100,7 @@ void MainWindow::setRecipe(Recipe* recipe) {
       }
    }
    this->pimpl->m_recipeObs = recipe;
+   Recipe::setDisplayedRecipe(recipe);
 
    this->displayRangesEtcForCurrentRecipeStyle();
 
@@ -1855,10 +2239,7 @@ void MainWindow::lockRecipe(int state) {
    pushButton_removeYeast->setEnabled(enabled);
    pushButton_editYeast->setEnabled(enabled);
 
-   this->pimpl->m_fermCatalog ->setEnableAddToRecipe(enabled);
-   this->pimpl->m_hopCatalog  ->setEnableAddToRecipe(enabled);
-   this->pimpl->m_miscCatalog ->setEnableAddToRecipe(enabled);
-   this->pimpl->m_yeastCatalog->setEnableAddToRecipe(enabled);
+   this->pimpl->setCatalogsCanAddToRecipe(enabled);
    // TODO: mashes still need dealing with
    //
    return;
@@ -1884,120 +2265,144 @@ void MainWindow::showChanges(QMetaProperty* prop) {
       return;
    }
 
-   bool updateAll = (prop == nullptr);
-   QString propName;
+   unsigned int parts = RecipePanel::Everything;
    if (prop) {
-      propName = prop->name();
+      auto const & partsByProperty = RecipePanel::partsByProperty();
+      auto const entry = partsByProperty.constFind(QString{prop->name()});
+      // If we don't know which widgets depend on the property, it's safest to assume they all do
+      parts = (entry != partsByProperty.cend()) ? *entry : RecipePanel::AllWidgets;
+   }
+   if (parts == RecipePanel::None) {
+      return;
    }
 
-   // May St. Stevens preserve me
-   this->lineEdit_name      ->setText  (this->pimpl->m_recipeObs->name          ());
-   this->lineEdit_batchSize ->setQuantity(this->pimpl->m_recipeObs->batchSize_l   ());
-   // TODO: One day we'll want to do some work to properly handle no-boil recipes....
-   std::optional<double> const boilSize = this->pimpl->m_recipeObs->boil() ? this->pimpl->m_recipeObs->boil()->preBoilSize_l() : std::nullopt;
-   this->lineEdit_boilSize  ->setQuantity(boilSize);
-   this->lineEdit_efficiency->setQuantity(this->pimpl->m_recipeObs->efficiency_pct());
-   this->lineEdit_boilTime  ->setQuantity(this->pimpl->m_recipeObs->boil()->boilTime_mins());
-   this->lineEdit_name      ->setCursorPosition(0);
-   this->lineEdit_batchSize ->setCursorPosition(0);
-   this->lineEdit_boilSize  ->setCursorPosition(0);
-   this->lineEdit_efficiency->setCursorPosition(0);
-/*
-   lineEdit_calcBatchSize->setText(this->pimpl->m_recipeObs);
-   lineEdit_calcBoilSize->setText(this->pimpl->m_recipeObs);
-*/
-
-   // Color manipulation
-/*
-   if( 0.95*this->pimpl->m_recipeObs->batchSize_l() <= this->pimpl->m_recipeObs->finalVolume_l() && this->pimpl->m_recipeObs->finalVolume_l() <= 1.05*this->pimpl->m_recipeObs->batchSize_l() )
-      lineEdit_calcBatchSize->setStyleSheet(this->pimpl->goodSS);
-   else if( this->pimpl->m_recipeObs->finalVolume_l() < 0.95*this->pimpl->m_recipeObs->batchSize_l() )
-      lineEdit_calcBatchSize->setStyleSheet(this->pimpl->lowSS);
-   else
-      lineEdit_calcBatchSize->setStyleSheet(this->pimpl->highSS);
-
-   if( 0.95*this->pimpl->m_recipeObs->boilSize_l() <= this->pimpl->m_recipeObs->boilVolume_l() && this->pimpl->m_recipeObs->boilVolume_l() <= 1.05*this->pimpl->m_recipeObs->boilSize_l() )
-      lineEdit_calcBoilSize->setStyleSheet(this->pimpl->goodSS);
-   else if( this->pimpl->m_recipeObs->boilVolume_l() < 0.95* this->pimpl->m_recipeObs->boilSize_l() )
-      lineEdit_calcBoilSize->setStyleSheet(this->pimpl->lowSS);
-   else
-      lineEdit_calcBoilSize->setStyleSheet(this->pimpl->highSS);
-*/
-   this->lineEdit_boilSg->setQuantity(this->pimpl->m_recipeObs->boilGrav());
+   //
+   // A single edit typically results in several change signals (eg changing batch size means the recipe recalculates
+   // OG, FG, IBU, colour, etc, each of which signals separately), so, rather than update the widgets for each signal,
+   // we accumulate what needs updating and do it once, when control gets back to the event loop.
+   //
+   if (this->pimpl->m_pendingRecipePanelParts == RecipePanel::None) {
+      QTimer::singleShot(0, this, [this]() { this->refreshRecipePanel(); return; });
+   }
+   this->pimpl->m_pendingRecipePanelParts |= parts;
+   return;
+}
 
-   auto style = this->pimpl->m_recipeObs->style();
-   if (style) {
-      updateDensitySlider(*this->styleRangeWidget_og, *this->oGLabel, style->ogMin(), style->ogMax(), 1.120);
-   }
-   this->styleRangeWidget_og->setValue(this->oGLabel->getAmountToDisplay(this->pimpl->m_recipeObs->og()));
-
-   if (style) {
-      updateDensitySlider(*this->styleRangeWidget_fg, *this->fGLabel, style->fgMin(), style->fgMax(), 1.030);
-   }
-   this->styleRangeWidget_fg->setValue(this->fGLabel->getAmountToDisplay(this->pimpl->m_recipeObs->fg()));
-
-   this->styleRangeWidget_abv->setValue(this->pimpl->m_recipeObs->ABV_pct());
-   this->styleRangeWidget_ibu->setValue(this->pimpl->m_recipeObs->IBU());
-
-   this->rangeWidget_batchSize->setRange         (0,
-                                                  this->label_batchSize->getAmountToDisplay(this->pimpl->m_recipeObs->batchSize_l()));
-   this->rangeWidget_batchSize->setPreferredRange(0,
-                                                  this->label_batchSize->getAmountToDisplay(this->pimpl->m_recipeObs->finalVolume_l()));
-   this->rangeWidget_batchSize->setValue         (this->label_batchSize->getAmountToDisplay(this->pimpl->m_recipeObs->finalVolume_l()));
-
-   this->rangeWidget_boilsize->setRange         (0,
-                                                 this->label_boilSize->getAmountToDisplay(boilSize.value_or(0.0)));
-   this->rangeWidget_boilsize->setPreferredRange(0,
-                                                 this->label_boilSize->getAmountToDisplay(this->pimpl->m_recipeObs->boilVolume_l()));
-   this->rangeWidget_boilsize->setValue         (this->label_boilSize->getAmountToDisplay(this->pimpl->m_recipeObs->boilVolume_l()));
-
-   /* Colors need the same basic treatment as gravity */
-   if (style) {
-      updateColorSlider(*this->styleRangeWidget_srm,
-                        *this->colorSRMLabel,
-                        style->colorMin_srm(),
-                        style->colorMax_srm());
-   }
-   this->styleRangeWidget_srm->setValue(this->colorSRMLabel->getAmountToDisplay(this->pimpl->m_recipeObs->color_srm()));
-
-   // In some, incomplete, recipes, OG is approximately 1.000, which then makes GU close to 0 and thus IBU/GU insanely
-   // large.  Besides being meaningless, such a large number takes up a lot of space.  So, where gravity units are
-   // below 1, we just show IBU on the IBU/GU slider.
-   auto gravityUnits = (this->pimpl->m_recipeObs->og()-1)*1000;
-   if (gravityUnits < 1) {
-      gravityUnits = 1;
-   }
-   ibuGuSlider->setValue(this->pimpl->m_recipeObs->IBU()/gravityUnits);
-
-   label_calories->setText(
-      QString("%1").arg(
-         Measurement::getDisplayUnitSystem(Measurement::PhysicalQuantity::Volume) == Measurement::UnitSystems::volume_Metric ?
-         this->pimpl->m_recipeObs->caloriesPer33cl() : this->pimpl->m_recipeObs->caloriesPerUs12oz(),
-         0,
-         'f',
-         0
-      )
-   );
+void MainWindow::refreshRecipePanel() {
+   unsigned int const parts = this->pimpl->m_pendingRecipePanelParts;
+   this->pimpl->m_pendingRecipePanelParts = RecipePanel::None;
+   if (this->pimpl->m_recipeObs == nullptr) {
+      return;
+   }
+   Recipe & recipe = *this->pimpl->m_recipeObs;
+   auto const needs = [parts](unsigned int const part) { return (parts & part) != 0; };
+
+   // May St. Stevens preserve me
+   if (needs(RecipePanel::Name)) {
+      this->lineEdit_name->setText(recipe.name());
+      this->lineEdit_name->setCursorPosition(0);
+   }
+   if (needs(RecipePanel::BatchSize)) {
+      this->lineEdit_batchSize->setQuantity(recipe.batchSize_l());
+      this->lineEdit_batchSize->setCursorPosition(0);
+      double const batchSize   = this->label_batchSize->getAmountToDisplay(recipe.batchSize_l  ());
+      double const finalVolume = this->label_batchSize->getAmountToDisplay(recipe.finalVolume_l());
+      this->rangeWidget_batchSize->setRange         (0, batchSize  );
+      this->rangeWidget_batchSize->setPreferredRange(0, finalVolume);
+      this->rangeWidget_batchSize->setValue         (finalVolume);
+   }
+   if (needs(RecipePanel::BoilSize)) {
+      // TODO: One day we'll want to do some work to properly handle no-boil recipes....
+      std::optional<double> const boilSize = recipe.boil() ? recipe.boil()->preBoilSize_l() : std::nullopt;
+      this->lineEdit_boilSize->setQuantity(boilSize);
+      this->lineEdit_boilSize->setCursorPosition(0);
+      double const displayBoilSize   = this->label_boilSize->getAmountToDisplay(boilSize.value_or(0.0));
+      double const displayBoilVolume = this->label_boilSize->getAmountToDisplay(recipe.boilVolume_l());
+      this->rangeWidget_boilsize->setRange         (0, displayBoilSize  );
+      this->rangeWidget_boilsize->setPreferredRange(0, displayBoilVolume);
+      this->rangeWidget_boilsize->setValue         (displayBoilVolume);
+   }
+   if (needs(RecipePanel::Efficiency)) {
+      this->lineEdit_efficiency->setQuantity(recipe.efficiency_pct());
+      this->lineEdit_efficiency->setCursorPosition(0);
+   }
+   if (needs(RecipePanel::BoilTime) && recipe.boil()) {
+      this->lineEdit_boilTime->setQuantity(recipe.boil()->boilTime_mins());
+   }
+   if (needs(RecipePanel::BoilSg)) {
+      this->lineEdit_boilSg->setQuantity(recipe.boilGrav());
+   }
+
+   auto style = recipe.style();
+   if (needs(RecipePanel::Og)) {
+      if (style) {
+         updateDensitySlider(*this->styleRangeWidget_og, *this->oGLabel, style->ogMin(), style->ogMax(), 1.120);
+      }
+      this->styleRangeWidget_og->setValue(this->oGLabel->getAmountToDisplay(recipe.og()));
+   }
+   if (needs(RecipePanel::Fg)) {
+      if (style) {
+         updateDensitySlider(*this->styleRangeWidget_fg, *this->fGLabel, style->fgMin(), style->fgMax(), 1.030);
+      }
+      this->styleRangeWidget_fg->setValue(this->fGLabel->getAmountToDisplay(recipe.fg()));
+   }
+   if (needs(RecipePanel::Abv)) {
+      this->styleRangeWidget_abv->setValue(recipe.ABV_pct());
+   }
+   if (needs(RecipePanel::Ibu)) {
+      this->styleRangeWidget_ibu->setValue(recipe.IBU());
+   }
+   if (needs(RecipePanel::Color)) {
+      /* Colors need the same basic treatment as gravity */
+      if (style) {
+         updateColorSlider(*this->styleRangeWidget_srm,
+                           *this->colorSRMLabel,
+                           style->colorMin_srm(),
+                           style->colorMax_srm());
+      }
+      this->styleRangeWidget_srm->setValue(this->colorSRMLabel->getAmountToDisplay(recipe.color_srm()));
+   }
+   if (needs(RecipePanel::IbuGu)) {
+      // In some, incomplete, recipes, OG is approximately 1.000, which then makes GU close to 0 and thus IBU/GU
+      // insanely large.  Besides being meaningless, such a large number takes up a lot of space.  So, where gravity
+      // units are below 1, we just show IBU on the IBU/GU slider.
+      auto gravityUnits = (recipe.og()-1)*1000;
+      if (gravityUnits < 1) {
+         gravityUnits = 1;
+      }
+      ibuGuSlider->setValue(recipe.IBU()/gravityUnits);
+   }
+   if (needs(RecipePanel::Calories)) {
+      bool const isMetric {
+         Measurement::getDisplayUnitSystem(Measurement::PhysicalQuantity::Volume) ==
+         Measurement::UnitSystems::volume_Metric
+      };
+      label_calories->setText(
+         QString("%1").arg(
+            isMetric ? recipe.caloriesPer33cl() : recipe.caloriesPerUs12oz(),
+            0,
+            'f',
+            0
+         )
+      );
+   }
 
    // See if we need to change the mash in the table.
-   if (this->pimpl->m_recipeObs->mash() && (updateAll || propName == PropertyNames::Recipe::mash)) {
-      this->pimpl->m_mashStepTableModel->setMash(this->pimpl->m_recipeObs->mash());
+   if (needs(RecipePanel::MashTable) && recipe.mash()) {
+      this->pimpl->m_mashStepTableModel->setMash(recipe.mash());
    }
    // See if we need to change the boil in the table.
-   if (this->pimpl->m_recipeObs->boil() &&
-       (updateAll ||
-        propName == PropertyNames::Recipe::boil ||
-        propName == PropertyNames::Boil::boilSteps)) {
-      this->pimpl->m_boilStepTableModel->setBoil(this->pimpl->m_recipeObs->boil());
+   if (needs(RecipePanel::BoilTable) && recipe.boil()) {
+      this->pimpl->m_boilStepTableModel->setBoil(recipe.boil());
    }
    // See if we need to change the fermentation in the table.
-   if (this->pimpl->m_recipeObs->fermentation() && (updateAll || propName == PropertyNames::Recipe::fermentation)) {
-      this->pimpl->m_fermentationStepTableModel->setFermentation(this->pimpl->m_recipeObs->fermentation());
+   if (needs(RecipePanel::FermentationTable) && recipe.fermentation()) {
+      this->pimpl->m_fermentationStepTableModel->setFermentation(recipe.fermentation());
    }
 
    // Not sure about this, but I am annoyed that modifying the hop usage
    // modifiers isn't automatically updating my display
-   if (updateAll) {
+   if (needs(RecipePanel::HopRecalc)) {
      this->pimpl->m_recipeObs->recalcIfNeeded(Hop::staticMetaObject.className());
      this->pimpl->m_hopAdditionsTableProxy->invalidate();
    }
@@ -2258,10 +2663,8 @@ void MainWindow::updateRecipeBatchSize() {
       return;
    }
 
-   this->doOrRedoUpdate(*this->pimpl->m_recipeObs,
-                        TYPE_INFO(Recipe, batchSize_l),
-                        lineEdit_batchSize->getNonOptCanonicalQty(),
-                        tr("Change Batch Size"));
+   this->pimpl->m_pendingBatchSize_l = lineEdit_batchSize->getNonOptCanonicalQty();
+   this->recipeHeaderEdited();
    return;
 }
 
@@ -2306,10 +2709,87 @@ void MainWindow::updateRecipeEfficiency() {
       return;
    }
 
-   this->doOrRedoUpdate(*this->pimpl->m_recipeObs,
-                        TYPE_INFO(Recipe, efficiency_pct),
-                        lineEdit_efficiency->getNonOptValue<unsigned int>(),
-                        tr("Change Recipe Efficiency"));
+   this->pimpl->m_pendingEfficiency_pct = lineEdit_efficiency->getNonOptValue<unsigned int>();
+   this->recipeHeaderEdited();
+   return;
+}
+
+void MainWindow::recipeHeaderEdited() {
+   this->pimpl->m_recipeHeaderPreviewTimer->stop();
+   // The focus might already have moved on (in which case we might or might not have had the focusChanged signal yet)
+   if (!this->tab_recipe->isAncestorOf(QApplication::focusWidget())) {
+      this->commitRecipeHeaderEdits();
+   } else {
+      this->previewRecipeHeader();
+   }
+   return;
+}
+
+void MainWindow::previewRecipeHeader() {
+   if (!this->pimpl->m_recipeObs) {
+      return;
+   }
+
+   //
+   // Whilst the user is still typing, the text might not parse, or might give a silly value, in which case we just
+   // leave the display as it is.
+   //
+   bool efficiencyOk = false;
+   double const efficiency_pct = this->lineEdit_efficiency->getNonOptValue<double>(&efficiencyOk);
+   double const batchSize_l = this->lineEdit_batchSize->getNonOptCanonicalQty();
+   if (!efficiencyOk || efficiency_pct <= 0.0 || efficiency_pct > 100.0 || batchSize_l <= 0.0) {
+      return;
+   }
+
+   RecipeEvaluator::Overrides overrides;
+   overrides.batchSize_l    = batchSize_l;
+   overrides.efficiency_pct = efficiency_pct;
+   RecipeEvaluator::Results const results =
+      RecipeEvaluator::evaluate(RecipeEvaluator::snapshotOf(*this->pimpl->m_recipeObs), overrides);
+
+   // This mirrors the equivalent parts of refreshRecipePanel
+   double const displayBatchSize   = this->label_batchSize->getAmountToDisplay(batchSize_l);
+   double const displayFinalVolume = this->label_batchSize->getAmountToDisplay(results.volumes.finalVolume_l);
+   this->rangeWidget_batchSize->setRange         (0, displayBatchSize  );
+   this->rangeWidget_batchSize->setPreferredRange(0, displayFinalVolume);
+   this->rangeWidget_batchSize->setValue         (displayFinalVolume);
+   this->lineEdit_boilSg->setQuantity(results.boilGrav);
+   this->styleRangeWidget_og ->setValue(this->oGLabel->getAmountToDisplay(results.gravities.og));
+   this->styleRangeWidget_fg ->setValue(this->fGLabel->getAmountToDisplay(results.gravities.fg));
+   this->styleRangeWidget_abv->setValue(results.ABV_pct);
+   this->styleRangeWidget_ibu->setValue(results.IBU);
+   this->styleRangeWidget_srm->setValue(this->colorSRMLabel->getAmountToDisplay(results.color_srm));
+   double const gravityUnits = std::max((results.gravities.og - 1) * 1000, 1.0);
+   this->ibuGuSlider->setValue(results.IBU / gravityUnits);
+   return;
+}
+
+void MainWindow::commitRecipeHeaderEdits() {
+   std::optional<double> const batchSize_l    = std::exchange(this->pimpl->m_pendingBatchSize_l   , std::nullopt);
+   std::optional<double> const efficiency_pct = std::exchange(this->pimpl->m_pendingEfficiency_pct, std::nullopt);
+   if (!this->pimpl->m_recipeObs || (!batchSize_l && !efficiency_pct)) {
+      return;
+   }
+   this->pimpl->m_recipeHeaderPreviewTimer->stop();
+
+   Recipe & recipe = *this->pimpl->m_recipeObs;
+   bool const both = batchSize_l && efficiency_pct;
+   auto update = new RecipeHeaderUpdate(
+      recipe,
+      both ? tr("Change Batch Size and Efficiency") : batchSize_l ? tr("Change Batch Size") :
+                                                                    tr("Change Recipe Efficiency")
+   );
+   if (batchSize_l) {
+      new SimpleUndoableUpdate(recipe, TYPE_INFO(Recipe, batchSize_l), *batchSize_l, tr("Change Batch Size"), update);
+   }
+   if (efficiency_pct) {
+      new SimpleUndoableUpdate(recipe,
+                               TYPE_INFO(Recipe, efficiency_pct),
+                               *efficiency_pct,
+                               tr("Change Recipe Efficiency"),
+                               update);
+   }
+   this->doOrRedoUpdate(update);
    return;
 }
 
@@ -2413,6 +2893,8 @@ void MainWindow::doOrRedoUpdate(QUndoCommand * update) {
 // For undo/redo, we use Qt's Undo framework
 void MainWindow::editUndo() {
    Q_ASSERT(this->pimpl->m_undoStack != 0);
+   // If the user has just changed one of the recipe header fields, that's what they'll expect to undo
+   this->commitRecipeHeaderEdits();
    if ( !this->pimpl->m_undoStack->canUndo() ) {
       qDebug() << "Undo called but nothing to undo";
    } else {
@@ -2425,6 +2907,7 @@ void MainWindow::editUndo() {
 
 void MainWindow::editRedo() {
    Q_ASSERT(this->pimpl->m_undoStack != 0);
+   this->commitRecipeHeaderEdits();
    if ( !this->pimpl->m_undoStack->canRedo() ) {
       qDebug() << "Redo called but nothing to redo";
    } else {
@@ -2556,6 +3039,11 @@ void MainWindow::newRecipe() {
          newBoil->setPreBoilSize_l( equipment->kettleBoilSize_l() );
          newBoil->setBoilTime_mins( equipment->boilTime_min().value_or(Equipment::default_boilTime_mins) );
          newRec->setEquipment(equipment);
+         // If we've got brew notes for this equipment, they tell us better than a default what efficiency to expect
+         std::optional<double> const calibratedEfficiency_pct = BrewNoteAnalytics::calibratedEfficiency_pct(*newRec);
+         if (calibratedEfficiency_pct) {
+            newRec->setEfficiency_pct(*calibratedEfficiency_pct);
+         }
       }
    }
 
@@ -2714,7 +3202,7 @@ void MainWindow::setTreeSelection(QModelIndex item) {
 
 // reduces the inventory by the selected recipes
 void MainWindow::reduceInventory() {
-
+   QList<Recipe *> recipes;
    for (QModelIndex selected : treeView_recipe->selectionModel()->selectedRows()) {
       Recipe* rec = treeView_recipe->getItem<Recipe>(selected);
       if (rec == nullptr) {
@@ -2729,35 +3217,19 @@ void MainWindow::reduceInventory() {
       if (rec != this->pimpl->m_recipeObs) {
          setRecipe(rec);
       }
-
-      //
-      // Reduce fermentables, miscs, hops, yeasts
-      //
-      // Note that the amount can be mass, volume or (for Yeast and Misc) count.  We don't worry about which here as we
-      // assume that a given type of ingredient is always measured in the same way.
-      //
-      for (auto ii : rec->fermentableAdditions()) {
-         auto inv = ii->fermentable()->totalInventory();
-         inv.quantity = std::max(inv.quantity - ii->amount().quantity, 0.0);
-         ii->fermentable()->setTotalInventory(inv);
-      }
-      for (auto ii : rec->hopAdditions()) {
-         auto inv = ii->hop()->totalInventory();
-         inv.quantity = std::max(inv.quantity - ii->amount().quantity, 0.0);
-         ii->hop()->setTotalInventory(inv);
-      }
-      for (auto ii : rec->miscAdditions()) {
-         auto inv = ii->misc()->totalInventory();
-         inv.quantity = std::max(inv.quantity - ii->amount().quantity, 0.0);
-         ii->misc()->setTotalInventory(inv);
-      }
-      for (auto ii : rec->yeastAdditions()) {
-         auto inv = ii->yeast()->totalInventory();
-         inv.quantity = std::max(inv.quantity - ii->amount().quantity, 0.0);
-         ii->yeast()->setTotalInventory(inv);
+      if (!recipes.contains(rec)) {
+         recipes.append(rec);
       }
    }
 
+   //
+   // All the new amounts are worked out up front and then written in one transaction, as one undoable step.  See
+   // UndoableInventoryDeduction for how amounts in different units are handled.
+   //
+   auto deduction = std::make_unique<UndoableInventoryDeduction>(recipes, tr("Deduct Brew from Inventory"));
+   if (!deduction->isEmpty()) {
+      this->doOrRedoUpdate(deduction.release());
+   }
    return;
 }
 
@@ -2829,6 +3301,70 @@ void MainWindow::brewAgainHelper() {
    return;
 }
 
+void MainWindow::findSimilarRecipes() {
+   Recipe * recipe = this->currentRecipe();
+   if (!recipe) {
+      return;
+   }
+
+   bool const firstUse = !this->pimpl->m_similarRecipesDialog;
+   SimilarRecipesDialog & dialog = this->pimpl->getOrCreate(this->pimpl->m_similarRecipesDialog);
+   if (firstUse) {
+      connect(&dialog, &SimilarRecipesDialog::recipeChosen, this, [this](Recipe * chosenRecipe) {
+         this->setRecipe(chosenRecipe);
+         this->setTreeSelection(this->treeView_recipe->findElement(chosenRecipe));
+         return;
+      });
+   }
+   dialog.showSimilarTo(*recipe);
+   return;
+}
+
+void MainWindow::compareRecipes() {
+   QList<Recipe *> recipes;
+   for (QModelIndex selected : this->treeView_recipe->selectionModel()->selectedRows()) {
+      // As in reduceInventory, a selected brew note stands for its recipe
+      Recipe * recipe = this->treeView_recipe->getItem<Recipe>(selected);
+      if (!recipe) {
+         recipe = this->treeView_recipe->getItem<Recipe>(this->treeView_recipe->parent(selected));
+      }
+      if (recipe && !recipes.contains(recipe)) {
+         recipes.append(recipe);
+      }
+   }
+   if (recipes.isEmpty()) {
+      return;
+   }
+
+   bool const firstUse = !this->pimpl->m_recipeComparisonDialog;
+   RecipeComparisonDialog & dialog = this->pimpl->getOrCreate(this->pimpl->m_recipeComparisonDialog);
+   if (firstUse) {
+      connect(&dialog, &RecipeComparisonDialog::recipeChosen, this, [this](Recipe * chosenRecipe) {
+         this->setRecipe(chosenRecipe);
+         this->setTreeSelection(this->treeView_recipe->findElement(chosenRecipe));
+         return;
+      });
+   }
+   dialog.compare(recipes);
+   return;
+}
+
+void MainWindow::showBrewNoteAnalytics() {
+   bool const firstUse = !this->pimpl->m_brewNoteAnalyticsDialog;
+   BrewNoteAnalyticsDialog & dialog = this->pimpl->getOrCreate(this->pimpl->m_brewNoteAnalyticsDialog);
+   if (firstUse) {
+      connect(&dialog, &BrewNoteAnalyticsDialog::calibrateRecipe, this, [this](Recipe * recipe, double efficiency_pct) {
+         this->doOrRedoUpdate(*recipe,
+                              TYPE_INFO(Recipe, efficiency_pct),
+                              efficiency_pct,
+                              tr("Calibrate Recipe Efficiency"));
+         return;
+      });
+   }
+   dialog.showForRecipe(this->currentRecipe());
+   return;
+}
+
 void MainWindow::backup() {
    // NB: QDir does all the necessary magic of translating '/' to whatever current platform's directory separator is
    QString defaultBackupFileName = QDir::currentPath() + "/" + Database::getDefaultBackupFileName();
@@ -2867,6 +3403,85 @@ void MainWindow::restoreFromBackup() {
    return;
 }
 
+void MainWindow::compactDuplicateIngredients() {
+   if (QMessageBox::question(
+          this,
+          tr("Merge Duplicate Ingredient Copies"),
+          tr("Recipes using hidden copies of ingredients will be changed to use the identical ingredients instead, and "
+             "the copies deleted.  This cannot be undone, so you may wish to back up the database first.  Do you want "
+             "to continue?"),
+          QMessageBox::Yes, QMessageBox::No
+       ) == QMessageBox::No) {
+      return;
+   }
+
+   QApplication::setOverrideCursor(Qt::WaitCursor);
+   IngredientCompactionReport const report = CompactDuplicateIngredients();
+   QApplication::restoreOverrideCursor();
+
+   QMessageBox::information(
+      this,
+      tr("Merge Duplicate Ingredient Copies"),
+      tr("Removed %1 duplicate ingredient(s) and updated %2 recipe addition(s), saving about %3 KiB of memory and "
+         "%4 KiB of database file.").arg(report.duplicatesRemoved)
+                                    .arg(report.additionsRepointed)
+                                    .arg(report.cacheBytesSaved / 1024)
+                                    .arg(report.dbBytesReclaimed / 1024)
+   );
+   return;
+}
+
+void MainWindow::checkDatabaseIntegrity() {
+   QApplication::setOverrideCursor(Qt::WaitCursor);
+   DatabaseIntegrityReport report = CheckDatabaseIntegrity(false);
+   QApplication::restoreOverrideCursor();
+
+   if (report.problems.isEmpty()) {
+      QMessageBox::information(
+         this,
+         tr("Check Database Integrity"),
+         report.checksSucceeded ? tr("No problems found.") :
+                                  tr("No problems found, but some checks failed.  See log file for more details.")
+      );
+      return;
+   }
+
+   QStringList details;
+   int numAffected = 0;
+   for (DatabaseIntegrityProblem const & problem : report.problems) {
+      details << tr("%1: %2 object(s)").arg(problem.description).arg(problem.ids.size());
+      numAffected += problem.ids.size();
+   }
+   QMessageBox msgBox{
+      QMessageBox::Warning,
+      tr("Check Database Integrity"),
+      tr("Found %1 problem(s), affecting %2 object(s).  Repairing removes broken references and links between objects "
+         "(and objects whose owner is missing).  This cannot be undone, so you may wish to back up the database "
+         "first.  Do you want to repair the database?").arg(report.problems.size()).arg(numAffected),
+      QMessageBox::Yes | QMessageBox::No,
+      this
+   };
+   msgBox.setDetailedText(details.join("\n"));
+   if (msgBox.exec() != QMessageBox::Yes) {
+      return;
+   }
+
+   QApplication::setOverrideCursor(Qt::WaitCursor);
+   report = CheckDatabaseIntegrity(true);
+   QApplication::restoreOverrideCursor();
+
+   if (!report.problems.isEmpty() && !report.repaired) {
+      QMessageBox::warning(this, tr("Oops!"), tr("Operation failed.  See log file for more details."));
+   } else {
+      QMessageBox::information(
+         this,
+         tr("Check Database Integrity"),
+         tr("Repaired %1 row(s) of the database.").arg(report.rowsRepaired)
+      );
+   }
+   return;
+}
+
 // Imports all the recipes, hops, equipment or whatever from a BeerXML file into the database.
 void MainWindow::importFiles() {
    ImportExport::importFromFiles();
@@ -2923,6 +3538,7 @@ void MainWindow::removeMash() {
 }
 
 void MainWindow::closeEvent(QCloseEvent* /*event*/) {
+   this->commitRecipeHeaderEdits();
    Application::saveSystemOptions();
    PersistentSettings::insert(PersistentSettings::Names::geometry, saveGeometry());
    PersistentSettings::insert(PersistentSettings::Names::windowState, saveState());
@@ -3153,6 +3769,82 @@ void MainWindow::exportSelected() {
    return;
 }
 
+void MainWindow::exportSelectedRecipeBook() {
+   QList<Recipe *> const recipes = this->pimpl->selectedRecipes();
+   if (recipes.isEmpty()) {
+      qDebug() << Q_FUNC_INFO << "No recipes selected, so nothing to export";
+      QMessageBox msgBox{QMessageBox::Critical,
+                         tr("Nothing to export"),
+                         tr("None of the selected items is a recipe")};
+      msgBox.exec();
+      return;
+   }
+
+   QString const fileName = QFileDialog::getSaveFileName(
+      this,
+      tr("Export Recipe Book"),
+      QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation),
+      tr("PDF (*.pdf)")
+   );
+   // Empty file name means the user clicked cancel
+   if (fileName.isEmpty()) {
+      return;
+   }
+
+   QApplication::setOverrideCursor(Qt::WaitCursor);
+   bool const succeeded = this->pimpl->m_recipeFormatter->exportRecipeBookToPdf(recipes, fileName);
+   QApplication::restoreOverrideCursor();
+   if (!succeeded) {
+      QMessageBox::warning(this, tr("Oops!"), tr("Could not write the recipe book to %1").arg(fileName));
+   }
+   return;
+}
+
+void MainWindow::exportShoppingList() {
+   QList<Recipe *> const recipes = this->pimpl->selectedRecipes();
+   if (recipes.isEmpty()) {
+      QMessageBox::critical(this, tr("No recipes"), tr("None of the selected items is a recipe"));
+      return;
+   }
+
+   QString const fileName = QFileDialog::getSaveFileName(
+      this,
+      tr("Export Shopping List"),
+      QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation),
+      tr("HTML (*.html);;JSON (*.json)")
+   );
+   // Empty file name means the user clicked cancel
+   if (fileName.isEmpty()) {
+      return;
+   }
+
+   QFile file{fileName};
+   if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+      QMessageBox::warning(this, tr("Oops!"), tr("Could not write the shopping list to %1").arg(fileName));
+      return;
+   }
+   QStringList recipeNames;
+   for (Recipe const * recipe : recipes) {
+      recipeNames.append(recipe->name());
+   }
+   QVector<ShoppingList::Item> const items = ShoppingList::itemsFor(recipes);
+   QTextStream out{&file};
+   bool const isJson = fileName.endsWith(".json", Qt::CaseInsensitive);
+   if (isJson) {
+      ShoppingList::writeJson(out, recipeNames, items);
+   } else {
+      ShoppingList::writeHtml(out, recipeNames, items);
+   }
+   out.flush();
+   file.close();
+
+   // Show the report straight away, as that's usually what the user wants to do next
+   if (!isJson) {
+      QDesktopServices::openUrl(QUrl::fromLocalFile(fileName));
+   }
+   return;
+}
+
 void MainWindow::redisplayLabel() {
    // There is a lot of magic going on in the showChanges(). I can either
    // duplicate that magic or I can just call showChanges().
@@ -3163,12 +3855,13 @@ void MainWindow::redisplayLabel() {
 void MainWindow::showPitchDialog() {
    // First, copy the current recipe og and volume.
    if (this->pimpl->m_recipeObs) {
-      this->pimpl->m_pitchDialog->setWortVolume_l( this->pimpl->m_recipeObs->finalVolume_l() );
-      this->pimpl->m_pitchDialog->setWortDensity( this->pimpl->m_recipeObs->og() );
-      this->pimpl->m_pitchDialog->calculate();
+      PitchDialog & pitchDialog = this->pimpl->getOrCreate(this->pimpl->m_pitchDialog);
+      pitchDialog.setWortVolume_l( this->pimpl->m_recipeObs->finalVolume_l() );
+      pitchDialog.setWortDensity( this->pimpl->m_recipeObs->og() );
+      pitchDialog.calculate();
    }
 
-   this->pimpl->m_pitchDialog->show();
+   this->pimpl->getOrCreate(this->pimpl->m_pitchDialog).show();
    return;
 }
 
@@ -3203,9 +3896,10 @@ void MainWindow::changeBrewDate() {
          continue;
 
       // Pop the calendar, get the date.
-      if ( this->pimpl->m_btDatePopup->exec() == QDialog::Accepted )
+      BtDatePopup & btDatePopup = this->pimpl->getOrCreate(this->pimpl->m_btDatePopup);
+      if ( btDatePopup.exec() == QDialog::Accepted )
       {
-         QDate newDate = this->pimpl->m_btDatePopup->selectedDate();
+         QDate newDate = btDatePopup.selectedDate();
          target->setBrewDate(newDate);
 
          // If this note is open in a tab
@@ -3241,6 +3935,16 @@ void MainWindow::fixBrewNote() {
    return;
 }
 
+void MainWindow::recalculateBrewNotes() {
+   for (QModelIndex const & selected : treeView_recipe->selectionModel()->selectedRows()) {
+      Recipe * recipe = treeView_recipe->getItem<Recipe>(selected);
+      if (recipe) {
+         BrewNote::recalculateEffForRecipe(*recipe);
+      }
+   }
+   return;
+}
+
 void MainWindow::updateStatus(const QString status) {
    if (statusBar()) {
       statusBar()->showMessage(status, 3000);
@@ -3277,8 +3981,9 @@ void MainWindow::closeBrewNote([[maybe_unused]] int brewNoteId, std::shared_ptr<
 void MainWindow::showWaterChemistryTool() {
    if (this->pimpl->m_recipeObs) {
       if (this->pimpl->m_recipeObs->mash() && this->pimpl->m_recipeObs->mash()->mashSteps().size() > 0) {
-         this->pimpl->m_waterDialog->setRecipe(this->pimpl->m_recipeObs);
-         this->pimpl->m_waterDialog->show();
+         WaterDialog & waterDialog = this->pimpl->getOrCreate(this->pimpl->m_waterDialog);
+         waterDialog.setRecipe(this->pimpl->m_recipeObs);
+         waterDialog.show();
          return;
       }
    }
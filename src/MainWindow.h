@@ -245,11 +245,19 @@ public slots:
    void deleteSelected();
    void copySelected();
    void exportSelected();
+   //! \brief Write the selected recipes to a PDF "recipe book" -- see \c RecipeFormatter::exportRecipeBookToPdf
+   void exportSelectedRecipeBook();
+   //! \brief Write what to buy to brew the selected recipes, less what's in inventory -- see \c ShoppingList
+   void exportShoppingList();
 
    //! \brief Backup the database.
    void backup();
    //! \brief Restore the database.
    void restoreFromBackup();
+   //! \brief Merge identical hidden ingredient copies, after asking the user.  See \c CompactDuplicateIngredients.
+   void compactDuplicateIngredients();
+   //! \brief Look for broken references etc in the database and offer to repair them.  See \c CheckDatabaseIntegrity.
+   void checkDatabaseIntegrity();
 
    //! \brief makes sure we can do water chemistry before we show the window
    void showWaterChemistryTool();
@@ -262,9 +270,18 @@ public slots:
    void reBrewNote();
    void brewItHelper();
    void brewAgainHelper();
+   //! \brief shows the recipes most like the current one
+   void findSimilarRecipes();
+   //! \brief shows the selected recipes side by side
+   void compareRecipes();
+   //! \brief shows per-equipment efficiency stats from brew notes, with the option to calibrate the current recipe
+   void showBrewNoteAnalytics();
+   //! \brief takes what the selected recipe(s) use out of inventory, as one undoable step
    void reduceInventory();
    void changeBrewDate();
    void fixBrewNote();
+   //! \brief recalculates efficiency for all the brew notes of the selected recipe(s)
+   void recalculateBrewNotes();
 
    void redisplayLabel();
 
@@ -296,11 +313,14 @@ public:
    /*!
     * \brief Make the widgets in the window update changes.
     *
-    *        Updates all the widgets with info about the currently selected Recipe, except for the tables.
+    *        Updates the widgets showing info about the currently selected Recipe.  The update itself is done the next
+    *        time control returns to the event loop (see \c refreshRecipePanel), so several calls in a row only result
+    *        in one update.
     *
     *        Called by \c Recipe and \c OptionDialog::saveLoggingSettings
     *
-    * \param prop Not yet used. Will indicate which Recipe property has changed.
+    * \param prop Which Recipe (or Boil) property has changed, in which case we only update the widgets that depend on
+    *             it, or \c nullptr to update everything (including the tables).
     */
    void showChanges(QMetaProperty* prop = nullptr);
 
@@ -326,6 +346,30 @@ private:
    // pointers get passed to UndoableAddOrRemove.  We should fix that at some point.
    template<typename NE> void remove(std::shared_ptr<NE> itemToRemove);
 
+   //! \brief Does the updates accumulated by \c showChanges
+   void refreshRecipePanel();
+
+   /**
+    * \brief Called when the user has finished editing one of the recipe header fields that feed into the calculations
+    *        (batch size, efficiency).  Rather than update the recipe straight away, we remember the new value and
+    *        preview its effect.  The recipe is only updated when the user moves on from the recipe panel, so that, eg,
+    *        tabbing through several fields results in one DB transaction and one recalculation.
+    */
+   void recipeHeaderEdited();
+
+   /**
+    * \brief Show the calculated values (OG, IBU, etc) that the current recipe would have with what is currently typed
+    *        into the recipe header fields.  This works on a snapshot of the recipe (see \c RecipeEvaluator), so it
+    *        doesn't change the recipe or touch the DB.
+    */
+   void previewRecipeHeader();
+
+   /**
+    * \brief Apply any edits to the recipe header fields not yet applied to the recipe, as one undoable update.  Does
+    *        nothing if there are none.
+    */
+   void commitRecipeHeaderEdits();
+
    //! \brief Scroll to the given \c item in the currently visible item tree.
    void setTreeSelection(QModelIndex item);
 
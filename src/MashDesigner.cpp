@@ -23,8 +23,12 @@
  ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
 #include "MashDesigner.h"
 
+#include <utility>
+
 #include <QInputDialog>
 #include <QMessageBox>
+#include <QSignalBlocker>
+#include <QTimer>
 
 #include "database/ObjectStoreWrapper.h"
 #include "HeatCalculations.h"
@@ -39,7 +43,9 @@ MashDesigner::MashDesigner(QWidget * parent) : QDialog       {parent},
                                                m_mashStep    {nullptr},
                                                m_prevStep    {nullptr},
                                                m_addedWater_l{0},
-                                               m_grain_kg    {0} {
+                                               m_grain_kg    {0},
+                                               m_movedSlider {nullptr},
+                                               m_refreshPending{false} {
    this->setupUi(this);
 
    // .:TODO:. Would be good to make the label & field naming a bit more consistent in the .ui file
@@ -49,24 +55,21 @@ MashDesigner::MashDesigner(QWidget * parent) : QDialog       {parent},
    this->label_zeroVol ->setText(Measurement::displayAmount(Measurement::Amount{0, Measurement::Units::liters}));
    this->label_zeroWort->setText(Measurement::displayAmount(Measurement::Amount{0, Measurement::Units::liters}));
 
-   // Update temp slider when we move amount slider.
    //
-   // Here and below, we connect to valueChanged rather than sliderMoved as, otherwise, we don't receive any signal if
-   // the keyboard is used to move the slider.
-   connect(horizontalSlider_amount, &QAbstractSlider::valueChanged, this, &MashDesigner::updateTempSlider);
-   // Update amount slider when we move temp slider.
-   connect(horizontalSlider_temp,   &QAbstractSlider::valueChanged, this, &MashDesigner::updateAmtSlider);
-   // Update tun fullness bar when either slider moves.
-   connect(horizontalSlider_amount, &QAbstractSlider::valueChanged, this, &MashDesigner::updateFullness);
-   connect(horizontalSlider_temp,   &QAbstractSlider::valueChanged, this, &MashDesigner::updateFullness);
-   // Update amount/temp text when sliders move.
-   connect(horizontalSlider_amount, &QAbstractSlider::valueChanged, this, &MashDesigner::updateAmt);
-   connect(horizontalSlider_amount, &QAbstractSlider::valueChanged, this, &MashDesigner::updateTemp);
-   connect(horizontalSlider_temp,   &QAbstractSlider::valueChanged, this, &MashDesigner::updateAmt);
-   connect(horizontalSlider_temp,   &QAbstractSlider::valueChanged, this, &MashDesigner::updateTemp);
-   // Update collected wort when sliders move.
-   connect(horizontalSlider_amount, &QAbstractSlider::valueChanged, this, &MashDesigner::updateCollectedWort);
-   connect(horizontalSlider_temp,   &QAbstractSlider::valueChanged, this, &MashDesigner::updateCollectedWort);
+   // When either slider moves, the other one has to move to match, and the amount/temp text, tun fullness bar and
+   // collected wort all need updating -- see refreshFromSliders.
+   //
+   // We connect to valueChanged rather than sliderMoved as, otherwise, we don't receive any signal if the keyboard is
+   // used to move the slider.
+   //
+   connect(horizontalSlider_amount, &QAbstractSlider::valueChanged, this, [this]() {
+      this->sliderMoved(this->horizontalSlider_amount);
+      return;
+   });
+   connect(horizontalSlider_temp, &QAbstractSlider::valueChanged, this, [this]() {
+      this->sliderMoved(this->horizontalSlider_temp);
+      return;
+   });
    // Save the target temp whenever it's changed.
    connect(lineEdit_temp,           &SmartLineEdit::textModified,  this, &MashDesigner::saveTargetTemp);
    // Move to next step.
@@ -507,6 +510,40 @@ double MashDesigner::selectedTemp_c() {
    return T;
 }
 
+void MashDesigner::sliderMoved(QAbstractSlider * slider) {
+   //
+   // Dragging a slider generates a valueChanged signal for every position it passes through, often several per screen
+   // refresh.  So, rather than redo everything for each one, we just note which slider moved and catch up once per
+   // pass of the event loop.
+   //
+   this->m_movedSlider = slider;
+   if (!this->m_refreshPending) {
+      this->m_refreshPending = true;
+      QTimer::singleShot(0, this, &MashDesigner::refreshFromSliders);
+   }
+   return;
+}
+
+void MashDesigner::refreshFromSliders() {
+   this->m_refreshPending = false;
+   QAbstractSlider const * movedSlider = std::exchange(this->m_movedSlider, nullptr);
+   {
+      // Moving the other slider to match the one that moved does not count as a move in its own right
+      QSignalBlocker const amountBlocker{this->horizontalSlider_amount};
+      QSignalBlocker const tempBlocker  {this->horizontalSlider_temp};
+      if (movedSlider == this->horizontalSlider_amount) {
+         this->updateTempSlider();
+      } else if (movedSlider == this->horizontalSlider_temp) {
+         this->updateAmtSlider();
+      }
+   }
+   this->updateFullness();
+   this->updateAmt();
+   this->updateTemp();
+   this->updateCollectedWort();
+   return;
+}
+
 void MashDesigner::updateTempSlider() {
    if (!this->m_mashStep) {
       return;
@@ -60,8 +60,11 @@ private slots:
    void proceed(); // Go to next step.
    void saveAndClose();
    void typeChanged();
+   //! Bring everything up to date after one or both sliders moved -- see \c sliderMoved
+   void refreshFromSliders();
 
 private:
+   void sliderMoved(QAbstractSlider * slider);
    bool nextStep(int step);
    void saveStep();
    bool initializeMash();
@@ -102,6 +105,9 @@ private:
    double m_grain_kg;
    double m_MC;
    int m_curStep;
+   //! The slider the user most recently moved, if we have not yet caught up -- see \c sliderMoved
+   QAbstractSlider * m_movedSlider;
+   bool m_refreshPending;
 };
 
 #endif
@@ -221,80 +221,67 @@ void MashWizard::wizardry() {
       return;
    }
 
-   // Do first step
-   double tempFinal = mashStep->startTemp_c().value_or(0.0);
-   double tempInitial = mash->grainTemp_c();
-   double massWater = thickness_LKg * grainMass;
-   // Thermal mass of mash and water.
-   double const MCw = HeatCalculations::Cw_calGC * massWater;
-   double MC = HeatCalculations::Cgrain_calGC * grainMass;
-
-   // I am specifically ignoring BeerXML's request to only do this if mash->getEquipAdjust() is set.
-   double tempWater = MC/MCw * (tempFinal-tempInitial) + (mash->mashTunSpecificHeat_calGC().value_or(0.0)*mash->mashTunWeight_kg().value_or(0.0))/MCw * (tempFinal-mash->tunTemp_c().value_or(0.0)) + tempFinal;
-
-   // Can't have water above boiling.
-   if( tempWater > boilingPoint_c ) {
+   //
+   // Work out the infusions and decoctions for all the steps in one go, from the heat capacities of the grain, water
+   // and tun, and only then update the steps.
+   //
+   // I am specifically ignoring BeerXML's request to only include the tun in the infusion calculations if
+   // mash->getEquipAdjust() is set.
+   //
+   HeatCalculations::MashScheduleInputs inputs{
+      grainMass,
+      mash->grainTemp_c(),
+      mash->tunTemp_c().value_or(0.0),
+      mash->mashTunWeight_kg().value_or(0.0),
+      mash->mashTunSpecificHeat_calGC().value_or(0.0),
+      mash->equipAdjust(),
+      boilingPoint_c,
+      thickness_LKg,
+      {}
+   };
+   inputs.steps.reserve(steps.size());
+   for (int i = 0; i < steps.size(); ++i) {
+      auto const & step = steps[i];
+      HeatCalculations::MashScheduleStep::Kind kind = HeatCalculations::MashScheduleStep::Kind::Infusion;
+      if (i > 0 && step->isTemperature()) {
+         kind = HeatCalculations::MashScheduleStep::Kind::Temperature;
+      } else if (i > 0 && step->isDecoction()) {
+         kind = HeatCalculations::MashScheduleStep::Kind::Decoction;
+      }
+      inputs.steps.push_back({kind, step->startTemp_c().value_or(0.0), step->amount_l()});
+   }
+
+   HeatCalculations::MashSchedule const schedule = HeatCalculations::solveMashSchedule(inputs);
+   if (schedule.error == HeatCalculations::MashSchedule::Error::StrikeAboveBoiling) {
+      // Can't have water above boiling.
       QMessageBox::information(this,
                                tr("Mash too thick"),
                                tr("Your mash is too thick for desired temp. at first step."));
       return;
    }
+   if (schedule.error == HeatCalculations::MashSchedule::Error::BadDecoction) {
+      QMessageBox::critical(this, tr("Decoction error"), tr("Something went wrong in decoction calculation.") );
+      qCritical().nospace() <<
+         Q_FUNC_INFO << "Decoction at step " << schedule.errorStep << ": r=" << schedule.badDecoctionFraction;
+      return;
+   }
 
-   mashStep->setAmount_l(massWater);
-   mashStep->setInfuseTemp_c(tempWater);
-   //================End of first step=====================
-
-   // Do rest of steps.
-   // Add thermal mass of equipment to MC.
-   // I am specifically ignoring BeerXML's request to only do this if mash->getEquipAdjust() is set.
-   MC += mash->mashTunSpecificHeat_calGC().value_or(0.0) * mash->mashTunWeight_kg().value_or(0.0);
-
-   for (int i = 1; i < steps.size(); ++i) {
-      mashStep = steps[i];
-
-      if (mashStep->isTemperature()) {
-         continue;
-      } else if (mashStep->isDecoction()) {
-         double m_w, m_g, m_e, r;
-         double c_w, c_g, c_e;
-
-         tempFinal = mashStep->startTemp_c().value_or(0.0);
-         tempInitial = steps[i-1]->startTemp_c().value_or(0.0);
-
-         m_w = 0; // Total mass of water.
-         for (int j = 0; j < i; ++j) {
-            m_w += steps[j]->amount_l();
-         }
-         m_g = grainMass;
-         m_e = mash->equipAdjust() ? mash->mashTunWeight_kg().value_or(0.0) : 0.0;
-
-         c_w = HeatCalculations::Cw_calGC;
-         c_g = HeatCalculations::Cgrain_calGC;
-         c_e = mash->equipAdjust() ? mash->mashTunSpecificHeat_calGC().value_or(0.0) : 0.0;
-
-         // r is the ratio of water and grain to take out for decoction.
-         r = ((m_w*c_w + m_g*c_g + m_e*c_e)*(tempFinal-tempInitial)) / ((m_w*c_w + m_g*c_g)*(boilingPoint_c-tempFinal) + (m_w*c_w + m_g*c_g)*(tempFinal-tempInitial));
-         if( r < 0 || r > 1 ) {
-            QMessageBox::critical(this, tr("Decoction error"), tr("Something went wrong in decoction calculation.") );
-            qCritical().nospace() << Q_FUNC_INFO << "Decoction: r=" << r;
-            return;
-         }
-
-         mashStep->setAmount_l( r*(m_w + m_g/grainDensity) );
+   for (int i = 0; i < steps.size(); ++i) {
+      HeatCalculations::MashStepResult const & result = schedule.steps[static_cast<std::size_t>(i)];
+      if (result.amount_l) {
+         steps[i]->setAmount_l(*result.amount_l);
       }
-      else {
-         tempFinal = mashStep->startTemp_c().value_or(0.0);
-         tempInitial = steps[i-1]->startTemp_c().value_or(0.0);
-         tempWater = boilingPoint_c; // Assume adding boiling water to minimize final volume.
-         MC += massWater * HeatCalculations::Cw_calGC; // Add thermal mass of last addition.
-
-         massWater = (MC*(tempFinal-tempInitial))/(HeatCalculations::Cw_calGC * (tempWater-tempFinal));
-
-         mashStep->setAmount_l(massWater);
-         mashStep->setInfuseTemp_c(tempWater);
+      if (result.infuseTemp_c) {
+         steps[i]->setInfuseTemp_c(*result.infuseTemp_c);
       }
    }
 
+   double tempFinal;
+   double tempInitial;
+   double tempWater;
+   double massWater;
+   double MC = schedule.mashHeatCapacity_calC;
+
    // if no sparge, adjust volume of last step to meet target runoff volume
    if ( m_bGroup->checkedButton() == radioButton_noSparge  && steps.size() > 1) {
       double otherMashStepTotal = 0.0;
@@ -376,11 +363,7 @@ void MashWizard::wizardry() {
             ObjectStoreWrapper::insert(newMashStep);
             steps.append(newMashStep);
             newMashStep->setStepNumber(steps.size());
-            emit newMashStep->changed(
-               newMashStep->metaObject()->property(
-                     newMashStep->metaObject()->indexOfProperty(*PropertyNames::MashStep::type)
-               )
-            );
+            newMashStep->emitChanged(PropertyNames::MashStep::type, QVariant());
          }
          emit mash->stepsChanged();
       }
@@ -397,11 +380,7 @@ void MashWizard::wizardry() {
          ObjectStoreWrapper::insert(newMashStep);
          steps.append(newMashStep);
          newMashStep->setStepNumber(steps.size());
-         emit newMashStep->changed(
-            newMashStep->metaObject()->property(
-                  newMashStep->metaObject()->indexOfProperty(*PropertyNames::MashStep::type)
-            )
-         );
+         newMashStep->emitChanged(PropertyNames::MashStep::type, QVariant());
       }
 
    }
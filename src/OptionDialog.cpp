@@ -51,6 +51,7 @@
 #include "measurement/Unit.h"
 #include "measurement/UnitSystem.h"
 #include "PersistentSettings.h"
+#include "RecipeEvaluator.h"
 
 //
 // Anonymous namespace for constants, global variables and functions used only in this file
@@ -490,17 +491,8 @@ public:
                                                                  PersistentSettings::Sections::backups).toInt());
 
       // The IBU modifications. These will all be calculated from a 60 min boil. This is gonna get confusing.
-      double amt = Localization::toDouble(
-         PersistentSettings::value(PersistentSettings::Names::mashHopAdjustment, 0).toString(),
-         Q_FUNC_INFO
-      );
-      optionDialog.ibuAdjustmentMashHopDoubleSpinBox->setValue(amt * 100);
-
-      amt = Localization::toDouble(
-         PersistentSettings::value(PersistentSettings::Names::firstWortHopAdjustment, 1.1).toString(),
-         Q_FUNC_INFO
-      );
-      optionDialog.ibuAdjustmentFirstWortDoubleSpinBox->setValue(amt * 100);
+      optionDialog.ibuAdjustmentMashHopDoubleSpinBox  ->setValue(IbuMethods::mashHopAdjustment      * 100);
+      optionDialog.ibuAdjustmentFirstWortDoubleSpinBox->setValue(IbuMethods::firstWortHopAdjustment * 100);
 
       // Database stuff -- this looks weird, but trust me. We want SQLITE to be
       // the default for this field
@@ -660,6 +652,7 @@ void OptionDialog::configure_formulaCombos() {
    ibuFormulaComboBox->addItem(tr("Tinseth's approximation"), QVariant(static_cast<int>(IbuMethods::IbuFormula::Tinseth)));
    ibuFormulaComboBox->addItem(tr("Rager's approximation"  ), QVariant(static_cast<int>(IbuMethods::IbuFormula::Rager  )));
    ibuFormulaComboBox->addItem(tr("Noonan's approximation" ), QVariant(static_cast<int>(IbuMethods::IbuFormula::Noonan )));
+   ibuFormulaComboBox->addItem(tr("Hosom's mIBU"           ), QVariant(static_cast<int>(IbuMethods::IbuFormula::mIbu   )));
 
    colorFormulaComboBox->addItem(tr("Mosher's approximation"), QVariant(ColorMethods::MOSHER));
    colorFormulaComboBox->addItem(tr("Daniel's approximation"), QVariant(ColorMethods::DANIEL));
@@ -906,13 +899,29 @@ bool OptionDialog::saveDefaultUnits() {
 void OptionDialog::saveFormulae() {
    bool okay = false;
 
+   auto const oldIbuFormula             = IbuMethods::ibuFormula;
+   auto const oldColorFormula           = ColorMethods::colorFormula;
+   auto const oldMashHopAdjustment      = IbuMethods::mashHopAdjustment;
+   auto const oldFirstWortHopAdjustment = IbuMethods::firstWortHopAdjustment;
+
    int ndx = ibuFormulaComboBox->itemData(ibuFormulaComboBox->currentIndex()).toInt(&okay);
    IbuMethods::ibuFormula = static_cast<IbuMethods::IbuFormula>(ndx);
    ndx = colorFormulaComboBox->itemData(colorFormulaComboBox->currentIndex()).toInt(&okay);
    ColorMethods::colorFormula = static_cast<ColorMethods::ColorType>(ndx);
 
-   PersistentSettings::insert(PersistentSettings::Names::mashHopAdjustment, ibuAdjustmentMashHopDoubleSpinBox->value() / 100);
-   PersistentSettings::insert(PersistentSettings::Names::firstWortHopAdjustment, ibuAdjustmentFirstWortDoubleSpinBox->value() / 100);
+   IbuMethods::mashHopAdjustment      = ibuAdjustmentMashHopDoubleSpinBox->value()   / 100;
+   IbuMethods::firstWortHopAdjustment = ibuAdjustmentFirstWortDoubleSpinBox->value() / 100;
+   IbuMethods::saveHopAdjustments();
+
+   // If anything changed that goes into the recipe calculations, get all the recipes redone now, rather than leaving
+   // each one to be recalculated on its own the next time something asks for its values.
+   if (IbuMethods::ibuFormula             != oldIbuFormula        ||
+       ColorMethods::colorFormula         != oldColorFormula      ||
+       IbuMethods::mashHopAdjustment      != oldMashHopAdjustment ||
+       IbuMethods::firstWortHopAdjustment != oldFirstWortHopAdjustment) {
+      RecipeEvaluator::recalculateAllRecipes();
+   }
+   return;
 }
 
 void OptionDialog::saveLoggingSettings() {
@@ -34,6 +34,8 @@
 #include "PersistentSettings.h"
 
 #include <memory>
+#include <mutex>
+#include <optional>
 
 #include <QDebug>
 #include <QSettings>
@@ -97,6 +99,31 @@ namespace {
    QDir configDir{""};
    QDir userDataDir{""};
 
+   //
+   // QSettings::value() has to do a fair bit of work (including taking a lock and, for some types, parsing the stored
+   // string) every time it's called.  Some settings are read a lot, so we keep our own copy of every value we have read
+   // or written, keyed by fully-qualified key.  A null entry means the setting is known not to be stored.
+   //
+   // Writes still go through QSettings, which itself only writes the file out to disk some time later (or when we
+   // exit).
+   //
+   QHash<QString, std::optional<QVariant>> cachedValues;
+   std::mutex cachedValuesMutex;
+
+   //! \return The stored value for \c fqKey, if there is one, going to \c qSettings only if we haven't already
+   std::optional<QVariant> cachedValue(QString const & fqKey) {
+      std::lock_guard<std::mutex> lock(cachedValuesMutex);
+      auto cached = cachedValues.constFind(fqKey);
+      if (cached == cachedValues.cend()) {
+         std::optional<QVariant> stored = std::nullopt;
+         if (qSettings->contains(fqKey)) {
+            stored = qSettings->value(fqKey);
+         }
+         cached = cachedValues.insert(fqKey, stored);
+      }
+      return *cached;
+   }
+
 }
 
 void PersistentSettings::initialise(QString customUserDataDir) {
@@ -196,7 +223,7 @@ bool PersistentSettings::contains(QString const & key,
                                   QString const section,
                                   PersistentSettings::Extension extension) {
    Q_ASSERT(initialised);
-   return qSettings->contains(generateFqKey(key, section, extension));
+   return cachedValue(generateFqKey(key, section, extension)).has_value();
 }
 
 bool PersistentSettings::contains(BtStringConst const & constKey,
@@ -220,9 +247,20 @@ void PersistentSettings::insert(QString const & key,
                                 QString const section,
                                 PersistentSettings::Extension extension) {
    Q_ASSERT(initialised);
-   // QSettings is a bit inconsistent here in using setValue() when QMap, QHash etc use insert() for the equivalent
-   // functionality
-   qSettings->setValue(generateFqKey(key, section, extension), value);
+   QString const fqKey{generateFqKey(key, section, extension)};
+   {
+      std::lock_guard<std::mutex> lock(cachedValuesMutex);
+      auto cached = cachedValues.constFind(fqKey);
+      if (cached != cachedValues.cend() && *cached == value) {
+         // Nothing to do if the value isn't changing
+         return;
+      }
+      // QSettings is a bit inconsistent here in using setValue() when QMap, QHash etc use insert() for the equivalent
+      // functionality
+      qSettings->setValue(fqKey, value);
+      cachedValues.insert(fqKey, value);
+   }
+   emit PersistentSettings::ChangeNotifier::instance().changed(key, section, extension);
    return;
 }
 
@@ -251,7 +289,7 @@ QVariant PersistentSettings::value(QString const & key,
                                    QString const section,
                                    PersistentSettings::Extension extension) {
    Q_ASSERT(initialised);
-   return qSettings->value(generateFqKey(key, section, extension), defaultValue);
+   return cachedValue(generateFqKey(key, section, extension)).value_or(defaultValue);
 }
 
 QVariant PersistentSettings::value(BtStringConst const & constKey,
@@ -281,7 +319,14 @@ void PersistentSettings::remove(QString const & key,
    // Not entirely clear from Qt docs whether we need to bother checking contains() before calling remove(), but it
    // doesn't hurt any.
    if (PersistentSettings::contains(fqKey)) {
-      qSettings->remove(fqKey);
+      {
+         std::lock_guard<std::mutex> lock(cachedValuesMutex);
+         qSettings->remove(fqKey);
+         // If fqKey is a section, this will have removed all the settings in it, so it's simplest just to start again
+         // with the cache.
+         cachedValues.clear();
+      }
+      emit PersistentSettings::ChangeNotifier::instance().changed(key, section, extension);
    }
    return;
 }
@@ -303,3 +348,14 @@ void PersistentSettings::remove(BtStringConst const & constKey,
    PersistentSettings::remove(constKey, section, extension);
    return;
 }
+
+void PersistentSettings::sync() {
+   Q_ASSERT(initialised);
+   qSettings->sync();
+   return;
+}
+
+PersistentSettings::ChangeNotifier & PersistentSettings::ChangeNotifier::instance() {
+   static PersistentSettings::ChangeNotifier notifier;
+   return notifier;
+}
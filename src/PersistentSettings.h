@@ -30,6 +30,7 @@
 #pragma once
 
 #include <QDir>
+#include <QObject>
 #include <QString>
 #include <QVariant>
 
@@ -40,16 +41,23 @@
 //===== (Note that we only need to add here names that have no section or are used in multiple places in the code) =====
 //===== (Note too that property names are often used as setting names and, in such cases, are not redefined here) ======
 #define AddSettingName(name) namespace PersistentSettings::Names { BtStringConst const name{#name}; }
+AddSettingName(beerJsonExportSignatures)
 AddSettingName(check_version)
 AddSettingName(color_formula)
+AddSettingName(compressBinaryBeerJsonExports)
 AddSettingName(config_version)
 AddSettingName(converted)
 AddSettingName(count)                            // backups section
 AddSettingName(date_format)
+AddSettingName(dbChangeNotifications)
+AddSettingName(dbConnectTimeoutSeconds)
 AddSettingName(dbHostname)
+AddSettingName(dbMaintenanceIntervalDays)
 AddSettingName(dbName)
 AddSettingName(dbPassword)
 AddSettingName(dbPortnum)
+AddSettingName(dbReplicaHostname)
+AddSettingName(dbReplicaPortnum)
 AddSettingName(dbSchema)
 AddSettingName(dbType)
 AddSettingName(dbUsername)
@@ -64,18 +72,29 @@ AddSettingName(geometry)
 AddSettingName(ibu_formula)
 AddSettingName(language)
 AddSettingName(last_db_merge_req)
+AddSettingName(lastDbMaintenance)
+AddSettingName(lazyObjectLoading)
 AddSettingName(LogDirectory)
+AddSettingName(LoggingCategoryLevels)
 AddSettingName(LoggingLevel)
 AddSettingName(mashHopAdjustment)
 AddSettingName(mashStepTableWidget_headerState)  // MainWindow section
 AddSettingName(boilStepTableWidget_headerState)  // MainWindow section
 AddSettingName(fermentationStepTableWidget_headerState)  // MainWindow section
 AddSettingName(maximum)                          // backups section
+AddSettingName(pagedCatalogs)
+AddSettingName(performanceTracing)
 AddSettingName(productionDate)
 AddSettingName(recipeKey)
+AddSettingName(sensorUdpBindAddress)
+AddSettingName(sensorUdpPort)
 AddSettingName(showsnapshots)
+AddSettingName(skipValidatingOwnBeerJsonExports)
+AddSettingName(slowSqlThresholdMs)
 AddSettingName(splitter_horizontal_State)        // MainWindow section
 AddSettingName(splitter_vertical_State)          // MainWindow section
+AddSettingName(sqliteConnectionProfile)
+AddSettingName(startupSnapshot)
 AddSettingName(treeView_equip_headerState)       // MainWindow section
 AddSettingName(treeView_ferm_headerState)        // MainWindow section
 AddSettingName(treeView_hops_headerState)        // MainWindow section
@@ -83,9 +102,12 @@ AddSettingName(treeView_misc_headerState)        // MainWindow section
 AddSettingName(treeView_recipe_headerState)      // MainWindow section
 AddSettingName(treeView_style_headerState)       // MainWindow section
 AddSettingName(treeView_yeast_headerState)       // MainWindow section
+AddSettingName(undoLimit)
 AddSettingName(UserDataDirectory)
 AddSettingName(versioning)
 AddSettingName(windowState)
+AddSettingName(writeBehindFlushIntervalMs)
+AddSettingName(writeBehindPropertyUpdates)
 #undef AddSettingName
 //=========================================== End of setting NAME constants ============================================
 //╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
@@ -207,5 +229,36 @@ namespace PersistentSettings {
    void remove(BtStringConst const & constName, QString const section = QString(),  Extension extension = PersistentSettings::Extension::NONE);
    void remove(BtStringConst const & constName, BtStringConst const & constSection, Extension extension = PersistentSettings::Extension::NONE);
 
+   /**
+    * \brief Write any changed settings out to disk now.  Normally this happens some time after the change, or when the
+    *        program shuts down, so this is only needed if we are going to exit without the usual tidying up.
+    */
+   void sync();
+
+   /**
+    * \brief Emits a signal whenever a setting is changed via \c insert or \c remove, so that code which has cached
+    *        something derived from a setting knows to look at it again.
+    *
+    *        (Reading settings is cheap -- \c value keeps an in-memory copy of everything it has read or written, so
+    *        only the first read of each setting goes to \c QSettings -- but this is still a cleaner way to pick up
+    *        changes than re-reading a setting on every use.)
+    */
+   class ChangeNotifier : public QObject {
+      Q_OBJECT
+
+   public:
+      static ChangeNotifier & instance();
+
+   signals:
+      /**
+       * \brief Emitted after the setting with the supplied key, section and extension has been changed (or removed).
+       *        For \c remove of a whole section, \c key is the section name and \c section is null.
+       */
+      void changed(QString const & key, QString const & section, PersistentSettings::Extension extension);
+
+   private:
+      ChangeNotifier() = default;
+   };
+
 }
 #endif
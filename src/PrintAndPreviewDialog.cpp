@@ -26,6 +26,7 @@
 #include <QSizePolicy>
 #include <QStandardPaths>
 #include <QTextBrowser>
+#include <QTextDocument>
 
 #include "InventoryFormatter.h"
 
@@ -289,6 +290,11 @@ void PrintAndPreviewDialog::handlePrinting() {
    } else {
       // if we are not sending to printer we need to save a file.
       QString fileDialogFilter = (radioButton_OutputPDF->isChecked()) ? "PDF (*.pdf)" : "HTML (*.html)";
+      // The inventory can also be saved as CSV, eg for stock checks in a spreadsheet
+      bool const isInventory = (verticalTabWidget->currentIndex() == 1);
+      if (!radioButton_OutputPDF->isChecked() && isInventory) {
+         fileDialogFilter += ";;CSV (*.csv)";
+      }
       QString filename = QFileDialog::getSaveFileName(
          this,
          (radioButton_OutputPDF->isChecked()) ? "Save PDF" : "Save HTML",
@@ -311,7 +317,11 @@ void PrintAndPreviewDialog::handlePrinting() {
             return;
          }
          QTextStream ts(&file);
-         ts << htmlDocument->document()->toHtml();
+         if (isInventory && filename.endsWith(".csv", Qt::CaseInsensitive)) {
+            InventoryFormatter::writeInventoryCsv(ts, this->selectedInventoryFlags());
+         } else {
+            ts << htmlDocument->document()->toHtml();
+         }
          file.close();
       }
    }
@@ -320,6 +330,15 @@ void PrintAndPreviewDialog::handlePrinting() {
    return;
 }
 
+InventoryFormatter::HtmlGenerationFlags PrintAndPreviewDialog::selectedInventoryFlags() const {
+   InventoryFormatter::HtmlGenerationFlags flags;
+   if (checkBox_inventoryFermentables->isChecked()) { flags |= InventoryFormatter::HtmlGenerationFlag::FERMENTABLES ; }
+   if (checkBox_inventoryHops->isChecked()        ) { flags |= InventoryFormatter::HtmlGenerationFlag::HOPS         ; }
+   if (checkBox_inventoryYeast->isChecked()       ) { flags |= InventoryFormatter::HtmlGenerationFlag::YEAST        ; }
+   if (checkBox_inventoryMicellaneous->isChecked()) { flags |= InventoryFormatter::HtmlGenerationFlag::MISCELLANEOUS; }
+   return flags;
+}
+
 /**
  * @brief updates the current view with the changed data. depanding on selected output.
  *
@@ -341,22 +360,13 @@ void PrintAndPreviewDialog::updatePreview() {
             pDoc += brewDayFormatter->buildHtml();
          }
       } else if (verticalTabWidget->currentIndex() == 1) {
-///         InventoryFormatter::HtmlGenerationFlags flags  = static_cast<InventoryFormatter::HtmlGenerationFlag::HtmlGenerationFlags>(
-///            checkBox_inventoryFermentables->isChecked() * InventoryFormatter::HtmlGenerationFlag::FERMENTABLES   +
-///            checkBox_inventoryHops->isChecked()         * InventoryFormatter::HtmlGenerationFlag::HOPS           +
-///            checkBox_inventoryYeast->isChecked()        * InventoryFormatter::HtmlGenerationFlag::YEAST          +
-///            checkBox_inventoryMicellaneous->isChecked() * InventoryFormatter::HtmlGenerationFlag::MISCELLANEOUS
-///         );
-         InventoryFormatter::HtmlGenerationFlags flags;
-         if (checkBox_inventoryFermentables->isChecked()) { flags |= InventoryFormatter::HtmlGenerationFlag::FERMENTABLES ; }
-         if (checkBox_inventoryHops->isChecked()        ) { flags |= InventoryFormatter::HtmlGenerationFlag::HOPS         ; }
-         if (checkBox_inventoryYeast->isChecked()       ) { flags |= InventoryFormatter::HtmlGenerationFlag::YEAST        ; }
-         if (checkBox_inventoryMicellaneous->isChecked()) { flags |= InventoryFormatter::HtmlGenerationFlag::MISCELLANEOUS; }
-
-         pDoc = InventoryFormatter::createInventoryHtml(flags);
+         pDoc = InventoryFormatter::createInventoryHtml(this->selectedInventoryFlags());
       }
       // adding the generated HTML to the QTexBrowser.
-      htmlDocument->setHtml(pDoc);
+      if (pDoc != this->htmlDocumentSource) {
+         htmlDocument->setHtml(pDoc);
+         this->htmlDocumentSource = pDoc;
+      }
    }
 
    // choose what displaywidget that should be showing depending on users choice.
@@ -497,8 +507,6 @@ void PrintAndPreviewDialog::printDocument(QPrinter * printer) {
       return;
    }
    recipeFormatter->setRecipe(mainWindow->currentRecipe());
-   // Setting up a blank page for drawing.
-   QTextBrowser textBrowser;
    QString hDoc = "";
    // If we are watching the Recipe tab we should print recipe stuff.
    if (Ui_BtPrintAndPreview::verticalTabWidget->currentIndex() == 0) {
@@ -518,24 +526,19 @@ void PrintAndPreviewDialog::printDocument(QPrinter * printer) {
 
       hDoc += recipeFormatter->buildHtmlFooter();
    } else if (verticalTabWidget->currentIndex() == 1) {
-///      InventoryFormatter::HtmlGenerationFlags flags = static_cast<InventoryFormatter::HtmlGenerationFlags>(
-///         checkBox_inventoryFermentables->isChecked() * InventoryFormatter::FERMENTABLES   +
-///         checkBox_inventoryHops->isChecked()         * InventoryFormatter::HOPS           +
-///         checkBox_inventoryYeast->isChecked()        * InventoryFormatter::YEAST          +
-///         checkBox_inventoryMicellaneous->isChecked() * InventoryFormatter::MISCELLANEOUS
-///      );
-      InventoryFormatter::HtmlGenerationFlags flags;
-      if (checkBox_inventoryFermentables->isChecked()) { flags |= InventoryFormatter::HtmlGenerationFlag::FERMENTABLES ; }
-      if (checkBox_inventoryHops->isChecked()        ) { flags |= InventoryFormatter::HtmlGenerationFlag::HOPS         ; }
-      if (checkBox_inventoryYeast->isChecked()       ) { flags |= InventoryFormatter::HtmlGenerationFlag::YEAST        ; }
-      if (checkBox_inventoryMicellaneous->isChecked()) { flags |= InventoryFormatter::HtmlGenerationFlag::MISCELLANEOUS; }
-
-      hDoc += InventoryFormatter::createInventoryHtml(flags);
+      hDoc += InventoryFormatter::createInventoryHtml(this->selectedInventoryFlags());
    }
 
-   // Render the page onto the painter/printer for preview/printing.
-   textBrowser.setHtml(hDoc);
-   textBrowser.print(printer);
+   //
+   // Render the page onto the painter/printer for preview/printing.  The preview widget asks for this every time
+   // anything about the page changes (eg orientation or paper size), often when the HTML hasn't, so it's worth not
+   // re-parsing it.  We don't need a QTextBrowser (or any other widget) just to print a document.
+   //
+   if (hDoc != this->printedHtml) {
+      this->printedDocument.setHtml(hDoc);
+      this->printedHtml = hDoc;
+   }
+   this->printedDocument.print(printer);
 
    return;
 }
@@ -26,9 +26,11 @@
 #include <QPrintPreviewWidget>
 #include <QString>
 #include <QTextBrowser>
+#include <QTextDocument>
 #include <QWidget>
 
 #include "BrewDayFormatter.h"
+#include "InventoryFormatter.h"
 #include "MainWindow.h"
 #include "model/Recipe.h"
 #include "RecipeFormatter.h"
@@ -126,6 +128,11 @@ private:
     */
    void updatePreview();
 
+   /**
+    * @brief Which types of ingredient the user has ticked on the inventory tab
+    */
+   InventoryFormatter::HtmlGenerationFlags selectedInventoryFlags() const;
+
    QPrintPreviewWidget* previewWidget;
    RecipeFormatter* recipeFormatter;
    BrewDayFormatter* brewDayFormatter;
@@ -136,5 +143,12 @@ private:
    QTextBrowser *htmlDocument;
    QPageSize currentlySelectedPageSize;
 
+   //! What we last put in \c htmlDocument, so we don't make it re-parse and re-lay-out the same thing
+   QString htmlDocumentSource;
+
+   //! What we last printed in \c printDocument, and the same parsed, so we only need to parse it again if it changes
+   QString printedHtml;
+   QTextDocument printedDocument;
+
 };
 #endif
@@ -40,7 +40,10 @@ namespace std {
 #include <QPainter>
 #include <QPaintEvent>
 #include <QDebug>
+#include <QEvent>
 #include <QHash>
+#include <QPixmap>
+#include <QResizeEvent>
 
 // Internal constants
 namespace {
@@ -83,7 +86,7 @@ public:
    /**
     * Constructor
     */
-   impl() : variableNames{}, allSeries{} {
+   impl() : variableNames{}, allSeries{}, gridLayer{}, gridLayerMaxAxisValue{0.0} {
       return;
    }
 
@@ -149,6 +152,10 @@ public:
    // graph.  Used to size/scale the axes (aka radii aka spokes)
    double maxAxisValue;
 
+   //! The axes, axis labels and value circles, as last drawn by \c RadarChart::drawGrid
+   QPixmap gridLayer;
+   //! The value of \c maxAxisValue when \c gridLayer was drawn, since the circles depend on it
+   double  gridLayerMaxAxisValue;
 };
 
 RadarChart::RadarChart(QWidget * parent) : QWidget(parent),
@@ -176,6 +183,7 @@ void RadarChart::init(QString const unitsName,
    Q_ASSERT(variableNames.size() > 0);
 
    this->pimpl->angleInRadiansBetweenAxes = RadiansInACircle / variableNames.size();
+   this->pimpl->gridLayer = QPixmap{};
 
    qDebug() <<
       Q_FUNC_INFO << "axisMarkInterval:" << this->pimpl->axisMarkInterval << "; maxAxisValue:" <<
@@ -207,10 +215,78 @@ void RadarChart::paintEvent(QPaintEvent *event) {
    // sum.  This works for short labels.
    double axisLengthInPixels = std::min(this->width(), this->height()) / 3;
 
+   //
+   // The axes, their labels and the value circles only change when the chart is resized or rescaled, so we draw them
+   // once onto a pixmap and then just copy that for each repaint, drawing only the series on top.
+   //
+   qreal const devicePixelRatio = this->devicePixelRatioF();
+   if (this->pimpl->gridLayer.isNull() ||
+       this->pimpl->gridLayer.size() != this->size() * devicePixelRatio ||
+       this->pimpl->gridLayerMaxAxisValue != this->pimpl->maxAxisValue) {
+      this->pimpl->gridLayer = QPixmap{this->size() * devicePixelRatio};
+      this->pimpl->gridLayer.setDevicePixelRatio(devicePixelRatio);
+      this->pimpl->gridLayer.fill(Qt::transparent);
+      QPainter gridPainter{&this->pimpl->gridLayer};
+      gridPainter.setRenderHint(QPainter::Antialiasing);
+      gridPainter.translate(this->rect().center());
+      this->drawGrid(gridPainter, axisLengthInPixels);
+      this->pimpl->gridLayerMaxAxisValue = this->pimpl->maxAxisValue;
+   }
+
    QPainter painter(this);
+   painter.drawPixmap(0, 0, this->pimpl->gridLayer);
    painter.setRenderHint(QPainter::Antialiasing);
    painter.translate(this->rect().center());
 
+   //
+   //
+   // Now plot the actual data
+   //
+   QPen seriesPen{allSeriesPen};
+   for (auto currSeries : qAsConst(this->pimpl->allSeries)) {
+      seriesPen.setColor(currSeries.color);
+      painter.setPen(seriesPen);
+      QVector<QPointF> seriesPoints(this->pimpl->variableNames.size());
+      for (int ii = 0; ii < this->pimpl->variableNames.size(); ++ii) {
+         double angleInRadians = StartingAngleInRadians + ii * this->pimpl->angleInRadiansBetweenAxes;
+
+         seriesPoints[ii] = this->pimpl->polarToQtCartesian(
+            axisLengthInPixels * currSeries.object->property(*this->pimpl->variableNames[ii].propertyName).toDouble() / this->pimpl->maxAxisValue,
+            angleInRadians
+         );
+
+         if (ii > 0) {
+            painter.drawLine(seriesPoints[ii - 1], seriesPoints[ii]);
+         }
+
+         if (ii == this->pimpl->variableNames.size() - 1) {
+            painter.drawLine(seriesPoints[ii], seriesPoints[0]);
+         }
+      }
+   }
+
+   return;
+}
+
+void RadarChart::resizeEvent(QResizeEvent * event) {
+   this->pimpl->gridLayer = QPixmap{};
+   QWidget::resizeEvent(event);
+   return;
+}
+
+void RadarChart::changeEvent(QEvent * event) {
+   // The grid has to be redrawn if anything that affects how it looks changes
+   if (event->type() == QEvent::FontChange    ||
+       event->type() == QEvent::PaletteChange ||
+       event->type() == QEvent::StyleChange) {
+      this->pimpl->gridLayer = QPixmap{};
+      this->update();
+   }
+   QWidget::changeEvent(event);
+   return;
+}
+
+void RadarChart::drawGrid(QPainter & painter, double const axisLengthInPixels) const {
    //
    // Draw and label the axes lines
    //
@@ -294,33 +370,5 @@ void RadarChart::paintEvent(QPaintEvent *event) {
    }
 //   painter.drawText(0, axisLengthInPixels, this->pimpl->unitsName);
    painter.restore();
-
-   //
-   //
-   // Now plot the actual data
-   //
-   QPen seriesPen{allSeriesPen};
-   for (auto currSeries : qAsConst(this->pimpl->allSeries)) {
-      seriesPen.setColor(currSeries.color);
-      painter.setPen(seriesPen);
-      QVector<QPointF> seriesPoints(this->pimpl->variableNames.size());
-      for (int ii = 0; ii < this->pimpl->variableNames.size(); ++ii) {
-         double angleInRadians = StartingAngleInRadians + ii * this->pimpl->angleInRadiansBetweenAxes;
-
-         seriesPoints[ii] = this->pimpl->polarToQtCartesian(
-            axisLengthInPixels * currSeries.object->property(*this->pimpl->variableNames[ii].propertyName).toDouble() / this->pimpl->maxAxisValue,
-            angleInRadians
-         );
-
-         if (ii > 0) {
-            painter.drawLine(seriesPoints[ii - 1], seriesPoints[ii]);
-         }
-
-         if (ii == this->pimpl->variableNames.size() - 1) {
-            painter.drawLine(seriesPoints[ii], seriesPoints[0]);
-         }
-      }
-   }
-
    return;
 }
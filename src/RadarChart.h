@@ -25,6 +25,10 @@
 
 #include "utils/BtStringConst.h"
 
+class QEvent;
+class QPainter;
+class QResizeEvent;
+
 /**
  * @brief Plots radar charts (see https://en.wikipedia.org/wiki/Radar_chart) of the specified Qt properties of one or
  *        more QObject.  Each axis of the chart represents a different Qt property.
@@ -78,8 +82,16 @@ public:
 
 protected:
    void paintEvent(QPaintEvent *event);
+   //! Reimplemented from QWidget to discard the cached grid, which is drawn for a particular size
+   virtual void resizeEvent(QResizeEvent * event);
+   virtual void changeEvent(QEvent * event);
 
 private:
+   /**
+    * \brief Draw the axes, their labels and the value circles, with \c painter's origin at the centre of the chart
+    */
+   void drawGrid(QPainter & painter, double const axisLengthInPixels) const;
+
    // Private implementation details - see https://herbsutter.com/gotw/_100/
    class impl;
    std::unique_ptr<impl> pimpl;
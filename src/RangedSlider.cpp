@@ -17,9 +17,12 @@
  ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
 #include "RangedSlider.h"
 
+#include <cmath>
+
 #include <QApplication>
 #include <QColor>
 #include <QDebug>
+#include <QEvent>
 #include <QFont>
 #include <QFontMetrics>
 #include <QLabel>
@@ -30,6 +33,7 @@
 #include <QPaintEvent>
 #include <QPalette>
 #include <QRectF>
+#include <QResizeEvent>
 #include <QToolTip>
 
 RangedSlider::RangedSlider(QWidget* parent)
@@ -82,6 +86,7 @@ void RangedSlider::setPreferredRange( double min, double max )
 
    _tooltipText = QString("%1 - %2").arg(min, 0, 'f', _prec).arg(max, 0, 'f', _prec);
 
+   this->invalidateLayers();
    update();
 }
 
@@ -94,6 +99,7 @@ void RangedSlider::setRange( double min, double max )
 {
    _min = min;
    _max = max;
+   this->invalidateLayers();
    update();
 }
 
@@ -122,18 +128,21 @@ void RangedSlider::setPrecision(int precision)
 void RangedSlider::setBackgroundBrush( QBrush const& brush )
 {
    _bgBrush = brush;
+   this->invalidateLayers();
    update();
 }
 
 void RangedSlider::setPreferredRangeBrush( QBrush const& brush )
 {
    _prefRangeBrush = brush;
+   this->invalidateLayers();
    update();
 }
 
 void RangedSlider::setPreferredRangePen( QPen const& pen )
 {
    _prefRangePen = pen;
+   this->invalidateLayers();
    update();
 }
 
@@ -160,6 +169,7 @@ void RangedSlider::setTickMarks( double primaryInterval, int secondaryTicks )
    _secondaryTicks = (secondaryTicks<1)? 1 : secondaryTicks;
    _tickInterval = primaryInterval/_secondaryTicks;
 
+   this->invalidateLayers();
    update();
 }
 
@@ -209,7 +219,24 @@ void RangedSlider::recalculateHeightInPixels() const {
    //
    QFontMetrics indicatorTextFontMetrics(this->indicatorTextFont);
    QFontMetrics valueTextFontMetrics(this->valueTextFont);
-   this->heightInPixels = indicatorTextFontMetrics.lineSpacing() + valueTextFontMetrics.lineSpacing();
+   this->indicatorTextHeight = indicatorTextFontMetrics.lineSpacing();
+   this->valueTextHeight     = valueTextFontMetrics.lineSpacing();
+   this->heightInPixels = this->indicatorTextHeight + this->valueTextHeight;
+
+   // We need to allow for the width of the text that displays to the right of the slider showing the current value.
+   // If there were just one slider, we might ask Qt for the width of this text with one of the following calls:
+   //    const int valueTextWidth = valueTextFontMetrics.width(_valText);              // Pre Qt 5.13
+   //    const int valueTextWidth = valueTextFontMetrics.horizontalAdvance(_valText);  // Since Qt 5.13
+   // However, we want all the sliders to have exact same width, so we choose some representative text to measure the
+   // width of.  We assume that all sliders show no more than 4 digits and a decimal point, and then add a space to
+   // ensure a gap between the value text and the graphical area.  (Note that digits are all the same width in the font
+   // we are using.
+   this->valueTextWidth =
+#if QT_VERSION < QT_VERSION_CHECK(5,13,0)
+      valueTextFontMetrics.width(" 1.000");
+#else
+      valueTextFontMetrics.horizontalAdvance(" 1.000");
+#endif
    return;
 }
 
@@ -266,46 +293,15 @@ void RangedSlider::paintEvent([[maybe_unused]] QPaintEvent * event) {
    // The value text also shows this->_valText.
    //
 
-   QFontMetrics indicatorTextFontMetrics(this->indicatorTextFont);
-   int indicatorTextHeight = indicatorTextFontMetrics.lineSpacing();
-
    // The heights of the slider graphic and the value text are usually the same, but we calculate them differently in
-   // case, in future, we want to squeeze things up a bit.
-   QFontMetrics valueTextFontMetrics(this->valueTextFont);
-   int valueTextHeight = valueTextFontMetrics.lineSpacing();
+   // case, in future, we want to squeeze things up a bit.  (The font metrics we need are worked out in
+   // recalculateHeightInPixels().)
+   int graphicalAreaHeight = this->height() - this->indicatorTextHeight;
 
-   int graphicalAreaHeight = this->height() - indicatorTextHeight;
-
-   // Although the Qt calls take an x- and a y- radius, we want the radius on the rectangle corners to be the same
-   // vertically and horizontally, so only define one measure here.
-   int rectangleCornerRadius = graphicalAreaHeight / 4;
-
-   static const QPalette palette(QApplication::palette());
    static const int indicatorLineWidth   = 4;
-   static const QColor fgRectColor(0,127,0);
    static const QColor indicatorTextColor(0,0,0);
    static const QColor valueTextColor(0,127,0);
 
-   // We need to allow for the width of the text that displays to the right of the slider showing the current value.
-   // If there were just one slider, we might ask Qt for the width of this text with one of the following calls:
-   //    const int valueTextWidth = valueTextFontMetrics.width(_valText);              // Pre Qt 5.13
-   //    const int valueTextWidth = valueTextFontMetrics.horizontalAdvance(_valText);  // Since Qt 5.13
-   // However, we want all the sliders to have exact same width, so we choose some representative text to measure the
-   // width of.  We assume that all sliders show no more than 4 digits and a decimal point, and then add a space to
-   // ensure a gap between the value text and the graphical area.  (Note that digits are all the same width in the font
-   // we are using.
-   int valueTextWidth =
-#if QT_VERSION < QT_VERSION_CHECK(5,13,0)
-      valueTextFontMetrics.width(" 1.000");
-#else
-      valueTextFontMetrics.horizontalAdvance(" 1.000");
-#endif
-
-   QLinearGradient glassGrad( QPointF(0,0), QPointF(0,graphicalAreaHeight) );
-   glassGrad.setColorAt( 0, QColor(255,255,255,127) );
-   glassGrad.setColorAt( 1, QColor(255,255,255,0) );
-   QBrush glassBrush(glassGrad);
-
    // Per https://doc.qt.io/qt-5/highdpi.html, for best High DPI display support, we need to:
    //  • Always use the qreal versions of the QPainter drawing API
    //  • Size windows and dialogs in relation to the corresponding screen size
@@ -313,16 +309,12 @@ void RangedSlider::paintEvent([[maybe_unused]] QPaintEvent * event) {
    QPainter painter(this);
 
    // Work out the left-to-right (ie x-coordinate) positions of things in the graphical area
-   double graphicalAreaWidth  = this->width() - valueTextWidth;
+   double graphicalAreaWidth  = this->width() - this->valueTextWidth;
    double range               = this->_max - this->_min;
-   double fgRectLeft          = graphicalAreaWidth * ((this->_prefMin - this->_min    )/range);
-   double fgRectWidth         = graphicalAreaWidth * ((this->_prefMax - this->_prefMin)/range);
    double indicatorLineMiddle = graphicalAreaWidth * ((this->_val     - this->_min    )/range);
    double indicatorLineLeft   = indicatorLineMiddle - (indicatorLineWidth / 2);
 
    // Make sure all coordinates are valid.
-   fgRectLeft          = qBound(0.0, fgRectLeft,          graphicalAreaWidth);
-   fgRectWidth         = qBound(0.0, fgRectWidth,         graphicalAreaWidth - fgRectLeft);
    indicatorLineMiddle = qBound(0.0, indicatorLineMiddle, graphicalAreaWidth - (indicatorLineWidth / 2));
    indicatorLineLeft   = qBound(0.0, indicatorLineLeft,   graphicalAreaWidth - indicatorLineWidth);
 
@@ -353,69 +345,140 @@ void RangedSlider::paintEvent([[maybe_unused]] QPaintEvent * event) {
    // able to use some of the blank space above it (to the right of the indicator text).
    painter.setPen(valueTextColor);
    painter.setFont(this->valueTextFont);
-   painter.drawText(graphicalAreaWidth, this->height() - valueTextHeight,
-                    valueTextWidth, valueTextHeight,
+   painter.drawText(graphicalAreaWidth, this->height() - this->valueTextHeight,
+                    this->valueTextWidth, this->valueTextHeight,
                     Qt::AlignRight | Qt::AlignVCenter,
                     this->_valText );
 
+   //
+   // Everything in the graphical area apart from the indicator only changes when the ranges, brushes or size do, so we
+   // draw it onto pixmaps (one for below the indicator and one for above) and just copy those on each repaint.  This
+   // matters because a single recipe change repaints all the sliders on the main window.
+   //
+   QSizeF const graphicalAreaSize{graphicalAreaWidth, static_cast<double>(graphicalAreaHeight)};
+   if (this->backgroundLayer.isNull() ||
+       this->layersSize != graphicalAreaSize ||
+       this->backgroundLayer.devicePixelRatioF() != this->devicePixelRatioF()) {
+      this->redrawLayers(graphicalAreaSize);
+   }
+
    // All the rest of what we need to do is inside the graphical area, so move the origin to the top-left corner of it
    painter.translate(0, indicatorTextRect.height());
+   painter.drawPixmap(0, 0, this->backgroundLayer);
+
+   // Make sure the indicator stays inside the "glass rectangle".
+   painter.setClipPath(this->glassClipPath);
    painter.setPen(Qt::NoPen);
+   painter.setBrush(_markerBrush);
+   painter.drawRect( QRectF(indicatorLineLeft, 0, indicatorLineWidth, graphicalAreaHeight) );
+   painter.setClipping(false);
+
+   painter.drawPixmap(0, 0, this->overlayLayer);
+
+   return;
+}
+
+void RangedSlider::invalidateLayers() {
+   this->backgroundLayer = QPixmap{};
+   this->overlayLayer    = QPixmap{};
+   return;
+}
+
+void RangedSlider::redrawLayers(QSizeF const & graphicalAreaSize) {
+   //
+   // The graphical area has:
+   //  - a background rectangle of the full width of the area, representing the range from this->_min to this->_max
+   //  - a foreground rectangle showing the sub-range of this background from this->_prefMin to this->_prefMax
+   //  - (drawn in paintEvent) the indicator
+   //  - a white-to-clear gradient to suggest "glassy", and the tick marks
+   //
+   double const graphicalAreaWidth  = graphicalAreaSize.width();
+   double const graphicalAreaHeight = graphicalAreaSize.height();
+
+   // Although the Qt calls take an x- and a y- radius, we want the radius on the rectangle corners to be the same
+   // vertically and horizontally, so only define one measure here.
+   int rectangleCornerRadius = static_cast<int>(graphicalAreaHeight) / 4;
+
+   double range       = this->_max - this->_min;
+   double fgRectLeft  = graphicalAreaWidth * ((this->_prefMin - this->_min    )/range);
+   double fgRectWidth = graphicalAreaWidth * ((this->_prefMax - this->_prefMin)/range);
+   fgRectLeft  = qBound(0.0, fgRectLeft,  graphicalAreaWidth);
+   fgRectWidth = qBound(0.0, fgRectWidth, graphicalAreaWidth - fgRectLeft);
+
+   QLinearGradient glassGrad( QPointF(0,0), QPointF(0,graphicalAreaHeight) );
+   glassGrad.setColorAt( 0, QColor(255,255,255,127) );
+   glassGrad.setColorAt( 1, QColor(255,255,255,0) );
+   QBrush glassBrush(glassGrad);
 
    // Make sure anything we draw "inside" the "glass rectangle" stays inside.
-   QPainterPath clipRect;
-   clipRect.addRoundedRect( QRectF(0, 0, graphicalAreaWidth, graphicalAreaHeight),
-                            rectangleCornerRadius,
-                            rectangleCornerRadius );
-   painter.setClipPath(clipRect);
-
-   // Draw the background rectangle.
-   painter.setBrush(_bgBrush);
-   painter.setRenderHint(QPainter::Antialiasing);
-   painter.drawRoundedRect( QRectF(0, 0, graphicalAreaWidth, graphicalAreaHeight),
-                            rectangleCornerRadius,
-                            rectangleCornerRadius );
-   painter.setRenderHint(QPainter::Antialiasing, false);
-
-   // Draw the style "foreground" rectangle.
-   painter.save();
+   this->glassClipPath = QPainterPath{};
+   this->glassClipPath.addRoundedRect( QRectF(0, 0, graphicalAreaWidth, graphicalAreaHeight),
+                                       rectangleCornerRadius,
+                                       rectangleCornerRadius );
+
+   qreal const devicePixelRatio = this->devicePixelRatioF();
+   QSize const pixmapSize{static_cast<int>(std::ceil(graphicalAreaWidth  * devicePixelRatio)),
+                          static_cast<int>(std::ceil(graphicalAreaHeight * devicePixelRatio))};
+   this->layersSize = graphicalAreaSize;
+   for (QPixmap * layer : {&this->backgroundLayer, &this->overlayLayer}) {
+      *layer = QPixmap{pixmapSize};
+      layer->setDevicePixelRatio(devicePixelRatio);
+      layer->fill(Qt::transparent);
+   }
+
+   {
+      QPainter painter(&this->backgroundLayer);
+      painter.setPen(Qt::NoPen);
+      painter.setClipPath(this->glassClipPath);
+
+      // Draw the background rectangle.
+      painter.setBrush(_bgBrush);
+      painter.setRenderHint(QPainter::Antialiasing);
+      painter.drawRoundedRect( QRectF(0, 0, graphicalAreaWidth, graphicalAreaHeight),
+                               rectangleCornerRadius,
+                               rectangleCornerRadius );
+
+      // Draw the style "foreground" rectangle.
       painter.setBrush(_prefRangeBrush);
       painter.setPen(_prefRangePen);
-      painter.setRenderHint(QPainter::Antialiasing);
       painter.drawRoundedRect( QRectF(fgRectLeft, 0, fgRectWidth, graphicalAreaHeight),
                                rectangleCornerRadius,
                                rectangleCornerRadius );
-   painter.restore();
-
-   // Draw the indicator.
-   painter.setBrush(_markerBrush);
-   painter.drawRect( QRectF(indicatorLineLeft, 0, indicatorLineWidth, graphicalAreaHeight) );
+   }
 
-   // Draw a white-to-clear gradient to suggest "glassy."
-   painter.setBrush(glassBrush);
-   painter.setRenderHint(QPainter::Antialiasing);
-   painter.drawRoundedRect( QRectF(0, 0, graphicalAreaWidth, graphicalAreaHeight),
-                            rectangleCornerRadius,
-                            rectangleCornerRadius );
-   painter.setRenderHint(QPainter::Antialiasing, false);
-
-   // Draw the ticks.
-   painter.setPen(Qt::black);
-   if( _tickInterval > 0.0 )
    {
-      int secTick = 1;
-      for( double currentTick = _min+_tickInterval; _max - currentTick > _tickInterval-1e-6; currentTick += _tickInterval )
+      QPainter painter(&this->overlayLayer);
+      painter.setPen(Qt::NoPen);
+      painter.setClipPath(this->glassClipPath);
+
+      // Draw a white-to-clear gradient to suggest "glassy."
+      painter.setBrush(glassBrush);
+      painter.setRenderHint(QPainter::Antialiasing);
+      painter.drawRoundedRect( QRectF(0, 0, graphicalAreaWidth, graphicalAreaHeight),
+                               rectangleCornerRadius,
+                               rectangleCornerRadius );
+      painter.setRenderHint(QPainter::Antialiasing, false);
+
+      // Draw the ticks.
+      painter.setPen(Qt::black);
+      if( _tickInterval > 0.0 )
       {
-         painter.translate( graphicalAreaWidth/(_max-_min) * _tickInterval, 0);
-         if( secTick == _secondaryTicks )
-         {
-            painter.drawLine( QPointF(0,0.25*graphicalAreaHeight), QPointF(0,0.75*graphicalAreaHeight) );
-            secTick = 1;
-         }
-         else
+         int secTick = 1;
+         for( double currentTick = _min+_tickInterval;
+              _max - currentTick > _tickInterval-1e-6;
+              currentTick += _tickInterval )
          {
-            painter.drawLine( QPointF(0,0.333*graphicalAreaHeight), QPointF(0,0.666*graphicalAreaHeight) );
-            ++secTick;
+            painter.translate( graphicalAreaWidth/(_max-_min) * _tickInterval, 0);
+            if( secTick == _secondaryTicks )
+            {
+               painter.drawLine( QPointF(0,0.25*graphicalAreaHeight), QPointF(0,0.75*graphicalAreaHeight) );
+               secTick = 1;
+            }
+            else
+            {
+               painter.drawLine( QPointF(0,0.333*graphicalAreaHeight), QPointF(0,0.666*graphicalAreaHeight) );
+               ++secTick;
+            }
          }
       }
    }
@@ -423,6 +486,23 @@ void RangedSlider::paintEvent([[maybe_unused]] QPaintEvent * event) {
    return;
 }
 
+void RangedSlider::resizeEvent(QResizeEvent * event) {
+   this->invalidateLayers();
+   QWidget::resizeEvent(event);
+   return;
+}
+
+void RangedSlider::changeEvent(QEvent * event) {
+   // Anything that changes how the widget looks means the cached layers need redrawing
+   if (event->type() == QEvent::FontChange    ||
+       event->type() == QEvent::PaletteChange ||
+       event->type() == QEvent::StyleChange) {
+      this->invalidateLayers();
+      this->update();
+   }
+   QWidget::changeEvent(event);
+   return;
+}
 
 void RangedSlider::moveEvent(QMoveEvent *event) {
    // If we've moved, we might be on a new screen with a different DPI resolution...
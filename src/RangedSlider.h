@@ -23,9 +23,14 @@
 #include <QSize>
 #include <QString>
 #include <QBrush>
+#include <QPainterPath>
 #include <QPen>
+#include <QPixmap>
+#include <QSizeF>
+class QEvent;
 class QPaintEvent;
 class QMouseEvent;
+class QResizeEvent;
 
 /*!
  * \brief Widget to display a number with an optional range on a type of read-only slider.
@@ -106,6 +111,10 @@ protected:
    virtual void mouseMoveEvent(QMouseEvent* event);
    //! \brief Reimplemented from QWidget.
    virtual void moveEvent(QMoveEvent *event);
+   //! \brief Reimplemented from QWidget to discard the cached layers, which are drawn for a particular size.
+   virtual void resizeEvent(QResizeEvent * event);
+   //! \brief Reimplemented from QWidget to discard the cached layers if the style, palette or font change.
+   virtual void changeEvent(QEvent * event);
 
 private:
    /**
@@ -114,6 +123,14 @@ private:
    void setSizes();
    void recalculateHeightInPixels() const;
 
+   //! Discard \c backgroundLayer and \c overlayLayer so that they get redrawn on the next paint
+   void invalidateLayers();
+
+   /**
+    * Draw \c backgroundLayer and \c overlayLayer for a graphical area of the given size
+    */
+   void redrawLayers(QSizeF const & graphicalAreaSize);
+
    /**
     * Minimum value the widget displays
     */
@@ -163,6 +180,26 @@ private:
     * (ie OK to change in a const function).
     */
    mutable int heightInPixels;
+
+   /**
+    * Line spacing of \c indicatorTextFont and \c valueTextFont, and the width we allow for the value text, which are
+    * also worked out by \c recalculateHeightInPixels().
+    */
+   mutable int indicatorTextHeight;
+   mutable int valueTextHeight;
+   mutable int valueTextWidth;
+
+   /**
+    * The parts of the graphical area that don't depend on the value: the background and preferred range (drawn below
+    * the indicator), and the "glass" effect and tick marks (drawn above it).  These are redrawn only when the size,
+    * ranges or brushes change, rather than on every repaint.
+    */
+   QPixmap      backgroundLayer;
+   QPixmap      overlayLayer;
+   //! Size of the graphical area \c backgroundLayer and \c overlayLayer were drawn for
+   QSizeF       layersSize;
+   //! The rounded rectangle outline of the graphical area, which the indicator is clipped to
+   QPainterPath glassClipPath;
 };
 
 #endif
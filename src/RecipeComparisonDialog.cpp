@@ -0,0 +1,490 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * RecipeComparisonDialog.cpp is part of Brewtarget, and is copyright the following authors 2024:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#include "RecipeComparisonDialog.h"
+
+#include <optional>
+#include <utility>
+
+#include <QCoreApplication>
+#include <QEvent>
+#include <QHash>
+#include <QHeaderView>
+#include <QMetaObject>
+#include <QRunnable>
+#include <QSet>
+#include <QStringList>
+#include <QTableWidget>
+#include <QTableWidgetItem>
+#include <QThreadPool>
+#include <QTimer>
+#include <QVBoxLayout>
+#include <QVector>
+#include <QWidget>
+
+#include "database/ObjectStoreWrapper.h"
+#include "FermentationSimulator.h"
+#include "Logging.h"
+#include "measurement/Measurement.h"
+#include "measurement/Unit.h"
+#include "model/Fermentable.h"
+#include "model/Hop.h"
+#include "model/Recipe.h"
+#include "model/RecipeAdditionFermentable.h"
+#include "model/RecipeAdditionHop.h"
+#include "RecipeEvaluator.h"
+
+namespace {
+
+   //! A labelled value, eg the percentage of the grain bill that is one fermentable
+   using LabelledValues = QList<std::pair<QString, double>>;
+
+   /**
+    * \brief Add \c value to the entry for \c label, creating it if need be.  (A recipe can, eg, use the same hop at the
+    *        same time in two additions, and we want to show their total.)
+    */
+   void addTo(LabelledValues & values, QString const & label, double const value) {
+      for (auto & entry : values) {
+         if (entry.first == label) {
+            entry.second += value;
+            return;
+         }
+      }
+      values.append({label, value});
+      return;
+   }
+
+   //! Add to \c allLabels any labels from \c values that it doesn't already have
+   void mergeLabels(QStringList & allLabels, LabelledValues const & values) {
+      for (auto const & entry : values) {
+         if (!allLabels.contains(entry.first)) {
+            allLabels.append(entry.first);
+         }
+      }
+      return;
+   }
+
+   std::optional<double> valueFor(LabelledValues const & values, QString const & label) {
+      for (auto const & entry : values) {
+         if (entry.first == label) {
+            return entry.second;
+         }
+      }
+      return std::nullopt;
+   }
+
+   /**
+    * \brief Everything we show for one recipe.  The names and grain bill are filled in on the GUI thread when we take
+    *        the snapshot; the rest comes from evaluating it.
+    */
+   struct Column {
+      QString        recipeName;
+      //! Percentage, by weight, of each fermentable (measured by weight) in the recipe
+      LabelledValues grainBill_pct;
+      QStringList    hopAdditionLabels;
+      //! The gravities in here get replaced by the ones we calculate, before we simulate
+      FermentationSimulator::Inputs fermentation;
+      // From here on, these are set from the RecipeEvaluator::Results and FermentationSimulator::Results
+      double         og        = 0.0;
+      double         fg        = 0.0;
+      double         ABV_pct   = 0.0;
+      double         IBU       = 0.0;
+      double         color_srm = 0.0;
+      LabelledValues ibusByHopAddition;
+      double                predictedFg         = 0.0;
+      std::optional<double> timeToTerminal_days = std::nullopt;
+   };
+
+   /**
+    * \brief Take a snapshot of \c recipe, and fill in the parts of its \c Column that don't need any calculation.
+    *        Must be called on the GUI thread.
+    */
+   RecipeEvaluator::Snapshot snapshotOf(Recipe & recipe, Column & column) {
+      column.recipeName = recipe.name();
+
+      double totalWeight_kg = 0.0;
+      LabelledValues weights_kg;
+      for (auto const & fermentableAddition : recipe.fermentableAdditions()) {
+         auto const fermentable = fermentableAddition->fermentable();
+         if (fermentable && fermentableAddition->amountIsWeight()) {
+            double const quantity_kg = fermentableAddition->amount().quantity;
+            addTo(weights_kg, fermentable->name(), quantity_kg);
+            totalWeight_kg += quantity_kg;
+         }
+      }
+      for (auto const & [label, quantity_kg] : weights_kg) {
+         column.grainBill_pct.append({label, totalWeight_kg > 0.0 ? 100.0 * quantity_kg / totalWeight_kg : 0.0});
+      }
+
+      // RecipeEvaluator::snapshotOf takes every hop addition, in order, so these line up with ibusByHopAddition
+      for (auto const & hopAddition : recipe.hopAdditions()) {
+         auto const hop = hopAddition->hop();
+         QString const hopName = hop ? hop->name() : hopAddition->name();
+         QString const stage = RecipeAddition::stageDisplayNames[hopAddition->stage()];
+         std::optional<double> const addAtTime_mins = hopAddition->addAtTime_mins();
+         column.hopAdditionLabels.append(
+            addAtTime_mins ?
+               RecipeComparisonDialog::tr("%1 (%2, %3 min)").arg(hopName, stage).arg(*addAtTime_mins) :
+               RecipeComparisonDialog::tr("%1 (%2)").arg(hopName, stage)
+         );
+      }
+
+      column.fermentation = FermentationSimulator::inputsFor(recipe);
+
+      return RecipeEvaluator::snapshotOf(recipe);
+   }
+
+   //! Rows of the table before the grain bill
+   enum class FixedRow {
+      Og,
+      Fg,
+      PredictedFg,
+      TimeToTerminal,
+      Abv,
+      Ibu,
+      Color,
+   };
+   int constexpr numFixedRows = static_cast<int>(FixedRow::Color) + 1;
+}
+
+// This private implementation class holds all private non-virtual members of RecipeComparisonDialog
+class RecipeComparisonDialog::impl {
+
+public:
+
+   /**
+    * Constructor
+    *
+    * As with SimilarRecipesDialog, it's safe to pass in a reference to RecipeComparisonDialog from its constructor
+    * because there is nothing else in that class to initialise by the time this pimpl constructor is being called.
+    */
+   impl(RecipeComparisonDialog & self) :
+      m_self              {self},
+      m_table             {new QTableWidget{}},
+      m_layout            {new QVBoxLayout{&self}},
+      m_recalcTimer       {new QTimer{&self}},
+      m_recipeIds         {},
+      m_columns           {},
+      m_changedRecipeIds  {},
+      m_latestJob         {0},
+      m_latestJobForRecipe{},
+      m_connections       {} {
+      this->m_layout->addWidget(this->m_table.get());
+      this->m_table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+      this->m_table->horizontalHeader()->setSectionResizeMode(QHeaderView::ResizeToContents);
+      this->m_table->setMinimumSize(640, 480);
+
+      QObject::connect(this->m_table->horizontalHeader(), &QHeaderView::sectionDoubleClicked, &self,
+                       [this](int const column) {
+         if (column >= 0 && column < this->m_recipeIds.size()) {
+            Recipe * recipe = ObjectStoreWrapper::getByIdRaw<Recipe>(this->m_recipeIds.at(column));
+            if (recipe) {
+               emit this->m_self.recipeChosen(recipe);
+            }
+         }
+         return;
+      });
+
+      //
+      // A single edit can make a recipe emit lots of change signals (eg one for each calculated value that changes),
+      // so, rather than re-evaluate on each one, we note which recipes have changed and re-evaluate them all once
+      // control gets back to the event loop.
+      //
+      this->m_recalcTimer->setSingleShot(true);
+      this->m_recalcTimer->setInterval(0);
+      QObject::connect(this->m_recalcTimer, &QTimer::timeout, &self, [this]() { this->recalculate(); return; });
+
+      this->setText();
+      return;
+   }
+
+   ~impl() = default;
+
+   /**
+    * Set the (translatable) parts of the dialog
+    */
+   void setText() {
+      this->m_self.setWindowTitle(RecipeComparisonDialog::tr("Compare Recipes"));
+      this->refreshTable();
+      return;
+   }
+
+   void compare(QList<Recipe *> const & recipes) {
+      for (auto const & connection : this->m_connections) {
+         QObject::disconnect(connection);
+      }
+      this->m_connections.clear();
+      this->m_recipeIds.clear();
+      this->m_columns.clear();
+      this->m_changedRecipeIds.clear();
+      this->m_latestJobForRecipe.clear();
+
+      for (Recipe * recipe : recipes) {
+         int const recipeId = recipe->key();
+         if (this->m_recipeIds.contains(recipeId)) {
+            continue;
+         }
+         this->m_recipeIds.append(recipeId);
+         this->m_changedRecipeIds.insert(recipeId);
+         this->m_connections.append(
+            QObject::connect(recipe, &NamedEntity::propertyChanged, &this->m_self, [this, recipeId]() {
+               this->m_changedRecipeIds.insert(recipeId);
+               this->m_recalcTimer->start();
+               return;
+            })
+         );
+      }
+      qCDebug(Logging::recipe) << Q_FUNC_INFO << "Comparing recipes" << this->m_recipeIds;
+
+      this->refreshTable();
+      this->m_recalcTimer->start();
+      return;
+   }
+
+   /**
+    * \brief Snapshot all the recipes that have changed since we last did this, and evaluate them on the global thread
+    *        pool.  The results come back to \c showResults on the GUI thread.
+    */
+   void recalculate() {
+      unsigned int const thisJob = ++this->m_latestJob;
+
+      QVector<int>                       recipeIds;
+      QVector<Column>                    columns;
+      QVector<RecipeEvaluator::Snapshot> snapshots;
+      bool recipesDeleted = false;
+      for (int const recipeId : std::as_const(this->m_changedRecipeIds)) {
+         Recipe * recipe = ObjectStoreWrapper::getByIdRaw<Recipe>(recipeId);
+         if (!recipe) {
+            qCDebug(Logging::recipe) << Q_FUNC_INFO << "Recipe #" << recipeId << "no longer exists";
+            this->m_recipeIds.removeAll(recipeId);
+            this->m_columns.remove(recipeId);
+            recipesDeleted = true;
+            continue;
+         }
+         recipeIds.append(recipeId);
+         columns.append(Column{});
+         snapshots.append(snapshotOf(*recipe, columns.back()));
+         this->m_latestJobForRecipe.insert(recipeId, thisJob);
+      }
+      this->m_changedRecipeIds.clear();
+      if (recipesDeleted) {
+         this->refreshTable();
+      }
+      if (snapshots.isEmpty()) {
+         return;
+      }
+
+      QThreadPool::globalInstance()->start(QRunnable::create(
+         [this, thisJob, recipeIds, columns, snapshots, dialog = &this->m_self]() {
+            QVector<RecipeEvaluator::Results> const results = RecipeEvaluator::evaluateEach(snapshots);
+            // All the fermentations get simulated together, which is quicker than doing them one at a time
+            QVector<FermentationSimulator::Inputs> fermentations;
+            fermentations.reserve(columns.size());
+            for (int ii = 0; ii < columns.size(); ++ii) {
+               fermentations.append(columns.at(ii).fermentation);
+               fermentations.back().og_sg           = results.at(ii).gravities.og;
+               fermentations.back().attainableFg_sg = results.at(ii).gravities.fg;
+            }
+            QVector<FermentationSimulator::Results> const simulated = FermentationSimulator::simulate(fermentations);
+            // If the dialog is deleted before this gets run, Qt will just drop it
+            QMetaObject::invokeMethod(
+               dialog,
+               [this, thisJob, recipeIds, columns, results, simulated]() {
+                  this->showResults(thisJob, recipeIds, columns, results, simulated);
+                  return;
+               },
+               Qt::QueuedConnection
+            );
+            return;
+         }
+      ));
+      return;
+   }
+
+   void showResults(unsigned int const thisJob,
+                    QVector<int> const & recipeIds,
+                    QVector<Column> columns,
+                    QVector<RecipeEvaluator::Results> const & results,
+                    QVector<FermentationSimulator::Results> const & simulated) {
+      for (int ii = 0; ii < recipeIds.size(); ++ii) {
+         int const recipeId = recipeIds.at(ii);
+         // Skip anything we've stopped comparing, or that a later job will have more up-to-date results for
+         if (this->m_latestJobForRecipe.value(recipeId) != thisJob) {
+            continue;
+         }
+
+         Column & column = columns[ii];
+         RecipeEvaluator::Results const & result = results.at(ii);
+         column.og        = result.gravities.og;
+         column.fg        = result.gravities.fg;
+         column.ABV_pct   = result.ABV_pct;
+         column.IBU       = result.IBU;
+         column.color_srm = result.color_srm;
+         column.predictedFg         = simulated.at(ii).fg_sg;
+         column.timeToTerminal_days = simulated.at(ii).timeToTerminal_days;
+         for (int jj = 0; jj < column.hopAdditionLabels.size() && jj < result.ibusByHopAddition.size(); ++jj) {
+            addTo(column.ibusByHopAddition, column.hopAdditionLabels.at(jj), result.ibusByHopAddition.at(jj));
+         }
+         this->m_columns.insert(recipeId, std::move(column));
+      }
+      this->refreshTable();
+      return;
+   }
+
+   /**
+    * \brief Set the text of a cell, reusing the existing item if there is one
+    */
+   void setCell(int const row, int const column, QString const & text) {
+      QTableWidgetItem * item = this->m_table->item(row, column);
+      if (!item) {
+         item = new QTableWidgetItem{};
+         item->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+         this->m_table->setItem(row, column, item);
+      }
+      item->setText(text);
+      return;
+   }
+
+   /**
+    * \brief Lay out the table for the current set of recipes and show whatever results we have.  There are only ever
+    *        a handful of recipes, so it is simplest to redo the lot each time.
+    */
+   void refreshTable() {
+      QStringList fermentableLabels;
+      QStringList hopAdditionLabels;
+      QStringList recipeNames;
+      for (int const recipeId : std::as_const(this->m_recipeIds)) {
+         auto const column = this->m_columns.constFind(recipeId);
+         if (column == this->m_columns.cend()) {
+            Recipe const * recipe = ObjectStoreWrapper::getByIdRaw<Recipe>(recipeId);
+            recipeNames.append(recipe ? recipe->name() : QString{});
+            continue;
+         }
+         recipeNames.append(column->recipeName);
+         mergeLabels(fermentableLabels, column->grainBill_pct);
+         mergeLabels(hopAdditionLabels, column->ibusByHopAddition);
+      }
+
+      QStringList rowNames{
+         RecipeComparisonDialog::tr("OG"),
+         RecipeComparisonDialog::tr("FG"),
+         RecipeComparisonDialog::tr("FG at end of fermentation schedule"),
+         RecipeComparisonDialog::tr("Days to terminal gravity"),
+         RecipeComparisonDialog::tr("ABV"),
+         RecipeComparisonDialog::tr("IBU"),
+         RecipeComparisonDialog::tr("Color"),
+         RecipeComparisonDialog::tr("Grain bill (% by weight)"),
+      };
+      int const firstFermentableRow = rowNames.size();
+      rowNames.append(fermentableLabels);
+      rowNames.append(RecipeComparisonDialog::tr("IBUs by hop addition"));
+      int const firstHopAdditionRow = rowNames.size();
+      rowNames.append(hopAdditionLabels);
+
+      this->m_table->setRowCount(rowNames.size());
+      this->m_table->setColumnCount(recipeNames.size());
+      this->m_table->setVerticalHeaderLabels(rowNames);
+      this->m_table->setHorizontalHeaderLabels(recipeNames);
+
+      for (int col = 0; col < this->m_recipeIds.size(); ++col) {
+         auto const column = this->m_columns.constFind(this->m_recipeIds.at(col));
+         if (column == this->m_columns.cend()) {
+            // Not evaluated yet
+            for (int row = 0; row < rowNames.size(); ++row) {
+               this->setCell(row, col, QString{});
+            }
+            continue;
+         }
+
+         auto const row = [](FixedRow const fixedRow) { return static_cast<int>(fixedRow); };
+         this->setCell(row(FixedRow::Og), col,
+                       Measurement::displayAmount(Measurement::Amount{column->og, Measurement::Units::specificGravity},
+                                                  3));
+         this->setCell(row(FixedRow::Fg), col,
+                       Measurement::displayAmount(Measurement::Amount{column->fg, Measurement::Units::specificGravity},
+                                                  3));
+         this->setCell(row(FixedRow::PredictedFg), col,
+                       Measurement::displayAmount(Measurement::Amount{column->predictedFg,
+                                                                      Measurement::Units::specificGravity},
+                                                  3));
+         this->setCell(row(FixedRow::TimeToTerminal), col,
+                       column->timeToTerminal_days ? Measurement::displayQuantity(*column->timeToTerminal_days, 1) :
+                                                     RecipeComparisonDialog::tr("Not reached"));
+         this->setCell(row(FixedRow::Abv), col, QString("%1%").arg(Measurement::displayQuantity(column->ABV_pct, 1)));
+         this->setCell(row(FixedRow::Ibu), col, Measurement::displayQuantity(column->IBU, 1));
+         this->setCell(row(FixedRow::Color), col,
+                       Measurement::displayAmount(Measurement::Amount{column->color_srm, Measurement::Units::srm}, 0));
+         // The section heading rows are left blank
+         this->setCell(numFixedRows, col, QString{});
+         this->setCell(firstHopAdditionRow - 1, col, QString{});
+
+         for (int ii = 0; ii < fermentableLabels.size(); ++ii) {
+            std::optional<double> const percent = valueFor(column->grainBill_pct, fermentableLabels.at(ii));
+            this->setCell(firstFermentableRow + ii, col,
+                          percent ? QString("%1%").arg(Measurement::displayQuantity(*percent, 1)) : QString{});
+         }
+         for (int ii = 0; ii < hopAdditionLabels.size(); ++ii) {
+            std::optional<double> const ibus = valueFor(column->ibusByHopAddition, hopAdditionLabels.at(ii));
+            this->setCell(firstHopAdditionRow + ii, col, ibus ? Measurement::displayQuantity(*ibus, 1) : QString{});
+         }
+      }
+      return;
+   }
+
+   RecipeComparisonDialog &      m_self;
+   std::unique_ptr<QTableWidget> m_table;
+   std::unique_ptr<QVBoxLayout>  m_layout;
+   //! Owned by the dialog via Qt parenting
+   QTimer *                      m_recalcTimer;
+   //! The recipes we are comparing, in column order
+   QList<int>                    m_recipeIds;
+   //! The latest results for each recipe, once we have them
+   QHash<int, Column>            m_columns;
+   //! Recipes that have changed since we last took snapshots (or that we haven't evaluated yet)
+   QSet<int>                     m_changedRecipeIds;
+   //! Incremented each time we send snapshots off for evaluation
+   unsigned int                  m_latestJob;
+   //! The latest job each recipe was sent off in, so we can ignore results that have been overtaken by later ones
+   QHash<int, unsigned int>      m_latestJobForRecipe;
+   //! Our connections to the signals of the recipes we're comparing
+   QList<QMetaObject::Connection> m_connections;
+};
+
+
+RecipeComparisonDialog::RecipeComparisonDialog(QWidget * parent) : QDialog(parent),
+                                                                   pimpl{std::make_unique<impl>(*this)} {
+   this->setObjectName("recipeComparisonDialog");
+   return;
+}
+
+// See https://herbsutter.com/gotw/_100/ for why we need to explicitly define the destructor here (and not in the
+// header file)
+RecipeComparisonDialog::~RecipeComparisonDialog() = default;
+
+void RecipeComparisonDialog::compare(QList<Recipe *> const & recipes) {
+   this->pimpl->compare(recipes);
+   this->show();
+   this->raise();
+   return;
+}
+
+void RecipeComparisonDialog::changeEvent(QEvent * event) {
+   if (event->type() == QEvent::LanguageChange) {
+      this->pimpl->setText();
+   }
+   // Pass the event down to the base class
+   QDialog::changeEvent(event);
+   return;
+}
@@ -0,0 +1,61 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * RecipeComparisonDialog.h is part of Brewtarget, and is copyright the following authors 2024:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#ifndef RECIPECOMPARISONDIALOG_H
+#define RECIPECOMPARISONDIALOG_H
+#pragma once
+
+#include <memory> // For PImpl
+
+#include <QDialog>
+#include <QList>
+
+class QEvent;
+class QWidget;
+class Recipe;
+
+/*!
+ * \class RecipeComparisonDialog
+ *
+ * \brief Shows the main calculated values (OG, FG, ABV, IBU, color), the grain bill percentages and the IBUs of each
+ *        hop addition of several recipes side by side, one column per recipe.
+ *
+ *        The compared recipes are watched for changes, and any that change are re-evaluated from a fresh
+ *        \c RecipeEvaluator::Snapshot on the global thread pool, so that editing one of them (in the main window or
+ *        an editor) updates its column without it having to be the current recipe.
+ */
+class RecipeComparisonDialog : public QDialog {
+   Q_OBJECT
+
+public:
+   RecipeComparisonDialog(QWidget * parent = nullptr);
+   ~RecipeComparisonDialog();
+
+   //! \brief Start comparing \c recipes (instead of whatever we were comparing before) and show the dialog
+   void compare(QList<Recipe *> const & recipes);
+
+   virtual void changeEvent(QEvent * event);
+
+signals:
+   //! \brief Emitted when the user double-clicks the heading of one of the recipes
+   void recipeChosen(Recipe * recipe);
+
+private:
+   // Private implementation details - see https://herbsutter.com/gotw/_100/
+   class impl;
+   std::unique_ptr<impl> pimpl;
+};
+
+#endif
@@ -0,0 +1,384 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * RecipeDiff.cpp is part of Brewtarget, and is copyright the following authors 2024:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#include "RecipeDiff.h"
+
+#include <algorithm>
+
+#include <QDate>
+#include <QObject>
+
+#include "database/ObjectStoreTyped.h"
+#include "database/ObjectStoreWrapper.h"
+#include "Localization.h"
+#include "measurement/Amount.h"
+#include "measurement/Measurement.h"
+#include "measurement/Unit.h"
+#include "model/Boil.h"
+#include "model/BoilStep.h"
+#include "model/Equipment.h"
+#include "model/Fermentable.h"
+#include "model/Fermentation.h"
+#include "model/FermentationStep.h"
+#include "model/Hop.h"
+#include "model/Mash.h"
+#include "model/MashStep.h"
+#include "model/Misc.h"
+#include "model/Recipe.h"
+#include "model/RecipeAdditionFermentable.h"
+#include "model/RecipeAdditionHop.h"
+#include "model/RecipeAdditionMisc.h"
+#include "model/RecipeAdditionYeast.h"
+#include "model/RecipeAdjustmentSalt.h"
+#include "model/RecipeUseOfWater.h"
+#include "model/Salt.h"
+#include "model/Style.h"
+#include "model/Water.h"
+#include "model/Yeast.h"
+#include "utils/EnumStringMapping.h"
+#include "utils/FuzzyCompare.h"
+#include "utils/OptionalHelpers.h"
+#include "utils/TypeLookup.h"
+
+namespace {
+
+   struct ComparedField {
+      ObjectStore::TableField const * field;
+      TypeInfo                const * typeInfo;
+   };
+
+   /**
+    * \return The fields we compare for objects of type \c NE: the stored ones that are exposed to the user (ie have a
+    *         \c TypeInfo::fieldType), plus units (which don't, but which go with an amount that does).  This excludes
+    *         keys, foreign keys and flags such as \c NamedEntity::deleted.  Worked out on first use.
+    */
+   template<class NE>
+   QVector<ComparedField> const & comparedFields() {
+      static QVector<ComparedField> const fields = []() {
+         QVector<ComparedField> fields;
+         for (ObjectStore::TableField const & field : ObjectStoreTyped<NE>::getInstance().primaryTableFields()) {
+            if (field.propertyName.isNull()) {
+               continue;
+            }
+            TypeInfo const & typeInfo = NE::typeLookup.getType(field.propertyName);
+            if (typeInfo.fieldType || field.fieldType == ObjectStore::FieldType::Unit) {
+               fields.append(ComparedField{&field, &typeInfo});
+            }
+         }
+         return fields;
+      }();
+      return fields;
+   }
+
+   /**
+    * \brief Removes the \c std::optional wrapper, if any, from \c value, which is the value of \c field
+    *
+    * \return \c false if \c value was \c std::nullopt, \c true otherwise
+    */
+   bool unwrap(ObjectStore::TableField const & field, TypeInfo const & typeInfo, QVariant & value) {
+      if (!typeInfo.isOptional()) {
+         return true;
+      }
+      bool hasValue = false;
+      // Same mapping of field types to property types as ObjectStore uses
+      switch (field.fieldType) {
+         case ObjectStore::FieldType::Bool:   { Optional::removeOptionalWrapper<bool        >(value, &hasValue); break; }
+         case ObjectStore::FieldType::Int:    { Optional::removeOptionalWrapper<int         >(value, &hasValue); break; }
+         case ObjectStore::FieldType::UInt:   { Optional::removeOptionalWrapper<unsigned int>(value, &hasValue); break; }
+         case ObjectStore::FieldType::Double: { Optional::removeOptionalWrapper<double      >(value, &hasValue); break; }
+         case ObjectStore::FieldType::String: { Optional::removeOptionalWrapper<QString     >(value, &hasValue); break; }
+         case ObjectStore::FieldType::Date:   { Optional::removeOptionalWrapper<QDate       >(value, &hasValue); break; }
+         case ObjectStore::FieldType::Enum:   { Optional::removeOptionalWrapper<int         >(value, &hasValue); break; }
+         case ObjectStore::FieldType::Unit:   {
+            // Units are never optional, so it's a coding error if we get here
+            qCritical() << Q_FUNC_INFO << "Unexpected optional unit" << field.propertyName;
+            Q_ASSERT(false);
+            break;
+         }
+      }
+      return hasValue;
+   }
+
+   /**
+    * \brief Compares values of \c field in the same way as \c NamedEntity::isEqualTo implementations (via
+    *        \c Utils::AutoCompare) do, ie fuzzily for floating point numbers and ignoring trailing spaces in strings.
+    */
+   bool valuesEqual(ComparedField const & compared, QVariant lhs, QVariant rhs) {
+      bool const lhsHasValue = unwrap(*compared.field, *compared.typeInfo, lhs);
+      bool const rhsHasValue = unwrap(*compared.field, *compared.typeInfo, rhs);
+      if (!lhsHasValue || !rhsHasValue) {
+         return lhsHasValue == rhsHasValue;
+      }
+      switch (compared.field->fieldType) {
+         case ObjectStore::FieldType::Bool:   { return lhs.toBool() == rhs.toBool(); }
+         case ObjectStore::FieldType::Int:    { return lhs.toInt () == rhs.toInt (); }
+         case ObjectStore::FieldType::UInt:   { return lhs.toUInt() == rhs.toUInt(); }
+         case ObjectStore::FieldType::Double: { return Utils::FuzzyCompare(lhs.toDouble(), rhs.toDouble()); }
+         case ObjectStore::FieldType::String: { return lhs.toString().trimmed() == rhs.toString().trimmed(); }
+         case ObjectStore::FieldType::Date:   { return lhs.toDate() == rhs.toDate(); }
+         case ObjectStore::FieldType::Enum:   { return lhs.toInt () == rhs.toInt (); }
+         case ObjectStore::FieldType::Unit:   {
+            return lhs.value<Measurement::Unit const *>() == rhs.value<Measurement::Unit const *>();
+         }
+      }
+      // It's a coding error if we get here
+      Q_ASSERT(false);
+      return false;
+   }
+
+   QString displayValue(RecipeDiff::FieldChange const & fieldChange, QVariant value) {
+      if (!unwrap(*fieldChange.field, *fieldChange.typeInfo, value)) {
+         return QObject::tr("(not set)");
+      }
+      switch (fieldChange.field->fieldType) {
+         case ObjectStore::FieldType::Bool:   { return value.toBool() ? QObject::tr("Yes") : QObject::tr("No"); }
+         case ObjectStore::FieldType::Int:    { return QString::number(value.toInt ()); }
+         case ObjectStore::FieldType::UInt:   { return QString::number(value.toUInt()); }
+         case ObjectStore::FieldType::String: { return value.toString(); }
+         case ObjectStore::FieldType::Date:   { return Localization::displayDateUserFormated(value.toDate()); }
+         case ObjectStore::FieldType::Double: {
+            // Where we know what the quantity measures, it is in canonical units
+            if (fieldChange.typeInfo->fieldType &&
+                std::holds_alternative<Measurement::PhysicalQuantity>(*fieldChange.typeInfo->fieldType)) {
+               auto const physicalQuantity = std::get<Measurement::PhysicalQuantity>(*fieldChange.typeInfo->fieldType);
+               return Measurement::displayAmount(
+                  Measurement::Amount{value.toDouble(), Measurement::Unit::getCanonicalUnit(physicalQuantity)}
+               );
+            }
+            return Measurement::displayQuantity(value.toDouble(), 3);
+         }
+         case ObjectStore::FieldType::Enum:   {
+            auto const enumMapping = std::get<EnumStringMapping const *>(fieldChange.field->valueDecoder);
+            return enumMapping->enumAsIntToString(value.toInt()).value_or(QString::number(value.toInt()));
+         }
+         case ObjectStore::FieldType::Unit:   {
+            Measurement::Unit const * unit = value.value<Measurement::Unit const *>();
+            return unit ? unit->name : QString{};
+         }
+      }
+      // It's a coding error if we get here
+      Q_ASSERT(false);
+      return QString{};
+   }
+
+   template<class NE>
+   QVector<RecipeDiff::FieldChange> changedFields(NE const & before, NE const & after) {
+      QVector<RecipeDiff::FieldChange> fieldChanges;
+      for (ComparedField const & compared : comparedFields<NE>()) {
+         QVariant beforeValue = before.property(*compared.field->propertyName);
+         QVariant afterValue  = after .property(*compared.field->propertyName);
+         if (!valuesEqual(compared, beforeValue, afterValue)) {
+            fieldChanges.append(
+               RecipeDiff::FieldChange{compared.field, compared.typeInfo, std::move(beforeValue), std::move(afterValue)}
+            );
+         }
+      }
+      return fieldChanges;
+   }
+
+   /**
+    * \brief Add to \c changes how \c after differs from \c before, where these are two versions of the same thing.
+    */
+   template<class NE>
+   void diffObjects(NE const & before, NE const & after, QVector<RecipeDiff::Change> & changes) {
+      // Same object, or objects that are equal in all the fields we would compare (and probably a few more)
+      if (&before == &after || before == after) {
+         return;
+      }
+      QVector<RecipeDiff::FieldChange> fieldChanges = changedFields(before, after);
+      if (!fieldChanges.isEmpty()) {
+         changes.append(RecipeDiff::Change{RecipeDiff::ChangeType::Modified,
+                                           NE::localisedName(),
+                                           after.name(),
+                                           std::move(fieldChanges)});
+      }
+      return;
+   }
+
+   template<class NE>
+   void addedOrRemoved(RecipeDiff::ChangeType const type, NE const & ne, QVector<RecipeDiff::Change> & changes) {
+      changes.append(RecipeDiff::Change{type, NE::localisedName(), ne.name(), {}});
+      return;
+   }
+
+   /**
+    * \brief For something, such as a \c Mash, that a recipe has at most one of
+    */
+   template<class NE>
+   void diffOptional(std::shared_ptr<NE> const & before,
+                     std::shared_ptr<NE> const & after,
+                     QVector<RecipeDiff::Change> & changes) {
+      if (before && after) {
+         diffObjects(*before, *after, changes);
+      } else if (before) {
+         addedOrRemoved(RecipeDiff::ChangeType::Removed, *before, changes);
+      } else if (after) {
+         addedOrRemoved(RecipeDiff::ChangeType::Added, *after, changes);
+      }
+      return;
+   }
+
+   /**
+    * \brief Steps are matched by position.  We only look at them when both versions of the recipe have a step owner
+    *        (eg a \c Mash), as otherwise the change to the owner itself says all there is to say.
+    */
+   template<class Owner>
+   void diffSteps(std::shared_ptr<Owner> const & before,
+                  std::shared_ptr<Owner> const & after,
+                  QVector<RecipeDiff::Change> & changes) {
+      if (!before || !after || before == after) {
+         return;
+      }
+      auto const beforeSteps = before->steps();
+      auto const afterSteps  = after ->steps();
+      for (int ii = 0; ii < std::max(beforeSteps.size(), afterSteps.size()); ++ii) {
+         if (ii >= afterSteps.size()) {
+            addedOrRemoved(RecipeDiff::ChangeType::Removed, *beforeSteps.at(ii), changes);
+         } else if (ii >= beforeSteps.size()) {
+            addedOrRemoved(RecipeDiff::ChangeType::Added, *afterSteps.at(ii), changes);
+         } else {
+            diffObjects(*beforeSteps.at(ii), *afterSteps.at(ii), changes);
+         }
+      }
+      return;
+   }
+
+   /**
+    * \return \c true if the two additions are of the same ingredient (or of identical copies of it)
+    */
+   template<class RA>
+   bool sameIngredient(RA const & lhs, RA const & rhs) {
+      if (lhs.ingredientId() == rhs.ingredientId()) {
+         return true;
+      }
+      using Ingr = typename RA::IngredientClass;
+      Ingr const * lhsIngredient = ObjectStoreWrapper::getByIdRaw<Ingr>(lhs.ingredientId());
+      Ingr const * rhsIngredient = ObjectStoreWrapper::getByIdRaw<Ingr>(rhs.ingredientId());
+      return lhsIngredient && rhsIngredient && *lhsIngredient == *rhsIngredient;
+   }
+
+   template<class RA>
+   void diffAdditions(QList<std::shared_ptr<RA>> before,
+                      QList<std::shared_ptr<RA>> after,
+                      QVector<RecipeDiff::Change> & changes) {
+      //
+      // First take out the additions that are unchanged, so that, eg, if a recipe has two additions of the same hop and
+      // only one of them changed, we pair up the right ones.
+      //
+      for (auto afterIter = after.begin(); afterIter != after.end(); ) {
+         auto const match = std::find_if(before.begin(), before.end(), [&afterIter](std::shared_ptr<RA> const & ra) {
+            return ra == *afterIter || (sameIngredient(*ra, **afterIter) && *ra == **afterIter);
+         });
+         if (match != before.end()) {
+            before.erase(match);
+            afterIter = after.erase(afterIter);
+         } else {
+            ++afterIter;
+         }
+      }
+
+      // What's left has either changed, or been added or removed
+      for (std::shared_ptr<RA> const & afterAddition : after) {
+         auto const match = std::find_if(
+            before.begin(), before.end(), [&afterAddition](std::shared_ptr<RA> const & ra) {
+               return sameIngredient(*ra, *afterAddition);
+            }
+         );
+         if (match != before.end()) {
+            diffObjects(**match, *afterAddition, changes);
+            before.erase(match);
+         } else {
+            addedOrRemoved(RecipeDiff::ChangeType::Added, *afterAddition, changes);
+         }
+      }
+      for (std::shared_ptr<RA> const & beforeAddition : before) {
+         addedOrRemoved(RecipeDiff::ChangeType::Removed, *beforeAddition, changes);
+      }
+      return;
+   }
+
+}
+
+QVector<RecipeDiff::Change> RecipeDiff::diff(Recipe const & before, Recipe const & after) {
+   QVector<Change> changes;
+   if (&before == &after) {
+      return changes;
+   }
+
+   //
+   // Recipe::isEqualTo compares everything the recipe contains, so, for the recipe itself, we go straight to comparing
+   // fields, rather than call diffObjects.
+   //
+   QVector<FieldChange> fieldChanges = changedFields(before, after);
+   if (!fieldChanges.isEmpty()) {
+      changes.append(Change{ChangeType::Modified, Recipe::localisedName(), after.name(), std::move(fieldChanges)});
+   }
+
+   diffOptional(before.style       (), after.style       (), changes);
+   diffOptional(before.equipment   (), after.equipment   (), changes);
+   diffOptional(before.mash        (), after.mash        (), changes);
+   diffSteps   (before.mash        (), after.mash        (), changes);
+   diffOptional(before.boil        (), after.boil        (), changes);
+   diffSteps   (before.boil        (), after.boil        (), changes);
+   diffOptional(before.fermentation(), after.fermentation(), changes);
+   diffSteps   (before.fermentation(), after.fermentation(), changes);
+
+   diffAdditions(before.fermentableAdditions(), after.fermentableAdditions(), changes);
+   diffAdditions(before.hopAdditions        (), after.hopAdditions        (), changes);
+   diffAdditions(before.miscAdditions       (), after.miscAdditions       (), changes);
+   diffAdditions(before.yeastAdditions      (), after.yeastAdditions      (), changes);
+   diffAdditions(before.saltAdjustments     (), after.saltAdjustments     (), changes);
+   diffAdditions(before.waterUses           (), after.waterUses           (), changes);
+
+   return changes;
+}
+
+QString RecipeDiff::toHtml(QVector<Change> const & changes) {
+   if (changes.isEmpty()) {
+      return QString("<p>%1</p>").arg(QObject::tr("No changes"));
+   }
+
+   QString html;
+   for (Change const & change : changes) {
+      QString description;
+      switch (change.type) {
+         case ChangeType::Added   : { description = QObject::tr("%1 added"  ); break; }
+         case ChangeType::Removed : { description = QObject::tr("%1 removed"); break; }
+         case ChangeType::Modified: { description = QObject::tr("%1 changed"); break; }
+      }
+      html += QString("<p><b>%1</b></p>")
+                 .arg(description.arg(QString("%1 \"%2\"").arg(change.objectType, change.name)).toHtmlEscaped());
+      if (change.fieldChanges.isEmpty()) {
+         continue;
+      }
+      html += QString("<table>"
+                      "<tr>"
+                      "<th align=\"left\">%1</th>"
+                      "<th align=\"left\">%2</th>"
+                      "<th align=\"left\">%3</th>"
+                      "</tr>")
+                 .arg(QObject::tr("Field"))
+                 .arg(QObject::tr("Before"))
+                 .arg(QObject::tr("After"));
+      for (FieldChange const & fieldChange : change.fieldChanges) {
+         html += QString("<tr><td>%1</td><td>%2</td><td>%3</td></tr>")
+                    .arg(QString(*fieldChange.field->propertyName).toHtmlEscaped())
+                    .arg(displayValue(fieldChange, fieldChange.before).toHtmlEscaped())
+                    .arg(displayValue(fieldChange, fieldChange.after ).toHtmlEscaped());
+      }
+      html += "</table>";
+   }
+   return html;
+}
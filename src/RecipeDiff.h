@@ -0,0 +1,85 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * RecipeDiff.h is part of Brewtarget, and is copyright the following authors 2024:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#ifndef RECIPEDIFF_H
+#define RECIPEDIFF_H
+#pragma once
+
+#include <QString>
+#include <QVariant>
+#include <QVector>
+
+#include "database/ObjectStore.h"
+
+class Recipe;
+struct TypeInfo;
+
+/**
+ * \brief Works out what changed between two versions of a recipe (typically a recipe and one of its ancestors -- see
+ *        \c Recipe::ancestors), down to the level of individual stored fields of the recipe, its style, equipment,
+ *        mash, boil and fermentation (and their steps), and its additions.
+ *
+ *        The fields compared for each type of object are its stored properties (from the primary table definition of
+ *        its \c ObjectStore) that \c TypeLookup says are exposed to the user, so there is nothing to keep in step
+ *        when properties are added to the model classes.  Objects that \c operator== says are equal (which, thanks
+ *        to cached fingerprints, is usually a cheap check) are not compared field by field, so diffing two versions
+ *        that share most of their content is quick.
+ *
+ *        Additions are paired up between the versions by ingredient: the same ingredient ID, or otherwise an identical
+ *        ingredient (as an older version may use an identical copy of the ingredient).  Steps are paired up by
+ *        position.
+ */
+namespace RecipeDiff {
+
+   //! One stored field whose value differs between the two versions of an object
+   struct FieldChange {
+      ObjectStore::TableField const * field;
+      TypeInfo                const * typeInfo;
+      //! Values as returned by the Qt property, so \c after could be applied to \c before with \c setProperty
+      QVariant before;
+      QVariant after;
+   };
+
+   enum class ChangeType {
+      Added,
+      Removed,
+      Modified,
+   };
+
+   struct Change {
+      ChangeType type;
+      //! Localised description of the type of object that changed, eg "Hop addition" or "Mash step"
+      QString    objectType;
+      //! Name of the object (in the later version, where it exists there)
+      QString    name;
+      //! Only for \c ChangeType::Modified
+      QVector<FieldChange> fieldChanges;
+   };
+
+   /**
+    * \return What changed from \c before to \c after, with changes to the recipe itself first, then changes to the
+    *         objects it uses and its additions.  Empty if the two are the same, including if they are the same object.
+    */
+   QVector<Change> diff(Recipe const & before, Recipe const & after);
+
+   /**
+    * \return \c changes as an HTML fragment (ie without header and footer), with values shown in the user's preferred
+    *         units
+    */
+   QString toHtml(QVector<Change> const & changes);
+
+}
+
+#endif
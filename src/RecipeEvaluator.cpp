@@ -0,0 +1,987 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * RecipeEvaluator.cpp is part of Brewtarget, and is copyright the following authors 2024:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#include "RecipeEvaluator.h"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QRunnable>
+#include <QSemaphore>
+#include <QThread>
+#include <QThreadPool>
+
+#include "Algorithms.h"
+#include "database/ObjectStoreTyped.h"
+#include "database/RecipeCalculationCache.h"
+#include "Logging.h"
+#include "measurement/ColorMethods.h"
+#include "measurement/IbuMethods.h"
+#include "measurement/Unit.h"
+#include "model/Boil.h"
+#include "model/Equipment.h"
+#include "model/Mash.h"
+#include "model/RecipeAdditionFermentable.h"
+#include "model/RecipeAdditionHop.h"
+#include "model/RecipeAdditionYeast.h"
+#include "model/Yeast.h"
+#include "PhysicalConstants.h"
+#include "utils/Diagnostics.h"
+#include "utils/Fingerprint.h"
+
+namespace {
+
+   // Conversion factor for lb/gal to kg/l
+   double constexpr lbPerGalToKgPerL = 8.34538;
+
+   bool isFermentableSugar(Fermentable const & fermentable) {
+      // TODO: This probably doesn't work in languages other than English!
+      if (fermentable.type() == Fermentable::Type::Sugar && fermentable.name() == "Milk Sugar (Lactose)") {
+         return false;
+      }
+
+      return true;
+   }
+
+   /**
+    * \brief Equivalent of \c Equipment::wortEndOfBoil_l
+    */
+   double wortEndOfBoil_l(RecipeEvaluator::EquipmentInputs const & equipment, double const kettleWort_l) {
+      return kettleWort_l -
+             (equipment.boilTime_min.value_or(Equipment::default_boilTime_mins) / 60.0) *
+             equipment.kettleEvaporationPerHour_l.value_or(Equipment::default_kettleEvaporationPerHour_l);
+   }
+
+   /**
+    * \brief Call \c evaluateOne(ii) for every \c ii in [0, count), spreading the calls across all available cores,
+    *        and return once they have all been done.
+    *
+    *        We split the work into one interleaved chunk per core.  The calling thread does one of the chunks itself,
+    *        and then waits for the thread pool to finish the rest.  (Doing one chunk ourselves means we still make
+    *        progress if the pool is busy, and saves a pointless thread hand-off in the case where there is only one
+    *        chunk.)
+    */
+   template<typename Functor> int inParallel(int const count, Functor const & evaluateOne) {
+      int const numChunks = std::clamp(QThread::idealThreadCount(), 1, std::max(count, 1));
+      auto evaluateChunk = [&evaluateOne, count, numChunks](int const chunk) {
+         for (int ii = chunk; ii < count; ii += numChunks) {
+            evaluateOne(ii);
+         }
+         return;
+      };
+
+      QSemaphore chunksDone;
+      for (int chunk = 1; chunk < numChunks; ++chunk) {
+         QThreadPool::globalInstance()->start(
+            QRunnable::create([&evaluateChunk, &chunksDone, chunk]() {
+               evaluateChunk(chunk);
+               chunksDone.release();
+               return;
+            })
+         );
+      }
+      evaluateChunk(0);
+      chunksDone.acquire(numChunks - 1);
+      return numChunks;
+   }
+
+   //! Each call to \c RecipeEvaluator::recalculateAllRecipes gets a new number, so that we can ignore stale results
+   std::atomic<unsigned int> latestRecalculationJob{0};
+
+   double boilSizeInLitersOr(RecipeEvaluator::Snapshot const & snapshot, double const defaultValue) {
+      if (!snapshot.boil) {
+         return defaultValue;
+      }
+      return snapshot.boil->preBoilSize_l.value_or(defaultValue);
+   }
+
+   /**
+    * \brief What goes into the IBU calculation for a single hop addition: the parameters for the IBU formula, and
+    *        what to do with its result
+    */
+   struct HopAdditionIbuCalculation {
+      //! \c false if the addition does not contribute any IBUs (eg a mash hop when mash hops are ignored)
+      bool                            contributes;
+      IbuMethods::IbuCalculationParms parms;
+      //! Multiplier for first wort and mash hops
+      double                          adjustment;
+      //! Multiplier for the equipment's hop utilization and the hop's form
+      double                          hopUtilization;
+
+      //! \return IBUs of the addition, given what the IBU formula gave for \c parms
+      double ibus(double const formulaIbus) const {
+         return this->contributes ? this->adjustment * formulaIbus * this->hopUtilization : 0.0;
+      }
+   };
+
+   HopAdditionIbuCalculation ibuCalculation(RecipeEvaluator::HopAdditionInputs const & hopAddition,
+                                            std::optional<RecipeEvaluator::EquipmentInputs> const & equipment,
+                                            std::optional<RecipeEvaluator::BoilInputs> const & boil,
+                                            double const og,
+                                            double const finalVolumeNoLosses_l) {
+      double const AArating = hopAddition.alpha_pct / 100.0;
+      double const grams = hopAddition.quantity * 1000.0;
+      double const minutes = hopAddition.addAtTime_mins.value_or(0.0);
+      // Assume 100% utilization until further notice
+      double hopUtilization = 1.0;
+      // Assume 60 min boil until further notice
+      double boilTime_mins = 60.0;
+
+      // NOTE: we used to carefully calculate the average boil gravity and use it in the
+      // IBU calculations. However, due to John Palmer
+      // (http://homebrew.stackexchange.com/questions/7343/does-wort-gravity-affect-hopAddition-utilization),
+      // it seems more appropriate to just use the OG directly, since it is the total
+      // amount of break material that truly affects the IBUs.
+
+      if (equipment) {
+         hopUtilization = equipment->hopUtilization_pct.value_or(Equipment::default_hopUtilization_pct) / 100.0;
+         boilTime_mins = static_cast<int>(equipment->boilTime_min.value_or(Equipment::default_boilTime_mins));
+      }
+
+      if (boil) {
+         boilTime_mins = boil->boilTime_mins;
+      }
+
+      // Adjust for hopAddition form. Tinseth's table was created from whole cone data,
+      // and it seems other formulae are optimized that way as well. So, the
+      // utilization is considered unadjusted for whole cones, and adjusted
+      // up for plugs and pellets.
+      //
+      // - http://www.realbeer.com/hops/FAQ.html
+      // - https://groups.google.com/forum/#!topic"brewtarget.h"lp/mv2qvWBC4sU
+      if (hopAddition.form) {
+         switch (*hopAddition.form) {
+            case Hop::Form::Plug:
+               hopUtilization *= 1.02;
+               break;
+            case Hop::Form::Pellet:
+               hopUtilization *= 1.10;
+               break;
+            default:
+               break;
+         }
+      }
+
+      IbuMethods::IbuCalculationParms parms = {
+         .AArating              = AArating,
+         .hops_grams            = grams,
+         .postBoilVolume_liters = finalVolumeNoLosses_l,
+         .wortGravity_sg        = og,
+         .boilTime_minutes      = boilTime_mins,  // Seems unlikely in reality that there would be fractions of a minute
+         .coolTime_minutes          = boil      ? boil->coolTime_mins                  : std::nullopt,
+         .kettleInternalDiameter_cm = equipment ? equipment->kettleInternalDiameter_cm : std::nullopt,
+         .kettleOpeningDiameter_cm  = equipment ? equipment->kettleOpeningDiameter_cm  : std::nullopt,
+      };
+
+      HopAdditionIbuCalculation calculation{
+         .contributes    = false,
+         .parms          = parms,
+         .adjustment     = 1.0,
+         .hopUtilization = hopUtilization,
+      };
+      if (hopAddition.isFirstWort) {
+         calculation.contributes = true;
+         calculation.adjustment  = IbuMethods::firstWortHopAdjustment;
+      } else if (hopAddition.stage == RecipeAddition::Stage::Boil) {
+         calculation.contributes = true;
+         calculation.parms.boilTime_minutes = minutes;
+      } else if (hopAddition.stage == RecipeAddition::Stage::Mash && IbuMethods::mashHopAdjustment > 0.0) {
+         calculation.contributes = true;
+         calculation.adjustment  = IbuMethods::mashHopAdjustment;
+      }
+      return calculation;
+   }
+
+   //
+   // For RecipeEvaluator::inputFingerprint we want any change to a number to change the fingerprint, so, unlike the
+   // Utils::fingerprintCombine overloads, these mix in the exact bit pattern of doubles.
+   //
+   std::size_t mixExact(std::size_t const seed, double const value) {
+      return Utils::fingerprintMix(seed, static_cast<std::size_t>(std::bit_cast<std::uint64_t>(value)));
+   }
+
+   std::size_t mixExact(std::size_t const seed, std::optional<double> const value) {
+      std::size_t const result = Utils::fingerprintCombine(seed, value.has_value());
+      return value ? mixExact(result, *value) : result;
+   }
+
+   std::size_t mixExact(std::size_t const seed, QVector<double> const & values) {
+      std::size_t result = Utils::fingerprintCombine(seed, static_cast<int>(values.size()));
+      for (double const value : values) {
+         result = mixExact(result, value);
+      }
+      return result;
+   }
+
+}
+
+int constexpr RecipeEvaluator::formulaVersion = 1;
+
+void RecipeEvaluator::GrainBill::append(FermentableAdditionInputs const & fermentableAddition) {
+   double const quantity = fermentableAddition.quantity;
+   bool const amountIsWeight = fermentableAddition.amountIsWeight;
+
+   // I wouldn't have thought you would want to measure grain by volume, but best to check.  (We logged a warning about
+   // it when we took the snapshot.)
+   bool const isGrainByWeight = fermentableAddition.type == Fermentable::Type::Grain && amountIsWeight;
+   this->grain_kg      .append(isGrainByWeight ? quantity : 0.0);
+   this->grainInMash_kg.append(
+      isGrainByWeight && fermentableAddition.stage == RecipeAddition::Stage::Mash ? quantity : 0.0
+   );
+
+   // .:TODO:. Assumptions below about liquids are almost certainly wrong, also TBD what other cases we have to cover
+   double density_kgL = 0.0;
+   switch (fermentableAddition.type) {
+      case Fermentable::Type::Extract    : density_kgL = PhysicalConstants::liquidExtractDensity_kgL; break;
+      case Fermentable::Type::Sugar      : density_kgL = PhysicalConstants::sucroseDensity_kgL      ; break;
+      case Fermentable::Type::Dry_Extract: density_kgL = PhysicalConstants::dryExtractDensity_kgL   ; break;
+      default:
+         break;
+   }
+   this->addedVolume_l.append(density_kgL == 0.0 ? 0.0 : amountIsWeight ? quantity / density_kgL : quantity);
+
+   // .:TBD:. What do do about liquids?  (We logged a warning about them when we took the snapshot.)
+   this->colorWeight_srmKg                .append(amountIsWeight ? fermentableAddition.color_srm * quantity : 0.0);
+   this->hoppedExtractWeight_ibuGalPerLbKg.append(
+      amountIsWeight ? fermentableAddition.ibuGalPerLb.value_or(0.0) * quantity : 0.0
+   );
+
+   // If we have some sort of non-grain, we have to ignore efficiency.
+   double const equivSucrose_kg = fermentableAddition.equivSucrose_kg;
+   bool const ignoreEfficiency = fermentableAddition.isSugar || fermentableAddition.isExtract;
+   bool const isLate = fermentableAddition.addAfterBoil;
+   this->sugar_kg                    .append(!ignoreEfficiency           ? equivSucrose_kg : 0.0);
+   this->sugarIgnoreEfficiency_kg    .append( ignoreEfficiency           ? equivSucrose_kg : 0.0);
+   this->lateSugar_kg                .append(!ignoreEfficiency && isLate ? equivSucrose_kg : 0.0);
+   this->lateSugarIgnoreEfficiency_kg.append( ignoreEfficiency && isLate ? equivSucrose_kg : 0.0);
+   this->nonFermentableSugar_kg      .append(
+      ignoreEfficiency && !fermentableAddition.isFermentableSugar ? equivSucrose_kg : 0.0
+   );
+   return;
+}
+
+void RecipeEvaluator::GrainBill::reserve(int const size) {
+   for (auto column : {&this->grain_kg,
+                       &this->grainInMash_kg,
+                       &this->addedVolume_l,
+                       &this->colorWeight_srmKg,
+                       &this->hoppedExtractWeight_ibuGalPerLbKg,
+                       &this->sugar_kg,
+                       &this->sugarIgnoreEfficiency_kg,
+                       &this->lateSugar_kg,
+                       &this->lateSugarIgnoreEfficiency_kg,
+                       &this->nonFermentableSugar_kg}) {
+      column->reserve(size);
+   }
+   return;
+}
+
+int RecipeEvaluator::GrainBill::size() const {
+   return this->grain_kg.size();
+}
+
+RecipeEvaluator::GrainBillTotals RecipeEvaluator::grainBillTotals(GrainBill const & grainBill) {
+   //
+   // Everything that depends on the type etc of each addition was sorted out in GrainBill::append, so this is just
+   // straight sums over contiguous arrays, with no branches and no indirection.
+   //
+   int const size = grainBill.size();
+   double const * const grain_kg                          = grainBill.grain_kg                         .constData();
+   double const * const grainInMash_kg                    = grainBill.grainInMash_kg                   .constData();
+   double const * const addedVolume_l                     = grainBill.addedVolume_l                    .constData();
+   double const * const colorWeight_srmKg                 = grainBill.colorWeight_srmKg                .constData();
+   double const * const hoppedExtractWeight_ibuGalPerLbKg = grainBill.hoppedExtractWeight_ibuGalPerLbKg.constData();
+   double const * const sugar_kg                          = grainBill.sugar_kg                         .constData();
+   double const * const sugarIgnoreEfficiency_kg          = grainBill.sugarIgnoreEfficiency_kg         .constData();
+   double const * const lateSugar_kg                      = grainBill.lateSugar_kg                     .constData();
+   double const * const lateSugarIgnoreEfficiency_kg      = grainBill.lateSugarIgnoreEfficiency_kg     .constData();
+   double const * const nonFermentableSugar_kg            = grainBill.nonFermentableSugar_kg           .constData();
+
+   GrainBillTotals totals{};
+   for (int ii = 0; ii < size; ++ii) {
+      totals.grains_kg                         += grain_kg                         [ii];
+      totals.grainsInMash_kg                   += grainInMash_kg                   [ii];
+      totals.addedVolume_l                     += addedVolume_l                    [ii];
+      totals.colorWeight_srmKg                 += colorWeight_srmKg                [ii];
+      totals.hoppedExtractWeight_ibuGalPerLbKg += hoppedExtractWeight_ibuGalPerLbKg[ii];
+      totals.sugars.sugar_kg                   += sugar_kg                         [ii];
+      totals.sugars.sugar_kg_ignoreEfficiency  += sugarIgnoreEfficiency_kg         [ii];
+      totals.sugars.lateAddition_kg            += lateSugar_kg                     [ii];
+      totals.sugars.lateAddition_kg_ignoreEff  += lateSugarIgnoreEfficiency_kg     [ii];
+      totals.sugars.nonFermentableSugars_kg    += nonFermentableSugar_kg           [ii];
+   }
+   return totals;
+}
+
+RecipeEvaluator::Snapshot RecipeEvaluator::snapshotOf(Recipe & recipe) {
+   Snapshot snapshot{
+      .batchSize_l          = recipe.batchSize_l(),
+      .efficiency_pct       = recipe.efficiency_pct(),
+      .equipment            = std::nullopt,
+      .boil                 = std::nullopt,
+      .mashTotalWater_l     = std::nullopt,
+      .grainBill            = {},
+      .grainBillTotals      = {},
+      .hopAdditions         = {},
+      .yeastAdditions       = {},
+   };
+
+   auto equipment = recipe.equipment();
+   if (equipment) {
+      snapshot.equipment = RecipeEvaluator::snapshotOf(*equipment);
+   }
+   auto boil = recipe.boil();
+   if (boil) {
+      snapshot.boil = RecipeEvaluator::snapshotOf(*boil);
+   }
+   auto mash = recipe.mash();
+   if (mash) {
+      snapshot.mashTotalWater_l = mash->totalMashWater_l();
+   }
+
+   auto const fermentableAdditions = recipe.fermentableAdditions();
+   snapshot.grainBill.reserve(fermentableAdditions.size());
+   for (auto const & fermentableAddition : fermentableAdditions) {
+      auto const fermentable = fermentableAddition->fermentable();
+      if (!fermentable) {
+         qCWarning(Logging::recipe) <<
+            Q_FUNC_INFO << "Ignoring fermentable addition #" << fermentableAddition->key() << "with no fermentable";
+         continue;
+      }
+
+      bool const amountIsWeight = fermentableAddition->amountIsWeight();
+      if (!amountIsWeight) {
+         if (fermentable->type() == Fermentable::Type::Grain) {
+            qCWarning(Logging::recipe) <<
+               Q_FUNC_INFO << "Ignoring grain fermentable addition #" << fermentableAddition->key() << "(" <<
+               fermentableAddition->name() << ") as measured by volume";
+         }
+         // .:TBD:. What do do about liquids
+         qCWarning(Logging::recipe) <<
+            Q_FUNC_INFO << "Unimplemented branch for handling color and IBU of liquid fermentables - #" <<
+            fermentable->key() << ":" << fermentableAddition->name();
+      }
+
+      FermentableAdditionInputs inputs{
+         .type               = fermentable->type(),
+         .stage              = fermentableAddition->stage(),
+         .amountIsWeight     = amountIsWeight,
+         .quantity           = fermentableAddition->amount().quantity,
+         .addAfterBoil       = fermentableAddition->addAfterBoil(),
+         .equivSucrose_kg    = fermentableAddition->equivSucrose_kg(),
+         .isSugar            = fermentable->isSugar(),
+         .isExtract          = fermentable->isExtract(),
+         .isFermentableSugar = isFermentableSugar(*fermentable),
+         .color_srm          = fermentable->color_srm(),
+         .ibuGalPerLb        = fermentable->ibuGalPerLb(),
+      };
+      snapshot.grainBill.append(inputs);
+   }
+   snapshot.grainBillTotals = RecipeEvaluator::grainBillTotals(snapshot.grainBill);
+
+   auto const hopAdditions = recipe.hopAdditions();
+   snapshot.hopAdditions.reserve(hopAdditions.size());
+   for (auto const & hopAddition : hopAdditions) {
+      snapshot.hopAdditions.append(RecipeEvaluator::snapshotOf(*hopAddition));
+   }
+
+   auto const yeastAdditions = recipe.yeastAdditions();
+   snapshot.yeastAdditions.reserve(yeastAdditions.size());
+   for (auto const & yeastAddition : yeastAdditions) {
+      auto const yeast = yeastAddition->yeast();
+      snapshot.yeastAdditions.append(
+         YeastAdditionInputs{
+            .additionAttenuation_pct     = yeastAddition->attenuation_pct(),
+            .yeastAttenuationTypical_pct = yeast ? yeast->attenuationTypical_pct() : Yeast::DefaultAttenuation_pct,
+         }
+      );
+   }
+
+   return snapshot;
+}
+
+RecipeEvaluator::HopAdditionInputs RecipeEvaluator::snapshotOf(RecipeAdditionHop const & hopAddition) {
+   // .:TBD:.  What to do if hopAddition is measured by volume?
+   //
+   // Per https://beersmith.com/blog/2016/08/31/using-hop-extracts-for-beer-brewing/, for CO2 Hop Extract, a first
+   // approximation would be 1 gram hop = 1 ml of hop extract.
+   //
+   // The same page suggests that, for Isomerized Hop Extract,
+   //    IBU = (extract_vol_ml * alpha_content_pct * 1000) / (volume_beer_liters)
+   //
+   if (!hopAddition.amountIsWeight()) {
+      qCCritical(Logging::recipe) << Q_FUNC_INFO << "Using Hop volume as weight - THIS IS PROBABLY WRONG!";
+   }
+
+   auto const hop = hopAddition.hop();
+   if (!hop) {
+      qCWarning(Logging::recipe) <<
+         Q_FUNC_INFO << "Hop addition #" << hopAddition.key() << "has no hop, so contributes no IBUs";
+   }
+
+   return HopAdditionInputs{
+      .alpha_pct      = hop ? hop->alpha_pct() : 0.0,
+      .quantity       = hopAddition.quantity(),
+      .addAtTime_mins = hopAddition.addAtTime_mins(),
+      .isFirstWort    = hopAddition.isFirstWort(),
+      .stage          = hopAddition.stage(),
+      .form           = hop ? hop->form() : std::nullopt,
+   };
+}
+
+RecipeEvaluator::EquipmentInputs RecipeEvaluator::snapshotOf(Equipment const & equipment) {
+   return RecipeEvaluator::EquipmentInputs{
+      .mashTunGrainAbsorption_LKg = equipment.mashTunGrainAbsorption_LKg(),
+      .lauteringDeadspaceLoss_l   = equipment.getLauteringDeadspaceLoss_l(),
+      .topUpKettle_l              = equipment.topUpKettle_l(),
+      .topUpWater_l               = equipment.topUpWater_l(),
+      .kettleTrubChillerLoss_l    = equipment.kettleTrubChillerLoss_l(),
+      .boilTime_min               = equipment.boilTime_min(),
+      .kettleEvaporationPerHour_l = equipment.kettleEvaporationPerHour_l(),
+      .hopUtilization_pct         = equipment.hopUtilization_pct(),
+      .kettleInternalDiameter_cm  = equipment.kettleInternalDiameter_cm(),
+      .kettleOpeningDiameter_cm   = equipment.kettleOpeningDiameter_cm(),
+   };
+}
+
+RecipeEvaluator::BoilInputs RecipeEvaluator::snapshotOf(Boil const & boil) {
+   return RecipeEvaluator::BoilInputs{
+      .preBoilSize_l = boil.preBoilSize_l(),
+      .boilTime_mins = boil.boilTime_mins(),
+      .coolTime_mins = boil.coolTime_mins(),
+   };
+}
+
+std::size_t RecipeEvaluator::inputFingerprint(Snapshot const & snapshot) {
+   std::size_t result = Utils::fingerprintCombine(0, RecipeEvaluator::formulaVersion);
+   result = Utils::fingerprintCombine(result, IbuMethods::ibuFormula);
+   result = Utils::fingerprintCombine(result, ColorMethods::colorFormula);
+   result = mixExact(result, IbuMethods::firstWortHopAdjustment);
+   result = mixExact(result, IbuMethods::mashHopAdjustment);
+
+   result = mixExact(result, snapshot.batchSize_l);
+   result = mixExact(result, snapshot.efficiency_pct);
+
+   result = Utils::fingerprintCombine(result, snapshot.equipment.has_value());
+   if (snapshot.equipment) {
+      EquipmentInputs const & equipment = *snapshot.equipment;
+      result = mixExact(result, equipment.mashTunGrainAbsorption_LKg);
+      result = mixExact(result, equipment.lauteringDeadspaceLoss_l  );
+      result = mixExact(result, equipment.topUpKettle_l             );
+      result = mixExact(result, equipment.topUpWater_l              );
+      result = mixExact(result, equipment.kettleTrubChillerLoss_l   );
+      result = mixExact(result, equipment.boilTime_min              );
+      result = mixExact(result, equipment.kettleEvaporationPerHour_l);
+      result = mixExact(result, equipment.hopUtilization_pct        );
+      result = mixExact(result, equipment.kettleInternalDiameter_cm );
+      result = mixExact(result, equipment.kettleOpeningDiameter_cm  );
+   }
+
+   result = Utils::fingerprintCombine(result, snapshot.boil.has_value());
+   if (snapshot.boil) {
+      result = mixExact(result, snapshot.boil->preBoilSize_l);
+      result = mixExact(result, snapshot.boil->boilTime_mins);
+      result = mixExact(result, snapshot.boil->coolTime_mins);
+   }
+
+   result = mixExact(result, snapshot.mashTotalWater_l);
+
+   // The grain bill totals are worked out from the grain bill, so there's no need to mix them in too
+   GrainBill const & grainBill = snapshot.grainBill;
+   result = mixExact(result, grainBill.grain_kg                         );
+   result = mixExact(result, grainBill.grainInMash_kg                   );
+   result = mixExact(result, grainBill.addedVolume_l                    );
+   result = mixExact(result, grainBill.colorWeight_srmKg                );
+   result = mixExact(result, grainBill.hoppedExtractWeight_ibuGalPerLbKg);
+   result = mixExact(result, grainBill.sugar_kg                         );
+   result = mixExact(result, grainBill.sugarIgnoreEfficiency_kg         );
+   result = mixExact(result, grainBill.lateSugar_kg                     );
+   result = mixExact(result, grainBill.lateSugarIgnoreEfficiency_kg     );
+   result = mixExact(result, grainBill.nonFermentableSugar_kg           );
+
+   result = Utils::fingerprintCombine(result, static_cast<int>(snapshot.hopAdditions.size()));
+   for (HopAdditionInputs const & hopAddition : snapshot.hopAdditions) {
+      result = mixExact                 (result, hopAddition.alpha_pct     );
+      result = mixExact                 (result, hopAddition.quantity      );
+      result = mixExact                 (result, hopAddition.addAtTime_mins);
+      result = Utils::fingerprintCombine(result, hopAddition.isFirstWort   );
+      result = Utils::fingerprintCombine(result, hopAddition.stage         );
+      result = Utils::fingerprintCombine(result, hopAddition.form          );
+   }
+
+   result = Utils::fingerprintCombine(result, static_cast<int>(snapshot.yeastAdditions.size()));
+   for (YeastAdditionInputs const & yeastAddition : snapshot.yeastAdditions) {
+      result = mixExact(result, yeastAddition.additionAttenuation_pct    );
+      result = mixExact(result, yeastAddition.yeastAttenuationTypical_pct);
+   }
+
+   return result;
+}
+
+RecipeEvaluator::Grains RecipeEvaluator::grains(Snapshot const & snapshot) {
+   return Grains{
+      .grains_kg       = snapshot.grainBillTotals.grains_kg,
+      .grainsInMash_kg = snapshot.grainBillTotals.grainsInMash_kg,
+   };
+}
+
+RecipeEvaluator::VolumeEstimates RecipeEvaluator::volumeEstimates(Snapshot const & snapshot, Grains const & grains) {
+   VolumeEstimates volumes{
+      .wortFromMash_l        = 0.0,
+      .boilVolume_l          = 0.0,
+      .finalVolume_l         = 0.0,
+      .finalVolumeNoLosses_l = 0.0,
+      .postBoilVolume_l      = 0.0,
+   };
+
+   auto const & equipment = snapshot.equipment;
+
+   // wortFromMash_l ==========================
+   if (snapshot.mashTotalWater_l) {
+      double const absorption_lKg =
+         equipment ? equipment->mashTunGrainAbsorption_LKg.value_or(Equipment::default_mashTunGrainAbsorption_LKg) :
+                     PhysicalConstants::grainAbsorption_Lkg;
+      volumes.wortFromMash_l = *snapshot.mashTotalWater_l - absorption_lKg * grains.grainsInMash_kg;
+   }
+
+   // boilVolume_l ==============================
+   double tmp = volumes.wortFromMash_l;
+   if (equipment) {
+      tmp = volumes.wortFromMash_l - equipment->lauteringDeadspaceLoss_l +
+            equipment->topUpKettle_l.value_or(Equipment::default_topUpKettle_l);
+   }
+
+   // Need to account for extract/sugar volume also.  (See GrainBill::append.)
+   tmp += snapshot.grainBillTotals.addedVolume_l;
+
+   if (tmp <= 0.0) {
+      // Give up.
+      tmp = boilSizeInLitersOr(snapshot, 0.0);
+   }
+
+   volumes.boilVolume_l = tmp;
+
+   // finalVolume_l ==============================
+
+   // NOTE: the following figure is not based on the other volume estimates
+   // since we want to show og,fg,ibus,etc. as if the collected wort is correct.
+   volumes.finalVolumeNoLosses_l = snapshot.batchSize_l + (equipment ? equipment->kettleTrubChillerLoss_l : 0.0);
+   if (equipment) {
+      volumes.finalVolume_l = wortEndOfBoil_l(*equipment, volumes.boilVolume_l) +
+                              equipment->topUpWater_l.value_or(Equipment::default_topUpWater_l) -
+                              equipment->kettleTrubChillerLoss_l;
+   } else {
+      // This is just shooting in the dark. Can't do much without an equipment.
+      volumes.finalVolume_l = volumes.boilVolume_l - 4.0;
+   }
+
+   // postBoilVolume_l ===========================
+
+   if (equipment) {
+      volumes.postBoilVolume_l = wortEndOfBoil_l(*equipment, volumes.boilVolume_l);
+   } else {
+      volumes.postBoilVolume_l = snapshot.batchSize_l; // Give up.
+   }
+
+   return volumes;
+}
+
+double RecipeEvaluator::color_srm(Snapshot const & snapshot, VolumeEstimates const & volumes) {
+   double const mcu = snapshot.grainBillTotals.colorWeight_srmKg * lbPerGalToKgPerL / volumes.finalVolumeNoLosses_l;
+   return ColorMethods::mcuToSrm(mcu);
+}
+
+Recipe::Sugars RecipeEvaluator::sugars(Snapshot const & snapshot) {
+   return snapshot.grainBillTotals.sugars;
+}
+
+double RecipeEvaluator::sugarRetention(Snapshot const & snapshot, VolumeEstimates const & volumes) {
+   auto const & equipment = snapshot.equipment;
+   if (!equipment) {
+      return 1.0;
+   }
+   double const kettleWort_l = (volumes.wortFromMash_l - equipment->lauteringDeadspaceLoss_l) +
+                               equipment->topUpKettle_l.value_or(Equipment::default_topUpKettle_l);
+   double const postBoilWort_l = wortEndOfBoil_l(*equipment, kettleWort_l);
+   double ratio = (postBoilWort_l - equipment->kettleTrubChillerLoss_l) / postBoilWort_l;
+   if (ratio > 1.0) { // Usually happens when we don't have a mash yet.
+      ratio = 1.0;
+   } else if (ratio < 0.0) {
+      ratio = 0.0;
+   } else if (Algorithms::isNan(ratio)) {
+      ratio = 1.0;
+   }
+   return ratio;
+}
+
+RecipeEvaluator::Gravities RecipeEvaluator::gravities(Snapshot const & snapshot, VolumeEstimates const & volumes) {
+   Gravities gravities{.og = 1.0, .fg = 1.0, .og_fermentable = 0.0, .fg_fermentable = 0.0};
+
+   // Find out how much sugar we have.
+   auto const sugars = RecipeEvaluator::sugars(snapshot);
+   double sugar_kg                  = sugars.sugar_kg;  // Mass of sugar that *is* affected by mash efficiency
+   double sugar_kg_ignoreEfficiency = sugars.sugar_kg_ignoreEfficiency;  // Mass of sugar that *is not* affected by mash efficiency
+   double nonFermentableSugars_kg   = sugars.nonFermentableSugars_kg;  // Mass of sugar that is not fermentable (also counted in sugar_kg_ignoreEfficiency)
+
+   // We might lose some sugar in the form of Trub/Chiller loss and lauter deadspace.
+   if (snapshot.equipment) {
+      double const ratio = RecipeEvaluator::sugarRetention(snapshot, volumes);
+      // Ignore this again since it should be included in efficiency.
+      //sugar_kg *= ratio;
+      sugar_kg_ignoreEfficiency *= ratio;
+      if (nonFermentableSugars_kg != 0.0) {
+         nonFermentableSugars_kg *= ratio;
+      }
+   }
+
+   // Total sugars after accounting for efficiency and mash losses. Implicitly includes non-fermentable sugars
+   sugar_kg = sugar_kg * snapshot.efficiency_pct / 100.0 + sugar_kg_ignoreEfficiency;
+   double plato = Algorithms::getPlato(sugar_kg, volumes.finalVolumeNoLosses_l);
+
+   gravities.og = Algorithms::PlatoToSG_20C20C(plato);    // og from all sugars
+   double tmp_pnts = (gravities.og - 1) * 1000.0; // points from all sugars
+   double tmp_nonferm_pnts;
+   if (nonFermentableSugars_kg != 0.0) {
+      double ferm_kg = sugar_kg - nonFermentableSugars_kg;  // Mass of only fermentable sugars
+      plato = Algorithms::getPlato(ferm_kg, volumes.finalVolumeNoLosses_l);   // Plato from fermentable sugars
+      gravities.og_fermentable = Algorithms::PlatoToSG_20C20C(plato);    // og from only fermentable sugars
+      plato = Algorithms::getPlato(nonFermentableSugars_kg, volumes.finalVolumeNoLosses_l);   // Plate from non-fermentable sugars
+      tmp_nonferm_pnts = ((Algorithms::PlatoToSG_20C20C(plato)) - 1) * 1000.0; // og points from non-fermentable sugars
+   } else {
+      gravities.og_fermentable = gravities.og;
+      tmp_nonferm_pnts = 0.0;
+   }
+
+   // Calculage FG
+   double attenuation_pct = 0.0;
+   for (auto const & yeastAddition : snapshot.yeastAdditions) {
+      // Get the yeast with the greatest attenuation.
+      if (yeastAddition.additionAttenuation_pct > attenuation_pct) {
+         attenuation_pct = yeastAddition.yeastAttenuationTypical_pct;
+      }
+   }
+   // This means we have yeast, but they neglected to provide attenuation percentages.
+   if (snapshot.yeastAdditions.size() > 0 && attenuation_pct <= 0.0)  {
+      attenuation_pct = Yeast::DefaultAttenuation_pct; // Use an average attenuation.
+   }
+
+   if (nonFermentableSugars_kg != 0.0) {
+      double tmp_ferm_pnts = (tmp_pnts - tmp_nonferm_pnts) * (1.0 - attenuation_pct / 100.0); // fg points from fermentable sugars
+      tmp_pnts = tmp_ferm_pnts + tmp_nonferm_pnts;  // FG points from both fermentable and non-fermentable sugars
+      gravities.fg =  1 + tmp_pnts / 1000.0; // new FG value
+      gravities.fg_fermentable =  1 + tmp_ferm_pnts / 1000.0; // FG from fermentables only
+   } else {
+      tmp_pnts *= (1.0 - attenuation_pct / 100.0);
+      gravities.fg =  1 + tmp_pnts / 1000.0;
+      gravities.fg_fermentable = gravities.fg;
+   }
+
+   return gravities;
+}
+
+double RecipeEvaluator::ABV_pct(Gravities const & gravities) {
+   // The complex formula, and variations comes from Ritchie Products Ltd, (Zymurgy, Summer 1995, vol. 18, no. 2)
+   // Michael L. Hall’s article Brew by the Numbers: Add Up What’s in Your Beer, and Designing Great Beers by Daniels.
+   return (76.08 * (gravities.og_fermentable - gravities.fg_fermentable) / (1.775 - gravities.og_fermentable)) *
+          (gravities.fg_fermentable / 0.794);
+}
+
+double RecipeEvaluator::boilGrav(Snapshot const & snapshot) {
+   auto const sugars = RecipeEvaluator::sugars(snapshot);
+
+   // Since the efficiency refers to how much sugar we get into the fermenter,
+   // we need to adjust for that here.
+   double const sugar_kg = snapshot.efficiency_pct / 100.0 * (sugars.sugar_kg - sugars.lateAddition_kg) +
+                           sugars.sugar_kg_ignoreEfficiency - sugars.lateAddition_kg_ignoreEff;
+
+   return Algorithms::PlatoToSG_20C20C(Algorithms::getPlato(sugar_kg, boilSizeInLitersOr(snapshot, 0.0)));
+}
+
+double RecipeEvaluator::ibuFromHopAddition(HopAdditionInputs const & hopAddition,
+                                           std::optional<EquipmentInputs> const & equipment,
+                                           std::optional<BoilInputs> const & boil,
+                                           double const og,
+                                           double const finalVolumeNoLosses_l) {
+   auto const calculation = ibuCalculation(hopAddition, equipment, boil, og, finalVolumeNoLosses_l);
+   if (!calculation.contributes) {
+      return 0.0;
+   }
+   return calculation.ibus(IbuMethods::getIbus(calculation.parms));
+}
+
+void RecipeEvaluator::ibusFromHopAdditions(std::span<HopAdditionInputs const> const hopAdditions,
+                                           std::optional<EquipmentInputs> const & equipment,
+                                           std::optional<BoilInputs> const & boil,
+                                           double const og,
+                                           double const finalVolumeNoLosses_l,
+                                           std::span<double> const ibus) {
+   // It's a coding error to supply different-sized inputs and outputs
+   if (hopAdditions.size() != ibus.size()) {
+      qCCritical(Logging::recipe) <<
+         Q_FUNC_INFO << "Have" << hopAdditions.size() << "inputs but" << ibus.size() << "outputs";
+      Q_ASSERT(false);
+      return;
+   }
+
+   //
+   // Only the additions that contribute IBUs need to go through the formula, so we gather up their parameters, get the
+   // IBUs for all of them in one go, and then apply the per-addition multipliers.
+   //
+   QVector<HopAdditionIbuCalculation> calculations;
+   calculations.reserve(hopAdditions.size());
+   QVector<IbuMethods::IbuCalculationParms> formulaParms;
+   formulaParms.reserve(hopAdditions.size());
+   for (auto const & hopAddition : hopAdditions) {
+      calculations.append(ibuCalculation(hopAddition, equipment, boil, og, finalVolumeNoLosses_l));
+      if (calculations.last().contributes) {
+         formulaParms.append(calculations.last().parms);
+      }
+   }
+
+   QVector<double> formulaIbus(formulaParms.size());
+   IbuMethods::getIbus(formulaParms, formulaIbus);
+
+   qsizetype nextFormulaResult = 0;
+   for (qsizetype ii = 0; ii < calculations.size(); ++ii) {
+      if (calculations[ii].contributes) {
+         ibus[ii] = calculations[ii].ibus(formulaIbus[nextFormulaResult]);
+         ++nextFormulaResult;
+      } else {
+         ibus[ii] = 0.0;
+      }
+   }
+   return;
+}
+
+double RecipeEvaluator::hoppedExtractIbus(Snapshot const & snapshot) {
+   return snapshot.grainBillTotals.hoppedExtractWeight_ibuGalPerLbKg / snapshot.batchSize_l / lbPerGalToKgPerL;
+}
+
+double RecipeEvaluator::IBU(Snapshot const & snapshot,
+                            double const og,
+                            VolumeEstimates const & volumes,
+                            QList<double> * ibusByHopAddition) {
+   if (ibusByHopAddition) {
+      ibusByHopAddition->clear();
+   }
+   QVector<double> hopAdditionIbus(snapshot.hopAdditions.size());
+   RecipeEvaluator::ibusFromHopAdditions(snapshot.hopAdditions,
+                                         snapshot.equipment,
+                                         snapshot.boil,
+                                         og,
+                                         volumes.finalVolumeNoLosses_l,
+                                         hopAdditionIbus);
+   double ibus = RecipeEvaluator::hoppedExtractIbus(snapshot);
+   for (double const ibusForAddition : hopAdditionIbus) {
+      if (ibusByHopAddition) {
+         ibusByHopAddition->append(ibusForAddition);
+      }
+      ibus += ibusForAddition;
+   }
+   return ibus;
+}
+
+double RecipeEvaluator::caloriesPerLiter(Gravities const & gravities) {
+   //
+   // The Journal of the Institute of Brewing (JIB) is published by the Institute of Brewing and Distilling.
+   // On pages 320-321 of Volume 88 of the JIB, dated "September - October 1982", there is an article on "Calculation of
+   // Calorific Value of Beer" submitted by P A Martin on behalf of the IOB (Institute of Brewing) Analysis Committee.
+   //
+   // The article discusses four methods for calculating the calories in beer, and, in summary, recommends calculating
+   // Calories/100ml as follows:
+   //    1.1 Estimate the alcohol content of the beer ... [and] convert ... to alcohol g/100ml
+   //    1.2 Estimate total carbohydrate of the beer (g/100ml as glucose) ...
+   //    1.3 Estimate protein content of the beer (g/100ml)
+   //    2.1 Calories/100ml = [alcohol (g/100ml) × 7] +
+   //                         [total carbohydrate (as glucose g/100ml) × 3.75] +
+   //                         [protein (g/100ml) × 4]
+   //    2.2 In a collaborative trial the precision of the method was ±2.02 Calories for highly attenuated beers and
+   //        ±3.06 Calories for normally fermented products.
+   //
+   // We should come back to this at some point...
+   //
+   // the formula in here are taken from http://hbd.org/ensmingr/
+   //
+
+   // Need to translate OG and FG into plato
+   double const startPlato  = Measurement::Units::plato.fromCanonical(gravities.og);
+   double const finishPlato = Measurement::Units::plato.fromCanonical(gravities.fg);
+
+   double const realExtract = (0.1808 * startPlato) + (0.8192 * finishPlato);
+
+   // Alcohol by weight?
+   double const abw = (startPlato - realExtract) / (2.0665 - (0.010665 * startPlato));
+
+   // The final results of this formula are calories per 100 ml.
+   // The 10.0 puts it in terms of liters.
+   double const caloriesPerLiter = ((6.9 * abw) + 4.0 * (realExtract - 0.1)) * gravities.fg * 10.0;
+
+   //! If there are no fermentables in the recipe, if there is no mash, etc.,
+   //  then the calories/12 oz ends up negative. Since negative doesn't make
+   //  sense, set it to 0
+   return std::max(caloriesPerLiter, 0.0);
+}
+
+RecipeEvaluator::Results RecipeEvaluator::evaluate(Snapshot const & snapshot, Overrides const & overrides) {
+   //
+   // Snapshot is cheap to copy, because QVector is implicitly shared, and we only actually copy the hop additions if
+   // we are going to change them.
+   //
+   Snapshot variant{snapshot};
+   if (overrides.batchSize_l) {
+      variant.batchSize_l = *overrides.batchSize_l;
+   }
+   if (overrides.efficiency_pct) {
+      variant.efficiency_pct = *overrides.efficiency_pct;
+   }
+   for (auto hopAdditionTime = overrides.hopAdditionTimes_mins.cbegin();
+        hopAdditionTime != overrides.hopAdditionTimes_mins.cend();
+        ++hopAdditionTime) {
+      int const index = hopAdditionTime.key();
+      if (index < 0 || index >= variant.hopAdditions.size()) {
+         // It's a coding error to override a hop addition that isn't there
+         qCCritical(Logging::recipe) <<
+            Q_FUNC_INFO << "Invalid hop addition index" << index << "(of" << variant.hopAdditions.size() << ")";
+         Q_ASSERT(false);
+         continue;
+      }
+      variant.hopAdditions[index].addAtTime_mins = hopAdditionTime.value();
+   }
+
+   Results results;
+   results.grains           = RecipeEvaluator::grains         (variant);
+   results.volumes          = RecipeEvaluator::volumeEstimates(variant, results.grains);
+   results.color_srm        = RecipeEvaluator::color_srm      (variant, results.volumes);
+   results.gravities        = RecipeEvaluator::gravities      (variant, results.volumes);
+   results.ABV_pct          = RecipeEvaluator::ABV_pct        (results.gravities);
+   results.boilGrav         = RecipeEvaluator::boilGrav       (variant);
+   results.IBU              = RecipeEvaluator::IBU            (variant,
+                                                               results.gravities.og,
+                                                               results.volumes,
+                                                               &results.ibusByHopAddition);
+   results.caloriesPerLiter = RecipeEvaluator::caloriesPerLiter(results.gravities);
+   return results;
+}
+
+QVector<RecipeEvaluator::Results> RecipeEvaluator::evaluateAll(Snapshot const & snapshot,
+                                                               QVector<Overrides> const & variants) {
+   //
+   // Each call writes to a different element of results, so no locking is needed beyond waiting for completion.  We
+   // take the raw data pointer up front so that nothing below can cause a detach of the QVector.
+   //
+   QVector<Results> results(variants.size());
+   Results * const resultData = results.data();
+   int const numChunks = inParallel(variants.size(), [&snapshot, &variants, resultData](int const ii) {
+      resultData[ii] = RecipeEvaluator::evaluate(snapshot, variants.at(ii));
+      return;
+   });
+
+   qCDebug(Logging::recipe) << Q_FUNC_INFO << "Evaluated" << variants.size() << "variants in" << numChunks << "chunks";
+   return results;
+}
+
+QVector<RecipeEvaluator::Results> RecipeEvaluator::evaluateEach(QVector<Snapshot> const & snapshots) {
+   // See comment in evaluateAll() above
+   QVector<Results> results(snapshots.size());
+   Results * const resultData = results.data();
+   int const numChunks = inParallel(snapshots.size(), [&snapshots, resultData](int const ii) {
+      resultData[ii] = RecipeEvaluator::evaluate(snapshots.at(ii));
+      return;
+   });
+
+   qCDebug(Logging::recipe) <<
+      Q_FUNC_INFO << "Evaluated" << snapshots.size() << "snapshots in" << numChunks << "chunks";
+   return results;
+}
+
+void RecipeEvaluator::recalculateAllRecipes() {
+   // It's a coding error to call this other than on the GUI thread, as that's the thread that owns the recipes
+   Q_ASSERT(QThread::currentThread() == QCoreApplication::instance()->thread());
+
+   unsigned int const thisJob = ++latestRecalculationJob;
+
+   //
+   // We hold on to recipe IDs rather than shared pointers, partly so that we can't end up with the last reference to a
+   // Recipe being dropped on a worker thread, and partly so that we notice if a Recipe gets deleted while we're
+   // working on it.
+   //
+   QVector<int>          recipeIds;
+   QVector<unsigned int> calcGenerations;
+   QVector<Snapshot>     snapshots;
+   // Taken here, rather than on the worker thread, because, like the snapshots, they depend on the current settings
+   QVector<std::size_t>  inputFingerprints;
+   QList<Recipe *> const recipes = ObjectStoreWrapper::getAllRaw<Recipe>();
+   recipeIds        .reserve(recipes.size());
+   calcGenerations  .reserve(recipes.size());
+   snapshots        .reserve(recipes.size());
+   inputFingerprints.reserve(recipes.size());
+   for (Recipe * recipe : recipes) {
+      recipeIds        .append(recipe->key());
+      calcGenerations  .append(recipe->calcGeneration());
+      snapshots        .append(RecipeEvaluator::snapshotOf(*recipe));
+      inputFingerprints.append(RecipeEvaluator::inputFingerprint(snapshots.back()));
+   }
+   qCDebug(Logging::recipe) << Q_FUNC_INFO << "Job" << thisJob << "recalculating" << recipeIds.size() << "recipes";
+
+   QThreadPool::globalInstance()->start(QRunnable::create(
+      [thisJob, recipeIds, calcGenerations, snapshots, inputFingerprints]() {
+         QVector<Results> const results = RecipeEvaluator::evaluateEach(snapshots);
+
+         QMetaObject::invokeMethod(
+            QCoreApplication::instance(),
+            [thisJob, recipeIds, calcGenerations, inputFingerprints, results]() {
+               if (thisJob != latestRecalculationJob) {
+                  qCDebug(Logging::recipe) <<
+                     Q_FUNC_INFO << "Discarding results of job" << thisJob << "as overtaken by a later one";
+                  return;
+               }
+
+               int numPublished = 0;
+               for (int ii = 0; ii < recipeIds.size(); ++ii) {
+                  Recipe * recipe = ObjectStoreWrapper::getByIdRaw<Recipe>(recipeIds.at(ii));
+                  if (!recipe) {
+                     qCDebug(Logging::recipe) <<
+                        Q_FUNC_INFO << "Recipe #" << recipeIds.at(ii) << "deleted during recalculation";
+                     continue;
+                  }
+                  if (recipe->calcGeneration() != calcGenerations.at(ii)) {
+                     // The recipe changed, and recalculated itself, after we took its snapshot
+                     qCDebug(Logging::recipe) <<
+                        Q_FUNC_INFO << "Recipe #" << recipeIds.at(ii) << "changed during recalculation";
+                     continue;
+                  }
+                  recipe->setCalculatedValues(results.at(ii));
+                  RecipeCalculationCache::store(recipeIds.at(ii), inputFingerprints.at(ii), results.at(ii));
+                  ++numPublished;
+               }
+
+               qCInfo(Logging::recipe) <<
+                  Q_FUNC_INFO << "Job" << thisJob << "updated" << numPublished << "of" << recipeIds.size() << "recipes";
+               emit ObjectStoreTyped<Recipe>::getInstance().signalObjectsChangedInBulk();
+               Diagnostics::recordSignalEmitted("Recipe", "signalObjectsChangedInBulk");
+               return;
+            },
+            Qt::QueuedConnection
+         );
+         return;
+      }
+   ));
+
+   return;
+}
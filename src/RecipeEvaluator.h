@@ -0,0 +1,340 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * RecipeEvaluator.h is part of Brewtarget, and is copyright the following authors 2024:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#ifndef RECIPEEVALUATOR_H
+#define RECIPEEVALUATOR_H
+#pragma once
+
+#include <optional>
+#include <span>
+
+#include <QHash>
+#include <QList>
+#include <QVector>
+
+#include "model/Fermentable.h"
+#include "model/Hop.h"
+#include "model/Recipe.h"
+#include "model/RecipeAddition.h"
+
+class Boil;
+class Equipment;
+class RecipeAdditionHop;
+
+/**
+ * \brief Side-effect-free calculation of a \c Recipe's derived values (OG, FG, IBU, color etc).
+ *
+ *        The functions here work on a \c Snapshot, which is a copy of just those bits of a \c Recipe, its additions,
+ *        \c Equipment, \c Boil and \c Mash that go into the calculations.  Once a snapshot is taken, nothing here
+ *        touches any \c NamedEntity object, the \c ObjectStore or the database, and no signals are emitted, so it is
+ *        safe to evaluate lots of variants of a recipe (eg sweeping batch size, efficiency or hop timings) in
+ *        parallel.
+ *
+ *        These are also the functions that \c Recipe itself uses to calculate its derived values, so the results are
+ *        the same as you would get by changing the \c Recipe.
+ */
+namespace RecipeEvaluator {
+
+   struct FermentableAdditionInputs {
+      Fermentable::Type     type;
+      RecipeAddition::Stage stage;
+      bool                  amountIsWeight;
+      double                quantity;
+      bool                  addAfterBoil;
+      double                equivSucrose_kg;
+      bool                  isSugar;
+      bool                  isExtract;
+      bool                  isFermentableSugar;
+      double                color_srm;
+      std::optional<double> ibuGalPerLb;
+   };
+
+   /**
+    * \brief The fermentable additions of a recipe, stored as parallel arrays (one entry per addition in each) rather
+    *        than as one struct per addition.  Each array holds just the contribution of each addition to one of the
+    *        totals in \c GrainBillTotals (which is zero if the addition doesn't count towards that total), so that all
+    *        the totals can be worked out in one tight, branch-free loop.  See \c grainBillTotals.
+    */
+   struct GrainBill {
+      //! Weight of each addition that is grain measured by weight, otherwise 0
+      QVector<double> grain_kg;
+      //! As \c grain_kg, but only for grain added in the mash
+      QVector<double> grainInMash_kg;
+      //! Volume of wort added by extracts and sugars
+      QVector<double> addedVolume_l;
+      //! Color times weight, for additions measured by weight
+      QVector<double> colorWeight_srmKg;
+      //! Hopped extract IBUs times weight, for additions measured by weight
+      QVector<double> hoppedExtractWeight_ibuGalPerLbKg;
+      //! Equivalent sucrose of additions that are affected by mash efficiency
+      QVector<double> sugar_kg;
+      //! Equivalent sucrose of additions (sugars and extracts) that are not affected by mash efficiency
+      QVector<double> sugarIgnoreEfficiency_kg;
+      //! As \c sugar_kg, but only for additions after the boil
+      QVector<double> lateSugar_kg;
+      //! As \c sugarIgnoreEfficiency_kg, but only for additions after the boil
+      QVector<double> lateSugarIgnoreEfficiency_kg;
+      //! Equivalent sucrose of additions that are not fermentable (eg lactose)
+      QVector<double> nonFermentableSugar_kg;
+
+      void append(FermentableAdditionInputs const & fermentableAddition);
+      void reserve(int const size);
+      int size() const;
+   };
+
+   /**
+    * \brief Everything we need to know about a recipe's fermentables for its calculations.  Apart from the color and
+    *        hopped extract totals, which need to be divided by a volume, these are the final values.
+    */
+   struct GrainBillTotals {
+      double         grains_kg;
+      double         grainsInMash_kg;
+      double         addedVolume_l;
+      double         colorWeight_srmKg;
+      double         hoppedExtractWeight_ibuGalPerLbKg;
+      Recipe::Sugars sugars;
+   };
+
+   //! \brief Work out all the totals for the supplied grain bill in one pass
+   GrainBillTotals grainBillTotals(GrainBill const & grainBill);
+
+   struct HopAdditionInputs {
+      double                    alpha_pct;
+      double                    quantity;
+      std::optional<double>     addAtTime_mins;
+      bool                      isFirstWort;
+      RecipeAddition::Stage     stage;
+      std::optional<Hop::Form>  form;
+
+      bool operator==(HopAdditionInputs const & other) const = default;
+   };
+
+   struct YeastAdditionInputs {
+      std::optional<double> additionAttenuation_pct;
+      double                yeastAttenuationTypical_pct;
+   };
+
+   struct EquipmentInputs {
+      std::optional<double> mashTunGrainAbsorption_LKg;
+      double                lauteringDeadspaceLoss_l;
+      std::optional<double> topUpKettle_l;
+      std::optional<double> topUpWater_l;
+      double                kettleTrubChillerLoss_l;
+      std::optional<double> boilTime_min;
+      std::optional<double> kettleEvaporationPerHour_l;
+      std::optional<double> hopUtilization_pct;
+      std::optional<double> kettleInternalDiameter_cm;
+      std::optional<double> kettleOpeningDiameter_cm;
+
+      bool operator==(EquipmentInputs const & other) const = default;
+   };
+
+   struct BoilInputs {
+      std::optional<double> preBoilSize_l;
+      double                boilTime_mins;
+      std::optional<double> coolTime_mins;
+
+      bool operator==(BoilInputs const & other) const = default;
+   };
+
+   /**
+    * \brief Everything about a \c Recipe that goes into calculating its derived values
+    */
+   struct Snapshot {
+      double                             batchSize_l;
+      double                             efficiency_pct;
+      std::optional<EquipmentInputs>     equipment;
+      std::optional<BoilInputs>          boil;
+      //! Total water added in the mash, or \c std::nullopt if there is no mash
+      std::optional<double>              mashTotalWater_l;
+      GrainBill                          grainBill;
+      //! Worked out from \c grainBill when the snapshot is taken, so it's done once however many calculations use it
+      GrainBillTotals                    grainBillTotals;
+      QVector<HopAdditionInputs>         hopAdditions;
+      QVector<YeastAdditionInputs>       yeastAdditions;
+   };
+
+   /**
+    * \brief Changes to apply to a \c Snapshot before evaluating it.  Anything not set is left as it is in the snapshot.
+    */
+   struct Overrides {
+      std::optional<double> batchSize_l    = std::nullopt;
+      std::optional<double> efficiency_pct = std::nullopt;
+      //! New addition times, keyed by index in \c Snapshot::hopAdditions
+      QHash<int, double>    hopAdditionTimes_mins = {};
+   };
+
+   struct Grains {
+      double grains_kg;
+      double grainsInMash_kg;
+   };
+
+   struct VolumeEstimates {
+      double wortFromMash_l;
+      double boilVolume_l;
+      double finalVolume_l;
+      //! Final volume before any losses out of the kettle, used in calculations for sg/ibu/etc.
+      double finalVolumeNoLosses_l;
+      double postBoilVolume_l;
+   };
+
+   struct Gravities {
+      double og;
+      double fg;
+      double og_fermentable;
+      double fg_fermentable;
+   };
+
+   /**
+    * \brief All the derived values for one snapshot
+    */
+   struct Results {
+      Grains          grains;
+      VolumeEstimates volumes;
+      Gravities       gravities;
+      double          color_srm;
+      double          ABV_pct;
+      double          boilGrav;
+      double          IBU;
+      //! IBUs of each hop addition, in the same order as \c Snapshot::hopAdditions
+      QList<double>   ibusByHopAddition;
+      double          caloriesPerLiter;
+   };
+
+   /**
+    * \brief Take a snapshot of the supplied \c Recipe.  This reads the recipe's additions, equipment etc, so it needs
+    *        to be called from the thread that owns them (ie normally the GUI thread).
+    */
+   Snapshot snapshotOf(Recipe & recipe);
+
+   //! \brief Take a snapshot of a single hop addition
+   HopAdditionInputs snapshotOf(RecipeAdditionHop const & hopAddition);
+   //! \brief Take a snapshot of just the bits of an \c Equipment that a \c Recipe's calculations use
+   EquipmentInputs   snapshotOf(Equipment const & equipment);
+   //! \brief Take a snapshot of just the bits of a \c Boil that a \c Recipe's calculations use
+   BoilInputs        snapshotOf(Boil const & boil);
+
+   /**
+    * \brief Increment this whenever a change to the calculations here could give different results from the same
+    *        inputs, so that values stored by \c RecipeCalculationCache in an earlier run get recalculated.
+    */
+   extern int const formulaVersion;
+
+   /**
+    * \brief Fingerprint of everything that goes into evaluating \c snapshot: the snapshot itself, the calculation
+    *        settings (IBU and color formulae, first wort and mash hop adjustments) and \c formulaVersion.  If two
+    *        fingerprints are the same, \c evaluate will (barring hash collisions) give the same results for both.
+    *
+    *        Unlike \c NamedEntity::fingerprint, this mixes in the exact bit pattern of \c double values, as the tiniest
+    *        change to an input can change the results.  Must be called on the GUI thread, as it reads the settings.
+    */
+   std::size_t inputFingerprint(Snapshot const & snapshot);
+
+   //=========================================== Individual calculations ============================================
+   // These are listed in dependency order -- ie each only needs the results of ones above it.
+
+   Grains          grains         (Snapshot const & snapshot);
+   VolumeEstimates volumeEstimates(Snapshot const & snapshot, Grains const & grains);
+   double          color_srm      (Snapshot const & snapshot, VolumeEstimates const & volumes);
+   Recipe::Sugars  sugars         (Snapshot const & snapshot);
+   //! Proportion of the sugars not affected by mash efficiency that gets past the lauter and trub/chiller losses
+   double          sugarRetention (Snapshot const & snapshot, VolumeEstimates const & volumes);
+   Gravities       gravities      (Snapshot const & snapshot, VolumeEstimates const & volumes);
+   double          ABV_pct        (Gravities const & gravities);
+   double          boilGrav       (Snapshot const & snapshot);
+
+   /**
+    * \brief IBUs from a single hop addition
+    *
+    * \param og The recipe's original gravity.  (See comment in the implementation about why we use this rather than
+    *           boil gravity.)
+    */
+   double ibuFromHopAddition(HopAdditionInputs const & hopAddition,
+                             std::optional<EquipmentInputs> const & equipment,
+                             std::optional<BoilInputs> const & boil,
+                             double const og,
+                             double const finalVolumeNoLosses_l);
+
+   /**
+    * \brief IBUs from each of a number of hop additions that share the same equipment, boil, OG and volume.  This
+    *        gives the same answers as calling \c ibuFromHopAddition for each one, but runs the IBU formula for all of
+    *        them in one go (see \c IbuMethods::getIbus).
+    *
+    * \param ibus Must be the same size as \c hopAdditions
+    */
+   void ibusFromHopAdditions(std::span<HopAdditionInputs const> const hopAdditions,
+                             std::optional<EquipmentInputs> const & equipment,
+                             std::optional<BoilInputs> const & boil,
+                             double const og,
+                             double const finalVolumeNoLosses_l,
+                             std::span<double> const ibus);
+
+   /**
+    * \brief IBUs from hopped extracts (ie fermentables with \c ibuGalPerLb set)
+    */
+   double hoppedExtractIbus(Snapshot const & snapshot);
+
+   /**
+    * \brief Total IBUs from all the hop additions and any hopped extracts
+    *
+    * \param ibusByHopAddition If not \c nullptr, this is filled with the IBUs of each hop addition, in the same order
+    *                          as \c Snapshot::hopAdditions
+    */
+   double IBU(Snapshot const & snapshot,
+              double const og,
+              VolumeEstimates const & volumes,
+              QList<double> * ibusByHopAddition = nullptr);
+
+   double caloriesPerLiter(Gravities const & gravities);
+
+   //============================================== Whole evaluations ===============================================
+
+   /**
+    * \brief Calculate all the derived values for the supplied snapshot, with the supplied overrides applied
+    */
+   Results evaluate(Snapshot const & snapshot, Overrides const & overrides = Overrides{});
+
+   /**
+    * \brief Evaluate lots of variants of a snapshot, spreading the work across all available cores.  This blocks until
+    *        all the variants have been evaluated.
+    *
+    * \return Results in the same order as \c variants
+    */
+   QVector<Results> evaluateAll(Snapshot const & snapshot, QVector<Overrides> const & variants);
+
+   /**
+    * \brief Evaluate lots of snapshots (typically of different recipes), spreading the work across all available cores.
+    *        This blocks until all the snapshots have been evaluated.
+    *
+    * \return Results in the same order as \c snapshots
+    */
+   QVector<Results> evaluateEach(QVector<Snapshot> const & snapshots);
+
+   /**
+    * \brief Recalculate every \c Recipe in the object store in the background, eg because a setting that affects the
+    *        calculations (IBU formula, color formula, hop adjustments) has changed.
+    *
+    *        The recipes are snapshotted straight away (so this must be called on the GUI thread), evaluated on the
+    *        global thread pool, and the results are then stored back in the recipes in one go on the GUI thread.
+    *        Rather than every recipe emitting a \c changed() signal for each calculated value, we then emit
+    *        \c ObjectStore::signalObjectsChangedInBulk once for the \c Recipe store.
+    *
+    *        Any recipe that gets modified (and therefore recalculates itself) while this is running is left alone, as
+    *        are any results from a previous call that is overtaken by a later one.
+    */
+   void recalculateAllRecipes();
+}
+
+#endif
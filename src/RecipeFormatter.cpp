@@ -22,10 +22,18 @@
  ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
 #include "RecipeFormatter.h"
 
+#include <cstdint>
+#include <optional>
+
+#include <QAbstractTextDocumentLayout>
 #include <QClipboard>
 #include <QDebug>
+#include <QHash>
 #include <QHBoxLayout>
 #include <QObject>
+#include <QPainter>
+#include <QPair>
+#include <QPdfWriter>
 #include <QPrinter>
 #include <QPushButton>
 #include <QStringList>
@@ -33,6 +41,7 @@
 #include <QTextDocument>
 #include <QVBoxLayout>
 
+#include "database/ObjectStoreTyped.h"
 #include "Html.h"
 #include "Localization.h"
 #include "MainWindow.h"
@@ -56,6 +65,9 @@
 #include "model/Water.h"
 #include "model/Yeast.h"
 #include "PersistentSettings.h"
+#include "ReportTemplate.h"
+#include "utils/Fingerprint.h"
+#include "utils/ParallelRender.h"
 
 namespace {
    //! Get the maximum number of characters in a list of strings.
@@ -142,6 +154,101 @@ namespace {
       return sorted;
    }
 
+   /**
+    * \brief Returns a value that changes whenever anything shown in the HTML view of \c recipe might have changed, so
+    *        we can tell when a cached copy of that view is out of date.  We mix in the change count (see
+    *        \c NamedEntity::changeCount) and address of the recipe and of everything it contains (so that adding or
+    *        removing, say, a hop addition also changes the result), along with the recipe's calculation generation and
+    *        the display settings generation.
+    */
+   std::size_t contentStamp(Recipe & recipe) {
+      std::size_t stamp = Measurement::displaySettingsGeneration();
+      stamp = Utils::fingerprintMix(stamp, recipe.calcGeneration());
+      auto mix = [&stamp](NamedEntity const * entity) {
+         if (entity) {
+            stamp = Utils::fingerprintMix(stamp, reinterpret_cast<std::uintptr_t>(entity));
+            stamp = Utils::fingerprintMix(stamp, entity->changeCount());
+         }
+         return;
+      };
+      auto mixAdditions = [&mix](auto const & additions) {
+         for (auto const & addition : additions) {
+            mix(addition.get());
+            mix(addition->ingredient().get());
+         }
+         return;
+      };
+
+      mix(&recipe);
+      mix(recipe.style().get());
+      mix(recipe.equipment().get());
+      mixAdditions(recipe.fermentableAdditions());
+      mixAdditions(recipe.hopAdditions());
+      mixAdditions(recipe.miscAdditions());
+      mixAdditions(recipe.yeastAdditions());
+      if (auto mash = recipe.mash()) {
+         mix(mash.get());
+         for (auto const & mashStep : mash->mashSteps()) {
+            mix(mashStep.get());
+         }
+      }
+      for (Instruction const * instruction : recipe.instructions()) {
+         mix(instruction);
+      }
+      for (BrewNote const * brewNote : recipe.brewNotes()) {
+         mix(brewNote);
+      }
+      return stamp;
+   }
+
+   //! Below this many recipes, \c RecipeFormatter::getHtmlFormat formats them all on the calling thread
+   constexpr int minRecipesForParallelFormatting = 2;
+
+   //! Formatting a recipe is expensive enough that it's worth making each one a separate job
+   constexpr int recipesPerFormattingJob = 1;
+
+   //! Same as the default margins in \c PrintAndPreviewDialog
+   constexpr double recipeBookMargins_pt = 20.0;
+
+   //
+   // Helpers for the tooltip templates (see RecipeFormatter::getToolTip)
+   //
+
+   //! The default text for a tooltip template, given the template for the rows of its table
+   QString toolTipText(QString const & rows) {
+      return "<html><head><style type=\"text/css\">{{css::/css/tooltip.css}}</style></head>"
+             "<body><div id=\"headerdiv\"><table id=\"tooltip\">" + rows + "</table></body></html>";
+   }
+
+   /**
+    * \brief Binding for a translated label.  The text needs to be marked with \c QT_TRANSLATE_NOOP so that it gets
+    *        picked up for translation.  We translate when rendering, rather than when creating the template, so that
+    *        a change of language takes effect straight away.
+    */
+   ReportTemplate::Binding label(char const * const sourceText) {
+      return [sourceText](NamedEntity const &) { return RecipeFormatter::tr(sourceText); };
+   }
+
+   std::function<QString(QVariant const &)> amount(Measurement::Unit const & unit, int const precision = 3) {
+      return [&unit, precision](QVariant const & value) {
+         return Measurement::displayAmount(Measurement::Amount{value.toDouble(), unit}, precision);
+      };
+   }
+
+   std::function<QString(QVariant const &)> quantity(int const precision) {
+      return [precision](QVariant const & value) { return Measurement::displayQuantity(value.toDouble(), precision); };
+   }
+
+   //! Same as the \c QString::arg(double) default format
+   QString number(QVariant const & value) {
+      return QString::number(value.toDouble());
+   }
+
+   //! Label and value cells for an optional entry in a tooltip table
+   QString cells(QString const & label, QString const & value) {
+      return QString("<td class=\"left\">%1</td><td class=\"value\">%2</td>").arg(label, value);
+   }
+
 }
 
 
@@ -236,6 +343,70 @@ public:
       return pDoc;
    }
 
+   /**
+    * \brief Everything in the HTML view of the current recipe apart from the header and footer.  The multi-recipe view
+    *        includes the brewing instructions, the single-recipe one does not.
+    */
+   QString buildRecipeBodyHtml(bool const withInstructions) {
+      QString body = this->buildStatTableHtml();
+      body += this->buildFermentableTableHtml();
+      body += this->buildHopsTableHtml();
+      body += this->buildMiscTableHtml();
+      body += this->buildYeastTableHtml();
+      body += this->buildMashTableHtml();
+      body += this->buildNotesHtml();
+      if (withInstructions) {
+         body += this->buildInstructionTableHtml();
+      }
+      body += this->buildBrewNotesHtml();
+      return body;
+   }
+
+   /**
+    * \return What \c buildRecipeBodyHtml previously gave for \c recipe, if the recipe has not changed since (see
+    *         \c contentStamp)
+    */
+   std::optional<QString> cachedBodyHtml(Recipe const & recipe,
+                                         bool const withInstructions,
+                                         std::size_t const stamp) const {
+      auto const cached = this->bodyHtmlCache.constFind(QPair<int, bool>{recipe.key(), withInstructions});
+      if (cached == this->bodyHtmlCache.cend() || cached->stamp != stamp) {
+         return std::nullopt;
+      }
+      return cached->html;
+   }
+
+   void cacheBodyHtml(Recipe const & recipe,
+                      bool const withInstructions,
+                      std::size_t const stamp,
+                      QString const & html) {
+      // Recipes that have not yet been stored in the DB don't have a unique key, so we can't cache for them
+      if (recipe.key() > 0) {
+         this->bodyHtmlCache.insert(QPair<int, bool>{recipe.key(), withInstructions}, CachedBodyHtml{stamp, html});
+      }
+      return;
+   }
+
+   /**
+    * \brief Cached version of \c buildRecipeBodyHtml for the current recipe
+    */
+   QString recipeBodyHtml(bool const withInstructions) {
+      if (!this->rec) {
+         return this->buildRecipeBodyHtml(withInstructions);
+      }
+      // Make sure any pending calculations are done before we take the stamp, as otherwise formatting the recipe would
+      // do them and leave us with an out-of-date stamp.
+      this->rec->og();
+      std::size_t const stamp = contentStamp(*this->rec);
+      std::optional<QString> cached = this->cachedBodyHtml(*this->rec, withInstructions, stamp);
+      if (cached) {
+         return *cached;
+      }
+      QString html = this->buildRecipeBodyHtml(withInstructions);
+      this->cacheBodyHtml(*this->rec, withInstructions, stamp, html);
+      return html;
+   }
+
    QString getTextSeparator() {
       if (this->textSeparator.get() != nullptr) {
          return *this->textSeparator;
@@ -1074,6 +1245,14 @@ public:
    std::unique_ptr<QString> textSeparator;
    Recipe* rec;
 
+   struct CachedBodyHtml {
+      std::size_t stamp;
+      QString html;
+   };
+
+   //! Output of \c buildRecipeBodyHtml, indexed by recipe key and whether instructions are included
+   QHash<QPair<int, bool>, CachedBodyHtml> bodyHtmlCache;
+
 };
 
 
@@ -1095,8 +1274,6 @@ void RecipeFormatter::setRecipe(Recipe* recipe) {
 
 
 QString RecipeFormatter::getHtmlFormat(QList<Recipe*> recipes) {
-   Recipe *current = this->pimpl->rec;
-
    QString hDoc = this->pimpl->buildHtmlHeader();
 
    // build a toc -- why do I do this to myself?
@@ -1106,41 +1283,146 @@ QString RecipeFormatter::getHtmlFormat(QList<Recipe*> recipes) {
    }
    hDoc += "</ul>";
 
-   foreach (Recipe* foo, recipes) {
-      this->pimpl->rec = foo;
-      hDoc += QString("<a name=\"%1\"></a>").arg(foo->name());
-      hDoc += this->pimpl->buildStatTableHtml();
-      hDoc += this->pimpl->buildFermentableTableHtml();
-      hDoc += this->pimpl->buildHopsTableHtml();
-      hDoc += this->pimpl->buildMiscTableHtml();
-      hDoc += this->pimpl->buildYeastTableHtml();
-      hDoc += this->pimpl->buildMashTableHtml();
-      hDoc += this->pimpl->buildNotesHtml();
-      hDoc += this->pimpl->buildInstructionTableHtml();
-      hDoc += this->pimpl->buildBrewNotesHtml();
+   //
+   // Formatting a recipe only reads it, so, for recipes we don't already have cached output for, we can do it on
+   // several threads at once.  As with exports (see ImportExport::exportToFile), this is only safe if nothing is going
+   // to be created or calculated on first access while we do so, so we take care of that up front.  Each job gets its
+   // own impl, as impl holds the "current" recipe.
+   //
+   QList<Recipe *> recipesToFormat;
+   QList<std::size_t> stamps;
+   QList<QString> bodies;
+   bool hydrated = false;
+   for (Recipe * recipe : recipes) {
+      std::size_t stamp = contentStamp(*recipe);
+      std::optional<QString> cached = this->pimpl->cachedBodyHtml(*recipe, true, stamp);
+      if (!cached) {
+         if (!hydrated) {
+            HydrateAllObjectStores();
+            hydrated = true;
+         }
+         // Asking for any calculated value is enough to make sure they have all been calculated.  Since this might
+         // redo some calculations, the stamp needs to be taken again afterwards.
+         recipe->og();
+         stamp = contentStamp(*recipe);
+         recipesToFormat.append(recipe);
+      }
+      stamps.append(stamp);
+      bodies.append(cached.value_or(QString{}));
+   }
+
+   QList<QString> formatted;
+   ParallelRender::renderAndWrite(
+      recipesToFormat,
+      [](Recipe * recipe) {
+         impl formatter;
+         formatter.rec = recipe;
+         return std::optional<QString>{formatter.buildRecipeBodyHtml(true)};
+      },
+      [&formatted](QString const & body) {
+         formatted.append(body);
+         return;
+      },
+      minRecipesForParallelFormatting,
+      recipesPerFormattingJob
+   );
+
+   for (int ii = 0, jj = 0; ii < recipes.size(); ++ii) {
+      Recipe * recipe = recipes.at(ii);
+      if (jj < recipesToFormat.size() && recipesToFormat.at(jj) == recipe) {
+         bodies[ii] = formatted.at(jj);
+         this->pimpl->cacheBodyHtml(*recipe, true, stamps.at(ii), bodies.at(ii));
+         ++jj;
+      }
+      hDoc += QString("<a name=\"%1\"></a>").arg(recipe->name());
+      hDoc += bodies.at(ii);
       hDoc += "<p></p>";
    }
    hDoc += this->pimpl->buildHtmlFooter();
 
-   this->pimpl->rec = current;
    return hDoc;
 }
 
 QString RecipeFormatter::getHtmlFormat() {
    QString pDoc = this->pimpl->buildHtmlHeader();
-   pDoc += this->pimpl->buildStatTableHtml();
-   pDoc += this->pimpl->buildFermentableTableHtml();
-   pDoc += this->pimpl->buildHopsTableHtml();
-   pDoc += this->pimpl->buildMiscTableHtml();
-   pDoc += this->pimpl->buildYeastTableHtml();
-   pDoc += this->pimpl->buildMashTableHtml();
-   pDoc += this->pimpl->buildNotesHtml();
-   pDoc += this->pimpl->buildBrewNotesHtml();
+   pDoc += this->pimpl->recipeBodyHtml(false);
    pDoc += this->pimpl->buildHtmlFooter();
 
    return pDoc;
 }
 
+bool RecipeFormatter::exportRecipeBookToPdf(QList<Recipe*> recipes,
+                                            QString const & fileName,
+                                            QPageSize const & pageSize) {
+   // Same preparation as for getHtmlFormat(QList<Recipe*>) -- see comments there
+   HydrateAllObjectStores();
+   for (Recipe * recipe : recipes) {
+      recipe->og();
+   }
+
+   QPdfWriter writer{fileName};
+   writer.setPageSize(pageSize);
+   writer.setPageMargins(QMarginsF{recipeBookMargins_pt,
+                                   recipeBookMargins_pt,
+                                   recipeBookMargins_pt,
+                                   recipeBookMargins_pt},
+                         QPageLayout::Point);
+   QPainter painter;
+   if (!painter.begin(&writer)) {
+      qWarning() << Q_FUNC_INFO << "Unable to start writing PDF to" << fileName;
+      return false;
+   }
+
+   // The paintable area of each page, in device units
+   QSizeF const pageArea{static_cast<double>(writer.width()), static_cast<double>(writer.height())};
+   QString const header = this->pimpl->buildHtmlHeader();
+   QString const footer = this->pimpl->buildHtmlFooter();
+   bool onFirstPage = true;
+   bool const succeeded = ParallelRender::renderAndWrite(
+      recipes,
+      [this, &header, &footer](Recipe * recipe) {
+         //
+         // Reading the cache from several threads is fine as nothing writes to it until we're done.  We don't add to
+         // the cache here though, as the point is not to hold the whole book in memory.
+         //
+         std::optional<QString> body = this->pimpl->cachedBodyHtml(*recipe, true, contentStamp(*recipe));
+         if (!body) {
+            impl formatter;
+            formatter.rec = recipe;
+            body = formatter.buildRecipeBodyHtml(true);
+         }
+         return std::optional<QString>{header + *body + footer};
+      },
+      [&writer, &painter, &pageArea, &onFirstPage](QString const & html) {
+         QTextDocument document;
+         document.setHtml(html);
+         // Lay the document out for the PDF's resolution and page size, rather than the screen's
+         document.documentLayout()->setPaintDevice(&writer);
+         document.setPageSize(pageArea);
+         for (int pageNum = 0; pageNum < document.pageCount(); ++pageNum) {
+            if (!onFirstPage) {
+               writer.newPage();
+            }
+            onFirstPage = false;
+            QRectF const pageRect{QPointF{0.0, pageNum * pageArea.height()}, pageArea};
+            painter.save();
+            painter.translate(0.0, -pageRect.top());
+            document.drawContents(&painter, pageRect);
+            painter.restore();
+         }
+         return;
+      },
+      minRecipesForParallelFormatting,
+      recipesPerFormattingJob
+   );
+
+   painter.end();
+   if (!succeeded) {
+      qWarning() << Q_FUNC_INFO << "Error formatting recipes for" << fileName;
+   }
+   return succeeded;
+}
+
 QString RecipeFormatter::buildHtmlHeader() {
    return this->pimpl->buildHtmlHeader();
 }
@@ -1208,43 +1490,42 @@ QString RecipeFormatter::getToolTip(Recipe* rec) {
       return "";
    }
 
-   auto style = rec->style();
-
-   // Do the style sheet first
-   QString header = "<html><head><style type=\"text/css\">";
-   header += Html::getCss(":/css/tooltip.css");
-   header += "</style></head>";
-
-   QString body   = "<body>";
-   //body += QString("<h1>%1</h1>").arg(rec->getName()());
-   body += QString("<div id=\"headerdiv\">");
-   body += QString("<table id=\"tooltip\">");
-   body += QString("<caption>%1 (%2%3)</caption>")
-         .arg( style ? style->name() : tr("unknown style"))
-         .arg( style ? style->categoryNumber() : tr("N/A") )
-         .arg( style ? style->styleLetter() : "" );
-
-   // Third row: OG and FG
-   body += QString("<tr><td class=\"left\">%1</td><td class=\"value\">%2</td>")
-           .arg(tr("OG"))
-           .arg(Measurement::displayAmount(Measurement::Amount{rec->og(), Measurement::Units::specificGravity}, 3));
-   body += QString("<td class=\"left\">%1</td><td class=\"value\">%2</td></tr>")
-           .arg(tr("FG"))
-           .arg(Measurement::displayAmount(Measurement::Amount{rec->fg(), Measurement::Units::specificGravity}, 3));
-
-   // Fourth row: Color and Bitterness.
-   body += QString("<tr><td class=\"left\">%1</td><td class=\"value\">%2 (%3)</td>")
-           .arg(tr("Color"))
-           .arg(Measurement::displayAmount(Measurement::Amount{rec->color_srm(), Measurement::Units::srm}, 1))
-           .arg(ColorMethods::colorFormulaName());
-   body += QString("<td class=\"left\">%1</td><td class=\"value\">%2 (%3)</td></tr>")
-           .arg(tr("IBU"))
-           .arg(Measurement::displayQuantity(rec->IBU(), 1))
-           .arg(IbuMethods::ibuFormulaName() );
-
-   body += "</table></body></html>";
-
-   return header + body;
+   static ReportTemplate const toolTipTemplate{
+      ReportTemplate::textFor(
+         "tooltip-recipe.html",
+         toolTipText(
+            "<caption>{{style}}</caption>"
+            // Third row: OG and FG
+            "<tr><td class=\"left\">{{ogLabel}}</td><td class=\"value\">{{og}}</td>"
+            "<td class=\"left\">{{fgLabel}}</td><td class=\"value\">{{fg}}</td></tr>"
+            // Fourth row: Color and Bitterness.
+            "<tr><td class=\"left\">{{colorLabel}}</td><td class=\"value\">{{color}} ({{colorFormula}})</td>"
+            "<td class=\"left\">{{ibuLabel}}</td><td class=\"value\">{{ibu}} ({{ibuFormula}})</td></tr>"
+         )
+      ),
+      {
+         {"style", [](NamedEntity const & entity) {
+            auto style = static_cast<Recipe const &>(entity).style();
+            return QString("%1 (%2%3)").arg(style ? style->name()           : tr("unknown style"),
+                                            style ? style->categoryNumber() : tr("N/A"),
+                                            style ? style->styleLetter()    : "");
+         }},
+         {"ogLabel"     , label(QT_TRANSLATE_NOOP("RecipeFormatter", "OG"   ))},
+         {"og"          , ReportTemplate::property(PropertyNames::Recipe::og,
+                                                   amount(Measurement::Units::specificGravity, 3))},
+         {"fgLabel"     , label(QT_TRANSLATE_NOOP("RecipeFormatter", "FG"   ))},
+         {"fg"          , ReportTemplate::property(PropertyNames::Recipe::fg,
+                                                   amount(Measurement::Units::specificGravity, 3))},
+         {"colorLabel"  , label(QT_TRANSLATE_NOOP("RecipeFormatter", "Color"))},
+         {"color"       , ReportTemplate::property(PropertyNames::Recipe::color_srm,
+                                                   amount(Measurement::Units::srm, 1))},
+         {"colorFormula", [](NamedEntity const &) { return ColorMethods::colorFormulaName(); }},
+         {"ibuLabel"    , label(QT_TRANSLATE_NOOP("RecipeFormatter", "IBU"  ))},
+         {"ibu"         , ReportTemplate::property(PropertyNames::Recipe::IBU, quantity(1))},
+         {"ibuFormula"  , [](NamedEntity const &) { return IbuMethods::ibuFormulaName(); }},
+      }
+   };
+   return toolTipTemplate.render(*rec);
 }
 
 QString RecipeFormatter::getToolTip(Style* style) {
@@ -1252,38 +1533,35 @@ QString RecipeFormatter::getToolTip(Style* style) {
       return "";
    }
 
-   // Do the style sheet first
-   QString header = "<html><head><style type=\"text/css\">";
-   header += Html::getCss(":/css/tooltip.css");
-   header += "</style></head>";
-
-   QString body   = "<body>";
-
-   body += QString("<div id=\"headerdiv\">");
-   body += QString("<table id=\"tooltip\">");
-   body += QString("<caption>%1</caption>")
-         .arg( style->name() );
-
-   // First row -- category and number (letter)
-   body += QString("<tr><td class=\"left\">%1</td><td class=\"value\">%2</td>")
-           .arg(tr("Category"))
-           .arg(style->category());
-   body += QString("<td class=\"left\">%1</td><td class=\"value\">%2%3</td></tr>")
-           .arg(tr("Code"))
-           .arg(style->categoryNumber())
-           .arg(style->styleLetter());
-
-   // Second row: guide and type
-   body += QString("<tr><td class=\"left\">%1</td><td class=\"value\">%2</td>")
-           .arg(tr("Guide"))
-           .arg(style->styleGuide());
-   body += QString("<td class=\"left\">%1</td><td class=\"value\">%2</td></tr>")
-           .arg(tr("Type"))
-           .arg(Style::typeDisplayNames[style->type()]);
-
-   body += "</table></body></html>";
-
-   return header + body;
+   static ReportTemplate const toolTipTemplate{
+      ReportTemplate::textFor(
+         "tooltip-style.html",
+         toolTipText(
+            "<caption>{{name}}</caption>"
+            // First row -- category and number (letter)
+            "<tr><td class=\"left\">{{categoryLabel}}</td><td class=\"value\">{{category}}</td>"
+            "<td class=\"left\">{{codeLabel}}</td><td class=\"value\">{{categoryNumber}}{{styleLetter}}</td></tr>"
+            // Second row: guide and type
+            "<tr><td class=\"left\">{{guideLabel}}</td><td class=\"value\">{{guide}}</td>"
+            "<td class=\"left\">{{typeLabel}}</td><td class=\"value\">{{type}}</td></tr>"
+         )
+      ),
+      {
+         {"name"          , ReportTemplate::property(PropertyNames::NamedEntity::name    )},
+         {"categoryLabel" , label(QT_TRANSLATE_NOOP("RecipeFormatter", "Category"))},
+         {"category"      , ReportTemplate::property(PropertyNames::Style::category      )},
+         {"codeLabel"     , label(QT_TRANSLATE_NOOP("RecipeFormatter", "Code"    ))},
+         {"categoryNumber", ReportTemplate::property(PropertyNames::Style::categoryNumber)},
+         {"styleLetter"   , ReportTemplate::property(PropertyNames::Style::styleLetter   )},
+         {"guideLabel"    , label(QT_TRANSLATE_NOOP("RecipeFormatter", "Guide"   ))},
+         {"guide"         , ReportTemplate::property(PropertyNames::Style::styleGuide    )},
+         {"typeLabel"     , label(QT_TRANSLATE_NOOP("RecipeFormatter", "Type"    ))},
+         {"type"          , [](NamedEntity const & entity) {
+            return Style::typeDisplayNames[static_cast<Style const &>(entity).type()];
+         }},
+      }
+   };
+   return toolTipTemplate.render(*style);
 }
 
 QString RecipeFormatter::getToolTip(Equipment* kit) {
@@ -1291,29 +1569,32 @@ QString RecipeFormatter::getToolTip(Equipment* kit) {
       return "";
    }
 
-   // Do the style sheet first
-   QString header = "<html><head><style type=\"text/css\">";
-   header += Html::getCss(":/css/tooltip.css");
-   header += "</style></head>";
-
-   QString body   = "<body>";
-
-   body += QString("<div id=\"headerdiv\">");
-   body += QString("<table id=\"tooltip\">");
-   body += QString("<caption>%1</caption>")
-         .arg( kit->name() );
-
-   // First row -- batchsize and boil time
-   body += QString("<tr><td class=\"left\">%1</td><td class=\"value\">%2</td>")
-           .arg(tr("Preboil"))
-           .arg(Measurement::displayAmount(Measurement::Amount{kit->kettleBoilSize_l(), Measurement::Units::liters}) );
-   body += QString("<td class=\"left\">%1</td><td class=\"value\">%2</td></tr>")
-           .arg(tr("BoilTime"))
-           .arg(Measurement::displayAmount(Measurement::Amount{kit->boilTime_min().value_or(Equipment::default_boilTime_mins), Measurement::Units::minutes}) );
-
-   body += "</table></body></html>";
-
-   return header + body;
+   static ReportTemplate const toolTipTemplate{
+      ReportTemplate::textFor(
+         "tooltip-equipment.html",
+         toolTipText(
+            "<caption>{{name}}</caption>"
+            // First row -- batchsize and boil time
+            "<tr><td class=\"left\">{{preboilLabel}}</td><td class=\"value\">{{preboil}}</td>"
+            "<td class=\"left\">{{boilTimeLabel}}</td><td class=\"value\">{{boilTime}}</td></tr>"
+         )
+      ),
+      {
+         {"name"         , ReportTemplate::property(PropertyNames::NamedEntity::name)},
+         {"preboilLabel" , label(QT_TRANSLATE_NOOP("RecipeFormatter", "Preboil" ))},
+         {"preboil"      , ReportTemplate::property(PropertyNames::Equipment::kettleBoilSize_l,
+                                                    amount(Measurement::Units::liters))},
+         {"boilTimeLabel", label(QT_TRANSLATE_NOOP("RecipeFormatter", "BoilTime"))},
+         {"boilTime"     , [](NamedEntity const & entity) {
+            auto const & equipment = static_cast<Equipment const &>(entity);
+            return Measurement::displayAmount(
+               Measurement::Amount{equipment.boilTime_min().value_or(Equipment::default_boilTime_mins),
+                                   Measurement::Units::minutes}
+            );
+         }},
+      }
+   };
+   return toolTipTemplate.render(*kit);
 }
 
 // Once we do inventory, this needs to be fixed to show amount on hand
@@ -1322,38 +1603,36 @@ QString RecipeFormatter::getToolTip(Fermentable* fermentable) {
       return "";
    }
 
-   // Do the style sheet first
-   QString header = "<html><head><style type=\"text/css\">";
-   header += Html::getCss(":/css/tooltip.css");
-   header += "</style></head>";
-
-   QString body   = "<body>";
-
-   body += QString("<div id=\"headerdiv\">");
-   body += QString("<table id=\"tooltip\">");
-   body += QString("<caption>%1</caption>")
-         .arg( fermentable->name() );
-
-   // First row -- type and color
-   body += QString("<tr><td class=\"left\">%1</td><td class=\"value\">%2</td>")
-           .arg(tr("Type"))
-           .arg(Fermentable::typeDisplayNames[fermentable->type()]);
-   body += QString("<td class=\"left\">%1</td><td class=\"value\">%2</td></tr>")
-           .arg(tr("Color"))
-           .arg(Measurement::displayAmount(Measurement::Amount{fermentable->color_srm(), Measurement::Units::srm}, 1));
-   // Second row -- isMashed and yield?
-//   body += QString("<tr><td class=\"left\">%1</td><td class=\"value\">%2</td>")
-//           .arg(tr("Mashed"))
-//           .arg( fermentable->stage() == RecipeAddition::Stage::Mash ? tr("Yes") : tr("No") );
-   body += QString("<tr><td class=\"left\">.</td><td class=\"value\">.</td>");
-   auto const yield = fermentable->fineGrindYield_pct();
-   body += QString("<td class=\"left\">%1</td><td class=\"value\">%2</td></tr>")
-           .arg(tr("Extract Yield Dry Basis Fine Grind (DBFG)"))
-           .arg(yield ? Measurement::displayQuantity(*yield, 3) : "?");
-
-   body += "</table></body></html>";
-
-   return header + body;
+   static ReportTemplate const toolTipTemplate{
+      ReportTemplate::textFor(
+         "tooltip-fermentable.html",
+         toolTipText(
+            "<caption>{{name}}</caption>"
+            // First row -- type and color
+            "<tr><td class=\"left\">{{typeLabel}}</td><td class=\"value\">{{type}}</td>"
+            "<td class=\"left\">{{colorLabel}}</td><td class=\"value\">{{color}}</td></tr>"
+            // Second row -- yield
+            "<tr><td class=\"left\">.</td><td class=\"value\">.</td>"
+            "<td class=\"left\">{{yieldLabel}}</td><td class=\"value\">{{yield}}</td></tr>"
+         )
+      ),
+      {
+         {"name"      , ReportTemplate::property(PropertyNames::NamedEntity::name)},
+         {"typeLabel" , label(QT_TRANSLATE_NOOP("RecipeFormatter", "Type" ))},
+         {"type"      , [](NamedEntity const & entity) {
+            return Fermentable::typeDisplayNames[static_cast<Fermentable const &>(entity).type()];
+         }},
+         {"colorLabel", label(QT_TRANSLATE_NOOP("RecipeFormatter", "Color"))},
+         {"color"     , ReportTemplate::property(PropertyNames::Fermentable::color_srm,
+                                                 amount(Measurement::Units::srm, 1))},
+         {"yieldLabel", label(QT_TRANSLATE_NOOP("RecipeFormatter", "Extract Yield Dry Basis Fine Grind (DBFG)"))},
+         {"yield"     , [](NamedEntity const & entity) {
+            auto const yield = static_cast<Fermentable const &>(entity).fineGrindYield_pct();
+            return yield ? Measurement::displayQuantity(*yield, 3) : "?";
+         }},
+      }
+   };
+   return toolTipTemplate.render(*fermentable);
 }
 
 QString RecipeFormatter::getToolTip(Hop* hop) {
@@ -1361,45 +1640,39 @@ QString RecipeFormatter::getToolTip(Hop* hop) {
       return "";
    }
 
-   // Do the style sheet first
-   QString header = "<html><head><style type=\"text/css\">";
-   header += Html::getCss(":/css/tooltip.css");
-   header += "</style></head>";
-
-   QString body   = "<body>";
-
-   body += QString("<div id=\"headerdiv\">");
-   body += QString("<table id=\"tooltip\">");
-   body += QString("<caption>%1</caption>")
-         .arg( hop->name() );
-
-   // First row -- alpha and beta
-   body += QString("<tr><td class=\"left\">%1</td><td class=\"value\">%2</td>")
-           .arg(tr("Alpha"))
-           .arg(Measurement::displayQuantity(hop->alpha_pct(), 3));
-   if (hop->beta_pct()) {
-      body += QString("<td class=\"left\">%1</td><td class=\"value\">%2</td>")
-            .arg(tr("Beta"))
-            .arg(Measurement::displayQuantity(*hop->beta_pct(), 3));
-   }
-   body += QString("</tr>");
-
-   // Second row -- form and type
-   body += QString("<tr>");
-   if (hop->form()) {
-      body += QString("<tr><td class=\"left\">%1</td><td class=\"value\">%2</td>")
-            .arg(tr("Form"))
-            .arg(Hop::formDisplayNames[*hop->form()]);
-   }
-   if (hop->type()) {
-      body += QString("<td class=\"left\">%1</td><td class=\"value\">%2</td></tr>")
-            .arg(tr("Type"))
-            .arg(Hop::typeDisplayNames[*hop->type()]);
-   }
-   body += QString("</tr>");
-   body += "</table></body></html>";
-
-   return header + body;
+   //
+   // Beta, form and type are all optional, so each of those cells is only shown if the hop has a value for it
+   //
+   static ReportTemplate const toolTipTemplate{
+      ReportTemplate::textFor(
+         "tooltip-hop.html",
+         toolTipText(
+            "<caption>{{name}}</caption>"
+            // First row -- alpha and beta
+            "<tr><td class=\"left\">{{alphaLabel}}</td><td class=\"value\">{{alpha}}</td>{{betaCells}}</tr>"
+            // Second row -- form and type
+            "<tr>{{formCells}}{{typeCells}}</tr>"
+         )
+      ),
+      {
+         {"name"      , ReportTemplate::property(PropertyNames::NamedEntity::name)},
+         {"alphaLabel", label(QT_TRANSLATE_NOOP("RecipeFormatter", "Alpha"))},
+         {"alpha"     , ReportTemplate::property(PropertyNames::Hop::alpha_pct, quantity(3))},
+         {"betaCells" , [](NamedEntity const & entity) {
+            auto const beta_pct = static_cast<Hop const &>(entity).beta_pct();
+            return beta_pct ? cells(tr("Beta"), Measurement::displayQuantity(*beta_pct, 3)) : QString{};
+         }},
+         {"formCells" , [](NamedEntity const & entity) {
+            auto const form = static_cast<Hop const &>(entity).form();
+            return form ? cells(tr("Form"), Hop::formDisplayNames[*form]) : QString{};
+         }},
+         {"typeCells" , [](NamedEntity const & entity) {
+            auto const type = static_cast<Hop const &>(entity).type();
+            return type ? cells(tr("Type"), Hop::typeDisplayNames[*type]) : QString{};
+         }},
+      }
+   };
+   return toolTipTemplate.render(*hop);
 }
 
 QString RecipeFormatter::getToolTip(Misc* misc) {
@@ -1407,28 +1680,24 @@ QString RecipeFormatter::getToolTip(Misc* misc) {
       return "";
    }
 
-   // Do the style sheet first
-   QString header = "<html><head><style type=\"text/css\">";
-   header += Html::getCss(":/css/tooltip.css");
-   header += "</style></head>";
-
-   QString body   = "<body>";
-
-   body += QString("<div id=\"headerdiv\">");
-   body += QString("<table id=\"tooltip\">");
-   body += QString("<caption>%1</caption>")
-         .arg( misc->name() );
-   // First row -- type and use
-   body += QString("<tr><td class=\"left\">%1</td><td class=\"value\">%2</td>")
-           .arg(tr("Type"))
-           .arg(Misc::typeDisplayNames[misc->type()]);
-///   body += QString("<td class=\"left\">%1</td><td class=\"value\">%2</td></tr>")
-///           .arg(tr("Use"))
-///           .arg(Misc::useDisplayNames[misc->use()]);
-
-   body += "</table></body></html>";
-
-   return header + body;
+   static ReportTemplate const toolTipTemplate{
+      ReportTemplate::textFor(
+         "tooltip-misc.html",
+         toolTipText(
+            "<caption>{{name}}</caption>"
+            // First row -- type
+            "<tr><td class=\"left\">{{typeLabel}}</td><td class=\"value\">{{type}}</td></tr>"
+         )
+      ),
+      {
+         {"name"     , ReportTemplate::property(PropertyNames::NamedEntity::name)},
+         {"typeLabel", label(QT_TRANSLATE_NOOP("RecipeFormatter", "Type"))},
+         {"type"     , [](NamedEntity const & entity) {
+            return Misc::typeDisplayNames[static_cast<Misc const &>(entity).type()];
+         }},
+      }
+   };
+   return toolTipTemplate.render(*misc);
 }
 
 QString RecipeFormatter::getToolTip(Yeast* yeast) {
@@ -1436,45 +1705,45 @@ QString RecipeFormatter::getToolTip(Yeast* yeast) {
       return "";
    }
 
-   // Do the style sheet first
-   QString header = "<html><head><style type=\"text/css\">";
-   header += Html::getCss(":/css/tooltip.css");
-   header += "</style></head>";
-
-   QString body   = "<body>";
-
-   body += QString("<div id=\"headerdiv\">");
-   body += QString("<table id=\"tooltip\">");
-   body += QString("<caption>%1</caption>")
-         .arg( yeast->name() );
-
-   // First row -- type and form
-   body += QString("<tr><td class=\"left\">%1</td><td class=\"value\">%2</td>")
-           .arg(tr("Type"))
-           .arg(Yeast::typeDisplayNames[yeast->type()]);
-   body += QString("<td class=\"left\">%1</td><td class=\"value\">%2</td></tr>")
-           .arg(tr("Form"))
-           .arg(Yeast::formDisplayNames[yeast->form()]);
-   // Second row -- lab and attenuation
-   body += QString("<tr><td class=\"left\">%1</td><td class=\"value\">%2</td>")
-           .arg(tr("Lab"))
-           .arg(yeast->laboratory());
-   body += QString("<td class=\"left\">%1</td><td class=\"value\">%2 %</td></tr>")
-           .arg(tr("Attenuation"))
-           .arg(Measurement::displayQuantity(yeast->attenuationTypical_pct(), 0));
-
-   // Third row -- prod id and flocculation
-   body += QString("<tr><td class=\"left\">%1</td><td class=\"value\">%2</td>")
-           .arg(tr("Id"))
-           .arg(yeast->productId());
-   body += QString("<td class=\"left\">%1</td><td class=\"value\">%2</td></tr>")
-           .arg(tr("Flocculation"))
-           .arg(Yeast::flocculationDisplayNames[yeast->flocculation()]);
-
-
-   body += "</table></body></html>";
-
-   return header + body;
+   static ReportTemplate const toolTipTemplate{
+      ReportTemplate::textFor(
+         "tooltip-yeast.html",
+         toolTipText(
+            "<caption>{{name}}</caption>"
+            // First row -- type and form
+            "<tr><td class=\"left\">{{typeLabel}}</td><td class=\"value\">{{type}}</td>"
+            "<td class=\"left\">{{formLabel}}</td><td class=\"value\">{{form}}</td></tr>"
+            // Second row -- lab and attenuation
+            "<tr><td class=\"left\">{{labLabel}}</td><td class=\"value\">{{lab}}</td>"
+            "<td class=\"left\">{{attenuationLabel}}</td><td class=\"value\">{{attenuation}} %</td></tr>"
+            // Third row -- prod id and flocculation
+            "<tr><td class=\"left\">{{idLabel}}</td><td class=\"value\">{{id}}</td>"
+            "<td class=\"left\">{{flocculationLabel}}</td><td class=\"value\">{{flocculation}}</td></tr>"
+         )
+      ),
+      {
+         {"name"             , ReportTemplate::property(PropertyNames::NamedEntity::name)},
+         {"typeLabel"        , label(QT_TRANSLATE_NOOP("RecipeFormatter", "Type"        ))},
+         {"type"             , [](NamedEntity const & entity) {
+            return Yeast::typeDisplayNames[static_cast<Yeast const &>(entity).type()];
+         }},
+         {"formLabel"        , label(QT_TRANSLATE_NOOP("RecipeFormatter", "Form"        ))},
+         {"form"             , [](NamedEntity const & entity) {
+            return Yeast::formDisplayNames[static_cast<Yeast const &>(entity).form()];
+         }},
+         {"labLabel"         , label(QT_TRANSLATE_NOOP("RecipeFormatter", "Lab"         ))},
+         {"lab"              , ReportTemplate::property(PropertyNames::Yeast::laboratory)},
+         {"attenuationLabel" , label(QT_TRANSLATE_NOOP("RecipeFormatter", "Attenuation" ))},
+         {"attenuation"      , ReportTemplate::property(PropertyNames::Yeast::attenuationTypical_pct, quantity(0))},
+         {"idLabel"          , label(QT_TRANSLATE_NOOP("RecipeFormatter", "Id"          ))},
+         {"id"               , ReportTemplate::property(PropertyNames::Yeast::productId)},
+         {"flocculationLabel", label(QT_TRANSLATE_NOOP("RecipeFormatter", "Flocculation"))},
+         {"flocculation"     , [](NamedEntity const & entity) {
+            return Yeast::flocculationDisplayNames[static_cast<Yeast const &>(entity).flocculation()];
+         }},
+      }
+   };
+   return toolTipTemplate.render(*yeast);
 }
 
 QString RecipeFormatter::getToolTip(Water* water) {
@@ -1482,44 +1751,39 @@ QString RecipeFormatter::getToolTip(Water* water) {
       return "";
    }
 
-   // Do the style sheet first
-   QString header = "<html><head><style type=\"text/css\">";
-   header += Html::getCss(":/css/tooltip.css");
-   header += "</style></head>";
-
-   QString body   = "<body>";
-
-   body += QString("<div id=\"headerdiv\">");
-   body += QString("<table id=\"tooltip\">");
-   body += QString("<caption>%1</caption>")
-         .arg( water->name() );
-
-   // First row -- Ca and Mg
-   body += QString("<tr><td class=\"left\">%1</td><td class=\"value\">%2</td>")
-           .arg(tr("Ca"))
-           .arg(water->calcium_ppm());
-   body += QString("<td class=\"left\">%1</td><td class=\"value\">%2</td></tr>")
-           .arg(tr("Mg"))
-           .arg(water->magnesium_ppm());
-   // Second row -- SO4 and Na
-   body += QString("<tr><td class=\"left\">%1</td><td class=\"value\">%2</td>")
-           .arg(tr("SO<sub>4</sub>"))
-           .arg(water->sulfate_ppm());
-   body += QString("<td class=\"left\">%1</td><td class=\"value\">%2</td></tr>")
-           .arg(tr("Na"))
-           .arg(water->sodium_ppm());
-   // third row -- Cl and HCO3
-   body += QString("<tr><td class=\"left\">%1</td><td class=\"value\">%2</td>")
-           .arg(tr("Cl"))
-           .arg(water->chloride_ppm());
-   body += QString("<td class=\"left\">%1</td><td class=\"value\">%2</td></tr>")
-           .arg(tr("HCO<sub>3</sub>"))
-           .arg( water->bicarbonate_ppm());
-
-
-   body += "</table></body></html>";
-
-   return header + body;
+   static ReportTemplate const toolTipTemplate{
+      ReportTemplate::textFor(
+         "tooltip-water.html",
+         toolTipText(
+            "<caption>{{name}}</caption>"
+            // First row -- Ca and Mg
+            "<tr><td class=\"left\">{{caLabel}}</td><td class=\"value\">{{ca}}</td>"
+            "<td class=\"left\">{{mgLabel}}</td><td class=\"value\">{{mg}}</td></tr>"
+            // Second row -- SO4 and Na
+            "<tr><td class=\"left\">{{so4Label}}</td><td class=\"value\">{{so4}}</td>"
+            "<td class=\"left\">{{naLabel}}</td><td class=\"value\">{{na}}</td></tr>"
+            // third row -- Cl and HCO3
+            "<tr><td class=\"left\">{{clLabel}}</td><td class=\"value\">{{cl}}</td>"
+            "<td class=\"left\">{{hco3Label}}</td><td class=\"value\">{{hco3}}</td></tr>"
+         )
+      ),
+      {
+         {"name"     , ReportTemplate::property(PropertyNames::NamedEntity::name)},
+         {"caLabel"  , label(QT_TRANSLATE_NOOP("RecipeFormatter", "Ca"              ))},
+         {"ca"       , ReportTemplate::property(PropertyNames::Water::calcium_ppm    , number)},
+         {"mgLabel"  , label(QT_TRANSLATE_NOOP("RecipeFormatter", "Mg"              ))},
+         {"mg"       , ReportTemplate::property(PropertyNames::Water::magnesium_ppm  , number)},
+         {"so4Label" , label(QT_TRANSLATE_NOOP("RecipeFormatter", "SO<sub>4</sub>"  ))},
+         {"so4"      , ReportTemplate::property(PropertyNames::Water::sulfate_ppm    , number)},
+         {"naLabel"  , label(QT_TRANSLATE_NOOP("RecipeFormatter", "Na"              ))},
+         {"na"       , ReportTemplate::property(PropertyNames::Water::sodium_ppm     , number)},
+         {"clLabel"  , label(QT_TRANSLATE_NOOP("RecipeFormatter", "Cl"              ))},
+         {"cl"       , ReportTemplate::property(PropertyNames::Water::chloride_ppm   , number)},
+         {"hco3Label", label(QT_TRANSLATE_NOOP("RecipeFormatter", "HCO<sub>3</sub>" ))},
+         {"hco3"     , ReportTemplate::property(PropertyNames::Water::bicarbonate_ppm, number)},
+      }
+   };
+   return toolTipTemplate.render(*water);
 }
 
 void RecipeFormatter::toTextClipboard() {
@@ -25,6 +25,8 @@
 
 #include <QList>
 #include <QObject>
+#include <QPageSize>
+#include <QString>
 
 #include "model/Recipe.h"
 
@@ -58,6 +60,19 @@ public:
    QString buildHtmlHeader();
    QString buildHtmlFooter();
 
+   /**
+    * \brief Write a "recipe book" of \c recipes, each starting on a new page, to the PDF file \c fileName.
+    *
+    *        Unlike printing the output of \c getHtmlFormat(QList<Recipe*>), this does not build the whole book as one
+    *        document.  Recipes are formatted (several at a time, on other threads) and then laid out and written to the
+    *        PDF one at a time, so memory use does not depend on the number of recipes.
+    *
+    * \return \c true if the file was written successfully, \c false otherwise
+    */
+   bool exportRecipeBookToPdf(QList<Recipe*> recipes,
+                              QString const & fileName,
+                              QPageSize const & pageSize = QPageSize{QPageSize::A4});
+
    //! Get a BBCode view. Why is this here?
    QString getBBCodeFormat();
 
@@ -0,0 +1,170 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * RecipeScaling.cpp is part of Brewtarget, and is copyright the following authors 2024:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#include "RecipeScaling.h"
+
+#include "database/Database.h"
+#include "database/DbTransaction.h"
+#include "Logging.h"
+#include "model/Boil.h"
+#include "model/Equipment.h"
+#include "model/Fermentable.h"
+#include "model/Mash.h"
+#include "model/MashStep.h"
+#include "model/NamedEntity.h"
+#include "model/Recipe.h"
+#include "model/RecipeAdditionFermentable.h"
+#include "model/RecipeAdditionHop.h"
+#include "model/RecipeAdditionMisc.h"
+#include "model/RecipeUseOfWater.h"
+
+namespace {
+   /**
+    * \brief Apply \c plan without starting a transaction or batch of our own, and without the final recalculation
+    */
+   void applyChanges(Recipe & recipe, RecipeScaling::Plan const & plan) {
+      recipe.setEquipment(plan.equipment);
+      recipe.setBatchSize_l(plan.batchSize_l);
+      recipe.nonOptBoil()->setPreBoilSize_l(plan.preBoilSize_l);
+      recipe.setEfficiency_pct(plan.efficiency_pct);
+      if (plan.boilTime_mins && recipe.boil()) {
+         recipe.boil()->setBoilTime_mins(*plan.boilTime_mins);
+      }
+
+      for (auto const & [fermentableAddition, quantity] : plan.fermentableQuantities) {
+         fermentableAddition->setQuantity(quantity);
+      }
+      for (auto const & [hopAddition, quantity] : plan.hopQuantities) {
+         hopAddition->setQuantity(quantity);
+      }
+      for (auto const & [miscAddition, quantity] : plan.miscQuantities) {
+         miscAddition->setQuantity(quantity);
+      }
+      for (auto const & [waterUse, volume_l] : plan.waterVolumes_l) {
+         waterUse->setVolume_l(volume_l);
+      }
+
+      auto mash = recipe.mash();
+      if (mash) {
+         // Reset all these to zero so that the user will know to re-run the mash wizard.
+         for (auto step : mash->mashSteps()) {
+            step->setAmount_l(0);
+         }
+      }
+      return;
+   }
+
+   /**
+    * \brief Apply each plan to its recipe with calculations turned off, then recalculate each recipe once
+    */
+   void applyAll(QList<std::pair<Recipe *, RecipeScaling::Plan>> const & plans, QString const & nameForLogging) {
+      // Views only need to hear about each changed property once, after everything is done
+      NamedEntityChangeBatch changeBatch;
+
+      Database & database = Database::instance();
+      QSqlDatabase connection = database.sqlDatabase();
+      DbTransaction dbTransaction{database, connection, nameForLogging};
+
+      for (auto const & [recipe, plan] : plans) {
+         //
+         // Every change we make would otherwise trigger a recalculation (usually of almost everything), so we turn
+         // calculations off while we make them and then do all the calculations once at the end.
+         //
+         bool const calcsWereEnabled = recipe->calcsEnabled();
+         recipe->setCalcsEnabled(false);
+         applyChanges(*recipe, plan);
+         recipe->setCalcsEnabled(calcsWereEnabled);
+         if (calcsWereEnabled) {
+            recipe->recalcAll();
+         }
+      }
+
+      dbTransaction.commit();
+      return;
+   }
+}
+
+RecipeScaling::Plan RecipeScaling::plan(Recipe const & recipe,
+                                        std::shared_ptr<Equipment> equipment,
+                                        double newEfficiency_pct) {
+   Plan plan;
+   plan.equipment      = equipment;
+   plan.batchSize_l    = equipment->fermenterBatchSize_l();
+   plan.preBoilSize_l  = equipment->kettleBoilSize_l();
+   plan.efficiency_pct = newEfficiency_pct;
+   if (recipe.boil()) {
+      plan.boilTime_mins = equipment->boilTime_min().value_or(Equipment::default_boilTime_mins);
+   }
+
+   double const volRatio = plan.batchSize_l / recipe.batchSize_l();
+   double const effRatio = recipe.efficiency_pct() / newEfficiency_pct;
+
+   auto const fermentableAdditions = recipe.fermentableAdditions();
+   plan.fermentableQuantities.reserve(fermentableAdditions.size());
+   for (auto const & fermAddition : fermentableAdditions) {
+      // We assume volumes and masses get scaled the same way
+      // Sugars and extracts are not affected by mash efficiency
+      double const ratio = (fermAddition->fermentable()->isSugar() || fermAddition->fermentable()->isExtract()) ?
+         volRatio : effRatio * volRatio;
+      plan.fermentableQuantities.append({fermAddition, fermAddition->quantity() * ratio});
+   }
+
+   auto const hopAdditions = recipe.hopAdditions();
+   plan.hopQuantities.reserve(hopAdditions.size());
+   for (auto const & hopAddition : hopAdditions) {
+      plan.hopQuantities.append({hopAddition, hopAddition->quantity() * volRatio});
+   }
+
+   auto const miscAdditions = recipe.miscAdditions();
+   plan.miscQuantities.reserve(miscAdditions.size());
+   for (auto const & miscAddition : miscAdditions) {
+      plan.miscQuantities.append({miscAddition, miscAddition->quantity() * volRatio});
+   }
+
+   auto const waterUses = recipe.waterUses();
+   plan.waterVolumes_l.reserve(waterUses.size());
+   for (auto const & waterUse : waterUses) {
+      plan.waterVolumes_l.append({waterUse, waterUse->volume_l() * volRatio});
+   }
+
+   // TBD: For now we don't scale the yeasts, but it might be good to give the option on this if user is doing a big
+   //      scale-up or down.
+
+   return plan;
+}
+
+void RecipeScaling::apply(Recipe & recipe, Plan const & plan) {
+   qCDebug(Logging::recipe) << Q_FUNC_INFO << "Scaling" << recipe << "to" << plan.batchSize_l << "L";
+   applyAll({{&recipe, plan}}, "Scale recipe");
+   return;
+}
+
+void RecipeScaling::scale(Recipe & recipe, std::shared_ptr<Equipment> equipment, double newEfficiency_pct) {
+   RecipeScaling::apply(recipe, RecipeScaling::plan(recipe, equipment, newEfficiency_pct));
+   return;
+}
+
+void RecipeScaling::scaleAll(QList<Recipe *> const & recipes,
+                             std::shared_ptr<Equipment> equipment,
+                             double newEfficiency_pct) {
+   QList<std::pair<Recipe *, Plan>> plans;
+   plans.reserve(recipes.size());
+   for (Recipe * recipe : recipes) {
+      plans.append({recipe, RecipeScaling::plan(*recipe, equipment, newEfficiency_pct)});
+   }
+   qCDebug(Logging::recipe) << Q_FUNC_INFO << "Scaling" << plans.size() << "recipes";
+   applyAll(plans, "Scale recipes");
+   return;
+}
@@ -0,0 +1,87 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * RecipeScaling.h is part of Brewtarget, and is copyright the following authors 2024:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#ifndef RECIPESCALING_H
+#define RECIPESCALING_H
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <utility>
+
+#include <QList>
+#include <QVector>
+
+class Equipment;
+class Recipe;
+class RecipeAdditionFermentable;
+class RecipeAdditionHop;
+class RecipeAdditionMisc;
+class RecipeUseOfWater;
+
+/**
+ * \brief Scaling a \c Recipe to new \c Equipment (ie a new batch size) and/or a new mash efficiency.
+ *
+ *        Setting each of a recipe's amounts one at a time means a DB write, a \c changed() signal and (because the
+ *        ingredients feed into almost all the calculations) a recipe recalculation for every one.  Instead, we first
+ *        read everything we need into a \c Plan and work out all the new values from that, without touching the
+ *        recipe.  Then we apply the plan in one go: all the writes in one DB transaction, one recalculation and
+ *        one \c changed() signal per changed property.
+ */
+namespace RecipeScaling {
+
+   /**
+    * \brief The new values for everything in a \c Recipe that scaling changes
+    */
+   struct Plan {
+      std::shared_ptr<Equipment> equipment;
+      double                     batchSize_l;
+      double                     preBoilSize_l;
+      double                     efficiency_pct;
+      //! Only set if the recipe has a boil
+      std::optional<double>      boilTime_mins;
+      QVector<std::pair<std::shared_ptr<RecipeAdditionFermentable>, double>> fermentableQuantities;
+      QVector<std::pair<std::shared_ptr<RecipeAdditionHop        >, double>> hopQuantities;
+      QVector<std::pair<std::shared_ptr<RecipeAdditionMisc       >, double>> miscQuantities;
+      QVector<std::pair<std::shared_ptr<RecipeUseOfWater         >, double>> waterVolumes_l;
+   };
+
+   /**
+    * \brief Work out what scaling \c recipe to \c equipment and \c newEfficiency_pct would change.  This only reads
+    *        from \c recipe.
+    */
+   Plan plan(Recipe const & recipe, std::shared_ptr<Equipment> equipment, double newEfficiency_pct);
+
+   /**
+    * \brief Apply a \c Plan made by \c plan to the \c recipe it was made for.
+    *
+    *        The mash step amounts are all reset to zero, because mash temperatures don't scale simply, so the user
+    *        needs to re-run the mash wizard.
+    */
+   void apply(Recipe & recipe, Plan const & plan);
+
+   /**
+    * \brief Convenience function to \c plan and \c apply in one go
+    */
+   void scale(Recipe & recipe, std::shared_ptr<Equipment> equipment, double newEfficiency_pct);
+
+   /**
+    * \brief Scale lots of recipes (eg from a script) to the same equipment and efficiency.  All the plans are made
+    *        first, and then applied inside one DB transaction.
+    */
+   void scaleAll(QList<Recipe *> const & recipes, std::shared_ptr<Equipment> equipment, double newEfficiency_pct);
+}
+
+#endif
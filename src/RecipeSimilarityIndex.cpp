@@ -0,0 +1,395 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * RecipeSimilarityIndex.cpp is part of Brewtarget, and is copyright the following authors 2024:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#include "RecipeSimilarityIndex.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QHash>
+#include <QMetaProperty>
+#include <QSet>
+#include <QThread>
+
+#include "database/ObjectStoreWrapper.h"
+#include "Logging.h"
+#include "model/Fermentable.h"
+#include "model/Hop.h"
+#include "model/Recipe.h"
+#include "model/RecipeAdditionFermentable.h"
+#include "model/RecipeAdditionHop.h"
+#include "model/RecipeAdditionYeast.h"
+#include "model/Yeast.h"
+#include "utils/NameFilterIndex.h"
+
+namespace {
+   //
+   // Layout of the feature vector.  Each group is a contiguous block starting at the given offset.
+   //
+   int constexpr fermentableTypeOffset =  0; int constexpr numFermentableTypeFeatures =  8;
+   int constexpr fermentableNameOffset =  8; int constexpr numFermentableNameFeatures = 40;
+   int constexpr hopTimingOffset       = 48; int constexpr numHopTimingFeatures       =  4;
+   int constexpr hopNameOffset         = 52; int constexpr numHopNameFeatures         = 24;
+   int constexpr yeastTypeOffset       = 76; int constexpr numYeastTypeFeatures       = 16;
+   int constexpr derivedOffset         = 92; int constexpr numDerivedFeatures         =  5;
+   // Everything after the derived values is padding, and always 0
+   static_assert(derivedOffset + numDerivedFeatures <= RecipeSimilarityIndex::numFeatures);
+   static_assert(RecipeSimilarityIndex::numFeatures % 8 == 0);
+
+   //
+   // Relative weight of each group in the overall similarity.  These are a matter of taste, but, eg, we want two
+   // recipes with the same grain bill and hops but a different yeast to come out closer than two with the same yeast
+   // and nothing else in common.
+   //
+   float constexpr fermentableTypeWeight = 0.6f;
+   float constexpr fermentableNameWeight = 1.0f;
+   float constexpr hopTimingWeight       = 0.6f;
+   float constexpr hopNameWeight         = 0.8f;
+   float constexpr yeastTypeWeight       = 0.5f;
+   float constexpr derivedWeight         = 1.0f;
+
+   enum class HopTiming {
+      Bittering,
+      Flavour  ,
+      Aroma    ,
+      DryHop   ,
+   };
+
+   HopTiming hopTimingOf(RecipeAdditionHop const & hopAddition) {
+      switch (hopAddition.stage()) {
+         // First wort and mash hops are, in practice, bittering additions
+         case RecipeAddition::Stage::Mash        : return HopTiming::Bittering;
+         case RecipeAddition::Stage::Boil        : break;
+         case RecipeAddition::Stage::Fermentation:
+         case RecipeAddition::Stage::Packaging   : return HopTiming::DryHop;
+      }
+      double const boilTime_mins = hopAddition.addAtTime_mins().value_or(0.0);
+      if (boilTime_mins >= 45.0) {
+         return HopTiming::Bittering;
+      }
+      if (boilTime_mins >= 15.0) {
+         return HopTiming::Flavour;
+      }
+      return HopTiming::Aroma;
+   }
+
+   /**
+    * \brief Which of \c numBuckets features an ingredient name counts towards.  This is the "hashing trick": rather
+    *        than needing one feature per ingredient in the database, ingredients share a smaller number of features,
+    *        and the occasional collision just makes two recipes look slightly more alike than they are.
+    */
+   int bucketOf(QString const & name, int const numBuckets) {
+      return static_cast<int>(qHash(NameFilterIndex::fold(name)) % static_cast<uint>(numBuckets));
+   }
+
+   /**
+    * \brief Scale a group of features to have length \c weight (or leave it as all zeros if it is empty), so that,
+    *        eg, recipes with lots of hop additions don't get more say than ones with few
+    */
+   void normaliseGroup(std::span<float> const group, float const weight) {
+      float const length = std::sqrt(std::inner_product(group.begin(), group.end(), group.begin(), 0.0f));
+      if (length > 0.0f) {
+         for (float & feature : group) {
+            feature *= weight / length;
+         }
+      }
+      return;
+   }
+
+   //! We only index recipes the user can see (eg not old versions or ones that have been deleted)
+   bool isIndexable(Recipe const & recipe) {
+      return recipe.display() && !recipe.deleted();
+   }
+}
+
+// This private implementation class holds all private non-virtual members of RecipeSimilarityIndex
+class RecipeSimilarityIndex::impl {
+public:
+   impl(RecipeSimilarityIndex & self) :
+      m_self{self},
+      m_built{false},
+      m_matrix{},
+      m_recipeIdOfRow{},
+      m_rowOfRecipe{},
+      m_dirtyRecipes{},
+      m_observedRecipes{} {
+      return;
+   }
+
+   ~impl() = default;
+
+   /**
+    * \brief Index all the recipes the first time we are called, and thereafter re-index any that have changed
+    */
+   void bringUpToDate() {
+      // It's a coding error to call this other than on the GUI thread, as that's the thread that owns the recipes
+      Q_ASSERT(QThread::currentThread() == QCoreApplication::instance()->thread());
+
+      if (!this->m_built) {
+         this->m_built = true;
+         this->connectStoreSignals();
+         for (Recipe const * recipe : ObjectStoreWrapper::getAllRaw<Recipe>()) {
+            this->m_dirtyRecipes.insert(recipe->key());
+         }
+      }
+
+      if (this->m_dirtyRecipes.isEmpty()) {
+         return;
+      }
+      //
+      // Asking a recipe for its derived values can make it recalculate and emit changed(), which would mark it dirty
+      // again.  So we take the current set before we start, and anything marked during the loop just gets re-indexed on
+      // the next query.
+      //
+      QSet<int> const dirtyRecipes = std::exchange(this->m_dirtyRecipes, QSet<int>{});
+      qCDebug(Logging::recipe) << Q_FUNC_INFO << "Re-indexing" << dirtyRecipes.size() << "recipe(s)";
+      for (int const recipeId : dirtyRecipes) {
+         Recipe * recipe = ObjectStoreWrapper::getByIdRaw<Recipe>(recipeId);
+         if (!recipe || !isIndexable(*recipe)) {
+            this->removeRow(recipeId);
+            continue;
+         }
+         this->setRow(recipeId, RecipeSimilarityIndex::featuresOf(*recipe));
+         this->observe(*recipe);
+      }
+      return;
+   }
+
+   void setRow(int const recipeId, Features const & features) {
+      int row = this->m_rowOfRecipe.value(recipeId, -1);
+      if (row < 0) {
+         row = this->m_recipeIdOfRow.size();
+         this->m_recipeIdOfRow.append(recipeId);
+         this->m_rowOfRecipe.insert(recipeId, row);
+         this->m_matrix.resize(this->m_matrix.size() + numFeatures);
+      }
+      std::copy(features.cbegin(), features.cend(), this->m_matrix.begin() + row * numFeatures);
+      return;
+   }
+
+   /**
+    * \brief Remove a recipe's row by moving the last row into its place, so the matrix stays contiguous
+    */
+   void removeRow(int const recipeId) {
+      auto const existingRow = this->m_rowOfRecipe.constFind(recipeId);
+      if (existingRow == this->m_rowOfRecipe.cend()) {
+         return;
+      }
+      int const row     = *existingRow;
+      int const lastRow = this->m_recipeIdOfRow.size() - 1;
+      this->m_rowOfRecipe.remove(recipeId);
+      if (row != lastRow) {
+         int const movedRecipeId = this->m_recipeIdOfRow.at(lastRow);
+         std::copy(this->m_matrix.cbegin() + lastRow * numFeatures,
+                   this->m_matrix.cbegin() + (lastRow + 1) * numFeatures,
+                   this->m_matrix.begin() + row * numFeatures);
+         this->m_recipeIdOfRow[row] = movedRecipeId;
+         this->m_rowOfRecipe.insert(movedRecipeId, row);
+      }
+      this->m_recipeIdOfRow.removeLast();
+      this->m_matrix.resize(this->m_matrix.size() - numFeatures);
+      return;
+   }
+
+   /**
+    * \brief Mark \c recipe for re-indexing whenever it changes.  This covers changes to its additions too, because the
+    *        recipe then recalculates and emits \c changed() for its derived values.
+    */
+   void observe(Recipe const & recipe) {
+      int const recipeId = recipe.key();
+      if (this->m_observedRecipes.contains(recipeId)) {
+         return;
+      }
+      this->m_observedRecipes.insert(recipeId);
+      QObject::connect(&recipe, &NamedEntity::changed, &this->m_self, [this, recipeId](QMetaProperty, QVariant) {
+         this->m_dirtyRecipes.insert(recipeId);
+         return;
+      });
+      return;
+   }
+
+   void connectStoreSignals() {
+      auto & recipeStore = ObjectStoreTyped<Recipe>::getInstance();
+      QObject::connect(&recipeStore, &ObjectStoreTyped<Recipe>::signalObjectInserted, &this->m_self,
+                       [this](int recipeId) {
+         this->m_dirtyRecipes.insert(recipeId);
+         return;
+      });
+      QObject::connect(&recipeStore, &ObjectStoreTyped<Recipe>::signalObjectDeleted, &this->m_self,
+                       [this](int recipeId, std::shared_ptr<QObject>) {
+         this->m_dirtyRecipes.remove(recipeId);
+         this->removeRow(recipeId);
+         return;
+      });
+      QObject::connect(&recipeStore, &ObjectStoreTyped<Recipe>::signalObjectsChangedInBulk, &this->m_self, [this]() {
+         for (int const recipeId : this->m_recipeIdOfRow) {
+            this->m_dirtyRecipes.insert(recipeId);
+         }
+         return;
+      });
+      return;
+   }
+
+   //================================================ Member variables =================================================
+   RecipeSimilarityIndex & m_self;
+
+   bool m_built;
+
+   //! One row of \c numFeatures floats per recipe
+   std::vector<float> m_matrix;
+   QVector<int>       m_recipeIdOfRow;
+   QHash<int, int>    m_rowOfRecipe;
+
+   //! Recipes to (re-)index, or remove, before the next query
+   QSet<int> m_dirtyRecipes;
+   //! Recipes whose \c changed() signal we are connected to
+   QSet<int> m_observedRecipes;
+};
+
+RecipeSimilarityIndex::RecipeSimilarityIndex(QObject * parent) :
+   QObject{parent},
+   pimpl{std::make_unique<impl>(*this)} {
+   return;
+}
+
+// See https://herbsutter.com/gotw/_100/ for why we need to explicitly define the destructor here (and not in the
+// header file)
+RecipeSimilarityIndex::~RecipeSimilarityIndex() = default;
+
+QVector<RecipeSimilarityIndex::Match> RecipeSimilarityIndex::nearest(Recipe & recipe, int const k) {
+   this->pimpl->bringUpToDate();
+
+   // The recipe we're asked about might not be in the index (eg if it's an old version), which is fine
+   Features const target = RecipeSimilarityIndex::featuresOf(recipe);
+   int const targetRow = this->pimpl->m_rowOfRecipe.value(recipe.key(), -1);
+
+   int const numRows = this->pimpl->m_recipeIdOfRow.size();
+   std::vector<float> similarities(static_cast<std::size_t>(numRows));
+   float const * row = this->pimpl->m_matrix.data();
+   for (int ii = 0; ii < numRows; ++ii, row += numFeatures) {
+      similarities[ii] = RecipeSimilarityIndex::similarity(target.data(), row);
+   }
+
+   std::vector<int> rows;
+   rows.reserve(numRows);
+   for (int ii = 0; ii < numRows; ++ii) {
+      if (ii != targetRow) {
+         rows.push_back(ii);
+      }
+   }
+   int const numMatches = std::min(k, static_cast<int>(rows.size()));
+   std::partial_sort(rows.begin(), rows.begin() + numMatches, rows.end(), [&similarities](int lhs, int rhs) {
+      return similarities[lhs] > similarities[rhs];
+   });
+
+   QVector<Match> matches;
+   matches.reserve(numMatches);
+   for (int ii = 0; ii < numMatches; ++ii) {
+      matches.append(Match{this->pimpl->m_recipeIdOfRow.at(rows[ii]), similarities[rows[ii]]});
+   }
+   return matches;
+}
+
+int RecipeSimilarityIndex::size() {
+   this->pimpl->bringUpToDate();
+   return this->pimpl->m_recipeIdOfRow.size();
+}
+
+RecipeSimilarityIndex::Features RecipeSimilarityIndex::featuresOf(Recipe & recipe) {
+   Features features{};
+
+   //
+   // Grain bill.  Additions measured by volume (eg liquid extract) don't have a weight, so we use their contribution of
+   // sugar instead, which is at least in the same ballpark.
+   //
+   for (auto const & fermentableAddition : recipe.fermentableAdditions()) {
+      Fermentable const * fermentable = fermentableAddition->fermentable();
+      if (!fermentable) {
+         continue;
+      }
+      float const amount = static_cast<float>(
+         fermentableAddition->amountIsWeight() ? fermentableAddition->amount().quantity :
+                                                 fermentableAddition->equivSucrose_kg()
+      );
+      features[fermentableTypeOffset + static_cast<int>(fermentable->type()) % numFermentableTypeFeatures] += amount;
+      features[fermentableNameOffset + bucketOf(fermentable->name(), numFermentableNameFeatures)] += amount;
+   }
+
+   //
+   // Hop schedule
+   //
+   for (auto const & hopAddition : recipe.hopAdditions()) {
+      Hop const * hop = hopAddition->hop();
+      if (!hop) {
+         continue;
+      }
+      float const amount = static_cast<float>(hopAddition->amount().quantity);
+      features[hopTimingOffset + static_cast<int>(hopTimingOf(*hopAddition))] += amount;
+      features[hopNameOffset + bucketOf(hop->name(), numHopNameFeatures)] += amount;
+   }
+
+   //
+   // Yeasts
+   //
+   double attenuation_pct = Yeast::DefaultAttenuation_pct;
+   for (auto const & yeastAddition : recipe.yeastAdditions()) {
+      Yeast const * yeast = yeastAddition->yeast();
+      if (!yeast) {
+         continue;
+      }
+      features[yeastTypeOffset + static_cast<int>(yeast->type()) % numYeastTypeFeatures] += 1.0f;
+      attenuation_pct = yeastAddition->attenuation_pct().value_or(yeast->attenuationTypical_pct());
+   }
+
+   //
+   // Derived values, each scaled so that a typical beer comes out somewhere around 0.5
+   //
+   features[derivedOffset + 0] = static_cast<float>((recipe.og() - 1.0) * 10.0);
+   features[derivedOffset + 1] = static_cast<float>(recipe.IBU()       / 80.0);
+   features[derivedOffset + 2] = static_cast<float>(recipe.color_srm() / 30.0);
+   features[derivedOffset + 3] = static_cast<float>(recipe.ABV_pct()   / 10.0);
+   features[derivedOffset + 4] = static_cast<float>(attenuation_pct    / 100.0);
+
+   float * const data = features.data();
+   normaliseGroup({data + fermentableTypeOffset, numFermentableTypeFeatures}, fermentableTypeWeight);
+   normaliseGroup({data + fermentableNameOffset, numFermentableNameFeatures}, fermentableNameWeight);
+   normaliseGroup({data + hopTimingOffset      , numHopTimingFeatures      }, hopTimingWeight      );
+   normaliseGroup({data + hopNameOffset        , numHopNameFeatures        }, hopNameWeight        );
+   normaliseGroup({data + yeastTypeOffset      , numYeastTypeFeatures      }, yeastTypeWeight      );
+   normaliseGroup({data + derivedOffset        , numDerivedFeatures        }, derivedWeight        );
+   normaliseGroup(features, 1.0f);
+   return features;
+}
+
+float RecipeSimilarityIndex::similarity(float const * lhs, float const * rhs) {
+   //
+   // Keeping 8 separate running totals means there is no dependency between one multiply-add and the next, so the
+   // compiler can do each group of 8 as a single vector operation (without needing -ffast-math to let it reorder the
+   // additions).
+   //
+   std::array<float, 8> lanes{};
+   for (int ii = 0; ii < numFeatures; ii += 8) {
+      for (int jj = 0; jj < 8; ++jj) {
+         lanes[jj] += lhs[ii + jj] * rhs[ii + jj];
+      }
+   }
+   return std::accumulate(lanes.cbegin(), lanes.cend(), 0.0f);
+}
@@ -0,0 +1,95 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * RecipeSimilarityIndex.h is part of Brewtarget, and is copyright the following authors 2024:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#ifndef RECIPESIMILARITYINDEX_H
+#define RECIPESIMILARITYINDEX_H
+#pragma once
+
+#include <array>
+#include <memory> // For PImpl
+
+#include <QObject>
+#include <QVector>
+
+class Recipe;
+
+/**
+ * \brief Index for finding the recipes most like a given one ("find recipes like this one").
+ *
+ *        Each recipe is reduced to a fixed-length feature vector made up of:
+ *          - its grain bill, as the proportion of each fermentable type and (by hashing ingredient names into a fixed
+ *            number of buckets) of each fermentable;
+ *          - its hop schedule, as the proportion of hops added for bittering, flavour, aroma and dry hopping, and (again
+ *            by hashing names) of each hop;
+ *          - its yeast types;
+ *          - its derived values (OG, IBU, color, ABV and attenuation).
+ *        Each of these groups is scaled to have the same length (times a weighting), and the whole vector normalised,
+ *        so that the dot product of two vectors is the cosine similarity of the recipes, with 1 meaning identical.
+ *
+ *        The vectors are held as rows of one flat \c float matrix, so that a query is a single pass over contiguous
+ *        memory working out one dot product per recipe, followed by picking out the best \c k.  This is fast enough
+ *        for tens of thousands of recipes without needing anything cleverer.
+ *
+ *        The index is built the first time it is queried.  After that, recipes that change (ie emit \c changed()), are
+ *        added or are deleted are re-indexed the next time there is a query, so a query only pays for what has changed
+ *        since the previous one.
+ *
+ *        All calls must be made on the GUI thread, because that is the thread that owns the recipes.
+ */
+class RecipeSimilarityIndex : public QObject {
+   Q_OBJECT
+
+public:
+   /**
+    * \brief Length of the feature vector, which is padded to a multiple of 8 so that dot products can be done 8 floats
+    *        at a time
+    */
+   static int constexpr numFeatures = 104;
+
+   using Features = std::array<float, numFeatures>;
+
+   struct Match {
+      int   recipeId;
+      //! Cosine similarity, between 0 (nothing in common) and 1 (identical features)
+      float similarity;
+   };
+
+   RecipeSimilarityIndex(QObject * parent = nullptr);
+   virtual ~RecipeSimilarityIndex();
+
+   /**
+    * \return Up to \c k recipes most similar to \c recipe, most similar first.  \c recipe itself is not included.
+    */
+   QVector<Match> nearest(Recipe & recipe, int const k);
+
+   //! \return Number of recipes in the index (after bringing it up to date)
+   int size();
+
+   /**
+    * \brief Work out the (normalised) feature vector for \c recipe.  (This is non-const because asking a \c Recipe for
+    *        its derived values can cause it to recalculate them.)
+    */
+   static Features featuresOf(Recipe & recipe);
+
+   //! \return Dot product of two feature vectors, which, since they are normalised, is their cosine similarity
+   static float similarity(float const * lhs, float const * rhs);
+
+private:
+   // Private implementation details - see https://herbsutter.com/gotw/_100/
+   class impl;
+   std::unique_ptr<impl> pimpl;
+};
+
+#endif
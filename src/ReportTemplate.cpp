@@ -0,0 +1,124 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * ReportTemplate.cpp is part of Brewtarget, and is copyright the following authors 2024:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#include "ReportTemplate.h"
+
+#include <algorithm>
+
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QTextStream>
+
+#include "Html.h"
+#include "PersistentSettings.h"
+
+namespace {
+   QString const placeholderStart{"{{"};
+   QString const placeholderEnd  {"}}"};
+   QString const cssPrefix       {"css:"};
+   //! Subdirectory of the user data directory where users can put their own versions of templates
+   QString const userTemplateDir {"templates"};
+}
+
+ReportTemplate::ReportTemplate(QString const & text, QHash<QString, Binding> const & bindings) :
+   m_chunks{},
+   m_bindings{},
+   m_literalLength{0},
+   m_lastRenderedLength{0} {
+   QHash<QString, int> bindingIndexes;
+   QString literal;
+   int position = 0;
+   while (position < text.size()) {
+      int const start = text.indexOf(placeholderStart, position);
+      int const end = (start < 0) ? -1 : text.indexOf(placeholderEnd, start + placeholderStart.size());
+      if (end < 0) {
+         if (start >= 0) {
+            qWarning() << Q_FUNC_INFO << "Unterminated placeholder at position" << start << "in template";
+         }
+         literal += text.mid(position);
+         break;
+      }
+
+      literal += text.mid(position, start - position);
+      position = end + placeholderEnd.size();
+      QString const name = text.mid(start + placeholderStart.size(),
+                                    end - start - placeholderStart.size()).trimmed();
+
+      if (name.startsWith(cssPrefix)) {
+         // The style sheet is the same every time, so it just becomes part of the literal text
+         literal += Html::getCss(name.mid(cssPrefix.size()));
+         continue;
+      }
+
+      int bindingIndex = bindingIndexes.value(name, -1);
+      if (bindingIndex < 0) {
+         if (!bindings.contains(name)) {
+            qWarning() << Q_FUNC_INFO << "No binding for placeholder" << name << "in template";
+            continue;
+         }
+         bindingIndex = this->m_bindings.size();
+         this->m_bindings.append(bindings.value(name));
+         bindingIndexes.insert(name, bindingIndex);
+      }
+      this->m_literalLength += literal.size();
+      this->m_chunks.append(Chunk{literal, bindingIndex});
+      literal.clear();
+   }
+
+   if (!literal.isEmpty()) {
+      this->m_literalLength += literal.size();
+      this->m_chunks.append(Chunk{literal, -1});
+   }
+   return;
+}
+
+ReportTemplate::~ReportTemplate() = default;
+
+ReportTemplate::Binding ReportTemplate::property(PropertyPath const & propertyPath,
+                                                 std::function<QString(QVariant const &)> format) {
+   return [propertyPath, format](NamedEntity const & entity) {
+      return format(propertyPath.getValue(entity));
+   };
+}
+
+QString ReportTemplate::textFor(QString const & fileName, QString const & defaultText) {
+   QFile userTemplate{PersistentSettings::getUserDataDir().filePath(userTemplateDir + "/" + fileName)};
+   if (!userTemplate.exists()) {
+      return defaultText;
+   }
+   if (!userTemplate.open(QIODevice::ReadOnly | QIODevice::Text)) {
+      qWarning() <<
+         Q_FUNC_INFO << "Could not read" << userTemplate.fileName() << "so using built-in template instead:" <<
+         userTemplate.errorString();
+      return defaultText;
+   }
+   qInfo() << Q_FUNC_INFO << "Using template" << userTemplate.fileName();
+   QTextStream inStream{&userTemplate};
+   return inStream.readAll();
+}
+
+QString ReportTemplate::render(NamedEntity const & entity) const {
+   QString output;
+   output.reserve(std::max(this->m_literalLength, this->m_lastRenderedLength.load(std::memory_order_relaxed)));
+   for (Chunk const & chunk : this->m_chunks) {
+      output += chunk.literal;
+      if (chunk.bindingIndex >= 0) {
+         output += this->m_bindings.at(chunk.bindingIndex)(entity);
+      }
+   }
+   this->m_lastRenderedLength.store(output.size(), std::memory_order_relaxed);
+   return output;
+}
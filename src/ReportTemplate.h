@@ -0,0 +1,99 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * ReportTemplate.h is part of Brewtarget, and is copyright the following authors 2024:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#ifndef REPORTTEMPLATE_H
+#define REPORTTEMPLATE_H
+#pragma once
+
+#include <atomic>
+#include <functional>
+
+#include <QHash>
+#include <QString>
+#include <QVariant>
+#include <QVector>
+
+#include "utils/PropertyPath.h"
+
+class NamedEntity;
+
+/**
+ * \brief A simple HTML (or other text) template for reports, tooltips and the like.  The template text is parsed once,
+ *        when the \c ReportTemplate is constructed, into a list of literal chunks and placeholders, so that each
+ *        \c render just has to append those chunks and the placeholder values to a single, suitably-sized, buffer.
+ *        This is a lot cheaper than building the same text with lots of \c QString concatenation and \c arg() calls
+ *        every time.
+ *
+ *        Placeholders are written \c {{name}}.  Each name is bound, when the template is constructed, to a
+ *        \c Binding that gives the text to substitute for a given object.  Use \c property to bind to a
+ *        \c PropertyPath on the object being rendered, or supply any other callable (eg for translated labels, or
+ *        values that need more than one property).
+ *
+ *        There is also one built-in placeholder, \c {{css:resourceName}}, which is replaced, at parse time, by the
+ *        contents of the named CSS resource (see \c Html::getCss).
+ *
+ *        Users can override the built-in text of a template by putting a file of the same name in the \c templates
+ *        subdirectory of their user data directory -- see \c textFor.
+ *
+ *        Once constructed, a \c ReportTemplate can safely be rendered from several threads at once (provided, of
+ *        course, that nothing is modifying the objects being rendered).
+ */
+class ReportTemplate {
+public:
+   using Binding = std::function<QString(NamedEntity const &)>;
+
+   /**
+    * \param text The template text.  Usually the result of \c textFor.
+    * \param bindings What to substitute for each placeholder.  Placeholders without a binding are logged (once, at
+    *                 parse time) and render as empty strings.
+    */
+   ReportTemplate(QString const & text, QHash<QString, Binding> const & bindings);
+   ~ReportTemplate();
+
+   /**
+    * \brief Bind a placeholder to the value of a property (or sub-property) of the object being rendered
+    *
+    * \param format How to turn the property value into text.  By default, we use \c QVariant::toString().
+    */
+   static Binding property(PropertyPath const & propertyPath,
+                           std::function<QString(QVariant const &)> format = [](QVariant const & value) {
+                              return value.toString();
+                           });
+
+   /**
+    * \brief Returns the text of the user's own version of the template called \c fileName if there is one, or
+    *        \c defaultText otherwise.
+    */
+   static QString textFor(QString const & fileName, QString const & defaultText);
+
+   QString render(NamedEntity const & entity) const;
+
+private:
+   struct Chunk {
+      //! Literal text to output (before the placeholder, if there is one)
+      QString literal;
+      //! Index into m_bindings of the placeholder following \c literal, or -1 if there isn't one
+      int     bindingIndex;
+   };
+
+   QVector<Chunk>   m_chunks;
+   QVector<Binding> m_bindings;
+   //! Total length of all the literal text
+   int              m_literalLength;
+   //! Length of the last thing we rendered, as a guess at how much space to reserve for the next one
+   mutable std::atomic<int> m_lastRenderedLength;
+};
+
+#endif
@@ -19,45 +19,52 @@
 #include "ScaleRecipeTool.h"
 
 #include <QMessageBox>
+#include <QSignalBlocker>
 #include <QButtonGroup>
 
 #include "config.h"
 #include "database/ObjectStoreWrapper.h"
 #include "listModels/EquipmentListModel.h"
-#include "model/Boil.h"
+#include "measurement/Measurement.h"
+#include "measurement/Unit.h"
 #include "model/Equipment.h"
-#include "model/Fermentable.h"
-#include "model/Hop.h"
-#include "model/Mash.h"
-#include "model/MashStep.h"
-#include "model/Misc.h"
 #include "model/Recipe.h"
 #include "model/RecipeAdditionFermentable.h"
-#include "model/RecipeAdditionHop.h"
-#include "model/RecipeAdditionMisc.h"
-#include "model/RecipeAdditionYeast.h"
-#include "model/RecipeUseOfWater.h"
-#include "model/Water.h"
-#include "model/Yeast.h"
 #include "NamedEntitySortProxyModel.h"
 
 ScaleRecipeTool::ScaleRecipeTool(QWidget* parent) :
    QWizard(parent),
-   equipListModel(new EquipmentListModel(this)),
-   equipSortProxyModel(new NamedEntitySortProxyModel(equipListModel)) {
+   recObs{nullptr},
+   equipListModel{EquipmentListModel::shared()},
+   equipSortProxyModel(new NamedEntitySortProxyModel(equipListModel.get())),
+   targetsPage{new ScaleRecipeTargetsPage(*this)} {
+   // The proxy is ours alone, so it should go when we do, rather than when the shared list model does
+   equipSortProxyModel->setParent(this);
    addPage(new ScaleRecipeIntroPage);
    addPage(new ScaleRecipeEquipmentPage(equipSortProxyModel));
+   addPage(this->targetsPage);
    return;
 }
 
 void ScaleRecipeTool::accept() {
-   int row = field("equipComboBox").toInt();
-   QModelIndex equipProxyNdx( equipSortProxyModel->index(row, 0));
-   QModelIndex equipNdx = equipSortProxyModel->mapToSource(equipProxyNdx);
+   auto plan = this->scalingPlan();
+   if (plan) {
+      //
+      // If the user wants the grain bill adjusted, we put the solved amounts into the scaling plan, so everything
+      // still gets applied in one go.
+      //
+      if (auto const targets = this->targetsPage->targets(); targets) {
+         auto const inputs = GrainBillSolver::inputsFor(*this->recObs, *plan);
+         GrainBillSolver::applyTo(*plan, inputs, GrainBillSolver::solve(inputs, *targets));
+      }
+      RecipeScaling::apply(*this->recObs, *plan);
 
-   Equipment* selectedEquip = equipListModel->at(equipNdx.row());
-   double newEff = field("effLineEdit").toString().toDouble();
-   scale(selectedEquip, newEff);
+      // Let the user know what happened.
+      QMessageBox::information(this,
+                               tr("Recipe Scaled"),
+                               tr("The equipment and mash have been reset due to the fact that mash temperatures do "
+                                  "not scale easily. Please re-run the mash wizard."));
+   }
 
    QWizard::accept();
    return;
@@ -68,71 +75,29 @@ void ScaleRecipeTool::setRecipe(Recipe* rec) {
    return;
 }
 
-void ScaleRecipeTool::scale(Equipment* equip, double newEff) {
-   if (!this->recObs || !equip) {
-      return;
+std::optional<RecipeScaling::Plan> ScaleRecipeTool::scalingPlan() const {
+   if (!this->recObs) {
+      return std::nullopt;
    }
 
-   auto equipment = ObjectStoreWrapper::getSharedFromRaw(equip);
-
-   // Calculate volume ratio
-   double currentBatchSize_l = recObs->batchSize_l();
-   double newBatchSize_l = equipment->fermenterBatchSize_l();
-   double volRatio = newBatchSize_l / currentBatchSize_l;
-
-   // Calculate efficiency ratio
-   double oldEfficiency = recObs->efficiency_pct();
-   double effRatio = oldEfficiency / newEff;
-
-   this->recObs->setEquipment(equipment);
-   this->recObs->setBatchSize_l(newBatchSize_l);
-   this->recObs->nonOptBoil()->setPreBoilSize_l(equipment->kettleBoilSize_l());
-   this->recObs->setEfficiency_pct(newEff);
-   if (this->recObs->boil()) {
-      this->recObs->boil()->setBoilTime_mins(equipment->boilTime_min().value_or(Equipment::default_boilTime_mins));
-   }
-
-   for (auto fermAddition : this->recObs->fermentableAdditions()) {
-      // We assume volumes and masses get scaled the same way
-      if (!fermAddition->fermentable()->isSugar() && !fermAddition->fermentable()->isExtract()) {
-         fermAddition->setQuantity(fermAddition->quantity() * effRatio * volRatio);
-      } else {
-         fermAddition->setQuantity(fermAddition->quantity() * volRatio);
-      }
-   }
-
-   for (auto hopAddition : this->recObs->hopAdditions()) {
-      // We assume volumes and masses get scaled the same way
-      hopAddition->setQuantity(hopAddition->quantity() * volRatio);
-   }
-
-   for (auto miscAddition : this->recObs->miscAdditions()) {
-      // We assume volumes and masses get scaled the same way
-      miscAddition->setQuantity(miscAddition->quantity() * volRatio);
-   }
+   int row = field("equipComboBox").toInt();
+   QModelIndex equipProxyNdx( equipSortProxyModel->index(row, 0));
+   QModelIndex equipNdx = equipSortProxyModel->mapToSource(equipProxyNdx);
 
-   for (auto waterUse : this->recObs->waterUses()) {
-      waterUse->setVolume_l(waterUse->volume_l() * volRatio);
+   Equipment* selectedEquip = equipListModel->at(equipNdx.row());
+   if (!selectedEquip) {
+      return std::nullopt;
    }
+   double newEff = field("effLineEdit").toString().toDouble();
+   return RecipeScaling::plan(*this->recObs, ObjectStoreWrapper::getSharedFromRaw(selectedEquip), newEff);
+}
 
-   auto mash = this->recObs->mash();
-   if (mash) {
-      // Reset all these to zero so that the user
-      // will know to re-run the mash wizard.
-      for (auto step : mash->mashSteps()) {
-         step->setAmount_l(0);
-      }
+std::optional<GrainBillSolver::Inputs> ScaleRecipeTool::grainBillInputs() const {
+   auto const plan = this->scalingPlan();
+   if (!plan) {
+      return std::nullopt;
    }
-
-   // TBD: For now we don't scale the yeasts, but it might be good to give the option on this if user is doing a big
-   //      scale-up or down.
-
-   // Let the user know what happened.
-   QMessageBox::information(this,
-                            tr("Recipe Scaled"),
-                            tr("The equipment and mash have been reset due to the fact that mash temperatures do not "
-                               "scale easily. Please re-run the mash wizard."));
-   return;
+   return GrainBillSolver::inputsFor(*this->recObs, *plan);
 }
 
 // ScaleRecipeIntroPage =======================================================
@@ -218,3 +183,162 @@ void ScaleRecipeEquipmentPage::changeEvent(QEvent* event) {
    QWidget::changeEvent(event);
    return;
 }
+
+// ScaleRecipeTargetsPage =====================================================
+
+ScaleRecipeTargetsPage::ScaleRecipeTargetsPage(ScaleRecipeTool & tool, QWidget* parent) :
+   QWizardPage(parent),
+   m_tool{tool},
+   m_layout{new QFormLayout},
+   m_adjustCheckBox{new QCheckBox},
+   m_ogLabel{new QLabel},
+   m_ogSpinBox{new QDoubleSpinBox},
+   m_colorLabel{new QLabel},
+   m_colorSpinBox{new QDoubleSpinBox},
+   m_typeSpinBoxes{},
+   m_solutionLabel{new QLabel},
+   m_inputs{} {
+
+   this->doLayout();
+   this->retranslateUi();
+
+   connect(this->m_adjustCheckBox, &QCheckBox::toggled,                                    this,
+           &ScaleRecipeTargetsPage::updateSolution);
+   connect(this->m_ogSpinBox,      QOverload<double>::of(&QDoubleSpinBox::valueChanged), this,
+           &ScaleRecipeTargetsPage::updateSolution);
+   connect(this->m_colorSpinBox,   QOverload<double>::of(&QDoubleSpinBox::valueChanged), this,
+           &ScaleRecipeTargetsPage::updateSolution);
+   return;
+}
+
+void ScaleRecipeTargetsPage::doLayout() {
+   this->m_layout->addRow(this->m_adjustCheckBox);
+   // In each spin box, the minimum value means "no target", and is shown as such
+   this->m_layout->addRow(this->m_ogLabel, this->m_ogSpinBox);
+      this->m_ogSpinBox->setRange(1.000, 1.200);
+      this->m_ogSpinBox->setDecimals(3);
+      this->m_ogSpinBox->setSingleStep(0.001);
+   this->m_layout->addRow(this->m_colorLabel, this->m_colorSpinBox);
+      this->m_colorSpinBox->setRange(0.0, 100.0);
+      this->m_colorSpinBox->setDecimals(1);
+   this->m_layout->addRow(this->m_solutionLabel);
+      this->m_solutionLabel->setWordWrap(true);
+   this->setLayout(this->m_layout);
+   return;
+}
+
+void ScaleRecipeTargetsPage::retranslateUi() {
+   this->setTitle(tr("Grain Bill Targets"));
+   this->setSubTitle(tr("Optionally, adjust the amounts of the recipe's fermentables to hit the targets below"));
+
+   this->m_adjustCheckBox->setText(tr("Adjust grain bill"));
+   this->m_ogLabel->setText(tr("Target OG"));
+   this->m_colorLabel->setText(tr("Target Color (SRM)"));
+   for (QDoubleSpinBox * spinBox : {this->m_ogSpinBox, this->m_colorSpinBox}) {
+      spinBox->setSpecialValueText(tr("Any"));
+   }
+   for (auto const & [type, spinBox] : this->m_typeSpinBoxes) {
+      spinBox->setSpecialValueText(tr("Any"));
+      if (auto label = qobject_cast<QLabel *>(this->m_layout->labelForField(spinBox))) {
+         label->setText(tr("%1 (%)").arg(Fermentable::typeDisplayNames[type]));
+      }
+   }
+   this->updateSolution();
+   return;
+}
+
+void ScaleRecipeTargetsPage::initializePage() {
+   // The equipment and efficiency might have changed since we were last shown, so start again
+   this->m_inputs = this->m_tool.grainBillInputs();
+   for (auto const & [type, spinBox] : this->m_typeSpinBoxes) {
+      this->m_layout->removeRow(spinBox);
+   }
+   this->m_typeSpinBoxes.clear();
+   if (!this->m_inputs) {
+      this->updateSolution();
+      return;
+   }
+
+   // Start with targets that leave the grain bill as it is (after scaling), and percentages unconstrained
+   auto const current = GrainBillSolver::solve(*this->m_inputs, GrainBillSolver::Targets{});
+   QSignalBlocker const ogBlocker{this->m_ogSpinBox};
+   QSignalBlocker const colorBlocker{this->m_colorSpinBox};
+   this->m_ogSpinBox->setValue(current.og);
+   this->m_colorSpinBox->setValue(current.color_srm);
+
+   int row = this->m_layout->rowCount() - 1;
+   for (auto const & [type, percentage] : current.typePercentages) {
+      auto spinBox = new QDoubleSpinBox;
+      spinBox->setRange(-1.0, 100.0);
+      spinBox->setDecimals(1);
+      spinBox->setValue(spinBox->minimum());
+      spinBox->setToolTip(tr("Currently %1%").arg(percentage, 0, 'f', 1));
+      connect(spinBox, QOverload<double>::of(&QDoubleSpinBox::valueChanged), this,
+              &ScaleRecipeTargetsPage::updateSolution);
+      this->m_layout->insertRow(row++, new QLabel, spinBox);
+      this->m_typeSpinBoxes.append({type, spinBox});
+   }
+   this->retranslateUi();
+   return;
+}
+
+std::optional<GrainBillSolver::Targets> ScaleRecipeTargetsPage::targets() const {
+   if (!this->m_adjustCheckBox->isChecked()) {
+      return std::nullopt;
+   }
+   GrainBillSolver::Targets targets;
+   if (this->m_ogSpinBox->value() > this->m_ogSpinBox->minimum()) {
+      targets.og = this->m_ogSpinBox->value();
+   }
+   if (this->m_colorSpinBox->value() > this->m_colorSpinBox->minimum()) {
+      targets.color_srm = this->m_colorSpinBox->value();
+   }
+   for (auto const & [type, spinBox] : this->m_typeSpinBoxes) {
+      if (spinBox->value() > spinBox->minimum()) {
+         targets.typePercentages[type] = spinBox->value();
+      }
+   }
+   return targets;
+}
+
+void ScaleRecipeTargetsPage::updateSolution() {
+   bool const adjust = this->m_adjustCheckBox->isChecked();
+   this->m_ogSpinBox->setEnabled(adjust);
+   this->m_colorSpinBox->setEnabled(adjust);
+   for (auto const & [type, spinBox] : this->m_typeSpinBoxes) {
+      spinBox->setEnabled(adjust);
+   }
+
+   auto const targets = this->targets();
+   if (!this->m_inputs || !targets) {
+      this->m_solutionLabel->clear();
+      return;
+   }
+
+   auto const solution = GrainBillSolver::solve(*this->m_inputs, *targets);
+   QStringList lines;
+   for (int row = 0; row < this->m_inputs->additions.size(); ++row) {
+      Measurement::Unit const & unit =
+         this->m_inputs->amountIsWeight.at(row) ? Measurement::Units::kilograms : Measurement::Units::liters;
+      lines.append(
+         tr("%1: %2").arg(this->m_inputs->additions.at(row)->name(),
+                          Measurement::displayAmount(Measurement::Amount{solution.quantities.at(row), unit}))
+      );
+   }
+   lines.append(
+      tr("OG %1, color %2").arg(
+         Measurement::displayAmount(Measurement::Amount{solution.og, Measurement::Units::specificGravity}, 3),
+         Measurement::displayAmount(Measurement::Amount{solution.color_srm, Measurement::Units::srm}, 1)
+      )
+   );
+   this->m_solutionLabel->setText(lines.join("\n"));
+   return;
+}
+
+void ScaleRecipeTargetsPage::changeEvent(QEvent* event) {
+   if(event->type() == QEvent::LanguageChange) {
+      retranslateUi();
+   }
+   QWidget::changeEvent(event);
+   return;
+}
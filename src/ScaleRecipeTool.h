@@ -19,7 +19,13 @@
 #define SCALE_RECIPE_TOOL_H
 #pragma once
 
+#include <memory>
+#include <optional>
+#include <utility>
+
+#include <QCheckBox>
 #include <QDialog>
+#include <QDoubleSpinBox>
 #include <QWidget>
 #include <QAbstractButton>
 #include <QButtonGroup>
@@ -31,15 +37,22 @@
 #include <QComboBox>
 #include <QEvent>
 #include <QLineEdit>
+#include <QVector>
+
+#include "GrainBillSolver.h"
+#include "model/Fermentable.h"
+#include "RecipeScaling.h"
 
 // Forward declarations
 class NamedEntitySortProxyModel;
 class Equipment;
 class EquipmentListModel;
 class Recipe;
+class ScaleRecipeTargetsPage;
 
 /*!
- * \brief Wizard to scale a recipe's ingredients to match a new \c Equipment
+ * \brief Wizard to scale a recipe's ingredients to match a new \c Equipment, and optionally to adjust the grain bill
+ *        to hit target OG, color and/or fermentable percentages
  */
 class ScaleRecipeTool : public QWizard {
    Q_OBJECT
@@ -49,18 +62,22 @@ public:
    //! \brief Set the observed \c Recipe
    void setRecipe(Recipe* rec);
 
+   //! \brief Plan for scaling the observed recipe to the equipment and efficiency selected so far, if there is one
+   std::optional<RecipeScaling::Plan> scalingPlan() const;
+
+   //! \brief Inputs for solving the observed recipe's grain bill once it is scaled per \c scalingPlan
+   std::optional<GrainBillSolver::Inputs> grainBillInputs() const;
+
 private slots:
    void accept() Q_DECL_OVERRIDE;
 
 private:
 
-   //! \brief Scale the observed recipe for the new \c equip
-   void scale(Equipment* equip, double newEff);
-
    Recipe* recObs;
    QButtonGroup scaleGroup;
-   EquipmentListModel* equipListModel;
+   std::shared_ptr<EquipmentListModel> equipListModel;
    NamedEntitySortProxyModel* equipSortProxyModel;
+   ScaleRecipeTargetsPage* targetsPage;
 };
 
 class ScaleRecipeIntroPage : public QWizardPage {
@@ -107,4 +124,42 @@ private:
    QLineEdit* effLineEdit;
 };
 
+/*!
+ * \brief Optional last page of \c ScaleRecipeTool, where the user can set targets for the grain bill and see the
+ *        amounts that would give them, which are re-solved every time a target changes
+ */
+class ScaleRecipeTargetsPage : public QWizardPage {
+
+   Q_OBJECT
+
+public:
+   ScaleRecipeTargetsPage(ScaleRecipeTool & tool, QWidget* parent = nullptr);
+
+   void initializePage() override;
+
+   //! \return The targets the user has set, or \c std::nullopt if they don't want the grain bill adjusted
+   std::optional<GrainBillSolver::Targets> targets() const;
+
+public slots:
+   void doLayout();
+   void retranslateUi();
+   void updateSolution();
+
+protected:
+   virtual void changeEvent(QEvent* event);
+
+private:
+   ScaleRecipeTool & m_tool;
+   QFormLayout* m_layout;
+   QCheckBox* m_adjustCheckBox;
+   QLabel* m_ogLabel;
+   QDoubleSpinBox* m_ogSpinBox;
+   QLabel* m_colorLabel;
+   QDoubleSpinBox* m_colorSpinBox;
+   //! One row per type of fermentable in the recipe, added when the page is shown
+   QVector<std::pair<Fermentable::Type, QDoubleSpinBox*>> m_typeSpinBoxes;
+   QLabel* m_solutionLabel;
+   std::optional<GrainBillSolver::Inputs> m_inputs;
+};
+
 #endif
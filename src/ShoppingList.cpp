@@ -0,0 +1,226 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * ShoppingList.cpp is part of Brewtarget, and is copyright the following authors 2024:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#include "ShoppingList.h"
+
+#include <algorithm>
+#include <memory>
+
+#include <QDate>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QObject>
+#include <QPair>
+#include <QTextStream>
+
+#include "database/ObjectStoreWrapper.h"
+#include "Html.h"
+#include "Localization.h"
+#include "measurement/Measurement.h"
+#include "measurement/Unit.h"
+#include "model/Fermentable.h"
+#include "model/Hop.h"
+#include "model/InventoryFermentable.h"
+#include "model/InventoryHop.h"
+#include "model/InventoryMisc.h"
+#include "model/InventorySalt.h"
+#include "model/InventoryYeast.h"
+#include "model/Misc.h"
+#include "model/Recipe.h"
+#include "model/RecipeAdditionFermentable.h"
+#include "model/RecipeAdditionHop.h"
+#include "model/RecipeAdditionMisc.h"
+#include "model/RecipeAdditionYeast.h"
+#include "model/RecipeAdjustmentSalt.h"
+#include "model/Salt.h"
+#include "model/Yeast.h"
+
+namespace {
+   //! A corrupt DB could, in principle, have a loop of parents, so we don't follow them for ever
+   int constexpr maxParentDepth = 32;
+
+   //! \return The ingredient that \c ingredient was (perhaps indirectly) copied from, or \c ingredient itself
+   template<class Ingr>
+   Ingr const & masterOf(Ingr const & ingredient) {
+      NamedEntity const * master = &ingredient;
+      for (int depth = 0; depth < maxParentDepth; ++depth) {
+         NamedEntity const * parent = master->getParent();
+         if (!parent) {
+            break;
+         }
+         master = parent;
+      }
+      return static_cast<Ingr const &>(*master);
+   }
+
+   /**
+    * \brief Add an item to \c items for each (master) ingredient of type \c Ingr used in \c recipes.  We go through
+    *        the additions of all the recipes once, totalling as we go, and then look up the inventory of each
+    *        ingredient in the object store's index on \c PropertyNames::Inventory::ingredientId.
+    */
+   template<class RA, class Ingr>
+   void appendItems(QList<Recipe *> const & recipes,
+                    QList<std::shared_ptr<RA>> (Recipe::*additionsOf)() const,
+                    QVector<ShoppingList::Item> & items) {
+      int const firstItem = items.size();
+      // (Master ingredient ID, canonical unit) -> index in items
+      QHash<QPair<int, Measurement::Unit const *>, int> itemIndexes;
+      for (Recipe const * recipe : recipes) {
+         for (std::shared_ptr<RA> const & addition : (recipe->*additionsOf)()) {
+            std::shared_ptr<Ingr> const ingredient = addition->ingredient();
+            if (!ingredient) {
+               continue;
+            }
+            Ingr const & master = masterOf(*ingredient);
+            Measurement::Amount const amount = addition->amount();
+            Measurement::Amount const canonicalAmount = amount.unit->toCanonical(amount.quantity);
+            QPair<int, Measurement::Unit const *> const key{master.key(), canonicalAmount.unit};
+            auto itemIndex = itemIndexes.constFind(key);
+            if (itemIndex == itemIndexes.cend()) {
+               itemIndex = itemIndexes.insert(key, items.size());
+               items.append(ShoppingList::Item{Ingr::localisedName(),
+                                               master.key(),
+                                               master.name(),
+                                               Measurement::Amount{0.0, *canonicalAmount.unit},
+                                               Measurement::Amount{0.0, *canonicalAmount.unit}});
+            }
+            items[*itemIndex].required.quantity += canonicalAmount.quantity;
+         }
+      }
+
+      for (auto item = items.begin() + firstItem; item != items.end(); ++item) {
+         for (auto const * inventory : ObjectStoreWrapper::findByIndexRaw<typename Ingr::InventoryClass>(
+            PropertyNames::Inventory::ingredientId,
+            item->ingredientId
+         )) {
+            Measurement::Amount const amount = inventory->amount();
+            Measurement::Amount const canonicalAmount = amount.unit->toCanonical(amount.quantity);
+            // Inventory held in different units (eg by volume when the recipes use weight) doesn't help here
+            if (canonicalAmount.unit == item->inInventory.unit) {
+               item->inInventory.quantity += canonicalAmount.quantity;
+            }
+         }
+      }
+
+      std::sort(
+         items.begin() + firstItem,
+         items.end(),
+         [](ShoppingList::Item const & lhs, ShoppingList::Item const & rhs) {
+            return lhs.name.compare(rhs.name, Qt::CaseInsensitive) < 0;
+         }
+      );
+      return;
+   }
+
+   QJsonObject toJson(Measurement::Amount const & amount) {
+      return QJsonObject{{"value", amount.quantity}, {"unit", amount.unit->name}};
+   }
+}
+
+Measurement::Amount ShoppingList::Item::toBuy() const {
+   double const shortfall = this->required.quantity - this->inInventory.quantity;
+   return Measurement::Amount{std::max(0.0, shortfall), *this->required.unit};
+}
+
+QVector<ShoppingList::Item> ShoppingList::itemsFor(QList<Recipe *> const & recipes) {
+   QVector<ShoppingList::Item> items;
+   appendItems<RecipeAdditionFermentable, Fermentable>(recipes, &Recipe::fermentableAdditions, items);
+   appendItems<RecipeAdditionHop        , Hop        >(recipes, &Recipe::hopAdditions        , items);
+   appendItems<RecipeAdditionYeast      , Yeast      >(recipes, &Recipe::yeastAdditions      , items);
+   appendItems<RecipeAdditionMisc       , Misc       >(recipes, &Recipe::miscAdditions       , items);
+   appendItems<RecipeAdjustmentSalt     , Salt       >(recipes, &Recipe::saltAdjustments     , items);
+   return items;
+}
+
+void ShoppingList::writeHtml(QTextStream & out, QStringList const & recipeNames, QVector<Item> const & items) {
+   out << Html::createHeader(QObject::tr("Shopping List"), ":css/inventory.css") <<
+          QString("<h1>%1 &mdash; %2</h1>")
+             .arg(QObject::tr("Shopping List"))
+             .arg(Localization::displayDateUserFormated(QDate::currentDate()));
+   out << "<p>" << QObject::tr("For: %1").arg(recipeNames.join(", ").toHtmlEscaped()) << "</p>";
+
+   QString currentType;
+   for (Item const & item : items) {
+      if (item.ingredientType != currentType) {
+         if (!currentType.isEmpty()) {
+            out << "</table>";
+         }
+         currentType = item.ingredientType;
+         out << "<h2>" << currentType.toHtmlEscaped() << "</h2>";
+         out << QString("<table>"
+                        "<tr>"
+                        "<th align=\"left\" width=\"40%\">%1</th>"
+                        "<th align=\"left\" width=\"20%\">%2</th>"
+                        "<th align=\"left\" width=\"20%\">%3</th>"
+                        "<th align=\"left\" width=\"20%\">%4</th>"
+                        "</tr>")
+                   .arg(QObject::tr("Name"))
+                   .arg(QObject::tr("Needed"))
+                   .arg(QObject::tr("In Inventory"))
+                   .arg(QObject::tr("To Buy"));
+      }
+      out << "<tr><td>" << item.name.toHtmlEscaped() << "</td>"
+             "<td>" << Measurement::displayAmount(item.required) << "</td>"
+             "<td>" << Measurement::displayAmount(item.inInventory) << "</td>"
+             "<td>" << Measurement::displayAmount(item.toBuy()) << "</td></tr>";
+   }
+   if (!currentType.isEmpty()) {
+      out << "</table>";
+   }
+   out << Html::createFooter();
+   return;
+}
+
+void ShoppingList::writeJson(QTextStream & out, QStringList const & recipeNames, QVector<Item> const & items) {
+   //
+   // Items are grouped by ingredient type, so we can build each array in turn.  We key the arrays by the same names as
+   // BeerJSON uses for lists of ingredients.
+   //
+   QJsonObject shoppingList{{"recipes", QJsonArray::fromStringList(recipeNames)}};
+   QString currentType;
+   QJsonArray currentArray;
+   auto const finishArray = [&]() {
+      if (!currentType.isEmpty()) {
+         shoppingList.insert(currentType, currentArray);
+      }
+      currentArray = QJsonArray{};
+      return;
+   };
+   QHash<QString, QString> const arrayNames{
+      {Fermentable::localisedName(), "fermentables"             },
+      {Hop        ::localisedName(), "hop_varieties"            },
+      {Yeast      ::localisedName(), "cultures"                 },
+      {Misc       ::localisedName(), "miscellaneous_ingredients"},
+      {Salt       ::localisedName(), "salts"                    },
+   };
+   for (Item const & item : items) {
+      QString const arrayName = arrayNames.value(item.ingredientType, item.ingredientType);
+      if (arrayName != currentType) {
+         finishArray();
+         currentType = arrayName;
+      }
+      currentArray.append(QJsonObject{{"name"     , item.name                },
+                                      {"amount"   , toJson(item.required   )},
+                                      {"inventory", toJson(item.inInventory)},
+                                      {"to_buy"   , toJson(item.toBuy()    )}});
+   }
+   finishArray();
+
+   QJsonObject const root{{"beerjson", QJsonObject{{"version", 2.06}, {"shopping_list", shoppingList}}}};
+   out << QJsonDocument{root}.toJson();
+   return;
+}
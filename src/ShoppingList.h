@@ -0,0 +1,72 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * ShoppingList.h is part of Brewtarget, and is copyright the following authors 2024:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#ifndef SHOPPINGLIST_H
+#define SHOPPINGLIST_H
+#pragma once
+
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include "measurement/Amount.h"
+
+class QTextStream;
+class Recipe;
+
+/**
+ * \brief Works out what to buy to brew a set of recipes: the total of each ingredient used across all of them, less
+ *        what is already in inventory.
+ *
+ *        A recipe's ingredients can be copies of a "master" ingredient (see \c NamedEntity::getParent), so we total
+ *        amounts against the master, which is also the one whose inventory counts.
+ */
+namespace ShoppingList {
+
+   struct Item {
+      //! Localised name of the type of ingredient, eg "Hop"
+      QString             ingredientType;
+      int                 ingredientId;
+      QString             name;
+      //! Total used across all the recipes, in canonical units
+      Measurement::Amount required;
+      //! In the same units as \c required
+      Measurement::Amount inInventory;
+
+      Measurement::Amount toBuy() const;
+   };
+
+   /**
+    * \return One item for each ingredient (and kind of amount -- eg a \c Misc can be measured by weight in one recipe
+    *         and by volume in another) used in \c recipes, grouped by ingredient type and then ordered by name
+    */
+   QVector<Item> itemsFor(QList<Recipe *> const & recipes);
+
+   /**
+    * \brief Write a report of \c items, for the recipes \c recipeNames, to \c out as HTML.  Amounts are shown in the
+    *        user's preferred units.
+    */
+   void writeHtml(QTextStream & out, QStringList const & recipeNames, QVector<Item> const & items);
+
+   /**
+    * \brief Write \c items, for the recipes \c recipeNames, to \c out as JSON.  This is not part of BeerJSON, but is
+    *        laid out in the same way, with amounts as BeerJSON-style value/unit pairs in canonical units.
+    */
+   void writeJson(QTextStream & out, QStringList const & recipeNames, QVector<Item> const & items);
+
+}
+
+#endif
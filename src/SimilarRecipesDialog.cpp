@@ -0,0 +1,146 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * SimilarRecipesDialog.cpp is part of Brewtarget, and is copyright the following authors 2024:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#include "SimilarRecipesDialog.h"
+
+#include <QEvent>
+#include <QHeaderView>
+#include <QLabel>
+#include <QTreeWidget>
+#include <QTreeWidgetItem>
+#include <QVBoxLayout>
+#include <QWidget>
+
+#include "database/ObjectStoreWrapper.h"
+#include "model/Recipe.h"
+#include "model/Style.h"
+#include "RecipeSimilarityIndex.h"
+
+namespace {
+   //! How many similar recipes to show
+   int constexpr numMatchesToShow = 20;
+}
+
+// This private implementation class holds all private non-virtual members of SimilarRecipesDialog
+class SimilarRecipesDialog::impl {
+
+public:
+
+   /**
+    * Constructor
+    *
+    * As with DiagnosticsDialog, it's safe to pass in a reference to SimilarRecipesDialog from its constructor because
+    * there is nothing else in that class to initialise by the time this pimpl constructor is being called.
+    */
+   impl(SimilarRecipesDialog & similarRecipesDialog) :
+      index   {new RecipeSimilarityIndex{&similarRecipesDialog}},
+      heading {new QLabel{}},
+      matches {new QTreeWidget{}},
+      layout  {new QVBoxLayout{&similarRecipesDialog}},
+      recipeId{-1} {
+      this->layout->addWidget(this->heading.get());
+      this->layout->addWidget(this->matches.get());
+      this->matches->setRootIsDecorated(false);
+      this->matches->setColumnCount(3);
+      this->matches->header()->setSectionResizeMode(QHeaderView::ResizeToContents);
+      this->matches->setMinimumSize(480, 360);
+
+      QObject::connect(this->matches.get(), &QTreeWidget::itemDoubleClicked, &similarRecipesDialog,
+                       [&similarRecipesDialog](QTreeWidgetItem * item, int) {
+         Recipe * recipe = ObjectStoreWrapper::getByIdRaw<Recipe>(item->data(0, Qt::UserRole).toInt());
+         if (recipe) {
+            emit similarRecipesDialog.recipeChosen(recipe);
+         }
+         return;
+      });
+
+      this->setText(similarRecipesDialog);
+      return;
+   }
+
+   ~impl() = default;
+
+   /**
+    * Set the (translatable) parts of the dialog
+    */
+   void setText(SimilarRecipesDialog & similarRecipesDialog) {
+      similarRecipesDialog.setWindowTitle(SimilarRecipesDialog::tr("Similar Recipes"));
+      this->matches->setHeaderLabels({SimilarRecipesDialog::tr("Recipe"),
+                                      SimilarRecipesDialog::tr("Style"),
+                                      SimilarRecipesDialog::tr("Similarity")});
+      Recipe const * recipe = ObjectStoreWrapper::getByIdRaw<Recipe>(this->recipeId);
+      this->heading->setText(
+         recipe ? SimilarRecipesDialog::tr("Recipes most like \"%1\" (double-click to open):").arg(recipe->name()) :
+                  QString{}
+      );
+      return;
+   }
+
+   void showSimilarTo(SimilarRecipesDialog & similarRecipesDialog, Recipe & recipe) {
+      this->recipeId = recipe.key();
+      this->matches->clear();
+      for (RecipeSimilarityIndex::Match const & match : this->index->nearest(recipe, numMatchesToShow)) {
+         Recipe const * matchingRecipe = ObjectStoreWrapper::getByIdRaw<Recipe>(match.recipeId);
+         if (!matchingRecipe) {
+            continue;
+         }
+         std::shared_ptr<Style> const style = matchingRecipe->style();
+         auto item = new QTreeWidgetItem{this->matches.get()};
+         item->setText(0, matchingRecipe->name());
+         item->setText(1, style ? style->name() : QString{});
+         item->setText(2, QString::number(static_cast<double>(match.similarity) * 100.0, 'f', 0) + "%");
+         item->setTextAlignment(2, Qt::AlignRight | Qt::AlignVCenter);
+         item->setData(0, Qt::UserRole, match.recipeId);
+      }
+      this->setText(similarRecipesDialog);
+      return;
+   }
+
+   // The index is owned by the dialog (via Qt parenting) as well as here, which is OK as deleting a QObject removes it
+   // from its parent's list of children.
+   std::unique_ptr<RecipeSimilarityIndex> index;
+   std::unique_ptr<QLabel>                heading;
+   std::unique_ptr<QTreeWidget>           matches;
+   std::unique_ptr<QVBoxLayout>           layout;
+   //! The recipe we last showed matches for
+   int                                    recipeId;
+};
+
+
+SimilarRecipesDialog::SimilarRecipesDialog(QWidget * parent) : QDialog(parent),
+                                                               pimpl{std::make_unique<impl>(*this)} {
+   this->setObjectName("similarRecipesDialog");
+   return;
+}
+
+// See https://herbsutter.com/gotw/_100/ for why we need to explicitly define the destructor here (and not in the
+// header file)
+SimilarRecipesDialog::~SimilarRecipesDialog() = default;
+
+void SimilarRecipesDialog::showSimilarTo(Recipe & recipe) {
+   this->pimpl->showSimilarTo(*this, recipe);
+   this->show();
+   this->raise();
+   return;
+}
+
+void SimilarRecipesDialog::changeEvent(QEvent * event) {
+   if (event->type() == QEvent::LanguageChange) {
+      this->pimpl->setText(*this);
+   }
+   // Pass the event down to the base class
+   QDialog::changeEvent(event);
+   return;
+}
@@ -0,0 +1,97 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * StyleConformance.cpp is part of Brewtarget, and is copyright the following authors 2024:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#include "StyleConformance.h"
+
+#include <QCoreApplication>
+
+#include "model/Style.h"
+
+namespace {
+   StyleConformance::Range rangeFrom(std::optional<double> const min, std::optional<double> const max) {
+      if (min.value_or(0.0) == 0.0 && max.value_or(0.0) == 0.0) {
+         return StyleConformance::Range{std::nullopt, std::nullopt};
+      }
+      return StyleConformance::Range{min, max};
+   }
+}
+
+QString StyleConformance::parameterName(Parameter const parameter) {
+   switch (parameter) {
+      case Parameter::og       : return QCoreApplication::translate("StyleConformance", "OG"   );
+      case Parameter::fg       : return QCoreApplication::translate("StyleConformance", "FG"   );
+      case Parameter::ibu      : return QCoreApplication::translate("StyleConformance", "IBU"  );
+      case Parameter::color_srm: return QCoreApplication::translate("StyleConformance", "Color");
+      case Parameter::abv_pct  : return QCoreApplication::translate("StyleConformance", "ABV"  );
+   }
+   // It's a coding error if we get here
+   Q_ASSERT(false);
+   return QString{};
+}
+
+bool StyleConformance::Range::isSet() const {
+   return this->min || this->max;
+}
+
+double StyleConformance::Check::deviation() const {
+   if (this->range.min && this->value < *this->range.min) {
+      return this->value - *this->range.min;
+   }
+   if (this->range.max && this->value > *this->range.max) {
+      return this->value - *this->range.max;
+   }
+   return 0.0;
+}
+
+bool StyleConformance::Check::isOutOfRange() const {
+   return this->deviation() != 0.0;
+}
+
+StyleConformance::Check const & StyleConformance::RecipeResult::check(Parameter const parameter) const {
+   return this->checks.at(static_cast<std::size_t>(parameter));
+}
+
+int StyleConformance::RecipeResult::numOutOfRange() const {
+   int count = 0;
+   for (Check const & check : this->checks) {
+      if (check.isOutOfRange()) {
+         ++count;
+      }
+   }
+   return count;
+}
+
+std::array<StyleConformance::Range, StyleConformance::numParameters> StyleConformance::rangesOf(Style const & style) {
+   return {
+      rangeFrom(style.ogMin       (), style.ogMax       ()),
+      rangeFrom(style.fgMin       (), style.fgMax       ()),
+      rangeFrom(style.ibuMin      (), style.ibuMax      ()),
+      rangeFrom(style.colorMin_srm(), style.colorMax_srm()),
+      rangeFrom(style.abvMin_pct  (), style.abvMax_pct  ()),
+   };
+}
+
+std::array<StyleConformance::Check, StyleConformance::numParameters> StyleConformance::check(
+   RecipeEvaluator::Results const & results,
+   std::array<Range, numParameters> const & ranges
+) {
+   return {
+      Check{results.gravities.og, ranges.at(static_cast<std::size_t>(Parameter::og       ))},
+      Check{results.gravities.fg, ranges.at(static_cast<std::size_t>(Parameter::fg       ))},
+      Check{results.IBU         , ranges.at(static_cast<std::size_t>(Parameter::ibu      ))},
+      Check{results.color_srm   , ranges.at(static_cast<std::size_t>(Parameter::color_srm))},
+      Check{results.ABV_pct     , ranges.at(static_cast<std::size_t>(Parameter::abv_pct  ))},
+   };
+}
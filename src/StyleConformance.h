@@ -0,0 +1,109 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * StyleConformance.h is part of Brewtarget, and is copyright the following authors 2024:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#ifndef STYLECONFORMANCE_H
+#define STYLECONFORMANCE_H
+#pragma once
+
+#include <array>
+#include <optional>
+
+#include <QString>
+
+#include "RecipeEvaluator.h"
+
+class Recipe;
+class Style;
+
+/**
+ * \brief Comparing the calculated values of a \c Recipe (OG, FG, IBU, color, ABV) against the ranges of its \c Style.
+ *
+ *        This is the same comparison that \c StyleRangeWidget shows for the current recipe, but done on the results of
+ *        \c RecipeEvaluator so that it can be run across the whole recipe library (see
+ *        \c StyleConformanceTableModel).
+ */
+namespace StyleConformance {
+
+   enum class Parameter {
+      og       ,
+      fg       ,
+      ibu      ,
+      color_srm,
+      abv_pct  ,
+   };
+
+   //! Number of values in \c Parameter
+   int constexpr numParameters = 5;
+
+   //! \return Translated display name of \c parameter
+   QString parameterName(Parameter const parameter);
+
+   /**
+    * \brief A style range.  Either end can be unset, in which case the value is not checked against it.
+    */
+   struct Range {
+      std::optional<double> min;
+      std::optional<double> max;
+
+      bool isSet() const;
+   };
+
+   /**
+    * \brief A calculated value and the range it should be in
+    */
+   struct Check {
+      double value;
+      Range  range;
+
+      /**
+       * \return How far outside the range the value is: negative if it's below the minimum, positive if it's above the
+       *         maximum, and 0 if it's in range (or there is no range to check against).
+       */
+      double deviation() const;
+
+      bool isOutOfRange() const;
+   };
+
+   /**
+    * \brief Result of checking one \c Recipe against its \c Style
+    */
+   struct RecipeResult {
+      int     recipeId;
+      QString recipeName;
+      //! Empty if the recipe has no style, in which case all the \c checks have unset ranges
+      QString styleName;
+      //! Indexed by \c Parameter
+      std::array<Check, numParameters> checks;
+
+      Check const & check(Parameter const parameter) const;
+
+      int numOutOfRange() const;
+   };
+
+   /**
+    * \return The ranges from \c style, indexed by \c Parameter.  A range whose min and max are both zero is treated as
+    *         not set, since that is what we get for styles whose ranges were never filled in.
+    */
+   std::array<Range, numParameters> rangesOf(Style const & style);
+
+   /**
+    * \brief Compare the supplied results of evaluating a recipe against the supplied style ranges
+    */
+   std::array<Check, numParameters> check(RecipeEvaluator::Results const & results,
+                                          std::array<Range, numParameters> const & ranges);
+
+}
+
+#endif
@@ -0,0 +1,160 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * StyleConformanceDialog.cpp is part of Brewtarget, and is copyright the following authors 2024:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#include "StyleConformanceDialog.h"
+
+#include <QEvent>
+#include <QHeaderView>
+#include <QLabel>
+#include <QPushButton>
+#include <QShowEvent>
+#include <QSortFilterProxyModel>
+#include <QTableView>
+#include <QVBoxLayout>
+#include <QWidget>
+
+#include "tableModels/StyleConformanceTableModel.h"
+
+// This private implementation class holds all private non-virtual members of StyleConformanceDialog
+class StyleConformanceDialog::impl {
+
+public:
+
+   /**
+    * Constructor
+    *
+    * As with DiagnosticsDialog, it's safe to pass in a reference to StyleConformanceDialog from its constructor because
+    * there is nothing else in that class to initialise by the time this pimpl constructor is being called.
+    */
+   impl(StyleConformanceDialog & styleConformanceDialog) :
+      model        {new StyleConformanceTableModel{&styleConformanceDialog}},
+      proxyModel   {new QSortFilterProxyModel{&styleConformanceDialog}},
+      table        {new QTableView{}},
+      status       {new QLabel{}},
+      rescanButton {new QPushButton{}},
+      layout       {new QVBoxLayout{&styleConformanceDialog}},
+      hasScanned   {false} {
+      this->proxyModel->setSourceModel(this->model.get());
+      this->proxyModel->setSortRole(StyleConformanceTableModel::SortRole);
+      this->proxyModel->setSortCaseSensitivity(Qt::CaseInsensitive);
+      // Rows that change while the user is looking at the table should be re-sorted into the right place
+      this->proxyModel->setDynamicSortFilter(true);
+
+      this->table->setModel(this->proxyModel.get());
+      this->table->setSortingEnabled(true);
+      // Most useful starting point is the recipes with the most problems at the top
+      this->table->sortByColumn(static_cast<int>(StyleConformanceTableModel::ColumnIndex::NumOutOfRange),
+                                Qt::DescendingOrder);
+      this->table->setSelectionBehavior(QAbstractItemView::SelectRows);
+      this->table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+      this->table->horizontalHeader()->setSectionResizeMode(QHeaderView::ResizeToContents);
+      this->table->horizontalHeader()->setStretchLastSection(true);
+      this->table->verticalHeader()->hide();
+      this->table->setMinimumSize(800, 480);
+
+      this->layout->addWidget(this->table.get());
+      this->layout->addWidget(this->status.get());
+      this->layout->addWidget(this->rescanButton.get(), 0, Qt::AlignRight);
+
+      QObject::connect(this->rescanButton.get(), &QPushButton::clicked, &styleConformanceDialog, [this]() {
+         this->rescan();
+         return;
+      });
+      QObject::connect(this->model.get(), &StyleConformanceTableModel::scanFinished, &styleConformanceDialog, [this]() {
+         this->updateStatus();
+         return;
+      });
+
+      this->setText(styleConformanceDialog);
+      return;
+   }
+
+   ~impl() = default;
+
+   /**
+    * Set the (translatable) parts of the dialog
+    */
+   void setText(StyleConformanceDialog & styleConformanceDialog) {
+      styleConformanceDialog.setWindowTitle(StyleConformanceDialog::tr("Style Conformance"));
+      this->rescanButton->setText(StyleConformanceDialog::tr("Rescan"));
+      this->updateStatus();
+      return;
+   }
+
+   void rescan() {
+      this->hasScanned = true;
+      this->model->rescanAll();
+      this->updateStatus();
+      return;
+   }
+
+   void updateStatus() {
+      int numOutOfStyle = 0;
+      for (int row = 0; row < this->model->rowCount(); ++row) {
+         if (this->model->resultAt(row).numOutOfRange() > 0) {
+            ++numOutOfStyle;
+         }
+      }
+      QString text = StyleConformanceDialog::tr("%1 of %2 recipes outside their style on at least one parameter").arg(
+         numOutOfStyle
+      ).arg(this->model->rowCount());
+      if (this->model->isScanning()) {
+         text += StyleConformanceDialog::tr(" (scanning...)");
+      }
+      this->status->setText(text);
+      return;
+   }
+
+   // The models are owned by the dialog (via Qt parenting) as well as here, which is OK as deleting a QObject removes
+   // it from its parent's list of children.
+   std::unique_ptr<StyleConformanceTableModel> model;
+   std::unique_ptr<QSortFilterProxyModel>      proxyModel;
+   std::unique_ptr<QTableView>                 table;
+   std::unique_ptr<QLabel>                     status;
+   std::unique_ptr<QPushButton>                rescanButton;
+   std::unique_ptr<QVBoxLayout>                layout;
+   bool                                        hasScanned;
+};
+
+
+StyleConformanceDialog::StyleConformanceDialog(QWidget * parent) : QDialog(parent),
+                                                                   pimpl{std::make_unique<impl>(*this)} {
+   this->setObjectName("styleConformanceDialog");
+   return;
+}
+
+// See https://herbsutter.com/gotw/_100/ for why we need to explicitly define the destructor here (and not in the
+// header file)
+StyleConformanceDialog::~StyleConformanceDialog() = default;
+
+
+void StyleConformanceDialog::changeEvent(QEvent * event) {
+   if (event->type() == QEvent::LanguageChange) {
+      this->pimpl->setText(*this);
+   }
+   // Pass the event down to the base class
+   QDialog::changeEvent(event);
+   return;
+}
+
+void StyleConformanceDialog::showEvent(QShowEvent * event) {
+   // We don't scan the library until the first time someone wants to look at the results.  After that, the model keeps
+   // itself up to date.
+   if (!this->pimpl->hasScanned) {
+      this->pimpl->rescan();
+   }
+   QDialog::showEvent(event);
+   return;
+}
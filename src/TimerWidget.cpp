@@ -47,6 +47,7 @@ TimerWidget::TimerWidget(TimerMainDialog *parent, BoilTime* bt) :
    started{true}, //default is started, this means timers will start as soon as main timer is started
    stopped{false},
    time{0},
+   additionTime{0},
    limitAlarmRing{false},
    alarmRingLimit{5},
    //
@@ -97,7 +98,8 @@ void TimerWidget::setTime(int t) {
       this->setTimeBox->setValue(t/60);
    }
 
-   this->time = boilTime->getTime() - t;
+   this->additionTime = t;
+   this->time = this->timeToAddition();
    //Reset timer to run again with new time
    this->stopped = false;
    this->started = true;
@@ -132,6 +134,11 @@ QString TimerWidget::getNote() {
    return this->noteEdit->text();
 }
 
+unsigned int TimerWidget::timeToAddition() {
+   int const boilRemaining = this->boilTime->getTime();
+   return boilRemaining > this->additionTime ? static_cast<unsigned int>(boilRemaining - this->additionTime) : 0;
+}
+
 void TimerWidget::updateTime() {
    this->timeLCD->display(TimerUtils::timeToString(this->time));
    return;
@@ -139,14 +146,16 @@ void TimerWidget::updateTime() {
 
 void TimerWidget::decrementTime() {
    if (this->started) {
+      unsigned int const remaining = this->timeToAddition();
       // show timers a minute before they go off
-      if (time == 60 && this->isHidden()) {
+      if (this->time > 60 && remaining <= 60 && this->isHidden()) {
          this->show();
-      } else if (time == 0) {
-         timesUp();
+      }
+      if (remaining == 0 && this->time == 0) {
+         this->timesUp();
       } else {
-         time = time - 1;
-         updateTime();
+         this->time = remaining;
+         this->updateTime();
       }
    }
    return;
@@ -191,7 +200,8 @@ void TimerWidget::setSound(QString s) {
 void TimerWidget::on_setTimeBox_valueChanged(int t) {
    if (t * 60 > boilTime->getTime()) {
       QMessageBox::warning(this, tr("Error"), tr("Addition time cannot be longer than remaining boil time"));
-      time = 0;
+      this->additionTime = this->boilTime->getTime();
+      this->time = 0;
    } else {
       this->setTime(t * 60);
    }
@@ -231,10 +241,11 @@ void TimerWidget::flash() {
 
 void TimerWidget::reset() {
    if (this->setTimeBox->value() * 60 > this->boilTime->getTime()) {
-      this->time = 0;
+      this->additionTime = this->boilTime->getTime();
    } else {
-      this->time = this->boilTime->getTime() - (this->setTimeBox->value() * 60);
+      this->additionTime = this->setTimeBox->value() * 60;
    }
+   this->time = this->timeToAddition();
    this->stopped = false;
    this->soundPlayer->stop();
    this->updateTime();
@@ -71,12 +71,17 @@ private:
    bool stopped; // Used to flash LCDNumber if time has elapsed
    /**
     * This will be stored as time to addition, not addition time ie. 50min for a 10min addition in a 60min boil - not 10min
+    * It is always recalculated from \c additionTime and the remaining boil time, rather than counted down, so that
+    * timers can't drift against the boil (or each other).
     */
    unsigned int time;
+   //! Addition time, ie seconds before the end of the boil at which this timer goes off
+   int additionTime;
    bool limitAlarmRing;
    unsigned int alarmRingLimit;
    QSoundEffect* soundPlayer;
 
+   unsigned int timeToAddition();
    void updateTime();
    void timesUp();
    void flash();
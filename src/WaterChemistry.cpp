@@ -0,0 +1,137 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * WaterChemistry.cpp is part of Brewtarget, and is copyright the following authors 2024:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#include "WaterChemistry.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <QDebug>
+#include <QtGlobal>
+
+namespace {
+   //
+   // An ion's error is measured relative to its target, but we don't want a target of (nearly) zero to make that ion
+   // dominate everything else, so below this we measure error relative to this instead.
+   //
+   double constexpr minIonScale_ppm = 10.0;
+
+   //! Being this far out on mash pH counts the same as being 100% out on an ion
+   double constexpr pHScale = 0.05;
+
+   unsigned int constexpr maxSweeps = 500;
+
+   //! We stop once no amount moves by more than this fraction of its allowed range in a sweep
+   double constexpr relativeTolerance = 1.0e-9;
+}
+
+WaterChemistry::SaltSolverResult WaterChemistry::solveSaltAdditions(SaltSolverInputs const & inputs) {
+   std::size_t const numAdditions = inputs.maxAmounts.size();
+   SaltSolverResult result;
+   result.amounts.assign(numAdditions, 0.0);
+   if (inputs.ionCoefficients.size() != numAdditions * numIons || inputs.pHCoefficients.size() != numAdditions) {
+      // This is a coding error
+      qCritical() << Q_FUNC_INFO << "Mismatched inputs:" << inputs.ionCoefficients.size() << "ion coefficients," <<
+         inputs.pHCoefficients.size() << "pH coefficients for" << numAdditions << "additions";
+      Q_ASSERT(false);
+      return result;
+   }
+
+   //
+   // The rows of the (weighted) system we want to solve are the ions plus, optionally, mash pH.  We store the design
+   // matrix column-major (ie one contiguous column per addition), which is how both building the normal equations and
+   // computing the residual want to walk it.
+   //
+   bool const includepH = inputs.basepH && inputs.targetpH;
+   std::size_t const numRows = numIons + (includepH ? 1 : 0);
+   std::vector<double> design(numRows * numAdditions, 0.0);
+   std::vector<double> wanted(numRows, 0.0);
+   for (std::size_t ii = 0; ii < numIons; ++ii) {
+      double const weight = 1.0 / std::max(inputs.target_ppm[ii], minIonScale_ppm);
+      wanted[ii] = weight * (inputs.target_ppm[ii] - inputs.base_ppm[ii]);
+      for (std::size_t jj = 0; jj < numAdditions; ++jj) {
+         design[jj * numRows + ii] = weight * inputs.ionCoefficients[jj * numIons + ii];
+      }
+   }
+   if (includepH) {
+      wanted[numIons] = (*inputs.targetpH - *inputs.basepH) / pHScale;
+      for (std::size_t jj = 0; jj < numAdditions; ++jj) {
+         design[jj * numRows + numIons] = inputs.pHCoefficients[jj] / pHScale;
+      }
+   }
+
+   //
+   // Normal equations: gram = designᵀ·design and projection = designᵀ·wanted.  These are numAdditions square, which is
+   // tiny, so from here on each sweep costs next to nothing, regardless of how many rows there are.
+   //
+   std::vector<double> gram(numAdditions * numAdditions, 0.0);
+   std::vector<double> projection(numAdditions, 0.0);
+   for (std::size_t jj = 0; jj < numAdditions; ++jj) {
+      double const * columnJ = &design[jj * numRows];
+      for (std::size_t kk = jj; kk < numAdditions; ++kk) {
+         double const * columnK = &design[kk * numRows];
+         double dot = 0.0;
+         for (std::size_t rr = 0; rr < numRows; ++rr) {
+            dot += columnJ[rr] * columnK[rr];
+         }
+         gram[jj * numAdditions + kk] = dot;
+         gram[kk * numAdditions + jj] = dot;
+      }
+      double dot = 0.0;
+      for (std::size_t rr = 0; rr < numRows; ++rr) {
+         dot += columnJ[rr] * wanted[rr];
+      }
+      projection[jj] = dot;
+   }
+
+   //
+   // Projected coordinate descent: minimise along each amount in turn, clamping to its bounds.  An addition that has no
+   // effect on anything we measure (zero diagonal) just stays at zero.
+   //
+   std::vector<double> & amounts = result.amounts;
+   for (result.iterations = 0; result.iterations < maxSweeps; ) {
+      ++result.iterations;
+      double largestMove = 0.0;
+      for (std::size_t jj = 0; jj < numAdditions; ++jj) {
+         double const diagonal = gram[jj * numAdditions + jj];
+         double const maxAmount = std::max(inputs.maxAmounts[jj], 0.0);
+         if (diagonal <= 0.0 || maxAmount <= 0.0) {
+            continue;
+         }
+         double const * gramRow = &gram[jj * numAdditions];
+         double gradient = -projection[jj];
+         for (std::size_t kk = 0; kk < numAdditions; ++kk) {
+            gradient += gramRow[kk] * amounts[kk];
+         }
+         double const newAmount = std::clamp(amounts[jj] - gradient / diagonal, 0.0, maxAmount);
+         largestMove = std::max(largestMove, std::abs(newAmount - amounts[jj]) / maxAmount);
+         amounts[jj] = newAmount;
+      }
+      if (largestMove <= relativeTolerance) {
+         break;
+      }
+   }
+
+   double sumOfSquares = 0.0;
+   for (std::size_t rr = 0; rr < numRows; ++rr) {
+      double error = -wanted[rr];
+      for (std::size_t jj = 0; jj < numAdditions; ++jj) {
+         error += design[jj * numRows + rr] * amounts[jj];
+      }
+      sumOfSquares += error * error;
+   }
+   result.residual = std::sqrt(sumOfSquares);
+   return result;
+}
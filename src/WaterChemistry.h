@@ -0,0 +1,78 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * WaterChemistry.h is part of Brewtarget, and is copyright the following authors 2024:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#ifndef WATERCHEMISTRY_H
+#define WATERCHEMISTRY_H
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <optional>
+#include <vector>
+
+/*!
+ * \brief Algorithms for working out water adjustments.  Nothing in here touches the model: callers (ie
+ *        \c WaterDialog) work out the effect of each addition up front, which keeps solving cheap enough to redo every
+ *        time the user changes something.
+ */
+namespace WaterChemistry {
+
+   //! Number of ions we track, ie number of values of \c Water::Ion
+   constexpr std::size_t numIons = 6;
+
+   /**
+    * \brief Everything \c solveSaltAdditions needs to know.  Each addition (ie each row of the salt table) is treated
+    *        as having a linear effect on the ion concentrations and the mash pH, so it is described just by its
+    *        coefficients per unit amount (where the unit is whatever the addition's amount is measured in).
+    */
+   struct SaltSolverInputs {
+      //! Ion concentrations (ppm) before any additions, indexed by \c Water::Ion
+      std::array<double, numIons> base_ppm;
+      //! Ion concentrations (ppm) we want to end up with, indexed by \c Water::Ion
+      std::array<double, numIons> target_ppm;
+      //! For each addition, the ppm of each ion it adds per unit amount, stored as ionCoefficients[jj * numIons + ii]
+      std::vector<double> ionCoefficients;
+      //! For each addition, the change in mash pH per unit amount
+      std::vector<double> pHCoefficients;
+      //! For each addition, the largest amount we are allowed to suggest
+      std::vector<double> maxAmounts;
+      //! Mash pH with no additions and the mash pH we want.  If either is unset, pH is ignored.
+      std::optional<double> basepH;
+      std::optional<double> targetpH;
+   };
+
+   struct SaltSolverResult {
+      //! For each addition, the suggested amount, in the same units as used for its coefficients
+      std::vector<double> amounts;
+      //! Weighted root-sum-square distance from the target at the suggested amounts
+      double residual = 0.0;
+      //! Number of sweeps over the additions before we converged (or gave up)
+      unsigned int iterations = 0;
+   };
+
+   /**
+    * \brief Find the amounts of the given additions, each between 0 and its maximum, that get us as close as possible
+    *        to the target ion concentrations (and, optionally, mash pH).  "Close" is least-squares, with each ion's
+    *        error taken relative to its target (so 10 ppm out on 20 ppm of magnesium counts for more than 10 ppm out on
+    *        300 ppm of sulfate).
+    *
+    *        Because the model is linear, we can reduce the whole problem to a small square system up front and then
+    *        solve it by projected coordinate descent, which handles the bounds trivially.  For the handful of additions
+    *        in a typical recipe this converges in a few tens of sweeps, ie well under a millisecond.
+    */
+   SaltSolverResult solveSaltAdditions(SaltSolverInputs const & inputs);
+}
+
+#endif
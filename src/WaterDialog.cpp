@@ -42,6 +42,7 @@
 #include "listModels/WaterListModel.h"
 #include "sortFilterProxyModels/WaterSortFilterProxyModel.h"
 #include "widgets/SmartDigitWidget.h"
+#include "WaterChemistry.h"
 
 
 //
@@ -61,12 +62,40 @@ namespace {
    double constexpr HCO3gpm = 61.01;
    // CO3 grams per mole
    double constexpr CO3gpm = 60.01;
+   // Lactic acid grams per mole
+   double constexpr lactic_gpm = 90;
+   // H3PO4 grams per mole
+   double constexpr H3PO4_gpm = 98;
 
    // The pH of a beer with no color
    double constexpr nosrmbeer_ph = 5.6;
    // Magic constants Kai derives in the document above.
    double constexpr pHSlopeLight = 0.21;
    double constexpr pHSlopeDark  = 0.06;
+
+   // The range of mash pH we show as OK.  When matching a target profile, we aim for the middle of it.
+   double constexpr mashpHLow  = 5.0;
+   double constexpr mashpHHigh = 5.5;
+
+   //
+   // Upper limits on what we'll suggest when matching a target profile.  Salts are in grams (and liquid acids in
+   // millilitres) per liter of brewing water.  Acidulated malt is as a fraction of the grist.
+   //
+   double constexpr maxAdditionPerLiter = 1.0;
+   double constexpr maxAcidulatedMaltFraction = 0.1;
+
+   double massConcPpm_perGramPerLiter(Salt const & salt, Water::Ion const ion) {
+      switch (ion) {
+         case Water::Ion::Ca:   return salt.massConcPpm_Ca_perGramPerLiter  ();
+         case Water::Ion::Cl:   return salt.massConcPpm_Cl_perGramPerLiter  ();
+         case Water::Ion::HCO3: return salt.massConcPpm_HCO3_perGramPerLiter();
+         case Water::Ion::Mg:   return salt.massConcPpm_Mg_perGramPerLiter  ();
+         case Water::Ion::Na:   return salt.massConcPpm_Na_perGramPerLiter  ();
+         case Water::Ion::SO4:  return salt.massConcPpm_SO4_perGramPerLiter ();
+         // No default case as we want the compiler to warn us if we missed one of the enum values above
+      }
+      return 0.0;
+   }
 }
 
 WaterDialog::WaterDialog(QWidget* parent) :
@@ -79,23 +108,25 @@ WaterDialog::WaterDialog(QWidget* parent) :
    m_mashRO{0.0},
    m_spargeRO{0.0},
    m_total_grains{0.0},
-   m_thickness{0.0} {
+   m_thickness{0.0},
+   m_weighted_colors{0.0},
+   m_gristpH{},
+   m_gristChangeCount{0} {
 
    setupUi(this);
    // initialize the two buttons and lists (I think)
-   m_base_combo_list = new WaterListModel(baseProfileCombo);
+   m_waterListModel = WaterListModel::shared();
    m_base_filter    = new WaterSortFilterProxyModel(baseProfileCombo);
    m_base_filter->setDynamicSortFilter(true);
    m_base_filter->setSortLocaleAware(true);
-   m_base_filter->setSourceModel(m_base_combo_list);
+   m_base_filter->setSourceModel(m_waterListModel.get());
    m_base_filter->sort(0);
    baseProfileCombo->setModel(m_base_filter);
 
-   m_target_combo_list = new WaterListModel(targetProfileCombo);
    m_target_filter    = new WaterSortFilterProxyModel(targetProfileCombo);
    m_target_filter->setDynamicSortFilter(true);
    m_target_filter->setSortLocaleAware(true);
-   m_target_filter->setSourceModel(m_target_combo_list);
+   m_target_filter->setSourceModel(m_waterListModel.get());
    m_target_filter->sort(0);
    targetProfileCombo->setModel(m_target_filter);
 
@@ -138,8 +169,8 @@ WaterDialog::WaterDialog(QWidget* parent) :
                                     tr("Too high for target profile."));
    }
    // we can be a bit more specific with pH
-   btDigit_ph->setLowLim(5.0);
-   btDigit_ph->setHighLim(5.5);
+   btDigit_ph->setLowLim(mashpHLow);
+   btDigit_ph->setHighLim(mashpHHigh);
    btDigit_ph->setQuantity(7.0);
 
    // since all the things are now digits, lets get the totals configured
@@ -166,6 +197,8 @@ WaterDialog::WaterDialog(QWidget* parent) :
    connect(m_saltAdjustmentTableModel, &RecipeAdjustmentSaltTableModel::newTotals, this                      , &WaterDialog::newTotals   );
    connect(pushButton_addSalt        , &QAbstractButton::clicked                 , m_saltAdjustmentTableModel, &RecipeAdjustmentSaltTableModel::catchSalt);
    connect(pushButton_removeSalt     , &QAbstractButton::clicked                 , this                      , &WaterDialog::removeSalts );
+   connect(pushButton_matchTarget    , &QAbstractButton::clicked                 , this                      , &WaterDialog::matchTarget );
+   connect(checkBox_autoMatchTarget  , &QAbstractButton::toggled                 , this                      , &WaterDialog::autoMatchTarget);
 
    connect(spinBox_mashRO,   QOverload<int>::of(&QSpinBox::valueChanged), this, &WaterDialog::setMashRO  );
    connect(spinBox_spargeRO, QOverload<int>::of(&QSpinBox::valueChanged), this, &WaterDialog::setSpargeRO);
@@ -182,6 +215,7 @@ void WaterDialog::setMashRO(int val) {
    m_mashRO = val/100.0;
    if ( m_base ) m_base->setMashRo_pct(m_mashRO);
    newTotals();
+   this->autoMatchTarget();
    return;
 }
 
@@ -189,6 +223,7 @@ void WaterDialog::setSpargeRO(int val) {
    m_spargeRO = val/100.0;
    if ( m_base ) m_base->setSpargeRo_pct(m_spargeRO);
    newTotals();
+   this->autoMatchTarget();
    return;
 }
 
@@ -240,51 +275,8 @@ void WaterDialog::setRecipe(Recipe *rec) {
    }
 
    // I need these numbers before we set the ranges
-   for (auto const & fermentableAddition : m_rec->fermentableAdditions() ) {
-      // .:TBD:. This almost certainly needs some refinement
-      switch (fermentableAddition->fermentable()->type()) {
-         case Fermentable::Type::Grain:
-         case Fermentable::Type::Extract:
-         case Fermentable::Type::Dry_Extract:
-            if (fermentableAddition->getMeasure() == Measurement::PhysicalQuantity::Mass) {
-               m_total_grains += fermentableAddition->amount().quantity;
-            }
-            break;
-         case Fermentable::Type::Sugar:
-         case Fermentable::Type::Other_Adjunct:
-         case Fermentable::Type::Fruit:
-         case Fermentable::Type::Juice:
-         case Fermentable::Type::Honey:
-            // For the moment, at least, assume these types of fermentables do not affect color.  .:TBD:. This is
-            // probably wrong!
-            break;
-      }
-   }
-
-   // Now we've got m_total_grains, we need to loop over fermentable again
-   for (auto const & fermentableAddition : m_rec->fermentableAdditions() ) {
-      // .:TBD:. This almost certainly needs some refinement
-      switch (fermentableAddition->fermentable()->type()) {
-         case Fermentable::Type::Grain:
-         case Fermentable::Type::Extract:
-         case Fermentable::Type::Dry_Extract:
-            if (fermentableAddition->getMeasure() == Measurement::PhysicalQuantity::Mass) {
-               double lovi = (fermentableAddition->fermentable()->color_srm() +0.6 ) / 1.35;
-               m_weighted_colors   += (fermentableAddition->amount().quantity/m_total_grains)*lovi;
-            }
-            break;
-         case Fermentable::Type::Sugar:
-         case Fermentable::Type::Other_Adjunct:
-         case Fermentable::Type::Fruit:
-         case Fermentable::Type::Juice:
-         case Fermentable::Type::Honey:
-            // For the moment, at least, assume these types of fermentables do not affect color.  .:TBD:. This is
-            // probably wrong!
-            break;
-      }
-   }
-
-   m_thickness = m_rec->mash()->totalInfusionAmount_l()/m_total_grains;
+   this->m_gristpH.reset();
+   this->refreshGrist();
 
    if (this->m_base) {
 
@@ -316,7 +308,7 @@ void WaterDialog::update_baseProfile(int selected) {
 
    QModelIndex proxyIdx(m_base_filter->index(baseProfileCombo->currentIndex(),0));
    QModelIndex sourceIdx(m_base_filter->mapToSource(proxyIdx));
-   Water const * parent = m_base_combo_list->at(sourceIdx.row());
+   Water const * parent = m_waterListModel->at(sourceIdx.row());
    if (parent) {
       // The copy constructor won't copy the key (aka database ID), so the new object will be in-memory only until we
       // explicitly insert it in the Object Store (which will be done if/when it is added to the Recipe).  Note
@@ -329,6 +321,7 @@ void WaterDialog::update_baseProfile(int selected) {
       baseProfileButton->setWater(this->m_base);
       m_base_editor->setWater(this->m_base);
       newTotals();
+      this->autoMatchTarget();
    }
    return;
 }
@@ -341,7 +334,7 @@ void WaterDialog::update_targetProfile(int selected) {
 
    QModelIndex proxyIdx(m_target_filter->index(targetProfileCombo->currentIndex(),0));
    QModelIndex sourceIdx(m_target_filter->mapToSource(proxyIdx));
-   Water* parent = m_target_combo_list->at(sourceIdx.row());
+   Water* parent = m_waterListModel->at(sourceIdx.row());
 
    if (parent) {
       // Comment above for copy of m_base applies equally here
@@ -354,6 +347,7 @@ void WaterDialog::update_targetProfile(int selected) {
       m_target_editor->setWater(this->m_target);
 
       this->setDigits();
+      this->autoMatchTarget();
    }
    return;
 }
@@ -385,12 +379,7 @@ void WaterDialog::newTotals() {
    // for the base water that depends the %RO in the mash and sparge water
 
    if (this->m_base) {
-      // 'd' means 'diluted'. They make calculating the modifier readable
-      double dInfuse = m_mashRO * mash->totalInfusionAmount_l();
-      double dSparge = m_spargeRO * mash->totalSpargeAmount_l();
-
-      // I hope this is right. All this 'rithmetic is making me head hurt.
-      double modifier = 1.0 - (dInfuse + dSparge) / allTheWaters;
+      double modifier = this->baseWaterFraction();
 
       for (int ii = 0; ii < Water::ionStringMapping.size(); ++ii) {
          Water::Ion ion = static_cast<Water::Ion>(ii);
@@ -418,6 +407,168 @@ void WaterDialog::removeSalts() {
    return;
 }
 
+void WaterDialog::matchTarget() {
+   if (!this->m_rec || !this->m_rec->mash() || !this->m_target) {
+      return;
+   }
+
+   auto mash = this->m_rec->mash();
+   double const allTheWaters = mash->totalMashWater_l();
+   if (qFuzzyCompare(allTheWaters, 0.0)) {
+      qWarning() << Q_FUNC_INFO << "Can not match target water chemistry without a mash";
+      return;
+   }
+
+   WaterChemistry::SaltSolverInputs inputs;
+   double const modifier = this->m_base ? this->baseWaterFraction() : 0.0;
+   for (int ii = 0; ii < Water::ionStringMapping.size(); ++ii) {
+      Water::Ion const ion = static_cast<Water::Ion>(ii);
+      inputs.base_ppm  [ii] = this->m_base ? modifier * this->m_base->ppm(ion) : 0.0;
+      inputs.target_ppm[ii] = this->m_target->ppm(ion);
+   }
+
+   //
+   // Work out what one unit of each addition does to the ions and the mash pH.  This mirrors the sums in newTotals(),
+   // calculateAddedSaltpH() and calculateAcidpH(), just done per addition rather than over the totals.
+   //
+   this->refreshGrist();
+   bool const canCalculatepH = this->m_base && this->m_rec->fermentableAdditions().size() && this->m_thickness > 0.0;
+   QList<std::shared_ptr<RecipeAdjustmentSalt>> additions;
+   for (int row = 0; row < this->m_saltAdjustmentTableModel->rowCount(); ++row) {
+      auto saltAdjustment = this->m_saltAdjustmentTableModel->getRow(row);
+      Salt const * salt = saltAdjustment->salt();
+      if (!salt) {
+         // Newly-added row where the user hasn't yet chosen the salt
+         continue;
+      }
+      double const multiplier = this->m_saltAdjustmentTableModel->multiplier(*saltAdjustment);
+      for (int ii = 0; ii < Water::ionStringMapping.size(); ++ii) {
+         inputs.ionCoefficients.push_back(
+            multiplier * massConcPpm_perGramPerLiter(*salt, static_cast<Water::Ion>(ii)) / allTheWaters
+         );
+      }
+
+      double pHDelta = multiplier * (0.0 - salt->massConcPpm_Ca_perGramPerLiter()/Cagpm * 2 / 3.5
+                                         - salt->massConcPpm_Mg_perGramPerLiter()/Mggpm * 2 / 7
+                                         + (salt->massConcPpm_HCO3_perGramPerLiter()/HCO3gpm +
+                                            salt->massConcPpm_CO3_perGramPerLiter ()/CO3gpm) / 61);
+      double const acidWeight = this->m_saltAdjustmentTableModel->acidWeightPerUnitAmount(*saltAdjustment);
+      pHDelta -= 1000 * acidWeight / (salt->type() == Salt::Type::H3PO4 ? H3PO4_gpm : lactic_gpm);
+      inputs.pHCoefficients.push_back(canCalculatepH ? pHDelta / this->m_thickness / mEq : 0.0);
+
+      inputs.maxAmounts.push_back(
+         salt->type() == Salt::Type::AcidulatedMalt ? maxAcidulatedMaltFraction * this->m_total_grains :
+                                                      maxAdditionPerLiter * allTheWaters / multiplier
+      );
+      additions.append(saltAdjustment);
+   }
+   if (additions.isEmpty()) {
+      return;
+   }
+
+   if (canCalculatepH) {
+      inputs.basepH   = this->gristpH() + this->calculateSaltpH();
+      inputs.targetpH = (mashpHLow + mashpHHigh) / 2.0;
+   }
+
+   auto const result = WaterChemistry::solveSaltAdditions(inputs);
+   qDebug() <<
+      Q_FUNC_INFO << "Matched target in" << result.iterations << "sweeps with residual" << result.residual;
+
+   for (int jj = 0; jj < additions.size(); ++jj) {
+      additions[jj]->setQuantity(result.amounts[jj]);
+   }
+   this->newTotals();
+   return;
+}
+
+void WaterDialog::autoMatchTarget() {
+   if (this->checkBox_autoMatchTarget->isChecked()) {
+      this->matchTarget();
+   }
+   return;
+}
+
+void WaterDialog::calculateGrainEquivalent() {
+   this->m_total_grains    = 0.0;
+   this->m_weighted_colors = 0.0;
+   for (auto const & fermentableAddition : m_rec->fermentableAdditions() ) {
+      // .:TBD:. This almost certainly needs some refinement
+      switch (fermentableAddition->fermentable()->type()) {
+         case Fermentable::Type::Grain:
+         case Fermentable::Type::Extract:
+         case Fermentable::Type::Dry_Extract:
+            if (fermentableAddition->getMeasure() == Measurement::PhysicalQuantity::Mass) {
+               m_total_grains += fermentableAddition->amount().quantity;
+            }
+            break;
+         case Fermentable::Type::Sugar:
+         case Fermentable::Type::Other_Adjunct:
+         case Fermentable::Type::Fruit:
+         case Fermentable::Type::Juice:
+         case Fermentable::Type::Honey:
+            // For the moment, at least, assume these types of fermentables do not affect color.  .:TBD:. This is
+            // probably wrong!
+            break;
+      }
+   }
+
+   // Now we've got m_total_grains, we need to loop over fermentable again
+   for (auto const & fermentableAddition : m_rec->fermentableAdditions() ) {
+      // .:TBD:. This almost certainly needs some refinement
+      switch (fermentableAddition->fermentable()->type()) {
+         case Fermentable::Type::Grain:
+         case Fermentable::Type::Extract:
+         case Fermentable::Type::Dry_Extract:
+            if (fermentableAddition->getMeasure() == Measurement::PhysicalQuantity::Mass) {
+               double lovi = (fermentableAddition->fermentable()->color_srm() +0.6 ) / 1.35;
+               m_weighted_colors   += (fermentableAddition->amount().quantity/m_total_grains)*lovi;
+            }
+            break;
+         case Fermentable::Type::Sugar:
+         case Fermentable::Type::Other_Adjunct:
+         case Fermentable::Type::Fruit:
+         case Fermentable::Type::Juice:
+         case Fermentable::Type::Honey:
+            // For the moment, at least, assume these types of fermentables do not affect color.  .:TBD:. This is
+            // probably wrong!
+            break;
+      }
+   }
+
+   m_thickness = m_rec->mash()->totalInfusionAmount_l()/m_total_grains;
+   return;
+}
+
+void WaterDialog::refreshGrist() {
+   if (!this->m_rec || !this->m_rec->mash()) {
+      return;
+   }
+   if (this->m_gristpH && this->m_gristChangeCount == this->m_rec->changeCount()) {
+      return;
+   }
+   this->calculateGrainEquivalent();
+   this->m_gristpH = this->calculateGristpH();
+   this->m_gristChangeCount = this->m_rec->changeCount();
+   return;
+}
+
+double WaterDialog::gristpH() {
+   this->refreshGrist();
+   return this->m_gristpH.value_or(nosrmbeer_ph);
+}
+
+//! \brief Fraction of the brewing water that is base water, as opposed to RO water
+double WaterDialog::baseWaterFraction() const {
+   auto mash = this->m_rec->mash();
+   // 'd' means 'diluted'. They make calculating the modifier readable
+   double dInfuse = m_mashRO * mash->totalInfusionAmount_l();
+   double dSparge = m_spargeRO * mash->totalSpargeAmount_l();
+
+   // I hope this is right. All this 'rithmetic is making me head hurt.
+   return 1.0 - (dInfuse + dSparge) / mash->totalMashWater_l();
+}
+
 //! \brief Calcuates the residual alkalinity of the mash water.
 double WaterDialog::calculateRA() const {
    double residual = 0.0;
@@ -441,10 +592,7 @@ double WaterDialog::calculateSaltpH() {
       return 0.0;
    }
 
-   auto mash = m_rec->mash();
-   double allTheWaters = mash->totalMashWater_l();
-
-   double modifier = 1 - ( (m_mashRO * mash->totalInfusionAmount_l()) + (m_spargeRO * mash->totalSpargeAmount_l())) / allTheWaters;
+   double modifier = this->baseWaterFraction();
 
    // I have no idea where the 2 comes from, but Kai did it. I wish I knew why
    // we get the initial numbers from the base water
@@ -481,8 +629,6 @@ double WaterDialog::calculateAddedSaltpH() {
 //! \brief Calculates the pH adjustment caused by lactic acid, H3PO4 and/or acid
 //! malts
 double WaterDialog::calculateAcidpH() {
-   const double H3PO4_gpm = 98;
-   const double lactic_gpm = 90;
    double totalDelta = 0.0;
 
    double lactic_amt   = this->m_saltAdjustmentTableModel->totalAcidWeight(Salt::Type::LacticAcid);
@@ -553,7 +699,7 @@ double WaterDialog::calculateMashpH() {
    double mashpH = 0.0;
 
    if ( m_rec && m_rec->fermentableAdditions().size() ) {
-      double gristpH   = calculateGristpH();
+      double gristpH   = this->gristpH();
       double basepH    = calculateSaltpH();
       double saltpH    = calculateAddedSaltpH();
       double acids     = calculateAcidpH();
@@ -21,6 +21,7 @@
 #pragma once
 
 #include <memory>
+#include <optional>
 
 #include <QButtonGroup>
 #include <QDialog>
@@ -61,6 +62,13 @@ public slots:
    void update_targetProfile(int selected);
    void newTotals();
    void removeSalts();
+   /**
+    * \brief Set the amounts of the salts in the table to get as close as we can to the target profile (and a sensible
+    *        mash pH).  The user chooses which salts are available by adding them to the table.
+    */
+   void matchTarget();
+   //! \brief Calls \c matchTarget if the user has asked for the target to be matched automatically
+   void autoMatchTarget();
    void setMashRO(int val);
    void setSpargeRO(int val);
    void saveAndClose();
@@ -73,7 +81,18 @@ signals:
 private:
 
    void setDigits();
+   //! \brief Works out the grain bill totals (\c m_total_grains, \c m_weighted_colors and \c m_thickness)
    void calculateGrainEquivalent();
+   /**
+    * \brief The grain bill only changes when the recipe does, so we keep the numbers we get from it (including the
+    *        grist pH, which means a pass over all the fermentables) until the recipe's change count moves on, rather
+    *        than working them out again every time a salt amount changes.
+    */
+   void refreshGrist();
+   //! \brief Cached result of \c calculateGristpH
+   double gristpH();
+
+   double baseWaterFraction() const;
 
    double calculateRA() const;
    double calculateGristpH();
@@ -84,8 +103,8 @@ private:
 
    QVector<SmartDigitWidget *>        m_ppm_digits;
    QVector<SmartDigitWidget *>        m_total_digits;
-   WaterListModel *                   m_base_combo_list;
-   WaterListModel *                   m_target_combo_list;
+   //! Shared by both profile combo boxes, each of which has its own filter -- see \c ListModelBase::shared
+   std::shared_ptr<WaterListModel>    m_waterListModel;
    RecipeAdjustmentSaltTableModel *   m_saltAdjustmentTableModel;
    RecipeAdjustmentSaltItemDelegate * m_saltAdjustmentDelegate;
    WaterEditor *                      m_base_editor;
@@ -98,6 +117,8 @@ private:
    double                             m_total_grains;
    double                             m_thickness;
    double                             m_weighted_colors;
+   std::optional<double>              m_gristpH;
+   unsigned int                       m_gristChangeCount;
    WaterSortFilterProxyModel *        m_base_filter;
    WaterSortFilterProxyModel *        m_target_filter;
 };
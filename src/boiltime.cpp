@@ -17,58 +17,105 @@
 
 #include "boiltime.h"
 
-BoilTime::BoilTime(QObject* parent): QObject(parent),
-    time(0),
-    started(false),
-    completed(false)
-{
-    timer = new QTimer(this);
-    timer->setInterval(1000);
-    connect(timer, &QTimer::timeout, this, &BoilTime::decrementTime);
+#include <algorithm>
+
+namespace {
+   constexpr qint64 msPerSecond = 1000;
+}
+
+BoilTime::BoilTime(QObject* parent) :
+   QObject{parent},
+   timer{new QTimer(this)},
+   clock{},
+   deadline_ms{0},
+   stoppedRemaining_ms{0},
+   lastTime{0},
+   started{false},
+   completed{false} {
+   // The default coarse timers can be out by up to 5%, which would make the seconds visibly uneven
+   this->timer->setSingleShot(true);
+   this->timer->setTimerType(Qt::PreciseTimer);
+   this->clock.start();
+   connect(this->timer, &QTimer::timeout, this, &BoilTime::tick);
+   return;
+}
+
+void BoilTime::setBoilTime(int boilTime) {
+   qint64 const boilTime_ms = static_cast<qint64>(boilTime) * msPerSecond;
+   if (this->started) {
+      this->deadline_ms = this->clock.elapsed() + boilTime_ms;
+      this->scheduleTick();
+   } else {
+      this->stoppedRemaining_ms = boilTime_ms;
+   }
+   this->lastTime = boilTime;
+   this->completed = false;
+   return;
+}
+
+int BoilTime::getTime() {
+   qint64 const remaining = this->remaining_ms();
+   if (remaining <= 0) {
+      return 0;
+   }
+   return static_cast<int>((remaining + msPerSecond - 1) / msPerSecond);
 }
 
-void BoilTime::setBoilTime(int boilTime)
-{
-    time = boilTime;
-    if (completed)
-        completed = false;
+bool BoilTime::isStarted() {
+   return this->started;
 }
 
-int BoilTime::getTime()
-{
-    return time;
+bool BoilTime::isCompleted() {
+   return this->completed;
 }
 
-bool BoilTime::isStarted()
-{
-    return started;
+void BoilTime::tick() {
+   int const time = this->getTime();
+   if (time != this->lastTime) {
+      this->lastTime = time;
+      emit BoilTimeChanged();
+   } else if (time == 0) {
+      this->completed = true;
+      emit timesUp();
+   }
+   this->scheduleTick();
+   return;
 }
 
-bool BoilTime::isCompleted()
-{
-    return completed;
+void BoilTime::startTimer() {
+   this->deadline_ms = this->clock.elapsed() + this->stoppedRemaining_ms;
+   this->started = true;
+   this->scheduleTick();
+   return;
 }
 
-void BoilTime::decrementTime()
-{
-    if (time == 0) {
-        emit timesUp();
-        completed = true;
-    }
-    else {
-    time = time - 1;
-    emit BoilTimeChanged();
-    }
+void BoilTime::stopTimer() {
+   this->stoppedRemaining_ms = std::max(this->remaining_ms(), qint64{0});
+   this->timer->stop();
+   this->started = false;
+   return;
 }
 
-void BoilTime::startTimer()
-{
-    timer->start();
-    started = true;
+qint64 BoilTime::remaining_ms() const {
+   if (this->started) {
+      return this->deadline_ms - this->clock.elapsed();
+   }
+   return this->stoppedRemaining_ms;
 }
 
-void BoilTime::stopTimer()
-{
-    timer->stop();
-    started = false;
+void BoilTime::scheduleTick() {
+   //
+   // Wake up when the remaining time next drops to a whole number of seconds, which is when getTime() changes.  Once
+   // the boil is over, we just wake once a second so that alarms can carry on ringing and flashing.
+   //
+   qint64 const remaining = this->remaining_ms();
+   qint64 delay_ms = msPerSecond;
+   if (remaining > 0) {
+      delay_ms = remaining % msPerSecond;
+      if (delay_ms == 0) {
+         delay_ms = msPerSecond;
+      }
+   }
+   this->timer->start(static_cast<int>(delay_ms));
+   return;
 }
@@ -17,38 +17,57 @@
 #define BOILTIME_H
 #pragma once
 
+#include <QElapsedTimer>
 #include <QObject>
 #include <QTimer>
+
 /*!
  * \brief Used by TimerMainDialog and TimerWidget
  *
  * Makes it possible to trigger multiple timers using one QTimer
+ *
+ * Rather than counting down one second per tick (which drifts, because ticks are never exactly a second apart), we
+ * hold the time at which the boil ends on a monotonic clock, and work out the remaining time from that whenever we are
+ * asked.  The one \c QTimer is single-shot, and is set to fire just as the displayed (whole-second) remaining time
+ * changes, so there is one wake-up per displayed second, however many \c TimerWidget objects are listening.
  */
-
-class BoilTime : public QObject
-{
-    Q_OBJECT
+class BoilTime : public QObject {
+   Q_OBJECT
 public:
-    BoilTime(QObject * parent);
-    void setBoilTime(int boilTime);
-    int getTime();
-    bool isStarted();
-    bool isCompleted();
-    void startTimer();
-    void stopTimer();
+   BoilTime(QObject * parent);
+
+   //! \brief Set the remaining boil time in seconds.  If we're running, we carry on counting down from there.
+   void setBoilTime(int boilTime);
+   //! \return Remaining boil time in whole seconds, rounded up (so we only show 0 once the boil is over)
+   int getTime();
+   bool isStarted();
+   bool isCompleted();
+   void startTimer();
+   void stopTimer();
 
 private slots:
-    void decrementTime();
+   void tick();
 
 signals:
-    void BoilTimeChanged();
-    void timesUp();
+   //! Emitted once each time the value returned by \c getTime changes while we are running
+   void BoilTimeChanged();
+   //! Emitted once a second after the boil is over, for as long as we are running
+   void timesUp();
 
 private:
-    QTimer* timer;
-    unsigned int time;
-    bool started;
-    bool completed;
+   qint64 remaining_ms() const;
+   void scheduleTick();
+
+   QTimer * timer;
+   QElapsedTimer clock;
+   //! When running, the value of \c clock at which the boil ends
+   qint64 deadline_ms;
+   //! When stopped, the remaining boil time
+   qint64 stoppedRemaining_ms;
+   //! The value of \c getTime when we last emitted \c BoilTimeChanged
+   int lastTime;
+   bool started;
+   bool completed;
 };
 
 #endif
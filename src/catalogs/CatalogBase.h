@@ -32,6 +32,8 @@
 #include "database/ObjectStoreWrapper.h"
 #include "MainWindow.h"
 #include "model/Ingredient.h"
+#include "PersistentSettings.h"
+#include "tableModels/PagedCatalogModel.h"
 #include "utils/CuriouslyRecurringTemplateBase.h"
 
 // TBD: Double-click does different things depending on whether you're looking at list of things in a recipe or
@@ -88,6 +90,10 @@
  *        There is not much to the rest of the derived class (eg HopDialog).
  *
  *        † Not the greatest name, but `new` is a reserved word and `create` is already taken by QWidget
+ *
+ *        If the \c pagedCatalogs setting is on, the table shows a \c PagedCatalogModel (which queries the database for
+ *        one page of rows at a time and so copes with very large catalogs) instead of the sort/filter proxy over a
+ *        \c NeTableModel holding every object in the store.
  */
 template<class Derived> class CatalogPhantom;
 template<class Derived, class NE, class NeTableModel, class NeSortFilterProxyModel, class NeEditor>
@@ -110,12 +116,20 @@ public:
       m_pushButton_edit       {new QPushButton(&this->derived())        },
       m_pushButton_remove     {new QPushButton(&this->derived())        },
       m_neTableModel          {new NeTableModel(m_tableWidget, false)   },
-      m_neTableProxy          {new NeSortFilterProxyModel(m_tableWidget)} {
+      m_neTableProxy          {new NeSortFilterProxyModel(m_tableWidget)},
+      m_pagedModel            {
+         PersistentSettings::value(PersistentSettings::Names::pagedCatalogs, false).toBool() ?
+            new PagedCatalogModel<NeTableModel, NE>(*m_neTableModel, m_tableWidget) : nullptr
+      } {
 
 ///      this->enableEditableInventory();
       m_neTableProxy->setSourceModel(m_neTableModel);
 
-      m_tableWidget->setModel(m_neTableProxy);
+      if (m_pagedModel) {
+         m_tableWidget->setModel(m_pagedModel);
+      } else {
+         m_tableWidget->setModel(m_neTableProxy);
+      }
       m_tableWidget->setSortingEnabled(true);
       m_tableWidget->sortByColumn(static_cast<int>(NeTableModel::ColumnIndex::Name), Qt::AscendingOrder);
       m_neTableProxy->setDynamicSortFilter(true);
@@ -174,12 +188,25 @@ public:
       this->derived().connect(m_tableWidget           , &QAbstractItemView::doubleClicked, &this->derived(), &Derived::addItem    );
       this->derived().connect(m_qLineEdit_searchBox   , &QLineEdit::textEdited,            &this->derived(), &Derived::filterItems);
 
-      m_neTableModel->observeDatabase(true);
+      // In paged mode, m_pagedModel only puts the objects it is showing into m_neTableModel
+      if (!m_pagedModel) {
+         m_neTableModel->observeDatabase(true);
+      }
 
       return;
    }
    virtual ~CatalogBase() = default;
 
+   /**
+    * \return The object in the row of \c viewIndex (an index in \c m_tableWidget), or \c nullptr if there isn't one
+    */
+   std::shared_ptr<NE> itemAt(QModelIndex const & viewIndex) const {
+      if (m_pagedModel) {
+         return m_pagedModel->getRow(viewIndex.row());
+      }
+      return m_neTableModel->getRow(m_neTableProxy->mapToSource(viewIndex).row());
+   }
+
 ///   QPushButton * createAddToRecipeButton() requires IsTableModel<NeTableModel> && HasInventory<NeTableModel> {
 ///      return new QPushButton(&this->derived());
 ///   }
@@ -230,7 +257,7 @@ public:
       // Substantive version - for FermentableCatalog, HopCatalog, MiscCatalog, YeastCatalog
       //
       qDebug() << Q_FUNC_INFO << "Index: " << index;
-      QModelIndex translated;
+      QModelIndex viewIndex;
 
       // If there is no provided index, get the selected index.
       if (!index.isValid()) {
@@ -249,19 +276,22 @@ public:
             }
          }
 
-         translated = m_neTableProxy->mapToSource(selected[0]);
+         viewIndex = selected[0];
       } else {
          // Only respond if the name is selected.  Since we connect to double-click signal, this keeps us from adding
          // something to the recipe when we just want to edit one of the other fields.
          if (index.column() == static_cast<int>(NeTableModel::ColumnIndex::Name)) {
-            translated = m_neTableProxy->mapToSource(index);
+            viewIndex = index;
          } else {
             return;
          }
       }
 
-      qDebug() << Q_FUNC_INFO << "translated.row(): " << translated.row();
-      m_parent->addIngredientToRecipe(*m_neTableModel->getRow(translated.row()));
+      qDebug() << Q_FUNC_INFO << "viewIndex.row(): " << viewIndex.row();
+      auto ingredient = this->itemAt(viewIndex);
+      if (ingredient) {
+         m_parent->addIngredientToRecipe(*ingredient);
+      }
 
       return;
    }
@@ -293,9 +323,10 @@ public:
          }
       }
 
-      QModelIndex translated = m_neTableProxy->mapToSource(selected[0]);
-      auto ingredient = m_neTableModel->getRow(translated.row());
-      ObjectStoreWrapper::softDelete(*ingredient);
+      auto ingredient = this->itemAt(selected[0]);
+      if (ingredient) {
+         ObjectStoreWrapper::softDelete(*ingredient);
+      }
       return;
    }
 
@@ -318,8 +349,10 @@ public:
          }
       }
 
-      QModelIndex translated = m_neTableProxy->mapToSource(selected[0]);
-      auto ingredient = m_neTableModel->getRow(translated.row());
+      auto ingredient = this->itemAt(selected[0]);
+      if (!ingredient) {
+         return;
+      }
       m_neEditor->setEditItem(ingredient);
       m_neEditor->show();
       return;
@@ -357,8 +390,11 @@ public:
     * \brief Subclass should call this from its \c filterItems slot
     */
    void filter(QString searchExpression) {
-      m_neTableProxy->setFilterCaseSensitivity(Qt::CaseInsensitive);
-      m_neTableProxy->setFilterFixedString(searchExpression);
+      if (m_pagedModel) {
+         m_pagedModel->setNameFilter(searchExpression);
+      } else {
+         m_neTableProxy->setNameFilter(searchExpression);
+      }
       return;
    }
 
@@ -385,6 +421,8 @@ public:
 
    NeTableModel *           m_neTableModel;
    NeSortFilterProxyModel * m_neTableProxy;
+   //! Only set if the pagedCatalogs setting is on
+   PagedCatalogModel<NeTableModel, NE> * m_pagedModel;
 };
 
 /**
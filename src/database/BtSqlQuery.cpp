@@ -18,9 +18,13 @@
 #include <stdexcept>
 
 #include <QDebug>
+#include <QElapsedTimer>
+#include <QMap>
 #include <QSqlError>
+#include <QTextStream>
 
 #include "Logging.h"
+#include "utils/Diagnostics.h"
 
 bool BtSqlQuery::prepare(const QString & query) {
    //
@@ -29,6 +33,8 @@ bool BtSqlQuery::prepare(const QString & query) {
    //
    this->bt_query = query;
    this->bt_boundValues = false;
+   this->bt_tableName = Diagnostics::tableNameFromSql(query);
+   this->bt_statementShape = Diagnostics::statementShapeOf(query);
 
    // Since we didn't actually call QSqlQuery::prepare() (yet), there's no possibility of an error to return
    return true;
@@ -40,8 +46,9 @@ void BtSqlQuery::reallyPrepare() {
    if (!this->bt_boundValues) {
       this->bt_boundValues = true;
       if (!this->QSqlQuery::prepare(this->bt_query)) {
-         qCritical() << Q_FUNC_INFO << "Call to QSqlQuery::prepare() failed: " << this->lastError().text();
-         qCritical().noquote() << Q_FUNC_INFO << Logging::getStackTrace();
+         qCCritical(Logging::database) <<
+            Q_FUNC_INFO << "Call to QSqlQuery::prepare() failed: " << this->lastError().text();
+         qCCritical(Logging::database).noquote() << Q_FUNC_INFO << Logging::getStackTrace();
          throw std::runtime_error(this->lastError().text().toStdString());
       }
    }
@@ -71,6 +78,8 @@ void BtSqlQuery::bindValue(int pos, const QVariant &val, QSql::ParamType paramTy
    *        as a parameter
    */
 bool BtSqlQuery::exec() {
+   QElapsedTimer timer;
+   timer.start();
    bool result;
    if (this->bt_boundValues) {
       result = this->QSqlQuery::exec();
@@ -79,9 +88,27 @@ bool BtSqlQuery::exec() {
       // pass it to QSqlQuery for execution
       result = this->QSqlQuery::exec(this->bt_query);
    }
+   qint64 const duration_ns = timer.nsecsElapsed();
+   if (Diagnostics::recordSqlStatement(this->bt_tableName, this->bt_statementShape, duration_ns)) {
+      qCWarning(Logging::database).noquote() <<
+         Q_FUNC_INFO << "Slow SQL statement took" << duration_ns / 1000000 << "ms:" << this->bt_query <<
+         "\nBind values:\n" << BoundValuesToString(*this);
+   }
 
    // If someone wants to reuse the object, eg to insert multiple rows with the same query, it's already in the correct
    // state (whether or not there were bound variables, so we're done here.
 
    return result;
 }
+
+QString BoundValuesToString(BtSqlQuery const & sqlQuery) {
+   QString result;
+   QTextStream resultAsStream{&result};
+
+   QMap<QString, QVariant> boundValueMap = sqlQuery.boundValues();
+   for (auto bv = boundValueMap.begin(); bv != boundValueMap.end(); ++bv) {
+      resultAsStream << bv.key() << ": " << bv.value().toString() << "\n";
+   }
+
+   return result;
+}
@@ -68,7 +68,8 @@ public:
 
    /**
     * \brief As \c QSqlQuery::exec() except that if no values were bound to the query, we pass the SQL from \c prepare()
-    *        as a parameter
+    *        as a parameter.  We also time the statement for \c Diagnostics, and log it, with its bound values, if it
+    *        was slow.
     */
    bool exec();
 
@@ -76,10 +77,23 @@ private:
    // We need to be careful about names to avoid clashes with anything in the base class
    QString bt_query;
    bool bt_boundValues = false;
+   //! For Diagnostics, worked out once per query we prepare, rather than every time it is executed
+   QString bt_tableName;
+   //! Ditto
+   QString bt_statementShape;
 
    void reallyPrepare();
 
 
 };
 
+/**
+ * \brief Return a string containing all the bound values on a query.   This is quite a useful thing to have logged
+ *        when you get an error!
+ *
+ *        NOTE: This can be a long string.  It includes newlines, and is intended to be logged with
+ *              qCDebug(Logging::database).noquote() or similar.
+ */
+QString BoundValuesToString(BtSqlQuery const & sqlQuery);
+
 #endif
@@ -0,0 +1,279 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * database/ChangeLog.cpp is part of Brewtarget, and is copyright the following authors 2024:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#include "database/ChangeLog.h"
+
+#include <memory>
+
+#include <QDateTime>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSqlError>
+#include <QStringList>
+#include <QUuid>
+#include <QVariant>
+
+#include "database/BtSqlQuery.h"
+#include "database/Database.h"
+#include "database/DbTransaction.h"
+#include "Logging.h"
+
+namespace {
+   QLatin1String const changeTableName{"object_change"};
+   QLatin1String const uuidTableName{"object_uuid"};
+
+   //
+   // As with the prepared UPDATE queries in ObjectStore.cpp, each thread has its own DB connection, so keying on
+   // connection name means a given query object is only ever used from the thread that created it.  The mutex is just
+   // to protect the hash itself.
+   //
+   QMutex preparedRecordQueriesMutex;
+   QHash<QString, std::shared_ptr<BtSqlQuery>> preparedRecordQueries;
+
+   std::shared_ptr<BtSqlQuery> getPreparedRecordQuery(QSqlDatabase & connection) {
+      QMutexLocker locker(&preparedRecordQueriesMutex);
+      auto cachedQuery = preparedRecordQueries.find(connection.connectionName());
+      if (cachedQuery != preparedRecordQueries.end()) {
+         return cachedQuery.value();
+      }
+
+      //
+      // Both SQLite (from 3.24) and PostgreSQL (from 9.5) support this "upsert" syntax, which saves us a SELECT to find
+      // out whether there is already a row for the object.
+      //
+      auto sqlQuery = std::make_shared<BtSqlQuery>(connection);
+      sqlQuery->prepare(
+         QString("INSERT INTO %1 (table_name, object_id, change_counter, changed_at_ms, hard_deleted, name) "
+                 "VALUES (?, ?, (SELECT COALESCE(MAX(change_counter), 0) + 1 FROM %1), ?, ?, ?) "
+                 "ON CONFLICT (table_name, object_id) DO UPDATE SET "
+                 "change_counter = excluded.change_counter, "
+                 "changed_at_ms = excluded.changed_at_ms, "
+                 "hard_deleted = excluded.hard_deleted, "
+                 "name = excluded.name").arg(changeTableName)
+      );
+      preparedRecordQueries.insert(connection.connectionName(), sqlQuery);
+      return sqlQuery;
+   }
+
+   bool record(QSqlDatabase & connection,
+               QString const & tableName,
+               int const objectId,
+               bool const hardDeleted,
+               QString const & name) {
+      std::shared_ptr<BtSqlQuery> sqlQuery = getPreparedRecordQuery(connection);
+      sqlQuery->bindValue(0, tableName);
+      sqlQuery->bindValue(1, objectId);
+      sqlQuery->bindValue(2, QDateTime::currentMSecsSinceEpoch());
+      sqlQuery->bindValue(3, hardDeleted);
+      sqlQuery->bindValue(4, name);
+
+      bool const succeeded = sqlQuery->exec();
+      if (!succeeded) {
+         qCCritical(Logging::database) <<
+            Q_FUNC_INFO << "Error recording change to" << tableName << "#" << objectId << ":" <<
+            sqlQuery->lastError().text();
+      }
+      sqlQuery->finish();
+      return succeeded;
+   }
+}
+
+bool ChangeLog::createTables(Database & database, QSqlDatabase & connection) {
+   QStringList const queries{
+      QString("CREATE TABLE IF NOT EXISTS %1 ("
+              "table_name TEXT NOT NULL, "
+              "object_id INTEGER NOT NULL, "
+              "change_counter BIGINT NOT NULL, "
+              "changed_at_ms BIGINT NOT NULL, "
+              "hard_deleted %2 NOT NULL, "
+              "name TEXT, "
+              "PRIMARY KEY (table_name, object_id))").arg(changeTableName, database.getDbNativeTypeName<bool>()),
+      // Both finding the next counter and finding changes since a given counter go by this column
+      QString("CREATE INDEX IF NOT EXISTS %1_counter_idx ON %1 (change_counter)").arg(changeTableName),
+      QString("CREATE TABLE IF NOT EXISTS %1 ("
+              "table_name TEXT NOT NULL, "
+              "object_id INTEGER NOT NULL, "
+              "uuid TEXT NOT NULL UNIQUE, "
+              "PRIMARY KEY (table_name, object_id))").arg(uuidTableName),
+   };
+   BtSqlQuery sqlQuery{connection};
+   for (QString const & query : queries) {
+      if (!sqlQuery.exec(query)) {
+         qCCritical(Logging::database) <<
+            Q_FUNC_INFO << "Error creating change log table:" << sqlQuery.lastError().text() << "(Query:" << query <<
+            ")";
+         return false;
+      }
+   }
+   return true;
+}
+
+bool ChangeLog::recordChange(QSqlDatabase & connection, QString const & tableName, int const objectId) {
+   return record(connection, tableName, objectId, false, QString{});
+}
+
+bool ChangeLog::recordHardDelete(QSqlDatabase & connection,
+                                 QString const & tableName,
+                                 int const objectId,
+                                 QString const & name) {
+   return record(connection, tableName, objectId, true, name);
+}
+
+void ChangeLog::clearPreparedStatementCache(QString const & connectionName) {
+   QMutexLocker locker(&preparedRecordQueriesMutex);
+   if (connectionName.isEmpty()) {
+      preparedRecordQueries.clear();
+   } else {
+      preparedRecordQueries.remove(connectionName);
+   }
+   return;
+}
+
+qint64 ChangeLog::latestCounter() {
+   QSqlDatabase connection = Database::instance().sqlDatabase();
+   BtSqlQuery sqlQuery{connection};
+   QString const query = QString("SELECT COALESCE(MAX(change_counter), 0) FROM %1").arg(changeTableName);
+   if (!sqlQuery.exec(query) || !sqlQuery.next()) {
+      qCWarning(Logging::database) << Q_FUNC_INFO << "Could not read change counter:" << sqlQuery.lastError().text();
+      return 0;
+   }
+   return sqlQuery.value(0).toLongLong();
+}
+
+QVector<ChangeLog::Entry> ChangeLog::changesSince(qint64 const counter) {
+   QVector<ChangeLog::Entry> changes;
+   QSqlDatabase connection = Database::instance().sqlDatabase();
+   BtSqlQuery sqlQuery{connection};
+   sqlQuery.prepare(
+      QString("SELECT table_name, object_id, change_counter, changed_at_ms, hard_deleted, name FROM %1 "
+              "WHERE change_counter > ? ORDER BY change_counter").arg(changeTableName)
+   );
+   sqlQuery.bindValue(0, counter);
+   if (!sqlQuery.exec()) {
+      qCWarning(Logging::database) <<
+         Q_FUNC_INFO << "Could not read changes since" << counter << ":" << sqlQuery.lastError().text();
+      return changes;
+   }
+   while (sqlQuery.next()) {
+      changes.append(ChangeLog::Entry{sqlQuery.value(0).toString(),
+                                      sqlQuery.value(1).toInt(),
+                                      sqlQuery.value(2).toLongLong(),
+                                      sqlQuery.value(3).toLongLong(),
+                                      sqlQuery.value(4).toBool(),
+                                      sqlQuery.value(5).toString()});
+   }
+   return changes;
+}
+
+qint64 ChangeLog::changedAt_ms(QString const & tableName, int const objectId) {
+   BtSqlQuery sqlQuery{Database::instance().sqlDatabase()};
+   sqlQuery.prepare(
+      QString("SELECT changed_at_ms FROM %1 WHERE table_name = ? AND object_id = ?").arg(changeTableName)
+   );
+   sqlQuery.bindValue(0, tableName);
+   sqlQuery.bindValue(1, objectId);
+   if (!sqlQuery.exec() || !sqlQuery.next()) {
+      return 0;
+   }
+   return sqlQuery.value(0).toLongLong();
+}
+
+QHash<int, QString> ChangeLog::uuidsFor(QString const & tableName, QVector<int> const & objectIds) {
+   QHash<int, QString> uuids;
+   if (objectIds.isEmpty()) {
+      return uuids;
+   }
+
+   //
+   // Reading all the UUIDs for the table in one go is quicker than one query per object, even if we only need a few of
+   // them
+   //
+   Database & database = Database::instance();
+   QSqlDatabase connection = database.sqlDatabase();
+   BtSqlQuery selectQuery{connection};
+   selectQuery.prepare(QString("SELECT object_id, uuid FROM %1 WHERE table_name = ?").arg(uuidTableName));
+   selectQuery.bindValue(0, tableName);
+   if (!selectQuery.exec()) {
+      qCWarning(Logging::database) <<
+         Q_FUNC_INFO << "Could not read UUIDs for" << tableName << ":" << selectQuery.lastError().text();
+      return uuids;
+   }
+   QHash<int, QString> allUuids;
+   while (selectQuery.next()) {
+      allUuids.insert(selectQuery.value(0).toInt(), selectQuery.value(1).toString());
+   }
+
+   DbTransaction dbTransaction{database, connection, QString("Assign UUIDs in %1").arg(tableName)};
+   BtSqlQuery insertQuery{connection};
+   insertQuery.prepare(QString("INSERT INTO %1 (table_name, object_id, uuid) VALUES (?, ?, ?)").arg(uuidTableName));
+   for (int const objectId : objectIds) {
+      QString uuid = allUuids.value(objectId);
+      if (uuid.isEmpty()) {
+         uuid = QUuid::createUuid().toString(QUuid::WithoutBraces);
+         insertQuery.bindValue(0, tableName);
+         insertQuery.bindValue(1, objectId);
+         insertQuery.bindValue(2, uuid);
+         if (!insertQuery.exec()) {
+            qCWarning(Logging::database) <<
+               Q_FUNC_INFO << "Could not assign UUID to" << tableName << "#" << objectId << ":" <<
+               insertQuery.lastError().text();
+            return QHash<int, QString>{};
+         }
+         allUuids.insert(objectId, uuid);
+      }
+      uuids.insert(objectId, uuid);
+   }
+   dbTransaction.commit();
+   return uuids;
+}
+
+int ChangeLog::objectIdFor(QString const & tableName, QString const & uuid) {
+   BtSqlQuery sqlQuery{Database::instance().sqlDatabase()};
+   sqlQuery.prepare(QString("SELECT object_id FROM %1 WHERE table_name = ? AND uuid = ?").arg(uuidTableName));
+   sqlQuery.bindValue(0, tableName);
+   sqlQuery.bindValue(1, uuid);
+   if (!sqlQuery.exec() || !sqlQuery.next()) {
+      return -1;
+   }
+   return sqlQuery.value(0).toInt();
+}
+
+bool ChangeLog::adoptUuid(QString const & tableName, int const objectId, QString const & uuid) {
+   Database & database = Database::instance();
+   QSqlDatabase connection = database.sqlDatabase();
+   DbTransaction dbTransaction{database, connection, QString("Adopt UUID in %1").arg(tableName)};
+
+   // Both the UUID and the object can only appear once in the table, so clear out whatever either was attached to
+   BtSqlQuery deleteQuery{connection};
+   deleteQuery.prepare(
+      QString("DELETE FROM %1 WHERE uuid = ? OR (table_name = ? AND object_id = ?)").arg(uuidTableName)
+   );
+   deleteQuery.bindValue(0, uuid);
+   deleteQuery.bindValue(1, tableName);
+   deleteQuery.bindValue(2, objectId);
+   BtSqlQuery insertQuery{connection};
+   insertQuery.prepare(QString("INSERT INTO %1 (table_name, object_id, uuid) VALUES (?, ?, ?)").arg(uuidTableName));
+   insertQuery.bindValue(0, tableName);
+   insertQuery.bindValue(1, objectId);
+   insertQuery.bindValue(2, uuid);
+   if (!deleteQuery.exec() || !insertQuery.exec()) {
+      qCWarning(Logging::database) <<
+         Q_FUNC_INFO << "Could not give" << tableName << "#" << objectId << "UUID" << uuid << ":" <<
+         connection.lastError().text();
+      return false;
+   }
+   return dbTransaction.commit();
+}
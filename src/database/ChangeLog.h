@@ -0,0 +1,137 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * database/ChangeLog.h is part of Brewtarget, and is copyright the following authors 2024:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#ifndef DATABASE_CHANGELOG_H
+#define DATABASE_CHANGELOG_H
+#pragma once
+
+#include <QHash>
+#include <QSqlDatabase>
+#include <QString>
+#include <QVector>
+
+class Database;
+
+/**
+ * \brief Record of which rows of which tables have changed, so that a delta export (see
+ *        \c ImportExport::exportChangesSince) can pick out just what has changed since the last one, eg for a nightly
+ *        sync between two sites.
+ *
+ *        Rather than add change-tracking columns to every table, we keep one row per changed object in a separate
+ *        table, keyed by table name and primary key.  Each time an object is inserted, updated (including being soft
+ *        deleted) or hard deleted, its row gets the next value of a DB-wide change counter.  A hard-deleted object's
+ *        row stays as a tombstone, with the object's name, as the object itself is no longer there to tell us what it
+ *        was.
+ *
+ *        The counter is just the highest one in the table plus one, so it only goes up, and there's no separate
+ *        sequence to keep in step with the table.  Rows for objects written out to a new DB with their existing keys
+ *        (see \c ObjectStore::writeAllToNewDb) are not recorded, as that is a copy rather than a change.
+ *
+ *        So that the same object can be recognised in two databases, where it will have different primary keys, each
+ *        object that has been in a delta export also has a UUID, kept in a second table.  An object imported from
+ *        another database takes on the UUID it had there (see \c adoptUuid), so both databases then know it by the same
+ *        one.
+ *
+ *        The record functions are called by \c ObjectStore as part of each write, on the same connection (and so in
+ *        the same transaction), so they can be called from any thread.
+ */
+namespace ChangeLog {
+
+   /**
+    * \brief Create the table that holds the change records.  This is done as part of \c CreateAllDatabaseTables, and
+    *        when upgrading an existing database.  Note that it is the caller's responsibility to handle transactions.
+    *
+    * \return \c false if something went wrong, \c true otherwise
+    */
+   bool createTables(Database & database, QSqlDatabase & connection);
+
+   /**
+    * \brief Record that the row with primary key \c objectId in table \c tableName has been inserted or updated.
+    *
+    *        NB: Caller is responsible for handling transactions
+    *
+    * \return \c true if succeeded, \c false otherwise
+    */
+   bool recordChange(QSqlDatabase & connection, QString const & tableName, int const objectId);
+
+   /**
+    * \brief Record that the row with primary key \c objectId in table \c tableName, which was the object named
+    *        \c name, has been hard deleted.
+    *
+    *        NB: Caller is responsible for handling transactions
+    *
+    * \return \c true if succeeded, \c false otherwise
+    */
+   bool recordHardDelete(QSqlDatabase & connection,
+                         QString const & tableName,
+                         int const objectId,
+                         QString const & name);
+
+   /**
+    * \brief The record queries are prepared once per DB connection.  This discards them for the connection named
+    *        \c connectionName (or for all connections if it is empty).  Called from
+    *        \c ObjectStore::clearPreparedStatementCache.
+    */
+   void clearPreparedStatementCache(QString const & connectionName);
+
+   struct Entry {
+      QString tableName;
+      int     objectId;
+      qint64  changeCounter;
+      qint64  changedAt_ms;
+      //! If \c true, the object no longer exists, and \c name is what it was called
+      bool    hardDeleted;
+      QString name;
+   };
+
+   /**
+    * \return The counter of the most recent change, or 0 if nothing has been recorded.  This is what to pass to
+    *         \c changesSince next time to get everything that has changed after now.
+    */
+   qint64 latestCounter();
+
+   /**
+    * \return The latest change to each object that has changed after \c counter, in counter order
+    */
+   QVector<Entry> changesSince(qint64 const counter);
+
+   /**
+    * \return When the object with primary key \c objectId in table \c tableName last changed (as milliseconds since
+    *         the epoch), or 0 if it hasn't been recorded as changing
+    */
+   qint64 changedAt_ms(QString const & tableName, int const objectId);
+
+   /**
+    * \return The UUID of each of the objects with primary keys \c objectIds in table \c tableName, first giving a new
+    *         one to any that don't yet have one
+    */
+   QHash<int, QString> uuidsFor(QString const & tableName, QVector<int> const & objectIds);
+
+   /**
+    * \return Primary key of the object in table \c tableName with UUID \c uuid, or -1 if there isn't one
+    */
+   int objectIdFor(QString const & tableName, QString const & uuid);
+
+   /**
+    * \brief Give the object with primary key \c objectId in table \c tableName the UUID \c uuid, taking it from any
+    *        other object that had it (eg an older version of an object that the one we've just imported replaces).
+    *
+    * \return \c true if succeeded, \c false otherwise
+    */
+   bool adoptUuid(QString const & tableName, int const objectId, QString const & uuid);
+
+}
+
+#endif
@@ -36,33 +36,53 @@
  ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
 #include "database/Database.h"
 
+#include <algorithm>
+#include <atomic>
 #include <filesystem>
 #include <iostream> // For writing to std::cerr in destructor
 #include <mutex>    // For std::once_flag etc
 
 #include <QDateTime>
 #include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QEventLoop>
 #include <QFile>
 #include <QFileInfo>
+#include <QHash>
 #include <QInputDialog>
 #include <QList>
 #include <QMessageBox>
 #include <QMutex>
 #include <QMutexLocker>
 #include <QObject>
+#include <QProgressDialog>
 #include <QSqlDriver>
 #include <QSqlError>
 #include <QSqlField>
+#include <QSqlRecord>
 #include <QString>
+#include <QStringList>
+#include <QTextStream>
 #include <QThread>
+#include <QThreadPool>
+#include <QTimer>
+#include <QVector>
 
 #include "Application.h"
 #include "config.h"
 #include "database/BtSqlQuery.h"
 #include "database/DefaultContentLoader.h"
 #include "database/DatabaseSchemaHelper.h"
+#include "database/DbTransaction.h"
+#include "database/ObjectStore.h"
+#include "database/ObjectStoreTyped.h"
+#include "database/RecipeCalculationCache.h"
+#include "database/SensorReadings.h"
+#include "Logging.h"
 #include "PersistentSettings.h"
 #include "utils/BtStringConst.h"
+#include "utils/Diagnostics.h"
 #include "utils/EnumStringMapping.h"
 #include "utils/ErrorCodeToStream.h"
 
@@ -136,7 +156,7 @@ namespace {
          case Database::DbType::PGSQL:  return dbNativeVariants.postgresqlName;
          default:
             // It's a coding error if we get here
-            qCritical() << Q_FUNC_INFO << "Unrecognised DB type:" << dbType;
+            qCCritical(Logging::database) << Q_FUNC_INFO << "Unrecognised DB type:" << dbType;
             Q_ASSERT(false);
             break;
       }
@@ -170,6 +190,207 @@ namespace {
    //
    Database::DbType currentDbType = Database::DbType::NODB;
 
+   //
+   // How often we check that a PostgreSQL connection still works (see impl::checkConnection).  Checking costs a round
+   // trip to the server, so we don't want to do it every time a connection is used.
+   //
+   constexpr qint64 connectionHealthCheckInterval_ms = 30 * 1000;
+
+   //! Used if the dbConnectTimeoutSeconds setting does not say otherwise
+   constexpr int defaultConnectTimeout_s = 10;
+
+   /**
+    * \brief If a connection test has not finished this long after the connect timeout, we stop waiting for it.  (The
+    *        timeout is enforced by the PostgreSQL client library, but does not, eg, cover looking up the host name.)
+    */
+   constexpr int connectTestGracePeriod_s = 5;
+
+   int connectTimeout_s() {
+      int const timeout_s = PersistentSettings::value(PersistentSettings::Names::dbConnectTimeoutSeconds,
+                                                      defaultConnectTimeout_s).toInt();
+      // For PostgreSQL, zero means wait forever, which is what we are trying to avoid
+      return std::max(timeout_s, 1);
+   }
+
+   /**
+    * \return Connect options for a PostgreSQL connection, so that failing to reach the server is reported after the
+    *         connect timeout rather than whenever the operating system gives up on the TCP connection (which can be
+    *         minutes).
+    */
+   QString postgresConnectOptions() {
+      return QString{"connect_timeout=%1"}.arg(connectTimeout_s());
+   }
+
+   //! Shared between \c testConnectionInBackground and the worker it starts, which can outlive it if the user cancels
+   struct ConnectionTest {
+      std::atomic<bool> finished = false;
+      // Only read once finished is true
+      bool succeeded = false;
+      QString errorText;
+   };
+
+   /**
+    * \brief Try to open (and then close again) a connection with the given details.  Opening a connection to an
+    *        unreachable server blocks until the connect timeout, so we do it on a worker thread and keep the event
+    *        loop running while we wait.  In interactive mode, a progress dialog with a Cancel button is shown.
+    *
+    * \param hostname For SQLite, the DB file name; for PostgreSQL, the server
+    * \param errorText Set to why we could not connect, if we couldn't
+    *
+    * \return \c true if we connected, \c false if we could not, or gave up waiting, or the user cancelled
+    */
+   bool testConnectionInBackground(Database::DbType const dbType,
+                                   QString const & hostname,
+                                   int const portnum,
+                                   QString const & databaseName,
+                                   QString const & username,
+                                   QString const & password,
+                                   QString & errorText) {
+      // Each test needs its own connection name, as a worker we stopped waiting for might still be using its one
+      static std::atomic<int> numTests = 0;
+      QString const connectionName = QString{"testConnDb%1"}.arg(++numTests);
+      QString const connectOptions = postgresConnectOptions();
+      int const maxWait_ms = (connectTimeout_s() + connectTestGracePeriod_s) * 1000;
+
+      auto connectionTest = std::make_shared<ConnectionTest>();
+      QThreadPool::globalInstance()->start(QRunnable::create([=]() {
+         {
+            // Extra braces here are to ensure that this QSqlDatabase object is out of scope before the call to
+            // QSqlDatabase::removeDatabase() below
+            QSqlDatabase connDb = QSqlDatabase::addDatabase(dbType == Database::DbType::PGSQL ? "QPSQL" : "QSQLITE",
+                                                            connectionName);
+            if (dbType == Database::DbType::PGSQL) {
+               connDb.setHostName(hostname);
+               connDb.setPort(portnum);
+               connDb.setDatabaseName(databaseName);
+               connDb.setUserName(username);
+               connDb.setPassword(password);
+               connDb.setConnectOptions(connectOptions);
+            } else {
+               connDb.setDatabaseName(hostname);
+            }
+            connectionTest->succeeded = connDb.open();
+            if (connectionTest->succeeded) {
+               connDb.close();
+            } else {
+               connectionTest->errorText = connDb.lastError().text();
+            }
+         }
+         QSqlDatabase::removeDatabase(connectionName);
+         connectionTest->finished = true;
+         return;
+      }));
+
+      std::unique_ptr<QProgressDialog> progressDialog;
+      if (Application::isInteractive()) {
+         progressDialog = std::make_unique<QProgressDialog>(Database::tr("Connecting to %1...").arg(hostname),
+                                                            Database::tr("Cancel"),
+                                                            0,
+                                                            0);
+         progressDialog->setWindowModality(Qt::ApplicationModal);
+         progressDialog->setMinimumDuration(0);
+         progressDialog->show();
+      }
+
+      QElapsedTimer waitTimer;
+      waitTimer.start();
+      QEventLoop eventLoop;
+      QTimer pollTimer;
+      QObject::connect(&pollTimer, &QTimer::timeout, &eventLoop, [&]() {
+         if (connectionTest->finished ||
+             waitTimer.hasExpired(maxWait_ms) ||
+             (progressDialog && progressDialog->wasCanceled())) {
+            eventLoop.quit();
+         }
+         return;
+      });
+      pollTimer.start(50);
+      eventLoop.exec();
+
+      if (!connectionTest->finished) {
+         // The worker carries on in the background until the connection attempt times out, but we don't care about
+         // its result any more
+         errorText = progressDialog && progressDialog->wasCanceled() ?
+            Database::tr("Cancelled") : Database::tr("Timed out after %1 seconds").arg(maxWait_ms / 1000);
+         qCWarning(Logging::database) << Q_FUNC_INFO << "Gave up connecting to" << hostname << ":" << errorText;
+         return false;
+      }
+      if (!connectionTest->succeeded) {
+         errorText = connectionTest->errorText;
+      }
+      return connectionTest->succeeded;
+   }
+
+   struct SqlitePragma {
+      char const * sql;
+      //! For error messages: "Could not ..."
+      char const * purpose;
+   };
+
+   //
+   // How we set up the main SQLite connection.  This can be chosen with the sqliteConnectionProfile setting:
+   //
+   //    "exclusive" (the default) is what we have always done.  Turning off synchronous writes reduces query time by
+   //                an order of magnitude, and holding an exclusive lock saves a bit more, but the DB can be corrupted
+   //                if power is lost at the wrong moment, and nothing else can read the DB while we have it open.
+   //
+   //    "wal" uses a write-ahead log (see https://www.sqlite.org/wal.html).  With synchronous=NORMAL, commits do not
+   //          wait for the disk either, but the DB stays consistent after a power cut (at worst losing the last few
+   //          transactions), and other processes (eg reporting tools) can read the DB while we are writing to it.
+   //          Using memory mapped I/O and a bigger page cache gets back most of the speed.  SQLite checkpoints the log
+   //          into the main DB file automatically as it grows (we set the default threshold explicitly to make this
+   //          clear), and when the last connection closes.
+   //
+   // Note that journal_mode=WAL is a property of the DB file, so other connections (eg on other threads) also use the
+   // write-ahead log.  The other settings only apply to the connection we run them on.
+   //
+   QVector<SqlitePragma> const exclusiveSqlitePragmas {
+      {"PRAGMA journal_mode = DELETE"   , "use rollback journal"        },
+      {"PRAGMA synchronous = off"       , "disable synchronous writes"  },
+      {"PRAGMA foreign_keys = on"       , "enable foreign keys"         },
+      {"PRAGMA locking_mode = EXCLUSIVE", "enable exclusive locks"      },
+      {"PRAGMA temp_store = MEMORY"     , "enable temporary memory"     },
+   };
+   QVector<SqlitePragma> const walSqlitePragmas {
+      {"PRAGMA journal_mode = WAL"      , "enable write-ahead log"      },
+      {"PRAGMA synchronous = NORMAL"    , "set synchronous writes"      },
+      {"PRAGMA foreign_keys = on"       , "enable foreign keys"         },
+      {"PRAGMA temp_store = MEMORY"     , "enable temporary memory"     },
+      // 256 MiB
+      {"PRAGMA mmap_size = 268435456"   , "enable memory-mapped I/O"    },
+      // Negative values are in KiB, so this is 64 MiB
+      {"PRAGMA cache_size = -65536"     , "set cache size"              },
+      // Pages
+      {"PRAGMA wal_autocheckpoint = 1000", "set write-ahead log checkpoints"},
+   };
+
+   //! \return The SQLite pragmas for the profile selected in PersistentSettings
+   QVector<SqlitePragma> const & sqlitePragmas() {
+      QString const profile = PersistentSettings::value(PersistentSettings::Names::sqliteConnectionProfile,
+                                                        "exclusive").toString();
+      if (profile == "wal") {
+         return walSqlitePragmas;
+      }
+      if (profile != "exclusive") {
+         qCWarning(Logging::database) <<
+            Q_FUNC_INFO << "Unrecognised SQLite connection profile" << profile << "- using exclusive";
+      }
+      return exclusiveSqlitePragmas;
+   }
+
+   /**
+    * \return \c value formatted as a CSV field (per RFC 4180), with NULL as an empty unquoted field, so that it can be
+    *         distinguished from an empty string
+    */
+   QString csvField(QVariant const & value) {
+      if (value.isNull()) {
+         return QString{};
+      }
+      QString field = value.toString();
+      field.replace('"', "\"\"");
+      return QString{"\"%1\""}.arg(field);
+   }
+
    // May St. Stevens intercede on my behalf.
    //
    //! \brief opens an SQLite db for transfer
@@ -189,7 +410,7 @@ namespace {
             throw QString("Could not open %1 : %2").arg(filePath).arg(newConnection.lastError().text());
          }
       } catch (QString e) {
-         qCritical() << Q_FUNC_INFO << e;
+         qCCritical(Logging::database) << Q_FUNC_INFO << e;
          throw;
       }
 
@@ -208,12 +429,13 @@ namespace {
          newConnection.setUserName(Username);
          newConnection.setPort(Portnum);
          newConnection.setPassword(Password);
+         newConnection.setConnectOptions(postgresConnectOptions());
 
          if (!newConnection.open()) {
             throw QString("Could not open %1 : %2").arg(Hostname).arg(newConnection.lastError().text());
          }
       } catch (QString e) {
-         qCritical() << Q_FUNC_INFO << e;
+         qCCritical(Logging::database) << Q_FUNC_INFO << e;
          throw;
       }
       return newConnection;
@@ -235,7 +457,9 @@ public:
                                    loaded{false},
                                    loadWasSuccessful{false},
                                    mutex{},
-                                   userDatabaseDidNotExist{false} {
+                                   userDatabaseDidNotExist{false},
+                                   dbReplicaHostname{},
+                                   dbReplicaPortnum{0} {
       return;
    }
 
@@ -246,12 +470,12 @@ public:
 
    // Don't know where to put this, so it goes here for right now
    bool loadSQLite(Database & database) {
-      qDebug() << "Loading SQLITE...";
+      qCDebug(Logging::database) << "Loading SQLITE...";
 
       // Set file names.
       this->dbFileName = PersistentSettings::getUserDataDir().filePath("database.sqlite");
       this->dataDbFileName = Application::getResourceDir().filePath("default_db.sqlite");
-      qInfo().noquote() <<
+      qCInfo(Logging::database).noquote() <<
          Q_FUNC_INFO << "dbFileName = \"" << this->dbFileName << "\"\ndataDbFileName=\"" << this->dataDbFileName << "\"";
       // Set the files.
       this->dbFile.setFileName(this->dbFileName);
@@ -262,6 +486,9 @@ public:
          QFile newdb(QString("%1.new").arg(this->dbFileName));
          if (newdb.exists()) {
             this->dbFile.remove();
+            // Any write-ahead log left over (eg after a crash) belongs to the DB we are replacing, not the new one
+            QFile::remove(QString("%1-wal").arg(this->dbFileName));
+            QFile::remove(QString("%1-shm").arg(this->dbFileName));
             newdb.copy(this->dbFileName);
             QFile::setPermissions(this->dbFileName, QFile::ReadOwner | QFile::WriteOwner | QFile::ReadGroup );
             newdb.remove();
@@ -286,7 +513,7 @@ public:
       QSqlDatabase connection = database.sqlDatabase();
 
       this->dbConName = connection.connectionName();
-      qDebug() << Q_FUNC_INFO << "dbConName=" << this->dbConName;
+      qCDebug(Logging::database) << Q_FUNC_INFO << "dbConName=" << this->dbConName;
 
       //
       // It's quite useful to record the DB version in the logs
@@ -295,30 +522,26 @@ public:
       QString queryString{"SELECT sqlite_version() AS version;"};
       sqlQuery.prepare(queryString);
       if (!sqlQuery.exec() || !sqlQuery.next()) {
-         qCritical() <<
+         qCCritical(Logging::database) <<
             Q_FUNC_INFO << "Error executing database query " << queryString << ": " << sqlQuery.lastError().text();
          return false;
       }
       QVariant fieldValue = sqlQuery.value("version");
-      qInfo() << Q_FUNC_INFO << "SQLite version" << fieldValue;
+      qCInfo(Logging::database) << Q_FUNC_INFO << "SQLite version" << fieldValue;
 
-      // NOTE: synchronous=off reduces query time by an order of magnitude!
+      // See comment in anonymous namespace above for the choice of settings here
       BtSqlQuery pragma(connection);
-      if ( ! pragma.exec( "PRAGMA synchronous = off" ) ) {
-         qCritical() << Q_FUNC_INFO << "Could not disable synchronous writes: " << pragma.lastError().text();
-         return false;
-      }
-      if ( ! pragma.exec( "PRAGMA foreign_keys = on")) {
-         qCritical() << Q_FUNC_INFO << "Could not enable foreign keys: " << pragma.lastError().text();
-         return false;
-      }
-      if ( ! pragma.exec( "PRAGMA locking_mode = EXCLUSIVE")) {
-         qCritical() << Q_FUNC_INFO << "Could not enable exclusive locks: " << pragma.lastError().text();
-         return false;
-      }
-      if ( ! pragma.exec("PRAGMA temp_store = MEMORY") ) {
-         qCritical() << Q_FUNC_INFO << "Could not enable temporary memory: " << pragma.lastError().text();
-         return false;
+      for (auto const & sqlitePragma : sqlitePragmas()) {
+         if (!pragma.exec(sqlitePragma.sql)) {
+            qCCritical(Logging::database) <<
+               Q_FUNC_INFO << "Could not" << sqlitePragma.purpose << ": " << pragma.lastError().text();
+            return false;
+         }
+         // Setting journal_mode returns the new mode, which won't be what we asked for if (eg) the DB file is on a
+         // network drive that can't support a write-ahead log.  This isn't fatal, as the DB still works.
+         if (pragma.next()) {
+            qCInfo(Logging::database) << Q_FUNC_INFO << sqlitePragma.sql << "->" << pragma.value(0).toString();
+         }
       }
 
       // older sqlite databases may not have a settings table. I think I will
@@ -337,8 +560,36 @@ public:
 
       this->dbUsername = PersistentSettings::value(PersistentSettings::Names::dbUsername).toString();
 
+      this->dbReplicaHostname = PersistentSettings::value(PersistentSettings::Names::dbReplicaHostname).toString();
+      this->dbReplicaPortnum  = PersistentSettings::value(PersistentSettings::Names::dbReplicaPortnum,
+                                                          this->dbPortnum).toInt();
+
       if (PersistentSettings::contains(PersistentSettings::Names::dbPassword)) {
          this->dbPassword = PersistentSettings::value(PersistentSettings::Names::dbPassword).toString();
+
+         //
+         // Opening the main connection below happens on this (the GUI) thread, so check first, without blocking, that
+         // we can connect.  Otherwise an unreachable server would freeze the splash screen until the connect timeout.
+         //
+         QString errorText;
+         if (!testConnectionInBackground(Database::DbType::PGSQL,
+                                         this->dbHostname,
+                                         this->dbPortnum,
+                                         this->dbName,
+                                         this->dbUsername,
+                                         this->dbPassword,
+                                         errorText)) {
+            qCCritical(Logging::database) <<
+               Q_FUNC_INFO << "Could not connect to PostgreSQL on" << this->dbHostname << ":" << errorText;
+            if (Application::isInteractive()) {
+               QMessageBox::critical(
+                  nullptr,
+                  tr("Connection failed"),
+                  tr("Could not connect to %1 : %2\n\nProgram will now exit.").arg(this->dbHostname).arg(errorText)
+               );
+            }
+            return false;
+         }
       } else {
          bool isOk = false;
 
@@ -369,7 +620,7 @@ public:
       QSqlDatabase connection = database.sqlDatabase();
 
       this->dbConName = connection.connectionName();
-      qDebug() << Q_FUNC_INFO << "dbConName=" << this->dbConName;
+      qCDebug(Logging::database) << Q_FUNC_INFO << "dbConName=" << this->dbConName;
 
       //
       // It's quite useful to record the DB version in the logs
@@ -378,12 +629,12 @@ public:
       QString queryString{"SELECT version() AS version;"};
       sqlQuery.prepare(queryString);
       if (!sqlQuery.exec() || !sqlQuery.next()) {
-         qCritical() <<
+         qCCritical(Logging::database) <<
             Q_FUNC_INFO << "Error executing database query " << queryString << ": " << sqlQuery.lastError().text();
          return false;
       }
       QVariant fieldValue = sqlQuery.value("version");
-      qInfo() << Q_FUNC_INFO << "PostgreSQL version" << fieldValue;
+      qCInfo(Logging::database) << Q_FUNC_INFO << "PostgreSQL version" << fieldValue;
 
       // by the time we had pgsql support, there is a settings table
       this->createFromScratch = ! connection.tables().contains("settings");
@@ -397,7 +648,7 @@ public:
       auto connection = database.sqlDatabase();
       int dbSchemaVersion = DatabaseSchemaHelper::schemaVersion(connection);
       int latestSchemaVersion = DatabaseSchemaHelper::latestVersion;
-      qInfo() <<
+      qCInfo(Logging::database) <<
          Q_FUNC_INFO << "Schema version in DB:" << dbSchemaVersion << ", current schema version in code:" << latestSchemaVersion;
 
       bool doUpdate = dbSchemaVersion < latestSchemaVersion;
@@ -429,7 +680,7 @@ public:
          ).arg(QDateTime::currentDateTime().toString("yyyy-MM-dd hh˸mm˸ss")).arg(dbSchemaVersion).arg(latestSchemaVersion);
          bool succeeded = database.backupToDir(backupDir, backupName);
          if (!succeeded) {
-            qCritical() << Q_FUNC_INFO << "Unable to create DB backup";
+            qCCritical(Logging::database) << Q_FUNC_INFO << "Unable to create DB backup";
             if (Application::isInteractive()) {
                QMessageBox upgradeBackupFailedMessageBox;
                upgradeBackupFailedMessageBox.setIcon(QMessageBox::Icon::Critical);
@@ -466,7 +717,7 @@ public:
             dbUpgradeMessageBox.setDefaultButton(QMessageBox::Ok);
             int ret = dbUpgradeMessageBox.exec();
             if (ret == QMessageBox::Abort) {
-               qDebug() << Q_FUNC_INFO << "User clicked \"Abort\".  Exiting.";
+               qCDebug(Logging::database) << Q_FUNC_INFO << "User clicked \"Abort\".  Exiting.";
                // Ask the application nicely to quit
                QCoreApplication::quit();
                // If it didn't, we have to insist!
@@ -476,9 +727,32 @@ public:
             }
          }
 
-         bool success = DatabaseSchemaHelper::migrate(database, dbSchemaVersion, latestSchemaVersion, database.sqlDatabase() );
+         //
+         // Upgrading a big DB across several versions can take a while, so, in interactive mode, show that something
+         // is happening.  (There is no cancel button, as stopping part way through would just roll back everything.)
+         //
+         std::unique_ptr<QProgressDialog> progressDialog;
+         DatabaseSchemaHelper::MigrationProgressCallback progressCallback;
+         if (Application::isInteractive()) {
+            progressDialog = std::make_unique<QProgressDialog>(tr("Upgrading database schema..."),
+                                                               QString{},
+                                                               0,
+                                                               latestSchemaVersion - dbSchemaVersion);
+            progressDialog->setWindowModality(Qt::ApplicationModal);
+            progressCallback = [&progressDialog](int const stepsDone, [[maybe_unused]] int const numSteps) {
+               progressDialog->setValue(stepsDone);
+               QCoreApplication::processEvents();
+               return;
+            };
+         }
+         bool success = DatabaseSchemaHelper::migrate(database,
+                                                      dbSchemaVersion,
+                                                      latestSchemaVersion,
+                                                      database.sqlDatabase(),
+                                                      progressCallback);
          if (!success) {
-            qCritical() << Q_FUNC_INFO << QString("Database migration %1->%2 failed").arg(dbSchemaVersion).arg(latestSchemaVersion);
+            qCCritical(Logging::database) <<
+               Q_FUNC_INFO << QString("Database migration %1->%2 failed").arg(dbSchemaVersion).arg(latestSchemaVersion);
             if (err) {
                *err = true;
             }
@@ -489,6 +763,112 @@ public:
       return doUpdate;
    }
 
+   /**
+    * \brief Back up a (loaded) SQLite DB with VACUUM INTO, which writes a consistent copy of the DB, as seen by our
+    *        connection, to a new file.  Unlike copying the DB file, this does not need the DB to be closed, and it only
+    *        copies pages that are in use, so the backup is also compacted.
+    *
+    * \return \c false if the backup could not be done this way (eg because the DB isn't open or because the SQLite
+    *         library is older than v3.27, which is where VACUUM INTO was introduced), in which case the caller should
+    *         fall back to copying the file.
+    */
+   bool backupSQLiteOnline(Database & database, QString const & newDbFileName) {
+      //
+      // We use this thread's connection (which will be the main one in the normal case) because, with the exclusive
+      // connection profile (see sqlitePragmas() above), no other connection is allowed to read the DB.
+      //
+      if (!this->loaded || !QSqlDatabase::contains(dbConnectionNamesForThisThread.value(this->dbType))) {
+         return false;
+      }
+      QSqlDatabase connection = database.sqlDatabase();
+
+      // VACUUM INTO will not overwrite an existing file
+      if (QFile::exists(newDbFileName) && !QFile::remove(newDbFileName)) {
+         qCWarning(Logging::database) << Q_FUNC_INFO << "Could not remove existing file" << newDbFileName;
+         return false;
+      }
+
+      BtSqlQuery query{connection};
+      query.prepare("VACUUM INTO :fileName");
+      query.bindValue(":fileName", newDbFileName);
+      if (!query.exec()) {
+         qCInfo(Logging::database) <<
+            Q_FUNC_INFO << "Unable to back up DB with VACUUM INTO (" << query.lastError().text() << ") so will copy "
+            "file instead";
+         // Don't leave a partial backup lying around
+         QFile::remove(newDbFileName);
+         return false;
+      }
+      return true;
+   }
+
+   /**
+    * \brief Take a consistent snapshot of a PostgreSQL DB, as one CSV file per table in \c snapshotDirName (which is
+    *        created if necessary).  The whole export is done in one REPEATABLE READ transaction, so it sees the DB as
+    *        it was when the export started, even if other users are changing it in the meantime.
+    *
+    *        We can't use COPY ... TO a file (which writes the file on the DB server, and requires special privileges)
+    *        or COPY ... TO STDOUT (which Qt does not support), so we read each table with a forward-only query and
+    *        write the CSV ourselves.
+    */
+   bool snapshotPgSQL(Database & database, QString const & snapshotDirName) {
+      QDir const snapshotDir{snapshotDirName};
+      if (!snapshotDir.mkpath(".")) {
+         qCWarning(Logging::database) << Q_FUNC_INFO << "Could not create snapshot directory" << snapshotDirName;
+         return false;
+      }
+
+      QSqlDatabase connection = database.sqlDatabase();
+      DbTransaction dbTransaction{database, connection, "PostgreSQL snapshot"};
+      BtSqlQuery query{connection};
+      // This has to be the first statement in the transaction
+      if (!query.exec("SET TRANSACTION ISOLATION LEVEL REPEATABLE READ READ ONLY")) {
+         qCWarning(Logging::database) <<
+            Q_FUNC_INFO << "Could not start snapshot transaction: " << query.lastError().text();
+         return false;
+      }
+
+      for (QString const & tableName : connection.tables(QSql::Tables)) {
+         query.setForwardOnly(true);
+         if (!query.exec(QString{"SELECT * FROM %1"}.arg(tableName))) {
+            qCWarning(Logging::database) <<
+               Q_FUNC_INFO << "Could not read table" << tableName << ": " << query.lastError().text();
+            return false;
+         }
+
+         QString const csvFileName = snapshotDir.filePath(QString{"%1.csv"}.arg(tableName));
+         QFile csvFile{csvFileName};
+         if (!csvFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            qCWarning(Logging::database) <<
+               Q_FUNC_INFO << "Could not open" << csvFileName << "for writing: " << csvFile.errorString();
+            return false;
+         }
+
+         QSqlRecord const record = query.record();
+         QStringList fields;
+         for (int ii = 0; ii < record.count(); ++ii) {
+            fields.append(csvField(record.fieldName(ii)));
+         }
+         csvFile.write(fields.join(',').append('\n').toUtf8());
+         while (query.next()) {
+            fields.clear();
+            for (int ii = 0; ii < record.count(); ++ii) {
+               fields.append(csvField(query.value(ii)));
+            }
+            csvFile.write(fields.join(',').append('\n').toUtf8());
+         }
+         if (csvFile.error() != QFileDevice::NoError) {
+            qCWarning(Logging::database) <<
+               Q_FUNC_INFO << "Error writing" << csvFileName << ": " << csvFile.errorString();
+            return false;
+         }
+      }
+
+      // We didn't change anything, so this is just to end the transaction cleanly
+      dbTransaction.commit();
+      return true;
+   }
+
    void automaticBackup(Database & database) {
       int count = PersistentSettings::value(PersistentSettings::Names::count, 0, PersistentSettings::Sections::backups).toInt() + 1;
       int frequency = PersistentSettings::value(PersistentSettings::Names::frequency, 4, PersistentSettings::Sections::backups).toInt();
@@ -525,7 +905,8 @@ public:
          foobar++;
          newName = QString("%1_%2").arg(halfName).arg(foobar,4,10,QChar('0'));
          if ( foobar > 9999 ) {
-            qWarning() << QString("%1 : could not find a unique name in 10000 tries. Overwriting %2").arg(Q_FUNC_INFO).arg(halfName);
+            qCWarning(Logging::database) <<
+               Q_FUNC_INFO << "Could not find a unique name in 10000 tries.  Overwriting" << halfName;
             newName = halfName;
          }
       }
@@ -553,12 +934,12 @@ public:
          // Make sure it exists, and make sure it is a file before we
          // try remove it
          if ( fileThing->exists() && fileThing->isFile() ) {
-            qInfo() <<
+            qCInfo(Logging::database) <<
                Q_FUNC_INFO << "Removing oldest database backup file," << victim << "as more than" << maxBackups <<
                "files in" << backupDir;
             // If we can't remove it, give a warning.
             if (! file->remove() ) {
-               qWarning() <<
+               qCWarning(Logging::database) <<
                   Q_FUNC_INFO << "Could not remove old database backup file " << victim << ".  Error:" << file->error();
             }
          }
@@ -574,6 +955,99 @@ public:
       return;
    }
 
+   /**
+    * \brief Create, register and try to open a new connection for the current thread.
+    *
+    * \param hostname, portnum For PostgreSQL, which server to connect to.  (Ignored for SQLite.)
+    *
+    * \return The new connection, which the caller should check is open.
+    */
+   QSqlDatabase addConnection(QString const & connectionName, QString const & hostname, int const portnum) {
+      //
+      // Create a new connection in Qt's register of connections.  (NB: The call to QSqlDatabase::addDatabase() is
+      // thread-safe, so we don't need to worry about mutexes here.)
+      //
+      QString driverType{this->dbType == Database::DbType::PGSQL ? "QPSQL" : "QSQLITE"};
+      qCDebug(Logging::database) <<
+         Q_FUNC_INFO << "Creating connection " << connectionName << " with " << driverType << " driver";
+      QSqlDatabase connection = QSqlDatabase::addDatabase(driverType, connectionName);
+      if (!connection.isValid()) {
+         //
+         // If the connection is not valid, it means the specified driver type is not available or could not be
+         // loaded.  Log an error here in the knowledge that the caller will find the connection is not open.
+         //
+         qCCritical(Logging::database) << Q_FUNC_INFO << "Unable to load " << driverType << " database driver";
+         return connection;
+      }
+
+      qCDebug(Logging::database) <<
+         Q_FUNC_INFO << "Created connection of type" << connection.driver()->handle().typeName();
+
+      //
+      // Initialisation parameters depend on the DB type
+      //
+      if (this->dbType == Database::DbType::PGSQL) {
+         connection.setHostName    (hostname);
+         connection.setDatabaseName(this->dbName);
+         connection.setUserName    (this->dbUsername);
+         connection.setPort        (portnum);
+         connection.setPassword    (this->dbPassword);
+         connection.setConnectOptions(postgresConnectOptions());
+      } else {
+         connection.setDatabaseName(this->dbFileName);
+      }
+
+      connection.open();
+      return connection;
+   }
+
+   /**
+    * \brief Check that an existing PostgreSQL connection still works, and reconnect if not.  (Eg the server might have
+    *        been restarted, or the network might have dropped, since we last used the connection.  Qt does not notice
+    *        this until a query fails.)  To keep this cheap, a connection is only checked if it has not been checked in
+    *        the last \c connectionHealthCheckInterval_ms.
+    *
+    *        SQLite connections are to a local file, so there is nothing to check.
+    */
+   void checkConnection(QSqlDatabase & connection) {
+      if (this->dbType != Database::DbType::PGSQL) {
+         return;
+      }
+
+      // Each connection belongs to one thread, so the times we last checked them can be per-thread too
+      thread_local QHash<QString, QElapsedTimer> lastChecked;
+      QElapsedTimer & timer = lastChecked[connection.connectionName()];
+      if (timer.isValid() && !timer.hasExpired(connectionHealthCheckInterval_ms)) {
+         return;
+      }
+      timer.start();
+
+      if (connection.isOpen()) {
+         BtSqlQuery query{connection};
+         if (query.exec("SELECT 1")) {
+            return;
+         }
+         qCWarning(Logging::database) <<
+            Q_FUNC_INFO << "Connection" << connection.connectionName() << "failed health check (" <<
+            query.lastError().text() << ") so reconnecting";
+      }
+      // Any queries prepared on the old connection won't work on the new one
+      ObjectStore::clearPreparedStatementCache(connection.connectionName());
+      // Closing the connection also drops any notification subscriptions (see SubscribeToDatabaseChanges), so we need
+      // to remember them to redo them after reconnecting
+      QStringList const subscriptions = connection.driver()->subscribedToNotifications();
+      connection.close();
+      if (!connection.open()) {
+         qCWarning(Logging::database) <<
+            Q_FUNC_INFO << "Unable to reconnect" << connection.connectionName() << ":" << connection.lastError().text();
+         return;
+      }
+      for (QString const & subscription : subscriptions) {
+         connection.driver()->subscribeToNotification(subscription);
+      }
+      return;
+   }
+
    //============================================== impl member variables ==============================================
 
    Database::DbType dbType;
@@ -605,6 +1079,9 @@ public:
    QString dbSchema;
    QString dbUsername;
    QString dbPassword;
+   // Optional read-only replica -- see Database::sqlDatabaseForReading()
+   QString dbReplicaHostname;
+   int dbReplicaPortnum;
 };
 
 
@@ -642,45 +1119,17 @@ QSqlDatabase Database::sqlDatabase() const {
    Q_ASSERT(!connectionName.isEmpty());
    QSqlDatabase connection = QSqlDatabase::database(connectionName);
    if (connection.isValid()) {
-      qDebug() << Q_FUNC_INFO << "Returning connection " << connectionName;
+      this->pimpl->checkConnection(connection);
+      qCDebug(Logging::database) << Q_FUNC_INFO << "Returning connection " << connectionName;
       return connection;
    }
 
-   //
-   // Create a new connection in Qt's register of connections.  (NB: The call to QSqlDatabase::addDatabase() is thread-
-   // safe, so we don't need to worry about mutexes here.)
-   //
-   QString driverType{this->pimpl->dbType == Database::DbType::PGSQL ? "QPSQL" : "QSQLITE"};
-   qDebug() <<
-      Q_FUNC_INFO << "Creating connection " << connectionName << " with " << driverType << " driver";
-   connection = QSqlDatabase::addDatabase(driverType, connectionName);
-   if (!connection.isValid()) {
-      //
-      // If the connection is not valid, it means the specified driver type is not available or could not be loaded
-      // Log an error here in the knowledge that we'll also throw an exception below
-      //
-      qCritical() << Q_FUNC_INFO << "Unable to load " << driverType << " database driver";
-   }
-
-   qDebug() << Q_FUNC_INFO << "Created connection of type" << connection.driver()->handle().typeName();
-
-   //
-   // Initialisation parameters depend on the DB type
-   //
-   if (this->pimpl->dbType == Database::DbType::PGSQL) {
-      connection.setHostName    (this->pimpl->dbHostname);
-      connection.setDatabaseName(this->pimpl->dbName);
-      connection.setUserName    (this->pimpl->dbUsername);
-      connection.setPort        (this->pimpl->dbPortnum);
-      connection.setPassword    (this->pimpl->dbPassword);
-   } else {
-      connection.setDatabaseName(this->pimpl->dbFileName);
-   }
+   connection = this->pimpl->addConnection(connectionName, this->pimpl->dbHostname, this->pimpl->dbPortnum);
 
    //
-   // The moment of truth is when we try to open the new connection
+   // The moment of truth is whether we managed to open the new connection
    //
-   if (!connection.open()) {
+   if (!connection.isOpen()) {
       QString errorMessage;
       if (this->pimpl->dbType == Database::DbType::PGSQL) {
          errorMessage = QString{
@@ -691,7 +1140,7 @@ QSqlDatabase Database::sqlDatabase() const {
             QObject::tr("Could not open SQLite DB file %1.\n%2")
          }.arg(this->pimpl->dbFileName).arg(connection.lastError().text());
       }
-      qCritical() << Q_FUNC_INFO << errorMessage;
+      qCCritical(Logging::database) << Q_FUNC_INFO << errorMessage;
 
       if (Application::isInteractive()) {
          QMessageBox::critical(nullptr,
@@ -706,14 +1155,56 @@ QSqlDatabase Database::sqlDatabase() const {
    return connection;
 }
 
+QSqlDatabase Database::sqlDatabaseForReading() const {
+   //
+   // Straight after we've created or upgraded the schema on the primary, a replica might not have caught up, so we
+   // don't read from it for the rest of the session.
+   //
+   if (this->pimpl->dbType != Database::DbType::PGSQL ||
+       this->pimpl->dbReplicaHostname.isEmpty() ||
+       this->pimpl->createFromScratch ||
+       this->pimpl->schemaUpdated) {
+      return this->sqlDatabase();
+   }
+
+   QString const connectionName =
+      QString{"%1-replica"}.arg(dbConnectionNamesForThisThread.value(this->pimpl->dbType));
+   QSqlDatabase connection = QSqlDatabase::database(connectionName);
+   if (connection.isValid()) {
+      this->pimpl->checkConnection(connection);
+   } else {
+      connection = this->pimpl->addConnection(connectionName,
+                                              this->pimpl->dbReplicaHostname,
+                                              this->pimpl->dbReplicaPortnum);
+      if (connection.isOpen()) {
+         // Belt and braces, as the replica should refuse writes anyway
+         BtSqlQuery query{connection};
+         if (!query.exec("SET SESSION CHARACTERISTICS AS TRANSACTION READ ONLY")) {
+            qCWarning(Logging::database) <<
+               Q_FUNC_INFO << "Unable to make replica connection read-only: " << query.lastError().text();
+         }
+      }
+   }
+
+   // If the replica is unavailable, we can always read from the primary instead
+   if (!connection.isOpen()) {
+      qCWarning(Logging::database) <<
+         Q_FUNC_INFO << "Read replica" << this->pimpl->dbReplicaHostname << "unavailable (" <<
+         connection.lastError().text() << ") so using primary";
+      return this->sqlDatabase();
+   }
+   return connection;
+}
+
 bool Database::load() {
+   Diagnostics::ScopedStartupPhaseTimer phaseTimer{"Open database"};
    this->pimpl->createFromScratch = false;
    this->pimpl->schemaUpdated = false;
    this->pimpl->loadWasSuccessful = false;
 
    // We have had problems on Windows with the DB driver not being found in certain circumstances.  This is some extra
    // diagnostic to help resolve that.
-   qInfo() << Q_FUNC_INFO << "Known DB drivers: " << QSqlDatabase::drivers();
+   qCInfo(Logging::database) << Q_FUNC_INFO << "Known DB drivers: " << QSqlDatabase::drivers();
 
    bool dbIsOpen;
    if (this->dbType() == Database::DbType::PGSQL ) {
@@ -733,7 +1224,7 @@ bool Database::load() {
    // This should work regardless of the db being used.
    if (this->pimpl->createFromScratch) {
       if (!DatabaseSchemaHelper::create(*this, sqldb)) {
-         qCritical() << Q_FUNC_INFO << "DatabaseSchemaHelper::create() failed";
+         qCCritical(Logging::database) << Q_FUNC_INFO << "DatabaseSchemaHelper::create() failed";
          return false;
       }
    }
@@ -741,7 +1232,10 @@ bool Database::load() {
    // Update the database if need be. This has to happen before we do anything
    // else or we dump core
    bool schemaErr = false;
-   this->pimpl->schemaUpdated = this->pimpl->updateSchema(*this, &schemaErr);
+   {
+      Diagnostics::ScopedStartupPhaseTimer schemaPhaseTimer{"Update database schema"};
+      this->pimpl->schemaUpdated = this->pimpl->updateSchema(*this, &schemaErr);
+   }
 
    if (schemaErr ) {
       if (Application::isInteractive()) {
@@ -754,6 +1248,18 @@ bool Database::load() {
       return false;
    }
 
+   //
+   // Now the schema is up to date, we can read the codes for coded enum and unit columns (adding any that are new in
+   // this version of the software), which have to be in place before anything is read from those columns.
+   //
+   {
+      DbTransaction dbTransaction{*this, sqldb, "Load enum codes"};
+      if (!LoadAllEnumCodes(sqldb) || !dbTransaction.commit()) {
+         qCCritical(Logging::database) << Q_FUNC_INFO << "Unable to load enum codes";
+         return false;
+      }
+   }
+
    this->pimpl->loadWasSuccessful = true;
    return this->pimpl->loadWasSuccessful;
 }
@@ -761,7 +1267,7 @@ bool Database::load() {
 void Database::checkForNewDefaultData() {
    // See if there are new ingredients that we need to merge from the data-space db.
    // Don't do this if we JUST copied the default database.
-   qDebug() <<
+   qCDebug(Logging::database) <<
       Q_FUNC_INFO << "dataDbFile:" << this->pimpl->dataDbFile.fileName() << ", dbFile:" <<
       this->pimpl->dbFile.fileName() << ", userDatabaseDidNotExist: " <<
       (this->pimpl->userDatabaseDidNotExist ? "True" : "False") << ", dataDbFile.lastModified:" <<
@@ -790,9 +1296,9 @@ void Database::checkForNewDefaultData() {
                   "%1\n\n"
                   "Log file may contain more details.").arg(userMessage)
             );
-            qCritical() << Q_FUNC_INFO << userMessage;
+            qCCritical(Logging::database) << Q_FUNC_INFO << userMessage;
          }
-         qDebug() << Q_FUNC_INFO << "Message box text : " << messageBoxText;
+         qCDebug(Logging::database) << Q_FUNC_INFO << "Message box text : " << messageBoxText;
          QMessageBox msgBox{succeeded ? QMessageBox::Information : QMessageBox::Critical,
                            messageBoxTitle,
                            messageBoxText};
@@ -812,7 +1318,7 @@ bool Database::createBlank(QString const& filename) {
       bool dbIsOpen = sqldb.open();
       if (! dbIsOpen )
       {
-         qWarning() << QString("Database::createBlank(): could not open '%1'").arg(filename);
+         qCWarning(Logging::database) << QString("Database::createBlank(): could not open '%1'").arg(filename);
          return false;
       }
 
@@ -840,15 +1346,31 @@ void Database::unload() {
    // We really don't want this function to be called twice on the same object or when we didn't get as far as making a
    // connection to the DB etc.
    if (!this->pimpl->loaded) {
-      qDebug() <<
+      qCDebug(Logging::database) <<
          Q_FUNC_INFO << "Nothing to do for Database object for" <<
          getDbNativeName(displayableDbType, this->pimpl->dbType) << "as not loaded";
       return;
    }
 
+   // Make sure any DB work the object stores have queued up or in progress is done before we close the connections.
+   // (This needs to happen before we take the mutex, as writing to the DB will need to get a connection.)
+   RecipeCalculationCache::unload();
+   SensorReadings::unload();
+   ObjectStore::flushPendingPropertyUpdates();
+   ObjectStore::waitForAsyncOperations();
+
+   // Doing the automatic backup while the DB is still open means we can use an online backup (see
+   // impl::backupSQLiteOnline), which is quicker than copying the file after it's closed.
+   if (this->pimpl->loadWasSuccessful && this->dbType() == Database::DbType::SQLITE) {
+      this->pimpl->automaticBackup(*this);
+   }
+
    // This RAII wrapper does all the hard work on mutex.lock() and mutex.unlock() in an exception-safe way
    QMutexLocker locker(&this->pimpl->mutex);
 
+   // Any prepared queries the object stores are holding on to would keep the connections alive, so get rid of them now
+   ObjectStore::clearPreparedStatementCache();
+
    // We only want to close connections that relate to this instance of Database
    QString ourConnectionPrefix = QString{"%1-"}.arg(getDbNativeName(displayableDbType, this->pimpl->dbType));
 
@@ -856,7 +1378,7 @@ void Database::unload() {
    QStringList allConnectionNames{QSqlDatabase::connectionNames()};
    for (QString conName : allConnectionNames) {
       if (0 == conName.indexOf(ourConnectionPrefix)) {
-         qDebug() << Q_FUNC_INFO << "Closing connection " << conName;
+         qCDebug(Logging::database) << Q_FUNC_INFO << "Closing connection " << conName;
          {
             //
             // Extra braces here are to ensure that this QSqlDatabase object is out of scope before the call to
@@ -870,22 +1392,21 @@ void Database::unload() {
          }
          QSqlDatabase::removeDatabase(conName);
       } else {
-         qDebug() <<
+         qCDebug(Logging::database) <<
             Q_FUNC_INFO << "Ignoring connection" << conName << "as does not start with" << ourConnectionPrefix;
       }
    }
 
-   qDebug() << Q_FUNC_INFO << "DB connections all closed";
+   qCDebug(Logging::database) << Q_FUNC_INFO << "DB connections all closed";
 
    if (this->pimpl->loadWasSuccessful && this->dbType() == Database::DbType::SQLITE ) {
       this->pimpl->dbFile.close();
-      this->pimpl->automaticBackup(*this);
    }
 
    this->pimpl->loaded = false;
    this->pimpl->loadWasSuccessful = false;
 
-   qDebug() << Q_FUNC_INFO << "Drop Instance done";
+   qCDebug(Logging::database) << Q_FUNC_INFO << "Drop Instance done";
 
    return;
 }
@@ -936,10 +1457,120 @@ char const * Database::getDefaultBackupFileName() {
     return "database.sqlite";
 }
 
+qint64 Database::compact() {
+   // VACUUM needs there to be no open transactions, so we can't leave any queued property updates for later
+   ObjectStore::flushPendingPropertyUpdates();
+
+   QSqlDatabase connection = this->sqlDatabase();
+   BtSqlQuery sqlQuery{connection};
+   if (!sqlQuery.exec("ANALYZE")) {
+      qCWarning(Logging::database) << Q_FUNC_INFO << "Could not analyze DB: " << sqlQuery.lastError().text();
+   }
+   if (this->dbType() != Database::DbType::SQLITE) {
+      return 0;
+   }
+
+   auto const pragmaValue = [&connection](char const * const pragma) -> qint64 {
+      BtSqlQuery pragmaQuery{connection};
+      if (!pragmaQuery.exec(QString{"PRAGMA %1"}.arg(pragma)) || !pragmaQuery.next()) {
+         qCWarning(Logging::database) <<
+            Q_FUNC_INFO << "Could not read" << pragma << ": " << pragmaQuery.lastError().text();
+         return 0;
+      }
+      return pragmaQuery.value(0).toLongLong();
+   };
+   if (pragmaValue("freelist_count") <= 0) {
+      return 0;
+   }
+
+   qint64 const pageSize = pragmaValue("page_size");
+   qint64 const pagesBefore = pragmaValue("page_count");
+   if (!sqlQuery.exec("VACUUM")) {
+      qCWarning(Logging::database) << Q_FUNC_INFO << "Could not vacuum DB: " << sqlQuery.lastError().text();
+      return 0;
+   }
+   return (pagesBefore - pragmaValue("page_count")) * pageSize;
+}
+
+bool Database::checkIntegrity(QTextStream & report) {
+   // Make sure we're checking what's actually in the DB
+   ObjectStore::flushPendingPropertyUpdates();
+
+   QSqlDatabase connection = this->sqlDatabase();
+   BtSqlQuery sqlQuery{connection};
+   if (this->dbType() != Database::DbType::SQLITE) {
+      if (!sqlQuery.exec("SELECT 1")) {
+         report << tr("Could not query database: %1").arg(sqlQuery.lastError().text()) << Qt::endl;
+         return false;
+      }
+      return true;
+   }
+
+   bool noProblemsFound = true;
+   //
+   // integrity_check returns a single row containing "ok" if all is well, otherwise one row per problem found
+   //
+   if (!sqlQuery.exec("PRAGMA integrity_check")) {
+      report << tr("Could not run integrity check: %1").arg(sqlQuery.lastError().text()) << Qt::endl;
+      return false;
+   }
+   while (sqlQuery.next()) {
+      QString const result = sqlQuery.value(0).toString();
+      if (result != "ok") {
+         report << result << Qt::endl;
+         noProblemsFound = false;
+      }
+   }
+
+   //
+   // foreign_key_check returns one row per broken reference: table name, row ID, referenced table name and index of the
+   // foreign key in the table's list of them
+   //
+   if (!sqlQuery.exec("PRAGMA foreign_key_check")) {
+      report << tr("Could not run foreign key check: %1").arg(sqlQuery.lastError().text()) << Qt::endl;
+      return false;
+   }
+   while (sqlQuery.next()) {
+      report <<
+         tr("Row %1 of table %2 refers to a missing row in table %3").arg(
+            sqlQuery.value(1).toString(), sqlQuery.value(0).toString(), sqlQuery.value(2).toString()
+         ) << Qt::endl;
+      noProblemsFound = false;
+   }
+
+   qCInfo(Logging::database) << Q_FUNC_INFO << "Integrity check" << (noProblemsFound ? "passed" : "FAILED");
+   return noProblemsFound;
+}
+
 bool Database::backupToFile(QString const & newDbFileName) {
    QString const curDbFileName = this->pimpl->dbFile.fileName();
 
-   qDebug() << Q_FUNC_INFO << "Database backup from" << curDbFileName << "to" << newDbFileName;
+   qCDebug(Logging::database) << Q_FUNC_INFO << "Database backup from" << curDbFileName << "to" << newDbFileName;
+
+   // Don't leave any queued property updates out of the backup
+   ObjectStore::flushPendingPropertyUpdates();
+
+   if (this->dbType() == Database::DbType::PGSQL) {
+      return this->pimpl->snapshotPgSQL(*this, newDbFileName);
+   }
+
+   if (this->pimpl->backupSQLiteOnline(*this, newDbFileName)) {
+      return true;
+   }
+
+   //
+   // Otherwise, we fall back to copying the DB file.  If we're using a write-ahead log, recent changes might not yet be
+   // in the main DB file, so, if the DB is still open, get them written there before we copy it.  (This is harmless if
+   // we're not using a write-ahead log.  When the DB is closed, SQLite will already have done this.)
+   //
+   QString const connectionName = dbConnectionNamesForThisThread.value(this->pimpl->dbType);
+   if (QSqlDatabase::contains(connectionName)) {
+      BtSqlQuery checkpoint{QSqlDatabase::database(connectionName)};
+      if (!checkpoint.exec("PRAGMA wal_checkpoint(TRUNCATE)")) {
+         qCWarning(Logging::database) <<
+            Q_FUNC_INFO << "Could not checkpoint write-ahead log: " << checkpoint.lastError().text();
+      }
+   }
 
    //
    // In earlier versions of the code, we just used the copy() member function of QFile.  When this works it is fine,
@@ -968,7 +1599,7 @@ bool Database::backupToFile(QString const & newDbFileName) {
          // AFAICT std::filesystem::copy should overwrite its target if it exists, but it's helpful for diagnostics to
          // pull that case out as a separate step.
          operation = "Remove existing target";
-         qInfo() <<
+         qCInfo(Logging::database) <<
             Q_FUNC_INFO << "Removing existing file" << newDbFileName << "before copying" << curDbFileName;
          std::filesystem::remove(target);
       }
@@ -976,14 +1607,14 @@ bool Database::backupToFile(QString const & newDbFileName) {
       std::filesystem::copy(source, target);
    } catch (std::filesystem::filesystem_error & fsError) {
       std::error_code errorCode = fsError.code();
-      qWarning() <<
+      qCWarning(Logging::database) <<
          Q_FUNC_INFO << "Error backing up database file " << curDbFileName << "to" << newDbFileName << ":" <<
          operation << "failed with" << errorCode << ".  Error message:" << fsError.what();
       return false;
    } catch (std::exception & exception) {
       // Most probably this would be std::bad_alloc, in which case we'd probably even have difficulty logging, but we
       // might as well try!
-      qCritical() <<
+      qCCritical(Logging::database) <<
          Q_FUNC_INFO << "Unexpected error backing up database file " << curDbFileName << "to" << newDbFileName << ":" <<
          operation << "failed:" << exception.what();
       return false;
@@ -1024,51 +1655,22 @@ bool Database::verifyDbConnection(Database::DbType testDb,
                                   QString const &  database,
                                   QString const &  username,
                                   QString const &  password) {
-   QString const testConnectionName{"testConnDb"};
-
-   QString driverName;
-   switch (testDb) {
-      case Database::DbType::PGSQL:
-         driverName = "QPSQL";
-         break;
-      default:
-         driverName = "QSQLITE";
+   QString errorText;
+   bool const results = testConnectionInBackground(testDb,
+                                                   hostname,
+                                                   portnum,
+                                                   database,
+                                                   username,
+                                                   password,
+                                                   errorText);
+   if (!results) {
+      QMessageBox::critical(
+         nullptr,
+         tr("Connection failed"),
+         QString(tr("Could not connect to %1 : %2")).arg(hostname).arg(errorText)
+      );
    }
 
-   bool results = false;
-
-   {
-      // Extra braces here are to ensure that this QSqlDatabase object is out of scope before the call to
-      // QSqlDatabase::removeDatabase() below
-      QSqlDatabase connDb = QSqlDatabase::addDatabase(driverName, testConnectionName);
-
-      switch (testDb) {
-         case Database::DbType::PGSQL:
-            connDb.setHostName(hostname);
-            connDb.setPort(portnum);
-            connDb.setDatabaseName(database);
-            connDb.setUserName(username);
-            connDb.setPassword(password);
-            break;
-         default:
-            connDb.setDatabaseName(hostname);
-      }
-
-      results = connDb.open();
-
-      if (results) {
-         connDb.close();
-      } else {
-         QMessageBox::critical(
-            nullptr,
-            tr("Connection failed"),
-            QString(tr("Could not connect to %1 : %2")).arg(hostname).arg(connDb.lastError().text())
-         );
-      }
-   }
-
-   QSqlDatabase::removeDatabase(testConnectionName);
-
    return results;
 }
 
@@ -1102,7 +1704,7 @@ void Database::convertDatabase(QString const& Hostname, QString const& DbName,
       DatabaseSchemaHelper::copyToNewDatabase(newDatabase, connectionNew);
    }
    catch (QString e) {
-      qCritical() << QString("%1 %2").arg(Q_FUNC_INFO).arg(e);
+      qCCritical(Logging::database) << QString("%1 %2").arg(Q_FUNC_INFO).arg(e);
       throw;
    }
 }
@@ -1111,6 +1713,10 @@ Database::DbType Database::dbType() const {
    return this->pimpl->dbType;
 }
 
+QString Database::sqliteFileName() const {
+   return this->pimpl->dbFileName;
+}
+
 void Database::setForeignKeysEnabled(bool enabled, QSqlDatabase connection, Database::DbType type) {
    if (type == Database::DbType::NODB) {
       type = this->dbType();
@@ -1226,13 +1832,13 @@ bool Database::updatePrimaryKeySequenceIfNecessary(QSqlDatabase & connection,
                        "FROM %1;").arg(*tableName, *columnName)
             );
             if (!query.exec()) {
-               qCritical() <<
+               qCCritical(Logging::database) <<
                   Q_FUNC_INFO << "Error updating sequence value for column" << columnName << "on table" << tableName <<
                   "using SQL \"" << query.lastQuery() << "\":" << query.lastError().text();
                return false;
             }
             if (query.next()) {
-               qInfo() <<
+               qCInfo(Logging::database) <<
                   Q_FUNC_INFO << "Updated sequence value for column" << columnName << "on table" << tableName << "to" <<
                   query.value(0);
             }
@@ -40,6 +40,7 @@
 #include "utils/NoCopy.h"
 
 class BtStringConst;
+class QTextStream;
 
 /*!
  * \class Database
@@ -103,6 +104,17 @@ public:
     */
    QSqlDatabase sqlDatabase() const;
 
+   /**
+    * \brief As \c sqlDatabase, but for reads that don't need to see the very latest changes (eg loading everything at
+    *        start-up).  If the user has configured a read-only PostgreSQL replica (dbReplicaHostname and, optionally,
+    *        dbReplicaPortnum in \c PersistentSettings), the returned connection is to that, which takes load off the
+    *        primary server when several people use the same DB.  Otherwise, or if the replica can't be reached, this
+    *        is the same as \c sqlDatabase.
+    *
+    *        NB: Never write using the returned connection!
+    */
+   QSqlDatabase sqlDatabaseForReading() const;
+
    //! \brief Should be called when we are about to close down.
    void unload();
 
@@ -120,9 +132,38 @@ public:
 
    static char const * getDefaultBackupFileName();
 
-   //! backs up database to chosen file
+   /**
+    * \brief Backs up database to chosen file.
+    *
+    *        For SQLite, this is done while the DB is open (with VACUUM INTO), so the backup is consistent and
+    *        compacted, falling back to copying the DB file if that is not possible.
+    *
+    *        For PostgreSQL, \c newDbFileName is a directory, into which we export a consistent snapshot of the DB as
+    *        one CSV file per table.  (We can't currently restore from this.)
+    */
    bool backupToFile(QString const & newDbFileName);
 
+   /**
+    * \brief Update the DB's query planner statistics (ANALYZE) and, for SQLite, if the DB file has free pages (eg after
+    *        \c PurgeSoftDeletedObjects), rebuild it (VACUUM) so that the space is given back.
+    *
+    *        For PostgreSQL, we leave reclaiming space to the server's autovacuum.
+    *
+    * \return Number of bytes by which the DB file shrank (so always 0 for PostgreSQL)
+    */
+   qint64 compact();
+
+   /**
+    * \brief Ask the DB to check itself for corruption and broken foreign key references.  For SQLite, this is
+    *        \c PRAGMA \c integrity_check and \c PRAGMA \c foreign_key_check.  PostgreSQL enforces foreign keys itself
+    *        and has no equivalent of the former, so there we just check that we can read the DB.
+    *
+    * \param report Each problem found is written here, one per line
+    *
+    * \return \c true if no problems were found, \c false otherwise
+    */
+   bool checkIntegrity(QTextStream & report);
+
    //! backs up database to 'dir' in chosen directory
    bool backupToDir(QString dir, QString filename="");
 
@@ -158,6 +199,9 @@ public:
     */
    Database::DbType dbType() const;
 
+   //! \return The file holding the DB, if it is SQLite
+   QString sqliteFileName() const;
+
    /**
     * \brief Turn foreign key constraints on or off.  Typically, turning them off is only required during copying the
     *        contents of one DB to another.
@@ -22,6 +22,7 @@
 #include <algorithm> // For std::sort and std::set_difference
 
 #include <QDebug>
+#include <QElapsedTimer>
 #include <QMessageBox>
 #include <QSqlError>
 #include <QSqlField>
@@ -32,11 +33,17 @@
 
 #include "Application.h"
 #include "database/BtSqlQuery.h"
+#include "database/ChangeLog.h"
 #include "database/Database.h"
 #include "database/DbTransaction.h"
+#include "database/EnumCodes.h"
 #include "database/ObjectStoreTyped.h"
+#include "database/RecipeCalculationCache.h"
+#include "database/SearchIndex.h"
+#include "database/SensorReadings.h"
+#include "Logging.h"
 
-int constexpr DatabaseSchemaHelper::latestVersion = 13;
+int constexpr DatabaseSchemaHelper::latestVersion = 22;
 
 // Default namespace hides functions from everything outside this file.
 namespace {
@@ -71,14 +78,14 @@ namespace {
 
       for (auto & query : queries) {
          if (query.onlyRunIfPriorQueryHadResults && !priorQueryHadResults) {
-            qInfo() <<
+            qCInfo(Logging::database) <<
                Q_FUNC_INFO << "Skipping upgrade query \"" << query.sql << "\" as was dependent on prior upgrade "
                "query (\"" << priorQuerySql << "\") returning results, and it didn't";
             // We deliberately don't update priorQueryHadResults or priorQuerySql in this case, as it allows more than
             // one query in a row to be dependent on a single "dummy-run" query
             continue;
          }
-         qDebug() << Q_FUNC_INFO << query.sql;
+         qCDebug(Logging::database) << Q_FUNC_INFO << query.sql;
 
          q.prepare(query.sql);
          for (auto & bv : query.bindValues) {
@@ -87,12 +94,12 @@ namespace {
          if (!q.exec()) {
             // If we get an error, we want to stop processing as otherwise you get "false" errors if subsequent queries
             // fail as a result of assuming that all prior queries have run OK.
-            qCritical() <<
+            qCCritical(Logging::database) <<
                Q_FUNC_INFO << "Error executing database upgrade/set-up query " << query.sql << ": " <<
                q.lastError().text();
             return false;
          }
-         qDebug() << Q_FUNC_INFO << q.numRowsAffected() << "rows affected";
+         qCDebug(Logging::database) << Q_FUNC_INFO << q.numRowsAffected() << "rows affected";
          priorQueryHadResults = q.next();
          priorQuerySql = query.sql;
       }
@@ -109,10 +116,10 @@ namespace {
       QString queryString{"ALTER TABLE brewnote ADD COLUMN projected_ferm_points "};
       QTextStream queryStringAsStream{&queryString};
       queryStringAsStream << db.getDbNativeTypeName<double>() << ";"; // Previously DEFAULT 0.0
-      qDebug() << Q_FUNC_INFO << queryString;
+      qCDebug(Logging::database) << Q_FUNC_INFO << queryString;
       ret &= q.exec(queryString);
       queryString = "ALTER TABLE brewnote SET projected_ferm_points = -1.0;";
-      qDebug() << Q_FUNC_INFO << queryString;
+      qCDebug(Logging::database) << Q_FUNC_INFO << queryString;
       ret &= q.exec(queryString);
 
       // Add the settings table
@@ -121,7 +128,7 @@ namespace {
          "id " << db.getDbNativePrimaryKeyDeclaration() << ",\n"
          "repopulatechildrenonnextstart " << db.getDbNativeTypeName<int>() << ",\n" // Previously DEFAULT 0
          "version " << db.getDbNativeTypeName<int>() << ");"; // Previously DEFAULT 0
-      qDebug() << Q_FUNC_INFO << queryString;
+      qCDebug(Logging::database) << Q_FUNC_INFO << queryString;
       ret &= q.exec(queryString);
 
       return ret;
@@ -2142,11 +2149,112 @@ namespace {
       return executeSqlQueries(q, migrationQueries);
    }
 
+   /**
+    * \brief Add indexes on foreign key columns (including all the "this" and "other" columns of junction tables), so
+    *        that, eg, hard deleting an ingredient or recipe, which deletes junction table rows by key, does not need to
+    *        scan whole tables.
+    *
+    *        Unlike the other migrations, the indexes are worked out from the \c ObjectStore table definitions rather
+    *        than listed here.  This is OK because they are created with "IF NOT EXISTS" and only on columns that are
+    *        in the current schema.  (If some future schema change drops one of these columns, whoever makes that
+    *        change will need to list the indexes here explicitly instead.)
+    */
+   bool migrate_to_14([[maybe_unused]] Database & db, QSqlDatabase connection) {
+      return CreateAllDatabaseIndexes(connection);
+   }
+
+   /**
+    * \brief On PostgreSQL, add the triggers that notify other users of the DB when something changes (see
+    *        \c ObjectStore::refreshFromDb).  Nothing to do on SQLite, which only ever has one user.
+    *
+    *        As with \c migrate_to_14, the triggers are worked out from the \c ObjectStore table definitions, which is
+    *        OK because each trigger is dropped (if it exists) before being created.
+    */
+   bool migrate_to_15(Database & db, QSqlDatabase connection) {
+      if (db.dbType() != Database::DbType::PGSQL) {
+         return true;
+      }
+      return CreateAllChangeNotificationTriggers(connection);
+   }
+
+   /**
+    * \brief Add the full-text search index (see \c SearchIndex).  This starts out empty, and gets filled from the object
+    *        stores the first time the program runs with it.
+    */
+   bool migrate_to_16(Database & db, QSqlDatabase connection) {
+      return SearchIndex::createTables(db, connection);
+   }
+
+   /**
+    * \brief Add the table where recipes' calculated values are kept between runs (see \c RecipeCalculationCache).  This
+    *        starts out empty, and gets filled as recipes are calculated.
+    */
+   bool migrate_to_17(Database & db, QSqlDatabase connection) {
+      return RecipeCalculationCache::createTables(db, connection);
+   }
+
+   /**
+    * \brief Add the table where fermentation sensor readings are kept (see \c SensorReadings)
+    */
+   bool migrate_to_18(Database & db, QSqlDatabase connection) {
+      return SensorReadings::createTables(db, connection);
+   }
+
+   /**
+    * \brief Add the tables for compressed sensor readings and their rollups.  (\c SensorReadings::createTables skips
+    *        the table added in v18, so we can just call it again.)
+    */
+   bool migrate_to_19(Database & db, QSqlDatabase connection) {
+      return SensorReadings::createTables(db, connection);
+   }
+
+   /**
+    * \brief Add the table that records which objects have changed, for delta exports (see \c ChangeLog).  This starts
+    *        out empty, which is fine because a delta export since counter 0 exports everything regardless.
+    */
+   bool migrate_to_20(Database & db, QSqlDatabase connection) {
+      return ChangeLog::createTables(db, connection);
+   }
+
+   /**
+    * \brief Add the table of object UUIDs used to match objects between databases.  (\c ChangeLog::createTables skips
+    *        the table added in v20, so we can just call it again.)
+    */
+   bool migrate_to_21(Database & db, QSqlDatabase connection) {
+      return ChangeLog::createTables(db, connection);
+   }
+
+   /**
+    * \brief Store enum and unit columns as integer codes (see \c EnumCodes) rather than strings.  Rather than list the
+    *        columns here, we go by the current table definitions, skipping any column that isn't in the DB yet.  (Such
+    *        a column would be added by a later migration, with the right type.)
+    */
+   bool migrate_to_22(Database & db, QSqlDatabase connection) {
+      if (!EnumCodes::createTables(db, connection)) {
+         return false;
+      }
+      for (ObjectStore const * objectStore : GetAllObjectStores()) {
+         BtStringConst const & tableName = objectStore->primaryTableName();
+         if (!EnumCodes::load(connection, tableName, objectStore->primaryTableFields())) {
+            return false;
+         }
+         QSqlRecord const columns = connection.record(*tableName);
+         for (ObjectStore::TableField const & fieldDefn : objectStore->primaryTableFields()) {
+            if (fieldDefn.isStoredAsCode() && columns.contains(*fieldDefn.columnName) &&
+                !EnumCodes::convertColumn(db, connection, tableName, fieldDefn)) {
+               return false;
+            }
+         }
+      }
+      return true;
+   }
+
    /*!
     * \brief Migrate from version \c oldVersion to \c oldVersion+1
     */
    bool migrateNext(Database & database, int oldVersion, QSqlDatabase db ) {
-      qDebug() << Q_FUNC_INFO << "Migrating DB schema from v" << oldVersion << "to v" << oldVersion + 1;
+      qCDebug(Logging::database) <<
+         Q_FUNC_INFO << "Migrating DB schema from v" << oldVersion << "to v" << oldVersion + 1;
       BtSqlQuery sqlQuery(db);
       bool ret = true;
 
@@ -2188,25 +2296,64 @@ namespace {
          case 12:
             ret &= migrate_to_13(database, sqlQuery);
             break;
+         case 13:
+            ret &= migrate_to_14(database, db);
+            break;
+         case 14:
+            ret &= migrate_to_15(database, db);
+            break;
+         case 15:
+            ret &= migrate_to_16(database, db);
+            break;
+         case 16:
+            ret &= migrate_to_17(database, db);
+            break;
+         case 17:
+            ret &= migrate_to_18(database, db);
+            break;
+         case 18:
+            ret &= migrate_to_19(database, db);
+            break;
+         case 19:
+            ret &= migrate_to_20(database, db);
+            break;
+         case 20:
+            ret &= migrate_to_21(database, db);
+            break;
+         case 21:
+            ret &= migrate_to_22(database, db);
+            break;
          default:
-            qCritical() << QString("Unknown version %1").arg(oldVersion);
+            qCCritical(Logging::database) << QString("Unknown version %1").arg(oldVersion);
             return false;
       }
 
-      //
-      // Set the db version
-      //
-      if (oldVersion > 3) {
-         QString const queryString{"UPDATE settings SET version=:version WHERE id=1"};
-         sqlQuery.prepare(queryString);
-         QVariant bindValue{QString::number(oldVersion + 1)};
-         sqlQuery.bindValue(":version", bindValue);
-         ret &= sqlQuery.exec();
-      }
-
       return ret;
    }
 
+   /*!
+    * \brief Record \c newVersion as the schema version of the DB.  Since all the migration steps run in one
+    *        transaction, we only need to do this once, at the end, rather than after each step.
+    *
+    *        Versions up to 4 store the version differently (and the migrations to them take care of it).
+    */
+   bool setSchemaVersion(QSqlDatabase db, int const newVersion) {
+      if (newVersion <= 4) {
+         return true;
+      }
+      BtSqlQuery sqlQuery{db};
+      QString const queryString{"UPDATE settings SET version=:version WHERE id=1"};
+      sqlQuery.prepare(queryString);
+      QVariant bindValue{QString::number(newVersion)};
+      sqlQuery.bindValue(":version", bindValue);
+      if (!sqlQuery.exec()) {
+         qCCritical(Logging::database) <<
+            Q_FUNC_INFO << "Error executing database query " << queryString << ": " << sqlQuery.lastError().text();
+         return false;
+      }
+      return true;
+   }
+
 }
 
 
@@ -2253,7 +2400,7 @@ bool DatabaseSchemaHelper::create(Database & database, QSqlDatabase connection)
    // having called dbTransaction.commit().
    DbTransaction dbTransaction{database, connection};
 
-   qDebug() << Q_FUNC_INFO;
+   qCDebug(Logging::database) << Q_FUNC_INFO;
    if (!CreateAllDatabaseTables(database, connection)) {
       return false;
    }
@@ -2287,16 +2434,21 @@ bool DatabaseSchemaHelper::create(Database & database, QSqlDatabase connection)
    return true;
 }
 
-bool DatabaseSchemaHelper::migrate(Database & database, int oldVersion, int newVersion, QSqlDatabase connection) {
+bool DatabaseSchemaHelper::migrate(Database & database,
+                                   int oldVersion,
+                                   int newVersion,
+                                   QSqlDatabase connection,
+                                   MigrationProgressCallback const & progressCallback) {
    if (oldVersion >= newVersion || newVersion > DatabaseSchemaHelper::latestVersion ) {
-      qCritical() << Q_FUNC_INFO <<
+      qCCritical(Logging::database) << Q_FUNC_INFO <<
          "Requested backwards migration from" << oldVersion << "to" << newVersion << ".  Assuming this is a coding "
          "error and therefore doing nothing!";
       return false;
    }
 
    bool ret = true;
-   qDebug() << Q_FUNC_INFO << "Migrating database schema from v" << oldVersion << "to v" << newVersion;
+   qCDebug(Logging::database) <<
+      Q_FUNC_INFO << "Migrating database schema from v" << oldVersion << "to v" << newVersion;
 
    // Start transaction
    // By the magic of RAII, this will abort if we exit this function (including by throwing an exception) without
@@ -2304,8 +2456,34 @@ bool DatabaseSchemaHelper::migrate(Database & database, int oldVersion, int newV
    // transaction is committed or rolled back.)
    DbTransaction dbTransaction{database, connection, "Migrate", DbTransaction::DISABLE_FOREIGN_KEYS};
 
-   for ( ; oldVersion < newVersion && ret; ++oldVersion ) {
-      ret &= migrateNext(database, oldVersion, connection);
+   //
+   // The views that show the strings for coded columns (see EnumCodes) would stop the migration steps renaming or
+   // dropping any of the columns they use, so we take them out of the way until the end.  (Before v22, there are no
+   // views, so this does nothing.)
+   //
+   ret &= DropAllReadableViews(connection);
+
+   int const numSteps = newVersion - oldVersion;
+   QElapsedTimer timer;
+   for (int step = 0; step < numSteps && ret; ++step) {
+      int const stepFromVersion = oldVersion + step;
+      if (progressCallback) {
+         progressCallback(step, numSteps);
+      }
+      timer.start();
+      ret &= migrateNext(database, stepFromVersion, connection);
+      qCInfo(Logging::database) <<
+         Q_FUNC_INFO << "Migration from v" << stepFromVersion << "to v" << stepFromVersion + 1 <<
+         (ret ? "took" : "failed after") << timer.elapsed() << "ms";
+   }
+   if (ret) {
+      ret &= setSchemaVersion(connection, newVersion);
+   }
+   if (ret && newVersion >= 22) {
+      ret &= CreateAllReadableViews(connection);
+   }
+   if (progressCallback) {
+      progressCallback(numSteps, numSteps);
    }
 
    // If all statements executed OK, we can commit, otherwise the transaction will roll back when we exit this function
@@ -2330,7 +2508,7 @@ int DatabaseSchemaHelper::schemaVersion(QSqlDatabase & db) {
 
    // Get the string before we kill it by convert()-ing
    QString stringVer( ver.toString() );
-   qDebug() << Q_FUNC_INFO << "Database schema version" << stringVer;
+   qCDebug(Logging::database) << Q_FUNC_INFO << "Database schema version" << stringVer;
 
    // Initially, versioning was done with strings, so we need to convert
    // the old version strings to integer versions
@@ -2350,7 +2528,7 @@ int DatabaseSchemaHelper::schemaVersion(QSqlDatabase & db) {
       return 3;
    }
 
-   qCritical() << "Could not find database version";
+   qCCritical(Logging::database) << "Could not find database version";
    return -1;
 }
 
@@ -2358,19 +2536,19 @@ bool DatabaseSchemaHelper::copyToNewDatabase(Database & newDatabase, QSqlDatabas
 
    // this is to prevent us from over-writing or doing heavens knows what to an existing db
    if (connectionNew.tables().contains(QLatin1String("settings"))) {
-      qWarning() << Q_FUNC_INFO << "It appears the database is already configured.";
+      qCWarning(Logging::database) << Q_FUNC_INFO << "It appears the database is already configured.";
       return false;
    }
 
    // The crucial bit is creating the new tables in the new DB.  Once that is done then, assuming disabling of foreign
    // keys works OK, it should be turn-the-handle to write out all the data.
    if (!DatabaseSchemaHelper::create(newDatabase, connectionNew)) {
-      qCritical() << Q_FUNC_INFO << "Error creating tables in new DB";
+      qCCritical(Logging::database) << Q_FUNC_INFO << "Error creating tables in new DB";
       return false;
    }
 
    if (!WriteAllObjectStoresToNewDb(newDatabase, connectionNew)) {
-      qCritical() << Q_FUNC_INFO << "Error writing data to new DB";
+      qCCritical(Logging::database) << Q_FUNC_INFO << "Error writing data to new DB";
       return false;
    }
 
@@ -20,6 +20,8 @@
 #define DATABASE_DATABASESCHEMAHELPER_H
 #pragma once
 
+#include <functional>
+
 #include <QSqlDatabase>
 
 #include "Database.h"
@@ -46,9 +48,20 @@ namespace DatabaseSchemaHelper {
    bool create(Database & database, QSqlDatabase db);
 
    /*!
-    * \brief Migrate schema from \c oldVersion to \c newVersion
+    * \brief Called before each step of a migration (with the number of steps done so far and the total number of
+    *        steps) and once more when it has finished
+    */
+   using MigrationProgressCallback = std::function<void(int const stepsDone, int const numSteps)>;
+
+   /*!
+    * \brief Migrate schema from \c oldVersion to \c newVersion.  All the steps are done in one transaction, so, if
+    *        any of them fails, the DB is left as it was.
     */
-   bool migrate(Database & database, int oldVersion, int newVersion, QSqlDatabase connection);
+   bool migrate(Database & database,
+                int oldVersion,
+                int newVersion,
+                QSqlDatabase connection,
+                MigrationProgressCallback const & progressCallback = {});
 
    //! \brief Current schema version of the given database
    int schemaVersion(QSqlDatabase & db);
@@ -16,11 +16,35 @@
 #include "database/DbTransaction.h"
 
 #include <QDebug>
+#include <QHash>
 #include <QSqlError>
 
+#include "database/BtSqlQuery.h"
 #include "database/Database.h"
 #include "Logging.h"
 
+namespace {
+   /**
+    * \brief Number of \c DbTransaction objects currently open on each connection.  Each connection belongs to one
+    *        thread, so this can be per-thread too.
+    */
+   thread_local QHash<QString, int> openTransactionsByConnection;
+
+   QString savepointName(int const nestingLevel) {
+      return QString{"db_transaction_%1"}.arg(nestingLevel);
+   }
+
+   bool execSavepointCommand(QSqlDatabase & connection, QString const & command) {
+      BtSqlQuery query{connection};
+      if (!query.exec(command)) {
+         qCCritical(Logging::database) <<
+            Q_FUNC_INFO << "Error executing" << command << ":" << query.lastError().text();
+         return false;
+      }
+      return true;
+   }
+}
+
 DbTransaction::DbTransaction(Database & database,
                              QSqlDatabase & connection,
                              QString const nameForLogging,
@@ -29,7 +53,24 @@ DbTransaction::DbTransaction(Database & database,
    connection{connection},
    nameForLogging{nameForLogging},
    committed{false},
-   specialBehaviours{specialBehaviours} {
+   specialBehaviours{specialBehaviours},
+   nestingLevel{openTransactionsByConnection[connection.connectionName()]++} {
+   if (this->nestingLevel > 0) {
+      // Foreign keys can only be turned on and off outside a transaction (see below)
+      if (this->specialBehaviours & DISABLE_FOREIGN_KEYS) {
+         qCCritical(Logging::database) <<
+            Q_FUNC_INFO << "Cannot disable foreign keys in nested transaction" << this->nameForLogging;
+         Q_ASSERT(false);
+         this->specialBehaviours &= ~DISABLE_FOREIGN_KEYS;
+      }
+      bool const succeeded =
+         execSavepointCommand(this->connection, QString{"SAVEPOINT %1"}.arg(savepointName(this->nestingLevel)));
+      qCDebug(Logging::database) <<
+         Q_FUNC_INFO << "Database transaction" << this->nameForLogging << "(nested" << this->nestingLevel <<
+         ") begin:" << (succeeded ? "succeeded" : "failed");
+      return;
+   }
+
    // Note that, on SQLite at least, turning foreign keys on and off has to happen outside a transaction, so we have to
    // be careful about the order in which we do things.
    if (this->specialBehaviours & DISABLE_FOREIGN_KEYS) {
@@ -37,24 +78,39 @@ DbTransaction::DbTransaction(Database & database,
    }
 
    bool succeeded = this->connection.transaction();
-   qDebug() <<
+   qCDebug(Logging::database) <<
       Q_FUNC_INFO << "Database transaction" << this->nameForLogging << "begin: " << (succeeded ? "succeeded" : "failed");
    if (!succeeded) {
-      qCritical() <<
+      qCCritical(Logging::database) <<
          Q_FUNC_INFO << "Unable to start database transaction" << this->nameForLogging << ":" << connection.lastError().text();
-      qCritical().noquote() << Q_FUNC_INFO << Logging::getStackTrace();
+      qCCritical(Logging::database).noquote() << Q_FUNC_INFO << Logging::getStackTrace();
    }
    return;
 }
 
 DbTransaction::~DbTransaction() {
-   qDebug() << Q_FUNC_INFO;
+   qCDebug(Logging::database) << Q_FUNC_INFO;
+   --openTransactionsByConnection[this->connection.connectionName()];
+   if (this->nestingLevel > 0) {
+      if (!this->committed) {
+         // Rolling back to a savepoint leaves it in place, so we also need to release it
+         QString const savepoint = savepointName(this->nestingLevel);
+         bool const succeeded =
+            execSavepointCommand(this->connection, QString{"ROLLBACK TO SAVEPOINT %1"}.arg(savepoint)) &&
+            execSavepointCommand(this->connection, QString{"RELEASE SAVEPOINT %1"}.arg(savepoint));
+         qCDebug(Logging::database) <<
+            Q_FUNC_INFO << "Database transaction" << this->nameForLogging << "(nested" << this->nestingLevel <<
+            ") rollback:" << (succeeded ? "succeeded" : "failed");
+      }
+      return;
+   }
+
    if (!committed) {
       bool succeeded = this->connection.rollback();
-      qDebug() <<
+      qCDebug(Logging::database) <<
          Q_FUNC_INFO << "Database transaction" << this->nameForLogging << "rollback: " << (succeeded ? "succeeded" : "failed");
       if (!succeeded) {
-         qCritical() <<
+         qCCritical(Logging::database) <<
             Q_FUNC_INFO << "Unable to rollback database transaction" << this->nameForLogging << ":" << connection.lastError().text();
       }
    }
@@ -67,11 +123,23 @@ DbTransaction::~DbTransaction() {
 }
 
 bool DbTransaction::commit() {
+   if (this->nestingLevel > 0) {
+      // The changes will only be written to the DB when the outermost transaction is committed
+      this->committed = execSavepointCommand(
+         this->connection,
+         QString{"RELEASE SAVEPOINT %1"}.arg(savepointName(this->nestingLevel))
+      );
+      qCDebug(Logging::database) <<
+         Q_FUNC_INFO << "Database transaction" << this->nameForLogging << "(nested" << this->nestingLevel <<
+         ") commit:" << (this->committed ? "succeeded" : "failed");
+      return this->committed;
+   }
+
    this->committed = connection.commit();
-   qDebug() <<
+   qCDebug(Logging::database) <<
       Q_FUNC_INFO << "Database transaction" << this->nameForLogging << "commit: " << (this->committed ? "succeeded" : "failed");
    if (!this->committed) {
-      qCritical() <<
+      qCCritical(Logging::database) <<
          Q_FUNC_INFO << "Unable to commit database transaction" << this->nameForLogging << ":" << connection.lastError().text();
    }
    return this->committed;
@@ -23,12 +23,18 @@ class Database;
 
 /**
  * \brief RAII wrapper for transaction(), commit(), rollback() member functions of QSqlDatabase
+ *
+ *        Transactions can be nested: if there is already a \c DbTransaction open on the same connection, then we use a
+ *        savepoint instead of starting a new transaction, so that rolling back only undoes what was done since the
+ *        inner \c DbTransaction was constructed.  Nothing is actually written to the DB until the outermost
+ *        transaction is committed.  This allows a caller doing lots of small DB updates (each of which has its own
+ *        \c DbTransaction) to make them all in one transaction, which is a lot quicker, especially on SQLite.
  */
 class DbTransaction {
 public:
    enum SpecialBehaviours {
       NONE = 0,
-      DISABLE_FOREIGN_KEYS = 1 // For the duration of this transaction
+      DISABLE_FOREIGN_KEYS = 1 // For the duration of this transaction.  NB: Not possible for nested transactions.
    };
 
    /**
@@ -61,6 +67,8 @@ private:
    QString const nameForLogging;
    bool committed;
    int specialBehaviours;
+   //! 0 for an outermost transaction, otherwise the number of transactions this one is nested inside
+   int nestingLevel;
 
    // RAII class shouldn't be getting copied or moved
    DbTransaction(DbTransaction const &) = delete;
@@ -23,8 +23,11 @@
 
 #include "Application.h"
 #include "config.h"
+#include "database/Database.h"
 #include "database/DatabaseSchemaHelper.h"
+#include "database/DbTransaction.h"
 #include "database/ObjectStoreWrapper.h"
+#include "Logging.h"
 #include "model/Recipe.h"
 #include "serialization/ImportExport.h"
 
@@ -89,12 +92,12 @@ DefaultContentLoader::UpdateResult DefaultContentLoader::updateContentIfNecessar
    //
    int const defaultContentAlreadyLoaded = DatabaseSchemaHelper::getDefaultContentVersionFromDb(db);
    if (defaultContentAlreadyLoaded < 0) {
-      qWarning() << Q_FUNC_INFO << "Could not read default_content column from settings table";
+      qCWarning(Logging::database) << Q_FUNC_INFO << "Could not read default_content column from settings table";
       userMessage << "Error reading settings from DB";
       return DefaultContentLoader::UpdateResult::Failed;
    }
 
-   qInfo() <<
+   qCInfo(Logging::database) <<
       Q_FUNC_INFO << "availableContentVersion:" << DefaultContentLoader::availableContentVersion << ", defaultContentAlreadyLoaded:" <<
       defaultContentAlreadyLoaded;
 
@@ -117,13 +120,13 @@ DefaultContentLoader::UpdateResult DefaultContentLoader::updateContentIfNecessar
             //
             // This is typically a coding error or a packaging error, unless our data directory has been messed with.
             //
-            qCritical() <<
+            qCCritical(Logging::database) <<
                Q_FUNC_INFO << "Search for" << globPattern << "in directory" << dir << "yielded" <<
                matchingFiles.size() << "results (expecting 1):" << matchingFiles.join(", ");
             userMessage << QObject::tr("Error matching %1 file pattern in %2 directory").arg(globPattern, dir.absolutePath());
             return DefaultContentLoader::UpdateResult::Failed;
          }
-         qDebug() << Q_FUNC_INFO << "Will read in" << matchingFiles.at(0);
+         qCDebug(Logging::database) << Q_FUNC_INFO << "Will read in" << matchingFiles.at(0);
          inputFiles << dir.absoluteFilePath(matchingFiles.at(0));
       }
 
@@ -134,8 +137,18 @@ DefaultContentLoader::UpdateResult DefaultContentLoader::updateContentIfNecessar
          // folder.
          //
          QList<Recipe *> allRecipesBeforeImport = ObjectStoreWrapper::getAllRaw<Recipe>();
-         qDebug() << Q_FUNC_INFO << allRecipesBeforeImport.size() << "Recipes before import";
+         qCDebug(Logging::database) << Q_FUNC_INFO << allRecipesBeforeImport.size() << "Recipes before import";
 
+         //
+         // Importing stores each record with its own DbTransaction.  Doing all of them inside one outer transaction
+         // (which makes the inner ones savepoints) means the DB only has to write everything out once, which, for the
+         // thousands of records in the default content, makes the import a lot quicker.
+         //
+         // NB: We commit this transaction even if the import fails, because anything that was imported OK is already
+         // in the object stores, so needs to be in the DB too.  (Records that failed will have been rolled back by
+         // their own DbTransaction.)
+         //
+         DbTransaction dbTransaction{Database::instance(), db, "Import default content"};
          succeeded = ImportExport::importFromFiles(inputFiles);
 
          if (succeeded) {
@@ -143,7 +156,7 @@ DefaultContentLoader::UpdateResult DefaultContentLoader::updateContentIfNecessar
             // Now see what Recipes exist that weren't there before the import
             //
             QList<Recipe *> allRecipesAfterImport = ObjectStoreWrapper::getAllRaw<Recipe>();
-            qDebug() << Q_FUNC_INFO << allRecipesAfterImport.size() << "Recipes after import";
+            qCDebug(Logging::database) << Q_FUNC_INFO << allRecipesAfterImport.size() << "Recipes after import";
 
             //
             // Once the lists are sorted, finding the difference is just a library call
@@ -155,7 +168,7 @@ DefaultContentLoader::UpdateResult DefaultContentLoader::updateContentIfNecessar
             std::set_difference(allRecipesAfterImport.begin(), allRecipesAfterImport.end(),
                                 allRecipesBeforeImport.begin(), allRecipesBeforeImport.end(),
                                 std::back_inserter(newlyImportedRecipes));
-            qDebug() << Q_FUNC_INFO << newlyImportedRecipes.size() << "newly imported Recipes";
+            qCDebug(Logging::database) << Q_FUNC_INFO << newlyImportedRecipes.size() << "newly imported Recipes";
             for (auto recipe : newlyImportedRecipes) {
                recipe->setFolder(FOLDER_FOR_SUPPLIED_RECIPES);
             }
@@ -169,6 +182,8 @@ DefaultContentLoader::UpdateResult DefaultContentLoader::updateContentIfNecessar
             );
          }
 
+         succeeded &= dbTransaction.commit();
+
       }
 
       //
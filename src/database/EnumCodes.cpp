@@ -0,0 +1,449 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * database/EnumCodes.cpp is part of Brewtarget, and is copyright the following authors 2024:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#include "database/EnumCodes.h"
+
+#include <algorithm>
+#include <memory>
+#include <unordered_map>
+#include <variant>
+
+#include <QMutex>
+#include <QMutexLocker>
+#include <QRegularExpression>
+#include <QSqlError>
+#include <QStringList>
+#include <QVariant>
+
+#include "database/BtSqlQuery.h"
+#include "database/Database.h"
+#include "Logging.h"
+
+namespace {
+   QLatin1String const codeTableName{"enum_code"};
+
+   //
+   // Codecs are created by EnumCodes::load, which is called on the main thread, and are never changed or deleted after
+   // that, so the pointers handed out by EnumCodes::codecFor stay valid and can be used from any thread.  The mutex is
+   // just to protect the map itself.
+   //
+   QMutex codecsMutex;
+   std::unordered_map<ObjectStore::TableField const *, std::unique_ptr<EnumCodes::Codec>> codecs;
+
+   /**
+    * \brief One value of an enum or unit field, as given by the field's mapping
+    */
+   struct MappingEntry {
+      QString                   string;
+      std::optional<int>        enumValue;
+      Measurement::Unit const * unit;
+   };
+
+   /**
+    * \return All the values of \c fieldDefn, in mapping order
+    */
+   std::vector<MappingEntry> mappingEntries(BtStringConst const & tableName,
+                                            ObjectStore::TableField const & fieldDefn) {
+      std::vector<MappingEntry> entries;
+      if (auto const enumMapping = std::get_if<EnumStringMapping const *>(&fieldDefn.valueDecoder)) {
+         for (EnumAndItsString const & entry : **enumMapping) {
+            entries.push_back(MappingEntry{entry.string, entry.native, nullptr});
+         }
+      } else if (auto const unitMapping =
+                    std::get_if<Measurement::UnitStringMapping const *>(&fieldDefn.valueDecoder)) {
+         for (auto const & entry : (*unitMapping)->entries()) {
+            entries.push_back(MappingEntry{entry.string, std::nullopt, entry.address});
+         }
+      } else {
+         // It's a coding error if a coded field doesn't have a mapping
+         qCCritical(Logging::database) <<
+            Q_FUNC_INFO << "Coding Error!  No mapping for column" << fieldDefn.columnName << "of" << tableName;
+         Q_ASSERT(false);
+      }
+      return entries;
+   }
+
+   bool execQueries(QSqlDatabase & connection, QStringList const & queries) {
+      BtSqlQuery sqlQuery{connection};
+      for (QString const & query : queries) {
+         if (!sqlQuery.exec(query)) {
+            qCCritical(Logging::database) <<
+               Q_FUNC_INFO << "Error executing database query" << query << ":" << sqlQuery.lastError().text();
+            return false;
+         }
+      }
+      return true;
+   }
+}
+
+EnumCodes::Codec::Codec() = default;
+
+EnumCodes::Codec::~Codec() = default;
+
+std::optional<int> EnumCodes::Codec::enumValue(int const code) const {
+   if (code < 0 || static_cast<std::size_t>(code) >= this->m_enumValues.size()) {
+      return std::nullopt;
+   }
+   return this->m_enumValues[static_cast<std::size_t>(code)];
+}
+
+std::optional<int> EnumCodes::Codec::code(int const enumValue) const {
+   auto match = this->m_codesByEnumValue.constFind(enumValue);
+   if (match == this->m_codesByEnumValue.cend()) {
+      return std::nullopt;
+   }
+   return *match;
+}
+
+Measurement::Unit const * EnumCodes::Codec::unit(int const code) const {
+   if (code < 0 || static_cast<std::size_t>(code) >= this->m_units.size()) {
+      return nullptr;
+   }
+   return this->m_units[static_cast<std::size_t>(code)];
+}
+
+std::optional<int> EnumCodes::Codec::code(Measurement::Unit const * unit) const {
+   auto match = this->m_codesByUnit.constFind(unit);
+   if (match == this->m_codesByUnit.cend()) {
+      return std::nullopt;
+   }
+   return *match;
+}
+
+std::optional<int> EnumCodes::Codec::codeForString(QString const & value) const {
+   auto match = this->m_codesByString.constFind(value);
+   if (match == this->m_codesByString.cend()) {
+      return std::nullopt;
+   }
+   return *match;
+}
+
+void EnumCodes::Codec::add(int const code,
+                           QString const & value,
+                           std::optional<int> const enumValue,
+                           Measurement::Unit const * unit) {
+   Q_ASSERT(code >= 0);
+   std::size_t const index = static_cast<std::size_t>(code);
+   if (enumValue) {
+      if (index >= this->m_enumValues.size()) {
+         this->m_enumValues.resize(index + 1);
+      }
+      this->m_enumValues[index] = enumValue;
+      this->m_codesByEnumValue.insert(*enumValue, code);
+   }
+   if (unit) {
+      if (index >= this->m_units.size()) {
+         this->m_units.resize(index + 1, nullptr);
+      }
+      this->m_units[index] = unit;
+      this->m_codesByUnit.insert(unit, code);
+   }
+   this->m_codesByString.insert(value, code);
+   return;
+}
+
+bool EnumCodes::createTables([[maybe_unused]] Database & database, QSqlDatabase & connection) {
+   return execQueries(
+      connection,
+      {QString("CREATE TABLE IF NOT EXISTS %1 ("
+               "table_name TEXT NOT NULL, "
+               "column_name TEXT NOT NULL, "
+               "code INTEGER NOT NULL, "
+               "value TEXT NOT NULL, "
+               "PRIMARY KEY (table_name, column_name, code), "
+               "UNIQUE (table_name, column_name, value))").arg(codeTableName)}
+   );
+}
+
+bool EnumCodes::load(QSqlDatabase & connection,
+                     BtStringConst const & tableName,
+                     QVector<ObjectStore::TableField> const & tableFields) {
+   BtSqlQuery selectQuery{connection};
+   selectQuery.prepare(
+      QString("SELECT code, value FROM %1 WHERE table_name = ? AND column_name = ?").arg(codeTableName)
+   );
+   BtSqlQuery insertQuery{connection};
+   insertQuery.prepare(
+      QString("INSERT INTO %1 (table_name, column_name, code, value) VALUES (?, ?, ?, ?)").arg(codeTableName)
+   );
+
+   for (ObjectStore::TableField const & fieldDefn : tableFields) {
+      if (!fieldDefn.isStoredAsCode()) {
+         continue;
+      }
+
+      selectQuery.bindValue(0, QString{*tableName});
+      selectQuery.bindValue(1, QString{*fieldDefn.columnName});
+      if (!selectQuery.exec()) {
+         qCCritical(Logging::database) <<
+            Q_FUNC_INFO << "Error reading codes for" << tableName << "." << fieldDefn.columnName << ":" <<
+            selectQuery.lastError().text();
+         return false;
+      }
+      QHash<QString, int> codesInDb;
+      int nextCode = 0;
+      while (selectQuery.next()) {
+         int const code = selectQuery.value(0).toInt();
+         codesInDb.insert(selectQuery.value(1).toString(), code);
+         nextCode = std::max(nextCode, code + 1);
+      }
+      selectQuery.finish();
+
+      Codec const * const existingCodec = EnumCodes::codecFor(fieldDefn);
+      auto codec = std::make_unique<Codec>();
+      for (MappingEntry const & entry : mappingEntries(tableName, fieldDefn)) {
+         std::optional<int> const existingCode =
+            existingCodec ? existingCodec->codeForString(entry.string) : std::nullopt;
+         int code;
+         auto codeInDb = codesInDb.constFind(entry.string);
+         if (codeInDb != codesInDb.cend()) {
+            code = *codeInDb;
+         } else {
+            code = existingCode.value_or(nextCode);
+            nextCode = std::max(nextCode, code + 1);
+            insertQuery.bindValue(0, QString{*tableName});
+            insertQuery.bindValue(1, QString{*fieldDefn.columnName});
+            insertQuery.bindValue(2, code);
+            insertQuery.bindValue(3, entry.string);
+            if (!insertQuery.exec()) {
+               qCCritical(Logging::database) <<
+                  Q_FUNC_INFO << "Error adding code" << code << "for" << entry.string << "in" << tableName << "." <<
+                  fieldDefn.columnName << ":" << insertQuery.lastError().text();
+               return false;
+            }
+            insertQuery.finish();
+         }
+
+         if (existingCodec && existingCode != code) {
+            qCCritical(Logging::database) <<
+               Q_FUNC_INFO << "DB has code" << code << "for" << entry.string << "in" << tableName << "." <<
+               fieldDefn.columnName << "but we are already using" <<
+               (existingCode ? QString::number(*existingCode) : QString{"none"});
+            return false;
+         }
+         codec->add(code, entry.string, entry.enumValue, entry.unit);
+      }
+
+      if (!existingCodec) {
+         QMutexLocker locker(&codecsMutex);
+         codecs.emplace(&fieldDefn, std::move(codec));
+      }
+   }
+   return true;
+}
+
+EnumCodes::Codec const * EnumCodes::codecFor(ObjectStore::TableField const & fieldDefn) {
+   QMutexLocker locker(&codecsMutex);
+   auto match = codecs.find(&fieldDefn);
+   if (match == codecs.end()) {
+      return nullptr;
+   }
+   return match->second.get();
+}
+
+namespace {
+   /**
+    * \return Statement setting column \c column of table \c tableToUpdate to the codes for the strings in its column
+    *         \c textColumn, using the codes for column \c column of \c table.  (The two tables are different when we
+    *         are converting a copy of \c table.)  Values were matched ignoring case when they were read in, so we do
+    *         the same here.
+    */
+   QString codesFromTextStatement(QString const & tableToUpdate,
+                                  QString const & table,
+                                  QString const & column,
+                                  QString const & textColumn) {
+      return QString("UPDATE %1 SET %3 = (SELECT code FROM %5 "
+                                         "WHERE table_name = '%2' AND column_name = '%3' AND "
+                                               "LOWER(value) = LOWER(%1.%4))").arg(tableToUpdate,
+                                                                                    table,
+                                                                                    column,
+                                                                                    textColumn,
+                                                                                    codeTableName);
+   }
+
+   /**
+    * \brief SQLite version of \c EnumCodes::convertColumn.  Rather than rename, add and drop columns, which needs
+    *        SQLite 3.35 or newer (and fails if an index or trigger refers to the column), we rebuild the table as the
+    *        SQLite documentation recommends: create a new table that differs only in the type of the column, copy the
+    *        rows across and convert them, drop the old table, rename the new one, and recreate the old table's
+    *        indexes and triggers.  This relies on the migration having foreign keys turned off.
+    */
+   bool convertColumnByRebuild(Database & database,
+                               QSqlDatabase & connection,
+                               QString const & table,
+                               QString const & column) {
+      BtSqlQuery sqlQuery{connection};
+      // Needs to be the type exactly as declared, so we can find it in the CREATE TABLE statement
+      QString declaredType;
+      bool columnFound = false;
+      if (!sqlQuery.exec(QString("PRAGMA table_info(%1)").arg(table))) {
+         qCCritical(Logging::database) <<
+            Q_FUNC_INFO << "Error reading columns of" << table << ":" << sqlQuery.lastError().text();
+         return false;
+      }
+      while (sqlQuery.next()) {
+         if (sqlQuery.value("name").toString().compare(column, Qt::CaseInsensitive) == 0) {
+            declaredType = sqlQuery.value("type").toString();
+            columnFound = true;
+         }
+      }
+      sqlQuery.finish();
+      if (!columnFound) {
+         qCCritical(Logging::database) << Q_FUNC_INFO << "No column" << column << "in" << table;
+         return false;
+      }
+      if (declaredType.isEmpty()) {
+         // A column with no declared type has no affinity, so it will store the codes as integers as it is
+         return execQueries(connection, {codesFromTextStatement(table, table, column, column)});
+      }
+
+      QString createStatement;
+      QStringList dependentStatements;
+      if (!sqlQuery.exec(QString("SELECT type, sql FROM sqlite_master WHERE tbl_name = '%1' AND sql IS NOT NULL "
+                                 "AND type IN ('table', 'index', 'trigger')").arg(table))) {
+         qCCritical(Logging::database) <<
+            Q_FUNC_INFO << "Error reading schema of" << table << ":" << sqlQuery.lastError().text();
+         return false;
+      }
+      while (sqlQuery.next()) {
+         if (sqlQuery.value(0).toString() == "table") {
+            createStatement = sqlQuery.value(1).toString();
+         } else {
+            dependentStatements.append(sqlQuery.value(1).toString());
+         }
+      }
+      sqlQuery.finish();
+
+      //
+      // The new table is the old one with a different name and the one column declared as an integer.  The column
+      // definition is the column name (maybe quoted) followed by its declared type, at the start of the column list or
+      // after a comma.
+      //
+      QString const newTable = table + "_v22";
+      QRegularExpression const tableNameRegExp{
+         QString(R"(^(\s*CREATE\s+TABLE\s+)["`\[]?%1["`\]]?)").arg(QRegularExpression::escape(table)),
+         QRegularExpression::CaseInsensitiveOption
+      };
+      QRegularExpression const columnRegExp{
+         QString(R"([(,]\s*["`\[]?%1["`\]]?\s+(%2)(?=[\s,)]|$))").arg(QRegularExpression::escape(column),
+                                                                      QRegularExpression::escape(declaredType)),
+         QRegularExpression::CaseInsensitiveOption
+      };
+      QRegularExpressionMatch const tableNameMatch = tableNameRegExp.match(createStatement);
+      QRegularExpressionMatch const columnMatch = columnRegExp.match(createStatement);
+      if (!tableNameMatch.hasMatch() || !columnMatch.hasMatch()) {
+         qCCritical(Logging::database) <<
+            Q_FUNC_INFO << "Unable to find" << column << "in definition of" << table << ":" << createStatement;
+         return false;
+      }
+      // Replace the column type first, as it comes after the table name
+      createStatement.replace(columnMatch.capturedStart(1),
+                              columnMatch.capturedLength(1),
+                              database.getDbNativeTypeName<int>());
+      createStatement.replace(tableNameMatch.capturedStart(0),
+                              tableNameMatch.capturedLength(0),
+                              tableNameMatch.captured(1) + newTable);
+
+      return execQueries(
+         connection,
+         QStringList{
+            createStatement,
+            QString("INSERT INTO %1 SELECT * FROM %2").arg(newTable, table),
+            codesFromTextStatement(newTable, table, column, column),
+            QString("DROP TABLE %1").arg(table),
+            // Otherwise newer versions of SQLite check, and try to update, every trigger and view in the DB when we
+            // rename the table, which fails for any that refer to the table we just dropped
+            QString("PRAGMA legacy_alter_table = ON"),
+            QString("ALTER TABLE %1 RENAME TO %2").arg(newTable, table),
+            QString("PRAGMA legacy_alter_table = OFF"),
+         } + dependentStatements
+      );
+   }
+}
+
+bool EnumCodes::convertColumn(Database & database,
+                              QSqlDatabase & connection,
+                              BtStringConst const & tableName,
+                              ObjectStore::TableField const & fieldDefn) {
+   QString const table{*tableName};
+   QString const column{*fieldDefn.columnName};
+
+   BtSqlQuery sqlQuery{connection};
+   QString const countQuery = QString(
+      "SELECT COUNT(*) FROM %1 WHERE %2 IS NOT NULL AND NOT EXISTS (SELECT 1 FROM %3 "
+      "WHERE table_name = '%1' AND column_name = '%2' AND LOWER(value) = LOWER(%1.%2))"
+   ).arg(table, column, codeTableName);
+   if (sqlQuery.exec(countQuery) && sqlQuery.next() && sqlQuery.value(0).toInt() > 0) {
+      qCWarning(Logging::database) <<
+         Q_FUNC_INFO << sqlQuery.value(0).toInt() << "values in" << table << "." << column << "could not be decoded, "
+         "so will be null";
+   }
+   sqlQuery.finish();
+
+   if (database.dbType() == Database::DbType::SQLITE) {
+      return convertColumnByRebuild(database, connection, table, column);
+   }
+
+   // PostgreSQL has always been able to rename and drop columns, and the views that would get in the way don't exist
+   // yet
+   QString const textColumn = column + "_text";
+   return execQueries(
+      connection,
+      {QString("ALTER TABLE %1 RENAME COLUMN %2 TO %3").arg(table, column, textColumn),
+       QString("ALTER TABLE %1 ADD COLUMN %2 %3").arg(table, column, database.getDbNativeTypeName<int>()),
+       codesFromTextStatement(table, table, column, textColumn),
+       QString("ALTER TABLE %1 DROP COLUMN %2").arg(table, textColumn)}
+   );
+}
+
+QString EnumCodes::viewName(BtStringConst const & tableName) {
+   return QString("readable_%1").arg(*tableName);
+}
+
+QString EnumCodes::valueExpression(BtStringConst const & tableName, ObjectStore::TableField const & fieldDefn) {
+   return QString("(SELECT value FROM %3 WHERE table_name = '%1' AND column_name = '%2' AND code = %1.%2)").arg(
+      *tableName, *fieldDefn.columnName, codeTableName
+   );
+}
+
+bool EnumCodes::createView(QSqlDatabase & connection,
+                           BtStringConst const & tableName,
+                           QVector<ObjectStore::TableField> const & tableFields) {
+   QString const table{*tableName};
+   QStringList columns;
+   bool hasCodedColumns = false;
+   for (ObjectStore::TableField const & fieldDefn : tableFields) {
+      QString const column{*fieldDefn.columnName};
+      if (fieldDefn.isStoredAsCode()) {
+         hasCodedColumns = true;
+         columns.append(QString("%1 AS %2").arg(EnumCodes::valueExpression(tableName, fieldDefn), column));
+      } else {
+         columns.append(QString("%1.%2").arg(table, column));
+      }
+   }
+   if (!hasCodedColumns) {
+      return true;
+   }
+
+   return execQueries(
+      connection,
+      {QString("DROP VIEW IF EXISTS %1").arg(EnumCodes::viewName(tableName)),
+       QString("CREATE VIEW %1 AS SELECT %2 FROM %3").arg(EnumCodes::viewName(tableName), columns.join(", "), table)}
+   );
+}
+
+bool EnumCodes::dropView(QSqlDatabase & connection, BtStringConst const & tableName) {
+   return execQueries(connection, {QString("DROP VIEW IF EXISTS %1").arg(EnumCodes::viewName(tableName))});
+}
@@ -0,0 +1,184 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * database/EnumCodes.h is part of Brewtarget, and is copyright the following authors 2024:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#ifndef DATABASE_ENUMCODES_H
+#define DATABASE_ENUMCODES_H
+#pragma once
+
+#include <optional>
+#include <vector>
+
+#include <QHash>
+#include <QSqlDatabase>
+#include <QString>
+#include <QVector>
+
+#include "database/ObjectStore.h"
+
+class Database;
+
+/**
+ * \brief Integer codes for the values of enum and unit fields that are \c ObjectStore::STORED_AS_CODE.
+ *
+ *        The \c enum_code table gives, for each such column, the string (from the field's \c EnumStringMapping or
+ *        \c Measurement::UnitStringMapping) that each code stands for.  Codes are never changed or reused once
+ *        assigned, so they do not depend on the order or numbering of the values in the code: a value that is new to
+ *        a DB just gets the next free code for its column.  (In a new DB, codes are assigned in mapping order, which,
+ *        for an ordinary enum, means they start out the same as the enum's own values.)
+ *
+ *        At start-up (see \c LoadAllEnumCodes), we read the codes for every coded column into a \c Codec, so that
+ *        \c ObjectStore can translate between codes and enum values or units with an array or hash lookup rather than
+ *        a string mapping.
+ *
+ *        For anyone looking at the DB with other tools, each table with coded columns also has a view (see
+ *        \c createView) showing the strings in place of the codes, ie what the table would have looked like before
+ *        v22 of the schema.
+ */
+namespace EnumCodes {
+
+   /**
+    * \brief Translation between the codes of one column and the values they stand for.  Which pair of member functions
+    *        applies depends on whether the field is a \c FieldType::Enum or a \c FieldType::Unit.
+    */
+   class Codec {
+   public:
+      Codec();
+      ~Codec();
+
+      /**
+       * \return The enum value with code \c code, or \c std::nullopt if there isn't one
+       */
+      std::optional<int> enumValue(int const code) const;
+
+      /**
+       * \return The code for enum value \c enumValue, or \c std::nullopt if there isn't one
+       */
+      std::optional<int> code(int const enumValue) const;
+
+      /**
+       * \return The unit with code \c code, or \c nullptr if there isn't one
+       */
+      Measurement::Unit const * unit(int const code) const;
+
+      /**
+       * \return The code for \c unit, or \c std::nullopt if there isn't one
+       */
+      std::optional<int> code(Measurement::Unit const * unit) const;
+
+      /**
+       * \return The code for the string \c value from the field's mapping, or \c std::nullopt if there isn't one
+       */
+      std::optional<int> codeForString(QString const & value) const;
+
+      /**
+       * \brief Used by \c load to record that \c code stands for \c value, which is the string for \c enumValue (for
+       *        an enum field) or \c unit (for a unit field)
+       */
+      void add(int const code,
+               QString const & value,
+               std::optional<int> const enumValue,
+               Measurement::Unit const * unit);
+
+   private:
+      //! Indexed by code.  Codes whose value is no longer in the mapping are \c std::nullopt or \c nullptr.
+      std::vector<std::optional<int>> m_enumValues;
+      std::vector<Measurement::Unit const *> m_units;
+
+      QHash<int, int> m_codesByEnumValue;
+      QHash<Measurement::Unit const *, int> m_codesByUnit;
+      QHash<QString, int> m_codesByString;
+   };
+
+   /**
+    * \brief Create the table that holds the codes.  This is done as part of \c CreateAllDatabaseTables, and when
+    *        upgrading an existing database.  Note that it is the caller's responsibility to handle transactions.
+    *
+    * \return \c false if something went wrong, \c true otherwise
+    */
+   bool createTables(Database & database, QSqlDatabase & connection);
+
+   /**
+    * \brief For each coded field in \c tableFields (of table \c tableName), read its codes from the DB, first adding
+    *        codes for any mapping values that do not yet have one, and set up its \c Codec if we have not already.
+    *
+    *        If we already have a \c Codec for a field (eg because we are writing a new DB with the contents of the
+    *        current one), missing values are given the codes we are already using, so the two DBs agree.  It is an
+    *        error for the DB to have different codes from the ones we are using.
+    *
+    *        This writes to the DB, so should be called from the main thread before objects are read in.  Note that it
+    *        is the caller's responsibility to handle transactions.
+    *
+    * \return \c false if something went wrong, \c true otherwise
+    */
+   bool load(QSqlDatabase & connection,
+             BtStringConst const & tableName,
+             QVector<ObjectStore::TableField> const & tableFields);
+
+   /**
+    * \return The \c Codec for \c fieldDefn, or \c nullptr if \c load has not been called for its table (which is a
+    *         coding error)
+    */
+   Codec const * codecFor(ObjectStore::TableField const & fieldDefn);
+
+   /**
+    * \brief Used in the schema migration to v22: replace the text values in column \c fieldDefn.columnName of table
+    *        \c tableName with their codes.  \c load must already have been called for the table.  Values that do not
+    *        match anything in the mapping (even ignoring case) become null, and are logged.
+    *
+    *        On SQLite, this rebuilds the table (keeping its indexes and triggers) rather than using ALTER TABLE ...
+    *        DROP COLUMN, so it works with versions of SQLite older than 3.35.  Foreign keys need to be turned off.
+    *
+    * \return \c false if something went wrong, \c true otherwise
+    */
+   bool convertColumn(Database & database,
+                      QSqlDatabase & connection,
+                      BtStringConst const & tableName,
+                      ObjectStore::TableField const & fieldDefn);
+
+   /**
+    * \brief Name of the view that \c createView creates for \c tableName, eg "readable_hop" for "hop"
+    */
+   QString viewName(BtStringConst const & tableName);
+
+   /**
+    * \return SQL expression giving the string that the code in coded column \c fieldDefn of the current row of
+    *         \c tableName stands for, as shown in the view made by \c createView.  Eg for sorting by what the user
+    *         sees rather than by code.
+    */
+   QString valueExpression(BtStringConst const & tableName, ObjectStore::TableField const & fieldDefn);
+
+   /**
+    * \brief (Re)create the view of table \c tableName that has the same columns as the table, but with each coded
+    *        column showing the string for the code, as given by the \c enum_code table.  Nothing is done for tables
+    *        without coded columns.
+    *
+    *        Because a view stops columns it refers to from being renamed or dropped, schema migrations drop the views
+    *        first (see \c dropView) and recreate them at the end.
+    *
+    * \return \c false if something went wrong, \c true otherwise
+    */
+   bool createView(QSqlDatabase & connection,
+                   BtStringConst const & tableName,
+                   QVector<ObjectStore::TableField> const & tableFields);
+
+   /**
+    * \brief Drop the view created by \c createView, if it exists
+    *
+    * \return \c false if something went wrong, \c true otherwise
+    */
+   bool dropView(QSqlDatabase & connection, BtStringConst const & tableName);
+}
+
+#endif
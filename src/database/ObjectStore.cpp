@@ -15,35 +15,71 @@
  ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
 #include "database/ObjectStore.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cstring>
 #include <iostream> // For start-up errors!
+#include <mutex>    // For std::once_flag etc
+#include <optional>
 #include <tuple>
+#include <utility>
 
+#include <QCache>
+#include <QCoreApplication>
+#include <QDataStream>
 #include <QDebug>
+#include <QElapsedTimer>
 #include <QHash>
 #include <QMap>
+#include <QMetaProperty>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QPair>
+#include <QSet>
 #include <QSqlDriver>
 #include <QSqlError>
 #include <QSqlField>
+#include <QFutureInterface>
+#include <QRunnable>
 #include <QSqlRecord>
+#include <QTextStream>
+#include <QThread>
+#include <QThreadPool>
+#include <QTimer>
+#include <QVariant>
 #include <QVector>
 
 #include "database/BtSqlQuery.h"
+#include "database/ChangeLog.h"
 #include "database/Database.h"
 #include "database/DbTransaction.h"
+#include "database/EnumCodes.h"
 #include "Logging.h"
 #include "model/NamedParameterBundle.h"
+#include "PersistentSettings.h"
+#include "utils/Diagnostics.h"
 #include "utils/MetaTypes.h"
 #include "utils/OptionalHelpers.h"
+#include "utils/StringPool.h"
+#include "utils/Tracing.h"
 
 // Private implementation details that don't need access to class member variables
 namespace {
+   //
+   // Limit on the number of bind parameters in one statement when we write multiple rows per INSERT.  SQLite before
+   // v3.32 does not allow more than 999.  (PostgreSQL allows 65535.)
+   //
+   constexpr int maxBindValuesPerStatement = 999;
+
 
    /**
-    * \brief For a given field type, get the native database typename
+    * \brief For a given field, get the native database typename
     */
-   char const * getDatabaseNativeTypeName(Database const & database, ObjectStore::FieldType const fieldType) {
-      switch (fieldType) {
+   char const * getDatabaseNativeTypeName(Database const & database, ObjectStore::TableField const & fieldDefn) {
+      if (fieldDefn.isStoredAsCode()) {
+         return database.getDbNativeTypeName<int>();
+      }
+      switch (fieldDefn.fieldType) {
          case ObjectStore::FieldType::Bool:    return database.getDbNativeTypeName<bool>();
          case ObjectStore::FieldType::Int:     return database.getDbNativeTypeName<int>();
          case ObjectStore::FieldType::UInt:    return database.getDbNativeTypeName<unsigned int>();
@@ -96,7 +132,7 @@ namespace {
       bool firstFieldOutput = false;
       for (auto const & fieldDefn: tableDefinition.tableFields) {
          if (std::holds_alternative<ObjectStore::TableDefinition const *>(fieldDefn.valueDecoder)) {
-            qDebug() << Q_FUNC_INFO << "Skipping" << fieldDefn.columnName << "as foreign key";
+            qCDebug(Logging::database) << Q_FUNC_INFO << "Skipping" << fieldDefn.columnName << "as foreign key";
             // It's (currently) a coding error if a foreign key is anything other than an integer
             Q_ASSERT(fieldDefn.fieldType == ObjectStore::FieldType::Int);
             continue;
@@ -123,17 +159,17 @@ namespace {
             firstFieldOutput = true;
             queryStringAsStream << " " << database.getDbNativePrimaryKeyDeclaration();
          } else {
-            queryStringAsStream << " " << getDatabaseNativeTypeName(database, fieldDefn.fieldType);
+            queryStringAsStream << " " << getDatabaseNativeTypeName(database, fieldDefn);
          }
       }
       queryStringAsStream << "\n);";
 
-      qDebug().noquote() << Q_FUNC_INFO << "Table creation: " << queryString;
+      qCDebug(Logging::database).noquote() << Q_FUNC_INFO << "Table creation: " << queryString;
 
       BtSqlQuery sqlQuery{connection};
       sqlQuery.prepare(queryString);
       if (!sqlQuery.exec()) {
-         qCritical() <<
+         qCCritical(Logging::database) <<
             Q_FUNC_INFO << "Error executing database query " << queryString << ": " << sqlQuery.lastError().text();
          return false;
       }
@@ -189,11 +225,11 @@ namespace {
             ).arg(
                *foreignKeyTo->tableFields[0].columnName
             );
-            qDebug().noquote() << Q_FUNC_INFO << "Foreign keys: " << queryString;
+            qCDebug(Logging::database).noquote() << Q_FUNC_INFO << "Foreign keys: " << queryString;
 
             sqlQuery.prepare(queryString);
             if (!sqlQuery.exec()) {
-               qCritical() <<
+               qCCritical(Logging::database) <<
                   Q_FUNC_INFO << "Error executing database query " << queryString << ": " <<
                   sqlQuery.lastError().text();
                return false;
@@ -204,22 +240,71 @@ namespace {
    }
 
    /**
-    * \brief Return a string containing all the bound values on a query.   This is quite a useful thing to have logged
-    *        when you get an error!
+    * \brief Add database indexes on the foreign key columns of a table (which, for a junction table, means the columns
+    *        for both ends of the cross-reference), as these are what we use to find rows when, eg, deleting an object
+    *        means deleting all the junction table rows that refer to it.  Without an index, such lookups are a full
+    *        table scan.
+    *
+    *        We use "IF NOT EXISTS", which both SQLite and PostgreSQL support, so that this is safe to call on a
+    *        database that already has some or all of the indexes.
     *
-    *        NOTE: This can be a long string.  It includes newlines, and is intended to be logged with
-    *              qDebug().noquote() or similar.
+    * \return true if succeeded, false otherwise
     */
-   QString BoundValuesToString(BtSqlQuery const & sqlQuery) {
-      QString result;
-      QTextStream resultAsStream{&result};
+   bool addIndexesToTable(QSqlDatabase & connection, ObjectStore::TableDefinition const & tableDefinition) {
+      BtSqlQuery sqlQuery{connection};
+      for (auto const & fieldDefn: tableDefinition.tableFields) {
+         if (fieldDefn.fieldType != ObjectStore::FieldType::Int ||
+             !std::holds_alternative<ObjectStore::TableDefinition const *>(fieldDefn.valueDecoder)) {
+            continue;
+         }
+
+         QString const queryString = QString{
+            "CREATE INDEX IF NOT EXISTS %1_%2_idx ON %1 (%2)"
+         }.arg(*tableDefinition.tableName).arg(*fieldDefn.columnName);
+         qCDebug(Logging::database).noquote() << Q_FUNC_INFO << "Indexes: " << queryString;
 
-      QMap<QString, QVariant> boundValueMap = sqlQuery.boundValues();
-      for (auto bv = boundValueMap.begin(); bv != boundValueMap.end(); ++bv) {
-         resultAsStream << bv.key() << ": " << bv.value().toString() << "\n";
+         sqlQuery.prepare(queryString);
+         if (!sqlQuery.exec()) {
+            qCCritical(Logging::database) <<
+               Q_FUNC_INFO << "Error executing database query " << queryString << ": " << sqlQuery.lastError().text();
+            return false;
+         }
       }
+      return true;
+   }
 
-      return result;
+   /**
+    * \brief Add a PostgreSQL trigger that, whenever a row of a table is inserted, updated or deleted, sends a
+    *        notification on \c ObjectStore::changeNotificationChannel saying which object changed.  The payload is
+    *        "<primary table name>,<object ID>".  For a junction table, the object is the one on the "this" side of the
+    *        cross-reference, since that's the object whose junction property has changed.
+    *
+    *        Relies on the notify_object_change() function created by \c ObjectStore::createChangeNotificationTriggers.
+    *
+    * \return true if succeeded, false otherwise
+    */
+   bool addChangeNotificationTrigger(QSqlDatabase & connection,
+                                     BtStringConst const & tableName,
+                                     BtStringConst const & objectTableName,
+                                     BtStringConst const & objectIdColumnName) {
+      QString const queryStrings[] {
+         QString{"DROP TRIGGER IF EXISTS %1_notify_change ON %1"}.arg(*tableName),
+         QString{
+            "CREATE TRIGGER %1_notify_change AFTER INSERT OR UPDATE OR DELETE ON %1 "
+            "FOR EACH ROW EXECUTE PROCEDURE notify_object_change('%2', '%3')"
+         }.arg(*tableName).arg(*objectTableName).arg(*objectIdColumnName)
+      };
+      BtSqlQuery sqlQuery{connection};
+      for (QString const & queryString : queryStrings) {
+         qCDebug(Logging::database).noquote() << Q_FUNC_INFO << "Triggers: " << queryString;
+         sqlQuery.prepare(queryString);
+         if (!sqlQuery.exec()) {
+            qCCritical(Logging::database) <<
+               Q_FUNC_INFO << "Error executing database query " << queryString << ": " << sqlQuery.lastError().text();
+            return false;
+         }
+      }
+      return true;
    }
 
    /**
@@ -237,7 +322,7 @@ namespace {
       auto match = enumMapping->stringToEnumAsInt(stringValue);
       // If we didn't find a match, it's either a coding error or someone messed with the DB data
       if (!match) {
-         qCritical() <<
+         qCCritical(Logging::database) <<
             Q_FUNC_INFO << "Could not decode" << stringValue << "to enum when mapping column" <<
             fieldDefn.columnName << "to property" << fieldDefn.propertyName << "for" << primaryTable.tableName <<
             "so using 0";
@@ -268,7 +353,7 @@ namespace {
       Measurement::Unit const * match = unitMapping->stringToObjectAddress(stringValue);
       // If we didn't find a match, it's either a coding error or someone messed with the DB data
       if (!match) {
-         qCritical() <<
+         qCCritical(Logging::database) <<
             Q_FUNC_INFO << "Could not decode" << stringValue << "to Unit when mapping column" <<
             fieldDefn.columnName << "to property" << fieldDefn.propertyName << "for" << primaryTable.tableName;
          // Stop here on debug build, as the code is unlikely to be able to recover
@@ -277,6 +362,65 @@ namespace {
       return match;
    }
 
+   /**
+    * \brief Given a code pulled out of the DB for an enum field that is \c ObjectStore::STORED_AS_CODE, look up and
+    *        return its internal numerical enum equivalent.  As with \c stringToEnum, it's the caller's responsibility
+    *        to handle null values.
+    */
+   int codeToEnum(ObjectStore::TableDefinition const & primaryTable,
+                  ObjectStore::TableField const &      fieldDefn,
+                  EnumCodes::Codec const &             codec,
+                  int const                            code) {
+      std::optional<int> const match = codec.enumValue(code);
+      // If we didn't find a match, it's either a coding error or someone messed with the DB data
+      if (!match) {
+         qCCritical(Logging::database) <<
+            Q_FUNC_INFO << "Could not decode" << code << "to enum when mapping column" << fieldDefn.columnName <<
+            "to property" << fieldDefn.propertyName << "for" << primaryTable.tableName << "so using 0";
+         return 0;
+      }
+      return *match;
+   }
+
+   /**
+    * \brief As \c codeToEnum, but for a \c Measurement::Unit field
+    */
+   Measurement::Unit const * codeToUnit(ObjectStore::TableDefinition const & primaryTable,
+                                        ObjectStore::TableField const &      fieldDefn,
+                                        EnumCodes::Codec const &             codec,
+                                        int const                            code) {
+      Measurement::Unit const * match = codec.unit(code);
+      // If we didn't find a match, it's either a coding error or someone messed with the DB data
+      if (!match) {
+         qCCritical(Logging::database) <<
+            Q_FUNC_INFO << "Could not decode" << code << "to Unit when mapping column" << fieldDefn.columnName <<
+            "to property" << fieldDefn.propertyName << "for" << primaryTable.tableName;
+         // Stop here on debug build, as the code is unlikely to be able to recover
+         Q_ASSERT(false);
+      }
+      return match;
+   }
+
+   /**
+    * \brief The inverse of \c codeToEnum and \c codeToUnit, ie get the code to write to the DB for an enum value or
+    *        unit.  (The value comes from our own objects, so it's a coding error if there is no code for it.)
+    */
+   template<typename T>
+   QVariant valueToCode(ObjectStore::TableDefinition const & primaryTable,
+                        ObjectStore::TableField const &      fieldDefn,
+                        EnumCodes::Codec const &             codec,
+                        T const                              value) {
+      std::optional<int> const code = codec.code(value);
+      if (!code) {
+         qCCritical(Logging::database) <<
+            Q_FUNC_INFO << "Coding Error!  No code for" << value << "when mapping property" << fieldDefn.propertyName <<
+            "to column" << fieldDefn.columnName << "for" << primaryTable.tableName;
+         Q_ASSERT(false);
+         return QVariant{};
+      }
+      return QVariant{*code};
+   }
+
    //
    // Convenience functions for accessing specific fields of a JunctionTableDefinition struct
    //
@@ -294,57 +438,10 @@ namespace {
    }
 
    /**
-    * \brief Insert data from an object property to a junction table
-    *
-    * \param junctionTable
-    * \param object
-    * \param primaryKey  Note that this must be supplied separately as, for a new object, we may not (yet) have set its
-    *                    primary key (ie we cannot just read primary key from object)
-    * \param connection
-    *
-    * \return \c true if succeeded, \c false otherwise
+    * \brief Construct the SQL to insert one row into a junction table.  Note that orderByColumn column is only used if
+    *        specified, and that, if it is, we assume it's an integer type and that we create the values ourselves.
     */
-   bool insertIntoJunctionTableDefinition(ObjectStore::JunctionTableDefinition const & junctionTable,
-                                          QObject const & object,
-                                          QVariant const & primaryKey,
-                                          QSqlDatabase & connection) {
-      qDebug() <<
-         Q_FUNC_INFO << "Writing" << object.metaObject()->className() << "property" <<
-         GetJunctionTableDefinitionPropertyName(junctionTable) << " into junction table " <<
-         junctionTable.tableName;
-
-      //
-      // It's a coding error if the caller has supplied us anything other than an int inside the primaryKey QVariant.
-      //
-      // Here and elsewhere, although we could just do a Q_ASSERT, we prefer (a) some extra diagnostics on debug builds
-      // and (b) to bail out immediately of the DB transaction on non-debug builds.
-      //
-      if (QVariant::Type::Int != primaryKey.type()) {
-         qCritical() << Q_FUNC_INFO << "Unexpected contents of primaryKey QVariant: " << primaryKey.typeName();
-         Q_ASSERT(false); // Stop here on debug builds
-         return false;    // Continue but bail out of the current DB transaction on other builds
-      }
-
-      //
-      // Construct the query
-      //
-      // We may be inserting more than one row.  In theory we COULD combine all the rows into a single insert statement
-      // using either BtSqlQuery::execBatch() or directly constructing one of the common (but technically non-standard)
-      // syntaxes, eg the following works on a lot of databases (including PostgreSQL and newer versions of SQLite) for
-      // up to 1000 rows):
-      //    INSERT INTO table (columnA, columnB, ..., columnN)
-      //         VALUES       (r1_valA, r1_valB, ..., r1_valN),
-      //                      (r2_valA, r2_valB, ..., r2_valN),
-      //                      ...,
-      //                      (rm_valA, rm_valB, ..., rm_valN);
-      // However, we DON"T do this.  The variable binding is more complicated/error-prone than when just doing
-      // individual inserts.  (Even with BtSqlQuery::execBatch(), we'd have to loop to construct the lists of bind
-      // parameters.)  And there's likely no noticeable performance benefit given that we're typically inserting only
-      // a handful of rows at a time (eg all the Hops in a Recipe).
-      //
-      // So instead, we just do individual inserts.  Note that orderByColumn column is only used if specified, and
-      // that, if it is, we assume it's an integer type and that we create the values ourselves.
-      //
+   QString junctionTableInsertSql(ObjectStore::JunctionTableDefinition const & junctionTable) {
       QString queryString{"INSERT INTO "};
       QTextStream queryStringAsStream{&queryString};
       queryStringAsStream << junctionTable.tableName << " (" <<
@@ -353,30 +450,34 @@ namespace {
       if (!GetJunctionTableDefinitionOrderByColumn(junctionTable).isNull()) {
          queryStringAsStream << ", " << GetJunctionTableDefinitionOrderByColumn(junctionTable);
       }
-      QString const thisPrimaryKeyBindName  = QString{":"} + *GetJunctionTableDefinitionThisPrimaryKeyColumn(junctionTable);
-      QString const otherPrimaryKeyBindName = QString{":"} + *GetJunctionTableDefinitionOtherPrimaryKeyColumn(junctionTable);
-      QString const orderByBindName         = QString{":"} + *GetJunctionTableDefinitionOrderByColumn(junctionTable);
-      queryStringAsStream << ") VALUES (" << thisPrimaryKeyBindName << ", " << otherPrimaryKeyBindName;
+      queryStringAsStream <<
+         ") VALUES (:" << GetJunctionTableDefinitionThisPrimaryKeyColumn(junctionTable) <<
+         ", :" << GetJunctionTableDefinitionOtherPrimaryKeyColumn(junctionTable);
       if (!GetJunctionTableDefinitionOrderByColumn(junctionTable).isNull()) {
-         queryStringAsStream << ", " << orderByBindName;
+         queryStringAsStream << ", :" << GetJunctionTableDefinitionOrderByColumn(junctionTable);
       }
       queryStringAsStream << ");";
-      qDebug() << Q_FUNC_INFO << "Using query string" << queryString;
-
-      //
-      // Note that, when we are using bind values, we do NOT want to call the
-      // BtSqlQuery::BtSqlQuery(const QString &, QSqlDatabase db) version of the BtSqlQuery constructor because that
-      // would result in the supplied query being executed immediately (ie before we've had a chance to bind
-      // parameters).
-      //
-      BtSqlQuery sqlQuery{connection};
-      sqlQuery.prepare(queryString);
+      return queryString;
+   }
 
-      // Get the list of data to bind to it
+   /**
+    * \brief Read the values of an object property that is stored in a junction table
+    *
+    * \param junctionTable
+    * \param object
+    * \param primaryKey  Only used for logging
+    * \param propertyValues  OUT - the values to write to the junction table (which can be empty)
+    *
+    * \return \c true if succeeded, \c false otherwise
+    */
+   bool readJunctionTablePropertyValues(ObjectStore::JunctionTableDefinition const & junctionTable,
+                                        QObject const & object,
+                                        int const primaryKey,
+                                        QVector<int> & propertyValues) {
       QVariant propertyValuesWrapper = object.property(*GetJunctionTableDefinitionPropertyName(junctionTable));
       if (!propertyValuesWrapper.isValid()) {
          // It's a programming error if we couldn't read a property value
-         qCritical() <<
+         qCCritical(Logging::database) <<
             Q_FUNC_INFO << "Unable to read" << object.metaObject()->className() << "property" <<
             GetJunctionTableDefinitionPropertyName(junctionTable);
          Q_ASSERT(false); // Stop here on debug builds
@@ -384,13 +485,14 @@ namespace {
       }
 
       // We now need to extract the property values from their QVariant wrapper
-      QVector<int> propertyValues;
+      propertyValues.clear();
       if (junctionTable.assumedNumEntries == ObjectStore::MAX_ONE_ENTRY) {
          // If it's single entry only, just turn it into a one-item list so that the remaining processing is the same
          bool succeeded = false;
          int theValue = propertyValuesWrapper.toInt(&succeeded);
          if (!succeeded) {
-            qCritical() << Q_FUNC_INFO << "Can't convert QVariant of" << propertyValuesWrapper.typeName() << "to int";
+            qCCritical(Logging::database) <<
+               Q_FUNC_INFO << "Can't convert QVariant of" << propertyValuesWrapper.typeName() << "to int";
             Q_ASSERT(false); // Stop here on debug builds
             return false;    // Continue but bail out of the current DB transaction on other builds
          }
@@ -398,9 +500,9 @@ namespace {
          // If the foreign key returned is not valid, it's not an error, it just means there is no associated object,
          // eg this Hop does not have a parent.
          if (theValue <= 0) {
-            qDebug() <<
+            qCDebug(Logging::database) <<
                Q_FUNC_INFO << "Property" << GetJunctionTableDefinitionPropertyName(junctionTable) << "of" <<
-               object.metaObject()->className() << "#" << primaryKey.toInt() << "is" << theValue <<
+               object.metaObject()->className() << "#" << primaryKey << "is" << theValue <<
                "which we assume means \"unset\", so nothing to write to junction table" <<
                junctionTable.tableName;
             return true;
@@ -417,7 +519,7 @@ namespace {
          // structure then toList() will just return an empty list.
          //
          if (!propertyValuesWrapper.canConvert< QVector<int> >()) {
-            qCritical() <<
+            qCCritical(Logging::database) <<
                Q_FUNC_INFO << "Can't convert QVariant of" << propertyValuesWrapper.typeName() << "to QVector<int>";
             Q_ASSERT(false); // Stop here on debug builds
             return false;    // Continue but bail out of the current DB transaction on other builds
@@ -425,25 +527,90 @@ namespace {
          propertyValues = propertyValuesWrapper.value< QVector<int> >();
       }
 
-      // Now loop through and bind/run the insert query once for each item in the list
-      int itemNumber = 1;
-      qDebug() <<
+      qCDebug(Logging::database) <<
          Q_FUNC_INFO << propertyValues.size() << "value(s) (in" << propertyValuesWrapper.typeName() <<
          ") for property" << GetJunctionTableDefinitionPropertyName(junctionTable) << "of" <<
-         object.metaObject()->className() << "#" << primaryKey.toInt();
+         object.metaObject()->className() << "#" << primaryKey;
+      return true;
+   }
+
+   /**
+    * \brief Insert data from an object property to a junction table
+    *
+    * \param junctionTable
+    * \param object
+    * \param primaryKey  Note that this must be supplied separately as, for a new object, we may not (yet) have set its
+    *                    primary key (ie we cannot just read primary key from object)
+    * \param connection
+    *
+    * \return \c true if succeeded, \c false otherwise
+    */
+   bool insertIntoJunctionTableDefinition(ObjectStore::JunctionTableDefinition const & junctionTable,
+                                          QObject const & object,
+                                          QVariant const & primaryKey,
+                                          QSqlDatabase & connection) {
+      qCDebug(Logging::database) <<
+         Q_FUNC_INFO << "Writing" << object.metaObject()->className() << "property" <<
+         GetJunctionTableDefinitionPropertyName(junctionTable) << " into junction table " <<
+         junctionTable.tableName;
+
+      //
+      // It's a coding error if the caller has supplied us anything other than an int inside the primaryKey QVariant.
+      //
+      // Here and elsewhere, although we could just do a Q_ASSERT, we prefer (a) some extra diagnostics on debug builds
+      // and (b) to bail out immediately of the DB transaction on non-debug builds.
+      //
+      if (QVariant::Type::Int != primaryKey.type()) {
+         qCCritical(Logging::database) <<
+            Q_FUNC_INFO << "Unexpected contents of primaryKey QVariant: " << primaryKey.typeName();
+         Q_ASSERT(false); // Stop here on debug builds
+         return false;    // Continue but bail out of the current DB transaction on other builds
+      }
+
+      //
+      // Construct the query
+      //
+      // We may be inserting more than one row.  We could combine all the rows into a single insert statement using
+      // BtSqlQuery::execBatch(), as insertIntoJunctionTableBatch() does.  But there's likely no noticeable performance
+      // benefit given that, for a single object, we're typically inserting only a handful of rows at a time (eg all
+      // the Hops in a Recipe).  So instead, we just do individual inserts.
+      //
+      QString const queryString = junctionTableInsertSql(junctionTable);
+      QString const thisPrimaryKeyBindName  = QString{":"} + *GetJunctionTableDefinitionThisPrimaryKeyColumn(junctionTable);
+      QString const otherPrimaryKeyBindName = QString{":"} + *GetJunctionTableDefinitionOtherPrimaryKeyColumn(junctionTable);
+      QString const orderByBindName         = QString{":"} + *GetJunctionTableDefinitionOrderByColumn(junctionTable);
+      qCDebug(Logging::database) << Q_FUNC_INFO << "Using query string" << queryString;
+
+      //
+      // Note that, when we are using bind values, we do NOT want to call the
+      // BtSqlQuery::BtSqlQuery(const QString &, QSqlDatabase db) version of the BtSqlQuery constructor because that
+      // would result in the supplied query being executed immediately (ie before we've had a chance to bind
+      // parameters).
+      //
+      BtSqlQuery sqlQuery{connection};
+      sqlQuery.prepare(queryString);
+
+      // Get the list of data to bind to it
+      QVector<int> propertyValues;
+      if (!readJunctionTablePropertyValues(junctionTable, object, primaryKey.toInt(), propertyValues)) {
+         return false;
+      }
+
+      // Now loop through and bind/run the insert query once for each item in the list
+      int itemNumber = 1;
       for (int curValue : propertyValues) {
          sqlQuery.bindValue(thisPrimaryKeyBindName, primaryKey);
          sqlQuery.bindValue(otherPrimaryKeyBindName, curValue);
          if (!GetJunctionTableDefinitionOrderByColumn(junctionTable).isNull()) {
             sqlQuery.bindValue(orderByBindName, itemNumber);
          }
-         qDebug() <<
+         qCDebug(Logging::database) <<
             Q_FUNC_INFO <<
             GetJunctionTableDefinitionThisPrimaryKeyColumn(junctionTable) << " #" << primaryKey.toInt() << ":" <<
             GetJunctionTableDefinitionOtherPrimaryKeyColumn(junctionTable) << "N°" << itemNumber << " is #" << curValue;
 
          if (!sqlQuery.exec()) {
-            qCritical() <<
+            qCCritical(Logging::database) <<
                Q_FUNC_INFO << "Error executing database query " << queryString << ": " << sqlQuery.lastError().text();
             return false;
          }
@@ -453,6 +620,66 @@ namespace {
       return true;
    }
 
+   /**
+    * \brief Batch version of \c insertIntoJunctionTableDefinition for when we are inserting lots of objects at once.
+    *        All the rows for all the objects are written with a single prepared statement and one call to
+    *        \c BtSqlQuery::execBatch().  (For drivers that don't natively support batch operations, Qt emulates it by
+    *        re-executing the prepared statement for each row, which still saves us preparing it each time.)
+    *
+    * \param junctionTable
+    * \param objectsAndKeys  Each object to write, along with its primary key
+    * \param connection
+    *
+    * \return \c true if succeeded, \c false otherwise
+    */
+   bool insertIntoJunctionTableBatch(ObjectStore::JunctionTableDefinition const & junctionTable,
+                                     QVector<std::pair<QObject const *, int> > const & objectsAndKeys,
+                                     QSqlDatabase & connection) {
+      bool const hasOrderBy = !GetJunctionTableDefinitionOrderByColumn(junctionTable).isNull();
+      QVariantList thisPrimaryKeys;
+      QVariantList otherPrimaryKeys;
+      QVariantList itemNumbers;
+      for (auto const & [object, primaryKey] : objectsAndKeys) {
+         QVector<int> propertyValues;
+         if (!readJunctionTablePropertyValues(junctionTable, *object, primaryKey, propertyValues)) {
+            return false;
+         }
+         int itemNumber = 1;
+         for (int curValue : propertyValues) {
+            thisPrimaryKeys.append(primaryKey);
+            otherPrimaryKeys.append(curValue);
+            itemNumbers.append(itemNumber);
+            ++itemNumber;
+         }
+      }
+
+      if (thisPrimaryKeys.isEmpty()) {
+         // Nothing to write is not an error
+         return true;
+      }
+
+      QString const queryString = junctionTableInsertSql(junctionTable);
+      qCDebug(Logging::database) <<
+         Q_FUNC_INFO << "Writing" << thisPrimaryKeys.size() << "rows using query string" << queryString;
+
+      BtSqlQuery sqlQuery{connection};
+      sqlQuery.prepare(queryString);
+      sqlQuery.bindValue(QString{":"} + *GetJunctionTableDefinitionThisPrimaryKeyColumn(junctionTable),
+                         thisPrimaryKeys);
+      sqlQuery.bindValue(QString{":"} + *GetJunctionTableDefinitionOtherPrimaryKeyColumn(junctionTable),
+                         otherPrimaryKeys);
+      if (hasOrderBy) {
+         sqlQuery.bindValue(QString{":"} + *GetJunctionTableDefinitionOrderByColumn(junctionTable), itemNumbers);
+      }
+      if (!sqlQuery.execBatch()) {
+         qCCritical(Logging::database) <<
+            Q_FUNC_INFO << "Error executing database query " << queryString << ": " << sqlQuery.lastError().text();
+         return false;
+      }
+
+      return true;
+   }
+
    /**
     * \brief Delete rows relating to a particular object from a junction table
     *
@@ -466,7 +693,7 @@ namespace {
                                           QVariant const & primaryKey,
                                           QSqlDatabase & connection) {
 
-      qDebug() <<
+      qCDebug(Logging::database) <<
          Q_FUNC_INFO << "Deleting property " << GetJunctionTableDefinitionPropertyName(junctionTable) <<
          " in junction table " << junctionTable.tableName;
 
@@ -485,11 +712,11 @@ namespace {
 
       // Bind the primary key value
       sqlQuery.bindValue(thisPrimaryKeyBindName, primaryKey);
-      qDebug().noquote() << Q_FUNC_INFO << "Bind values:" << BoundValuesToString(sqlQuery);
+      qCDebug(Logging::database).noquote() << Q_FUNC_INFO << "Bind values:" << BoundValuesToString(sqlQuery);
 
       // Run the query
       if (!sqlQuery.exec()) {
-         qCritical() <<
+         qCCritical(Logging::database) <<
             Q_FUNC_INFO << "Error executing database query " << queryString << ": " << sqlQuery.lastError().text();
          return false;
       }
@@ -498,50 +725,236 @@ namespace {
    }
 
    /**
-    * \brief Force a QVariant to be a specific type.  Called from \c unwrapAndMapAsNeeded
+    * \brief Bring the rows in a junction table for one object into line with the current value of the corresponding
+    *        object property, by only changing what has changed.  Eg, adding a Hop to a Recipe, or swapping two
+    *        Instructions, touches one or two rows rather than rewriting all of them.
+    *
+    *        We read the existing rows, then match each value in the property to an existing row with the same "other"
+    *        key.  Rows that don't get matched are removed with one DELETE; values that don't get matched are added with
+    *        one multi-row INSERT; and, if there is an order-by column, matched rows in the wrong position are fixed
+    *        with one UPDATE.  (Each of these is split across several statements if there are more bind values than
+    *        the DB driver allows in one statement, but that would be a very long list.)
+    *
+    * \param junctionTable
+    * \param object
+    * \param primaryKey
+    * \param connection
+    *
+    * \return \c true if succeeded, \c false otherwise
     */
-   template<typename T>
-   void forceVariantToType(QVariant & propertyValue) {
-      if (propertyValue.isNull()) {
-         return;
+   bool updateJunctionTableRows(ObjectStore::JunctionTableDefinition const & junctionTable,
+                                QObject const & object,
+                                QVariant const & primaryKey,
+                                QSqlDatabase & connection) {
+      QVector<int> propertyValues;
+      if (!readJunctionTablePropertyValues(junctionTable, object, primaryKey.toInt(), propertyValues)) {
+         return false;
       }
-      propertyValue = QVariant::fromValue<T>(propertyValue.value<T>());
-      return;
-   }
 
-   /**
-    * \brief Used by \c wrapAndUnmapAsNeeded below.  Returns generally expected QVariant types for different types of
-    *        DB fields.
-    *
-    *        Unfortunately, there's not an exact 1-1 mapping between our internal types and DB types, so we have to
-    *        allow for a few possibilities here -- eg reading an integer out of the DB is likely to give you a QVariant
-    *        of type QMetaType::LongLong.  But the check is still valuable.
-    */
-   QVector<int> const getExpectedTypes(ObjectStore::FieldType const fieldType) {
-      switch (fieldType) {
-         case ObjectStore::FieldType::Bool  : { return {QMetaType::Bool   , QMetaType::LongLong}; }
-         case ObjectStore::FieldType::Int   : { return {QMetaType::Int    , QMetaType::LongLong}; }
-         case ObjectStore::FieldType::UInt  : { return {QMetaType::UInt   , QMetaType::LongLong}; }
-         case ObjectStore::FieldType::Double: { return {QMetaType::Double                      }; }
-         case ObjectStore::FieldType::String: { return {QMetaType::QString                     }; }
-         case ObjectStore::FieldType::Date  : { return {QMetaType::QDate  , QMetaType::QString }; }
-         case ObjectStore::FieldType::Enum  : { return {QMetaType::QString                     }; }
-         case ObjectStore::FieldType::Unit  : { return {QMetaType::QString                     }; }
-         // No default case needed as compiler should warn us if any options covered above
+      BtStringConst const & rowIdColumn = junctionTable.tableFields[0].columnName;
+      BtStringConst const & thisColumn  = GetJunctionTableDefinitionThisPrimaryKeyColumn(junctionTable);
+      BtStringConst const & otherColumn = GetJunctionTableDefinitionOtherPrimaryKeyColumn(junctionTable);
+      BtStringConst const & orderByColumn = GetJunctionTableDefinitionOrderByColumn(junctionTable);
+      bool const hasOrderBy = !orderByColumn.isNull();
+
+      //
+      // Read what's there now
+      //
+      QString queryString{"SELECT "};
+      QTextStream queryStringAsStream{&queryString};
+      queryStringAsStream << rowIdColumn << ", " << otherColumn;
+      if (hasOrderBy) {
+         queryStringAsStream << ", " << orderByColumn;
+      }
+      queryStringAsStream <<
+         " FROM " << junctionTable.tableName << " WHERE " << thisColumn << " = :" << thisColumn << ";";
+      BtSqlQuery sqlQuery{connection};
+      sqlQuery.prepare(queryString);
+      sqlQuery.bindValue(QString{":"} + *thisColumn, primaryKey);
+      if (!sqlQuery.exec()) {
+         qCCritical(Logging::database) <<
+            Q_FUNC_INFO << "Error executing database query " << queryString << ": " << sqlQuery.lastError().text();
+         return false;
+      }
+      // Other key -> row ID and order-by value of each existing row with that other key
+      QHash<int, QVector<std::pair<int, int>>> existingRows;
+      while (sqlQuery.next()) {
+         existingRows[sqlQuery.value(1).toInt()].append(
+            std::make_pair(sqlQuery.value(0).toInt(), hasOrderBy ? sqlQuery.value(2).toInt() : 0)
+         );
       }
-      // It's a coding error if we get here
-      Q_ASSERT(false);
-   }
 
-   using TableColumnAndType = std::tuple<QString, QString, ObjectStore::FieldType>;
-   /**
-    * \brief Used by \c wrapAndUnmapAsNeeded below.  Returns "known bad" types of certain DB columns.  In the long run,
-    *        we want to fix these!
-    *
-    *        There are some historical oddities in the DB schema that we have not yet fully smoothed away.  In
-    *        particular:
-    *          - Some booleans used to be stored as "true"/"false" strings in SQLite rather than 0/1 integers.  This
-    *            does work with \c QVariant::toBool(), which will treat "", "0" and "false" as \c false and all other
+      //
+      // Work out the differences.  As elsewhere, item numbers in the order-by column start from 1.
+      //
+      QVector<std::pair<int, int>> valuesToInsert;  // Other key and item number
+      QVector<std::pair<int, int>> rowsToRenumber;  // Row ID and new item number
+      for (int ii = 0; ii < propertyValues.size(); ++ii) {
+         int const itemNumber = ii + 1;
+         auto existing = existingRows.find(propertyValues[ii]);
+         if (existing == existingRows.end() || existing->isEmpty()) {
+            valuesToInsert.append(std::make_pair(propertyValues[ii], itemNumber));
+            continue;
+         }
+         auto const [rowId, existingItemNumber] = existing->takeFirst();
+         if (hasOrderBy && existingItemNumber != itemNumber) {
+            rowsToRenumber.append(std::make_pair(rowId, itemNumber));
+         }
+      }
+      QVector<int> rowsToDelete;
+      for (auto const & unmatchedRows : existingRows) {
+         for (auto const & [rowId, existingItemNumber] : unmatchedRows) {
+            rowsToDelete.append(rowId);
+         }
+      }
+
+      qCDebug(Logging::database) <<
+         Q_FUNC_INFO << object.metaObject()->className() << "#" << primaryKey.toInt() << "property" <<
+         GetJunctionTableDefinitionPropertyName(junctionTable) << ":" << rowsToDelete.size() << "deletes," <<
+         valuesToInsert.size() << "inserts," << rowsToRenumber.size() << "renumbers in" << junctionTable.tableName;
+
+      auto const execOrLog = [](BtSqlQuery & query, QString const & sql) {
+         if (!query.exec()) {
+            qCCritical(Logging::database) <<
+               Q_FUNC_INFO << "Error executing database query " << sql << ": " << query.lastError().text();
+            return false;
+         }
+         return true;
+      };
+
+      //
+      // Deletes first, so that nothing we renumber or insert clashes with a row that's going
+      //
+      for (int first = 0; first < rowsToDelete.size(); first += maxBindValuesPerStatement) {
+         int const numRows = std::min(maxBindValuesPerStatement, static_cast<int>(rowsToDelete.size()) - first);
+         QStringList placeholders;
+         for (int ii = 0; ii < numRows; ++ii) {
+            placeholders.append("?");
+         }
+         QString const deleteString = QString{"DELETE FROM %1 WHERE %2 IN (%3);"}.arg(*junctionTable.tableName)
+                                                                               .arg(*rowIdColumn)
+                                                                               .arg(placeholders.join(", "));
+         BtSqlQuery deleteQuery{connection};
+         deleteQuery.prepare(deleteString);
+         for (int ii = first; ii < first + numRows; ++ii) {
+            deleteQuery.addBindValue(rowsToDelete[ii]);
+         }
+         if (!execOrLog(deleteQuery, deleteString)) {
+            return false;
+         }
+      }
+
+      //
+      // Renumbering is done with a CASE expression, which needs three bind values per row (two for the CASE and one for
+      // the IN list).  The CAST is for PostgreSQL, which otherwise can't work out the type of the THEN values.
+      //
+      for (int first = 0; first < rowsToRenumber.size(); first += maxBindValuesPerStatement / 3) {
+         int const numRows = std::min(maxBindValuesPerStatement / 3, static_cast<int>(rowsToRenumber.size()) - first);
+         QString updateString;
+         QTextStream updateStringAsStream{&updateString};
+         updateStringAsStream << "UPDATE " << junctionTable.tableName << " SET " << orderByColumn << " = CASE " <<
+            rowIdColumn;
+         QStringList placeholders;
+         for (int ii = 0; ii < numRows; ++ii) {
+            updateStringAsStream << " WHEN ? THEN CAST(? AS INTEGER)";
+            placeholders.append("?");
+         }
+         updateStringAsStream << " END WHERE " << rowIdColumn << " IN (" << placeholders.join(", ") << ");";
+         BtSqlQuery updateQuery{connection};
+         updateQuery.prepare(updateString);
+         for (int ii = first; ii < first + numRows; ++ii) {
+            updateQuery.addBindValue(rowsToRenumber[ii].first);
+            updateQuery.addBindValue(rowsToRenumber[ii].second);
+         }
+         for (int ii = first; ii < first + numRows; ++ii) {
+            updateQuery.addBindValue(rowsToRenumber[ii].first);
+         }
+         if (!execOrLog(updateQuery, updateString)) {
+            return false;
+         }
+      }
+
+      int const numColumns = hasOrderBy ? 3 : 2;
+      int const rowsPerInsert = maxBindValuesPerStatement / numColumns;
+      for (int first = 0; first < valuesToInsert.size(); first += rowsPerInsert) {
+         int const numRows = std::min(rowsPerInsert, static_cast<int>(valuesToInsert.size()) - first);
+         QString insertString;
+         QTextStream insertStringAsStream{&insertString};
+         insertStringAsStream << "INSERT INTO " << junctionTable.tableName << " (" << thisColumn << ", " << otherColumn;
+         if (hasOrderBy) {
+            insertStringAsStream << ", " << orderByColumn;
+         }
+         insertStringAsStream << ") VALUES ";
+         for (int ii = 0; ii < numRows; ++ii) {
+            insertStringAsStream << (ii == 0 ? "" : ", ") << (hasOrderBy ? "(?, ?, ?)" : "(?, ?)");
+         }
+         insertStringAsStream << ";";
+         BtSqlQuery insertQuery{connection};
+         insertQuery.prepare(insertString);
+         for (int ii = first; ii < first + numRows; ++ii) {
+            insertQuery.addBindValue(primaryKey);
+            insertQuery.addBindValue(valuesToInsert[ii].first);
+            if (hasOrderBy) {
+               insertQuery.addBindValue(valuesToInsert[ii].second);
+            }
+         }
+         if (!execOrLog(insertQuery, insertString)) {
+            return false;
+         }
+      }
+
+      return true;
+   }
+
+   /**
+    * \brief Force a QVariant to be a specific type.  Called from \c unwrapAndMapAsNeeded
+    */
+   template<typename T>
+   void forceVariantToType(QVariant & propertyValue) {
+      // If the value is already of the right type (which it usually is), there is nothing to do
+      if (propertyValue.isNull() || propertyValue.userType() == qMetaTypeId<T>()) {
+         return;
+      }
+      propertyValue = QVariant::fromValue<T>(propertyValue.value<T>());
+      return;
+   }
+
+   /**
+    * \brief Used by \c wrapAndUnmapAsNeeded below.  Returns generally expected QVariant types for different types of
+    *        DB fields.
+    *
+    *        Unfortunately, there's not an exact 1-1 mapping between our internal types and DB types, so we have to
+    *        allow for a few possibilities here -- eg reading an integer out of the DB is likely to give you a QVariant
+    *        of type QMetaType::LongLong.  But the check is still valuable.
+    */
+   QVector<int> const getExpectedTypes(ObjectStore::TableField const & fieldDefn) {
+      if (fieldDefn.isStoredAsCode()) {
+         return {QMetaType::Int, QMetaType::LongLong};
+      }
+      switch (fieldDefn.fieldType) {
+         case ObjectStore::FieldType::Bool  : { return {QMetaType::Bool   , QMetaType::LongLong}; }
+         case ObjectStore::FieldType::Int   : { return {QMetaType::Int    , QMetaType::LongLong}; }
+         case ObjectStore::FieldType::UInt  : { return {QMetaType::UInt   , QMetaType::LongLong}; }
+         case ObjectStore::FieldType::Double: { return {QMetaType::Double                      }; }
+         case ObjectStore::FieldType::String: { return {QMetaType::QString                     }; }
+         case ObjectStore::FieldType::Date  : { return {QMetaType::QDate  , QMetaType::QString }; }
+         case ObjectStore::FieldType::Enum  : { return {QMetaType::QString                     }; }
+         case ObjectStore::FieldType::Unit  : { return {QMetaType::QString                     }; }
+         // No default case needed as compiler should warn us if any options covered above
+      }
+      // It's a coding error if we get here
+      Q_ASSERT(false);
+   }
+
+   using TableColumnAndType = std::tuple<QString, QString, ObjectStore::FieldType>;
+   /**
+    * \brief Used by \c wrapAndUnmapAsNeeded below.  Returns "known bad" types of certain DB columns.  In the long run,
+    *        we want to fix these!
+    *
+    *        There are some historical oddities in the DB schema that we have not yet fully smoothed away.  In
+    *        particular:
+    *          - Some booleans used to be stored as "true"/"false" strings in SQLite rather than 0/1 integers.  This
+    *            does work with \c QVariant::toBool(), which will treat "", "0" and "false" as \c false and all other
     *            values as \c true, but in the longer run we'd prefer to use the DB's native bool value (0 and 1 in the
     *            case of SQLite).
     *          - Some integer foreign key columns were created without a type in SQLite, which means they get treated as
@@ -564,25 +977,187 @@ namespace {
       {{"yeast",       "inventory_id"    , ObjectStore::FieldType::Int }, {QMetaType::Double }},
    };
 
+   //
+   // Prepared UPDATE statements for individual columns, for reuse by ObjectStore::impl::updatePropertyInDb.  Because
+   // each thread has its own DB connection (see Database::sqlDatabase()), keying on connection name means a given query
+   // object is only ever used from the thread that created it.  The mutex is just to protect the hash itself.
+   //
+   using PreparedUpdateKey = QPair<QString, ObjectStore::TableField const *>;
+   QMutex preparedUpdateQueriesMutex;
+   QHash<PreparedUpdateKey, std::shared_ptr<BtSqlQuery>> preparedUpdateQueries;
+
+   /**
+    * \brief Get a prepared query, of the form
+    *
+    *           UPDATE tablename SET columnName = ? WHERE primaryKeyColumn = ?;
+    *
+    *        for updating the supplied field of the supplied table on the supplied connection.  This is created the
+    *        first time it is asked for and then reused.
+    */
+   std::shared_ptr<BtSqlQuery> getPreparedUpdateQuery(QSqlDatabase & connection,
+                                                      ObjectStore::TableDefinition const & tableDefinition,
+                                                      ObjectStore::TableField const & fieldDefn) {
+      PreparedUpdateKey const key{connection.connectionName(), &fieldDefn};
+      QMutexLocker locker(&preparedUpdateQueriesMutex);
+      auto cachedQuery = preparedUpdateQueries.find(key);
+      if (cachedQuery != preparedUpdateQueries.end()) {
+         return cachedQuery.value();
+      }
+
+      QString queryString{"UPDATE "};
+      QTextStream queryStringAsStream{&queryString};
+      queryStringAsStream <<
+         tableDefinition.tableName << " SET " << fieldDefn.columnName << " = ? WHERE " <<
+         tableDefinition.tableFields[0].columnName << " = ?;";
+      qCDebug(Logging::database) <<
+         Q_FUNC_INFO << "Preparing" << queryString << "for reuse on DB connection" << connection.connectionName();
+
+      auto sqlQuery = std::make_shared<BtSqlQuery>(connection);
+      sqlQuery->prepare(queryString);
+      preparedUpdateQueries.insert(key, sqlQuery);
+      return sqlQuery;
+   }
+
+   /**
+    * \brief Write a single column of a single row of the supplied (primary) table.  This is the most frequently called
+    *        bit of the object store (eg every time the user edits a field in the UI), so we reuse prepared queries --
+    *        see \c getPreparedUpdateQuery.  The change is also recorded in the \c ChangeLog.
+    *
+    *        NB: Caller is responsible for handling transactions
+    *
+    * \return \c true if succeeded, \c false otherwise
+    */
+   bool updateColumnInDb(QSqlDatabase & connection,
+                         ObjectStore::TableDefinition const & tableDefinition,
+                         ObjectStore::TableField const & fieldDefn,
+                         QVariant const & primaryKey,
+                         QVariant const & value) {
+      std::shared_ptr<BtSqlQuery> sqlQuery = getPreparedUpdateQuery(connection, tableDefinition, fieldDefn);
+
+      // The query has exactly two placeholders: the column to update and then the primary key
+      sqlQuery->bindValue(0, value);
+      sqlQuery->bindValue(1, primaryKey);
+
+      bool const succeeded = sqlQuery->exec();
+      if (!succeeded) {
+         qCCritical(Logging::database) <<
+            Q_FUNC_INFO << "Error executing database query " << sqlQuery->lastQuery() << ": " <<
+            sqlQuery->lastError().text();
+      }
+      // Tell the driver we've finished with the results (if any) so the statement is ready for reuse
+      sqlQuery->finish();
+      return succeeded && ChangeLog::recordChange(connection, *tableDefinition.tableName, primaryKey.toInt());
+   }
+
+   //
+   // Write-behind queue for property updates -- see ObjectStore::updateProperty() and
+   // ObjectStore::flushPendingPropertyUpdates().  Because we only write the latest value for a given column of a given
+   // row, several quick edits to the same property (which are common when the user is typing in a field) result in a
+   // single DB write.
+   //
+   struct QueuedColumnUpdate {
+      ObjectStore::TableDefinition const * tableDefinition;
+      ObjectStore::TableField      const * fieldDefn;
+      QVariant primaryKey;
+      QVariant value;
+   };
+   using QueuedColumnUpdateKey = QPair<ObjectStore::TableField const *, int>;
+   QMutex queuedColumnUpdatesMutex;
+   QHash<Database *, QHash<QueuedColumnUpdateKey, QueuedColumnUpdate>> queuedColumnUpdates;
+   bool flushOfQueuedColumnUpdatesScheduled = false;
+
+   /**
+    * \return \c true if property updates should be queued rather than written immediately.  We don't queue updates
+    *         made from threads other than the main one because the flush timer runs on the main thread.
+    *
+    *         NB: The setting is only read once, so a change to it takes effect the next time the program is started.
+    */
+   bool useWriteBehindForPropertyUpdates() {
+      static bool const enabled =
+         PersistentSettings::value(PersistentSettings::Names::writeBehindPropertyUpdates, false).toBool();
+      if (!enabled) {
+         return false;
+      }
+      QCoreApplication const * const application = QCoreApplication::instance();
+      return application && QThread::currentThread() == application->thread();
+   }
+
+   /**
+    * \brief Add an update to the write-behind queue, replacing any not-yet-written update to the same column of the
+    *        same row, and make sure a flush is scheduled.
+    */
+   void queueColumnUpdate(Database & database, QueuedColumnUpdate const & update) {
+      static int const flushIntervalMs =
+         PersistentSettings::value(PersistentSettings::Names::writeBehindFlushIntervalMs, 250).toInt();
+
+      QMutexLocker locker(&queuedColumnUpdatesMutex);
+      queuedColumnUpdates[&database].insert(QueuedColumnUpdateKey{update.fieldDefn, update.primaryKey.toInt()},
+                                            update);
+      if (!flushOfQueuedColumnUpdatesScheduled) {
+         flushOfQueuedColumnUpdatesScheduled = true;
+         // Using the application as context object ensures the flush runs on the main thread
+         QTimer::singleShot(flushIntervalMs,
+                            QCoreApplication::instance(),
+                            []() { ObjectStore::flushPendingPropertyUpdates(); });
+      }
+      return;
+   }
+
+   /**
+    * \brief The thread on which we do the DB work for ObjectStore::insertAsync() etc.  There is only one such thread,
+    *        so operations are done in the order they were requested, and the thread is kept alive (rather than
+    *        expiring when idle) so that we keep reusing the same DB connection (see Database::sqlDatabase()).
+    */
+   QThreadPool & dbWorkerThreadPool() {
+      static QThreadPool threadPool;
+      static std::once_flag initFlag;
+      std::call_once(initFlag, []() {
+         threadPool.setMaxThreadCount(1);
+         threadPool.setExpiryTimeout(-1);
+      });
+      return threadPool;
+   }
+
 }
 
 ObjectStore::TableField::TableField(ObjectStore::FieldType                 const   fieldType,
                                     char const *                           const   columnName,
                                     BtStringConst                          const & propertyName,
-                                    ObjectStore::TableField::ValueDecoder  const   valueDecoder) :
+                                    ObjectStore::TableField::ValueDecoder  const   valueDecoder,
+                                    ObjectStore::Indexing                  const   indexing,
+                                    ObjectStore::Loading                   const   loading,
+                                    ObjectStore::Storage                   const   storage) :
    fieldType{fieldType},
    columnName{columnName},
    propertyName{propertyName},
-   valueDecoder{valueDecoder} {
+   valueDecoder{valueDecoder},
+   indexing{indexing},
+   loading{loading},
+   storage{storage} {
+   // Lazy loading is only implemented for text
+   Q_ASSERT(loading == ObjectStore::LOAD_EAGERLY || fieldType == ObjectStore::FieldType::String);
 
 
    return;
 }
 
+bool ObjectStore::TableField::isStoredAsCode() const {
+   return this->storage == ObjectStore::STORED_AS_CODE &&
+          (this->fieldType == ObjectStore::FieldType::Enum || this->fieldType == ObjectStore::FieldType::Unit);
+}
+
 ObjectStore::TableDefinition::TableDefinition(char const * const tableName,
                                               std::initializer_list<TableField> const tableFields) :
          tableName{tableName},
-         tableFields{tableFields} {
+         tableFields{tableFields},
+         fieldIndexByPropertyName{} {
+
+   for (int ii = 0; ii < this->tableFields.size(); ++ii) {
+      BtStringConst const & propertyName = this->tableFields[ii].propertyName;
+      if (!propertyName.isNull()) {
+         this->fieldIndexByPropertyName.emplace(*propertyName, ii);
+      }
+   }
 
    //
    // Uncomment the following if trying to debug issues with foreign keys.
@@ -610,10 +1185,129 @@ ObjectStore::TableDefinition::TableDefinition(char const * const tableName,
    return;
 }
 
+ObjectStore::TableField const * ObjectStore::TableDefinition::fieldForProperty(
+   BtStringConst const & propertyName
+) const {
+   if (propertyName.isNull()) {
+      return nullptr;
+   }
+   auto const match = this->fieldIndexByPropertyName.find(*propertyName);
+   if (match == this->fieldIndexByPropertyName.end()) {
+      return nullptr;
+   }
+   return &this->tableFields[match->second];
+}
+
+namespace {
+   //
+   // State for ObjectStoreSignalBatch.  This is only ever accessed on the GUI thread, so there is no need for locking.
+   //
+   int signalBatchDepth = 0;
+
+   //! Stores with queued signals, in the order they first queued one
+   QVector<ObjectStore *> storesWithQueuedSignals;
+
+   bool onGuiThread() {
+      QCoreApplication const * application = QCoreApplication::instance();
+      return application && QThread::currentThread() == application->thread();
+   }
+}
+
+struct ObjectStore::Snapshot::Data {
+   ObjectStore const * store = nullptr;
+   unsigned int version = 0;
+   //! Property name -> index of its value in each of \c rowsById.  The same for every snapshot of a given store.
+   QHash<QString, int> columnByPropertyName;
+   QHash<int, QVector<QVariant> > rowsById;
+};
+
 // This private implementation class holds all private non-virtual members of ObjectStore
 class ObjectStore::impl {
 public:
 
+   /**
+    * \brief In-memory secondary index on one \c INDEXED field of the primary table or a junction table.  This allows
+    *        us to find, say, all the \c RecipeAdditionHop objects for a given \c Recipe without looking at every
+    *        \c RecipeAdditionHop in the store.
+    */
+   struct PropertyIndex {
+      //! The field we are indexing.  (Points into \c primaryTable or \c junctionTables, which live for the duration of
+      //  the program.)
+      TableField const * fieldDefn;
+      //! Index in \c junctionTables of the table holding the field, or -1 if it is in \c primaryTable
+      int junctionTableIndex;
+      //! Property value -> IDs of all cached objects having that value
+      QHash<int, QSet<int> > idsByValue;
+      //! ID of cached object -> the property value it is currently indexed under.  We need this because, by the time
+      //  we are told a property has changed, the object no longer knows its old value.
+      QHash<int, int> valueById;
+      //! Property value -> \c idsByValue for that value, in the order \c ObjectStore::idsByIndex returns them.  Only
+      //  built on demand and dropped whenever the set of IDs, or the sort key of one of them, changes.
+      mutable QHash<int, QVector<int> > orderedIdsByValue;
+   };
+
+   /**
+    * \brief In-memory index on \c NamedEntity::fingerprint, used to find candidate duplicates (eg when importing from
+    *        BeerXML or BeerJSON) without comparing against every object in the store.
+    */
+   struct FingerprintIndex {
+      //! Fingerprint -> IDs of all cached objects having that fingerprint
+      QHash<std::size_t, QSet<int> > idsByFingerprint;
+      //! ID of cached object -> the fingerprint it is currently indexed under.  We need this for the same reason as
+      //  \c PropertyIndex::valueById.
+      QHash<int, std::size_t> fingerprintById;
+   };
+
+   /**
+    * \brief In-memory index on \c NamedEntity::name, used to resolve name clashes (eg when importing from BeerXML or
+    *        BeerJSON) in one lookup.
+    */
+   struct NameIndex {
+      //! Name -> number of cached objects with exactly that name
+      QHash<QString, int> countByName;
+      //! Base name (see \c NamedEntity::splitDuplicateNameNumber) -> " (n)" number -> number of cached objects
+      //  having that base name and number.  We only need the highest number, but we need the others so we know what
+      //  the highest one is after an object is removed or renamed.
+      QHash<QString, QMap<int, int> > countByNumberByBaseName;
+      //! ID of cached object -> the name it is currently indexed under
+      QHash<int, QString> nameById;
+   };
+
+   /**
+    * \brief Everything \c loadAll needs from the DB, read by \c readAllRows.  This is plain data (no \c QObject), so it
+    *        can safely be built on one thread and consumed on another.
+    */
+   /**
+    * \brief In lazy loading mode, what we hold for an object that has been read from the DB but not yet created
+    */
+   struct PendingObject {
+      NamedParameterBundle namedParameterBundle;
+      //! Index in \c junctionTables and values to set, for each junction table that has data for this object
+      QVector<std::pair<int, QVector<int> > > junctionValues;
+   };
+
+   /**
+    * \brief How to decode one column of the primary table when reading rows in \c readAllRows.  None of this depends
+    *        on the row, so we work it out once per store (see \c getRowDecoder) rather than once per value read.
+    */
+   struct ColumnDecoder {
+      //! The field for this column.  (Points into \c primaryTable, which lives for the duration of the program.)
+      TableField const * fieldDefn;
+      //! The types of \c QVariant we expect the DB driver to give us for this column (see \c getExpectedTypes)
+      QVector<int> expectedTypes;
+      //! Whether the property is \c std::optional, which determines the conversion done by \c wrapAndUnmapAsNeeded
+      bool isOptional;
+      //! For a field that is \c ObjectStore::STORED_AS_CODE, the codes of its column.  Otherwise \c nullptr.
+      EnumCodes::Codec const * codec;
+   };
+
+   struct LoadedRows {
+      //! Primary key and constructor parameters for each row of the primary table
+      QVector<std::pair<int, NamedParameterBundle> > primaryRows;
+      //! One entry per element of \c junctionTables: ID of "this" object -> ordered IDs of "other" objects
+      QVector<QMap<int, QVector<int> > > junctionRows;
+   };
+
    /**
     * Constructor
     */
@@ -626,7 +1320,28 @@ public:
                                                            primaryTable{primaryTable},
                                                            junctionTables{junctionTables},
                                                            allObjects{},
-                                                           database{nullptr} {
+                                                           propertyIndexes{},
+                                                           sortKeyField{nullptr},
+                                                           sortKeyById{},
+                                                           fingerprintIndex{},
+                                                           nameIndex{},
+                                                           pendingObjects{},
+                                                           prefetchedRows{},
+                                                           rowDecoderOnce{},
+                                                           rowDecoder{},
+                                                           propertyReadersOnce{},
+                                                           propertyReadersClass{nullptr},
+                                                           propertyReaders{},
+                                                           applyingChangesFromDb{false},
+                                                           database{nullptr},
+                                                           queuedInsertions{},
+                                                           queuedDeletions{},
+                                                           contentVersion{0},
+                                                           latestSnapshot{},
+                                                           idsChangedSinceSnapshot{},
+                                                           lazyTextCache{lazyTextCacheMaxChars},
+                                                           lazyTextCacheMutex{} {
+      this->setUpIndexes();
       return;
    }
 
@@ -662,7 +1377,7 @@ public:
       // It's a coding error if we don't have an enum mapping for an enum field
       if (ObjectStore::FieldType::Enum == fieldDefn.fieldType &&
          !std::holds_alternative<EnumStringMapping const *>(fieldDefn.valueDecoder)) {
-         qCritical() <<
+         qCCritical(Logging::database) <<
             Q_FUNC_INFO << "Coding Error!  No enum mapping found to map property " << fieldDefn.propertyName <<
             " to column " << fieldDefn.columnName << "for" << primaryTable.tableName;
          Q_ASSERT(false);
@@ -671,12 +1386,15 @@ public:
       // Similarly, it's a coding error if we don't have a unit name mapping for a unit field
       if (ObjectStore::FieldType::Unit == fieldDefn.fieldType &&
          !std::holds_alternative<Measurement::UnitStringMapping const *>(fieldDefn.valueDecoder)) {
-         qCritical() <<
+         qCCritical(Logging::database) <<
             Q_FUNC_INFO << "Coding Error!  No unit name mapping found to map property " << fieldDefn.propertyName <<
             " to column " << fieldDefn.columnName << "for" << primaryTable.tableName;
          Q_ASSERT(false);
       }
 
+      // For a field stored as a code, we don't need the string mapping at all
+      EnumCodes::Codec const * const codec = this->getCodec(fieldDefn);
+
       if (this->typeLookup.getType(fieldDefn.propertyName).isOptional()) {
          //
          // This is an optional field, so we are converting a QVariant holding std::optional<T> to a QVariant holding
@@ -697,7 +1415,8 @@ public:
                auto const enumMapping = std::get<EnumStringMapping const *>(fieldDefn.valueDecoder);
                auto val = propertyValue.value<std::optional<int> >();
                if (val.has_value()) {
-                  propertyValue = QVariant(enumMapping->enumToString(val.value()));
+                  propertyValue = codec ? valueToCode(primaryTable, fieldDefn, *codec, val.value()) :
+                                          QVariant(enumMapping->enumToString(val.value()));
                   return;
                }
                propertyValue = QVariant();
@@ -745,12 +1464,21 @@ public:
          case ObjectStore::FieldType::String: { forceVariantToType<QString     >(propertyValue); return; }
          case ObjectStore::FieldType::Date:   { forceVariantToType<QDate       >(propertyValue); return; }
          case ObjectStore::FieldType::Enum:   {
-            // This is a non-optional enum, so we need to map it to a QString
+            // This is a non-optional enum, so we need to map it to its code or a QString
+            if (codec) {
+               propertyValue = valueToCode(primaryTable, fieldDefn, *codec, propertyValue.toInt());
+               return;
+            }
             auto const enumMapping = std::get<EnumStringMapping const *>(fieldDefn.valueDecoder);
             propertyValue = QVariant(enumMapping->enumToString(propertyValue.toInt()));
             return;
          }
          case ObjectStore::FieldType::Unit:   {
+            if (codec) {
+               propertyValue =
+                  valueToCode(primaryTable, fieldDefn, *codec, propertyValue.value<Measurement::Unit const *>());
+               return;
+            }
             auto const unitMapping = std::get<Measurement::UnitStringMapping const *>(fieldDefn.valueDecoder);
 
             propertyValue =
@@ -771,19 +1499,20 @@ public:
     *
     * \param primaryTable This is used only for logging errors (in case there is bad data in the DB, which could happen
     *                     if the DB has been manually edited or partially restored from an old verison etc.
-    * \param fieldDefn
+    * \param columnDecoder The field and its precomputed type information (see \c getRowDecoder)
     * \param valueFromDb the QVariant that we may need to modify
     */
    void wrapAndUnmapAsNeeded(ObjectStore::TableDefinition const & primaryTable,
-                             ObjectStore::TableField const & fieldDefn,
+                             ColumnDecoder const & columnDecoder,
                              QVariant & propertyValue) {
+      ObjectStore::TableField const & fieldDefn = *columnDecoder.fieldDefn;
       //
       // If it is not null (when the type info is not meaningful), we would like to check that the QVariant we've
       // received back from the QSqlQuery object is a sane type.  If it isn't then it could indicate either a past or
       // current coding error, or some manual edit of the DB.  Either way we at least want to log a warning.
       //
       if (!propertyValue.isNull()) {
-         auto expectedTypes = getExpectedTypes(fieldDefn.fieldType);
+         auto const & expectedTypes = columnDecoder.expectedTypes;
 
          // NB: In Qt 6, QVariant::type() becomes QVariant::typeId()
 #if QT_VERSION < QT_VERSION_CHECK(6,0,0)
@@ -832,7 +1561,7 @@ public:
                   propertyValue = QVariant(propertyValue.toDouble(&recovered));
                }
                if (recovered) {
-                  qWarning() <<
+                  qCWarning(Logging::database) <<
                      Q_FUNC_INFO << "Recovered from unexpected type #" << propertyType << "=" <<
                      readPropertyValue.typeName() << "in QVariant for property" << fieldDefn.propertyName <<
                      ", field type" << fieldDefn.fieldType << ", value" << readPropertyValue << ", table" <<
@@ -846,7 +1575,7 @@ public:
                   // from a user point of view that the software carries on working even if some (hopefully) obscure
                   // field could not be read from the DB.
                   //
-                  qCritical() <<
+                  qCCritical(Logging::database) <<
                      Q_FUNC_INFO << "Unexpected type #" << propertyType << "=" << propertyValue.typeName() <<
                      "in QVariant for property" << fieldDefn.propertyName << ", field type" << fieldDefn.fieldType <<
                      ", value" << propertyValue << ", table" << primaryTable.tableName << ", column" <<
@@ -861,7 +1590,7 @@ public:
          }
       }
 
-      if (this->typeLookup.getType(fieldDefn.propertyName).isOptional()) {
+      if (columnDecoder.isOptional) {
          //
          // This is an optional field, so we are converting from a QVariant holding either T or null to a QVariant
          // holding std::optional<T>, with relevant special case handling for when T is actually an enum (where we need
@@ -881,9 +1610,11 @@ public:
                if (propertyValue.isNull()) {
                   propertyValue = QVariant::fromValue(std::optional<int>());
                } else {
-                  propertyValue = QVariant::fromValue(
-                     std::optional<int>(stringToEnum(primaryTable, fieldDefn, propertyValue.toString()))
-                  );
+                  propertyValue = QVariant::fromValue(std::optional<int>(
+                     columnDecoder.codec ?
+                        codeToEnum(primaryTable, fieldDefn, *columnDecoder.codec, propertyValue.toInt()) :
+                        stringToEnum(primaryTable, fieldDefn, propertyValue.toString())
+                  ));
                }
                return;
             }
@@ -921,7 +1652,7 @@ public:
             // This is a non-optional enum, so we need to map from a QString to an int
             if (propertyValue.isNull()) {
                // This is either a coding error or someone messed with the DB data.
-               qCritical() <<
+               qCCritical(Logging::database) <<
                   Q_FUNC_INFO << "Found null value for non-optional enum when mapping column " <<
                   fieldDefn.columnName << " to property " << fieldDefn.propertyName << "for" <<
                   primaryTable.tableName << "so using 0";
@@ -929,13 +1660,16 @@ public:
                return;
             }
 
-            propertyValue = QVariant(stringToEnum(primaryTable, fieldDefn, propertyValue.toString()));
+            propertyValue = QVariant(
+               columnDecoder.codec ? codeToEnum(primaryTable, fieldDefn, *columnDecoder.codec, propertyValue.toInt()) :
+                                     stringToEnum(primaryTable, fieldDefn, propertyValue.toString())
+            );
             return;
          }
          case ObjectStore::FieldType::Unit:   {
             if (propertyValue.isNull()) {
                // This is either a coding error or someone messed with the DB data.
-               qCritical() <<
+               qCCritical(Logging::database) <<
                   Q_FUNC_INFO << "Found null value for non-optional Unit when mapping column " <<
                   fieldDefn.columnName << " to property " << fieldDefn.propertyName << "for" <<
                   primaryTable.tableName;
@@ -945,7 +1679,8 @@ public:
             }
 
             propertyValue = QVariant::fromValue<Measurement::Unit const *>(
-               stringToUnit(primaryTable, fieldDefn, propertyValue.toString())
+               columnDecoder.codec ? codeToUnit(primaryTable, fieldDefn, *columnDecoder.codec, propertyValue.toInt()) :
+                                     stringToUnit(primaryTable, fieldDefn, propertyValue.toString())
             );
             return;
          }
@@ -1006,7 +1741,67 @@ public:
     * \brief Extract the primary key from an object
     */
    QVariant getPrimaryKey(QObject const & object) {
-      return object.property(*getPrimaryKeyProperty());
+      return this->readProperty(object, this->primaryTable.tableFields[0]);
+   }
+
+   /**
+    * \brief Read the property stored in \c fieldDefn (a field of \c primaryTable) from \c object.
+    *
+    *        This is equivalent to `object.property(*fieldDefn.propertyName)` but, since \c QObject::property has to
+    *        search the class's meta-object for the property name, and we do this for every column of every row we
+    *        write, we resolve each field's \c QMetaProperty once per store and then read through that.  If, for some
+    *        reason, we get an object whose class is not the one we resolved against, or a field that is not in
+    *        \c primaryTable, we just fall back to the look-up by name.
+    */
+   QVariant readProperty(QObject const & object, TableField const & fieldDefn) {
+      QMetaObject const * metaObject = object.metaObject();
+      std::call_once(this->propertyReadersOnce, [this, metaObject]() {
+         this->propertyReadersClass = metaObject;
+         for (auto const & field : this->primaryTable.tableFields) {
+            if (!field.propertyName.isNull()) {
+               int const propertyIndex = metaObject->indexOfProperty(*field.propertyName);
+               if (propertyIndex >= 0) {
+                  this->propertyReaders.insert(&field, metaObject->property(propertyIndex));
+               }
+            }
+         }
+         return;
+      });
+      if (metaObject == this->propertyReadersClass) {
+         auto const reader = this->propertyReaders.constFind(&fieldDefn);
+         if (reader != this->propertyReaders.cend()) {
+            return reader->read(&object);
+         }
+      }
+      return object.property(*fieldDefn.propertyName);
+   }
+
+   /**
+    * \brief Get the value to write to the DB for a property that is stored directly in the primary table
+    */
+   QVariant columnValueForProperty(QObject const & object, TableField const & fieldDefn) {
+      QVariant propertyBindValue{this->readProperty(object, fieldDefn)};
+
+      // Fix-up the QVariant if needed, including converting enums to strings
+      this->unwrapAndMapAsNeeded(this->primaryTable, fieldDefn, propertyBindValue);
+
+      if (std::holds_alternative<ObjectStore::TableDefinition const *>(fieldDefn.valueDecoder)) {
+         //
+         // If the columns if a foreign key and the caller is setting it to a non-positive value then we actually need
+         // to store NULL in the DB.  (In the code we store foreign key IDs as ints, and use -1 to mean null.  In the DB
+         // we need to store NULL explicitly because, if we try to store -1, we'll get a foreign key constraint
+         // violation as the DB is unable to find a row in the related table with primary key -1.)
+         //
+         // Firstly, we assert it's a coding error if we've created a foreign key column that's not an int.  For the
+         // moment at least, we don't support other types of primary/foreign key.
+         //
+         Q_ASSERT(ObjectStore::FieldType::Int == fieldDefn.fieldType);
+         if (propertyBindValue.toInt() <= 0) {
+            qCDebug(Logging::database) << Q_FUNC_INFO << "Treating" << propertyBindValue << "foreign key value as NULL";
+            propertyBindValue = QVariant(QVariant::Int);
+         }
+      }
+      return propertyBindValue;
    }
 
    /**
@@ -1017,87 +1812,23 @@ public:
     * \return \c true if succeeded, \c false otherwise
     */
    bool updatePropertyInDb(QSqlDatabase & connection, QObject const & object, BtStringConst const & propertyName) {
-      // We'll need some of this info even if it's a junction table property we're updating
-      BtStringConst const & primaryKeyColumn {this->getPrimaryKeyColumn()};
-      QVariant const        primaryKey       {this->getPrimaryKey(object)};
+      // We'll need this even if it's a junction table property we're updating
+      QVariant const primaryKey{this->getPrimaryKey(object)};
 
       //
       // First check whether this is a simple property.  (If not we look for it in the ones we store in junction
       // tables.)
       //
-      auto matchingFieldDefn = std::find_if(
-         this->primaryTable.tableFields.begin(),
-         this->primaryTable.tableFields.end(),
-         [propertyName](TableField const & fd) {return fd.propertyName == propertyName;}
-      );
-
-      if (matchingFieldDefn != this->primaryTable.tableFields.end()) {
+      TableField const * const fieldDefn = this->primaryTable.fieldForProperty(propertyName);
+      if (fieldDefn) {
          //
          // We're updating a simple property
          //
-         // Construct the SQL, which will be of the form
-         //
-         //    UPDATE tablename
-         //    SET columnName = :columnName
-         //    WHERE primaryKeyColumn = :primaryKeyColumn;
-         //
-         QString queryString{"UPDATE "};
-         QTextStream queryStringAsStream{&queryString};
-         queryStringAsStream << this->primaryTable.tableName << " SET ";
-
-         BtStringConst const & columnToUpdateInDb = matchingFieldDefn->columnName;
-
-         queryStringAsStream << " " << columnToUpdateInDb << " = :" << columnToUpdateInDb;
-         queryStringAsStream << " WHERE " << primaryKeyColumn << " = :" << primaryKeyColumn << ";";
-
-         qDebug() <<
-            Q_FUNC_INFO << "Updating" << object.metaObject()->className() << "property" << propertyName <<
-            "with database query" << queryString;
-
-         //
-         // Bind the values
-         //
-         BtSqlQuery sqlQuery{connection};
-         sqlQuery.prepare(queryString);
-         QVariant propertyBindValue{object.property(*propertyName)};
-         auto fieldDefn = std::find_if(
-            this->primaryTable.tableFields.begin(),
-            this->primaryTable.tableFields.end(),
-            [propertyName](TableField const & fd){return propertyName == fd.propertyName;}
-         );
-
-         // It's a coding error if we're trying to update a property that's not in the field definitions
-         Q_ASSERT(fieldDefn != this->primaryTable.tableFields.end());
-
-         // Fix-up the QVariant if needed, including converting enums to strings
-         this->unwrapAndMapAsNeeded(this->primaryTable, *fieldDefn, propertyBindValue);
-
-         if (std::holds_alternative<ObjectStore::TableDefinition const *>(fieldDefn->valueDecoder)) {
-            //
-            // If the columns if a foreign key and the caller is setting it to a non-positive value then we actually
-            // need to store NULL in the DB.  (In the code we store foreign key IDs as ints, and use -1 to mean null.
-            // In the DB we need to store NULL explicitly because, if we try to store -1, we'll get a foreign key
-            // constraint violation as the DB is unable to find a row in the related table with primary key -1.)
-            //
-            // Firstly, we assert it's a coding error if we've created a foreign key column that's not an int.  For the
-            // moment at least, we don't support other types of primary/foreign key.
-            //
-            Q_ASSERT(ObjectStore::FieldType::Int == fieldDefn->fieldType);
-            if (propertyBindValue.toInt() <= 0) {
-               qDebug() << Q_FUNC_INFO << "Treating" << propertyBindValue << "foreign key value as NULL";
-               propertyBindValue = QVariant(QVariant::Int);
-            }
-         }
-         sqlQuery.bindValue(QString{":%1"}.arg(*columnToUpdateInDb), propertyBindValue);
-         sqlQuery.bindValue(QString{":%1"}.arg(*primaryKeyColumn), primaryKey);
-         qDebug().noquote() << Q_FUNC_INFO << "Bind values:" << BoundValuesToString(sqlQuery);
-
-         //
-         // Run the query
-         //
-         if (!sqlQuery.exec()) {
-            qCritical() <<
-               Q_FUNC_INFO << "Error executing database query " << queryString << ": " << sqlQuery.lastError().text();
+         if (!updateColumnInDb(connection,
+                               this->primaryTable,
+                               *fieldDefn,
+                               primaryKey,
+                               this->columnValueForProperty(object, *fieldDefn))) {
             return false;
          }
       } else {
@@ -1115,24 +1846,20 @@ public:
 
          // It's a coding error if we couldn't find the property either as a simple field or an associative entity
          if (matchingJunctionTableDefinitionDefn == this->junctionTables.end()) {
-            qCritical() <<
+            qCCritical(Logging::database) <<
                Q_FUNC_INFO << "Unable to find rule for storing property" << object.metaObject()->className() << "::" <<
                propertyName << "in either" << this->primaryTable.tableName << "or any associated table";
-            qCritical().noquote() << Q_FUNC_INFO << Logging::getStackTrace();
+            qCCritical(Logging::database).noquote() << Q_FUNC_INFO << Logging::getStackTrace();
             Q_ASSERT(false);
          }
 
-         //
-         // As elsewhere, the simplest way to update a junction table is to blat any rows relating to the current object
-         // and then write out data based on the current property values.
-         //
-         qDebug() <<
+         qCDebug(Logging::database) <<
             Q_FUNC_INFO << "Updating" << object.metaObject()->className() << "property" << propertyName <<
             "in junction table" << matchingJunctionTableDefinitionDefn->tableName;
-         if (!deleteFromJunctionTableDefinition(*matchingJunctionTableDefinitionDefn, primaryKey, connection)) {
+         if (!updateJunctionTableRows(*matchingJunctionTableDefinitionDefn, object, primaryKey, connection)) {
             return false;
          }
-         if (!insertIntoJunctionTableDefinition(*matchingJunctionTableDefinitionDefn, object, primaryKey, connection)) {
+         if (!ChangeLog::recordChange(connection, *this->primaryTable.tableName, primaryKey.toInt())) {
             return false;
          }
       }
@@ -1142,33 +1869,187 @@ public:
    }
 
    /**
-    * \brief Insert an object in the database
+    * \brief Write several columns of a single row of the primary table in one UPDATE statement.  (Unlike
+    *        \c updateColumnInDb, the query is not reused, as the set of columns will typically differ from one call to
+    *        the next.)
     *
     *        NB: Caller is responsible for handling transactions
     *
-    * \param connection
-    * \param object
-    * \param writePrimaryKey Normally this is \c false, meaning we are going to let the DB assign a primary key to the
-    *                        new object we are inserting.  However, if we are writing existing objects out to a new
-    *                        database, then this will be \c true, meaning we write out the existing primary keys (to
-    *                        keep any foreign key references to them valid.  (In this latter circumstance, we are also
-    *                        assuming the caller has disabled foreign key constraints for the duration of the
-    *                        transaction.)
-    *
-    * \return the primary key of the inserted object, or -1 if there was an error.  Note that, in the case that
-    *         \c writePrimaryKey is \c false (ie we are inserting a new object), it is the \b caller's responsibility to
-    *         update the object with its new primary key.
+    * \return \c true if succeeded, \c false otherwise
     */
-   int insertObjectInDb(QSqlDatabase & connection, QObject const & object, bool writePrimaryKey) {
-      //
-      // Construct the SQL, which will be of the form
-      //
-      //    INSERT INTO tablename (firstColumn, secondColumn, ...)
-      //    VALUES (:firstColumn, :secondColumn, ...);
+   bool updateColumnsInDb(QSqlDatabase & connection,
+                          QObject const & object,
+                          QVector<TableField const *> const & fieldDefns) {
+      QString queryString{"UPDATE "};
+      QTextStream queryStringAsStream{&queryString};
+      queryStringAsStream << this->primaryTable.tableName << " SET ";
+      for (int ii = 0; ii < fieldDefns.size(); ++ii) {
+         queryStringAsStream << (ii == 0 ? "" : ", ") << fieldDefns.at(ii)->columnName << " = ?";
+      }
+      queryStringAsStream << " WHERE " << this->getPrimaryKeyColumn() << " = ?;";
+
+      BtSqlQuery sqlQuery{connection};
+      sqlQuery.prepare(queryString);
+      for (int ii = 0; ii < fieldDefns.size(); ++ii) {
+         sqlQuery.bindValue(ii, this->columnValueForProperty(object, *fieldDefns.at(ii)));
+      }
+      sqlQuery.bindValue(fieldDefns.size(), this->getPrimaryKey(object));
+
+      if (!sqlQuery.exec()) {
+         qCCritical(Logging::database) <<
+            Q_FUNC_INFO << "Error executing database query " << queryString << ": " << sqlQuery.lastError().text();
+         return false;
+      }
+      return ChangeLog::recordChange(connection, *this->primaryTable.tableName, this->getPrimaryKey(object).toInt());
+   }
+
+   /**
+    * \brief Update all the columns (including junction table ones) for an existing object in the database
+    *
+    *        NB: Caller is responsible for handling transactions
+    *
+    * \return \c true if succeeded, \c false otherwise
+    */
+   bool updateObjectInDb(QSqlDatabase & connection, QObject const & object) {
+      //
+      // Construct the SQL, which will be of the form
+      //
+      //    UPDATE tablename
+      //    SET firstColumn = :firstColumn, secondColumn = :secondColumn, ...
+      //    WHERE primaryKeyColumn = :primaryKeyColumn;
+      //
+      // .:TBD:. A small optimisation might be to construct this just once rather than every time this function is
+      //         called
+      //
+      QString queryString{"UPDATE "};
+      QTextStream queryStringAsStream{&queryString};
+      queryStringAsStream << this->primaryTable.tableName << " SET ";
+
+      QString  const primaryKeyColumn {*this->getPrimaryKeyColumn()};
+      QVariant const primaryKey       {this->getPrimaryKey(object)};
+
+      bool skippedPrimaryKey = false;
+      bool firstFieldOutput = false;
+      for (auto const & fieldDefn: this->primaryTable.tableFields) {
+         if (!skippedPrimaryKey) {
+            skippedPrimaryKey = true;
+         } else {
+            if (!firstFieldOutput) {
+               firstFieldOutput = true;
+            } else {
+               queryStringAsStream << ", ";
+            }
+            queryStringAsStream << " " << fieldDefn.columnName << " = :" << fieldDefn.columnName;
+         }
+      }
+
+      queryStringAsStream << " WHERE " << primaryKeyColumn << " = :" << primaryKeyColumn << ";";
+
+      //
+      // Bind the values.  Note that, because we're using bind names, it doesn't matter that the order in which we do
+      // the binds is different than the order in which the fields appear in the query.
+      //
+      BtSqlQuery sqlQuery{connection};
+      sqlQuery.prepare(queryString);
+      for (auto const & fieldDefn: this->primaryTable.tableFields) {
+         QVariant bindValue{this->readProperty(object, fieldDefn)};
+
+         // Fix-up the QVariant if needed, including converting enums to strings
+         this->unwrapAndMapAsNeeded(this->primaryTable, fieldDefn, bindValue);
+
+         sqlQuery.bindValue(QString{":"} + *fieldDefn.columnName, bindValue);
+      }
+
+      //
+      // Run the query
+      //
+      if (!sqlQuery.exec()) {
+         qCCritical(Logging::database) <<
+            Q_FUNC_INFO << "Error executing database query " << queryString << ": " << sqlQuery.lastError().text();
+         return false;
+      }
+
+      //
+      // Now update data in the junction tables
+      //
+      for (auto const & junctionTable : this->junctionTables) {
+         qCDebug(Logging::database) <<
+            Q_FUNC_INFO << "Updating property " << GetJunctionTableDefinitionPropertyName(junctionTable) <<
+            " in junction table " << junctionTable.tableName;
+
+         //
+         // Often nothing, or only a little, has changed, so we only write the differences.  (This costs an extra SELECT
+         // per junction table, but saves rewriting every row.)
+         //
+         if (!updateJunctionTableRows(junctionTable, object, primaryKey, connection)) {
+            return false;
+         }
+      }
+
+      return ChangeLog::recordChange(connection, *this->primaryTable.tableName, primaryKey.toInt());
+   }
+
+   /**
+    * \brief Insert an object in the database
+    *
+    *        NB: Caller is responsible for handling transactions
+    *
+    * \param connection
+    * \param object
+    * \param writePrimaryKey Normally this is \c false, meaning we are going to let the DB assign a primary key to the
+    *                        new object we are inserting.  However, if we are writing existing objects out to a new
+    *                        database, then this will be \c true, meaning we write out the existing primary keys (to
+    *                        keep any foreign key references to them valid.  (In this latter circumstance, we are also
+    *                        assuming the caller has disabled foreign key constraints for the duration of the
+    *                        transaction.)
+    *
+    * \return the primary key of the inserted object, or -1 if there was an error.  Note that, in the case that
+    *         \c writePrimaryKey is \c false (ie we are inserting a new object), it is the \b caller's responsibility to
+    *         update the object with its new primary key.
+    */
+   int insertObjectInDb(QSqlDatabase & connection, QObject const & object, bool writePrimaryKey) {
+      QString const queryString = this->primaryTableInsertSql(writePrimaryKey);
+      qCDebug(Logging::database) <<
+         Q_FUNC_INFO << "Inserting" << object.metaObject()->className() << "main table row with database query " <<
+         queryString;
+
+      BtSqlQuery sqlQuery{connection};
+      sqlQuery.prepare(queryString);
+      int const primaryKeyInDb = this->insertPrimaryTableRow(sqlQuery, queryString, object, writePrimaryKey);
+      if (primaryKeyInDb <= 0) {
+         return -1;
+      }
+
       //
-      // We omit the primary key column because we can't know its value in advance.  We'll find out what value the DB
-      // assigned to it after the query was run -- see below.
+      // Now save data to the junction tables
       //
+      for (auto const & junctionTable : this->junctionTables) {
+         if (!insertIntoJunctionTableDefinition(junctionTable, object, primaryKeyInDb, connection)) {
+            qCCritical(Logging::database) <<
+               Q_FUNC_INFO << "Error writing to junction tables:" << connection.lastError().text();
+            return -1;
+         }
+      }
+
+      // Copying an object to a new DB with its existing key is not a change (see ChangeLog)
+      if (!writePrimaryKey && !ChangeLog::recordChange(connection, *this->primaryTable.tableName, primaryKeyInDb)) {
+         return -1;
+      }
+
+      return primaryKeyInDb;
+   }
+
+   /**
+    * \brief Construct the SQL to insert a row in the primary table, which will be of the form
+    *
+    *           INSERT INTO tablename (firstColumn, secondColumn, ...)
+    *           VALUES (:firstColumn, :secondColumn, ...);
+    *
+    *        Unless \c writePrimaryKey is set, we omit the primary key column because we can't know its value in
+    *        advance.  We'll find out what value the DB assigned to it after the query was run -- see
+    *        \c insertPrimaryTableRow.
+    */
+   QString primaryTableInsertSql(bool writePrimaryKey) {
       QString queryString{"INSERT INTO "};
       QTextStream queryStringAsStream{&queryString};
       queryStringAsStream << this->primaryTable.tableName << " (";
@@ -1176,46 +2057,60 @@ public:
       queryStringAsStream << ") VALUES (";
       this->appendColumNames(queryStringAsStream, writePrimaryKey, true);
       queryStringAsStream << ");";
+      return queryString;
+   }
 
-      qDebug() <<
-         Q_FUNC_INFO << "Inserting" << object.metaObject()->className() << "main table row with database query " <<
-         queryString;
+   /**
+    * \return The value to write to the primary table column for \c fieldDefn when inserting \c object
+    */
+   QVariant primaryTableInsertValue(ObjectStore::TableField const & fieldDefn, QObject const & object) {
+      QVariant bindValue{this->readProperty(object, fieldDefn)};
+
+      // Fix-up the QVariant if needed, including converting enums to strings
+      this->unwrapAndMapAsNeeded(this->primaryTable, fieldDefn, bindValue);
+
+      if (std::holds_alternative<ObjectStore::TableDefinition const *>(fieldDefn.valueDecoder) &&
+          bindValue.toInt() <= 0) {
+         // If the field is a foreign key and the value we would otherwise put in it is not a valid key (eg we are
+         // inserting a Recipe on which the Equipment has not yet been set) then the query would barf at the invalid
+         // key.  So, in this case, we need to insert NULL.
+         bindValue = QVariant();
+      }
+      return bindValue;
+   }
 
+   /**
+    * \brief Bind the values for \c object to \c sqlQuery (which has been prepared with the SQL from
+    *        \c primaryTableInsertSql) and execute it.  The same \c sqlQuery can be reused for multiple objects.
+    *
+    *        NB: This only writes the primary table row.  The caller is responsible for junction tables.
+    *
+    * \return The primary key of the inserted row, or -1 if there was an error
+    */
+   int insertPrimaryTableRow(BtSqlQuery & sqlQuery,
+                             QString const & queryString,
+                             QObject const & object,
+                             bool writePrimaryKey) {
       //
       // Bind the values
       //
-      BtSqlQuery sqlQuery{connection};
-      sqlQuery.prepare(queryString);
       for (int ii = (writePrimaryKey ? 0 : 1); ii < this->primaryTable.tableFields.size(); ++ii) {
          auto const & fieldDefn = this->primaryTable.tableFields[ii];
-
-         QVariant bindValue{object.property(*fieldDefn.propertyName)};
-
-         // Fix-up the QVariant if needed, including converting enums to strings
-         this->unwrapAndMapAsNeeded(this->primaryTable, fieldDefn, bindValue);
-
-         if (std::holds_alternative<ObjectStore::TableDefinition const *>(fieldDefn.valueDecoder) && bindValue.toInt() <= 0) {
-            // If the field is a foreign key and the value we would otherwise put in it is not a valid key (eg we are
-            // inserting a Recipe on which the Equipment has not yet been set) then the query would barf at the invalid
-            // key.  So, in this case, we need to insert NULL.
-            bindValue = QVariant();
-         }
-
-         sqlQuery.bindValue(QString{":"} + *fieldDefn.columnName, bindValue);
+         sqlQuery.bindValue(QString{":"} + *fieldDefn.columnName, this->primaryTableInsertValue(fieldDefn, object));
       }
 
-      qDebug().noquote() << Q_FUNC_INFO << "Bind values:" << BoundValuesToString(sqlQuery);
+      qCDebug(Logging::database).noquote() << Q_FUNC_INFO << "Bind values:" << BoundValuesToString(sqlQuery);
 
       //
       // Run the query
       //
       if (!sqlQuery.exec()) {
-         qCritical() <<
+         qCCritical(Logging::database) <<
             Q_FUNC_INFO << "Error executing database query " << queryString << ": " << sqlQuery.lastError().text();
          return -1;
       }
 
-      int currentPrimaryKey = object.property(*this->getPrimaryKeyProperty()).toInt();
+      int currentPrimaryKey = this->getPrimaryKey(object).toInt();
       int primaryKeyInDb;
       if (writePrimaryKey) {
          //
@@ -1257,99 +2152,616 @@ public:
          //
          if (currentPrimaryKey > 0) {
             // This is almost certainly a coding error
-            qCritical() <<
+            qCCritical(Logging::database) <<
                Q_FUNC_INFO << "Wrote new" << object.metaObject()->className() << " to database (with primary key " <<
                primaryKeyInDb << ") but it already had primary key" << currentPrimaryKey;
             Q_ASSERT(false); // Stop here on debug build
          }
       }
 
-      qDebug() <<
+      qCDebug(Logging::database) <<
          Q_FUNC_INFO << object.metaObject()->className() << "#" << primaryKeyInDb << "inserted in database using" <<
          queryString;
 
-      //
-      // Now save data to the junction tables
-      //
-      for (auto const & junctionTable : this->junctionTables) {
-         if (!insertIntoJunctionTableDefinition(junctionTable, object, primaryKeyInDb, connection)) {
-            qCritical() <<
-               Q_FUNC_INFO << "Error writing to junction tables:" << connection.lastError().text();
-            return -1;
-         }
-      }
-
       return primaryKeyInDb;
    }
 
-   char const * const m_className;
-   ObjectStore::State m_state;
-   TypeLookup const & typeLookup;
-   TableDefinition const & primaryTable;
-   JunctionTableDefinitions const & junctionTables;
-   QHash<int, std::shared_ptr<QObject> > allObjects;
-   Database * database;
-};
+   /**
+    * \brief Write the primary table rows for \c objects, with their existing primary keys, several rows per INSERT
+    *        statement, ie of the form
+    *
+    *           INSERT INTO tablename (primaryKeyColumn, firstColumn, ...)
+    *           VALUES (?, ?, ...), (?, ?, ...), ...;
+    *
+    *        This is for writing everything to a new DB (see \c ObjectStore::writeAllToNewDb), where we don't need
+    *        anything back from the DB for each row.  Sending many rows per statement saves a round trip per row, which
+    *        makes a big difference when the new DB is on a PostgreSQL server.
+    *
+    *        NB: Caller is responsible for handling transactions and for disabling foreign key constraints
+    *
+    * \return \c true if succeeded, \c false otherwise
+    */
+   bool insertPrimaryTableRowsWithKeys(QSqlDatabase & connection, QList<QObject const *> const & objects) {
+      int const numColumns = this->primaryTable.tableFields.size();
+      int const rowsPerStatement = std::max(1, maxBindValuesPerStatement / numColumns);
+
+      QString columnNames;
+      QTextStream columnNamesAsStream{&columnNames};
+      this->appendColumNames(columnNamesAsStream, true, false);
+      QStringList rowPlaceholders;
+      for (int ii = 0; ii < numColumns; ++ii) {
+         rowPlaceholders.append("?");
+      }
+      QString const rowPlaceholder = QString{"(%1)"}.arg(rowPlaceholders.join(", "));
 
-QString ObjectStore::getDisplayName(ObjectStore::FieldType const fieldType) {
-   switch (fieldType) {
-      case ObjectStore::FieldType::Bool  : return "ObjectStore::FieldType::Bool"  ;
-      case ObjectStore::FieldType::Int   : return "ObjectStore::FieldType::Int"   ;
-      case ObjectStore::FieldType::UInt  : return "ObjectStore::FieldType::UInt"  ;
-      case ObjectStore::FieldType::Double: return "ObjectStore::FieldType::Double";
-      case ObjectStore::FieldType::String: return "ObjectStore::FieldType::String";
-      case ObjectStore::FieldType::Date  : return "ObjectStore::FieldType::Date"  ;
-      case ObjectStore::FieldType::Enum  : return "ObjectStore::FieldType::Enum"  ;
-      case ObjectStore::FieldType::Unit  : return "ObjectStore::FieldType::Unit"  ;
-      // In C++23, we'd add:
-      // default: std::unreachable();
+      for (int firstRow = 0; firstRow < objects.size(); firstRow += rowsPerStatement) {
+         int const numRows = std::min(rowsPerStatement, static_cast<int>(objects.size()) - firstRow);
+
+         QString queryString{"INSERT INTO "};
+         QTextStream queryStringAsStream{&queryString};
+         queryStringAsStream << this->primaryTable.tableName << " (" << columnNames << ") VALUES ";
+         for (int ii = 0; ii < numRows; ++ii) {
+            queryStringAsStream << (ii == 0 ? "" : ", ") << rowPlaceholder;
+         }
+         queryStringAsStream << ";";
+
+         BtSqlQuery sqlQuery{connection};
+         sqlQuery.prepare(queryString);
+         for (int ii = firstRow; ii < firstRow + numRows; ++ii) {
+            for (auto const & fieldDefn : this->primaryTable.tableFields) {
+               sqlQuery.addBindValue(this->primaryTableInsertValue(fieldDefn, *objects.at(ii)));
+            }
+         }
+         if (!sqlQuery.exec()) {
+            qCCritical(Logging::database) <<
+               Q_FUNC_INFO << "Error inserting" << numRows << "rows in" << this->primaryTable.tableName << ": " <<
+               sqlQuery.lastError().text();
+            return false;
+         }
+      }
+      return true;
    }
-   // In C++23, we'd add:
-   // std::unreachable()
-   // It's a coding error if we get here
-   Q_ASSERT(false);
-}
 
-ObjectStore::ObjectStore(char const *             const   className,
-                         TypeLookup               const & typeLookup,
-                         TableDefinition          const & primaryTable,
-                         JunctionTableDefinitions const & junctionTables) :
-   pimpl{ std::make_unique<impl>(className, typeLookup, primaryTable, junctionTables) } {
-   qDebug() << Q_FUNC_INFO << "Construct of object store for primary table" << this->pimpl->primaryTable.tableName;
-   // We have seen a circumstance where primaryTable.tableName is null, which shouldn't be possible.  This is some
-   // diagnostic to try to find out why.
-   if (this->pimpl->primaryTable.tableName.isNull()) {
-      qCritical().noquote() << Q_FUNC_INFO << "Primary table without name.  Call stack is:" << Logging::getStackTrace();
+   /**
+    * \brief Set up an empty \c PropertyIndex for each primary table or junction table field marked \c INDEXED.  Called
+    *        once from the constructor.
+    */
+   void setUpIndexes() {
+      for (auto const & fieldDefn : this->primaryTable.tableFields) {
+         if (fieldDefn.indexing == ObjectStore::INDEXED) {
+            this->addIndex(this->primaryTable, fieldDefn, -1);
+         } else if (fieldDefn.indexing == ObjectStore::SORT_KEY) {
+            // As with indexes, sort keys need to be integers, and there can only be one
+            if (fieldDefn.fieldType != ObjectStore::FieldType::Int || fieldDefn.propertyName.isNull() ||
+                this->sortKeyField) {
+               qCCritical(Logging::database) <<
+                  Q_FUNC_INFO << "Cannot sort on" << this->primaryTable.tableName << "." << fieldDefn.columnName;
+               Q_ASSERT(false);
+               continue;
+            }
+            this->sortKeyField = &fieldDefn;
+         }
+      }
+      for (int jj = 0; jj < this->junctionTables.size(); ++jj) {
+         auto const & junctionTable = this->junctionTables[jj];
+         //
+         // In a junction table, only the field holding the property value can meaningfully be indexed, and only then if
+         // there is a single value per object.
+         //
+         for (auto const & fieldDefn : junctionTable.tableFields) {
+            if (fieldDefn.indexing == ObjectStore::INDEXED) {
+               if (&fieldDefn != &junctionTable.tableFields[2] ||
+                   junctionTable.assumedNumEntries != ObjectStore::MAX_ONE_ENTRY) {
+                  // This is a coding error, but we can recover by not indexing the field
+                  qCCritical(Logging::database) <<
+                     Q_FUNC_INFO << "Cannot index" << junctionTable.tableName << "." << fieldDefn.columnName;
+                  Q_ASSERT(false);
+                  continue;
+               }
+               this->addIndex(junctionTable, fieldDefn, jj);
+            }
+         }
+      }
+      return;
    }
-   return;
-}
 
-// See https://herbsutter.com/gotw/_100/ for why we need to explicitly define the destructor here (and not in the
-// header file)
-ObjectStore::~ObjectStore() {
-   // Normally we try to avoid logging things here, as it's possible that the objects used in Logging.cpp have already
-   // been destroyed, but it can be useful to turn this on when debugging ObjectStore problems.
-   //qDebug() <<
-   //   Q_FUNC_INFO << "Destruct of object store for primary table" << this->pimpl->primaryTable.tableName <<
-   //   "(containing" << this->pimpl->allObjects.size() << "objects)";
-   return;
-}
+   void addIndex(TableDefinition const & tableDefn, TableField const & fieldDefn, int const junctionTableIndex) {
+      // Indexes are on integer values, so it's a coding error to mark any other type of field INDEXED
+      if (fieldDefn.fieldType != ObjectStore::FieldType::Int || fieldDefn.propertyName.isNull()) {
+         qCCritical(Logging::database) <<
+            Q_FUNC_INFO << "Cannot index" << tableDefn.tableName << "." << fieldDefn.columnName;
+         Q_ASSERT(false);
+         return;
+      }
+      this->propertyIndexes.append(PropertyIndex{&fieldDefn, junctionTableIndex, {}, {}, {}});
+      return;
+   }
 
-ObjectStore::State ObjectStore::state() const {
-   return this->pimpl->m_state;
-}
+   /**
+    * \return The index for \c propertyName, or \c nullptr if that property is not indexed
+    */
+   PropertyIndex * findIndex(BtStringConst const & propertyName) {
+      for (auto & index : this->propertyIndexes) {
+         if (index.fieldDefn->propertyName == propertyName) {
+            return &index;
+         }
+      }
+      return nullptr;
+   }
+   PropertyIndex const * findIndex(BtStringConst const & propertyName) const {
+      return const_cast<impl *>(this)->findIndex(propertyName);
+   }
 
-void ObjectStore::logDiagnostics() const {
-   for (int key : this->pimpl->allObjects.keys()) {
-      std::shared_ptr<QObject> object = this->pimpl->allObjects.value(key);
-      qDebug() <<
-         Q_FUNC_INFO << "Object @" << static_cast<void *>(object.get()) << "stored as #" << key << "has key" <<
-         this->pimpl->getPrimaryKey(*object) << "and shared pointer use count" << object.use_count();
+   /**
+    * \brief Add (or re-add) an object to a single index, using the current value of the indexed property
+    */
+   void indexObject(PropertyIndex & index, int const id, QObject const & object) {
+      this->addToIndex(index, id, this->readProperty(object, *index.fieldDefn).toInt());
+      return;
    }
-   return;
-}
 
-// Note that we have to pass Database in as a parameter because, ultimately, we're being called from Database::load()
+   void addToIndex(PropertyIndex & index, int const id, int const value) {
+      auto const existing = index.valueById.constFind(id);
+      if (existing != index.valueById.cend() && existing.value() == value) {
+         // Nothing to do, and not dropping the ordered IDs for the value saves re-sorting them
+         return;
+      }
+      this->unindexObject(index, id);
+      index.idsByValue[value].insert(id);
+      index.valueById.insert(id, value);
+      index.orderedIdsByValue.remove(value);
+      return;
+   }
+
+   /**
+    * \brief Record \c sortKey as the sort key of object \c id.  If it has changed, the ordered lists of IDs that
+    *        include the object are no longer in order, so we drop them.
+    */
+   void setSortKey(int const id, int const sortKey) {
+      auto existing = this->sortKeyById.find(id);
+      if (existing != this->sortKeyById.end() && existing.value() == sortKey) {
+         return;
+      }
+      this->sortKeyById.insert(id, sortKey);
+      for (auto & index : this->propertyIndexes) {
+         auto value = index.valueById.constFind(id);
+         if (value != index.valueById.cend()) {
+            index.orderedIdsByValue.remove(value.value());
+         }
+      }
+      return;
+   }
+
+   /**
+    * \brief Called when an object is added or updated, or the property that is the sort key (if there is one) changes
+    */
+   void sortKeyObject(int const id, QObject const & object) {
+      if (this->sortKeyField) {
+         this->setSortKey(id, this->readProperty(object, *this->sortKeyField).toInt());
+      }
+      return;
+   }
+
+   /**
+    * \brief Remove an object from a single index (if it is in it)
+    */
+   void unindexObject(PropertyIndex & index, int const id) {
+      auto existing = index.valueById.find(id);
+      if (existing != index.valueById.end()) {
+         auto ids = index.idsByValue.find(existing.value());
+         if (ids != index.idsByValue.end()) {
+            ids->remove(id);
+            if (ids->isEmpty()) {
+               index.idsByValue.erase(ids);
+            }
+         }
+         index.orderedIdsByValue.remove(existing.value());
+         index.valueById.erase(existing);
+      }
+      return;
+   }
+
+   /**
+    * \brief Called whenever an object is added to, or updated in, \c allObjects
+    */
+   void indexObject(int const id, QObject const & object) {
+      for (auto & index : this->propertyIndexes) {
+         this->indexObject(index, id, object);
+      }
+      this->sortKeyObject(id, object);
+      this->fingerprintObject(id, object);
+      this->nameIndexObject(id, object);
+      this->noteContentChange(id);
+      return;
+   }
+
+   /**
+    * \brief Called whenever an object in the store is inserted, deleted or changed, so that \c ObjectStore::snapshot
+    *        knows what it needs to re-read.  (All such changes go through the index maintenance functions or
+    *        \c ObjectStore::updateProperty / \c ObjectStore::updateProperties.)
+    */
+   void noteContentChange(int const id) {
+      ++this->contentVersion;
+      // Until someone asks for a snapshot, there is nothing to keep up to date
+      if (this->latestSnapshot) {
+         this->idsChangedSinceSnapshot.insert(id);
+      }
+      return;
+   }
+
+   /**
+    * \return The values, in the order of \c ObjectStore::Snapshot::Data::columnByPropertyName, of the primary table
+    *         properties of \c object
+    */
+   QVector<QVariant> snapshotRow(QObject const & object) {
+      QVector<QVariant> row;
+      row.reserve(this->primaryTable.tableFields.size());
+      for (auto const & fieldDefn : this->primaryTable.tableFields) {
+         if (!fieldDefn.propertyName.isNull()) {
+            row.append(this->readProperty(object, fieldDefn));
+         }
+      }
+      return row;
+   }
+
+   /**
+    * \brief Add (or re-add) an object to the name index, if we have built it
+    */
+   void nameIndexObject(int const id, QObject const & object) {
+      if (!this->nameIndex) {
+         return;
+      }
+      this->unnameIndexObject(id);
+      NamedEntity const * namedEntity = qobject_cast<NamedEntity const *>(&object);
+      if (!namedEntity) {
+         // As in fingerprintObject, this is a coding error
+         qCCritical(Logging::database) <<
+            Q_FUNC_INFO << "Cannot index name of non-NamedEntity" << this->m_className << "#" << id;
+         Q_ASSERT(false);
+         return;
+      }
+      QString const name = namedEntity->name();
+      auto const [baseName, number] = NamedEntity::splitDuplicateNameNumber(name);
+      ++this->nameIndex->countByName[name];
+      ++this->nameIndex->countByNumberByBaseName[baseName][number];
+      this->nameIndex->nameById.insert(id, name);
+      return;
+   }
+
+   /**
+    * \brief Remove an object from the name index (if we have built it and the object is in it)
+    */
+   void unnameIndexObject(int const id) {
+      if (!this->nameIndex) {
+         return;
+      }
+      auto existing = this->nameIndex->nameById.find(id);
+      if (existing == this->nameIndex->nameById.end()) {
+         return;
+      }
+      QString const & name = existing.value();
+      if (--this->nameIndex->countByName[name] <= 0) {
+         this->nameIndex->countByName.remove(name);
+      }
+      auto const [baseName, number] = NamedEntity::splitDuplicateNameNumber(name);
+      auto countByNumber = this->nameIndex->countByNumberByBaseName.find(baseName);
+      if (countByNumber != this->nameIndex->countByNumberByBaseName.end()) {
+         if (--(*countByNumber)[number] <= 0) {
+            countByNumber->remove(number);
+         }
+         if (countByNumber->isEmpty()) {
+            this->nameIndex->countByNumberByBaseName.erase(countByNumber);
+         }
+      }
+      this->nameIndex->nameById.erase(existing);
+      return;
+   }
+
+   /**
+    * \brief Add (or re-add) an object to the fingerprint index, if we have built it
+    */
+   void fingerprintObject(int const id, QObject const & object) {
+      if (!this->fingerprintIndex) {
+         return;
+      }
+      this->unfingerprintObject(id);
+      NamedEntity const * namedEntity = qobject_cast<NamedEntity const *>(&object);
+      if (!namedEntity) {
+         // This is a coding error, as everything we store should be a NamedEntity
+         qCCritical(Logging::database) <<
+            Q_FUNC_INFO << "Cannot fingerprint non-NamedEntity" << this->m_className << "#" << id;
+         Q_ASSERT(false);
+         return;
+      }
+      std::size_t const fingerprint = namedEntity->fingerprint();
+      this->fingerprintIndex->idsByFingerprint[fingerprint].insert(id);
+      this->fingerprintIndex->fingerprintById.insert(id, fingerprint);
+      return;
+   }
+
+   /**
+    * \brief Remove an object from the fingerprint index (if we have built it and the object is in it)
+    */
+   void unfingerprintObject(int const id) {
+      if (!this->fingerprintIndex) {
+         return;
+      }
+      auto existing = this->fingerprintIndex->fingerprintById.find(id);
+      if (existing != this->fingerprintIndex->fingerprintById.end()) {
+         auto ids = this->fingerprintIndex->idsByFingerprint.find(existing.value());
+         if (ids != this->fingerprintIndex->idsByFingerprint.end()) {
+            ids->remove(id);
+            if (ids->isEmpty()) {
+               this->fingerprintIndex->idsByFingerprint.erase(ids);
+            }
+         }
+         this->fingerprintIndex->fingerprintById.erase(existing);
+      }
+      return;
+   }
+
+   /**
+    * \brief In lazy loading mode, add a not-yet-created object to the indexes, using the raw data we read from the DB.
+    *        (When the object is created, \c indexObject will be called for it.)
+    */
+   void indexPendingObject(int const id, PendingObject const & pendingObject) {
+      this->noteContentChange(id);
+      if (this->sortKeyField) {
+         this->setSortKey(id, pendingObject.namedParameterBundle.get(this->sortKeyField->propertyName).toInt());
+      }
+      for (auto & index : this->propertyIndexes) {
+         if (index.junctionTableIndex < 0) {
+            this->addToIndex(index, id, pendingObject.namedParameterBundle.get(index.fieldDefn->propertyName).toInt());
+         } else {
+            // If there's no row in the junction table, we leave the object out of the index until it is created
+            for (auto const & [junctionTableIndex, otherKeys] : pendingObject.junctionValues) {
+               if (junctionTableIndex == index.junctionTableIndex) {
+                  this->addToIndex(index, id, otherKeys.first());
+                  break;
+               }
+            }
+         }
+      }
+      return;
+   }
+
+   /**
+    * \brief Called whenever an object is removed from \c allObjects
+    */
+   void unindexObject(int const id) {
+      for (auto & index : this->propertyIndexes) {
+         this->unindexObject(index, id);
+      }
+      this->sortKeyById.remove(id);
+      this->unfingerprintObject(id);
+      this->unnameIndexObject(id);
+      this->noteContentChange(id);
+      return;
+   }
+
+   /**
+    * \brief Read the primary table and all junction tables into \c loadedRows, without creating any objects or
+    *        otherwise modifying the store.  Safe to call from a worker thread provided \c connection belongs to that
+    *        thread.
+    *
+    * \param onlyPrimaryKey If set, only read the rows for the object with this primary key
+    * \param rawPrimaryRows If set, the primary table rows are put here, as the column values the DB gave us, instead
+    *                       of being decoded into \c loadedRows.primaryRows.  (This is what \c writeSnapshot stores.)
+    *
+    * \return \c false if there was an error
+    */
+   bool readAllRows(Database & db,
+                    QSqlDatabase & connection,
+                    LoadedRows & loadedRows,
+                    std::optional<int> const onlyPrimaryKey = std::nullopt,
+                    QVector<QVector<QVariant> > * rawPrimaryRows = nullptr);
+
+   /**
+    * \brief Decode one row of raw column values (in the order of \c primaryTable.tableFields, as read from the DB or
+    *        from a start-up snapshot) into constructor parameters, and add it to \c loadedRows.
+    */
+   void appendDecodedRow(LoadedRows & loadedRows, QVector<QVariant> & rowValues);
+
+   //! \return The column names of \c primaryTable, in order.  Stored in snapshots so we can tell if the schema changed.
+   QStringList primaryColumnNames() const {
+      QStringList columnNames;
+      columnNames.reserve(this->primaryTable.tableFields.size());
+      for (auto const & fieldDefn : this->primaryTable.tableFields) {
+         columnNames.append(*fieldDefn.columnName);
+      }
+      return columnNames;
+   }
+
+   /**
+    * \brief Returns the \c EnumCodes::Codec for \c fieldDefn if it is \c ObjectStore::STORED_AS_CODE, or \c nullptr
+    *        otherwise.  The codecs are set up at start-up (see \c LoadAllEnumCodes), so it's a coding error if a coded
+    *        field doesn't have one.
+    */
+   EnumCodes::Codec const * getCodec(ObjectStore::TableField const & fieldDefn) const {
+      if (!fieldDefn.isStoredAsCode()) {
+         return nullptr;
+      }
+      EnumCodes::Codec const * const codec = EnumCodes::codecFor(fieldDefn);
+      if (!codec) {
+         qCCritical(Logging::database) <<
+            Q_FUNC_INFO << "Coding Error!  Codes for column" << fieldDefn.columnName << "of" <<
+            this->primaryTable.tableName << "have not been loaded";
+         Q_ASSERT(false);
+      }
+      return codec;
+   }
+
+   /**
+    * \brief Returns one \c ColumnDecoder for each of \c primaryTable.tableFields, in the same order, building them the
+    *        first time we're called.  (We can't do this in the constructor as we need to look up property types, and
+    *        \c typeLookup might be a static in another translation unit that is not yet constructed.)  Thread-safe, as
+    *        \c readAllRows can be called from a worker thread.
+    */
+   QVector<ColumnDecoder> const & getRowDecoder() {
+      std::call_once(this->rowDecoderOnce, [this]() {
+         this->rowDecoder.reserve(this->primaryTable.tableFields.size());
+         for (auto const & fieldDefn : this->primaryTable.tableFields) {
+            this->rowDecoder.append(ColumnDecoder{&fieldDefn,
+                                                  getExpectedTypes(fieldDefn),
+                                                  this->typeLookup.getType(fieldDefn.propertyName).isOptional(),
+                                                  this->getCodec(fieldDefn)});
+         }
+         return;
+      });
+      return this->rowDecoder;
+   }
+
+   /**
+    * \brief Set a property stored in a junction table on an object.  Used when creating objects from the DB.
+    *
+    * \return \c false if there was an error (which is a coding error and will have been logged)
+    */
+   bool setJunctionProperty(QObject & object,
+                            int const id,
+                            ObjectStore::JunctionTableDefinition const & junctionTable,
+                            QVector<int> const & otherKeys);
+
+   char const * const m_className;
+   ObjectStore::State m_state;
+   TypeLookup const & typeLookup;
+   TableDefinition const & primaryTable;
+   JunctionTableDefinitions const & junctionTables;
+   //! Primary key -> object.  Keys are DB primary keys, which are dense enough that we can index an array by them.
+   DenseIdMap<std::shared_ptr<QObject> > allObjects;
+   QVector<PropertyIndex> propertyIndexes;
+   //! The primary table field marked \c SORT_KEY, if any
+   TableField const * sortKeyField;
+   //! ID of cached object -> current value of its sort key (if we have one).  Like the indexes, this covers objects
+   //  not yet created in lazy loading mode, so that \c ObjectStore::idsByIndex never needs to create objects.
+   QHash<int, int> sortKeyById;
+   //! Only built the first time it is needed (see \c ObjectStore::idsByFingerprint), as most runs never need it
+   std::optional<FingerprintIndex> fingerprintIndex;
+   //! Similarly, only built the first time it is needed (see \c ObjectStore::uniqueName)
+   std::optional<NameIndex> nameIndex;
+   //! In lazy loading mode, objects not yet created.  An ID is never in both this and \c allObjects.
+   QHash<int, PendingObject> pendingObjects;
+   //! Set by \c ObjectStore::prefetchAll and consumed by \c ObjectStore::loadAll
+   std::optional<LoadedRows> prefetchedRows;
+   //! See \c getRowDecoder
+   std::once_flag rowDecoderOnce;
+   QVector<ColumnDecoder> rowDecoder;
+   //! See \c readProperty
+   std::once_flag propertyReadersOnce;
+   QMetaObject const * propertyReadersClass;
+   QHash<TableField const *, QMetaProperty> propertyReaders;
+   //! Set by \c ObjectStore::refreshFromDb while it updates objects with changes that are already in the DB
+   bool applyingChangesFromDb;
+   Database * database;
+   //! IDs of inserted objects whose \c signalObjectInserted is waiting for an \c ObjectStoreSignalBatch to close
+   QVector<int> queuedInsertions;
+   //! Similarly, deleted objects whose \c signalObjectDeleted is waiting
+   QVector<std::pair<int, std::shared_ptr<QObject>>> queuedDeletions;
+   //! See \c ObjectStore::contentVersion.  Only modified on the GUI thread, but can be read on any.
+   std::atomic<unsigned int> contentVersion;
+   //! The most recent result of \c ObjectStore::snapshot, if any
+   std::shared_ptr<ObjectStore::Snapshot::Data const> latestSnapshot;
+   //! Objects that have been inserted, deleted or changed since \c latestSnapshot was made
+   QSet<int> idsChangedSinceSnapshot;
+   //! Recently read values of \c LOAD_LAZILY fields (see \c ObjectStore::lazyTextValue).  Cost is length in characters.
+   static constexpr int lazyTextCacheMaxChars = 256 * 1024;
+   QCache<QPair<int, TableField const *>, QString> lazyTextCache;
+   //! Getters for lazily-loaded fields can be called from worker threads (eg when exporting in parallel), and
+   //! \c QCache is not thread-safe, so all access to \c lazyTextCache is under this lock
+   QMutex lazyTextCacheMutex;
+
+   /**
+    * \brief Drop any cached lazily-loaded values for the object with primary key \c id, eg because it has been deleted
+    *        or changed in the DB.
+    */
+   void forgetLazyText(int const id) {
+      QMutexLocker locker(&this->lazyTextCacheMutex);
+      for (auto const & fieldDefn : this->primaryTable.tableFields) {
+         if (fieldDefn.loading == ObjectStore::LOAD_LAZILY) {
+            this->lazyTextCache.remove(qMakePair(id, &fieldDefn));
+         }
+      }
+      return;
+   }
+};
+
+QString ObjectStore::getDisplayName(ObjectStore::FieldType const fieldType) {
+   switch (fieldType) {
+      case ObjectStore::FieldType::Bool  : return "ObjectStore::FieldType::Bool"  ;
+      case ObjectStore::FieldType::Int   : return "ObjectStore::FieldType::Int"   ;
+      case ObjectStore::FieldType::UInt  : return "ObjectStore::FieldType::UInt"  ;
+      case ObjectStore::FieldType::Double: return "ObjectStore::FieldType::Double";
+      case ObjectStore::FieldType::String: return "ObjectStore::FieldType::String";
+      case ObjectStore::FieldType::Date  : return "ObjectStore::FieldType::Date"  ;
+      case ObjectStore::FieldType::Enum  : return "ObjectStore::FieldType::Enum"  ;
+      case ObjectStore::FieldType::Unit  : return "ObjectStore::FieldType::Unit"  ;
+      // In C++23, we'd add:
+      // default: std::unreachable();
+   }
+   // In C++23, we'd add:
+   // std::unreachable()
+   // It's a coding error if we get here
+   Q_ASSERT(false);
+}
+
+char const * const ObjectStore::changeNotificationChannel = "object_changes";
+
+ObjectStore::ObjectStore(char const *             const   className,
+                         TypeLookup               const & typeLookup,
+                         TableDefinition          const & primaryTable,
+                         JunctionTableDefinitions const & junctionTables) :
+   pimpl{ std::make_unique<impl>(className, typeLookup, primaryTable, junctionTables) } {
+   qCDebug(Logging::database) <<
+      Q_FUNC_INFO << "Construct of object store for primary table" << this->pimpl->primaryTable.tableName;
+   // We have seen a circumstance where primaryTable.tableName is null, which shouldn't be possible.  This is some
+   // diagnostic to try to find out why.
+   if (this->pimpl->primaryTable.tableName.isNull()) {
+      qCCritical(Logging::database).noquote() <<
+         Q_FUNC_INFO << "Primary table without name.  Call stack is:" << Logging::getStackTrace();
+   }
+   return;
+}
+
+// See https://herbsutter.com/gotw/_100/ for why we need to explicitly define the destructor here (and not in the
+// header file)
+ObjectStore::~ObjectStore() {
+   // Normally we try to avoid logging things here, as it's possible that the objects used in Logging.cpp have already
+   // been destroyed, but it can be useful to turn this on when debugging ObjectStore problems.
+   //qDebug() <<
+   //   Q_FUNC_INFO << "Destruct of object store for primary table" << this->pimpl->primaryTable.tableName <<
+   //   "(containing" << this->pimpl->allObjects.size() << "objects)";
+   storesWithQueuedSignals.removeAll(this);
+   return;
+}
+
+ObjectStore::State ObjectStore::state() const {
+   return this->pimpl->m_state;
+}
+
+int ObjectStore::numCachedObjects() const {
+   return this->pimpl->allObjects.size();
+}
+
+std::size_t ObjectStore::estimatedCacheBytes() const {
+   //
+   // As well as the object itself, each cached object costs us a shared_ptr control block and a slot in allObjects
+   // (plus a share of any unused slots).  We don't need to be precise, so we just allow a fixed amount for all of that.
+   //
+   std::size_t constexpr overheadPerObject = 48;
+   return static_cast<std::size_t>(this->numCachedObjects()) * (this->objectSize() + overheadPerObject);
+}
+
+void ObjectStore::logDiagnostics() const {
+   this->hydrateAll();
+   for (int key : this->pimpl->allObjects.keys()) {
+      std::shared_ptr<QObject> object = this->pimpl->allObjects.value(key);
+      qCDebug(Logging::database) <<
+         Q_FUNC_INFO << "Object @" << static_cast<void *>(object.get()) << "stored as #" << key << "has key" <<
+         this->pimpl->getPrimaryKey(*object) << "and shared pointer use count" << object.use_count();
+   }
+   return;
+}
+
+// Note that we have to pass Database in as a parameter because, ultimately, we're being called from Database::load()
 // which is called from Database::getInstance(), so we don't want to get in an endless loop.
 bool ObjectStore::createTables(Database & database, QSqlDatabase & connection) const {
    //
@@ -1393,25 +2805,75 @@ bool ObjectStore::addTableConstraints(Database & database, QSqlDatabase & connec
    return true;
 }
 
-void ObjectStore::loadAll(Database * database) {
-   // Assume we failed until we succeed!  (This saves us having to remember to set the error state in every error
-   // branch.  Instead, we just have to set the all OK state at the end of this function.)
-   this->pimpl->m_state = ObjectStore::State::ErrorInitialising;
+bool ObjectStore::createIndexes(QSqlDatabase & connection) const {
+   if (!addIndexesToTable(connection, this->pimpl->primaryTable)) {
+      return false;
+   }
 
-   if (database) {
-      this->pimpl->database = database;
-   } else {
-      this->pimpl->database = &Database::instance();
+   for (auto const & junctionTable : this->pimpl->junctionTables) {
+      if (!addIndexesToTable(connection, junctionTable)) {
+         return false;
+      }
+   }
+
+   return true;
+}
+
+bool ObjectStore::createChangeNotificationTriggers(QSqlDatabase & connection) const {
+   //
+   // The function is shared by all tables (and all stores), so it doesn't matter that each store (re)creates it.  We
+   // send the ID as text, via the row's JSON representation, because the trigger doesn't know the name of the ID column
+   // at compile time.  NB: Trigger functions can only take text arguments, hence having to look up the ID column by
+   // name.
+   //
+   QString const functionQueryString = QString{
+      "CREATE OR REPLACE FUNCTION notify_object_change() RETURNS trigger AS $$ "
+      "BEGIN "
+         "PERFORM pg_notify('%1', TG_ARGV[0] || ',' || (to_jsonb(COALESCE(NEW, OLD)) ->> TG_ARGV[1])); "
+         "RETURN NULL; "
+      "END; "
+      "$$ LANGUAGE plpgsql"
+   }.arg(ObjectStore::changeNotificationChannel);
+   BtSqlQuery sqlQuery{connection};
+   sqlQuery.prepare(functionQueryString);
+   if (!sqlQuery.exec()) {
+      qCCritical(Logging::database) <<
+         Q_FUNC_INFO << "Error executing database query " << functionQueryString << ": " <<
+         sqlQuery.lastError().text();
+      return false;
+   }
+
+   if (!addChangeNotificationTrigger(connection,
+                                     this->pimpl->primaryTable.tableName,
+                                     this->pimpl->primaryTable.tableName,
+                                     this->pimpl->getPrimaryKeyColumn())) {
+      return false;
+   }
+
+   for (auto const & junctionTable : this->pimpl->junctionTables) {
+      if (!addChangeNotificationTrigger(connection,
+                                        junctionTable.tableName,
+                                        this->pimpl->primaryTable.tableName,
+                                        GetJunctionTableDefinitionThisPrimaryKeyColumn(junctionTable))) {
+         return false;
+      }
    }
 
+   return true;
+}
+
+bool ObjectStore::impl::readAllRows(Database & db,
+                                    QSqlDatabase & connection,
+                                    ObjectStore::impl::LoadedRows & loadedRows,
+                                    std::optional<int> const onlyPrimaryKey,
+                                    QVector<QVector<QVariant> > * rawPrimaryRows) {
    // Start transaction
    // (By the magic of RAII, this will abort if we return from this function without calling dbTransaction.commit()
    //
    // .:TBD:. In theory we don't need a transaction if we're _only_ reading data...
-   QSqlDatabase connection = this->pimpl->database->sqlDatabase();
-   DbTransaction dbTransaction{*this->pimpl->database,
+   DbTransaction dbTransaction{db,
                                connection,
-                               QString("Load All %1").arg(*this->pimpl->primaryTable.tableName)};
+                               QString("Load All %1").arg(*this->primaryTable.tableName)};
 
    //
    // Using QSqlTableModel would save us having to write a SELECT statement, however it is a bit hard to use it to
@@ -1423,22 +2885,49 @@ void ObjectStore::loadAll(Database * database) {
    // So, instead, we create the appropriate SELECT query from scratch.  We specify the column names rather than just
    // do SELECT * because it's small extra effort and will give us an early error if an invalid column is specified.
    //
+   // When reading one row (eg in refreshFromDb), it's simpler to read everything, including LOAD_LAZILY fields.  When
+   // reading the whole table, we select NULL in place of each LOAD_LAZILY field, so the columns stay in the same order
+   // as primaryTable.tableFields but without any of the lazy text being read.
    QString queryString{"SELECT "};
    QTextStream queryStringAsStream{&queryString};
-   this->pimpl->appendColumNames(queryStringAsStream, true, false);
-   queryStringAsStream << "\n FROM " << this->pimpl->primaryTable.tableName << ";";
-   BtSqlQuery sqlQuery{connection};
-   sqlQuery.prepare(queryString);
-   if (!sqlQuery.exec()) {
-      qCritical() <<
-         Q_FUNC_INFO << "Error executing database query " << queryString << ": " << sqlQuery.lastError().text();
-      return;
-   }
-
-   qDebug() <<
-      Q_FUNC_INFO << "Reading main table rows from" << this->pimpl->primaryTable.tableName <<
-      "database table using query " << queryString;
+   if (onlyPrimaryKey) {
+      this->appendColumNames(queryStringAsStream, true, false);
+   } else {
+      bool firstFieldOutput = true;
+      for (auto const & fieldDefn : this->primaryTable.tableFields) {
+         if (!firstFieldOutput) {
+            queryStringAsStream << ", ";
+         }
+         firstFieldOutput = false;
+         if (fieldDefn.loading == ObjectStore::LOAD_LAZILY) {
+            queryStringAsStream << "NULL AS ";
+         }
+         queryStringAsStream << fieldDefn.columnName;
+      }
+   }
+   queryStringAsStream << "\n FROM " << this->primaryTable.tableName;
+   if (onlyPrimaryKey) {
+      queryStringAsStream << "\n WHERE " << this->getPrimaryKeyColumn() << " = :id";
+   }
+   queryStringAsStream << ";";
+   BtSqlQuery sqlQuery{connection};
+   // We only ever step forwards through the results, so there's no need for the driver to cache rows we've read
+   sqlQuery.setForwardOnly(true);
+   sqlQuery.prepare(queryString);
+   if (onlyPrimaryKey) {
+      sqlQuery.bindValue(":id", *onlyPrimaryKey);
+   }
+   if (!sqlQuery.exec()) {
+      qCCritical(Logging::database) <<
+         Q_FUNC_INFO << "Error executing database query " << queryString << ": " << sqlQuery.lastError().text();
+      return false;
+   }
+
+   qCDebug(Logging::database) <<
+      Q_FUNC_INFO << "Reading main table rows from" << this->primaryTable.tableName <<
+      "database table using query " << queryString;
 
+   int const numColumns = this->primaryTable.tableFields.size();
    while (sqlQuery.next()) {
       //
       // We want to pull all the fields for the current row from the database and use them to construct a new
@@ -1471,223 +2960,1030 @@ void ObjectStore::loadAll(Database * database) {
       // object class to enforce mandatory construction parameters with this approach.
       //
       // Method (ii) is therefore our preferred approach.  We use NamedParameterBundle, which is a simple extension of
-      // QHash.
+      // QHash.  (See appendDecodedRow.)
       //
-      NamedParameterBundle namedParameterBundle;
-      int primaryKey = -1;
-
-      //
-      // Populate all the fields
-      // By convention, the primary key should be listed as the first field
+      // The columns in the query are in the same order as primaryTable.tableFields (see appendColumNames), so we can
+      // read them by index rather than having QSqlQuery look up each column name.
       //
-      // NB: For now we're assuming that the primary key is always an integer, but it would not be enormous work to
-      //     allow a wider range of types.
-      //
-      bool readPrimaryKey = false;
-      for (auto const & fieldDefn : this->pimpl->primaryTable.tableFields) {
-         QVariant fieldValue = sqlQuery.value(*fieldDefn.columnName);
+      QVector<QVariant> rowValues;
+      rowValues.reserve(numColumns);
+      for (int columnIndex = 0; columnIndex < numColumns; ++columnIndex) {
+         auto const & fieldDefn = this->primaryTable.tableFields[columnIndex];
+         if (!onlyPrimaryKey && fieldDefn.loading == ObjectStore::LOAD_LAZILY) {
+            // See comment above.  An invalid QVariant tells appendDecodedRow the field is not loaded.
+            rowValues.append(QVariant{});
+            continue;
+         }
+         QVariant fieldValue = sqlQuery.value(columnIndex);
          //qDebug() <<
          //   Q_FUNC_INFO << "Reading col" << fieldDefn.columnName << "(=" << fieldValue << ") into property" <<
          //   fieldDefn.propertyName;
          if (!fieldValue.isValid()) {
-            qCritical() <<
+            qCCritical(Logging::database) <<
                Q_FUNC_INFO << "Error reading column " << fieldDefn.columnName << " (" << fieldValue.toString() <<
-               ") from database table " << this->pimpl->primaryTable.tableName << ". SQL error message: " <<
+               ") from database table " << this->primaryTable.tableName << ". SQL error message: " <<
                sqlQuery.lastError().text();
             break;
          }
+         rowValues.append(std::move(fieldValue));
+      }
+
+      if (rawPrimaryRows) {
+         rawPrimaryRows->append(std::move(rowValues));
+      } else {
+         this->appendDecodedRow(loadedRows, rowValues);
+      }
+   }
+
+   //
+   // Now we load the data from the junction tables.  This, pretty much by definition, isn't needed for the object's
+   // constructor, so we're OK to pull it out separately.  Otherwise we'd have to do a LEFT JOIN for each junction
+   // table in the query above.  Since we're caching everything in memory, and we're not overly worried about
+   // optimising every single SQL query (because the amount of data in the DB is not enormous), we prefer the
+   // simplicity of separate queries.
+   //
+   for (auto const & junctionTable : this->junctionTables) {
+      qCDebug(Logging::database) <<
+         Q_FUNC_INFO << "Reading junction table " << junctionTable.tableName << " into " <<
+         GetJunctionTableDefinitionPropertyName(junctionTable);
+
+      //
+      // Order first by the object we're adding the other IDs to, then order either by the other IDs or by another
+      // column if one is specified.
+      //
+      queryString = "SELECT ";
+      queryStringAsStream <<
+         GetJunctionTableDefinitionThisPrimaryKeyColumn(junctionTable) << ", " <<
+         GetJunctionTableDefinitionOtherPrimaryKeyColumn(junctionTable) <<
+         " FROM " << junctionTable.tableName;
+      if (onlyPrimaryKey) {
+         queryStringAsStream << " WHERE " << GetJunctionTableDefinitionThisPrimaryKeyColumn(junctionTable) << " = :id";
+      }
+      queryStringAsStream <<
+         " ORDER BY " << GetJunctionTableDefinitionThisPrimaryKeyColumn(junctionTable) << ", ";
+      if (!GetJunctionTableDefinitionOrderByColumn(junctionTable).isNull()) {
+         queryStringAsStream << GetJunctionTableDefinitionOrderByColumn(junctionTable);
+      } else {
+         queryStringAsStream << GetJunctionTableDefinitionOtherPrimaryKeyColumn(junctionTable);
+      }
+      queryStringAsStream << ";";
+
+      sqlQuery = BtSqlQuery{connection};
+      sqlQuery.setForwardOnly(true);
+      sqlQuery.prepare(queryString);
+      if (onlyPrimaryKey) {
+         sqlQuery.bindValue(":id", *onlyPrimaryKey);
+      }
+      if (!sqlQuery.exec()) {
+         qCCritical(Logging::database) <<
+            Q_FUNC_INFO << "Error executing database query " << queryString << ": " << sqlQuery.lastError().text();
+         return false;
+      }
+
+      qCDebug(Logging::database) << Q_FUNC_INFO << "Reading junction table rows from database query " << queryString;
+
+      //
+      // The simplest way to process the data is first to build the ID-to-ordered-list-of-IDs map in memory, then loop
+      // through this to pass the data to the relevant objects.
+      //
+      int previousPrimaryKey = -1;
+      QMap< int, QVector<int> > thisToOtherKeys;
+      while (sqlQuery.next()) {
+         int thisPrimaryKey = sqlQuery.value(*GetJunctionTableDefinitionThisPrimaryKeyColumn(junctionTable)).toInt();
+         int otherPrimaryKey = sqlQuery.value(*GetJunctionTableDefinitionOtherPrimaryKeyColumn(junctionTable)).toInt();
+         // Usually keep the next line commented out otherwise it generates a lot of lines in the logs
+//         qDebug() << Q_FUNC_INFO << "Interim store of" << thisPrimaryKey << "<->" << otherPrimaryKey;
+
+         if (thisPrimaryKey != previousPrimaryKey) {
+            thisToOtherKeys.insert(thisPrimaryKey, QVector<int>{});
+            previousPrimaryKey = thisPrimaryKey;
+         }
+         Q_ASSERT(thisToOtherKeys.contains(thisPrimaryKey));
+         thisToOtherKeys[thisPrimaryKey].append(otherPrimaryKey);
+      }
+
+      loadedRows.junctionRows.append(thisToOtherKeys);
+   }
+
+   dbTransaction.commit();
+   return true;
+}
+
+void ObjectStore::impl::appendDecodedRow(ObjectStore::impl::LoadedRows & loadedRows, QVector<QVariant> & rowValues) {
+   QVector<ColumnDecoder> const & rowDecoder = this->getRowDecoder();
+   // Normally we get a value for every column, but readAllRows stops early if it could not read a column
+   Q_ASSERT(rowValues.size() <= rowDecoder.size());
+
+   NamedParameterBundle namedParameterBundle;
+   namedParameterBundle.reserve(static_cast<std::size_t>(rowValues.size()));
+
+   //
+   // By convention, the primary key should be listed as the first field
+   //
+   // NB: For now we're assuming that the primary key is always an integer, but it would not be enormous work to
+   //     allow a wider range of types.
+   //
+   int primaryKey = -1;
+   for (int columnIndex = 0; columnIndex < rowValues.size(); ++columnIndex) {
+      auto const & columnDecoder = rowDecoder[columnIndex];
+      auto const & fieldDefn = *columnDecoder.fieldDefn;
+      QVariant & fieldValue = rowValues[columnIndex];
+
+      if (fieldDefn.loading == ObjectStore::LOAD_LAZILY && !fieldValue.isValid()) {
+         // Not read yet (see readAllRows), which the object will recognise from the null string
+         namedParameterBundle.insert(fieldDefn.propertyName, QVariant::fromValue(QString{}));
+         continue;
+      }
+
+      // Text fields (origin, notes, etc) are often the same in many rows (eg child copies of an ingredient), so we
+      // only want to keep one copy of each
+      if (fieldDefn.fieldType == ObjectStore::FieldType::String && !fieldValue.isNull()) {
+         fieldValue = QVariant{StringPool::intern(fieldValue.toString())};
+      }
+
+      // Fix-up the QVariant if needed, including converting enum codes or strings to int
+      this->wrapAndUnmapAsNeeded(this->primaryTable, columnDecoder, fieldValue);
+
+      // It's a coding error if we got the same parameter twice
+      Q_ASSERT(!namedParameterBundle.contains(fieldDefn.propertyName));
+
+      namedParameterBundle.insert(fieldDefn.propertyName, fieldValue);
+
+      // We assert that the insert always works!
+      Q_ASSERT(namedParameterBundle.contains(fieldDefn.propertyName));
+
+      if (columnIndex == 0) {
+         primaryKey = fieldValue.toInt();
+      }
+   }
+
+   loadedRows.primaryRows.append(std::make_pair(primaryKey, std::move(namedParameterBundle)));
+   return;
+}
+
+bool ObjectStore::impl::setJunctionProperty(QObject & object,
+                                            int const id,
+                                            ObjectStore::JunctionTableDefinition const & junctionTable,
+                                            QVector<int> const & otherKeys) {
+   // We assert that we could not have created a mapping without at least one entry
+   Q_ASSERT(otherKeys.size() > 0);
+
+   //
+   // Normally we'd pass a list of all the "other" keys for each "this" object, but if we've been told to assume
+   // there is at most one "other" per "this", then we'll pass just the first one we get back for each "this".
+   //
+   bool success = false;
+   if (junctionTable.assumedNumEntries == ObjectStore::MAX_ONE_ENTRY) {
+      qCDebug(Logging::database) <<
+         Q_FUNC_INFO << object.metaObject()->className() << " #" << id << ", " <<
+         GetJunctionTableDefinitionPropertyName(junctionTable) << "=" << otherKeys.first();
+      success = object.setProperty(*GetJunctionTableDefinitionPropertyName(junctionTable), otherKeys.first());
+   } else {
+      //
+      // The setProperty function always takes a QVariant, so we need to create one from the QList<QVariant> we
+      // have.  However, we need to be careful here.  There are several ways to get the call to setProperty wrong
+      // at runtime, which gives you a "false" return code but no diagnostics or log of why the call failed.
+      //
+      // In particular, we can't just shove a QList<QVariant> (ie otherKeys) inside a QVariant, because passing
+      // this to setProperty() (or equivalent calls via the metaObject) will cause Qt to attempt (and fail) to
+      // access a setter that takes QList<QVariant>.  We need a QVector<int> (ie what the setter expects) wrapped
+      // in a QVariant.
+      //
+      // To add to the challenge, despite QVariant having a huge number of constructors, none of them will accept
+      // QVector<int>, so, instead, you have to use the static function QVariant::fromValue to create a QVariant
+      // wrapper around QVector<int>.
+      //
+      QVariant wrappedConvertedOtherKeys = QVariant::fromValue(otherKeys);
+      qCDebug(Logging::database) <<
+         Q_FUNC_INFO << object.metaObject()->className() << " #" << id << ", " <<
+         GetJunctionTableDefinitionPropertyName(junctionTable) << "=" << otherKeys << "(" <<
+         wrappedConvertedOtherKeys << ")";
+      success = object.setProperty(*GetJunctionTableDefinitionPropertyName(junctionTable), wrappedConvertedOtherKeys);
+   }
+   if (!success) {
+      // This is a coding error - eg the property doesn't have a WRITE member function or it doesn't take the
+      // type of argument we supplied inside a QVariant.
+      qCCritical(Logging::database) <<
+         Q_FUNC_INFO << "Unable to set property" << GetJunctionTableDefinitionPropertyName(junctionTable) <<
+         "on" << object.metaObject()->className();
+      Q_ASSERT(false); // Stop here on a debug build
+   }
+   return success;
+}
+
+bool ObjectStore::flushPendingPropertyUpdates() {
+   QHash<Database *, QHash<QueuedColumnUpdateKey, QueuedColumnUpdate>> updatesToWrite;
+   {
+      QMutexLocker locker(&queuedColumnUpdatesMutex);
+      updatesToWrite.swap(queuedColumnUpdates);
+      flushOfQueuedColumnUpdatesScheduled = false;
+   }
+
+   bool succeeded = true;
+   for (auto databaseUpdates = updatesToWrite.cbegin(); databaseUpdates != updatesToWrite.cend(); ++databaseUpdates) {
+      Database & database = *databaseUpdates.key();
+      QSqlDatabase connection = database.sqlDatabase();
+      DbTransaction dbTransaction{
+         database,
+         connection,
+         QString("Write %1 queued property updates").arg(databaseUpdates.value().size())
+      };
+      //
+      // If one update fails, we still want to write all the others, so we carry on and commit what we can.  (The error
+      // will have been logged by updateColumnInDb.)
+      //
+      for (auto const & update : databaseUpdates.value()) {
+         if (!updateColumnInDb(connection,
+                               *update.tableDefinition,
+                               *update.fieldDefn,
+                               update.primaryKey,
+                               update.value)) {
+            succeeded = false;
+         }
+      }
+      dbTransaction.commit();
+   }
+   return succeeded;
+}
+
+void ObjectStore::clearPreparedStatementCache(QString const & connectionName) {
+   ChangeLog::clearPreparedStatementCache(connectionName);
+   QMutexLocker locker(&preparedUpdateQueriesMutex);
+   if (connectionName.isEmpty()) {
+      qCDebug(Logging::database) <<
+         Q_FUNC_INFO << "Discarding" << preparedUpdateQueries.size() << "prepared UPDATE queries";
+      preparedUpdateQueries.clear();
+      return;
+   }
+   for (auto ii = preparedUpdateQueries.begin(); ii != preparedUpdateQueries.end(); ) {
+      if (ii.key().first == connectionName) {
+         ii = preparedUpdateQueries.erase(ii);
+      } else {
+         ++ii;
+      }
+   }
+   return;
+}
+
+bool ObjectStore::prefetchAll(Database * database) {
+   // It's a coding error to call this once we've loaded, or to call it twice
+   if (this->pimpl->m_state != ObjectStore::State::NotYetInitialised || this->pimpl->prefetchedRows) {
+      qCCritical(Logging::database) << Q_FUNC_INFO << this->pimpl->m_className << "already loaded or prefetched";
+      Q_ASSERT(false);
+      return false;
+   }
+
+   //
+   // NB: We deliberately don't touch this->pimpl->database here.  It gets set (on the calling thread) in loadAll().
+   //     All we're doing is reading the tables on whatever connection is right for the current thread.
+   //
+   Database & db = database ? *database : Database::instance();
+   QSqlDatabase connection = db.sqlDatabaseForReading();
+
+   QElapsedTimer timer;
+   timer.start();
+   ObjectStore::impl::LoadedRows loadedRows;
+   if (!this->pimpl->readAllRows(db, connection, loadedRows)) {
+      // loadAll() will try again on the main thread, so there is no need to set an error state here
+      qCWarning(Logging::database) << Q_FUNC_INFO << "Unable to prefetch" << this->pimpl->primaryTable.tableName;
+      return false;
+   }
+
+   qCInfo(Logging::database) <<
+      Q_FUNC_INFO << "Prefetched" << loadedRows.primaryRows.size() << "rows from DB table" <<
+      this->pimpl->primaryTable.tableName << "in" << timer.elapsed() << "ms";
+   this->pimpl->prefetchedRows = std::move(loadedRows);
+   return true;
+}
+
+bool ObjectStore::writeSnapshot(QDataStream & stream, Database * database) const {
+   Database & db = database ? *database : Database::instance();
+   QSqlDatabase connection = db.sqlDatabase();
+
+   //
+   // We store the column values exactly as the DB driver gave them to us (which are all things like integers, doubles
+   // and strings that QDataStream knows how to write) rather than the decoded constructor parameters (some of which
+   // are our own types).  Reading the snapshot back then goes through exactly the same decoding as reading the DB.
+   //
+   ObjectStore::impl::LoadedRows loadedRows;
+   QVector<QVector<QVariant> > rawPrimaryRows;
+   if (!this->pimpl->readAllRows(db, connection, loadedRows, std::nullopt, &rawPrimaryRows)) {
+      qCWarning(Logging::database) <<
+         Q_FUNC_INFO << "Unable to read" << this->pimpl->primaryTable.tableName << "for start-up snapshot";
+      return false;
+   }
+
+   stream << this->pimpl->primaryColumnNames() << rawPrimaryRows << loadedRows.junctionRows;
+   return stream.status() == QDataStream::Ok;
+}
+
+bool ObjectStore::readSnapshot(QDataStream & stream) {
+   // Same preconditions as prefetchAll
+   if (this->pimpl->m_state != ObjectStore::State::NotYetInitialised || this->pimpl->prefetchedRows) {
+      qCCritical(Logging::database) << Q_FUNC_INFO << this->pimpl->m_className << "already loaded or prefetched";
+      Q_ASSERT(false);
+      return false;
+   }
+
+   QStringList columnNames;
+   QVector<QVector<QVariant> > rawPrimaryRows;
+   ObjectStore::impl::LoadedRows loadedRows;
+   stream >> columnNames >> rawPrimaryRows >> loadedRows.junctionRows;
+   if (stream.status() != QDataStream::Ok) {
+      qCWarning(Logging::database) <<
+         Q_FUNC_INFO << "Unable to read start-up snapshot of" << this->pimpl->primaryTable.tableName;
+      return false;
+   }
+
+   //
+   // The snapshot is only written by a build that passed the same checks, but it does no harm to make sure it still
+   // matches what we are expecting before we use it.
+   //
+   int const numColumns = this->pimpl->primaryTable.tableFields.size();
+   if (columnNames != this->pimpl->primaryColumnNames() ||
+       loadedRows.junctionRows.size() != this->pimpl->junctionTables.size()) {
+      qCInfo(Logging::database) <<
+         Q_FUNC_INFO << "Start-up snapshot of" << this->pimpl->primaryTable.tableName << "does not match schema";
+      return false;
+   }
+
+   loadedRows.primaryRows.reserve(rawPrimaryRows.size());
+   for (auto & rowValues : rawPrimaryRows) {
+      if (rowValues.size() != numColumns) {
+         qCWarning(Logging::database) <<
+            Q_FUNC_INFO << "Start-up snapshot of" << this->pimpl->primaryTable.tableName << "has a row with" <<
+            rowValues.size() << "columns instead of" << numColumns;
+         return false;
+      }
+      this->pimpl->appendDecodedRow(loadedRows, rowValues);
+   }
+
+   this->pimpl->prefetchedRows = std::move(loadedRows);
+   return true;
+}
+
+void ObjectStore::loadAll(Database * database) {
+   Tracing::Span span{"ObjectStore::loadAll"};
+   // Assume we failed until we succeed!  (This saves us having to remember to set the error state in every error
+   // branch.  Instead, we just have to set the all OK state at the end of this function.)
+   this->pimpl->m_state = ObjectStore::State::ErrorInitialising;
+
+   if (database) {
+      this->pimpl->database = database;
+   } else {
+      this->pimpl->database = &Database::instance();
+   }
+
+   QElapsedTimer timer;
+   timer.start();
+
+   //
+   // If prefetchAll() was called (typically on a worker thread at start-up) then the DB has already been read, and
+   // all we have to do here is create the objects.  Otherwise we read the tables now.
+   //
+   ObjectStore::impl::LoadedRows loadedRows;
+   if (this->pimpl->prefetchedRows) {
+      loadedRows = std::move(*this->pimpl->prefetchedRows);
+      this->pimpl->prefetchedRows.reset();
+   } else {
+      QSqlDatabase connection = this->pimpl->database->sqlDatabaseForReading();
+      if (!this->pimpl->readAllRows(*this->pimpl->database, connection, loadedRows)) {
+         return;
+      }
+   }
+
+   bool const lazy = PersistentSettings::value(PersistentSettings::Names::lazyObjectLoading, false).toBool();
+
+   if (lazy) {
+      //
+      // In lazy mode, we just hang on to the rows and only create each object the first time someone asks for it (see
+      // ObjectStore::hydrate()).  The indexes still need to cover everything, so we build them from the raw data.
+      //
+      for (auto & [primaryKey, namedParameterBundle] : loadedRows.primaryRows) {
+         Q_ASSERT(!this->pimpl->pendingObjects.contains(primaryKey));
+         this->pimpl->pendingObjects.insert(primaryKey, ObjectStore::impl::PendingObject{namedParameterBundle, {}});
+      }
+   } else {
+      for (auto & [primaryKey, namedParameterBundle] : loadedRows.primaryRows) {
+         // Get a new object...
+         auto object = this->createNewObject(namedParameterBundle);
+
+         // ...and store it
+         // It's a coding error if we have two objects with the same primary key
+         Q_ASSERT(!this->pimpl->allObjects.contains(primaryKey));
+         this->pimpl->allObjects.insert(primaryKey, object);
+         // Normally leave this debug output commented, as it generates a lot of logging at start-up, but can be useful
+         // to enable for debugging.
+//         qDebug() <<
+//            Q_FUNC_INFO << "Cached" << object->metaObject()->className() << "#" << primaryKey << "in" <<
+//            this->metaObject()->className();
+      }
+   }
+
+   qCDebug(Logging::database) <<
+      Q_FUNC_INFO << "Read" << loadedRows.primaryRows.size() << "entries from primary table" <<
+      this->pimpl->primaryTable.tableName << (lazy ? "(lazy mode)" : "");
+
+   //
+   // Now pass the junction table data to the relevant objects (or, in lazy mode, stash it with the pending rows)
+   //
+   Q_ASSERT(loadedRows.junctionRows.size() == this->pimpl->junctionTables.size());
+   for (int jj = 0; jj < this->pimpl->junctionTables.size(); ++jj) {
+      auto const & junctionTable = this->pimpl->junctionTables[jj];
+      auto const & thisToOtherKeys = loadedRows.junctionRows[jj];
+      for (auto currentMapping = thisToOtherKeys.cbegin();
+           currentMapping != thisToOtherKeys.cend();
+           ++currentMapping) {
+         //
+         // It's probably a coding error somewhere if there's an associative entry for an object that doesn't exist,
+         // but we can recover by ignoring the associative entry
+         //
+         if (!this->contains(currentMapping.key())) {
+            qCCritical(Logging::database) <<
+               Q_FUNC_INFO << "Ignoring record in table " << junctionTable.tableName <<
+               " for non-existent object with primary key " << currentMapping.key();
+            continue;
+         }
+
+         if (lazy) {
+            this->pimpl->pendingObjects[currentMapping.key()].junctionValues.append(
+               std::make_pair(jj, currentMapping.value())
+            );
+            continue;
+         }
+
+         auto currentObject = this->getById(currentMapping.key());
+         if (!this->pimpl->setJunctionProperty(*currentObject,
+                                               currentMapping.key(),
+                                               junctionTable,
+                                               currentMapping.value())) {
+            // Continue but leave the store in error state on a non-debug build
+            return;
+         }
+
+         // This is useful for debugging but I usually leave it commented out as it generates a lot of logging at
+         // start-up
+//         qDebug() <<
+//            Q_FUNC_INFO << "Set" <<
+//            (junctionTable.assumedNumEntries == ObjectStore::MAX_ONE_ENTRY ? 1 : otherKeys.size()) <<
+//            GetJunctionTableDefinitionPropertyName(junctionTable).c_str() << "property for" <<
+//            currentObject->metaObject()->className() << "#" << currentKey;
+
+      }
+   }
+
+   //
+   // Now that all properties (including those from junction tables) are set, we can build the indexes
+   //
+   for (auto ii = this->pimpl->allObjects.cbegin(); ii != this->pimpl->allObjects.cend(); ++ii) {
+      this->pimpl->indexObject(ii.key(), *ii.value());
+   }
+   for (auto ii = this->pimpl->pendingObjects.cbegin(); ii != this->pimpl->pendingObjects.cend(); ++ii) {
+      this->pimpl->indexPendingObject(ii.key(), ii.value());
+   }
+
+   qCInfo(Logging::database) <<
+      Q_FUNC_INFO << "Read" << this->size() << "objects from DB table" << this->pimpl->primaryTable.tableName <<
+      "in" << timer.elapsed() << "ms";
+
+   // If we made it this far, everything must have loaded in OK (otherwise we'd have bailed out above).
+   this->pimpl->m_state = ObjectStore::State::InitialisedOk;
+
+   return;
+}
+
+void ObjectStore::hydrate(int id) const {
+   if (!this->pimpl->pendingObjects.contains(id)) {
+      return;
+   }
+
+   // Take the data out of pendingObjects first, so we can't go round in circles if creating the object somehow results
+   // in it being asked for again
+   ObjectStore::impl::PendingObject pendingObject = this->pimpl->pendingObjects.take(id);
+
+   //
+   // Conceptually, the object is already in the store and we're just instantiating it, so it's OK to do this from a
+   // const member function.  But createNewObject() is not const, hence the cast.
+   //
+   auto object = const_cast<ObjectStore *>(this)->createNewObject(pendingObject.namedParameterBundle);
+   this->pimpl->allObjects.insert(id, object);
+   for (auto const & [junctionTableIndex, otherKeys] : pendingObject.junctionValues) {
+      // Any error will have been logged, and there's not much else we can do about it here
+      this->pimpl->setJunctionProperty(*object, id, this->pimpl->junctionTables[junctionTableIndex], otherKeys);
+   }
+   this->pimpl->indexObject(id, *object);
+   return;
+}
+
+void ObjectStore::refreshFromDb(QSet<int> const & ids) {
+   if (this->pimpl->m_state != ObjectStore::State::InitialisedOk) {
+      // If we haven't loaded yet, then the changes will get picked up when we do
+      return;
+   }
+
+   // NB: Not sqlDatabaseForReading(), as a replica might not yet have the change we've been told about
+   QSqlDatabase connection = this->pimpl->database->sqlDatabase();
+   for (int const id : ids) {
+      this->pimpl->forgetLazyText(id);
+      ObjectStore::impl::LoadedRows loadedRows;
+      if (!this->pimpl->readAllRows(*this->pimpl->database, connection, loadedRows, id)) {
+         // Error will already have been logged
+         continue;
+      }
+      Q_ASSERT(loadedRows.primaryRows.size() <= 1);
+      Q_ASSERT(loadedRows.junctionRows.size() == this->pimpl->junctionTables.size());
+
+      //
+      // Case 1: The row has gone, so (if we have it) remove the object from the cache, as defaultHardDelete would do
+      //
+      if (loadedRows.primaryRows.isEmpty()) {
+         if (this->contains(id)) {
+            qCDebug(Logging::database) <<
+               Q_FUNC_INFO << this->pimpl->m_className << "#" << id << "was deleted in the DB";
+            this->hydrate(id);
+            auto object = this->pimpl->allObjects.take(id);
+            this->pimpl->unindexObject(id);
+            this->emitObjectDeleted(id, object);
+         }
+         continue;
+      }
+
+      auto & namedParameterBundle = loadedRows.primaryRows.first().second;
+
+      //
+      // Case 2: If we have the row's data but haven't yet created the object, then we just replace the data
+      //
+      if (this->pimpl->pendingObjects.contains(id)) {
+         ObjectStore::impl::PendingObject pendingObject{namedParameterBundle, {}};
+         for (int jj = 0; jj < this->pimpl->junctionTables.size(); ++jj) {
+            if (loadedRows.junctionRows[jj].contains(id)) {
+               pendingObject.junctionValues.append(std::make_pair(jj, loadedRows.junctionRows[jj].value(id)));
+            }
+         }
+         this->pimpl->unindexObject(id);
+         this->pimpl->indexPendingObject(id, pendingObject);
+         this->pimpl->pendingObjects.insert(id, pendingObject);
+         continue;
+      }
+
+      //
+      // Case 3: New row, so create the object, as loadAll would do
+      //
+      if (!this->pimpl->allObjects.contains(id)) {
+         qCDebug(Logging::database) << Q_FUNC_INFO << this->pimpl->m_className << "#" << id << "was inserted in the DB";
+         auto object = this->createNewObject(namedParameterBundle);
+         this->pimpl->allObjects.insert(id, object);
+         for (int jj = 0; jj < this->pimpl->junctionTables.size(); ++jj) {
+            if (loadedRows.junctionRows[jj].contains(id)) {
+               this->pimpl->setJunctionProperty(*object,
+                                                id,
+                                                this->pimpl->junctionTables[jj],
+                                                loadedRows.junctionRows[jj].value(id));
+            }
+         }
+         this->pimpl->indexObject(id, *object);
+         this->emitObjectInserted(id);
+         continue;
+      }
+
+      //
+      // Case 4: Existing object, so update its properties.  Going through the setters means the object (and anything
+      // watching it) sees the change in the usual way, but we need to stop the setters writing the values we just read
+      // back to the DB.  (Setters generally only signal when the value actually changes, so it doesn't matter that we
+      // set every property.)
+      //
+      qCDebug(Logging::database) << Q_FUNC_INFO << this->pimpl->m_className << "#" << id << "was updated in the DB";
+      auto object = this->pimpl->allObjects.value(id);
+      this->pimpl->applyingChangesFromDb = true;
+      for (auto const & fieldDefn : this->pimpl->primaryTable.tableFields) {
+         if (fieldDefn.propertyName == this->pimpl->getPrimaryKeyProperty()) {
+            continue;
+         }
+         if (!object->setProperty(*fieldDefn.propertyName, namedParameterBundle.get(fieldDefn.propertyName))) {
+            qCWarning(Logging::database) <<
+               Q_FUNC_INFO << "Unable to set property" << fieldDefn.propertyName << "on" << this->pimpl->m_className <<
+               "#" << id;
+         }
+      }
+      for (int jj = 0; jj < this->pimpl->junctionTables.size(); ++jj) {
+         auto const & junctionTable = this->pimpl->junctionTables[jj];
+         if (loadedRows.junctionRows[jj].contains(id)) {
+            this->pimpl->setJunctionProperty(*object, id, junctionTable, loadedRows.junctionRows[jj].value(id));
+         } else if (junctionTable.assumedNumEntries != ObjectStore::MAX_ONE_ENTRY) {
+            // All the rows for this object were removed.  (There's no "nothing" value for a MAX_ONE_ENTRY property.)
+            object->setProperty(*GetJunctionTableDefinitionPropertyName(junctionTable),
+                                QVariant::fromValue(QVector<int>{}));
+         }
+      }
+      this->pimpl->applyingChangesFromDb = false;
+   }
 
-         // Fix-up the QVariant if needed, including converting enum string representation to int
-         this->pimpl->wrapAndUnmapAsNeeded(this->pimpl->primaryTable, fieldDefn, fieldValue);
-
-         // It's a coding error if we got the same parameter twice
-         Q_ASSERT(!namedParameterBundle.contains(fieldDefn.propertyName));
+   return;
+}
 
-         namedParameterBundle.insert(fieldDefn.propertyName, fieldValue);
+BtStringConst const & ObjectStore::primaryTableName() const {
+   return this->pimpl->primaryTable.tableName;
+}
 
-         // We assert that the insert always works!
-         Q_ASSERT(namedParameterBundle.contains(fieldDefn.propertyName));
+QVector<ObjectStore::TableField> const & ObjectStore::primaryTableFields() const {
+   return this->pimpl->primaryTable.tableFields;
+}
 
-         if (!readPrimaryKey) {
-            readPrimaryKey = true;
-            primaryKey = fieldValue.toInt();
+void ObjectStore::appendReferencingQueries(ObjectStore const & referencedStore,
+                                           QVector<BtStringConst const *> const & ownerProperties,
+                                           QStringList & subqueries) const {
+   TableDefinition const * const referencedTable = &referencedStore.pimpl->primaryTable;
+   auto const appendForTable = [&](TableDefinition const & tableDefinition, int const firstField) {
+      for (int ii = firstField; ii < tableDefinition.tableFields.size(); ++ii) {
+         auto const & fieldDefn = tableDefinition.tableFields[ii];
+         auto const foreignKeyTo = std::get_if<TableDefinition const *>(&fieldDefn.valueDecoder);
+         if (!foreignKeyTo || *foreignKeyTo != referencedTable ||
+             std::any_of(ownerProperties.cbegin(),
+                         ownerProperties.cend(),
+                         [&fieldDefn](BtStringConst const * ownerProperty) {
+                            return fieldDefn.propertyName == *ownerProperty;
+                         })) {
+            continue;
+         }
+         QString subquery{
+            QString{"SELECT %1 FROM %2 WHERE %1 IS NOT NULL"}.arg(*fieldDefn.columnName).arg(*tableDefinition.tableName)
+         };
+         if (&tableDefinition == referencedTable) {
+            // An object referring to itself (as, eg, a Recipe with no previous versions does) doesn't count
+            subquery += QString{" AND %1 <> %2"}.arg(*fieldDefn.columnName)
+                                                .arg(*tableDefinition.tableFields[0].columnName);
          }
+         subqueries.append(subquery);
       }
+      return;
+   };
+
+   appendForTable(this->pimpl->primaryTable, 0);
+   for (auto const & junctionTable : this->pimpl->junctionTables) {
+      //
+      // For our own junction tables, the "this" column (second field) is a reference to one of our objects, but it's
+      // not one that stops that object being hard deleted, because the rows get deleted along with the object.
+      //
+      appendForTable(junctionTable, this == &referencedStore ? 2 : 0);
+   }
+   return;
+}
 
-      // Get a new object...
-      auto object = this->createNewObject(namedParameterBundle);
+namespace {
+   /**
+    * \brief Write the FROM and WHERE clauses shared by \c ObjectStore::countPaged and \c ObjectStore::idsOfPage, and
+    *        append the values to bind to the latter's placeholders to \c bindValues
+    */
+   void writePageQueryFromAndWhere(QTextStream & queryStringAsStream,
+                                   ObjectStore::TableDefinition const & primaryTable,
+                                   ObjectStore::PageQuery const & pageQuery,
+                                   QVariantList & bindValues) {
+      QStringList conditions;
+      // Same rule as TableModelBase::add for the in-memory catalogs
+      ObjectStore::TableField const * const deletedField =
+         primaryTable.fieldForProperty(PropertyNames::NamedEntity::deleted);
+      if (deletedField) {
+         conditions.append(QString{"%1 = ?"}.arg(*deletedField->columnName));
+         bindValues.append(false);
+      }
+      ObjectStore::TableField const * const displayField =
+         primaryTable.fieldForProperty(PropertyNames::NamedEntity::display);
+      if (displayField) {
+         conditions.append(QString{"%1 = ?"}.arg(*displayField->columnName));
+         bindValues.append(true);
+      }
+      ObjectStore::TableField const * const nameField = primaryTable.fieldForProperty(PropertyNames::NamedEntity::name);
+      if (nameField && !pageQuery.nameContains.isEmpty()) {
+         // Anything that LIKE would treat as a wildcard needs escaping
+         QString pattern = pageQuery.nameContains.toLower();
+         pattern.replace("\\", "\\\\").replace("%", "\\%").replace("_", "\\_");
+         conditions.append(QString{"LOWER(%1) LIKE ? ESCAPE '\\'"}.arg(*nameField->columnName));
+         bindValues.append("%" + pattern + "%");
+      }
 
-      // ...and store it
-      // It's a coding error if we have two objects with the same primary key
-      Q_ASSERT(!this->pimpl->allObjects.contains(primaryKey));
-      this->pimpl->allObjects.insert(primaryKey, object);
-      // Normally leave this debug output commented, as it generates a lot of logging at start-up, but can be useful to
-      // enable for debugging.
-//      qDebug() <<
-//         Q_FUNC_INFO << "Cached" << object->metaObject()->className() << "#" << primaryKey << "in" <<
-//         this->metaObject()->className();
+      queryStringAsStream << " FROM " << primaryTable.tableName;
+      if (!conditions.isEmpty()) {
+         queryStringAsStream << " WHERE " << conditions.join(" AND ");
+      }
+      return;
    }
+}
 
-   qDebug() <<
-      Q_FUNC_INFO << "Read" << this->pimpl->allObjects.size() << "entries from primary table" <<
-      this->pimpl->primaryTable.tableName;
+int ObjectStore::countPaged(ObjectStore::PageQuery const & pageQuery) const {
+   // The DB needs to be up-to-date for the count to be right
+   ObjectStore::flushPendingPropertyUpdates();
 
-   //
-   // Now we load the data from the junction tables.  This, pretty much by definition, isn't needed for the object's
-   // constructor, so we're OK to pull it out separately.  Otherwise we'd have to do a LEFT JOIN for each junction
-   // table in the query above.  Since we're caching everything in memory, and we're not overly worried about
-   // optimising every single SQL query (because the amount of data in the DB is not enormous), we prefer the
-   // simplicity of separate queries.
-   //
-   for (auto const & junctionTable : this->pimpl->junctionTables) {
-      qDebug() <<
-         Q_FUNC_INFO << "Reading junction table " << junctionTable.tableName << " into " <<
-         GetJunctionTableDefinitionPropertyName(junctionTable);
+   QString queryString;
+   QTextStream queryStringAsStream{&queryString};
+   QVariantList bindValues;
+   queryStringAsStream << "SELECT COUNT(*)";
+   writePageQueryFromAndWhere(queryStringAsStream, this->pimpl->primaryTable, pageQuery, bindValues);
+   queryStringAsStream << ";";
 
-      //
-      // Order first by the object we're adding the other IDs to, then order either by the other IDs or by another
-      // column if one is specified.
-      //
-      queryString = "SELECT ";
-      queryStringAsStream <<
-         GetJunctionTableDefinitionThisPrimaryKeyColumn(junctionTable) << ", " <<
-         GetJunctionTableDefinitionOtherPrimaryKeyColumn(junctionTable) <<
-         " FROM " << junctionTable.tableName <<
-         " ORDER BY " << GetJunctionTableDefinitionThisPrimaryKeyColumn(junctionTable) << ", ";
-      if (!GetJunctionTableDefinitionOrderByColumn(junctionTable).isNull()) {
-         queryStringAsStream << GetJunctionTableDefinitionOrderByColumn(junctionTable);
+   // NB: Not sqlDatabaseForReading(), as a replica might not yet have the updates we just flushed
+   QSqlDatabase connection = this->pimpl->database->sqlDatabase();
+   BtSqlQuery sqlQuery{connection};
+   sqlQuery.prepare(queryString);
+   for (QVariant const & bindValue : bindValues) {
+      sqlQuery.addBindValue(bindValue);
+   }
+   if (!sqlQuery.exec() || !sqlQuery.next()) {
+      qCCritical(Logging::database) <<
+         Q_FUNC_INFO << "Error executing database query " << queryString << ": " << sqlQuery.lastError().text();
+      return -1;
+   }
+   return sqlQuery.value(0).toInt();
+}
+
+QVector<int> ObjectStore::idsOfPage(ObjectStore::PageQuery const & pageQuery,
+                                    int const offset,
+                                    int const limit) const {
+   Tracing::Span span{"ObjectStore::idsOfPage"};
+   // As in countPaged, the DB needs to be up-to-date
+   ObjectStore::flushPendingPropertyUpdates();
+
+   TableField const * sortField =
+      pageQuery.sortProperty ? this->pimpl->primaryTable.fieldForProperty(*pageQuery.sortProperty) : nullptr;
+   if (!sortField) {
+      sortField = this->pimpl->primaryTable.fieldForProperty(PropertyNames::NamedEntity::name);
+   }
+
+   QString queryString;
+   QTextStream queryStringAsStream{&queryString};
+   QVariantList bindValues;
+   BtStringConst const & primaryKeyColumn = this->pimpl->getPrimaryKeyColumn();
+   char const * const direction = pageQuery.ascending ? " ASC" : " DESC";
+   queryStringAsStream << "SELECT " << primaryKeyColumn;
+   writePageQueryFromAndWhere(queryStringAsStream, this->pimpl->primaryTable, pageQuery, bindValues);
+   queryStringAsStream << " ORDER BY ";
+   if (sortField) {
+      // Users expect names etc to sort the same way regardless of case
+      if (sortField->fieldType == ObjectStore::FieldType::String) {
+         queryStringAsStream << "LOWER(" << sortField->columnName << ")" << direction << ", ";
+      } else if (sortField->isStoredAsCode()) {
+         // Codes are in no particular order, so we sort by the strings they stand for, as we did before we had codes
+         queryStringAsStream <<
+            EnumCodes::valueExpression(this->pimpl->primaryTable.tableName, *sortField) << direction << ", ";
       } else {
-         queryStringAsStream << GetJunctionTableDefinitionOtherPrimaryKeyColumn(junctionTable);
+         queryStringAsStream << sortField->columnName << direction << ", ";
       }
-      queryStringAsStream << ";";
+   }
+   queryStringAsStream << primaryKeyColumn << direction << " LIMIT ? OFFSET ?;";
+   bindValues.append(limit);
+   bindValues.append(offset);
 
-      sqlQuery = BtSqlQuery{connection};
-      sqlQuery.prepare(queryString);
-      if (!sqlQuery.exec()) {
-         qCritical() <<
-            Q_FUNC_INFO << "Error executing database query " << queryString << ": " << sqlQuery.lastError().text();
-         return;
+   QSqlDatabase connection = this->pimpl->database->sqlDatabase();
+   BtSqlQuery sqlQuery{connection};
+   sqlQuery.prepare(queryString);
+   for (QVariant const & bindValue : bindValues) {
+      sqlQuery.addBindValue(bindValue);
+   }
+   QVector<int> ids;
+   if (!sqlQuery.exec()) {
+      qCCritical(Logging::database) <<
+         Q_FUNC_INFO << "Error executing database query " << queryString << ": " << sqlQuery.lastError().text();
+      return ids;
+   }
+   while (sqlQuery.next()) {
+      ids.append(sqlQuery.value(0).toInt());
+   }
+   return ids;
+}
+
+QString ObjectStore::lazyTextValue(int const id, BtStringConst const & propertyName) const {
+   TableField const * fieldDefn = this->pimpl->primaryTable.fieldForProperty(propertyName);
+   if (!fieldDefn || fieldDefn->loading != ObjectStore::LOAD_LAZILY) {
+      // This is a coding error
+      qCCritical(Logging::database) <<
+         Q_FUNC_INFO << propertyName << "is not a lazily-loaded field of" << this->pimpl->m_className;
+      Q_ASSERT(false);
+      return QString{};
+   }
+
+   auto const cacheKey = qMakePair(id, fieldDefn);
+   {
+      QMutexLocker locker(&this->pimpl->lazyTextCacheMutex);
+      if (QString const * cachedValue = this->pimpl->lazyTextCache.object(cacheKey)) {
+         return *cachedValue;
       }
+   }
 
-      qDebug() << Q_FUNC_INFO << "Reading junction table rows from database query " << queryString;
+   //
+   // We don't hold the lock while we query the DB, so that lookups on other threads aren't held up.  Each thread has
+   // its own DB connection, so, at worst, two threads both read the same value and both cache it.
+   //
+   QString queryString;
+   QTextStream queryStringAsStream{&queryString};
+   queryStringAsStream <<
+      "SELECT " << fieldDefn->columnName << " FROM " << this->pimpl->primaryTable.tableName <<
+      " WHERE " << this->pimpl->getPrimaryKeyColumn() << " = ?;";
+   // NB: Not sqlDatabaseForReading(), as a replica might not have the latest value
+   QSqlDatabase connection = this->pimpl->database->sqlDatabase();
+   BtSqlQuery sqlQuery{connection};
+   sqlQuery.prepare(queryString);
+   sqlQuery.addBindValue(id);
+   if (!sqlQuery.exec()) {
+      qCCritical(Logging::database) <<
+         Q_FUNC_INFO << "Error executing database query " << queryString << ": " << sqlQuery.lastError().text();
+      return QString{};
+   }
+   // It's not an error if there's no row, as the object might have been deleted
+   QString value{""};
+   if (sqlQuery.next() && !sqlQuery.value(0).isNull()) {
+      value = sqlQuery.value(0).toString();
+   }
+   QMutexLocker locker(&this->pimpl->lazyTextCacheMutex);
+   this->pimpl->lazyTextCache.insert(cacheKey, new QString{value}, std::max(1, static_cast<int>(value.size())));
+   return value;
+}
 
-      //
-      // The simplest way to process the data is first to build the ID-to-ordered-list-of-IDs map in memory, then loop
-      // through this to pass the data to the relevant objects.
-      //
-      int previousPrimaryKey = -1;
-      QMap< int, QVector<int> > thisToOtherKeys;
-      while (sqlQuery.next()) {
-         int thisPrimaryKey = sqlQuery.value(*GetJunctionTableDefinitionThisPrimaryKeyColumn(junctionTable)).toInt();
-         int otherPrimaryKey = sqlQuery.value(*GetJunctionTableDefinitionOtherPrimaryKeyColumn(junctionTable)).toInt();
-         // Usually keep the next line commented out otherwise it generates a lot of lines in the logs
-//         qDebug() << Q_FUNC_INFO << "Interim store of" << thisPrimaryKey << "<->" << otherPrimaryKey;
+int ObjectStore::purgeSoftDeleted(QStringList const & referencingQueries) {
+   TableField const * const deletedField =
+      this->pimpl->primaryTable.fieldForProperty(PropertyNames::NamedEntity::deleted);
+   if (!deletedField) {
+      // Objects in this store don't get soft deleted
+      return 0;
+   }
 
-         if (thisPrimaryKey != previousPrimaryKey) {
-            thisToOtherKeys.insert(thisPrimaryKey, QVector<int>{});
-            previousPrimaryKey = thisPrimaryKey;
-         }
-         Q_ASSERT(thisToOtherKeys.contains(thisPrimaryKey));
-         thisToOtherKeys[thisPrimaryKey].append(otherPrimaryKey);
-      }
+   QString queryString;
+   QTextStream queryStringAsStream{&queryString};
+   BtStringConst const & primaryKeyColumn = this->pimpl->getPrimaryKeyColumn();
+   queryStringAsStream <<
+      "SELECT " << primaryKeyColumn << " FROM " << this->pimpl->primaryTable.tableName <<
+      " WHERE " << deletedField->columnName << " = :deleted";
+   for (QString const & referencingQuery : referencingQueries) {
+      queryStringAsStream << "\n AND " << primaryKeyColumn << " NOT IN (" << referencingQuery << ")";
+   }
+   queryStringAsStream << ";";
 
-      for (auto currentMapping = thisToOtherKeys.cbegin();
-           currentMapping != thisToOtherKeys.cend();
-           ++currentMapping) {
-         //
-         // It's probably a coding error somewhere if there's an associative entry for an object that doesn't exist,
-         // but we can recover by ignoring the associative entry
-         //
-         if (!this->contains(currentMapping.key())) {
-            qCritical() <<
-               Q_FUNC_INFO << "Ignoring record in table " << junctionTable.tableName <<
-               " for non-existent object with primary key " << currentMapping.key();
-            continue;
-         }
+   QSqlDatabase connection = this->pimpl->database->sqlDatabase();
+   BtSqlQuery sqlQuery{connection};
+   sqlQuery.prepare(queryString);
+   sqlQuery.bindValue(":deleted", true);
+   if (!sqlQuery.exec()) {
+      qCCritical(Logging::database) <<
+         Q_FUNC_INFO << "Error executing database query " << queryString << ": " << sqlQuery.lastError().text();
+      return 0;
+   }
+   QVector<int> idsToDelete;
+   while (sqlQuery.next()) {
+      idsToDelete.append(sqlQuery.value(0).toInt());
+   }
 
-         auto currentObject = this->getById(currentMapping.key());
+   int numDeleted = 0;
+   for (int const id : idsToDelete) {
+      // Deleting one object can delete others (that it owns), so we need to check each one is still there
+      if (this->contains(id)) {
+         this->hardDeleteObject(id);
+         ++numDeleted;
+      }
+   }
+   if (numDeleted > 0) {
+      qCInfo(Logging::database) <<
+         Q_FUNC_INFO << "Purged" << numDeleted << "soft-deleted" << this->pimpl->m_className << "objects";
+   }
+   return numDeleted;
+}
 
-         // We assert that we could not have created a mapping without at least one entry
-         Q_ASSERT(currentMapping.value().size() > 0);
+namespace {
+   //! Longest chain of parents we follow when looking for cycles
+   int constexpr maxParentChainLength = 64;
+}
 
-         //
-         // Normally we'd pass a list of all the "other" keys for each "this" object, but if we've been told to assume
-         // there is at most one "other" per "this", then we'll pass just the first one we get back for each "this".
-         //
-         bool success = false;
-         if (junctionTable.assumedNumEntries == ObjectStore::MAX_ONE_ENTRY) {
-            qDebug() <<
-               Q_FUNC_INFO << currentObject->metaObject()->className() << " #" << currentMapping.key() << ", " <<
-               GetJunctionTableDefinitionPropertyName(junctionTable) << "=" << currentMapping.value().first();
-            success = currentObject->setProperty(*GetJunctionTableDefinitionPropertyName(junctionTable),
-                                                 currentMapping.value().first());
-         } else {
-            //
-            // The setProperty function always takes a QVariant, so we need to create one from the QList<QVariant> we
-            // have.  However, we need to be careful here.  There are several ways to get the call to setProperty wrong
-            // at runtime, which gives you a "false" return code but no diagnostics or log of why the call failed.
-            //
-            // In particular, we can't just shove a QList<QVariant> (ie otherKeys) inside a QVariant, because passing
-            // this to setProperty() (or equivalent calls via the metaObject) will cause Qt to attempt (and fail) to
-            // access a setter that takes QList<QVariant>.  We need a QVector<int> (ie what the setter expects) wrapped
-            // in a QVariant.
-            //
-            // To add to the challenge, despite QVariant having a huge number of constructors, none of them will accept
-            // QVector<int>, so, instead, you have to use the static function QVariant::fromValue to create a QVariant
-            // wrapper around QVector<int>.
-            //
-            QVariant wrappedConvertedOtherKeys = QVariant::fromValue(currentMapping.value());
-            qDebug() <<
-               Q_FUNC_INFO << currentObject->metaObject()->className() << " #" << currentMapping.key() << ", " <<
-               GetJunctionTableDefinitionPropertyName(junctionTable) << "=" << currentMapping.value() << "(" <<
-               wrappedConvertedOtherKeys << ")";
-            success = currentObject->setProperty(*GetJunctionTableDefinitionPropertyName(junctionTable),
-                                                 wrappedConvertedOtherKeys);
-         }
-         if (!success) {
-            // This is a coding error - eg the property doesn't have a WRITE member function or it doesn't take the
-            // type of argument we supplied inside a QVariant.
-            qCritical() <<
-               Q_FUNC_INFO << "Unable to set property" << GetJunctionTableDefinitionPropertyName(junctionTable) <<
-               "on" << currentObject->metaObject()->className();
-            Q_ASSERT(false); // Stop here on a debug build
-            return;          // Continue but abort the transaction on a non-debug build
+QVector<ObjectStore::IntegrityCheck> ObjectStore::integrityChecks(
+   QVector<BtStringConst const *> const & ownerProperties
+) const {
+   QVector<IntegrityCheck> checks;
+
+   //
+   // Broken references.  NOT EXISTS is the portable way to write an anti-join, which both SQLite and PostgreSQL then
+   // do using the primary key index of the referenced table.  We alias the referenced table because it can be the
+   // same as the referencing one (eg for Recipe::ancestorId).
+   //
+   auto const appendBrokenReferences = [&](TableDefinition const & tableDefinition, bool const isJunctionTable) {
+      QString const tableName{*tableDefinition.tableName};
+      // In a junction table, the object a row belongs to is in the second column; otherwise it's the primary key
+      QString const idColumn{*tableDefinition.tableFields[isJunctionTable ? 1 : 0].columnName};
+      for (int ii = 1; ii < tableDefinition.tableFields.size(); ++ii) {
+         auto const & fieldDefn = tableDefinition.tableFields[ii];
+         auto const foreignKeyTo = std::get_if<TableDefinition const *>(&fieldDefn.valueDecoder);
+         if (!foreignKeyTo) {
+            continue;
          }
+         QString const column{*fieldDefn.columnName};
+         QString const referencedTableName{*(*foreignKeyTo)->tableName};
+         QString const condition{
+            QString{"%1 IS NOT NULL AND NOT EXISTS (SELECT 1 FROM %2 AS referenced WHERE referenced.%3 = %4.%1)"}.arg(
+               column, referencedTableName, *(*foreignKeyTo)->tableFields[0].columnName, tableName
+            )
+         };
+         bool const deleteRows = isJunctionTable ||
+                                 std::any_of(ownerProperties.cbegin(),
+                                             ownerProperties.cend(),
+                                             [&fieldDefn](BtStringConst const * ownerProperty) {
+                                                return fieldDefn.propertyName == *ownerProperty;
+                                             });
+         checks.append(
+            IntegrityCheck{
+               .description = QString{"%1.%2 refers to missing row(s) in %3"}.arg(tableName,
+                                                                                  column,
+                                                                                  referencedTableName),
+               .query       = QString{"SELECT DISTINCT %1 FROM %2 WHERE %3"}.arg(idColumn, tableName, condition),
+               .repair      = {
+                  deleteRows ? QString{"DELETE FROM %1 WHERE %2"}.arg(tableName, condition) :
+                               QString{"UPDATE %1 SET %2 = NULL WHERE %3"}.arg(tableName, column, condition)
+               },
+            }
+         );
+      }
+      return;
+   };
 
-         // This is useful for debugging but I usually leave it commented out as it generates a lot of logging at
-         // start-up
-//         qDebug() <<
-//            Q_FUNC_INFO << "Set" <<
-//            (junctionTable.assumedNumEntries == ObjectStore::MAX_ONE_ENTRY ? 1 : otherKeys.size()) <<
-//            GetJunctionTableDefinitionPropertyName(junctionTable).c_str() << "property for" <<
-//            currentObject->metaObject()->className() << "#" << currentKey;
+   appendBrokenReferences(this->pimpl->primaryTable, false);
+   for (auto const & junctionTable : this->pimpl->junctionTables) {
+      appendBrokenReferences(junctionTable, true);
+   }
 
+   //
+   // Parent-child links are in a junction table from the child's point of view (see JUNCTION_TABLES<Equipment> etc in
+   // ObjectStoreTyped.cpp), so the second column is the child and the third the parent.  The recursive query gives,
+   // for every child, each of its ancestors and how many generations up it is.
+   //
+   for (auto const & junctionTable : this->pimpl->junctionTables) {
+      auto const & fields = junctionTable.tableFields;
+      if (fields.size() < 3 || fields[2].propertyName != PropertyNames::NamedEntity::parentKey) {
+         continue;
       }
+      QString const tableName{*junctionTable.tableName};
+      QString const childColumn{*fields[1].columnName};
+      QString const parentColumn{*fields[2].columnName};
+      QString const ancestors{
+         QString{
+            "WITH RECURSIVE ancestors (child_id, ancestor_id, generation) AS ("
+            "SELECT %2, %3, 1 FROM %1 WHERE %3 IS NOT NULL "
+            "UNION ALL "
+            "SELECT ancestors.child_id, %1.%3, ancestors.generation + 1 FROM ancestors "
+            "JOIN %1 ON %1.%2 = ancestors.ancestor_id "
+            "WHERE %1.%3 IS NOT NULL AND ancestors.generation < %4) "
+         }.arg(tableName, childColumn, parentColumn).arg(maxParentChainLength)
+      };
+      QString const inCycle{ancestors + "SELECT DISTINCT child_id FROM ancestors WHERE ancestor_id = child_id"};
+      checks.append(
+         IntegrityCheck{
+            .description = QString{"%1 has cycle(s) of parents"}.arg(tableName),
+            .query       = inCycle,
+            .repair      = {QString{"DELETE FROM %1 WHERE %2 IN (%3)"}.arg(tableName, childColumn, inCycle)},
+         }
+      );
+      // This has to come after the cycles check, as its repair relies on every chain of parents having a top
+      checks.append(
+         IntegrityCheck{
+            .description = QString{"%1 has parent(s) with parents"}.arg(tableName),
+            .query       = QString{
+               "SELECT DISTINCT child.%2 FROM %1 AS child JOIN %1 AS parent ON parent.%2 = child.%3 "
+               "WHERE parent.%3 IS NOT NULL"
+            }.arg(tableName, childColumn, parentColumn),
+            .repair      = {
+               ancestors + QString{
+                  "UPDATE %1 SET %3 = (SELECT ancestor_id FROM ancestors WHERE ancestors.child_id = %1.%2 "
+                  "ORDER BY generation DESC LIMIT 1) "
+                  "WHERE %3 IN (SELECT %2 FROM %1 WHERE %3 IS NOT NULL)"
+               }.arg(tableName, childColumn, parentColumn)
+            },
+         }
+      );
    }
 
-   dbTransaction.commit();
-
-   qInfo() << Q_FUNC_INFO << "Read" << this->size() << "objects from DB table" << this->pimpl->primaryTable.tableName;
-
-   // If we made it this far, everything must have loaded in OK (otherwise we'd have bailed out above).
-   this->pimpl->m_state = ObjectStore::State::InitialisedOk;
+   return checks;
+}
 
+void ObjectStore::hydrateAll() const {
+   if (!this->pimpl->pendingObjects.isEmpty()) {
+      qCDebug(Logging::database) <<
+         Q_FUNC_INFO << "Creating" << this->pimpl->pendingObjects.size() << "remaining" << this->pimpl->m_className <<
+         "objects";
+      // NB: We can't iterate directly over pendingObjects, as hydrate() modifies it
+      for (int const id : this->pimpl->pendingObjects.keys()) {
+         this->hydrate(id);
+      }
+   }
    return;
 }
 
 size_t ObjectStore::size() const {
-   return this->pimpl->allObjects.size();
+   return this->pimpl->allObjects.size() + this->pimpl->pendingObjects.size();
 }
 
 bool ObjectStore::contains(int id) const {
-   return this->pimpl->allObjects.contains(id);
+   return this->pimpl->allObjects.contains(id) || this->pimpl->pendingObjects.contains(id);
 }
 
 std::shared_ptr<QObject> ObjectStore::getById(int id) const {
+   this->hydrate(id);
    // Callers should always check that the object they are requesting exists.  However, if a caller does request
    // something invalid, then we at least want to log that for debugging.
    if (!this->pimpl->allObjects.contains(id)) {
-      qCritical() <<
+      qCCritical(Logging::database) <<
          Q_FUNC_INFO << "Unable to find cached object with ID" << id << "(which should be stored in DB table" <<
          this->pimpl->primaryTable.tableName << ")";
    }
@@ -1697,10 +3993,11 @@ std::shared_ptr<QObject> ObjectStore::getById(int id) const {
 QList<std::shared_ptr<QObject> > ObjectStore::getByIds(QVector<int> const & listOfIds) const {
    QList<std::shared_ptr<QObject> > listToReturn;
    for (auto id : listOfIds) {
+      this->hydrate(id);
       if (this->pimpl->allObjects.contains(id)) {
          listToReturn.append(this->pimpl->allObjects.value(id));
       } else {
-         qWarning() <<
+         qCWarning(Logging::database) <<
             Q_FUNC_INFO << "Unable to find object with ID" << id << "(DB table" <<
             this->pimpl->primaryTable.tableName << ")";
       }
@@ -1709,6 +4006,7 @@ QList<std::shared_ptr<QObject> > ObjectStore::getByIds(QVector<int> const & list
 }
 
 int ObjectStore::insert(std::shared_ptr<QObject> object) {
+   Tracing::Span span{"ObjectStore::insert"};
    // Start transaction
    // (By the magic of RAII, this will abort if we return from this function without calling dbTransaction.commit()
    QSqlDatabase connection = this->pimpl->database->sqlDatabase();
@@ -1724,6 +4022,7 @@ int ObjectStore::insert(std::shared_ptr<QObject> object) {
    //
    Q_ASSERT(!this->pimpl->allObjects.contains(primaryKey));
    this->pimpl->allObjects.insert(primaryKey, object);
+   this->pimpl->indexObject(primaryKey, *object);
 
    // Everything succeeded if we got this far so we can wrap up the transaction
    dbTransaction.commit();
@@ -1737,7 +4036,7 @@ int ObjectStore::insert(std::shared_ptr<QObject> object) {
    if (!setPrimaryKeyOk) {
       // This is a coding error - eg the property doesn't have a WRITE member function or it doesn't take the type of
       // argument we supplied inside a QVariant.
-      qCritical() <<
+      qCCritical(Logging::database) <<
          Q_FUNC_INFO << "Unable to set property" << primaryKeyProperty << "on" << object->metaObject()->className();
       Q_ASSERT(false);
    }
@@ -1745,96 +4044,164 @@ int ObjectStore::insert(std::shared_ptr<QObject> object) {
    //
    // Tell any bits of the UI that need to know that there's a new object
    //
-   emit this->signalObjectInserted(primaryKey);
+   this->emitObjectInserted(primaryKey);
    return primaryKey;
 }
 
-void ObjectStore::update(std::shared_ptr<QObject> object) {
+QFuture<int> ObjectStore::insertAsync(std::shared_ptr<QObject> object) {
+   QFutureInterface<int> promise;
+   promise.reportStarted();
+   QFuture<int> future = promise.future();
+
+   Database * const database = this->pimpl->database;
+   dbWorkerThreadPool().start(QRunnable::create([this, database, object, promise]() mutable {
+      //
+      // On the worker thread, we just write to the DB, using the worker thread's own connection
+      //
+      int primaryKey = -1;
+      {
+         QSqlDatabase connection = database->sqlDatabase();
+         DbTransaction dbTransaction{*database,
+                                     connection,
+                                     QString("Async insert %1").arg(*this->pimpl->primaryTable.tableName)};
+         primaryKey = this->pimpl->insertObjectInDb(connection, *object, false);
+         if (primaryKey > 0) {
+            dbTransaction.commit();
+         }
+      }
+
+      //
+      // Everything else needs to be done on the thread that owns the store, as it touches the cache and emits signals.
+      // This is the same as the tail end of insert().
+      //
+      QMetaObject::invokeMethod(this, [this, object, primaryKey, promise]() mutable {
+         if (primaryKey > 0) {
+            Q_ASSERT(!this->pimpl->allObjects.contains(primaryKey));
+            this->pimpl->allObjects.insert(primaryKey, object);
+            this->pimpl->indexObject(primaryKey, *object);
+
+            BtStringConst const & primaryKeyProperty = this->pimpl->getPrimaryKeyProperty();
+            if (!object->setProperty(*primaryKeyProperty, primaryKey)) {
+               // This is a coding error - see comment in insert()
+               qCCritical(Logging::database) <<
+                  Q_FUNC_INFO << "Unable to set property" << primaryKeyProperty << "on" <<
+                  object->metaObject()->className();
+               Q_ASSERT(false);
+            }
+            this->emitObjectInserted(primaryKey);
+         } else {
+            qCCritical(Logging::database) <<
+               Q_FUNC_INFO << "Error inserting" << this->pimpl->m_className << "object in DB";
+         }
+         promise.reportResult(primaryKey);
+         promise.reportFinished();
+      }, Qt::QueuedConnection);
+   }));
+
+   return future;
+}
+
+QVector<int> ObjectStore::insertMany(QList<std::shared_ptr<QObject> > const & objects) {
+   QVector<int> primaryKeys;
+   if (objects.isEmpty()) {
+      return primaryKeys;
+   }
+
+   qCDebug(Logging::database) << Q_FUNC_INFO << "Inserting" << objects.size() << this->pimpl->m_className << "objects";
+
    // Start transaction
    // (By the magic of RAII, this will abort if we return from this function without calling dbTransaction.commit()
    QSqlDatabase connection = this->pimpl->database->sqlDatabase();
    DbTransaction dbTransaction{*this->pimpl->database,
                                connection,
-                               QString("Update %1").arg(*this->pimpl->primaryTable.tableName)};
+                               QString("Insert %1 %2").arg(objects.size()).arg(*this->pimpl->primaryTable.tableName)};
 
    //
-   // Construct the SQL, which will be of the form
-   //
-   //    UPDATE tablename
-   //    SET firstColumn = :firstColumn, secondColumn = :secondColumn, ...
-   //    WHERE primaryKeyColumn = :primaryKeyColumn;
-   //
-   // .:TBD:. A small optimisation might be to construct this just once rather than every time this function is called
+   // We need the DB to tell us the primary key of each new row, so we can't use execBatch() for the primary table
+   // (because lastInsertId() would only give us the last of them).  But we can at least prepare the statement once and
+   // reuse it for every object.
    //
-   QString queryString{"UPDATE "};
-   QTextStream queryStringAsStream{&queryString};
-   queryStringAsStream << this->pimpl->primaryTable.tableName << " SET ";
-
-   QString  const primaryKeyColumn {*this->pimpl->getPrimaryKeyColumn()};
-   QVariant const primaryKey       {this->pimpl->getPrimaryKey(*object)};
+   QString const queryString = this->pimpl->primaryTableInsertSql(false);
+   BtSqlQuery sqlQuery{connection};
+   sqlQuery.prepare(queryString);
 
-   bool skippedPrimaryKey = false;
-   bool firstFieldOutput = false;
-   for (auto const & fieldDefn: this->pimpl->primaryTable.tableFields) {
-      if (!skippedPrimaryKey) {
-         skippedPrimaryKey = true;
-      } else {
-         if (!firstFieldOutput) {
-            firstFieldOutput = true;
-         } else {
-            queryStringAsStream << ", ";
-         }
-         queryStringAsStream << " " << fieldDefn.columnName << " = :" << fieldDefn.columnName;
+   primaryKeys.reserve(objects.size());
+   QVector<std::pair<QObject const *, int> > objectsAndKeys;
+   objectsAndKeys.reserve(objects.size());
+   for (auto const & object : objects) {
+      int const primaryKey = this->pimpl->insertPrimaryTableRow(sqlQuery, queryString, *object, false);
+      if (primaryKey <= 0 ||
+          !ChangeLog::recordChange(connection, *this->pimpl->primaryTable.tableName, primaryKey)) {
+         // Error will have been logged already
+         return QVector<int>{};
       }
+      primaryKeys.append(primaryKey);
+      objectsAndKeys.append(std::make_pair(object.get(), primaryKey));
    }
 
-   queryStringAsStream << " WHERE " << primaryKeyColumn << " = :" << primaryKeyColumn << ";";
-
    //
-   // Bind the values.  Note that, because we're using bind names, it doesn't matter that the order in which we do the
-   // binds is different than the order in which the fields appear in the query.
+   // Junction table rows don't need anything back from the DB, so we can write all the rows for each junction table in
+   // one go.
    //
-   BtSqlQuery sqlQuery{connection};
-   sqlQuery.prepare(queryString);
-   for (auto const & fieldDefn: this->pimpl->primaryTable.tableFields) {
-      QVariant bindValue{object->property(*fieldDefn.propertyName)};
-
-      // Fix-up the QVariant if needed, including converting enums to strings
-      this->pimpl->unwrapAndMapAsNeeded(this->pimpl->primaryTable, fieldDefn, bindValue);
+   for (auto const & junctionTable : this->pimpl->junctionTables) {
+      if (!insertIntoJunctionTableBatch(junctionTable, objectsAndKeys, connection)) {
+         qCCritical(Logging::database) << Q_FUNC_INFO << "Error writing to junction table" << junctionTable.tableName;
+         return QVector<int>{};
+      }
+   }
 
-      sqlQuery.bindValue(QString{":"} + *fieldDefn.columnName, bindValue);
+   // Everything succeeded if we got this far so we can wrap up the transaction
+   if (!dbTransaction.commit()) {
+      return QVector<int>{};
    }
 
    //
-   // Run the query
+   // Now the DB is written, we can update our cache, tell the objects what their primary keys are, and tell the rest of
+   // the program about the new objects.  As in insert(), setting the primary key must happen _after_ the transaction
+   // has finished.
    //
-   if (!sqlQuery.exec()) {
-      qCritical() <<
-         Q_FUNC_INFO << "Error executing database query " << queryString << ": " << sqlQuery.lastError().text();
-      return;
+   BtStringConst const & primaryKeyProperty = this->pimpl->getPrimaryKeyProperty();
+   for (int ii = 0; ii < objects.size(); ++ii) {
+      auto const & object = objects.at(ii);
+      int const primaryKey = primaryKeys.at(ii);
+      Q_ASSERT(!this->pimpl->allObjects.contains(primaryKey));
+      this->pimpl->allObjects.insert(primaryKey, object);
+      this->pimpl->indexObject(primaryKey, *object);
+      if (!object->setProperty(*primaryKeyProperty, primaryKey)) {
+         // This is a coding error - see comment in insert()
+         qCCritical(Logging::database) <<
+            Q_FUNC_INFO << "Unable to set property" << primaryKeyProperty << "on" << object->metaObject()->className();
+         Q_ASSERT(false);
+      }
    }
+   for (int const primaryKey : primaryKeys) {
+      this->emitObjectInserted(primaryKey);
+   }
+
+   return primaryKeys;
+}
+
+void ObjectStore::update(std::shared_ptr<QObject> object) {
+   // Any queued property updates for this object are older than what we're about to write, so they need to go first
+   ObjectStore::flushPendingPropertyUpdates();
+
+   // Start transaction
+   // (By the magic of RAII, this will abort if we return from this function without calling dbTransaction.commit()
+   QSqlDatabase connection = this->pimpl->database->sqlDatabase();
+   DbTransaction dbTransaction{*this->pimpl->database,
+                               connection,
+                               QString("Update %1").arg(*this->pimpl->primaryTable.tableName)};
 
-   //
-   // Now update data in the junction tables
-   //
-   for (auto const & junctionTable : this->pimpl->junctionTables) {
-      qDebug() <<
-         Q_FUNC_INFO << "Updating property " << GetJunctionTableDefinitionPropertyName(junctionTable) <<
-         " in junction table " << junctionTable.tableName;
+   QVariant const primaryKey{this->pimpl->getPrimaryKey(*object)};
 
-      //
-      // The simplest thing to do with each junction table is to blat any rows relating to the current object and then
-      // write out data based on the current property values.  This may often mean we're deleting rows and rewriting
-      // them but, for the small quantity of data we're talking about, it doesn't seem worth the complexity of
-      // optimising (eg read what's in the DB, compare with what's in the object property, work out what deletes,
-      // inserts and updates are needed to sync them, etc.
-      //
-      if (!deleteFromJunctionTableDefinition(junctionTable, primaryKey, connection)) {
-         return;
-      }
-      if (!insertIntoJunctionTableDefinition(junctionTable, *object, primaryKey, connection)) {
-         return;
-      }
+   // We don't know which properties changed, so any indexed ones need to be re-read.  We do this regardless of whether
+   // the DB write succeeds, as the indexes need to reflect what's in memory.
+   if (this->pimpl->allObjects.contains(primaryKey.toInt())) {
+      this->pimpl->indexObject(primaryKey.toInt(), *object);
+   }
+
+   if (!this->pimpl->updateObjectInDb(connection, *object)) {
+      return;
    }
 
    dbTransaction.commit();
@@ -1842,6 +4209,7 @@ void ObjectStore::update(std::shared_ptr<QObject> object) {
 }
 
 void ObjectStore::update(QObject & object) {
+   Tracing::Span span{"ObjectStore::update"};
    // It's a coding error to call this function for something that's not already stored in the DB
    int const primaryKey = this->pimpl->getPrimaryKey(object).toInt();
    Q_ASSERT(primaryKey > 0);
@@ -1852,6 +4220,48 @@ void ObjectStore::update(QObject & object) {
    return;
 }
 
+QFuture<bool> ObjectStore::updateAsync(std::shared_ptr<QObject> object) {
+   // As in update(), queued property updates need to be written first, and the indexes need to reflect what's in memory
+   ObjectStore::flushPendingPropertyUpdates();
+   int const primaryKey = this->pimpl->getPrimaryKey(*object).toInt();
+   if (this->pimpl->allObjects.contains(primaryKey)) {
+      this->pimpl->indexObject(primaryKey, *object);
+   }
+
+   QFutureInterface<bool> promise;
+   promise.reportStarted();
+   QFuture<bool> future = promise.future();
+
+   Database * const database = this->pimpl->database;
+   dbWorkerThreadPool().start(QRunnable::create([this, database, object, promise]() mutable {
+      bool succeeded = false;
+      {
+         QSqlDatabase connection = database->sqlDatabase();
+         DbTransaction dbTransaction{*database,
+                                     connection,
+                                     QString("Async update %1").arg(*this->pimpl->primaryTable.tableName)};
+         succeeded = this->pimpl->updateObjectInDb(connection, *object);
+         if (succeeded) {
+            dbTransaction.commit();
+         }
+      }
+
+      // There's nothing else to do on the thread that owns the store, but we finish the future there for consistency
+      // with insertAsync()
+      QMetaObject::invokeMethod(this, [succeeded, promise]() mutable {
+         promise.reportResult(succeeded);
+         promise.reportFinished();
+      }, Qt::QueuedConnection);
+   }));
+
+   return future;
+}
+
+void ObjectStore::waitForAsyncOperations() {
+   dbWorkerThreadPool().waitForDone();
+   return;
+}
+
 std::shared_ptr<QObject> ObjectStore::insertOrUpdate(std::shared_ptr<QObject> object) {
    QVariant const primaryKey = this->pimpl->getPrimaryKey(*object);
    if (primaryKey.toInt() > 0) {
@@ -1878,6 +4288,60 @@ int ObjectStore::insertOrUpdate(QObject & object) {
 }
 
 void ObjectStore::updateProperty(QObject const & object, BtStringConst const & propertyName) {
+   Tracing::Span span{"ObjectStore::updateProperty"};
+   // As in update(), indexes need to reflect the in-memory object, even if the DB write below fails
+   // We don't know which fields go into the fingerprint, so any property change means re-computing it (if we have
+   // built the fingerprint index).
+   if (this->pimpl->allObjects.contains(this->pimpl->getPrimaryKey(object).toInt())) {
+      this->pimpl->noteContentChange(this->pimpl->getPrimaryKey(object).toInt());
+   }
+   auto index = this->pimpl->findIndex(propertyName);
+   bool const isNameChange = this->pimpl->nameIndex && propertyName == PropertyNames::NamedEntity::name;
+   bool const isSortKeyChange = this->pimpl->sortKeyField && propertyName == this->pimpl->sortKeyField->propertyName;
+   if (index || this->pimpl->fingerprintIndex || isNameChange || isSortKeyChange) {
+      int const id = this->pimpl->getPrimaryKey(object).toInt();
+      if (this->pimpl->allObjects.contains(id)) {
+         if (index) {
+            this->pimpl->indexObject(*index, id, object);
+         }
+         if (isSortKeyChange) {
+            this->pimpl->sortKeyObject(id, object);
+         }
+         this->pimpl->fingerprintObject(id, object);
+         if (isNameChange) {
+            this->pimpl->nameIndexObject(id, object);
+         }
+      }
+   }
+
+   // When refreshFromDb is applying someone else's change, the DB already has the new value
+   if (this->pimpl->applyingChangesFromDb) {
+      emit this->signalPropertyChanged(this->pimpl->getPrimaryKey(object).toInt(), propertyName);
+      Diagnostics::recordSignalEmitted(this->pimpl->m_className, "signalPropertyChanged", *propertyName);
+      return;
+   }
+
+   //
+   // In write-behind mode, properties stored directly in the primary table are queued up to be written a little later
+   // (see flushPendingPropertyUpdates()), taking the DB write off the UI thread's critical path.  Since the in-memory
+   // object already has the new value, we can tell the UI about the change straight away.  Properties stored in
+   // junction tables change rarely, so we always write them immediately.
+   //
+   if (useWriteBehindForPropertyUpdates()) {
+      TableField const * const fieldDefn = this->pimpl->primaryTable.fieldForProperty(propertyName);
+      if (fieldDefn) {
+         QVariant const primaryKey = this->pimpl->getPrimaryKey(object);
+         queueColumnUpdate(*this->pimpl->database,
+                           QueuedColumnUpdate{&this->pimpl->primaryTable,
+                                              fieldDefn,
+                                              primaryKey,
+                                              this->pimpl->columnValueForProperty(object, *fieldDefn)});
+         emit this->signalPropertyChanged(primaryKey.toInt(), propertyName);
+         Diagnostics::recordSignalEmitted(this->pimpl->m_className, "signalPropertyChanged", *propertyName);
+         return;
+      }
+   }
+
    // Start transaction
    // (By the magic of RAII, this will abort if we return from this function without calling dbTransaction.commit()
    QSqlDatabase connection = this->pimpl->database->sqlDatabase();
@@ -1897,22 +4361,207 @@ void ObjectStore::updateProperty(QObject const & object, BtStringConst const & p
 
    // Tell any bits of the UI that need to know that the property was updated
    emit this->signalPropertyChanged(this->pimpl->getPrimaryKey(object).toInt(), propertyName);
+   Diagnostics::recordSignalEmitted(this->pimpl->m_className, "signalPropertyChanged", *propertyName);
+
+   return;
+}
+
+void ObjectStore::updateProperties(QObject const & object, QVector<BtStringConst const *> const & propertyNames) {
+   Tracing::Span span{"ObjectStore::updateProperties"};
+   if (propertyNames.isEmpty()) {
+      return;
+   }
+
+   int const id = this->pimpl->getPrimaryKey(object).toInt();
+   // As in updateProperty(), indexes need to reflect the in-memory object, even if the DB write below fails
+   if (this->pimpl->allObjects.contains(id)) {
+      this->pimpl->noteContentChange(id);
+      bool nameChanged = false;
+      for (BtStringConst const * propertyName : propertyNames) {
+         auto index = this->pimpl->findIndex(*propertyName);
+         if (index) {
+            this->pimpl->indexObject(*index, id, object);
+         }
+         if (this->pimpl->sortKeyField && *propertyName == this->pimpl->sortKeyField->propertyName) {
+            this->pimpl->sortKeyObject(id, object);
+         }
+         nameChanged = nameChanged || *propertyName == PropertyNames::NamedEntity::name;
+      }
+      this->pimpl->fingerprintObject(id, object);
+      if (nameChanged && this->pimpl->nameIndex) {
+         this->pimpl->nameIndexObject(id, object);
+      }
+   }
+
+   if (!this->pimpl->applyingChangesFromDb) {
+      //
+      // Properties stored directly in the primary table all go in one UPDATE, unless we're in write-behind mode, in
+      // which case they just join the queue (so that they can't be overwritten by older values already queued).  Any
+      // junction table properties are written one by one, as in updateProperty().
+      //
+      QVector<TableField const *> fieldDefns;
+      QVector<BtStringConst const *> junctionTableProperties;
+      for (BtStringConst const * propertyName : propertyNames) {
+         TableField const * const fieldDefn = this->pimpl->primaryTable.fieldForProperty(*propertyName);
+         if (fieldDefn) {
+            fieldDefns.append(fieldDefn);
+         } else {
+            junctionTableProperties.append(propertyName);
+         }
+      }
+
+      if (useWriteBehindForPropertyUpdates()) {
+         QVariant const primaryKey = this->pimpl->getPrimaryKey(object);
+         for (TableField const * fieldDefn : fieldDefns) {
+            queueColumnUpdate(*this->pimpl->database,
+                              QueuedColumnUpdate{&this->pimpl->primaryTable,
+                                                 fieldDefn,
+                                                 primaryKey,
+                                                 this->pimpl->columnValueForProperty(object, *fieldDefn)});
+         }
+         fieldDefns.clear();
+      }
+
+      if (!fieldDefns.isEmpty() || !junctionTableProperties.isEmpty()) {
+         QSqlDatabase connection = this->pimpl->database->sqlDatabase();
+         DbTransaction dbTransaction{
+            *this->pimpl->database,
+            connection,
+            QString("Update %1 properties on %2").arg(propertyNames.size()).arg(*this->pimpl->primaryTable.tableName)
+         };
+         if (!fieldDefns.isEmpty() && !this->pimpl->updateColumnsInDb(connection, object, fieldDefns)) {
+            // As in updateProperty(), bailing out here will abort the transaction and avoid sending the signals
+            return;
+         }
+         for (BtStringConst const * propertyName : junctionTableProperties) {
+            if (!this->pimpl->updatePropertyInDb(connection, object, *propertyName)) {
+               return;
+            }
+         }
+         dbTransaction.commit();
+      }
+   }
 
+   for (BtStringConst const * propertyName : propertyNames) {
+      emit this->signalPropertyChanged(id, *propertyName);
+      Diagnostics::recordSignalEmitted(this->pimpl->m_className, "signalPropertyChanged", **propertyName);
+   }
    return;
 }
 
+bool ObjectStore::setPropertyInBulk(BtStringConst const & propertyName,
+                                    QMap<QString, QVector<int>> const & idsByValue) {
+   Tracing::Span span{"ObjectStore::setPropertyInBulk"};
+   if (idsByValue.isEmpty()) {
+      return true;
+   }
+
+   TableField const * const fieldDefn = this->pimpl->primaryTable.fieldForProperty(propertyName);
+   if (!fieldDefn || fieldDefn->fieldType != ObjectStore::FieldType::String) {
+      // It's a coding error to call this for anything else
+      qCCritical(Logging::database) <<
+         Q_FUNC_INFO << propertyName << "is not a string property in the primary table of" << this->pimpl->m_className;
+      Q_ASSERT(false);
+      return false;
+   }
+
+   QSqlDatabase connection = this->pimpl->database->sqlDatabase();
+   DbTransaction dbTransaction{
+      *this->pimpl->database,
+      connection,
+      QString("Bulk update of property %1 on %2").arg(*propertyName).arg(*this->pimpl->primaryTable.tableName)
+   };
+
+   // One bind value is the new value; the rest are the IDs
+   int const idsPerStatement = maxBindValuesPerStatement - 1;
+   for (auto entry = idsByValue.cbegin(); entry != idsByValue.cend(); ++entry) {
+      QVector<int> const & ids = entry.value();
+      for (int first = 0; first < ids.size(); first += idsPerStatement) {
+         int const numIds = std::min(idsPerStatement, static_cast<int>(ids.size()) - first);
+         QStringList placeholders;
+         for (int ii = 0; ii < numIds; ++ii) {
+            placeholders.append("?");
+         }
+         QString queryString;
+         QTextStream queryStringAsStream{&queryString};
+         queryStringAsStream <<
+            "UPDATE " << this->pimpl->primaryTable.tableName << " SET " << fieldDefn->columnName << " = ? WHERE " <<
+            this->pimpl->primaryTable.tableFields[0].columnName << " IN (" << placeholders.join(", ") << ");";
+         BtSqlQuery sqlQuery{connection};
+         sqlQuery.prepare(queryString);
+         sqlQuery.addBindValue(entry.key());
+         for (int ii = first; ii < first + numIds; ++ii) {
+            sqlQuery.addBindValue(ids[ii]);
+         }
+         if (!sqlQuery.exec()) {
+            qCCritical(Logging::database) <<
+               Q_FUNC_INFO << "Error executing database query " << queryString << ": " << sqlQuery.lastError().text();
+            // Bailing out here will abort the transaction
+            return false;
+         }
+      }
+      for (int const id : ids) {
+         if (!ChangeLog::recordChange(connection, *this->pimpl->primaryTable.tableName, id)) {
+            return false;
+         }
+      }
+   }
+
+   if (!dbTransaction.commit()) {
+      return false;
+   }
+
+   //
+   // Any not-yet-written write-behind update of the same column of these rows is now out of date, and would undo what
+   // we just did if we let it be written.
+   //
+   {
+      QMutexLocker locker(&queuedColumnUpdatesMutex);
+      auto queuedUpdates = queuedColumnUpdates.find(this->pimpl->database);
+      if (queuedUpdates != queuedColumnUpdates.end()) {
+         for (QVector<int> const & ids : idsByValue) {
+            for (int const id : ids) {
+               queuedUpdates->remove(QueuedColumnUpdateKey{fieldDefn, id});
+            }
+         }
+      }
+   }
+
+   this->pimpl->applyingChangesFromDb = true;
+   for (auto entry = idsByValue.cbegin(); entry != idsByValue.cend(); ++entry) {
+      for (int const id : entry.value()) {
+         this->hydrate(id);
+         auto object = this->pimpl->allObjects.value(id);
+         if (!object) {
+            qCWarning(Logging::database) <<
+               Q_FUNC_INFO << this->pimpl->m_className << "#" << id << "is not in the cache";
+            continue;
+         }
+         if (!object->setProperty(*propertyName, entry.key())) {
+            qCWarning(Logging::database) <<
+               Q_FUNC_INFO << "Unable to set property" << propertyName << "on" << this->pimpl->m_className << "#" << id;
+         }
+      }
+   }
+   this->pimpl->applyingChangesFromDb = false;
+
+   return true;
+}
+
 std::shared_ptr<QObject> ObjectStore::defaultSoftDelete(int id) {
    //
    // We assume on soft-delete that there is nothing to do on related objects - eg if a Mash is soft deleted (ie marked
    // deleted but remains in the DB) then there isn't actually anything we need to do with its MashSteps.
    //
-   qDebug() << Q_FUNC_INFO << "Soft delete" << this->pimpl->m_className << "#" << id;
+   qCDebug(Logging::database) << Q_FUNC_INFO << "Soft delete" << this->pimpl->m_className << "#" << id;
+   this->hydrate(id);
    auto object = this->pimpl->allObjects.value(id);
    if (this->pimpl->allObjects.contains(id)) {
       this->pimpl->allObjects.remove(id);
+      this->pimpl->unindexObject(id);
 
       // Tell any bits of the UI that need to know that an object was deleted
-      emit this->signalObjectDeleted(id, object);
+      this->emitObjectDeleted(id, object);
    }
 
    return object;
@@ -1925,7 +4574,9 @@ std::shared_ptr<QObject> ObjectStore::defaultHardDelete(int id) {
    // the object model than here in the object store as they can be subtle, and it would be cumbersome to model them
    // generically.
    //
-   qDebug() << Q_FUNC_INFO << "Hard delete" << this->pimpl->m_className << "#" << id;
+   qCDebug(Logging::database) << Q_FUNC_INFO << "Hard delete" << this->pimpl->m_className << "#" << id;
+   this->hydrate(id);
+   this->pimpl->forgetLazyText(id);
    auto object = this->pimpl->allObjects.value(id);
    QSqlDatabase connection = this->pimpl->database->sqlDatabase();
    DbTransaction dbTransaction{*this->pimpl->database,
@@ -1968,7 +4619,7 @@ std::shared_ptr<QObject> ObjectStore::defaultHardDelete(int id) {
    queryStringAsStream << this->pimpl->primaryTable.tableName;
    BtStringConst const & primaryKeyColumn = this->pimpl->getPrimaryKeyColumn();
    queryStringAsStream << " WHERE " << primaryKeyColumn << " = :" << primaryKeyColumn << ";";
-   qDebug() <<
+   qCDebug(Logging::database) <<
       Q_FUNC_INFO << "Deleting main table row #" << id << "with database query " << queryString;
 
    //
@@ -1977,33 +4628,150 @@ std::shared_ptr<QObject> ObjectStore::defaultHardDelete(int id) {
    BtSqlQuery sqlQuery{connection};
    sqlQuery.prepare(queryString);
    sqlQuery.bindValue(QString{":"} + *primaryKeyColumn, primaryKey);
-   qDebug().noquote() << Q_FUNC_INFO << "Bind values:" << BoundValuesToString(sqlQuery);
+   qCDebug(Logging::database).noquote() << Q_FUNC_INFO << "Bind values:" << BoundValuesToString(sqlQuery);
 
    //
    // Run the query
    //
    if (!sqlQuery.exec()) {
-      qCritical() <<
+      qCCritical(Logging::database) <<
          Q_FUNC_INFO << "Error executing database query " << queryString << ": " << sqlQuery.lastError().text();
       return object;
    }
 
+   // Once the object is gone, its name is the only way another DB it has been synced to can tell which object it was
+   QString const name = object ? object->property(*PropertyNames::NamedEntity::name).toString() : QString{};
+   if (!ChangeLog::recordHardDelete(connection, *this->pimpl->primaryTable.tableName, id, name)) {
+      return object;
+   }
+
    dbTransaction.commit();
 
    //
    // Remove the object from the cache
    //
    this->pimpl->allObjects.remove(id);
+   this->pimpl->unindexObject(id);
 
    // Tell any bits of the UI that need to know that an object was deleted
-   emit this->signalObjectDeleted(id, object);
+   this->emitObjectDeleted(id, object);
 
    return object;
 }
 
+QVector<int> ObjectStore::idsByIndex(BtStringConst const & propertyName, int const value) const {
+   auto const index = this->pimpl->findIndex(propertyName);
+   if (!index) {
+      //
+      // It's a coding error to ask for a lookup on something we don't index.  On a release build, we can recover by
+      // doing the search the slow way.
+      //
+      qCCritical(Logging::database) <<
+         Q_FUNC_INFO << "No index on property" << propertyName << "of" << this->pimpl->m_className <<
+         "so doing linear search";
+      Q_ASSERT(false);
+      return this->idsOfAllMatching(
+         [&propertyName, value](QObject const * obj) { return obj->property(*propertyName).toInt() == value; }
+      );
+   }
+
+   auto const cached = index->orderedIdsByValue.constFind(value);
+   if (cached != index->orderedIdsByValue.cend()) {
+      return *cached;
+   }
+
+   QVector<int> results;
+   auto const ids = index->idsByValue.constFind(value);
+   if (ids != index->idsByValue.cend()) {
+      results.reserve(ids->size());
+      for (int const id : *ids) {
+         results.append(id);
+      }
+      //
+      // Sorting by ID means callers get results in a consistent order (typically the order in which objects were
+      // created), which is marginally nicer than the arbitrary order of QSet.  Where there is a sort key (eg step
+      // number), that comes first.
+      //
+      if (this->pimpl->sortKeyField) {
+         auto const & sortKeyById = this->pimpl->sortKeyById;
+         std::sort(results.begin(), results.end(), [&sortKeyById](int const lhs, int const rhs) {
+            return std::make_pair(sortKeyById.value(lhs), lhs) < std::make_pair(sortKeyById.value(rhs), rhs);
+         });
+      } else {
+         std::sort(results.begin(), results.end());
+      }
+      index->orderedIdsByValue.insert(value, results);
+   }
+   return results;
+}
+
+QList<std::shared_ptr<QObject> > ObjectStore::findByIndex(BtStringConst const & propertyName, int const value) const {
+   return this->getByIds(this->idsByIndex(propertyName, value));
+}
+
+QVector<int> ObjectStore::idsByFingerprint(std::size_t const fingerprint) const {
+   if (!this->pimpl->fingerprintIndex) {
+      // Fingerprints are computed from the objects themselves, so, in lazy loading mode, we need them all to exist
+      this->hydrateAll();
+      this->pimpl->fingerprintIndex = ObjectStore::impl::FingerprintIndex{};
+      this->pimpl->fingerprintIndex->idsByFingerprint.reserve(this->pimpl->allObjects.size());
+      this->pimpl->fingerprintIndex->fingerprintById.reserve(this->pimpl->allObjects.size());
+      for (auto ii = this->pimpl->allObjects.cbegin(); ii != this->pimpl->allObjects.cend(); ++ii) {
+         this->pimpl->fingerprintObject(ii.key(), *ii.value());
+      }
+      qCDebug(Logging::database) <<
+         Q_FUNC_INFO << "Built fingerprint index for" << this->pimpl->allObjects.size() << this->pimpl->m_className <<
+         "objects";
+   }
+
+   QVector<int> results;
+   auto const ids = this->pimpl->fingerprintIndex->idsByFingerprint.constFind(fingerprint);
+   if (ids != this->pimpl->fingerprintIndex->idsByFingerprint.cend()) {
+      results.reserve(ids->size());
+      for (int const id : *ids) {
+         results.append(id);
+      }
+      // As in idsByIndex, sort for consistency
+      std::sort(results.begin(), results.end());
+   }
+   return results;
+}
+
+QString ObjectStore::uniqueName(QString const & candidateName) const {
+   if (!this->pimpl->nameIndex) {
+      // As in idsByFingerprint, we need all the objects to exist to build the index
+      this->hydrateAll();
+      this->pimpl->nameIndex = ObjectStore::impl::NameIndex{};
+      this->pimpl->nameIndex->countByName.reserve(this->pimpl->allObjects.size());
+      this->pimpl->nameIndex->nameById.reserve(this->pimpl->allObjects.size());
+      for (auto ii = this->pimpl->allObjects.cbegin(); ii != this->pimpl->allObjects.cend(); ++ii) {
+         this->pimpl->nameIndexObject(ii.key(), *ii.value());
+      }
+   }
+
+   if (!this->pimpl->nameIndex->countByName.contains(candidateName)) {
+      return candidateName;
+   }
+
+   //
+   // Since the name is in use, there must be at least one entry for its base name.  Going one higher than the highest
+   // number in use for that base name gives us a name that cannot clash.
+   //
+   auto const [baseName, number] = NamedEntity::splitDuplicateNameNumber(candidateName);
+   auto const countByNumber = this->pimpl->nameIndex->countByNumberByBaseName.constFind(baseName);
+   Q_ASSERT(countByNumber != this->pimpl->nameIndex->countByNumberByBaseName.cend() && !countByNumber->isEmpty());
+   int const highestNumber = std::max(number, countByNumber->lastKey());
+   return baseName + QString(" (%1)").arg(highestNumber + 1);
+}
+
+bool ObjectStore::hasIndex(BtStringConst const & propertyName) const {
+   return this->pimpl->findIndex(propertyName) != nullptr;
+}
+
 std::shared_ptr<QObject> ObjectStore::findFirstMatching(
    std::function<bool(std::shared_ptr<QObject>)> const & matchFunction
 ) const {
+   this->hydrateAll();
    auto result = std::find_if(this->pimpl->allObjects.cbegin(), this->pimpl->allObjects.cend(), matchFunction);
    if (result == this->pimpl->allObjects.cend()) {
       return nullptr;
@@ -2012,6 +4780,7 @@ std::shared_ptr<QObject> ObjectStore::findFirstMatching(
 }
 
 std::optional< QObject * > ObjectStore::findFirstMatching(std::function<bool(QObject *)> const & matchFunction) const {
+   this->hydrateAll();
    // std::find_if on this->pimpl->allObjects is going to need a lambda that takes shared pointer to QObject
    // We create a wrapper lambda with this profile that just extracts the raw pointer and passes it through to the
    // caller's lambda
@@ -2031,6 +4800,7 @@ QList<std::shared_ptr<QObject> > ObjectStore::findAllMatching(
    // Before Qt 6, it would be more efficient to use QVector than QList.  However, we use QList because (a) lots of the
    // rest of the code expects it and (b) from Qt 6, QList will become the same as QVector (see
    // https://www.qt.io/blog/qlist-changes-in-qt-6)
+   this->hydrateAll();
    QList<std::shared_ptr<QObject> > results;
    std::copy_if(this->pimpl->allObjects.cbegin(),
                 this->pimpl->allObjects.cend(),
@@ -2057,7 +4827,8 @@ QList<QObject *> ObjectStore::findAllMatching(std::function<bool(QObject *)> con
 QVector<int> ObjectStore::idsOfAllMatching(
    std::function<bool(QObject const *)> const & matchFunction
 ) const {
-   qDebug() << Q_FUNC_INFO << this->pimpl->m_className;
+   qCDebug(Logging::database) << Q_FUNC_INFO << this->pimpl->m_className;
+   this->hydrateAll();
    // It would be nice to use C++20 ranges here, but I couldn't find a way to use them with QHash in such a way that the
    // keys of the hash would be accessible in the range.  So, for now, we do it the old way.
    QVector<int> results;
@@ -2070,11 +4841,79 @@ QVector<int> ObjectStore::idsOfAllMatching(
 }
 
 QList<std::shared_ptr<QObject> > ObjectStore::getAll() const {
-   // QHash already knows how to return a QList of its values
+   this->hydrateAll();
+   // DenseIdMap, like QHash, already knows how to return a QList of its values
    return this->pimpl->allObjects.values();
 }
 
+DenseIdMap<std::shared_ptr<QObject> > const & ObjectStore::allCachedObjects() const {
+   this->hydrateAll();
+   return this->pimpl->allObjects;
+}
+
+unsigned int ObjectStore::contentVersion() const {
+   return this->pimpl->contentVersion.load();
+}
+
+ObjectStore::Snapshot ObjectStore::snapshot() const {
+   QCoreApplication const * application = QCoreApplication::instance();
+   if (application && QThread::currentThread() != application->thread()) {
+      // It's a coding error to call this anywhere other than the GUI thread, as it reads the objects in the store
+      qCCritical(Logging::database) << Q_FUNC_INFO << this->pimpl->m_className << "snapshot requested off GUI thread";
+      Q_ASSERT(false);
+      return ObjectStore::Snapshot{};
+   }
+
+   this->hydrateAll();
+
+   unsigned int const version = this->pimpl->contentVersion.load();
+   auto & latestSnapshot = this->pimpl->latestSnapshot;
+   if (latestSnapshot && latestSnapshot->version == version) {
+      return ObjectStore::Snapshot{latestSnapshot};
+   }
+
+   std::shared_ptr<ObjectStore::Snapshot::Data> data;
+   if (latestSnapshot) {
+      //
+      // Start from the previous snapshot and just re-read the objects that have changed.  Copying the previous
+      // snapshot's data does not copy the rows, as Qt containers are implicitly shared; the ones we don't modify here
+      // remain shared between the two snapshots.
+      //
+      data = std::make_shared<ObjectStore::Snapshot::Data>(*latestSnapshot);
+      for (int const id : std::as_const(this->pimpl->idsChangedSinceSnapshot)) {
+         if (this->pimpl->allObjects.contains(id)) {
+            data->rowsById.insert(id, this->pimpl->snapshotRow(*this->pimpl->allObjects.value(id)));
+         } else {
+            data->rowsById.remove(id);
+         }
+      }
+   } else {
+      data = std::make_shared<ObjectStore::Snapshot::Data>();
+      data->store = this;
+      int column = 0;
+      for (auto const & fieldDefn : this->pimpl->primaryTable.tableFields) {
+         if (!fieldDefn.propertyName.isNull()) {
+            data->columnByPropertyName.insert(QString{*fieldDefn.propertyName}, column);
+            ++column;
+         }
+      }
+      data->rowsById.reserve(this->pimpl->allObjects.size());
+      auto const & allObjects = this->pimpl->allObjects;
+      for (auto ii = allObjects.cbegin(); ii != allObjects.cend(); ++ii) {
+         data->rowsById.insert(ii.key(), this->pimpl->snapshotRow(*ii.value()));
+      }
+   }
+   data->version = version;
+   this->pimpl->idsChangedSinceSnapshot.clear();
+   latestSnapshot = data;
+   qCDebug(Logging::database) <<
+      Q_FUNC_INFO << this->pimpl->m_className << "snapshot version" << version << "has" << data->rowsById.size() <<
+      "objects";
+   return ObjectStore::Snapshot{latestSnapshot};
+}
+
 QList<QObject *> ObjectStore::getAllRaw() const {
+   this->hydrateAll();
    QList<QObject *> listToReturn;
    listToReturn.reserve(this->pimpl->allObjects.size());
    std::transform(this->pimpl->allObjects.cbegin(),
@@ -2090,13 +4929,28 @@ bool ObjectStore::writeAllToNewDb(Database & databaseNew, QSqlDatabase & connect
    //
    // We've got all the data cached in memory, so we just need to write it to the new database ... with a couple of
    // twists.  The assumption here is that we're already inside a transaction and that foreign key constraints are
-   // turned off.  So we just need to tell our insert member function to write to a different DB than normal and not to
-   // try to do anything with transactions ... AND we want to keep all the existing primary key values the same, rather
-   // than let the DB generate new ones when we do the inserts, so the third parameter to this->pimpl->insertObjectInDb
-   // is true.
+   // turned off.  So we just need to write to a different DB than normal and not to try to do anything with
+   // transactions ... AND we want to keep all the existing primary key values the same, rather than let the DB
+   // generate new ones when we do the inserts.
    //
-   for (auto object : this->pimpl->allObjects) {
-      if (this->pimpl->insertObjectInDb(connectionNew, *object, true) <= 0) {
+   // Since we don't need anything back from the DB for each object, we don't insert them one by one, but write several
+   // primary table rows per statement, and all the rows for each junction table in one batch.
+   //
+   this->hydrateAll();
+   QList<QObject const *> objects;
+   QVector<std::pair<QObject const *, int> > objectsAndKeys;
+   objects.reserve(this->pimpl->allObjects.size());
+   objectsAndKeys.reserve(this->pimpl->allObjects.size());
+   for (auto ii = this->pimpl->allObjects.cbegin(); ii != this->pimpl->allObjects.cend(); ++ii) {
+      objects.append(ii.value().get());
+      objectsAndKeys.append(std::make_pair(ii.value().get(), ii.key()));
+   }
+   if (!this->pimpl->insertPrimaryTableRowsWithKeys(connectionNew, objects)) {
+      return false;
+   }
+   for (auto const & junctionTable : this->pimpl->junctionTables) {
+      if (!insertIntoJunctionTableBatch(junctionTable, objectsAndKeys, connectionNew)) {
+         qCCritical(Logging::database) << Q_FUNC_INFO << "Error writing to junction table" << junctionTable.tableName;
          return false;
       }
    }
@@ -2108,9 +4962,7 @@ bool ObjectStore::writeAllToNewDb(Database & databaseNew, QSqlDatabase & connect
    // Note that we only need to do this for the primary key on primaryTable.  We make no use of the primary key IDs on
    // junction tables and we always let the DB auto-generate them, even when writing all data to a new DB.
    //
-   // We _could_ call databaseNew.updatePrimaryKeySequenceIfNecessary() in this->pimpl->insertObjectInDb() every time we
-   // explicitly insert an ID in primaryTable, but it's currently not necessary as this is the only place we ask
-   // this->pimpl->insertObjectInDb() to do that.
+   // This is the only place we explicitly insert IDs in primaryTable, so it's the only place we need to do this.
    //
    databaseNew.updatePrimaryKeySequenceIfNecessary(connectionNew,
                                                    this->pimpl->primaryTable.tableName,
@@ -2118,3 +4970,129 @@ bool ObjectStore::writeAllToNewDb(Database & databaseNew, QSqlDatabase & connect
 
    return true;
 }
+
+void ObjectStore::emitObjectInserted(int const id) {
+   if (signalBatchDepth > 0 && onGuiThread()) {
+      if (!storesWithQueuedSignals.contains(this)) {
+         storesWithQueuedSignals.append(this);
+      }
+      this->pimpl->queuedInsertions.append(id);
+      return;
+   }
+   emit this->signalObjectInserted(id);
+   Diagnostics::recordSignalEmitted(this->pimpl->m_className, "signalObjectInserted");
+   return;
+}
+
+void ObjectStore::emitObjectDeleted(int const id, std::shared_ptr<QObject> object) {
+   if (signalBatchDepth > 0 && onGuiThread()) {
+      // If no-one has yet heard about the object being inserted, they don't need to hear about it being deleted either
+      if (this->pimpl->queuedInsertions.removeOne(id)) {
+         return;
+      }
+      if (!storesWithQueuedSignals.contains(this)) {
+         storesWithQueuedSignals.append(this);
+      }
+      this->pimpl->queuedDeletions.append({id, object});
+      return;
+   }
+   emit this->signalObjectDeleted(id, object);
+   Diagnostics::recordSignalEmitted(this->pimpl->m_className, "signalObjectDeleted");
+   return;
+}
+
+void ObjectStore::deliverQueuedSignals() {
+   auto const deletions  = std::exchange(this->pimpl->queuedDeletions,  {});
+   auto const insertions = std::exchange(this->pimpl->queuedInsertions, {});
+   if (deletions.isEmpty() && insertions.isEmpty()) {
+      return;
+   }
+
+   qCDebug(Logging::database) <<
+      Q_FUNC_INFO << this->pimpl->m_className << ":" << deletions.size() << "deletions and" << insertions.size() <<
+      "insertions";
+   emit this->signalBulkDeliveryStarting();
+   for (auto const & [id, object] : deletions) {
+      emit this->signalObjectDeleted(id, object);
+      Diagnostics::recordSignalEmitted(this->pimpl->m_className, "signalObjectDeleted");
+   }
+   for (int const id : insertions) {
+      emit this->signalObjectInserted(id);
+      Diagnostics::recordSignalEmitted(this->pimpl->m_className, "signalObjectInserted");
+   }
+   emit this->signalBulkDeliveryFinished();
+   return;
+}
+
+ObjectStoreSignalBatch::ObjectStoreSignalBatch() :
+   m_active{onGuiThread()} {
+   if (this->m_active) {
+      ++signalBatchDepth;
+   }
+   return;
+}
+
+ObjectStoreSignalBatch::~ObjectStoreSignalBatch() {
+   if (!this->m_active) {
+      return;
+   }
+
+   Q_ASSERT(signalBatchDepth > 0);
+   if (--signalBatchDepth > 0) {
+      return;
+   }
+
+   //
+   // Now the outermost batch is closed, deliver the signals.  The slots that receive them can insert or delete more
+   // objects, but, since no batch is open, those signals are emitted straight away rather than being queued.
+   //
+   auto const stores = std::exchange(storesWithQueuedSignals, {});
+   for (ObjectStore * store : stores) {
+      store->deliverQueuedSignals();
+   }
+   return;
+}
+
+ObjectStore::Snapshot::Snapshot() :
+   m_data{} {
+   return;
+}
+
+ObjectStore::Snapshot::Snapshot(std::shared_ptr<Data const> data) :
+   m_data{std::move(data)} {
+   return;
+}
+
+ObjectStore::Snapshot::~Snapshot() = default;
+
+unsigned int ObjectStore::Snapshot::version() const {
+   return this->m_data ? this->m_data->version : 0;
+}
+
+bool ObjectStore::Snapshot::isCurrent() const {
+   return this->m_data && this->m_data->store->contentVersion() == this->m_data->version;
+}
+
+int ObjectStore::Snapshot::size() const {
+   return this->m_data ? this->m_data->rowsById.size() : 0;
+}
+
+bool ObjectStore::Snapshot::contains(int const id) const {
+   return this->m_data && this->m_data->rowsById.contains(id);
+}
+
+QList<int> ObjectStore::Snapshot::ids() const {
+   return this->m_data ? this->m_data->rowsById.keys() : QList<int>{};
+}
+
+QVariant ObjectStore::Snapshot::value(int const id, BtStringConst const & propertyName) const {
+   if (!this->m_data) {
+      return QVariant{};
+   }
+   int const column = this->m_data->columnByPropertyName.value(QString{*propertyName}, -1);
+   auto const row = this->m_data->rowsById.constFind(id);
+   if (column < 0 || row == this->m_data->rowsById.cend()) {
+      return QVariant{};
+   }
+   return row->at(column);
+}
@@ -20,21 +20,29 @@
 
 #include <memory> // For PImpl
 #include <optional>
+#include <string_view>
+#include <unordered_map>
 
+#include <QFuture>
+#include <QMap>
 #include <QObject>
+#include <QSet>
 #include <QSqlDatabase>
 #include <QString>
+#include <QStringList>
 #include <QVector>
 
 #include "measurement/Unit.h"
 #include "model/NamedEntity.h"
 #include "utils/BtStringConst.h"
+#include "utils/DenseIdMap.h"
 #include "utils/EnumStringMapping.h"
 #include "utils/NoCopy.h"
 #include "utils/TypeLookup.h"
 
 class Database;
 class NamedParameterBundle;
+class QDataStream;
 
 /**
  * \brief Base class for storing objects (of a given class) in (a) the database and (b) a local in-memory cache.
@@ -88,8 +96,8 @@ public:
       Double,
       String,
       Date,
-      Enum,   // Stored as a string in the DB
-      Unit,   // Stored as a string in the DB
+      Enum,   // Stored as an integer code in the DB (see \c Storage)
+      Unit,   // Stored as an integer code in the DB (see \c Storage)
    };
 
    /**
@@ -106,6 +114,53 @@ public:
    // property names) is that these values are not needed anywhere else in the code.
    //
 
+   /**
+    * \brief Whether the store should keep an in-memory index on a \c TableField, so that \c idsByIndex and
+    *        \c findByIndex can look up objects by the value of the corresponding property without scanning every
+    *        cached object.  Only makes sense for integer fields (typically foreign keys).
+    *
+    *        NB: For an index to remain correct, every change to the value of the corresponding property on a stored
+    *            object needs to come through \c ObjectStore::updateProperty() or \c ObjectStore::update().  In
+    *            practice this means the setter should use \c SET_AND_NOTIFY or otherwise call
+    *            \c propagatePropertyChange().
+    *
+    *        A primary table field marked \c SORT_KEY is not itself indexed, but gives the order of the results of
+    *        \c idsByIndex (and \c findByIndex) on the other fields of the table.  Eg a step's step number orders the
+    *        steps found by owner ID.  At most one field per table can be the sort key.  The same NB applies.
+    */
+   enum Indexing {
+      NOT_INDEXED,
+      INDEXED,
+      SORT_KEY
+   };
+
+   /**
+    * \brief Whether \c loadAll reads a \c TableField along with the rest of the row.  Large free-text fields (notes and
+    *        the like) that are only shown in editors and printouts can be marked \c LOAD_LAZILY, in which case
+    *        \c loadAll constructs the object with a null \c QString for the property and the getter should instead
+    *        return \c NamedEntity::lazyText, which reads the value from the DB (via \c lazyTextValue) on demand.
+    *
+    *        Only makes sense for \c FieldType::String fields.
+    */
+   enum Loading {
+      LOAD_EAGERLY,
+      LOAD_LAZILY
+   };
+
+   /**
+    * \brief How a \c FieldType::Enum or \c FieldType::Unit field is held in the DB.  By default, it is
+    *        \c STORED_AS_CODE, ie as a small integer whose meaning is given by the \c enum_code table (see
+    *        \c EnumCodes), which makes rows smaller and means reading or writing the field does not involve any string
+    *        mapping.  \c STORED_AS_TEXT instead stores the string from the field's mapping, as all such fields were
+    *        before v22 of the schema.
+    *
+    *        Either way, the \c readable_ views (see \c EnumCodes::createView) show the strings.
+    */
+   enum Storage {
+      STORED_AS_CODE,
+      STORED_AS_TEXT
+   };
+
    struct TableDefinition;
    struct TableField {
       FieldType     const fieldType;
@@ -117,12 +172,23 @@ public:
                       TableDefinition                const *,  // FieldType::Int (when foreign key)
                       Measurement::UnitStringMapping const *>; // FieldType::Unit
       ValueDecoder valueDecoder;
+      Indexing indexing;
+      Loading loading;
+      Storage storage;
 
       //! Constructor
       TableField(FieldType     const   fieldType,
                  char const *  const   columnName,
                  BtStringConst const & propertyName = BtString::NULL_STR,
-                 ValueDecoder  const   valueDecoder = ValueDecoder{});
+                 ValueDecoder  const   valueDecoder = ValueDecoder{},
+                 Indexing      const   indexing     = NOT_INDEXED,
+                 Loading       const   loading      = LOAD_EAGERLY,
+                 Storage       const   storage      = STORED_AS_CODE);
+
+      /**
+       * \return \c true if this is an enum or unit field held as an integer code (see \c Storage)
+       */
+      bool isStoredAsCode() const;
    };
 
    /**
@@ -135,6 +201,18 @@ public:
       //! Constructor
       TableDefinition(char const * const tableName,
                       std::initializer_list<TableField> const tableFields);
+
+      /**
+       * \brief Find the field that stores the supplied property.  This is a hash lookup rather than a scan of
+       *        \c tableFields, as it is on the path for every property update.
+       *
+       * \return \c nullptr if no field in this table has the supplied property name
+       */
+      TableField const * fieldForProperty(BtStringConst const & propertyName) const;
+
+   private:
+      //! Index into \c tableFields of each field that has a property name.  Built once by the constructor.
+      std::unordered_map<std::string_view, int> fieldIndexByPropertyName;
    };
 
    /**
@@ -198,6 +276,60 @@ public:
    // This isn't strictly necessary, but it makes various declarations more concise
    typedef QVector<JunctionTableDefinition> JunctionTableDefinitions;
 
+   /**
+    * \brief An immutable copy of the values of the primary table properties of every object in a store at a given
+    *        moment.  (Not to be confused with the start-up snapshot of \c writeSnapshot / \c readSnapshot, which is
+    *        about the DB.)
+    *
+    *        Our objects (and the \c ObjectStore itself) may only be used on the GUI thread, so this is how we give
+    *        data to worker threads.  A \c Snapshot is obtained (on the GUI thread) from \c ObjectStore::snapshot and
+    *        can then be copied and read on any thread, as the data behind it is never modified.  Copying a
+    *        \c Snapshot is just copying a shared pointer.
+    *
+    *        Each snapshot has the \c ObjectStore::contentVersion at which it was made, so that a worker can tell (via
+    *        \c isCurrent) whether anything in the store has changed since.
+    *
+    *        Properties stored in junction tables (eg the IDs of the ingredients in a recipe) are not included.
+    */
+   class Snapshot {
+   public:
+      //! An empty snapshot, with version 0
+      Snapshot();
+      ~Snapshot();
+
+      //! \return The \c ObjectStore::contentVersion of the store when this snapshot was made
+      unsigned int version() const;
+
+      /**
+       * \return \c true if nothing in the store has changed since this snapshot was made.  Unlike the rest of the
+       *         store, \c ObjectStore::contentVersion is safe to read from any thread, so callers do not have to be
+       *         on the GUI thread to call this.
+       */
+      bool isCurrent() const;
+
+      int size() const;
+      bool contains(int id) const;
+
+      //! \return IDs of all the objects in the snapshot, in no particular order
+      QList<int> ids() const;
+
+      /**
+       * \return The value, when the snapshot was made, of \c propertyName on the object with the supplied \c id, or
+       *         an invalid \c QVariant if there is no such object or \c propertyName is not a primary table
+       *         property.
+       */
+      QVariant value(int id, BtStringConst const & propertyName) const;
+
+      //! Implementation detail, defined in ObjectStore.cpp
+      struct Data;
+
+   private:
+      friend class ObjectStore;
+      Snapshot(std::shared_ptr<Data const> data);
+
+      std::shared_ptr<Data const> m_data;
+   };
+
    /**
     * \brief Constructor sets up mappings but does not read in data from DB
     *
@@ -239,20 +371,199 @@ public:
     */
    bool addTableConstraints(Database & database, QSqlDatabase & connection) const;
 
+   /**
+    * \brief Add indexes on the foreign key columns of the table(s) for the objects handled by this store, unless they
+    *        are there already.  As with \c createTables(), it is the caller's responsibility to handle transactions.
+    */
+   bool createIndexes(QSqlDatabase & connection) const;
+
+   /**
+    * \brief Name of the PostgreSQL notification channel on which the triggers added by
+    *        \c createChangeNotificationTriggers report changes
+    */
+   static char const * const changeNotificationChannel;
+
+   /**
+    * \brief PostgreSQL only: (re)create triggers on the table(s) for the objects handled by this store, so that every
+    *        change to them (including ones made by other users of the same DB) sends a notification on
+    *        \c changeNotificationChannel.  See \c refreshFromDb.  As with \c createTables(), it is the caller's
+    *        responsibility to handle transactions.
+    */
+   bool createChangeNotificationTriggers(QSqlDatabase & connection) const;
+
+   /**
+    * \brief Re-read from the DB the objects with the supplied IDs, typically because someone else has changed them,
+    *        and bring the cache up to date.  Objects that are new to us are added (and \c signalObjectInserted
+    *        emitted); ones that are no longer in the DB are removed (and \c signalObjectDeleted emitted); and others
+    *        have their properties set to the values in the DB (without those values being written back).
+    */
+   void refreshFromDb(QSet<int> const & ids);
+
+   /**
+    * \brief Name of the DB table that holds the objects handled by this store (as used in the payload of change
+    *        notifications)
+    */
+   BtStringConst const & primaryTableName() const;
+
+   /**
+    * \brief The fields of the primary table, ie which properties of the objects handled by this store are stored (other
+    *        than in junction tables) and how.  Used by generic code, such as \c RecipeDiff, that needs to know which
+    *        properties hold data rather than calculated values.
+    */
+   QVector<TableField> const & primaryTableFields() const;
+
+   /**
+    * \brief For each column, in the table(s) of this store, that refers to (ie is a foreign key to) the primary table
+    *        of \c referencedStore, add to \c subqueries a query giving all the IDs that column refers to.  These are
+    *        the objects in \c referencedStore that \c purgeSoftDeleted must not delete.
+    *
+    * \param ownerProperties Properties (eg \c PropertyNames::Step::ownerId) that hold the ID of the object that owns
+    *                        this one.  Columns for these are skipped, as hard deleting an owner also deletes what it
+    *                        owns.
+    */
+   void appendReferencingQueries(ObjectStore const & referencedStore,
+                                 QVector<BtStringConst const *> const & ownerProperties,
+                                 QStringList & subqueries) const;
+
+   /**
+    * \brief Hard delete (see \c hardDeleteObject) every soft-deleted object in this store that is not in the results of
+    *        any of \c referencingQueries (see \c appendReferencingQueries).  Soft-deleted objects are not shown
+    *        anywhere, so, once nothing refers to them, all they do is take up space in the DB and in our cache.
+    *
+    * \return Number of objects deleted
+    */
+   int purgeSoftDeleted(QStringList const & referencingQueries);
+
+   /**
+    * \brief A set-based check, made from our table definitions, for one kind of broken data in one table or column
+    */
+   struct IntegrityCheck {
+      //! What is wrong with the rows the query finds, for reporting
+      QString     description;
+      //! Query giving the IDs of the objects in this store that have the problem
+      QString     query;
+      //! Statement(s) that fix the problem for all the affected rows in one go
+      QStringList repair;
+   };
+
+   /**
+    * \brief Make the \c IntegrityCheck queries for the tables of this store, which look for:
+    *          • Foreign key columns (in the primary table or a junction table) referring to rows that don't exist.  To
+    *            repair, rows whose owner (see \c appendReferencingQueries) is missing are deleted, as are broken
+    *            junction table rows, and other broken references are set to NULL.
+    *          • Cycles of parents (see \c NamedEntity::getParentAndChildrenIds), found with a recursive query.  To
+    *            repair, the objects in the cycle lose their parents.
+    *          • Parents that have parents.  To repair, each child is given the top of its chain of parents instead.
+    *
+    *        The checks are returned in the order their repairs need to be done, and the queries can be run on any
+    *        thread, as they only touch the DB.
+    */
+   QVector<IntegrityCheck> integrityChecks(QVector<BtStringConst const *> const & ownerProperties) const;
+
+   /**
+    * \return Number of objects currently in our cache
+    */
+   int numCachedObjects() const;
+
+   /**
+    * \return Rough estimate of the memory used by the objects in our cache.  This counts the objects themselves and
+    *         our per-object overhead, but not what they point to (eg the contents of strings), so it's a lower bound.
+    */
+   std::size_t estimatedCacheBytes() const;
+
    /**
     * \brief Load from database all objects handled by this store
     *
+    *        If the \c lazyObjectLoading setting is on, then we still read all the rows, but we only create each object
+    *        the first time it is asked for (via \c getById, \c getByIds, \c findByIndex etc).  This makes start-up
+    *        quicker and uses less memory for stores, such as \c RecipeAdditionHop or \c BrewNote, where most rows are
+    *        only ever accessed via their owning \c Recipe.  Anything that needs to look at every object (\c getAll,
+    *        \c findAllMatching, etc) will create all remaining objects first.
+    *
     * \param database Sets and stores the Database this store is going to work with.  If not supplied (or set to
     *                 nullptr) then the store will use \c Database::getInstance()
     */
    void loadAll(Database * database = nullptr);
 
+   /**
+    * \brief Optionally called before \c loadAll to do the DB reading part of it up front, typically on a worker thread
+    *        so that several stores can be read in parallel at start-up.  No objects are created and nothing is added
+    *        to the store: the rows read are just held until \c loadAll is called (on the main thread), which then
+    *        uses them instead of querying the DB itself.
+    *
+    *        NB: It is the caller's responsibility to ensure nothing else is using this store until \c prefetchAll
+    *            returns, and that \c prefetchAll is not called more than once.
+    *
+    * \param database If not supplied (or set to nullptr) then the store will use \c Database::getInstance(), which is
+    *                 probably not what you want from a worker thread.
+    *
+    * \return \c true if the tables were read OK, \c false otherwise (in which case \c loadAll will try again)
+    */
+   bool prefetchAll(Database * database = nullptr);
+
+   /**
+    * \brief Write the current contents of this store's tables to \c stream, in a form that \c readSnapshot can use
+    *        instead of reading the DB at the next start-up.  See \c MakeObjectStoreSnapshot.
+    *
+    * \return \c true if everything was read and written OK
+    */
+   bool writeSnapshot(QDataStream & stream, Database * database = nullptr) const;
+
+   /**
+    * \brief Alternative to \c prefetchAll that gets the rows from a start-up snapshot written by \c writeSnapshot
+    *        instead of from the DB.  The same NB applies.  It is the caller's responsibility to know that the snapshot
+    *        is up-to-date.
+    *
+    * \return \c true if the snapshot was read OK and matches the current table definitions, \c false otherwise (in
+    *         which case the caller should fall back to \c prefetchAll or \c loadAll)
+    */
+   bool readSnapshot(QDataStream & stream);
+
+   /**
+    * \brief Discard all the prepared UPDATE statements that object stores keep for reuse when writing property changes
+    *        to the DB.  These are held per DB connection, so this needs to be called before connections are closed
+    *        (eg by \c Database::unload).
+    *
+    * \param connectionName If not empty, only discard the statements for this connection (eg because it is about to
+    *                       be reopened)
+    */
+   static void clearPreparedStatementCache(QString const & connectionName = QString{});
+
+   /**
+    * \brief Write out, in one transaction per DB, any property updates that \c updateProperty has queued (across all
+    *        object stores) in write-behind mode.  Does nothing if there are none.
+    *
+    * \return \c true if all the queued updates were written OK, \c false if there were any errors
+    */
+   static bool flushPendingPropertyUpdates();
+
+   /**
+    * \brief Wait for all DB operations started by \c insertAsync or \c updateAsync (across all object stores) to
+    *        finish.  Needs to be called before the DB worker thread's connection is closed (eg by
+    *        \c Database::unload).
+    *
+    *        NB: This waits for the DB work itself, but the completion handling for each operation (updating the cache,
+    *            emitting signals, etc) is only done when the event loop of the thread that owns the store next runs.
+    */
+   static void waitForAsyncOperations();
+
    /**
     * \brief Create a new object of the type we are handling, using the parameters read from the DB.  Subclass needs to
     *        implement.
     */
    virtual std::shared_ptr<QObject> createNewObject(NamedParameterBundle & namedParameterBundle) = 0;
 
+   /**
+    * \brief Hard delete an object, including anything the subclass needs to do (eg deleting objects it owns).  Used by
+    *        \c purgeSoftDeleted.  Subclass needs to implement.
+    */
+   virtual void hardDeleteObject(int id) = 0;
+
+   /**
+    * \return Size of the objects we store, for \c estimatedCacheBytes.  Subclass needs to implement.
+    */
+   virtual std::size_t objectSize() const = 0;
+
    /**
     * \brief Insert a new object in the DB (and in our cache list)
     *
@@ -266,6 +577,36 @@ public:
     */
    template <typename D> void insert(D) = delete;
 
+   /**
+    * \brief Insert several new objects in the DB (and in our cache list) in one go.  This is equivalent to calling
+    *        \c insert for each object, but much faster for large numbers of objects (eg when importing a big BeerXML
+    *        file) as everything is done in a single DB transaction, the primary table INSERT statement is only
+    *        prepared once, and junction table rows are written in batches.
+    *
+    *        NB: Unlike \c insert, this is not virtual, so it will not pick up any subclass-specific insert logic.
+    *
+    * \return The IDs of what was inserted, in the same order as \c objects.  If there was an error, nothing is inserted
+    *         and an empty list is returned.
+    */
+   QVector<int> insertMany(QList<std::shared_ptr<QObject> > const & objects);
+
+   /**
+    * \brief As \c insert, except that the DB work is done on a dedicated DB worker thread (with its own connection), so
+    *        the caller (typically the GUI thread) is not held up waiting for the DB -- which matters most when the DB
+    *        is a remote PostgreSQL one.
+    *
+    *        The object is added to our cache list, given its primary key, and \c signalObjectInserted emitted, back on
+    *        the thread that owns this store once the DB insert has completed, just before the returned future is
+    *        finished.  Until then, the object is not in the store.
+    *
+    *        NB: Unlike \c insert, this is not virtual, so it will not pick up any subclass-specific insert logic.
+    *            Also, the caller must not modify the object until the returned future is finished, as its properties
+    *            are read on the worker thread.
+    *
+    * \return Future that will give the ID of what was inserted, or -1 if there was an error
+    */
+   QFuture<int> insertAsync(std::shared_ptr<QObject> object);
+
    /**
     * \brief Update an existing object in the DB
     */
@@ -273,6 +614,16 @@ public:
 
    virtual void update(QObject & object);
 
+   /**
+    * \brief As \c update, except that the DB work is done on the DB worker thread (see \c insertAsync).  The in-memory
+    *        indexes are updated straight away.
+    *
+    *        NB: As with \c insertAsync, the caller must not modify the object until the returned future is finished.
+    *
+    * \return Future that will give \c true if the update succeeded or \c false otherwise
+    */
+   QFuture<bool> updateAsync(std::shared_ptr<QObject> object);
+
    /**
     * \brief We don't want the compiler automatically constructing a shared_ptr for us if we accidentally call update
     *        with, say, a raw pointer, so this template trick ensures it can't.
@@ -304,9 +655,35 @@ public:
 
    /**
     * \brief Update a single property of an existing object in the DB
+    *
+    *        If the \c writeBehindPropertyUpdates setting is on, and the property is stored directly in the object's
+    *        primary table, then the DB write is queued rather than done immediately.  Only the latest value for each
+    *        property of each object is kept in the queue, which is written out by \c flushPendingPropertyUpdates
+    *        (every \c writeBehindFlushIntervalMs milliseconds, and before the DB is backed up or closed).
     */
    void updateProperty(QObject const & object, BtStringConst const & propertyName);
 
+   /**
+    * \brief As \c updateProperty, but for several properties of the same object at once.  The ones stored directly in
+    *        the object's primary table are written with a single multi-column UPDATE (or, in write-behind mode,
+    *        queued).  \c signalPropertyChanged is emitted for each property.
+    */
+   void updateProperties(QObject const & object, QVector<BtStringConst const *> const & propertyNames);
+
+   /**
+    * \brief Set one string property on lots of objects at once (eg to move them all to new folders).  \c idsByValue
+    *        gives, for each new value, the IDs of the objects that are to have it.  The DB write is one
+    *        UPDATE ... WHERE id IN (...) per value (or per several hundred objects for a very long list), all in one
+    *        transaction, rather than a transaction per object.  The cached objects are then updated through their
+    *        setters, without the values being written back (as in \c refreshFromDb), so their signals, our indexes and
+    *        \c signalPropertyChanged all happen in the usual way.
+    *
+    *        The property must be a \c FieldType::String stored directly in the primary table.
+    *
+    * \return \c false if the DB update failed, in which case the cached objects are left unchanged
+    */
+   bool setPropertyInBulk(BtStringConst const & propertyName, QMap<QString, QVector<int>> const & idsByValue);
+
    /**
     * \brief Remove the object from our local in-memory cache
     *
@@ -416,6 +793,99 @@ public:
     */
    QVector<int> idsOfAllMatching(std::function<bool(QObject const *)> const & matchFunction) const;
 
+   /**
+    * \brief What \c countPaged and \c idsOfPage should return.  These let a table show a very large store one "page" at
+    *        a time, with the filtering and sorting done by the database, rather than on every object in memory.
+    *
+    *        As with the in-memory catalogs, soft-deleted and hidden objects are never included.
+    */
+   struct PageQuery {
+      //! If not empty, only include objects whose name contains this, ignoring case (at least for ASCII characters)
+      QString nameContains = QString{};
+      /**
+       * \brief Property to sort by, which needs to be stored in the primary table.  If it isn't (or this is
+       *        \c nullptr) we sort by name.  Objects with the same value are ordered by primary key.
+       */
+      BtStringConst const * sortProperty = nullptr;
+      bool ascending = true;
+   };
+
+   /**
+    * \return Number of objects, in the database, that \c pageQuery matches, or -1 if there was an error
+    */
+   int countPaged(PageQuery const & pageQuery) const;
+
+   /**
+    * \return The IDs, in order, of up to \c limit objects matching \c pageQuery, starting from the \c offset-th one
+    *         (counting from 0).  Use \c getById to get the objects themselves, which, with the \c lazyObjectLoading
+    *         setting on, is when they get created.
+    */
+   QVector<int> idsOfPage(PageQuery const & pageQuery, int const offset, int const limit) const;
+
+   /**
+    * \return The value in the DB of the \c LOAD_LAZILY property \c propertyName of the object with primary key \c id.
+    *         The most recently read values are cached, so it's OK for a getter to call this every time it's asked for
+    *         the property.  Can be called on any thread.
+    */
+   QString lazyTextValue(int const id, BtStringConst const & propertyName) const;
+
+   /**
+    * \brief Use the store's in-memory index on \c propertyName to find the IDs of all cached objects whose
+    *        \c propertyName property has the value \c value.  This is equivalent to, but much faster than, calling
+    *        \c idsOfAllMatching with a lambda that compares the property value.
+    *
+    *        NB: This is non-virtual for the same reason as \c getById.
+    *
+    *        It is a coding error to call this for a property that is not marked \c INDEXED in the primary table or
+    *        one of the junction tables.  (Use \c hasIndex if in doubt.)
+    *
+    *        The ordered list of IDs for each value is kept until an object with that value is added, removed or has
+    *        its sort key changed, so repeated lookups (eg of a mash's steps) don't do any sorting.
+    *
+    * \return IDs of all matching objects, in ascending order of the primary table's \c SORT_KEY field, if it has one,
+    *         and then of ID (and thus an empty list if there are none)
+    */
+   QVector<int> idsByIndex(BtStringConst const & propertyName, int const value) const;
+
+   /**
+    * \brief Similar to \c idsByIndex but returns a list of the cached objects
+    */
+   QList<std::shared_ptr<QObject> > findByIndex(BtStringConst const & propertyName, int const value) const;
+
+   /**
+    * \brief Find the IDs of all cached objects whose \c NamedEntity::fingerprint is \c fingerprint.  Since equal
+    *        objects have equal fingerprints, this gives the only candidates that need to be checked with
+    *        \c NamedEntity::operator== when looking for a duplicate.
+    *
+    *        The fingerprint index is built on the first call (which, in lazy loading mode, means creating all the
+    *        objects) and kept up to date thereafter.
+    *
+    *        NB: This is non-virtual for the same reason as \c getById.
+    *
+    * \return IDs of all objects with the given fingerprint, in ascending order
+    */
+   QVector<int> idsByFingerprint(std::size_t const fingerprint) const;
+
+   /**
+    * \brief Used to avoid creating objects with the same name when importing.  (This is the store-wide equivalent of
+    *        calling \c SerializationRecord::modifyClashingName until the name no longer clashes, but it takes one
+    *        lookup rather than one scan of the store per attempt.)
+    *
+    *        Like \c idsByFingerprint, this uses an index that is built on the first call and kept up to date
+    *        thereafter.
+    *        Soft-deleted objects still count as using their names.
+    *
+    * \return \c candidateName if no cached object has that name, otherwise the name with its " (n)" number (if any)
+    *         replaced by one more than the highest number in use with the same base name.  Eg if "Oatmeal Stout" and
+    *         "Oatmeal Stout (3)" are taken, then asking for either gives "Oatmeal Stout (4)".
+    */
+   QString uniqueName(QString const & candidateName) const;
+
+   /**
+    * \return \c true if this store keeps an index on \c propertyName, \c false otherwise
+    */
+   bool hasIndex(BtStringConst const & propertyName) const;
+
    /**
     * \brief Special case of \c findAllMatching that returns a list of all cached objects of a given type
     */
@@ -425,6 +895,30 @@ public:
     */
    QList<QObject *> getAllRaw() const;
 
+   /**
+    * \brief Direct read-only access to all the cached objects, so that the templated scans in \c ObjectStoreTyped (eg
+    *        \c ObjectStoreTyped::forEach) can loop over them without going through \c std::function.  As with
+    *        \c getAll, in lazy loading mode, this first creates any objects not yet created.
+    */
+   DenseIdMap<std::shared_ptr<QObject> > const & allCachedObjects() const;
+
+   /**
+    * \return Number that changes whenever any object in the store is inserted, deleted or has one of its properties
+    *         changed (via \c update or \c updateProperty, with the same NB as for \c Indexing).  Can be read from
+    *         any thread.  See \c Snapshot.
+    */
+   unsigned int contentVersion() const;
+
+   /**
+    * \brief Get a \c Snapshot of the current contents of the store, for handing to a worker thread.  Must be called
+    *        on the GUI thread.  (As with \c getAll, in lazy loading mode, this first creates any objects not yet
+    *        created.)
+    *
+    *        We keep the most recent snapshot, so calling this again when nothing has changed is cheap, and, when
+    *        only a few objects have changed, only those objects' properties are re-read.
+    */
+   Snapshot snapshot() const;
+
    /**
     * \brief Write everything in this object store to a new database.  Caller's responsibility to wrap everything in a
     *        transaction and turn off foreign key constraints.
@@ -518,7 +1012,50 @@ signals:
     */
    void signalPropertyChanged(int id, BtStringConst const & propertyName);
 
+   /**
+    * \brief Signal emitted after lots of objects have been changed in one go (eg all \c Recipe objects had their
+    *        calculated values redone after a change to the IBU formula -- see
+    *        \c RecipeEvaluator::recalculateAllRecipes).  In this case, the individual objects will NOT have emitted
+    *        \c NamedEntity::changed() signals, so listeners that display lots of objects of this type should just
+    *        refresh everything they show.
+    */
+   void signalObjectsChangedInBulk();
+
+   /**
+    * \brief Signals emitted either side of the delivery of the \c signalObjectInserted and \c signalObjectDeleted
+    *        signals that were queued while an \c ObjectStoreSignalBatch was open.  Listeners that display lots of
+    *        objects of this type (eg table, list and tree models) can use these to apply all the insertions and
+    *        deletions in between as one change to what they show.  Other listeners can just ignore them.  The deleted
+    *        objects are kept alive until after \c signalBulkDeliveryFinished has been emitted.
+    */
+   void signalBulkDeliveryStarting();
+   void signalBulkDeliveryFinished();
+
+   /**
+    * \brief In lazy loading mode, create all objects that have been read from the DB but not yet created.  Needed
+    *        before anything that has to look at every object.  Also needed before objects are going to be read from
+    *        other threads (see \c HydrateAllObjectStores), as objects must only be created on the main thread.
+    */
+   void hydrateAll() const;
+
 private:
+   /**
+    * \brief In lazy loading mode (see \c loadAll), create the object with the supplied ID if it has been read from the
+    *        DB but not yet created.  Otherwise does nothing.
+    */
+   void hydrate(int id) const;
+
+   /**
+    * \brief Emit \c signalObjectInserted or \c signalObjectDeleted straight away or, if an \c ObjectStoreSignalBatch
+    *        is open, queue it until the batch is closed.
+    */
+   void emitObjectInserted(int const id);
+   void emitObjectDeleted(int const id, std::shared_ptr<QObject> object);
+
+   //! Called from \c ObjectStoreSignalBatch when the outermost batch is closed
+   void deliverQueuedSignals();
+   friend class ObjectStoreSignalBatch;
+
    // Private implementation details - see https://herbsutter.com/gotw/_100/
    class impl;
    std::unique_ptr<impl> pimpl;
@@ -527,6 +1064,33 @@ private:
    NO_COPY_DECLARATIONS(ObjectStore)
 };
 
+/**
+ * \class ObjectStoreSignalBatch
+ *
+ * \brief RAII helper for coalescing \c ObjectStore::signalObjectInserted and \c ObjectStore::signalObjectDeleted
+ *        signals during bulk operations such as imports.
+ *
+ *        Each of those signals normally makes every table, list and tree model showing that type of object update
+ *        (and re-sort and repaint) straight away, which, for thousands of objects, is very slow.  While a batch is
+ *        open, the signals are instead queued.  When the outermost batch is closed, each store that queued any emits
+ *        \c ObjectStore::signalBulkDeliveryStarting, then its queued deletion and insertion signals, then
+ *        \c ObjectStore::signalBulkDeliveryFinished.  An object that is both inserted and deleted while the batch is
+ *        open generates no signals at all.
+ *
+ *        Batches can be nested.  Like \c NamedEntityChangeBatch, they only have an effect on the GUI thread.
+ */
+class ObjectStoreSignalBatch {
+public:
+   ObjectStoreSignalBatch();
+   ~ObjectStoreSignalBatch();
+
+private:
+   bool const m_active;
+
+   // RAII class shouldn't be getting copied or moved
+   NO_COPY_DECLARATIONS(ObjectStoreSignalBatch)
+};
+
 
 /**
  * \brief Convenience function for logging
@@ -15,9 +15,38 @@
  ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
 #include "database/ObjectStoreTyped.h"
 
-#include  <mutex> // for std::once_flag
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <mutex> // for std::once_flag
 
+#include <QByteArray>
+#include <QCoreApplication>
+#include <QDataStream>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QRunnable>
+#include <QSaveFile>
+#include <QSet>
+#include <QSqlDriver>
+#include <QSqlError>
+#include <QStringList>
+#include <QThreadPool>
+#include <QTimer>
+
+#include "config.h"
+#include "database/BtSqlQuery.h"
+#include "database/ChangeLog.h"
+#include "database/Database.h"
 #include "database/DbTransaction.h"
+#include "database/EnumCodes.h"
+#include "database/RecipeCalculationCache.h"
+#include "database/SearchIndex.h"
+#include "database/SensorReadings.h"
+#include "Logging.h"
 #include "measurement/Unit.h"
 #include "model/Boil.h"
 #include "model/BoilStep.h"
@@ -37,6 +66,7 @@
 #include "model/Mash.h"
 #include "model/MashStep.h"
 #include "model/Misc.h"
+#include "model/OwnedByRecipe.h"
 #include "model/RecipeAdditionFermentable.h"
 #include "model/RecipeAdditionHop.h"
 #include "model/RecipeAdditionMisc.h"
@@ -45,9 +75,11 @@
 #include "model/RecipeUseOfWater.h"
 #include "model/Recipe.h"
 #include "model/Salt.h"
+#include "model/Step.h"
 #include "model/Style.h"
 #include "model/Water.h"
 #include "model/Yeast.h"
+#include "PersistentSettings.h"
 
 namespace {
    //
@@ -147,7 +179,7 @@ namespace {
          {
             {ObjectStore::FieldType::Int, "id"                                                                         },
             {ObjectStore::FieldType::Int, "child_id",  PropertyNames::NamedEntity::key,       &PRIMARY_TABLE<Equipment>},
-            {ObjectStore::FieldType::Int, "parent_id", PropertyNames::NamedEntity::parentKey, &PRIMARY_TABLE<Equipment>},
+            {ObjectStore::FieldType::Int, "parent_id", PropertyNames::NamedEntity::parentKey, &PRIMARY_TABLE<Equipment>, ObjectStore::INDEXED},
          },
          ObjectStore::MAX_ONE_ENTRY
       }
@@ -171,7 +203,7 @@ namespace {
          {ObjectStore::FieldType::Double, "ibu_gal_per_lb"                , PropertyNames::Fermentable::ibuGalPerLb              },
          {ObjectStore::FieldType::Double, "max_in_batch"                  , PropertyNames::Fermentable::maxInBatch_pct           },
          {ObjectStore::FieldType::Double, "moisture"                      , PropertyNames::Fermentable::moisture_pct             },
-         {ObjectStore::FieldType::String, "notes"                         , PropertyNames::Fermentable::notes                    },
+         {ObjectStore::FieldType::String, "notes"                         , PropertyNames::Fermentable::notes, {}, ObjectStore::NOT_INDEXED, ObjectStore::LOAD_LAZILY},
          {ObjectStore::FieldType::String, "origin"                        , PropertyNames::Fermentable::origin                   },
          {ObjectStore::FieldType::String, "supplier"                      , PropertyNames::Fermentable::supplier                 },
          {ObjectStore::FieldType::Double, "protein"                       , PropertyNames::Fermentable::protein_pct              },
@@ -207,7 +239,7 @@ namespace {
       "fermentable_in_inventory",
       {
          {ObjectStore::FieldType::Int   , "id"            , PropertyNames::NamedEntity::key                     },
-         {ObjectStore::FieldType::Int   , "fermentable_id", PropertyNames::Inventory::ingredientId   , &PRIMARY_TABLE<Fermentable>},
+         {ObjectStore::FieldType::Int   , "fermentable_id", PropertyNames::Inventory::ingredientId   , &PRIMARY_TABLE<Fermentable>, ObjectStore::INDEXED},
          {ObjectStore::FieldType::Double, "quantity"      , PropertyNames::IngredientAmount::quantity},
          {ObjectStore::FieldType::Unit  , "unit"          , PropertyNames::IngredientAmount::unit    , &Measurement::Units::unitStringMapping},
       }
@@ -233,7 +265,7 @@ namespace {
          {ObjectStore::FieldType::Double, "hsi"                  , PropertyNames::Hop::hsi_pct           },
          {ObjectStore::FieldType::Double, "humulene"             , PropertyNames::Hop::humulene_pct      },
          {ObjectStore::FieldType::Double, "myrcene"              , PropertyNames::Hop::myrcene_pct       },
-         {ObjectStore::FieldType::String, "notes"                , PropertyNames::Hop::notes             },
+         {ObjectStore::FieldType::String, "notes"                , PropertyNames::Hop::notes, {}, ObjectStore::NOT_INDEXED, ObjectStore::LOAD_LAZILY},
          {ObjectStore::FieldType::String, "origin"               , PropertyNames::Hop::origin            },
          {ObjectStore::FieldType::String, "substitutes"          , PropertyNames::Hop::substitutes       },
          {ObjectStore::FieldType::Enum  , "htype"                , PropertyNames::Hop::type              , &Hop::typeStringMapping},
@@ -261,7 +293,7 @@ namespace {
       "hop_in_inventory",
       {
          {ObjectStore::FieldType::Int   , "id"      , PropertyNames::NamedEntity::key                     },
-         {ObjectStore::FieldType::Int   , "hop_id"  , PropertyNames::Inventory::ingredientId   , &PRIMARY_TABLE<Hop>},
+         {ObjectStore::FieldType::Int   , "hop_id"  , PropertyNames::Inventory::ingredientId   , &PRIMARY_TABLE<Hop>, ObjectStore::INDEXED},
          {ObjectStore::FieldType::Double, "quantity", PropertyNames::IngredientAmount::quantity},
          {ObjectStore::FieldType::Unit  , "unit"    , PropertyNames::IngredientAmount::unit    , &Measurement::Units::unitStringMapping},
       }
@@ -279,7 +311,7 @@ namespace {
          {ObjectStore::FieldType::String, "name"      , PropertyNames::NamedEntity::name      },
          {ObjectStore::FieldType::Bool  , "display"   , PropertyNames::NamedEntity::display   },
          {ObjectStore::FieldType::Bool  , "deleted"   , PropertyNames::NamedEntity::deleted   },
-         {ObjectStore::FieldType::String, "directions", PropertyNames::Instruction::directions},
+         {ObjectStore::FieldType::String, "directions", PropertyNames::Instruction::directions, {}, ObjectStore::NOT_INDEXED, ObjectStore::LOAD_LAZILY},
          {ObjectStore::FieldType::Bool  , "hasTimer"  , PropertyNames::Instruction::hasTimer  },
          {ObjectStore::FieldType::String, "timervalue", PropertyNames::Instruction::timerValue},
          {ObjectStore::FieldType::Bool  , "completed" , PropertyNames::Instruction::completed },
@@ -327,10 +359,10 @@ namespace {
          // NB: MashSteps don't have folders, as each one is owned by a Mash
          {ObjectStore::FieldType::Double, "end_temp_c"               , PropertyNames::    Step::endTemp_c             },
          {ObjectStore::FieldType::Double, "infuse_temp_c"            , PropertyNames::MashStep::infuseTemp_c          },
-         {ObjectStore::FieldType::Int   , "mash_id"                  , PropertyNames::    Step::ownerId               , &PRIMARY_TABLE<Mash>},
+         {ObjectStore::FieldType::Int   , "mash_id"                  , PropertyNames::    Step::ownerId               , &PRIMARY_TABLE<Mash>, ObjectStore::INDEXED},
          {ObjectStore::FieldType::Enum  , "mstype"                   , PropertyNames::MashStep::type                  , &MashStep::typeStringMapping},
          {ObjectStore::FieldType::Double, "ramp_time_mins"           , PropertyNames::    Step::rampTime_mins         },
-         {ObjectStore::FieldType::Int   , "step_number"              , PropertyNames::    Step::stepNumber            },
+         {ObjectStore::FieldType::Int   , "step_number"              , PropertyNames::    Step::stepNumber            , {}, ObjectStore::SORT_KEY},
          {ObjectStore::FieldType::Double, "step_temp_c"              , PropertyNames::    Step::startTemp_c           },
          {ObjectStore::FieldType::Double, "step_time_mins"           , PropertyNames::    Step::stepTime_mins         },
          // Now we support BeerJSON, amount_l unifies and replaces infuseAmount_l and decoctionAmount_l
@@ -381,8 +413,8 @@ namespace {
          {ObjectStore::FieldType::Double, "start_temp_c"    , PropertyNames::Step::startTemp_c            },
          {ObjectStore::FieldType::Double, "end_temp_c"      , PropertyNames::Step::endTemp_c              },
          {ObjectStore::FieldType::Double, "ramp_time_mins"  , PropertyNames::Step::rampTime_mins          },
-         {ObjectStore::FieldType::Int   , "step_number"     , PropertyNames::Step::stepNumber             },
-         {ObjectStore::FieldType::Int   , "boil_id"         , PropertyNames::Step::ownerId                , &PRIMARY_TABLE<Boil>},
+         {ObjectStore::FieldType::Int   , "step_number"     , PropertyNames::Step::stepNumber             , {}, ObjectStore::SORT_KEY},
+         {ObjectStore::FieldType::Int   , "boil_id"         , PropertyNames::Step::ownerId                , &PRIMARY_TABLE<Boil>, ObjectStore::INDEXED},
          {ObjectStore::FieldType::String, "description"     , PropertyNames::Step::description            },
          {ObjectStore::FieldType::Double, "start_acidity_ph", PropertyNames::Step::startAcidity_pH        },
          {ObjectStore::FieldType::Double, "end_acidity_ph"  , PropertyNames::Step::endAcidity_pH          },
@@ -431,8 +463,8 @@ namespace {
          {ObjectStore::FieldType::Double, "step_time_mins"  , PropertyNames::Step::stepTime_mins          },
          {ObjectStore::FieldType::Double, "start_temp_c"    , PropertyNames::Step::startTemp_c            },
          {ObjectStore::FieldType::Double, "end_temp_c"      , PropertyNames::Step::endTemp_c              },
-         {ObjectStore::FieldType::Int   , "step_number"     , PropertyNames::Step::stepNumber             },
-         {ObjectStore::FieldType::Int   , "fermentation_id" , PropertyNames::Step::ownerId                , &PRIMARY_TABLE<Fermentation>},
+         {ObjectStore::FieldType::Int   , "step_number"     , PropertyNames::Step::stepNumber             , {}, ObjectStore::SORT_KEY},
+         {ObjectStore::FieldType::Int   , "fermentation_id" , PropertyNames::Step::ownerId                , &PRIMARY_TABLE<Fermentation>, ObjectStore::INDEXED},
          {ObjectStore::FieldType::String, "description"     , PropertyNames::Step::description            },
          {ObjectStore::FieldType::Double, "start_acidity_ph", PropertyNames::Step::startAcidity_pH        },
          {ObjectStore::FieldType::Double, "end_acidity_ph"  , PropertyNames::Step::  endAcidity_pH        },
@@ -458,7 +490,7 @@ namespace {
          {ObjectStore::FieldType::String, "folder"          , PropertyNames::FolderBase::folder                   },
          {ObjectStore::FieldType::Enum  , "mtype"           , PropertyNames::Misc::type                           , &Misc::typeStringMapping},
          {ObjectStore::FieldType::String, "use_for"         , PropertyNames::Misc::useFor                         },
-         {ObjectStore::FieldType::String, "notes"           , PropertyNames::Misc::notes                          },
+         {ObjectStore::FieldType::String, "notes"           , PropertyNames::Misc::notes, {}, ObjectStore::NOT_INDEXED, ObjectStore::LOAD_LAZILY},
          // ⮜⮜⮜ All below added for BeerJSON support ⮞⮞⮞
          {ObjectStore::FieldType::String, "producer"        , PropertyNames::Misc::producer                       },
          {ObjectStore::FieldType::String, "product_id"      , PropertyNames::Misc::productId                      },
@@ -472,7 +504,7 @@ namespace {
       "misc_in_inventory",
       {
          {ObjectStore::FieldType::Int   , "id"      , PropertyNames::NamedEntity::key                     },
-         {ObjectStore::FieldType::Int   , "misc_id" , PropertyNames::Inventory::ingredientId   , &PRIMARY_TABLE<Misc>},
+         {ObjectStore::FieldType::Int   , "misc_id" , PropertyNames::Inventory::ingredientId   , &PRIMARY_TABLE<Misc>, ObjectStore::INDEXED},
          {ObjectStore::FieldType::Double, "quantity", PropertyNames::IngredientAmount::quantity},
          {ObjectStore::FieldType::Unit  , "unit"    , PropertyNames::IngredientAmount::unit    , &Measurement::Units::unitStringMapping},
       }
@@ -505,7 +537,7 @@ namespace {
       "salt_in_inventory",
       {
          {ObjectStore::FieldType::Int   , "id"      , PropertyNames::NamedEntity::key                     },
-         {ObjectStore::FieldType::Int   , "salt_id" , PropertyNames::Inventory::ingredientId   , &PRIMARY_TABLE<Salt>},
+         {ObjectStore::FieldType::Int   , "salt_id" , PropertyNames::Inventory::ingredientId   , &PRIMARY_TABLE<Salt>, ObjectStore::INDEXED},
          {ObjectStore::FieldType::Double, "quantity", PropertyNames::IngredientAmount::quantity},
          {ObjectStore::FieldType::Unit  , "unit"    , PropertyNames::IngredientAmount::unit    , &Measurement::Units::unitStringMapping},
       }
@@ -605,7 +637,7 @@ namespace {
          {ObjectStore::FieldType::Int   , "max_reuse"                   , PropertyNames::Yeast::maxReuse                      },
          {ObjectStore::FieldType::String, "best_for"                    , PropertyNames::Yeast::bestFor                       },
          {ObjectStore::FieldType::String, "laboratory"                  , PropertyNames::Yeast::laboratory                    },
-         {ObjectStore::FieldType::String, "notes"                       , PropertyNames::Yeast::notes                         },
+         {ObjectStore::FieldType::String, "notes"                       , PropertyNames::Yeast::notes, {}, ObjectStore::NOT_INDEXED, ObjectStore::LOAD_LAZILY},
          {ObjectStore::FieldType::String, "product_id"                  , PropertyNames::Yeast::productId                     }, // Manufacturer's product ID, so, unlike other blah_id fields, not a foreign key!
          // ⮜⮜⮜ All below added for BeerJSON support ⮞⮞⮞
          {ObjectStore::FieldType::Double, "alcohol_tolerance_pct"       , PropertyNames::Yeast::alcoholTolerance_pct          },
@@ -628,7 +660,7 @@ namespace {
       "yeast_in_inventory",
       {
          {ObjectStore::FieldType::Int   , "id"            , PropertyNames::NamedEntity::key                     },
-         {ObjectStore::FieldType::Int   , "yeast_id"      , PropertyNames::Inventory::ingredientId   , &PRIMARY_TABLE<Yeast>},
+         {ObjectStore::FieldType::Int   , "yeast_id"      , PropertyNames::Inventory::ingredientId   , &PRIMARY_TABLE<Yeast>, ObjectStore::INDEXED},
          {ObjectStore::FieldType::Double, "quantity"      , PropertyNames::IngredientAmount::quantity},
          {ObjectStore::FieldType::Unit  , "unit"          , PropertyNames::IngredientAmount::unit    , &Measurement::Units::unitStringMapping},
       }
@@ -655,23 +687,23 @@ namespace {
          {ObjectStore::FieldType::Double, "carbonationtemp_c"  , PropertyNames::Recipe::carbonationTemp_c },
          {ObjectStore::FieldType::Date  , "date"               , PropertyNames::Recipe::date              },
          {ObjectStore::FieldType::Double, "efficiency"         , PropertyNames::Recipe::efficiency_pct    },
-         {ObjectStore::FieldType::Int   , "equipment_id"       , PropertyNames::Recipe::equipmentId       , &PRIMARY_TABLE<Equipment>},
+         {ObjectStore::FieldType::Int   , "equipment_id"       , PropertyNames::Recipe::equipmentId       , &PRIMARY_TABLE<Equipment>, ObjectStore::INDEXED},
          {ObjectStore::FieldType::Double, "fg"                 , PropertyNames::Recipe::fg                },
          {ObjectStore::FieldType::Bool  , "forced_carb"        , PropertyNames::Recipe::forcedCarbonation },
          {ObjectStore::FieldType::Double, "keg_priming_factor" , PropertyNames::Recipe::kegPrimingFactor  },
-         {ObjectStore::FieldType::Int   , "mash_id"            , PropertyNames::Recipe::mashId            , &PRIMARY_TABLE<Mash>},
-         {ObjectStore::FieldType::String, "notes"              , PropertyNames::Recipe::notes             },
+         {ObjectStore::FieldType::Int   , "mash_id"            , PropertyNames::Recipe::mashId            , &PRIMARY_TABLE<Mash>, ObjectStore::INDEXED},
+         {ObjectStore::FieldType::String, "notes"              , PropertyNames::Recipe::notes, {}, ObjectStore::NOT_INDEXED, ObjectStore::LOAD_LAZILY},
          {ObjectStore::FieldType::Double, "og"                 , PropertyNames::Recipe::og                },
          {ObjectStore::FieldType::Double, "priming_sugar_equiv", PropertyNames::Recipe::primingSugarEquiv },
          {ObjectStore::FieldType::String, "priming_sugar_name" , PropertyNames::Recipe::primingSugarName  },
-         {ObjectStore::FieldType::Int   , "style_id"           , PropertyNames::Recipe::styleId           , &PRIMARY_TABLE<Style>},
-         {ObjectStore::FieldType::String, "taste_notes"        , PropertyNames::Recipe::tasteNotes        },
+         {ObjectStore::FieldType::Int   , "style_id"           , PropertyNames::Recipe::styleId           , &PRIMARY_TABLE<Style>, ObjectStore::INDEXED},
+         {ObjectStore::FieldType::String, "taste_notes"        , PropertyNames::Recipe::tasteNotes, {}, ObjectStore::NOT_INDEXED, ObjectStore::LOAD_LAZILY},
          {ObjectStore::FieldType::Double, "taste_rating"       , PropertyNames::Recipe::tasteRating       },
          {ObjectStore::FieldType::Enum  , "type"               , PropertyNames::Recipe::type              , &Recipe::typeStringMapping},
          {ObjectStore::FieldType::Int   , "ancestor_id"        , PropertyNames::Recipe::ancestorId        , &PRIMARY_TABLE<Recipe>},
          {ObjectStore::FieldType::Bool  , "locked"             , PropertyNames::Recipe::locked            },
-         {ObjectStore::FieldType::Int   , "boil_id"            , PropertyNames::Recipe::boilId            , &PRIMARY_TABLE<Boil>},
-         {ObjectStore::FieldType::Int   , "fermentation_id"    , PropertyNames::Recipe::fermentationId    , &PRIMARY_TABLE<Fermentation>},
+         {ObjectStore::FieldType::Int   , "boil_id"            , PropertyNames::Recipe::boilId            , &PRIMARY_TABLE<Boil>, ObjectStore::INDEXED},
+         {ObjectStore::FieldType::Int   , "fermentation_id"    , PropertyNames::Recipe::fermentationId    , &PRIMARY_TABLE<Fermentation>, ObjectStore::INDEXED},
          // ⮜⮜⮜ All below added for BeerJSON support ⮞⮞⮞
          {ObjectStore::FieldType::Double, "beer_acidity_ph"         , PropertyNames::Recipe::beerAcidity_pH         },
          {ObjectStore::FieldType::Double, "apparent_attenuation_pct", PropertyNames::Recipe::apparentAttenuation_pct},
@@ -717,7 +749,7 @@ namespace {
          {ObjectStore::FieldType::String, "name"             , PropertyNames::NamedEntity::name               },
          {ObjectStore::FieldType::Bool  , "display"          , PropertyNames::NamedEntity::display            },
          {ObjectStore::FieldType::Bool  , "deleted"          , PropertyNames::NamedEntity::deleted            },
-         {ObjectStore::FieldType::Int   , "recipe_id"        , PropertyNames::OwnedByRecipe::recipeId         , &PRIMARY_TABLE<Recipe>     },
+         {ObjectStore::FieldType::Int   , "recipe_id"        , PropertyNames::OwnedByRecipe::recipeId         , &PRIMARY_TABLE<Recipe>     , ObjectStore::INDEXED},
          {ObjectStore::FieldType::Int   , "fermentable_id"   , PropertyNames::IngredientInRecipe::ingredientId, &PRIMARY_TABLE<Fermentable>},
          {ObjectStore::FieldType::Enum  , "stage"            , PropertyNames::RecipeAddition::stage           , &RecipeAddition::stageStringMapping},
          {ObjectStore::FieldType::Double, "quantity"         , PropertyNames::IngredientAmount::quantity      },
@@ -740,7 +772,7 @@ namespace {
          {ObjectStore::FieldType::String, "name"             , PropertyNames::NamedEntity::name               },
          {ObjectStore::FieldType::Bool  , "display"          , PropertyNames::NamedEntity::display            },
          {ObjectStore::FieldType::Bool  , "deleted"          , PropertyNames::NamedEntity::deleted            },
-         {ObjectStore::FieldType::Int   , "recipe_id"        , PropertyNames::OwnedByRecipe::recipeId         , &PRIMARY_TABLE<Recipe>},
+         {ObjectStore::FieldType::Int   , "recipe_id"        , PropertyNames::OwnedByRecipe::recipeId         , &PRIMARY_TABLE<Recipe>, ObjectStore::INDEXED},
          {ObjectStore::FieldType::Int   , "hop_id"           , PropertyNames::IngredientInRecipe::ingredientId, &PRIMARY_TABLE<Hop>   },
          {ObjectStore::FieldType::Enum  , "stage"            , PropertyNames::RecipeAddition::stage           , &RecipeAddition::stageStringMapping},
          {ObjectStore::FieldType::Double, "quantity"         , PropertyNames::IngredientAmount::quantity      },
@@ -763,7 +795,7 @@ namespace {
          {ObjectStore::FieldType::String, "name"             , PropertyNames::NamedEntity::name               },
          {ObjectStore::FieldType::Bool  , "display"          , PropertyNames::NamedEntity::display            },
          {ObjectStore::FieldType::Bool  , "deleted"          , PropertyNames::NamedEntity::deleted            },
-         {ObjectStore::FieldType::Int   , "recipe_id"        , PropertyNames::OwnedByRecipe::recipeId         , &PRIMARY_TABLE<Recipe>},
+         {ObjectStore::FieldType::Int   , "recipe_id"        , PropertyNames::OwnedByRecipe::recipeId         , &PRIMARY_TABLE<Recipe>, ObjectStore::INDEXED},
          {ObjectStore::FieldType::Int   , "misc_id"          , PropertyNames::IngredientInRecipe::ingredientId, &PRIMARY_TABLE<Misc>   },
          {ObjectStore::FieldType::Enum  , "stage"            , PropertyNames::RecipeAddition::stage           , &RecipeAddition::stageStringMapping},
          {ObjectStore::FieldType::Double, "quantity"         , PropertyNames::IngredientAmount::quantity      },
@@ -786,7 +818,7 @@ namespace {
          {ObjectStore::FieldType::String, "name"               , PropertyNames::NamedEntity::name                     },
          {ObjectStore::FieldType::Bool  , "display"            , PropertyNames::NamedEntity::display                  },
          {ObjectStore::FieldType::Bool  , "deleted"            , PropertyNames::NamedEntity::deleted                  },
-         {ObjectStore::FieldType::Int   , "recipe_id"          , PropertyNames::OwnedByRecipe::recipeId               , &PRIMARY_TABLE<Recipe>},
+         {ObjectStore::FieldType::Int   , "recipe_id"          , PropertyNames::OwnedByRecipe::recipeId               , &PRIMARY_TABLE<Recipe>, ObjectStore::INDEXED},
          {ObjectStore::FieldType::Int   , "yeast_id"           , PropertyNames::IngredientInRecipe::ingredientId      , &PRIMARY_TABLE<Yeast>   },
          {ObjectStore::FieldType::Enum  , "stage"              , PropertyNames::RecipeAddition::stage                 , &RecipeAddition::stageStringMapping},
          {ObjectStore::FieldType::Double, "quantity"           , PropertyNames::IngredientAmount::quantity            },
@@ -812,7 +844,7 @@ namespace {
          {ObjectStore::FieldType::String, "name"       , PropertyNames::NamedEntity::name               },
          {ObjectStore::FieldType::Bool  , "display"    , PropertyNames::NamedEntity::display            },
          {ObjectStore::FieldType::Bool  , "deleted"    , PropertyNames::NamedEntity::deleted            },
-         {ObjectStore::FieldType::Int   , "recipe_id"  , PropertyNames::OwnedByRecipe::recipeId         , &PRIMARY_TABLE<Recipe>},
+         {ObjectStore::FieldType::Int   , "recipe_id"  , PropertyNames::OwnedByRecipe::recipeId         , &PRIMARY_TABLE<Recipe>, ObjectStore::INDEXED},
          {ObjectStore::FieldType::Int   , "salt_id"    , PropertyNames::IngredientInRecipe::ingredientId, &PRIMARY_TABLE<Salt>   },
          {ObjectStore::FieldType::Double, "quantity"   , PropertyNames::IngredientAmount::quantity      },
          {ObjectStore::FieldType::Unit  , "unit"       , PropertyNames::IngredientAmount::unit          , &Measurement::Units::unitStringMapping},
@@ -830,7 +862,7 @@ namespace {
          {ObjectStore::FieldType::String, "name"     , PropertyNames::NamedEntity::name               },
          {ObjectStore::FieldType::Bool  , "display"  , PropertyNames::NamedEntity::display            },
          {ObjectStore::FieldType::Bool  , "deleted"  , PropertyNames::NamedEntity::deleted            },
-         {ObjectStore::FieldType::Int   , "recipe_id", PropertyNames::OwnedByRecipe::recipeId         , &PRIMARY_TABLE<Recipe>},
+         {ObjectStore::FieldType::Int   , "recipe_id", PropertyNames::OwnedByRecipe::recipeId         , &PRIMARY_TABLE<Recipe>, ObjectStore::INDEXED},
          {ObjectStore::FieldType::Int   , "water_id" , PropertyNames::IngredientInRecipe::ingredientId, &PRIMARY_TABLE<Water>   },
          {ObjectStore::FieldType::Double, "volume_l" , PropertyNames::RecipeUseOfWater::volume_l      },
       }
@@ -857,7 +889,7 @@ namespace {
          {ObjectStore::FieldType::Double, "fg"                     , PropertyNames::BrewNote::fg               },
          {ObjectStore::FieldType::Double, "final_volume"           , PropertyNames::BrewNote::finalVolume_l    },
          {ObjectStore::FieldType::Double, "mash_final_temp"        , PropertyNames::BrewNote::mashFinTemp_c    },
-         {ObjectStore::FieldType::String, "notes"                  , PropertyNames::BrewNote::notes            },
+         {ObjectStore::FieldType::String, "notes"                  , PropertyNames::BrewNote::notes, {}, ObjectStore::NOT_INDEXED, ObjectStore::LOAD_LAZILY},
          {ObjectStore::FieldType::Double, "og"                     , PropertyNames::BrewNote::og               },
          {ObjectStore::FieldType::Double, "pitch_temp"             , PropertyNames::BrewNote::pitchTemp_c      },
          {ObjectStore::FieldType::Double, "post_boil_volume"       , PropertyNames::BrewNote::postBoilVolume_l },
@@ -877,7 +909,7 @@ namespace {
          {ObjectStore::FieldType::Double, "strike_temp"            , PropertyNames::BrewNote::strikeTemp_c     },
          {ObjectStore::FieldType::Double, "volume_into_bk"         , PropertyNames::BrewNote::volumeIntoBK_l   },
          {ObjectStore::FieldType::Double, "volume_into_fermenter"  , PropertyNames::BrewNote::volumeIntoFerm_l },
-         {ObjectStore::FieldType::Int   , "recipe_id"              , PropertyNames::OwnedByRecipe::recipeId    , &PRIMARY_TABLE<Recipe>},
+         {ObjectStore::FieldType::Int   , "recipe_id"              , PropertyNames::OwnedByRecipe::recipeId    , &PRIMARY_TABLE<Recipe>, ObjectStore::INDEXED},
       }
    };
    // BrewNotes don't have children
@@ -887,12 +919,18 @@ namespace {
 
 
 template<class NE>
-ObjectStoreTyped<NE> & ObjectStoreTyped<NE>::getInstance() {
+ObjectStoreTyped<NE> & ObjectStoreTyped<NE>::getUnloadedInstance() {
    //
    // As of C++11, simple "Meyers singleton" is now thread-safe -- see
    // https://www.modernescpp.com/index.php/thread-safe-initialization-of-a-singleton#h3-guarantees-of-the-c-runtime
    //
    static ObjectStoreTyped<NE> ostSingleton{NE::typeLookup, PRIMARY_TABLE<NE>, JUNCTION_TABLES<NE>};
+   return ostSingleton;
+}
+
+template<class NE>
+ObjectStoreTyped<NE> & ObjectStoreTyped<NE>::getInstance() {
+   ObjectStoreTyped<NE> & ostSingleton = ObjectStoreTyped<NE>::getUnloadedInstance();
 
    // C++11 provides a thread-safe way to ensure singleton.loadAll() is called exactly once
    //
@@ -905,7 +943,7 @@ ObjectStoreTyped<NE> & ObjectStoreTyped<NE>::getInstance() {
 }
 
 //
-// We have to make sure that each version of the above function gets instantiated.  NOTE: This is the 1st of 3 places we
+// We have to make sure that each version of the above function gets instantiated.  NOTE: This is the 1st of 4 places we
 // need to add any new ObjectStoreTyped
 //
 // You might think the use in InitialiseAllObjectStores below is sufficient for this, but the GCC linker says
@@ -940,11 +978,315 @@ template ObjectStoreTyped<Style                    > & ObjectStoreTyped<Style
 template ObjectStoreTyped<Water                    > & ObjectStoreTyped<Water                    >::getInstance();
 template ObjectStoreTyped<Yeast                    > & ObjectStoreTyped<Yeast                    >::getInstance();
 
+namespace {
+   /**
+    * \brief What the start-up loader needs to know about each \c ObjectStoreTyped
+    */
+   struct StartupLoader {
+      char const * name;
+      //! The store, which we must not access via \c getInstance until we have called \c prefetchAll on it
+      ObjectStore & unloadedStore;
+      //! Calls \c getInstance, which in turn calls \c loadAll and creates the objects from the prefetched rows
+      std::function<void()> publish;
+   };
+
+   template<class NE>
+   StartupLoader makeStartupLoader(char const * name) {
+      return StartupLoader{name,
+                           ObjectStoreTyped<NE>::getUnloadedInstance(),
+                           []() { ObjectStoreTyped<NE>::getInstance(); return; }};
+   }
+
+   //
+   // The start-up snapshot file (see SaveObjectStoreSnapshot) is:
+   //    - snapshotMagic, snapshotFormatVersion and the version of the program that wrote it
+   //    - the marker from sqliteFileMarker at the time it was written
+   //    - the number of stores, then, for each store, its name and the data from ObjectStore::writeSnapshot
+   //
+   // Bump snapshotFormatVersion when changing any of this (or what ObjectStore::writeSnapshot writes).
+   //
+   constexpr quint32 snapshotMagic = 0x42545353; // "BTSS"
+   constexpr quint32 snapshotFormatVersion = 1;
+   constexpr QDataStream::Version snapshotStreamVersion = QDataStream::Qt_5_15;
+
+   QString snapshotFileName() {
+      return PersistentSettings::getUserDataDir().filePath("objectStoreSnapshot.bin");
+   }
+
+   //! \return \c true if we should be reading and writing the start-up snapshot
+   bool usingSnapshot() {
+      return PersistentSettings::value(PersistentSettings::Names::startupSnapshot, false).toBool() &&
+             Database::instance().dbType() == Database::DbType::SQLITE;
+   }
+
+   /**
+    * \return Something that changes whenever the SQLite DB file does, or empty if we can't tell (in particular, if the
+    *         write-ahead log has anything in it, as it means there are changes not yet in the main DB file).
+    *
+    *        We use the size and modification time of the file and the "file change counter" that SQLite keeps at byte
+    *        offset 24 of the file header (see https://www.sqlite.org/fileformat.html).  None of these change when we
+    *        just read the DB.
+    */
+   QByteArray sqliteFileMarker(QString const & dbFileName) {
+      QFileInfo const walFileInfo{dbFileName + "-wal"};
+      if (walFileInfo.exists() && walFileInfo.size() > 0) {
+         return QByteArray{};
+      }
+
+      QFile dbFile{dbFileName};
+      if (!dbFile.open(QIODevice::ReadOnly) || !dbFile.seek(24)) {
+         return QByteArray{};
+      }
+      QByteArray const fileChangeCounter = dbFile.read(4);
+      if (fileChangeCounter.size() != 4) {
+         return QByteArray{};
+      }
+
+      QFileInfo const dbFileInfo{dbFileName};
+      QByteArray marker;
+      QDataStream markerStream{&marker, QIODevice::WriteOnly};
+      markerStream << dbFileInfo.size() << dbFileInfo.lastModified().toMSecsSinceEpoch() << fileChangeCounter;
+      return marker;
+   }
+
+   /**
+    * \brief Memory-map the start-up snapshot, if there is one and it is for the DB as it is now.
+    *
+    * \param snapshotFile Must stay open for as long as the returned data is used, as it points into the mapped file
+    *
+    * \return Store name -> data for \c ObjectStore::readSnapshot, or empty if there is no snapshot we can use
+    */
+   QHash<QString, QByteArray> mapSnapshot(QFile & snapshotFile) {
+      if (!usingSnapshot()) {
+         return {};
+      }
+
+      QByteArray const marker = sqliteFileMarker(Database::instance().sqliteFileName());
+      snapshotFile.setFileName(snapshotFileName());
+      if (marker.isEmpty() || !snapshotFile.open(QIODevice::ReadOnly)) {
+         return {};
+      }
+      qint64 const fileSize = snapshotFile.size();
+      uchar const * const mappedFile = snapshotFile.map(0, fileSize);
+      if (!mappedFile) {
+         qCWarning(Logging::database) <<
+            Q_FUNC_INFO << "Unable to map" << snapshotFile.fileName() << ":" << snapshotFile.errorString();
+         return {};
+      }
+
+      // We don't copy the contents of the file, just point into its mapped memory
+      QByteArray const contents = QByteArray::fromRawData(reinterpret_cast<char const *>(mappedFile),
+                                                          static_cast<int>(fileSize));
+      QDataStream stream{contents};
+      stream.setVersion(snapshotStreamVersion);
+
+      quint32 magic = 0;
+      quint32 formatVersion = 0;
+      QString programVersion;
+      QByteArray snapshotMarker;
+      quint32 numStores = 0;
+      stream >> magic >> formatVersion >> programVersion >> snapshotMarker >> numStores;
+      if (stream.status() != QDataStream::Ok || magic != snapshotMagic || formatVersion != snapshotFormatVersion ||
+          programVersion != CONFIG_VERSION_STRING) {
+         qCInfo(Logging::database) << Q_FUNC_INFO << "Ignoring start-up snapshot from different version";
+         return {};
+      }
+      if (snapshotMarker != marker) {
+         qCInfo(Logging::database) << Q_FUNC_INFO << "Ignoring start-up snapshot as DB has changed since";
+         return {};
+      }
+
+      QHash<QString, QByteArray> sections;
+      for (quint32 ii = 0; ii < numStores; ++ii) {
+         QString storeName;
+         // This is how QDataStream writes the size of a QByteArray
+         quint32 sectionSize = 0;
+         stream >> storeName >> sectionSize;
+         qint64 const sectionStart = stream.device()->pos();
+         if (stream.status() != QDataStream::Ok || sectionStart + sectionSize > fileSize) {
+            qCWarning(Logging::database) << Q_FUNC_INFO << "Start-up snapshot is corrupt";
+            return {};
+         }
+         sections.insert(storeName, QByteArray::fromRawData(contents.constData() + sectionStart,
+                                                            static_cast<int>(sectionSize)));
+         stream.skipRawData(static_cast<int>(sectionSize));
+      }
+      return sections;
+   }
+
+   //! \return The object stores in the order in which start-up should create their objects
+   QVector<StartupLoader> const & getStartupLoaders() {
+      //
+      // NOTE: This is the 4th of 4 places we need to add any new ObjectStoreTyped
+      //
+      // The order is the order in which we publish (ie create the objects), and is such that things come after the
+      // things they refer to.  (It's not a disaster if we get this wrong, as ObjectStoreTyped<NE>::getInstance() will
+      // load dependencies on demand, but it keeps the logs easier to follow.)
+      //
+      static QVector<StartupLoader> const startupLoaders {
+    *
+    *        Reading (ie running the SELECT statements and converting the results into \c NamedParameterBundle etc) is
+    *        independent for each table, so it is safe to do on worker threads.  \c Database::sqlDatabase() gives each
+    *        thread its own connection.  Creating the objects is not something we want to do off the main thread,
+    *        because (a) they are \c QObject and would pick up the wrong thread affinity and (b) constructors and
+    *        setters of one type can look up objects in other stores.  Hence the two phases.
+    */
+         makeStartupLoader<Equipment                >("Equipment"                ),
+         makeStartupLoader<Fermentable              >("Fermentable"              ),
+         makeStartupLoader<Hop                      >("Hop"                      ),
+         makeStartupLoader<Misc                     >("Misc"                     ),
+         makeStartupLoader<Salt                     >("Salt"                     ),
+         makeStartupLoader<Style                    >("Style"                    ),
+         makeStartupLoader<Water                    >("Water"                    ),
+         makeStartupLoader<Yeast                    >("Yeast"                    ),
+         makeStartupLoader<InventoryFermentable     >("InventoryFermentable"     ),
+         makeStartupLoader<InventoryHop             >("InventoryHop"             ),
+         makeStartupLoader<InventoryMisc            >("InventoryMisc"            ),
+         makeStartupLoader<InventorySalt            >("InventorySalt"            ),
+         makeStartupLoader<InventoryYeast           >("InventoryYeast"           ),
+         makeStartupLoader<Mash                     >("Mash"                     ),
+         makeStartupLoader<MashStep                 >("MashStep"                 ),
+         makeStartupLoader<Boil                     >("Boil"                     ),
+         makeStartupLoader<BoilStep                 >("BoilStep"                 ),
+         makeStartupLoader<Fermentation             >("Fermentation"             ),
+         makeStartupLoader<FermentationStep         >("FermentationStep"         ),
+         makeStartupLoader<Instruction              >("Instruction"              ),
+         makeStartupLoader<Recipe                   >("Recipe"                   ),
+         makeStartupLoader<RecipeAdditionFermentable>("RecipeAdditionFermentable"),
+         makeStartupLoader<RecipeAdditionHop        >("RecipeAdditionHop"        ),
+         makeStartupLoader<RecipeAdditionMisc       >("RecipeAdditionMisc"       ),
+         makeStartupLoader<RecipeAdditionYeast      >("RecipeAdditionYeast"      ),
+         makeStartupLoader<RecipeAdjustmentSalt     >("RecipeAdjustmentSalt"     ),
+         makeStartupLoader<RecipeUseOfWater         >("RecipeUseOfWater"         ),
+         makeStartupLoader<BrewNote                 >("BrewNote"                 ),
+      };
+      return startupLoaders;
+   }
+
+   /**
+    * \brief Read all the not-yet-loaded object stores from the DB in parallel, then create their objects on the
+    *        calling thread.
+    *
+    *        Reading (ie running the SELECT statements and converting the results into \c NamedParameterBundle etc) is
+    *        independent for each table, so it is safe to do on worker threads.  \c Database::sqlDatabase() gives each
+    *        thread its own connection.  Creating the objects is not something we want to do off the main thread,
+    *        because (a) they are \c QObject and would pick up the wrong thread affinity and (b) constructors and
+    *        setters of one type can look up objects in other stores.  Hence the two phases.
+    *
+    *        If we have a usable start-up snapshot, the worker threads read from that rather than the DB.
+    */
+   void loadAllObjectStoresInParallel() {
+      QVector<StartupLoader> const & startupLoaders = getStartupLoaders();
+
+      // We get the Database instance here, on the main thread, so the worker threads don't have to
+      Database & database = Database::instance();
+
+      QElapsedTimer timer;
+      timer.start();
+
+      // Needs to stay open until the worker threads are done, as snapshotSections point into it
+      QFile snapshotFile;
+      QHash<QString, QByteArray> const snapshotSections = mapSnapshot(snapshotFile);
+
+      QThreadPool threadPool;
+      int numPrefetched = 0;
+      for (auto const & startupLoader : startupLoaders) {
+         // Stores that have already been loaded (eg because something needed them earlier in start-up) are skipped
+         if (startupLoader.unloadedStore.state() == ObjectStore::State::NotYetInitialised) {
+            ObjectStore * store = &startupLoader.unloadedStore;
+            QByteArray const snapshotSection = snapshotSections.value(startupLoader.name);
+            threadPool.start(QRunnable::create([store, snapshotSection, &database]() {
+               if (!snapshotSection.isEmpty()) {
+                  QDataStream stream{snapshotSection};
+                  stream.setVersion(snapshotStreamVersion);
+                  if (store->readSnapshot(stream)) {
+                     return;
+                  }
+               }
+               store->prefetchAll(&database);
+               return;
+            }));
+            ++numPrefetched;
+         }
+      }
+      threadPool.waitForDone();
+      qint64 const prefetchTime = timer.restart();
+
+      for (auto const & startupLoader : startupLoaders) {
+         startupLoader.publish();
+      }
+
+      qCInfo(Logging::database) <<
+         Q_FUNC_INFO << "Read" << numPrefetched << "object stores from" <<
+         (snapshotSections.isEmpty() ? "DB" : "start-up snapshot") << "on" << threadPool.maxThreadCount() <<
+         "threads in" << prefetchTime << "ms; created objects in" << timer.elapsed() << "ms";
+      return;
+   }
+}
+
+QByteArray MakeObjectStoreSnapshot() {
+   // If we didn't get as far as loading the DB, there's nothing we want to snapshot
+   if (!usingSnapshot() || !Database::instance().loadSuccessful()) {
+      return QByteArray{};
+   }
+
+   QElapsedTimer timer;
+   timer.start();
+
+   QVector<StartupLoader> const & startupLoaders = getStartupLoaders();
+   QByteArray snapshotContents;
+   QDataStream stream{&snapshotContents, QIODevice::WriteOnly};
+   stream.setVersion(snapshotStreamVersion);
+   stream << static_cast<quint32>(startupLoaders.size());
+   for (auto const & startupLoader : startupLoaders) {
+      QByteArray snapshotSection;
+      QDataStream sectionStream{&snapshotSection, QIODevice::WriteOnly};
+      sectionStream.setVersion(snapshotStreamVersion);
+      if (!startupLoader.unloadedStore.writeSnapshot(sectionStream)) {
+         return QByteArray{};
+      }
+      stream << QString{startupLoader.name} << snapshotSection;
+   }
+
+   qCInfo(Logging::database) <<
+      Q_FUNC_INFO << "Made" << snapshotContents.size() << "byte start-up snapshot in" << timer.elapsed() << "ms";
+   return snapshotContents;
+}
+
+void SaveObjectStoreSnapshot(QByteArray const & snapshotContents) {
+   QString const fileName = snapshotFileName();
+   QByteArray const marker = snapshotContents.isEmpty() ?
+      QByteArray{} : sqliteFileMarker(Database::instance().sqliteFileName());
+   if (marker.isEmpty()) {
+      // Either we're not doing snapshots, or we wouldn't be able to tell next time whether the one we have is usable
+      QFile::remove(fileName);
+      return;
+   }
+
+   // Write to a temporary file and then rename, so we never leave a half-written snapshot
+   QSaveFile snapshotFile{fileName};
+   if (!snapshotFile.open(QIODevice::WriteOnly)) {
+      qCWarning(Logging::database) << Q_FUNC_INFO << "Unable to write" << fileName << ":" << snapshotFile.errorString();
+      return;
+   }
+   QDataStream stream{&snapshotFile};
+   stream.setVersion(snapshotStreamVersion);
+   stream << snapshotMagic << snapshotFormatVersion << QString{CONFIG_VERSION_STRING} << marker;
+   stream.writeRawData(snapshotContents.constData(), snapshotContents.size());
+   if (stream.status() != QDataStream::Ok || !snapshotFile.commit()) {
+      qCWarning(Logging::database) << Q_FUNC_INFO << "Error writing" << fileName;
+      QFile::remove(fileName);
+   }
+   return;
+}
+
 bool InitialiseAllObjectStores(QString & errorMessage) {
+   loadAllObjectStoresInParallel();
+
    // It's deliberate that we don't stop after the first error.  If there is a problem, it's quite useful to know how
    // extensive it is.
    QStringList errors;
-   // NOTE: This is the 2nd of 3 places we need to add any new ObjectStoreTyped
+   // NOTE: This is the 2nd of 4 places we need to add any new ObjectStoreTyped
    if (ObjectStoreTyped<Boil                     >::getInstance().state() == ObjectStore::State::ErrorInitialising) { errors << "Boil"                     ; }
    if (ObjectStoreTyped<BoilStep                 >::getInstance().state() == ObjectStore::State::ErrorInitialising) { errors << "BoilStep"                 ; }
    if (ObjectStoreTyped<BrewNote                 >::getInstance().state() == ObjectStore::State::ErrorInitialising) { errors << "BrewNote"                 ; }
@@ -984,7 +1326,7 @@ bool InitialiseAllObjectStores(QString & errorMessage) {
 
 namespace {
    QVector<ObjectStore const *> getAllObjectStores() {
-      // NOTE: This is the 3rd of 3 places we need to add any new ObjectStoreTyped
+      // NOTE: This is the 3rd of 4 places we need to add any new ObjectStoreTyped
       static QVector<ObjectStore const *> allObjectStores {
          &ObjectStoreTyped<Boil                     >::getInstance(),
          &ObjectStoreTyped<BoilStep                 >::getInstance(),
@@ -1019,8 +1361,392 @@ namespace {
    }
 }
 
+void HydrateAllObjectStores() {
+   for (ObjectStore const * objectStore : getAllObjectStores()) {
+      objectStore->hydrateAll();
+   }
+   return;
+}
+
+namespace {
+   //! How long to collect change notifications before applying them
+   constexpr int changeNotificationDelay_ms = 500;
+
+   //! Table name -> IDs of changed objects, for change notifications we have received but not yet applied
+   QHash<QString, QSet<int>> pendingDbChanges;
+
+   void applyPendingDbChanges() {
+      //
+      // Make sure our own queued and in-flight writes (including their completion handling) are done before we read
+      // anything back, so we don't overwrite a newer in-memory value with an older one from the DB.
+      //
+      ObjectStore::flushPendingPropertyUpdates();
+      ObjectStore::waitForAsyncOperations();
+      QCoreApplication::sendPostedEvents(nullptr, QEvent::MetaCall);
+
+      QHash<QString, QSet<int>> changes;
+      changes.swap(pendingDbChanges);
+      for (ObjectStore const * objectStore : getAllObjectStores()) {
+         auto const ids = changes.constFind(*objectStore->primaryTableName());
+         if (ids != changes.cend()) {
+            qCDebug(Logging::database) <<
+               Q_FUNC_INFO << ids->size() << "change(s) to" << objectStore->primaryTableName();
+            // The stores are only const in getAllObjectStores() because most of its callers don't modify them
+            const_cast<ObjectStore *>(objectStore)->refreshFromDb(*ids);
+         }
+      }
+      return;
+   }
+
+   void handleDbNotification(QString const & channel,
+                             QSqlDriver::NotificationSource const source,
+                             QVariant const & payload) {
+      if (channel != ObjectStore::changeNotificationChannel || source == QSqlDriver::SelfSource) {
+         return;
+      }
+
+      // Payload is "<table name>,<object ID>" -- see ObjectStore::createChangeNotificationTriggers
+      QStringList const tableAndId = payload.toString().split(',');
+      bool idOk = false;
+      int const id = tableAndId.size() == 2 ? tableAndId[1].toInt(&idOk) : 0;
+      if (!idOk) {
+         qCWarning(Logging::database) << Q_FUNC_INFO << "Ignoring unexpected payload" << payload << "on" << channel;
+         return;
+      }
+
+      if (pendingDbChanges.isEmpty()) {
+         QTimer::singleShot(changeNotificationDelay_ms, QCoreApplication::instance(), &applyPendingDbChanges);
+      }
+      pendingDbChanges[tableAndId[0]].insert(id);
+      return;
+   }
+}
+
+void SubscribeToDatabaseChanges() {
+   Database & database = Database::instance();
+   if (database.dbType() != Database::DbType::PGSQL ||
+       !PersistentSettings::value(PersistentSettings::Names::dbChangeNotifications, false).toBool()) {
+      return;
+   }
+
+   QSqlDriver * driver = database.sqlDatabase().driver();
+   if (!driver->subscribeToNotification(ObjectStore::changeNotificationChannel)) {
+      qCWarning(Logging::database) <<
+         Q_FUNC_INFO << "Unable to subscribe to" << ObjectStore::changeNotificationChannel << "notifications:" <<
+         driver->lastError().text();
+      return;
+   }
+
+   QObject::connect(driver,
+                    qOverload<QString const &, QSqlDriver::NotificationSource, QVariant const &>(
+                       &QSqlDriver::notification
+                    ),
+                    QCoreApplication::instance(),
+                    &handleDbNotification);
+   qCInfo(Logging::database) << Q_FUNC_INFO << "Listening for changes made to the DB by other users";
+   return;
+}
+
+QVector<ObjectStore const *> GetAllObjectStores() {
+   return getAllObjectStores();
+}
+
+void PurgeSoftDeletedObjects() {
+   QElapsedTimer timer;
+   timer.start();
+
+   // Make sure the DB is up-to-date with our own changes before we look at what is safe to delete
+   ObjectStore::flushPendingPropertyUpdates();
+   ObjectStore::waitForAsyncOperations();
+   QCoreApplication::sendPostedEvents(nullptr, QEvent::MetaCall);
+
+   QVector<BtStringConst const *> const ownerProperties{&PropertyNames::OwnedByRecipe::recipeId,
+                                                        &PropertyNames::Step::ownerId};
+   Database & database = Database::instance();
+   QSqlDatabase connection = database.sqlDatabase();
+   int numPurged = 0;
+   {
+      // As in DefaultContentLoader, doing all the hard deletes inside one transaction makes them a lot quicker
+      DbTransaction dbTransaction{database, connection, "Purge soft-deleted"};
+      //
+      // Purging an object from one store can mean objects in another store are no longer referred to (eg a Style that
+      // was only used by a deleted Recipe), but we don't go round again for these.  They'll get picked up next time.
+      //
+      for (ObjectStore const * objectStore : getAllObjectStores()) {
+         QStringList referencingQueries;
+         for (ObjectStore const * referencingStore : getAllObjectStores()) {
+            referencingStore->appendReferencingQueries(*objectStore, ownerProperties, referencingQueries);
+         }
+         // As in applyPendingDbChanges, the cast is OK because getAllObjectStores only gives const pointers for the
+         // convenience of its other callers
+         numPurged += const_cast<ObjectStore *>(objectStore)->purgeSoftDeleted(referencingQueries);
+      }
+      dbTransaction.commit();
+   }
+
+   qint64 const bytesReclaimed = numPurged > 0 ? database.compact() : 0;
+   qCInfo(Logging::database) <<
+      Q_FUNC_INFO << "Purged" << numPurged << "soft-deleted objects from DB and memory, reclaiming" << bytesReclaimed <<
+      "bytes of DB file, in" << timer.elapsed() << "ms";
+   return;
+}
+
+DatabaseIntegrityReport CheckDatabaseIntegrity(bool const repair) {
+   QElapsedTimer timer;
+   timer.start();
+
+   // As in PurgeSoftDeletedObjects, make sure the DB is up-to-date with our own changes before we look at it
+   ObjectStore::flushPendingPropertyUpdates();
+   ObjectStore::waitForAsyncOperations();
+   QCoreApplication::sendPostedEvents(nullptr, QEvent::MetaCall);
+
+   QVector<BtStringConst const *> const ownerProperties{&PropertyNames::OwnedByRecipe::recipeId,
+                                                        &PropertyNames::Step::ownerId};
+   QVector<ObjectStore const *> const allObjectStores = getAllObjectStores();
+   QVector<QVector<ObjectStore::IntegrityCheck>> checks;
+   checks.reserve(allObjectStores.size());
+   for (ObjectStore const * objectStore : allObjectStores) {
+      checks.append(objectStore->integrityChecks(ownerProperties));
+   }
+
+   //
+   // Each worker only writes to its own (pre-sized) element of the results, so they don't need any locking.  As in
+   // loadAllObjectStoresInParallel, we get the Database instance here so the worker threads don't have to.
+   //
+   Database & database = Database::instance();
+   QVector<QVector<DatabaseIntegrityProblem>> problemsByStore(allObjectStores.size());
+   std::atomic<bool> checksSucceeded{true};
+   {
+      QThreadPool threadPool;
+      for (int ii = 0; ii < allObjectStores.size(); ++ii) {
+         if (checks[ii].isEmpty()) {
+            continue;
+         }
+         threadPool.start(QRunnable::create([&checks, &problemsByStore, &checksSucceeded, &database, ii]() {
+            QSqlDatabase connection = database.sqlDatabase();
+            for (ObjectStore::IntegrityCheck const & check : checks[ii]) {
+               BtSqlQuery sqlQuery{connection};
+               if (!sqlQuery.exec(check.query)) {
+                  qCCritical(Logging::database) <<
+                     Q_FUNC_INFO << "Error executing database query " << check.query << ": " <<
+                     sqlQuery.lastError().text();
+                  checksSucceeded = false;
+                  continue;
+               }
+               DatabaseIntegrityProblem problem{.description = check.description, .ids = {}};
+               while (sqlQuery.next()) {
+                  problem.ids.append(sqlQuery.value(0).toInt());
+               }
+               if (!problem.ids.isEmpty()) {
+                  problemsByStore[ii].append(problem);
+               }
+            }
+            return;
+         }));
+      }
+      threadPool.waitForDone();
+   }
+
+   DatabaseIntegrityReport report;
+   report.checksSucceeded = checksSucceeded;
+   for (auto const & problems : problemsByStore) {
+      report.problems << problems;
+   }
+
+   if (repair && !report.problems.isEmpty()) {
+      QSqlDatabase connection = database.sqlDatabase();
+      DbTransaction dbTransaction{database, connection, "Repair integrity"};
+      bool succeeded = true;
+      for (int ii = 0; ii < allObjectStores.size() && succeeded; ++ii) {
+         if (problemsByStore[ii].isEmpty()) {
+            continue;
+         }
+         //
+         // We run all the repairs for a store that has problems rather than just the ones for the checks that found
+         // something, as eg removing a cycle of parents can leave a parent with a parent.  Repairs that have nothing to
+         // fix don't change anything.
+         //
+         for (ObjectStore::IntegrityCheck const & check : checks[ii]) {
+            for (QString const & statement : check.repair) {
+               BtSqlQuery sqlQuery{connection};
+               if (!sqlQuery.exec(statement)) {
+                  qCCritical(Logging::database) <<
+                     Q_FUNC_INFO << "Error executing database query " << statement << ": " <<
+                     sqlQuery.lastError().text();
+                  succeeded = false;
+                  break;
+               }
+               report.rowsRepaired += std::max(sqlQuery.numRowsAffected(), 0);
+            }
+         }
+      }
+      if (succeeded) {
+         dbTransaction.commit();
+         report.repaired = true;
+         for (int ii = 0; ii < allObjectStores.size(); ++ii) {
+            QSet<int> ids;
+            for (DatabaseIntegrityProblem const & problem : problemsByStore[ii]) {
+               ids.unite(QSet<int>{problem.ids.cbegin(), problem.ids.cend()});
+            }
+            if (!ids.isEmpty()) {
+               // As in PurgeSoftDeletedObjects, the cast is OK because getAllObjectStores only gives const pointers
+               const_cast<ObjectStore *>(allObjectStores[ii])->refreshFromDb(ids);
+            }
+         }
+      } else {
+         report.rowsRepaired = 0;
+      }
+   }
+
+   report.elapsed_ms = timer.elapsed();
+   qCInfo(Logging::database) <<
+      Q_FUNC_INFO << "Found" << report.problems.size() << "integrity problem(s)" <<
+      (report.checksSucceeded ? "" : "(some checks failed)") << "in" << allObjectStores.size() << "object stores" <<
+      (report.repaired ? QString{"and repaired %1 row(s)"}.arg(report.rowsRepaired) : QString{}) << "in" <<
+      report.elapsed_ms << "ms";
+   return report;
+}
+
+namespace {
+   /**
+    * \brief Do the work of \c CompactDuplicateIngredients for one type of ingredient, adding what we did to \c report.
+    *        Must be called inside a transaction.
+    */
+   template<class Ingr, class RA>
+   void compactDuplicates(IngredientCompactionReport & report) {
+      using Inv = typename Ingr::InventoryClass;
+      ObjectStoreTyped<Ingr> & ingredientStore = ObjectStoreTyped<Ingr>::getInstance();
+      std::size_t const bytesBefore = ingredientStore.estimatedCacheBytes();
+
+      //
+      // Equal objects have equal fingerprints, so we only need to compare objects within each group that shares a
+      // fingerprint.  The first of each set of equal objects is kept, so we put the ones the user can see (and then
+      // lower IDs) first.
+      //
+      QHash<std::size_t, QVector<Ingr *>> ingredientsByFingerprint;
+      ingredientStore.forEach([&ingredientsByFingerprint](Ingr * ingredient) {
+         ingredientsByFingerprint[ingredient->fingerprint()].append(ingredient);
+         return;
+      });
+      // Duplicate -> the object we keep instead
+      QVector<std::pair<Ingr *, Ingr *>> duplicates;
+      for (QVector<Ingr *> & ingredients : ingredientsByFingerprint) {
+         if (ingredients.size() < 2) {
+            continue;
+         }
+         std::sort(ingredients.begin(), ingredients.end(), [](Ingr const * lhs, Ingr const * rhs) {
+            if (lhs->display() != rhs->display()) {
+               return lhs->display();
+            }
+            return lhs->key() < rhs->key();
+         });
+         QVector<Ingr *> kept;
+         for (Ingr * ingredient : ingredients) {
+            //
+            // Only hidden copies (ie what used to be "child" objects, and ones soft-deleted since) are merged, as
+            // removing an ingredient the user can see would surprise them.  We also leave alone copies with
+            // inventory, rather than have to decide how to combine it.
+            //
+            auto const original = std::find_if(kept.cbegin(), kept.cend(), [ingredient](Ingr const * candidate) {
+               return *candidate == *ingredient;
+            });
+            if (original != kept.cend() && !ingredient->display() &&
+                ObjectStoreTyped<Inv>::getInstance().idsByIndex(PropertyNames::Inventory::ingredientId,
+                                                                ingredient->key()).isEmpty()) {
+               duplicates.append({ingredient, *original});
+            } else {
+               kept.append(ingredient);
+            }
+         }
+      }
+      if (duplicates.isEmpty()) {
+         return;
+      }
+
+      // The ingredient ID column of recipe additions isn't indexed, so we do one pass to find them all
+      QHash<int, QVector<RA *>> additionsByIngredient;
+      ObjectStoreTyped<RA>::getInstance().forEach([&additionsByIngredient](RA * addition) {
+         additionsByIngredient[addition->ingredientId()].append(addition);
+         return;
+      });
+      for (auto const & [duplicate, original] : duplicates) {
+         for (RA * addition : additionsByIngredient.value(duplicate->key())) {
+            addition->setIngredientId(original->key());
+            ++report.additionsRepointed;
+         }
+      }
+      // The additions must point elsewhere in the DB before we can delete what they used to point to
+      ObjectStore::flushPendingPropertyUpdates();
+      for (auto const & [duplicate, original] : duplicates) {
+         qCDebug(Logging::database) <<
+            Q_FUNC_INFO << "Merging" << Ingr::staticMetaObject.className() << "#" << duplicate->key() << "into #" <<
+            original->key();
+         ingredientStore.hardDelete(duplicate->key());
+         ++report.duplicatesRemoved;
+      }
+      report.cacheBytesSaved += bytesBefore - ingredientStore.estimatedCacheBytes();
+      return;
+   }
+}
+
+IngredientCompactionReport CompactDuplicateIngredients() {
+   QElapsedTimer timer;
+   timer.start();
+
+   // As in PurgeSoftDeletedObjects, make sure the DB is up-to-date before we start
+   ObjectStore::flushPendingPropertyUpdates();
+   ObjectStore::waitForAsyncOperations();
+   QCoreApplication::sendPostedEvents(nullptr, QEvent::MetaCall);
+
+   IngredientCompactionReport report;
+   Database & database = Database::instance();
+   QSqlDatabase connection = database.sqlDatabase();
+   {
+      DbTransaction dbTransaction{database, connection, "Compact duplicate ingredients"};
+      compactDuplicates<Fermentable, RecipeAdditionFermentable>(report);
+      compactDuplicates<Hop        , RecipeAdditionHop        >(report);
+      compactDuplicates<Misc       , RecipeAdditionMisc       >(report);
+      compactDuplicates<Yeast      , RecipeAdditionYeast      >(report);
+      compactDuplicates<Salt       , RecipeAdjustmentSalt     >(report);
+      dbTransaction.commit();
+   }
+
+   report.dbBytesReclaimed = report.duplicatesRemoved > 0 ? database.compact() : 0;
+   qCInfo(Logging::database) <<
+      Q_FUNC_INFO << "Removed" << report.duplicatesRemoved << "duplicate ingredients, repointing" <<
+      report.additionsRepointed << "recipe additions, saving" << report.cacheBytesSaved << "bytes of cache and" <<
+      report.dbBytesReclaimed << "bytes of DB file, in" << timer.elapsed() << "ms";
+   return report;
+}
+
+void ScheduleDatabaseMaintenance() {
+   int const intervalDays =
+      PersistentSettings::value(PersistentSettings::Names::dbMaintenanceIntervalDays, 30).toInt();
+   if (intervalDays <= 0) {
+      return;
+   }
+   QDateTime const lastMaintenance =
+      PersistentSettings::value(PersistentSettings::Names::lastDbMaintenance, QDateTime{}).toDateTime();
+   QDateTime const now = QDateTime::currentDateTime();
+   if (lastMaintenance.isValid() && lastMaintenance.daysTo(now) < intervalDays) {
+      return;
+   }
+
+   //
+   // We don't want to slow down start-up, so this runs once the event loop is going.  Anything the user soft-deletes
+   // in this session will still be around for undo, because we only look at the DB once, before they have had a chance
+   // to do much.
+   //
+   QTimer::singleShot(0, QCoreApplication::instance(), []() {
+      PurgeSoftDeletedObjects();
+      PersistentSettings::insert(PersistentSettings::Names::lastDbMaintenance, QDateTime::currentDateTime());
+      return;
+   });
+   return;
+}
+
 bool CreateAllDatabaseTables(Database & database, QSqlDatabase & connection) {
-   qDebug() << Q_FUNC_INFO;
+   qCDebug(Logging::database) << Q_FUNC_INFO;
    for (auto ii : getAllObjectStores()) {
       if (!ii->createTables(database, connection)) {
          return false;
@@ -1031,6 +1757,78 @@ bool CreateAllDatabaseTables(Database & database, QSqlDatabase & connection) {
          return false;
       }
    }
+   if (!CreateAllDatabaseIndexes(connection)) {
+      return false;
+   }
+   if (!SearchIndex::createTables(database, connection)) {
+      return false;
+   }
+   if (!RecipeCalculationCache::createTables(database, connection)) {
+      return false;
+   }
+   if (!SensorReadings::createTables(database, connection)) {
+      return false;
+   }
+   if (!ChangeLog::createTables(database, connection)) {
+      return false;
+   }
+   if (!EnumCodes::createTables(database, connection) || !LoadAllEnumCodes(connection) ||
+       !CreateAllReadableViews(connection)) {
+      return false;
+   }
+   if (database.dbType() == Database::DbType::PGSQL) {
+      return CreateAllChangeNotificationTriggers(connection);
+   }
+   return true;
+}
+
+bool CreateAllDatabaseIndexes(QSqlDatabase & connection) {
+   qCDebug(Logging::database) << Q_FUNC_INFO;
+   for (auto ii : getAllObjectStores()) {
+      if (!ii->createIndexes(connection)) {
+         return false;
+      }
+   }
+   return true;
+}
+
+bool CreateAllChangeNotificationTriggers(QSqlDatabase & connection) {
+   qCDebug(Logging::database) << Q_FUNC_INFO;
+   for (auto ii : getAllObjectStores()) {
+      if (!ii->createChangeNotificationTriggers(connection)) {
+         return false;
+      }
+   }
+   return true;
+}
+
+bool LoadAllEnumCodes(QSqlDatabase & connection) {
+   qCDebug(Logging::database) << Q_FUNC_INFO;
+   for (auto ii : getAllObjectStores()) {
+      if (!EnumCodes::load(connection, ii->primaryTableName(), ii->primaryTableFields())) {
+         return false;
+      }
+   }
+   return true;
+}
+
+bool CreateAllReadableViews(QSqlDatabase & connection) {
+   qCDebug(Logging::database) << Q_FUNC_INFO;
+   for (auto ii : getAllObjectStores()) {
+      if (!EnumCodes::createView(connection, ii->primaryTableName(), ii->primaryTableFields())) {
+         return false;
+      }
+   }
+   return true;
+}
+
+bool DropAllReadableViews(QSqlDatabase & connection) {
+   qCDebug(Logging::database) << Q_FUNC_INFO;
+   for (auto ii : getAllObjectStores()) {
+      if (!EnumCodes::dropView(connection, ii->primaryTableName())) {
+         return false;
+      }
+   }
    return true;
 }
 
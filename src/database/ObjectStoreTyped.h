@@ -21,7 +21,10 @@
 #include <QDebug>
 
 #include "database/ObjectStore.h"
+#include "Logging.h"
 #include "model/NamedEntity.h"
+#include "utils/Diagnostics.h"
+#include "utils/PoolAllocator.h"
 
 /**
  * \brief Read, write and cache any subclass of \c NamedEntity in the database
@@ -52,6 +55,13 @@ public:
     */
    static ObjectStoreTyped<NE> & getInstance();
 
+   /**
+    * \brief Get the singleton instance of this class WITHOUT triggering \c loadAll.  This is only for the start-up
+    *        loader (see \c InitialiseAllObjectStores), which needs to call \c prefetchAll beforehand.  Everything else
+    *        should use \c getInstance.
+    */
+   static ObjectStoreTyped<NE> & getUnloadedInstance();
+
    using ObjectStore::insert;
 
    /**
@@ -69,6 +79,34 @@ public:
       return this->ObjectStore::insert(std::static_pointer_cast<QObject>(ne));
    }
 
+   using ObjectStore::insertMany;
+
+   /**
+    * \brief Insert several new objects in the DB (and in our cache list) in one go.  See \c ObjectStore::insertMany.
+    */
+   QVector<int> insertMany(QList<std::shared_ptr<NE> > const & nes) {
+      QList<std::shared_ptr<QObject> > objects;
+      objects.reserve(nes.size());
+      for (auto ne : nes) {
+         // Same as in insert() above
+         ne->setDeleted(false);
+         objects.append(std::static_pointer_cast<QObject>(ne));
+      }
+      return this->ObjectStore::insertMany(objects);
+   }
+
+   using ObjectStore::insertAsync;
+
+   /**
+    * \brief Insert a new object in the DB (and in our cache list) without waiting for the DB.  See
+    *        \c ObjectStore::insertAsync.
+    */
+   QFuture<int> insertAsync(std::shared_ptr<NE> ne) {
+      // Same as in insert() above
+      ne->setDeleted(false);
+      return this->ObjectStore::insertAsync(std::static_pointer_cast<QObject>(ne));
+   }
+
    /**
     * \brief Insert a copy of an existing object in the DB (and in our cache list)
     *
@@ -80,12 +118,13 @@ public:
       // From the supplied ID, get a shared pointer to the object we want to copy
       auto otherNe = this->getById(id);
       if (!otherNe) {
-         qWarning() << Q_FUNC_INFO << "Unable to find object #" << id;
+         qCWarning(Logging::database) << Q_FUNC_INFO << "Unable to find object #" << id;
       }
 
       // If we found an object with the supplied ID, make a copy, using the copy constructor (which should do the right
       // thing about parentage etc).  If not, which shouldn't really happen, make a default object.
-      auto copyNe = otherNe ? std::make_shared<NE>(*otherNe) : std::make_shared<NE>();
+      auto copyNe = otherNe ? std::allocate_shared<NE>(PoolAllocator<NE>{}, *otherNe) :
+                              std::allocate_shared<NE>(PoolAllocator<NE>{});
 
       // Add the copied object to the database and our object cache, and return it to the caller
       this->insert(copyNe);
@@ -100,7 +139,7 @@ public:
     * \return ID of the newly-inserted object in the database
     */
    int insert(NE & ne) {
-      qWarning() << Q_FUNC_INFO << "Deprecated function";
+      qCWarning(Logging::database) << Q_FUNC_INFO << "Deprecated function";
       std::shared_ptr<NE> nePointer{&ne};
       return this->insert(nePointer);
    }
@@ -125,7 +164,7 @@ public:
     * \return ID of what was inserted or updated
     */
    int insertOrUpdate(NE & ne) {
-      qWarning() << Q_FUNC_INFO << "Deprecated function";
+      qCWarning(Logging::database) << Q_FUNC_INFO << "Deprecated function";
       int id = ne.key();
       if (id > 0) {
          std::shared_ptr<NE> nep = this->getById(id);
@@ -143,7 +182,7 @@ public:
     */
    std::shared_ptr<NE> getById(int id) const {
       if (!this->contains(id)) {
-         qDebug() << Q_FUNC_INFO << "ID" << id << "not found amongst" << this->size() << "objects";
+         qCDebug(Logging::database) << Q_FUNC_INFO << "ID" << id << "not found amongst" << this->size() << "objects";
          return nullptr;
       }
       return std::static_pointer_cast<NE>(this->ObjectStore::getById(id));
@@ -215,6 +254,27 @@ public:
       return std::shared_ptr<NE>{std::static_pointer_cast<NE>(result)};
    }
 
+   /**
+    * \brief Version of \c findFirstMatching that only looks at objects whose \c NamedEntity::fingerprint is
+    *        \c fingerprint.  Typically \c matchFunction will include a test of \c operator== against an object with
+    *        that fingerprint.
+    *
+    * \return The lowest-ID object with \c fingerprint that gives a \c true result to \c matchFunction, or \c nullptr
+    *         if none does
+    */
+   std::shared_ptr<NE> findFirstMatchingFingerprint(
+      std::size_t const fingerprint,
+      std::function<bool(std::shared_ptr<NE>)> const & matchFunction
+   ) const {
+      for (int const id : this->idsByFingerprint(fingerprint)) {
+         auto ne = std::static_pointer_cast<NE>(this->ObjectStore::getById(id));
+         if (ne && matchFunction(ne)) {
+            return ne;
+         }
+      }
+      return nullptr;
+   }
+
    /**
     * \brief Alternate version of \c findFirstMatching that uses raw pointers
     *
@@ -276,6 +336,38 @@ public:
       );
    }
 
+   /**
+    * \brief Call \c functor on every cached object, passing it \c NE \c *.  Unlike the member functions above that take
+    *        \c std::function, this is a template, so the compiler can inline \c functor into what is just a loop over
+    *        an array of pointers.
+    */
+   template<class Functor>
+   void forEach(Functor && functor) const {
+      for (std::shared_ptr<QObject> const & object : this->allCachedObjects()) {
+         functor(static_cast<NE *>(object.get()));
+      }
+      return;
+   }
+
+   /**
+    * \brief Templated version of the raw pointer version of \c findAllMatching, for when the scan is performance
+    *        critical.  See \c forEach.
+    *
+    * \param matchFunction Takes \c NE \c * (or \c NE \c const \c *) and returns \c true if the object is a match or
+    *                      \c false otherwise.
+    */
+   template<class Functor>
+   QList<NE *> findAllMatchingRaw(Functor && matchFunction) const {
+      QList<NE *> results;
+      this->forEach([&results, &matchFunction](NE * ne) {
+         if (matchFunction(ne)) {
+            results.append(ne);
+         }
+         return;
+      });
+      return results;
+   }
+
    /**
     * \brief Similary to \c findAllMatching but returns a list of IDs
     */
@@ -285,6 +377,21 @@ public:
       );
    }
 
+   /**
+    * \brief Indexed lookup of all cached objects whose \c propertyName property has the value \c value.  See
+    *        \c ObjectStore::idsByIndex.
+    */
+   QList<std::shared_ptr<NE> > findByIndex(BtStringConst const & propertyName, int const value) const {
+      return this->convertShared(this->ObjectStore::findByIndex(propertyName, value));
+   }
+
+   /**
+    * \brief Raw pointer version of \c findByIndex
+    */
+   QList<NE *> findByIndexRaw(BtStringConst const & propertyName, int const value) const {
+      return this->convertRaw(this->ObjectStore::findByIndex(propertyName, value));
+   }
+
    /**
     * \brief Special case of \c findAllMatching that returns a list of all cached objects of a given type
     */
@@ -304,12 +411,22 @@ protected:
     */
    virtual std::shared_ptr<QObject> createNewObject(NamedParameterBundle & namedParameterBundle) {
       //
-      // NB: std::static_pointer_cast actually creates a new instance of std::shared_ptr (whose stored pointer is
-      // obtained from its parameter's stored pointer using a cast expression).  So there is no point creating a
-      // shared_ptr of one type if we're straight away going to cast it to another type; just create the type we need
-      // in the first place.
+      // We allocate from a per-type pool (see utils/PoolAllocator.h) so that the object and its shared_ptr control
+      // block come out of one allocation, and objects loaded one after another sit next to each other in memory.
       //
-      return std::shared_ptr<QObject>(new NE{namedParameterBundle});
+      // NB: The implicit conversion to std::shared_ptr<QObject> here shares ownership with (rather than copies) the
+      // std::shared_ptr<NE> we create.
+      //
+      return std::allocate_shared<NE>(PoolAllocator<NE>{}, namedParameterBundle);
+   }
+
+   virtual void hardDeleteObject(int id) {
+      this->hardDelete(id);
+      return;
+   }
+
+   virtual std::size_t objectSize() const {
+      return sizeof(NE);
    }
 
 private:
@@ -320,11 +437,11 @@ private:
     * \param hard \c true for hard delete, \c false for soft delete
     */
    std::shared_ptr<NE> hardOrSoftDelete(int id, bool hard) {
-      qDebug() <<
+      qCDebug(Logging::database) <<
          Q_FUNC_INFO << (hard ? "Hard" : "Soft") << "delete " << NE::staticMetaObject.className() << " #" << id;
       if (id <= 0 || !this->contains(id)) {
          // Trying to delete a non-existent object is a coding error, but might be recoverable
-         qWarning() <<
+         qCWarning(Logging::database) <<
             Q_FUNC_INFO << "Trying to delete non-existent " << NE::staticMetaObject.className() << " with ID" << id;
          return std::shared_ptr<NE>{};
       }
@@ -355,6 +472,7 @@ private:
       // of the UI that need to know that an object was deleted.  (In the hard delete case, this signal will already
       // have been emitted.)
       emit this->signalObjectDeleted(id, object);
+      Diagnostics::recordSignalEmitted(NE::staticMetaObject.className(), "signalObjectDeleted");
 
       return ne;
    }
@@ -414,6 +532,14 @@ private:
  *              function was called.  They will not be initialised twice.  If any failed initialisation then that WILL
  *              be picked up by this function and reported as an error.
  *
+ *        Any stores not already initialised are read from the DB in parallel (on a thread pool, with one DB connection
+ *        per thread) and then have their objects created on the calling thread, in an order where things that are
+ *        referred to (eg \c Hop) come before things that refer to them (eg \c RecipeAdditionHop).  Timings for each
+ *        store are logged.
+ *
+ *        If the \c startupSnapshot setting is on and the snapshot written by \c SaveObjectStoreSnapshot at the end of
+ *        the last run matches the DB, the stores are read from that instead of the DB.
+ *
  * \param errorMessage OUT - In the event of an error, will hold info suitable for showing to the user about which
  *                           stores could not be initialised.
  *
@@ -421,6 +547,115 @@ private:
  */
 bool InitialiseAllObjectStores(QString & errorMessage);
 
+/**
+ * \brief If the \c startupSnapshot setting is on and the DB is SQLite, read the contents of all the object stores'
+ *        tables, ready for \c SaveObjectStoreSnapshot.  Must be called while the DB is still open, typically at shut
+ *        down, after anything that might still write to the DB.
+ *
+ * \return The snapshot contents, or empty if we are not doing snapshots or something went wrong
+ */
+QByteArray MakeObjectStoreSnapshot();
+
+/**
+ * \brief Write \c snapshotContents (from \c MakeObjectStoreSnapshot) to the start-up snapshot file, along with a marker
+ *        identifying the current state of the DB file, so that \c InitialiseAllObjectStores can use it next time
+ *        instead of reading the DB, provided the DB has not changed in the meantime.  Must be called after the DB is
+ *        closed (\c Database::unload), as SQLite can modify the DB file when it closes it.
+ *
+ *        If \c snapshotContents is empty, any existing snapshot is removed.
+ */
+void SaveObjectStoreSnapshot(QByteArray const & snapshotContents);
+
+/**
+ * \brief In lazy loading mode (see \c ObjectStore::loadAll), create all objects that have not yet been created, in all
+ *        object stores.  Must be called on the main thread.
+ *
+ *        Normally, objects are created on demand when they are first accessed.  This is no good if they are about to be
+ *        accessed from several threads at once (eg by \c ParallelRender), as it would mean modifying the stores (and
+ *        creating \c QObject instances) on those threads.  So this needs to be called first.
+ */
+void HydrateAllObjectStores();
+
+/**
+ * \brief If the DB is PostgreSQL and the \c dbChangeNotifications setting is on, start listening for the notifications
+ *        sent by the triggers that \c CreateAllChangeNotificationTriggers adds, so that changes other users make to the
+ *        DB show up here.  Must be called on the main thread, after \c InitialiseAllObjectStores.
+ *
+ *        Notifications for changes we made ourselves are ignored.  The others are collected for a short while, so that,
+ *        eg, a recipe someone else has just saved is refreshed once rather than once per changed row, and then passed
+ *        to \c ObjectStore::refreshFromDb on the relevant store(s).
+ */
+void SubscribeToDatabaseChanges();
+
+/**
+ * \brief Hard delete, from all the object stores (and the DB), soft-deleted objects that nothing else refers to, then
+ *        compact the DB (see \c Database::compact).  What was reclaimed is logged.  Must be called on the main thread.
+ *
+ *        Typically called via \c ScheduleDatabaseMaintenance rather than directly.
+ */
+void PurgeSoftDeletedObjects();
+
+struct IngredientCompactionReport {
+   //! Ingredient rows deleted
+   int         duplicatesRemoved  = 0;
+   //! Recipe addition rows changed to refer to the ingredient that was kept
+   int         additionsRepointed = 0;
+   //! Estimated, as per \c ObjectStore::estimatedCacheBytes
+   std::size_t cacheBytesSaved    = 0;
+   qint64      dbBytesReclaimed   = 0;
+};
+
+/**
+ * \brief Merge hidden copies of ingredients into identical ones we are keeping.  Historically, adding an ingredient to a
+ *        recipe made a copy of it, so a long-used DB can hold large numbers of identical hidden copies, all of which
+ *        are loaded into memory.
+ *
+ *        Identical objects are found by fingerprint (see \c NamedEntity::fingerprint) and confirmed with
+ *        \c operator==.  Recipe additions using a copy are changed to use the ingredient we are keeping, and then the
+ *        copy is deleted, all in one transaction, after which the DB is compacted.  Must be called on the main thread.
+ */
+IngredientCompactionReport CompactDuplicateIngredients();
+
+struct DatabaseIntegrityProblem {
+   //! As \c ObjectStore::IntegrityCheck::description
+   QString      description;
+   //! Primary keys of the affected objects
+   QVector<int> ids;
+};
+
+struct DatabaseIntegrityReport {
+   QVector<DatabaseIntegrityProblem> problems;
+   //! False if any of the check queries failed (in which case there could be problems we didn't find)
+   bool   checksSucceeded = true;
+   //! Only set if repairs were requested and done
+   bool   repaired        = false;
+   //! Total number of rows changed or deleted by the repairs
+   int    rowsRepaired    = 0;
+   qint64 elapsed_ms      = 0;
+};
+
+/**
+ * \brief Run all the \c ObjectStore::integrityChecks (ie look for broken references, cycles of parents and parents with
+ *        parents) against the DB, one thread per object store, and, if \c repair is \c true, fix whatever was found,
+ *        in one transaction, and bring the affected objects in memory up to date.  Must be called on the main thread.
+ *
+ *        Complements \c Database::checkIntegrity, which checks the DB file itself and the foreign key constraints the
+ *        DB knows about.
+ */
+DatabaseIntegrityReport CheckDatabaseIntegrity(bool const repair);
+
+/**
+ * \return All the object stores, eg so that \c Diagnostics can report on them
+ */
+QVector<ObjectStore const *> GetAllObjectStores();
+
+/**
+ * \brief If it is more than \c dbMaintenanceIntervalDays (default 30, 0 meaning never) since we last did so, schedule
+ *        \c PurgeSoftDeletedObjects to run on the main thread once start-up is finished.  Must be called on the main
+ *        thread, after \c InitialiseAllObjectStores.
+ */
+void ScheduleDatabaseMaintenance();
+
 /**
  * \brief Does what it says on the tin.  Note that it is the caller's responsibility to handle transactions.
  *
@@ -431,6 +666,43 @@ bool InitialiseAllObjectStores(QString & errorMessage);
  */
 bool CreateAllDatabaseTables(Database & database, QSqlDatabase & connection);
 
+/**
+ * \brief Add any missing indexes on foreign key columns to all the tables.  (This is done as part of
+ *        \c CreateAllDatabaseTables, so is only needed separately when upgrading an existing database.)  Note that it
+ *        is the caller's responsibility to handle transactions.
+ *
+ * \return false if something went wrong, true otherwise
+ */
+bool CreateAllDatabaseIndexes(QSqlDatabase & connection);
+
+/**
+ * \brief PostgreSQL only: add (or replace) the triggers used by \c SubscribeToDatabaseChanges on all the tables.  (This
+ *        is done as part of \c CreateAllDatabaseTables for PostgreSQL, so is only needed separately when upgrading an
+ *        existing database.)  Note that it is the caller's responsibility to handle transactions.
+ *
+ * \return false if something went wrong, true otherwise
+ */
+bool CreateAllChangeNotificationTriggers(QSqlDatabase & connection);
+
+/**
+ * \brief Read the codes of stored-as-code enum and unit fields (see \c EnumCodes) for all the tables, adding codes for
+ *        any values that don't have one yet.  This needs to be done, on the main thread, after the schema is up to
+ *        date and before any objects are read in.  (It is also done as part of \c CreateAllDatabaseTables.)
+ *
+ * \return false if something went wrong, true otherwise
+ */
+bool LoadAllEnumCodes(QSqlDatabase & connection);
+
+/**
+ * \brief (Re)create, or drop, the views (see \c EnumCodes::createView) that show the strings for stored-as-code
+ *        columns.  Creating is done as part of \c CreateAllDatabaseTables; schema migrations drop the views at the
+ *        start and recreate them at the end.  Note that it is the caller's responsibility to handle transactions.
+ *
+ * \return false if something went wrong, true otherwise
+ */
+bool CreateAllReadableViews(QSqlDatabase & connection);
+bool DropAllReadableViews(QSqlDatabase & connection);
+
 /**
  * \brief Write all data in all object stores to a new database
  *
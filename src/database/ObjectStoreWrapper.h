@@ -16,7 +16,10 @@
 #ifndef DATABASE_OBJECTSTOREWRAPPER_H
 #define DATABASE_OBJECTSTOREWRAPPER_H
 #pragma once
+#include <utility>
+
 #include "database/ObjectStoreTyped.h"
+#include "Logging.h"
 
 /**
  * \brief Namespace containing convenience functions for accessing member functions of appropriate ObjectStoreTyped
@@ -76,6 +79,13 @@ namespace ObjectStoreWrapper {
       return ObjectStoreTyped<NE>::getInstance().getAllRaw();
    }
 
+   /**
+    * \brief See \c ObjectStore::snapshot.  Must be called on the GUI thread, but the result can be used on any thread.
+    */
+   template<class NE> ObjectStore::Snapshot snapshot() {
+      return ObjectStoreTyped<NE>::getInstance().snapshot();
+   }
+
    /**
     * \brief Gets only those objects which are:
     *          - marked displayable
@@ -83,7 +93,7 @@ namespace ObjectStoreWrapper {
     *          - do not have a parent (ie are not "an instance of use of"
     */
    template<class NE> QList<NE *> getAllDisplayableRaw() {
-      return ObjectStoreTyped<NE>::getInstance().findAllMatching(
+      return ObjectStoreTyped<NE>::getInstance().findAllMatchingRaw(
          [](NE const * ne) { return (ne->display() && !ne->deleted() && ne->getParentKey() <= 0); }
       );
    }
@@ -104,7 +114,7 @@ namespace ObjectStoreWrapper {
       // If the object isn't stored in the DB then we can create a shared pointer for it, but this is dangerous as there
       // might already be another shared pointer to it.  At minimum we should log a warning.  In the long run we should
       // Q_ASSERT(false) here.
-      qWarning() <<
+      qCWarning(Logging::database) <<
          Q_FUNC_INFO << "Creating new shared_ptr for unstored" << ne->metaObject()->className() << "#" << id << " :" <<
          ne->name() << ".  This may be a bug - eg if a shared_ptr already exists for this object!";
       return std::shared_ptr<NE>{ne};
@@ -143,10 +153,35 @@ namespace ObjectStoreWrapper {
     *        get called twice and, sooner or later, we'll get a segfault.
     */
    template<class NE> int insert(NE & ne) {
-      qWarning() << Q_FUNC_INFO << "Deprecated function";
+      qCWarning(Logging::database) << Q_FUNC_INFO << "Deprecated function";
       return ObjectStoreTyped<NE>::getInstance().insert(ne);
    }
 
+   /**
+    * \brief Preferred way of inserting lots of new objects in a store at once.  See \c ObjectStore::insertMany.
+    *
+    * \return IDs of the inserted objects, or an empty list if there was an error (in which case nothing was inserted)
+    */
+   template<class NE> QVector<int> insertBatch(QList<std::shared_ptr<NE> > const & nes) {
+      return ObjectStoreTyped<NE>::getInstance().insertMany(nes);
+   }
+
+   /**
+    * \brief Insert a new object without waiting for the DB.  See \c ObjectStore::insertAsync.
+    *
+    * \return Future that will give the ID of the newly-inserted object, or -1 if there was an error
+    */
+   template<class NE> QFuture<int> insertAsync(std::shared_ptr<NE> ne) {
+      return ObjectStoreTyped<NE>::getInstance().insertAsync(ne);
+   }
+
+   /**
+    * \brief Update an existing object without waiting for the DB.  See \c ObjectStore::updateAsync.
+    */
+   template<class NE> QFuture<bool> updateAsync(std::shared_ptr<NE> ne) {
+      return ObjectStoreTyped<NE>::getInstance().updateAsync(std::static_pointer_cast<QObject>(ne));
+   }
+
    template<class NE> std::shared_ptr<NE> insertCopyOf(NE const & ne) {
       return ObjectStoreTyped<NE>::getInstance().insertCopyOf(ne.key());
    }
@@ -157,7 +192,7 @@ namespace ObjectStoreWrapper {
    }
 
    template<class NE> int insertOrUpdate(NE & ne) {
-      qWarning() << Q_FUNC_INFO << "Deprecated function";
+      qCWarning(Logging::database) << Q_FUNC_INFO << "Deprecated function";
       return ObjectStoreTyped<NE>::getInstance().insertOrUpdate(static_cast<QObject &>(ne));
    }
 
@@ -166,6 +201,11 @@ namespace ObjectStoreWrapper {
       return;
    }
 
+   template<class NE> void updateProperties(NE const & ne, QVector<BtStringConst const *> const & propertyNames) {
+      ObjectStoreTyped<NE>::getInstance().updateProperties(ne, propertyNames);
+      return;
+   }
+
    template<class NE> std::shared_ptr<NE> softDelete(NE const & ne) {
       return ObjectStoreTyped<NE>::getInstance().softDelete(ne.key());
    }
@@ -220,11 +260,47 @@ namespace ObjectStoreWrapper {
       return ObjectStoreTyped<NE>::getInstance().findAllMatching(matchFunction);
    }
 
+   /**
+    * \brief See \c ObjectStoreTyped::forEach
+    */
+   template<class NE, class Functor> void forEach(Functor && functor) {
+      ObjectStoreTyped<NE>::getInstance().forEach(std::forward<Functor>(functor));
+      return;
+   }
+
+   /**
+    * \brief See \c ObjectStoreTyped::findAllMatchingRaw
+    */
+   template<class NE, class Functor> QList<NE *> findAllMatchingRaw(Functor && matchFunction) {
+      return ObjectStoreTyped<NE>::getInstance().findAllMatchingRaw(std::forward<Functor>(matchFunction));
+   }
+
    template<class NE>
    QVector<int> idsOfAllMatching(std::function<bool(NE const *)> const & matchFunction) {
       return ObjectStoreTyped<NE>::getInstance().idsOfAllMatching(matchFunction);
    }
 
+   /**
+    * \brief Indexed alternative to \c findAllMatching for looking up objects by the value of an indexed property, eg
+    *        \c findByIndex<RecipeAdditionHop>(PropertyNames::OwnedByRecipe::recipeId, recipe.key()).  See
+    *        \c ObjectStore::Indexing for which properties can be used.
+    */
+   template<class NE> QList<std::shared_ptr<NE> > findByIndex(BtStringConst const & propertyName, int const value) {
+      return ObjectStoreTyped<NE>::getInstance().findByIndex(propertyName, value);
+   }
+
+   template<class NE> QList<NE *> findByIndexRaw(BtStringConst const & propertyName, int const value) {
+      return ObjectStoreTyped<NE>::getInstance().findByIndexRaw(propertyName, value);
+   }
+
+   template<class NE> QVector<int> idsByIndex(BtStringConst const & propertyName, int const value) {
+      return ObjectStoreTyped<NE>::getInstance().idsByIndex(propertyName, value);
+   }
+
+   template<class NE> bool hasIndex(BtStringConst const & propertyName) {
+      return ObjectStoreTyped<NE>::getInstance().hasIndex(propertyName);
+   }
+
    /**
     * \brief Given two IDs of some subclass of \c NamedEntity, return \c true if the corresponding objects are equal (or
     *        if both IDs are invalid), and \c false otherwise
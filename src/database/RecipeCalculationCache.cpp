@@ -0,0 +1,300 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * database/RecipeCalculationCache.cpp is part of Brewtarget, and is copyright the following authors 2024:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#include "database/RecipeCalculationCache.h"
+
+#include <utility>
+#include <vector>
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QSet>
+#include <QSqlError>
+#include <QStringList>
+#include <QThread>
+#include <QTimer>
+#include <QVariant>
+
+#include "database/BtSqlQuery.h"
+#include "database/Database.h"
+#include "database/DbTransaction.h"
+#include "database/ObjectStoreWrapper.h"
+#include "Logging.h"
+#include "model/Recipe.h"
+
+namespace {
+   QLatin1String const cacheTableName{"recipe_calculated_values"};
+
+   /**
+    * \brief How long to collect newly calculated values before writing them out.  Editing a recipe usually means a
+    *        recalculation per keystroke, and we only want to write the result.
+    */
+   int constexpr flushDelay_ms = 1000;
+
+   //! One numeric column of the table, and the bit of \c RecipeEvaluator::Results it holds
+   struct ValueColumn {
+      char const * name;
+      double & (*value)(RecipeEvaluator::Results & results);
+   };
+
+   std::vector<ValueColumn> const & valueColumns() {
+      using Results = RecipeEvaluator::Results;
+      static std::vector<ValueColumn> const columns {
+         {"grains_kg"               , [](Results & rr) -> double & { return rr.grains.grains_kg;                }},
+         {"grains_in_mash_kg"       , [](Results & rr) -> double & { return rr.grains.grainsInMash_kg;          }},
+         {"wort_from_mash_l"        , [](Results & rr) -> double & { return rr.volumes.wortFromMash_l;          }},
+         {"boil_volume_l"           , [](Results & rr) -> double & { return rr.volumes.boilVolume_l;            }},
+         {"final_volume_l"          , [](Results & rr) -> double & { return rr.volumes.finalVolume_l;           }},
+         {"final_volume_no_losses_l", [](Results & rr) -> double & { return rr.volumes.finalVolumeNoLosses_l;   }},
+         {"post_boil_volume_l"      , [](Results & rr) -> double & { return rr.volumes.postBoilVolume_l;        }},
+         {"og"                      , [](Results & rr) -> double & { return rr.gravities.og;                    }},
+         {"fg"                      , [](Results & rr) -> double & { return rr.gravities.fg;                    }},
+         {"og_fermentable"          , [](Results & rr) -> double & { return rr.gravities.og_fermentable;        }},
+         {"fg_fermentable"          , [](Results & rr) -> double & { return rr.gravities.fg_fermentable;        }},
+         {"color_srm"               , [](Results & rr) -> double & { return rr.color_srm;                       }},
+         {"abv_pct"                 , [](Results & rr) -> double & { return rr.ABV_pct;                         }},
+         {"boil_grav"               , [](Results & rr) -> double & { return rr.boilGrav;                        }},
+         {"ibu"                     , [](Results & rr) -> double & { return rr.IBU;                             }},
+         {"calories_per_liter"      , [](Results & rr) -> double & { return rr.caloriesPerLiter;                }},
+      };
+      return columns;
+   }
+
+   struct Entry {
+      std::size_t              inputFingerprint;
+      RecipeEvaluator::Results results;
+   };
+
+   //! Set once we've read in what's in the DB
+   bool loaded = false;
+   QHash<int, Entry> entries;
+   //! Recipes whose entries need writing out at the next \c RecipeCalculationCache::flushPendingUpdates
+   QSet<int> pendingRecipeIds;
+   bool flushScheduled = false;
+
+   //
+   // Fingerprints are stored as hex text, as not every DB we support has an unsigned 64-bit integer type.  Similarly,
+   // the IBUs of each hop addition are stored as a comma-separated list, with enough digits to get back exactly the
+   // same doubles.
+   //
+   QString fingerprintToText(std::size_t const inputFingerprint) {
+      return QString::number(static_cast<quint64>(inputFingerprint), 16);
+   }
+
+   QString ibusToText(QList<double> const & ibus) {
+      QStringList values;
+      for (double const value : ibus) {
+         values.append(QString::number(value, 'g', 17));
+      }
+      return values.join(',');
+   }
+
+   QList<double> ibusFromText(QString const & text) {
+      QList<double> ibus;
+      for (QString const & value : text.split(',', Qt::SkipEmptyParts)) {
+         ibus.append(value.toDouble());
+      }
+      return ibus;
+   }
+
+   QStringList columnNames() {
+      QStringList names{"recipe_id", "input_fingerprint", "ibus_by_hop_addition"};
+      for (ValueColumn const & column : valueColumns()) {
+         names.append(column.name);
+      }
+      return names;
+   }
+
+   void loadEntries() {
+      loaded = true;
+
+      QElapsedTimer timer;
+      timer.start();
+      QSqlDatabase connection = Database::instance().sqlDatabase();
+      BtSqlQuery sqlQuery{connection};
+      QString const query = QString("SELECT %1 FROM %2").arg(columnNames().join(", "), cacheTableName);
+      if (!sqlQuery.exec(query)) {
+         qCWarning(Logging::database) <<
+            Q_FUNC_INFO << "Could not read stored recipe calculations, so recipes will be recalculated:" <<
+            sqlQuery.lastError().text();
+         return;
+      }
+
+      while (sqlQuery.next()) {
+         bool fingerprintOk = false;
+         Entry entry{};
+         entry.inputFingerprint =
+            static_cast<std::size_t>(sqlQuery.value(1).toString().toULongLong(&fingerprintOk, 16));
+         if (!fingerprintOk) {
+            continue;
+         }
+         entry.results.ibusByHopAddition = ibusFromText(sqlQuery.value(2).toString());
+         int columnIndex = 3;
+         for (ValueColumn const & column : valueColumns()) {
+            column.value(entry.results) = sqlQuery.value(columnIndex).toDouble();
+            ++columnIndex;
+         }
+         entries.insert(sqlQuery.value(0).toInt(), entry);
+      }
+      qCDebug(Logging::database) <<
+         Q_FUNC_INFO << "Read stored calculations for" << entries.size() << "recipes in" << timer.elapsed() << "ms";
+      return;
+   }
+
+   void markPending(int const recipeId) {
+      pendingRecipeIds.insert(recipeId);
+      if (!flushScheduled) {
+         flushScheduled = true;
+         QTimer::singleShot(flushDelay_ms, QCoreApplication::instance(), []() {
+            RecipeCalculationCache::flushPendingUpdates();
+            return;
+         });
+      }
+      return;
+   }
+}
+
+bool RecipeCalculationCache::createTables(Database & database, QSqlDatabase & connection) {
+   QString const doubleType = database.dbType() == Database::DbType::PGSQL ? "DOUBLE PRECISION" : "REAL";
+   QStringList columnDefinitions{
+      "recipe_id            INTEGER PRIMARY KEY",
+      "input_fingerprint    TEXT NOT NULL",
+      "ibus_by_hop_addition TEXT NOT NULL",
+   };
+   for (ValueColumn const & column : valueColumns()) {
+      columnDefinitions.append(QString("%1 %2 NOT NULL").arg(QLatin1String{column.name}, doubleType));
+   }
+
+   QString const query =
+      QString("CREATE TABLE IF NOT EXISTS %1 (%2)").arg(cacheTableName, columnDefinitions.join(", "));
+   BtSqlQuery sqlQuery{connection};
+   if (!sqlQuery.exec(query)) {
+      qCCritical(Logging::database) <<
+         Q_FUNC_INFO << "Error creating recipe calculation cache:" << sqlQuery.lastError().text() << "(Query:" <<
+         query << ")";
+      return false;
+   }
+   return true;
+}
+
+std::optional<RecipeEvaluator::Results> RecipeCalculationCache::lookUp(int const recipeId,
+                                                                        std::size_t const inputFingerprint) {
+   // It's a coding error to call this other than on the main thread, as that's the thread that owns the recipes
+   Q_ASSERT(QThread::currentThread() == QCoreApplication::instance()->thread());
+   if (!loaded) {
+      loadEntries();
+   }
+
+   auto const entry = entries.constFind(recipeId);
+   if (entry == entries.cend() || entry->inputFingerprint != inputFingerprint) {
+      return std::nullopt;
+   }
+   return entry->results;
+}
+
+void RecipeCalculationCache::store(int const recipeId,
+                                   std::size_t const inputFingerprint,
+                                   RecipeEvaluator::Results const & results) {
+   // It's a coding error to call this other than on the main thread, as that's the thread that owns the recipes
+   Q_ASSERT(QThread::currentThread() == QCoreApplication::instance()->thread());
+   if (!loaded) {
+      // Otherwise what's in the DB would overwrite what we store here when we get round to reading it in
+      loadEntries();
+   }
+
+   auto const entry = entries.constFind(recipeId);
+   if (entry != entries.cend() && entry->inputFingerprint == inputFingerprint) {
+      // Same inputs give the same results, so there's nothing new to write out
+      return;
+   }
+   entries.insert(recipeId, Entry{inputFingerprint, results});
+   markPending(recipeId);
+   return;
+}
+
+void RecipeCalculationCache::flushPendingUpdates() {
+   flushScheduled = false;
+   if (pendingRecipeIds.isEmpty()) {
+      return;
+   }
+   QSet<int> const recipeIds = std::exchange(pendingRecipeIds, QSet<int>{});
+
+   QElapsedTimer timer;
+   timer.start();
+   Database & database = Database::instance();
+   QSqlDatabase connection = database.sqlDatabase();
+   DbTransaction dbTransaction{database, connection, QString("Store %1 recipe calculations").arg(recipeIds.size())};
+
+   BtSqlQuery deleteQuery{connection};
+   deleteQuery.prepare(QString("DELETE FROM %1 WHERE recipe_id = :recipe_id").arg(cacheTableName));
+
+   QStringList const names = columnNames();
+   QStringList placeholders;
+   for (QString const & name : names) {
+      placeholders.append(":" + name);
+   }
+   BtSqlQuery insertQuery{connection};
+   insertQuery.prepare(
+      QString("INSERT INTO %1 (%2) VALUES (%3)").arg(cacheTableName, names.join(", "), placeholders.join(", "))
+   );
+
+   int numStored = 0;
+   for (int const recipeId : recipeIds) {
+      deleteQuery.bindValue(":recipe_id", recipeId);
+      if (!deleteQuery.exec()) {
+         qCWarning(Logging::database) <<
+            Q_FUNC_INFO << "Error removing stored calculations for Recipe #" << recipeId << ":" <<
+            deleteQuery.lastError().text();
+         continue;
+      }
+
+      auto const entry = entries.constFind(recipeId);
+      if (entry == entries.cend() || !ObjectStoreWrapper::getByIdRaw<Recipe>(recipeId)) {
+         // Recipe has been deleted, so removing its row was all we needed to do
+         entries.remove(recipeId);
+         continue;
+      }
+
+      RecipeEvaluator::Results results = entry->results;
+      insertQuery.bindValue(":recipe_id"           , recipeId);
+      insertQuery.bindValue(":input_fingerprint"   , fingerprintToText(entry->inputFingerprint));
+      insertQuery.bindValue(":ibus_by_hop_addition", ibusToText(results.ibusByHopAddition));
+      for (ValueColumn const & column : valueColumns()) {
+         insertQuery.bindValue(QString(":%1").arg(column.name), column.value(results));
+      }
+      if (!insertQuery.exec()) {
+         qCWarning(Logging::database) <<
+            Q_FUNC_INFO << "Error storing calculations for Recipe #" << recipeId << ":" <<
+            insertQuery.lastError().text();
+         continue;
+      }
+      ++numStored;
+   }
+
+   dbTransaction.commit();
+   qCDebug(Logging::database) <<
+      Q_FUNC_INFO << "Stored calculations for" << numStored << "of" << recipeIds.size() << "recipes in" <<
+      timer.elapsed() << "ms";
+   return;
+}
+
+void RecipeCalculationCache::unload() {
+   RecipeCalculationCache::flushPendingUpdates();
+   entries.clear();
+   loaded = false;
+   return;
+}
@@ -0,0 +1,83 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * database/RecipeCalculationCache.h is part of Brewtarget, and is copyright the following authors 2024:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#ifndef DATABASE_RECIPECALCULATIONCACHE_H
+#define DATABASE_RECIPECALCULATIONCACHE_H
+#pragma once
+
+#include <cstddef>
+#include <optional>
+
+#include <QSqlDatabase>
+
+#include "RecipeEvaluator.h"
+
+class Database;
+
+/**
+ * \brief Calculated values (OG, FG, IBU, color, ABV, volumes etc) of recipes, kept in the DB from one run of the
+ *        program to the next, so that we don't have to redo the calculations for every recipe the user looks at after
+ *        start-up.
+ *
+ *        Each recipe's values are stored along with the \c RecipeEvaluator::inputFingerprint of the snapshot they were
+ *        calculated from.  That fingerprint covers everything that goes into the calculations -- the recipe's
+ *        additions, equipment and boil, the calculation settings, and the version of the formulae -- so, if the
+ *        fingerprint of the recipe as it is now matches the stored one, the stored values are what the calculations
+ *        would give.  Otherwise the recipe just gets recalculated (and the new values stored).
+ *
+ *        Stored values are read in from the DB in one go the first time they are needed.  New values are written out a
+ *        moment after they are stored, in one transaction.  Rows for recipes that have been deleted are tidied up the
+ *        next time values for the same ID are stored, which, since IDs are rarely reused, may be never -- but such rows
+ *        are harmless.
+ *
+ *        All functions must be called on the main thread.
+ */
+namespace RecipeCalculationCache {
+
+   /**
+    * \brief Create the table that holds the calculated values.  This is done as part of \c CreateAllDatabaseTables, and
+    *        when upgrading an existing database.  Note that it is the caller's responsibility to handle transactions.
+    *
+    * \return \c false if something went wrong, \c true otherwise
+    */
+   bool createTables(Database & database, QSqlDatabase & connection);
+
+   /**
+    * \return The values stored for recipe \c recipeId, if they were calculated from inputs with the fingerprint
+    *         \c inputFingerprint, or \c std::nullopt otherwise
+    */
+   std::optional<RecipeEvaluator::Results> lookUp(int const recipeId, std::size_t const inputFingerprint);
+
+   /**
+    * \brief Remember the values calculated for recipe \c recipeId from inputs with the fingerprint
+    *        \c inputFingerprint.  They are written to the DB shortly afterwards.
+    */
+   void store(int const recipeId, std::size_t const inputFingerprint, RecipeEvaluator::Results const & results);
+
+   /**
+    * \brief Write out any values stored since the last flush.  (There's usually no need to call this, as it is done
+    *        automatically shortly after values are stored, and when the DB is unloaded.)
+    */
+   void flushPendingUpdates();
+
+   /**
+    * \brief Write out any pending values and forget the ones we have read in, ready for a different DB to be loaded.
+    *        Called from \c Database::unload.
+    */
+   void unload();
+
+}
+
+#endif
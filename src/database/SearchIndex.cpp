@@ -0,0 +1,522 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * database/SearchIndex.cpp is part of Brewtarget, and is copyright the following authors 2024:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#include "database/SearchIndex.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QRegularExpression>
+#include <QSet>
+#include <QSqlError>
+#include <QStringList>
+#include <QThread>
+#include <QTimer>
+#include <QVariant>
+
+#include "database/BtSqlQuery.h"
+#include "database/Database.h"
+#include "database/DbTransaction.h"
+#include "database/ObjectStoreTyped.h"
+#include "Logging.h"
+#include "model/BrewNote.h"
+#include "model/Equipment.h"
+#include "model/Fermentable.h"
+#include "model/Hop.h"
+#include "model/Misc.h"
+#include "model/NamedEntity.h"
+#include "model/Recipe.h"
+#include "model/Style.h"
+#include "model/Water.h"
+#include "model/Yeast.h"
+#include "utils/NameFilterIndex.h"
+
+namespace {
+   char const * const searchIndexTableName = "search_index";
+
+   /**
+    * \brief How long to collect changed objects before re-indexing them.  Editing a recipe's notes, for instance,
+    *        usually means a change per keystroke, and we only want to write the result.
+    */
+   int constexpr flushDelay_ms = 1000;
+
+   /**
+    * \brief One type of object that we index.  The document ID of each object in the index is its ID times
+    *        \c maxSources plus the index of its type in \c sources(), so the order of \c sources() must not change
+    *        (but new types can be added on the end).
+    */
+   struct Source {
+      ObjectStore & (*objectStore)();
+      QString       (*typeName)();
+      //! Everything other than the name that goes into the document
+      std::vector<BtStringConst const *> textProperties;
+   };
+
+   qint64 constexpr maxSources = 16;
+
+   template<class NE> ObjectStore & objectStoreFor() {
+      return ObjectStoreTyped<NE>::getInstance();
+   }
+
+   std::vector<Source> const & sources() {
+      static std::vector<Source> const allSources {
+         {&objectStoreFor<Recipe>     , &Recipe::localisedName     , {&PropertyNames::Recipe::notes,
+                                                                      &PropertyNames::Recipe::tasteNotes,
+                                                                      &PropertyNames::Recipe::brewer,
+                                                                      &PropertyNames::Recipe::asstBrewer}},
+         {&objectStoreFor<BrewNote>   , &BrewNote::localisedName   , {&PropertyNames::BrewNote::notes}},
+         {&objectStoreFor<Equipment>  , &Equipment::localisedName  , {&PropertyNames::Equipment::hltNotes,
+                                                                      &PropertyNames::Equipment::mashTunNotes,
+                                                                      &PropertyNames::Equipment::lauterTunNotes,
+                                                                      &PropertyNames::Equipment::kettleNotes,
+                                                                      &PropertyNames::Equipment::fermenterNotes,
+                                                                      &PropertyNames::Equipment::agingVesselNotes,
+                                                                      &PropertyNames::Equipment::packagingVesselNotes}},
+         {&objectStoreFor<Fermentable>, &Fermentable::localisedName, {&PropertyNames::Fermentable::notes,
+                                                                      &PropertyNames::Fermentable::origin,
+                                                                      &PropertyNames::Fermentable::supplier,
+                                                                      &PropertyNames::Fermentable::producer}},
+         {&objectStoreFor<Hop>        , &Hop::localisedName        , {&PropertyNames::Hop::notes,
+                                                                      &PropertyNames::Hop::origin,
+                                                                      &PropertyNames::Hop::substitutes,
+                                                                      &PropertyNames::Hop::producer}},
+         {&objectStoreFor<Misc>       , &Misc::localisedName       , {&PropertyNames::Misc::notes,
+                                                                      &PropertyNames::Misc::useFor,
+                                                                      &PropertyNames::Misc::producer}},
+         {&objectStoreFor<Style>      , &Style::localisedName      , {&PropertyNames::Style::notes,
+                                                                      &PropertyNames::Style::category,
+                                                                      &PropertyNames::Style::ingredients,
+                                                                      &PropertyNames::Style::examples,
+                                                                      &PropertyNames::Style::aroma,
+                                                                      &PropertyNames::Style::appearance,
+                                                                      &PropertyNames::Style::flavor,
+                                                                      &PropertyNames::Style::mouthfeel,
+                                                                      &PropertyNames::Style::overallImpression}},
+         {&objectStoreFor<Yeast>      , &Yeast::localisedName      , {&PropertyNames::Yeast::notes,
+                                                                      &PropertyNames::Yeast::laboratory,
+                                                                      &PropertyNames::Yeast::productId,
+                                                                      &PropertyNames::Yeast::bestFor}},
+         {&objectStoreFor<Water>      , &Water::localisedName      , {&PropertyNames::Water::notes}},
+      };
+      Q_ASSERT(static_cast<qint64>(allSources.size()) <= maxSources);
+      return allSources;
+   }
+
+   qint64 docIdOf(int const sourceIndex, int const id) {
+      return static_cast<qint64>(id) * maxSources + sourceIndex;
+   }
+
+   int sourceIndexOf(qint64 const docId) {
+      return static_cast<int>(docId % maxSources);
+   }
+
+   int idOf(qint64 const docId) {
+      return static_cast<int>(docId / maxSources);
+   }
+
+   //! \c false if we couldn't create the index table, in which case searches fall back to the object stores
+   bool indexAvailable = false;
+   bool maintaining = false;
+   //! Documents to re-index (or remove) at the next \c SearchIndex::flushPendingUpdates
+   QSet<qint64> pendingDocIds;
+   bool flushScheduled = false;
+
+   void markPending(int const sourceIndex, int const id) {
+      pendingDocIds.insert(docIdOf(sourceIndex, id));
+      if (!flushScheduled) {
+         flushScheduled = true;
+         QTimer::singleShot(flushDelay_ms, QCoreApplication::instance(), []() {
+            SearchIndex::flushPendingUpdates();
+            return;
+         });
+      }
+      return;
+   }
+
+   //! We don't want search results the user can't see, such as soft-deleted objects
+   NamedEntity const * indexableEntity(QObject const * object) {
+      NamedEntity const * namedEntity = qobject_cast<NamedEntity const *>(object);
+      if (!namedEntity || !namedEntity->display() || namedEntity->deleted()) {
+         return nullptr;
+      }
+      return namedEntity;
+   }
+
+   //! \return All the text of \c object other than its name, one property per line
+   QString bodyOf(QObject const & object, Source const & source) {
+      QStringList lines;
+      for (BtStringConst const * propertyName : source.textProperties) {
+         QString const text = object.property(**propertyName).toString();
+         if (!text.isEmpty()) {
+            lines.append(text);
+         }
+      }
+      return lines.join('\n');
+   }
+
+   /**
+    * \brief Split search text into the words to look for.  These are folded (see \c NameFilterIndex::fold) and contain
+    *        only letters, digits and underscores, so are safe to put in a full-text query without further escaping.
+    */
+   QStringList wordsOf(QString const & text) {
+      static QRegularExpression const nonWordCharacters{"[^\\w]+", QRegularExpression::UseUnicodePropertiesOption};
+      return NameFilterIndex::fold(text).split(nonWordCharacters, Qt::SkipEmptyParts);
+   }
+
+   bool tableExists(Database const & database, QSqlDatabase & connection) {
+      BtSqlQuery sqlQuery{connection};
+      sqlQuery.prepare(
+         database.dbType() == Database::DbType::PGSQL ?
+            "SELECT 1 FROM information_schema.tables WHERE table_name = :tableName" :
+            "SELECT 1 FROM sqlite_master WHERE name = :tableName"
+      );
+      sqlQuery.bindValue(":tableName", searchIndexTableName);
+      return sqlQuery.exec() && sqlQuery.next();
+   }
+
+   /**
+    * \brief Slow path for when there is no index table: check every indexable object.  Hits where all the words are in
+    *        the name rank above the others.
+    */
+   QVector<SearchIndex::Hit> searchObjectStores(QStringList const & words, int const maxHits) {
+      QVector<SearchIndex::Hit> hits;
+      for (Source const & source : sources()) {
+         ObjectStore const & objectStore = source.objectStore();
+         for (QObject const * object : objectStore.getAllRaw()) {
+            NamedEntity const * namedEntity = indexableEntity(object);
+            if (!namedEntity) {
+               continue;
+            }
+            QString const body       = bodyOf(*object, source);
+            QString const foldedName = NameFilterIndex::fold(namedEntity->name());
+            QString const foldedBody = NameFilterIndex::fold(body);
+            int numWordsInName = 0;
+            bool allWordsFound = true;
+            for (QString const & word : words) {
+               if (foldedName.contains(word)) {
+                  ++numWordsInName;
+               } else if (!foldedBody.contains(word)) {
+                  allWordsFound = false;
+                  break;
+               }
+            }
+            if (allWordsFound) {
+               hits.append(SearchIndex::Hit{&objectStore,
+                                            namedEntity->key(),
+                                            source.typeName(),
+                                            namedEntity->name(),
+                                            body.left(80),
+                                            static_cast<double>(numWordsInName)});
+            }
+         }
+      }
+
+      std::stable_sort(hits.begin(), hits.end(), [](SearchIndex::Hit const & lhs, SearchIndex::Hit const & rhs) {
+         return lhs.rank > rhs.rank;
+      });
+      if (hits.size() > maxHits) {
+         hits.resize(maxHits);
+      }
+      return hits;
+   }
+}
+
+bool SearchIndex::createTables(Database & database, QSqlDatabase & connection) {
+   BtSqlQuery sqlQuery{connection};
+   if (database.dbType() == Database::DbType::PGSQL) {
+      //
+      // We fill in the document column ourselves, from the folded (see NameFilterIndex::fold) name and body, rather
+      // than have PostgreSQL work it out, because the "simple" text search configuration (which we want, as recipes
+      // are not written in any one language) does not strip accents.  Words in the name get weight A and the rest
+      // weight B, so that ts_rank favours matches in the name.
+      //
+      QStringList const queries{
+         QString("CREATE TABLE IF NOT EXISTS %1 ("
+                    "doc_id   BIGINT PRIMARY KEY, "
+                    "name     TEXT NOT NULL, "
+                    "body     TEXT NOT NULL, "
+                    "document TSVECTOR NOT NULL"
+                 ")").arg(searchIndexTableName),
+         QString("CREATE INDEX IF NOT EXISTS %1_document_idx ON %1 USING GIN (document)").arg(searchIndexTableName),
+      };
+      for (QString const & query : queries) {
+         if (!sqlQuery.exec(query)) {
+            qCCritical(Logging::database) <<
+               Q_FUNC_INFO << "Error creating search index:" << sqlQuery.lastError().text() << "(Query:" << query <<
+               ")";
+            return false;
+         }
+      }
+      return true;
+   }
+
+   //
+   // On SQLite, the rowid of the FTS5 table is the document ID.  The unicode61 tokenizer folds case and, with
+   // remove_diacritics, accents, so we store the text as it is.
+   //
+   QString const query = QString(
+      "CREATE VIRTUAL TABLE IF NOT EXISTS %1 USING fts5(name, body, tokenize = 'unicode61 remove_diacritics 1')"
+   ).arg(searchIndexTableName);
+   if (!sqlQuery.exec(query)) {
+      // Most likely this SQLite was built without FTS5.  Searching will still work, just more slowly.
+      qCWarning(Logging::database) <<
+         Q_FUNC_INFO << "Could not create full-text search index, so searches will not use it:" <<
+         sqlQuery.lastError().text();
+   }
+   return true;
+}
+
+void SearchIndex::startMaintaining() {
+   // It's a coding error to call this other than on the main thread, as that's the thread that owns the objects
+   Q_ASSERT(QThread::currentThread() == QCoreApplication::instance()->thread());
+   if (maintaining) {
+      return;
+   }
+   maintaining = true;
+
+   Database & database = Database::instance();
+   QSqlDatabase connection = database.sqlDatabase();
+   //
+   // If the table is missing (eg the DB was created with an SQLite that had no FTS5) we try again to create it, in
+   // case the SQLite we have now is better equipped.
+   //
+   indexAvailable = tableExists(database, connection);
+   if (!indexAvailable) {
+      SearchIndex::createTables(database, connection);
+      indexAvailable = tableExists(database, connection);
+   }
+
+   for (int sourceIndex = 0; sourceIndex < static_cast<int>(sources().size()); ++sourceIndex) {
+      Source const & source = sources().at(sourceIndex);
+      ObjectStore & objectStore = source.objectStore();
+      QObject::connect(&objectStore, &ObjectStore::signalObjectInserted, QCoreApplication::instance(),
+                       [sourceIndex](int id) {
+         markPending(sourceIndex, id);
+         return;
+      });
+      QObject::connect(&objectStore, &ObjectStore::signalObjectDeleted, QCoreApplication::instance(),
+                       [sourceIndex](int id, std::shared_ptr<QObject>) {
+         markPending(sourceIndex, id);
+         return;
+      });
+      QObject::connect(&objectStore, &ObjectStore::signalPropertyChanged, QCoreApplication::instance(),
+                       [sourceIndex](int id, BtStringConst const & propertyName) {
+         // Display and deleted matter because they determine whether the object should be in the index at all
+         if (propertyName == PropertyNames::NamedEntity::name    ||
+             propertyName == PropertyNames::NamedEntity::display ||
+             propertyName == PropertyNames::NamedEntity::deleted) {
+            markPending(sourceIndex, id);
+            return;
+         }
+         for (BtStringConst const * textProperty : sources().at(sourceIndex).textProperties) {
+            if (propertyName == *textProperty) {
+               markPending(sourceIndex, id);
+               return;
+            }
+         }
+         return;
+      });
+   }
+
+   if (!indexAvailable) {
+      return;
+   }
+
+   BtSqlQuery sqlQuery{connection};
+   if (sqlQuery.exec(QString("SELECT COUNT(*) FROM %1").arg(searchIndexTableName)) && sqlQuery.next() &&
+       sqlQuery.value(0).toInt() == 0) {
+      qCInfo(Logging::database) << Q_FUNC_INFO << "Search index is empty, so rebuilding it";
+      for (int sourceIndex = 0; sourceIndex < static_cast<int>(sources().size()); ++sourceIndex) {
+         for (QObject const * object : sources().at(sourceIndex).objectStore().getAllRaw()) {
+            NamedEntity const * namedEntity = indexableEntity(object);
+            if (namedEntity) {
+               pendingDocIds.insert(docIdOf(sourceIndex, namedEntity->key()));
+            }
+         }
+      }
+      SearchIndex::flushPendingUpdates();
+   }
+   return;
+}
+
+void SearchIndex::flushPendingUpdates() {
+   flushScheduled = false;
+   if (pendingDocIds.isEmpty()) {
+      return;
+   }
+   QSet<qint64> const docIds = std::exchange(pendingDocIds, QSet<qint64>{});
+   if (!indexAvailable) {
+      return;
+   }
+
+   QElapsedTimer timer;
+   timer.start();
+   Database & database = Database::instance();
+   bool const isPostgres = (database.dbType() == Database::DbType::PGSQL);
+   QSqlDatabase connection = database.sqlDatabase();
+   DbTransaction dbTransaction{database, connection, QString("Update %1 search index documents").arg(docIds.size())};
+
+   BtSqlQuery deleteQuery{connection};
+   deleteQuery.prepare(
+      QString(isPostgres ? "DELETE FROM %1 WHERE doc_id = :docId" : "DELETE FROM %1 WHERE rowid = :docId").arg(
+         searchIndexTableName
+      )
+   );
+   BtSqlQuery insertQuery{connection};
+   insertQuery.prepare(
+      QString(
+         isPostgres ?
+            "INSERT INTO %1 (doc_id, name, body, document) VALUES (:docId, :name, :body, "
+               "setweight(to_tsvector('simple', :foldedName), 'A') || "
+               "setweight(to_tsvector('simple', :foldedBody), 'B'))" :
+            "INSERT INTO %1 (rowid, name, body) VALUES (:docId, :name, :body)"
+      ).arg(searchIndexTableName)
+   );
+
+   int numIndexed = 0;
+   for (qint64 const docId : docIds) {
+      deleteQuery.bindValue(":docId", docId);
+      if (!deleteQuery.exec()) {
+         qCWarning(Logging::database) <<
+            Q_FUNC_INFO << "Error removing document" << docId << "from search index:" <<
+            deleteQuery.lastError().text();
+         continue;
+      }
+
+      Source const & source = sources().at(sourceIndexOf(docId));
+      std::shared_ptr<QObject> const object = source.objectStore().getById(idOf(docId));
+      NamedEntity const * namedEntity = indexableEntity(object.get());
+      if (!namedEntity) {
+         // Object has been deleted or hidden, so removing it from the index was all we needed to do
+         continue;
+      }
+
+      QString const body = bodyOf(*object, source);
+      insertQuery.bindValue(":docId", docId);
+      insertQuery.bindValue(":name" , namedEntity->name());
+      insertQuery.bindValue(":body" , body);
+      if (isPostgres) {
+         insertQuery.bindValue(":foldedName", NameFilterIndex::fold(namedEntity->name()));
+         insertQuery.bindValue(":foldedBody", NameFilterIndex::fold(body));
+      }
+      if (!insertQuery.exec()) {
+         qCWarning(Logging::database) <<
+            Q_FUNC_INFO << "Error adding document" << docId << "to search index:" << insertQuery.lastError().text();
+         continue;
+      }
+      ++numIndexed;
+   }
+
+   dbTransaction.commit();
+   qCDebug(Logging::database) <<
+      Q_FUNC_INFO << "Re-indexed" << numIndexed << "of" << docIds.size() << "changed objects in" << timer.elapsed() <<
+      "ms";
+   return;
+}
+
+QVector<SearchIndex::Hit> SearchIndex::search(QString const & searchText, int const maxHits) {
+   // It's a coding error to call this other than on the main thread, as that's the thread that owns the objects
+   Q_ASSERT(QThread::currentThread() == QCoreApplication::instance()->thread());
+
+   QStringList const words = wordsOf(searchText);
+   if (words.isEmpty()) {
+      return {};
+   }
+
+   if (!indexAvailable) {
+      return searchObjectStores(words, maxHits);
+   }
+
+   // Make sure we find what the user has just typed into, say, the notes of the current recipe
+   SearchIndex::flushPendingUpdates();
+
+   Database & database = Database::instance();
+   QSqlDatabase connection = database.sqlDatabase();
+   BtSqlQuery sqlQuery{connection};
+   if (database.dbType() == Database::DbType::PGSQL) {
+      QStringList prefixWords;
+      for (QString const & word : words) {
+         prefixWords.append(word + ":*");
+      }
+      sqlQuery.prepare(
+         QString("SELECT doc_id, "
+                        "ts_headline('simple', body, searchQuery, 'StartSel=[, StopSel=], MaxWords=12, MinWords=4'), "
+                        "ts_rank(document, searchQuery) AS score "
+                 "FROM %1, to_tsquery('simple', :searchQuery) AS searchQuery "
+                 "WHERE document @@ searchQuery "
+                 "ORDER BY score DESC "
+                 "LIMIT :maxHits").arg(searchIndexTableName)
+      );
+      sqlQuery.bindValue(":searchQuery", prefixWords.join(" & "));
+   } else {
+      //
+      // In FTS5 query syntax, "word"* is a prefix query, and space-separated queries must all match.  The weights
+      // passed to bm25 are for the name and body columns respectively.  Note that bm25 gives better matches more
+      // negative scores.
+      //
+      QStringList prefixWords;
+      for (QString const & word : words) {
+         prefixWords.append("\"" + word + "\"*");
+      }
+      sqlQuery.prepare(
+         QString("SELECT rowid, "
+                        "snippet(%1, 1, '[', ']', '...', 12), "
+                        "-bm25(%1, 10.0, 1.0) AS score "
+                 "FROM %1 "
+                 "WHERE %1 MATCH :searchQuery "
+                 "ORDER BY score DESC "
+                 "LIMIT :maxHits").arg(searchIndexTableName)
+      );
+      sqlQuery.bindValue(":searchQuery", prefixWords.join(" "));
+   }
+   sqlQuery.bindValue(":maxHits", maxHits);
+
+   QElapsedTimer timer;
+   timer.start();
+   if (!sqlQuery.exec()) {
+      qCWarning(Logging::database) << Q_FUNC_INFO << "Error searching index:" << sqlQuery.lastError().text();
+      return searchObjectStores(words, maxHits);
+   }
+
+   QVector<Hit> hits;
+   while (sqlQuery.next()) {
+      qint64 const docId = sqlQuery.value(0).toLongLong();
+      int const sourceIndex = sourceIndexOf(docId);
+      if (sourceIndex >= static_cast<int>(sources().size())) {
+         continue;
+      }
+      Source const & source = sources().at(sourceIndex);
+      ObjectStore const & objectStore = source.objectStore();
+      std::shared_ptr<QObject> const object = objectStore.getById(idOf(docId));
+      NamedEntity const * namedEntity = indexableEntity(object.get());
+      if (!namedEntity) {
+         // Can happen if another user of a shared DB deleted something we haven't heard about yet
+         continue;
+      }
+      hits.append(Hit{&objectStore,
+                      namedEntity->key(),
+                      source.typeName(),
+                      namedEntity->name(),
+                      sqlQuery.value(1).toString(),
+                      sqlQuery.value(2).toDouble()});
+   }
+   qCDebug(Logging::database) <<
+      Q_FUNC_INFO << "Found" << hits.size() << "hits for" << words << "in" << timer.elapsed() << "ms";
+   return hits;
+}
@@ -0,0 +1,94 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * database/SearchIndex.h is part of Brewtarget, and is copyright the following authors 2024:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#ifndef DATABASE_SEARCHINDEX_H
+#define DATABASE_SEARCHINDEX_H
+#pragma once
+
+#include <QSqlDatabase>
+#include <QString>
+#include <QVector>
+
+class Database;
+class ObjectStore;
+
+/**
+ * \brief Full-text index over the names and free-text fields (notes, taste notes, style descriptions etc) of recipes,
+ *        brew notes and all the ingredient types, so that one search box can find things across all of them.
+ *
+ *        The index lives in the DB: an FTS5 virtual table on SQLite, or a table with a GIN-indexed \c tsvector column
+ *        on PostgreSQL.  Either way, there is one row (or "document") per object, holding the object's name and, as a
+ *        separate column, all its other text.  Matches in the name count for more when ranking.
+ *
+ *        The index is kept up to date from the signals \c ObjectStore::insert, \c ObjectStore::updateProperty etc
+ *        emit: changed objects are collected and then re-indexed in one transaction a moment later (or straight away
+ *        if someone searches in the meantime).  If the index is empty at start-up (eg because the DB has just been
+ *        upgraded, or copied to a new one), it is rebuilt from the object stores.
+ *
+ *        If the SQLite we are running with was built without FTS5, the index table can't be created.  We then fall
+ *        back to searching the object stores in memory, which gives the same hits, albeit more slowly and with simpler
+ *        ranking.
+ *
+ *        All functions must be called on the main thread.
+ */
+namespace SearchIndex {
+
+   struct Hit {
+      //! The store holding the object that matched
+      ObjectStore const * objectStore;
+      int                 id;
+      //! Translated name of the type of object, eg "Recipe"
+      QString             typeName;
+      QString             name;
+      //! Extract of the text around the match, with matched terms in [square brackets]
+      QString             snippet;
+      //! Higher is better.  Only meaningful for comparing hits from the same search.
+      double              rank;
+   };
+
+   /**
+    * \brief Create the index table (and, on PostgreSQL, its index).  This is done as part of
+    *        \c CreateAllDatabaseTables, and when upgrading an existing database.  Note that it is the caller's
+    *        responsibility to handle transactions.
+    *
+    * \return \c false if something went wrong, \c true otherwise -- including if the index could not be created because
+    *         SQLite does not support FTS5, as we can manage without it
+    */
+   bool createTables(Database & database, QSqlDatabase & connection);
+
+   /**
+    * \brief Start keeping the index up to date, first rebuilding it if it is empty.  Must be called on the main thread,
+    *        after \c InitialiseAllObjectStores.
+    */
+   void startMaintaining();
+
+   /**
+    * \brief Write out any pending changes to the index.  (There's usually no need to call this, as it is done
+    *        automatically shortly after objects change, and before every search.)
+    */
+   void flushPendingUpdates();
+
+   /**
+    * \brief Find the objects whose name or text contains all the words in \c searchText (ignoring case and accents).
+    *        Each word also matches longer words it is the start of, so that results can be shown while the user is
+    *        still typing.
+    *
+    * \return Up to \c maxHits hits, best first
+    */
+   QVector<Hit> search(QString const & searchText, int const maxHits = 100);
+
+}
+
+#endif
@@ -0,0 +1,786 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * database/SensorReadings.cpp is part of Brewtarget, and is copyright the following authors 2024:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#include "database/SensorReadings.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <deque>
+#include <mutex>    // For std::once_flag etc
+#include <utility>
+
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include <QMap>
+#include <QMetaObject>
+#include <QRunnable>
+#include <QSqlError>
+#include <QThread>
+#include <QThreadPool>
+#include <QTimer>
+#include <QVariant>
+#include <QtNetwork/QHostAddress>
+#include <QtNetwork/QNetworkDatagram>
+#include <QtNetwork/QUdpSocket>
+
+#include "database/BtSqlQuery.h"
+#include "database/Database.h"
+#include "database/DbTransaction.h"
+#include "database/ObjectStoreWrapper.h"
+#include "Logging.h"
+#include "model/BrewNote.h"
+#include "PersistentSettings.h"
+#include "utils/BoundedMpscQueue.h"
+#include "utils/TimeSeriesChunk.h"
+
+namespace {
+   //! Readings not yet compressed into a chunk
+   QLatin1String const readingTableName{"sensor_reading"};
+   QLatin1String const chunkTableName  {"sensor_reading_chunk"};
+   QLatin1String const rollupTableName {"sensor_reading_rollup"};
+
+   //! Three hours of readings every 15 seconds
+   int constexpr readingsPerChunk = 720;
+
+   //! Periods, in seconds, of the summaries in the rollup table
+   int constexpr rollupResolutions_s[] {60, 15 * 60, 60 * 60};
+
+   //! How long to collect submitted readings before passing them on
+   int constexpr flushDelay_ms = 1000;
+
+   //! Enough for a day of readings every 15 seconds
+   std::size_t constexpr maxRecentReadingsPerBrewNote = 6000;
+
+   BoundedMpscQueue<SensorReadings::Reading, 8192> readingQueue;
+   std::atomic<bool> flushScheduled{false};
+   std::atomic<qint64> numDropped{0};
+
+   //! Only brew notes for which someone has called recentReadings have an entry here
+   QHash<int, std::deque<SensorReadings::Reading> > recentByBrewNote;
+
+   std::function<void(QSet<int> const &)> readingsListener;
+
+   QThread * listenerThread = nullptr;
+   QUdpSocket * listenerSocket = nullptr;
+
+   /**
+    * \brief The thread on which we write readings to the DB.  As with the one for ObjectStore::insertAsync() etc,
+    *        there is only one such thread, so batches are written in order, and it is kept alive so that it keeps
+    *        reusing the same DB connection.
+    */
+   QThreadPool & writerThreadPool() {
+      static QThreadPool threadPool;
+      static std::once_flag initFlag;
+      std::call_once(initFlag, []() {
+         threadPool.setMaxThreadCount(1);
+         threadPool.setExpiryTimeout(-1);
+      });
+      return threadPool;
+   }
+
+   QVariant optionalToVariant(std::optional<double> const value) {
+      return value ? QVariant{*value} : QVariant{};
+   }
+
+   std::optional<double> variantToOptional(QVariant const & value) {
+      if (value.isNull()) {
+         return std::nullopt;
+      }
+      return value.toDouble();
+   }
+
+   //! Summaries of both quantities over one rollup period
+   struct Rollup {
+      SensorReadings::Statistic sg;
+      SensorReadings::Statistic temperature_c;
+
+      void add(SensorReadings::Reading const & reading) {
+         if (reading.sg           ) { this->sg           .add(*reading.sg           ); }
+         if (reading.temperature_c) { this->temperature_c.add(*reading.temperature_c); }
+         return;
+      }
+
+      void merge(Rollup const & other) {
+         this->sg.merge(other.sg);
+         this->temperature_c.merge(other.temperature_c);
+         return;
+      }
+   };
+
+   //! Rollup start time -> rollup
+   using Rollups = QMap<qint64, Rollup>;
+
+   qint64 periodStart(qint64 const timestamp_ms, qint64 const period_ms) {
+      // Rounding down, even for (unlikely) timestamps before 1970
+      return timestamp_ms - (((timestamp_ms % period_ms) + period_ms) % period_ms);
+   }
+
+   void addToRollups(Rollups & rollups, int const resolution_s, SensorReadings::Reading const & reading) {
+      rollups[periodStart(reading.timestamp_ms, resolution_s * qint64{1000})].add(reading);
+      return;
+   }
+
+   bool execOrLog(BtSqlQuery & sqlQuery, char const * const description) {
+      if (!sqlQuery.exec()) {
+         qCWarning(Logging::database) <<
+            Q_FUNC_INFO << "Error" << description << ":" << sqlQuery.lastError().text() << "(Query:" <<
+            sqlQuery.lastQuery() << ")";
+         return false;
+      }
+      return true;
+   }
+
+   //! Readings for \c brewNoteId that are not yet in a chunk, from \c from_ms to \c to_ms, in time order
+   QVector<SensorReadings::Reading> readUnchunkedReadings(QSqlDatabase & connection,
+                                                          int const brewNoteId,
+                                                          qint64 const from_ms = std::numeric_limits<qint64>::min(),
+                                                          qint64 const to_ms   = std::numeric_limits<qint64>::max()) {
+      QVector<SensorReadings::Reading> readings;
+      BtSqlQuery sqlQuery{connection};
+      sqlQuery.prepare(
+         QString("SELECT reading_time_ms, sg, temperature_c FROM %1 "
+                 "WHERE brewnote_id = ? AND reading_time_ms >= ? AND reading_time_ms <= ? "
+                 "ORDER BY reading_time_ms").arg(readingTableName)
+      );
+      sqlQuery.addBindValue(brewNoteId);
+      sqlQuery.addBindValue(from_ms);
+      sqlQuery.addBindValue(to_ms);
+      if (execOrLog(sqlQuery, "reading sensor readings")) {
+         while (sqlQuery.next()) {
+            readings.append(SensorReadings::Reading{brewNoteId,
+                                                    sqlQuery.value(0).toLongLong(),
+                                                    variantToOptional(sqlQuery.value(1)),
+                                                    variantToOptional(sqlQuery.value(2))});
+         }
+      }
+      return readings;
+   }
+
+   /**
+    * \brief Decode a chunk and append those of its readings from \c from_ms to \c to_ms to \c readings.  We only
+    *        convert the readings we need from columns, and the range check only looks at the timestamp column.
+    */
+   void appendChunkReadings(QByteArray const & chunk,
+                            int const brewNoteId,
+                            qint64 const from_ms,
+                            qint64 const to_ms,
+                            QVector<SensorReadings::Reading> & readings) {
+      TimeSeriesChunk::Columns columns;
+      if (!TimeSeriesChunk::decode(chunk, columns) || columns.values.size() != 2) {
+         qCWarning(Logging::database) <<
+            Q_FUNC_INFO << "Ignoring invalid sensor reading chunk for BrewNote #" << brewNoteId;
+         return;
+      }
+      qint64 const * const timestamps = columns.timestamps_ms.constData();
+      double const * const sgs = columns.values[0].constData();
+      double const * const temperatures = columns.values[1].constData();
+      int const numReadings = columns.timestamps_ms.size();
+      for (int ii = 0; ii < numReadings; ++ii) {
+         if (timestamps[ii] < from_ms || timestamps[ii] > to_ms) {
+            continue;
+         }
+         readings.append(SensorReadings::Reading{
+            brewNoteId,
+            timestamps[ii],
+            std::isnan(sgs[ii])          ? std::nullopt : std::optional<double>{sgs[ii]},
+            std::isnan(temperatures[ii]) ? std::nullopt : std::optional<double>{temperatures[ii]}
+         });
+      }
+      return;
+   }
+
+   void sortByTime(QVector<SensorReadings::Reading> & readings) {
+      std::stable_sort(
+         readings.begin(),
+         readings.end(),
+         [](SensorReadings::Reading const & lhs, SensorReadings::Reading const & rhs) {
+            return lhs.timestamp_ms < rhs.timestamp_ms;
+         }
+      );
+      return;
+   }
+
+   //! All readings for \c brewNoteId from \c from_ms to \c to_ms (whether or not in chunks), in time order
+   QVector<SensorReadings::Reading> readReadings(QSqlDatabase & connection,
+                                                 int const brewNoteId,
+                                                 qint64 const from_ms,
+                                                 qint64 const to_ms) {
+      QVector<SensorReadings::Reading> readings;
+      BtSqlQuery sqlQuery{connection};
+      sqlQuery.prepare(
+         QString("SELECT data FROM %1 WHERE brewnote_id = ? AND last_time_ms >= ? AND first_time_ms <= ? "
+                 "ORDER BY first_time_ms").arg(chunkTableName)
+      );
+      sqlQuery.addBindValue(brewNoteId);
+      sqlQuery.addBindValue(from_ms);
+      sqlQuery.addBindValue(to_ms);
+      if (execOrLog(sqlQuery, "reading sensor reading chunks")) {
+         while (sqlQuery.next()) {
+            appendChunkReadings(sqlQuery.value(0).toByteArray(), brewNoteId, from_ms, to_ms, readings);
+         }
+      }
+      readings.append(readUnchunkedReadings(connection, brewNoteId, from_ms, to_ms));
+      // Chunks can overlap if readings arrive out of order, so we can't assume they're already sorted
+      sortByTime(readings);
+      return readings;
+   }
+
+   //! Rollups of resolution \c resolution_s for \c brewNoteId starting between \c from_ms and \c to_ms
+   Rollups readRollups(QSqlDatabase & connection,
+                       int const brewNoteId,
+                       int const resolution_s,
+                       qint64 const from_ms,
+                       qint64 const to_ms) {
+      Rollups rollups;
+      BtSqlQuery sqlQuery{connection};
+      sqlQuery.prepare(
+         QString("SELECT period_start_ms, "
+                 "sg_count, sg_sum, sg_min, sg_max, "
+                 "temperature_count, temperature_sum, temperature_min, temperature_max "
+                 "FROM %1 WHERE brewnote_id = ? AND resolution_s = ? AND period_start_ms >= ? AND "
+                 "period_start_ms <= ?").arg(rollupTableName)
+      );
+      sqlQuery.addBindValue(brewNoteId);
+      sqlQuery.addBindValue(resolution_s);
+      sqlQuery.addBindValue(from_ms);
+      sqlQuery.addBindValue(to_ms);
+      if (execOrLog(sqlQuery, "reading sensor reading rollups")) {
+         while (sqlQuery.next()) {
+            Rollup & rollup = rollups[sqlQuery.value(0).toLongLong()];
+            rollup.sg = SensorReadings::Statistic{sqlQuery.value(1).toInt(),
+                                                  sqlQuery.value(2).toDouble(),
+                                                  sqlQuery.value(3).toDouble(),
+                                                  sqlQuery.value(4).toDouble()};
+            rollup.temperature_c = SensorReadings::Statistic{sqlQuery.value(5).toInt(),
+                                                             sqlQuery.value(6).toDouble(),
+                                                             sqlQuery.value(7).toDouble(),
+                                                             sqlQuery.value(8).toDouble()};
+         }
+      }
+      return rollups;
+   }
+
+   //! Add \c newRollups to any rollups already stored for the same periods.  Called on the writer thread.
+   bool storeRollups(QSqlDatabase & connection,
+                     int const brewNoteId,
+                     int const resolution_s,
+                     Rollups const & newRollups) {
+      if (newRollups.isEmpty()) {
+         return true;
+      }
+      qint64 const first_ms = newRollups.firstKey();
+      qint64 const last_ms  = newRollups.lastKey();
+      Rollups rollups = readRollups(connection, brewNoteId, resolution_s, first_ms, last_ms);
+      for (auto ii = newRollups.cbegin(); ii != newRollups.cend(); ++ii) {
+         rollups[ii.key()].merge(ii.value());
+      }
+
+      BtSqlQuery deleteQuery{connection};
+      deleteQuery.prepare(
+         QString("DELETE FROM %1 WHERE brewnote_id = ? AND resolution_s = ? AND period_start_ms >= ? AND "
+                 "period_start_ms <= ?").arg(rollupTableName)
+      );
+      deleteQuery.addBindValue(brewNoteId);
+      deleteQuery.addBindValue(resolution_s);
+      deleteQuery.addBindValue(first_ms);
+      deleteQuery.addBindValue(last_ms);
+      if (!execOrLog(deleteQuery, "replacing sensor reading rollups")) {
+         return false;
+      }
+
+      BtSqlQuery insertQuery{connection};
+      insertQuery.prepare(
+         QString("INSERT INTO %1 (brewnote_id, resolution_s, period_start_ms, "
+                 "sg_count, sg_sum, sg_min, sg_max, "
+                 "temperature_count, temperature_sum, temperature_min, temperature_max) "
+                 "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)").arg(rollupTableName)
+      );
+      for (auto ii = rollups.cbegin(); ii != rollups.cend(); ++ii) {
+         insertQuery.addBindValue(brewNoteId);
+         insertQuery.addBindValue(resolution_s);
+         insertQuery.addBindValue(ii.key());
+         for (SensorReadings::Statistic const & statistic : {ii->sg, ii->temperature_c}) {
+            // Min and max of no values are infinite, which not every DB can store, but we never look at them anyway
+            insertQuery.addBindValue(statistic.count);
+            insertQuery.addBindValue(statistic.sum);
+            insertQuery.addBindValue(statistic.count ? statistic.min : 0.0);
+            insertQuery.addBindValue(statistic.count ? statistic.max : 0.0);
+         }
+         if (!execOrLog(insertQuery, "storing sensor reading rollup")) {
+            return false;
+         }
+      }
+      return true;
+   }
+
+   /**
+    * \brief If \c brewNoteId has enough readings not yet in a chunk, compress them into one, and add them to the
+    *        rollups.  Called on the writer thread, inside the transaction that stored the readings.
+    */
+   void chunkReadingsIfEnough(QSqlDatabase & connection, int const brewNoteId) {
+      BtSqlQuery countQuery{connection};
+      countQuery.prepare(QString("SELECT COUNT(*) FROM %1 WHERE brewnote_id = ?").arg(readingTableName));
+      countQuery.addBindValue(brewNoteId);
+      if (!execOrLog(countQuery, "counting sensor readings") || !countQuery.next() ||
+          countQuery.value(0).toInt() < readingsPerChunk) {
+         return;
+      }
+
+      QVector<SensorReadings::Reading> const readings = readUnchunkedReadings(connection, brewNoteId);
+      if (readings.isEmpty()) {
+         return;
+      }
+      TimeSeriesChunk::Columns columns;
+      columns.values.resize(2);
+      Rollups rollups[std::size(rollupResolutions_s)];
+      for (SensorReadings::Reading const & reading : readings) {
+         columns.timestamps_ms.append(reading.timestamp_ms);
+         columns.values[0].append(reading.sg           .value_or(std::numeric_limits<double>::quiet_NaN()));
+         columns.values[1].append(reading.temperature_c.value_or(std::numeric_limits<double>::quiet_NaN()));
+         for (std::size_t ii = 0; ii < std::size(rollupResolutions_s); ++ii) {
+            addToRollups(rollups[ii], rollupResolutions_s[ii], reading);
+         }
+      }
+
+      BtSqlQuery insertQuery{connection};
+      insertQuery.prepare(
+         QString("INSERT INTO %1 (brewnote_id, first_time_ms, last_time_ms, num_readings, data) "
+                 "VALUES (?, ?, ?, ?, ?)").arg(chunkTableName)
+      );
+      insertQuery.addBindValue(brewNoteId);
+      insertQuery.addBindValue(readings.first().timestamp_ms);
+      insertQuery.addBindValue(readings.last().timestamp_ms);
+      insertQuery.addBindValue(readings.size());
+      insertQuery.addBindValue(TimeSeriesChunk::encode(columns));
+      if (!execOrLog(insertQuery, "storing sensor reading chunk")) {
+         return;
+      }
+      for (std::size_t ii = 0; ii < std::size(rollupResolutions_s); ++ii) {
+         if (!storeRollups(connection, brewNoteId, rollupResolutions_s[ii], rollups[ii])) {
+            return;
+         }
+      }
+      // All writes are on the writer thread, so nothing can have added readings since we read them
+      BtSqlQuery deleteQuery{connection};
+      deleteQuery.prepare(QString("DELETE FROM %1 WHERE brewnote_id = ?").arg(readingTableName));
+      deleteQuery.addBindValue(brewNoteId);
+      execOrLog(deleteQuery, "removing chunked sensor readings");
+      qCDebug(Logging::database) <<
+         Q_FUNC_INFO << "Compressed" << readings.size() << "sensor readings for BrewNote #" << brewNoteId;
+      return;
+   }
+
+   //! Called on the writer thread
+   void writeReadings(QVector<SensorReadings::Reading> const & readings) {
+      QElapsedTimer timer;
+      timer.start();
+      Database & database = Database::instance();
+      QSqlDatabase connection = database.sqlDatabase();
+      DbTransaction dbTransaction{database, connection, QString("Store %1 sensor readings").arg(readings.size())};
+
+      BtSqlQuery insertQuery{connection};
+      insertQuery.prepare(
+         QString("INSERT INTO %1 (brewnote_id, reading_time_ms, sg, temperature_c) VALUES (?, ?, ?, ?)").arg(
+            readingTableName
+         )
+      );
+      QSet<int> brewNoteIds;
+      for (SensorReadings::Reading const & reading : readings) {
+         insertQuery.addBindValue(reading.brewNoteId);
+         insertQuery.addBindValue(reading.timestamp_ms);
+         insertQuery.addBindValue(optionalToVariant(reading.sg));
+         insertQuery.addBindValue(optionalToVariant(reading.temperature_c));
+         if (!insertQuery.exec()) {
+            qCWarning(Logging::database) <<
+               Q_FUNC_INFO << "Error storing sensor reading for BrewNote #" << reading.brewNoteId << ":" <<
+               insertQuery.lastError().text();
+         }
+         brewNoteIds.insert(reading.brewNoteId);
+      }
+      for (int const brewNoteId : brewNoteIds) {
+         chunkReadingsIfEnough(connection, brewNoteId);
+      }
+
+      dbTransaction.commit();
+      qCDebug(Logging::database) <<
+         Q_FUNC_INFO << "Stored" << readings.size() << "sensor readings in" << timer.elapsed() << "ms";
+      return;
+   }
+
+   /**
+    * \brief Parse one line received by the UDP listener (see comment in header for the format) and submit it.  Called
+    *        on the listener thread.
+    */
+   void submitLine(QByteArray const & line) {
+      QList<QByteArray> const fields = line.trimmed().split(',');
+      SensorReadings::Reading reading;
+      bool ok = fields.size() == 4;
+      if (ok) {
+         reading.brewNoteId = fields[0].trimmed().toInt(&ok);
+      }
+      if (ok) {
+         QByteArray const timestamp = fields[1].trimmed();
+         reading.timestamp_ms = timestamp.isEmpty() ? QDateTime::currentMSecsSinceEpoch() : timestamp.toLongLong(&ok);
+      }
+      for (auto [index, value] : {std::make_pair(2, &reading.sg), std::make_pair(3, &reading.temperature_c)}) {
+         QByteArray const field = ok ? fields[index].trimmed() : QByteArray{};
+         if (!field.isEmpty()) {
+            *value = field.toDouble(&ok);
+         }
+      }
+      if (!ok) {
+         qCWarning(Logging::database) << Q_FUNC_INFO << "Ignoring unrecognised sensor reading:" << line;
+         return;
+      }
+      SensorReadings::submit(reading);
+      return;
+   }
+}
+
+void SensorReadings::Statistic::add(double const value) {
+   ++this->count;
+   this->sum += value;
+   this->min = std::min(this->min, value);
+   this->max = std::max(this->max, value);
+   return;
+}
+
+void SensorReadings::Statistic::merge(SensorReadings::Statistic const & other) {
+   this->count += other.count;
+   this->sum   += other.sum;
+   this->min = std::min(this->min, other.min);
+   this->max = std::max(this->max, other.max);
+   return;
+}
+
+double SensorReadings::Statistic::mean() const {
+   if (this->count == 0) {
+      return std::numeric_limits<double>::quiet_NaN();
+   }
+   return this->sum / this->count;
+}
+
+bool SensorReadings::createTables(Database & database, QSqlDatabase & connection) {
+   bool const isPostgres = database.dbType() == Database::DbType::PGSQL;
+   QString const doubleType = isPostgres ? "DOUBLE PRECISION" : "REAL";
+   QString const blobType   = isPostgres ? "BYTEA"            : "BLOB";
+   QStringList const queries{
+      QString("CREATE TABLE IF NOT EXISTS %1 ("
+              "brewnote_id INTEGER NOT NULL, "
+              "reading_time_ms BIGINT NOT NULL, "
+              "sg %2, "
+              "temperature_c %2)").arg(readingTableName, doubleType),
+      // Readings are always looked up by brew note, in time order
+      QString("CREATE INDEX IF NOT EXISTS %1_brewnote_idx ON %1 (brewnote_id, reading_time_ms)").arg(readingTableName),
+      QString("CREATE TABLE IF NOT EXISTS %1 ("
+              "brewnote_id INTEGER NOT NULL, "
+              "first_time_ms BIGINT NOT NULL, "
+              "last_time_ms BIGINT NOT NULL, "
+              "num_readings INTEGER NOT NULL, "
+              "data %2 NOT NULL)").arg(chunkTableName, blobType),
+      QString("CREATE INDEX IF NOT EXISTS %1_brewnote_idx ON %1 (brewnote_id, first_time_ms)").arg(chunkTableName),
+      QString("CREATE TABLE IF NOT EXISTS %1 ("
+              "brewnote_id INTEGER NOT NULL, "
+              "resolution_s INTEGER NOT NULL, "
+              "period_start_ms BIGINT NOT NULL, "
+              "sg_count INTEGER NOT NULL, "
+              "sg_sum %2, "
+              "sg_min %2, "
+              "sg_max %2, "
+              "temperature_count INTEGER NOT NULL, "
+              "temperature_sum %2, "
+              "temperature_min %2, "
+              "temperature_max %2)").arg(rollupTableName, doubleType),
+      QString(
+         "CREATE INDEX IF NOT EXISTS %1_brewnote_idx ON %1 (brewnote_id, resolution_s, period_start_ms)"
+      ).arg(rollupTableName),
+   };
+   BtSqlQuery sqlQuery{connection};
+   for (QString const & query : queries) {
+      if (!sqlQuery.exec(query)) {
+         qCCritical(Logging::database) <<
+            Q_FUNC_INFO << "Error creating sensor readings table:" << sqlQuery.lastError().text() << "(Query:" <<
+            query << ")";
+         return false;
+      }
+   }
+   return true;
+}
+
+bool SensorReadings::submit(SensorReadings::Reading const & reading) {
+   SensorReadings::Reading queuedReading{reading};
+   std::size_t position = 0;
+   if (!readingQueue.tryPush(queuedReading, position)) {
+      qint64 const dropped = numDropped.fetch_add(1, std::memory_order_relaxed) + 1;
+      // Don't flood the log if we're being sent far more than we can handle
+      if (dropped == 1 || dropped % 1000 == 0) {
+         qCWarning(Logging::database) <<
+            Q_FUNC_INFO << "Sensor reading queue full, so dropped reading for BrewNote #" << reading.brewNoteId <<
+            "(" << dropped << "dropped so far)";
+      }
+      return false;
+   }
+
+   if (!flushScheduled.exchange(true)) {
+      // We might not be on the main thread, so we can't start a timer directly
+      QMetaObject::invokeMethod(QCoreApplication::instance(), []() {
+         QTimer::singleShot(flushDelay_ms, QCoreApplication::instance(), []() {
+            SensorReadings::flushPendingReadings();
+            return;
+         });
+         return;
+      }, Qt::QueuedConnection);
+   }
+   return true;
+}
+
+void SensorReadings::flushPendingReadings() {
+   // It's a coding error to call this other than on the main thread, as that's the queue's one consumer
+   Q_ASSERT(QThread::currentThread() == QCoreApplication::instance()->thread());
+   // Clear the flag first, so that anything submitted from now on schedules another flush
+   flushScheduled.store(false);
+
+   QVector<SensorReadings::Reading> batch;
+   QSet<int> brewNoteIds;
+   SensorReadings::Reading reading;
+   while (readingQueue.tryPop(reading)) {
+      if (!ObjectStoreWrapper::contains<BrewNote>(reading.brewNoteId)) {
+         qCWarning(Logging::database) <<
+            Q_FUNC_INFO << "Ignoring sensor reading for non-existent BrewNote #" << reading.brewNoteId;
+         continue;
+      }
+      auto recent = recentByBrewNote.find(reading.brewNoteId);
+      if (recent != recentByBrewNote.end()) {
+         recent->push_back(reading);
+         if (recent->size() > maxRecentReadingsPerBrewNote) {
+            recent->pop_front();
+         }
+      }
+      brewNoteIds.insert(reading.brewNoteId);
+      batch.append(reading);
+   }
+   if (batch.isEmpty()) {
+      return;
+   }
+
+   if (readingsListener) {
+      readingsListener(brewNoteIds);
+   }
+   writerThreadPool().start(QRunnable::create([batch = std::move(batch)]() {
+      writeReadings(batch);
+      return;
+   }));
+   return;
+}
+
+QVector<SensorReadings::Reading> SensorReadings::recentReadings(int const brewNoteId) {
+   Q_ASSERT(QThread::currentThread() == QCoreApplication::instance()->thread());
+   auto recent = recentByBrewNote.find(brewNoteId);
+   if (recent == recentByBrewNote.end()) {
+      // Make sure everything we've already taken off the queue is in the DB before we read it
+      writerThreadPool().waitForDone();
+      recent = recentByBrewNote.insert(brewNoteId, std::deque<SensorReadings::Reading>{});
+
+      //
+      // Start with the readings not yet in a chunk, then work back through the chunks, newest first, until we have
+      // enough.
+      //
+      QSqlDatabase connection = Database::instance().sqlDatabase();
+      QVector<SensorReadings::Reading> readings = readUnchunkedReadings(connection, brewNoteId);
+      BtSqlQuery sqlQuery{connection};
+      sqlQuery.prepare(
+         QString("SELECT data FROM %1 WHERE brewnote_id = ? ORDER BY last_time_ms DESC").arg(chunkTableName)
+      );
+      sqlQuery.addBindValue(brewNoteId);
+      if (execOrLog(sqlQuery, "reading sensor reading chunks")) {
+         while (static_cast<std::size_t>(readings.size()) < maxRecentReadingsPerBrewNote && sqlQuery.next()) {
+            appendChunkReadings(sqlQuery.value(0).toByteArray(),
+                                brewNoteId,
+                                std::numeric_limits<qint64>::min(),
+                                std::numeric_limits<qint64>::max(),
+                                readings);
+         }
+      }
+      sortByTime(readings);
+      int const numToSkip = std::max(0, readings.size() - static_cast<int>(maxRecentReadingsPerBrewNote));
+      recent->assign(readings.cbegin() + numToSkip, readings.cend());
+   }
+   return QVector<SensorReadings::Reading>(recent->cbegin(), recent->cend());
+}
+
+QVector<SensorReadings::ChartPoint> SensorReadings::chartPoints(int const brewNoteId,
+                                                                qint64 const from_ms,
+                                                                qint64 const to_ms,
+                                                                int const maxPoints) {
+   Q_ASSERT(QThread::currentThread() == QCoreApplication::instance()->thread());
+   QVector<SensorReadings::ChartPoint> points;
+   if (maxPoints <= 0 || from_ms > to_ms) {
+      return points;
+   }
+   writerThreadPool().waitForDone();
+   QSqlDatabase connection = Database::instance().sqlDatabase();
+
+   //
+   // Chunks record how many readings they hold, so we can find out whether we can return raw readings without having
+   // to decode anything.  (A chunk that only partly overlaps the range will make this an over-estimate, which just
+   // means we might use rollups where raw readings would have fitted.)
+   //
+   qint64 numReadings = 0;
+   BtSqlQuery countQuery{connection};
+   countQuery.prepare(
+      QString("SELECT COALESCE(SUM(num_readings), 0) FROM %1 "
+              "WHERE brewnote_id = ? AND last_time_ms >= ? AND first_time_ms <= ?").arg(chunkTableName)
+   );
+   countQuery.addBindValue(brewNoteId);
+   countQuery.addBindValue(from_ms);
+   countQuery.addBindValue(to_ms);
+   if (execOrLog(countQuery, "counting sensor readings") && countQuery.next()) {
+      numReadings = countQuery.value(0).toLongLong();
+   }
+   QVector<SensorReadings::Reading> const unchunkedReadings =
+      readUnchunkedReadings(connection, brewNoteId, from_ms, to_ms);
+   numReadings += unchunkedReadings.size();
+
+   if (numReadings <= maxPoints) {
+      for (SensorReadings::Reading const & reading : readReadings(connection, brewNoteId, from_ms, to_ms)) {
+         SensorReadings::ChartPoint point;
+         point.timestamp_ms = reading.timestamp_ms;
+         if (reading.sg           ) { point.sg           .add(*reading.sg           ); }
+         if (reading.temperature_c) { point.temperature_c.add(*reading.temperature_c); }
+         points.append(point);
+      }
+      return points;
+   }
+
+   //
+   // Otherwise, use the finest rollups that fit, or, if even the coarsest have too many periods, the coarsest, which we
+   // then combine below.  Readings that are not yet in a chunk are not yet in the rollups either, so we add them in
+   // here.
+   //
+   int resolution_s = std::end(rollupResolutions_s)[-1];
+   for (int const candidate_s : rollupResolutions_s) {
+      if ((to_ms - from_ms) / (candidate_s * qint64{1000}) + 1 <= maxPoints) {
+         resolution_s = candidate_s;
+         break;
+      }
+   }
+   qint64 const period_ms = resolution_s * qint64{1000};
+   qint64 const firstStart_ms = periodStart(from_ms, period_ms);
+   Rollups rollups = readRollups(connection, brewNoteId, resolution_s, firstStart_ms, to_ms);
+   for (SensorReadings::Reading const & reading : unchunkedReadings) {
+      addToRollups(rollups, resolution_s, reading);
+   }
+
+   qint64 const numPeriods = (periodStart(to_ms, period_ms) - firstStart_ms) / period_ms + 1;
+   qint64 const periodsPerPoint = (numPeriods + maxPoints - 1) / maxPoints;
+   qint64 const pointPeriod_ms = period_ms * periodsPerPoint;
+   for (auto ii = rollups.cbegin(); ii != rollups.cend(); ++ii) {
+      qint64 const pointStart_ms = firstStart_ms + ((ii.key() - firstStart_ms) / pointPeriod_ms) * pointPeriod_ms;
+      if (points.isEmpty() || points.last().timestamp_ms != pointStart_ms) {
+         SensorReadings::ChartPoint point;
+         point.timestamp_ms = pointStart_ms;
+         points.append(point);
+      }
+      points.last().sg           .merge(ii->sg           );
+      points.last().temperature_c.merge(ii->temperature_c);
+   }
+   return points;
+}
+
+void SensorReadings::setReadingsListener(std::function<void(QSet<int> const & brewNoteIds)> listener) {
+   readingsListener = std::move(listener);
+   return;
+}
+
+void SensorReadings::startListening() {
+   if (listenerThread) {
+      return;
+   }
+   int const port = PersistentSettings::value(PersistentSettings::Names::sensorUdpPort, 0).toInt();
+   if (port <= 0) {
+      return;
+   }
+   // See comment in header for why we only listen on the loopback interface unless told otherwise
+   QString const bindAddressSetting =
+      PersistentSettings::value(PersistentSettings::Names::sensorUdpBindAddress, "127.0.0.1").toString();
+   QHostAddress const bindAddress{bindAddressSetting};
+   if (bindAddress.isNull()) {
+      qCWarning(Logging::database) <<
+         Q_FUNC_INFO << "Not listening for sensor readings, as" << bindAddressSetting << "is not a valid address";
+      return;
+   }
+   if (!bindAddress.isLoopback()) {
+      qCWarning(Logging::database) <<
+         Q_FUNC_INFO << "Sensor readings will be accepted, without authentication, from any host that can reach" <<
+         bindAddress.toString() << "on UDP port" << port;
+   }
+
+   listenerThread = new QThread{};
+   listenerThread->setObjectName("SensorListener");
+   listenerSocket = new QUdpSocket{};
+   listenerSocket->moveToThread(listenerThread);
+   QObject::connect(listenerThread, &QThread::finished, listenerSocket, &QObject::deleteLater);
+   listenerThread->start();
+
+   QUdpSocket * socket = listenerSocket;
+   QMetaObject::invokeMethod(socket, [socket, bindAddress, port]() {
+      if (!socket->bind(bindAddress, static_cast<quint16>(port))) {
+         qCWarning(Logging::database) <<
+            Q_FUNC_INFO << "Could not listen for sensor readings on" << bindAddress.toString() << "UDP port" << port <<
+            ":" << socket->errorString();
+         return;
+      }
+      qCInfo(Logging::database) <<
+         Q_FUNC_INFO << "Listening for sensor readings on" << bindAddress.toString() << "UDP port" << port;
+      QObject::connect(socket, &QUdpSocket::readyRead, socket, [socket]() {
+         while (socket->hasPendingDatagrams()) {
+            QNetworkDatagram const datagram = socket->receiveDatagram();
+            for (QByteArray const & line : datagram.data().split('\n')) {
+               if (!line.trimmed().isEmpty()) {
+                  submitLine(line);
+               }
+            }
+         }
+         return;
+      });
+      return;
+   }, Qt::QueuedConnection);
+   return;
+}
+
+void SensorReadings::stopListening() {
+   if (!listenerThread) {
+      return;
+   }
+   // The socket gets deleted (on its own thread) when the thread finishes
+   listenerThread->quit();
+   listenerThread->wait();
+   delete listenerThread;
+   listenerThread = nullptr;
+   listenerSocket = nullptr;
+   return;
+}
+
+void SensorReadings::unload() {
+   SensorReadings::stopListening();
+   SensorReadings::flushPendingReadings();
+   writerThreadPool().waitForDone();
+   recentByBrewNote.clear();
+   return;
+}
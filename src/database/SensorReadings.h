@@ -0,0 +1,159 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * database/SensorReadings.h is part of Brewtarget, and is copyright the following authors 2024:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#ifndef DATABASE_SENSORREADINGS_H
+#define DATABASE_SENSORREADINGS_H
+#pragma once
+
+#include <functional>
+#include <limits>
+#include <optional>
+
+#include <QSet>
+#include <QSqlDatabase>
+#include <QtGlobal>
+#include <QVector>
+
+class Database;
+
+/**
+ * \brief Readings from fermentation sensors (digital hydrometers, temperature probes, etc), each attached to the
+ *        \c BrewNote for the batch being fermented.
+ *
+ *        Readings can arrive often (eg every few seconds from each of several fermenters), so they take the following
+ *        route, which never does a DB query per reading:
+ *          - \c submit (callable on any thread, including the UDP listener's -- see \c startListening) puts the
+ *            reading on a bounded lock-free queue;
+ *          - about once a second, on the main thread, we take everything off the queue, add it to the in-memory
+ *            buffer of recent readings for each brew note that has one (see \c recentReadings), and tell the listener
+ *            set by \c setReadingsListener which brew notes have new readings;
+ *          - the same batch is then written to the DB, in one transaction, on a background thread.
+ *
+ *        In the DB, new readings are stored one per row.  Once a brew note has a few hours' worth, they are compressed
+ *        into one "chunk" (see \c TimeSeriesChunk), so a fermentation of a few weeks is a couple of hundred rows
+ *        rather than a hundred thousand or so.  At the same time, we add them to summaries ("rollups") of the readings
+ *        in each minute, quarter-hour and hour, so that \c chartPoints can show any length of time without having to
+ *        read more than a bounded number of points.
+ *
+ *        If readings arrive faster than we can take them off the queue, the excess are dropped (and logged).
+ *
+ *        The UDP listener accepts datagrams of one or more lines, each of the form
+ *
+ *           brewNoteId,timestamp,specificGravity,temperatureC
+ *
+ *        where timestamp is in milliseconds since the Unix epoch, and all but the first field can be left empty (an
+ *        empty timestamp meaning "now").
+ *
+ *        Except where stated, functions must be called on the main thread.
+ */
+namespace SensorReadings {
+
+   struct Reading {
+      int                   brewNoteId    = -1;
+      //! Milliseconds since the Unix epoch
+      qint64                timestamp_ms  = 0;
+      std::optional<double> sg            = std::nullopt;
+      std::optional<double> temperature_c = std::nullopt;
+   };
+
+   /**
+    * \brief Summary of the values of one quantity over a period
+    */
+   struct Statistic {
+      int    count = 0;
+      double sum   = 0.0;
+      double min   =  std::numeric_limits<double>::infinity();
+      double max   = -std::numeric_limits<double>::infinity();
+
+      void add(double const value);
+      void merge(Statistic const & other);
+      //! \return NaN if there are no values
+      double mean() const;
+   };
+
+   /**
+    * \brief One point on a chart: either one reading, or a summary of all the readings in a period starting at
+    *        \c timestamp_ms
+    */
+   struct ChartPoint {
+      qint64    timestamp_ms = 0;
+      Statistic sg;
+      Statistic temperature_c;
+   };
+
+   /**
+    * \brief Create the tables that hold the readings.  This is done as part of \c CreateAllDatabaseTables, and when
+    *        upgrading an existing database.  Tables that already exist are left alone, so a later schema version can
+    *        call this again to add newer tables.  Note that it is the caller's responsibility to handle transactions.
+    *
+    * \return \c false if something went wrong, \c true otherwise
+    */
+   bool createTables(Database & database, QSqlDatabase & connection);
+
+   /**
+    * \brief Queue a reading to be stored.  Can be called on any thread.
+    *
+    * \return \c false if the queue was full, in which case the reading has been dropped
+    */
+   bool submit(Reading const & reading);
+
+   /**
+    * \brief Take queued readings off the queue and pass them on (see above).  There's usually no need to call this, as
+    *        it is done automatically shortly after readings are submitted.
+    */
+   void flushPendingReadings();
+
+   /**
+    * \return Up to the last day or so of readings for \c brewNoteId, oldest first.  The first call for a given brew
+    *         note reads them from the DB; after that, they come from memory and are kept up to date as new readings
+    *         arrive, so live charts can call this every time they are told of new readings.
+    */
+   QVector<Reading> recentReadings(int const brewNoteId);
+
+   /**
+    * \return At most \c maxPoints points, in time order, covering the readings for \c brewNoteId from \c from_ms to
+    *         \c to_ms.  If there are few enough readings in that time, we return them all, otherwise summaries of
+    *         equal periods.
+    */
+   QVector<ChartPoint> chartPoints(int const brewNoteId, qint64 const from_ms, qint64 const to_ms, int const maxPoints);
+
+   /**
+    * \brief Set the function to call, on the main thread, with the IDs of the brew notes that have new readings.  Pass
+    *        an empty function to stop being told.
+    */
+   void setReadingsListener(std::function<void(QSet<int> const & brewNoteIds)> listener);
+
+   /**
+    * \brief Start listening for readings on the UDP port given by the \c sensorUdpPort setting, if it is set.  The
+    *        socket lives on its own thread, so bursts of readings don't hold up the user interface.
+    *
+    *        Readings are not authenticated, and each one is written to the DB, so, by default, we only accept them
+    *        from this machine.  To accept readings from other devices on the network (eg a hydrometer's bridge), set
+    *        \c sensorUdpBindAddress to the address of the network interface to listen on, or to "0.0.0.0" (or "::")
+    *        for all of them.  Anything on that network can then send readings.
+    */
+   void startListening();
+
+   void stopListening();
+
+   /**
+    * \brief Stop listening, write out any pending readings and forget the ones in memory, ready for a different DB to
+    *        be loaded.  Called from \c Database::unload.
+    */
+   void unload();
+
+}
+
+#endif
@@ -0,0 +1,427 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * database/SyntheticData.cpp is part of Brewtarget, and is copyright the following authors 2024:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#include "database/SyntheticData.h"
+
+#include <algorithm>
+#include <memory>
+#include <random>
+
+#include <QDate>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+#include "database/ObjectStoreWrapper.h"
+#include "Logging.h"
+#include "model/BrewNote.h"
+#include "model/Fermentable.h"
+#include "model/Hop.h"
+#include "model/InventoryFermentable.h"
+#include "model/InventoryHop.h"
+#include "model/InventoryMisc.h"
+#include "model/InventoryYeast.h"
+#include "model/Mash.h"
+#include "model/MashStep.h"
+#include "model/Misc.h"
+#include "model/Recipe.h"
+#include "model/RecipeAdditionFermentable.h"
+#include "model/RecipeAdditionHop.h"
+#include "model/RecipeAdditionMisc.h"
+#include "model/RecipeAdditionYeast.h"
+#include "model/Yeast.h"
+
+namespace {
+
+   class Random {
+   public:
+      explicit Random(quint32 const seed) : m_engine{seed} {
+         return;
+      }
+
+      //! \return Integer in the range [min, max]
+      int between(int const min, int const max) {
+         return min + static_cast<int>(static_cast<quint32>(this->m_engine()) % static_cast<quint32>(max - min + 1));
+      }
+
+      //! \return Number in the range [min, max)
+      double real(double const min, double const max) {
+         return min + (max - min) * (static_cast<quint32>(this->m_engine()) / 4294967296.0);
+      }
+
+      //! \return \c true with probability \c percent / 100
+      bool chance(int const percent) {
+         return this->between(0, 99) < percent;
+      }
+
+      template<class T> T const & pick(QList<T> const & from) {
+         return from.at(this->between(0, from.size() - 1));
+      }
+
+   private:
+      std::mt19937 m_engine;
+   };
+
+   QStringList const beerStyles{
+      "Pale Ale", "IPA", "Stout", "Porter", "Pilsner", "Helles", "Dubbel", "Saison", "Hefeweizen", "Bitter",
+      "Brown Ale", "Barleywine", "Kölsch", "Märzen", "Red Ale", "Witbier", "Tripel", "Schwarzbier", "Gose", "Mild"
+   };
+
+   QStringList const folders{
+      "", "", "Ales", "Ales/Pale", "Ales/Dark", "Lagers", "Belgian", "Wheat", "Competition", "Experiments/2023",
+      "Experiments/2024"
+   };
+
+   //! Typical hop addition times, in minutes from the end of the boil.  Negative means dry hop.
+   QList<int> const hopTimes_mins{60, 60, 45, 30, 20, 15, 10, 5, 0, 0, -1, -1};
+
+   /**
+    * \brief Generates everything and keeps track of what it has generated
+    */
+   class Generator {
+   public:
+      Generator(Random & random, SyntheticData::Summary & summary) : m_random{random}, m_summary{summary} {
+         return;
+      }
+
+      //! Note a name or amount in the fingerprint
+      template<class T> void addToFingerprint(T const & value) {
+         this->m_summary.fingerprint = this->m_summary.fingerprint * 31 + qHash(value, 0);
+         return;
+      }
+
+      template<class NE> QVector<int> insert(QList<std::shared_ptr<NE>> const & nes) {
+         if (nes.isEmpty()) {
+            return QVector<int>{};
+         }
+         QVector<int> const keys = ObjectStoreWrapper::insertBatch(nes);
+         if (keys.size() != nes.size()) {
+            qCWarning(Logging::database) << Q_FUNC_INFO << "Failed to insert" << nes.size() << "objects";
+            this->m_summary.succeeded = false;
+         }
+         return keys;
+      }
+
+      /**
+       * \brief The pool of ingredients for recipes to use.  It grows more slowly than the number of recipes, as bigger
+       *        databases tend to reuse more of the same ingredients.
+       */
+      void makeIngredients(int const numRecipes) {
+         int const poolSize = 20 + numRecipes / 10;
+         for (int ii = 0; ii < poolSize; ++ii) {
+            auto fermentable = std::make_shared<Fermentable>(QString{"Synthetic Malt %1"}.arg(ii));
+            fermentable->setType(this->m_random.chance(85) ? Fermentable::Type::Grain : Fermentable::Type::Sugar);
+            fermentable->setColor_srm(fermentable->type() == Fermentable::Type::Grain ?
+                                      this->m_random.real(1.5, 500.0) : this->m_random.real(0.0, 50.0));
+            fermentable->setFineGrindYield_pct(this->m_random.real(60.0, 82.0));
+            this->m_fermentables.append(fermentable);
+
+            auto hop = std::make_shared<Hop>(QString{"Synthetic Hop %1"}.arg(ii));
+            hop->setAlpha_pct(this->m_random.real(2.0, 18.0));
+            hop->setType(this->m_random.chance(50) ? Hop::Type::Aroma : Hop::Type::Bittering);
+            hop->setForm(this->m_random.chance(80) ? Hop::Form::Pellet : Hop::Form::Leaf);
+            this->m_hops.append(hop);
+
+            this->addToFingerprint(fermentable->name());
+            this->addToFingerprint(fermentable->color_srm());
+            this->addToFingerprint(hop->alpha_pct());
+         }
+         for (int ii = 0; ii < poolSize / 2; ++ii) {
+            auto misc = std::make_shared<Misc>(QString{"Synthetic Misc %1"}.arg(ii));
+            misc->setType(this->m_random.chance(50) ? Misc::Type::Spice : Misc::Type::Fining);
+            this->m_miscs.append(misc);
+
+            auto yeast = std::make_shared<Yeast>(QString{"Synthetic Yeast %1"}.arg(ii));
+            yeast->setType(this->m_random.chance(70) ? Yeast::Type::Ale : Yeast::Type::Lager);
+            yeast->setForm(this->m_random.chance(60) ? Yeast::Form::Dry : Yeast::Form::Liquid);
+            this->m_yeasts.append(yeast);
+         }
+         this->insert(this->m_fermentables);
+         this->insert(this->m_hops);
+         this->insert(this->m_miscs);
+         this->insert(this->m_yeasts);
+         this->m_summary.ingredients +=
+            this->m_fermentables.size() + this->m_hops.size() + this->m_miscs.size() + this->m_yeasts.size();
+         return;
+      }
+
+      //! Most, but not all, ingredients are in stock
+      void makeInventory() {
+         QList<std::shared_ptr<InventoryFermentable>> inventoryFermentables;
+         QList<std::shared_ptr<InventoryHop        >> inventoryHops;
+         QList<std::shared_ptr<InventoryMisc       >> inventoryMiscs;
+         QList<std::shared_ptr<InventoryYeast      >> inventoryYeasts;
+         using Measurement::PhysicalQuantity;
+         this->makeInventoryFor(this->m_fermentables, inventoryFermentables, 0.5 , 25.0, PhysicalQuantity::Mass );
+         this->makeInventoryFor(this->m_hops        , inventoryHops        , 0.05,  1.0, PhysicalQuantity::Mass );
+         this->makeInventoryFor(this->m_miscs       , inventoryMiscs       , 0.01,  0.5, PhysicalQuantity::Mass );
+         this->makeInventoryFor(this->m_yeasts      , inventoryYeasts      , 1.0 , 10.0, PhysicalQuantity::Count);
+         this->insert(inventoryFermentables);
+         this->insert(inventoryHops);
+         this->insert(inventoryMiscs);
+         this->insert(inventoryYeasts);
+         this->m_summary.inventories +=
+            inventoryFermentables.size() + inventoryHops.size() + inventoryMiscs.size() + inventoryYeasts.size();
+         return;
+      }
+
+      /**
+       * \brief Make \c numRecipes recipes, each with between one and eight versions
+       */
+      void makeRecipes(int const numRecipes) {
+         //
+         // Each version of a recipe needs the key of the one before it, so we insert one generation of versions at a
+         // time: all the first versions, then all the second versions, and so on.
+         //
+         QList<int> numVersions;
+         int maxVersions = 1;
+         for (int ii = 0; ii < numRecipes; ++ii) {
+            int const versions =
+               this->m_random.chance(70) ? 1 : (this->m_random.chance(67) ? this->m_random.between(2, 3) :
+                                                                              this->m_random.between(4, 8));
+            numVersions.append(versions);
+            maxVersions = std::max(maxVersions, versions);
+         }
+
+         QList<std::shared_ptr<Recipe>> previousGeneration;
+         for (int generation = 0; generation < maxVersions; ++generation) {
+            QList<std::shared_ptr<Recipe>> thisGeneration;
+            for (int ii = 0; ii < numRecipes; ++ii) {
+               if (generation >= numVersions.at(ii)) {
+                  thisGeneration.append(nullptr);
+                  continue;
+               }
+               auto recipe = std::make_shared<Recipe>(
+                  QString{"Synthetic %1 %2"}.arg(this->m_random.pick(beerStyles)).arg(ii)
+               );
+               if (generation > 0) {
+                  // Same name as the earlier versions
+                  recipe->setName(previousGeneration.at(ii)->name());
+                  recipe->setAncestorId(previousGeneration.at(ii)->key(), false);
+               }
+               bool const isLatest = generation == numVersions.at(ii) - 1;
+               recipe->setDisplay(isLatest);
+               recipe->setLocked(!isLatest);
+               recipe->setHasDescendants(!isLatest);
+               recipe->setFolder(this->m_random.pick(folders));
+               recipe->setBatchSize_l(this->m_random.chance(80) ? 23.0 : this->m_random.real(5.0, 1000.0));
+               recipe->setEfficiency_pct(this->m_random.real(60.0, 85.0));
+               recipe->setMashId(this->m_mashKeys.at(this->m_random.between(0, this->m_mashKeys.size() - 1)));
+               thisGeneration.append(recipe);
+               this->addToFingerprint(recipe->name());
+            }
+
+            QList<std::shared_ptr<Recipe>> toInsert;
+            for (auto const & recipe : thisGeneration) {
+               if (recipe) {
+                  toInsert.append(recipe);
+               }
+            }
+            this->insert(toInsert);
+            this->m_summary.recipes += toInsert.size();
+            this->makeAdditions(toInsert);
+            for (int ii = 0; ii < numRecipes; ++ii) {
+               if (thisGeneration.at(ii) && generation == numVersions.at(ii) - 1) {
+                  this->m_latestVersions.append(thisGeneration.at(ii));
+               }
+               if (!thisGeneration.at(ii)) {
+                  // Keep hold of the last version so that positions in the list still match recipe numbers
+                  thisGeneration[ii] = previousGeneration.value(ii);
+               }
+            }
+            previousGeneration = thisGeneration;
+         }
+         this->m_summary.oldVersions = this->m_summary.recipes - numRecipes;
+         return;
+      }
+
+      /**
+       * \brief Mashes are shared between recipes, as they tend to be in practice (eg everyone's "Single Infusion")
+       */
+      void makeMashes(int const numRecipes) {
+         QList<std::shared_ptr<Mash>> mashes;
+         int const numMashes = 5 + numRecipes / 20;
+         for (int ii = 0; ii < numMashes; ++ii) {
+            auto mash = std::make_shared<Mash>(QString{"Synthetic Mash %1"}.arg(ii));
+            mash->setGrainTemp_c(this->m_random.real(15.0, 22.0));
+            mash->setSpargeTemp_c(this->m_random.real(74.0, 80.0));
+            mashes.append(mash);
+         }
+         this->m_mashKeys = this->insert(mashes);
+
+         QList<std::shared_ptr<MashStep>> steps;
+         for (int const mashKey : this->m_mashKeys) {
+            int const numSteps = this->m_random.chance(60) ? 1 : this->m_random.between(2, 4);
+            double temperature_c = numSteps == 1 ? this->m_random.real(64.0, 69.0) : this->m_random.real(40.0, 55.0);
+            for (int stepNumber = 1; stepNumber <= numSteps; ++stepNumber) {
+               auto step = std::make_shared<MashStep>(QString{"Step %1"}.arg(stepNumber));
+               step->setOwnerId(mashKey);
+               step->setStepNumber(stepNumber);
+               step->setType(MashStep::Type::Infusion);
+               step->setStartTemp_c(temperature_c);
+               step->setStepTime_mins(this->m_random.between(1, 12) * 5.0);
+               step->setAmount_l(this->m_random.real(8.0, 20.0));
+               steps.append(step);
+               temperature_c = std::min(temperature_c + this->m_random.real(4.0, 12.0), 78.0);
+            }
+         }
+         this->insert(steps);
+         this->m_summary.mashSteps += steps.size();
+         return;
+      }
+
+      //! Only the latest version of each recipe gets brewed
+      void makeBrewNotes() {
+         QList<std::shared_ptr<BrewNote>> brewNotes;
+         QDate const firstBrewDay{2015, 1, 1};
+         for (auto const & recipe : this->m_latestVersions) {
+            int const numBrews = this->m_random.chance(40) ? 0 : this->m_random.between(1, 6);
+            for (int ii = 0; ii < numBrews; ++ii) {
+               auto brewNote = std::make_shared<BrewNote>(*recipe);
+               brewNote->setBrewDate(firstBrewDay.addDays(this->m_random.between(0, 3650)));
+               brewNote->setOg(this->m_random.real(1.035, 1.095));
+               brewNote->setFg(this->m_random.real(1.004, 1.020));
+               brewNote->setBrewhouseEff_pct(this->m_random.real(60.0, 85.0));
+               brewNotes.append(brewNote);
+               this->addToFingerprint(brewNote->og());
+            }
+         }
+         this->insert(brewNotes);
+         this->m_summary.brewNotes += brewNotes.size();
+         return;
+      }
+
+   private:
+      template<class Ingr, class Inv>
+      void makeInventoryFor(QList<std::shared_ptr<Ingr>> const & ingredients,
+                            QList<std::shared_ptr<Inv>> & inventories,
+                            double const minQuantity,
+                            double const maxQuantity,
+                            Measurement::PhysicalQuantity const measure) {
+         for (auto const & ingredient : ingredients) {
+            if (this->m_random.chance(60)) {
+               auto inventory = std::make_shared<Inv>();
+               inventory->setIngredientId(ingredient->key());
+               inventory->setMeasure(measure);
+               inventory->setQuantity(this->m_random.real(minQuantity, maxQuantity));
+               inventories.append(inventory);
+            }
+         }
+         return;
+      }
+
+      template<class RA, class Ingr>
+      void makeAdditionsOf(QList<std::shared_ptr<Recipe>> const & recipes,
+                           QList<std::shared_ptr<Ingr>> const & ingredients,
+                           int const minPerRecipe,
+                           int const maxPerRecipe,
+                           QList<std::shared_ptr<RA>> & additions) {
+         for (auto const & recipe : recipes) {
+            int const numAdditions = this->m_random.between(minPerRecipe, maxPerRecipe);
+            for (int ii = 0; ii < numAdditions; ++ii) {
+               auto const & ingredient = this->m_random.pick(ingredients);
+               auto addition = std::make_shared<RA>(ingredient->name());
+               addition->setRecipeId(recipe->key());
+               addition->setIngredientId(ingredient->key());
+               additions.append(addition);
+            }
+         }
+         return;
+      }
+
+      void makeAdditions(QList<std::shared_ptr<Recipe>> const & recipes) {
+         QList<std::shared_ptr<RecipeAdditionFermentable>> fermentableAdditions;
+         QList<std::shared_ptr<RecipeAdditionHop        >> hopAdditions;
+         QList<std::shared_ptr<RecipeAdditionMisc       >> miscAdditions;
+         QList<std::shared_ptr<RecipeAdditionYeast      >> yeastAdditions;
+         // Mostly 3-6 fermentables and 2-5 hops, with the odd recipe having only one or lots
+         this->makeAdditionsOf(recipes, this->m_fermentables, 1, 9, fermentableAdditions);
+         this->makeAdditionsOf(recipes, this->m_hops        , 1, 8, hopAdditions        );
+         this->makeAdditionsOf(recipes, this->m_miscs       , 0, 3, miscAdditions       );
+         this->makeAdditionsOf(recipes, this->m_yeasts      , 1, 2, yeastAdditions      );
+
+         for (auto const & addition : fermentableAdditions) {
+            addition->setStage(RecipeAddition::Stage::Mash);
+            addition->setMeasure(Measurement::PhysicalQuantity::Mass);
+            addition->setQuantity(this->m_random.real(0.1, 6.0));
+            this->addToFingerprint(addition->quantity());
+         }
+         for (auto const & addition : hopAdditions) {
+            int const time_mins = this->m_random.pick(hopTimes_mins);
+            addition->setStage(time_mins < 0 ? RecipeAddition::Stage::Fermentation : RecipeAddition::Stage::Boil);
+            if (time_mins >= 0) {
+               addition->setAddAtTime_mins(time_mins);
+            }
+            addition->setMeasure(Measurement::PhysicalQuantity::Mass);
+            addition->setQuantity(this->m_random.real(0.005, 0.1));
+            this->addToFingerprint(addition->quantity());
+         }
+         for (auto const & addition : miscAdditions) {
+            addition->setStage(RecipeAddition::Stage::Boil);
+            addition->setAddAtTime_mins(this->m_random.between(0, 15));
+            addition->setMeasure(Measurement::PhysicalQuantity::Mass);
+            addition->setQuantity(this->m_random.real(0.001, 0.05));
+         }
+         for (auto const & addition : yeastAdditions) {
+            addition->setStage(RecipeAddition::Stage::Fermentation);
+            addition->setMeasure(Measurement::PhysicalQuantity::Count);
+            addition->setQuantity(this->m_random.between(1, 3));
+         }
+
+         this->insert(fermentableAdditions);
+         this->insert(hopAdditions);
+         this->insert(miscAdditions);
+         this->insert(yeastAdditions);
+         this->m_summary.additions +=
+            fermentableAdditions.size() + hopAdditions.size() + miscAdditions.size() + yeastAdditions.size();
+         return;
+      }
+
+      Random & m_random;
+      SyntheticData::Summary & m_summary;
+      QList<std::shared_ptr<Fermentable>> m_fermentables;
+      QList<std::shared_ptr<Hop        >> m_hops;
+      QList<std::shared_ptr<Misc       >> m_miscs;
+      QList<std::shared_ptr<Yeast      >> m_yeasts;
+      QVector<int> m_mashKeys;
+      QList<std::shared_ptr<Recipe>> m_latestVersions;
+   };
+}
+
+SyntheticData::Summary SyntheticData::generate(SyntheticData::Parameters const & parameters) {
+   QElapsedTimer timer;
+   timer.start();
+
+   // As when importing, we don't want to be creating new versions of recipes just because we're filling them in
+   RecipeHelper::SuspendRecipeVersioning suspendRecipeVersioning;
+
+   SyntheticData::Summary summary;
+   Random random{parameters.seed};
+   Generator generator{random, summary};
+   generator.makeIngredients(parameters.numRecipes);
+   generator.makeInventory();
+   generator.makeMashes(parameters.numRecipes);
+   generator.makeRecipes(parameters.numRecipes);
+   generator.makeBrewNotes();
+
+   qCInfo(Logging::database) <<
+      Q_FUNC_INFO << "Generated" << summary.recipes << "recipes (" << summary.oldVersions << "old versions)," <<
+      summary.ingredients << "ingredients," << summary.additions << "additions," << summary.mashSteps <<
+      "mash steps," << summary.brewNotes << "brew notes and" << summary.inventories << "inventory items from seed" <<
+      parameters.seed << "in" << timer.elapsed() << "ms";
+   return summary;
+}
@@ -0,0 +1,63 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * database/SyntheticData.h is part of Brewtarget, and is copyright the following authors 2024:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#ifndef DATABASE_SYNTHETICDATA_H
+#define DATABASE_SYNTHETICDATA_H
+#pragma once
+
+#include <cstddef>
+
+#include <QtGlobal>
+
+/**
+ * \brief Generates big, realistic-looking, databases for benchmarks and scale testing: recipes with typical numbers of
+ *        additions and mash steps, some with several versions (ancestor chains), brew notes, folders, and a pool of
+ *        ingredients, many with inventory.  Everything is written through the bulk insert path
+ *        (\c ObjectStore::insertMany), one batch per type (or, for recipe versions, per generation).
+ *
+ *        The same seed always gives the same data.  For this reason, we only use the raw output of \c std::mt19937,
+ *        whose sequence is fixed by the C++ standard, and not the standard distributions, whose results differ from
+ *        one standard library to another.
+ *
+ *        Must be called on the main thread, after the object stores have been initialised.
+ */
+namespace SyntheticData {
+
+   struct Parameters {
+      //! Number of recipes, not counting their previous versions
+      int numRecipes = 100;
+      quint32 seed = 1;
+   };
+
+   //! What was generated
+   struct Summary {
+      int recipes      = 0;
+      //! Included in \c recipes
+      int oldVersions  = 0;
+      int ingredients  = 0;
+      int additions    = 0;
+      int mashSteps    = 0;
+      int brewNotes    = 0;
+      int inventories  = 0;
+      //! Hash of the names and amounts generated, so it's easy to check that two runs with the same seed match
+      std::size_t fingerprint = 0;
+      //! \c false if any of the inserts failed
+      bool succeeded = true;
+   };
+
+   Summary generate(Parameters const & parameters);
+}
+
+#endif
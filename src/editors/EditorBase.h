@@ -348,11 +348,15 @@ public:
          return;
       }
 
-      this->writeNormalFields();
-      if (this->m_editItem->key() < 0) {
-         ObjectStoreWrapper::insert(this->m_editItem);
+      {
+         // Saving is one logical edit, so whatever is displaying the item only needs to hear about it once
+         NamedEntityChangeBatch changeBatch;
+         this->writeNormalFields();
+         if (this->m_editItem->key() < 0) {
+            ObjectStoreWrapper::insert(this->m_editItem);
+         }
+         this->writeLateFields();
       }
-      this->writeLateFields();
 
       this->derived().setVisible(false);
       return;
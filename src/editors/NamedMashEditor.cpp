@@ -44,9 +44,9 @@ NamedMashEditor::NamedMashEditor(QWidget* parent, MashStepEditor* editor, bool s
       // pushButton_new->setVisible(false);
    }
 
-   //! Create the list model and assign it to the combo box
-   this->m_mashListModel = new MashListModel(mashComboBox);
-   this->mashComboBox->setModel(this->m_mashListModel);
+   //! Get the (shared) list model and assign it to the combo box
+   this->m_mashListModel = MashListModel::shared();
+   this->mashComboBox->setModel(this->m_mashListModel.get());
 
    //! Create the table model (and may St. Stevens take pity)
    this->m_mashStepTableModel = new MashStepTableModel(mashStepTableWidget);
@@ -57,8 +57,8 @@ NamedMashEditor::NamedMashEditor(QWidget* parent, MashStepEditor* editor, bool s
    this->m_mashStepEditor = editor;
 
    //! And do some fun stuff with the equipment
-   this->m_equipListModel = new EquipmentListModel(equipmentComboBox);
-   this->equipmentComboBox->setModel(m_equipListModel);
+   this->m_equipListModel = EquipmentListModel::shared();
+   this->equipmentComboBox->setModel(this->m_equipListModel.get());
 
    SMART_FIELD_INIT(NamedMashEditor, label_name      , lineEdit_name      , Mash, PropertyNames::NamedEntity::name             );
    SMART_FIELD_INIT(NamedMashEditor, label_grainTemp , lineEdit_grainTemp , Mash, PropertyNames::Mash::grainTemp_c          , 1);
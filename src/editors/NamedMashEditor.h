@@ -19,6 +19,8 @@
 #define EDITORS_NAMEDMASHEDITOR_H
 #pragma once
 
+#include <memory>
+
 #include <QDialog>
 #include <QMetaProperty>
 #include <QString>
@@ -83,14 +85,14 @@ public slots:
 private:
    //! The mash we are watching
    std::shared_ptr<Mash> m_mashObs;
-   //! The mash list model for the combobox
-   MashListModel * m_mashListModel;
+   //! The mash list model for the combobox -- see \c ListModelBase::shared
+   std::shared_ptr<MashListModel> m_mashListModel;
    //! The table model
    MashStepTableModel * m_mashStepTableModel;
    //! and the mash step edit. Don't know if we need this one
    MashStepEditor * m_mashStepEditor;
    //! This is getting fun!
-   EquipmentListModel* m_equipListModel;
+   std::shared_ptr<EquipmentListModel> m_equipListModel;
 
    //! Show any changes made. This will get ugly, I am sure
    void showChanges(QMetaProperty * prop = nullptr);
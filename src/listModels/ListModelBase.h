@@ -18,11 +18,14 @@
 #pragma once
 
 #include <memory>
+#include <utility>
 
 #include <QList>
 #include <QMetaProperty>
 #include <QModelIndex>
+#include <QSet>
 #include <QVariant>
+#include <QVector>
 #include <QWidget>
 
 #include "model/Recipe.h"
@@ -45,12 +48,45 @@ class ListModelBase : public CuriouslyRecurringTemplateBase<ListModelPhantom, De
 public:
    ListModelBase() :
       m_items{},
-      m_recipe{nullptr} {
+      m_recipe{nullptr},
+      m_inBulkDelivery{false},
+      m_bulkInsertedIds{},
+      m_bulkDeletedItems{} {
       this->derived().connect(&ObjectStoreTyped<NE>::getInstance(), &ObjectStoreTyped<NE>::signalObjectInserted, &this->derived(), &Derived::addItem);
       this->derived().connect(&ObjectStoreTyped<NE>::getInstance(), &ObjectStoreTyped<NE>::signalObjectDeleted , &this->derived(), &Derived::removeItem);
+      this->derived().connect(&ObjectStoreTyped<NE>::getInstance(),
+                              &ObjectStoreTyped<NE>::signalBulkDeliveryStarting,
+                              &this->derived(),
+                              [this]() { this->m_inBulkDelivery = true; return; });
+      this->derived().connect(&ObjectStoreTyped<NE>::getInstance(),
+                              &ObjectStoreTyped<NE>::signalBulkDeliveryFinished,
+                              &this->derived(),
+                              [this]() { this->endBulkDelivery(); return; });
       return;
    }
 
+   /**
+    * \brief Returns the shared instance of this list model, creating it if there isn't one at the moment.
+    *
+    *        Every instance of a list model watches the same \c ObjectStore and holds the same list of items, so there
+    *        is no point in each combo box having its own.  Instead, each widget holds a \c shared_ptr to the one
+    *        instance, which is destroyed when the last of them goes away.  (A \c QComboBox keeps its own current
+    *        index, so several of them can sit on the same model.  Widgets that need their own sorting or filtering put
+    *        their own proxy model in front of the shared instance.)
+    *
+    *        Because the instance is shared, it has no parent \c QObject, and callers must not give it one.  Like the
+    *        rest of the GUI code, this is only to be called from the GUI thread.
+    */
+   static std::shared_ptr<Derived> shared() {
+      static std::weak_ptr<Derived> instance;
+      std::shared_ptr<Derived> result = instance.lock();
+      if (!result) {
+         result = std::make_shared<Derived>();
+         instance = result;
+      }
+      return result;
+   }
+
    //! \brief Add items to the list model
    void addItems(QList<NE *> items) {
       QList<NE *> tmp;
@@ -65,7 +101,7 @@ public:
 
       if (tmp.size() > 0) {
          int size = m_items.size();
-         this->derived().beginInsertRows(QModelIndex(), size, size + tmp.size());
+         this->derived().beginInsertRows(QModelIndex(), size, size + tmp.size() - 1);
          m_items.append(tmp);
 
          for (NE * ii : tmp) {
@@ -172,6 +208,11 @@ protected:
 
    void doAddItem(int itemId) {
       qDebug() << Q_FUNC_INFO << "New" << NE::staticMetaObject.className() << "#" << itemId;
+      // See endBulkDelivery
+      if (this->m_inBulkDelivery) {
+         this->m_bulkInsertedIds.append(itemId);
+         return;
+      }
       NE * ne = ObjectStoreWrapper::getByIdRaw<NE>(itemId);
       if (!ne || !ne->display() || ne->deleted()) {
          return;
@@ -190,10 +231,59 @@ protected:
    void doRemoveItem([[maybe_unused]] int itemId,
                      std::shared_ptr<QObject> object) {
       NE * item = std::static_pointer_cast<NE>(object).get();
+      // See endBulkDelivery
+      if (this->m_inBulkDelivery) {
+         this->m_bulkDeletedItems.insert(item);
+         return;
+      }
       this->remove(item);
       return;
    }
 
+   /**
+    * \brief Called at the end of a delivery of queued insertions and deletions from our \c ObjectStore (see
+    *        \c ObjectStoreSignalBatch), so we can remove all the deleted items in one go and then add all the new ones
+    *        in one insert, rather than updating views once per item.  (The \c ObjectStore keeps the deleted objects
+    *        alive until after it has told us the delivery is finished, so the pointers in \c m_bulkDeletedItems are
+    *        still valid here.)
+    */
+   void endBulkDelivery() {
+      this->m_inBulkDelivery = false;
+
+      if (!this->m_bulkDeletedItems.isEmpty()) {
+         QList<NE *> remainingItems;
+         QList<NE *> removedItems;
+         for (NE * item : this->m_items) {
+            if (this->m_bulkDeletedItems.contains(item)) {
+               removedItems.append(item);
+            } else {
+               remainingItems.append(item);
+            }
+         }
+         this->m_bulkDeletedItems.clear();
+         if (!removedItems.isEmpty()) {
+            this->derived().beginResetModel();
+            for (NE * item : removedItems) {
+               this->derived().disconnect(item, nullptr, &this->derived(), nullptr);
+            }
+            this->m_items = remainingItems;
+            this->derived().endResetModel();
+         }
+      }
+
+      if (!this->m_bulkInsertedIds.isEmpty()) {
+         QList<NE *> newItems;
+         for (int const itemId : std::exchange(this->m_bulkInsertedIds, {})) {
+            NE * item = ObjectStoreWrapper::getByIdRaw<NE>(itemId);
+            if (item) {
+               newItems.append(item);
+            }
+         }
+         this->addItems(newItems);
+      }
+      return;
+   }
+
    void doRecipeChanged(QMetaProperty prop, QVariant val, BtStringConst const & propNameInRecipe) {
       if (prop.name() == propNameInRecipe) {
          NE * newItem = val.value<NE *>();
@@ -206,6 +296,11 @@ protected:
 private:
    QList<NE *> m_items ;
    Recipe *    m_recipe;
+
+   //! Set while our \c ObjectStore is delivering queued signals -- see \c endBulkDelivery
+   bool             m_inBulkDelivery;
+   QVector<int>     m_bulkInsertedIds;
+   QSet<NE const *> m_bulkDeletedItems;
 };
 
 /**
@@ -23,6 +23,10 @@
 #include <xercesc/util/PlatformUtils.hpp>
 #include <xalanc/Include/PlatformDefinitions.hpp>
 
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+
 #include <QApplication>
 #include <QCommandLineParser>
 #include <QDate>
@@ -31,13 +35,16 @@
 #include <QSharedMemory>
 
 #include "Application.h"
+#include "BatchMode.h"
 #include "config.h"
 #include "database/Database.h"
 #include "Localization.h"
 #include "Logging.h"
 #include "PersistentSettings.h"
 #include "serialization/xml/BeerXml.h"
+#include "utils/Diagnostics.h"
 #include "utils/MetaTypes.h"
+#include "utils/Tracing.h"
 
 namespace {
 
@@ -91,6 +98,31 @@ namespace {
          return false;
       }
    };
+
+   /**
+    * \brief In batch mode (see \c BatchMode), we must not use any widgets, so we need to know whether we're in it
+    *        before we create the application object -- ie before we can use \c QCommandLineParser.
+    */
+   bool isBatchMode(int const argc, char const * const * const argv) {
+      for (int ii = 1; ii < argc; ++ii) {
+         if (qstrcmp(argv[ii], "--batch") == 0) {
+            return true;
+         }
+      }
+      return false;
+   }
+
+   /**
+    * \brief Tell the user about an error that means we can't carry on
+    */
+   void showFatalError(bool const batchMode, QString const & errorMessage) {
+      if (batchMode) {
+         qCritical().noquote() << errorMessage;
+      } else {
+         QMessageBox::critical(nullptr, QApplication::tr("Application terminates"), errorMessage);
+      }
+      return;
+   }
 }
 
 int main(int argc, char **argv) {
@@ -116,12 +148,20 @@ int main(int argc, char **argv) {
    // application name are set on the QApplication object, but omitting the call to setOrganizationName() takes out the
    // extra directory layer).
    //
-   ExceptionCatchingQApplication app(argc, argv);
-   app.setOrganizationDomain(CONFIG_ORGANIZATION_DOMAIN);
+   // In batch mode, there is no GUI, so we only need (and only want) a QCoreApplication
+   //
+   bool const batchMode = isBatchMode(argc, argv);
+   std::unique_ptr<QCoreApplication> app;
+   if (batchMode) {
+      app = std::make_unique<QCoreApplication>(argc, argv);
+   } else {
+      app = std::make_unique<ExceptionCatchingQApplication>(argc, argv);
+   }
+   app->setOrganizationDomain(CONFIG_ORGANIZATION_DOMAIN);
    // We used to vary the application name (and therefore location of config files etc) depending on whether we're
    // building with debug or release version of Qt, but on the whole I don't think this is helpful
-   app.setApplicationName(CONFIG_APPLICATION_NAME_LC);
-   app.setApplicationVersion(CONFIG_VERSION_STRING);
+   app->setApplicationName(CONFIG_APPLICATION_NAME_LC);
+   app->setApplicationVersion(CONFIG_VERSION_STRING);
 
    // Process command-line options relatively early as some may override other settings
    QCommandLineParser parser;
@@ -144,9 +184,116 @@ int main(int argc, char **argv) {
       QString()
    };
    parser.addOption(userDirectoryOption);
+   /*!
+    * \brief Turns on performance tracing (see \c Tracing) for this run.  (To have it on all the time, set
+    *        performanceTracing=true in the config file.)
+    */
+   QCommandLineOption const traceOption{"trace", "Record a performance trace (in the log directory)"};
+   parser.addOption(traceOption);
+   QCommandLineOption const exportTraceOption{
+      "export-trace",
+      "Export the last performance trace to <file> in Chrome trace-event JSON format, then exit",
+      "file"
+   };
+   parser.addOption(exportTraceOption);
+   QCommandLineOption const diagnosticsOption{
+      "diagnostics",
+      "On exit, write diagnostic counters (object store sizes, SQL statistics, etc) to stdout"
+   };
+   parser.addOption(diagnosticsOption);
+   /*!
+    * \brief Overrides the slowSqlThresholdMs setting (see \c Diagnostics::setSlowSqlThreshold_ms) for this run
+    */
+   QCommandLineOption const slowSqlOption{
+      "slow-sql-ms",
+      "Log SQL statements that take longer than <milliseconds> (0 to log none)",
+      "milliseconds"
+   };
+   parser.addOption(slowSqlOption);
+   /*!
+    * \brief Turns off the fast exit at the end of main(), so that everything gets destroyed properly, as memory
+    *        checkers etc expect
+    */
+   QCommandLineOption const fullTeardownOption{
+      "full-teardown",
+      "On exit, destroy every object the program created, rather than leaving the operating system to reclaim memory"
+   };
+   parser.addOption(fullTeardownOption);
+   /*!
+    * \brief Options for running without a GUI.  See \c BatchMode.
+    */
+   QCommandLineOption const batchOption{
+      "batch",
+      "Run without a user interface, doing what the other batch options below ask, then exit"
+   };
+   parser.addOption(batchOption);
+   QCommandLineOption const batchSyntheticOption{
+      "generate-recipes",
+      "In batch mode, first generate <count> synthetic recipes, with ingredients, brew notes etc, for benchmarking",
+      "count"
+   };
+   parser.addOption(batchSyntheticOption);
+   QCommandLineOption const batchSeedOption{
+      "seed",
+      "Random <seed> for --generate-recipes (default 1).  The same seed always generates the same data.",
+      "seed",
+      "1"
+   };
+   parser.addOption(batchSeedOption);
+   QCommandLineOption const batchImportOption{
+      "import",
+      "In batch mode, import recipes, ingredients etc from BeerXML or BeerJSON <file> (can be given more than once)",
+      "file"
+   };
+   parser.addOption(batchImportOption);
+   QCommandLineOption const batchImportChangesOption{
+      "import-changes",
+      "In batch mode, import a delta export made with --export-changes from another database",
+      "file"
+   };
+   parser.addOption(batchImportChangesOption);
+   QCommandLineOption const batchRecalculateOption{
+      "recalculate",
+      "In batch mode, recalculate all recipes"
+   };
+   parser.addOption(batchRecalculateOption);
+   QCommandLineOption const batchExportOption{
+      "export-recipes",
+      "In batch mode, export all recipes to <file> (BeerJSON, binary BeerJSON or BeerXML, according to its extension)",
+      "file"
+   };
+   parser.addOption(batchExportOption);
+   QCommandLineOption const batchExportChangesOption{
+      "export-changes",
+      "In batch mode, export what has changed since --changes-since to <file>, plus <file>.sync.json",
+      "file"
+   };
+   parser.addOption(batchExportChangesOption);
+   QCommandLineOption const batchChangesSinceOption{
+      "changes-since",
+      "Change <counter> from the previous --export-changes run (default 0, meaning export everything)",
+      "counter",
+      "0"
+   };
+   parser.addOption(batchChangesSinceOption);
+   QCommandLineOption const batchCheckDbOption{
+      "check-db",
+      "In batch mode, check the database for corruption and broken references"
+   };
+   parser.addOption(batchCheckDbOption);
+   QCommandLineOption const batchRepairDbOption{
+      "repair-db",
+      "In batch mode, with --check-db, also repair the broken references, and chains and cycles of parents, it finds"
+   };
+   parser.addOption(batchRepairDbOption);
+   QCommandLineOption const batchTimingsOption{
+      "timings",
+      "In batch mode, print how long each step took"
+   };
+   parser.addOption(batchTimingsOption);
    parser.addHelpOption();
    parser.addVersionOption();
-   parser.process(app);
+   parser.process(*app);
 
    //
    // Having initialised various QApplication settings and read command line options, we can now allow Qt to work out
@@ -165,6 +312,24 @@ int main(int argc, char **argv) {
    Logging::initializeLogging();
    qDebug() << Q_FUNC_INFO << "Logging initialised";
 
+   // The trace file goes in the log directory, so this has to come after logging is initialised
+   if (parser.isSet(exportTraceOption)) {
+      bool const exported = Tracing::exportChromeTrace(Tracing::defaultTraceFilePath(),
+                                                       parser.value(exportTraceOption));
+      Logging::terminateLogging();
+      return exported ? EXIT_SUCCESS : EXIT_FAILURE;
+   }
+   Diagnostics::setSlowSqlThreshold_ms(
+      parser.isSet(slowSqlOption) ?
+         parser.value(slowSqlOption).toInt() :
+         PersistentSettings::value(PersistentSettings::Names::slowSqlThresholdMs,
+                                   Diagnostics::defaultSlowSqlThreshold_ms).toInt()
+   );
+   if (parser.isSet(traceOption) ||
+       PersistentSettings::value(PersistentSettings::Names::performanceTracing, false).toBool()) {
+      Tracing::start(Tracing::defaultTraceFilePath());
+   }
+
    // Initialize Xerces XML tools
    // NB: This is also where where we would initialise xalanc::XalanTransformer if we were using it
    try {
@@ -189,6 +354,8 @@ int main(int argc, char **argv) {
    // get cleaned up.  We do attempt to detect and rectify such cases, with the double-check below, but it still seems
    // wise to allow the user to override the warning if for any reason it is triggered incorrectly.
    //
+   // In batch mode, there's no-one to ask, so we just refuse to run if it looks like another instance is running.
+   //
    QSharedMemory sharedMemory(CONFIG_APPLICATION_NAME_UC);
    if (!sharedMemory.create(1)) {
       //
@@ -200,6 +367,10 @@ int main(int argc, char **argv) {
       sharedMemory.attach();
       sharedMemory.detach(); // This should delete the shared memory if no other process is using it
       if (!sharedMemory.create(1)) {
+         if (batchMode) {
+            qCritical() << "Another instance of" << CONFIG_APPLICATION_NAME_UC << "is already running";
+            return EXIT_FAILURE;
+         }
          enum QMessageBox::StandardButton buttonPressed =
             QMessageBox::warning(NULL,
                                  QApplication::tr("%1 is already running!").arg(CONFIG_APPLICATION_NAME_UC),
@@ -211,7 +382,7 @@ int main(int argc, char **argv) {
          if (buttonPressed == QMessageBox::Ok) {
             // We haven't yet called exec on QApplication, so I'm not sure we _need_ to call exit() here, but it
             // doesn't seem to hurt.
-            app.exit();
+            app->exit();
             return EXIT_SUCCESS;
          }
       }
@@ -223,7 +394,7 @@ int main(int argc, char **argv) {
    try {
       qInfo() <<
          "Starting" << CONFIG_APPLICATION_NAME_UC << "v" << CONFIG_VERSION_STRING << " (app name" <<
-         app.applicationName() << ") on " << QSysInfo::prettyProductName();
+         app->applicationName() << ") on " << QSysInfo::prettyProductName();
       qInfo() <<
          "Built at" << CONFIG_BUILD_TIMESTAMP << "on" << CONFIG_BUILD_SYSTEM << "for" << CONFIG_RUN_SYSTEM << "with" <<
          CONFIG_CXX_COMPILER_ID << "compiler";
@@ -237,7 +408,35 @@ int main(int argc, char **argv) {
 
       registerMetaTypes();
 
-      auto mainAppReturnValue = Application::run();
+      int mainAppReturnValue = EXIT_SUCCESS;
+      if (batchMode) {
+         BatchMode::Options batchModeOptions;
+         batchModeOptions.syntheticRecipes    = parser.value(batchSyntheticOption).toInt();
+         batchModeOptions.syntheticSeed       = parser.value(batchSeedOption).toUInt();
+         batchModeOptions.filesToImport       = parser.values(batchImportOption);
+         batchModeOptions.changesToImport     = parser.value(batchImportChangesOption);
+         batchModeOptions.recalculateRecipes  = parser.isSet(batchRecalculateOption);
+         batchModeOptions.recipeExportFile    = parser.value(batchExportOption);
+         batchModeOptions.changesExportFile   = parser.value(batchExportChangesOption);
+         batchModeOptions.changesSinceCounter = parser.value(batchChangesSinceOption).toLongLong();
+         batchModeOptions.checkDatabase       = parser.isSet(batchCheckDbOption);
+         batchModeOptions.repairDatabase      = parser.isSet(batchRepairDbOption);
+         batchModeOptions.printTimings        = parser.isSet(batchTimingsOption);
+         batchModeOptions.printDiagnostics    = parser.isSet(diagnosticsOption);
+         mainAppReturnValue = BatchMode::run(batchModeOptions);
+      } else {
+         // This needs to happen before Application::run() cleans up, as the counters include what's in the object
+         // stores
+         if (parser.isSet(diagnosticsOption)) {
+            QObject::connect(app.get(), &QCoreApplication::aboutToQuit, []() {
+               QTextStream stdoutStream{stdout};
+               stdoutStream << Diagnostics::format(Diagnostics::takeSnapshot());
+               return;
+            });
+         }
+
+         mainAppReturnValue = Application::run();
+      }
 
       //
       // Clean exit of Xerces XML tools
@@ -250,25 +449,44 @@ int main(int argc, char **argv) {
 
       qDebug() << Q_FUNC_INFO << "Xerces terminated cleanly.  Returning " << mainAppReturnValue;
 
+      //
+      // By now, everything that matters has been written out: Application::cleanup has flushed any pending DB writes
+      // and closed the DB (doing the automatic backup, if one is due, while the DB was still open), and the main
+      // window saved its state when it was closed.  All that's left is for the static object stores to destroy every
+      // object in them one at a time, disconnecting each one's signals as they go.  With a big database, that takes a
+      // noticeable time, and it achieves nothing that the OS won't do for us much faster when the process ends.  So,
+      // unless asked not to, we skip it.
+      //
+      if (!parser.isSet(fullTeardownOption)) {
+         // On some platforms, the shared memory would otherwise outlive us and make the next run think we're still
+         // running
+         sharedMemory.detach();
+         PersistentSettings::sync();
+         qDebug() << Q_FUNC_INFO << "Exiting without destroying object stores";
+         Logging::terminateLogging();
+         std::fflush(nullptr);
+         std::_Exit(mainAppReturnValue);
+      }
+
       return mainAppReturnValue;
    }
    catch (const QString & error)
    {
-      QMessageBox::critical(0,
-            QApplication::tr("Application terminates"),
-            QApplication::tr("The application encountered a fatal error.\nError message:\n%1").arg(error));
+      showFatalError(
+         batchMode,
+         QApplication::tr("The application encountered a fatal error.\nError message:\n%1").arg(error)
+      );
    }
    catch (std::exception & exception)
    {
-      QMessageBox::critical(0,
-            QApplication::tr("Application terminates"),
-            QApplication::tr("The application encountered a fatal error.\nError message:\n%1").arg(exception.what()));
+      showFatalError(
+         batchMode,
+         QApplication::tr("The application encountered a fatal error.\nError message:\n%1").arg(exception.what())
+      );
    }
    catch (...)
    {
-      QMessageBox::critical(0,
-            QApplication::tr("Application terminates"),
-            QApplication::tr("The application encountered a fatal error."));
+      showFatalError(batchMode, QApplication::tr("The application encountered a fatal error."));
    }
    return EXIT_FAILURE;
 }
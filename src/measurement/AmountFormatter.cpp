@@ -0,0 +1,110 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * measurement/AmountFormatter.cpp is part of Brewtarget, and is copyright the following authors 2024:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#include "measurement/AmountFormatter.h"
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+
+#include <QtGlobal>
+
+#include "Localization.h"
+#include "measurement/Unit.h"
+
+namespace {
+   //
+   // All the formatters we've made so far.  We use std::map rather than QHash because we hand out references to the
+   // formatters, so they must not move around when new ones are added.  A scale of -1 means no forced scale.
+   //
+   // The mutex is because, although we _mostly_ format amounts on the GUI thread, we don't want to rely on it.
+   //
+   using FormatterKey = std::tuple<Measurement::UnitSystem const *, int, int>;
+   std::map<FormatterKey, std::unique_ptr<Measurement::AmountFormatter const>> formatters;
+   std::mutex formattersMutex;
+}
+
+Measurement::AmountFormatter const & Measurement::AmountFormatter::get(
+   UnitSystem const & unitSystem,
+   int const precision,
+   std::optional<UnitSystem::RelativeScale> const forcedScale
+) {
+   FormatterKey const key{&unitSystem, precision, forcedScale ? static_cast<int>(*forcedScale) : -1};
+
+   std::lock_guard<std::mutex> lock{formattersMutex};
+   auto existing = formatters.find(key);
+   if (existing != formatters.end()) {
+      return *existing->second;
+   }
+   // Constructor is private, so we can't use std::make_unique here
+   auto inserted = formatters.emplace(
+      key,
+      std::unique_ptr<AmountFormatter const>{new AmountFormatter{unitSystem, precision, forcedScale}}
+   );
+   return *inserted.first->second;
+}
+
+Measurement::AmountFormatter::AmountFormatter(UnitSystem const & unitSystem,
+                                              int const precision,
+                                              std::optional<UnitSystem::RelativeScale> const forcedScale) :
+   m_unitSystem{unitSystem},
+   m_precision {precision},
+   m_locale    {Localization::getLocale()},
+   m_choices   {} {
+   //
+   // This mirrors the logic of UnitSystem::impl::displayableAmount.  If there is only one unit in the unit system,
+   // there is no scale to choose, so we ignore any forced scale.
+   //
+   QList<UnitSystem::RelativeScale> const scales = unitSystem.getRelativeScales();
+   if (scales.isEmpty()) {
+      this->m_choices.push_back(Choice{unitSystem.unit(), 0.0});
+   } else if (forcedScale) {
+      // It's a coding error to specify a forced scale that is not in the UnitSystem
+      Q_ASSERT(scales.contains(*forcedScale));
+      this->m_choices.push_back(Choice{unitSystem.scaleUnit(*forcedScale), 0.0});
+   } else {
+      // getRelativeScales gives us the scales in order, smallest first
+      for (auto const scale : scales) {
+         Unit const * unit = unitSystem.scaleUnit(scale);
+         this->m_choices.push_back(Choice{unit, unit->toCanonical(unit->boundary()).quantity});
+      }
+   }
+   return;
+}
+
+Measurement::Unit const & Measurement::AmountFormatter::chooseUnit(double const canonicalQuantity) const {
+   // Use the largest unit that isn't too big to show the supplied amount (and, failing that, the smallest unit)
+   Unit const * chosen = this->m_choices.front().unit;
+   double const magnitude = qAbs(canonicalQuantity);
+   for (size_t ii = 1; ii < this->m_choices.size() && magnitude >= this->m_choices[ii].canonicalBoundary; ++ii) {
+      chosen = this->m_choices[ii].unit;
+   }
+   return *chosen;
+}
+
+QString Measurement::AmountFormatter::format(Amount const & amount) const {
+   if (amount.unit->getPhysicalQuantity() != this->m_unitSystem.getPhysicalQuantity()) {
+      return this->m_locale.toString(amount.quantity, 'f', this->m_precision);
+   }
+
+   double const canonicalQuantity = amount.unit->toCanonical(amount.quantity).quantity;
+   Unit const & unit = this->chooseUnit(canonicalQuantity);
+   QString result = this->m_locale.toString(unit.fromCanonical(canonicalQuantity), 'f', this->m_precision);
+   result.reserve(result.size() + 1 + unit.name.size());
+   result += ' ';
+   result += unit.name;
+   return result;
+}
@@ -0,0 +1,87 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * measurement/AmountFormatter.h is part of Brewtarget, and is copyright the following authors 2024:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#ifndef MEASUREMENT_AMOUNTFORMATTER_H
+#define MEASUREMENT_AMOUNTFORMATTER_H
+#pragma once
+
+#include <optional>
+#include <vector>
+
+#include <QLocale>
+#include <QString>
+
+#include "measurement/Amount.h"
+#include "measurement/UnitSystem.h"
+
+namespace Measurement {
+   class Unit;
+
+   /**
+    * \brief Turns amounts into display strings (eg "4.500 kg") for one \c UnitSystem at one precision, and optionally
+    *        one \c RelativeScale.  This is what \c UnitSystem::displayAmount (and therefore
+    *        \c Measurement::displayAmount) uses, so it gets called for every amount in every table cell, tooltip and
+    *        printed recipe.
+    *
+    *        Everything that doesn't depend on the amount itself -- which units we might use, the thresholds for
+    *        switching between them, the locale -- is worked out once, when the formatter is made.  Formatters are made
+    *        on demand, and kept, by \c get.  Because they are keyed on the \c UnitSystem (rather than, say, the
+    *        \c PhysicalQuantity), changing display settings does not invalidate them.  Instead, callers just
+    *        end up asking for a different one.
+    */
+   class AmountFormatter {
+   public:
+      /**
+       * \brief Get the (shared) formatter for the supplied parameters, making it if necessary.  The reference remains
+       *        valid for the life of the program.
+       *
+       * \param unitSystem
+       * \param precision Number of decimal places
+       * \param forcedScale If set, always use the \c Unit for this \c RelativeScale rather than choosing one based on
+       *                    the size of the amount
+       */
+      static AmountFormatter const & get(UnitSystem const & unitSystem,
+                                         int const precision,
+                                         std::optional<UnitSystem::RelativeScale> const forcedScale);
+
+      /**
+       * \return \c amount formatted for display, including the unit name.  If \c amount is for a different
+       *         \c PhysicalQuantity than our \c UnitSystem, we just show the number.
+       */
+      QString format(Amount const & amount) const;
+
+   private:
+      AmountFormatter(UnitSystem const & unitSystem,
+                      int const precision,
+                      std::optional<UnitSystem::RelativeScale> const forcedScale);
+
+      //! \return The \c Unit in which to show \c canonicalQuantity
+      Unit const & chooseUnit(double const canonicalQuantity) const;
+
+      //! A unit we might display in, along with the smallest (canonical) quantity for which we'd use it
+      struct Choice {
+         Unit const * unit;
+         double       canonicalBoundary;
+      };
+
+      UnitSystem const & m_unitSystem;
+      int const m_precision;
+      QLocale const m_locale;
+      //! Smallest unit first
+      std::vector<Choice> m_choices;
+   };
+}
+
+#endif
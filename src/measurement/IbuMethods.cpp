@@ -20,6 +20,7 @@
 
 #include <numbers> // For std::numbers::pi
 
+#include <algorithm>
 #include <cmath>
 
 #include <QDebug>
@@ -27,6 +28,7 @@
 #include <QString>
 
 #include "Algorithms.h"
+#include "Localization.h"
 #include "measurement/Unit.h"
 #include "PersistentSettings.h"
 
@@ -35,13 +37,20 @@ namespace {
       return std::numbers::pi * radius * radius;
    }
 
+   /**
+    * \brief The gravity-dependent part of Tinseth's formula (which the mIBU formula also uses)
+    */
+   double calculateBignessFactor(double const wortGravity_sg) {
+      return 1.65 * pow(0.000125, (wortGravity_sg - 1.0));
+   }
+
    /**
     * \brief This intermediate calculation is used in Tinseth's formula and the mIBU formula
     *
-    * \param wortGravity_sg
+    * \param bignessFactor from \c calculateBignessFactor
     * \param boilTime_minutes usually measured from the point at which hops are added until flameout
     */
-   double calculateDecimalAlphaAcidUtilization(double const wortGravity_sg,
+   double calculateDecimalAlphaAcidUtilization(double const bignessFactor,
                                                double const boilTime_minutes) {
       //
       // TODO This is Tinseth's "Utilization Table" from which we could probably get a better value for
@@ -84,7 +93,6 @@ namespace {
       // This is the short-cut way to get decimalAlphaAcidUtilization
       //
       double const boilTimeFactor = (1.0 - exp(-0.04 * boilTime_minutes)) / 4.15;
-      double const bignessFactor  = 1.65 * pow(0.000125, (wortGravity_sg - 1.0));
       double const decimalAlphaAcidUtilization = bignessFactor * boilTimeFactor;
       return decimalAlphaAcidUtilization;
    }
@@ -94,8 +102,8 @@ namespace {
     */
    double tinseth(IbuMethods::IbuCalculationParms const & parms) {
       double const mgPerLiterOfAddedAlphaAcids = (parms.AArating * parms.hops_grams * 1000) / parms.postBoilVolume_liters;
-      double const decimalAlphaAcidUtilization = calculateDecimalAlphaAcidUtilization(parms.wortGravity_sg,
-                                                                                      parms.boilTime_minutes);
+      double const decimalAlphaAcidUtilization =
+         calculateDecimalAlphaAcidUtilization(calculateBignessFactor(parms.wortGravity_sg), parms.boilTime_minutes);
       return decimalAlphaAcidUtilization * mgPerLiterOfAddedAlphaAcids;
 ///      return ((AArating * hops_grams * 1000) / postBoilVolume_liters) * ((1.0 - exp(-0.04 * boilTime_minutes)) / 4.15) * (1.65 * pow(0.000125, (wortGravity_sg - 1)));
    }
@@ -139,33 +147,93 @@ namespace {
       return(volumeFactor * ( hopsFactor * (100 * parms.AArating) * p.eval(parms.boilTime_minutes) ) * utilizationFactor);
    }
 
+   /**
+    * \brief One step of \c integrate: refine \c whole, the Simpson's rule estimate of the integral of \c func over
+    *        [\c a, \c b], by splitting the interval in two, and recurse on each half until the estimates agree to
+    *        within \c tolerance (or we run out of \c depth).
+    *
+    * \param fa \c func(a)
+    * \param fm \c func at the mid-point of [\c a, \c b]
+    * \param fb \c func(b)
+    */
+   template<typename Func>
+   double adaptiveSimpson(Func const & func,
+                          double const a, double const b,
+                          double const fa, double const fm, double const fb,
+                          double const whole,
+                          double const tolerance,
+                          int const depth) {
+      double const m = (a + b) / 2.0;
+      double const flm = func((a + m) / 2.0);
+      double const frm = func((m + b) / 2.0);
+      double const left  = (m - a) / 6.0 * (fa + 4.0 * flm + fm);
+      double const right = (b - m) / 6.0 * (fm + 4.0 * frm + fb);
+      double const delta = left + right - whole;
+      if (depth <= 0 || std::abs(delta) <= 15.0 * tolerance) {
+         // Richardson extrapolation of the two estimates
+         return left + right + delta / 15.0;
+      }
+      return adaptiveSimpson(func, a, m, fa, flm, fm, left , tolerance / 2.0, depth - 1) +
+             adaptiveSimpson(func, m, b, fm, frm, fb, right, tolerance / 2.0, depth - 1);
+   }
+
+   /**
+    * \brief Integrate the (smooth) function \c func over [\c a, \c b] by adaptive Simpson's rule, to within roughly
+    *        \c tolerance.  For the sort of functions we integrate, this needs a few dozen evaluations of \c func.
+    */
+   template<typename Func>
+   double integrate(Func const & func, double const a, double const b, double const tolerance) {
+      double const fa = func(a);
+      double const fm = func((a + b) / 2.0);
+      double const fb = func(b);
+      double const whole = (b - a) / 6.0 * (fa + 4.0 * fm + fb);
+      return adaptiveSimpson(func, a, b, fa, fm, fb, whole, tolerance, 20);
+   }
+
    /**
     * \brief Intermediate step used by mIBU formula
+    *
+    *        We used to do this integral numerically with 0.001 minute steps, which, for a 20 minute whirlpool or
+    *        no-chill cool, was 20,000 evaluations of the integrand for every hop addition every time the recipe's IBUs
+    *        were recalculated.  Now we split the cooling time where the integrand changes form (at 5 minutes) and do
+    *        the part before that exactly and the part after it by adaptive Simpson's rule.
+    *
+    * \param bignessFactor from \c calculateBignessFactor
     */
    double computePostBoilUtilization(double const boilTime_minutes,
-                                     double const wortGravity_sg,
+                                     double const bignessFactor,
                                      double const postBoilVolume_liters,
                                      double const coolTime_minutes,
                                      double const kettleInternalDiameter_cm,
                                      double const kettleOpeningDiameter_cm) {
+      if (coolTime_minutes <= 0.0) {
+         return 0.0;
+      }
 
       double const surfaceArea_cm2 = circleAreaFromRadius(kettleInternalDiameter_cm/2.0);
       double const openingArea_cm2 = circleAreaFromRadius(kettleOpeningDiameter_cm/2.0);
       double const effectiveArea_cm2 = sqrt(surfaceArea_cm2 * openingArea_cm2);
       double const b = (0.0002925 * effectiveArea_cm2 / postBoilVolume_liters) + 0.00538;
 
-      double const integrationTime = 0.001;
-      double decimalAArating = 0.0;
-      for (double time_minutes = boilTime_minutes;
-           time_minutes < boilTime_minutes + coolTime_minutes;
-           time_minutes += integrationTime) {
-         double const dU = -1.65 * pow(0.000125, (wortGravity_sg-1.0)) * -0.04 * exp(-0.04*time_minutes) / 4.15;
-         double const temp_degK = 53.70 * exp(-1.0 * b * (time_minutes - boilTime_minutes)) + 319.55;
-         double const degreeOfUtilization =
-            // The 1.0 case accounts for nonIAA components
-            (time_minutes < 5.0) ? 1.0 : 2.39*pow(10.0,11.0)*exp(-9773.0/temp_degK);
-         double const combinedValue = dU * degreeOfUtilization;
-         decimalAArating += (combinedValue * integrationTime);
+      double const endTime_minutes   = boilTime_minutes + coolTime_minutes;
+      double const splitTime_minutes = std::clamp(5.0, boilTime_minutes, endTime_minutes);
+
+      //
+      // Up to 5 minutes, the degree of utilization is 1.0 (to account for nonIAA components), so we are just
+      // integrating the rate of change of Tinseth's boil time factor, which gives the change in that factor.
+      //
+      double decimalAArating =
+         bignessFactor * (exp(-0.04 * boilTime_minutes) - exp(-0.04 * splitTime_minutes)) / 4.15;
+
+      if (splitTime_minutes < endTime_minutes) {
+         auto const combinedValue = [bignessFactor, b, boilTime_minutes](double const time_minutes) {
+            double const dU = bignessFactor * 0.04 * exp(-0.04 * time_minutes) / 4.15;
+            double const temp_degK = 53.70 * exp(-1.0 * b * (time_minutes - boilTime_minutes)) + 319.55;
+            double const degreeOfUtilization = 2.39 * pow(10.0, 11.0) * exp(-9773.0 / temp_degK);
+            return dU * degreeOfUtilization;
+         };
+         // Utilizations are typically of the order of 0.01 to 0.1, so this is more than accurate enough
+         decimalAArating += integrate(combinedValue, splitTime_minutes, endTime_minutes, 1.0e-8);
       }
       return decimalAArating;
    }
@@ -182,10 +250,11 @@ namespace {
       if (!parms.coolTime_minutes         ) { qWarning() << Q_FUNC_INFO << "coolTime_minutes          not set!"; }
       if (!parms.kettleInternalDiameter_cm) { qWarning() << Q_FUNC_INFO << "kettleInternalDiameter_cm not set!"; }
       if (!parms.kettleOpeningDiameter_cm ) { qWarning() << Q_FUNC_INFO << "kettleOpeningDiameter_cm  not set!"; }
-      double const decimalAlphaAcidUtilization = calculateDecimalAlphaAcidUtilization(parms.wortGravity_sg,
+      double const bignessFactor = calculateBignessFactor(parms.wortGravity_sg);
+      double const decimalAlphaAcidUtilization = calculateDecimalAlphaAcidUtilization(bignessFactor,
                                                                                       parms.boilTime_minutes);
       double const postBoilUtilization = computePostBoilUtilization(parms.boilTime_minutes,
-                                                                    parms.wortGravity_sg,
+                                                                    bignessFactor,
                                                                     parms.postBoilVolume_liters,
                                                                     parms.coolTime_minutes.value_or(0.0),
                                                                     parms.kettleInternalDiameter_cm.value_or(45.0),
@@ -195,6 +264,18 @@ namespace {
       double const IBU = (totalUtilization * parms.AArating * parms.hops_grams * 1000.0) / parms.postBoilVolume_liters;
       return IBU;
    }
+
+   /**
+    * \brief Applies \c formula to each element of \c parms.  Because \c formula is a template parameter, the call
+    *        gets inlined, giving a plain loop over the inputs.
+    */
+   template<double (*formula)(IbuMethods::IbuCalculationParms const &)>
+   void applyFormula(std::span<IbuMethods::IbuCalculationParms const> const parms, std::span<double> const ibus) {
+      for (std::size_t ii = 0; ii < parms.size(); ++ii) {
+         ibus[ii] = formula(parms[ii]);
+      }
+      return;
+   }
 }
 
 EnumStringMapping const IbuMethods::formulaStringMapping {
@@ -225,6 +306,8 @@ void IbuMethods::loadIbuFormula() {
       IbuMethods::ibuFormula = IbuMethods::IbuFormula::Rager;
    } else if (text == "noonan") {
        IbuMethods::ibuFormula = IbuMethods::IbuFormula::Noonan;
+   } else if (text == "mibu") {
+      IbuMethods::ibuFormula = IbuMethods::IbuFormula::mIbu;
    } else {
       qCritical() << Q_FUNC_INFO << "Bad ibu_formula type:" << text;
    }
@@ -241,14 +324,57 @@ QString IbuMethods::ibuFormulaName() {
    return IbuMethods::formulaDisplayNames[IbuMethods::ibuFormula];
 }
 
+double IbuMethods::firstWortHopAdjustment = 1.1;
+double IbuMethods::mashHopAdjustment      = 0.0;
+
+void IbuMethods::loadHopAdjustments() {
+   IbuMethods::firstWortHopAdjustment = Localization::toDouble(
+      PersistentSettings::value(PersistentSettings::Names::firstWortHopAdjustment, 1.1).toString(),
+      Q_FUNC_INFO
+   );
+   IbuMethods::mashHopAdjustment = Localization::toDouble(
+      PersistentSettings::value(PersistentSettings::Names::mashHopAdjustment, 0).toString(),
+      Q_FUNC_INFO
+   );
+   return;
+}
+
+void IbuMethods::saveHopAdjustments() {
+   PersistentSettings::insert(PersistentSettings::Names::firstWortHopAdjustment, IbuMethods::firstWortHopAdjustment);
+   PersistentSettings::insert(PersistentSettings::Names::mashHopAdjustment,      IbuMethods::mashHopAdjustment);
+   return;
+}
+
 double IbuMethods::getIbus(IbuMethods::IbuCalculationParms const & parms) {
    switch(IbuMethods::ibuFormula) {
       case IbuMethods::IbuFormula::Tinseth: return tinseth(parms);
       case IbuMethods::IbuFormula::Rager  : return rager  (parms);
       case IbuMethods::IbuFormula::Noonan : return noonan (parms);
+      case IbuMethods::IbuFormula::mIbu   : return mIbu   (parms);
    }
    qCritical() <<
       Q_FUNC_INFO << "Unrecognized IBU formula type:" << static_cast<int>(IbuMethods::ibuFormula) <<
       ".  Defaulting to Tinseth.";
    return tinseth(parms);
 }
+
+void IbuMethods::getIbus(std::span<IbuMethods::IbuCalculationParms const> parms, std::span<double> ibus) {
+   // It's a coding error to supply different-sized inputs and outputs
+   if (parms.size() != ibus.size()) {
+      qCritical() << Q_FUNC_INFO << "Have" << parms.size() << "inputs but" << ibus.size() << "outputs";
+      Q_ASSERT(false);
+      return;
+   }
+
+   switch(IbuMethods::ibuFormula) {
+      case IbuMethods::IbuFormula::Tinseth: applyFormula<tinseth>(parms, ibus); return;
+      case IbuMethods::IbuFormula::Rager  : applyFormula<rager  >(parms, ibus); return;
+      case IbuMethods::IbuFormula::Noonan : applyFormula<noonan >(parms, ibus); return;
+      case IbuMethods::IbuFormula::mIbu   : applyFormula<mIbu   >(parms, ibus); return;
+   }
+   qCritical() <<
+      Q_FUNC_INFO << "Unrecognized IBU formula type:" << static_cast<int>(IbuMethods::ibuFormula) <<
+      ".  Defaulting to Tinseth.";
+   applyFormula<tinseth>(parms, ibus);
+   return;
+}
@@ -19,6 +19,9 @@
 #define MEASUREMENT_IBUMETHODS_H
 #pragma once
 
+#include <optional>
+#include <span>
+
 #include "utils/EnumStringMapping.h"
 
 class QString;
@@ -80,6 +83,27 @@ namespace IbuMethods {
    //! \brief return the bitterness formula's name
    QString ibuFormulaName();
 
+   /**
+    * \brief Multiplier applied to the IBUs of first wort hop additions.  (We keep this and \c mashHopAdjustment in
+    *        memory because they are needed for every hop addition every time a recipe's IBUs are recalculated.)
+    */
+   extern double firstWortHopAdjustment;
+
+   /**
+    * \brief Multiplier applied to the IBUs of mash hop additions.  If this is zero, mash hops don't contribute IBUs.
+    */
+   extern double mashHopAdjustment;
+
+   /**
+    * \brief Read \c firstWortHopAdjustment and \c mashHopAdjustment in from persistent settings
+    */
+   void loadHopAdjustments();
+
+   /**
+    * \brief Write \c firstWortHopAdjustment and \c mashHopAdjustment out to persistent settings
+    */
+   void saveHopAdjustments();
+
    /**
     * \brief Parameters for the various IBU calculation formulae
     *
@@ -120,6 +144,17 @@ namespace IbuMethods {
     * \return IBUs according to selected algorithm.
     */
    double getIbus(IbuCalculationParms const & parms);
+
+   /*!
+    * \brief Batch version of the above.  Sets each element of \c ibus to the IBUs, according to the selected algorithm,
+    *        for the corresponding element of \c parms.  This is quicker than calling \c getIbus for each one, as we
+    *        only have to work out which formula to use once, and then the loop over the parameters is simple enough for
+    *        the compiler to optimise.
+    *
+    * \param parms
+    * \param ibus Must be the same size as \c parms
+    */
+   void getIbus(std::span<IbuCalculationParms const> parms, std::span<double> ibus);
 }
 
 #endif
@@ -35,7 +35,6 @@
 
 namespace {
 
-   int const fieldWidth = 0;
    char const format = 'f';
 
    /**
@@ -45,6 +44,9 @@ namespace {
     */
    QMap<Measurement::PhysicalQuantity, Measurement::UnitSystem const *> physicalQuantityToDisplayUnitSystem;
 
+   //! See \c Measurement::displaySettingsGeneration
+   unsigned int displaySettingsGen = 0;
+
    //
    // Load the previous stored setting for which UnitSystem we use for a particular physical quantity
    //
@@ -145,6 +147,7 @@ void Measurement::setDisplayUnitSystem(Measurement::PhysicalQuantity physicalQua
    Q_ASSERT(physicalQuantity == unitSystem.getPhysicalQuantity());
    qDebug() << Q_FUNC_INFO << "Setting UnitSystem for" << physicalQuantity << "to" << unitSystem.uniqueName;
    physicalQuantityToDisplayUnitSystem.insert(physicalQuantity, &unitSystem);
+   Measurement::displaySettingsChanged();
    return;
 }
 
@@ -169,8 +172,18 @@ Measurement::UnitSystem const & Measurement::getDisplayUnitSystem(Measurement::P
    return *unitSystem;
 }
 
+unsigned int Measurement::displaySettingsGeneration() {
+   return displaySettingsGen;
+}
+
+void Measurement::displaySettingsChanged() {
+   ++displaySettingsGen;
+   return;
+}
+
 QString Measurement::displayQuantity(double quantity, int precision) {
-   return QString("%L1").arg(quantity, fieldWidth, format, precision);
+   // This is equivalent to QString("%L1").arg(quantity, 0, format, precision), but saves parsing the pattern
+   return Localization::getLocale().toString(quantity, format, precision);
 }
 
 QString Measurement::displayQuantity(double quantity, int precision, NonPhysicalQuantity const nonPhysicalQuantity) {
@@ -69,6 +69,19 @@ namespace Measurement {
     */
    UnitSystem const & getDisplayUnitSystem(PhysicalQuantity physicalQuantity);
 
+   /**
+    * \brief Returns a number that changes whenever a setting that affects how amounts are displayed changes -- ie the
+    *        display \c UnitSystem for a \c PhysicalQuantity or the forced \c SystemOfMeasurement or
+    *        \c UnitSystem::RelativeScale for a field.  Anything that caches display strings can compare this with the
+    *        value it had when it built the cache to know whether the cache is still valid.
+    */
+   unsigned int displaySettingsGeneration();
+
+   /**
+    * \brief Call when one of the settings described in \c displaySettingsGeneration changes
+    */
+   void displaySettingsChanged();
+
    /*!
     * \brief Converts a quantity without units to a displayable string
     *
@@ -23,8 +23,8 @@
 #include <mutex>    // For std::once_flag etc
 #include <string>
 
+#include <QHash>
 #include <QStringList>
-#include <QRegExp>
 #include <QDebug>
 
 #include "Algorithms.h"
@@ -141,37 +141,131 @@ namespace {
       }
       return allMatches;
    }
+
+   /**
+    * \brief Key for \c resolvedUnits.  Note that we use the name as supplied, even for case-insensitive look-ups, so
+    *        we don't have to make a lower-case copy of it just to look in the cache.  (So "ml" and "mL" get separate
+    *        entries, which is fine.)
+    */
+   struct ResolvedUnitKey {
+      Measurement::PhysicalQuantity physicalQuantity;
+      QString                       name;
+      bool                          caseInensitiveMatching;
+
+      bool operator==(ResolvedUnitKey const & rhs) const {
+         return this->physicalQuantity       == rhs.physicalQuantity &&
+                this->caseInensitiveMatching == rhs.caseInensitiveMatching &&
+                this->name                   == rhs.name;
+      }
+   };
+
+   uint qHash(ResolvedUnitKey const & key, uint seed = 0) {
+      return ::qHash(key.name, seed) ^ (static_cast<uint>(key.physicalQuantity) << 1) ^
+             static_cast<uint>(key.caseInensitiveMatching);
+   }
+
+   //
+   // The units Unit::getUnit(name, physicalQuantity, caseInensitiveMatching) has already found.  We don't store misses,
+   // as names we don't recognise come from user input and imported files, so there's no limit on how many different
+   // ones we might see.  Since the answer can depend on the display unit system, these are only valid for the
+   // Measurement::displaySettingsGeneration() in resolvedUnitsGeneration.  We need the mutex as, unlike the other
+   // look-ups here, this one gets added to after initialisation.
+   //
+   QHash<ResolvedUnitKey, Measurement::Unit const *> resolvedUnits;
+   unsigned int resolvedUnitsGeneration = 0;
+   std::mutex resolvedUnitsMutex;
+
+   /**
+    * \brief This does the work for \c Unit::getUnit(name, physicalQuantity, caseInensitiveMatching) when we don't
+    *        already have the answer in \c resolvedUnits.
+    */
+   Measurement::Unit const * resolveUnit(QString const & name,
+                                         Measurement::PhysicalQuantity const & physicalQuantity,
+                                         bool const caseInensitiveMatching) {
+      auto matches = getUnitsByNameAndPhysicalQuantity(name, physicalQuantity, caseInensitiveMatching);
+
+      auto const numMatches = matches.length();
+      if (0 == numMatches) {
+         return nullptr;
+      }
+
+      // Under most circumstances, there is a one-to-one relationship between unit string and Unit. C will only map to
+      // Measurement::Unit::Celsius, for example. If there's only one match, just return it.
+      if (1 == numMatches) {
+         auto unitToReturn = matches.at(0);
+         if (unitToReturn->getPhysicalQuantity() != physicalQuantity) {
+            qWarning() <<
+               Q_FUNC_INFO << "Unit" << name << "matches a unit of type" << unitToReturn->getPhysicalQuantity() <<
+               "but caller specified" << physicalQuantity;
+            return nullptr;
+         }
+         return unitToReturn;
+      }
+
+      // That solved something like 99% of the use cases. Now we have to handle those pesky volumes.
+      // Loop through the found Units, like Measurement::Unit::us_quart and
+      // Measurement::Unit::imperial_quart, and try to find one that matches the global default.
+      Measurement::Unit const * defUnit = nullptr;
+      for (auto const unit : matches) {
+         auto const & displayUnitSystem = Measurement::getDisplayUnitSystem(unit->getPhysicalQuantity());
+         qDebug() <<
+            Q_FUNC_INFO << "Look at" << *unit << "from" << unit->getUnitSystem() << "(Display Unit System for" <<
+            unit->getPhysicalQuantity() << "is" << displayUnitSystem << ")";
+         if (unit->getPhysicalQuantity() != physicalQuantity) {
+            // If the caller knows the amount is, say, a Volume, don't bother trying to match against units for any
+            // other physical quantity.
+            qDebug() <<
+               Q_FUNC_INFO << "Ignoring match in" << unit->getPhysicalQuantity() << "as not" << physicalQuantity;
+            continue;
+         }
+
+         if (displayUnitSystem == unit->getUnitSystem()) {
+            // We found a match that belongs to one of the global default unit systems
+            return unit;
+         }
+
+         // Save this for later if we need it - ie if we don't find a better match
+         defUnit = unit;
+      }
+
+      // If we got here, we couldn't find a match. Unless something weird has
+      // happened, that means you entered "qt" into a field and the system
+      // default is SI. At that point, just use the USCustomary
+      return defUnit;
+   }
 }
 
 // This private implementation class holds all private non-virtual members of Unit
 class Measurement::Unit::impl {
 public:
    /**
-    * Simple case constructor -- conversion to/from canonical units is just multiplication/division
+    * Simple case constructor -- conversion to/from canonical units is just a LinearConversion
     */
    impl(Unit const & self,
         UnitSystem const & unitSystem,
-        double const multiplierToCanonical,
-        double const boundaryValue,
-        bool const isCanonical) :
-      m_self                 {self},
-      m_unitSystem           {unitSystem},
-      m_multiplierToCanonical{multiplierToCanonical},
-      m_convertToCanonical   {},
-      m_convertFromCanonical {},
-      m_boundaryValue        {boundaryValue},
-      m_isCanonical          {isCanonical} {
-      // If this is a canonical unit then, by definition, its multiplier should be 1.0.  Usually we wouldn't compare
-      // doubles, but I'm pretty sure comparing against 1.0 is safe in this context because there will never be a
-      // rounding error from the `1.0` literal.
+        LinearConversion const linearConversion,
+        Unit const * canonical,
+        double const boundaryValue) :
+      m_self                {self},
+      m_unitSystem          {unitSystem},
+      m_canonical           {canonical ? *canonical : self},
+      m_linearConversion    {linearConversion},
+      m_convertToCanonical  {},
+      m_convertFromCanonical{},
+      m_boundaryValue       {boundaryValue},
+      m_isCanonical         {canonical == nullptr} {
+      // If this is a canonical unit then, by definition, its multiplier should be 1.0 and its offset 0.0.  Usually we
+      // wouldn't compare doubles, but I'm pretty sure comparing against 1.0 is safe in this context because there will
+      // never be a rounding error from the `1.0` literal.
       //
       // Note, however, that it _can_ be valid for a non-canonical unit to have a 1.0 multiplier to and from canonical
       // units (eg Lovibond is a no-op conversion to/from SRM).
-      Q_ASSERT((isCanonical && 1.0 == multiplierToCanonical) || !isCanonical);
+      Q_ASSERT((this->m_isCanonical && 1.0 == linearConversion.multiplier && 0.0 == linearConversion.offset) ||
+               !this->m_isCanonical);
 
       // It's a coding error for the multiplier to be zero.  Again, I think this is an OK comparison to do since we're
       // checking for source code error rather than "value is so close to zero it might as well be zero".
-      Q_ASSERT(0.0 != multiplierToCanonical);
+      Q_ASSERT(0.0 != linearConversion.multiplier);
 
       return;
    }
@@ -184,14 +278,16 @@ public:
         UnitSystem const & unitSystem,
         std::function<double(double)> const convertToCanonical,
         std::function<double(double)> const convertFromCanonical,
+        Unit const * canonical,
         double const boundaryValue) :
-      m_self                 {self},
-      m_unitSystem           {unitSystem},
-      m_multiplierToCanonical{std::nullopt},
-      m_convertToCanonical   {convertToCanonical},
-      m_convertFromCanonical {convertFromCanonical},
-      m_boundaryValue        {boundaryValue},
-      m_isCanonical          {false} {
+      m_self                {self},
+      m_unitSystem          {unitSystem},
+      m_canonical           {canonical ? *canonical : self},
+      m_linearConversion    {std::nullopt},
+      m_convertToCanonical  {convertToCanonical},
+      m_convertFromCanonical{convertFromCanonical},
+      m_boundaryValue       {boundaryValue},
+      m_isCanonical         {false} {
       return;
    }
 
@@ -203,15 +299,14 @@ public:
    // Member variables for impl
    Unit const & m_self;
    UnitSystem const & m_unitSystem;
+   //! We know this from the constructor, so we store it rather than look it up each time
+   Unit const & m_canonical;
 
-   std::optional<double> const m_multiplierToCanonical = std::nullopt;
+   std::optional<LinearConversion> const m_linearConversion = std::nullopt;
    std::function<double(double)> const m_convertToCanonical = {};
    std::function<double(double)> const m_convertFromCanonical = {};
    double const m_boundaryValue;
    bool const m_isCanonical;
-   //
-   // TBD: We could store a pointer to the canonical Unit here, since we have it in the constructors below
-   //
 };
 
 Measurement::Unit::Unit(UnitSystem const & unitSystem,
@@ -219,12 +314,21 @@ Measurement::Unit::Unit(UnitSystem const & unitSystem,
                         double const multiplierToCanonical,
                         Measurement::Unit const * canonical,
                         double const boundaryValue) :
+   Unit{unitSystem, unitName, LinearConversion{.multiplier = multiplierToCanonical}, canonical, boundaryValue} {
+   return;
+}
+
+Measurement::Unit::Unit(UnitSystem const & unitSystem,
+                        QString const unitName,
+                        LinearConversion const linearConversion,
+                        Measurement::Unit const * canonical,
+                        double const boundaryValue) :
    name{unitName},
    pimpl{std::make_unique<impl>(*this,
                                 unitSystem,
-                                multiplierToCanonical,
-                                boundaryValue,
-                                (canonical == nullptr))} {
+                                linearConversion,
+                                canonical,
+                                boundaryValue)} {
    //
    // You might think here would be a neat place to add the Unit we are constructing to unitNameLookup and, if
    // appropriate, physicalQuantityToCanonicalUnit.  However, there is not guarantee that unitSystem is constructed at
@@ -247,6 +351,7 @@ Measurement::Unit::Unit(UnitSystem const & unitSystem,
                                 unitSystem,
                                 convertToCanonical,
                                 convertFromCanonical,
+                                canonical,
                                 boundaryValue)} {
    // It's a coding error if we used this version of the constructor for a canonical unit
    Q_ASSERT(canonical);
@@ -275,32 +380,25 @@ std::pair<double, QString> Measurement::Unit::splitAmountString(QString const &
       *ok = false;
    }
 
-   // All functions in QRegExp are reentrant, so it should be safe to use as a shared const in multi-threaded code.
-   static QRegExp const amtUnit {
-      //
-      // For the numeric part (the quantity) we need to make sure we get the right decimal point (. or ,) and the right
-      // grouping separator (, or .).  Some locales write 1.000,10 and others write 1,000.10.  We need to catch both.
-      //
-      // For the units, we have to be a bit careful.  We used to use "\\w" to match "word characters" for the unit name.
-      // This was fine when we had "simple" unit names such as "kg" and "floz", but it breaks for names containing
-      // symbols, such as "L/kg" or "c/g·C".  Instead, we have to match non-space characters
-      //
-      "((?:\\d+" + QRegExp::escape(Localization::getLocale().groupSeparator()) + ")?\\d+(?:" +
-      QRegExp::escape(Localization::getLocale().decimalPoint()) + "\\d+)?|" +
-      QRegExp::escape(Localization::getLocale().decimalPoint()) + "\\d+)\\s*([^\\s]+)?",
-      Qt::CaseInsensitive
-   };
-
-   // Make sure we can parse the string
-   if (amtUnit.indexIn(inputString) == -1) {
+   //
+   // For the numeric part (the quantity) we need to make sure we get the right decimal point (. or ,) and the right
+   // grouping separator (, or .).  Some locales write 1.000,10 and others write 1,000.10.  Localization::splitAmount
+   // takes care of this.
+   //
+   // For the units, we have to be a bit careful.  We used to match "word characters" for the unit name.  This was fine
+   // when we had "simple" unit names such as "kg" and "floz", but it breaks for names containing symbols, such as
+   // "L/kg" or "c/g·C".  Instead, splitAmount gives us all the non-space characters after the number.
+   //
+   Localization::AmountParts const parts = Localization::splitAmount(inputString);
+   if (parts.quantity.isEmpty()) {
       qDebug() << Q_FUNC_INFO << "Unable to parse" << inputString << "so treating as 0.0";
       return std::pair<double, QString>{0.0, ""};
    }
 
-   QString const unitName = amtUnit.cap(2);
+   QString const unitName = parts.units.toString();
 
    double quantity = 0.0;
-   QString numericPartOfInput{amtUnit.cap(1)};
+   QStringView const numericPartOfInput{parts.quantity};
    try {
       quantity = Localization::toDouble(numericPartOfInput, Q_FUNC_INFO);
       // If we didn't throw an exception then all must finally be OK!
@@ -308,7 +406,7 @@ std::pair<double, QString> Measurement::Unit::splitAmountString(QString const &
          *ok = true;
       }
    } catch (std::invalid_argument const & ex) {
-      // If we get this error it's most probably either a bug in our regular expression or a problem with
+      // If we get this error it's most probably either a bug in Localization::splitAmount or a problem with
       // Localization::getLocale().
       qWarning() << Q_FUNC_INFO << "Could not parse" << numericPartOfInput << "as number:" << ex.what();
    } catch(std::out_of_range const & ex) {
@@ -328,7 +426,7 @@ bool Measurement::Unit::operator==(Unit const & other) const {
 }
 
 Measurement::Unit const & Measurement::Unit::getCanonical() const {
-   return Measurement::Unit::getCanonicalUnit(this->getPhysicalQuantity());
+   return this->pimpl->m_canonical;
 }
 
 bool Measurement::Unit::isCanonical() const {
@@ -338,19 +436,48 @@ bool Measurement::Unit::isCanonical() const {
 
 Measurement::Amount Measurement::Unit::toCanonical(double amt) const {
    double const convertedQuantity{
-      this->pimpl->m_multiplierToCanonical ? amt * (*this->pimpl->m_multiplierToCanonical) :
-                                             this->pimpl->m_convertToCanonical(amt)
+      this->pimpl->m_linearConversion ? this->pimpl->m_linearConversion->toCanonical(amt) :
+                                        this->pimpl->m_convertToCanonical(amt)
    };
    return Measurement::Amount{convertedQuantity, this->getCanonical()};
 }
 
 double Measurement::Unit::fromCanonical(double amt) const {
-   if (this->pimpl->m_multiplierToCanonical) {
-      return amt / (*this->pimpl->m_multiplierToCanonical);
+   if (this->pimpl->m_linearConversion) {
+      return this->pimpl->m_linearConversion->fromCanonical(amt);
    }
    return this->pimpl->m_convertFromCanonical(amt);
 }
 
+void Measurement::Unit::toCanonical(std::span<double> amounts) const {
+   if (this->pimpl->m_linearConversion) {
+      // Take a copy so the compiler knows it can't change during the loop
+      LinearConversion const linearConversion = *this->pimpl->m_linearConversion;
+      for (double & amount : amounts) {
+         amount = linearConversion.toCanonical(amount);
+      }
+      return;
+   }
+   for (double & amount : amounts) {
+      amount = this->pimpl->m_convertToCanonical(amount);
+   }
+   return;
+}
+
+void Measurement::Unit::fromCanonical(std::span<double> amounts) const {
+   if (this->pimpl->m_linearConversion) {
+      LinearConversion const linearConversion = *this->pimpl->m_linearConversion;
+      for (double & amount : amounts) {
+         amount = linearConversion.fromCanonical(amount);
+      }
+      return;
+   }
+   for (double & amount : amounts) {
+      amount = this->pimpl->m_convertFromCanonical(amount);
+   }
+   return;
+}
+
 Measurement::PhysicalQuantity Measurement::Unit::getPhysicalQuantity() const {
    // The PhysicalQuantity for this Unit is already stored in its UnitSystem, so we don't store it separately here
    return this->pimpl->m_unitSystem.getPhysicalQuantity();
@@ -410,55 +537,28 @@ QString Measurement::Unit::convertWithoutContext(QString const & qstr, QString c
 Measurement::Unit const * Measurement::Unit::getUnit(QString const & name,
                                                      Measurement::PhysicalQuantity const & physicalQuantity,
                                                      bool const caseInensitiveMatching) {
-   auto matches = getUnitsByNameAndPhysicalQuantity(name, physicalQuantity, caseInensitiveMatching);
-
-   auto const numMatches = matches.length();
-   if (0 == numMatches) {
-      return nullptr;
+   //
+   // This gets called a lot (eg for every amount in an import, and every time the user enters an amount with units),
+   // but there are not many different names, so it's worth remembering the answers.
+   //
+   std::lock_guard<std::mutex> lock{resolvedUnitsMutex};
+   unsigned int const currentGeneration = Measurement::displaySettingsGeneration();
+   if (resolvedUnitsGeneration != currentGeneration) {
+      resolvedUnits.clear();
+      resolvedUnitsGeneration = currentGeneration;
    }
 
-   // Under most circumstances, there is a one-to-one relationship between unit string and Unit. C will only map to
-   // Measurement::Unit::Celsius, for example. If there's only one match, just return it.
-   if (1 == numMatches) {
-      auto unitToReturn = matches.at(0);
-      if (unitToReturn->getPhysicalQuantity() != physicalQuantity) {
-         qWarning() <<
-            Q_FUNC_INFO << "Unit" << name << "matches a unit of type" << unitToReturn->getPhysicalQuantity() <<
-            "but caller specified" << physicalQuantity;
-         return nullptr;
-      }
-      return unitToReturn;
+   ResolvedUnitKey key{physicalQuantity, name, caseInensitiveMatching};
+   auto cached = resolvedUnits.constFind(key);
+   if (cached != resolvedUnits.cend()) {
+      return *cached;
    }
 
-   // That solved something like 99% of the use cases. Now we have to handle those pesky volumes.
-   // Loop through the found Units, like Measurement::Unit::us_quart and
-   // Measurement::Unit::imperial_quart, and try to find one that matches the global default.
-   Measurement::Unit const * defUnit = nullptr;
-   for (auto const unit : matches) {
-      auto const & displayUnitSystem = Measurement::getDisplayUnitSystem(unit->getPhysicalQuantity());
-      qDebug() <<
-         Q_FUNC_INFO << "Look at" << *unit << "from" << unit->getUnitSystem() << "(Display Unit System for" <<
-         unit->getPhysicalQuantity() << "is" << displayUnitSystem << ")";
-      if (unit->getPhysicalQuantity() != physicalQuantity) {
-         // If the caller knows the amount is, say, a Volume, don't bother trying to match against units for any other
-         // physical quantity.
-         qDebug() << Q_FUNC_INFO << "Ignoring match in" << unit->getPhysicalQuantity() << "as not" << physicalQuantity;
-         continue;
-      }
-
-      if (displayUnitSystem == unit->getUnitSystem()) {
-         // We found a match that belongs to one of the global default unit systems
-         return unit;
-      }
-
-      // Save this for later if we need it - ie if we don't find a better match
-      defUnit = unit;
+   Measurement::Unit const * unit = resolveUnit(name, physicalQuantity, caseInensitiveMatching);
+   if (unit) {
+      resolvedUnits.insert(std::move(key), unit);
    }
-
-   // If we got here, we couldn't find a match. Unless something weird has
-   // happened, that means you entered "qt" into a field and the system
-   // default is SI. At that point, just use the USCustomary
-   return defUnit;
+   return unit;
 }
 
 Measurement::Unit const * Measurement::Unit::getUnit(QString const & name,
@@ -553,8 +653,8 @@ namespace Measurement::Units {
 
    // === Temperature ===
    Unit const celsius   {Measurement::UnitSystems::temperature_MetricIsCelsius        , QObject::tr("C")};
-   Unit const fahrenheit{Measurement::UnitSystems::temperature_UsCustomaryIsFahrenheit, QObject::tr("F"), [](double x){return (x - 32.0) * 5.0/9.0;},
-                                                                                                          [](double y){return (y * 9.0/5.0) + 32.0;}, &celsius};
+   Unit const fahrenheit{Measurement::UnitSystems::temperature_UsCustomaryIsFahrenheit, QObject::tr("F"),
+                         Unit::LinearConversion{.multiplier = 5.0/9.0, .offset = -32.0}, &celsius};
 
    // === Time ===
    // Added weeks because BeerJSON has it
@@ -593,8 +693,8 @@ namespace Measurement::Units {
 
    // == Diastatic power ==
    Unit const lintner{Measurement::UnitSystems::diastaticPower_Lintner        , QObject::tr("L" )};
-   Unit const wk     {Measurement::UnitSystems::diastaticPower_WindischKolbach, QObject::tr("WK"), [](double x){return (x + 16.0) / 3.5;},
-                                                                                                   [](double y){return (3.5 * y) - 16.0;}, &lintner};
+   Unit const wk     {Measurement::UnitSystems::diastaticPower_WindischKolbach, QObject::tr("WK"),
+                     Unit::LinearConversion{.multiplier = 1.0/3.5, .offset = 16.0}, &lintner};
 
    // == Acidity ==
    Unit const pH{Measurement::UnitSystems::acidity_pH, QObject::tr("pH")};
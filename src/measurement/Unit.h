@@ -25,6 +25,7 @@
 #include <functional>
 #include <memory> // For PImpl
 #include <optional>
+#include <span>
 #include <utility> // For std::pair
 
 #include <QMultiMap>
@@ -48,6 +49,20 @@ namespace Measurement {
    class Unit {
 
    public:
+      /**
+       * \brief Conversion to canonical units that is just adding an offset and then multiplying.  This covers almost
+       *        all units (and, for most of them, the offset is 0).  Eg for °F, the offset is -32 and the multiplier is
+       *        5/9.  Because these are just numbers (rather than, say, a \c std::function), we can do the conversions
+       *        inline, and the compiler can vectorise the bulk versions of \c toCanonical and \c fromCanonical.
+       */
+      struct LinearConversion {
+         double multiplier;
+         double offset = 0.0;
+
+         constexpr double toCanonical  (double const x) const { return (x + this->offset) * this->multiplier; }
+         constexpr double fromCanonical(double const y) const { return y / this->multiplier - this->offset;   }
+      };
+
       /**
        * \brief Construct a type of unit.  Note that it is \b not intended that users of this class construct their own
        *        \c Unit objects.  Rather they should use pointers or references to the constants defined in the \c Units
@@ -82,8 +97,21 @@ namespace Measurement {
            double const boundaryValue = 1.0);
 
       /**
-       * \brief Construct a type of unit when converting to/from canonical units requires more than a simple
-       *        multiplication/division (eg as when converting °F to/from °C).  Parameters are as for the other
+       * \brief Construct a type of unit when converting to canonical units requires adding an offset as well as
+       *        multiplying (eg as when converting °F to °C).  Parameters are as for the first constructor, except as
+       *        follows.
+       *
+       * \param linearConversion How to convert a quantity of this \c Unit to/from a quantity of \c canonical \c Unit
+       */
+      Unit(UnitSystem const & unitSystem,
+           QString const unitName,
+           LinearConversion const linearConversion,
+           Unit const * canonical,
+           double const boundaryValue = 1.0);
+
+      /**
+       * \brief Construct a type of unit when converting to/from canonical units requires more than a
+       *        \c LinearConversion (eg as when converting °P to/from SG).  Parameters are as for the first
        *        constructor, except as follows.
        *
        * \param convertToCanonical Converts a quantity of this \c Unit to a quantity of \c canonical \c Unit
@@ -153,6 +181,13 @@ namespace Measurement {
        */
       double fromCanonical(double amt) const;
 
+      /**
+       * \brief Bulk versions of \c toCanonical and \c fromCanonical, for when we have a whole column of numbers to
+       *        convert.  Conversion is done in place.
+       */
+      void toCanonical  (std::span<double> amounts) const;
+      void fromCanonical(std::span<double> amounts) const;
+
       /**
        * \brief Returns the \c Measurement::PhysicalQuantity that this \c Measurement::Unit measures.  This is a
        *        convenience function to save you having to first get the \c Measurement::UnitSystem.
@@ -24,6 +24,7 @@
 #include <QRegExp>
 
 #include "Localization.h"
+#include "measurement/AmountFormatter.h"
 #include "measurement/Unit.h"
 #include "utils/EnumStringMapping.h"
 
@@ -41,8 +42,6 @@ namespace {
       return scaleToUnit;
    }
 
-   int const fieldWidth = 0;
-   char const format = 'f';
    int const defaultPrecision = 3;
 
    QMultiMap<Measurement::PhysicalQuantity, Measurement::UnitSystem const *> physicalQuantityToUnitSystems;
@@ -239,16 +238,7 @@ QString Measurement::UnitSystem::displayAmount(Measurement::Amount const & amoun
       precision = defaultPrecision;
    }
 
-   auto result = this->pimpl->displayableAmount(amount, forcedScale);
-
-   if (result.second.isEmpty()) {
-      return QString("%L1").arg(this->amountDisplay(Measurement::Amount{result.first, *amount.unit}, forcedScale),
-                                fieldWidth,
-                                format,
-                                precision);
-   }
-
-   return QString("%L1 %2").arg(result.first, fieldWidth, format, precision).arg(result.second);
+   return Measurement::AmountFormatter::get(*this, precision, forcedScale).format(amount);
 }
 
 double Measurement::UnitSystem::amountDisplay(Measurement::Amount const & amount,
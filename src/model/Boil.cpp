@@ -159,8 +159,8 @@ void Boil::acceptStepChange([[maybe_unused]] QMetaProperty prop,
 
    // If one of our steps changed, our pseudo properties may also change, so we need to emit some signals
    if (stepSender->ownerId() == this->key()) {
-      emit changed(metaProperty(*PropertyNames::Boil::boilTime_mins), QVariant());
-      emit changed(metaProperty(*PropertyNames::Boil::boilSteps    ), QVariant());
+      this->emitChanged(PropertyNames::Boil::boilTime_mins, QVariant());
+      this->emitChanged(PropertyNames::Boil::boilSteps, QVariant());
    }
 
    return;
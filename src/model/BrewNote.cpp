@@ -22,11 +22,15 @@
 #include "model/BrewNote.h"
 
 #include <algorithm>
+#include <utility>
+
 #include <QDebug>
 #include <QObject>
 #include <QString>
 
 #include "Algorithms.h"
+#include "database/Database.h"
+#include "database/DbTransaction.h"
 #include "database/ObjectStoreWrapper.h"
 #include "Localization.h"
 #include "model/Boil.h"
@@ -116,6 +120,7 @@ BrewNote::BrewNote(Recipe const & recipe) :
 BrewNote::BrewNote(QDate dateNow, QString const & name) :
    OwnedByRecipe      {name},
    loading            {false  },
+   m_stagedChanges    {       },
    m_brewDate         {dateNow},
    m_fermentDate      {       },
    m_notes            {""     },
@@ -154,6 +159,7 @@ BrewNote::BrewNote(QDate dateNow, QString const & name) :
 BrewNote::BrewNote(NamedParameterBundle const & namedParameterBundle) :
    OwnedByRecipe{namedParameterBundle},
    loading            {false},
+   m_stagedChanges    {     },
    SET_REGULAR_FROM_NPB (m_brewDate         , namedParameterBundle, PropertyNames::BrewNote::brewDate         ),
    SET_REGULAR_FROM_NPB (m_fermentDate      , namedParameterBundle, PropertyNames::BrewNote::fermentDate      ),
    SET_REGULAR_FROM_NPB (m_notes            , namedParameterBundle, PropertyNames::BrewNote::notes            ),
@@ -191,9 +197,10 @@ BrewNote::BrewNote(NamedParameterBundle const & namedParameterBundle) :
 
 BrewNote::BrewNote(BrewNote const & other) :
    OwnedByRecipe      {other                    },
+   m_stagedChanges    {                         },
    m_brewDate         {other.m_brewDate         },
    m_fermentDate      {other.m_fermentDate      },
-   m_notes            {other.m_notes            },
+   m_notes            {other.notes()            },
    m_sg               {other.m_sg               },
    m_abv              {other.m_abv              },
    m_effIntoBK_pct    {other.m_effIntoBK_pct    },
@@ -228,95 +235,155 @@ BrewNote::BrewNote(BrewNote const & other) :
 
 BrewNote::~BrewNote() = default;
 
-void BrewNote::populateNote(Recipe * parent) {
-   this->m_recipeId = parent->key();
+namespace {
+   /**
+    * \brief The values of a \c Recipe that \c BrewNote::populateNote needs, each read just once
+    */
+   struct RecipeSnapshot {
+      double                boilSize_l;
+      double                postBoilVolume_l;
+      double                finalVolume_l;
+      //! Only set if the recipe has equipment
+      std::optional<double> boilOff_l;
+      double                totalSugar_kg;
+      double                boilGrav;
+      //! Strike and mash final temperatures are only set if the recipe has a mash with at least one step
+      std::optional<double> strikeTemp_c;
+      std::optional<double> mashFinTemp_c;
+      double                og;
+      std::optional<double> pitchTemp_c;
+      double                fg;
+      double                efficiency_pct;
+      double                abv_pct;
+      double                atten_pct;
+   };
+
+   RecipeSnapshot snapshotOf(Recipe & recipe) {
+      RecipeSnapshot snapshot;
+
+      auto const boil = recipe.boil();
+      snapshot.boilSize_l       = boil ? boil->preBoilSize_l().value_or(0.0) : 0.0;
+      snapshot.postBoilVolume_l = recipe.postBoilVolume_l();
+      snapshot.finalVolume_l    = recipe.finalVolume_l();
+
+      auto const equip = recipe.equipment();
+      if (equip) {
+         double const boilTime_mins = boil ? boil->boilTime_mins() : Equipment::default_boilTime_mins;
+         snapshot.boilOff_l = equip->kettleEvaporationPerHour_l().value_or(
+            Equipment::default_kettleEvaporationPerHour_l
+         ) * (boilTime_mins/60.0);
+      }
 
-   // Since we have the recipe, lets set some defaults The order in which
-   // these are done is very specific. Please do not modify them without some
-   // serious testing.
-
-   // Everything needs volumes of one type or another. But the individual
-   // volumes are fairly independent of anything. Do them all first.
-   double const boilSize_l = parent->boil() ? parent->boil()->preBoilSize_l().value_or(0.0) : 0.0;
-   this->setProjVolIntoBK_l  (boilSize_l);
-   this->setVolumeIntoBK_l   (boilSize_l);
-   this->setPostBoilVolume_l (parent->postBoilVolume_l());
-   this->setProjVolIntoFerm_l(parent->finalVolume_l());
-   this->setVolumeIntoFerm_l (parent->finalVolume_l());
-   this->setFinalVolume_l    (parent->finalVolume_l());
-
-   auto equip = parent->equipment();
-   if (equip) {
-      double const boilTime_mins = parent->boil() ? parent->boil()->boilTime_mins() : Equipment::default_boilTime_mins;
-      this->setBoilOff_l(
-         equip->kettleEvaporationPerHour_l().value_or(Equipment::default_kettleEvaporationPerHour_l) * (boilTime_mins/60.0)
-      );
-   }
+      auto const sugars = recipe.calcTotalPoints();
+      snapshot.totalSugar_kg = sugars.sugar_kg + sugars.sugar_kg_ignoreEfficiency;
+      snapshot.boilGrav      = recipe.boilGrav();
+
+      auto const mash = recipe.mash();
+      if (mash) {
+         auto const steps = mash->mashSteps();
+         if (!steps.isEmpty()) {
+            auto const firstStep = steps.at(0);
+            if (firstStep) {
+               snapshot.strikeTemp_c  = firstStep->infuseTemp_c().value_or(firstStep->startTemp_c().value_or(0.0));
+               snapshot.mashFinTemp_c = firstStep->endTemp_c   ().value_or(firstStep->startTemp_c().value_or(0.0));
+            }
+            // If there are more than two steps, the penultimate one is taken to be the end of the mash proper (the
+            // last one typically being a mash-out)
+            if (steps.size() > 2) {
+               auto const penultimateStep = steps.at(steps.size() - 2);
+               snapshot.mashFinTemp_c =
+                  penultimateStep->endTemp_c().value_or(penultimateStep->startTemp_c().value_or(0.0));
+            }
+         }
+      }
 
-   auto sugars = parent->calcTotalPoints();
-   this->setProjPoints(sugars.sugar_kg + sugars.sugar_kg_ignoreEfficiency);
+      snapshot.og = recipe.og();
 
-   this->setProjFermPoints(sugars.sugar_kg + sugars.sugar_kg_ignoreEfficiency);
+      auto const fermentation = recipe.fermentation();
+      if (fermentation && fermentation->primary() && fermentation->primary()->startTemp_c()) {
+         snapshot.pitchTemp_c = *fermentation->primary()->startTemp_c(); // Replaces parent->primaryTemp_c()
+      }
 
-   // Out of the gate, we expect projected to be the measured.
-   this->setSg( parent->boilGrav() );
-   this->setProjBoilGrav(parent->boilGrav() );
-
-   if (parent->mash()) {
-      auto steps = parent->mash()->mashSteps();
-      if (!steps.isEmpty()) {
-         auto mStep = steps.at(0);
-
-         if (mStep) {
-            double const strikeTemp = mStep->infuseTemp_c().value_or(mStep->startTemp_c().value_or(0.0));
-            this->setStrikeTemp_c(strikeTemp);
-            this->setProjStrikeTemp_c(strikeTemp);
-
-            double const endTemp = mStep->endTemp_c().value_or(mStep->startTemp_c().value_or(0.0));
-            this->setMashFinTemp_c(endTemp);
-            this->setProjMashFinTemp_c(endTemp);
-         }
+      snapshot.fg             = recipe.fg();
+      snapshot.efficiency_pct = recipe.efficiency_pct();
+      snapshot.abv_pct        = recipe.ABV_pct();
 
-         if (steps.size() > 2) {
-            // NOTE: Qt will complain that steps.size()-2 is always positive,
-            // and therefore the internal assert that the index is positive is
-            // bunk. This is OK, as we just checked that we will not underflow.
-            mStep = steps.at( steps.size() - 2 );
-            double const endTemp = mStep->endTemp_c().value_or(mStep->startTemp_c().value_or(0.0));
-            this->setMashFinTemp_c(endTemp);
-            this->setProjMashFinTemp_c(endTemp);
+      double atten_pct = -1.0;
+      for (auto const & yeastAddition : recipe.yeastAdditions()) {
+         if (yeastAddition->attenuation_pct() > atten_pct ) {
+            atten_pct = yeastAddition->yeast()->attenuationTypical_pct();
          }
       }
+      if (atten_pct < 0.0) {
+         atten_pct = Yeast::DefaultAttenuation_pct; // Use an average attenuation;
+      }
+      snapshot.atten_pct = atten_pct;
+
+      return snapshot;
    }
+}
 
-   this->setOg( parent->og());
-   this->setProjOg(parent->og());
+void BrewNote::populateNote(Recipe * parent) {
+   this->m_recipeId = parent->key();
 
-   auto fermentation = parent->fermentation();
-   if (fermentation &&
-       fermentation->primary() &&
-       fermentation->primary()->startTemp_c()) {
-      this->setPitchTemp_c(*fermentation->primary()->startTemp_c()); // Replaces parent->primaryTemp_c()
+   //
+   // Reading the recipe's values can make it recalculate, so we read each one just once, up front.  Then we work out
+   // all our values, and only then write them out (see commitStagedChanges()).  Because nothing is written until the
+   // end, the order in which we set things here only matters where one of our values is calculated from others.
+   //
+   RecipeSnapshot const recipe = snapshotOf(*parent);
+
+   // Everything needs volumes of one type or another, and the individual volumes are fairly independent of anything
+   this->stage(PropertyNames::BrewNote::projVolIntoBK_l  , this->m_projVolIntoBK_l  , recipe.boilSize_l      );
+   this->stage(PropertyNames::BrewNote::volumeIntoBK_l   , this->m_volumeIntoBK_l   , recipe.boilSize_l      );
+   this->stage(PropertyNames::BrewNote::postBoilVolume_l , this->m_postBoilVolume_l , recipe.postBoilVolume_l);
+   this->stage(PropertyNames::BrewNote::projVolIntoFerm_l, this->m_projVolIntoFerm_l, recipe.finalVolume_l   );
+   this->stage(PropertyNames::BrewNote::volumeIntoFerm_l , this->m_volumeIntoFerm_l , recipe.finalVolume_l   );
+   this->stage(PropertyNames::BrewNote::finalVolume_l    , this->m_finalVolume_l    , recipe.finalVolume_l   );
+   if (recipe.boilOff_l) {
+      this->stage(PropertyNames::BrewNote::boilOff_l, this->m_boilOff_l, *recipe.boilOff_l);
    }
 
-   this->setFg( parent->fg());
-   this->setProjFg( parent->fg() );
-
-   this->setProjEff_pct(parent->efficiency_pct());
-   this->setProjABV_pct( parent->ABV_pct());
+   // Points depend on the volumes we just set
+   this->stage(PropertyNames::BrewNote::projPoints,
+               this->m_projPoints,
+               BrewNote::glucosePoints(recipe.totalSugar_kg, this->m_projVolIntoBK_l));
+   this->stage(PropertyNames::BrewNote::projFermPoints,
+               this->m_projFermPoints,
+               BrewNote::glucosePoints(recipe.totalSugar_kg, this->m_projVolIntoFerm_l));
 
-   double atten_pct = -1.0;
-   auto const yeastAdditions = parent->yeastAdditions();
-   for (auto const & yeastAddition : yeastAdditions) {
-      if (yeastAddition->attenuation_pct() > atten_pct ) {
-         atten_pct = yeastAddition->yeast()->attenuationTypical_pct();
-      }
+   // Out of the gate, we expect projected to be the measured.
+   this->stage(PropertyNames::BrewNote::sg          , this->m_sg          , recipe.boilGrav);
+   this->stage(PropertyNames::BrewNote::projBoilGrav, this->m_projBoilGrav, recipe.boilGrav);
+   if (recipe.strikeTemp_c) {
+      this->stage(PropertyNames::BrewNote::strikeTemp_c    , this->m_strikeTemp_c    , *recipe.strikeTemp_c);
+      this->stage(PropertyNames::BrewNote::projStrikeTemp_c, this->m_projStrikeTemp_c, *recipe.strikeTemp_c);
    }
-
-   if (atten_pct < 0.0) {
-      atten_pct = Yeast::DefaultAttenuation_pct; // Use an average attenuation;
+   if (recipe.mashFinTemp_c) {
+      this->stage(PropertyNames::BrewNote::mashFinTemp_c    , this->m_mashFinTemp_c    , *recipe.mashFinTemp_c);
+      this->stage(PropertyNames::BrewNote::projMashFinTemp_c, this->m_projMashFinTemp_c, *recipe.mashFinTemp_c);
    }
-   this->setProjAtten(atten_pct);
+   this->stage(PropertyNames::BrewNote::og    , this->m_og    , recipe.og);
+   this->stage(PropertyNames::BrewNote::projOg, this->m_projOg, recipe.og);
+   if (recipe.pitchTemp_c) {
+      this->stage(PropertyNames::BrewNote::pitchTemp_c, this->m_pitchTemp_c, *recipe.pitchTemp_c);
+   }
+   this->stage(PropertyNames::BrewNote::fg         , this->m_fg         , recipe.fg            );
+   this->stage(PropertyNames::BrewNote::projFg     , this->m_projFg     , recipe.fg            );
+   this->stage(PropertyNames::BrewNote::projEff_pct, this->m_projEff_pct, recipe.efficiency_pct);
+   this->stage(PropertyNames::BrewNote::projABV_pct, this->m_projABV_pct, recipe.abv_pct       );
+   this->stage(PropertyNames::BrewNote::projAtten  , this->m_projAtten  , recipe.atten_pct     );
+
+   // Finally, the values we calculate from the ones above
+   std::optional<double> const effIntoBK_pct = this->effIntoBKFromValues();
+   if (effIntoBK_pct) {
+      this->stage(PropertyNames::BrewNote::effIntoBK_pct, this->m_effIntoBK_pct, *effIntoBK_pct);
+   }
+   this->stage(PropertyNames::BrewNote::brewhouseEff_pct, this->m_brewhouseEff_pct, this->brewhouseEffFromValues());
+   this->stage(PropertyNames::BrewNote::abv             , this->m_abv             , this->actualAbvFromValues   ());
+   this->stage(PropertyNames::BrewNote::attenuation     , this->m_attenuation     , this->attenuationFromValues ());
+
+   this->commitStagedChanges();
    return;
 }
 
@@ -326,13 +393,88 @@ void BrewNote::recalculateEff(Recipe* parent) {
    this->m_recipeId = parent->key();
 
    auto const sugars = parent->calcTotalPoints();
-   this->setProjPoints(sugars.sugar_kg + sugars.sugar_kg_ignoreEfficiency);
+   this->recalculateEff(sugars.sugar_kg + sugars.sugar_kg_ignoreEfficiency);
+   return;
+}
 
-//   sugars = parent->calcTotalPoints();
-   this->setProjFermPoints(sugars.sugar_kg + sugars.sugar_kg_ignoreEfficiency);
+void BrewNote::recalculateEff(double const totalSugar_kg) {
+   this->stage(PropertyNames::BrewNote::projPoints,
+               this->m_projPoints,
+               BrewNote::glucosePoints(totalSugar_kg, this->m_projVolIntoBK_l));
+   this->stage(PropertyNames::BrewNote::projFermPoints,
+               this->m_projFermPoints,
+               BrewNote::glucosePoints(totalSugar_kg, this->m_projVolIntoFerm_l));
+
+   std::optional<double> const effIntoBK_pct = this->effIntoBKFromValues();
+   if (effIntoBK_pct) {
+      this->stage(PropertyNames::BrewNote::effIntoBK_pct, this->m_effIntoBK_pct, *effIntoBK_pct);
+   }
+   this->stage(PropertyNames::BrewNote::brewhouseEff_pct, this->m_brewhouseEff_pct, this->brewhouseEffFromValues());
 
-   this->calculateEffIntoBK_pct();
-   this->calculateBrewHouseEff_pct();
+   this->commitStagedChanges();
+   return;
+}
+
+void BrewNote::recalculateEffForRecipe(Recipe & recipe) {
+   QList<BrewNote *> const brewNotes = recipe.brewNotes();
+   if (brewNotes.isEmpty()) {
+      return;
+   }
+
+   auto const sugars = recipe.calcTotalPoints();
+   double const totalSugar_kg = sugars.sugar_kg + sugars.sugar_kg_ignoreEfficiency;
+
+   Database & database = Database::instance();
+   QSqlDatabase connection = database.sqlDatabase();
+   DbTransaction dbTransaction{
+      database,
+      connection,
+      QString("Recalculate efficiency for %1 brew notes of recipe #%2").arg(brewNotes.size()).arg(recipe.key())
+   };
+   NamedEntityChangeBatch changeBatch;
+   for (BrewNote * brewNote : brewNotes) {
+      brewNote->recalculateEff(totalSugar_kg);
+   }
+   dbTransaction.commit();
+   return;
+}
+
+double BrewNote::glucosePoints(double const sugar_kg, double const volume_l) {
+   double const plato = Algorithms::getPlato(sugar_kg, volume_l);
+   double const total_g = Algorithms::PlatoToSG_20C20C( plato );
+   return (total_g - 1.0 ) * 1000;
+}
+
+void BrewNote::stage(BtStringConst const & propertyName, double & memberVariable, double const newValue) {
+   if (this->newValueMatchesExisting(propertyName, memberVariable, newValue)) {
+      return;
+   }
+   this->prepareForPropertyChange(propertyName);
+   memberVariable = newValue;
+   if (!this->m_stagedChanges.contains(&propertyName)) {
+      this->m_stagedChanges.append(&propertyName);
+   }
+   return;
+}
+
+void BrewNote::commitStagedChanges() {
+   QVector<BtStringConst const *> const changedProperties = std::exchange(this->m_stagedChanges, {});
+   if (changedProperties.isEmpty()) {
+      return;
+   }
+
+   // As in NamedEntity::propagatePropertyChange
+   this->m_cachedFingerprint.reset();
+   if (!this->m_propagationAndSignalsEnabled) {
+      return;
+   }
+   if (this->key() > 0) {
+      ObjectStoreWrapper::updateProperties(*this, changedProperties);
+   }
+   NamedEntityChangeBatch changeBatch;
+   for (BtStringConst const * propertyName : changedProperties) {
+      this->notifyPropertyChange(*propertyName);
+   }
    return;
 }
 
@@ -343,7 +485,7 @@ QString BrewNote::brewDate_short   () const { return Localization::displayDateUs
 QDate   BrewNote::fermentDate      () const { return this->m_fermentDate; }
 QString BrewNote::fermentDate_str  () const { return this->m_fermentDate.toString(); }
 QString BrewNote::fermentDate_short() const { return Localization::displayDateUserFormated(this->m_fermentDate); }
-QString BrewNote::notes            () const { return this->m_notes            ; }
+QString BrewNote::notes            () const { return this->lazyText(PropertyNames::BrewNote::notes, this->m_notes); }
 double  BrewNote::sg               () const { return this->m_sg               ; }
 double  BrewNote::abv              () const { return this->m_abv              ; }
 double  BrewNote::attenuation      () const { return this->m_attenuation      ; }
@@ -458,10 +600,7 @@ void BrewNote::setProjPoints(double var) {
    if ( loading ) {
       this->m_projPoints = var;
    } else {
-      double const plato = Algorithms::getPlato(var, m_projVolIntoBK_l);
-      double const total_g = Algorithms::PlatoToSG_20C20C( plato );
-      double const convertPnts = (total_g - 1.0 ) * 1000;
-
+      double const convertPnts = BrewNote::glucosePoints(var, m_projVolIntoBK_l);
       SET_AND_NOTIFY(PropertyNames::BrewNote::projPoints, this->m_projPoints, convertPnts);
    }
    return;
@@ -471,10 +610,7 @@ void BrewNote::setProjFermPoints(double var) {
    if ( loading ) {
       this->m_projFermPoints = var;
    } else {
-      double const plato = Algorithms::getPlato(var, m_projVolIntoFerm_l);
-      double const total_g = Algorithms::PlatoToSG_20C20C( plato );
-      double const convertPnts = (total_g - 1.0 ) * 1000;
-
+      double const convertPnts = BrewNote::glucosePoints(var, m_projVolIntoFerm_l);
       SET_AND_NOTIFY(PropertyNames::BrewNote::projFermPoints, this->m_projFermPoints, convertPnts);
    }
    return;
@@ -504,26 +640,13 @@ void BrewNote::setBoilOff_l        (double var) { SET_AND_NOTIFY(PropertyNames::
 // calculators -- these kind of act as both setters and getters.  Likely bad
 // form
 double BrewNote::calculateEffIntoBK_pct() {
-   // I don't think we need a lot of math here. Points has already been
-   // translated from SG into pure glucose points
-   double const maxPoints = m_projPoints * m_projVolIntoBK_l;
-   qDebug() <<
-      Q_FUNC_INFO << "m_projPoints: " << m_projPoints << ", m_projVolIntoBK_l:" << m_projVolIntoBK_l <<
-      ", maxPoints:" << maxPoints;
-
-   double const actualPoints = (m_sg - 1) * 1000 * m_volumeIntoBK_l;
-   qDebug() <<
-      Q_FUNC_INFO << "m_sg:" << m_sg << ", m_volumeIntoBK_l:" << m_volumeIntoBK_l << ", actualPoints:" << actualPoints;
+   std::optional<double> const effIntoBK = this->effIntoBKFromValues();
    // this can happen under normal circumstances (eg, load)
-   if (maxPoints <= 0.0) {
+   if (!effIntoBK) {
       return 0.0;
    }
-
-   double const effIntoBK = actualPoints/maxPoints * 100;
-   qDebug() << Q_FUNC_INFO << "effIntoBK:" << effIntoBK;
-   setEffIntoBK_pct(effIntoBK);
-
-   return effIntoBK;
+   setEffIntoBK_pct(*effIntoBK);
+   return *effIntoBK;
 }
 
 // The idea is that based on the preboil gravity, estimate what the actual OG will be.
@@ -540,10 +663,7 @@ double BrewNote::calculateOg() {
 }
 
 double BrewNote::calculateBrewHouseEff_pct() {
-   double const expectedPoints = m_projFermPoints * m_projVolIntoFerm_l;
-   double const actualPoints = (m_og-1.0) * 1000.0 * m_volumeIntoFerm_l;
-
-   double const brewhouseEff = actualPoints/expectedPoints * 100.0;
+   double const brewhouseEff = this->brewhouseEffFromValues();
    this->setBrewhouseEff_pct(brewhouseEff);
    return brewhouseEff;
 }
@@ -565,15 +685,49 @@ double BrewNote::calculateABV_pct() {
 }
 
 double BrewNote::calculateActualABV_pct() {
-   double const abv = (m_og - m_fg) * 130;
+   double const abv = this->actualAbvFromValues();
    this->setABV(abv);
    return abv;
 }
 
 double BrewNote::calculateAttenuation_pct() {
-    // Calculate measured attenuation based on user-reported values for
-    // post-boil OG and post-ferment FG
-    double const attenuation = ((m_og - m_fg) / (m_og - 1)) * 100;
+    double const attenuation = this->attenuationFromValues();
     this->setAttenuation(attenuation);
     return attenuation;
 }
+
+std::optional<double> BrewNote::effIntoBKFromValues() const {
+   // I don't think we need a lot of math here. Points has already been
+   // translated from SG into pure glucose points
+   double const maxPoints = m_projPoints * m_projVolIntoBK_l;
+   qDebug() <<
+      Q_FUNC_INFO << "m_projPoints: " << m_projPoints << ", m_projVolIntoBK_l:" << m_projVolIntoBK_l <<
+      ", maxPoints:" << maxPoints;
+
+   double const actualPoints = (m_sg - 1) * 1000 * m_volumeIntoBK_l;
+   qDebug() <<
+      Q_FUNC_INFO << "m_sg:" << m_sg << ", m_volumeIntoBK_l:" << m_volumeIntoBK_l << ", actualPoints:" << actualPoints;
+   if (maxPoints <= 0.0) {
+      return std::nullopt;
+   }
+
+   double const effIntoBK = actualPoints/maxPoints * 100;
+   qDebug() << Q_FUNC_INFO << "effIntoBK:" << effIntoBK;
+   return effIntoBK;
+}
+
+double BrewNote::brewhouseEffFromValues() const {
+   double const expectedPoints = m_projFermPoints * m_projVolIntoFerm_l;
+   double const actualPoints = (m_og-1.0) * 1000.0 * m_volumeIntoFerm_l;
+   return actualPoints/expectedPoints * 100.0;
+}
+
+double BrewNote::actualAbvFromValues() const {
+   return (m_og - m_fg) * 130;
+}
+
+double BrewNote::attenuationFromValues() const {
+    // Calculate measured attenuation based on user-reported values for
+    // post-boil OG and post-ferment FG
+    return ((m_og - m_fg) / (m_og - 1)) * 100;
+}
@@ -22,12 +22,15 @@
 #define MODEL_BREWNOTE_H
 #pragma once
 
+#include <optional>
+
 #include <QDate>
 #include <QDomDocument>
 #include <QDomNode>
 #include <QSqlRecord>
 #include <QString>
 #include <QStringList>
+#include <QVector>
 
 #include "model/OwnedByRecipe.h"
 
@@ -208,8 +211,19 @@ public:
    void setProjAtten        (double var);
 
    // Metasetter
+   /**
+    * \brief Set the projected values (and, as a starting point, the measured ones) from \c parent.  Everything is
+    *        worked out from one read of each of the recipe's values, and then written to the DB in one go (and
+    *        signalled in one \c NamedEntityChangeBatch) rather than a property at a time.
+    */
    void populateNote(Recipe* parent);
    void recalculateEff(Recipe* parent);
+
+   /**
+    * \brief Does \c recalculateEff for every brew note of \c recipe, with the recipe's points only worked out once and
+    *        all the DB writes in one transaction
+    */
+   static void recalculateEffForRecipe(Recipe & recipe);
    void setLoading(bool flag);
 
    // Calculations
@@ -231,9 +245,31 @@ protected:
    virtual ObjectStore & getObjectStoreTypedInstance() const;
 
 private:
+   //! Does the work of \c recalculateEff, given the recipe's total sugars from \c Recipe::calcTotalPoints
+   void recalculateEff(double const totalSugar_kg);
+
+   //! \return Value of \c sugar_kg of sugar in \c volume_l of wort, as (SG - 1) * 1000
+   static double glucosePoints(double const sugar_kg, double const volume_l);
+
+   // These work out the calculated values from the current member variables, without setting anything
+   std::optional<double> effIntoBKFromValues   () const;
+   double                brewhouseEffFromValues() const;
+   double                actualAbvFromValues   () const;
+   double                attenuationFromValues () const;
+
+   /**
+    * \brief As \c setAndNotify, except that, instead of the change being written to the DB and signalled straight
+    *        away, the property is added to \c m_stagedChanges for \c commitStagedChanges to deal with
+    */
+   void stage(BtStringConst const & propertyName, double & memberVariable, double const newValue);
+
+   //! Write all the staged properties to the DB in one update, and then emit their "changed" signals
+   void commitStagedChanges();
 
    bool loading;
 
+   QVector<BtStringConst const *> m_stagedChanges;
+
    QDate   m_brewDate         ;
    QDate   m_fermentDate      ;
    QString m_notes            ;
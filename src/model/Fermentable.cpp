@@ -33,6 +33,7 @@
 #include "model/NamedParameterBundle.h"
 #include "model/Recipe.h"
 #include "utils/AutoCompare.h"
+#include "utils/Fingerprint.h"
 #include "utils/OptionalHelpers.h"
 
 QString Fermentable::localisedName() { return tr("Fermentable"); }
@@ -116,7 +117,7 @@ bool Fermentable::isEqualTo(NamedEntity const & other) const {
       outlinesAreEqual &&
 
       // Remaining BeerJSON fields -- excluding inventories
-      Utils::AutoCompare(this->m_notes                 , rhs.m_notes                 ) &&
+      Utils::AutoCompare(this->notes()                 , rhs.notes()                 ) &&
       Utils::AutoCompare(this->m_moisture_pct          , rhs.m_moisture_pct          ) &&
       Utils::AutoCompare(this->m_alphaAmylase_dextUnits, rhs.m_alphaAmylase_dextUnits) &&
       Utils::AutoCompare(this->m_diastaticPower_lintner, rhs.m_diastaticPower_lintner) &&
@@ -142,6 +143,17 @@ bool Fermentable::isEqualTo(NamedEntity const & other) const {
    );
 }
 
+std::size_t Fermentable::fingerprintFields(std::size_t const seed) const {
+   // Same "outline" fields as in isEqualTo, less the fuzzy-compared ones
+   std::size_t result = seed;
+   result = Utils::fingerprintCombine(result, this->m_type      );
+   result = Utils::fingerprintCombine(result, this->m_origin    );
+   result = Utils::fingerprintCombine(result, this->m_producer  );
+   result = Utils::fingerprintCombine(result, this->m_productId );
+   result = Utils::fingerprintCombine(result, this->m_grainGroup);
+   return result;
+}
+
 ObjectStore & Fermentable::getObjectStoreTypedInstance() const {
    return ObjectStoreTyped<Fermentable>::getInstance();
 }
@@ -275,7 +287,7 @@ Fermentable::Fermentable(Fermentable const & other) :
    m_color_srm                {other.m_color_srm             },
    m_origin                   {other.m_origin                },
    m_supplier                 {other.m_supplier              },
-   m_notes                    {other.m_notes                 },
+   m_notes                    {other.notes()                 },
    m_coarseFineDiff_pct       {other.m_coarseFineDiff_pct    },
    m_moisture_pct             {other.m_moisture_pct          },
    m_diastaticPower_lintner   {other.m_diastaticPower_lintner},
@@ -316,7 +328,7 @@ Fermentable::Type                      Fermentable::type                     ()
 double                                 Fermentable::color_srm                () const { return                    this->m_color_srm                ; }
 QString                                Fermentable::origin                   () const { return                    this->m_origin                   ; }
 QString                                Fermentable::supplier                 () const { return                    this->m_supplier                 ; }
-QString                                Fermentable::notes                    () const { return                    this->m_notes                    ; }
+QString                                Fermentable::notes                    () const { return this->lazyText(PropertyNames::Fermentable::notes, this->m_notes); }
 std::optional<double>                  Fermentable::coarseFineDiff_pct       () const { return                    this->m_coarseFineDiff_pct       ; }
 std::optional<double>                  Fermentable::moisture_pct             () const { return                    this->m_moisture_pct             ; }
 std::optional<double>                  Fermentable::diastaticPower_lintner   () const { return                    this->m_diastaticPower_lintner   ; }
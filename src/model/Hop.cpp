@@ -29,6 +29,7 @@
 #include "model/NamedParameterBundle.h"
 #include "model/Recipe.h"
 #include "utils/AutoCompare.h"
+#include "utils/Fingerprint.h"
 
 QString Hop::localisedName() { return tr("Hop"); }
 
@@ -99,7 +100,7 @@ bool Hop::isEqualTo(NamedEntity const & other) const {
       // Remaining BeerJSON fields -- excluding inventories
 
       Utils::AutoCompare(this->m_type              , rhs.m_type              ) &&
-      Utils::AutoCompare(this->m_notes             , rhs.m_notes             ) &&
+      Utils::AutoCompare(this->notes()             , rhs.notes()             ) &&
       Utils::AutoCompare(this->m_hsi_pct           , rhs.m_hsi_pct           ) &&
       Utils::AutoCompare(this->m_substitutes       , rhs.m_substitutes       ) &&
 
@@ -121,6 +122,17 @@ bool Hop::isEqualTo(NamedEntity const & other) const {
    );
 }
 
+std::size_t Hop::fingerprintFields(std::size_t const seed) const {
+   // Same "outline" fields as in isEqualTo, less the fuzzy-compared ones
+   std::size_t result = seed;
+   result = Utils::fingerprintCombine(result, this->m_producer );
+   result = Utils::fingerprintCombine(result, this->m_productId);
+   result = Utils::fingerprintCombine(result, this->m_origin   );
+   result = Utils::fingerprintCombine(result, this->m_year     );
+   result = Utils::fingerprintCombine(result, this->m_form     );
+   return result;
+}
+
 ObjectStore & Hop::getObjectStoreTypedInstance() const {
    return ObjectStoreTyped<Hop>::getInstance();
 }
@@ -234,7 +246,7 @@ Hop::Hop(Hop const & other) :
    m_beta_pct          {other.m_beta_pct          },
    m_origin            {other.m_origin            },
    m_type              {other.m_type              },
-   m_notes             {other.m_notes             },
+   m_notes             {other.notes()             },
    m_hsi_pct           {other.m_hsi_pct           },
    m_substitutes       {other.m_substitutes       },
    m_humulene_pct      {other.m_humulene_pct      },
@@ -268,7 +280,7 @@ std::optional<Hop::Form> Hop::form              () const { return this->m_form
 std::optional<int>       Hop::formAsInt         () const { return Optional::toOptInt(m_form); }
 std::optional<double>    Hop::beta_pct          () const { return this->m_beta_pct          ; }
 QString                  Hop::origin            () const { return this->m_origin            ; }
-QString                  Hop::notes             () const { return this->m_notes             ; }
+QString                  Hop::notes             () const { return this->lazyText(PropertyNames::Hop::notes, this->m_notes); }
 std::optional<Hop::Type> Hop::type              () const { return this->m_type              ; }
 std::optional<int>       Hop::typeAsInt         () const { return Optional::toOptInt(m_type); }
 std::optional<double>    Hop::hsi_pct           () const { return this->m_hsi_pct           ; }
@@ -32,10 +32,11 @@ protected:
    static TypeLookup const typeLookup;
 
    /**
-    * \brief Used to implement Ingredient::totalInventory() for Ingredient subclass (ie Derived)
+    * \brief Used to implement Ingredient::totalInventory() for Ingredient subclass (ie Derived).  Does not create an
+    *        \c Inventory object if there isn't one: that only happens when inventory is set.
     */
    Measurement::Amount getTotalInventory() const {
-      return InventoryTools::getInventory<Derived>(this->derived())->amount();
+      return InventoryTools::inventoryAmount<Derived>(this->derived());
    }
 
    /**
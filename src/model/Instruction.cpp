@@ -73,7 +73,8 @@ bool Instruction::isEqualTo(NamedEntity const & other) const {
    Instruction const & rhs = static_cast<Instruction const &>(other);
    // Base class will already have ensured names are equal
    return (
-      this->m_directions == rhs.m_directions &&
+      this->lazyText(PropertyNames::Instruction::directions, this->m_directions) ==
+         rhs.lazyText(PropertyNames::Instruction::directions, rhs.m_directions) &&
       this->m_hasTimer   == rhs.m_hasTimer   &&
       this->m_timerValue == rhs.m_timerValue
    );
@@ -125,7 +126,7 @@ Instruction::Instruction(NamedParameterBundle const & namedParameterBundle) :
 Instruction::Instruction(Instruction const & other) :
    NamedEntity {other},
    pimpl       {std::make_unique<impl>(*this)},
-   m_directions{other.m_directions},
+   m_directions{other.lazyText(PropertyNames::Instruction::directions, other.m_directions)},
    m_hasTimer  {other.m_hasTimer  },
    m_timerValue{other.m_timerValue},
    m_completed {other.m_completed },
@@ -174,7 +175,7 @@ void Instruction::addReagent(QString const & reagent) {
 }
 
 // Accessors ==================================================================
-QString Instruction::directions() { return m_directions; }
+QString Instruction::directions() { return this->lazyText(PropertyNames::Instruction::directions, m_directions); }
 
 bool Instruction::hasTimer() { return m_hasTimer; }
 
@@ -22,6 +22,8 @@
 #include <QObject>
 
 #include "database/ObjectStoreWrapper.h"
+#include "measurement/Amount.h"
+#include "measurement/Unit.h"
 #include "model/NamedParameterBundle.h"
 #include "model/Ingredient.h"
 #include "model/NamedEntity.h"
@@ -158,13 +160,11 @@ namespace InventoryTools {
    */
    template<IsInventory Inv, IsIngredient Ing>
    std::shared_ptr<Inv> firstInventory(Ing const & ing) {
-      auto ingredientId = ing.key();
-      auto result = ObjectStoreWrapper::findFirstMatching<Inv>(
-         [ingredientId](std::shared_ptr<Inv> inventory) {
-            return inventory->ingredientId() == ingredientId;
-         }
-      );
-      return result;
+      auto const inventories = ObjectStoreWrapper::findByIndex<Inv>(PropertyNames::Inventory::ingredientId, ing.key());
+      if (inventories.isEmpty()) {
+         return nullptr;
+      }
+      return inventories.first();
    }
 
    /**
@@ -180,9 +180,31 @@ namespace InventoryTools {
       return !!result;
    }
 
+   /**
+   * \return The amount in inventory of the supplied \c Ingredient subclass object, or zero (in the ingredient's
+   *         canonical units) if it has no \c Inventory object.
+   *
+   *         This is the read path (eg for the inventory column of a catalog table, which asks for every row it paints)
+   *         so, unlike \c getInventory, it never creates an \c Inventory object.  Finding the existing one is a look-up
+   *         in the object store's index on \c PropertyNames::Inventory::ingredientId.
+   */
+   template<IsIngredient Ing>
+   Measurement::Amount inventoryAmount(Ing const & ing) {
+      if (ing.key() > 0) {
+         auto const inventories = ObjectStoreWrapper::findByIndexRaw<typename Ing::InventoryClass>(
+            PropertyNames::Inventory::ingredientId,
+            ing.key()
+         );
+         if (!inventories.isEmpty()) {
+            return inventories.first()->amount();
+         }
+      }
+      return Measurement::Amount{0.0, Measurement::Unit::getCanonicalUnit(Ing::defaultMeasure)};
+   }
+
    /**
    * \return A suitable \c Inventory subclass object for the supplied \c Ingredient subclass object.  If the former does
-   *         not exist, it will be created.
+   *         not exist, it will be created.  This is the write path: see \c inventoryAmount for reading.
    */
    template<IsIngredient Ing>
    std::shared_ptr<typename Ing::InventoryClass> getInventory(Ing const & ing) {
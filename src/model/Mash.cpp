@@ -225,8 +225,8 @@ void Mash::acceptStepChange([[maybe_unused]] QMetaProperty prop,
 
    // If one of our mash steps changed, our calculated properties may also change, so we need to emit some signals
    if (stepSender->ownerId() == this->key()) {
-      emit changed(metaProperty(*PropertyNames::Mash::totalMashWater_l), QVariant());
-      emit changed(metaProperty(*PropertyNames::Mash::totalTime       ), QVariant());
+      this->emitChanged(PropertyNames::Mash::totalMashWater_l, QVariant());
+      this->emitChanged(PropertyNames::Mash::totalTime, QVariant());
    }
 
    return;
@@ -32,6 +32,7 @@
 #include "model/NamedParameterBundle.h"
 #include "model/Recipe.h"
 #include "utils/AutoCompare.h"
+#include "utils/Fingerprint.h"
 
 QString Misc::localisedName() { return tr("Miscellaneous"); }
 
@@ -77,10 +78,19 @@ bool Misc::isEqualTo(NamedEntity const & other) const {
 
       // Remaining BeerJSON fields -- excluding inventories
       Utils::AutoCompare(this->m_useFor, rhs.m_useFor) &&
-      Utils::AutoCompare(this->m_notes , rhs.m_notes )
+      Utils::AutoCompare(this->notes() , rhs.notes() )
    );
 }
 
+std::size_t Misc::fingerprintFields(std::size_t const seed) const {
+   // Same "outline" fields as in isEqualTo
+   std::size_t result = seed;
+   result = Utils::fingerprintCombine(result, this->m_producer );
+   result = Utils::fingerprintCombine(result, this->m_productId);
+   result = Utils::fingerprintCombine(result, this->m_type     );
+   return result;
+}
+
 ObjectStore & Misc::getObjectStoreTypedInstance() const {
    return ObjectStoreTyped<Misc>::getInstance();
 }
@@ -133,7 +143,7 @@ Misc::Misc(Misc const & other) :
    Ingredient{other             },
    m_type     {other.m_type     },
    m_useFor   {other.m_useFor   },
-   m_notes    {other.m_notes    },
+   m_notes    {other.notes()    },
    // ⮜⮜⮜ All below added for BeerJSON support ⮞⮞⮞
    m_producer {other.m_producer },
    m_productId{other.m_productId} {
@@ -147,7 +157,7 @@ Misc::~Misc() = default;
 //============================"GET" METHODS=====================================
 Misc::Type Misc::type          () const { return m_type     ; }
 QString    Misc::useFor        () const { return m_useFor   ; }
-QString    Misc::notes         () const { return m_notes    ; }
+QString    Misc::notes         () const { return this->lazyText(PropertyNames::Misc::notes, m_notes); }
 // ⮜⮜⮜ All below added for BeerJSON support ⮞⮞⮞
 QString    Misc::producer      () const { return m_producer ; }
 QString    Misc::productId     () const { return m_productId; }
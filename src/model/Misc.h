@@ -149,6 +149,7 @@ signals:
 
 protected:
    virtual bool isEqualTo(NamedEntity const & other) const;
+   virtual std::size_t fingerprintFields(std::size_t const seed) const;
    virtual ObjectStore & getObjectStoreTypedInstance() const;
 
 private:
@@ -0,0 +1,188 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * model/ModelData.cpp is part of Brewtarget, and is copyright the following authors 2024:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#include "model/ModelData.h"
+
+#include "model/RecipeAdditionFermentable.h"
+#include "model/RecipeAdditionHop.h"
+#include "model/RecipeAdditionYeast.h"
+
+namespace {
+   /**
+    * \brief Fill in the fields common to all recipe additions
+    */
+   template<class RA>
+   void copyAdditionFields(RecipeAdditionData & data, RA const & addition, NamedEntity const * ingredient) {
+      data.key             = addition.key();
+      data.recipeId        = addition.recipeId();
+      data.ingredientId    = ingredient ? ingredient->key() : -1;
+      data.stage           = addition.stage();
+      data.step            = addition.step();
+      data.addAtTime_mins  = addition.addAtTime_mins();
+      data.addAtGravity_sg = addition.addAtGravity_sg();
+      data.addAtAcidity_pH = addition.addAtAcidity_pH();
+      data.duration_mins   = addition.duration_mins();
+      data.amount          = addition.amount();
+      return;
+   }
+}
+
+HopData HopData::of(Hop const & hop) {
+   return HopData{
+      .key                = hop.key(),
+      .name               = hop.name(),
+      .alpha_pct          = hop.alpha_pct(),
+      .form               = hop.form(),
+      .beta_pct           = hop.beta_pct(),
+      .origin             = hop.origin(),
+      .type               = hop.type(),
+      .hsi_pct            = hop.hsi_pct(),
+      .humulene_pct       = hop.humulene_pct(),
+      .caryophyllene_pct  = hop.caryophyllene_pct(),
+      .cohumulone_pct     = hop.cohumulone_pct(),
+      .myrcene_pct        = hop.myrcene_pct(),
+      .totalOil_mlPer100g = hop.totalOil_mlPer100g(),
+      .farnesene_pct      = hop.farnesene_pct(),
+      .geraniol_pct       = hop.geraniol_pct(),
+      .bPinene_pct        = hop.bPinene_pct(),
+      .linalool_pct       = hop.linalool_pct(),
+      .limonene_pct       = hop.limonene_pct(),
+      .nerol_pct          = hop.nerol_pct(),
+      .pinene_pct         = hop.pinene_pct(),
+      .polyphenols_pct    = hop.polyphenols_pct(),
+      .xanthohumol_pct    = hop.xanthohumol_pct(),
+      .producer           = hop.producer(),
+      .productId          = hop.productId(),
+      .year               = hop.year()
+   };
+}
+
+FermentableData FermentableData::of(Fermentable const & fermentable) {
+   return FermentableData{
+      .key                    = fermentable.key(),
+      .name                   = fermentable.name(),
+      .type                   = fermentable.type(),
+      .color_srm              = fermentable.color_srm(),
+      .origin                 = fermentable.origin(),
+      .supplier               = fermentable.supplier(),
+      .coarseFineDiff_pct     = fermentable.coarseFineDiff_pct(),
+      .moisture_pct           = fermentable.moisture_pct(),
+      .protein_pct            = fermentable.protein_pct(),
+      .maxInBatch_pct         = fermentable.maxInBatch_pct(),
+      .recommendMash          = fermentable.recommendMash(),
+      .ibuGalPerLb            = fermentable.ibuGalPerLb(),
+      .grainGroup             = fermentable.grainGroup(),
+      .producer               = fermentable.producer(),
+      .productId              = fermentable.productId(),
+      .fineGrindYield_pct     = fermentable.fineGrindYield_pct(),
+      .coarseGrindYield_pct   = fermentable.coarseGrindYield_pct(),
+      .potentialYield_sg      = fermentable.potentialYield_sg(),
+      .alphaAmylase_dextUnits = fermentable.alphaAmylase_dextUnits(),
+      .kolbachIndex_pct       = fermentable.kolbachIndex_pct(),
+      .friability_pct         = fermentable.friability_pct(),
+      .di_ph                  = fermentable.di_ph(),
+      .viscosity_cP           = fermentable.viscosity_cP(),
+      .dmsP_ppm               = fermentable.dmsP_ppm(),
+      .fan_ppm                = fermentable.fan_ppm(),
+      .fermentability_pct     = fermentable.fermentability_pct(),
+      .betaGlucan_ppm         = fermentable.betaGlucan_ppm(),
+      .isExtract              = fermentable.isExtract(),
+      .isSugar                = fermentable.isSugar()
+   };
+}
+
+YeastData YeastData::of(Yeast const & yeast) {
+   return YeastData{
+      .key                       = yeast.key(),
+      .name                      = yeast.name(),
+      .type                      = yeast.type(),
+      .form                      = yeast.form(),
+      .laboratory                = yeast.laboratory(),
+      .productId                 = yeast.productId(),
+      .minTemperature_c          = yeast.minTemperature_c(),
+      .maxTemperature_c          = yeast.maxTemperature_c(),
+      .flocculation              = yeast.flocculation(),
+      .maxReuse                  = yeast.maxReuse(),
+      .alcoholTolerance_pct      = yeast.alcoholTolerance_pct(),
+      .attenuationMin_pct        = yeast.attenuationMin_pct(),
+      .attenuationMax_pct        = yeast.attenuationMax_pct(),
+      .phenolicOffFlavorPositive = yeast.phenolicOffFlavorPositive(),
+      .glucoamylasePositive      = yeast.glucoamylasePositive(),
+      .killerProducingK1Toxin    = yeast.killerProducingK1Toxin(),
+      .killerProducingK2Toxin    = yeast.killerProducingK2Toxin(),
+      .killerProducingK28Toxin   = yeast.killerProducingK28Toxin(),
+      .killerProducingKlusToxin  = yeast.killerProducingKlusToxin(),
+      .killerNeutral             = yeast.killerNeutral(),
+      .attenuationTypical_pct    = yeast.attenuationTypical_pct()
+   };
+}
+
+EquipmentData EquipmentData::of(Equipment const & equipment) {
+   return EquipmentData{
+      .key                        = equipment.key(),
+      .name                       = equipment.name(),
+      .kettleBoilSize_l           = equipment.kettleBoilSize_l(),
+      .fermenterBatchSize_l       = equipment.fermenterBatchSize_l(),
+      .mashTunVolume_l            = equipment.mashTunVolume_l(),
+      .mashTunWeight_kg           = equipment.mashTunWeight_kg(),
+      .mashTunSpecificHeat_calGC  = equipment.mashTunSpecificHeat_calGC(),
+      .topUpWater_l               = equipment.topUpWater_l(),
+      .kettleTrubChillerLoss_l    = equipment.kettleTrubChillerLoss_l(),
+      .evapRate_pctHr             = equipment.evapRate_pctHr(),
+      .kettleEvaporationPerHour_l = equipment.kettleEvaporationPerHour_l(),
+      .boilTime_min               = equipment.boilTime_min(),
+      .calcBoilVolume             = equipment.calcBoilVolume(),
+      .lauterTunDeadspaceLoss_l   = equipment.lauterTunDeadspaceLoss_l(),
+      .topUpKettle_l              = equipment.topUpKettle_l(),
+      .hopUtilization_pct         = equipment.hopUtilization_pct(),
+      .mashTunGrainAbsorption_LKg = equipment.mashTunGrainAbsorption_LKg(),
+      .boilingPoint_c             = equipment.boilingPoint_c(),
+      .kettleInternalDiameter_cm  = equipment.kettleInternalDiameter_cm(),
+      .kettleOpeningDiameter_cm   = equipment.kettleOpeningDiameter_cm(),
+      .hltVolume_l                = equipment.hltVolume_l(),
+      .lauterTunVolume_l          = equipment.lauterTunVolume_l(),
+      .agingVesselVolume_l        = equipment.agingVesselVolume_l(),
+      .packagingVesselVolume_l    = equipment.packagingVesselVolume_l(),
+      .hltLoss_l                  = equipment.hltLoss_l(),
+      .mashTunLoss_l              = equipment.mashTunLoss_l(),
+      .fermenterLoss_l            = equipment.fermenterLoss_l(),
+      .agingVesselLoss_l          = equipment.agingVesselLoss_l(),
+      .packagingVesselLoss_l      = equipment.packagingVesselLoss_l(),
+      .kettleOutflowPerMinute_l   = equipment.kettleOutflowPerMinute_l()
+   };
+}
+
+RecipeAdditionHopData RecipeAdditionHopData::of(RecipeAdditionHop const & hopAddition) {
+   RecipeAdditionHopData data{};
+   copyAdditionFields(data, hopAddition, hopAddition.hop());
+   data.isFirstWort = hopAddition.isFirstWort();
+   return data;
+}
+
+RecipeAdditionFermentableData RecipeAdditionFermentableData::of(RecipeAdditionFermentable const & fermentableAddition) {
+   RecipeAdditionFermentableData data{};
+   copyAdditionFields(data, fermentableAddition, fermentableAddition.fermentable());
+   return data;
+}
+
+RecipeAdditionYeastData RecipeAdditionYeastData::of(RecipeAdditionYeast const & yeastAddition) {
+   RecipeAdditionYeastData data{};
+   copyAdditionFields(data, yeastAddition, yeastAddition.yeast());
+   data.attenuation_pct   = yeastAddition.attenuation_pct  ();
+   data.timesCultured     = yeastAddition.timesCultured    ();
+   data.cellCountBillions = yeastAddition.cellCountBillions();
+   data.addToSecondary    = yeastAddition.addToSecondary   ();
+   return data;
+}
@@ -0,0 +1,219 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * model/ModelData.h is part of Brewtarget, and is copyright the following authors 2024:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#ifndef MODEL_MODELDATA_H
+#define MODEL_MODELDATA_H
+#pragma once
+
+#include <optional>
+
+#include <QString>
+
+#include "measurement/Amount.h"
+#include "model/Equipment.h"
+#include "model/Fermentable.h"
+#include "model/Hop.h"
+#include "model/RecipeAddition.h"
+#include "model/Yeast.h"
+
+class RecipeAdditionFermentable;
+class RecipeAdditionHop;
+class RecipeAdditionYeast;
+
+/**
+ * \brief Plain value-type copies of the (stored) properties of some of our model classes.
+ *
+ *        The model classes themselves are \c QObject subclasses, belong to the GUI thread, and have setters that emit
+ *        signals and write to the DB.  The structs here have none of that: they are just aggregates of values, so they
+ *        can be copied to, and used on, any thread, and arrays of them are a lot more compact to loop over than arrays
+ *        of pointers to \c QObject.  The intended use is for code such as the recipe calculations, importers and
+ *        exporters that wants to work on a consistent copy of the data off the GUI thread.
+ *
+ *        Each struct has a static \c of function to make one from the corresponding model object, which, like all
+ *        other reading of model objects, needs to be done on the thread that owns the object (ie normally the GUI
+ *        thread).  There is deliberately no conversion back: changes need to go through the model classes' setters in
+ *        the usual way.
+ *
+ *        Fields are named after, and in the same order as, the corresponding Q_PROPERTY in the model class.  Free-text
+ *        fields (notes etc) are not included, as nothing that runs off-thread needs them.  References to other
+ *        objects are by ID (ie \c NamedEntity::key).
+ */
+struct HopData {
+   int                      key;
+   QString                  name;
+   double                   alpha_pct;
+   std::optional<Hop::Form> form;
+   std::optional<double>    beta_pct;
+   QString                  origin;
+   std::optional<Hop::Type> type;
+   std::optional<double>    hsi_pct;
+   std::optional<double>    humulene_pct;
+   std::optional<double>    caryophyllene_pct;
+   std::optional<double>    cohumulone_pct;
+   std::optional<double>    myrcene_pct;
+   std::optional<double>    totalOil_mlPer100g;
+   std::optional<double>    farnesene_pct;
+   std::optional<double>    geraniol_pct;
+   std::optional<double>    bPinene_pct;
+   std::optional<double>    linalool_pct;
+   std::optional<double>    limonene_pct;
+   std::optional<double>    nerol_pct;
+   std::optional<double>    pinene_pct;
+   std::optional<double>    polyphenols_pct;
+   std::optional<double>    xanthohumol_pct;
+   QString                  producer;
+   QString                  productId;
+   QString                  year;
+
+   static HopData of(Hop const & hop);
+};
+
+struct FermentableData {
+   int                                    key;
+   QString                                name;
+   Fermentable::Type                      type;
+   double                                 color_srm;
+   QString                                origin;
+   QString                                supplier;
+   std::optional<double>                  coarseFineDiff_pct;
+   std::optional<double>                  moisture_pct;
+   std::optional<double>                  diastaticPower_lintner;
+   std::optional<double>                  protein_pct;
+   std::optional<double>                  maxInBatch_pct;
+   std::optional<bool>                    recommendMash;
+   std::optional<double>                  ibuGalPerLb;
+   std::optional<Fermentable::GrainGroup> grainGroup;
+   QString                                producer;
+   QString                                productId;
+   std::optional<double>                  fineGrindYield_pct;
+   std::optional<double>                  coarseGrindYield_pct;
+   std::optional<double>                  potentialYield_sg;
+   std::optional<double>                  alphaAmylase_dextUnits;
+   std::optional<double>                  kolbachIndex_pct;
+   std::optional<double>                  friability_pct;
+   std::optional<double>                  di_ph;
+   std::optional<double>                  viscosity_cP;
+   std::optional<double>                  dmsP_ppm;
+   std::optional<double>                  fan_ppm;
+   std::optional<double>                  fermentability_pct;
+   std::optional<double>                  betaGlucan_ppm;
+   // These are calculated rather than stored, but are used enough to be worth copying
+   bool                                   isExtract;
+   bool                                   isSugar;
+
+   static FermentableData of(Fermentable const & fermentable);
+};
+
+struct YeastData {
+   int                                key;
+   QString                            name;
+   Yeast::Type                        type;
+   Yeast::Form                        form;
+   QString                            laboratory;
+   QString                            productId;
+   std::optional<double>              minTemperature_c;
+   std::optional<double>              maxTemperature_c;
+   std::optional<Yeast::Flocculation> flocculation;
+   std::optional<int>                 maxReuse;
+   std::optional<double>              alcoholTolerance_pct;
+   std::optional<double>              attenuationMin_pct;
+   std::optional<double>              attenuationMax_pct;
+   std::optional<bool>                phenolicOffFlavorPositive;
+   std::optional<bool>                glucoamylasePositive;
+   std::optional<bool>                killerProducingK1Toxin;
+   std::optional<bool>                killerProducingK2Toxin;
+   std::optional<bool>                killerProducingK28Toxin;
+   std::optional<bool>                killerProducingKlusToxin;
+   std::optional<bool>                killerNeutral;
+   //! See \c Yeast::attenuationTypical_pct
+   double                             attenuationTypical_pct;
+
+   static YeastData of(Yeast const & yeast);
+};
+
+struct EquipmentData {
+   int                   key;
+   QString               name;
+   double                kettleBoilSize_l;
+   double                fermenterBatchSize_l;
+   double                mashTunVolume_l;
+   std::optional<double> mashTunWeight_kg;
+   std::optional<double> mashTunSpecificHeat_calGC;
+   std::optional<double> topUpWater_l;
+   double                kettleTrubChillerLoss_l;
+   std::optional<double> evapRate_pctHr;
+   std::optional<double> kettleEvaporationPerHour_l;
+   std::optional<double> boilTime_min;
+   bool                  calcBoilVolume;
+   double                lauterTunDeadspaceLoss_l;
+   std::optional<double> topUpKettle_l;
+   std::optional<double> hopUtilization_pct;
+   std::optional<double> mashTunGrainAbsorption_LKg;
+   double                boilingPoint_c;
+   std::optional<double> kettleInternalDiameter_cm;
+   std::optional<double> kettleOpeningDiameter_cm;
+   double                hltVolume_l;
+   double                lauterTunVolume_l;
+   double                agingVesselVolume_l;
+   double                packagingVesselVolume_l;
+   double                hltLoss_l;
+   double                mashTunLoss_l;
+   double                fermenterLoss_l;
+   double                agingVesselLoss_l;
+   double                packagingVesselLoss_l;
+   std::optional<double> kettleOutflowPerMinute_l;
+
+   static EquipmentData of(Equipment const & equipment);
+};
+
+/**
+ * \brief The fields common to all the \c RecipeAddition subclasses.  (Not used on its own, hence no \c of function.)
+ */
+struct RecipeAdditionData {
+   int                   key;
+   //! The \c Recipe this is an addition to
+   int                   recipeId;
+   //! The ingredient being added, or -1 if none is set
+   int                   ingredientId;
+   RecipeAddition::Stage stage;
+   std::optional<int>    step;
+   std::optional<double> addAtTime_mins;
+   std::optional<double> addAtGravity_sg;
+   std::optional<double> addAtAcidity_pH;
+   std::optional<double> duration_mins;
+   Measurement::Amount   amount;
+};
+
+struct RecipeAdditionHopData : public RecipeAdditionData {
+   //! See \c RecipeAdditionHop::isFirstWort
+   bool isFirstWort;
+
+   static RecipeAdditionHopData of(RecipeAdditionHop const & hopAddition);
+};
+
+struct RecipeAdditionFermentableData : public RecipeAdditionData {
+   static RecipeAdditionFermentableData of(RecipeAdditionFermentable const & fermentableAddition);
+};
+
+struct RecipeAdditionYeastData : public RecipeAdditionData {
+   std::optional<double> attenuation_pct;
+   std::optional<int   > timesCultured;
+   std::optional<int   > cellCountBillions;
+   std::optional<bool  > addToSecondary;
+
+   static RecipeAdditionYeastData of(RecipeAdditionYeast const & yeastAddition);
+};
+
+#endif
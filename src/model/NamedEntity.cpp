@@ -22,9 +22,15 @@
 #include <compare>
 #include <typeinfo>
 #include <string>
+#include <vector>
 
+#include <QCoreApplication>
 #include <QDebug>
+#include <QHash>
+#include <QMetaMethod>
 #include <QMetaProperty>
+#include <QThread>
+#include <QVector>
 
 #include "database/ObjectStore.h"
 #include "measurement/ConstrainedAmount.h"
@@ -56,6 +62,8 @@
 #include "model/Style.h"
 #include "model/Water.h"
 #include "model/Yeast.h"
+#include "utils/Diagnostics.h"
+#include "utils/Fingerprint.h"
 
 
 QString NamedEntity::localisedName() { return tr("Named Entity"); }
@@ -134,6 +142,9 @@ void NamedEntity::swap(NamedEntity & other) noexcept {
    std::swap(this->m_name   , other.m_name   );
    std::swap(this->m_display, other.m_display);
    std::swap(this->m_deleted, other.m_deleted);
+   // Subclass fields are being swapped too, so neither fingerprint is valid any more
+   this->m_cachedFingerprint.reset();
+   other.m_cachedFingerprint.reset();
    return;
 }
 
@@ -154,7 +165,10 @@ TypeLookup const NamedEntity::typeLookup {
    {}
 };
 
-NamedEntity::~NamedEntity() = default;
+NamedEntity::~NamedEntity() {
+   NamedEntityChangeBatch::forget(*this);
+   return;
+}
 
 void NamedEntity::makeChild(NamedEntity const & copiedFrom) {
    // It's a coding error if we're not starting out with objects that are copies of each other
@@ -186,17 +200,31 @@ void NamedEntity::makeChild(NamedEntity const & copiedFrom) {
    return;
 }
 
-QRegExp const & NamedEntity::getDuplicateNameNumberMatcher() {
+QRegularExpression const & NamedEntity::getDuplicateNameNumberMatcher() {
    //
    // Note that, in the regexp, to match a bracket, we need to escape it, thus "\(" instead of "(".  However, we
    // must also escape the backslash so that the C++ compiler doesn't think we want a special character (such as
    // '\n') and barf a "unknown escape sequence" warning at us.  So "\\(" is needed in the string literal here to
    // pass "\(" to the regexp to match literal "(" (and similarly for close bracket).
    //
-   static QRegExp const duplicateNameNumberMatcher{" *\\(([0-9]+)\\)$"};
+   // Unlike QRegExp, QRegularExpression has no per-match state, so it's safe for all callers to share one instance,
+   // and we can ask for it to be compiled just once, up front.
+   static QRegularExpression const duplicateNameNumberMatcher = [](){
+      QRegularExpression matcher{" *\\(([0-9]+)\\)$"};
+      matcher.optimize();
+      return matcher;
+   }();
    return duplicateNameNumberMatcher;
 }
 
+std::pair<QString, int> NamedEntity::splitDuplicateNameNumber(QString const & name) {
+   QRegularExpressionMatch const match = NamedEntity::getDuplicateNameNumberMatcher().match(name);
+   if (!match.hasMatch()) {
+      return {name, 0};
+   }
+   return {name.left(match.capturedStart()), match.captured(1).toInt()};
+}
+
 
 // See https://zpz.github.io/blog/overloading-equality-operator-in-cpp-class-hierarchy/ (and cross-references to
 // http://www.gotw.ca/publications/mill18.htm) for good discussion on implementation of operator== in a class
@@ -213,6 +241,15 @@ bool NamedEntity::operator==(NamedEntity const & other) const {
       return false;
    }
 
+   //
+   // Equal objects always have equal fingerprints, so, if the fingerprints differ, we don't need to compare any fields.
+   // Since the fingerprint is cached, this is usually just an integer comparison, which is a lot cheaper than the
+   // field-by-field comparison in isEqualTo (particularly for classes such as Recipe that compare contained objects).
+   //
+   if (this->fingerprint() != other.fingerprint()) {
+      return false;
+   }
+
    //
    // For the base class attributes, we deliberately don't compare m_key, parentKey, table or m_folder.  If we've read
    // in an object from a file and want to  see if it's the same as one in the database, then the DB-related info and
@@ -226,15 +263,8 @@ bool NamedEntity::operator==(NamedEntity const & other) const {
       // "Tettnang" and another called "Tettnang (1)" we wouldn't say they are different just because of the names.
       // So we want to strip off any number in brackets at the ends of the names and then compare again.
       //
-      QRegExp const & duplicateNameNumberMatcher = NamedEntity::getDuplicateNameNumberMatcher();
-      QString names[2] {this->m_name, other.m_name};
-      for (auto ii = 0; ii < 2; ++ii) {
-         int positionOfMatch = duplicateNameNumberMatcher.indexIn(names[ii]);
-         if (positionOfMatch > -1) {
-            // There's some integer in brackets at the end of the name.  Chop it off.
-            names[ii].truncate(positionOfMatch);
-         }
-      }
+      QString const names[2] {NamedEntity::splitDuplicateNameNumber(this->m_name).first,
+                              NamedEntity::splitDuplicateNameNumber(other.m_name).first};
 //      qDebug() << Q_FUNC_INFO << "Adjusted names to " << names[0] << " & " << names[1];
       if (names[0] != names[1]) {
          return false;
@@ -249,6 +279,21 @@ bool NamedEntity::operator!=(NamedEntity const & other) const {
    return !(*this == other);
 }
 
+std::size_t NamedEntity::fingerprint() const {
+   if (!this->m_cachedFingerprint) {
+      // Same name normalisation as in operator== above.  We don't use Utils::fingerprintCombine for the name, because
+      // operator== does not ignore whitespace.
+      QString const name = NamedEntity::splitDuplicateNameNumber(this->m_name).first;
+      this->m_cachedFingerprint = this->fingerprintFields(Utils::fingerprintMix(0, qHash(name)));
+   }
+   return *this->m_cachedFingerprint;
+}
+
+std::size_t NamedEntity::fingerprintFields(std::size_t const seed) const {
+   // Nothing to add in the base class
+   return seed;
+}
+
 std::strong_ordering NamedEntity::operator<=>(NamedEntity const & other) const {
    // The spaceship operator is not defined for two QString objects, but it is defined for a pair of std::u16string,
    // which is close to the same thing (in that QString stores "a string of 16-bit QChars, where each QChar corresponds
@@ -302,6 +347,13 @@ int NamedEntity::key() const {
    return this->m_key;
 }
 
+QString NamedEntity::lazyText(BtStringConst const & propertyName, QString const & memberValue) const {
+   if (!memberValue.isNull() || this->m_key <= 0) {
+      return memberValue;
+   }
+   return this->getObjectStoreTypedInstance().lazyTextValue(this->m_key, propertyName);
+}
+
 void NamedEntity::setKey(int key) {
    // This will get called by the ObjectStore after inserting something in the DB, so we _don't_ want to call
    // this->propagatePropertyChange, as this would result in some hilarious and pointless circularity where we call
@@ -362,8 +414,13 @@ QVector<int> NamedEntity::getParentAndChildrenIds() const {
    results.append(parent->m_key);
 
    // ...now find all the children, ie all the other ingredients of this type whose parent is the ingredient we just
-   // found
-   QList<std::shared_ptr<QObject> > children = this->getObjectStoreTypedInstance().findAllMatching(
+   // found.  Where the store indexes parentKey, we can do this without looking at every object.
+   ObjectStore const & objectStore = this->getObjectStoreTypedInstance();
+   if (objectStore.hasIndex(PropertyNames::NamedEntity::parentKey)) {
+      results.append(objectStore.idsByIndex(PropertyNames::NamedEntity::parentKey, parent->key()));
+      return results;
+   }
+   QList<std::shared_ptr<QObject> > children = objectStore.findAllMatching(
       [parent](std::shared_ptr<QObject> obj) { return std::static_pointer_cast<NamedEntity>(obj)->getParentKey() == parent->key(); }
    );
    for (auto child : children) {
@@ -460,6 +517,9 @@ void NamedEntity::prepareForPropertyChange(BtStringConst const & propertyName) {
 }
 
 void NamedEntity::propagatePropertyChange(BtStringConst const & propertyName, bool notify) const {
+   // Whatever else happens, the property has changed, so the fingerprint might have too
+   this->m_cachedFingerprint.reset();
+
    if (!this->m_propagationAndSignalsEnabled) {
       qDebug() << Q_FUNC_INFO << "m_propagationAndSignalsEnabled unset";
       return;
@@ -480,14 +540,60 @@ void NamedEntity::propagatePropertyChange(BtStringConst const & propertyName, bo
 }
 
 void NamedEntity::notifyPropertyChange(BtStringConst const & propertyName) const {
+   // Some setters call this directly rather than via propagatePropertyChange
+   this->m_cachedFingerprint.reset();
+
    // It's obviously a coding error to supply a property name that is not registered with Qt as a property of this
    // object
    int idx = this->metaObject()->indexOfProperty(*propertyName);
    Q_ASSERT(idx >= 0);
-   QMetaProperty metaProperty = this->metaObject()->property(idx);
-   QVariant value = metaProperty.read(this);
-   emit this->changed(metaProperty, value);
+   if (!NamedEntityChangeBatch::defer(*this, idx)) {
+      this->emitChanged(idx);
+   }
+   return;
+}
+
+unsigned int NamedEntity::changeCount() const {
+   return this->m_changeCount;
+}
+
+namespace {
+   //! \return The \c NamedEntity::changed signal, for \c QObject::isSignalConnected
+   QMetaMethod const & changedSignal() {
+      static QMetaMethod const signal = QMetaMethod::fromSignal(&NamedEntity::changed);
+      return signal;
+   }
+}
+
+void NamedEntity::emitChanged(int const propertyIndex) const {
+   ++this->m_changeCount;
+   //
+   // Building the payload of the full-fat changed signal means reading the property into a QVariant (which, for some
+   // properties, means a calculation or a string copy).  Most of our listeners now use propertyChanged instead, so it
+   // is worth skipping that work when nothing is connected to changed.  (We still need the QMetaProperty for the
+   // property name that Diagnostics records.)
+   //
+   QMetaProperty metaProperty = this->metaObject()->property(propertyIndex);
+   if (this->isSignalConnected(changedSignal())) {
+      QVariant value = metaProperty.read(this);
+      emit this->changed(metaProperty, value);
+      Diagnostics::recordSignalEmitted(this->metaObject()->className(), "changed", metaProperty.name());
+   }
+   emit this->propertyChanged(this->m_key, propertyIndex);
+   Diagnostics::recordSignalEmitted(this->metaObject()->className(), "propertyChanged", metaProperty.name());
+   return;
+}
 
+void NamedEntity::emitChanged(BtStringConst const & propertyName, QVariant const & value) const {
+   int const propertyIndex = this->metaObject()->indexOfProperty(*propertyName);
+   Q_ASSERT(propertyIndex >= 0);
+   ++this->m_changeCount;
+   if (this->isSignalConnected(changedSignal())) {
+      emit this->changed(this->metaObject()->property(propertyIndex), value);
+      Diagnostics::recordSignalEmitted(this->metaObject()->className(), "changed", *propertyName);
+   }
+   emit this->propertyChanged(this->m_key, propertyIndex);
+   Diagnostics::recordSignalEmitted(this->metaObject()->className(), "propertyChanged", *propertyName);
    return;
 }
 
@@ -534,6 +640,95 @@ NamedEntity * NamedEntity::ensureExists(BtStringConst const & property) {
 //======================================================================================================================
 // NamedEntityModifyingMarker
 //======================================================================================================================
+namespace {
+   //
+   // State for NamedEntityChangeBatch.  This is only ever accessed on the GUI thread, so there is no need for locking.
+   //
+   int changeBatchDepth = 0;
+
+   //! Objects with deferred signals, in the order they first changed, along with the indexes of their changed
+   //  properties, in the order they first changed.  Entries for deleted objects have their pointer set to nullptr.
+   std::vector<std::pair<NamedEntity const *, QVector<int>>> deferredChanges;
+
+   //! Position in deferredChanges of each object
+   QHash<NamedEntity const *, std::size_t> deferredChangePositions;
+
+   bool onGuiThread() {
+      QCoreApplication const * application = QCoreApplication::instance();
+      return application && QThread::currentThread() == application->thread();
+   }
+}
+
+NamedEntityChangeBatch::NamedEntityChangeBatch() :
+   m_active{onGuiThread()} {
+   if (this->m_active) {
+      ++changeBatchDepth;
+   }
+   return;
+}
+
+NamedEntityChangeBatch::~NamedEntityChangeBatch() {
+   if (!this->m_active) {
+      return;
+   }
+
+   Q_ASSERT(changeBatchDepth > 0);
+   if (--changeBatchDepth > 0) {
+      return;
+   }
+
+   //
+   // Now the outermost batch is closed, emit the signals.  The slots that receive them can make further changes, but,
+   // since no batch is open, they don't get added to deferredChanges.  They can, however, delete objects in it, so we
+   // need to re-read the pointer for each entry, rather than iterating over a copy.
+   //
+   for (std::size_t ii = 0; ii < deferredChanges.size(); ++ii) {
+      QVector<int> const propertyIndexes = deferredChanges[ii].second;
+      for (int const propertyIndex : propertyIndexes) {
+         NamedEntity const * namedEntity = deferredChanges[ii].first;
+         if (!namedEntity) {
+            break;
+         }
+         namedEntity->emitChanged(propertyIndex);
+      }
+   }
+   deferredChanges.clear();
+   deferredChangePositions.clear();
+   return;
+}
+
+bool NamedEntityChangeBatch::defer(NamedEntity const & namedEntity, int const propertyIndex) {
+   if (changeBatchDepth == 0 || !onGuiThread()) {
+      return false;
+   }
+
+   auto position = deferredChangePositions.constFind(&namedEntity);
+   if (position == deferredChangePositions.cend()) {
+      deferredChangePositions.insert(&namedEntity, deferredChanges.size());
+      deferredChanges.emplace_back(&namedEntity, QVector<int>{propertyIndex});
+      return true;
+   }
+
+   QVector<int> & propertyIndexes = deferredChanges[*position].second;
+   if (!propertyIndexes.contains(propertyIndex)) {
+      propertyIndexes.append(propertyIndex);
+   }
+   return true;
+}
+
+void NamedEntityChangeBatch::forget(NamedEntity const & namedEntity) {
+   if (deferredChangePositions.isEmpty() || !onGuiThread()) {
+      return;
+   }
+
+   auto position = deferredChangePositions.find(&namedEntity);
+   if (position != deferredChangePositions.end()) {
+      deferredChanges[*position].first = nullptr;
+      deferredChangePositions.erase(position);
+   }
+   return;
+}
+
 NamedEntityModifyingMarker::NamedEntityModifyingMarker(NamedEntity & namedEntity) :
    namedEntity{namedEntity},
    savedModificationState{namedEntity.isBeingModified()} {
@@ -21,16 +21,19 @@
 #define MODEL_NAMEDENTITY_H
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <memory>
 #include <optional>
 #include <type_traits>
+#include <utility>
 
 #include <QDateTime>
 #include <QDebug>
 #include <QList>
 #include <QMetaProperty>
 #include <QObject>
+#include <QRegularExpression>
 #include <QVariant>
 
 #include "model/FolderBase.h"
@@ -227,6 +230,20 @@ public:
     */
    bool operator!=(NamedEntity const & other) const;
 
+   /**
+    * \brief A hash of the fields that \c operator== compares exactly, so that, if \c a \c == \c b, then
+    *        \c a.fingerprint() \c == \c b.fingerprint().  (The converse does not hold, so a matching fingerprint still
+    *        needs to be confirmed with \c operator==.)  This lets \c ObjectStore::idsByFingerprint find candidate
+    *        duplicates without comparing against every stored object.
+    *
+    *        The base class contribution is the name, less any trailing " (n)" number, as per \c operator==.
+    *        Subclasses add more fields by overriding \c fingerprintFields.
+    *
+    *        The value is cached until the next property change (see \c propagatePropertyChange), which also lets
+    *        \c operator== reject most unequal objects by comparing fingerprints before it compares any fields.
+    */
+   std::size_t fingerprint() const;
+
    /**
     * \brief As you might expect, this ensures we order \b NamedEntity objects by name
     *
@@ -249,13 +266,47 @@ public:
    bool deleted() const;
    bool display() const;
    int key() const;
+
+   /**
+    * \brief Number of \c changed signals this object has emitted for its own properties (see \c emitChanged).  Only
+    *        useful for comparing with an earlier value, to find out cheaply whether the object has changed in the
+    *        meantime -- eg in \c TableModelBase, to know whether display strings cached for an object are still valid.
+    */
+   unsigned int changeCount() const;
    [[deprecated]] int getParentKey() const;
 
    /**
     * \brief Returns a regexp that will match the " (n)" (for n some positive integer) added on the end of a name to
     *        prevent name clashes.  It will also "capture" n to allow you to extract it.
     */
-   static QRegExp const & getDuplicateNameNumberMatcher();
+   static QRegularExpression const & getDuplicateNameNumberMatcher();
+
+   /**
+    * \brief Splits a name into the part before any " (n)" added to prevent name clashes, and n.  Eg
+    *        "Oatmeal Stout (2)" gives {"Oatmeal Stout", 2} and "Oatmeal Stout" gives {"Oatmeal Stout", 0}.
+    */
+   static std::pair<QString, int> splitDuplicateNameNumber(QString const & name);
+
+   /**
+    * \return The index of \c propertyName in the \c QMetaObject of \c NE, ie what \c propertyChanged will pass for
+    *         it.  Listeners will typically look this up once (eg in a function-level static) rather than on every
+    *         signal.
+    */
+   template<class NE>
+   static int propertyIndex(BtStringConst const & propertyName) {
+      int const index = NE::staticMetaObject.indexOfProperty(*propertyName);
+      Q_ASSERT(index >= 0);
+      return index;
+   }
+
+   /**
+    * \brief Emit \c propertyChanged, and \c changed if anything is listening to it, for \c propertyName with the
+    *        supplied value.  This is for the (few) places where a change needs to be notified straight away, typically
+    *        of a calculated property whose value the caller already has to hand, rather than via
+    *        \c notifyPropertyChange.  (In particular, it does not read the property, so it is safe to call from inside
+    *        the getter's own calculation.)
+    */
+   void emitChanged(BtStringConst const & propertyName, QVariant const & value) const;
 
    void setName(QString const & var);
    void setDeleted(bool const var);
@@ -405,6 +456,21 @@ signals:
     *       Otherwise, everything will silently break.
     */
    void changed(QMetaProperty, QVariant value = QVariant()) const;
+
+   /*!
+    * \brief Compact version of \c changed, emitted alongside it for every change of one of our properties.
+    *
+    *        Listeners that only need to know which property of which object changed should prefer this one: it is
+    *        just two \c int values, whereas \c changed has to copy a \c QMetaProperty and read the new value of the
+    *        property into a \c QVariant.  (We only do that work if something is connected to \c changed.)
+    *
+    * \param key The key of the object that changed -- ie \c NamedEntity::key
+    * \param propertyIndex The index of the property in the object's \c QMetaObject.  Listeners can obtain the index
+    *                      to compare against once, eg via \c NamedEntity::propertyIndex, and then compare integers
+    *                      rather than property names.
+    */
+   void propertyChanged(int key, int propertyIndex) const;
+
    void changedFolder(QString);
    void changedName(QString);
 
@@ -426,6 +492,12 @@ protected:
     */
    bool m_propagationAndSignalsEnabled = false;
 
+   //! See \c changeCount
+   mutable unsigned int m_changeCount = 0;
+
+   //! See \c fingerprint.  Cleared whenever a property changes.
+   mutable std::optional<std::size_t> m_cachedFingerprint = std::nullopt;
+
    //! The key of this entity in its table.
    int m_key;
    // This is <=0 if there is no parent (or parent is not yet known)
@@ -443,6 +515,17 @@ protected:
     */
    virtual bool isEqualTo(NamedEntity const & other) const = 0;
 
+   /**
+    * \brief Subclasses override this to mix (with \c Utils::fingerprintCombine) into \c seed those fields that their
+    *        \c isEqualTo always compares exactly.  That means no floating point fields (which are compared fuzzily)
+    *        and, for \c OutlineableNamedEntity subclasses, only fields that are compared even when one side is an
+    *        outline.  It is always safe to add fewer fields; it just means more candidates to check with
+    *        \c isEqualTo.
+    *
+    *        As with \c isEqualTo, a sub-sub-class should start from its parent's implementation.
+    */
+   virtual std::size_t fingerprintFields(std::size_t const seed) const;
+
    /**
     * \brief Subclasses need to override this function to return the appropriate instance of \c ObjectStoreTyped.
     *        This allows us in this base class to access \c ObjectStoreTyped<Hop> for \c Hop,
@@ -450,6 +533,13 @@ protected:
     */
    virtual ObjectStore & getObjectStoreTypedInstance() const = 0;
 
+   /**
+    * \brief For use in the getter of a property stored in an \c ObjectStore::LOAD_LAZILY field.  Returns
+    *        \c memberValue, unless it is null on an object that is in the DB, which means the value has not been read
+    *        yet, in which case we get it from the object store (without storing it in the object).
+    */
+   QString lazyText(BtStringConst const & propertyName, QString const & memberValue) const;
+
    // Depending on who created the bundle, the "either-or" amounts can be set either via their individual properties (eg
    // if we're reading from the database) or via their composite attributes (eg if we're reading from a BeerJSON file).
 
@@ -585,6 +675,8 @@ protected:
     * \brief Emit a "changed" signal for the supplied \c propertyName.  Usually called from \c propagatePropertyChange,
     *        but can be called directly when the property being updated is not stored in the DB (or not stored in the
     *        default way -- see eg RecipeAddition subclasses).
+    *
+    *        If a \c NamedEntityChangeBatch is open, the signal is not emitted until the batch closes.
     */
    void notifyPropertyChange(BtStringConst const & propertyName) const;
 
@@ -628,6 +720,12 @@ protected:
    }
 
 private:
+   // NamedEntityChangeBatch needs to be able to call emitChanged
+   friend class NamedEntityChangeBatch;
+
+   //! Emit a "changed" signal for the property with the given index in our QMetaObject
+   void emitChanged(int const propertyIndex) const;
+
   QString m_name;
   bool m_display;
   bool m_deleted;
@@ -659,6 +757,48 @@ private:
    NamedEntityModifyingMarker & operator=(NamedEntityModifyingMarker &&) = delete;
 };
 
+/**
+ * \class NamedEntityChangeBatch
+ *
+ * \brief RAII helper for coalescing "changed" signals from \c NamedEntity objects.
+ *
+ *        One logical edit (eg in an editor, or a change to an ingredient that makes a Recipe recalculate) can result
+ *        in the same property of the same object being set several times, and in many properties of many objects
+ *        being set.  Each of those normally emits a "changed" signal straight away, and each signal typically makes
+ *        one or more views repaint.  While a batch is open, we instead just note which properties of which objects
+ *        changed, and then, when the outermost batch is closed, emit one "changed" signal per changed property (with
+ *        its value at that point).  Changes are still written to the database straight away, as normal.
+ *
+ *        Batches can be nested.  They only have an effect on the GUI thread.
+ */
+class NamedEntityChangeBatch {
+public:
+   NamedEntityChangeBatch();
+   ~NamedEntityChangeBatch();
+
+   /**
+    * \brief Called from \c NamedEntity::notifyPropertyChange.
+    *
+    * \return \c true if a batch is open, in which case the signal for the property with index \c propertyIndex has
+    *         been deferred (and should not be emitted now); \c false if the signal should be emitted immediately.
+    */
+   static bool defer(NamedEntity const & namedEntity, int const propertyIndex);
+
+   /**
+    * \brief Called from the \c NamedEntity destructor so that we don't try to emit signals for a deleted object
+    */
+   static void forget(NamedEntity const & namedEntity);
+
+private:
+   bool const m_active;
+
+   // RAII class shouldn't be getting copied or moved
+   NamedEntityChangeBatch(NamedEntityChangeBatch const &) = delete;
+   NamedEntityChangeBatch & operator=(NamedEntityChangeBatch const &) = delete;
+   NamedEntityChangeBatch(NamedEntityChangeBatch &&) = delete;
+   NamedEntityChangeBatch & operator=(NamedEntityChangeBatch &&) = delete;
+};
+
 /**
  * \brief Convenience function for logging
  */
@@ -27,6 +27,7 @@
 
 NamedParameterBundle::NamedParameterBundle(NamedParameterBundle::OperationMode mode) :
    m_parameters{},
+   m_lookupHint{0},
    m_mode{mode},
    m_containedBundles{} {
    return;
@@ -34,10 +35,29 @@ NamedParameterBundle::NamedParameterBundle(NamedParameterBundle::OperationMode m
 
 NamedParameterBundle::~NamedParameterBundle() = default;
 
+NamedParameterBundle::NamedParameterBundle(NamedParameterBundle const &) = default;
+NamedParameterBundle::NamedParameterBundle(NamedParameterBundle &&) noexcept = default;
+NamedParameterBundle & NamedParameterBundle::operator=(NamedParameterBundle const &) = default;
+NamedParameterBundle & NamedParameterBundle::operator=(NamedParameterBundle &&) noexcept = default;
+
+QVariant const * NamedParameterBundle::find(BtStringConst const & propertyName) const {
+   char const * const key = *propertyName;
+   std::size_t const numParameters = this->m_parameters.size();
+   for (std::size_t ii = 0; ii < numParameters; ++ii) {
+      std::size_t const index = (this->m_lookupHint + ii) % numParameters;
+      if (this->m_parameters[index].first == key) {
+         this->m_lookupHint = index + 1;
+         return &this->m_parameters[index].second;
+      }
+   }
+   return nullptr;
+}
+
 void NamedParameterBundle::insert(BtStringConst const & propertyName, QVariant const & value) {
-   // std::map and std::unordered_map both need an extra set of braces on the call to insert, as we're actually passing
-   // in one parameter (std::pair) rather than two.
-   this->m_parameters.insert({QString{*propertyName}, value});
+   // As with std::map::insert, if there is already a value for this parameter, we leave it alone
+   if (!this->find(propertyName)) {
+      this->m_parameters.emplace_back(*propertyName, value);
+   }
    return;
 }
 
@@ -66,7 +86,7 @@ void NamedParameterBundle::insert(PropertyPath const & propertyPath, QVariant co
 }
 
 bool NamedParameterBundle::contains(BtStringConst const & propertyName) const {
-   return this->m_parameters.contains(*propertyName);
+   return this->find(propertyName) != nullptr;
 }
 
 bool NamedParameterBundle::contains(PropertyPath const & propertyPath) const {
@@ -105,12 +125,18 @@ std::size_t NamedParameterBundle::size() const noexcept {
    return this->m_parameters.size() + this->m_containedBundles.size();
 }
 
+void NamedParameterBundle::reserve(std::size_t numParameters) {
+   this->m_parameters.reserve(numParameters);
+   return;
+}
+
 bool NamedParameterBundle::isEmpty() const {
    return this->m_parameters.empty() && this->m_containedBundles.empty();
 }
 
 QVariant NamedParameterBundle::get(BtStringConst const & propertyName) const {
-   if (!this->m_parameters.contains(*propertyName)) {
+   QVariant const * parameter = this->find(propertyName);
+   if (!parameter) {
       QString errorMessage = QString("No value supplied for required parameter, %1.").arg(*propertyName);
       QTextStream errorMessageAsStream(&errorMessage);
       errorMessageAsStream << "  (Parameters in this bundle are ";
@@ -147,7 +173,7 @@ QVariant NamedParameterBundle::get(BtStringConst const & propertyName) const {
       qInfo() << Q_FUNC_INFO << errorMessage << ", so using generic default";
       return QVariant{};
    }
-   QVariant returnValue = this->m_parameters.at(*propertyName);
+   QVariant returnValue = *parameter;
    if (!returnValue.isValid()) {
       QString errorMessage =
          QString{"Invalid value (%1) supplied for required parameter, %2"}.arg(returnValue.toString(), *propertyName);
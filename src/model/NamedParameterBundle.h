@@ -20,6 +20,8 @@
 #include <cstddef> // for std::size_t
 #include <optional>
 #include <map>
+#include <utility>
+#include <vector>
 
 #include <QDate>
 #include <QString>
@@ -68,6 +70,12 @@ public:
    NamedParameterBundle(OperationMode mode = OperationMode::Strict);
    ~NamedParameterBundle();
 
+   //! Copy and move both OK.  (We need to declare them because declaring the destructor suppresses the implicit move.)
+   NamedParameterBundle(NamedParameterBundle const &);
+   NamedParameterBundle(NamedParameterBundle &&) noexcept;
+   NamedParameterBundle & operator=(NamedParameterBundle const &);
+   NamedParameterBundle & operator=(NamedParameterBundle &&) noexcept;
+
    void insert(BtStringConst const & propertyName, QVariant const & value);
 
    void insert(PropertyPath  const & propertyPath, QVariant const & value);
@@ -83,6 +91,12 @@ public:
 
    std::size_t size() const noexcept;
 
+   /**
+    * \brief Callers that know how many parameters they are about to insert (eg \c ObjectStore, which knows how many
+    *        columns a table has) can call this first to avoid reallocations
+    */
+   void reserve(std::size_t numParameters);
+
    bool isEmpty() const;
 
    /**
@@ -113,10 +127,11 @@ public:
    template <class T> std::optional<T> optEnumVal(BtStringConst const & propertyName) const {
       // Of course it's a coding error to request a parameter without a name!
       Q_ASSERT(!propertyName.isNull());
-      if (!this->m_parameters.contains(*propertyName)) {
+      QVariant const * parameter = this->find(propertyName);
+      if (!parameter) {
          return std::nullopt;
       }
-      auto value = this->m_parameters.at(*propertyName).value< std::optional<int> >();
+      auto value = parameter->value< std::optional<int> >();
       if (value.has_value()) {
          return std::optional<T>(static_cast<T>(value.value()));
       }
@@ -132,10 +147,11 @@ public:
    template <class T> T val(BtStringConst const & propertyName, T const & defaultValue) const {
       // Of course it's a coding error to request a parameter without a name!
       Q_ASSERT(!propertyName.isNull());
-      if (!this->m_parameters.contains(*propertyName)) {
+      QVariant const * parameter = this->find(propertyName);
+      if (!parameter) {
          return defaultValue;
       }
-      return this->m_parameters.at(*propertyName).value<T>();
+      return parameter->value<T>();
    }
 
    bool containsBundle(BtStringConst const & propertyName) const;
@@ -143,6 +159,11 @@ public:
    NamedParameterBundle const & getBundle(BtStringConst const & propertyName) const;
 
 private:
+   /**
+    * \brief Returns the value stored for \c propertyName, or \c nullptr if there isn't one
+    */
+   QVariant const * find(BtStringConst const & propertyName) const;
+
    //
    // The default choice here for look-ups would be QMap or QHash.  However, these have the undesirable attribute that
    // they always return a copy of the contained value, which we especially don't want to do for m_containedBundles.
@@ -150,13 +171,21 @@ private:
    // return objects by reference (and the references stay valid provided the entries to which they refer are not
    // removed from the map.
    //
-   // I haven't done the profiling, but, for the relatively small number of entries we're storing (a few dozen at most),
-   // I'd imagine there's not a huge overall performance difference between std::map and std::unordered_map.  We can
-   // always change it later if I'm wrong.
+   // The keys are the interned pointers held by BtStringConst (see comments in utils/BtStringConst.h), so look-ups
+   // just compare pointers, rather than having to construct a QString and compare its contents.  (We stick with
+   // std::map for m_containedBundles as it's a member of NamedParameterBundle holding NamedParameterBundle, which is
+   // still an incomplete type at this point.)
+   //
+   // For m_parameters, which is filled for every object we load from the DB or read from a file, even a hash table is
+   // more than we need.  There are at most a few dozen entries, so a flat vector, allocated in one go, is cheaper to
+   // build than a node per entry, and a scan comparing pointers is about as quick as hashing.  Constructors mostly read
+   // parameters in the same order they were inserted (ie the order of the fields in the DB or serialisation mapping),
+   // so we start each search just after the previous match, which usually means the first comparison succeeds.
    //
-   std::map<QString, QVariant> m_parameters;
+   std::vector<std::pair<char const *, QVariant>> m_parameters;
+   mutable std::size_t m_lookupHint;
    OperationMode m_mode;
-   std::map<QString, NamedParameterBundle> m_containedBundles;
+   std::map<char const *, NamedParameterBundle> m_containedBundles;
 };
 
 
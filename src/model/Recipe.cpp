@@ -24,20 +24,30 @@
  ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
 #include "model/Recipe.h"
 
+#include <array>
+#include <bitset>
 #include <cmath> // For pow/log
 #include <compare> //
+#include <optional>
+#include <tuple>
 
 #include <QDate>
 #include <QDebug>
+#include <QHash>
 #include <QInputDialog>
 #include <QList>
 #include <QObject>
+#include <QSet>
 
 #include "Algorithms.h"
 #include "config.h"
+#include "database/Database.h"
+#include "database/DbTransaction.h"
 #include "database/ObjectStoreWrapper.h"
+#include "database/RecipeCalculationCache.h"
 #include "HeatCalculations.h"
 #include "Localization.h"
+#include "Logging.h"
 #include "measurement/Amount.h"
 #include "measurement/ColorMethods.h"
 #include "measurement/IbuMethods.h"
@@ -67,10 +77,26 @@
 #include "model/Yeast.h"
 #include "PersistentSettings.h"
 #include "PhysicalConstants.h"
+#include "RecipeEvaluator.h"
 #include "utils/AutoCompare.h"
+#include "utils/Diagnostics.h"
+#include "utils/Tracing.h"
 
 namespace {
 
+   //
+   // Incremented whenever any Recipe's ancestor ID changes, which invalidates every Recipe's cached list of ancestors
+   // (because changing where one Recipe sits in a lineage changes the ancestors of all its descendants).  Recipes that
+   // have not yet built their list start with generation 0, so we start at 1.
+   //
+   unsigned int ancestryGeneration = 1;
+
+   //
+   // ID of the Recipe currently shown to the user (see Recipe::setDisplayedRecipe).  We hold the ID rather than a
+   // pointer so we never have to worry about it dangling when the Recipe is deleted.
+   //
+   int displayedRecipeId = -1;
+
    /**
     * \brief This is used to assist the creation of instructions.
     */
@@ -99,7 +125,7 @@ namespace {
          return false;
       }
 
-      qDebug() <<
+      qCDebug(Logging::recipe) <<
          Q_FUNC_INFO << var.metaObject()->className() << "#" << var.key() << "has parent #" << parentOfVar->key();
       //
       // Parameter has a parent.  See if it (the parameter, not its parent!) is used in a recipe.
@@ -119,14 +145,15 @@ namespace {
          // we had two completely unrelated shared_ptr objects (one in the object store and one newly created here)
          // pointing to the same address.  We need to get an instance of shared_ptr that's copied from (and thus
          // shares the internal reference count of) the one held by the object store.
-         qDebug() << Q_FUNC_INFO << var.metaObject()->className() << "#" << var.key() << "not used in any recipe";
+         qCDebug(Logging::recipe) <<
+            Q_FUNC_INFO << var.metaObject()->className() << "#" << var.key() << "not used in any recipe";
          return true;
       }
 
       // The var is used in another Recipe.  (We shouldn't really find ourselves in this position, but the way the rest
       // of the code works means that, even if we do, we should recover OK - or at least not make the situation any
       // worse.)
-      qWarning() <<
+      qCWarning(Logging::recipe) <<
          Q_FUNC_INFO << var.metaObject()->className() << "#" << var.key() <<
          "is unexpectedly already used in recipe #" << matchingRecipe->key();
       return false;
@@ -161,7 +188,7 @@ namespace {
          return ObjectStoreWrapper::getById<NE>(var.key());
       }
 
-      qDebug() << Q_FUNC_INFO << "Making copy of " << var.metaObject()->className() << "#" << var.key();
+      qCDebug(Logging::recipe) << Q_FUNC_INFO << "Making copy of " << var.metaObject()->className() << "#" << var.key();
 
       // We need to make a copy...
       auto copy = std::make_shared<NE>(var);
@@ -184,14 +211,6 @@ namespace {
    template<> std::shared_ptr<Salt       > copyIfNeeded(Salt        & var) = delete;
    template<> std::shared_ptr<Water      > copyIfNeeded(Water       & var) = delete;
 
-   bool isFermentableSugar(Fermentable * fermy) {
-      // TODO: This probably doesn't work in languages other than English!
-      if (fermy->type() == Fermentable::Type::Sugar && fermy->name() == "Milk Sugar (Lactose)") {
-         return false;
-      }
-
-      return true;
-   }
 }
 
 //
@@ -229,6 +248,13 @@ public:
    impl(Recipe & self) :
       m_self                 {self},
       instructionIds         {}   ,
+      m_generatedInstructions{}   ,
+      m_pendingAdditions     {}   ,
+      m_dirtyCalculations    {}   ,
+      m_calcGeneration       {0}  ,
+      m_snapshot             {}   ,
+      m_signalsConnected     {false},
+      m_ibuMemo              {}   ,
       m_ABV_pct              {0.0},
       m_color_srm            {0.0},
       m_boilGrav             {0.0},
@@ -255,24 +281,64 @@ public:
 
    /**
     * \brief Make copies of the additions of a particular type (\c RecipeAdditionHop, \c RecipeAdditionFermentable,
-    *        etc) from one \c Recipe and add them to another - typically because we are copying the \c Recipe.
+    *        etc) from one \c Recipe, to be added to this one when it is stored - typically because we are copying the
+    *        \c Recipe.
     *
     *        This also works for \c RecipeAdjustmentSalt and \c RecipeUseOfWater.
     */
    template<class RA> void copyAdditions(Recipe const & other) {
       for (RA * otherAddition : other.pimpl->allMyRaw<RA>()) {
-         std::shared_ptr<RA> ourAddition = std::make_shared<RA>(*otherAddition);
-         this->m_self.addAddition(ourAddition);
+         //
+         // Additions record which Recipe they belong to, so there's no point storing them until we know our own key.
+         // (Otherwise they'd go in the DB with an invalid recipe ID and we'd never find them again.)  So we hang on to
+         // them until setKey() is called -- or, if we are never stored, they just get thrown away with us.
+         //
+         std::get<QList<std::shared_ptr<RA>>>(this->m_pendingAdditions).append(std::make_shared<RA>(*otherAddition));
       }
       return;
    }
 
+   /**
+    * \brief Store any additions that \c copyAdditions was holding back because we didn't have a key yet.  All the
+    *        additions of a given type are written to the DB in a single transaction.
+    */
+   template<class RA> void storePendingAdditions() {
+      QList<std::shared_ptr<RA>> & pendingAdditions = std::get<QList<std::shared_ptr<RA>>>(this->m_pendingAdditions);
+      if (pendingAdditions.isEmpty()) {
+         return;
+      }
+
+      for (auto addition : pendingAdditions) {
+         addition->setRecipeId(this->m_self.key());
+      }
+      if (ObjectStoreWrapper::insertBatch(pendingAdditions).isEmpty()) {
+         // Error will already have been logged
+         qCCritical(Logging::recipe) <<
+            Q_FUNC_INFO << "Unable to store" << pendingAdditions.size() << RA::staticMetaObject.className() <<
+            "copies for Recipe #" << this->m_self.key();
+      } else {
+         //
+         // This is the tail end of Recipe::addAddition(), except that we don't ask for a recalculation.  Our calculated
+         // values are still uninitialized (see copy constructor), so they will be calculated when first needed.
+         //
+         for (auto addition : pendingAdditions) {
+            connect(addition.get(),
+                    &NamedEntity::propertyChanged,
+                    &this->m_self,
+                    &Recipe::acceptChangeToContainedObject);
+         }
+         this->m_self.notifyPropertyChange(Recipe::propertyNameFor<RA>());
+      }
+      pendingAdditions.clear();
+      return;
+   }
+
    /**
     * \brief Make copies of the Instructions from one Recipe and add them to another - typically
     *        because we are copying the Recipe.
     */
    template<class NE> void copyList(Recipe & us, Recipe const & other) {
-      qDebug() << Q_FUNC_INFO;
+      qCDebug(Logging::recipe) << Q_FUNC_INFO;
       for (int otherIngId : other.pimpl->accessIds<NE>()) {
          // Make and store a copy of the current Hop/Fermentable/etc object we're looking at in the other Recipe
          auto otherIngredient = ObjectStoreWrapper::getById<NE>(otherIngId);
@@ -280,14 +346,14 @@ public:
          // Store the ID of the copy in our recipe
          this->accessIds<NE>().append(ourIngredient->key());
 
-         qDebug() <<
+         qCDebug(Logging::recipe) <<
             Q_FUNC_INFO << "After adding" << ourIngredient->metaObject()->className() << "#" << ourIngredient->key() <<
             ", Recipe" << us.name() << "has" << this->accessIds<NE>().size() << "of" <<
             NE::staticMetaObject.className();
 
          // Connect signals so that we are notified when there are changes to the Hop/Fermentable/etc we just added to
          // our recipe.
-         connect(ourIngredient.get(), &NamedEntity::changed, &us, &Recipe::acceptChangeToContainedObject);
+         connect(ourIngredient.get(), &NamedEntity::propertyChanged, &us, &Recipe::acceptChangeToContainedObject);
       }
       return;
    }
@@ -296,9 +362,9 @@ public:
     * \brief If the Recipe is about to be deleted, we delete all the things that belong to it.
     */
    template<class NE> void hardDeleteAdditions() {
-      qDebug() << Q_FUNC_INFO;
+      qCDebug(Logging::recipe) << Q_FUNC_INFO;
       for (int id : this->allMyIds<NE>()) {
-         qDebug() << Q_FUNC_INFO << "Hard deleting" << NE::staticMetaObject.className() << "#" << id;
+         qCDebug(Logging::recipe) << Q_FUNC_INFO << "Hard deleting" << NE::staticMetaObject.className() << "#" << id;
          ObjectStoreWrapper::hardDelete<NE>(id);
       }
    }
@@ -309,7 +375,7 @@ public:
     *        of" Hops/Fermentables/etc records (which are distinguished by having a parent ID.
     */
    template<class NE> void hardDeleteAllMy() {
-      qDebug() << Q_FUNC_INFO;
+      qCDebug(Logging::recipe) << Q_FUNC_INFO;
       for (auto id : this->accessIds<NE>()) {
          ObjectStoreWrapper::hardDelete<NE>(id);
       }
@@ -319,7 +385,13 @@ public:
    template<typename T>
    T getCalculated(T & memberVariable) {
       if (this->m_self.m_uninitializedCalcs) {
-         this->m_self.recalcAll();
+         if (!this->useStoredCalculations()) {
+            this->m_self.recalcAll();
+         }
+      } else if (this->m_self.m_calcsEnabled && this->m_dirtyCalculations.any()) {
+         // Calculations deferred by Recipe::recalcIfNeeded (eg because we are not the displayed recipe) get done now
+         NamedEntityChangeBatch changeBatch;
+         this->recalcDirty();
       }
       return memberVariable;
    }
@@ -330,10 +402,7 @@ public:
     */
    template<class NE>
    QList<std::shared_ptr<NE>> allMy() const {
-      int const recipeId = this->m_self.key();
-      return ObjectStoreWrapper::findAllMatching<NE>([recipeId](std::shared_ptr<NE> ne) {
-                                                        return ne->recipeId() == recipeId;
-                                                     });
+      return ObjectStoreWrapper::findByIndex<NE>(PropertyNames::OwnedByRecipe::recipeId, this->m_self.key());
    }
 
    /**
@@ -342,10 +411,7 @@ public:
     */
    template<class NE>
    QList<NE *> allMyRaw() const {
-      int const recipeId = this->m_self.key();
-      return ObjectStoreWrapper::findAllMatching<NE>([recipeId](NE const * ne) {
-                                                        return ne->recipeId() == recipeId;
-                                                     });
+      return ObjectStoreWrapper::findByIndexRaw<NE>(PropertyNames::OwnedByRecipe::recipeId, this->m_self.key());
    }
 
    /**
@@ -354,10 +420,7 @@ public:
     */
    template<class NE>
    QVector<int> allMyIds() const {
-      int const recipeId = this->m_self.key();
-      return ObjectStoreWrapper::idsOfAllMatching<NE>([recipeId](NE const * ne) {
-                                                         return ne->recipeId() == recipeId;
-                                                      });
+      return ObjectStoreWrapper::idsByIndex<NE>(PropertyNames::OwnedByRecipe::recipeId, this->m_self.key());
    }
 
    //
@@ -393,15 +456,11 @@ public:
    template<class NE> void hardDeleteOrphanedStepOwner() {
       auto stepOwner = this->m_self.get<NE>();
       if (stepOwner && stepOwner->name() == "") {
-         qDebug() <<
+         qCDebug(Logging::recipe) <<
             Q_FUNC_INFO << "Checking whether our unnamed" << NE::staticMetaObject.className() << "is used elsewhere";
-         auto recipesUsingThisStepOwner = ObjectStoreWrapper::findAllMatching<Recipe>(
-            [stepOwner](Recipe const * rec) {
-               return rec->uses(*stepOwner);
-            }
-         );
+         auto const recipesUsingThisStepOwner = Recipe::findAllUsing(*stepOwner);
          if (1 == recipesUsingThisStepOwner.size()) {
-            qDebug() <<
+            qCDebug(Logging::recipe) <<
                Q_FUNC_INFO << "Deleting unnamed" << NE::staticMetaObject.className() << "# " << stepOwner->key() <<
                " used only by Recipe #" << this->m_self.key();
             Q_ASSERT(recipesUsingThisStepOwner.at(0)->key() == this->m_self.key());
@@ -413,49 +472,90 @@ public:
    }
 
    /**
-    * \brief Connect signals for this Recipe.  See comment for \c Recipe::connectSignalsForAllRecipes for more
-    *        explanation.
+    * \brief Connect signals for this Recipe, if this has not already been done.  See comment for
+    *        \c Recipe::connectSignalsForAllRecipes for more explanation.
+    *
+    *        Some of these objects may already have been connected (eg by \c set or \c Recipe::addAddition), hence
+    *        \c Qt::UniqueConnection.
     */
    void connectSignals() {
+      if (this->m_signalsConnected) {
+         return;
+      }
+      this->m_signalsConnected = true;
+
       auto equipment = this->m_self.equipment();
       if (equipment) {
          // We used to have special signals for changes to Equipment's boilSize_l and boilTime_min properties, but these
-         // are now picked up in Recipe::acceptChangeToContainedObject from the generic `changed` signal
-         connect(equipment.get(), &NamedEntity::changed, &this->m_self, &Recipe::acceptChangeToContainedObject);
+         // are now picked up in Recipe::acceptChangeToContainedObject from the generic `propertyChanged` signal
+         connect(equipment.get(),
+                 &NamedEntity::propertyChanged,
+                 &this->m_self,
+                 &Recipe::acceptChangeToContainedObject,
+                 Qt::UniqueConnection);
       }
 
       auto fermentableAdditions = this->m_self.fermentableAdditions();
       for (auto fermentableAddition : fermentableAdditions) {
          connect(fermentableAddition->fermentable(),
-                 &NamedEntity::changed,
+                 &NamedEntity::propertyChanged,
                  &this->m_self,
-                 &Recipe::acceptChangeToContainedObject);
+                 &Recipe::acceptChangeToContainedObject,
+                 Qt::UniqueConnection);
       }
 
       auto hopAdditions = this->m_self.hopAdditions();
       for (auto hopAddition : hopAdditions) {
          connect(hopAddition->hop(),
-                 &NamedEntity::changed,
+                 &NamedEntity::propertyChanged,
                  &this->m_self,
-                 &Recipe::acceptChangeToContainedObject);
+                 &Recipe::acceptChangeToContainedObject,
+                 Qt::UniqueConnection);
       }
 
       auto yeastAdditions = this->m_self.yeastAdditions();
       for (auto yeastAddition : yeastAdditions) {
          connect(yeastAddition->yeast(),
-                 &NamedEntity::changed,
+                 &NamedEntity::propertyChanged,
                  &this->m_self,
-                 &Recipe::acceptChangeToContainedObject);
+                 &Recipe::acceptChangeToContainedObject,
+                 Qt::UniqueConnection);
       }
 
       auto mash = this->m_self.mash();
       if (mash) {
-         connect(mash.get(), &NamedEntity::changed, &this->m_self, &Recipe::acceptChangeToContainedObject);
+         connect(mash.get(),
+                 &NamedEntity::propertyChanged,
+                 &this->m_self,
+                 &Recipe::acceptChangeToContainedObject,
+                 Qt::UniqueConnection);
       }
 
       return;
    }
 
+   /**
+    * \brief Changes to some properties of our \c Equipment need to be copied into our \c Boil.  This does that.
+    *
+    *        Normally called from \c Recipe::acceptChangeToContainedObject, but, for a \c Recipe whose signals are
+    *        not yet connected, called from the dispatcher set up in \c Recipe::connectSignalsForAllRecipes.
+    */
+   void acceptEquipmentChange(QString const & propName, QVariant const & val) {
+      if (propName == *PropertyNames::Equipment::kettleBoilSize_l) {
+         Q_ASSERT(val.canConvert<double>());
+         qCDebug(Logging::recipe) << Q_FUNC_INFO << "We" << (this->m_self.boil() ? "have" : "don't have") << "a boil";
+         if (this->m_self.boil()) {
+            this->m_self.boil()->setPreBoilSize_l(val.value<double>());
+         }
+      } else if (propName == PropertyNames::Equipment::boilTime_min) {
+         Q_ASSERT(val.canConvert<double>());
+         if (this->m_self.boil()) {
+            this->m_self.boil()->setBoilTime_mins(val.value<double>());
+         }
+      }
+      return;
+   }
+
    template<class NE>
    void set(std::shared_ptr<NE> val, int & ourId) {
       if (!val && ourId < 0) {
@@ -476,6 +576,8 @@ public:
 
       if (!val) {
          ourId = -1;
+         // Still need to store the change, not least so that the ObjectStore's index on this property stays correct
+         this->m_self.propagatePropertyChange(Recipe::propertyNameFor<NE>());
          return;
       }
 
@@ -488,11 +590,11 @@ public:
       }
 
       BtStringConst const & property = Recipe::propertyNameFor<NE>();
-      qDebug() << Q_FUNC_INFO << "Setting" << property << "to" << ourId;
+      qCDebug(Logging::recipe) << Q_FUNC_INFO << "Setting" << property << "to" << ourId;
       this->m_self.propagatePropertyChange(property);
 
-      connect(val.get(), &NamedEntity::changed, &this->m_self, &Recipe::acceptChangeToContainedObject);
-      emit this->m_self.changed(this->m_self.metaProperty(*property), QVariant::fromValue<NE *>(val.get()));
+      connect(val.get(), &NamedEntity::propertyChanged, &this->m_self, &Recipe::acceptChangeToContainedObject);
+      this->m_self.emitChanged(property, QVariant::fromValue<NE *>(val.get()));
 
       this->m_self.recalcAll();
       return;
@@ -512,14 +614,15 @@ public:
 //      qDebug() << Q_FUNC_INFO << "Recipe #" << this->m_self.key() << NE::staticMetaObject.className() << "ID" << ourId;
       if (ourId < 0) {
          // Negative ID just means there isn't one -- because this is how we store "NULL" for a foreign key
-         qDebug() << Q_FUNC_INFO << "No" << NE::staticMetaObject.className() << "on Recipe #" << this->m_self.key();
+         qCDebug(Logging::recipe) <<
+            Q_FUNC_INFO << "No" << NE::staticMetaObject.className() << "on Recipe #" << this->m_self.key();
          return nullptr;
       }
       auto retVal = ObjectStoreWrapper::getById<NE>(ourId);
       if (!retVal) {
          // I would think it's a coding error to have a seemingly valid boil/etc ID that's not in the database, but we
          // try to recover as best we can.
-         qCritical() <<
+         qCCritical(Logging::recipe) <<
             Q_FUNC_INFO << "Invalid" << NE::staticMetaObject.className() << "ID (" << ourId << ") on Recipe #" <<
             this->m_self.key();
          return nullptr;
@@ -620,7 +723,7 @@ public:
             } else if (type == RecipeAdditionMisc::Use::Secondary) {
                str = tr("Put %1 %2 into secondary for %3.");
             } else {
-               qWarning() << Q_FUNC_INFO << "Unrecognized misc use.";
+               qCWarning(Logging::recipe) << Q_FUNC_INFO << "Unrecognized misc use.";
                str = tr("Use %1 %2 for %3.");
             }
 
@@ -698,11 +801,61 @@ public:
          ins->setDirections(pi.text);
          ins->setInterval(pi.time);
 
-         m_self.add(ins);
+         this->addInstruction(ins);
       }
       return;
    }
 
+   /**
+    * \brief Called, instead of \c Recipe::add, for each instruction made by \c generateInstructions.  Adding
+    *        instructions one at a time would mean a DB insert and a rewrite of our instruction IDs for each one, so we
+    *        just collect them here for \c storeGeneratedInstructions to add all at once.
+    */
+   void addInstruction(std::shared_ptr<Instruction> instruction) {
+      this->m_generatedInstructions.append(instruction);
+      return;
+   }
+
+   /**
+    * \brief Replace our existing instructions with the ones collected by \c addInstruction, storing the new ones with
+    *        a single batch insert.  Everything, including deleting the old instructions, is done in one transaction.
+    */
+   void storeGeneratedInstructions() {
+      NamedEntityChangeBatch changeBatch;
+      Database & database = Database::instance();
+      QSqlDatabase connection = database.sqlDatabase();
+      DbTransaction dbTransaction{database,
+                                  connection,
+                                  QString("Generate %1 instructions").arg(this->m_generatedInstructions.size())};
+
+      if (!this->instructionIds.isEmpty()) {
+         this->m_self.clearInstructions();
+      }
+
+      if (!this->m_generatedInstructions.isEmpty()) {
+         if (ObjectStoreWrapper::insertBatch(this->m_generatedInstructions).isEmpty()) {
+            // Error will already have been logged
+            qCCritical(Logging::recipe) <<
+               Q_FUNC_INFO << "Unable to store" << this->m_generatedInstructions.size() <<
+               "instructions for Recipe #" << this->m_self.key();
+            this->m_generatedInstructions.clear();
+            return;
+         }
+         for (auto const & instruction : this->m_generatedInstructions) {
+            this->instructionIds.append(instruction->key());
+            connect(instruction.get(),
+                    &NamedEntity::propertyChanged,
+                    &this->m_self,
+                    &Recipe::acceptChangeToContainedObject);
+         }
+         this->m_self.propagatePropertyChange(Recipe::propertyNameFor<Instruction>());
+      }
+      this->m_generatedInstructions.clear();
+
+      dbTransaction.commit();
+      return;
+   }
+
 
    /**
     * \brief This does the logic for \c nonOptBoil, \c nonOptFermentation, etc
@@ -804,7 +957,7 @@ public:
       ins->setDirections(str);
       ins->addReagent(tmp);
 
-      this->m_self.add(ins);
+      this->addInstruction(ins);
 
       return;
    }
@@ -834,7 +987,7 @@ public:
       auto ins = std::make_shared<Instruction>();
       ins->setName(tr("Post boil"));
       ins->setDirections(str);
-      this->m_self.add(ins);
+      this->addInstruction(ins);
 
       return;
    }
@@ -853,7 +1006,7 @@ public:
       str += tr("to the mash tun.");
       ins->setDirections(str);
 
-      this->m_self.add(ins);
+      this->addInstruction(ins);
 
       return;
    }
@@ -876,7 +1029,7 @@ public:
       str += tr("for upcoming infusions.");
       ins->setDirections(str);
 
-      this->m_self.add(ins);
+      this->addInstruction(ins);
 
       return;
    }
@@ -898,7 +1051,7 @@ public:
       ins->setName(tr("First wort hopping"));
       ins->setDirections(str);
 
-      this->m_self.add(ins);
+      this->addInstruction(ins);
 
       return;
    }
@@ -928,7 +1081,7 @@ public:
       ins->setDirections(str);
       ins->addReagent(tmp);
 
-      this->m_self.add(ins);
+      this->addInstruction(ins);
 
       return;
    }
@@ -956,70 +1109,152 @@ public:
       str += QString(tr(" into the %1 water").arg(tmp));
       ins->setDirections(str);
 
-      this->m_self.add(ins);
+      this->addInstruction(ins);
 
       return;
    }
 
-   // Batch size without losses.
-   double batchSizeNoLosses_l() {
-      double ret = this->m_self.batchSize_l();
-      auto equipment = this->m_self.equipment();
-      if (equipment) {
-         ret += equipment->kettleTrubChillerLoss_l();
+   /**
+    * \brief The snapshot of this recipe that the calculation functions below work from.  This is taken on first use in
+    *        each pass of \c recalcDirty(), so all the calculations in a pass see the same inputs.
+    */
+   RecipeEvaluator::Snapshot const & snapshot() {
+      if (!this->m_snapshot) {
+         this->m_snapshot = RecipeEvaluator::snapshotOf(this->m_self);
       }
+      return *this->m_snapshot;
+   }
 
-      return ret;
+   //! \brief The current grain values, as used as inputs to \c RecipeEvaluator::volumeEstimates
+   RecipeEvaluator::Grains currentGrains() const {
+      return RecipeEvaluator::Grains{.grains_kg = this->m_grains_kg, .grainsInMash_kg = this->m_grainsInMash_kg};
+   }
+
+   //! \brief The current volume estimates, as used as inputs to the gravity, color and IBU calculations
+   RecipeEvaluator::VolumeEstimates currentVolumeEstimates() const {
+      return RecipeEvaluator::VolumeEstimates{
+         .wortFromMash_l        = this->m_wortFromMash_l       ,
+         .boilVolume_l          = this->m_boilVolume_l         ,
+         .finalVolume_l         = this->m_finalVolume_l        ,
+         .finalVolumeNoLosses_l = this->m_finalVolumeNoLosses_l,
+         .postBoilVolume_l      = this->m_postBoilVolume_l     ,
+      };
+   }
+
+   //! \brief The current gravities, as used as inputs to the ABV and calorie calculations
+   RecipeEvaluator::Gravities currentGravities() const {
+      return RecipeEvaluator::Gravities{
+         .og             = this->m_self.m_og     ,
+         .fg             = this->m_self.m_fg     ,
+         .og_fermentable = this->m_og_fermentable,
+         .fg_fermentable = this->m_fg_fermentable,
+      };
    }
 
-   //============================================== Calculation Functions ==============================================
    /**
-    * Emits changed(grains_kg), changed(grainsInMash_kg). Depends on: --.
+    * \brief IBUs for a single hop addition, reusing the previous result if none of the inputs have changed since we
+    *        last calculated it.  This saves a lot of work on recipes with lots of hop additions, as, typically, only
+    *        one of them changes at a time.
     */
-   void recalcGrains() {
-      double calculatedGrains_kg = 0.0;
-      double calculatedGrainsInMash_kg = 0.0;
+   double ibuFromHopAddition(RecipeAdditionHop const & hopAddition,
+                             RecipeEvaluator::HopAdditionInputs const & hopAdditionInputs,
+                             std::optional<RecipeEvaluator::EquipmentInputs> const & equipment,
+                             std::optional<RecipeEvaluator::BoilInputs> const & boil) {
+      IbuMemo const inputs = this->ibuMemoInputs(hopAdditionInputs, equipment, boil);
+      auto memo = this->m_ibuMemo.find(&hopAddition);
+      if (memo != this->m_ibuMemo.end() && memo->sameInputsAs(inputs)) {
+         return memo->ibus;
+      }
+
+      double const ibus = RecipeEvaluator::ibuFromHopAddition(hopAdditionInputs,
+                                                              equipment,
+                                                              boil,
+                                                              inputs.og,
+                                                              inputs.finalVolumeNoLosses_l);
+      IbuMemo newMemo{inputs};
+      newMemo.ibus = ibus;
+      this->m_ibuMemo.insert(&hopAddition, newMemo);
+      return ibus;
+   }
 
-      for (auto const & fermentableAddition : this->m_self.fermentableAdditions()) {
-         if (fermentableAddition->fermentable() &&
-             fermentableAddition->fermentable()->type() == Fermentable::Type::Grain) {
-            // I wouldn't have thought you would want to measure grain by volume, but best to check
-            if (fermentableAddition->amountIsWeight()) {
-               calculatedGrains_kg += fermentableAddition->amount().quantity;
-               if (fermentableAddition->stage() == RecipeAddition::Stage::Mash) {
-                  calculatedGrainsInMash_kg += fermentableAddition->amount().quantity;
-               }
-            } else {
-               qWarning() <<
-                  Q_FUNC_INFO << "Ignoring grain fermentable addition #" << fermentableAddition->key() << "(" <<
-                  fermentableAddition->name() << ") as measured by volume";
-            }
+   /**
+    * \brief As \c ibuFromHopAddition, but for all the hop additions in the recipe (which must line up with those in
+    *        \c snapshot).  Additions whose IBUs need recalculating are all done in one go.
+    */
+   QList<double> ibusFromHopAdditions(QList<std::shared_ptr<RecipeAdditionHop>> const & hopAdditions,
+                                      RecipeEvaluator::Snapshot const & snapshot) {
+      QList<double> ibus;
+      ibus.reserve(hopAdditions.size());
+      QVector<qsizetype> toCalculate;
+      QVector<RecipeEvaluator::HopAdditionInputs> toCalculateInputs;
+      for (qsizetype ii = 0; ii < hopAdditions.size() && ii < snapshot.hopAdditions.size(); ++ii) {
+         IbuMemo const inputs = this->ibuMemoInputs(snapshot.hopAdditions.at(ii), snapshot.equipment, snapshot.boil);
+         auto memo = this->m_ibuMemo.find(hopAdditions.at(ii).get());
+         if (memo != this->m_ibuMemo.end() && memo->sameInputsAs(inputs)) {
+            ibus.append(memo->ibus);
+         } else {
+            ibus.append(0.0);
+            toCalculate.append(ii);
+            toCalculateInputs.append(snapshot.hopAdditions.at(ii));
+         }
+      }
+
+      if (!toCalculate.isEmpty()) {
+         QVector<double> calculatedIbus(toCalculate.size());
+         RecipeEvaluator::ibusFromHopAdditions(toCalculateInputs,
+                                               snapshot.equipment,
+                                               snapshot.boil,
+                                               this->m_self.m_og,
+                                               this->m_finalVolumeNoLosses_l,
+                                               calculatedIbus);
+         for (qsizetype jj = 0; jj < toCalculate.size(); ++jj) {
+            IbuMemo newMemo = this->ibuMemoInputs(toCalculateInputs.at(jj), snapshot.equipment, snapshot.boil);
+            newMemo.ibus = calculatedIbus.at(jj);
+            this->m_ibuMemo.insert(hopAdditions.at(toCalculate.at(jj)).get(), newMemo);
+            ibus[toCalculate.at(jj)] = newMemo.ibus;
          }
       }
+      return ibus;
+   }
+
+   //============================================== Calculation Functions ==============================================
+   //
+   // The actual calculations are done in RecipeEvaluator, so that they can also be used for "what if" evaluations
+   // without modifying the Recipe.  The functions here store the results and tell listeners about whatever changed.
+   //
+
+   /**
+    * Emits changed(grains_kg), changed(grainsInMash_kg). Depends on: --.
+    */
+   bool recalcGrains() {
+      auto const grains = RecipeEvaluator::grains(this->snapshot());
+      double const calculatedGrains_kg       = grains.grains_kg;
+      double const calculatedGrainsInMash_kg = grains.grainsInMash_kg;
+      bool changed = false;
 
       if (!qFuzzyCompare(calculatedGrains_kg, this->m_grains_kg)) {
-         qDebug() <<
+         qCDebug(Logging::recipe) <<
             Q_FUNC_INFO << "Recipe #" << this->m_self.key() << "(" << this->m_self.name() << ") "
             "Calculated weight of grains: " << calculatedGrains_kg << ", stored weight: " << this->m_grains_kg;
          this->m_grains_kg = calculatedGrains_kg;
+         changed = true;
          if (!this->m_self.m_uninitializedCalcs) {
-            emit this->m_self.changed(this->m_self.metaProperty(*PropertyNames::Recipe::grains_kg),
-                                      this->m_grains_kg);
+            this->m_self.emitChanged(PropertyNames::Recipe::grains_kg, this->m_grains_kg);
          }
       }
 
       if (!qFuzzyCompare(calculatedGrainsInMash_kg, this->m_grainsInMash_kg)) {
-         qDebug() <<
+         qCDebug(Logging::recipe) <<
             Q_FUNC_INFO << "Recipe #" << this->m_self.key() << "(" << this->m_self.name() << ") "
             "Calculated weight of grains in mash: " << calculatedGrainsInMash_kg << ", stored weight: " <<
             this->m_grainsInMash_kg;
          this->m_grainsInMash_kg = calculatedGrainsInMash_kg;
+         changed = true;
          if (!this->m_self.m_uninitializedCalcs) {
-            emit this->m_self.changed(this->m_self.metaProperty(*PropertyNames::Recipe::grainsInMash_kg),
-                                      this->m_grainsInMash_kg);
+            this->m_self.emitChanged(PropertyNames::Recipe::grainsInMash_kg, this->m_grainsInMash_kg);
          }
       }
-      return;
+      return changed;
    }
 
 
@@ -1027,97 +1262,22 @@ public:
     * Emits changed(wortFromMash_l), changed(boilVolume_l), changed(finalVolume_l), changed(postBoilVolume_l).
     * Depends on: m_grainsInMash_kg
     */
-   void recalcVolumeEstimates() {
-      double tmp = 0.0;
-      double calculatedWortFromMash_l = 0.0;
-      double calculatedBoilVolume_l = 0.0;
-      double calculatedFinalVolume_l = 0.0;
-      double calculatedPostBoilVolume_l = 0.0;
-
-      auto equipment = this->m_self.equipment();
-
-      // wortFromMash_l ==========================
-      if (!this->m_self.mash()) {
-         this->m_wortFromMash_l = 0.0;
-      } else {
-         double waterAdded_l = this->m_self.mash()->totalMashWater_l();
-         double absorption_lKg;
-         if (equipment) {
-            absorption_lKg = equipment->mashTunGrainAbsorption_LKg().value_or(Equipment::default_mashTunGrainAbsorption_LKg);
-         } else {
-            absorption_lKg = PhysicalConstants::grainAbsorption_Lkg;
-         }
-
-         calculatedWortFromMash_l = (waterAdded_l - absorption_lKg * this->m_grainsInMash_kg);
-      }
-
-      // boilVolume_l ==============================
-
-      if (equipment) {
-         tmp = calculatedWortFromMash_l - equipment->getLauteringDeadspaceLoss_l() + equipment->topUpKettle_l().value_or(Equipment::default_topUpKettle_l);
-      } else {
-         tmp = calculatedWortFromMash_l;
-      }
-
-      // .:TODO:. Assumptions below about liquids are almost certainly wrong, also TBD what other cases we have to cover
-      // Need to account for extract/sugar volume also.
-      for (auto const & fermentableAddition : this->m_self.fermentableAdditions()) {
-         auto const & fermentable = fermentableAddition->fermentable();
-         switch (fermentable->type()) {
-            case Fermentable::Type::Extract:
-               if (fermentableAddition->amountIsWeight()) {
-                  tmp += fermentableAddition->amount().quantity / PhysicalConstants::liquidExtractDensity_kgL;
-               } else {
-                  tmp += fermentableAddition->amount().quantity;
-               }
-               break;
-            case Fermentable::Type::Sugar:
-               if (fermentableAddition->amountIsWeight()) {
-                  tmp += fermentableAddition->amount().quantity / PhysicalConstants::sucroseDensity_kgL;
-               } else {
-                  tmp += fermentableAddition->amount().quantity;
-               }
-               break;
-            case Fermentable::Type::Dry_Extract:
-               if (fermentableAddition->amountIsWeight()) {
-                  tmp += fermentableAddition->amount().quantity / PhysicalConstants::dryExtractDensity_kgL;
-               } else {
-                  tmp += fermentableAddition->amount().quantity;
-               }
-               break;
-         }
-      }
-
-      if (tmp <= 0.0) {
-         // Give up.
-         tmp = this->boilSizeInLitersOr(0.0);
-      }
-
-      calculatedBoilVolume_l = tmp;
-
-      // finalVolume_l ==============================
-
-      // NOTE: the following figure is not based on the other volume estimates
-      // since we want to show og,fg,ibus,etc. as if the collected wort is correct.
-      this->m_finalVolumeNoLosses_l = this->batchSizeNoLosses_l();
-      if (equipment) {
-         //_finalVolumeNoLosses_l = equipment->wortEndOfBoil_l(calculatedBoilVolume_l) + equipment->topUpWater_l();
-         calculatedFinalVolume_l =
-            equipment->wortEndOfBoil_l(calculatedBoilVolume_l) +
-            equipment->topUpWater_l().value_or(Equipment::default_topUpWater_l) -
-            equipment->kettleTrubChillerLoss_l();
-      } else {
-         this->m_finalVolume_l = calculatedBoilVolume_l - 4.0; // This is just shooting in the dark. Can't do much without an equipment.
-         //_finalVolumeNoLosses_l = _finalVolume_l;
-      }
-
-      // postBoilVolume_l ===========================
-
-      if (equipment) {
-         calculatedPostBoilVolume_l = equipment->wortEndOfBoil_l(calculatedBoilVolume_l);
-      } else {
-         calculatedPostBoilVolume_l = this->m_self.batchSize_l(); // Give up.
-      }
+   bool recalcVolumeEstimates() {
+      // Several member variables get set below, not always via the comparisons that emit signals, so the simplest way
+      // to tell our caller whether anything changed is to compare before and after.
+      double const oldWortFromMash_l        = this->m_wortFromMash_l;
+      double const oldBoilVolume_l          = this->m_boilVolume_l;
+      double const oldFinalVolume_l         = this->m_finalVolume_l;
+      double const oldFinalVolumeNoLosses_l = this->m_finalVolumeNoLosses_l;
+      double const oldPostBoilVolume_l      = this->m_postBoilVolume_l;
+
+      auto const volumes = RecipeEvaluator::volumeEstimates(this->snapshot(), this->currentGrains());
+      double const calculatedWortFromMash_l   = volumes.wortFromMash_l;
+      double const calculatedBoilVolume_l     = volumes.boilVolume_l;
+      double const calculatedFinalVolume_l    = volumes.finalVolume_l;
+      double const calculatedPostBoilVolume_l = volumes.postBoilVolume_l;
+
+      this->m_finalVolumeNoLosses_l = volumes.finalVolumeNoLosses_l;
 
       if (!qFuzzyCompare(calculatedWortFromMash_l, this->m_wortFromMash_l)) {
 //         qDebug() <<
@@ -1125,8 +1285,7 @@ public:
 //            "Calculated wort from mash: " << calculatedWortFromMash_l << ", stored: " << this->m_wortFromMash_l;
          this->m_wortFromMash_l = calculatedWortFromMash_l;
          if (!this->m_self.m_uninitializedCalcs) {
-            emit this->m_self.changed(this->m_self.metaProperty(*PropertyNames::Recipe::wortFromMash_l),
-                                      this->m_wortFromMash_l);
+            this->m_self.emitChanged(PropertyNames::Recipe::wortFromMash_l, this->m_wortFromMash_l);
          }
       }
 
@@ -1137,8 +1296,7 @@ public:
 //            "Calculated boil volume: " << calculatedBoilVolume_l << ", stored: " << this->m_boilVolume_l;
          this->m_boilVolume_l = calculatedBoilVolume_l;
          if (!this->m_self.m_uninitializedCalcs) {
-            emit this->m_self.changed(this->m_self.metaProperty(*PropertyNames::Recipe::boilVolume_l),
-                                      this->m_boilVolume_l);
+            this->m_self.emitChanged(PropertyNames::Recipe::boilVolume_l, this->m_boilVolume_l);
          }
       }
 
@@ -1148,77 +1306,73 @@ public:
 //            "Calculated final volume: " << calculatedFinalVolume_l << ", stored: " << this->m_finalVolume_l;
          this->m_finalVolume_l = calculatedFinalVolume_l;
          if (!this->m_self.m_uninitializedCalcs) {
-            emit this->m_self.changed(this->m_self.metaProperty(*PropertyNames::Recipe::finalVolume_l),
-                                      this->m_finalVolume_l);
+            this->m_self.emitChanged(PropertyNames::Recipe::finalVolume_l, this->m_finalVolume_l);
          }
       }
 
       if (! qFuzzyCompare(calculatedPostBoilVolume_l, this->m_postBoilVolume_l)) {
-         qDebug() <<
+         qCDebug(Logging::recipe) <<
             Q_FUNC_INFO << "Recipe #" << this->m_self.key() << "(" << this->m_self.name() << ") "
             "Calculated post boil volume: " << calculatedPostBoilVolume_l << ", stored: " << this->m_postBoilVolume_l;
          this->m_postBoilVolume_l = calculatedPostBoilVolume_l;
          if (!this->m_self.m_uninitializedCalcs) {
-            emit this->m_self.changed(this->m_self.metaProperty(*PropertyNames::Recipe::postBoilVolume_l),
-                                      this->m_postBoilVolume_l);
+            this->m_self.emitChanged(PropertyNames::Recipe::postBoilVolume_l, this->m_postBoilVolume_l);
          }
       }
-      return;
+      return oldWortFromMash_l        != this->m_wortFromMash_l        ||
+             oldBoilVolume_l          != this->m_boilVolume_l          ||
+             oldFinalVolume_l         != this->m_finalVolume_l         ||
+             oldFinalVolumeNoLosses_l != this->m_finalVolumeNoLosses_l ||
+             oldPostBoilVolume_l      != this->m_postBoilVolume_l;
    }
 
    /**
     * Emits changed(color_srm). Depends on: m_finalVolume_l
     */
-   void recalcColor_srm() {
-      double mcu = 0.0;
-
-      for (auto const & fermentableAddition : this->m_self.fermentableAdditions()) {
-         if (fermentableAddition->amountIsWeight()) {
-            // Conversion factor for lb/gal to kg/l = 8.34538.
-            mcu += fermentableAddition->fermentable()->color_srm() * 8.34538 * fermentableAddition->amount().quantity / m_finalVolumeNoLosses_l;
-         } else {
-            // .:TBD:. What do do about liquids
-            qWarning() <<
-               Q_FUNC_INFO << "Unimplemented branch for handling color of liquid fermentables - #" <<
-               fermentableAddition->fermentable()->key() << ":" << fermentableAddition->name();
-         }
-      }
-
-      double calculatedColor_srm = ColorMethods::mcuToSrm(mcu);
+   bool recalcColor_srm() {
+      bool changed = false;
+      double const calculatedColor_srm = RecipeEvaluator::color_srm(this->snapshot(), this->currentVolumeEstimates());
       if (!qFuzzyCompare(this->m_color_srm, calculatedColor_srm)) {
 //         qDebug() <<
 //            Q_FUNC_INFO << "Recipe #" << this->m_self.key() << "(" << this->m_self.name() << ") "
 //            "Calculated color: " << calculatedColor_srm << ", stored: " << this->m_color_srm;
          this->m_color_srm = calculatedColor_srm;
+         changed = true;
          if (!this->m_self.m_uninitializedCalcs) {
-            emit this->m_self.changed(this->m_self.metaProperty(*PropertyNames::Recipe::color_srm), this->m_color_srm);
+            this->m_self.emitChanged(PropertyNames::Recipe::color_srm, this->m_color_srm);
          }
       }
 
-      return;
+      return changed;
    }
 
    /**
     * Emits changed(SRMColor). Depends on: m_color_srm.
     */
-   void recalcSRMColor() {
+   bool recalcSRMColor() {
+      bool changed = false;
       QColor calculatedSRMColor = Algorithms::srmToColor(this->m_color_srm);
       if (calculatedSRMColor != this->m_SRMColor) {
          this->m_SRMColor = calculatedSRMColor;
+         changed = true;
          if (!this->m_self.m_uninitializedCalcs) {
-            emit this->m_self.changed(this->m_self.metaProperty(*PropertyNames::Recipe::SRMColor), this->m_SRMColor);
+            this->m_self.emitChanged(PropertyNames::Recipe::SRMColor, this->m_SRMColor);
          }
       }
-      return;
+      return changed;
    }
 
    /**
     * Emits changed(og), changed(fg).
     * Depends on: m_wortFromMash_l, m_finalVolume_l
     */
-   void recalcOgFg() {
-
-      this->m_og_fermentable = this->m_fg_fermentable = 0.0;
+   bool recalcOgFg() {
+      // As in recalcVolumeEstimates(), we need to tell our caller whether anything our dependents use has changed,
+      // which includes m_og_fermentable and m_fg_fermentable as well as m_og and m_fg.
+      double const oldOg            = this->m_self.m_og;
+      double const oldFg            = this->m_self.m_fg;
+      double const oldOgFermentable = this->m_og_fermentable;
+      double const oldFgFermentable = this->m_fg_fermentable;
 
       // The first time through really has to get the m_og and m_fg from the
       // database, not use the initialized values of 1. I (maf) tried putting
@@ -1233,91 +1387,14 @@ public:
          this->m_self.m_fg = Localization::toDouble(this->m_self, PropertyNames::Recipe::fg, Q_FUNC_INFO);
       }
 
-      // Find out how much sugar we have.
-      auto const sugars = this->m_self.calcTotalPoints();
-      double sugar_kg                  = sugars.sugar_kg;  // Mass of sugar that *is* affected by mash efficiency
-      double sugar_kg_ignoreEfficiency = sugars.sugar_kg_ignoreEfficiency;  // Mass of sugar that *is not* affected by mash efficiency
-      double nonFermentableSugars_kg   = sugars.nonFermentableSugars_kg;  // Mass of sugar that is not fermentable (also counted in sugar_kg_ignoreEfficiency)
-
-      // Uncomment for diagnosing problems with calculations
-//      qDebug() <<
-//         Q_FUNC_INFO << "Recipe #" << this->m_self.key() << "(" << this->m_self.name() << ") "
-//         "sugar_kg: " << sugar_kg << ", sugar_kg_ignoreEfficiency: " << sugar_kg_ignoreEfficiency <<
-//         ", nonFermentableSugars_kg:" << nonFermentableSugars_kg;
-
-      // We might lose some sugar in the form of Trub/Chiller loss and lauter deadspace.
-      auto equipment = this->m_self.equipment();
-      if (equipment) {
-         double const kettleWort_l = (this->m_wortFromMash_l - equipment->getLauteringDeadspaceLoss_l()) +
-                                     equipment->topUpKettle_l().value_or(Equipment::default_topUpKettle_l);
-         double const postBoilWort_l = equipment->wortEndOfBoil_l(kettleWort_l);
-         double ratio = (postBoilWort_l - equipment->kettleTrubChillerLoss_l()) / postBoilWort_l;
-         if (ratio > 1.0) { // Usually happens when we don't have a mash yet.
-            ratio = 1.0;
-         } else if (ratio < 0.0) {
-            ratio = 0.0;
-         } else if (Algorithms::isNan(ratio)) {
-            ratio = 1.0;
-         }
-         // Ignore this again since it should be included in efficiency.
-         //sugar_kg *= ratio;
-         sugar_kg_ignoreEfficiency *= ratio;
-         if (nonFermentableSugars_kg != 0.0) {
-            nonFermentableSugars_kg *= ratio;
-         }
-      }
-
-      // Total sugars after accounting for efficiency and mash losses. Implicitly includes non-fermentable sugars
-      sugar_kg = sugar_kg * this->m_self.efficiency_pct() / 100.0 + sugar_kg_ignoreEfficiency;
-      double plato = Algorithms::getPlato(sugar_kg, this->m_finalVolumeNoLosses_l);
-
-      double calculatedOg = Algorithms::PlatoToSG_20C20C(plato);    // og from all sugars
-      double tmp_pnts = (calculatedOg - 1) * 1000.0; // points from all sugars
-      double tmp_nonferm_pnts;
-      if (nonFermentableSugars_kg != 0.0) {
-         double ferm_kg = sugar_kg - nonFermentableSugars_kg;  // Mass of only fermentable sugars
-         plato = Algorithms::getPlato(ferm_kg, this->m_finalVolumeNoLosses_l);   // Plato from fermentable sugars
-         this->m_og_fermentable = Algorithms::PlatoToSG_20C20C(plato);    // og from only fermentable sugars
-         plato = Algorithms::getPlato(nonFermentableSugars_kg, this->m_finalVolumeNoLosses_l);   // Plate from non-fermentable sugars
-         tmp_nonferm_pnts = ((Algorithms::PlatoToSG_20C20C(plato)) - 1) * 1000.0; // og points from non-fermentable sugars
-      } else {
-         this->m_og_fermentable = calculatedOg;
-         tmp_nonferm_pnts = 0.0;
-      }
-
-      // Calculage FG
-      double attenuation_pct = 0.0;
-      for (auto yeastAddition : this->m_self.yeastAdditions()) {
-         // Get the yeast with the greatest attenuation.
-         if (yeastAddition->attenuation_pct() > attenuation_pct) {
-            attenuation_pct = yeastAddition->yeast()->attenuationTypical_pct();
-         }
-      }
-      // This means we have yeast, but they neglected to provide attenuation percentages.
-      if (this->m_self.yeastAdditions().size() > 0 && attenuation_pct <= 0.0)  {
-         attenuation_pct = Yeast::DefaultAttenuation_pct; // Use an average attenuation.
-      }
-
-      double calculatedFg;
-      if (nonFermentableSugars_kg != 0.0) {
-         double tmp_ferm_pnts = (tmp_pnts - tmp_nonferm_pnts) * (1.0 - attenuation_pct / 100.0); // fg points from fermentable sugars
-         tmp_pnts = tmp_ferm_pnts + tmp_nonferm_pnts;  // FG points from both fermentable and non-fermentable sugars
-         //tmp_pnts *= (1.0 - attenuation_pct/100.0);  // WTF, this completely ignores all the calculations about non-fermentable sugars and just converts everything!
-         calculatedFg =  1 + tmp_pnts / 1000.0; // new FG value
-         this->m_fg_fermentable =  1 + tmp_ferm_pnts / 1000.0; // FG from fermentables only
-      } else {
-         tmp_pnts *= (1.0 - attenuation_pct / 100.0);
-         calculatedFg =  1 + tmp_pnts / 1000.0;
-         this->m_fg_fermentable = calculatedFg;
-      }
-
-      // Uncomment for diagnosing problems with calculations
-//      qDebug() <<
-//         Q_FUNC_INFO << "Recipe #" << this->m_self.key() << "(" << this->m_self.name() << ") "
-//         "m_og_fermentable: " << m_og_fermentable << ", m_fg_fermentable: " << m_fg_fermentable;
+      auto const gravities = RecipeEvaluator::gravities(this->snapshot(), this->currentVolumeEstimates());
+      double const calculatedOg = gravities.og;
+      double const calculatedFg = gravities.fg;
+      this->m_og_fermentable = gravities.og_fermentable;
+      this->m_fg_fermentable = gravities.fg_fermentable;
 
       if (!qFuzzyCompare(this->m_self.m_og, calculatedOg)) {
-         qDebug() <<
+         qCDebug(Logging::recipe) <<
             Q_FUNC_INFO << "Recipe #" << this->m_self.key() << "(" << this->m_self.name() << ") "
             "Calculated OG: " << calculatedOg << ", stored: " << this->m_self.m_og;
          this->m_self.m_og = calculatedOg;
@@ -1331,183 +1408,460 @@ public:
          // these functions in the first place.
          if (!this->m_self.m_uninitializedCalcs) {
             this->m_self.propagatePropertyChange(PropertyNames::Recipe::og, false);
-            emit this->m_self.changed(this->m_self.metaProperty(*PropertyNames::Recipe::og    ), this->m_self.m_og);
-            emit this->m_self.changed(this->m_self.metaProperty(*PropertyNames::Recipe::points), (this->m_self.m_og - 1.0) * 1e3);
+            this->m_self.emitChanged(PropertyNames::Recipe::og, this->m_self.m_og);
+            this->m_self.emitChanged(PropertyNames::Recipe::points, (this->m_self.m_og - 1.0) * 1e3);
          }
       }
 
       if (!qFuzzyCompare(this->m_self.m_fg, calculatedFg)) {
-         qDebug() <<
+         qCDebug(Logging::recipe) <<
             Q_FUNC_INFO << "Recipe #" << this->m_self.key() << "(" << this->m_self.name() << ") "
             "Calculated FG: " << calculatedFg << ", stored: " << this->m_self.m_fg;
          this->m_self.m_fg = calculatedFg;
          if (!this->m_self.m_uninitializedCalcs) {
             this->m_self.propagatePropertyChange(PropertyNames::Recipe::fg, false);
-            emit this->m_self.changed(this->m_self.metaProperty(*PropertyNames::Recipe::fg), this->m_self.m_fg);
+            this->m_self.emitChanged(PropertyNames::Recipe::fg, this->m_self.m_fg);
          }
       }
-      return;
+      return oldOg            != this->m_self.m_og      ||
+             oldFg            != this->m_self.m_fg      ||
+             oldOgFermentable != this->m_og_fermentable ||
+             oldFgFermentable != this->m_fg_fermentable;
    }
 
 
    /**
     * Emits changed(ABV_pct). Depends on: m_og, m_fg
     */
-   void recalcABV_pct() {
-      // The complex formula, and variations comes from Ritchie Products Ltd, (Zymurgy, Summer 1995, vol. 18, no. 2)
-      // Michael L. Hall’s article Brew by the Numbers: Add Up What’s in Your Beer, and Designing Great Beers by Daniels.
-      double calculatedABV_pct =
-         (76.08 * (this->m_og_fermentable - this->m_fg_fermentable) / (1.775 - this->m_og_fermentable)) *
-         (this->m_fg_fermentable / 0.794);
+   bool recalcABV_pct() {
+      bool changed = false;
+      double const calculatedABV_pct = RecipeEvaluator::ABV_pct(this->currentGravities());
 
       if (!qFuzzyCompare(calculatedABV_pct, m_ABV_pct)) {
-         qDebug() <<
+         qCDebug(Logging::recipe) <<
             Q_FUNC_INFO << "Recipe #" << this->m_self.key() << "(" << this->m_self.name() << ") "
             "Calculated ABV: " << calculatedABV_pct << ", stored: " << this->m_ABV_pct;
          this->m_ABV_pct = calculatedABV_pct;
+         changed = true;
          if (!this->m_self.m_uninitializedCalcs) {
-            emit this->m_self.changed(this->m_self.metaProperty(*PropertyNames::Recipe::ABV_pct), this->m_ABV_pct);
+            this->m_self.emitChanged(PropertyNames::Recipe::ABV_pct, this->m_ABV_pct);
          }
       }
-      return;
+      return changed;
    }
 
    /**
     * Emits changed(boilGrav). Depends on: _postBoilVolume_l, _boilVolume_l
     */
-   void recalcBoilGrav() {
-      auto const sugars = this->m_self.calcTotalPoints();
-      double sugar_kg                  = sugars.sugar_kg;
-      double sugar_kg_ignoreEfficiency = sugars.sugar_kg_ignoreEfficiency;
-      double lateAddition_kg           = sugars.lateAddition_kg;
-      double lateAddition_kg_ignoreEff = sugars.lateAddition_kg_ignoreEff;
-
-      // Since the efficiency refers to how much sugar we get into the fermenter,
-      // we need to adjust for that here.
-      sugar_kg = (this->m_self.efficiency_pct() / 100.0 * (sugar_kg - lateAddition_kg) + sugar_kg_ignoreEfficiency -
-                  lateAddition_kg_ignoreEff);
-
-      double calculatedBoilGrav = Algorithms::PlatoToSG_20C20C(Algorithms::getPlato(sugar_kg,
-                                                                                    this->boilSizeInLitersOr(0.0)));
+   bool recalcBoilGrav() {
+      bool changed = false;
+      double const calculatedBoilGrav = RecipeEvaluator::boilGrav(this->snapshot());
       if (! qFuzzyCompare(calculatedBoilGrav, this->m_boilGrav)) {
-         qDebug() <<
+         qCDebug(Logging::recipe) <<
             Q_FUNC_INFO << "Recipe #" << this->m_self.key() << "(" << this->m_self.name() << ") "
             "Calculated Boil Grav: " << calculatedBoilGrav << ", stored: " << this->m_boilGrav;
          this->m_boilGrav = calculatedBoilGrav;
+         changed = true;
          if (!this->m_self.m_uninitializedCalcs) {
-            emit this->m_self.changed(this->m_self.metaProperty(*PropertyNames::Recipe::boilGrav), this->m_boilGrav);
+            this->m_self.emitChanged(PropertyNames::Recipe::boilGrav, this->m_boilGrav);
          }
       }
-      return;
+      return changed;
    }
 
    /**
-    * Emits changed(IBU). Depends on: _batchSize_l, _boilGrav, _boilVolume_l, _finalVolume_l
+    * Emits changed(IBU). Depends on: batchSize_l, m_og, m_finalVolumeNoLosses_l, equipment, boil
     */
-   void recalcIBU() {
+   bool recalcIBU() {
+      bool changed = false;
       double calculatedIbu = 0.0;
 
       // Bitterness due to hops...
-      //
-      // Note that, normally, we don't want to take a reference to a smart pointer.  However, in this context, it's safe
-      // (because the hop additions aren't going to change while we look at them) and it gets rid of a compiler warning.
-      this->m_ibus.clear();
-      for (auto const & hopAddition : this->m_self.hopAdditions()) {
-         double tmp = this->m_self.ibuFromHopAddition(*hopAddition);
-         this->m_ibus.append(tmp);
-         calculatedIbu += tmp;
+      auto const & snapshot = this->snapshot();
+      auto const hopAdditions = this->m_self.hopAdditions();
+      // The snapshot was taken from the same list of hop additions, so they should line up
+      Q_ASSERT(hopAdditions.size() == snapshot.hopAdditions.size());
+      this->m_ibus = this->ibusFromHopAdditions(hopAdditions, snapshot);
+      for (double const ibus : this->m_ibus) {
+         calculatedIbu += ibus;
+      }
+
+      // Don't hang on to memoized results for additions that are no longer in the recipe
+      if (this->m_ibuMemo.size() > hopAdditions.size()) {
+         QSet<RecipeAdditionHop const *> currentAdditions;
+         for (auto const & hopAddition : hopAdditions) {
+            currentAdditions.insert(hopAddition.get());
+         }
+         for (auto memo = this->m_ibuMemo.begin(); memo != this->m_ibuMemo.end(); ) {
+            if (currentAdditions.contains(memo.key())) {
+               ++memo;
+            } else {
+               memo = this->m_ibuMemo.erase(memo);
+            }
+         }
       }
 
       // Bitterness due to hopped extracts...
-      for (auto const & fermentableAddition : this->m_self.fermentableAdditions()) {
-         if (fermentableAddition->amountIsWeight()) {
-            // Conversion factor for lb/gal to kg/l = 8.34538.
-            calculatedIbu += fermentableAddition->fermentable()->ibuGalPerLb().value_or(0.0) * (fermentableAddition->amount().quantity / this->m_self.batchSize_l()) / 8.34538;
-         } else {
-            // .:TBD:. What do do about liquids
-            qWarning() <<
-               Q_FUNC_INFO << "Unimplemented branch for handling IBU of liquid fermentables - #" <<
-               fermentableAddition->fermentable()->key() << ":" << fermentableAddition->name();
-         }
-      }
+      calculatedIbu += RecipeEvaluator::hoppedExtractIbus(snapshot);
 
       if (! qFuzzyCompare(calculatedIbu, this->m_IBU)) {
-         qDebug() <<
+         qCDebug(Logging::recipe) <<
             Q_FUNC_INFO << "Recipe #" << this->m_self.key() << "(" << this->m_self.name() << ") "
             "Calculated IBU: " << calculatedIbu << ", stored: " << this->m_IBU;
          this->m_IBU = calculatedIbu;
+         changed = true;
          if (!this->m_self.m_uninitializedCalcs) {
-            emit this->m_self.changed(this->m_self.metaProperty(*PropertyNames::Recipe::IBU), this->m_IBU);
+            this->m_self.emitChanged(PropertyNames::Recipe::IBU, this->m_IBU);
          }
       }
 
-      return;
+      return changed;
    }
 
    /**
     * Emits changed(calories). Depends on: m_og, m_fg.
     */
-   void recalcCalories() {
-      //
-      // The Journal of the Institute of Brewing (JIB) is published by the Institute of Brewing and Distilling.
-      // On pages 320-321 of Volume 88 of the JIB, dated "September - October 1982", there is an article on "Calculation of
-      // Calorific Value of Beer" submitted by P A Martin on behalf of the IOB (Institute of Brewing) Analysis Committee.
-      //
-      // The article discusses four methods for calculating the calories in beer, and, in summary, recommends calculating
-      // Calories/100ml as follows:
-      //    1.1 Estimate the alcohol content of the beer ... [and] convert ... to alcohol g/100ml
-      //    1.2 Estimate total carbohydrate of the beer (g/100ml as glucose) ...
-      //    1.3 Estimate protein content of the beer (g/100ml)
-      //    2.1 Calories/100ml = [alcohol (g/100ml) × 7] +
-      //                         [total carbohydrate (as glucose g/100ml) × 3.75] +
-      //                         [protein (g/100ml) × 4]
-      //    2.2 In a collaborative trial the precision of the method was ±2.02 Calories for highly attenuated beers and
-      //        ±3.06 Calories for normally fermented products.
-      //
-      // We should come back to this at some point...
+   bool recalcCalories() {
+      bool changed = false;
+      double const calculatedCaloriesPerLiter = RecipeEvaluator::caloriesPerLiter(this->currentGravities());
+
+      if (!qFuzzyCompare(calculatedCaloriesPerLiter, this->m_caloriesPerLiter)) {
+         qCDebug(Logging::recipe) <<
+            Q_FUNC_INFO << "Recipe #" << this->m_self.key() << "(" << this->m_self.name() << ") "
+            "Calculated calories/liter: " << calculatedCaloriesPerLiter << ", stored: " << this->m_caloriesPerLiter;
+         this->m_caloriesPerLiter = calculatedCaloriesPerLiter;
+         changed = true;
+         if (!this->m_self.m_uninitializedCalcs) {
+            this->m_self.emitChanged(PropertyNames::Recipe::caloriesPerLiter, this->m_caloriesPerLiter);
+         }
+      }
+      return changed;
+   }
+
+
+   //================================================ Dependency graph =================================================
+   /**
+    * \brief The groups of calculated properties, each of which is (re)calculated by one of the functions above.  These
+    *        are listed in dependency order, ie each calculation only depends on ones listed before it (plus inputs such
+    *        as batch size, efficiency, ingredient additions, equipment, etc).  This means that, in \c recalcDirty(), we
+    *        can just go through them in order.
+    */
+   enum class Calculation {
+      Grains         ,
+      VolumeEstimates,
+      Color_srm      ,
+      SRMColor       ,
+      OgFg           ,
+      ABV_pct        ,
+      BoilGrav       ,
+      IBU            ,
+      Calories       ,
+   };
+   static constexpr std::size_t numCalculations = static_cast<std::size_t>(Calculation::Calories) + 1;
+
+   /**
+    * \brief The calculations that directly use the results of the supplied one, and so need redoing if those results
+    *        change.
+    */
+   static std::initializer_list<Calculation> dependentsOf(Calculation const calculation) {
+      switch (calculation) {
+         case Calculation::Grains         : return {Calculation::VolumeEstimates};
+         case Calculation::VolumeEstimates: return {Calculation::Color_srm, Calculation::OgFg, Calculation::IBU};
+         case Calculation::Color_srm      : return {Calculation::SRMColor};
+         case Calculation::SRMColor       : return {};
+         case Calculation::OgFg           : return {Calculation::ABV_pct, Calculation::IBU, Calculation::Calories};
+         case Calculation::ABV_pct        : return {};
+         case Calculation::BoilGrav       : return {};
+         case Calculation::IBU            : return {};
+         case Calculation::Calories       : return {};
+         // No default case needed as compiler should warn us if any options covered above
+      }
+      // It's a coding error if we get here
+      Q_ASSERT(false);
+      return {};
+   }
+
+   /**
+    * \brief Run the function for the supplied calculation
+    *
+    * \return \c true if any of the calculated values changed, \c false otherwise
+    */
+   bool recalc(Calculation const calculation) {
+      // Span names for tracing, and stage names for diagnostics, indexed by Calculation
+      static constexpr std::array<char const *, numCalculations> stageNames{
+         "Recipe::recalcGrains"         ,
+         "Recipe::recalcVolumeEstimates",
+         "Recipe::recalcColor_srm"      ,
+         "Recipe::recalcSRMColor"       ,
+         "Recipe::recalcOgFg"           ,
+         "Recipe::recalcABV_pct"        ,
+         "Recipe::recalcBoilGrav"       ,
+         "Recipe::recalcIBU"            ,
+         "Recipe::recalcCalories"       ,
+      };
+      char const * const stageName = stageNames[static_cast<std::size_t>(calculation)];
+      Tracing::Span span{stageName};
+      Diagnostics::ScopedRecalcTimer recalcTimer{stageName};
+      switch (calculation) {
+         case Calculation::Grains         : return this->recalcGrains();
+         case Calculation::VolumeEstimates: return this->recalcVolumeEstimates();
+         case Calculation::Color_srm      : return this->recalcColor_srm();
+         case Calculation::SRMColor       : return this->recalcSRMColor();
+         case Calculation::OgFg           : return this->recalcOgFg();
+         case Calculation::ABV_pct        : return this->recalcABV_pct();
+         case Calculation::BoilGrav       : return this->recalcBoilGrav();
+         case Calculation::IBU            : return this->recalcIBU();
+         case Calculation::Calories       : return this->recalcCalories();
+         // No default case needed as compiler should warn us if any options covered above
+      }
+      // It's a coding error if we get here
+      Q_ASSERT(false);
+      return false;
+   }
+
+   /**
+    * \brief Note that the supplied calculations need redoing because one of their inputs changed.  (There's no need to
+    *        mark their dependents, as \c recalcDirty() will work out which of those need redoing.)
+    */
+   void markDirty(std::initializer_list<Calculation> const calculations) {
+      for (auto const calculation : calculations) {
+         this->m_dirtyCalculations.set(static_cast<std::size_t>(calculation));
+      }
+      return;
+   }
+
+   void markAllDirty() {
+      this->m_dirtyCalculations.set();
+      return;
+   }
+
+   /**
+    * \brief Redo all the calculations that have been marked dirty, and any that depend on results that actually change
+    *        as a result.  Since each calculation only emits \c changed() for values that move, editing, say, a late hop
+    *        addition only redoes the IBU calculation, and only tells listeners about the IBU value.
+    */
+   void recalcDirty() {
+      if (!this->m_self.m_calcsEnabled) {
+         qCDebug(Logging::recipe) << Q_FUNC_INFO << "Calculations disabled";
+         return;
+      }
+
+      // The first time through, everything needs calculating
+      if (this->m_self.m_uninitializedCalcs) {
+         this->markAllDirty();
+      }
+
       //
-      // the formula in here are taken from http://hbd.org/ensmingr/
+      // The calculation functions emit changed(), which can cause other objects to call back into us (eg to get
+      // finalVolume_l()) and, potentially, to mark more things dirty.  If that happens, there's no need to recurse, as
+      // the loop below will pick up anything newly marked dirty.
       //
+      if (!this->m_self.m_recalcMutex.tryLock()) {
+         return;
+      }
 
-      // Need to translate OG and FG into plato
+      // Once we've got calculated values, we need to hear about changes that would alter them
+      this->connectSignals();
 
-      double const startPlato  = Measurement::Units::plato.fromCanonical(this->m_self.m_og);
-      double const finishPlato = Measurement::Units::plato.fromCanonical(this->m_self.m_fg);
+      bool const anythingToRecalculate = this->m_dirtyCalculations.any();
+      if (anythingToRecalculate) {
+         ++this->m_calcGeneration;
+      }
 
-      double const realExtract = (0.1808 * startPlato) + (0.8192 * finishPlato);
+      while (this->m_dirtyCalculations.any()) {
+         // If we're going round again, it's because something changed while we were calculating, so we need a new
+         // snapshot
+         this->m_snapshot.reset();
+         for (std::size_t ii = 0; ii < numCalculations; ++ii) {
+            if (this->m_dirtyCalculations.test(ii)) {
+               this->m_dirtyCalculations.reset(ii);
+               Calculation const calculation = static_cast<Calculation>(ii);
+               if (this->recalc(calculation)) {
+                  this->markDirty(dependentsOf(calculation));
+               }
+            }
+         }
+      }
 
-      // Alcohol by weight?
-      double const abw = (startPlato - realExtract) / (2.0665 - (0.010665 * startPlato));
+      // Nothing is dirty now, so the snapshot (which we take here if none of the calculations needed it) is current
+      if (anythingToRecalculate && this->m_self.key() > 0) {
+         RecipeCalculationCache::store(this->m_self.key(),
+                                       RecipeEvaluator::inputFingerprint(this->snapshot()),
+                                       this->currentResults());
+      }
 
-      // The final results of this formula are calories per 100 ml.
-      // The 10.0 puts it in terms of liters.
-      double calculatedCaloriesPerLiter = ((6.9 * abw) + 4.0 * (realExtract - 0.1)) * this->m_self.m_fg * 10.0;
+      this->m_snapshot.reset();
+      this->m_self.m_uninitializedCalcs = false;
 
-      //! If there are no fermentables in the recipe, if there is no mash, etc.,
-      //  then the calories/12 oz ends up negative. Since negative doesn't make
-      //  sense, set it to 0
-      if (calculatedCaloriesPerLiter < 0) {
-         calculatedCaloriesPerLiter = 0;
+      this->m_self.m_recalcMutex.unlock();
+      return;
+   }
+
+   /**
+    * \brief The first time our calculated values are needed, this tries to get them from \c RecipeCalculationCache
+    *        instead of working them out.  We can only do that if they were calculated from exactly the same inputs as
+    *        we have now, so we still need to take a snapshot, but that is a lot less work than the calculations.
+    *
+    * \return \c true if we got the values, \c false if the caller needs to calculate them
+    */
+   bool useStoredCalculations() {
+      if (!this->m_self.m_calcsEnabled || this->m_self.key() <= 0) {
+         return false;
       }
 
-      if (!qFuzzyCompare(calculatedCaloriesPerLiter, this->m_caloriesPerLiter)) {
-         qDebug() <<
-            Q_FUNC_INFO << "Recipe #" << this->m_self.key() << "(" << this->m_self.name() << ") "
-            "Calculated calories/liter: " << calculatedCaloriesPerLiter << ", stored: " << this->m_caloriesPerLiter;
-         this->m_caloriesPerLiter = calculatedCaloriesPerLiter;
-         if (!this->m_self.m_uninitializedCalcs) {
-            emit this->m_self.changed(this->m_self.metaProperty(*PropertyNames::Recipe::caloriesPerLiter),
-                                      this->m_caloriesPerLiter);
-         }
+      std::optional<RecipeEvaluator::Results> const results =
+         RecipeCalculationCache::lookUp(this->m_self.key(), RecipeEvaluator::inputFingerprint(this->snapshot()));
+      this->m_snapshot.reset();
+      if (!results) {
+         return false;
+      }
+
+      qCDebug(Logging::recipe) << Q_FUNC_INFO << "Using stored calculations for Recipe #" << this->m_self.key();
+      this->applyResults(*results);
+      ++this->m_calcGeneration;
+      this->m_dirtyCalculations.reset();
+      this->m_self.m_uninitializedCalcs = false;
+      // As in recalcDirty(), now we've got calculated values, we need to hear about changes that would alter them
+      this->connectSignals();
+      return true;
+   }
+
+   //! \brief All the current calculated values, as \c RecipeCalculationCache stores them
+   RecipeEvaluator::Results currentResults() const {
+      return RecipeEvaluator::Results{
+         .grains            = this->currentGrains(),
+         .volumes           = this->currentVolumeEstimates(),
+         .gravities         = this->currentGravities(),
+         .color_srm         = this->m_color_srm,
+         .ABV_pct           = this->m_ABV_pct,
+         .boilGrav          = this->m_boilGrav,
+         .IBU               = this->m_IBU,
+         .ibusByHopAddition = this->m_ibus,
+         .caloriesPerLiter  = this->m_caloriesPerLiter,
+      };
+   }
+
+   /**
+    * \brief See \c Recipe::setCalculatedValues
+    */
+   void setCalculatedValues(RecipeEvaluator::Results const & results) {
+      // If calculations are off, or haven't been done yet, then it's not our job to turn them on
+      if (!this->m_self.m_calcsEnabled || this->m_self.m_uninitializedCalcs) {
+         qCDebug(Logging::recipe) << Q_FUNC_INFO << "Ignoring calculated values for Recipe #" << this->m_self.key();
+         return;
       }
+
+      this->applyResults(results);
       return;
    }
 
+   /**
+    * \brief Store calculated values without emitting \c changed() for them.  OG and FG are also stored in the DB, so,
+    *        as in recalcOgFg(), they get written out if they changed.
+    */
+   void applyResults(RecipeEvaluator::Results const & results) {
+      this->m_grains_kg             = results.grains.grains_kg;
+      this->m_grainsInMash_kg       = results.grains.grainsInMash_kg;
+      this->m_wortFromMash_l        = results.volumes.wortFromMash_l;
+      this->m_boilVolume_l          = results.volumes.boilVolume_l;
+      this->m_finalVolume_l         = results.volumes.finalVolume_l;
+      this->m_finalVolumeNoLosses_l = results.volumes.finalVolumeNoLosses_l;
+      this->m_postBoilVolume_l      = results.volumes.postBoilVolume_l;
+      this->m_color_srm             = results.color_srm;
+      this->m_SRMColor              = Algorithms::srmToColor(results.color_srm);
+      this->m_og_fermentable        = results.gravities.og_fermentable;
+      this->m_fg_fermentable        = results.gravities.fg_fermentable;
+      this->m_ABV_pct               = results.ABV_pct;
+      this->m_boilGrav              = results.boilGrav;
+      this->m_IBU                   = results.IBU;
+      this->m_ibus                  = results.ibusByHopAddition;
+      this->m_caloriesPerLiter      = results.caloriesPerLiter;
+
+      if (!qFuzzyCompare(this->m_self.m_og, results.gravities.og)) {
+         this->m_self.m_og = results.gravities.og;
+         this->m_self.propagatePropertyChange(PropertyNames::Recipe::og, false);
+      }
+      if (!qFuzzyCompare(this->m_self.m_fg, results.gravities.fg)) {
+         this->m_self.m_fg = results.gravities.fg;
+         this->m_self.propagatePropertyChange(PropertyNames::Recipe::fg, false);
+      }
+      return;
+   }
 
    //================================================ Member variables =================================================
    Recipe & m_self;
    QVector<int> instructionIds;
 
+   //! See \c addInstruction
+   QList<std::shared_ptr<Instruction>> m_generatedInstructions;
+
+   //! See \c copyAdditions
+   std::tuple<QList<std::shared_ptr<RecipeAdditionFermentable>>,
+              QList<std::shared_ptr<RecipeAdditionHop        >>,
+              QList<std::shared_ptr<RecipeAdditionMisc       >>,
+              QList<std::shared_ptr<RecipeAdditionYeast      >>,
+              QList<std::shared_ptr<RecipeAdjustmentSalt     >>,
+              QList<std::shared_ptr<RecipeUseOfWater         >>> m_pendingAdditions;
+
+   //! Which of the calculations (see \c Calculation above) need redoing
+   std::bitset<numCalculations> m_dirtyCalculations;
+
+   //! See \c Recipe::calcGeneration
+   unsigned int m_calcGeneration;
+
+   //! See \c snapshot()
+   std::optional<RecipeEvaluator::Snapshot> m_snapshot;
+
+   //! See \c connectSignals()
+   bool m_signalsConnected;
+
+   /**
+    * \brief Everything that goes into the IBU calculation for a single hop addition (including global settings), along
+    *        with the result
+    */
+   struct IbuMemo {
+      RecipeEvaluator::HopAdditionInputs              hopAddition;
+      std::optional<RecipeEvaluator::EquipmentInputs> equipment;
+      std::optional<RecipeEvaluator::BoilInputs>      boil;
+      double                                          og;
+      double                                          finalVolumeNoLosses_l;
+      IbuMethods::IbuFormula                          ibuFormula;
+      double                                          firstWortHopAdjustment;
+      double                                          mashHopAdjustment;
+      double                                          ibus;
+
+      bool sameInputsAs(IbuMemo const & other) const {
+         return this->hopAddition            == other.hopAddition            &&
+                this->equipment              == other.equipment              &&
+                this->boil                   == other.boil                   &&
+                this->og                     == other.og                     &&
+                this->finalVolumeNoLosses_l  == other.finalVolumeNoLosses_l  &&
+                this->ibuFormula             == other.ibuFormula             &&
+                this->firstWortHopAdjustment == other.firstWortHopAdjustment &&
+                this->mashHopAdjustment      == other.mashHopAdjustment;
+      }
+   };
+
+   //! \return What goes into the IBU calculation for a hop addition of this recipe, for comparison with \c m_ibuMemo
+   IbuMemo ibuMemoInputs(RecipeEvaluator::HopAdditionInputs const & hopAdditionInputs,
+                         std::optional<RecipeEvaluator::EquipmentInputs> const & equipment,
+                         std::optional<RecipeEvaluator::BoilInputs> const & boil) const {
+      return IbuMemo{
+         .hopAddition            = hopAdditionInputs,
+         .equipment              = equipment,
+         .boil                   = boil,
+         .og                     = this->m_self.m_og,
+         .finalVolumeNoLosses_l  = this->m_finalVolumeNoLosses_l,
+         .ibuFormula             = IbuMethods::ibuFormula,
+         .firstWortHopAdjustment = IbuMethods::firstWortHopAdjustment,
+         .mashHopAdjustment      = IbuMethods::mashHopAdjustment,
+         .ibus                   = 0.0,
+      };
+   }
+
+   //! Last IBU result for each hop addition, along with the inputs that gave it.  See \c ibuFromHopAddition.
+   QHash<RecipeAdditionHop const *, IbuMemo> m_ibuMemo;
+
    // Calculated properties.
    double        m_ABV_pct              ;
    double        m_color_srm            ;
@@ -1724,6 +2078,7 @@ Recipe::Recipe(QString name) :
    m_recalcMutex            {},
    m_ancestor_id            {-1                  },
    m_ancestors              {},
+   m_ancestorsGeneration    {0                   },
    m_hasDescendants         {false               } {
 
    CONSTRUCTOR_END
@@ -1770,6 +2125,7 @@ Recipe::Recipe(NamedParameterBundle const & namedParameterBundle) :
                          m_recalcMutex            {},
    SET_REGULAR_FROM_NPB (m_ancestor_id            , namedParameterBundle, PropertyNames::Recipe::ancestorId             , -1),
                          m_ancestors              {},
+                         m_ancestorsGeneration    {0},
                          m_hasDescendants         {false} {
    // At this stage, we haven't set any Hops, Fermentables, etc.  This is deliberate because the caller typically needs
    // to access subsidiary records to obtain this info.   Callers will usually use setters (setHopIds, etc but via
@@ -1797,8 +2153,8 @@ Recipe::Recipe(Recipe const & other) :
    m_carbonationTemp_c      {other.m_carbonationTemp_c },
    m_primingSugarEquiv      {other.m_primingSugarEquiv },
    m_kegPrimingFactor       {other.m_kegPrimingFactor  },
-   m_notes                  {other.m_notes             },
-   m_tasteNotes             {other.m_tasteNotes        },
+   m_notes                  {other.notes()             },
+   m_tasteNotes             {other.tasteNotes()        },
    m_tasteRating            {other.m_tasteRating       },
    m_styleId                {other.m_styleId           },  // But see additional logic in body
    m_equipmentId            {other.m_equipmentId       },  // But see additional logic in body
@@ -1817,6 +2173,7 @@ Recipe::Recipe(Recipe const & other) :
    // Copying a Recipe doesn't copy its descendants
    m_ancestor_id            {-1                        },
    m_ancestors              {},
+   m_ancestorsGeneration    {0                         },
    m_hasDescendants         {false                     } {
    setObjectName("Recipe"); // .:TBD:. Would be good to understand whether/why we need this
 
@@ -1856,11 +2213,13 @@ Recipe::Recipe(Recipe const & other) :
 
    this->pimpl->connectSignals();
 
-   this->recalcAll();
-
-   // This turns on writing to the DB and sending signals when things change.  However, we do this _after_ calling
-   // recalcAll() as the newly constructed object will not yet be stored in the DB and won't yet have anyone listening
-   // to its signals.
+   //
+   // Note that we don't call recalcAll() here, because our copies of the additions are not attached to us until we are
+   // stored (see setKey()).  Leaving m_uninitializedCalcs set means the calculations get done on first use instead --
+   // which, when we're making a frozen previous version of a Recipe, may well be never.
+   //
+   // This turns on writing to the DB and sending signals when things change.
+   //
    CONSTRUCTOR_END
    return;
 }
@@ -1879,22 +2238,53 @@ void Recipe::setKey(int key) {
    //
    this->NamedEntity::setKey(key);
    if (this->m_ancestor_id <= 0) {
-      qDebug() << Q_FUNC_INFO << "Setting default ancestor ID on Recipe #" << key;
+      qCDebug(Logging::recipe) << Q_FUNC_INFO << "Setting default ancestor ID on Recipe #" << key;
 
       // We want to store the new ancestor ID in the DB, but we don't want to signal the UI about this change, so
       // suppress signal sending.
       this->setAncestorId(key, false);
    }
+
+   // If we were copied from another Recipe, now is the time to store our copies of its additions
+   this->pimpl->storePendingAdditions<RecipeAdditionFermentable>();
+   this->pimpl->storePendingAdditions<RecipeAdditionHop        >();
+   this->pimpl->storePendingAdditions<RecipeAdditionMisc       >();
+   this->pimpl->storePendingAdditions<RecipeAdditionYeast      >();
+   this->pimpl->storePendingAdditions<RecipeAdjustmentSalt     >();
+   this->pimpl->storePendingAdditions<RecipeUseOfWater         >();
    return;
 }
 
 void Recipe::connectSignalsForAllRecipes() {
-   qDebug() << Q_FUNC_INFO << "Connecting signals for all Recipes";
-   // Connect fermentable, hop changed signals to their parent recipe
-   for (auto recipe : ObjectStoreTyped<Recipe>::getInstance().getAllRaw()) {
-//      qDebug() << Q_FUNC_INFO << "Connecting signals for Recipe #" << recipe->key();
-      recipe->pimpl->connectSignals();
-   }
+   qCDebug(Logging::recipe) << Q_FUNC_INFO << "Connecting Equipment change dispatcher for all Recipes";
+   //
+   // Each Recipe connects to its own contained objects when it is first calculated (see impl::recalcDirty), which is
+   // all that matters for its calculated values.  But changes to an Equipment's kettle boil size or boil time also
+   // need to be copied to the Boil of the Recipe using it, whether or not anyone has looked at that Recipe yet.  So,
+   // for Recipes that aren't yet connected, we do that here, from the one connection to the Equipment ObjectStore.
+   //
+   connect(&ObjectStoreTyped<Equipment>::getInstance(),
+           &ObjectStoreTyped<Equipment>::signalPropertyChanged,
+           &ObjectStoreTyped<Recipe>::getInstance(),
+           [](int const equipmentId, BtStringConst const & propertyName) {
+              if (!(propertyName == PropertyNames::Equipment::kettleBoilSize_l ||
+                    propertyName == PropertyNames::Equipment::boilTime_min)) {
+                 return;
+              }
+              auto equipment = ObjectStoreWrapper::getById<Equipment>(equipmentId);
+              if (!equipment) {
+                 return;
+              }
+              QVariant const val = equipment->property(*propertyName);
+              auto const recipes = ObjectStoreWrapper::findByIndexRaw<Recipe>(PropertyNames::Recipe::equipmentId,
+                                                                              equipmentId);
+              for (auto recipe : recipes) {
+                 if (!recipe->pimpl->m_signalsConnected) {
+                    recipe->pimpl->acceptEquipmentChange(*propertyName, val);
+                 }
+              }
+              return;
+           });
 
    return;
 }
@@ -1903,10 +2293,11 @@ void Recipe::generateInstructions() {
    double timeRemaining;
    double totalWaterAdded_l = 0.0;
 
-   if (!this->instructions().empty()) {
-      this->clearInstructions();
-   }
-
+   //
+   // We work out all the new instructions first, and only then replace the old ones in one go (see
+   // impl::storeGeneratedInstructions).  Apart from being quicker, this means we're not in the middle of a DB
+   // transaction while, below, we might be waiting for the user to tell us the boil time.
+   //
    QVector<PreInstruction> preinstructions;
 
    // Mash instructions
@@ -1967,7 +2358,7 @@ void Recipe::generateInstructions() {
    startBoilIns->setName(tr("Start boil"));
    startBoilIns->setInterval(timeRemaining);
    startBoilIns->setDirections(str);
-   this->add(startBoilIns);
+   this->pimpl->addInstruction(startBoilIns);
 
    /*** Get fermentables unless we haven't added yet ***/
    if (this->pimpl->hasBoilFermentable()) {
@@ -1994,7 +2385,7 @@ void Recipe::generateInstructions() {
    auto flameoutIns = std::make_shared<Instruction>();
    flameoutIns->setName(tr("Flameout"));
    flameoutIns->setDirections(tr("Stop boiling the wort."));
-   this->add(flameoutIns);
+   this->pimpl->addInstruction(flameoutIns);
 
    // TODO: These get included in RecipeAddition::Stage::Boil above.  But we're going to want to rework this anyway to
    //       order by stage, step, time.
@@ -2024,7 +2415,7 @@ void Recipe::generateInstructions() {
    auto pitchIns = std::make_shared<Instruction>();
    pitchIns->setName(tr("Pitch yeast"));
    pitchIns->setDirections(str);
-   this->add(pitchIns);
+   this->pimpl->addInstruction(pitchIns);
    /*** End primary yeast ***/
 
    /*** Primary misc ***/
@@ -2037,13 +2428,13 @@ void Recipe::generateInstructions() {
    auto fermentIns = std::make_shared<Instruction>();
    fermentIns->setName(tr("Ferment"));
    fermentIns->setDirections(str);
-   this->add(fermentIns);
+   this->pimpl->addInstruction(fermentIns);
 
    str = tr("Transfer beer to secondary.");
    auto transferIns = std::make_shared<Instruction>();
    transferIns->setName(tr("Transfer to secondary"));
    transferIns->setDirections(str);
-   this->add(transferIns);
+   this->pimpl->addInstruction(transferIns);
 
    /*** Secondary misc ***/
    this->pimpl->addPreinstructions(this->pimpl->miscSteps(RecipeAdditionMisc::Use::Secondary));
@@ -2051,9 +2442,11 @@ void Recipe::generateInstructions() {
    /*** Dry hopping ***/
    this->pimpl->addPreinstructions(this->pimpl->hopSteps(RecipeAddition::Stage::Fermentation));
 
-   // END fermentation instructions. Let everybody know that now is the time
-   // to update instructions
-   emit changed(metaProperty(*PropertyNames::Recipe::instructions), this->instructions().size());
+   // END fermentation instructions.
+   this->pimpl->storeGeneratedInstructions();
+
+   // Let everybody know that now is the time to update instructions
+   this->emitChanged(PropertyNames::Recipe::instructions, this->instructions().size());
 
    return;
 }
@@ -2118,7 +2511,7 @@ template<class NE> std::shared_ptr<NE> Recipe::add(std::shared_ptr<NE> ne) {
    if (ne->key() <= 0) {
       // With shared pointer parameter, ObjectStoreWrapper::insert returns what we passed it (ie our shared pointer
       // remains valid after the call).
-      qDebug() << Q_FUNC_INFO << "Inserting" << ne->metaObject()->className() << "in object store";
+      qCDebug(Logging::recipe) << Q_FUNC_INFO << "Inserting" << ne->metaObject()->className() << "in object store";
       ObjectStoreWrapper::insert(ne);
    } else {
       //
@@ -2130,7 +2523,7 @@ template<class NE> std::shared_ptr<NE> Recipe::add(std::shared_ptr<NE> ne) {
    }
 
    this->pimpl->accessIds<NE>().append(ne->key());
-   connect(ne.get(), &NamedEntity::changed, this, &Recipe::acceptChangeToContainedObject);
+   connect(ne.get(), &NamedEntity::propertyChanged, this, &Recipe::acceptChangeToContainedObject);
    this->propagatePropertyChange(Recipe::propertyNameFor<NE>());
 
    this->recalcIfNeeded(ne->metaObject()->className());
@@ -2162,7 +2555,7 @@ template<class RA> std::shared_ptr<RA> Recipe::addAddition(std::shared_ptr<RA> a
    if (addition->key() <= 0) {
       // With shared pointer parameter, ObjectStoreWrapper::insert returns what we passed it (ie our shared pointer
       // remains valid after the call).
-      qDebug() <<
+      qCDebug(Logging::recipe) <<
          Q_FUNC_INFO << "Inserting" << addition->metaObject()->className() << "for" <<
          addition->ingredient()->metaObject()->className() << "#" << addition->ingredient()->key() << "in object store";
       ObjectStoreWrapper::insert(addition);
@@ -2172,7 +2565,7 @@ template<class RA> std::shared_ptr<RA> Recipe::addAddition(std::shared_ptr<RA> a
    // Doing this connect here means that a signal will be sent to acceptChangeToContainedObject() by the call to
    // notifyPropertyChange() below.
    //
-   connect(addition.get(), &NamedEntity::changed, this, &Recipe::acceptChangeToContainedObject);
+   connect(addition.get(), &NamedEntity::propertyChanged, this, &Recipe::acceptChangeToContainedObject);
 
    //
    // We don't want to call this->propagatePropertyChange here because the RecipeAddition is not stored either in the
@@ -2199,7 +2592,7 @@ template<class NE> bool Recipe::uses(NE const & val) const {
       // We shouldn't be trying to look for something that hasn't even been stored (and therefore does not yet have an
       // ID).
       //
-      qCritical() <<
+      qCCritical(Logging::recipe) <<
          Q_FUNC_INFO << "Trying to search for use of" << val.metaObject()->className() << "that is not stored!";
       return false;
    }
@@ -2238,7 +2631,7 @@ std::shared_ptr<Instruction> Recipe::remove(std::shared_ptr<Instruction> var) {
    int idToRemove = var->key();
    if (!this->pimpl->accessIds<Instruction>().removeOne(idToRemove)) {
       // It's a coding error if we try to remove something from the Recipe that wasn't in it in the first place!
-      qCritical() <<
+      qCCritical(Logging::recipe) <<
          Q_FUNC_INFO << "Tried to remove" << var->metaObject()->className() << "with ID" << idToRemove <<
          "but couldn't find it in Recipe #" << this->key();
       Q_ASSERT(false);
@@ -2254,7 +2647,7 @@ std::shared_ptr<Instruction> Recipe::remove(std::shared_ptr<Instruction> var) {
    // UNNECESSARY.
    //
    if (isUnusedInstanceOfUseOf(*var)) {
-      qDebug() <<
+      qCDebug(Logging::recipe) <<
          Q_FUNC_INFO << "Deleting" << var->metaObject()->className() << "#" << var->key() <<
          "as it is \"instance of use of\" that is no longer needed";
       ObjectStoreWrapper::hardDelete<Instruction>(var->key());
@@ -2274,7 +2667,7 @@ template<class RA> std::shared_ptr<RA> Recipe::removeAddition(std::shared_ptr<RA
 
    addition->setRecipeId(-1);
 
-   disconnect(addition.get(), &NamedEntity::changed, this, &Recipe::acceptChangeToContainedObject);
+   disconnect(addition.get(), &NamedEntity::propertyChanged, this, &Recipe::acceptChangeToContainedObject);
    //
    // For the same reason as in addAddition(), we don't want to call this->propagatePropertyChange here
    //
@@ -2286,7 +2679,8 @@ template<class RA> std::shared_ptr<RA> Recipe::removeAddition(std::shared_ptr<RA
    // Because RecipeAdditionHop etc objects are owned by their Recipe, we need to delete the object from the ObjectStore
    // at this point.
    //
-   qDebug() << Q_FUNC_INFO << "Deleting" << addition->metaObject()->className() << "#" << addition->key();
+   qCDebug(Logging::recipe) <<
+      Q_FUNC_INFO << "Deleting" << addition->metaObject()->className() << "#" << addition->key();
    ObjectStoreWrapper::hardDelete<RA>(addition->key());
 
    // The caller now owns the removed object unless and until they pass it in to Recipe::add() (typically to undo the
@@ -2337,7 +2731,7 @@ void Recipe::clearInstructions() {
 
 void Recipe::insertInstruction(Instruction const & ins, int pos) {
    if (this->pimpl->instructionIds.contains(ins.key())) {
-      qDebug() <<
+      qCDebug(Logging::recipe) <<
          Q_FUNC_INFO << "Request to insert instruction ID" << ins.key() << "at position" << pos << "for recipe #" <<
          this->key() << "ignored as this instruction is already in the list at position" <<
          this->instructionNumber(ins);
@@ -2347,7 +2741,7 @@ void Recipe::insertInstruction(Instruction const & ins, int pos) {
    // The position should be indexed from 1, so it's a coding error if it's less than this
    Q_ASSERT(pos >= 1);
 
-   qDebug() <<
+   qCDebug(Logging::recipe) <<
       Q_FUNC_INFO << "Inserting instruction #" << ins.key() << "(" << ins.name() << ") at position" << pos <<
       "in list of" << this->pimpl->instructionIds.size();
    this->pimpl->instructionIds.insert(pos - 1, ins.key());
@@ -2405,10 +2799,11 @@ void Recipe::setBatchSize_l(double var) {
                       this->m_batchSize_l,
                       this->enforceMin(var, "batch size"));
 
-   // NOTE: this is bad, but we have to call recalcAll(), because the estimated
-   // boil/batch volumes depend on the target volumes when there are no mash
-   // steps to actually provide an estimate for the volumes.
-   recalcAll();
+   // The estimated boil/batch volumes depend on the target volumes when there are no mash steps to actually provide an
+   // estimate for the volumes.  IBU uses the batch size directly (for hopped extracts).
+   this->pimpl->markDirty({Recipe::impl::Calculation::VolumeEstimates, Recipe::impl::Calculation::IBU});
+   this->pimpl->recalcDirty();
+   return;
 }
 
 void Recipe::setEfficiency_pct(double val) {
@@ -2416,10 +2811,10 @@ void Recipe::setEfficiency_pct(double val) {
                       this->m_efficiency_pct,
                       this->enforceMinAndMax(val, "efficiency", 0.0, 100.0, 70.0));
 
-   // If you change the efficency, you really should recalc. And I'm afraid it
-   // means recalc all, since og and fg will change, which means your ratios
-   // change
-   recalcAll();
+   // Changing the efficiency changes OG and boil gravity (and, via them, everything that depends on OG/FG)
+   this->pimpl->markDirty({Recipe::impl::Calculation::OgFg, Recipe::impl::Calculation::BoilGrav});
+   this->pimpl->recalcDirty();
+   return;
 }
 
 void Recipe::setAsstBrewer(const QString & val) {
@@ -2517,15 +2912,30 @@ void Recipe::setCalcsEnabled(bool const val) {
 }
 
 QList<Recipe *> Recipe::ancestors() const {
-   // If we know we have some ancestors, and we didn't yet load them, do so now
-   if (this->m_ancestor_id > 0 && this->m_ancestor_id != this->key() && this->m_ancestors.size() == 0) {
+   if (this->m_ancestorsGeneration != ancestryGeneration) {
+      //
+      // Our immediate ancestor's list of ancestors is the rest of ours, so we build on that (which is itself cached)
+      // rather than walking the whole chain of ancestor IDs for each Recipe.  This makes getting the ancestors of every
+      // Recipe in a lineage (eg when building the tree view) linear rather than quadratic in the length of the lineage.
+      //
       // NB: In previous versions of the code, we included the Recipe in the list along with its ancestors, but it's
       //     now just the ancestors in the list.
-      Recipe * ancestor = const_cast<Recipe *>(this);
-      while (ancestor->m_ancestor_id > 0 && ancestor->m_ancestor_id != ancestor->key()) {
-         ancestor = ObjectStoreWrapper::getByIdRaw<Recipe>(ancestor->m_ancestor_id);
-         ancestor->m_hasDescendants = true;
-         this->m_ancestors.append(ancestor);
+      //
+      // We mark the cache as current before we ask our ancestor for its ancestors, so that, if the DB somehow ended up
+      // with a loop of ancestor IDs, we won't recurse forever.
+      //
+      this->m_ancestors.clear();
+      this->m_ancestorsGeneration = ancestryGeneration;
+      if (this->m_ancestor_id > 0 && this->m_ancestor_id != this->key()) {
+         Recipe * ancestor = ObjectStoreWrapper::getByIdRaw<Recipe>(this->m_ancestor_id);
+         if (!ancestor) {
+            qCCritical(Logging::recipe) <<
+               Q_FUNC_INFO << "Could not find ancestor Recipe #" << this->m_ancestor_id << "of Recipe #" << this->key();
+         } else {
+            ancestor->m_hasDescendants = true;
+            this->m_ancestors.append(ancestor);
+            this->m_ancestors.append(ancestor->ancestors());
+         }
       }
    }
 
@@ -2556,6 +2966,7 @@ void Recipe::setAncestorId(int ancestorId, bool notify) {
       return;
    }
    this->m_ancestor_id = ancestorId;
+   ++ancestryGeneration;
    this->propagatePropertyChange(PropertyNames::Recipe::ancestorId, notify);
    return;
 }
@@ -2569,7 +2980,7 @@ void Recipe::setAncestor(Recipe & ancestor) {
    //    - Recipe A is modified
    // This means that, if Recipe A already has a direct ancestor, then Recipe B needs to take it
    //
-   qDebug() <<
+   qCDebug(Logging::recipe) <<
       Q_FUNC_INFO << "Setting Recipe #" << ancestor.key() << "to be immediate prior version (ancestor) of Recipe #" <<
       this->key();
 
@@ -2582,23 +2993,22 @@ void Recipe::setAncestor(Recipe & ancestor) {
          if (this->ancestors().size() > 0) {
             // We have some ancestors so we just have to tell the immediate one that it no longer has descendants
             this->ancestors().at(0)->setHasDescendants(false);
-            this->ancestors().clear();
          }
       } else {
          // Give our existing ancestors them to the new direct ancestor (aka immediate prior version).  Note that it's
          // a coding error if this new direct ancestor already has its own ancestors.
          Q_ASSERT(ancestor.m_ancestor_id == ancestor.key() || ancestor.m_ancestor_id <= 0);
-         ancestor.m_ancestor_id = this->m_ancestor_id;
-         ancestor.m_ancestors = this->ancestors();
+         ancestor.setAncestorId(this->m_ancestor_id, false);
       }
    }
 
+   //
+   // Note that we don't need to touch this->m_ancestors (or ancestor.m_ancestors) here, as calling setAncestorId()
+   // invalidates all cached lists of ancestors.
+   //
+
    // Skip most of the remaining work if we're really setting "no ancestors"
    if (&ancestor != this) {
-      // Either we verified the lazy-load of this->m_ancestors in the call to this->ancestors() in the if statement above
-      // or it should have been empty to begin with.  In both cases, we should be good to append the new ancestor here.
-      this->m_ancestors.append(&ancestor);
-
       ancestor.setDisplay(false);
       ancestor.setLocked(true);
       ancestor.setHasDescendants(true);
@@ -2699,12 +3109,7 @@ QVector<int> Recipe::getInstructionIds() const {
 QList<BrewNote *> Recipe::brewNotes() const {
    // The Recipe owns its BrewNotes, but, for the moment at least, it's the BrewNote that knows which Recipe it's in
    // rather than the Recipe which knows which BrewNotes it has, so we have to ask.
-   int const recipeId = this->key();
-   return ObjectStoreTyped<BrewNote>::getInstance().findAllMatching(
-      [recipeId](BrewNote const * bn) {
-         return bn->recipeId() == recipeId;
-      }
-   );
+   return this->pimpl->allMyRaw<BrewNote>();
 }
 
 template<typename NE> QList< std::shared_ptr<NE> > Recipe::getAll() const {
@@ -2741,8 +3146,8 @@ int Recipe::getAncestorId() const { return this->m_ancestor_id; }
 Recipe::Type Recipe::type()          const { return m_type;               }
 QString Recipe::brewer()             const { return m_brewer;             }
 QString Recipe::asstBrewer()         const { return m_asstBrewer;         }
-QString Recipe::notes()              const { return m_notes;              }
-QString Recipe::tasteNotes()         const { return m_tasteNotes;         }
+QString Recipe::notes()              const { return this->lazyText(PropertyNames::Recipe::notes, m_notes); }
+QString Recipe::tasteNotes()         const { return this->lazyText(PropertyNames::Recipe::tasteNotes, m_tasteNotes); }
 QString Recipe::primingSugarName()   const { return m_primingSugarName;   }
 bool    Recipe::forcedCarbonation()  const { return m_forcedCarbonation;  }
 double  Recipe::batchSize_l()        const { return m_batchSize_l;        }
@@ -2765,66 +3170,74 @@ std::optional<double> Recipe::apparentAttenuation_pct() const { return m_apparen
 //==============================Recalculators==================================
 
 void Recipe::recalcIfNeeded(QString classNameOfWhatWasAddedOrChanged) {
-   qDebug() << Q_FUNC_INFO << classNameOfWhatWasAddedOrChanged;
+   qCDebug(Logging::recipe) << Q_FUNC_INFO << classNameOfWhatWasAddedOrChanged;
    // We could just compare with "Hop", "Equipment", etc but there's then no compile-time checking of typos.  Using
    // ::staticMetaObject.className() is a bit more clunky but it's safer.
+   //
+   // Here we only need to say which calculations use the thing that changed directly.  Anything that depends on the
+   // results of those calculations will get redone if, and only if, those results change.
+   using Calculation = Recipe::impl::Calculation;
 
    if (classNameOfWhatWasAddedOrChanged ==               Hop::staticMetaObject.className() ||
        classNameOfWhatWasAddedOrChanged == RecipeAdditionHop::staticMetaObject.className()) {
-      this->pimpl->recalcIBU();
-      return;
-   }
-
-   if (classNameOfWhatWasAddedOrChanged ==                 Equipment::staticMetaObject.className() ||
-       classNameOfWhatWasAddedOrChanged ==               Fermentable::staticMetaObject.className() ||
-       classNameOfWhatWasAddedOrChanged == RecipeAdditionFermentable::staticMetaObject.className() ||
-       classNameOfWhatWasAddedOrChanged ==                      Mash::staticMetaObject.className()) {
-      this->recalcAll();
-      return;
-   }
-
-   if (classNameOfWhatWasAddedOrChanged ==               Yeast::staticMetaObject.className() ||
-       classNameOfWhatWasAddedOrChanged == RecipeAdditionYeast::staticMetaObject.className()) {
-      this->pimpl->recalcOgFg();
-      this->pimpl->recalcABV_pct();
+      this->pimpl->markDirty({Calculation::IBU});
+   } else if (classNameOfWhatWasAddedOrChanged ==               Fermentable::staticMetaObject.className() ||
+              classNameOfWhatWasAddedOrChanged == RecipeAdditionFermentable::staticMetaObject.className()) {
+      // Fermentables are used in almost everything (including IBU, via hopped extracts)
+      this->pimpl->markDirty({Calculation::Grains,
+                              Calculation::VolumeEstimates,
+                              Calculation::Color_srm,
+                              Calculation::OgFg,
+                              Calculation::BoilGrav,
+                              Calculation::IBU});
+   } else if (classNameOfWhatWasAddedOrChanged == Equipment::staticMetaObject.className()) {
+      // Changing equipment kettle boil size also changes our boil size (see acceptChangeToContainedObject), hence
+      // BoilGrav here
+      this->pimpl->markDirty({Calculation::VolumeEstimates,
+                              Calculation::OgFg,
+                              Calculation::BoilGrav,
+                              Calculation::IBU});
+      //
+      // The same Equipment can be shared by thousands of recipes, so, unless we're the one on screen, we just leave
+      // the calculations marked dirty and let getCalculated() do them the next time one of our values is needed.
+      //
+      if (this->key() != displayedRecipeId) {
+         qCDebug(Logging::recipe) << Q_FUNC_INFO << "Deferring recalculation of Recipe #" << this->key();
+         return;
+      }
+   } else if (classNameOfWhatWasAddedOrChanged == Mash::staticMetaObject.className()) {
+      this->pimpl->markDirty({Calculation::VolumeEstimates});
+   } else if (classNameOfWhatWasAddedOrChanged ==               Yeast::staticMetaObject.className() ||
+              classNameOfWhatWasAddedOrChanged == RecipeAdditionYeast::staticMetaObject.className()) {
+      this->pimpl->markDirty({Calculation::OgFg});
+   } else {
       return;
    }
 
+   this->pimpl->recalcDirty();
    return;
 }
 
-void Recipe::recalcAll() {
-   if (!this->m_calcsEnabled) {
-      qDebug() << Q_FUNC_INFO << "Calculations disabled";
-      return;
-   }
-
-   // WARNING
-   // Infinite recursion possible, since these methods will emit changed(),
-   // causing other objects to call finalVolume_l() for example, which may
-   // cause another call to recalcAll() and so on.
-   //
-   // GSG: Now only emit when m_uninitializedCalcs is true, which helps some.
-
-   // Someone has already called this function back in the call stack, so return to avoid recursion.
-   if (!this->m_recalcMutex.tryLock()) {
-      return;
-   }
+unsigned int Recipe::calcGeneration() const {
+   return this->pimpl->m_calcGeneration;
+}
 
-   // Times are in seconds, and are cumulative.
-   this->pimpl->recalcGrains(); // 0.03
-   this->pimpl->recalcVolumeEstimates(); // 0.06
-   this->pimpl->recalcColor_srm(); // 0.08
-   this->pimpl->recalcSRMColor(); // 0.08
-   this->pimpl->recalcOgFg(); // 0.11
-   this->pimpl->recalcABV_pct(); // 0.12
-   this->pimpl->recalcBoilGrav(); // 0.14
-   this->pimpl->recalcIBU(); // 0.15
-   this->pimpl->recalcCalories();
+void Recipe::setCalculatedValues(RecipeEvaluator::Results const & results) {
+   this->pimpl->setCalculatedValues(results);
+   return;
+}
 
-   this->m_uninitializedCalcs = false;
+void Recipe::setDisplayedRecipe(Recipe const * recipe) {
+   displayedRecipeId = recipe ? recipe->key() : -1;
+   return;
+}
 
-   this->m_recalcMutex.unlock();
+void Recipe::recalcAll() {
+   Tracing::Span span{"Recipe::recalcAll"};
+   // A recalculation changes lots of properties, but views only need to hear about each one once
+   NamedEntityChangeBatch changeBatch;
+   this->pimpl->markAllDirty();
+   this->pimpl->recalcDirty();
    return;
 }
 
@@ -2832,38 +3245,7 @@ void Recipe::recalcAll() {
 // available. The only way I can see of doing that which doesn't suck is to
 // split that calculation out of recalcOgFg();
 Recipe::Sugars Recipe::calcTotalPoints() {
-   Recipe::Sugars ret;
-
-   for (auto const & fermentableAddition : this->fermentableAdditions()) {
-      auto const & fermentable = fermentableAddition->fermentable();
-      qDebug() <<
-         "calcTotalPoints Rec" << this->key() << "(" << this->name() << ") "
-         "Ferm Add" << fermentable->key() << "(" << fermentable->name() << ") equivSucrose_kg" <<
-         fermentableAddition->equivSucrose_kg() << ", isSugar?" << fermentable->isSugar() << ", isExtract?" <<
-         fermentable->isExtract() << ", addAfterBoil?" <<
-         fermentableAddition->addAfterBoil() << ", isFermentableSugar?" << isFermentableSugar(fermentable);
-
-      // If we have some sort of non-grain, we have to ignore efficiency.
-      if (fermentable->isSugar() || fermentable->isExtract()) {
-         ret.sugar_kg_ignoreEfficiency += fermentableAddition->equivSucrose_kg();
-
-         if (fermentableAddition->addAfterBoil()) {
-            ret.lateAddition_kg_ignoreEff += fermentableAddition->equivSucrose_kg();
-         }
-
-         if (!isFermentableSugar(fermentable)) {
-            ret.nonFermentableSugars_kg += fermentableAddition->equivSucrose_kg();
-         }
-      } else {
-         ret.sugar_kg += fermentableAddition->equivSucrose_kg();
-
-         if (fermentableAddition->addAfterBoil()) {
-            ret.lateAddition_kg += fermentableAddition->equivSucrose_kg();
-         }
-      }
-   }
-
-   return ret;
+   return RecipeEvaluator::sugars(RecipeEvaluator::snapshotOf(*this));
 }
 
 
@@ -2871,99 +3253,17 @@ Recipe::Sugars Recipe::calcTotalPoints() {
 //====================================Helpers===========================================
 
 double Recipe::ibuFromHopAddition(RecipeAdditionHop const & hopAddition) {
-   auto equipment = this->equipment();
-   double ibus = 0.0;
-   double fwhAdjust = Localization::toDouble(
-      PersistentSettings::value(PersistentSettings::Names::firstWortHopAdjustment, 1.1).toString(),
-      Q_FUNC_INFO
-   );
-   double mashHopAdjust = Localization::toDouble(
-      PersistentSettings::value(PersistentSettings::Names::mashHopAdjustment, 0).toString(),
-      Q_FUNC_INFO
-   );
-
    // It's a coding error to ask one recipe about another's hop additions!
    Q_ASSERT(hopAddition.recipeId() == this->key());
 
-   double AArating = hopAddition.hop()->alpha_pct() / 100.0;
-   // .:TBD:.  What to do if hopAddition is measured by volume?
-   //
-   // Per https://beersmith.com/blog/2016/08/31/using-hop-extracts-for-beer-brewing/, for CO2 Hop Extract, a first
-   // approximation would be 1 gram hop = 1 ml of hop extract.
-   //
-   // The same page suggests that, for Isomerized Hop Extract,
-   //    IBU = (extract_vol_ml * alpha_content_pct * 1000) / (volume_beer_liters)
-   //
-   if (!hopAddition.amountIsWeight()) {
-      qCritical() << Q_FUNC_INFO << "Using Hop volume as weight - THIS IS PROBABLY WRONG!";
-   }
-   double grams = hopAddition.quantity() * 1000.0;
-   double minutes = hopAddition.addAtTime_mins().value_or(0.0);
-   // Assume 100% utilization until further notice
-   double hopUtilization = 1.0;
-   // Assume 60 min boil until further notice
-   double boilTime_mins = 60.0;
-
-   // NOTE: we used to carefully calculate the average boil gravity and use it in the
-   // IBU calculations. However, due to John Palmer
-   // (http://homebrew.stackexchange.com/questions/7343/does-wort-gravity-affect-hopAddition-utilization),
-   // it seems more appropriate to just use the OG directly, since it is the total
-   // amount of break material that truly affects the IBUs.
-
-   if (equipment) {
-      hopUtilization = equipment->hopUtilization_pct().value_or(Equipment::default_hopUtilization_pct) / 100.0;
-      boilTime_mins = static_cast<int>(equipment->boilTime_min().value_or(Equipment::default_boilTime_mins));
-   }
-
+   auto equipment = this->equipment();
    auto boil = this->boil();
-   if (boil) {
-      boilTime_mins = boil->boilTime_mins();
-   }
-
-   IbuMethods::IbuCalculationParms parms = {
-      .AArating              = AArating,
-      .hops_grams            = grams,
-      .postBoilVolume_liters = this->pimpl->m_finalVolumeNoLosses_l,
-      .wortGravity_sg        = m_og,
-      .boilTime_minutes      = boilTime_mins,  // Seems unlikely in reality that there would be fractions of a minute
-      .coolTime_minutes          = boil->coolTime_mins(),
-      .kettleInternalDiameter_cm = equipment->kettleInternalDiameter_cm(),
-      .kettleOpeningDiameter_cm  = equipment->kettleOpeningDiameter_cm (),
-   };
-   if (hopAddition.isFirstWort()) {
-      ibus = fwhAdjust * IbuMethods::getIbus(parms);
-   } else if (hopAddition.stage() == RecipeAddition::Stage::Boil) {
-      parms.boilTime_minutes = minutes;
-      ibus = IbuMethods::getIbus(parms);
-   } else if (hopAddition.stage() == RecipeAddition::Stage::Mash && mashHopAdjust > 0.0) {
-      ibus = mashHopAdjust * IbuMethods::getIbus(parms);
-   }
-
-   // Adjust for hopAddition form. Tinseth's table was created from whole cone data,
-   // and it seems other formulae are optimized that way as well. So, the
-   // utilization is considered unadjusted for whole cones, and adjusted
-   // up for plugs and pellets.
-   //
-   // - http://www.realbeer.com/hops/FAQ.html
-   // - https://groups.google.com/forum/#!topic"brewtarget.h"lp/mv2qvWBC4sU
-   auto const hopForm = hopAddition.hop()->form();
-   if (hopForm) {
-      switch (*hopForm) {
-         case Hop::Form::Plug:
-            hopUtilization *= 1.02;
-            break;
-         case Hop::Form::Pellet:
-            hopUtilization *= 1.10;
-            break;
-         default:
-            break;
-      }
-   }
-
-   // Adjust for hopAddition utilization.
-   ibus *= hopUtilization;
-
-   return ibus;
+   return this->pimpl->ibuFromHopAddition(
+      hopAddition,
+      RecipeEvaluator::snapshotOf(hopAddition),
+      equipment ? std::make_optional(RecipeEvaluator::snapshotOf(*equipment)) : std::nullopt,
+      boil      ? std::make_optional(RecipeEvaluator::snapshotOf(*boil     )) : std::nullopt
+   );
 }
 
 QList<QString> Recipe::getReagents(QList<std::shared_ptr<RecipeAdditionFermentable>> fermentableAdditions) {
@@ -3030,34 +3330,28 @@ QList<QString> Recipe::getReagents(QList< std::shared_ptr<MashStep> > msteps) {
 
 //==========================Accept changes from ingredients====================
 
-void Recipe::acceptChangeToContainedObject(QMetaProperty prop, QVariant val) {
+void Recipe::acceptChangeToContainedObject(int key, int propertyIndex) {
    // This tells us which object sent us the signal
    QObject * signalSender = this->sender();
    if (signalSender != nullptr) {
+      // Changes we make here (eg to the boil) and the resulting recalculation are all part of the same logical edit
+      NamedEntityChangeBatch changeBatch;
       QString signalSenderClassName = signalSender->metaObject()->className();
+      QMetaProperty const prop = signalSender->metaObject()->property(propertyIndex);
       QString propName = prop.name();
-      qDebug() <<
-         Q_FUNC_INFO << "Signal received from " << signalSenderClassName << ": changed" << propName << "to" << val;;
+      qCDebug(Logging::recipe) <<
+         Q_FUNC_INFO << "Signal received from " << signalSenderClassName << "#" << key << ": changed" << propName;
       Equipment * equipment = qobject_cast<Equipment *>(signalSender);
       if (equipment) {
-         qDebug() << Q_FUNC_INFO << "Equipment #" << equipment->key() << "(ours=" << this->m_equipmentId << ")";
+         qCDebug(Logging::recipe) <<
+            Q_FUNC_INFO << "Equipment #" << equipment->key() << "(ours=" << this->m_equipmentId << ")";
          Q_ASSERT(equipment->key() == this->m_equipmentId);
-         if (propName == *PropertyNames::Equipment::kettleBoilSize_l) {
-            Q_ASSERT(val.canConvert<double>());
-            qDebug() << Q_FUNC_INFO << "We" << (this->boil() ? "have" : "don't have") << "a boil";
-            if (this->boil()) {
-               this->boil()->setPreBoilSize_l(val.value<double>());
-            }
-         } else if (propName == PropertyNames::Equipment::boilTime_min) {
-            Q_ASSERT(val.canConvert<double>());
-            if (this->boil()) {
-               this->boil()->setBoilTime_mins(val.value<double>());
-            }
-         }
+         // Only Equipment changes need the new value, so this is the one case where we read it
+         this->pimpl->acceptEquipmentChange(propName, prop.read(equipment));
       }
       this->recalcIfNeeded(signalSenderClassName);
    } else {
-      qDebug() << Q_FUNC_INFO << "No sender";
+      qCDebug(Logging::recipe) << Q_FUNC_INFO << "No sender";
    }
    return;
 }
@@ -3100,7 +3394,7 @@ double Recipe::targetCollectedWortVol_l() {
    }
 
    double boilSize_liters = this->pimpl->boilSizeInLitersOr(0.0);
-   qDebug() << Q_FUNC_INFO << "Boil size:" << boilSize_liters;
+   qCDebug(Logging::recipe) << Q_FUNC_INFO << "Boil size:" << boilSize_liters;
 
    if (this->equipment()) {
       return boilSize_liters - this->equipment()->getLauteringDeadspaceLoss_l()
@@ -3188,7 +3482,7 @@ void RecipeHelper::prepareForPropertyChange(NamedEntity & ne, BtStringConst cons
       return;
    }
 
-   qDebug() <<
+   qCDebug(Logging::recipe) <<
       Q_FUNC_INFO << "Modifying: " << ne.metaObject()->className() << "#" << ne.key() << "property" << propertyName;
 
    //
@@ -3215,7 +3509,8 @@ void RecipeHelper::prepareForPropertyChange(NamedEntity & ne, BtStringConst cons
 
    // If the object we're about to change already has descendants, then we don't want to create new ones.
    if (owningRecipe->hasDescendants()) {
-      qDebug() << Q_FUNC_INFO << "Recipe #" << owningRecipe->key() << "already has descendants, so not creating any more";
+      qCDebug(Logging::recipe) <<
+         Q_FUNC_INFO << "Recipe #" << owningRecipe->key() << "already has descendants, so not creating any more";
       return;
    }
 
@@ -3233,14 +3528,15 @@ void RecipeHelper::prepareForPropertyChange(NamedEntity & ne, BtStringConst cons
 
    // Create a deep copy of the Recipe, and put it in the DB, so it has an ID.
    // (This will also emit signalObjectInserted for the new Recipe from ObjectStoreTyped<Recipe>.)
-   qDebug() << Q_FUNC_INFO << "Copying Recipe" << owningRecipe->key();
+   qCDebug(Logging::recipe) << Q_FUNC_INFO << "Copying Recipe" << owningRecipe->key();
 
    // We also don't want to trigger versioning on the newly spawned Recipe until we're completely done here!
    std::shared_ptr<Recipe> spawn = std::make_shared<Recipe>(*owningRecipe);
    NamedEntityModifyingMarker spawnModifyingMarker(*spawn);
    ObjectStoreWrapper::insert(spawn);
 
-   qDebug() << Q_FUNC_INFO << "Copied Recipe #" << owningRecipe->key() << "to new Recipe #" << spawn->key();
+   qCDebug(Logging::recipe) <<
+      Q_FUNC_INFO << "Copied Recipe #" << owningRecipe->key() << "to new Recipe #" << spawn->key();
 
    // We assert that the newly created version of the recipe has not yet been brewed (and therefore will not get
    // automatically versioned on subsequent changes before it is brewed).
@@ -3274,14 +3570,14 @@ bool RecipeHelper::getAutomaticVersioningEnabled() {
 RecipeHelper::SuspendRecipeVersioning::SuspendRecipeVersioning() {
    this->savedVersioningValue = RecipeHelper::getAutomaticVersioningEnabled();
    if (this->savedVersioningValue) {
-      qDebug() << Q_FUNC_INFO << "Temporarily suspending automatic Recipe versioning";
+      qCDebug(Logging::recipe) << Q_FUNC_INFO << "Temporarily suspending automatic Recipe versioning";
       RecipeHelper::setAutomaticVersioningEnabled(false);
    }
    return;
 }
 RecipeHelper::SuspendRecipeVersioning::~SuspendRecipeVersioning() {
    if (this->savedVersioningValue) {
-      qDebug() << Q_FUNC_INFO << "Re-enabling automatic Recipe versioning";
+      qCDebug(Logging::recipe) << Q_FUNC_INFO << "Re-enabling automatic Recipe versioning";
       RecipeHelper::setAutomaticVersioningEnabled(true);
    }
    return;
@@ -136,6 +136,9 @@ class Salt;
 class Style;
 class Water;
 class Yeast;
+namespace RecipeEvaluator {
+   struct Results;
+}
 
 
 /*!
@@ -149,7 +152,7 @@ class Recipe : public NamedEntity,
    FOLDER_BASE_DECL(Recipe)
 
    /**
-    * \brief \c MainWindow is a friend so it can access \c Recipe::recalcAll() and \c Recipe::recalcIfNeeded()
+    * \brief \c MainWindow is a friend so it can access \c Recipe::recalcIfNeeded()
     *
     *        In the long run, we should fix this, so that \c MainWindow doesn't need to call private member functions on
     *        \c Recipe.
@@ -400,15 +403,28 @@ public:
    virtual void setKey(int key);
 
    /**
-    * \brief Connect Fermentable, Hop changed signals etc to their parent Recipes.
+    * \brief Make sure changes to Fermentables, Hops etc reach their parent Recipes.
     *
     *        This is needed because each Recipe needs to know when one of its constituent parts has been modified, eg
     *        if the alpha acid on a hop is modified then that will affect the recipe's IBU.
     *
+    *        We don't connect every Recipe's contained objects up-front, as, with a big database, that's a lot of
+    *        connections to make (and hold in memory) before we can show anything.  Instead, a Recipe makes its own
+    *        connections the first time it is calculated -- until then it has no calculated values that could be out of
+    *        date.  What this function does is connect the one dispatcher for changes that have to be applied to a
+    *        Recipe regardless (ie Equipment boil size and time, which get copied to the Recipe's Boil).
+    *
     *        Needs to be called \b after all the calls to ObjectStoreTyped<FooBar>::getInstance().loadAll()
     */
    static void connectSignalsForAllRecipes();
 
+   /**
+    * \brief Say which recipe (if any) is currently shown to the user.  When something shared by many recipes, such as
+    *        an \c Equipment, changes, only this recipe is recalculated straight away.  The others just note that their
+    *        calculated values are out of date and redo them when one of those values is next asked for.
+    */
+   static void setDisplayedRecipe(Recipe const * recipe);
+
    /*!
     * \brief Add (a copy if necessary of) a Hop/Fermentable/Instruction etc (that may or may not already be in an
     *        ObjectStore).
@@ -473,6 +489,20 @@ public:
       return ObjectStoreWrapper::findFirstMatching<Recipe>( [var](Recipe * rec) {return rec->uses(var);} );
    }
 
+   /*!
+    * \brief Find all recipes that use \c var, which must be an \c Equipment, \c Style, \c Mash, \c Boil or
+    *        \c Fermentation.  The recipe's ID property for each of these is indexed in the \c ObjectStore, so, unlike
+    *        \c findOwningRecipe, this does not have to look at every recipe.
+    *
+    * \return Matching recipes in ID order (empty if \c var is not stored)
+    */
+   template<class T> static QList<Recipe *> findAllUsing(T const & var) {
+      if (var.key() <= 0) {
+         return {};
+      }
+      return ObjectStoreWrapper::findByIndexRaw<Recipe>(Recipe::propertyNameFor<T>(), var.key());
+   }
+
    int instructionNumber(Instruction const & ins) const;
    /*!
     * \brief Swap instructions \c ins1 and \c ins2
@@ -705,10 +735,36 @@ public:
     */
    virtual void hardDeleteOrphanedEntities();
 
+   /**
+    * \brief Recalculates all the calculated properties.  Normally this happens automatically, but callers that turn
+    *        calculations off (see \c setCalcsEnabled) to make a lot of changes at once need to call it afterwards.
+    *
+    *        WARNING: this call took 0.15s in rev 916!
+    */
+   void recalcAll();
+
+   /**
+    * \brief Goes up by one every time this recipe redoes any of its calculations because something in it changed.
+    *        \c RecipeEvaluator::recalculateAllRecipes uses this to spot when results it worked out from an earlier
+    *        snapshot of the recipe are out of date.
+    */
+   unsigned int calcGeneration() const;
+
+   /**
+    * \brief Store calculated values that were worked out elsewhere from a snapshot of this recipe.  Unlike the normal
+    *        calculations, this does not emit \c changed(); it is for the caller to tell listeners about all the
+    *        changes in one go.  See \c RecipeEvaluator::recalculateAllRecipes.
+    */
+   void setCalculatedValues(RecipeEvaluator::Results const & results);
+
 signals:
 
 public slots:
-   void acceptChangeToContainedObject(QMetaProperty prop, QVariant val);
+   /**
+    * \brief Connected to the \c NamedEntity::propertyChanged signal of the objects we use (equipment, mash,
+    *        ingredients, additions, etc) so that we can recalculate what depends on them.
+    */
+   void acceptChangeToContainedObject(int key, int propertyIndex);
 
 protected:
    virtual bool isEqualTo(NamedEntity const & other) const;
@@ -762,18 +818,19 @@ private:
 
    // version things
    int                     m_ancestor_id;
+   //! Cached list of ancestors -- see \c ancestors()
    mutable QList<Recipe *> m_ancestors;
+   //! Value of the global ancestry generation counter when we last built \c m_ancestors
+   mutable unsigned int    m_ancestorsGeneration;
    mutable bool            m_hasDescendants;
 
    // Some recalculators for calculated properties.
 
-   void recalcIfNeeded(QString classNameOfWhatWasAddedOrChanged);
-
-   /* Recalculates all the calculated properties.
-    *
-    * WARNING: this call took 0.15s in rev 916!
+   /**
+    * \brief Redo the calculations that use objects of the supplied class (eg \c Hop or \c RecipeAdditionHop), and any
+    *        calculations that depend on results that change as a result.  See \c Recipe::impl::recalcDirty.
     */
-   void recalcAll();
+   void recalcIfNeeded(QString classNameOfWhatWasAddedOrChanged);
 };
 
 // Need specialisations for abstract types
@@ -22,6 +22,7 @@
 #include "model/InventorySalt.h"
 #include "model/NamedParameterBundle.h"
 #include "model/Recipe.h"
+#include "utils/Fingerprint.h"
 
 namespace {
    // Constants used in our mass concentration calculations below
@@ -76,6 +77,13 @@ bool Salt::isEqualTo(NamedEntity const & other) const {
    );
 }
 
+std::size_t Salt::fingerprintFields(std::size_t const seed) const {
+   // All the fields compared in isEqualTo
+   std::size_t result = seed;
+   result = Utils::fingerprintCombine(result, this->m_type);
+   return result;
+}
+
 ObjectStore & Salt::getObjectStoreTypedInstance() const {
    return ObjectStoreTyped<Salt>::getInstance();
 }
@@ -18,6 +18,7 @@
 #pragma once
 
 #include <algorithm>
+#include <atomic>
 #include <memory>
 #include <optional>
 
@@ -27,6 +28,7 @@
 
 #include "database/ObjectStoreWrapper.h"
 #include "model/Recipe.h"
+#include "model/Step.h"
 #include "utils/CuriouslyRecurringTemplateBase.h"
 
 //======================================================================================================================
@@ -80,11 +82,11 @@ public:
    // Note that, because this is static, it cannot be initialised inside the class definition
    static TypeLookup const typeLookup;
 
-   StepOwnerBase() : m_stepIds{} {
+   StepOwnerBase() : m_stepIds{}, m_stepSignalsConnected{false} {
       return;
    }
 
-   StepOwnerBase(StepOwnerBase const & other) {
+   StepOwnerBase(StepOwnerBase const & other) : m_stepIds{}, m_stepSignalsConnected{false} {
       // Deep copy of MashSteps
       for (auto step : other.steps()) {
          // Make a copy of the current DerivedStep object we're looking at in the other Mash
@@ -125,16 +127,26 @@ public:
             steps.append(ObjectStoreWrapper::getById<DerivedStep>(ii));
          }
       } else {
-         steps = ObjectStoreWrapper::findAllMatching<DerivedStep>(
-            [myId](std::shared_ptr<DerivedStep> const step) {return step->ownerId() == myId && !step->deleted();}
-         );
-
-         // Now we've got the Steps, we need to make sure they're in the right order
-         std::sort(steps.begin(),
-                   steps.end(),
-                   [](std::shared_ptr<DerivedStep> const lhs, std::shared_ptr<DerivedStep> const rhs) {
-                      return lhs->stepNumber() < rhs->stepNumber();
-                   });
+         //
+         // Step number is the sort key of the step tables, so the store gives us the steps in the right order, and
+         // only has to sort them again after one of them is added, removed or renumbered.
+         //
+         for (auto step : ObjectStoreWrapper::findByIndex<DerivedStep>(PropertyNames::Step::ownerId, myId)) {
+            if (!step->deleted()) {
+               steps.append(step);
+            }
+         }
+
+         //
+         // Rather than connect every step of every Derived at start-up, we connect the ones we loaded from the DB the
+         // first time anyone asks for them.  Anything that wants to change one of our steps has to get hold of it
+         // first, and, until then, there's no-one to tell about our calculated properties changing.
+         //
+         if (!this->m_stepSignalsConnected.exchange(true)) {
+            for (auto const & step : steps) {
+               this->connectStep(*step);
+            }
+         }
       }
 
       return steps;
@@ -174,6 +186,7 @@ public:
       }
 
       Q_ASSERT(step->key() > 0);
+      this->connectStep(*step);
 
       //
       // If the Derived itself is not yet stored in the DB then it needs to hang on to its list of DerivedSteps so that,
@@ -299,16 +312,15 @@ public:
    }
 
    /**
-    * \brief Connect DerivedStep changed signals to their parent Mashes.
-    *
-    *        Needs to be called \b after all the calls to ObjectStoreTyped<FooBar>::getInstance().loadAll()
+    * \brief Connect \c step's changed signal to our \c acceptStepChange, unless that's already done.  (Connecting
+    *        doesn't change our logical state, so this can be called from \c steps().)
     */
-   static void doConnectSignals() {
-      for (auto dd : ObjectStoreTyped<Derived>::getInstance().getAllRaw()) {
-         for (auto step : dd->steps()) {
-            Derived::connect(step.get(), &NamedEntity::changed, dd, &Derived::acceptStepChange);
-         }
-      }
+   void connectStep(DerivedStep const & step) const {
+      Derived::connect(&step,
+                       &NamedEntity::changed,
+                       &this->derived(),
+                       &Derived::acceptStepChange,
+                       Qt::UniqueConnection);
       return;
    }
 
@@ -337,7 +349,8 @@ public:
     * \brief Needs to be called from Derived::getOwningRecipe (which is virtual)
     */
    Recipe * doGetOwningRecipe() const {
-      return ObjectStoreWrapper::findFirstMatching<Recipe>( [this](Recipe * rec) {return rec->uses(this->derived());} );
+      auto const recipes = Recipe::findAllUsing(this->derived());
+      return recipes.isEmpty() ? nullptr : recipes.first();
    }
 
    /**
@@ -442,6 +455,9 @@ private:
 
 protected:
    QVector<int> m_stepIds;
+
+   //! Whether \c steps() has connected the steps it loaded from the DB (see there)
+   mutable std::atomic<bool> m_stepSignalsConnected;
 };
 
 template<class Derived, class DerivedStep>
@@ -485,11 +501,6 @@ TypeLookup const StepOwnerBase<Derived, DerivedStep>::typeLookup {
       QList<std::shared_ptr<NeName##Step>> LcNeName##Steps        () const;              \
       void set##NeName##Steps        (QList<std::shared_ptr<NeName##Step>> const & val); \
                                                                                          \
-      /** \brief Connect DerivedStep changed signals to their parent Mashes. */          \
-      /*         Needs to be called \b after all the calls to                */          \
-      /*         ObjectStoreTyped<FooBar>::getInstance().loadAll()           */          \
-      static void connectSignals();                                                      \
-                                                                                         \
       virtual void setKey(int key);                                                      \
                                                                                          \
       virtual Recipe * getOwningRecipe() const;                                          \
@@ -515,8 +526,6 @@ TypeLookup const StepOwnerBase<Derived, DerivedStep>::typeLookup {
       this->setSteps(val); return;                                                                        \
    }                                                                                                      \
                                                                                                           \
-   void NeName::connectSignals() { StepOwnerBase<NeName, NeName##Step>::doConnectSignals(); return; }     \
-                                                                                                          \
    void NeName::setKey(int key) { this->doSetKey(key); return; }                                          \
                                                                                                           \
    Recipe * NeName::getOwningRecipe() const { return this->doGetOwningRecipe(); }                         \
@@ -24,6 +24,7 @@
 #include "model/NamedParameterBundle.h"
 #include "model/Recipe.h"
 #include "utils/AutoCompare.h"
+#include "utils/Fingerprint.h"
 
 QString Style::localisedName() { return tr("Style"); }
 
@@ -59,6 +60,17 @@ bool Style::isEqualTo(NamedEntity const & other) const {
    );
 }
 
+std::size_t Style::fingerprintFields(std::size_t const seed) const {
+   // All the fields compared in isEqualTo
+   std::size_t result = seed;
+   result = Utils::fingerprintCombine(result, this->m_category      );
+   result = Utils::fingerprintCombine(result, this->m_categoryNumber);
+   result = Utils::fingerprintCombine(result, this->m_styleLetter   );
+   result = Utils::fingerprintCombine(result, this->m_styleGuide    );
+   result = Utils::fingerprintCombine(result, this->m_type          );
+   return result;
+}
+
 ObjectStore & Style::getObjectStoreTypedInstance() const {
    return ObjectStoreTyped<Style>::getInstance();
 }
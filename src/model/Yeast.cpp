@@ -28,6 +28,7 @@
 #include "model/Recipe.h"
 #include "PhysicalConstants.h"
 #include "utils/AutoCompare.h"
+#include "utils/Fingerprint.h"
 
 QString Yeast::localisedName() { return tr("Yeast"); }
 
@@ -128,7 +129,7 @@ bool Yeast::isEqualTo(NamedEntity const & other) const {
       Utils::AutoCompare(this->m_flocculation             , rhs.m_flocculation             ) &&
       Utils::AutoCompare(this->m_attenuationMin_pct       , rhs.m_attenuationMin_pct       ) &&
       Utils::AutoCompare(this->m_attenuationMax_pct       , rhs.m_attenuationMax_pct       ) &&
-      Utils::AutoCompare(this->m_notes                    , rhs.m_notes                    ) &&
+      Utils::AutoCompare(this->notes()                    , rhs.notes()                    ) &&
       Utils::AutoCompare(this->m_bestFor                  , rhs.m_bestFor                  ) &&
       Utils::AutoCompare(this->m_maxReuse                 , rhs.m_maxReuse                 ) &&
       Utils::AutoCompare(this->m_phenolicOffFlavorPositive, rhs.m_phenolicOffFlavorPositive) &&
@@ -141,6 +142,16 @@ bool Yeast::isEqualTo(NamedEntity const & other) const {
    );
 }
 
+std::size_t Yeast::fingerprintFields(std::size_t const seed) const {
+   // Same "outline" fields as in isEqualTo
+   std::size_t result = seed;
+   result = Utils::fingerprintCombine(result, this->m_type      );
+   result = Utils::fingerprintCombine(result, this->m_form      );
+   result = Utils::fingerprintCombine(result, this->m_laboratory);
+   result = Utils::fingerprintCombine(result, this->m_productId );
+   return result;
+}
+
 ObjectStore & Yeast::getObjectStoreTypedInstance() const {
    return ObjectStoreTyped<Yeast>::getInstance();
 }
@@ -253,7 +264,7 @@ Yeast::Yeast(Yeast const & other) :
    m_minTemperature_c         {other.m_minTemperature_c         },
    m_maxTemperature_c         {other.m_maxTemperature_c         },
    m_flocculation             {other.m_flocculation             },
-   m_notes                    {other.m_notes                    },
+   m_notes                    {other.notes()                    },
    m_bestFor                  {other.m_bestFor                  },
    m_maxReuse                 {other.m_maxReuse                 },
    m_alcoholTolerance_pct     {other.m_alcoholTolerance_pct     },
@@ -282,7 +293,7 @@ std::optional<double>              Yeast::minTemperature_c         () const { re
 std::optional<double>              Yeast::maxTemperature_c         () const { return                    m_maxTemperature_c         ; } // ⮜⮜⮜ Optional in BeerXML ⮞⮞⮞
 std::optional<Yeast::Flocculation> Yeast::flocculation             () const { return                    m_flocculation             ; } // ⮜⮜⮜ Optional in BeerXML ⮞⮞⮞
 std::optional<int>                 Yeast::flocculationAsInt        () const { return Optional::toOptInt(m_flocculation)            ; } // ⮜⮜⮜ Optional in BeerXML ⮞⮞⮞
-QString                            Yeast::notes                    () const { return                    m_notes                    ; }
+QString                            Yeast::notes                    () const { return this->lazyText(PropertyNames::Yeast::notes, m_notes); }
 QString                            Yeast::bestFor                  () const { return                    m_bestFor                  ; }
 std::optional<int>                 Yeast::maxReuse                 () const { return                    m_maxReuse                 ; } // ⮜⮜⮜ Optional in BeerXML ⮞⮞⮞
 // ⮜⮜⮜ All below added for BeerJSON support ⮞⮞⮞
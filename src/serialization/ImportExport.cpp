@@ -16,27 +16,66 @@
  ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
 #include "serialization/ImportExport.h"
 
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <vector>
+
+#include <QApplication>
+#include <QElapsedTimer>
 #include <QFile>
 #include <QFileDialog>
+#include <QFileInfo>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
 #include <QMessageBox>
 #include <QObject>
+#include <QProgressDialog>
+#include <QRunnable>
+#include <QSet>
+#include <QSqlError>
+#include <QThreadPool>
 
+#include "database/BtSqlQuery.h"
+#include "database/ChangeLog.h"
+#include "database/Database.h"
+#include "database/DbTransaction.h"
+#include "database/ObjectStoreTyped.h"
+#include "database/ObjectStoreWrapper.h"
+#include "Logging.h"
 #include "MainWindow.h"
+#include "model/Boil.h"
+#include "model/BoilStep.h"
 #include "model/Equipment.h"
 #include "model/Fermentable.h"
+#include "model/Fermentation.h"
+#include "model/FermentationStep.h"
 #include "model/Hop.h"
+#include "model/Mash.h"
+#include "model/MashStep.h"
 #include "model/Misc.h"
 #include "model/Recipe.h"
 #include "model/RecipeAdditionFermentable.h"
 #include "model/RecipeAdditionHop.h"
 #include "model/RecipeAdditionMisc.h"
 #include "model/RecipeAdditionYeast.h"
+#include "model/RecipeAdjustmentSalt.h"
 #include "model/RecipeUseOfWater.h"
+#include "model/Salt.h"
 #include "model/Style.h"
 #include "model/Water.h"
 #include "model/Yeast.h"
+#include "PersistentSettings.h"
 #include "serialization/json/BeerJson.h"
 #include "serialization/xml/BeerXml.h"
+#include "utils/BtException.h"
+#include "utils/Compression.h"
+#include "utils/ImportRecordCount.h"
 
 namespace {
    enum class ImportOrExport {
@@ -70,8 +109,11 @@ namespace {
          importing ? QObject::tr("Open") : QObject::tr("Save"),
          fileChooserDirectory,
          importing ?
-            QObject::tr("BeerJSON and BeerXML files (*.json *.xml);;BeerJSON files (*.json);;BeerXML files (*.xml)") :
-            QObject::tr("BeerJSON format (*.json);;BeerXML format (*.xml)")
+            QObject::tr("BeerJSON and BeerXML files (*.json *.bjb *.xml *.json.gz *.xml.gz *.zip);;"
+                        "BeerJSON files (*.json *.json.gz);;Binary BeerJSON files (*.bjb);;"
+                        "BeerXML files (*.xml *.xml.gz);;Zip archives (*.zip)") :
+            QObject::tr("BeerJSON format (*.json);;Binary BeerJSON format (*.bjb);;BeerXML format (*.xml);;"
+                        "Compressed BeerJSON format (*.json.gz);;Compressed BeerXML format (*.xml.gz)")
       };
       fileChooser.setViewMode(QFileDialog::List);
       if (importing) {
@@ -93,8 +135,8 @@ namespace {
          return std::nullopt;
       }
 
-      qDebug() << Q_FUNC_INFO << "Selected " << fileChooser.selectedFiles().length() << " files";
-      qDebug() << Q_FUNC_INFO << "Directory " << fileChooser.directory();
+      qCDebug(Logging::serialization) << Q_FUNC_INFO << "Selected " << fileChooser.selectedFiles().length() << " files";
+      qCDebug(Logging::serialization) << Q_FUNC_INFO << "Directory " << fileChooser.directory();
 
       // Remember the directory for next time
       fileChooserDirectory = fileChooser.directory().canonicalPath();
@@ -148,7 +190,7 @@ namespace {
             }
          }
       }
-      qDebug() << Q_FUNC_INFO << "Message box text : " << messageBoxText;
+      qCDebug(Logging::serialization) << Q_FUNC_INFO << "Message box text : " << messageBoxText;
       QMessageBox msgBox{succeeded ? QMessageBox::Information : QMessageBox::Critical,
                          messageBoxTitle,
                          messageBoxText};
@@ -187,6 +229,101 @@ namespace {
       }
       return ingredientSet;
    }
+
+   /**
+    * \brief Result of the first stage of importing one file (see \c ImportExport::importFromFiles)
+    */
+   struct ValidatedFile {
+      //! Loads the file's contents and stores them in the DB.  Empty if the file was unreadable or invalid.
+      std::function<bool(QTextStream &)> loadAndStoreInDb;
+      //! Explanation of why the file was invalid, or (after loading) summary of what was imported
+      QString userMessage;
+   };
+
+   /**
+    * \brief One document to import (see \c ImportExport::importFiles).  This is either a file, which may be
+    *        gzip-compressed, or an entry in a zip archive.
+    */
+   struct ImportSource {
+      //! Which of the files we were asked to import this came from
+      int inputIndex;
+      //! Name of the file or, for an archive entry, the archive's name followed by the entry's path inside the archive
+      QString name;
+      //! Empty unless this is an archive entry
+      QString archiveName;
+      std::optional<Compression::ZipEntry> zipEntry;
+   };
+
+   bool isGzipName(QString const & name) {
+      return name.endsWith(".gz", Qt::CaseInsensitive);
+   }
+
+   /**
+    * \return The file extension that tells us what format \c name is in, ignoring any ".gz" on the end
+    */
+   QString formatSuffix(QString const & name) {
+      return QFileInfo{isGzipName(name) ? name.chopped(3) : name}.suffix().toLower();
+   }
+
+   bool isImportableName(QString const & name) {
+      QString const suffix = formatSuffix(name);
+      return suffix == "json" || suffix == "bjb" || suffix == "xml";
+   }
+
+   /**
+    * \brief Read and validate one file.  This is called on worker threads, so must not touch the DB or the model.
+    */
+   ValidatedFile readAndValidate(ImportSource const & source) {
+      QString const & filename = source.name;
+      qCDebug(Logging::serialization) << Q_FUNC_INFO << "Reading and validating " << filename;
+      QElapsedTimer timer;
+      timer.start();
+      ValidatedFile validatedFile;
+      QTextStream userMessageAsStream{&validatedFile.userMessage};
+      QString const suffix = formatSuffix(filename);
+      bool const isJson = (suffix == "json" || suffix == "bjb");
+      if (!isJson && suffix != "xml") {
+         qCInfo(Logging::serialization) <<
+            Q_FUNC_INFO << "Don't understand file extension on" << filename << "so ignoring!";
+      } else if (!source.zipEntry && !isGzipName(filename)) {
+         validatedFile.loadAndStoreInDb = isJson ?
+            BeerJson::readAndValidate(filename, userMessageAsStream) :
+            BeerXML::getInstance().readAndValidate(filename, userMessageAsStream);
+      } else {
+         //
+         // Compressed documents are decompressed into memory (a chunk at a time, so we never hold the compressed and
+         // decompressed versions of the whole thing at once), rather than to a temporary file.
+         //
+         QByteArray contents;
+         bool decompressed = false;
+         try {
+            if (source.zipEntry) {
+               contents = Compression::readZipEntry(source.archiveName, *source.zipEntry);
+            } else {
+               QFile inputFile{filename};
+               if (!inputFile.open(QIODevice::ReadOnly)) {
+                  throw BtException(QObject::tr("Could not open %1 for reading (error # %2)").arg(filename)
+                                                                                             .arg(inputFile.error()));
+               }
+               contents = Compression::gunzip(inputFile, filename);
+            }
+            decompressed = true;
+         } catch (BtException const & exception) {
+            userMessageAsStream << exception.what();
+         }
+         if (decompressed) {
+            validatedFile.loadAndStoreInDb = isJson ?
+               BeerJson::readAndValidate(filename, contents, userMessageAsStream) :
+               BeerXML::getInstance().readAndValidate(filename, contents, userMessageAsStream);
+         }
+      }
+      userMessageAsStream.flush();
+      // Logged here, rather than in ImportRecordCount, as for most files this happens before loading starts
+      qCInfo(Logging::serialization) <<
+         Q_FUNC_INFO << "Read and validated" << filename << "in" << timer.elapsed() << "ms:" <<
+         (validatedFile.loadAndStoreInDb ? "OK" : "FAILED");
+      return validatedFile;
+   }
 }
 
 bool ImportExport::importFromFiles(std::optional<QStringList> inputFiles) {
@@ -197,27 +334,44 @@ bool ImportExport::importFromFiles(std::optional<QStringList> inputFiles) {
       return false;
    }
 
-   bool allSucceeded = true;
-   for (QString filename : *inputFiles) {
-      //
-      // I guess if the user were importing a lot of files in one go, it might be annoying to have a separate result
-      // message for each one, but TBD whether that's much of a use case.  For now, we keep things simple.
-      //
-      qDebug() << Q_FUNC_INFO << "Importing " << filename;
-      QString userMessage;
-      QTextStream userMessageAsStream{&userMessage};
-      bool succeeded = false;
-      if (filename.endsWith("json", Qt::CaseInsensitive)) {
-         succeeded = BeerJson::import(filename, userMessageAsStream);
-      } else if (filename.endsWith("xml", Qt::CaseInsensitive)) {
-         succeeded = BeerXML::getInstance().importFromXML(filename, userMessageAsStream);
-      } else {
-         qInfo() << Q_FUNC_INFO << "Don't understand file extension on" << filename << "so ignoring!";
+   int const numFiles = inputFiles->size();
+   QProgressDialog progress{QObject::tr("Reading files..."),
+                            QObject::tr("Cancel"),
+                            0,
+                            2 * numFiles,
+                            &MainWindow::instance()};
+   progress.setWindowModality(Qt::WindowModal);
+   progress.setValue(0);
+
+   QVector<FileImportResult> const results = ImportExport::importFiles(
+      *inputFiles,
+      [&progress](int const stepsDone, int const totalSteps, QString const & label) {
+         if (!label.isEmpty()) {
+            progress.setLabelText(label);
+         }
+         // Archives count for as many steps as they have entries, so we only know the total once they've been opened
+         progress.setMaximum(totalSteps);
+         progress.setValue(stepsDone);
+         // Keep the UI responsive
+         QApplication::processEvents();
+         return !progress.wasCanceled();
       }
-      qDebug() << Q_FUNC_INFO << "Import " << (succeeded ? "succeeded" : "failed");
-      importExportMsg(ImportOrExport::IMPORT, filename, succeeded, userMessage);
+   );
+   bool const cancelled = progress.wasCanceled();
+   progress.setValue(progress.maximum());
 
-      allSucceeded &= succeeded;
+   //
+   // I guess if the user were importing a lot of files in one go, it might be annoying to have a separate result
+   // message for each one, but TBD whether that's much of a use case.  For now, we keep things simple.
+   //
+   // If the user cancelled, we don't show messages for the files we didn't get round to.
+   //
+   bool allSucceeded = !cancelled;
+   for (auto const & result : results) {
+      if (result.attempted) {
+         importExportMsg(ImportOrExport::IMPORT, result.fileName, result.succeeded, result.userMessage);
+      }
+      allSucceeded &= result.succeeded;
    }
 
    MainWindow::instance().showChanges();
@@ -225,6 +379,186 @@ bool ImportExport::importFromFiles(std::optional<QStringList> inputFiles) {
    return allSucceeded;
 }
 
+QVector<ImportExport::FileImportResult> ImportExport::importFiles(QStringList const & inputFiles,
+                                                                  ImportProgressCallback const & progressCallback) {
+   //
+   // Importing is done in two stages:
+   //
+   //  1. Reading each file in and validating it against its schema.  For larger files, this is where most of the time
+   //     goes, and, since it doesn't touch the DB or the model, we can do it for all the files in parallel.
+   //
+   //  2. Loading the contents of each valid file into model objects and storing them in the DB (which is also where
+   //     we detect duplicates).  This has to happen on the main thread, as that is where model objects live and it is
+   //     the only thread the ObjectStores are written from.  So it is done one file at a time, in the order the files
+   //     were given to us.
+   //
+   // Each file therefore counts for two steps of progress: one for each stage.
+   //
+   // The caller can cancel at any point.  In stage 1, this just means we don't start reading any more files.  In stage
+   // 2, the file currently being loaded is rolled back (see ImportRecordCount::rollBack), and no more files are loaded.
+   // Files that were already loaded are kept, as each one is a separate import from the user's point of view.
+   //
+   // Storing each imported record has its own DbTransaction.  In stage 2, we put all the records from one file inside
+   // one outer transaction (which makes the inner ones savepoints -- see DbTransaction), so the DB only has to write
+   // everything out once per file rather than once per record.
+   //
+   BeerJson::loadExportSignatures();
+
+   int const numFiles = inputFiles.size();
+   QVector<FileImportResult> results(numFiles);
+   for (int ii = 0; ii < numFiles; ++ii) {
+      results[ii].fileName = inputFiles.at(ii);
+   }
+
+   //
+   // Zip archives are expanded into their entries here, so that the entries get read and validated in parallel just
+   // like separate files.  (Listing the entries only means reading the archive's central directory, so is quick.)
+   //
+   std::vector<ImportSource> sources;
+   sources.reserve(numFiles);
+   for (int ii = 0; ii < numFiles; ++ii) {
+      QString const & fileName = inputFiles.at(ii);
+      if (!fileName.endsWith(".zip", Qt::CaseInsensitive)) {
+         sources.push_back(ImportSource{ii, fileName, QString{}, std::nullopt});
+         continue;
+      }
+      try {
+         std::size_t const numSourcesBefore = sources.size();
+         for (Compression::ZipEntry const & entry : Compression::zipEntries(fileName)) {
+            QString const entryName = QString{"%1/%2"}.arg(fileName, entry.name);
+            // Archives often contain things other than recipes (eg a README), which we quietly skip
+            if (isImportableName(entryName)) {
+               sources.push_back(ImportSource{ii, entryName, fileName, entry});
+            }
+         }
+         if (sources.size() == numSourcesBefore) {
+            results[ii].attempted = true;
+            results[ii].userMessage = QObject::tr("No BeerJSON or BeerXML files found in archive");
+         }
+      } catch (BtException const & exception) {
+         results[ii].attempted = true;
+         results[ii].userMessage = exception.what();
+      }
+   }
+
+   int const numSources = static_cast<int>(sources.size());
+   bool cancelled = false;
+   auto const keepGoing = [&progressCallback, &cancelled, numSources](int const stepsDone, QString const & label) {
+      if (progressCallback && !progressCallback(stepsDone, 2 * numSources, label)) {
+         cancelled = true;
+      }
+      return !cancelled;
+   };
+
+   // Each stage 1 job writes only to its own element, so no locking is needed.  (We use std::vector rather than QVector
+   // to be sure nothing gets implicitly shared between threads.)
+   std::vector<ValidatedFile> validatedFiles(numSources);
+   std::atomic<int> numValidated{0};
+   {
+      QThreadPool threadPool;
+      for (int ii = 0; ii < numSources; ++ii) {
+         ValidatedFile * validatedFile = &validatedFiles[ii];
+         ImportSource const * source = &sources[ii];
+         threadPool.start(QRunnable::create([validatedFile, source, &numValidated]() {
+            *validatedFile = readAndValidate(*source);
+            ++numValidated;
+            return;
+         }));
+      }
+      while (!threadPool.waitForDone(50)) {
+         if (!keepGoing(numValidated, QString{})) {
+            // Removes the jobs that haven't started yet.  We still have to wait for the ones that have.
+            threadPool.clear();
+         }
+      }
+   }
+
+   //
+   // During importation we do not want automatic versioning turned on because, during the process of reading in a
+   // Recipe we'll end up creating load of versions of it.
+   //
+   RecipeHelper::SuspendRecipeVersioning suspendRecipeVersioning;
+
+   QString currentFileName;
+   int stepsDone = numSources;
+   ImportRecordCount::ScopedProgressCallback recordProgressCallback{
+      [&keepGoing, &currentFileName, &stepsDone](int const numRecords) {
+         return keepGoing(
+            stepsDone,
+            QObject::tr("Importing %1 (%n record(s))...", "", numRecords).arg(currentFileName)
+         );
+      }
+   };
+
+   // For archives, we count the entries imported, and only pass on the messages for the ones that failed, as there
+   // might be thousands of them
+   QVector<int> numArchiveEntries(numFiles, 0);
+   QVector<int> numArchiveEntriesImported(numFiles, 0);
+   QVector<QStringList> archiveFailures(numFiles);
+
+   for (int ii = 0; ii < numSources && !cancelled; ++ii) {
+      ImportSource const & source = sources[ii];
+      FileImportResult & result = results[source.inputIndex];
+      currentFileName = QFileInfo{source.name}.fileName();
+      stepsDone = numSources + ii;
+      keepGoing(stepsDone, QObject::tr("Importing %1...").arg(currentFileName));
+
+      result.attempted = true;
+      bool succeeded = false;
+      ValidatedFile & validatedFile = validatedFiles[ii];
+      if (validatedFile.loadAndStoreInDb) {
+         qCDebug(Logging::serialization) << Q_FUNC_INFO << "Importing " << source.name;
+         QTextStream userMessageAsStream{&validatedFile.userMessage};
+         //
+         // As in DefaultContentLoader, we commit this transaction even if the import fails, because anything that was
+         // imported OK is already in the object stores, so needs to be in the DB too.  (Records that failed will have
+         // been rolled back by their own DbTransaction, and, if the user cancelled, ImportRecordCount::rollBack will
+         // have deleted what was imported from this file.)
+         //
+         Database & database = Database::instance();
+         QSqlDatabase connection = database.sqlDatabase();
+         DbTransaction dbTransaction{database, connection, QString("Import %1").arg(currentFileName)};
+         succeeded = validatedFile.loadAndStoreInDb(userMessageAsStream);
+         if (!dbTransaction.commit()) {
+            succeeded = false;
+         }
+         // Clearing the function frees the parsed document, which can be large
+         validatedFile.loadAndStoreInDb = nullptr;
+      }
+      qCDebug(Logging::serialization) <<
+         Q_FUNC_INFO << "Import of " << source.name << (succeeded ? "succeeded" : "failed");
+
+      if (source.archiveName.isEmpty()) {
+         result.succeeded = succeeded;
+         result.userMessage = validatedFile.userMessage;
+         continue;
+      }
+      ++numArchiveEntries[source.inputIndex];
+      if (succeeded) {
+         ++numArchiveEntriesImported[source.inputIndex];
+      } else {
+         archiveFailures[source.inputIndex].append(
+            QString{"%1: %2"}.arg(source.name.mid(source.archiveName.size() + 1), validatedFile.userMessage)
+         );
+      }
+   }
+
+   for (int ii = 0; ii < numFiles; ++ii) {
+      if (numArchiveEntries[ii] > 0) {
+         results[ii].succeeded = archiveFailures[ii].isEmpty();
+         results[ii].userMessage =
+            QObject::tr("Imported %1 of %n file(s) from archive", "", numArchiveEntries[ii]).arg(
+               numArchiveEntriesImported[ii]
+            );
+         if (!archiveFailures[ii].isEmpty()) {
+            results[ii].userMessage += "\n\n" + archiveFailures[ii].join("\n");
+         }
+      }
+   }
+
+   return results;
+}
+
 
 void ImportExport::exportToFile(QList<Recipe      const *> const * recipes,
                                 QList<Equipment   const *> const * equipments,
@@ -249,21 +583,58 @@ void ImportExport::exportToFile(QList<Recipe      const *> const * recipes,
    if (!selectedFiles) {
       return;
    }
-   QString filename = (*selectedFiles)[0];
 
+   ImportExport::exportToNamedFile(
+      (*selectedFiles)[0], recipes, equipments, fermentables, hops, miscs, styles, waters, yeasts
+   );
+   return;
+}
+
+bool ImportExport::exportToNamedFile(QString const & filename,
+                                     QList<Recipe      const *> const * recipes,
+                                     QList<Equipment   const *> const * equipments,
+                                     QList<Fermentable const *> const * fermentables,
+                                     QList<Hop         const *> const * hops,
+                                     QList<Misc        const *> const * miscs,
+                                     QList<Style       const *> const * styles,
+                                     QList<Water       const *> const * waters,
+                                     QList<Yeast       const *> const * yeasts) {
    QString userMessage;
    QTextStream userMessageAsStream{&userMessage};
 
-   // Destructor will close the file if nec when we exit the function
-   QFile outFile;
-   outFile.setFileName(filename);
+   //
+   // Destructor will close the file if nec when we exit the function.  For a name ending in ".gz", the file compresses
+   // what we write to it, and we work out the format from the rest of the name.
+   //
+   bool const compressed = isGzipName(filename);
+   std::unique_ptr<QFile> const outFileOwner{
+      compressed ? std::unique_ptr<QFile>{std::make_unique<Compression::GzipFile>(filename)} :
+                   std::make_unique<QFile>(filename)
+   };
+   QFile & outFile = *outFileOwner;
+   QString const suffix = formatSuffix(filename);
 
    if (!outFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
-      qWarning() << Q_FUNC_INFO << "Could not open" << filename << "for writing.";
-      return;
+      qCWarning(Logging::serialization) << Q_FUNC_INFO << "Could not open" << filename << "for writing.";
+      return false;
+   }
+
+   //
+   // When exporting lots of records, the serializers render them on several threads at once (see
+   // utils/ParallelRender.h).  This is only safe if nothing is going to be created or calculated on first access
+   // while they do so.  So we make sure all objects exist and all recipe calculations are done up front, here on the
+   // GUI thread.
+   //
+   HydrateAllObjectStores();
+   if (recipes) {
+      for (Recipe const * recipe : *recipes) {
+         // Asking for any calculated value is enough to make sure they have all been calculated
+         const_cast<Recipe *>(recipe)->og();
+      }
    }
 
-   if (filename.endsWith("json", Qt::CaseInsensitive)) {
+   bool const binary = (suffix == "bjb");
+   if (binary || suffix == "json") {
       //
       // It's not strictly required by the BeerJSON standard, but we'll get a better export of Recipe if we also
       // explicitly export all the ingredients.  This is because, in BeerJSON (unlike BeerXML), the Recipe specification
@@ -288,7 +659,12 @@ void ImportExport::exportToFile(QList<Recipe      const *> const * recipes,
          }
       }
 
-      BeerJson::Exporter exporter(outFile, userMessageAsStream);
+      BeerJson::Exporter::Format format{BeerJson::Exporter::Format::Text};
+      if (binary) {
+         format = PersistentSettings::value(PersistentSettings::Names::compressBinaryBeerJsonExports, true).toBool() ?
+            BeerJson::Exporter::Format::CompressedBinary : BeerJson::Exporter::Format::Binary;
+      }
+      BeerJson::Exporter exporter(outFile, userMessageAsStream, format);
       if (!setOfFermentable.isEmpty()   ) { exporter.add(setOfFermentable.values()); }
       if (!setOfHop        .isEmpty()   ) { exporter.add(setOfHop        .values()); }
       if (!setOfMisc       .isEmpty()   ) { exporter.add(setOfMisc       .values()); }
@@ -299,10 +675,10 @@ void ImportExport::exportToFile(QList<Recipe      const *> const * recipes,
       if (recipes && recipes->size() > 0) { exporter.add(*recipes                 ); }
 
       exporter.close();
-      return;
+      return true;
    }
 
-   if (filename.endsWith("xml", Qt::CaseInsensitive)) {
+   if (suffix == "xml") {
       BeerXML & bxml = BeerXML::getInstance();
       // The slightly non-standard-XML format of BeerXML means the common bit (which gets written by createXmlFile) is
       // just at the start and there is no "closing" bit to write after we write all the data.
@@ -330,10 +706,494 @@ void ImportExport::exportToFile(QList<Recipe      const *> const * recipes,
       if (recipes      && recipes     ->size() > 0) { bxml.toXml(*recipes,      outFile); }
       if (equipments   && equipments  ->size() > 0) { bxml.toXml(*equipments,   outFile); }
 
+      return true;
+   }
+
+   qCInfo(Logging::serialization) << Q_FUNC_INFO << "Don't understand file extension on" << filename << "so ignoring!";
+
+   return false;
+}
+
+namespace {
+   //! Latest change to each object covered by a delta export, by table name
+   using ChangesByTable = QHash<QString, QVector<ChangeLog::Entry>>;
+
+   //! An object to list in the sync file, as either changed or deleted
+   struct SyncItem {
+      int     objectId;
+      QString name;
+      qint64  changedAt_ms;
+   };
+
+   struct SyncItems {
+      QVector<SyncItem> changed;
+      QVector<SyncItem> deleted;
+   };
+
+   //! What to list in the sync file, by table name
+   using SyncItemsByTable = QHash<QString, SyncItems>;
+
+   QString syncFileName(QString const & filename) {
+      return filename + ".sync.json";
+   }
+
+   template<class NE> QString tableNameFor() {
+      return QString{*ObjectStoreTyped<NE>::getInstance().primaryTableName()};
+   }
+
+   /**
+    * \brief Call \c functor with \c std::type_identity of the exportable type whose primary table is \c tableName
+    *
+    * \return What \c functor returned, or 0 if \c tableName is not the table of an exportable type
+    */
+   template<class Functor>
+   int forTableType(QString const & tableName, Functor && functor) {
+      if (tableName == tableNameFor<Recipe     >()) { return functor(std::type_identity<Recipe     >{}); }
+      if (tableName == tableNameFor<Equipment  >()) { return functor(std::type_identity<Equipment  >{}); }
+      if (tableName == tableNameFor<Fermentable>()) { return functor(std::type_identity<Fermentable>{}); }
+      if (tableName == tableNameFor<Hop        >()) { return functor(std::type_identity<Hop        >{}); }
+      if (tableName == tableNameFor<Misc       >()) { return functor(std::type_identity<Misc       >{}); }
+      if (tableName == tableNameFor<Style      >()) { return functor(std::type_identity<Style      >{}); }
+      if (tableName == tableNameFor<Water      >()) { return functor(std::type_identity<Water      >{}); }
+      if (tableName == tableNameFor<Yeast      >()) { return functor(std::type_identity<Yeast      >{}); }
+      qCWarning(Logging::serialization) << Q_FUNC_INFO << "Ignoring entry for unknown table" << tableName;
+      return 0;
+   }
+
+   /**
+    * \return Keys of the objects of type \c NE that have been added or changed (but not hard deleted), with when they
+    *         were last changed
+    */
+   template<class NE> QHash<int, qint64> changedKeys(ChangesByTable const & changesByTable) {
+      QHash<int, qint64> keys;
+      for (ChangeLog::Entry const & entry : changesByTable.value(tableNameFor<NE>())) {
+         if (!entry.hardDeleted) {
+            keys.insert(entry.objectId, entry.changedAt_ms);
+         }
+      }
+      return keys;
+   }
+
+   /**
+    * \brief Name of an object that is no longer in its object store (because it was soft deleted since the store was
+    *        loaded), read from the DB, or empty if it was a hidden copy (eg of an ingredient in a recipe), as such
+    *        copies are not exported in their own right.
+    */
+   QString nameOfDeleted(ObjectStore const & objectStore, int const id) {
+      QString nameColumn;
+      QString displayColumn;
+      for (ObjectStore::TableField const & field : objectStore.primaryTableFields()) {
+         if (field.propertyName == PropertyNames::NamedEntity::name) {
+            nameColumn = *field.columnName;
+         } else if (field.propertyName == PropertyNames::NamedEntity::display) {
+            displayColumn = *field.columnName;
+         }
+      }
+      if (nameColumn.isEmpty() || displayColumn.isEmpty()) {
+         return QString{};
+      }
+
+      BtSqlQuery sqlQuery{Database::instance().sqlDatabase()};
+      sqlQuery.prepare(QString("SELECT %1, %2 FROM %3 WHERE %4 = ?").arg(
+         nameColumn, displayColumn, *objectStore.primaryTableName(), *objectStore.primaryTableFields()[0].columnName
+      ));
+      sqlQuery.bindValue(0, id);
+      if (!sqlQuery.exec()) {
+         qCWarning(Logging::serialization) <<
+            Q_FUNC_INFO << "Could not read name of deleted object #" << id << ":" << sqlQuery.lastError().text();
+         return QString{};
+      }
+      if (!sqlQuery.next() || !sqlQuery.value(1).toBool()) {
+         return QString{};
+      }
+      return sqlQuery.value(0).toString();
+   }
+
+   /**
+    * \brief Sort the changes to objects of type \c NE into ones to export (or, if \c everything is set, export all of
+    *        them) and ones that have been deleted
+    */
+   template<class NE>
+   void collectChanges(ChangesByTable const & changesByTable,
+                       bool const everything,
+                       QList<NE const *> & toExport,
+                       SyncItemsByTable & syncItemsByTable) {
+      ObjectStoreTyped<NE> & objectStore = ObjectStoreTyped<NE>::getInstance();
+      QString const tableName = tableNameFor<NE>();
+      SyncItems & syncItems = syncItemsByTable[tableName];
+      QHash<int, qint64> changedAt_ms;
+      for (ChangeLog::Entry const & entry : changesByTable.value(tableName)) {
+         changedAt_ms.insert(entry.objectId, entry.changedAt_ms);
+         if (entry.hardDeleted) {
+            // Name will be empty for hidden copies
+            if (!entry.name.isEmpty()) {
+               syncItems.deleted.append(SyncItem{entry.objectId, entry.name, entry.changedAt_ms});
+            }
+            continue;
+         }
+         NE const * ne = ObjectStoreWrapper::getByIdRaw<NE>(entry.objectId);
+         if (!ne || ne->deleted()) {
+            QString const name =
+               ne ? (ne->display() ? ne->name() : QString{}) : nameOfDeleted(objectStore, entry.objectId);
+            if (!name.isEmpty()) {
+               syncItems.deleted.append(SyncItem{entry.objectId, name, entry.changedAt_ms});
+            }
+            continue;
+         }
+         if (!everything && ne->display()) {
+            toExport.append(ne);
+            syncItems.changed.append(SyncItem{ne->key(), ne->name(), entry.changedAt_ms});
+         }
+      }
+
+      if (everything) {
+         for (NE const * ne : ObjectStoreWrapper::getAllRaw<NE>()) {
+            if (ne->display() && !ne->deleted()) {
+               toExport.append(ne);
+               // Objects that haven't changed since we started recording changes count as changed at the epoch
+               syncItems.changed.append(SyncItem{ne->key(), ne->name(), changedAt_ms.value(ne->key(), 0)});
+            }
+         }
+      }
+      return;
+   }
+
+   /**
+    * \brief Record, in \c recipeChangedAt_ms, the recipes with changed additions of type \c RA, including where it's
+    *        the recipe's (hidden) copy of the ingredient that has changed.
+    */
+   template<class Ingr, class RA>
+   void addRecipesWithChangedAdditions(ChangesByTable const & changesByTable, QHash<int, qint64> & recipeChangedAt_ms) {
+      QHash<int, qint64> const changedAdditions   = changedKeys<RA  >(changesByTable);
+      QHash<int, qint64> const changedIngredients = changedKeys<Ingr>(changesByTable);
+      if (changedAdditions.isEmpty() && changedIngredients.isEmpty()) {
+         return;
+      }
+      for (RA const * addition : ObjectStoreWrapper::getAllRaw<RA>()) {
+         qint64 const changedAt_ms = std::max(changedAdditions  .value(addition->key()         , 0),
+                                              changedIngredients.value(addition->ingredientId(), 0));
+         if (changedAt_ms > 0) {
+            qint64 & recipeChanged_ms = recipeChangedAt_ms[addition->recipeId()];
+            recipeChanged_ms = std::max(recipeChanged_ms, changedAt_ms);
+         }
+      }
       return;
    }
 
-   qInfo() << Q_FUNC_INFO << "Don't understand file extension on" << filename << "so ignoring!";
+   /**
+    * \return Keys of the step owners (mashes, boils or fermentations) of type \c Owner that have changed, or whose
+    *         steps have, with when they last did
+    */
+   template<class Owner, class OwnedStep>
+   QHash<int, qint64> changedStepOwners(ChangesByTable const & changesByTable) {
+      QHash<int, qint64> owners = changedKeys<Owner>(changesByTable);
+      QHash<int, qint64> const steps = changedKeys<OwnedStep>(changesByTable);
+      for (auto step = steps.cbegin(); step != steps.cend(); ++step) {
+         if (OwnedStep const * ownedStep = ObjectStoreWrapper::getByIdRaw<OwnedStep>(step.key())) {
+            qint64 & ownerChanged_ms = owners[ownedStep->ownerId()];
+            ownerChanged_ms = std::max(ownerChanged_ms, step.value());
+         }
+      }
+      return owners;
+   }
 
-   return;
+   /**
+    * \brief Add the entries for \c items in table \c tableName to \c entries
+    */
+   void appendSyncEntries(QString const & tableName,
+                          QVector<SyncItem> const & items,
+                          QHash<int, QString> const & uuids,
+                          QJsonArray & entries) {
+      for (SyncItem const & item : items) {
+         entries.append(QJsonObject{{"table"      , tableName                   },
+                                    {"uuid"       , uuids.value(item.objectId)  },
+                                    {"name"       , item.name                   },
+                                    {"changedAtMs", item.changedAt_ms           }});
+      }
+      return;
+   }
+
+   //! What \c ImportExport::importChanges did
+   struct ChangeCounts {
+      int deleted   = 0;
+      int replaced  = 0;
+      int keptLocal = 0;
+   };
+
+   /**
+    * \return The displayed objects of type \c NE named \c name
+    */
+   template<class NE>
+   QList<NE *> displayedNamed(QString const & name) {
+      return ObjectStoreWrapper::findAllMatchingRaw<NE>(
+         [&name](NE const * ne) { return ne->display() && !ne->deleted() && ne->name() == name; }
+      );
+   }
+
+   /**
+    * \return The object here that is known by \c uuid, or \c nullptr if there isn't one (or it has been deleted)
+    */
+   template<class NE>
+   NE * objectWithUuid(QString const & uuid) {
+      if (uuid.isEmpty()) {
+         return nullptr;
+      }
+      int const objectId = ChangeLog::objectIdFor(tableNameFor<NE>(), uuid);
+      NE * ne = objectId > 0 ? ObjectStoreWrapper::getByIdRaw<NE>(objectId) : nullptr;
+      return ne && !ne->deleted() ? ne : nullptr;
+   }
+
+   /**
+    * \brief Apply the deletion, at the other end, of the object known by \c uuid (or, if it's not known here, called
+    *        \c name)
+    */
+   template<class NE>
+   int applyDeletion(QString const & uuid, QString const & name, ChangeCounts & counts) {
+      QList<NE *> toDelete;
+      if (NE * ne = objectWithUuid<NE>(uuid)) {
+         toDelete.append(ne);
+      } else if (uuid.isEmpty() || ChangeLog::objectIdFor(tableNameFor<NE>(), uuid) < 0) {
+         // We've not seen this object before, so the best we can do is go by name
+         toDelete = displayedNamed<NE>(name);
+      }
+      for (NE * ne : toDelete) {
+         ObjectStoreWrapper::softDelete(*ne);
+         ++counts.deleted;
+      }
+      return toDelete.size();
+   }
+
+   /**
+    * \brief Having imported an object known by \c uuid, called \c name, that was last changed at the other end at
+    *        \c remoteChangedAt_ms, sort out which of it and any existing version here we keep.
+    *
+    *        If the object has been changed more recently here than there, our version wins.  (Resolving conflicts
+    *        property by property would need the version that both ends last agreed on, which neither DB keeps.)
+    */
+   template<class NE>
+   int applyChange(QString const & uuid, QString const & name, qint64 const remoteChangedAt_ms, ChangeCounts & counts) {
+      QList<NE *> const named = displayedNamed<NE>(name);
+      if (named.isEmpty()) {
+         return 0;
+      }
+      // What we've just imported is the most recently added object with the name
+      NE * imported = *std::max_element(named.begin(),
+                                        named.end(),
+                                        [](NE const * lhs, NE const * rhs) { return lhs->key() < rhs->key(); });
+      QString const tableName = tableNameFor<NE>();
+
+      NE * local = objectWithUuid<NE>(uuid);
+      if (!local) {
+         // First time we've seen this object, so, as far as we can tell, it replaces anything of the same name
+         for (NE * other : named) {
+            if (other != imported) {
+               ObjectStoreWrapper::softDelete(*other);
+               ++counts.replaced;
+            }
+         }
+      } else if (local != imported) {
+         if (ChangeLog::changedAt_ms(tableName, local->key()) > remoteChangedAt_ms) {
+            // The copy we just imported is unchanged from what we had before our change, so it can go
+            ObjectStoreWrapper::softDelete(*imported);
+            ++counts.keptLocal;
+            return 1;
+         }
+         ObjectStoreWrapper::softDelete(*local);
+         ++counts.replaced;
+      }
+
+      if (!uuid.isEmpty()) {
+         ChangeLog::adoptUuid(tableName, imported->key(), uuid);
+      }
+      return 1;
+   }
+}
+
+bool ImportExport::exportChangesSince(QString const & filename, qint64 const sinceCounter, qint64 & upToCounter) {
+   QElapsedTimer timer;
+   timer.start();
+
+   // Anything not yet written to the DB would otherwise be missed
+   ObjectStore::flushPendingPropertyUpdates();
+
+   upToCounter = sinceCounter;
+   ChangesByTable changesByTable;
+   for (ChangeLog::Entry const & entry : ChangeLog::changesSince(sinceCounter)) {
+      changesByTable[entry.tableName].append(entry);
+      upToCounter = std::max(upToCounter, entry.changeCounter);
+   }
+   bool const everything = sinceCounter <= 0;
+
+   QList<Recipe      const *> recipes;
+   QList<Equipment   const *> equipments;
+   QList<Fermentable const *> fermentables;
+   QList<Hop         const *> hops;
+   QList<Misc        const *> miscs;
+   QList<Style       const *> styles;
+   QList<Water       const *> waters;
+   QList<Yeast       const *> yeasts;
+   SyncItemsByTable syncItemsByTable;
+   collectChanges(changesByTable, everything, recipes     , syncItemsByTable);
+   collectChanges(changesByTable, everything, equipments  , syncItemsByTable);
+   collectChanges(changesByTable, everything, fermentables, syncItemsByTable);
+   collectChanges(changesByTable, everything, hops        , syncItemsByTable);
+   collectChanges(changesByTable, everything, miscs       , syncItemsByTable);
+   collectChanges(changesByTable, everything, styles      , syncItemsByTable);
+   collectChanges(changesByTable, everything, waters      , syncItemsByTable);
+   collectChanges(changesByTable, everything, yeasts      , syncItemsByTable);
+
+   if (!everything) {
+      //
+      // Recipes whose own row hasn't changed still need exporting if anything that is part of them has
+      //
+      QHash<int, qint64> recipeChangedAt_ms;
+      addRecipesWithChangedAdditions<Fermentable, RecipeAdditionFermentable>(changesByTable, recipeChangedAt_ms);
+      addRecipesWithChangedAdditions<Hop        , RecipeAdditionHop        >(changesByTable, recipeChangedAt_ms);
+      addRecipesWithChangedAdditions<Misc       , RecipeAdditionMisc       >(changesByTable, recipeChangedAt_ms);
+      addRecipesWithChangedAdditions<Yeast      , RecipeAdditionYeast      >(changesByTable, recipeChangedAt_ms);
+      addRecipesWithChangedAdditions<Salt       , RecipeAdjustmentSalt     >(changesByTable, recipeChangedAt_ms);
+      addRecipesWithChangedAdditions<Water      , RecipeUseOfWater         >(changesByTable, recipeChangedAt_ms);
+
+      QHash<int, qint64> const mashes        = changedStepOwners<Mash        , MashStep        >(changesByTable);
+      QHash<int, qint64> const boils         = changedStepOwners<Boil        , BoilStep        >(changesByTable);
+      QHash<int, qint64> const fermentations = changedStepOwners<Fermentation, FermentationStep>(changesByTable);
+      if (!mashes.isEmpty() || !boils.isEmpty() || !fermentations.isEmpty()) {
+         for (Recipe const * recipe : ObjectStoreWrapper::getAllRaw<Recipe>()) {
+            auto const mash         = recipe->mash();
+            auto const boil         = recipe->boil();
+            auto const fermentation = recipe->fermentation();
+            qint64 const changedAt_ms = std::max({mash         ? mashes       .value(mash        ->key(), 0) : 0,
+                                                  boil         ? boils        .value(boil        ->key(), 0) : 0,
+                                                  fermentation ? fermentations.value(fermentation->key(), 0) : 0});
+            if (changedAt_ms > 0) {
+               qint64 & recipeChanged_ms = recipeChangedAt_ms[recipe->key()];
+               recipeChanged_ms = std::max(recipeChanged_ms, changedAt_ms);
+            }
+         }
+      }
+
+      SyncItems & recipeItems = syncItemsByTable[tableNameFor<Recipe>()];
+      for (SyncItem & item : recipeItems.changed) {
+         item.changedAt_ms = std::max(item.changedAt_ms, recipeChangedAt_ms.take(item.objectId));
+      }
+      for (auto ii = recipeChangedAt_ms.cbegin(); ii != recipeChangedAt_ms.cend(); ++ii) {
+         Recipe const * recipe = ObjectStoreWrapper::getByIdRaw<Recipe>(ii.key());
+         if (recipe && recipe->display() && !recipe->deleted()) {
+            recipes.append(recipe);
+            recipeItems.changed.append(SyncItem{recipe->key(), recipe->name(), ii.value()});
+         }
+      }
+   }
+
+   QJsonArray changed;
+   QJsonArray deleted;
+   for (auto ii = syncItemsByTable.cbegin(); ii != syncItemsByTable.cend(); ++ii) {
+      QVector<int> objectIds;
+      for (SyncItem const & item : ii->changed + ii->deleted) {
+         objectIds.append(item.objectId);
+      }
+      QHash<int, QString> const uuids = ChangeLog::uuidsFor(ii.key(), objectIds);
+      appendSyncEntries(ii.key(), ii->changed, uuids, changed);
+      appendSyncEntries(ii.key(), ii->deleted, uuids, deleted);
+   }
+
+   if (!changed.isEmpty() &&
+       !ImportExport::exportToNamedFile(filename,
+                                        &recipes,
+                                        &equipments,
+                                        &fermentables,
+                                        &hops,
+                                        &miscs,
+                                        &styles,
+                                        &waters,
+                                        &yeasts)) {
+      return false;
+   }
+
+   QJsonObject const syncInfo{
+      {"sinceCounter", sinceCounter},
+      {"upToCounter" , upToCounter },
+      {"changed"     , changed     },
+      {"deleted"     , deleted     },
+   };
+   QFile syncFile{syncFileName(filename)};
+   if (!syncFile.open(QIODevice::WriteOnly | QIODevice::Truncate) ||
+       syncFile.write(QJsonDocument{syncInfo}.toJson()) < 0) {
+      qCWarning(Logging::serialization) << Q_FUNC_INFO << "Could not write" << syncFile.fileName();
+      return false;
+   }
+
+   qCInfo(Logging::serialization) <<
+      Q_FUNC_INFO << "Exported" << changed.size() << "changed and" << deleted.size() << "deleted objects (changes" <<
+      sinceCounter << "to" << upToCounter << ") in" << timer.elapsed() << "ms";
+   return true;
+}
+
+bool ImportExport::importChanges(QString const & filename, QString & userMessage) {
+   QElapsedTimer timer;
+   timer.start();
+
+   QFile syncFile{syncFileName(filename)};
+   if (!syncFile.open(QIODevice::ReadOnly)) {
+      userMessage = QObject::tr("Could not open %1, so %2 does not look like a delta export.").arg(
+         syncFile.fileName(), filename
+      );
+      return false;
+   }
+   QJsonParseError parseError;
+   QJsonDocument const syncInfo = QJsonDocument::fromJson(syncFile.readAll(), &parseError);
+   if (!syncInfo.isObject()) {
+      userMessage = QObject::tr("Could not read %1: %2").arg(syncFile.fileName(), parseError.errorString());
+      return false;
+   }
+   QJsonArray const changed = syncInfo.object().value("changed").toArray();
+   QJsonArray const deleted = syncInfo.object().value("deleted").toArray();
+
+   //
+   // Deletions come first, so that an object that was deleted and then re-created with the same name at the other end
+   // ends up here too.  Each batch of updates is done in one transaction, which is a lot quicker than one per object.
+   //
+   Database & database = Database::instance();
+   QSqlDatabase connection = database.sqlDatabase();
+   ChangeCounts counts;
+   {
+      DbTransaction dbTransaction{database, connection, "Apply deletions from delta export"};
+      for (QJsonValue const & entry : deleted) {
+         forTableType(entry["table"].toString(), [&](auto type) {
+            using NE = typename decltype(type)::type;
+            return applyDeletion<NE>(entry["uuid"].toString(), entry["name"].toString(), counts);
+         });
+      }
+      ObjectStore::flushPendingPropertyUpdates();
+      dbTransaction.commit();
+   }
+
+   if (!changed.isEmpty()) {
+      QVector<FileImportResult> const results = ImportExport::importFiles(QStringList{filename});
+      if (results.isEmpty() || !results.first().succeeded) {
+         userMessage = results.isEmpty() ? QObject::tr("Nothing imported") : results.first().userMessage;
+         return false;
+      }
+      userMessage = results.first().userMessage;
+
+      DbTransaction dbTransaction{database, connection, "Apply changes from delta export"};
+      for (QJsonValue const & entry : changed) {
+         forTableType(entry["table"].toString(), [&](auto type) {
+            using NE = typename decltype(type)::type;
+            return applyChange<NE>(entry["uuid"].toString(),
+                                   entry["name"].toString(),
+                                   static_cast<qint64>(entry["changedAtMs"].toDouble()),
+                                   counts);
+         });
+      }
+      ObjectStore::flushPendingPropertyUpdates();
+      dbTransaction.commit();
+   }
+
+   userMessage.append(QObject::tr("\n%1 object(s) deleted, %2 replaced, %3 kept because changed more recently here")
+                      .arg(counts.deleted).arg(counts.replaced).arg(counts.keptLocal));
+   qCInfo(Logging::serialization) <<
+      Q_FUNC_INFO << "Applied" << changed.size() << "changes and" << deleted.size() << "deletions from" << filename <<
+      "in" << timer.elapsed() << "ms";
+   return true;
 }
@@ -18,9 +18,13 @@
 #define SERIALIZATION_IMPORTEXPORT_H
 #pragma once
 
+#include <functional>
 #include <optional>
 
 #include <QList>
+#include <QString>
+#include <QStringList>
+#include <QVector>
 
 class Equipment;
 class Fermentable;
@@ -41,12 +45,53 @@ namespace ImportExport {
     *        similar to how other programs work (eg LibreOffice, Gimp), so I think it's OK, but we'll see what feedback
     *        is on usability.
     *
+    *        Files with a .bjb extension are in our binary form of BeerJSON (see \c BeerJsonBinary), which is much
+    *        quicker to read and write when moving lots of recipes between installations of the program.
+    *
+    *        Any of these can also be gzip-compressed (eg .json.gz), or be in a zip archive, in which case they are
+    *        decompressed into memory as they are read (see \c Compression).  For export, a name ending in .gz gives a
+    *        gzip-compressed file.
+    *
     * \param inputFiles If \c std::nullopt (ie not supplied) then user will be prompted for file(s) through the UI
     *
     * \return \c true if succeeded, \c false otherwise
     */
    bool importFromFiles(std::optional<QStringList> inputFiles = std::nullopt);
 
+   /**
+    * \brief What happened when we tried to import one file (see \c importFiles)
+    */
+   struct FileImportResult {
+      QString fileName;
+      //! \c false if the import was cancelled before we got to this file
+      bool attempted = false;
+      bool succeeded = false;
+      //! Explanation of why the file could not be imported, or summary of what was imported from it
+      QString userMessage;
+   };
+
+   /**
+    * \brief Called by \c importFiles to report progress.  \c label, if not empty, describes what is happening now.
+    *
+    * \return \c false to cancel the import, \c true to carry on
+    */
+   using ImportProgressCallback = std::function<bool(int const stepsDone, int const totalSteps, QString const & label)>;
+
+   /**
+    * \brief Does the work of \c importFromFiles, but without any user interface (file choosers, progress or message
+    *        boxes), so that it can also be used in batch mode (see \c BatchMode).  Must be called on the main
+    *        thread.
+    *
+    * \param inputFiles The BeerXML/BeerJSON files to import.  These are read and validated in parallel, and then
+    *                   loaded into the DB one at a time, in the order given.  Each entry in a zip archive is treated
+    *                   as a separate file for this purpose, but gets reported as part of the archive's result.
+    * \param progressCallback Optional
+    *
+    * \return One result for each of \c inputFiles, in the same order
+    */
+   QVector<FileImportResult> importFiles(QStringList const & inputFiles,
+                                         ImportProgressCallback const & progressCallback = nullptr);
+
    /**
     * \brief Import recipes, hops, equipment, etc to a BeerXML or BeerJSON file specified by the user
     *        (We'll work out whether it's BeerXML or BeerJSON based on the filename extension, so doesn't need to be
@@ -72,6 +117,58 @@ namespace ImportExport {
                      QList<Style       const *> const * styles       = nullptr,
                      QList<Water       const *> const * waters       = nullptr,
                      QList<Yeast       const *> const * yeasts       = nullptr);
+
+   /**
+    * \brief Does the work of \c exportToFile, but to the file named in \c filename rather than one chosen by the user.
+    *        As for \c exportToFile, the format is determined by the file extension (.json, .bjb or .xml, optionally
+    *        followed by .gz for a compressed file).
+    *
+    * \return \c true if succeeded, \c false otherwise
+    */
+   bool exportToNamedFile(QString const & filename,
+                          QList<Recipe      const *> const * recipes,
+                          QList<Equipment   const *> const * equipments   = nullptr,
+                          QList<Fermentable const *> const * fermentables = nullptr,
+                          QList<Hop         const *> const * hops         = nullptr,
+                          QList<Misc        const *> const * miscs        = nullptr,
+                          QList<Style       const *> const * styles       = nullptr,
+                          QList<Water       const *> const * waters       = nullptr,
+                          QList<Yeast       const *> const * yeasts       = nullptr);
+
+   /**
+    * \brief Delta export, for keeping two databases (eg at different sites) in step: export the recipes, hops,
+    *        equipment, etc that have been added or changed since the change counter was \c sinceCounter (see
+    *        \c ChangeLog).  A recipe counts as changed if any of its additions, or its mash, boil or fermentation, has.
+    *
+    *        Alongside \c filename (which is exported to as for \c exportToNamedFile), we write \c filename plus
+    *        ".sync.json", which holds the range of counters covered, and the type, UUID (see \c ChangeLog), name and time
+    *        of last change of each object exported and of each that has been deleted.  The UUID is how
+    *        \c importChanges finds the corresponding objects, since IDs are different in each database.  (If nothing has
+    *        been added or changed, only the latter file is written.)
+    *
+    *        Between them, this and \c importChanges give two-way replication: each end exports its changes since the
+    *        last sync and imports the other's, in either order.
+    *
+    * \param sinceCounter 0 means export everything (which is what to do the first time)
+    * \param upToCounter Set to the counter of the last change exported, which is what to pass as \c sinceCounter
+    *                    next time
+    *
+    * \return \c true if succeeded, \c false otherwise
+    */
+   bool exportChangesSince(QString const & filename, qint64 const sinceCounter, qint64 & upToCounter);
+
+   /**
+    * \brief Import a delta export made by \c exportChangesSince.  Objects deleted at the other end are soft deleted
+    *        here, then the changed objects are imported.  Each replaces the existing object with the same UUID, unless
+    *        that has been changed more recently here, in which case ours is kept.  An object whose UUID isn't known
+    *        here replaces any existing object of the same type and name, and it takes on the UUID.
+    *        Like \c importFiles, this has no user interface and must be called on the main thread.
+    *
+    * \param userMessage Set to a summary of what was done, or an explanation of what went wrong
+    *
+    * \return \c true if succeeded, \c false otherwise
+    */
+   bool importChanges(QString const & filename, QString & userMessage);
 }
 
 #endif
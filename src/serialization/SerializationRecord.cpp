@@ -15,10 +15,15 @@
  ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
 #include "serialization/SerializationRecord.h"
 
+#include "Logging.h"
+#include "utils/ImportPhaseTimings.h"
+
 
 SerializationRecord::SerializationRecord() :
    m_namedParameterBundle{NamedParameterBundle::OperationMode::NotStrict},
    m_namedEntity{nullptr},
+   m_earlierInBatch{nullptr},
+   m_completeEarlierInBatch{nullptr},
    m_includeInStats{true} {
    return;
 }
@@ -40,7 +45,7 @@ void SerializationRecord::constructNamedEntity() {
 ///   qCritical() <<
 ///      Q_FUNC_INFO << this->m_recordDefinition.m_namedEntityClassName << "this->m_namedParameterBundle:" <<
 ///      this->m_namedParameterBundle;
-   qDebug().noquote() << Q_FUNC_INFO << Logging::getStackTrace();
+   qCDebug(Logging::serialization).noquote() << Q_FUNC_INFO << Logging::getStackTrace();
    Q_ASSERT(false && "Trying to construct named entity for base record");
    return;
 }
@@ -50,11 +55,27 @@ int SerializationRecord::storeNamedEntityInDb() {
    return -1;
 }
 
+bool SerializationRecord::canStoreInBatch() const {
+   return false;
+}
+
+QVector<int> SerializationRecord::storeNamedEntitiesInDb(
+   [[maybe_unused]] QList<SerializationRecord const *> const & records
+) const {
+   Q_ASSERT(false && "Trying to store named entities for base record");
+   return {};
+}
+
 void SerializationRecord::deleteNamedEntityFromDb() {
    Q_ASSERT(false && "Trying to delete named entity for base record");
    return;
 }
 
+std::function<void()> SerializationRecord::namedEntityDeleter() const {
+   Q_ASSERT(false && "Trying to delete named entity for base record");
+   return [](){ return; };
+}
+
 [[nodiscard]] bool SerializationRecord::isDuplicate() {
    // Base class does not have a NamedEntity so nothing to check
    // Stictly, it's a coding error if this function is called, as caller should first check whether there is a
@@ -63,6 +84,11 @@ void SerializationRecord::deleteNamedEntityFromDb() {
    return false;
 }
 
+bool SerializationRecord::timedIsDuplicate() {
+   ImportPhaseTimings::ScopedTimer duplicateDetectionTimer{ImportPhaseTimings::Phase::DuplicateDetection};
+   return this->isDuplicate();
+}
+
 void SerializationRecord::normaliseName() {
    // Base class does not have a NamedEntity so nothing to normalise
    // Stictly, it's a coding error if this function is called, as caller should first check whether there is a
@@ -79,20 +105,25 @@ void SerializationRecord::setContainingEntity([[maybe_unused]] std::shared_ptr<N
    return;
 }
 
+bool SerializationRecord::earlierInBatchHasName(QString const & name) const {
+   if (!this->m_earlierInBatch) {
+      return false;
+   }
+   for (auto const & earlier : *this->m_earlierInBatch) {
+      if (earlier->name() == name) {
+         return true;
+      }
+   }
+   return false;
+}
+
 void SerializationRecord::modifyClashingName(QString & candidateName) {
    //
    // First, see whether there's already a (n) (ie "(1)", "(2)" etc) at the end of the name (with or without
    // space(s) preceding the left bracket.  If so, we want to replace this with " (n+1)".  If not, we try " (1)".
    //
-   int duplicateNumber = 1;
-   QRegExp const & nameNumberMatcher = NamedEntity::getDuplicateNameNumberMatcher();
-   int positionOfMatch = nameNumberMatcher.indexIn(candidateName);
-   if (positionOfMatch > -1) {
-      // There's already some integer in brackets at the end of the name, extract it, add one, and truncate the
-      // name.
-      duplicateNumber = nameNumberMatcher.cap(1).toInt() + 1;
-      candidateName.truncate(positionOfMatch);
-   }
-   candidateName += QString(" (%1)").arg(duplicateNumber);
+   // If there's no integer in brackets at the end of the name, splitDuplicateNameNumber gives 0 for the number
+   auto const [baseName, duplicateNumber] = NamedEntity::splitDuplicateNameNumber(candidateName);
+   candidateName = baseName + QString(" (%1)").arg(duplicateNumber + 1);
    return;
 }
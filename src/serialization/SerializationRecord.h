@@ -17,8 +17,12 @@
 #define SERIALIZATION_SERIALIZATIONRECORD_H
 #pragma once
 
+#include <functional>
 #include <memory>
 
+#include <QList>
+#include <QVector>
+
 #include "model/NamedEntity.h"
 #include "model/NamedParameterBundle.h"
 
@@ -84,6 +88,23 @@ protected:
     */
    virtual int storeNamedEntityInDb();
 
+   /**
+    * \brief Whether this record can be stored in the DB in one go with other records of the same type (see
+    *        \c storeNamedEntitiesInDb), as we do for the child records of one type inside a parent record.  This is
+    *        \c false for records whose subclass does anything special when storing.  Base class returns \c false.
+    */
+   virtual bool canStoreInBatch() const;
+
+   /**
+    * \brief For records where \c canStoreInBatch() is \c true, subclasses implement this to store the \c NamedEntity
+    *        objects of all the supplied records (which are of the same type as this one) with a single
+    *        \c ObjectStore::insertMany.
+    *
+    * \return the IDs of the newly-inserted objects, in the same order as \c records, or an empty list if there was an
+    *         error (in which case nothing was stored)
+    */
+   virtual QVector<int> storeNamedEntitiesInDb(QList<SerializationRecord const *> const & records) const;
+
 public:
    /**
     * \brief Subclasses need to implement this to delete \c this->m_namedEntity from the appropriate ObjectStore (this
@@ -91,6 +112,13 @@ public:
     */
    virtual void deleteNamedEntityFromDb();
 
+   /**
+    * \brief Subclasses need to implement this to return a function that does the same as \c deleteNamedEntityFromDb
+    *        but which, unlike it, can still be called after this record has been destroyed.  This is used to roll back
+    *        a cancelled import (see \c ImportRecordCount::rollBack).
+    */
+   virtual std::function<void()> namedEntityDeleter() const;
+
    /**
     * \brief Given a name that is a duplicate of an existing one, modify it to a potential alternative.
     *        Callers should call this function as many times as necessary to find a non-clashing name.
@@ -117,6 +145,12 @@ protected:
     */
    [[nodiscard]] virtual bool isDuplicate();
 
+   /**
+    * \brief Calls \c isDuplicate(), adding the time taken to \c ImportPhaseTimings::Phase::DuplicateDetection.
+    *        Subclasses should call this rather than \c isDuplicate() directly.
+    */
+   [[nodiscard]] bool timedIsDuplicate();
+
    /**
     * \brief If the \b NamedEntity for this record is supposed to have globally unique names, then this method will
     *        check the current name and modify it if necessary.  NB: This function should be called _after_
@@ -131,6 +165,12 @@ protected:
     */
    virtual void setContainingEntity(std::shared_ptr<NamedEntity> containingEntity);
 
+   /**
+    * \return \c true if the \c NamedEntity of one of the records before us in the current batch (see
+    *         \c m_earlierInBatch) has the supplied name
+    */
+   bool earlierInBatchHasName(QString const & name) const;
+
 
    // Name-value pairs containing all the field data from the XML or JSON record that will be used to construct/populate
    // this->m_namedEntity
@@ -148,6 +188,20 @@ protected:
    //
    std::shared_ptr<NamedEntity> m_namedEntity;
 
+   //
+   // When we are storing a batch of records in one go (see canStoreInBatch()), this points to the NamedEntity objects
+   // of the records before us in the batch that are going to be stored.  They are not yet in the object store, so
+   // normaliseName() needs to check them as well as what's in the store.  Otherwise it's nullptr.
+   //
+   QList<std::shared_ptr<NamedEntity>> const * m_earlierInBatch;
+
+   //
+   // Similarly, the subset of m_earlierInBatch that isDuplicate() needs to check.  This excludes records with child
+   // records, as they don't get their children until after the whole batch is stored, so comparing with them would be
+   // meaningless.  (They get caught by the second duplicate check that is done once a record's children are stored.)
+   //
+   QList<std::shared_ptr<NamedEntity>> const * m_completeEarlierInBatch;
+
    // This determines whether we include this record in the stats we show the user (about how many records were read in
    // or skipped from a file.  By default it's true.  Subclass constructors set it to false for types of record that
    // are entirely owned and contained by other records (eg MashSteps are just part of a Mash, so we tell the user
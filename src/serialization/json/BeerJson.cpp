@@ -16,11 +16,18 @@
 #include "serialization/json/BeerJson.h"
 
 #include <cstdlib>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <string_view>
 
 // We could just include <boost/json.hpp> which pulls all the Boost.JSON headers in, but that seems overkill
 #include <boost/json/kind.hpp>
 #include <boost/json/parse_options.hpp>
 #include <boost/json/parse.hpp>
+#include <boost/json/serialize.hpp>
 #include <boost/json/string.hpp>
 
 #include <valijson/adapters/boost_json_adapter.hpp>
@@ -29,11 +36,19 @@
 #include <valijson/validator.hpp>
 
 #include <QApplication>
+#include <QBuffer>
+#include <QCryptographicHash>
 #include <QDebug>
+#include <QFile>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSet>
 #include <QString>
 #include <QTextStream>
 
+#include "database/ObjectStore.h"
 #include "database/ObjectStoreWrapper.h"
+#include "Logging.h"
 #include "model/Boil.h"
 #include "model/BrewNote.h"
 #include "model/Equipment.h"
@@ -51,6 +66,8 @@
 #include "model/Style.h"
 #include "model/Water.h"
 #include "model/Yeast.h"
+#include "PersistentSettings.h"
+#include "serialization/json/BeerJsonBinary.h"
 #include "serialization/json/JsonCoding.h"
 #include "serialization/json/JsonMeasureableUnitsMapping.h"
 #include "serialization/json/JsonNamedEntityRecord.h"
@@ -59,6 +76,7 @@
 #include "serialization/json/JsonSchema.h"
 #include "serialization/json/JsonUtils.h"
 #include "utils/OStreamWriterForQFile.h"
+#include "utils/ParallelRender.h"
 
 namespace {
    // See below for more comments on this.  If and when BeerJSON evolves then we will want separate constants for
@@ -1160,19 +1178,128 @@ namespace {
 
    //=-=-=-=-=-=-=-=-
 
+   //
+   // Schema validation is the slowest part of reading a BeerJSON file.  When the user imports a file that we exported
+   // and that hasn't been changed since, it's also unnecessary, as we know what we wrote.  So, for each export, we
+   // remember a signature (SHA-256 hash) of the file we wrote, and skip validation for files whose signature matches.
+   //
+   // Ideally the signature would go in the file itself, but BeerJSON doesn't allow additional properties in any of
+   // its objects, so other programs would then reject our exports.  Instead we keep the most recent signatures in
+   // PersistentSettings.  Since PersistentSettings may only be used on the GUI thread, but files are validated on
+   // worker threads, we keep an in-memory copy, guarded by a mutex.  See BeerJson::loadExportSignatures.
+   //
+   QMutex exportSignaturesMutex;
+   bool exportSignaturesLoaded = false;
+   bool skipValidatingOwnExports = false;
+   QStringList exportSignatures;
+   //! We only need the signatures of recent exports, so there's no point letting the list grow without limit
+   constexpr int maxExportSignatures = 100;
+
+   /**
+    * \return Signature of the contents of the file, or empty string if it could not be read
+    */
+   QString fileSignature(QString const & fileName) {
+      QFile file{fileName};
+      if (!file.open(QIODevice::ReadOnly)) {
+         qCWarning(Logging::serialization) << Q_FUNC_INFO << "Could not open" << fileName << "for reading";
+         return QString{};
+      }
+      QCryptographicHash hash{QCryptographicHash::Sha256};
+      if (!hash.addData(&file)) {
+         qCWarning(Logging::serialization) << Q_FUNC_INFO << "Could not read" << fileName;
+         return QString{};
+      }
+      return QString::fromLatin1(hash.result().toHex());
+   }
+
    /**
-    * \brief This function first validates the input file against a JSON schema (https://json-schema.org/)
+    * \return \c true if \c fileName is a file we exported (and which has not changed since), and the user has not
+    *         switched off skipping validation for such files.  Safe to call from any thread.
     */
-   bool validateAndLoad(QString const & fileName, QTextStream & userMessage) {
-      boost::json::value inputDocument;
+   bool isUnmodifiedExport(QString const & fileName) {
+      {
+         QMutexLocker locker(&exportSignaturesMutex);
+         if (!skipValidatingOwnExports || exportSignatures.isEmpty()) {
+            return false;
+         }
+      }
+      // We don't want to hold the lock while we read the file
+      QString const signature = fileSignature(fileName);
+      QMutexLocker locker(&exportSignaturesMutex);
+      return !signature.isEmpty() && exportSignatures.contains(signature);
+   }
+
+   /**
+    * \return \c true unless the user has switched off skipping validation for files we exported.  Safe to call from any
+    *         thread.
+    */
+   bool skippingValidationOfOwnExports() {
+      QMutexLocker locker(&exportSignaturesMutex);
+      return skipValidatingOwnExports;
+   }
+
+   /**
+    * \brief Remember the signature of a file we just exported.  Must be called on the GUI thread.
+    */
+   void rememberExport(QString const & fileName) {
+      BeerJson::loadExportSignatures();
+      QString const signature = fileSignature(fileName);
+      if (signature.isEmpty()) {
+         return;
+      }
+      QMutexLocker locker(&exportSignaturesMutex);
+      exportSignatures.removeAll(signature);
+      exportSignatures.prepend(signature);
+      while (exportSignatures.size() > maxExportSignatures) {
+         exportSignatures.removeLast();
+      }
+      PersistentSettings::insert(PersistentSettings::Names::beerJsonExportSignatures, exportSignatures);
+      return;
+   }
+
+   /**
+    * \brief This function reads in the input file and validates it against a JSON schema (https://json-schema.org/).
+    *        See \c BeerJson::readAndValidate for details.
+    *
+    * \param fileContents If not \c nullptr, the contents of the file, which has already been read (eg from an
+    *                     archive), in which case \c fileName is only used for logging and messages
+    */
+   std::function<bool(QTextStream &)> readAndValidate(QString const & fileName,
+                                                      QByteArray const * fileContents,
+                                                      QTextStream & userMessage) {
+      //
+      // The returned function needs to own the document, hence the shared_ptr.  The document is only needed until
+      // we've stored its contents in the DB, so we put it in its own arena (which is freed when the returned function,
+      // and thus the document, is destroyed).  Note that we have to move-construct the document here rather than
+      // assign it, as assigning to a value that uses a different memory resource would copy it out of the arena.
+      //
+      // Binary files carry their own checksum, so we don't need to look them up in exportSignatures
+      bool const binaryFile = fileContents ? BeerJsonBinary::isBinaryData(*fileContents) :
+                                             BeerJsonBinary::isBinaryFile(fileName);
+      bool checksumMatched = false;
+      std::shared_ptr<boost::json::value> inputDocumentOwner;
       try {
-         inputDocument = JsonUtils::loadJsonDocument(fileName);
+         if (fileContents) {
+            QBuffer buffer;
+            buffer.setData(*fileContents);
+            buffer.open(QIODevice::ReadOnly);
+            inputDocumentOwner = std::make_shared<boost::json::value>(
+               binaryFile ? BeerJsonBinary::read(*fileContents, fileName, JsonUtils::makeArena(), checksumMatched) :
+                            JsonUtils::loadJsonDocument(buffer, fileName, true, JsonUtils::makeArena())
+            );
+         } else {
+            inputDocumentOwner = std::make_shared<boost::json::value>(
+               binaryFile ? BeerJsonBinary::read(fileName, JsonUtils::makeArena(), checksumMatched) :
+                            JsonUtils::loadJsonDocument(fileName, true, JsonUtils::makeArena())
+            );
+         }
       } catch (std::exception const & exception) {
-         qWarning() <<
+         qCWarning(Logging::serialization) <<
             Q_FUNC_INFO << "Caught exception while reading" << fileName << ":" << exception.what();
          userMessage << exception.what();
-         return false;
+         return {};
       }
+      boost::json::value & inputDocument = *inputDocumentOwner;
 
       //
       // If there are ever multiple versions of BeerJSON, this is where we'll work out which one to use for reading
@@ -1185,20 +1312,21 @@ namespace {
       //
       QString beerJsonVersion = "";
       if (!inputDocument.is_object()) {
-         qWarning() << Q_FUNC_INFO << "Root of" << fileName << "is not a JSON object";
+         qCWarning(Logging::serialization) << Q_FUNC_INFO << "Root of" << fileName << "is not a JSON object";
       } else {
          boost::json::object const & documentRoot = inputDocument.as_object();
          if (!documentRoot.contains("beerjson")) {
-            qWarning() << Q_FUNC_INFO << "No beerjson root object found in" << fileName;
+            qCWarning(Logging::serialization) << Q_FUNC_INFO << "No beerjson root object found in" << fileName;
          } else {
             boost::json::value const & beerJsonValue = documentRoot.at("beerjson");
             if (!beerJsonValue.is_object()) {
-               qWarning() << Q_FUNC_INFO << "beerjson element in" << fileName << "is not a JSON object";
+               qCWarning(Logging::serialization) <<
+                  Q_FUNC_INFO << "beerjson element in" << fileName << "is not a JSON object";
             } else {
                boost::json::object const & beerJson = beerJsonValue.as_object();
                boost::json::value const * bjVer = beerJson.if_contains("version");
                if (!bjVer) {
-                  qWarning() << Q_FUNC_INFO << "No version found in" << fileName;
+                  qCWarning(Logging::serialization) << Q_FUNC_INFO << "No version found in" << fileName;
                } else {
                   //
                   // Version is a JSON number (in JavaScript’s double-precision floating-point format).  It would be
@@ -1206,12 +1334,14 @@ namespace {
                   // integer-dot-integer so a string would be easier to parse).  However, AFAICT, there isn't a way to
                   // do this with Boost.JSON.
                   //
-                  qDebug() << Q_FUNC_INFO << "Version" << *bjVer << "(" << bjVer->kind() << ")";
+                  qCDebug(Logging::serialization) << Q_FUNC_INFO << "Version" << *bjVer << "(" << bjVer->kind() << ")";
                   double const * bjVersion = bjVer->if_double();
                   if (!bjVersion) {
-                     qDebug() << Q_FUNC_INFO << "Could not parse version" << bjVer << "in" << fileName;
+                     qCDebug(Logging::serialization) <<
+                        Q_FUNC_INFO << "Could not parse version" << bjVer << "in" << fileName;
                   } else {
-                     qDebug() << Q_FUNC_INFO << "BeerJSON version of" << fileName << "is" << *bjVersion;
+                     qCDebug(Logging::serialization) <<
+                        Q_FUNC_INFO << "BeerJSON version of" << fileName << "is" << *bjVersion;
                      beerJsonVersion = QString::number(*bjVersion);
                   }
                }
@@ -1220,9 +1350,9 @@ namespace {
       }
 
       if (beerJsonVersion.isEmpty()) {
-         qWarning() << Q_FUNC_INFO << "Unable to read BeerJSON version from" << fileName;
+         qCWarning(Logging::serialization) << Q_FUNC_INFO << "Unable to read BeerJSON version from" << fileName;
          userMessage << "Invalid BeerJSON file: could not read version number";
-         return false;
+         return {};
       }
 
       //
@@ -1232,7 +1362,7 @@ namespace {
       // Obviously, in time, if and when BeerJSON evolves, we'll want to do something less hard-coded here!
       //
       if (beerJsonVersion != jsonVersionWeSupport) {
-         qWarning() <<
+         qCWarning(Logging::serialization) <<
             Q_FUNC_INFO << "BeerJSON version " << beerJsonVersion << "differs from what we are expecting (" <<
             jsonVersionWeSupport << ")";
       }
@@ -1241,7 +1371,21 @@ namespace {
       // line.
 //      qDebug() << Q_FUNC_INFO << "JSON file read in is:" << inputDocument;
 
-      return BEER_JSON_1_CODING.validateLoadAndStoreInDb(inputDocument, userMessage);
+      //
+      // We only keep signatures of the files we wrote, so a document that has come out of an archive can't be matched
+      // against them
+      //
+      if (binaryFile ? (checksumMatched && skippingValidationOfOwnExports()) :
+                       (!fileContents && isUnmodifiedExport(fileName))) {
+         qCInfo(Logging::serialization) <<
+            Q_FUNC_INFO << "Skipping validation of" << fileName << "as it is one of our unmodified exports";
+      } else if (!BEER_JSON_1_CODING.validate(inputDocument, userMessage)) {
+         return {};
+      }
+
+      return [inputDocumentOwner](QTextStream & userMessage) {
+         return BEER_JSON_1_CODING.loadAndStoreInDb(*inputDocumentOwner, userMessage);
+      };
    }
 
 }
@@ -1258,17 +1402,47 @@ bool BeerJson::import(QString const & filename, QTextStream & userMessage) {
    //
    RecipeHelper::SuspendRecipeVersioning suspendRecipeVersioning;
 
+   //
+   // Similarly, rather than have every table, list and tree model update itself once for each object we import, we
+   // queue up the "object inserted" signals and deliver them, to be handled as one change, at the end.
+   //
+   ObjectStoreSignalBatch objectStoreSignalBatch;
+
    //
    // Slightly more manually, we also change the cursor to show "busy" while we're doing the import as, for large
    // imports, processing can take a few seconds or so.
    //
    QApplication::setOverrideCursor(Qt::WaitCursor);
    QApplication::processEvents();
-   bool result = validateAndLoad(filename, userMessage);
+   BeerJson::loadExportSignatures();
+   auto loadAndStoreInDb = ::readAndValidate(filename, nullptr, userMessage);
+   bool result = loadAndStoreInDb && loadAndStoreInDb(userMessage);
    QApplication::restoreOverrideCursor();
    return result;
 }
 
+std::function<bool(QTextStream &)> BeerJson::readAndValidate(QString const & filename, QTextStream & userMessage) {
+   return ::readAndValidate(filename, nullptr, userMessage);
+}
+
+std::function<bool(QTextStream &)> BeerJson::readAndValidate(QString const & name,
+                                                             QByteArray const & contents,
+                                                             QTextStream & userMessage) {
+   return ::readAndValidate(name, &contents, userMessage);
+}
+
+void BeerJson::loadExportSignatures() {
+   QMutexLocker locker(&exportSignaturesMutex);
+   if (!exportSignaturesLoaded) {
+      skipValidatingOwnExports =
+         PersistentSettings::value(PersistentSettings::Names::skipValidatingOwnBeerJsonExports, true).toBool();
+      exportSignatures =
+         PersistentSettings::value(PersistentSettings::Names::beerJsonExportSignatures, QStringList{}).toStringList();
+      exportSignaturesLoaded = true;
+   }
+   return;
+}
+
 namespace BeerJson {
    //
    // This private implementation class holds all private non-virtual members of Exporter
@@ -1281,14 +1455,34 @@ namespace BeerJson {
       */
       impl(Exporter & self,
          QFile & outFile,
-         QTextStream & userMessage) : self{self},
-                                      outFile{outFile},
-                                      userMessage{userMessage},
-                                      writtenToFile{false},
-                                      outputDocument{} {
-         // We have to pass in jsonVersionWeSupport as a double, not a char * or a std::string, otherwise it will get
+         QTextStream & userMessage,
+         Exporter::Format const format) : self{self},
+                                          outFile{outFile},
+                                          userMessage{userMessage},
+                                          writtenToFile{false},
+                                          outStream{outFile},
+                                          binaryWriter{},
+                                          recordNamesWritten{} {
+         if (format != Exporter::Format::Text) {
+            this->binaryWriter = std::make_unique<BeerJsonBinary::Writer>(
+               outFile, format == Exporter::Format::CompressedBinary, std::atof(*jsonVersionWeSupport)
+            );
+            return;
+         }
+
+         //
+         // Rather than build the whole document in memory and then serialise it, we write it out as we go along, one
+         // record at a time, so that memory use does not depend on how much we are exporting.  The output is the same
+         // as JsonUtils::serialize would give for the document (with two-space indent), so we write the opening of
+         // the document here, each list of records in Exporter::add and the closing in Exporter::close.
+         //
+         // We have to write jsonVersionWeSupport as a double, not a char * or a std::string, otherwise it will get
          // quotes put around it.
-         this->outputDocument["beerjson"] = { {"version", std::atof(*jsonVersionWeSupport)} };
+         //
+         this->outStream <<
+            "{\n" << indent << boost::json::serialize(boost::json::string_view{"beerjson"}) << ": {\n" <<
+            indent << indent << boost::json::serialize(boost::json::string_view{"version"}) << ": " <<
+            std::atof(*jsonVersionWeSupport);
          return;
       }
 
@@ -1297,17 +1491,26 @@ namespace BeerJson {
       */
       ~impl() = default;
 
+      //! Indent for each level of the output document
+      static constexpr std::string_view indent{"  "};
+
       Exporter & self;
       QFile & outFile;
       QTextStream & userMessage;
       bool writtenToFile;
 
-      boost::json::object outputDocument;
+      OStreamWriterForQFile outStream;
+
+      //! Set if we are writing the binary format rather than text
+      std::unique_ptr<BeerJsonBinary::Writer> binaryWriter;
+
+      //! Each list of records can only be written once, as we've no way to go back and change it
+      QSet<QString> recordNamesWritten;
 
    };
 
-   Exporter::Exporter(QFile & outFile, QTextStream & userMessage) :
-      pimpl{std::make_unique<impl>(*this, outFile, userMessage)} {
+   Exporter::Exporter(QFile & outFile, QTextStream & userMessage, Exporter::Format const format) :
+      pimpl{std::make_unique<impl>(*this, outFile, userMessage, format)} {
       return;
    }
 
@@ -1317,21 +1520,76 @@ namespace BeerJson {
    }
 
    template<class NE> void Exporter::add(QList<NE const *> const & nes) {
-      QList< std::shared_ptr<NamedEntity> > objectsToWrite;
-      objectsToWrite.reserve(nes.size());
-      for (NE const * ne : nes) {
-         //
-         // We have to cast away const on ne, as otherwise we'll end up with static_pointer to const that's harder to
-         // cast away.  Or we'd have to write const and non-const versions of all the functions we're calling, which
-         // is strictly correct but a bit overkill here.
-         //
-         objectsToWrite.append(
-            std::static_pointer_cast<NamedEntity>(ObjectStoreWrapper::getSharedFromRaw(const_cast<NE *>(ne)))
-         );
+      char const * const recordName_c_str = *BEER_JSON_RECORD_DEFN<NE>.m_recordName;
+      QString const recordName{recordName_c_str};
+      if (this->pimpl->writtenToFile || this->pimpl->recordNamesWritten.contains(recordName)) {
+         // It's a coding error to add records after close() or to add the same type of records twice
+         qCCritical(Logging::serialization) << Q_FUNC_INFO << "Cannot add" << recordName << "records now";
+         Q_ASSERT(false);
+         return;
+      }
+      this->pimpl->recordNamesWritten.insert(recordName);
+
+      std::ostream & outStream = this->pimpl->outStream;
+      BeerJsonBinary::Writer * const binaryWriter = this->pimpl->binaryWriter.get();
+      std::string const listIndent{std::string{impl::indent}.append(impl::indent)};
+      if (binaryWriter) {
+         binaryWriter->beginList(recordName_c_str);
+      } else {
+         outStream <<
+            ",\n" << listIndent << boost::json::serialize(boost::json::string_view{recordName_c_str}) << ": [\n";
+      }
+      std::string const recordIndent{std::string{listIndent}.append(impl::indent)};
+      bool firstWritten = false;
+      // When there are lots of records, they get rendered in parallel -- see comments in utils/ParallelRender.h
+      bool const succeeded = ParallelRender::renderAndWrite(
+         nes,
+         [&recordIndent, binaryWriter](NE const * ne) -> std::optional<std::string> {
+            //
+            // We have to cast away const on ne, as otherwise we'll end up with static_pointer to const that's harder
+            // to cast away.  Or we'd have to write const and non-const versions of all the functions we're calling,
+            // which is strictly correct but a bit overkill here.
+            //
+            auto objectToWrite{
+               std::static_pointer_cast<NamedEntity>(ObjectStoreWrapper::getSharedFromRaw(const_cast<NE *>(ne)))
+            };
+            //
+            // As in JsonRecord::listToJson, we need the containing entity to be a value of type object, but here we
+            // write it out as soon as it's built, so we only ever have a few records at a time in memory.
+            //
+            // (Can't use braces on this constructor until Boost 1.81!)
+            boost::json::value neJson(boost::json::object_kind);
+            std::unique_ptr<JsonRecord> jsonRecord{BEER_JSON_RECORD_DEFN<NE>.makeRecord(BEER_JSON_1_CODING, neJson)};
+            if (!jsonRecord->toJson(*objectToWrite)) {
+               return std::nullopt;
+            }
+            if (binaryWriter) {
+               return BeerJsonBinary::encode(neJson);
+            }
+            std::ostringstream rendered;
+            std::string currentIndent{recordIndent};
+            JsonUtils::serialize(rendered, neJson, impl::indent, &currentIndent);
+            return rendered.str();
+         },
+         [&](std::string const & rendered) {
+            if (binaryWriter) {
+               binaryWriter->addRecord(rendered);
+               return;
+            }
+            if (firstWritten) {
+               outStream << ",\n";
+            }
+            outStream << recordIndent << rendered;
+            firstWritten = true;
+            return;
+         }
+      );
+      if (!succeeded) {
+         qCWarning(Logging::serialization) << Q_FUNC_INFO << "Stopped export of" << recordName << "after error";
+      }
+      if (!binaryWriter) {
+         outStream << "\n" << listIndent << "]";
       }
-      boost::json::array outputArray;
-      JsonRecord::listToJson(objectsToWrite, outputArray, BEER_JSON_1_CODING, BEER_JSON_RECORD_DEFN<NE>);
-      this->pimpl->outputDocument["beerjson"].get_object()[*BEER_JSON_RECORD_DEFN<NE>.m_recordName] = outputArray;
       return;
    }
 
@@ -1358,11 +1616,28 @@ namespace BeerJson {
          return;
       }
 
-      OStreamWriterForQFile outStream(this->pimpl->outFile);
-      JsonUtils::serialize(outStream, this->pimpl->outputDocument, "  ");
+      // The binary format has its own checksum, so there's no need to remember a signature for it
+      if (this->pimpl->binaryWriter) {
+         if (!this->pimpl->binaryWriter->close()) {
+            qCWarning(Logging::serialization) <<
+               Q_FUNC_INFO << "Error writing" << this->pimpl->outFile.fileName() << ":" <<
+               this->pimpl->outFile.errorString();
+            this->pimpl->userMessage << QObject::tr("Error writing file");
+         }
+         this->pimpl->writtenToFile = true;
+         return;
+      }
+
+      // See comment in Exporter::impl constructor
+      this->pimpl->outStream << "\n" << impl::indent << "}\n}\n";
+      this->pimpl->outStream.flush();
 
       this->pimpl->writtenToFile = true;
 
+      // The file has to be on disk before we can sign it.  (The caller will close the file, but that's fine.)
+      this->pimpl->outFile.flush();
+      rememberExport(this->pimpl->outFile.fileName());
+
       return;
    }
 
@@ -17,17 +17,20 @@
 #define SERIALIZATION_JSON_BEERJSON_H
 #pragma once
 
+#include <functional>
 #include <memory> // For PImpl
 
 #include <QList>
 
+class QByteArray;
 class QFile;
 class QString;
 class QTextStream;
 
 namespace BeerJson {
    /*!
-    * \brief Import ingredients, recipes, etc from a BeerJSON file
+    * \brief Import ingredients, recipes, etc from a BeerJSON file, or a file in our binary form of BeerJSON (see
+    *        \c BeerJsonBinary)
     *
     * \param filename
     * \param userMessage Where to write any (brief!) message we want to be shown to the user after the import.
@@ -37,27 +40,70 @@ namespace BeerJson {
     */
    bool import(QString const & filename, QTextStream & userMessage);
 
+   /**
+    * \brief First half of \c import: read a BeerJSON file and validate it against the schema.  This is safe to call
+    *        from any thread, including for several files at once.
+    *
+    * \return If the file is valid, a function that must be called on the GUI thread (with recipe versioning suspended)
+    *         to load the file's contents and store them in the DB, and which takes and returns the same as \c import.
+    *         If the file is not valid, an empty function, and the reason is in \c userMessage.
+    */
+   std::function<bool(QTextStream &)> readAndValidate(QString const & filename, QTextStream & userMessage);
+
+   /**
+    * \brief As above, but for a document that has already been read into memory (eg an entry in a zip archive) rather
+    *        than being in a file of its own.  \c name is only used for logging and messages.
+    */
+   std::function<bool(QTextStream &)> readAndValidate(QString const & name,
+                                                      QByteArray const & contents,
+                                                      QTextStream & userMessage);
+
+   /**
+    * \brief Schema validation is skipped when importing an unmodified file that we exported (unless the user has
+    *        turned this off via \c PersistentSettings::Names::skipValidatingOwnBeerJsonExports).  The record of what
+    *        we exported is kept in \c PersistentSettings, which can only be read on the GUI thread, so this needs to be
+    *        called (on the GUI thread) before \c readAndValidate is called from any other thread.  It is safe to call
+    *        more than once.
+    */
+   void loadExportSignatures();
+
    /**
     * \brief Objects of this class are intended to be relatively short-lived, existing only for the time it takes to
     *        construct the serialized representation and write it to a file.
+    *
+    *        The output is streamed to the file as each record is serialized, so memory use does not grow with the
+    *        number of records exported.
     */
    class Exporter {
    public:
+      //! Whether to write normal BeerJSON or our binary form of it (see \c BeerJsonBinary)
+      enum class Format {
+         Text,
+         Binary,
+         CompressedBinary
+      };
+
       /**
       * \param outFile Should be open already.  Caller is responsible for closing it after \c close() or our destructor
       *                is called
       * \param userMessage
+      * \param format
       */
-      Exporter(QFile & outFile, QTextStream & userMessage);
+      Exporter(QFile & outFile, QTextStream & userMessage, Format const format = Format::Text);
       ~Exporter();
 
       /**
-      * \brief Add a list of \c NamedEntity objects to the serializer
+      * \brief Serialize a list of \c NamedEntity objects to the file.  Each type of \c NamedEntity can only be added
+      *        once, and not after \c close() has been called.
+      *
+      *        Long lists are rendered on several threads, so, as in \c ImportExport::exportToFile, the caller needs to
+      *        have called \c HydrateAllObjectStores (and made sure any \c Recipe calculations are up-to-date) first.
       */
       template<class NE> void add(QList<NE const *> const & nes);
 
       /**
-      * \brief Write the serialized data to the file.  Will be called in destructor if not already invoked directly.
+      * \brief Finish writing the serialized data to the file.  Will be called in destructor if not already invoked
+      *        directly.
       */
       void close();
 
@@ -0,0 +1,430 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * serialization/json/BeerJsonBinary.cpp is part of Brewtarget, and is copyright the following authors 2024:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#include "serialization/json/BeerJsonBinary.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <new>
+
+#include <boost/json/array.hpp>
+#include <boost/json/object.hpp>
+#include <boost/json/string.hpp>
+
+#include <QByteArray>
+#include <QCryptographicHash>
+#include <QFile>
+#include <QIODevice>
+#include <QObject>
+#include <QString>
+#include <QtEndian>
+
+#include "Logging.h"
+#include "utils/BtException.h"
+#include "utils/BtStringStream.h"
+
+namespace {
+   constexpr char magic[4] = {'B', 'T', 'B', 'J'};
+   constexpr quint16 formatVersion = 1;
+   constexpr quint16 flagCompressed = 0x0001;
+   constexpr int headerSize = sizeof(magic) + sizeof(quint16) + sizeof(quint16) + sizeof(quint64);
+   constexpr int checksumSize = 32; // SHA-256
+
+   //! Blocks are written once they get to at least this size.  Big enough to compress well.
+   constexpr int blockSize = 256 * 1024;
+
+   //! Guards against a corrupt (or malicious) file making us recurse until we run out of stack
+   constexpr int maxNestingDepth = 64;
+
+   // Item types in the contents of the blocks
+   constexpr char itemList   = 'L';
+   constexpr char itemRecord = 'R';
+
+   // Tags for encoded JSON values
+   enum class Tag : char {
+      Null,
+      False,
+      True,
+      Int64,
+      UInt64,
+      Double,
+      String,
+      Array,
+      Object
+   };
+
+   template<typename T> void append(std::string & output, T const value) {
+      char bytes[sizeof(T)];
+      qToLittleEndian(value, bytes);
+      output.append(bytes, sizeof(T));
+      return;
+   }
+
+   void appendString(std::string & output, char const * const data, std::size_t const size) {
+      append(output, static_cast<quint32>(size));
+      output.append(data, size);
+      return;
+   }
+
+   void encodeValue(std::string & output, boost::json::value const & value) {
+      switch (value.kind()) {
+         case boost::json::kind::null:
+            output.push_back(static_cast<char>(Tag::Null));
+            break;
+         case boost::json::kind::bool_:
+            output.push_back(static_cast<char>(value.get_bool() ? Tag::True : Tag::False));
+            break;
+         case boost::json::kind::int64:
+            output.push_back(static_cast<char>(Tag::Int64));
+            append(output, static_cast<qint64>(value.get_int64()));
+            break;
+         case boost::json::kind::uint64:
+            output.push_back(static_cast<char>(Tag::UInt64));
+            append(output, static_cast<quint64>(value.get_uint64()));
+            break;
+         case boost::json::kind::double_:
+            output.push_back(static_cast<char>(Tag::Double));
+            append(output, std::bit_cast<quint64>(value.get_double()));
+            break;
+         case boost::json::kind::string:
+            output.push_back(static_cast<char>(Tag::String));
+            appendString(output, value.get_string().data(), value.get_string().size());
+            break;
+         case boost::json::kind::array:
+            output.push_back(static_cast<char>(Tag::Array));
+            append(output, static_cast<quint32>(value.get_array().size()));
+            for (auto const & element : value.get_array()) {
+               encodeValue(output, element);
+            }
+            break;
+         case boost::json::kind::object:
+            output.push_back(static_cast<char>(Tag::Object));
+            append(output, static_cast<quint32>(value.get_object().size()));
+            for (auto const & keyValuePair : value.get_object()) {
+               appendString(output, keyValuePair.key().data(), keyValuePair.key().size());
+               encodeValue(output, keyValuePair.value());
+            }
+            break;
+      }
+      return;
+   }
+
+   [[noreturn]] void throwCorrupt(QString const & fileName, char const * const what) {
+      BtStringStream errorMessage;
+      errorMessage << "File " << fileName << " is not a valid binary BeerJSON file (" << what << ")";
+      qCWarning(Logging::serialization) << Q_FUNC_INFO << errorMessage.asString();
+      throw BtException(errorMessage.asString());
+   }
+
+   /**
+    * \brief Reads from a block of memory, checking we don't go past the end of it
+    */
+   class Reader {
+   public:
+      Reader(QString const & fileName, char const * start, char const * end) :
+         m_fileName{fileName}, m_position{start}, m_end{end} {
+         return;
+      }
+
+      bool atEnd() const {
+         return this->m_position == this->m_end;
+      }
+
+      std::string_view readBytes(std::size_t const numBytes) {
+         if (static_cast<std::size_t>(this->m_end - this->m_position) < numBytes) {
+            throwCorrupt(this->m_fileName, "unexpected end of data");
+         }
+         std::string_view const bytes{this->m_position, numBytes};
+         this->m_position += numBytes;
+         return bytes;
+      }
+
+      template<typename T> T read() {
+         return qFromLittleEndian<T>(this->readBytes(sizeof(T)).data());
+      }
+
+      std::string_view readString() {
+         return this->readBytes(this->read<quint32>());
+      }
+
+      boost::json::string_view readJsonString() {
+         std::string_view const key = this->readString();
+         return boost::json::string_view{key.data(), key.size()};
+      }
+
+      boost::json::value readValue(boost::json::storage_ptr const & storage, int const depth = 0) {
+         if (depth > maxNestingDepth) {
+            throwCorrupt(this->m_fileName, "nested too deeply");
+         }
+         Tag const tag = static_cast<Tag>(this->readBytes(1)[0]);
+         switch (tag) {
+            case Tag::Null  : return boost::json::value(nullptr, storage);
+            case Tag::False : return boost::json::value(false, storage);
+            case Tag::True  : return boost::json::value(true, storage);
+            case Tag::Int64 : return boost::json::value(static_cast<std::int64_t>(this->read<qint64>()), storage);
+            case Tag::UInt64: return boost::json::value(static_cast<std::uint64_t>(this->read<quint64>()), storage);
+            case Tag::Double: return boost::json::value(std::bit_cast<double>(this->read<quint64>()), storage);
+            case Tag::String: return boost::json::value(boost::json::string{this->readJsonString(), storage});
+            case Tag::Array:
+               {
+                  quint32 const numElements = this->read<quint32>();
+                  boost::json::array array(storage);
+                  // Each element is at least one byte, so this stops a bad size making us reserve lots of memory
+                  array.reserve(std::min<std::size_t>(numElements, this->m_end - this->m_position));
+                  for (quint32 ii = 0; ii < numElements; ++ii) {
+                     array.push_back(this->readValue(storage, depth + 1));
+                  }
+                  return boost::json::value(std::move(array));
+               }
+            case Tag::Object:
+               {
+                  quint32 const numMembers = this->read<quint32>();
+                  boost::json::object object(storage);
+                  object.reserve(std::min<std::size_t>(numMembers, this->m_end - this->m_position));
+                  for (quint32 ii = 0; ii < numMembers; ++ii) {
+                     boost::json::string_view const key = this->readJsonString();
+                     object.emplace(key, this->readValue(storage, depth + 1));
+                  }
+                  return boost::json::value(std::move(object));
+               }
+         }
+         throwCorrupt(this->m_fileName, "unknown value type");
+      }
+
+   private:
+      QString const & m_fileName;
+      char const * m_position;
+      char const * const m_end;
+   };
+
+}
+
+bool BeerJsonBinary::isBinaryFile(QString const & fileName) {
+   QFile file{fileName};
+   if (!file.open(QIODevice::ReadOnly)) {
+      return false;
+   }
+   return BeerJsonBinary::isBinaryData(file.read(sizeof(magic)));
+}
+
+bool BeerJsonBinary::isBinaryData(QByteArray const & contents) {
+   return contents.startsWith(QByteArray::fromRawData(magic, sizeof(magic)));
+}
+
+std::string BeerJsonBinary::encode(boost::json::value const & value) {
+   std::string encoded;
+   encodeValue(encoded, value);
+   return encoded;
+}
+
+[[nodiscard]] boost::json::value BeerJsonBinary::read(QString const & fileName,
+                                                      boost::json::storage_ptr storage,
+                                                      bool & checksumMatched) {
+   QFile inputFile{fileName};
+   if (!inputFile.open(QIODevice::ReadOnly)) {
+      qCWarning(Logging::serialization) <<
+         Q_FUNC_INFO << "Could not open " << fileName << " for reading (error #" << inputFile.error() << ":" <<
+         inputFile.errorString() << ")";
+      throw BtException(QObject::tr("Could not open %1 for reading (error # %2)").arg(fileName).arg(inputFile.error()));
+   }
+   return BeerJsonBinary::read(inputFile.readAll(), fileName, storage, checksumMatched);
+}
+
+[[nodiscard]] boost::json::value BeerJsonBinary::read(QByteArray const & fileContents,
+                                                      QString const & fileName,
+                                                      boost::json::storage_ptr storage,
+                                                      bool & checksumMatched) {
+   try {
+      Reader fileReader{fileName, fileContents.constData(), fileContents.constData() + fileContents.size()};
+      if (fileContents.size() < headerSize ||
+          fileReader.readBytes(sizeof(magic)) != std::string_view{magic, sizeof(magic)}) {
+         throwCorrupt(fileName, "no header");
+      }
+      quint16 const fileFormatVersion = fileReader.read<quint16>();
+      if (fileFormatVersion > formatVersion) {
+         throwCorrupt(fileName, "written by a newer version of the program");
+      }
+      bool const compressed = fileReader.read<quint16>() & flagCompressed;
+      double const beerJsonVersion = std::bit_cast<double>(fileReader.read<quint64>());
+
+      //
+      // Get the contents of all the blocks, checking them against the checksum as we go
+      //
+      QCryptographicHash hash{QCryptographicHash::Sha256};
+      QByteArray contents;
+      for (;;) {
+         quint32 const uncompressedSize = fileReader.read<quint32>();
+         quint32 const storedSize = fileReader.read<quint32>();
+         if (uncompressedSize == 0 && storedSize == 0) {
+            break;
+         }
+         std::string_view const storedBytes = fileReader.readBytes(storedSize);
+         QByteArray block = QByteArray::fromRawData(storedBytes.data(), static_cast<int>(storedBytes.size()));
+         if (compressed) {
+            block = qUncompress(block);
+         }
+         if (static_cast<quint32>(block.size()) != uncompressedSize) {
+            throwCorrupt(fileName, "bad block");
+         }
+         hash.addData(block);
+         contents.append(block);
+      }
+      std::string_view const checksum = fileReader.readBytes(checksumSize);
+      checksumMatched = hash.result() == QByteArray::fromRawData(checksum.data(), checksumSize);
+      if (!checksumMatched) {
+         qCWarning(Logging::serialization) << Q_FUNC_INFO << "Checksum of" << fileName << "does not match its contents";
+      }
+
+      //
+      // Now turn the items into a document, with the same structure as BeerJson::Exporter writes for the text format
+      //
+      boost::json::value document(boost::json::object_kind, storage);
+      boost::json::object & beerJson =
+         document.as_object().emplace("beerjson", boost::json::object(storage)).first->value().as_object();
+      beerJson.emplace("version", beerJsonVersion);
+      boost::json::array * currentList = nullptr;
+      Reader contentsReader{fileName, contents.constData(), contents.constData() + contents.size()};
+      while (!contentsReader.atEnd()) {
+         char const itemType = contentsReader.readBytes(1)[0];
+         if (itemType == itemList) {
+            boost::json::string_view const listName = contentsReader.readJsonString();
+            currentList = &beerJson.emplace(listName, boost::json::array(storage)).first->value().as_array();
+         } else if (itemType == itemRecord && currentList) {
+            std::string_view const encodedRecord = contentsReader.readString();
+            Reader recordReader{fileName, encodedRecord.data(), encodedRecord.data() + encodedRecord.size()};
+            currentList->push_back(recordReader.readValue(storage));
+            if (!recordReader.atEnd()) {
+               throwCorrupt(fileName, "bad record length");
+            }
+         } else {
+            throwCorrupt(fileName, "unknown item");
+         }
+      }
+
+      return document;
+   } catch (std::bad_alloc const & exception) {
+      // As in JsonUtils::loadJsonDocument
+      BtStringStream errorMessage;
+      errorMessage << "Memory allocation error (" << exception.what() << ") while reading " << fileName;
+      qCWarning(Logging::serialization) << Q_FUNC_INFO << errorMessage.asString();
+      throw BtException(errorMessage.asString());
+   }
+}
+
+class BeerJsonBinary::Writer::impl {
+public:
+   impl(QIODevice & output, bool const compress) :
+      m_output{output},
+      m_compress{compress},
+      m_block{},
+      m_hash{QCryptographicHash::Sha256},
+      m_succeeded{true},
+      m_closed{false} {
+      this->m_block.reserve(blockSize);
+      return;
+   }
+
+   ~impl() = default;
+
+   void write(char const * data, qint64 const size) {
+      if (this->m_output.write(data, size) != size) {
+         this->m_succeeded = false;
+      }
+      return;
+   }
+
+   void write(std::string const & data) {
+      this->write(data.data(), static_cast<qint64>(data.size()));
+      return;
+   }
+
+   void writeBlock() {
+      if (this->m_block.empty()) {
+         return;
+      }
+      QByteArray const uncompressed =
+         QByteArray::fromRawData(this->m_block.data(), static_cast<int>(this->m_block.size()));
+      this->m_hash.addData(uncompressed);
+      QByteArray const stored = this->m_compress ? qCompress(uncompressed) : uncompressed;
+
+      std::string blockHeader;
+      append(blockHeader, static_cast<quint32>(uncompressed.size()));
+      append(blockHeader, static_cast<quint32>(stored.size()));
+      this->write(blockHeader);
+      this->write(stored.constData(), stored.size());
+      this->m_block.clear();
+      return;
+   }
+
+   void addItem(char const itemType, std::string_view const data) {
+      this->m_block.push_back(itemType);
+      appendString(this->m_block, data.data(), data.size());
+      if (this->m_block.size() >= static_cast<std::size_t>(blockSize)) {
+         this->writeBlock();
+      }
+      return;
+   }
+
+   QIODevice & m_output;
+   bool const m_compress;
+   //! Contents of the block we are building
+   std::string m_block;
+   QCryptographicHash m_hash;
+   bool m_succeeded;
+   bool m_closed;
+};
+
+BeerJsonBinary::Writer::Writer(QIODevice & output, bool const compress, double const beerJsonVersion) :
+   pimpl{std::make_unique<impl>(output, compress)} {
+   std::string header{magic, sizeof(magic)};
+   append(header, formatVersion);
+   append(header, static_cast<quint16>(compress ? flagCompressed : 0));
+   append(header, std::bit_cast<quint64>(beerJsonVersion));
+   this->pimpl->write(header);
+   return;
+}
+
+BeerJsonBinary::Writer::~Writer() {
+   this->close();
+   return;
+}
+
+void BeerJsonBinary::Writer::beginList(std::string_view const listName) {
+   // It's a coding error to add anything after close()
+   Q_ASSERT(!this->pimpl->m_closed);
+   this->pimpl->addItem(itemList, listName);
+   return;
+}
+
+void BeerJsonBinary::Writer::addRecord(std::string_view const encodedRecord) {
+   Q_ASSERT(!this->pimpl->m_closed);
+   this->pimpl->addItem(itemRecord, encodedRecord);
+   return;
+}
+
+bool BeerJsonBinary::Writer::close() {
+   if (!this->pimpl->m_closed) {
+      this->pimpl->writeBlock();
+      std::string endMarker;
+      append(endMarker, static_cast<quint32>(0));
+      append(endMarker, static_cast<quint32>(0));
+      this->pimpl->write(endMarker);
+      QByteArray const checksum = this->pimpl->m_hash.result();
+      this->pimpl->write(checksum.constData(), checksum.size());
+      this->pimpl->m_closed = true;
+   }
+   return this->pimpl->m_succeeded;
+}
@@ -0,0 +1,134 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * serialization/json/BeerJsonBinary.h is part of Brewtarget, and is copyright the following authors 2024:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#ifndef SERIALIZATION_JSON_BEERJSONBINARY_H
+#define SERIALIZATION_JSON_BEERJSONBINARY_H
+#pragma once
+
+#include <memory> // For PImpl
+#include <string>
+#include <string_view>
+
+#include <boost/json/storage_ptr.hpp>
+#include <boost/json/value.hpp>
+
+class QByteArray;
+class QIODevice;
+class QString;
+
+/**
+ * \brief Compact binary form of a BeerJSON document, for moving large numbers of records between installations of the
+ *        program more quickly than the text form allows.  Other programs won't understand it, so it complements rather
+ *        than replaces BeerJSON.
+ *
+ *        The records in the file are exactly the JSON objects that \c JsonRecord writes for BeerJSON (so the same
+ *        \c JsonRecordDefinition field tables drive both forms), and reading a file gives back the same document as
+ *        reading the equivalent text file would.  What's different is the encoding:
+ *           - Each JSON value is a one-byte tag followed, for numbers, by the value and, for strings, arrays and
+ *             objects, by a length and then the contents.  So there is no text to parse.
+ *           - Each record is prefixed by its length.
+ *           - Records are written in blocks, each of which can be compressed (with zlib, via \c qCompress).
+ *           - The file ends with a SHA-256 checksum of the (uncompressed) contents.  If this matches, we know the file
+ *             is exactly what we wrote, so, since we only ever write valid BeerJSON, there is no need to validate it
+ *             against the schema when importing it.
+ *
+ *        Layout of the file (all integers are little-endian):
+ *           "BTBJ" | format version (uint16) | flags (uint16) | BeerJSON version (double)
+ *           zero or more blocks: uncompressed size (uint32) | stored size (uint32) | stored bytes
+ *           end marker (two zero uint32) | SHA-256 of the uncompressed contents of all the blocks (32 bytes)
+ *
+ *        Concatenated, the uncompressed blocks are a sequence of items, each of which is either the start of a list of
+ *        records ('L', then the length-prefixed name of the list, eg "hop_varieties") or a record in the current list
+ *        ('R', then the length-prefixed encoded record).
+ */
+namespace BeerJsonBinary {
+   /**
+    * \return \c true if the file starts with the identifier of our binary format
+    */
+   bool isBinaryFile(QString const & fileName);
+
+   /**
+    * \return \c true if \c contents starts with the identifier of our binary format
+    */
+   bool isBinaryData(QByteArray const & contents);
+
+   /**
+    * \brief Encode one record (or any other JSON value), ready for \c Writer::addRecord.  Safe to call from any
+    *        thread, so records can be encoded in parallel.
+    */
+   std::string encode(boost::json::value const & value);
+
+   /**
+    * \brief Read a file written by \c Writer into a BeerJSON document.
+    *
+    * \param storage As for \c JsonUtils::loadJsonDocument
+    * \param checksumMatched OUT - Whether the file's contents match the checksum saved in it
+    *
+    * \throw BtException containing text that can be displayed to the user
+    */
+   [[nodiscard]] boost::json::value read(QString const & fileName,
+                                         boost::json::storage_ptr storage,
+                                         bool & checksumMatched);
+
+   /**
+    * \brief As above, but for the contents of a file that has already been read into memory (eg from an archive)
+    *
+    * \param fileName Used in error messages
+    */
+   [[nodiscard]] boost::json::value read(QByteArray const & fileContents,
+                                         QString const & fileName,
+                                         boost::json::storage_ptr storage,
+                                         bool & checksumMatched);
+
+   /**
+    * \brief Writes a file in our binary format.  As with \c BeerJson::Exporter (which is what uses this), output is
+    *        written as we go along, so memory use does not grow with the number of records.
+    */
+   class Writer {
+   public:
+      /**
+       * \param output Should be open already.  Caller is responsible for closing it after \c close() is called.
+       * \param compress Whether to compress the blocks
+       * \param beerJsonVersion The BeerJSON version number to put in the document we read back
+       */
+      Writer(QIODevice & output, bool const compress, double const beerJsonVersion);
+      ~Writer();
+
+      //! \brief Start a new list of records, eg "hop_varieties".  Each subsequent record goes in this list.
+      void beginList(std::string_view const listName);
+
+      //! \brief Add to the current list a record encoded with \c encode
+      void addRecord(std::string_view const encodedRecord);
+
+      /**
+       * \brief Write out the last block and the checksum.  Nothing can be added afterwards.
+       *
+       * \return \c false if there was an error writing to \c output at any point
+       */
+      bool close();
+
+   private:
+      // Private implementation details - see https://herbsutter.com/gotw/_100/
+      class impl;
+      std::unique_ptr<impl> pimpl;
+
+      Writer(Writer const &) = delete;
+      Writer & operator=(Writer const &) = delete;
+      Writer(Writer &&) = delete;
+      Writer & operator=(Writer &&) = delete;
+   };
+}
+
+#endif
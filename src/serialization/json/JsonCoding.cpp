@@ -23,8 +23,10 @@
 #include <QDebug>
 #include <QFile>
 
+#include "Logging.h"
 #include "serialization/json/JsonRecord.h"
 #include "serialization/json/JsonUtils.h"
+#include "utils/ImportPhaseTimings.h"
 #include "utils/ImportRecordCount.h"
 
 //
@@ -82,27 +84,30 @@ JsonRecordDefinition const & JsonCoding::getRoot() const {
    return this->pimpl->m_rootRecordDefinition;
 }
 
-bool JsonCoding::validateLoadAndStoreInDb(boost::json::value & inputDocument,
-                                          QTextStream & userMessage) const {
+bool JsonCoding::validate(boost::json::value const & inputDocument, QTextStream & userMessage) const {
    try {
       JsonSchema const & schema = JsonSchema::instance(this->pimpl->m_schemaId);
+      ImportPhaseTimings::ScopedTimer validationTimer{ImportPhaseTimings::Phase::Validation};
       if (!schema.validate(inputDocument, userMessage)) {
-         qWarning() << Q_FUNC_INFO << "Schema validation failed";
+         qCWarning(Logging::serialization) << Q_FUNC_INFO << "Schema validation failed";
          return false;
       }
 
    } catch (std::exception const & exception) {
-      qWarning() <<
+      qCWarning(Logging::serialization) <<
          Q_FUNC_INFO << "Caught exception while validating JSON file:" << exception.what();
       userMessage << exception.what();
       return false;
    }
 
-   qDebug() << Q_FUNC_INFO << "Schema validation succeeded";
+   qCDebug(Logging::serialization) << Q_FUNC_INFO << "Schema validation succeeded";
+   return true;
+}
 
+bool JsonCoding::loadAndStoreInDb(boost::json::value & inputDocument, QTextStream & userMessage) const {
    //
    // We're expecting the root of the JSON document to be an object named "beerjson".  This should have been
-   // established by the validation above.
+   // established by the caller having called validate() first.
    //
    // Of course, if we were being truly general, we would not hard-code "beerjson" here but rather have it as some
    // construction parameter of JsonCoding.  But, we do not foresee this being necessary any time soon (or possibly
@@ -118,7 +123,8 @@ bool JsonCoding::validateLoadAndStoreInDb(boost::json::value & inputDocument,
 
    boost::json::value & rootRecordData = *documentRoot.if_contains("beerjson"); //documentRoot["beerjson"];
    Q_ASSERT(rootRecordData.is_object());
-   qDebug() << Q_FUNC_INFO << "Root record contains" << rootRecordData.as_object().size() << "elements";
+   qCDebug(Logging::serialization) <<
+      Q_FUNC_INFO << "Root record contains" << rootRecordData.as_object().size() << "elements";
 
    //
    // Now we've loaded the JSON document into memory and determined that it's valid against its schema, we need to
@@ -132,19 +138,30 @@ bool JsonCoding::validateLoadAndStoreInDb(boost::json::value & inputDocument,
    // Look at the root object first
    //
    JsonRecord rootRecord{*this, rootRecordData, this->pimpl->m_rootRecordDefinition};
-   qDebug() << Q_FUNC_INFO << "Looking at field definitions of root element (" << this->pimpl->m_rootRecordDefinition.m_recordName << ")";
+   qCDebug(Logging::serialization) <<
+      Q_FUNC_INFO << "Looking at field definitions of root element (" <<
+      this->pimpl->m_rootRecordDefinition.m_recordName << ")";
 
    ImportRecordCount stats;
 
-   if (!rootRecord.load(userMessage)) {
-      return false;
+   {
+      ImportPhaseTimings::ScopedTimer loadTimer{ImportPhaseTimings::Phase::Load};
+      if (!rootRecord.load(userMessage)) {
+         return false;
+      }
    }
-   qDebug() << Q_FUNC_INFO;
+   qCDebug(Logging::serialization) << Q_FUNC_INFO;
 
    // At the root level, Succeeded and FoundDuplicate are both OK return values.  It's only Failed that indicates an
    // error (rather than in info) message for the user in userMessage.
-   if (JsonRecord::ProcessingResult::Failed == rootRecord.normaliseAndStoreInDb(nullptr, userMessage, stats)) {
-      return false;
+   {
+      ImportPhaseTimings::ScopedTimer storeTimer{ImportPhaseTimings::Phase::NormaliseAndStoreInDb};
+      if (JsonRecord::ProcessingResult::Failed == rootRecord.normaliseAndStoreInDb(nullptr, userMessage, stats)) {
+         if (stats.isCancelled()) {
+            stats.rollBack(userMessage);
+         }
+         return false;
+      }
    }
 
    // Everything went OK - unless we found no content to read.
@@ -152,3 +169,11 @@ bool JsonCoding::validateLoadAndStoreInDb(boost::json::value & inputDocument,
    // true otherwise
    return stats.writeToUserMessage(userMessage);
 }
+
+bool JsonCoding::validateLoadAndStoreInDb(boost::json::value & inputDocument,
+                                          QTextStream & userMessage) const {
+   if (!this->validate(inputDocument, userMessage)) {
+      return false;
+   }
+   return this->loadAndStoreInDb(inputDocument, userMessage);
+}
@@ -72,6 +72,21 @@ public:
     */
    JsonRecordDefinition const & getRoot() const;
 
+   /**
+    * \brief Validate JSON file against schema without loading anything from it.  Unlike the functions below, this is
+    *        safe to call from any thread, so that validation can happen off the GUI thread.  See
+    *        \c ImportExport::importFromFiles.
+    *
+    * \return true if file validated OK, false otherwise
+    */
+   bool validate(boost::json::value const & inputDocument, QTextStream & userMessage) const;
+
+   /**
+    * \brief Load the contents of a JSON file that has been through \c validate into objects, and store them in the
+    *        DB.  This creates model objects, so must be called on the GUI thread.
+    */
+   bool loadAndStoreInDb(boost::json::value & inputDocument, QTextStream & userMessage) const;
+
    /**
     * \brief Validate JSON file against schema, load its contents into objects, and store then in the DB
     *
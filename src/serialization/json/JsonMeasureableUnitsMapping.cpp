@@ -17,31 +17,52 @@
 
 #include <stdexcept>
 
-#include <boost/algorithm/string/predicate.hpp>
-
 #include <QDebug>
 
+#include "Logging.h"
+
+namespace {
+   /**
+    * \brief Lower-case ASCII letters only.  (Unit names are short, so this will normally fit in the small string
+    *        buffer and not need to allocate.)
+    */
+   std::string foldCase(std::string_view const input) {
+      std::string folded{input};
+      for (char & character : folded) {
+         if (character >= 'A' && character <= 'Z') {
+            character = static_cast<char>(character - 'A' + 'a');
+         }
+      }
+      return folded;
+   }
+}
+
 JsonMeasureableUnitsMapping::JsonMeasureableUnitsMapping(std::initializer_list<decltype(nameToUnit)::value_type> init,
                                                          JsonXPath const unitField,
                                                          JsonXPath const valueField) :
    nameToUnit{init},
+   foldedNameToUnit{},
+   unitToName{},
    unitField{unitField},
    valueField{valueField} {
+   // NB: emplace does not overwrite existing entries, which gives us the "first one wins" behaviour we want
+   for (auto const & [unitName, unit] : this->nameToUnit) {
+      this->foldedNameToUnit.emplace(foldCase(unitName), unit);
+      this->unitToName.emplace(unit, unitName);
+   }
    return;
 }
 
 JsonMeasureableUnitsMapping::~JsonMeasureableUnitsMapping() = default;
 
 std::string_view JsonMeasureableUnitsMapping::getNameForUnit(Measurement::Unit const & unitToMatch) const {
-   // We could use std::find_if here with a lambda, but a loop with structured bindings is more concise in this instance
-   for (auto const & [unitName, unit] : this->nameToUnit) {
-      if (unit == &unitToMatch) {
-         return unitName;
-      }
+   auto const match = this->unitToName.find(&unitToMatch);
+   if (match != this->unitToName.end()) {
+      return match->second;
    }
 
    // It's almost certainly a coding error if we get here - because we should always have a mapping for a Unit we use.
-   qCritical() <<
+   qCCritical(Logging::serialization) <<
       Q_FUNC_INFO << "No name found for Unit" << unitToMatch << "while searching mapping for" <<
       this->getPhysicalQuantity();
    throw std::invalid_argument("Unit not found in JsonMeasureableUnitsMapping");
@@ -54,44 +75,21 @@ Measurement::PhysicalQuantity JsonMeasureableUnitsMapping::getPhysicalQuantity()
 }
 
 bool JsonMeasureableUnitsMapping::containsUnit(std::string_view const unitName, MatchType const matchType) const {
-
-   if (matchType == JsonMeasureableUnitsMapping::MatchType::CaseSensitive) {
-      return this->nameToUnit.contains(unitName);
-   }
-
-   Q_ASSERT(matchType == JsonMeasureableUnitsMapping::MatchType::CaseInsensitive);
-
-   //
-   // In theory this is somewhat inefficient.  In practice, the size of the collections we are searching is so small
-   // (just a handful of entries) that it doesn't matter.
-   //
-   for (auto ii = this->nameToUnit.cbegin(); ii != this->nameToUnit.cend(); ++ii) {
-      if (boost::iequals(ii->first, unitName)) {
-         return true;
-      }
-   }
-   return false;
-
+   return this->findUnit(unitName, matchType) != nullptr;
 }
 
 Measurement::Unit const * JsonMeasureableUnitsMapping::findUnit(std::string_view const unitName,
                                                                 MatchType const matchType) const {
 
    if (matchType == JsonMeasureableUnitsMapping::MatchType::CaseSensitive) {
-      return this->nameToUnit.find(unitName)->second;
+      auto const match = this->nameToUnit.find(unitName);
+      return match == this->nameToUnit.end() ? nullptr : match->second;
    }
 
    Q_ASSERT(matchType == JsonMeasureableUnitsMapping::MatchType::CaseInsensitive);
 
-   //
-   // See comment above in containsUnit() about efficiency.
-   //
-   for (auto ii = this->nameToUnit.cbegin(); ii != this->nameToUnit.cend(); ++ii) {
-      if (boost::iequals(ii->first, unitName)) {
-         return ii->second;
-      }
-   }
-   return nullptr;
+   auto const match = this->foldedNameToUnit.find(foldCase(unitName));
+   return match == this->foldedNameToUnit.end() ? nullptr : match->second;
 }
 
 Measurement::Unit const * JsonMeasureableUnitsMapping::defaultUnit() const {
@@ -18,7 +18,9 @@
 #pragma once
 
 #include <map>
+#include <string>
 #include <string_view>
+#include <unordered_map>
 
 #include "serialization/json/JsonXPath.h"
 #include "measurement/Unit.h"
@@ -47,6 +49,20 @@ private:
    // Boost.JSON.  We use std::map rather than QMap because it's easier to search both sides of the map (ie search by
    // value as well as search by key).
    std::map<std::string_view, Measurement::Unit const *> nameToUnit;
+
+   //
+   // Every measurable value we read from or write to BeerJSON needs a unit look-up, so, rather than search nameToUnit
+   // (and, for case-insensitive matching, compare against every entry), the constructor also builds the following hash
+   // maps.  When two names differ only in case, or two names map to the same unit, the first in nameToUnit wins, as it
+   // did when we searched nameToUnit in order.
+   //
+
+   //! Unit names, in (ASCII) lower case, to unit.  All BeerJSON unit names are ASCII.
+   std::unordered_map<std::string, Measurement::Unit const *> foldedNameToUnit;
+
+   //! Unit to name
+   std::unordered_map<Measurement::Unit const *, std::string_view> unitToName;
+
 public:
    JsonXPath const  unitField;
    JsonXPath const valueField;
@@ -78,7 +94,8 @@ public:
    bool containsUnit(std::string_view const unitName, MatchType const matchType) const;
 
    /**
-    * \brief Returns the unit for the supplied unit name
+    * \brief Returns the unit for the supplied unit name, or \c nullptr if there isn't one.  (So, if you need the unit,
+    *        there's no need to call \c containsUnit first.)
     * \param unitName
     * \param matchCase
     */
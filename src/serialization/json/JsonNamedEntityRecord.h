@@ -22,6 +22,7 @@
 #include <QList>
 
 #include "database/ObjectStoreWrapper.h"
+#include "Logging.h"
 #include "model/BrewNote.h"
 #include "model/Instruction.h"
 #include "model/Mash.h"
@@ -65,12 +66,31 @@ protected:
       return ObjectStoreWrapper::insert(std::static_pointer_cast<NE>(this->m_namedEntity));
    }
 
+   virtual bool canStoreInBatch() const {
+      return true;
+   }
+
+   virtual QVector<int> storeNamedEntitiesInDb(QList<SerializationRecord const *> const & records) const {
+      QList<std::shared_ptr<NE>> namedEntities;
+      for (SerializationRecord const * record : records) {
+         namedEntities.append(std::static_pointer_cast<NE>(record->getNamedEntity()));
+      }
+      return ObjectStoreWrapper::insertBatch(namedEntities);
+   }
+
 public:
    virtual void deleteNamedEntityFromDb() {
       ObjectStoreWrapper::hardDelete(*std::static_pointer_cast<NE>(this->m_namedEntity));
       return;
    }
 
+   virtual std::function<void()> namedEntityDeleter() const {
+      return [namedEntity = std::static_pointer_cast<NE>(this->m_namedEntity)]() {
+         ObjectStoreWrapper::hardDelete(*namedEntity);
+         return;
+      };
+   }
+
 protected:
    //
    // TODO It's a bit clunky to have the knowledge/logic in this class for whether duplicates and name clashes are
@@ -91,9 +111,15 @@ protected:
       // It's a coding error if we are searching for a duplicate of a null object
       Q_ASSERT(this->m_namedEntity);
 
-      // This copy of the pointer is just to make it clearer what we're passing to lambda in findFirstMatching() below
+      // This copy of the pointer is just to make it clearer what we're passing to lambda in
+      // findFirstMatchingFingerprint() below
       std::shared_ptr<NE const> const currentEntity = std::static_pointer_cast<NE const>(this->m_namedEntity);
-      auto matchResult = ObjectStoreTyped<NE>::getInstance().findFirstMatching(
+      //
+      // Only objects with the same fingerprint can be equal to currentEntity, so we don't need to compare against
+      // anything else in the store.
+      //
+      auto matchResult = ObjectStoreTyped<NE>::getInstance().findFirstMatchingFingerprint(
+         currentEntity->fingerprint(),
          //
          // Note that, because we run this check both before and after something has been stored in the database (for
          // reasons explained in JsonRecord::normaliseAndStoreInDb) we need to be particularly careful NOT to match the
@@ -109,7 +135,7 @@ protected:
          }
       );
       if (matchResult) {
-         qDebug() <<
+         qCDebug(Logging::serialization) <<
             Q_FUNC_INFO << "Found a match (#" << matchResult->key() << "," << matchResult->name() <<
             ") for #" << this->m_namedEntity->key() << ", " << this->m_namedEntity->name();
          // Set our Hop/Yeast/Fermentable/etc to the one we found already stored in the database, so that any
@@ -118,7 +144,22 @@ protected:
          this->m_namedEntity = matchResult;
          return true;
       }
-      qDebug() << Q_FUNC_INFO << "No match found for "<< this->m_namedEntity->name();
+      //
+      // If we're being stored in a batch, the records before us in the batch aren't in the store yet, so we have to
+      // check them separately.
+      //
+      if (this->m_completeEarlierInBatch) {
+         for (auto const & earlier : *this->m_completeEarlierInBatch) {
+            if (earlier->fingerprint() == currentEntity->fingerprint() && *earlier == *currentEntity) {
+               qCDebug(Logging::serialization) <<
+                  Q_FUNC_INFO << "Found a match (" << earlier->name() << ") earlier in the same batch for" <<
+                  this->m_namedEntity->name();
+               this->m_namedEntity = earlier;
+               return true;
+            }
+         }
+      }
+      qCDebug(Logging::serialization) << Q_FUNC_INFO << "No match found for "<< this->m_namedEntity->name();
       return false;
    }
 
@@ -126,36 +167,32 @@ protected:
     * \brief Implementation for general case where name is supposed to be unique.  Before storing, we try to ensure
     *        that what we load in does not create duplicate names.  Eg, if we already have a Recipe called "Oatmeal
     *        Stout" and then read in a (different) recipe with the same name, then we will change the name of the
-    *        newly read-in one to "Oatmeal Stout (1)" (or "Oatmeal Stout (2)" if "Oatmeal Stout (1)" is taken, and so
-    *        on).  For those NamedEntity subclasses where we don't care about duplicate names (eg MashStep records),
-    *        there is a no-op specialisation of this function.
+    *        newly read-in one to "Oatmeal Stout (1)" (or "Oatmeal Stout (n+1)" if "Oatmeal Stout (n)" is taken, for
+    *        the highest such n).  For those NamedEntity subclasses where we don't care about duplicate names (eg
+    *        MashStep records), there is a no-op specialisation of this function.
     *
     *        See below for trivial specialisations of this function for classes where names are not unique.
     */
    virtual void normaliseName() {
-      QString currentName = this->m_namedEntity->name();
-
-      while (
-         //
-         // At the moment, we're pretty strict here and count a name clash even for things that are soft deleted.  If
-         // we wanted to allow clashes with such soft-deleted things then we could add a check against ne->deleted()
-         // as in the isDuplicate() function.
-         //
-         auto matchResult = ObjectStoreTyped<NE>::getInstance().findFirstMatching(
-            [currentName](std::shared_ptr<NE> ne) {return ne->name() == currentName;}
-         )
-      ) {
-         qDebug() << Q_FUNC_INFO << "Found existing " << this->m_recordDefinition.m_namedEntityClassName << "named" << currentName;
-
-         JsonRecord::modifyClashingName(currentName);
-
-         //
-         // Now the for loop will search again with the new name
-         //
-         qDebug() << Q_FUNC_INFO << "Trying " << currentName;
+      QString const currentName = this->m_namedEntity->name();
+
+      //
+      // At the moment, we're pretty strict here and count a name clash even for things that are soft deleted.  (The
+      // object store's name index includes them.)
+      //
+      QString uniqueName = ObjectStoreTyped<NE>::getInstance().uniqueName(currentName);
+      // Names of records earlier in the same batch aren't in the store's name index yet
+      while (this->earlierInBatchHasName(uniqueName)) {
+         SerializationRecord::modifyClashingName(uniqueName);
+         uniqueName = ObjectStoreTyped<NE>::getInstance().uniqueName(uniqueName);
+      }
+      if (uniqueName != currentName) {
+         qCDebug(Logging::serialization) <<
+            Q_FUNC_INFO << "Found existing" << this->m_recordDefinition.m_namedEntityClassName << "named" <<
+            currentName << "so using" << uniqueName;
       }
 
-      this->m_namedEntity->setName(currentName);
+      this->m_namedEntity->setName(uniqueName);
 
       return;
    }
@@ -188,7 +225,7 @@ template<> inline void JsonNamedEntityRecord<BrewNote>::normaliseName() { return
 
 // Specialisations for cases where object is owned by its containing entity
 template<> inline void JsonNamedEntityRecord<BrewNote>::setContainingEntity(std::shared_ptr<NamedEntity> containingEntity) {
-   qDebug() <<
+   qCDebug(Logging::serialization) <<
       Q_FUNC_INFO << "BrewNote * " << static_cast<void*>(this->m_namedEntity.get()) << ", Recipe * " <<
       static_cast<void*>(containingEntity.get());
    auto brewNote = std::static_pointer_cast<BrewNote>(this->m_namedEntity);
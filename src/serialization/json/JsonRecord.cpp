@@ -15,6 +15,7 @@
  ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
 #include "serialization/json/JsonRecord.h"
 
+#include <algorithm>
 #include <optional>
 #include <string_view>
 #include <system_error>
@@ -23,6 +24,7 @@
 #include <QDebug>
 #include <QMetaType>
 
+#include "Logging.h"
 #include "serialization/json/JsonCoding.h"
 #include "serialization/json/JsonUtils.h"
 #include "model/Hop.h"  // Only needed for workaround/hack for Hop year property
@@ -32,6 +34,8 @@
 #include "utils/ErrorCodeToStream.h"
 #include "utils/ImportRecordCount.h"
 #include "utils/OptionalHelpers.h"
+#include "utils/StringPool.h"
+#include "utils/Tracing.h"
 
 //
 // Variables and constant definitions that we need only in this file
@@ -79,7 +83,8 @@ namespace {
       boost::json::value const * valueRaw = valueField.followPathFrom(recordData, errCode);
       if (!valueRaw) {
          // Not expecting this to happen given that we've already validated the JSON file against its schema.
-         qWarning() << Q_FUNC_INFO << "Error parsing value from" << xPath << " (" << type << "): " << errCode;
+         qCWarning(Logging::serialization) <<
+            Q_FUNC_INFO << "Error parsing value from" << xPath << " (" << type << "): " << errCode;
          return false;
       }
       // Usually leave next line commented as otherwise generates too much logging
@@ -94,7 +99,7 @@ namespace {
          // Not expecting this to happen as doco says "If T is a floating point type and the stored value is a number,
          // the conversion is performed without error. The converted number is returned, with a possible loss of
          // precision. "
-         qWarning() <<
+         qCWarning(Logging::serialization) <<
             Q_FUNC_INFO << "Error extracting double from" << *valueRaw << "(" << valueRaw->kind() << ") for" <<
             xPath << " (" << type << "): " << errCode;
          return false;
@@ -105,7 +110,8 @@ namespace {
       boost::json::value const * unitNameRaw = unitField.followPathFrom(recordData, errCode);
       if (!unitNameRaw) {
          // Not expecting this to happen given that we've already validated the JSON file against its schema.
-         qWarning() << Q_FUNC_INFO << "Error parsing units from" << xPath << " (" << type << "): " << errCode;
+         qCWarning(Logging::serialization) <<
+            Q_FUNC_INFO << "Error parsing units from" << xPath << " (" << type << "): " << errCode;
          return false;
       }
       Q_ASSERT(unitNameRaw);
@@ -157,18 +163,18 @@ namespace {
       // if the case is "wrong" because there are no enums where members differ only by case.
       //
       auto mapper = std::get<JsonMeasureableUnitsMapping const *>(fieldDefinition.valueDecoder);
-      if (!mapper->containsUnit(unitName, JsonMeasureableUnitsMapping::MatchType::CaseInsensitive)) {
-         qCritical() << Q_FUNC_INFO << "Unexpected unit name:" << std::string(unitName).c_str();
+      Measurement::Unit const * unit = mapper->findUnit(unitName,
+                                                        JsonMeasureableUnitsMapping::MatchType::CaseInsensitive);
+      if (!unit) {
+         qCCritical(Logging::serialization) << Q_FUNC_INFO << "Unexpected unit name:" << std::string(unitName).c_str();
          // Stop here on debug build
          Q_ASSERT(false);
          return std::nullopt;
       }
 
-      Measurement::Unit const * unit = mapper->findUnit(unitName,
-                                                        JsonMeasureableUnitsMapping::MatchType::CaseInsensitive);
       Measurement::Amount canonicalValue = unit->toCanonical(value);
 
-      qDebug() <<
+      qCDebug(Logging::serialization) <<
          Q_FUNC_INFO << "Converted" << value << " " << std::string(unitName).c_str() << "to" << canonicalValue;
 
       return canonicalValue;
@@ -220,8 +226,8 @@ namespace {
       for (auto const unitsMapping :
            *std::get<ListOfJsonMeasureableUnitsMappings const *>(fieldDefinition.valueDecoder)) {
          // As above, we need to be case insensitive here and this should not create ambiguity
-         if (unitsMapping->containsUnit(unitName, JsonMeasureableUnitsMapping::MatchType::CaseInsensitive)) {
-            unit = unitsMapping->findUnit(unitName, JsonMeasureableUnitsMapping::MatchType::CaseInsensitive);
+         unit = unitsMapping->findUnit(unitName, JsonMeasureableUnitsMapping::MatchType::CaseInsensitive);
+         if (unit) {
             break;
          }
       }
@@ -229,7 +235,7 @@ namespace {
       // The schema validation should have ensured that the unit name is constrained to one of the values we are
       // expecting, so it's almost certainly a coding error if it doesn't.
       if (!unit) {
-         qCritical() <<
+         qCCritical(Logging::serialization) <<
             Q_FUNC_INFO << "Unexpected unit name:" << std::string(unitName).c_str() << "for field" <<
             fieldDefinition.xPath << "(" << fieldDefinition.type << ")";
          // Stop here on debug build
@@ -239,7 +245,7 @@ namespace {
 
       Measurement::Amount canonicalValue = unit->toCanonical(value);
 
-      qDebug() <<
+      qCDebug(Logging::serialization) <<
          Q_FUNC_INFO << "Converted" << value << " " << std::string(unitName).c_str() << "to" << canonicalValue;
 
       return canonicalValue;
@@ -275,7 +281,7 @@ namespace {
       // The schema validation should have ensured that the unit name is what we're expecting, so it's almost certainly
       // a coding error if it doesn't.
       if (!std::get<JsonSingleUnitSpecifier const *>(fieldDefinition.valueDecoder)->validUnits.contains(unitName)) {
-         qCritical() <<
+         qCCritical(Logging::serialization) <<
             Q_FUNC_INFO << "Unit name" << std::string(unitName).c_str() << "does not match expected (" <<
             std::get<JsonSingleUnitSpecifier const *>(fieldDefinition.valueDecoder)->validUnits.first().data() <<
             "etc)";
@@ -302,8 +308,9 @@ JsonRecord::JsonRecord(JsonCoding const & jsonCoding,
 JsonRecord::~JsonRecord() = default;
 
 [[nodiscard]] bool JsonRecord::load(QTextStream & userMessage) {
+   Tracing::Span span{"JsonRecord::load"};
    Q_ASSERT(this->m_recordData.is_object());
-   qDebug() <<
+   qCDebug(Logging::serialization) <<
       Q_FUNC_INFO << "Loading" << this->m_recordDefinition.m_recordName << "record containing" <<
       this->m_recordData.as_object().size() << "elements";
 
@@ -323,7 +330,7 @@ JsonRecord::~JsonRecord() = default;
    // Note that it's a coding error if there are no fields in the record definition.  (This usually means a template
    // specialisation was omitted in serialization/json/BeerJson.cpp.)
    //
-   qDebug() <<
+   qCDebug(Logging::serialization) <<
       Q_FUNC_INFO << "Examining" << this->m_recordDefinition.fieldDefinitions.size() << "field definitions for" <<
       this->m_recordDefinition.m_recordName;
    Q_ASSERT(this->m_recordDefinition.fieldDefinitions.size() > 0);
@@ -360,7 +367,7 @@ JsonRecord::~JsonRecord() = default;
          //
          if (fieldDefinition.propertyPath.isNull() &&
              std::holds_alternative<std::monostate>(fieldDefinition.valueDecoder)) {
-            qInfo() <<
+            qCInfo(Logging::serialization) <<
                Q_FUNC_INFO << "Ignoring unsupported field at" << fieldDefinition.xPath << " (" <<
                fieldDefinition.type << "/" << container->kind() << ")";
             continue;
@@ -488,7 +495,7 @@ JsonRecord::~JsonRecord() = default;
                case JsonRecordDefinition::FieldType::String:
                   Q_ASSERT(container->is_string());
                   {
-                     QString rawValue{container->get_string().c_str()};
+                     QString rawValue{StringPool::intern(QString{container->get_string().c_str()})};
                      parsedValue = Optional::variantFromRaw(rawValue, propertyIsOptional);
                      parsedValueOk = true;
                   }
@@ -507,7 +514,7 @@ JsonRecord::~JsonRecord() = default;
                      if (!match) {
                         // This is probably a coding error as the JSON Schema should already have verified that the
                         // value is one of the expected ones.
-                        qWarning() <<
+                        qCWarning(Logging::serialization) <<
                            Q_FUNC_INFO << "Ignoring " << this->m_recordDefinition.m_namedEntityClassName << " node " <<
                            fieldDefinition.xPath << "=" << value << " as value not recognised";
                      } else {
@@ -575,7 +582,7 @@ JsonRecord::~JsonRecord() = default;
                   Q_ASSERT(container->is_object());
                   {
                      std::optional<double> value = readSingleUnitValue(fieldDefinition, container);
-                     qDebug() <<
+                     qCDebug(Logging::serialization) <<
                         Q_FUNC_INFO << "Read:" << value << "for" << fieldDefinition.xPath << "/" <<
                         fieldDefinition.propertyPath;
                      if (value) {
@@ -607,7 +614,7 @@ JsonRecord::~JsonRecord() = default;
                         // The JSON schema validation doesn't guarantee the date is valid, just that it's the right
                         // digit groupings.  So, we do need to handle cases such as 2022-13-13 which are the right
                         // format but not valid dates.
-                        qWarning() <<
+                        qCWarning(Logging::serialization) <<
                            Q_FUNC_INFO << "Ignoring " << this->m_recordDefinition.m_namedEntityClassName << " node " <<
                            fieldDefinition.xPath << "=" << value << " as could not be parsed as ISO 8601 date";
                      }
@@ -624,7 +631,7 @@ JsonRecord::~JsonRecord() = default;
                   // out), we can't carry on to normal processing below.  So jump straight to processing the next
                   // node in the loop (via continue).
                   //
-                  qDebug() <<
+                  qCDebug(Logging::serialization) <<
                      Q_FUNC_INFO << "Skipping " << this->m_recordDefinition.m_namedEntityClassName << " node " <<
                      fieldDefinition.xPath << "=" << *container << "(" << fieldDefinition.propertyPath.asXPath() <<
                      ") as not useful";
@@ -675,38 +682,13 @@ JsonRecord::~JsonRecord() = default;
    QTextStream & userMessage,
    ImportRecordCount & stats
 ) {
-   qDebug() << Q_FUNC_INFO;
+   qCDebug(Logging::serialization) << Q_FUNC_INFO;
    if (nullptr != this->m_namedEntity) {
-      qDebug() <<
-         Q_FUNC_INFO << "Normalise and store " << this->m_recordDefinition.m_namedEntityClassName << "(" <<
-         this->m_namedEntity->metaObject()->className() << "):" << this->m_namedEntity->name();
-
-      //
-      // If the object we are reading in is a duplicate of something we already have (and duplicates are not allowed)
-      // then skip over this record (and any records it contains).  (This is _not_ an error, so we return true not
-      // false in this event.)
-      //
-      // Note, however, that some objects -- in particular those such as Recipe that contain other objects -- need
-      // to be further along in their construction (ie have had all their contained objects added) before we can
-      // determine whether they are duplicates.  This is why we check again, after storing in the DB, below.
-      //
-      if (this->isDuplicate()) {
-         qDebug() <<
-            Q_FUNC_INFO << "(Early found) duplicate" << this->m_recordDefinition.m_namedEntityClassName <<
-            (this->m_includeInStats ? " will" : " won't") << " be included in stats";
-         if (this->m_includeInStats) {
-            stats.skipped(*this->m_recordDefinition.m_namedEntityClassName);
-         }
-         return JsonRecord::ProcessingResult::FoundDuplicate;
+      JsonRecord::ProcessingResult const preparationResult = this->prepareToStoreInDb(containingEntity, stats);
+      if (JsonRecord::ProcessingResult::Succeeded != preparationResult) {
+         return preparationResult;
       }
 
-      this->normaliseName();
-
-      // Some classes of object are owned by their containing entity and can't sensibly be saved without knowing what it
-      // is.  Subclasses of JsonRecord will override setContainingEntity() to pass the info in if it is needed (or ignore
-      // it if not).
-      this->setContainingEntity(containingEntity);
-
       // Now we're ready to store in the DB
       int id = this->storeNamedEntityInDb();
       if (id <= 0) {
@@ -716,6 +698,49 @@ JsonRecord::~JsonRecord() = default;
       }
    }
 
+   return this->finishStoringInDb(userMessage, stats);
+}
+
+JsonRecord::ProcessingResult JsonRecord::prepareToStoreInDb(std::shared_ptr<NamedEntity> containingEntity,
+                                                            ImportRecordCount & stats) {
+   // It's a coding error to call this for the root record
+   Q_ASSERT(this->m_namedEntity);
+
+   qCDebug(Logging::serialization) <<
+      Q_FUNC_INFO << "Normalise and store " << this->m_recordDefinition.m_namedEntityClassName << "(" <<
+      this->m_namedEntity->metaObject()->className() << "):" << this->m_namedEntity->name();
+
+   //
+   // If the object we are reading in is a duplicate of something we already have (and duplicates are not allowed)
+   // then skip over this record (and any records it contains).  (This is _not_ an error, so we return true not
+   // false in this event.)
+   //
+   // Note, however, that some objects -- in particular those such as Recipe that contain other objects -- need
+   // to be further along in their construction (ie have had all their contained objects added) before we can
+   // determine whether they are duplicates.  This is why we check again, after storing in the DB, in
+   // finishStoringInDb().
+   //
+   if (this->timedIsDuplicate()) {
+      qCDebug(Logging::serialization) <<
+         Q_FUNC_INFO << "(Early found) duplicate" << this->m_recordDefinition.m_namedEntityClassName <<
+         (this->m_includeInStats ? " will" : " won't") << " be included in stats";
+      if (this->m_includeInStats) {
+         stats.skipped(*this->m_recordDefinition.m_namedEntityClassName);
+      }
+      return JsonRecord::ProcessingResult::FoundDuplicate;
+   }
+
+   this->normaliseName();
+
+   // Some classes of object are owned by their containing entity and can't sensibly be saved without knowing what it
+   // is.  Subclasses of JsonRecord will override setContainingEntity() to pass the info in if it is needed (or ignore
+   // it if not).
+   this->setContainingEntity(containingEntity);
+
+   return JsonRecord::ProcessingResult::Succeeded;
+}
+
+JsonRecord::ProcessingResult JsonRecord::finishStoringInDb(QTextStream & userMessage, ImportRecordCount & stats) {
    JsonRecord::ProcessingResult processingResult;
 
    //
@@ -735,7 +760,7 @@ JsonRecord::~JsonRecord() = default;
          // required
          return JsonRecord::ProcessingResult::Succeeded;
       }
-      processingResult = this->isDuplicate() ? JsonRecord::ProcessingResult::FoundDuplicate :
+      processingResult = this->timedIsDuplicate() ? JsonRecord::ProcessingResult::FoundDuplicate :
                                                JsonRecord::ProcessingResult::Succeeded;
    } else {
       // There was a problem with one of our child records
@@ -747,7 +772,7 @@ JsonRecord::~JsonRecord() = default;
       // We potentially do stats for everything except failure
       //
       if (JsonRecord::ProcessingResult::FoundDuplicate == processingResult) {
-         qDebug() <<
+         qCDebug(Logging::serialization) <<
             Q_FUNC_INFO << "(Late found) duplicate" << this->m_recordDefinition.m_namedEntityClassName << "(" <<
             this->m_recordDefinition.m_localisedEntityName << ")" << (this->m_includeInStats ? " will" : " won't") <<
             " be included in stats";
@@ -772,7 +797,7 @@ JsonRecord::~JsonRecord() = default;
          // and 2 MashSteps before hitting an error on the 3rd MashStep, then deleting the Mash from the DB will also
          // result in those 2 stored MashSteps getting deleted from the DB.)
          //
-         qDebug() <<
+         qCDebug(Logging::serialization) <<
             Q_FUNC_INFO << "Deleting stored" << this->m_recordDefinition.m_namedEntityClassName << "as" <<
             (JsonRecord::ProcessingResult::FoundDuplicate == processingResult ? "duplicate" : "failed to read all child records");
          this->deleteNamedEntityFromDb();
@@ -793,9 +818,100 @@ JsonRecord::~JsonRecord() = default;
    return processingResult;
 }
 
+bool JsonRecord::normaliseAndStoreChildRecordBatchInDb(std::vector< std::unique_ptr<JsonRecord> > & childRecords,
+                                                       QList<std::shared_ptr<NamedEntity>> & processedChildren,
+                                                       QTextStream & userMessage,
+                                                       ImportRecordCount & stats) {
+   qCDebug(Logging::serialization) <<
+      Q_FUNC_INFO << "Storing" << childRecords.size() <<
+      childRecords.front()->m_recordDefinition.m_namedEntityClassName << "children of" <<
+      this->m_recordDefinition.m_namedEntityClassName;
+
+   //
+   // First we do the duplicate checks and name normalisation for all the records, in order.  The records before the
+   // current one in the batch aren't in the object store yet, so isDuplicate() and normaliseName() need to be told
+   // about them.
+   //
+   QList<std::shared_ptr<NamedEntity>> namedEntitiesToStore;
+   QList<std::shared_ptr<NamedEntity>> completeNamedEntitiesToStore;
+   QList<SerializationRecord const *> recordsToStore;
+   std::vector<JsonRecord::ProcessingResult> preparationResults;
+   preparationResults.reserve(childRecords.size());
+   for (auto & childRecord : childRecords) {
+      if (stats.isCancelled()) {
+         return false;
+      }
+      childRecord->m_earlierInBatch         = &namedEntitiesToStore;
+      childRecord->m_completeEarlierInBatch = &completeNamedEntitiesToStore;
+      preparationResults.push_back(childRecord->prepareToStoreInDb(this->m_namedEntity, stats));
+      childRecord->m_earlierInBatch         = nullptr;
+      childRecord->m_completeEarlierInBatch = nullptr;
+      if (JsonRecord::ProcessingResult::Succeeded == preparationResults.back()) {
+         namedEntitiesToStore.append(childRecord->m_namedEntity);
+         recordsToStore.append(childRecord.get());
+         bool const hasChildRecords = std::any_of(
+            childRecord->m_childRecordSets.cbegin(),
+            childRecord->m_childRecordSets.cend(),
+            [](auto const & grandchildRecordSet) { return !grandchildRecordSet.records.empty(); }
+         );
+         if (!hasChildRecords) {
+            completeNamedEntitiesToStore.append(childRecord->m_namedEntity);
+         }
+      }
+   }
+
+   //
+   // Then we store all the ones that aren't duplicates in one go.  insertMany keeps them in order, so, eg, the IDs of
+   // mash steps are in the same order as the steps themselves.
+   //
+   if (!recordsToStore.isEmpty()) {
+      QVector<int> const ids = childRecords.front()->storeNamedEntitiesInDb(recordsToStore);
+      if (ids.size() != recordsToStore.size()) {
+         userMessage << "Error storing " << namedEntitiesToStore.first()->metaObject()->className() <<
+         " records in database.  See logs for more details";
+         return false;
+      }
+   }
+
+   //
+   // Finally we do the rest of the processing for each record in turn.  If we have to bail out part way through, the
+   // records we stored above but haven't yet got to would not otherwise get cleaned up.
+   //
+   auto const deleteStoredFrom = [&childRecords, &preparationResults](std::size_t const first) {
+      for (std::size_t jj = first; jj < childRecords.size(); ++jj) {
+         if (JsonRecord::ProcessingResult::Succeeded == preparationResults[jj]) {
+            childRecords[jj]->deleteNamedEntityFromDb();
+         }
+      }
+      return;
+   };
+   for (std::size_t ii = 0; ii < childRecords.size(); ++ii) {
+      auto & childRecord = childRecords[ii];
+      JsonRecord::ProcessingResult result = preparationResults[ii];
+      if (JsonRecord::ProcessingResult::Succeeded == result) {
+         if (stats.isCancelled()) {
+            deleteStoredFrom(ii);
+            return false;
+         }
+         result = childRecord->finishStoringInDb(userMessage, stats);
+         if (JsonRecord::ProcessingResult::Failed == result) {
+            deleteStoredFrom(ii + 1);
+            return false;
+         }
+      }
+      if (!this->m_namedEntity && JsonRecord::ProcessingResult::Succeeded == result) {
+         // We're the root record, so the child is a top-level record
+         stats.storedTopLevel(childRecord->namedEntityDeleter());
+      }
+      processedChildren.append(childRecord->m_namedEntity);
+   }
+
+   return true;
+}
+
 [[nodiscard]] bool JsonRecord::normaliseAndStoreChildRecordsInDb(QTextStream & userMessage,
                                                                  ImportRecordCount & stats) {
-   qDebug() << Q_FUNC_INFO << this->m_childRecordSets.size() << "child record sets";
+   qCDebug(Logging::serialization) << Q_FUNC_INFO << this->m_childRecordSets.size() << "child record sets";
    //
    // We are assuming it does not matter which order different types of children are processed in.
    //
@@ -805,25 +921,46 @@ JsonRecord::~JsonRecord() = default;
    //
    for (auto & childRecordSet : this->m_childRecordSets) {
       if (childRecordSet.parentFieldDefinition) {
-         qDebug() <<
+         qCDebug(Logging::serialization) <<
             Q_FUNC_INFO << childRecordSet.parentFieldDefinition->propertyPath << "has" <<
             childRecordSet.records.size() << "entries";
       } else {
-         qDebug() << Q_FUNC_INFO << "Top-level record has" << childRecordSet.records.size() << "entries";
+         qCDebug(Logging::serialization) <<
+            Q_FUNC_INFO << "Top-level record has" << childRecordSet.records.size() << "entries";
       }
 
       QList<std::shared_ptr<NamedEntity>> processedChildren;
-      for (auto & childRecord : childRecordSet.records) {
-         // The childRecord variable is a reference to a std::unique_ptr (because the vector we're looping over owns the
-         // records it contains), which is why we have all the "member of pointer" (->) operators below.
-         qDebug() <<
-            Q_FUNC_INFO << "Storing" << childRecord->m_recordDefinition.m_namedEntityClassName << "child of" <<
-            this->m_recordDefinition.m_namedEntityClassName;
-         if (JsonRecord::ProcessingResult::Failed ==
-            childRecord->normaliseAndStoreInDb(this->m_namedEntity, userMessage, stats)) {
+      if (childRecordSet.records.size() > 1 && childRecordSet.records.front()->canStoreInBatch()) {
+         // Eg all the hop additions in a recipe, or all the steps in a mash
+         if (!this->normaliseAndStoreChildRecordBatchInDb(childRecordSet.records,
+                                                          processedChildren,
+                                                          userMessage,
+                                                          stats)) {
             return false;
          }
-         processedChildren.append(childRecord->m_namedEntity);
+      } else {
+         for (auto & childRecord : childRecordSet.records) {
+            // The childRecord variable is a reference to a std::unique_ptr (because the vector we're looping over owns
+            // the records it contains), which is why we have all the "member of pointer" (->) operators below.
+            qCDebug(Logging::serialization) <<
+               Q_FUNC_INFO << "Storing" << childRecord->m_recordDefinition.m_namedEntityClassName << "child of" <<
+               this->m_recordDefinition.m_namedEntityClassName;
+            // If the user has cancelled the import, returning failure here means partially stored records get cleaned
+            // up in the same way as for any other problem
+            if (stats.isCancelled()) {
+               return false;
+            }
+            JsonRecord::ProcessingResult const result =
+               childRecord->normaliseAndStoreInDb(this->m_namedEntity, userMessage, stats);
+            if (JsonRecord::ProcessingResult::Failed == result) {
+               return false;
+            }
+            if (!this->m_namedEntity && JsonRecord::ProcessingResult::Succeeded == result) {
+               // We're the root record, so the child is a top-level record
+               stats.storedTopLevel(childRecord->namedEntityDeleter());
+            }
+            processedChildren.append(childRecord->m_namedEntity);
+         }
       }
 
       //
@@ -858,7 +995,7 @@ JsonRecord::~JsonRecord() = default;
             if (fieldDefinition.type != JsonRecordDefinition::FieldType::ListOfRecords) {
                // It's a coding error if we ended up with more than on child when there's only supposed to be one!
                if (processedChildren.size() > 1) {
-                  qCritical() <<
+                  qCCritical(Logging::serialization) <<
                      Q_FUNC_INFO << "Only expecting one record for" << propertyPath << "property on" <<
                      this->m_recordDefinition.m_namedEntityClassName << "object, but found" << processedChildren.size();
                   Q_ASSERT(false);
@@ -907,7 +1044,7 @@ JsonRecord::~JsonRecord() = default;
             }
 
             if (!propertyPath.setValue(*this->m_namedEntity, valueToSet)) {
-               qCritical() <<
+               qCCritical(Logging::serialization) <<
                   Q_FUNC_INFO << "Could not write" << propertyPath << "property on" <<
                   this->m_recordDefinition.m_namedEntityClassName;
                   Q_ASSERT(false);
@@ -923,7 +1060,7 @@ JsonRecord::~JsonRecord() = default;
                                                JsonRecordDefinition const & childRecordDefinition,
                                                boost::json::value & childRecordData,
                                                QTextStream & userMessage) {
-   qDebug() << Q_FUNC_INFO;
+   qCDebug(Logging::serialization) << Q_FUNC_INFO;
    // TODO: We could move these 3 lines to the caller to save duplication with loadChildRecords
    auto constructorWrapper = childRecordDefinition.jsonRecordConstructorWrapper;
    this->m_childRecordSets.push_back(JsonRecord::ChildRecordSet{&parentFieldDefinition, {}});
@@ -945,7 +1082,7 @@ JsonRecord::~JsonRecord() = default;
                                                 JsonRecordDefinition const & childRecordDefinition,
                                                 boost::json::array & childRecordsData,
                                                 QTextStream & userMessage) {
-   qDebug() << Q_FUNC_INFO;
+   qCDebug(Logging::serialization) << Q_FUNC_INFO;
    //
    // This is where we have a list of one or more substantive records of a particular type, which may be either at top
    // level (eg hop_varieties) or inside another record that we are in the process of reading (eg hop_additions inside a
@@ -983,7 +1120,7 @@ void JsonRecord::insertValue(JsonRecordDefinition::FieldDefinition const & field
                              boost::json::object & recordDataAsObject,
                              std::string_view const & key,
                              QVariant & value) {
-   qDebug() <<
+   qCDebug(Logging::serialization) <<
       Q_FUNC_INFO << "Writing" << std::string(key).c_str() << "=" << value << "(type" << fieldDefinition.type <<
       ") for xPath" << fieldDefinition.xPath << ", path" << fieldDefinition.propertyPath;
 
@@ -1083,11 +1220,11 @@ void JsonRecord::insertValue(JsonRecordDefinition::FieldDefinition const & field
             Q_ASSERT(unitsMapping);
             Measurement::Unit const * const aUnit = unitsMapping->defaultUnit();
             Measurement::Unit const & canonicalUnit = aUnit->getCanonical();
-            qDebug() << Q_FUNC_INFO << canonicalUnit;
+            qCDebug(Logging::serialization) << Q_FUNC_INFO << canonicalUnit;
 
             // Now we found canonical units, we need to find the right string to represent them
             auto unitName = unitsMapping->getNameForUnit(canonicalUnit);
-            qDebug() << Q_FUNC_INFO << std::string(unitName).c_str();
+            qCDebug(Logging::serialization) << Q_FUNC_INFO << std::string(unitName).c_str();
             recordDataAsObject[key].emplace_object();
             auto & measurementWithUnits = recordDataAsObject[key].as_object();
             measurementWithUnits.emplace(unitsMapping->unitField.asKey(),  unitName);
@@ -1120,7 +1257,7 @@ void JsonRecord::insertValue(JsonRecordDefinition::FieldDefinition const & field
                if (unitsMapping->getPhysicalQuantity() == amount.unit->getPhysicalQuantity()) {
                   // Now we have the right PhysicalQuantity, we just need the entry for our Units
                   auto unitName = unitsMapping->getNameForUnit(*amount.unit);
-                  qDebug() << Q_FUNC_INFO << std::string(unitName).c_str();
+                  qCDebug(Logging::serialization) << Q_FUNC_INFO << std::string(unitName).c_str();
                   recordDataAsObject[key].emplace_object();
                   auto & measurementWithUnits = recordDataAsObject[key].as_object();
                   measurementWithUnits.emplace(unitsMapping->unitField.asKey(),  unitName);
@@ -1205,7 +1342,7 @@ bool JsonRecord::listToJson(QList< std::shared_ptr<NamedEntity> > const & object
 
 bool JsonRecord::toJson(NamedEntity const & namedEntityToExport) {
    Q_ASSERT(this->m_recordData.is_object());
-   qDebug() <<
+   qCDebug(Logging::serialization) <<
       Q_FUNC_INFO << "Exporting JSON for" << namedEntityToExport.metaObject()->className() << "#" <<
       namedEntityToExport.key();
 
@@ -1217,13 +1354,13 @@ bool JsonRecord::toJson(NamedEntity const & namedEntityToExport) {
    // Note that it's a coding error if there are no fields in the record definition.  (This usually means a template
    // specialisation was omitted in serialization/json/BeerJson.cpp.)
    //
-   qDebug() <<
+   qCDebug(Logging::serialization) <<
       Q_FUNC_INFO << "Examining" << this->m_recordDefinition.fieldDefinitions.size() << "field definitions for" <<
       this->m_recordDefinition.m_recordName;
    Q_ASSERT(this->m_recordDefinition.fieldDefinitions.size() > 0);
 
    for (auto & fieldDefinition : this->m_recordDefinition.fieldDefinitions) {
-      qDebug() << Q_FUNC_INFO <<
+      qCDebug(Logging::serialization) << Q_FUNC_INFO <<
          "fieldDefinition.xPath:" << fieldDefinition.xPath << ", fieldDefinition.propertyPath:" <<
          fieldDefinition.propertyPath;
       // If there isn't a property name that means this is not a field we support so there's nothing to write out.
@@ -1261,7 +1398,7 @@ bool JsonRecord::toJson(NamedEntity const & namedEntityToExport) {
          // It's a coding error if we're trying to give something other than a Record an empty XPath
          Q_ASSERT(JsonRecordDefinition::FieldType::Record == fieldDefinition.type);
 
-         qDebug() <<
+         qCDebug(Logging::serialization) <<
             Q_FUNC_INFO << "Empty XPath for property path" << fieldDefinition.propertyPath << "means put its fields in "
             "this record";
       }
@@ -1317,7 +1454,7 @@ bool JsonRecord::toJson(NamedEntity const & namedEntityToExport) {
             QVariant childNamedEntityVariant = fieldDefinition.propertyPath.getValue(namedEntityToExport);
 
             // Normally leave this log statement commented out to avoid cluttering the logs
-            qDebug() <<
+            qCDebug(Logging::serialization) <<
                Q_FUNC_INFO << "childNamedEntityVariant:" << childNamedEntityVariant << ", childRecordDefinition:" <<
                childRecordDefinition;
 
@@ -1352,7 +1489,8 @@ bool JsonRecord::toJson(NamedEntity const & namedEntityToExport) {
                      // In the general case, we would expect failure to occur if the key is already present.  Here, it's
                      // probably a coding error but, for now at least, we'll allow for the possibility that there was a
                      // run-time error.
-                     qCritical() << Q_FUNC_INFO << "Error inserting new JSON object at key" << key.c_str();
+                     qCCritical(Logging::serialization) <<
+                        Q_FUNC_INFO << "Error inserting new JSON object at key" << key.c_str();
                      return false;
                   }
 
@@ -1365,7 +1503,8 @@ bool JsonRecord::toJson(NamedEntity const & namedEntityToExport) {
                //
                // Otherwise (empty XPath), valuePointer is still pointing to the "current" object.
                //
-               qDebug() << Q_FUNC_INFO << "Creating JsonRecord for" << fieldDefinition.propertyPath;
+               qCDebug(Logging::serialization) <<
+                  Q_FUNC_INFO << "Creating JsonRecord for" << fieldDefinition.propertyPath;
                std::unique_ptr<JsonRecord> subRecord{
                   childRecordDefinition.makeRecord(this->m_coding, *valuePointer)
                };
@@ -1374,7 +1513,7 @@ bool JsonRecord::toJson(NamedEntity const & namedEntityToExport) {
                }
 
             } else {
-               qDebug() <<
+               qCDebug(Logging::serialization) <<
                   Q_FUNC_INFO << "No child NamedEntity for xPath" << fieldDefinition.xPath << "/ propertyPath:" <<
                   fieldDefinition.propertyPath;
             }
@@ -1389,11 +1528,12 @@ bool JsonRecord::toJson(NamedEntity const & namedEntityToExport) {
             // However, we have a pointer to the relevant instantiation of NamedEntity::downcastListFromVariant, which
             // will correctly convert the QVariant to QList<std::shared_ptr<NamedEntity>>.
             //
-            qDebug() << Q_FUNC_INFO << "value: " << value;
+            qCDebug(Logging::serialization) << Q_FUNC_INFO << "value: " << value;
             Q_ASSERT(childRecordDefinition.m_upAndDownCasters.m_listDowncaster);
             QList< std::shared_ptr<NamedEntity> > objectsToWrite =
                childRecordDefinition.m_upAndDownCasters.m_listDowncaster(value);
-            qDebug() << Q_FUNC_INFO << "value (" << value << ") gives" << objectsToWrite.size() << "objects";
+            qCDebug(Logging::serialization) <<
+               Q_FUNC_INFO << "value (" << value << ") gives" << objectsToWrite.size() << "objects";
 
             //
             // In theory we could add some logic here to decide whether to write the array out if it is of zero length.
@@ -133,6 +133,35 @@ protected:
    [[nodiscard]] bool normaliseAndStoreChildRecordsInDb(QTextStream & userMessage, ImportRecordCount & stats);
 
 private:
+   /**
+    * \brief The first part of \c normaliseAndStoreInDb: the early duplicate check, name normalisation and setting of
+    *        the containing entity, ie everything that needs doing before our \c NamedEntity is stored in the DB.
+    *
+    * \return \b Succeeded if the \c NamedEntity should now be stored, \b FoundDuplicate if it should be skipped
+    */
+   [[nodiscard]] ProcessingResult prepareToStoreInDb(std::shared_ptr<NamedEntity> containingEntity,
+                                                     ImportRecordCount & stats);
+
+   /**
+    * \brief The last part of \c normaliseAndStoreInDb, once our \c NamedEntity (if any) is stored in the DB: storing
+    *        our child records, the late duplicate check, stats and, if need be, clean-up.
+    */
+   [[nodiscard]] ProcessingResult finishStoringInDb(QTextStream & userMessage, ImportRecordCount & stats);
+
+   /**
+    * \brief Equivalent of calling \c normaliseAndStoreInDb on each of the supplied child records (which must all be of
+    *        the same type and have \c canStoreInBatch() \c true) in turn, except that the new objects are all stored
+    *        with one \c ObjectStore::insertMany call.
+    *
+    * \param processedChildren Where to append, in order, the stored objects (or the existing ones they duplicate)
+    *
+    * \return \b true if everything succeeded, \b false if there was an error
+    */
+   [[nodiscard]] bool normaliseAndStoreChildRecordBatchInDb(std::vector< std::unique_ptr<JsonRecord> > & childRecords,
+                                                            QList<std::shared_ptr<NamedEntity>> & processedChildren,
+                                                            QTextStream & userMessage,
+                                                            ImportRecordCount & stats);
+
    /**
     * \brief Add a value to a JSON object
     *
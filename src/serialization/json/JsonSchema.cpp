@@ -15,11 +15,14 @@
  ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
 #include "serialization/json/JsonSchema.h"
 
+#include <atomic>
 #include <map>
 #include <memory>
 
 #include <QDebug>
 #include <QMap>
+#include <QMutex>
+#include <QMutexLocker>
 #include <QString>
 
 #include <valijson/adapters/boost_json_adapter.hpp>
@@ -27,6 +30,7 @@
 #include <valijson/schema_parser.hpp>
 #include <valijson/validator.hpp>
 
+#include "Logging.h"
 #include "serialization/json/JsonUtils.h"
 #include "utils/BtStringStream.h"
 
@@ -60,6 +64,12 @@ namespace {
    // schemas.  (As noted elsewhere, we don't want the schemas to be constructed too early in program execution, hence
    // why we are not using static variables to hold them.)
    std::map<JsonSchema::Id, std::unique_ptr<JsonSchema const>> jsonSchemas;
+   // Guards jsonSchemas, as files can be validated on worker threads (see ImportExport::importFromFiles).  Once a
+   // schema has been constructed, it is only read from, so it is safe to use without the lock.
+   QMutex jsonSchemasMutex;
+
+   // Number of times we've parsed a schema (see JsonSchema::compilationCount)
+   std::atomic<int> schemaCompilations{0};
 
    //
    // A JSON schema can be spread across several files linked together via "$ref" statements in the JSON.  Valijson uses
@@ -83,7 +93,7 @@ namespace {
    void freeReferencedDocument([[maybe_unused]] boost::json::value const * document) {
       // There isn't anything for us to do, because we hang on to all the JSON schema documents until the program
       // terminates.
-      qDebug() << Q_FUNC_INFO;
+      qCDebug(Logging::serialization) << Q_FUNC_INFO;
       return;
    }
 
@@ -108,7 +118,7 @@ namespace {
          nodePath << " " << cc.c_str();
       }
 
-      qWarning() <<
+      qCWarning(Logging::serialization) <<
          Q_FUNC_INFO << "At node" << nodePath.asString() << "error was" << validationError.description.c_str();
       return QObject::tr("At node %1, error was %2").arg(nodePath.asString()).arg(validationError.description.c_str());
    }
@@ -158,14 +168,15 @@ public:
                                              this->jsonSchema,
                                              &JsonSchema::fetchReferencedDocument,
                                              &freeReferencedDocument);
-         qDebug() << Q_FUNC_INFO << "Schema populated";
+         ++schemaCompilations;
+         qCDebug(Logging::serialization) << Q_FUNC_INFO << "Schema populated";
 
       } catch (std::exception const & exception) {
          // Because we're only populating data from resources shipped with the program, we're not expecting exceptions,
          // either from our own code or either of the two libraries (Boost.JSON and Valijson), so, if we do get one,
          // it's likely a coding error.  Log something (in case we didn't already) and barf the exception up to wherever
          // the constructor was called from.
-         qCritical() << Q_FUNC_INFO << "Caught exception:" << exception.what();
+         qCCritical(Logging::serialization) << Q_FUNC_INFO << "Caught exception:" << exception.what();
          throw;
       }
 
@@ -194,7 +205,7 @@ public:
 #ifndef __clang__
       Q_ASSERT(this != nullptr);
 #endif
-      qDebug() << Q_FUNC_INFO << "Request for" << uri.c_str();
+      qCDebug(Logging::serialization) << Q_FUNC_INFO << "Request for" << uri.c_str();
       QString schemaFilePath = QString("%1/%2").arg(this->baseDir, uri.c_str());
       if (!this->schemaFileCache.contains(schemaFilePath)) {
          //
@@ -204,11 +215,11 @@ public:
          std::shared_ptr<boost::json::value const> schemaDocument =
             std::make_shared<boost::json::value const>(JsonUtils::loadJsonDocument(schemaFilePath, true));
 
-         qDebug() << Q_FUNC_INFO << "Read" << uri.c_str() << "as" << schemaFilePath;
+         qCDebug(Logging::serialization) << Q_FUNC_INFO << "Read" << uri.c_str() << "as" << schemaFilePath;
 
          this->schemaFileCache.insert(schemaFilePath, schemaDocument);
       } else {
-         qDebug() << Q_FUNC_INFO << schemaFilePath << "already in cache";
+         qCDebug(Logging::serialization) << Q_FUNC_INFO << schemaFilePath << "already in cache";
       }
 
       // We assert that we either already had the schema file in the cache or we just read it into the cache
@@ -245,6 +256,7 @@ JsonSchema::JsonSchema(char const * const baseDir,
 JsonSchema::~JsonSchema() = default;
 
 JsonSchema const & JsonSchema::instance(JsonSchema::Id id) {
+   QMutexLocker locker(&jsonSchemasMutex);
    // Once we are using C++20, we can write the following:
    ///if (jsonSchemas.contains(id)) {
    ///   return *jsonSchemas.value(id);
@@ -279,6 +291,10 @@ JsonSchema const & JsonSchema::instance(JsonSchema::Id id) {
 }
 
 
+int JsonSchema::compilationCount() {
+   return schemaCompilations;
+}
+
 bool JsonSchema::validate(boost::json::value const & document, QTextStream & userMessage) const {
 
    // Now pass the input document into Valijson (via a wrapper as with the base schema document) and validate it against
@@ -287,7 +303,8 @@ bool JsonSchema::validate(boost::json::value const & document, QTextStream & use
    valijson::Validator validator;
    valijson::ValidationResults validationResults;
    if (!validator.validate(this->pimpl->jsonSchema, inputAdapter, &validationResults)) {
-      qWarning() << Q_FUNC_INFO << validationResults.numErrors() << "validation errors in JSON file";
+      qCWarning(Logging::serialization) <<
+         Q_FUNC_INFO << validationResults.numErrors() << "validation errors in JSON file";
       // If there is more than one error, then we'll log them all here but only show the first one to the user on
       // the screen.  (Otherwise we might risk information overload.)
       userMessage <<
@@ -295,12 +312,13 @@ bool JsonSchema::validate(boost::json::value const & document, QTextStream & use
          validationErrorToString(*validationResults.begin());
       int errNum = 1;
       for (auto err = validationResults.begin(); err != validationResults.end(); ++err, ++errNum) {
-         qWarning() << Q_FUNC_INFO << "Validation error #" << errNum << ":" << validationErrorToString(*err);
+         qCWarning(Logging::serialization) <<
+            Q_FUNC_INFO << "Validation error #" << errNum << ":" << validationErrorToString(*err);
       }
       return false;
    }
 
-   qDebug() << Q_FUNC_INFO << "Validation succeeded";
+   qCDebug(Logging::serialization) << Q_FUNC_INFO << "Validation succeeded";
    return true;
 }
 
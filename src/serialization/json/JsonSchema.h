@@ -51,10 +51,19 @@ public:
     *        do not call the constructor until after all Qt start-up has happened, so we can guarantee that, eg, Qt
     *        resources are accessible.
     *
+    *        Each schema is parsed (and its referenced files loaded) only once per process, on the first call for its
+    *        \c id.  The resulting compiled schema is immutable, so all subsequent validations, on any thread, share it.
+    *
     * \param id Which schema you want to get.
     */
    static JsonSchema const & instance(JsonSchema::Id id);
 
+   /**
+    * \brief How many times, in this session, a schema has been parsed.  This should never be more than the number of
+    *        values of \c Id.
+    */
+   static int compilationCount();
+
    //! Destructor needs to be public as, internally, we manage instances of JsonSchema in std::unique_ptr
    ~JsonSchema();
 
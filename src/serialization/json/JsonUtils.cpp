@@ -15,10 +15,12 @@
  ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
 #include "serialization/json/JsonUtils.h"
 
+#include <algorithm>
 #include <iostream>
 #include <sstream>
 
 // We could just include <boost/json.hpp> which pulls all the Boost.JSON headers in, but that seems overkill
+#include <boost/json/monotonic_resource.hpp>
 #include <boost/json/parse_options.hpp>
 #include <boost/json/parse.hpp>
 #include <boost/json/string.hpp>
@@ -29,18 +31,30 @@
 #include <QFile>
 #include <QString>
 
+#include "Logging.h"
 #include "utils/BtException.h"
 #include "utils/BtStringStream.h"
 #include "utils/ErrorCodeToStream.h"
 
-[[nodiscard]] boost::json::value JsonUtils::loadJsonDocument(QString const & fileName, bool allowComments) {
+namespace {
+   //! How much of the file we read at a time.  Large enough to keep the number of reads small, but small enough not
+   //  to need to hold a significant chunk of a big file in memory alongside the document we're building from it.
+   constexpr qint64 readChunkSize = 64 * 1024;
+
+   //! Size of the initial block of a new arena.  Most BeerJSON files we see are in the tens to hundreds of kilobytes.
+   constexpr std::size_t initialArenaSize = 256 * 1024;
+}
+
+[[nodiscard]] boost::json::value JsonUtils::loadJsonDocument(QString const & fileName,
+                                                             bool allowComments,
+                                                             boost::json::storage_ptr storage) {
 
    QFile inputFile(fileName);
 
    if (!inputFile.open(QIODevice::ReadOnly)) {
       // Some slight duplication here but there's value in having the log messages in English and the on-screen display
       // message in the user's preferred language
-      qWarning() <<
+      qCWarning(Logging::serialization) <<
          Q_FUNC_INFO << "Could not open " << fileName << " for reading (error #" << inputFile.error() << ":" <<
          inputFile.errorString() << ")";
       QString errorMessage{
@@ -49,11 +63,21 @@
       throw BtException(errorMessage);
    }
 
+   return JsonUtils::loadJsonDocument(inputFile, fileName, allowComments, storage);
+}
+
+[[nodiscard]] boost::json::value JsonUtils::loadJsonDocument(QIODevice & inputFile,
+                                                             QString const & fileName,
+                                                             bool allowComments,
+                                                             boost::json::storage_ptr storage) {
+   // It's a coding error to give us a device we can't get the size of
+   Q_ASSERT(inputFile.isOpen() && !inputFile.isSequential());
+
    qint64 fileSize = inputFile.size();
    if (fileSize <= 0) {
       BtStringStream errorMessage;
       errorMessage << "File " << fileName << " has no data (length is " << fileSize << " bytes)";
-      qWarning() << Q_FUNC_INFO << errorMessage.asString();
+      qCWarning(Logging::serialization) << Q_FUNC_INFO << errorMessage.asString();
       throw BtException(errorMessage.asString());
    }
 
@@ -66,8 +90,15 @@
    // give you the best error handling.  In particular if there is a problem with the json input, you'll just get
    // a std::error_code that says, eg, "syntax error" without giving you any clue where in the input the problem is.
    //
-   // So, instead, we need to create a streaming parser and give it the source one line at a time.  That way, if we
-   // hit an error we can get the line number that first caused it.
+   // So, instead, we need to create a streaming parser and give it the source a chunk at a time.  That way, if we
+   // hit an error we can work out the line number that first caused it (from the number of newlines in the bytes the
+   // parser accepted).  We use fixed-size chunks rather than lines, because files written without line breaks would
+   // otherwise mean reading the whole file in one go -- and because reading many short lines is slow.
+   //
+   // Memory
+   // ------
+   // The document is allocated in the supplied memory resource (see comments on loadJsonDocument in the header).  The
+   // parser's own working storage uses the default resource, and is freed when the parser goes out of scope.
    //
    // String encodings
    // ----------------
@@ -145,22 +176,35 @@
       boost::json::parse_options parseOptions;
       parseOptions.allow_comments = allowComments;
       boost::json::stream_parser streamParser{
-         boost::json::storage_ptr{}, // Default memory resource
-         parseOptions,               // Default parse options (strict parsing)
+         boost::json::storage_ptr{}, // Default memory resource for temporary storage
+         parseOptions,
       };
-      QByteArray rawInputLine{};
-      for (auto [lineNumber, bytesLeftToRead] = std::tuple{1, fileSize};
-         bytesLeftToRead > 0;
-         ++lineNumber, bytesLeftToRead -= rawInputLine.size()) {
+      // This is what tells the parser where to put the document it builds
+      streamParser.reset(storage);
+
+      QByteArray rawInputChunk{};
+      int lineNumber = 1;
+      for (qint64 bytesLeftToRead = fileSize; bytesLeftToRead > 0; bytesLeftToRead -= rawInputChunk.size()) {
+         rawInputChunk = inputFile.read(std::min(bytesLeftToRead, readChunkSize));
+         if (rawInputChunk.isEmpty()) {
+            BtStringStream errorMessage{};
+            errorMessage << "Could not read " << fileName << " after line " << lineNumber << ": " <<
+               inputFile.errorString();
+            qCWarning(Logging::serialization) << Q_FUNC_INFO << errorMessage.asString();
+            throw BtException(errorMessage.asString());
+         }
          // Because of the way UTF-8 is encoded (see eg https://www.johndcook.com/blog/2019/09/09/how-utf-8-works/), it
-         // is entirely valid to treat it as an ASCII file for many purposes, including "give me a line of text".
-         rawInputLine = inputFile.readLine();
-         boost::json::string_view inputStringView{rawInputLine.data()};
-         streamParser.write(inputStringView, errorCode);
+         // is entirely valid to treat it as an ASCII file for many purposes, including "count the newlines".  It also
+         // doesn't matter if a chunk boundary falls in the middle of a multi-byte character, as the stream parser
+         // handles that.
+         boost::json::string_view inputStringView{rawInputChunk.constData(),
+                                                  static_cast<std::size_t>(rawInputChunk.size())};
+         std::size_t const bytesParsed = streamParser.write(inputStringView, errorCode);
+         lineNumber += rawInputChunk.left(static_cast<int>(bytesParsed)).count('\n');
          if (errorCode) {
             BtStringStream errorMessage{};
             errorMessage << "Parsing failed at line " << lineNumber << ": " << errorCode;
-            qWarning() << Q_FUNC_INFO << errorMessage.asString();
+            qCWarning(Logging::serialization) << Q_FUNC_INFO << errorMessage.asString();
             throw BtException(errorMessage.asString());
          }
       }
@@ -169,7 +213,7 @@
       if (errorCode) {
          BtStringStream errorMessage;
          errorMessage << "Parsing failed after reading last line: " << errorCode;
-         qWarning() << Q_FUNC_INFO << errorMessage.asString();
+         qCWarning(Logging::serialization) << Q_FUNC_INFO << errorMessage.asString();
          throw BtException(errorMessage.asString());
       }
       boost::json::value parsedDocument = streamParser.release();
@@ -180,11 +224,15 @@
       // least we can give the user something semi-meaningful to report to a maintainer.
       BtStringStream errorMessage;
       errorMessage << "Memory allocation error (" << exception.what() << ") while parsing " << fileName;
-      qWarning() << Q_FUNC_INFO << errorMessage.asString();
+      qCWarning(Logging::serialization) << Q_FUNC_INFO << errorMessage.asString();
       throw BtException(errorMessage.asString());
    }
 }
 
+[[nodiscard]] boost::json::storage_ptr JsonUtils::makeArena() {
+   return boost::json::make_shared_resource<boost::json::monotonic_resource>(initialArenaSize);
+}
+
 void JsonUtils::serialize(std::ostream & stream,
                           boost::json::value const & val,
                           std::string_view const tabString,
@@ -226,7 +274,7 @@ void JsonUtils::serialize(std::ostream & stream,
                //
                if (ii->value().kind() == boost::json::kind::object &&
                    ii->value().get_object().size() == 0) {
-                  qDebug() << Q_FUNC_INFO << "Skipping output of empty object for" << ii->key();
+                  qCDebug(Logging::serialization) << Q_FUNC_INFO << "Skipping output of empty object for" << ii->key();
                   continue;
                }
 
@@ -17,9 +17,11 @@
 #define SERIALIZATION_JSON_JSONUTILS_H
 #pragma once
 
+#include <boost/json/storage_ptr.hpp>
 #include <boost/json/value.hpp>
 
 class QDebug;
+class QIODevice;
 class QString;
 class QTextStream;
 
@@ -39,9 +41,38 @@ namespace JsonUtils {
     *                      useful for us to have such comments in data/DefaultContent002-BJCP_2021_Styles.json and
     *                      similar files.
     *
+    * \param storage Memory resource for the parsed document.  By default, this is the default memory resource (ie
+    *                global new and delete).  When we are only going to read the document and then throw it away (eg
+    *                when importing a file), it is much quicker to use \c makeArena() here, so that the thousands of
+    *                small allocations for the tree are carved out of a few large blocks, which are all freed in one go
+    *                when the document is destroyed.
+    *
     * \throw BtException containing text that can be displayed to the user
     */
-   [[nodiscard]] boost::json::value loadJsonDocument(QString const & fileName, bool allowComments = true);
+   [[nodiscard]] boost::json::value loadJsonDocument(QString const & fileName,
+                                                     bool allowComments = true,
+                                                     boost::json::storage_ptr storage = {});
+
+   /**
+    * \brief As above, but reads from \c input, which must already be open and must not be sequential.  Used for
+    *        documents that are not in files of their own (eg entries in a zip archive).
+    *
+    * \param name Used in error messages in place of the file name
+    */
+   [[nodiscard]] boost::json::value loadJsonDocument(QIODevice & input,
+                                                     QString const & name,
+                                                     bool allowComments = true,
+                                                     boost::json::storage_ptr storage = {});
+
+   /**
+    * \brief Make a new monotonic memory resource (aka arena) suitable for passing to \c loadJsonDocument.  Memory is
+    *        only released when the last \c boost::json::value using the resource is destroyed.
+    *
+    *        NB: Assigning a document allocated in the arena to a \c boost::json::value that uses a different memory
+    *        resource makes a deep copy (in the other resource).  Use move construction to keep the document in the
+    *        arena.
+    */
+   [[nodiscard]] boost::json::storage_ptr makeArena();
 
    /**
     * \brief Output a \c boost::json::value to a stream as nicely formatted valid JSON.  Essentially adds nice
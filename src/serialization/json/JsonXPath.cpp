@@ -28,6 +28,7 @@
 #include <QDebug>
 #include <QtGlobal> // For Q_ASSERT
 
+#include "Logging.h"
 #include "serialization/json/JsonUtils.h"
 
 JsonXPath::JsonXPath(char const * const xPath) :
@@ -181,23 +182,39 @@ boost::json::value const * JsonXPath::followPathFrom(boost::json::value const *
                                                      std::error_code & errorCode) const {
    // It's a coding error to call with a null pointer
    Q_ASSERT(startingValue);
-   // Note that if this->isEmpty(), the outer for loop does not execute (because this->m_pathParts.size() == 0) and we
+   //
+   // This gets called for every field of every record we read, so it needs to be quick.  We therefore walk the path
+   // nodes -- ie the keys and named array item identifiers that the constructor already split the path into -- rather
+   // than the JSON Pointers in m_pathParts.  This saves Boost.JSON having to re-parse the JSON Pointer on each call,
+   // and means there is no string copying or formatting here, except when we log a warning.
+   //
+   // Note that if this->isEmpty(), the outer for loop does not execute (because this->m_pathNodes.size() == 0) and we
    // return startingValue, which is the desired behaviour.
+   //
    boost::json::value const * destinationValue = startingValue;
-   for (auto const & pathPart : this->m_pathParts) {
-      if (std::holds_alternative<JsonXPath::JsonPointer>(pathPart)) {
-         // For a JSON Pointer, Boost.JSON does all the work
-         auto jsonPointer{std::get<JsonXPath::JsonPointer>(pathPart)};
+   for (auto const & pathNode : this->m_pathNodes) {
+      if (std::holds_alternative<JsonXPath::JsonKey>(pathNode)) {
+         std::string_view const key{std::get<JsonXPath::JsonKey>(pathNode)};
          // Normally have this commented out as it generates lots of logging
 //         qDebug() <<
-//            Q_FUNC_INFO << "Following path part" << jsonPointer.c_str() << "from" << *destinationValue << "in" <<
+//            Q_FUNC_INFO << "Following path node" << key.data() << "from" << *destinationValue << "in" <<
 //            this->m_rawXPath;
-         destinationValue = destinationValue->find_pointer(std::string_view{jsonPointer}, errorCode);
-         // If we already know there's no result, stop looping through the path parts
-         // This is not an error per se, just that nothing was found
+         boost::json::object const * destinationValueAsObject = destinationValue->if_object();
+         if (destinationValueAsObject) {
+            destinationValue = destinationValueAsObject->if_contains(key);
+         } else {
+            //
+            // A JSON Pointer can also index into an array (eg "/foo/0"), so, although we don't currently use this, we
+            // fall back to letting Boost.JSON deal with anything that isn't an object.
+            //
+            std::string const jsonPointer{std::string{"/"}.append(key)};
+            destinationValue = destinationValue->find_pointer(std::string_view{jsonPointer}, errorCode);
+         }
+         // If we already know there's no result, stop looping through the path nodes
+         // This is not an error per se, just that nothing was found (so, normally, we don't log it, as that would
+         // generate a lot of logging for optional fields)
          if (!destinationValue) {
-            qDebug() <<
-               Q_FUNC_INFO << "No result from" << jsonPointer.c_str() << "while following" << this->m_rawXPath;
+//            qDebug() << Q_FUNC_INFO << "No result from" << key.data() << "while following" << this->m_rawXPath;
             // std::error_code usually holds an implementation-defined value, but we can use POSIX error codes.
             // Here I'm taking a liberal interpretation of the Posix "bad address" (EFAULT) code.  It was a toss up
             // between that and "invalid argument" (EINVAL).
@@ -205,14 +222,14 @@ boost::json::value const * JsonXPath::followPathFrom(boost::json::value const *
             return nullptr;
          }
       } else {
-         Q_ASSERT(std::holds_alternative<JsonXPath::NamedArrayItemId>(pathPart));
+         Q_ASSERT(std::holds_alternative<JsonXPath::NamedArrayItemId>(pathNode));
 
          // For a named array item identifier, we have to do things by hand
-         auto const & namedArrayItemId = std::get<JsonXPath::NamedArrayItemId>(pathPart);
+         auto const & namedArrayItemId = std::get<JsonXPath::NamedArrayItemId>(pathNode);
 
          // Firstly, the current value has better be an array
          if (!destinationValue->is_array()) {
-            qWarning() <<
+            qCWarning(Logging::serialization) <<
                Q_FUNC_INFO << "Following" << this->m_rawXPath << "resulted in trying to apply" << namedArrayItemId <<
                "to" << destinationValue->kind();
             errorCode = std::make_error_code(std::errc::bad_address);
@@ -223,9 +240,12 @@ boost::json::value const * JsonXPath::followPathFrom(boost::json::value const *
          // match as, in our use cases, we are not expecting multiple matches and cannot usefully interpret them.)
          bool foundInArray = false;
          boost::json::array const & destinationValueAsArray = destinationValue->get_array();
-         qDebug() <<
-            Q_FUNC_INFO << "Searching through" << destinationValueAsArray.size() << "array items for" <<
-            namedArrayItemId;
+         std::string_view const matchKey  {namedArrayItemId.key  };
+         std::string_view const matchValue{namedArrayItemId.value};
+         // Normally have this commented out as it generates lots of logging
+//         qDebug() <<
+//            Q_FUNC_INFO << "Searching through" << destinationValueAsArray.size() << "array items for" <<
+//            namedArrayItemId;
          //
          // Note that we do not use the range for (eg `for (auto arrayEntry : destinationValueAsArray)`) because we want
          // arrayEntry to be a pointer to constant values and we don't want any copying going on.
@@ -238,7 +258,7 @@ boost::json::value const * JsonXPath::followPathFrom(boost::json::value const *
             // use cases, we do not have heterogeneous arrays, so it's better to barf up an error straight away.
             auto arrayEntryAsObject = arrayEntry->if_object();
             if (!arrayEntryAsObject) {
-               qWarning() <<
+               qCWarning(Logging::serialization) <<
                   Q_FUNC_INFO << "While following" << this->m_rawXPath << "found" << arrayEntry->kind() <<
                   "when applying" << namedArrayItemId;
                errorCode = std::make_error_code(std::errc::bad_address);
@@ -247,9 +267,9 @@ boost::json::value const * JsonXPath::followPathFrom(boost::json::value const *
 
             // Again, in theory, we could just skip over any object that doesn't have the key we want to look up, but
             // our data doesn't have such cases, so we just error straight away.
-            auto value = arrayEntryAsObject->if_contains(std::string_view{namedArrayItemId.key});
+            auto value = arrayEntryAsObject->if_contains(matchKey);
             if (!value) {
-               qWarning() <<
+               qCWarning(Logging::serialization) <<
                   Q_FUNC_INFO << "While following" << this->m_rawXPath << "found array entry without correct key "
                   "when applying" << namedArrayItemId;
                errorCode = std::make_error_code(std::errc::bad_address);
@@ -259,14 +279,14 @@ boost::json::value const * JsonXPath::followPathFrom(boost::json::value const *
             // You get the idea by now... :-)
             auto valueAsString = value->if_string();
             if (!valueAsString) {
-               qWarning() <<
+               qCWarning(Logging::serialization) <<
                   Q_FUNC_INFO << "While following" << this->m_rawXPath << "found array entry without non-string value "
                   "for key (" << value->kind() << ") when applying" << namedArrayItemId;
                errorCode = std::make_error_code(std::errc::bad_address);
                return nullptr;
             }
 
-            if (*valueAsString == namedArrayItemId.value) {
+            if (std::string_view{valueAsString->data(), valueAsString->size()} == matchValue) {
                // It isn't normally necessary to enable the next log statement
 //               qDebug() << Q_FUNC_INFO << "Found" << valueAsString->c_str();
                destinationValue = arrayEntry;
@@ -274,14 +294,16 @@ boost::json::value const * JsonXPath::followPathFrom(boost::json::value const *
                break;
             }
 
-            qDebug() <<
-               Q_FUNC_INFO << "Skipping" << valueAsString->c_str() << "while searching for" << namedArrayItemId <<
-               "as part of" << this->m_rawXPath;
+            // Normally have this commented out as it generates lots of logging
+//            qDebug() <<
+//               Q_FUNC_INFO << "Skipping" << valueAsString->c_str() << "while searching for" << namedArrayItemId <<
+//               "as part of" << this->m_rawXPath;
          }
 
          if (!foundInArray) {
             // It's not necessarily an error if we didn't find the thing we were looking for.  It might be optional.
-            qDebug() << Q_FUNC_INFO << "No match found for" << namedArrayItemId << "when following" << this->m_rawXPath;
+            qCDebug(Logging::serialization) <<
+               Q_FUNC_INFO << "No match found for" << namedArrayItemId << "when following" << this->m_rawXPath;
             errorCode = std::make_error_code(std::errc::bad_address);
             return nullptr;
          }
@@ -303,7 +325,7 @@ std::string JsonXPath::makePointerToLeaf(boost::json::value ** valuePointer) con
    // Start with the special case of the empty XPath, in which case we want valuePointer to be unchanged
    //
    if (this->isEmpty()) {
-      qDebug() << Q_FUNC_INFO << "Empty XPath";
+      qCDebug(Logging::serialization) << Q_FUNC_INFO << "Empty XPath";
       return "";
    }
 
@@ -397,7 +419,7 @@ std::string JsonXPath::makePointerToLeaf(boost::json::value ** valuePointer) con
       if (!std::holds_alternative<std::monostate>(priorNode)) {
          if (std::holds_alternative<JsonXPath::JsonKey>(priorNode)) {
             auto const & previousKey{std::get<JsonXPath::JsonKey>(priorNode)};
-            qDebug() << Q_FUNC_INFO << "previousKey:" << previousKey.c_str();
+            qCDebug(Logging::serialization) << Q_FUNC_INFO << "previousKey:" << previousKey.c_str();
             Q_ASSERT(previousValue->is_object());
             boost::json::value * currentValue = previousValue->get_object().if_contains(previousKey);
             if (!currentValue) {
@@ -405,12 +427,12 @@ std::string JsonXPath::makePointerToLeaf(boost::json::value ** valuePointer) con
                // key (see examples in comment above)
                if (std::holds_alternative<JsonXPath::JsonKey>(currentNode)) {
                   // This is case (1) Node follows Node
-                  qDebug() << Q_FUNC_INFO << "Making sub-object for" << previousKey.c_str();
+                  qCDebug(Logging::serialization) << Q_FUNC_INFO << "Making sub-object for" << previousKey.c_str();
                   previousValue->get_object()[previousKey].emplace_object();
                } else {
                   // This is case (2) Named Array Item Id follows Node
                   Q_ASSERT(std::holds_alternative<JsonXPath::NamedArrayItemId>(currentNode));
-                  qDebug() << Q_FUNC_INFO << "Making sub-array for" << previousKey.c_str();
+                  qCDebug(Logging::serialization) << Q_FUNC_INFO << "Making sub-array for" << previousKey.c_str();
                   previousValue->get_object()[previousKey].emplace_array();
                }
                // The previous key should now exist!
@@ -421,7 +443,7 @@ std::string JsonXPath::makePointerToLeaf(boost::json::value ** valuePointer) con
          } else {
             Q_ASSERT(std::holds_alternative<JsonXPath::NamedArrayItemId>(priorNode));
             auto const & namedArrayItemId{std::get<JsonXPath::NamedArrayItemId>(priorNode)};
-            qDebug() <<
+            qCDebug(Logging::serialization) <<
                Q_FUNC_INFO << "namedArrayItemId.key:" << namedArrayItemId.key.c_str() << ", namedArrayItemId.value:" <<
                namedArrayItemId.value.c_str();
             // As noted above, we cannot have Named Array Item Id follows Named Array Item Id, so we assert that here
@@ -457,14 +479,14 @@ std::string JsonXPath::makePointerToLeaf(boost::json::value ** valuePointer) con
                   break;
                }
 
-               qDebug() <<
+               qCDebug(Logging::serialization) <<
                   Q_FUNC_INFO << "Skipping array entry with" << namedArrayItemId.key.c_str() << "=" <<
                   itemIdAsString->c_str() << "while searching for" << namedArrayItemId.value.c_str();
             }
 
             if (!found) {
                // This is case (3) Node follows Named Array Item Id
-               qDebug() <<
+               qCDebug(Logging::serialization) <<
                   Q_FUNC_INFO << "Creating new array element with" << namedArrayItemId.key.c_str() << "=" <<
                   namedArrayItemId.value.c_str();
                // We're letting BoostJSON do all the constructor calling as we want it to own the objects being made.
@@ -503,11 +525,9 @@ std::string_view JsonXPath::asKey() const {
    // It's also a coding error if there is more than one path node
    Q_ASSERT(this->m_pathNodes.size() == 1);
 
-   // We need to get the first path part (m_pathParts[0]) and then strip the beginning '/' character from it
-   // (.substr(1)) before we pass it to the string_view constructor.  (Maybe there is a slick way to skip over the '/'
-   // in the string_view constructor, but I didn't yet find it.)
-   std::string_view key{std::get<JsonXPath::JsonKey>(this->m_pathParts[0]).substr(1)};
-   return key;
+   // The first path node (m_pathNodes[0]) is the key without the leading '/'.  Note that we must not make the
+   // string_view from a temporary (eg by calling substr(1) on m_pathParts[0]), as it would then be left dangling.
+   return std::string_view{std::get<JsonXPath::JsonKey>(this->m_pathNodes[0])};
 }
 
 char const * JsonXPath::asXPath_c_str() const {
@@ -176,8 +176,10 @@ private:
    //
    // All three of the member variables below store the complete JsonXpath, just in 3 different ways:
    //    - m_rawXPath is best for logging
-   //    - m_pathParts is best for reading from a document
-   //    - m_pathNodes is best for writing to a document
+   //    - m_pathParts is best for checking the structure of the path
+   //    - m_pathNodes is best for reading from, or writing to, a document.  It is, in effect, the path "compiled" into
+   //      the keys and named array item identifiers we look up at each step.  This means that, when reading a record,
+   //      we don't need to do any string parsing, formatting or allocation for each field.
    // We accept the storage inefficiency for the benefit of simplifying our algorithms.
    //
 
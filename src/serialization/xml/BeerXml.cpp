@@ -17,18 +17,26 @@
  ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
 #include "serialization/xml/BeerXml.h"
 
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <optional>
 #include <stdexcept>
 
 #include <QApplication>
+#include <QBuffer>
 #include <QDebug>
 #include <QDomNodeList>
 #include <QFile>
 #include <QHash>
+#include <QIODevice>
 #include <QList>
 #include <QTextCodec>
 #include <QTextStream>
 
 #include "config.h" // For CONFIG_VERSION_STRING
+#include "database/ObjectStore.h"
+#include "Logging.h"
 #include "model/Boil.h" // But NB model/BoilStep.h is not needed
 #include "model/BrewNote.h"
 #include "model/Equipment.h"
@@ -53,6 +61,7 @@
 #include "serialization/xml/MibEnum.h"
 #include "serialization/xml/XmlCoding.h"
 #include "serialization/xml/XmlRecord.h"
+#include "utils/ParallelRender.h"
 
 //
 // Variables and constant definitions that we need only in this file
@@ -1091,24 +1100,109 @@ namespace {
    };
 
    /**
-    * \brief Validate XML file against schema and load its contents
+    * \brief Files bigger than this are imported by streaming through them rather than by loading them into memory and
+    *        building a DOM tree.  The DOM route is quicker, but its memory use is several times the size of the file.
+    */
+   constexpr qint64 streamingImportThreshold_bytes{16 * 1024 * 1024};
+
+   /**
+    * \brief Read-only device that presents some bytes, followed by the rest of a file (from its current position),
+    *        followed by some more bytes, as a single seekable document.  This allows us to make the edit described in
+    *        \c readAndValidate without having to read the whole file into memory.
+    */
+   class SplicedDevice : public QIODevice {
+   public:
+      SplicedDevice(QByteArray const & prefix, QFile & body, QByteArray const & suffix) :
+         QIODevice{},
+         m_prefix{prefix},
+         m_body{body},
+         m_bodyStart{body.pos()},
+         m_suffix{suffix},
+         m_position{0} {
+         return;
+      }
+      virtual ~SplicedDevice() = default;
+
+      virtual bool isSequential() const override {
+         return false;
+      }
+
+      virtual qint64 size() const override {
+         return this->m_prefix.size() + this->bodySize() + this->m_suffix.size();
+      }
+
+      virtual bool seek(qint64 position) override {
+         if (!QIODevice::seek(position)) {
+            return false;
+         }
+         this->m_position = position;
+         return true;
+      }
+
+   protected:
+      virtual qint64 readData(char * data, qint64 maxSize) override {
+         qint64 const endOfBody = this->m_prefix.size() + this->bodySize();
+         qint64 bytesRead = 0;
+         while (bytesRead < maxSize && this->m_position < this->size()) {
+            qint64 chunkSize = 0;
+            if (this->m_position < this->m_prefix.size()) {
+               chunkSize = std::min(maxSize - bytesRead, this->m_prefix.size() - this->m_position);
+               std::memcpy(data + bytesRead, this->m_prefix.constData() + this->m_position, chunkSize);
+            } else if (this->m_position < endOfBody) {
+               qint64 const positionInBody = this->m_bodyStart + this->m_position - this->m_prefix.size();
+               if (this->m_body.pos() != positionInBody && !this->m_body.seek(positionInBody)) {
+                  return bytesRead > 0 ? bytesRead : -1;
+               }
+               chunkSize = this->m_body.read(data + bytesRead,
+                                             std::min(maxSize - bytesRead, endOfBody - this->m_position));
+               if (chunkSize <= 0) {
+                  return bytesRead > 0 ? bytesRead : -1;
+               }
+            } else {
+               chunkSize = std::min(maxSize - bytesRead, this->size() - this->m_position);
+               std::memcpy(data + bytesRead, this->m_suffix.constData() + this->m_position - endOfBody, chunkSize);
+            }
+            bytesRead += chunkSize;
+            this->m_position += chunkSize;
+         }
+         return bytesRead;
+      }
+
+      virtual qint64 writeData([[maybe_unused]] char const * data, [[maybe_unused]] qint64 maxSize) override {
+         return -1;
+      }
+
+   private:
+      qint64 bodySize() const {
+         return this->m_body.size() - this->m_bodyStart;
+      }
+
+      QByteArray const m_prefix;
+      QFile & m_body;
+      qint64 const m_bodyStart;
+      QByteArray const m_suffix;
+      qint64 m_position;
+   };
+
+   /**
+    * \brief Read XML file and validate it against schema.  See \c BeerXML::readAndValidate for details.
     *
+    * \param inputFile The file to validate, open for reading and positioned at the start
     * \param fileName Fully-qualified name of the file to validate
+    * \param canStream \c true if \c inputFile is the file called \c fileName, in which case, if it is large, we stream
+    *                  it from disk rather than read it into memory.  (For a document that is already in memory, eg
+    *                  because it has been decompressed from an archive, streaming would not save anything.)
     * \param userMessage Any message that we want the top-level caller to display to the user (either about an error
     *                    or, in the event of success, summarising what was read in) should be appended to this string.
     *
-    * \return true if file validated OK (including if there were "errors" that we can safely ignore)
-    *         false if there was a problem that means it's not worth trying to read in the data from the file
+    * \return Function to load the file's contents and store them in the DB if file validated OK (including if there
+    *         were "errors" that we can safely ignore), or an empty function if there was a problem that means it's not
+    *         worth trying to read in the data from the file
     */
-   bool validateAndLoad(QString const & fileName, QTextStream & userMessage) {
-
-      QFile inputFile;
-      inputFile.setFileName(fileName);
-
-      if(!inputFile.open(QIODevice::ReadOnly)) {
-         qWarning() << Q_FUNC_INFO << ": Could not open " << fileName << " for reading";
-         return false;
-      }
+   std::function<bool(QTextStream &)> readAndValidate(QIODevice & inputFile,
+                                                      QString const & fileName,
+                                                      bool const canStream,
+                                                      QTextStream & userMessage) {
 
       //
       // Rather than just read the XML file into memory, we actually make a small on-the-fly modification to it to
@@ -1142,6 +1236,11 @@ namespace {
       // Note here that we are assuming the on-disk format of the file is single-byte (UTF-8 or ASCII or ISO-8859-1).
       // This is a reasonably safe assumption but, in theory, we could examine the first line to verify it.
       //
+      // We do not otherwise do anything about the character encoding: both Xerces and QXmlStreamReader honour the
+      // encoding in the XML declaration (eg ISO-8859-1 or windows-1252) and transcode as they pull bytes in, a buffer
+      // at a time.  So, for the streamed import of large files below, legacy-encoded files cost no more memory than
+      // UTF-8 ones, and there is never a transcoded copy of the whole file.
+      //
       // We _could_ make "BEER_XML" some sort of constant eg:
       //    constexpr static char const * const INSERTED_ROOT_NODE_NAME = "BEER_XML";
       // but we wouldn't be able to use that constant in beerxml/v1/BeerXml.xsd, and using it in the few C++ places we
@@ -1151,27 +1250,19 @@ namespace {
       //
       QByteArray documentData = inputFile.readLine();
       QString firstLine{documentData};
-      qDebug() << Q_FUNC_INFO << "First line of " << inputFile.fileName() << " was " << firstLine;
+      qCDebug(Logging::serialization) <<
+         Q_FUNC_INFO << "First line of " << fileName << " was " << firstLine;
       if (!firstLine.startsWith(QString("<?xml version="))) {
          //
          // For the moment, we're being strict and bailing out here.  An alternative approach would be to accept files
          // missing the XML declaration (which is, after all, optional in most types of XML file)
          //
-         qCritical() <<
+         qCCritical(Logging::serialization) <<
             Q_FUNC_INFO << "Unexpected first line of file (should begin with '<?xml version=' but doesn't): " <<
             firstLine;
          userMessage << "Unexpected first line (not the XML declaration mandated by BeerXML).";
-         return false;
+         return {};
       }
-      documentData += "<BEER_XML>\n";
-      documentData += inputFile.readAll();
-      documentData += "\n</BEER_XML>";
-      qDebug() << Q_FUNC_INFO << "Input file " << inputFile.fileName() << ": " << documentData.length() << " bytes";
-
-      // It is sometimes helpful to uncomment the next line for debugging, but usually leave it commented out as can
-      // put a _lot_ of data in the logs in DEBUG mode.
-      // qDebug().noquote() << Q_FUNC_INFO << "Full content of " << inputFile.fileName() << " is:\n" << QString(documentData);
-
       //
       // Some errors we explicitly want to ignore.  In particular, the BeerXML 1.0 standard says:
       //
@@ -1201,10 +1292,62 @@ namespace {
          {QString("^no declaration found for element"),                 QString("we are assuming unrecognised tags are just non-standard tags in the BeerXML")},
          {QString("^element '[^']*' is not allowed for content model"), QString("we are assuming unrecognised tags are just non-standard tags in the BeerXML")}
       };
+      if (canStream && inputFile.size() > streamingImportThreshold_bytes) {
+         //
+         // For a large file, rather than read it all into memory, we give the XML coding a device that makes the same
+         // edit on the fly, and it streams through the document instead of building a DOM tree.  Because the streaming
+         // import stores records as it goes, its validation pass cannot be separated from the loading, so it all
+         // happens when the returned function is called.
+         //
+         QByteArray const firstLineData = documentData;
+         return [fileName, firstLineData](QTextStream & userMessage) {
+            QFile inputFile{fileName};
+            if (!inputFile.open(QIODevice::ReadOnly)) {
+               qCWarning(Logging::serialization) << Q_FUNC_INFO << ": Could not reopen " << fileName << " for reading";
+               return false;
+            }
+            // We already checked the first line above
+            inputFile.readLine();
+            BtDomErrorHandler domErrorHandler(&errorPatternsToIgnore, 1, 1);
+            SplicedDevice document{firstLineData + "<BEER_XML>\n", inputFile, "\n</BEER_XML>"};
+            document.open(QIODevice::ReadOnly | QIODevice::Unbuffered);
+            qCDebug(Logging::serialization) <<
+               Q_FUNC_INFO << "Streaming input file " << inputFile.fileName() << ": " << document.size() << " bytes";
+            return BEER_XML_1_CODING.validateLoadAndStoreInDb(document, fileName, domErrorHandler, userMessage);
+         };
+      }
+
+      documentData += "<BEER_XML>\n";
+      documentData += inputFile.readAll();
+      documentData += "\n</BEER_XML>";
+      qCDebug(Logging::serialization) <<
+         Q_FUNC_INFO << "Input file " << fileName << ": " << documentData.length() << " bytes";
+
+      // It is sometimes helpful to uncomment the next line for debugging, but usually leave it commented out as can
+      // put a _lot_ of data in the logs in DEBUG mode.
+      // qDebug().noquote() << Q_FUNC_INFO << "Full content of " << fileName << " is:\n" << QString(documentData);
+
       BtDomErrorHandler domErrorHandler(&errorPatternsToIgnore, 1, 1);
+      std::shared_ptr<BtDomDocumentOwner> domDocumentOwner =
+         BEER_XML_1_CODING.validate(documentData, fileName, domErrorHandler, userMessage);
+      if (!domDocumentOwner) {
+         return {};
+      }
 
-      return BEER_XML_1_CODING.validateLoadAndStoreInDb(documentData, fileName, domErrorHandler, userMessage);
+      return [domDocumentOwner](QTextStream & userMessage) {
+         return BEER_XML_1_CODING.loadAndStoreInDb(*domDocumentOwner, userMessage);
+      };
+   }
 
+   std::function<bool(QTextStream &)> readAndValidate(QString const & fileName, QTextStream & userMessage) {
+      QFile inputFile;
+      inputFile.setFileName(fileName);
+
+      if(!inputFile.open(QIODevice::ReadOnly)) {
+         qCWarning(Logging::serialization) << Q_FUNC_INFO << ": Could not open " << fileName << " for reading";
+         return {};
+      }
+      return readAndValidate(inputFile, fileName, true, userMessage);
    }
 
 }
@@ -1234,6 +1377,11 @@ BeerXML::~BeerXML() = default;
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+namespace {
+   //! When exporting, this is roughly how many characters we build up before writing them to the file
+   constexpr int exportBufferSize = 1024 * 1024;
+}
+
 void BeerXML::createXmlFile(QFile & outFile) const {
    QTextStream out(&outFile);
    // BeerXML specifies the ISO-8859-1 encoding
@@ -1253,23 +1401,53 @@ template<class NE> void BeerXML::toXml(QList<NE const *> const & nes, QFile & ou
       return;
    }
 
+   //
+   // Rather than have QTextStream encode and write to the file in small pieces, we build the output in a large,
+   // preallocated, buffer, and then encode it and write it to the file in one go whenever the buffer fills up.
+   //
+   // BeerXML specifies the ISO-8859-1 encoding
+   // .:TODO:. In Qt6, QTextCodec and QTextStream::setCodec have been removed and are replaced by QStringConverter
+   // (which is new in Qt6).
+   //
+   QTextCodec const * const codec = QTextCodec::codecForMib(CharacterSets::ISO_8859_1_1987);
+   QString buffer;
+   buffer.reserve(exportBufferSize + exportBufferSize / 4);
+   QTextStream out(&buffer);
+   auto writeBuffer = [&]() {
+      out.flush();
+      outFile.write(codec->fromUnicode(buffer));
+      buffer.clear();
+      return;
+   };
+
    // It is a feature of BeerXML that the tag name for a list of elements is just the tag name for an individual
    // element with an S on the end, even when this is not grammatically correct.  Thus a list of <HOP>...</HOP> records
    // is contained inside <HOPS>...</HOPS> tags, a list of <MISC>...</MISC> records is contained inside
    // <MISCS>...</MISCS> tags and so on.
-   QTextStream out(&outFile);
-   // BeerXML specifies the ISO-8859-1 encoding
-   // .:TODO:. In Qt6, QTextCodec and QTextStream::setCodec have been removed and are replaced by QStringConverter
-   // (which is new in Qt6).
-   out.setCodec(QTextCodec::codecForMib(CharacterSets::ISO_8859_1_1987));
    out << "<" << BEER_XML_RECORD_DEFN<NE>.m_recordName << "S>\n";
-   for (NE const * ne : nes) {
-      std::unique_ptr<XmlRecord> xmlRecord{
-         BEER_XML_RECORD_DEFN<NE>.makeRecord(BEER_XML_1_CODING)
-      };
-      xmlRecord->toXml(*ne, out, true);
-   }
+   // When there are lots of records, they get rendered in parallel -- see comments in utils/ParallelRender.h
+   ParallelRender::renderAndWrite(
+      nes,
+      [](NE const * ne) {
+         std::unique_ptr<XmlRecord> xmlRecord{
+            BEER_XML_RECORD_DEFN<NE>.makeRecord(BEER_XML_1_CODING)
+         };
+         QString rendered;
+         QTextStream renderedStream(&rendered);
+         xmlRecord->toXml(*ne, renderedStream, true);
+         renderedStream.flush();
+         return std::optional<QString>{rendered};
+      },
+      [&](QString const & rendered) {
+         out << rendered;
+         if (buffer.size() >= exportBufferSize) {
+            writeBuffer();
+         }
+         return;
+      }
+   );
    out << "</" << BEER_XML_RECORD_DEFN<NE>.m_recordName << "S>\n";
+   writeBuffer();
    return;
 }
 //
@@ -1299,13 +1477,33 @@ bool BeerXML::importFromXML(QString const & filename, QTextStream & userMessage)
    //
    RecipeHelper::SuspendRecipeVersioning suspendRecipeVersioning;
 
+   //
+   // Similarly, rather than have every table, list and tree model update itself once for each object we import, we
+   // queue up the "object inserted" signals and deliver them, to be handled as one change, at the end.
+   //
+   ObjectStoreSignalBatch objectStoreSignalBatch;
+
    //
    // Slightly more manually, we also change the cursor to show "busy" while we're doing the import as, for large
    // imports, processing can take a few seconds or so.
    //
    QApplication::setOverrideCursor(Qt::WaitCursor);
    QApplication::processEvents();
-   bool result = validateAndLoad(filename, userMessage);
+   auto loadAndStoreInDb = ::readAndValidate(filename, userMessage);
+   bool result = loadAndStoreInDb && loadAndStoreInDb(userMessage);
    QApplication::restoreOverrideCursor();
    return result;
 }
+
+std::function<bool(QTextStream &)> BeerXML::readAndValidate(QString const & filename, QTextStream & userMessage) const {
+   return ::readAndValidate(filename, userMessage);
+}
+
+std::function<bool(QTextStream &)> BeerXML::readAndValidate(QString const & name,
+                                                            QByteArray const & contents,
+                                                            QTextStream & userMessage) const {
+   QBuffer buffer;
+   buffer.setData(contents);
+   buffer.open(QIODevice::ReadOnly);
+   return ::readAndValidate(buffer, name, false, userMessage);
+}
@@ -18,6 +18,8 @@
 #define SERIALIZATION_XML_BEERXML_H
 #pragma once
 
+#include <functional>
+
 #include <QFile>
 #include <QString>
 #include <QTextStream>
@@ -49,6 +51,9 @@ public:
 
    /**
     * \brief Write a list of objects to the supplied file
+    *
+    *        Long lists are rendered on several threads, so, as in \c ImportExport::exportToFile, the caller needs to
+    *        have called \c HydrateAllObjectStores (and made sure any \c Recipe calculations are up-to-date) first.
     */
    template<class NE> void toXml(QList<NE const *> const & nes, QFile & outFile) const;
 
@@ -60,6 +65,25 @@ public:
     */
    bool importFromXML(QString const & filename, QTextStream & userMessage);
 
+   /**
+    * \brief First half of \c importFromXML: read a BeerXML document and validate it against the schema.  This is safe
+    *        to call from any thread, including for several files at once.  (The exception is very large files, which
+    *        we stream rather than load into memory.  For these, all the work is deferred to the returned function.)
+    *
+    * \return If the file is valid, a function that must be called on the GUI thread (with recipe versioning suspended)
+    *         to load the file's contents and store them in the DB, and which takes and returns the same as
+    *         \c importFromXML.  If the file is not valid, an empty function, and the reason is in \c userMessage.
+    */
+   std::function<bool(QTextStream &)> readAndValidate(QString const & filename, QTextStream & userMessage) const;
+
+   /**
+    * \brief As above, but for a document that has already been read into memory (eg an entry in a zip archive) rather
+    *        than being in a file of its own.  \c name is only used for logging and messages.
+    */
+   std::function<bool(QTextStream &)> readAndValidate(QString const & name,
+                                                      QByteArray const & contents,
+                                                      QTextStream & userMessage) const;
+
 private:
 
    /**
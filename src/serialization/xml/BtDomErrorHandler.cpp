@@ -20,7 +20,9 @@
 
 #include <xercesc/dom/DOMLocator.hpp>
 #include <xercesc/dom/DOMError.hpp>
+#include <xercesc/sax/SAXParseException.hpp>
 
+#include "Logging.h"
 #include "serialization/xml/XQString.h"
 
 // This private implementation class holds all private non-virtual members of BtDomErrorHandler
@@ -90,7 +92,7 @@ QString BtDomErrorHandler::getlastError() {
 unsigned int BtDomErrorHandler::correctErrorLine(unsigned int lineNumberOfError) {
    if (this->pimpl->numberOfLinesInserted > 0 &&
          lineNumberOfError > (this->pimpl->lineAfterWhichInserted + this->pimpl->numberOfLinesInserted)) {
-      qDebug() <<
+      qCDebug(Logging::serialization) <<
          Q_FUNC_INFO << "Removing " << this->pimpl->numberOfLinesInserted << " from raw line number of error ("<<
          lineNumberOfError << ")";
       return lineNumberOfError - this->pimpl->numberOfLinesInserted;
@@ -113,22 +115,63 @@ bool BtDomErrorHandler::handleError(xercesc::DOMError const & domError) {
    // Nonetheless, even just knowing the first point in the document where there was a problem with parsing is
    // usually pretty helpful.
    //
+   xercesc::DOMLocator* location {domError.getLocation()};
+   return this->processError(impl::XercesErrorSeverities[domError.getSeverity()],
+                             static_cast<unsigned int>(location->getLineNumber()),
+                             static_cast<unsigned int>(location->getColumnNumber()),
+                             XQString(location->getURI()),
+                             XQString(domError.getMessage()));
+}
+
+void BtDomErrorHandler::warning(xercesc::SAXParseException const & saxParseException) {
+   this->processSaxError(impl::XercesErrorSeverities[xercesc::DOMError::DOM_SEVERITY_WARNING], saxParseException);
+   return;
+}
+
+void BtDomErrorHandler::error(xercesc::SAXParseException const & saxParseException) {
+   this->processSaxError(impl::XercesErrorSeverities[xercesc::DOMError::DOM_SEVERITY_ERROR], saxParseException);
+   return;
+}
+
+void BtDomErrorHandler::fatalError(xercesc::SAXParseException const & saxParseException) {
+   this->processSaxError(impl::XercesErrorSeverities[xercesc::DOMError::DOM_SEVERITY_FATAL_ERROR], saxParseException);
+   return;
+}
+
+void BtDomErrorHandler::resetErrors() {
+   this->reset();
+   return;
+}
+
+void BtDomErrorHandler::processSaxError(char const * const severity,
+                                        xercesc::SAXParseException const & saxParseException) {
+   if (!this->processError(severity,
+                           static_cast<unsigned int>(saxParseException.getLineNumber()),
+                           static_cast<unsigned int>(saxParseException.getColumnNumber()),
+                           XQString(saxParseException.getSystemId()),
+                           XQString(saxParseException.getMessage()))) {
+      throw saxParseException;
+   }
+   return;
+}
+
+bool BtDomErrorHandler::processError(char const * const severity,
+                                     unsigned int const lineNumber,
+                                     unsigned int const columnNumber,
+                                     QString const & uri,
+                                     QString const & message) {
+   //
    // Here we create two versions of the error message - "short" is (potentially) to show on the screen (unless we
    // deduce below we can ignore it) and "full" is for the log file
    //
    QString shortErrorMessage;
    QTextStream shortErrorMessageAsTextStream(&shortErrorMessage);
-   xercesc::DOMLocator* location {domError.getLocation()};
-   XQString message{domError.getMessage()};
    shortErrorMessageAsTextStream <<
-      impl::XercesErrorSeverities[domError.getSeverity()] <<
-      " at line " << this->correctErrorLine(location->getLineNumber()) <<
-      ", column " << location->getColumnNumber() <<
-      ": " << message;
+      severity << " at line " << this->correctErrorLine(lineNumber) << ", column " << columnNumber << ": " << message;
 
    QString fullErrorMessage;
    QTextStream fullErrorMessageAsTextStream(&fullErrorMessage);
-   fullErrorMessageAsTextStream << XQString(location->getURI()) << ": " << shortErrorMessage;
+   fullErrorMessageAsTextStream << uri << ": " << shortErrorMessage;
 
    //
    // Check whether the error we just hit is one we can actually ignore
@@ -139,7 +182,7 @@ bool BtDomErrorHandler::handleError(xercesc::DOMError const & domError) {
          if (pattern.indexIn(message) != -1) {
             // We want to force the parse error onto a separate line, as it will be quite long, hence
             // ".noquote()" here.
-            qWarning().noquote() <<
+            qCWarning(Logging::serialization).noquote() <<
                "IGNORING the following parse error because" << ii->reasonToIgnore << ":\n   " << fullErrorMessage;
             return true;
          }
@@ -149,7 +192,7 @@ bool BtDomErrorHandler::handleError(xercesc::DOMError const & domError) {
    //
    // Other errors get logged as such and cause us to stop processing the document
    //
-   qCritical() << fullErrorMessage;
+   qCCritical(Logging::serialization) << fullErrorMessage;
    this->pimpl->lastError = shortErrorMessage;
    this->pimpl->couldntHandleError = true;
    return false;
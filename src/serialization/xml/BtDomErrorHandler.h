@@ -24,6 +24,7 @@
 #include <QVector>
 
 #include <xercesc/dom/DOMErrorHandler.hpp>
+#include <xercesc/sax/ErrorHandler.hpp>
 
 class QString;
 
@@ -36,8 +37,11 @@ class QString;
  *    further processing of the document,
  *  - apply any "corrections" needed the location of the error, which are required when we have made temporary
  *    modifications to the document being parsed (see comments elsewhere for why we would want to do this)
+ *
+ * We also implement xercesc::ErrorHandler, which is the equivalent interface for SAX parsing, so that the same rules
+ * apply when we validate a document by streaming it through a SAX parser rather than by building a DOM tree.
  */
-class BtDomErrorHandler: public xercesc::DOMErrorHandler {
+class BtDomErrorHandler: public xercesc::DOMErrorHandler, public xercesc::ErrorHandler {
 public:
    struct PatternAndReason {
       QString const regExMatchingErrorMessage;
@@ -86,7 +90,32 @@ public:
     */
    virtual bool handleError(xercesc::DOMError const & domError);
 
+   /**
+    * \brief SAX equivalents of \c handleError.  Errors we can't ignore are rethrown, as there is no other way to tell
+    *        the SAX parser to stop processing.
+    */
+   virtual void warning   (xercesc::SAXParseException const & saxParseException);
+   virtual void error     (xercesc::SAXParseException const & saxParseException);
+   virtual void fatalError(xercesc::SAXParseException const & saxParseException);
+   virtual void resetErrors();
+
 private:
+   /**
+    * \brief Common processing for DOM and SAX errors
+    *
+    * \return \c true if the error can be ignored, \c false otherwise
+    */
+   bool processError(char const * const severity,
+                     unsigned int const lineNumber,
+                     unsigned int const columnNumber,
+                     QString const & uri,
+                     QString const & message);
+
+   /**
+    * \brief Calls \c processError for a SAX error, and rethrows it if it can't be ignored
+    */
+   void processSaxError(char const * const severity, xercesc::SAXParseException const & saxParseException);
+
    // Private implementation details - see https://herbsutter.com/gotw/_100/
    class impl;
    std::unique_ptr<impl> pimpl;
@@ -18,6 +18,7 @@
 #pragma once
 
 #include <QString>
+#include <QStringView>
 
 #include <xercesc/util/Xerces_autoconf_config.hpp>
 #include <xalanc/PlatformSupport/PlatformSupportDefinitions.hpp>
@@ -36,6 +37,11 @@
  *
  * Xalan works pretty much the same way as Xerces, but has its own definitions (XalanDOMChar is the same as XMLCh) and
  * a proper string class (xalanc::XalanDOMString).
+ *
+ * Constructing an \c XQString copies the characters.  Where we only need to look at a string (eg to compare it, log it
+ * or map it to an enum), the static \c view functions give a \c QStringView onto the Xerces or Xalan buffer instead.
+ * As with any \c QStringView, it is only valid for as long as the buffer it views, which, for node names and values,
+ * is as long as the document.
  */
 class XQString : public QString {
 public:
@@ -56,6 +62,21 @@ public:
       return;
    }
 
+   /**
+    * Non-owning view of a Xerces null-terminated UTF-16 XMLCh string
+    */
+   static QStringView view(XMLCh const * xercesString) {
+      return QStringView{reinterpret_cast<QChar const *>(xercesString)};
+   }
+
+   /**
+    * Non-owning view of a Xalan string
+    */
+   static QStringView view(xalanc::XalanDOMString const & xalanString) {
+      return QStringView{reinterpret_cast<QChar const *>(xalanString.data()),
+                         static_cast<qsizetype>(xalanString.length())};
+   }
+
    /**
     * Return a pointer to a Xerces-friendly null-terminated UTF-16 string
     */
@@ -15,8 +15,14 @@
  ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
 #include "serialization/xml/XmlCoding.h"
 
+#include <atomic>
+#include <memory>
+#include <mutex>
+
 #include <QDebug>
 #include <QFile>
+#include <QIODevice>
+#include <QXmlStreamReader>
 
 #include <xercesc/dom/DOMConfiguration.hpp>
 #include <xercesc/dom/DOMDocument.hpp>
@@ -28,7 +34,12 @@
 #include <xercesc/framework/MemBufInputSource.hpp>
 #include <xercesc/framework/Wrapper4InputSource.hpp>
 #include <xercesc/framework/XMLGrammarPoolImpl.hpp>
+#include <xercesc/sax/InputSource.hpp>
 #include <xercesc/sax/SAXException.hpp>
+#include <xercesc/sax/SAXParseException.hpp>
+#include <xercesc/sax2/SAX2XMLReader.hpp>
+#include <xercesc/sax2/XMLReaderFactory.hpp>
+#include <xercesc/util/BinInputStream.hpp>
 #include <xercesc/util/PlatformUtils.hpp>
 #include <xercesc/util/XMLException.hpp>
 #include <xercesc/util/XMLUniDefs.hpp>
@@ -41,8 +52,10 @@
 #include <xalanc/XercesParserLiaison/XercesDOMSupport.hpp>
 #include <xalanc/XPath/XPathEvaluator.hpp>
 
+#include "Logging.h"
 #include "serialization/xml/BtDomDocumentOwner.h"
 #include "serialization/xml/XercesHelpers.h"
+#include "utils/ImportPhaseTimings.h"
 #include "utils/ImportRecordCount.h"
 
 //
@@ -94,6 +107,61 @@
 //
 
 
+namespace {
+   //! Number of times any XmlCoding has compiled its schema.  See \c XmlCoding::schemaCompilationCount.
+   std::atomic<int> schemaCompilations{0};
+
+   /**
+    * \brief Lets Xerces read directly from a \c QIODevice, so that we can validate a document without first reading it
+    *        all into memory.
+    */
+   class QIODeviceBinInputStream : public xercesc::BinInputStream {
+   public:
+      QIODeviceBinInputStream(QIODevice & device) : m_device{device} {
+         return;
+      }
+      virtual ~QIODeviceBinInputStream() = default;
+
+      virtual XMLFilePos curPos() const override {
+         return static_cast<XMLFilePos>(this->m_device.pos());
+      }
+
+      virtual XMLSize_t readBytes(XMLByte * const toFill, XMLSize_t const maxToRead) override {
+         qint64 const bytesRead = this->m_device.read(reinterpret_cast<char *>(toFill), static_cast<qint64>(maxToRead));
+         return bytesRead > 0 ? static_cast<XMLSize_t>(bytesRead) : 0;
+      }
+
+      virtual XMLCh const * getContentType() const override {
+         return nullptr;
+      }
+
+   private:
+      QIODevice & m_device;
+   };
+
+   class QIODeviceInputSource : public xercesc::InputSource {
+   public:
+      /**
+       * \param systemId As with \c xercesc::MemBufInputSource, this is just a name for the input, which will show up
+       *                 in error messages
+       */
+      QIODeviceInputSource(QIODevice & device, char const * const systemId) :
+         xercesc::InputSource{systemId},
+         m_device{device} {
+         return;
+      }
+      virtual ~QIODeviceInputSource() = default;
+
+      //! Caller owns the returned stream
+      virtual xercesc::BinInputStream * makeStream() const override {
+         return new QIODeviceBinInputStream{this->m_device};
+      }
+
+   private:
+      QIODevice & m_device;
+   };
+}
+
 //
 // Private implementation class for XmlCoding
 //
@@ -108,13 +176,14 @@ public:
         QString const schemaResource,
         XmlRecordDefinition const & rootRecordDefinition) :
       m_self{self},
-      m_initialised{false},
+      m_schemaLoaded{},
       m_name{name},
       m_schemaResource{schemaResource},
       m_rootRecordDefinition{rootRecordDefinition},
-    // grammarPool(xercesc::XMLPlatformUtils::fgMemoryManager),
+      m_grammarPool{nullptr},
       m_domImplementation{nullptr},
-      m_parser{nullptr} {
+      m_parser{nullptr},
+      m_saxReader{nullptr} {
       // We don't want to call loadSchema yet, as the main application will not have initialised Xerces and Xalan
       return;
    }
@@ -125,45 +194,13 @@ public:
    ~impl() = default;
 
    /**
-    * \brief Load in the schema(s) we're going to use for validating XML documents.
-    *
-    *        This is the complicated bit of using Xerces.  Once this is done, remaining usage is pretty
-    *        straightforward!
+    * \brief Create a DOM parser, with the settings we use for both loading schemas and parsing documents, that uses
+    *        our grammar pool.  Individual parsers are not thread-safe, but since the (locked) pool is, it's safe to use
+    *        separate parsers on different threads, and it's cheap to create a parser once the pool is populated.
     *
-    * \param schemaResource The XSD schema file to load in.  The expectation is that this has been compiled into the
-    *                       app as a Qt resource, so we don't need to bother with a lot of boilerplate error-handling
-    *                       for file permissions or file not found etc.
+    *        Caller is responsible for calling \c release() on the returned parser.
     */
-   void loadSchema(QString const & schemaResource) {
-      //
-      // See https://stackoverflow.com/questions/52275608/xerces-c-validate-xml-with-hardcoded-xsd and
-      // http://www.codesynthesis.com/~boris/blog/2010/03/15/validating-external-schemas-xerces-cxx/ (plus linked
-      // public-domain example code) for advice about using fixed application-determined XSDs rather than trying to pull
-      // them off the internet on the fly.
-      //
-      // The mysterious "features" parameter that we need to pass in to DOMImplementationRegistry::getDOMImplementation()
-      // come from W3C DOM specifications - see eg:
-      //  • https://www.w3.org/TR/DOM-Level-3-Core/introduction.html#ID-Conformance
-      //  • https://www.w3.org/TR/DOM-Level-2-Core/#introduction-ID-Conformance
-      // According to https://c-dev.xerces.apache.narkive.com/yF69tsO8/list-of-dom-implementation-features, Xerces
-      // implements the following features and levels thereof:
-      //  • "XML"
-      //  • "1.0"
-      //  • "2.0"
-      //  • "3.0"
-      //  • "Traversal"
-      //  • "Core"
-      //  • "Range"
-      //  • "LS" = Load and Save  (which means I think implements the "platform- and language-neutral interface" interface
-      //                           defined in DOM Level 3 (https://www.w3.org/TR/2004/REC-DOM-Level-3-LS-20040407/)
-      // In practice, since we are not extending Xerces (eg to parse other SGML-derived languages), I'm not sure how much
-      // it matters what features we request.  (The xercesc::DOMImplementation class inherits from
-      // xercesc::DOMImplementationLS for instance.)  Most of the easily-found example code seems to use "LS" (or
-      // sometimes "Range") but this is perhaps because "LS" is the shortest!
-      //
-      XQString const features("LS");
-      this->m_domImplementation = xercesc::DOMImplementationRegistry::getDOMImplementation(features.getXercesString());
-
+   xercesc::DOMLSParser * createParser() const {
       //
       // According to https://xerces.apache.org/xerces-c/program-dom-3.html, DOMLSParser is a new interface introduced by
       // the W3C DOM Level 3.0 Load and Save Specification.  DOMLSParser provides the "Load" interface for parsing XML
@@ -179,11 +216,15 @@ public:
       // other schema language).   Since we completely control the schemas we're using, there seems little benefit in
       // trying to specify such restrictions here.
       //
-      this->m_parser =
+      // The last parameter is the grammar pool into which loadSchema loads the compiled schema.  We supply our own
+      // (rather than let each parser create one internally) so that all our parsers, and the SAX reader we create in
+      // loadSchemaForSaxReader, can share it instead of compiling the schema each time.
+      //
+      xercesc::DOMLSParser * parser =
          this->m_domImplementation->createLSParser(xercesc::DOMImplementationLS::MODE_SYNCHRONOUS,
-                                                   nullptr  /*,
-                                                   xercesc::XMLPlatformUtils::fgMemoryManager, .:TBD:. Shall we reenable the grammar pool stuff?
-                                                   &this->grammarPool*/);
+                                                   nullptr,
+                                                   xercesc::XMLPlatformUtils::fgMemoryManager,
+                                                   this->m_grammarPool);
 
       //
       // See https://xerces.apache.org/xerces-c/program-dom-3.html for full details of these config options
@@ -210,7 +251,7 @@ public:
       // anything but will cause a subsequent error of "implementation does not support the requested type of object or
       // operation" when you, say, try to parse a document.
       //
-      xercesc::DOMConfiguration * config = this->m_parser->getDomConfig();
+      xercesc::DOMConfiguration * config = parser->getDomConfig();
 
       // "comments" - false = Discard Comment nodes in document
       config->setParameter(xercesc::XMLUni::fgDOMComments, false);
@@ -263,6 +304,72 @@ public:
       // Xerces functionality from Xalan.
       config->setParameter(xercesc::XMLUni::fgXercesDOMHasPSVIInfo, true);
 
+      // "http://apache.org/xml/features/validation/use-cachedGrammarInParse"
+      // true = Use cached grammar if it exists in the pool
+      // (This and the next setting only affect parsing documents, not loading the schema in loadSchema.)
+      config->setParameter(xercesc::XMLUni::fgXercesUseCachedGrammarInParse, true);
+
+      // "http://apache.org/xml/features/validating/load-schema"
+      // false = Don't load the schema if it wasn't found in the grammar pool, ie don't load schemas from any other
+      //         source (e.g., from XML document's xsi:schemaLocation attributes).
+      config->setParameter(xercesc::XMLUni::fgXercesLoadSchema, false);
+
+      // "http://apache.org/xml/features/dom/user-adopts-DOMDocument"
+      // true = The caller will adopt the DOMDocument that is returned from the parse method and thus is responsible to
+      //        call xercesc::DOMDocument::release() to release the associated memory. The parser will not release it.
+      //        The ownership is transferred from the parser to the caller.
+      //
+      // The reason for setting this to true is that we release the parser as soon as we have parsed the document, but
+      // we want to hang on to the document until we have finished loading from it.
+      config->setParameter(xercesc::XMLUni::fgXercesUserAdoptsDOMDocument, true);
+
+      return parser;
+   }
+
+   /**
+    * \brief Load in the schema(s) we're going to use for validating XML documents.
+    *
+    *        This is the complicated bit of using Xerces.  Once this is done, remaining usage is pretty
+    *        straightforward!
+    *
+    * \param schemaResource The XSD schema file to load in.  The expectation is that this has been compiled into the
+    *                       app as a Qt resource, so we don't need to bother with a lot of boilerplate error-handling
+    *                       for file permissions or file not found etc.
+    */
+   void loadSchema(QString const & schemaResource) {
+      //
+      // See https://stackoverflow.com/questions/52275608/xerces-c-validate-xml-with-hardcoded-xsd and
+      // http://www.codesynthesis.com/~boris/blog/2010/03/15/validating-external-schemas-xerces-cxx/ (plus linked
+      // public-domain example code) for advice about using fixed application-determined XSDs rather than trying to pull
+      // them off the internet on the fly.
+      //
+      // The mysterious "features" parameter that we need to pass in to DOMImplementationRegistry::getDOMImplementation()
+      // come from W3C DOM specifications - see eg:
+      //  • https://www.w3.org/TR/DOM-Level-3-Core/introduction.html#ID-Conformance
+      //  • https://www.w3.org/TR/DOM-Level-2-Core/#introduction-ID-Conformance
+      // According to https://c-dev.xerces.apache.narkive.com/yF69tsO8/list-of-dom-implementation-features, Xerces
+      // implements the following features and levels thereof:
+      //  • "XML"
+      //  • "1.0"
+      //  • "2.0"
+      //  • "3.0"
+      //  • "Traversal"
+      //  • "Core"
+      //  • "Range"
+      //  • "LS" = Load and Save  (which means I think implements the "platform- and language-neutral interface" interface
+      //                           defined in DOM Level 3 (https://www.w3.org/TR/2004/REC-DOM-Level-3-LS-20040407/)
+      // In practice, since we are not extending Xerces (eg to parse other SGML-derived languages), I'm not sure how much
+      // it matters what features we request.  (The xercesc::DOMImplementation class inherits from
+      // xercesc::DOMImplementationLS for instance.)  Most of the easily-found example code seems to use "LS" (or
+      // sometimes "Range") but this is perhaps because "LS" is the shortest!
+      //
+      XQString const features("LS");
+      this->m_domImplementation = xercesc::DOMImplementationRegistry::getDOMImplementation(features.getXercesString());
+
+      this->m_grammarPool = new xercesc::XMLGrammarPoolImpl(xercesc::XMLPlatformUtils::fgMemoryManager);
+      this->m_parser = this->createParser();
+      xercesc::DOMConfiguration * config = this->m_parser->getDomConfig();
+
       BtDomErrorHandler domErrorHandler;
       config->setParameter(xercesc::XMLUni::fgDOMErrorHandler, &domErrorHandler);
 
@@ -270,18 +377,18 @@ public:
       if (!schemaFile.open(QIODevice::ReadOnly)) {
          // This should pretty much never happen, as we're loading from a QResource compiled into the binary rather
          // than reading from the file system at run-time.
-         qCritical() <<
+         qCCritical(Logging::serialization) <<
             Q_FUNC_INFO << "Could not open schema file resource " << schemaFile.fileName() << " for reading";
          throw std::runtime_error("Could not open schema file resource");
       }
 
       QByteArray schemaData = schemaFile.readAll();
-      qDebug() <<
+      qCDebug(Logging::serialization) <<
          Q_FUNC_INFO << "Schema file " << schemaFile.fileName() << ": " << schemaData.length() << " bytes";
 
       // Don't want qDebug to escape newlines, as there will be lots in the list of parameter settings, hence
       // ".noquote()" here.
-      qDebug().noquote() <<
+      qCDebug(Logging::serialization).noquote() <<
          Q_FUNC_INFO << "Settings for reading schema file " << schemaFile.fileName() << ": " <<
          XercesHelpers::getParameterSettings(*config);
 
@@ -305,44 +412,67 @@ public:
                                                              true);
       if (!grammar) {
          // As above, this shouldn't happen "in production" as it's our own schema file, so we should make it parseable
-         qCritical() << Q_FUNC_INFO << "Unable to parse schema " << schemaFile.fileName();
+         qCCritical(Logging::serialization) << Q_FUNC_INFO << "Unable to parse schema " << schemaFile.fileName();
          throw std::runtime_error("Unable to parse schema -- see log file for more details");
       }
 
       if (domErrorHandler.failed()) {
-         qCritical() << Q_FUNC_INFO << "Error parsing schema " << schemaFile.fileName();
+         qCCritical(Logging::serialization) << Q_FUNC_INFO << "Error parsing schema " << schemaFile.fileName();
          throw std::runtime_error("Error parsing schema -- see log file for more details");
       }
 
+      ++schemaCompilations;
+
       xercesc::Grammar * rootGrammar = this->m_parser->getRootGrammar();
 
-      qDebug() <<
+      qCDebug(Logging::serialization) <<
          Q_FUNC_INFO << "Schema " << schemaFile.fileName() << " loaded OK.  Grammar:" << grammar << ", root grammar:" <<
          rootGrammar;
 
-      // "http://apache.org/xml/features/validation/use-cachedGrammarInParse"
-      // true = Use cached grammar if it exists in the pool
-      config->setParameter(xercesc::XMLUni::fgXercesUseCachedGrammarInParse, true);
+      this->loadSchemaForSaxReader();
 
-      // "http://apache.org/xml/features/validating/load-schema"
-      // false = Don't load the schema if it wasn't found in the grammar pool, ie don't load schemas from any other
-      //         source (e.g., from XML document's xsi:schemaLocation attributes).
-      config->setParameter(xercesc::XMLUni::fgXercesLoadSchema, false);
+      // We're not planning any modifications to the pool after this, and locking it means it can safely be used from
+      // more than one parser (and thread) at once.
+      this->m_grammarPool->lockPool();
 
-      // "http://apache.org/xml/features/dom/user-adopts-DOMDocument"
-      // true = The caller will adopt the DOMDocument that is returned from the parse method and thus is responsible to
-      //        call xercesc::DOMDocument::release() to release the associated memory. The parser will not release it.
-      //        The ownership is transferred from the parser to the caller.
-      //
-      // The reason for setting this to true is that we reuse the parser, so we don't want to wait until its destructor
-      // is called for all the DOMDocument objects to be released.
-      config->setParameter(xercesc::XMLUni::fgXercesUserAdoptsDOMDocument, true);
+      return;
+   }
 
+   /**
+    * \brief Set up the SAX reader we use to validate large documents without building a DOM tree for them.  This uses
+    *        the grammar pool that \c loadSchema has loaded the schema into and, as far as possible, the same
+    *        settings as the DOM parser.  (SAX2 "features" have the same names as the corresponding DOM parameters,
+    *        though there is no SAX equivalent of some of the DOM ones, eg "comments", which are only about what goes in
+    *        the DOM tree.)
+    */
+   void loadSchemaForSaxReader() {
+      this->m_saxReader = xercesc::XMLReaderFactory::createXMLReader(xercesc::XMLPlatformUtils::fgMemoryManager,
+                                                                     this->m_grammarPool);
+      this->m_saxReader->setFeature(xercesc::XMLUni::fgSAX2CoreNameSpaces           , true );
+      this->m_saxReader->setFeature(xercesc::XMLUni::fgSAX2CoreValidation           , true );
+      this->m_saxReader->setFeature(xercesc::XMLUni::fgXercesDynamic                , false);
+      this->m_saxReader->setFeature(xercesc::XMLUni::fgXercesSchema                 , true );
+      this->m_saxReader->setFeature(xercesc::XMLUni::fgXercesSchemaFullChecking     , false);
+      this->m_saxReader->setFeature(xercesc::XMLUni::fgXercesHandleMultipleImports  , true );
+      this->m_saxReader->setFeature(xercesc::XMLUni::fgXercesUseCachedGrammarInParse, true );
+      this->m_saxReader->setFeature(xercesc::XMLUni::fgXercesLoadSchema             , false);
       return;
    }
 
    /**
-    * \brief Validate XML file against schema, then call other functions to load its contents and store them in the DB
+    * \brief Compile the schema if we haven't already.  This is safe to call from multiple threads, and the schema is
+    *        only ever compiled once per \c XmlCoding (ie once per session, as each coding is a singleton).
+    */
+   void ensureSchemaLoaded() {
+      // If loadSchema throws, the flag is not set, and the next caller will try again
+      std::call_once(this->m_schemaLoaded, [this]() { this->loadSchema(this->m_schemaResource); return; });
+      return;
+   }
+
+   /**
+    * \brief Validate XML file against schema.  This can safely be called from any thread, including for several
+    *        documents at once, as each call uses its own parser (sharing the compiled schema in the locked grammar
+    *        pool).
     *
     * \param documentData The contents of the XML file, which the caller should already have loaded into memory
     * \param fileName Used only for logging / error message
@@ -354,33 +484,26 @@ public:
     * \param userMessage Any message that we want the top-level caller to display to the user (either about an error
     *                    or, in the event of success, summarising what was read in) should be appended to this string.
     *
-    * \return true if file validated OK (including if there were "errors" that we can safely ignore)
-    *         false if there was a problem that means it's not worth trying to read in the data from the file
+    * \return The parsed document if file validated OK (including if there were "errors" that we can safely ignore)
+    *         \c nullptr if there was a problem that means it's not worth trying to read in the data from the file
     */
-   bool validateLoadAndStoreInDb(QByteArray const & documentData,
-                                 QString const & fileName,
-                                 BtDomErrorHandler & domErrorHandler,
-                                 QTextStream & userMessage) {
-      if (!m_initialised) {
-         this->loadSchema(m_schemaResource);
-         m_initialised = true;
-      }
+   std::shared_ptr<BtDomDocumentOwner> validate(QByteArray const & documentData,
+                                                QString const & fileName,
+                                                BtDomErrorHandler & domErrorHandler,
+                                                QTextStream & userMessage) {
+      this->ensureSchemaLoaded();
+
+      xercesc::DOMLSParser * parser = this->createParser();
 
       // See https://www.codesynthesis.com/pipermail/xsd-users/2010-April/002805.html for list of all exceptions Xerces
       // can throw.
       try {
-         // Probably not 100% necessary to lock the pool against modifications, as we're not planning any after start-up, but...
-         //this->grammarPool.lockPool();
-
-         /// TBD probably need to lock other things here ///
-
-
-         xercesc::DOMConfiguration * config = this->m_parser->getDomConfig();
+         xercesc::DOMConfiguration * config = parser->getDomConfig();
          config->setParameter(xercesc::XMLUni::fgDOMErrorHandler, &domErrorHandler);
 
          // Don't want qDebug to escape newlines, as there will be lots in the list of parameter settings, hence
          // ".noquote()" here.
-         qDebug().noquote() <<
+         qCDebug(Logging::serialization).noquote() <<
             Q_FUNC_INFO << "Settings for reading input " << fileName << ": " << XercesHelpers::getParameterSettings(*config);
 
          QByteArray fileNameAsCString = fileName.toLocal8Bit();
@@ -393,50 +516,57 @@ public:
 
          xercesc::Wrapper4InputSource documentAsDOMLSInput{&documentAsInputSource, false};
 
-
          // The BtDomDocumentOwner object will, in its destructor, handle telling Xerces to release resources related
-         // to the document
-         // std::shared_ptr<BtDomDocumentOwner> domDocumentOwner{new BtDomDocumentOwner{this->m_parser->parse(&documentAsDOMLSInput)}}
-         BtDomDocumentOwner domDocumentOwner{this->m_parser->parse(&documentAsDOMLSInput)};
+         // to the document.  Because we set fgXercesUserAdoptsDOMDocument in createParser, the document outlives the
+         // parser.
+         xercesc::DOMDocument * domDocument = nullptr;
+         {
+            // With schema validation turned on, Xerces validates as it parses, so we time the two together
+            ImportPhaseTimings::ScopedTimer validationTimer{ImportPhaseTimings::Phase::Validation};
+            domDocument = parser->parse(&documentAsDOMLSInput);
+         }
+         auto domDocumentOwner = std::make_shared<BtDomDocumentOwner>(domDocument);
+         parser->release();
+         parser = nullptr;
 
          bool parsedOk = !domErrorHandler.failed();
-         qDebug() << Q_FUNC_INFO << "Parse of input file " << fileName << (parsedOk ? "succeeded" : "FAILED");
+         qCDebug(Logging::serialization) <<
+            Q_FUNC_INFO << "Parse of input file " << fileName << (parsedOk ? "succeeded" : "FAILED");
 
          if (!parsedOk) {
             userMessage << domErrorHandler.getlastError();
-            return false;
+            return nullptr;
          }
 
-         if (nullptr == domDocumentOwner.getDomDocument()) {
+         if (nullptr == domDocumentOwner->getDomDocument()) {
             //
             // This really should never happen.  Xerces is only supposed to return null from parse() if it in
             // asynchronous mode (which it shouln't be).
             //
-            qCritical() << Q_FUNC_INFO << "Got null pointer back from document parse!";
-            userMessage << tr("Internal Error! (Document parse returned null pointer.)");
-            return false;
+            qCCritical(Logging::serialization) << Q_FUNC_INFO << "Got null pointer back from document parse!";
+            userMessage << XmlCoding::tr("Internal Error! (Document parse returned null pointer.)");
+            return nullptr;
          }
 
-         // If we got this far, the validation has succeeded, and we can now proceed to loading
-         return this->loadValidated(domDocumentOwner.getDomDocument(), userMessage);
+         return domDocumentOwner;
 
       } catch(const std::exception& se) {
-         qCritical() << Q_FUNC_INFO << "Caught std::exception: " << se.what();
+         qCCritical(Logging::serialization) << Q_FUNC_INFO << "Caught std::exception: " << se.what();
          userMessage << "Caught std::exception: " << se.what();
       } catch (const xercesc::XMLException & xe) {
          unsigned int lineNumberOfError = domErrorHandler.correctErrorLine(xe.getSrcLine());
-         qCritical() <<
+         qCCritical(Logging::serialization) <<
             Q_FUNC_INFO << "Caught xerces::XMLException at line " << lineNumberOfError << ": " <<
             XQString(xe.getType()) << ": " << XQString(xe.getMessage());
          userMessage <<
             "XMLException at line " << lineNumberOfError << ": " << XQString(xe.getType())  << ": " <<
             XQString(xe.getMessage());
       } catch (const xercesc::DOMException & de) {
-         qCritical() <<
+         qCCritical(Logging::serialization) <<
             Q_FUNC_INFO << "Caught xerces::DOMException #" << de.code << ": " << XQString(de.getMessage());
          userMessage << "DOMException #" << de.code << ": " << XQString(de.getMessage());
       } catch (const xercesc::SAXException & se) {
-         qCritical() <<
+         qCCritical(Logging::serialization) <<
             Q_FUNC_INFO << "Caught xerces::SAXException: " << XQString(se.getMessage());
 
          userMessage << "SAXException: " << XQString(se.getMessage());
@@ -444,7 +574,154 @@ public:
       //
       // If we reach here it's because we caught an exception
       //
-      return false;
+      if (parser) {
+         parser->release();
+      }
+      return nullptr;
+   }
+
+   /**
+    * \brief Load the contents of a document that has been through \c validate and store them in the DB.  Unlike
+    *        \c validate, this must be called from the GUI thread, as it creates model objects.
+    */
+   bool loadAndStoreInDb(BtDomDocumentOwner & domDocumentOwner, QTextStream & userMessage) {
+      Q_ASSERT(domDocumentOwner.getDomDocument());
+      return this->loadValidated(domDocumentOwner.getDomDocument(), userMessage);
+   }
+
+   /**
+    * \brief Validate XML file against schema, then call other functions to load its contents and store them in the DB
+    *
+    *        Parameters and return value are as for \c validate
+    */
+   bool validateLoadAndStoreInDb(QByteArray const & documentData,
+                                 QString const & fileName,
+                                 BtDomErrorHandler & domErrorHandler,
+                                 QTextStream & userMessage) {
+      auto domDocumentOwner = this->validate(documentData, fileName, domErrorHandler, userMessage);
+      if (!domDocumentOwner) {
+         return false;
+      }
+
+      // If we got this far, the validation has succeeded, and we can now proceed to loading
+      return this->loadAndStoreInDb(*domDocumentOwner, userMessage);
+   }
+
+   /**
+    * \brief Streaming alternative to the above for documents too large to comfortably hold in memory (particularly as
+    *        the DOM tree takes up several times the size of the document itself).  This makes two passes over the
+    *        document: first, we validate it with a SAX reader (so that, as above, we don't store anything from an
+    *        invalid document); then we load it with a pull parser, storing each top-level record in the DB as soon as
+    *        it has been read.
+    *
+    * \param document The XML document, which must be open for reading and must not be sequential (as we need to go
+    *                 back to the start for the second pass)
+    *
+    * Other parameters and return value are as for the version above
+    */
+   bool validateLoadAndStoreInDb(QIODevice & document,
+                                 QString const & fileName,
+                                 BtDomErrorHandler & domErrorHandler,
+                                 QTextStream & userMessage) {
+      this->ensureSchemaLoaded();
+
+      // It's a coding error to supply a device we can't rewind
+      Q_ASSERT(document.isReadable() && !document.isSequential());
+      qint64 const startOfDocument = document.pos();
+
+      try {
+         QByteArray fileNameAsCString = fileName.toLocal8Bit();
+         QIODeviceInputSource documentAsInputSource{document, fileNameAsCString.constData()};
+         this->m_saxReader->setErrorHandler(&domErrorHandler);
+         {
+            ImportPhaseTimings::ScopedTimer validationTimer{ImportPhaseTimings::Phase::Validation};
+            this->m_saxReader->parse(documentAsInputSource);
+         }
+         this->m_saxReader->setErrorHandler(nullptr);
+      } catch (const xercesc::SAXParseException & spe) {
+         // BtDomErrorHandler throws these for errors that we can't ignore, having already logged them
+         this->m_saxReader->setErrorHandler(nullptr);
+         if (!domErrorHandler.failed()) {
+            qCCritical(Logging::serialization) <<
+               Q_FUNC_INFO << "Caught xerces::SAXParseException: " << XQString(spe.getMessage());
+            userMessage << "SAXParseException: " << XQString(spe.getMessage());
+            return false;
+         }
+      } catch (const std::exception & se) {
+         this->m_saxReader->setErrorHandler(nullptr);
+         qCCritical(Logging::serialization) << Q_FUNC_INFO << "Caught std::exception: " << se.what();
+         userMessage << "Caught std::exception: " << se.what();
+         return false;
+      } catch (const xercesc::XMLException & xe) {
+         this->m_saxReader->setErrorHandler(nullptr);
+         unsigned int lineNumberOfError = domErrorHandler.correctErrorLine(xe.getSrcLine());
+         qCCritical(Logging::serialization) <<
+            Q_FUNC_INFO << "Caught xerces::XMLException at line " << lineNumberOfError << ": " <<
+            XQString(xe.getType()) << ": " << XQString(xe.getMessage());
+         userMessage <<
+            "XMLException at line " << lineNumberOfError << ": " << XQString(xe.getType())  << ": " <<
+            XQString(xe.getMessage());
+         return false;
+      } catch (const xercesc::SAXException & se) {
+         this->m_saxReader->setErrorHandler(nullptr);
+         qCCritical(Logging::serialization) <<
+            Q_FUNC_INFO << "Caught xerces::SAXException: " << XQString(se.getMessage());
+         userMessage << "SAXException: " << XQString(se.getMessage());
+         return false;
+      }
+
+      bool const validatedOk = !domErrorHandler.failed();
+      qCDebug(Logging::serialization) <<
+         Q_FUNC_INFO << "Validation of input file " << fileName << (validatedOk ? "succeeded" : "FAILED");
+      if (!validatedOk) {
+         userMessage << domErrorHandler.getlastError();
+         return false;
+      }
+
+      //
+      // Now we know the document is valid, we can go back to the start and read it in
+      //
+      if (!document.seek(startOfDocument)) {
+         qCCritical(Logging::serialization) <<
+            Q_FUNC_INFO << "Unable to return to start of " << fileName << ":" << document.errorString();
+         userMessage << XmlCoding::tr("Contents of file were not readable");
+         return false;
+      }
+      QXmlStreamReader reader{&document};
+      if (!reader.readNextStartElement()) {
+         qCCritical(Logging::serialization) << Q_FUNC_INFO << "Couldn't find any elements in the document!";
+         userMessage << XmlCoding::tr("Contents of file were not readable");
+         return false;
+      }
+      if (reader.name() != QLatin1String(*this->m_rootRecordDefinition.m_recordName)) {
+         qCCritical(Logging::serialization) <<
+            Q_FUNC_INFO << "First element in document was not the one we inserted!  Found " << reader.name() <<
+            "instead of" << this->m_rootRecordDefinition.m_recordName;
+         userMessage << XmlCoding::tr("Could not understand file format");
+         return false;
+      }
+
+      XmlRecord rootRecord{this->m_self, this->m_rootRecordDefinition};
+      ImportRecordCount stats;
+      bool const loadedOk = rootRecord.loadNormaliseAndStoreInDb(reader, userMessage, stats);
+      if (reader.hasError()) {
+         // This shouldn't happen, as the document has already been through the SAX reader
+         unsigned int const lineNumberOfError =
+            domErrorHandler.correctErrorLine(static_cast<unsigned int>(reader.lineNumber()));
+         qCCritical(Logging::serialization) <<
+            Q_FUNC_INFO << "Error reading " << fileName << " at line " << lineNumberOfError << ": " <<
+            reader.errorString();
+         userMessage << "Error at line " << lineNumberOfError << ": " << reader.errorString();
+         return false;
+      }
+      if (!loadedOk) {
+         if (stats.isCancelled()) {
+            stats.rollBack(userMessage);
+         }
+         return false;
+      }
+
+      return stats.writeToUserMessage(userMessage);
    }
 
    /**
@@ -478,13 +755,13 @@ public:
       //
       xalanc::XalanNode * rootNode = xalanDocument->getFirstChild();
       if (nullptr == rootNode) {
-         qCritical() << Q_FUNC_INFO << "Couldn't find any nodes in the document!";
+         qCCritical(Logging::serialization) << Q_FUNC_INFO << "Couldn't find any nodes in the document!";
          userMessage << XmlCoding::tr("Contents of file were not readable");
          return false;
       }
-      XQString firstChildName{rootNode->getNodeName()};
-      if (firstChildName != "BEER_XML") {
-         qCritical() <<
+      QStringView const firstChildName = XQString::view(rootNode->getNodeName());
+      if (firstChildName != QStringView{u"BEER_XML"}) {
+         qCCritical(Logging::serialization) <<
             Q_FUNC_INFO << "First node in document was not the one we inserted!  Found " << firstChildName <<
             "instead of BEER_XML";
          userMessage << XmlCoding::tr("Could not understand file format");
@@ -507,26 +784,35 @@ public:
                                   xalanc::XalanNode * rootNode,
                                   QTextStream & userMessage) const {
 
-      XQString rootNodeName{rootNode->getNodeName()};
-      qDebug() << Q_FUNC_INFO << "Processing root node: " << rootNodeName;
+      QStringView const rootNodeName = XQString::view(rootNode->getNodeName());
+      qCDebug(Logging::serialization) << Q_FUNC_INFO << "Processing root node: " << rootNodeName;
 
       //
       // Look at the root object first
       //
       XmlRecord rootRecord{this->m_self, this->m_rootRecordDefinition};
-      qDebug() <<
+      qCDebug(Logging::serialization) <<
          Q_FUNC_INFO << "Looking at field definitions of root element (" << this->m_rootRecordDefinition.m_recordName << ")";
 
       ImportRecordCount stats;
 
-      if (!rootRecord.load(domSupport, rootNode, userMessage)) {
-         return false;
+      {
+         ImportPhaseTimings::ScopedTimer loadTimer{ImportPhaseTimings::Phase::Load};
+         if (!rootRecord.load(domSupport, rootNode, userMessage)) {
+            return false;
+         }
       }
 
       // At the root level, Succeeded and FoundDuplicate are both OK return values.  It's only Failed that indicates an
       // error (rather than in info) message for the user in userMessage.
-      if (XmlRecord::ProcessingResult::Failed == rootRecord.normaliseAndStoreInDb(nullptr, userMessage, stats)) {
-         return false;
+      {
+         ImportPhaseTimings::ScopedTimer storeTimer{ImportPhaseTimings::Phase::NormaliseAndStoreInDb};
+         if (XmlRecord::ProcessingResult::Failed == rootRecord.normaliseAndStoreInDb(nullptr, userMessage, stats)) {
+            if (stats.isCancelled()) {
+               stats.rollBack(userMessage);
+            }
+            return false;
+         }
       }
 
       // Everything went OK - unless we found no content to read.
@@ -537,7 +823,7 @@ public:
 
    // =========================================== Member variables for impl ============================================
    XmlCoding & m_self;
-   bool m_initialised;
+   std::once_flag m_schemaLoaded;
    QString const m_name;
    QString const m_schemaResource;
    XmlRecordDefinition const & m_rootRecordDefinition;
@@ -546,14 +832,19 @@ public:
    // Xerces.  However, since Xerces 3.0.0 release, it is now part of the public API -- see
    // https://xerces.apache.org/xerces-c/migrate-archive-3.html#NewAPI300
    //
-   // NB: For the moment, this is commented out as I think we don't need it.  If we want to play around with it more
-   //     then we need to be careful about ensuring it is destructed before the Xerces & Xalan libraries are terminated
-   //     in main().
+   // This holds the compiled schema, shared by m_parser and m_saxReader.  As with them, we don't delete it, as that
+   // would need to happen before the Xerces & Xalan libraries are terminated in main().
    //
-   // xercesc::XMLGrammarPoolImpl grammarPool;
+   xercesc::XMLGrammarPoolImpl * m_grammarPool;
 
    xercesc::DOMImplementation * m_domImplementation;
    xercesc::DOMLSParser * m_parser;
+
+   //
+   // Used for validating large documents.  As with m_parser, we don't delete this, as that would need to happen before
+   // Xerces is terminated in main().
+   //
+   xercesc::SAX2XMLReader * m_saxReader;
 };
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -575,9 +866,31 @@ XmlRecordDefinition const & XmlCoding::getRoot() const {
    return this->pimpl->m_rootRecordDefinition;
 }
 
+std::shared_ptr<BtDomDocumentOwner> XmlCoding::validate(QByteArray const & documentData,
+                                                       QString const & fileName,
+                                                       BtDomErrorHandler & domErrorHandler,
+                                                       QTextStream & userMessage) const {
+   return this->pimpl->validate(documentData, fileName, domErrorHandler, userMessage);
+}
+
+bool XmlCoding::loadAndStoreInDb(BtDomDocumentOwner & domDocumentOwner, QTextStream & userMessage) const {
+   return this->pimpl->loadAndStoreInDb(domDocumentOwner, userMessage);
+}
+
 bool XmlCoding::validateLoadAndStoreInDb(QByteArray const & documentData,
                                          QString const & fileName,
                                          BtDomErrorHandler & domErrorHandler,
                                          QTextStream & userMessage) const {
    return this->pimpl->validateLoadAndStoreInDb(documentData, fileName, domErrorHandler, userMessage);
 }
+
+bool XmlCoding::validateLoadAndStoreInDb(QIODevice & document,
+                                         QString const & fileName,
+                                         BtDomErrorHandler & domErrorHandler,
+                                         QTextStream & userMessage) const {
+   return this->pimpl->validateLoadAndStoreInDb(document, fileName, domErrorHandler, userMessage);
+}
+
+int XmlCoding::schemaCompilationCount() {
+   return schemaCompilations;
+}
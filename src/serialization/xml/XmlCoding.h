@@ -19,6 +19,7 @@
 
 #include <memory> // For smart pointers
 #include <QHash>
+#include <QIODevice>
 #include <QObject>
 #include <QString>
 #include <QTextStream>
@@ -27,6 +28,7 @@
 #include <xalanc/DOMSupport/DOMSupport.hpp>
 #include <xalanc/XalanDOM/XalanNode.hpp>
 
+#include "serialization/xml/BtDomDocumentOwner.h"
 #include "serialization/xml/BtDomErrorHandler.h"
 #include "serialization/xml/XmlRecord.h"
 #include "serialization/xml/XmlNamedEntityRecord.h"
@@ -144,6 +146,33 @@ public:
     */
    XmlRecordDefinition const & getRoot() const;
 
+   /**
+    * \brief How many times, in this session, any \c XmlCoding has compiled its XML Schema.  Each coding compiles its
+    *        schema (lazily) on first use and then reuses it for every subsequent document, so this should never be
+    *        more than the number of codings.
+    */
+   static int schemaCompilationCount();
+
+   /**
+    * \brief Validate XML file against schema without loading anything from it.  Unlike the functions below, this is
+    *        safe to call from any thread (including for several documents at once), so that the expensive parsing and
+    *        validation of a document can happen off the GUI thread.  See \c ImportExport::importFromFiles.
+    *
+    *        Parameters are as for \c validateLoadAndStoreInDb.
+    *
+    * \return The parsed document, to pass to \c loadAndStoreInDb, if it validated OK, or \c nullptr otherwise
+    */
+   std::shared_ptr<BtDomDocumentOwner> validate(QByteArray const & documentData,
+                                                QString const & fileName,
+                                                BtDomErrorHandler & domErrorHandler,
+                                                QTextStream & userMessage) const;
+
+   /**
+    * \brief Load the contents of a document returned by \c validate into objects, and store them in the DB.  This
+    *        creates model objects, so must be called on the GUI thread.
+    */
+   bool loadAndStoreInDb(BtDomDocumentOwner & domDocumentOwner, QTextStream & userMessage) const;
+
    /**
     * \brief Validate XML file against schema, load its contents into objects, and store then in the DB
     *
@@ -165,6 +194,20 @@ public:
                                  BtDomErrorHandler & domErrorHandler,
                                  QTextStream & userMessage) const;
 
+   /**
+    * \brief As above, but reading the document from a device rather than memory, and without ever holding the whole
+    *        document (or a DOM tree of it) in memory.  This is slower (as it needs two passes over the document), so
+    *        is only worth using for large files.
+    *
+    * \param document The XML document, which must be open for reading and seekable
+    *
+    * Other parameters and return value are as for the version above
+    */
+   bool validateLoadAndStoreInDb(QIODevice & document,
+                                 QString const & fileName,
+                                 BtDomErrorHandler & domErrorHandler,
+                                 QTextStream & userMessage) const;
+
 private:
 
    // Private implementation details - see https://herbsutter.com/gotw/_100/
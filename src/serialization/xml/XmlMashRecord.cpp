@@ -15,6 +15,8 @@
  ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
 #include "serialization/xml/XmlMashRecord.h"
 
+#include "Logging.h"
+
 void XmlMashRecord::subRecordToXml(XmlRecordDefinition::FieldDefinition const & fieldDefinition,
                                    XmlRecord const & subRecord,
                                    NamedEntity const & namedEntityToExport,
@@ -45,6 +47,7 @@ void XmlMashRecord::setContainingEntity(std::shared_ptr<NamedEntity> containingE
    // Don't include Mash in stats is it's in a Recipe (ie if the cast below succeeds); DO include it if it's not (ie if
    // there's no containing entity or the cast below fails).
    this->m_includeInStats = (nullptr == dynamic_cast<Recipe *>(containingEntity.get()));
-   qDebug() << Q_FUNC_INFO << (this->m_includeInStats ? "Included in" : "Excluded from") << "stats";
+   qCDebug(Logging::serialization) <<
+      Q_FUNC_INFO << (this->m_includeInStats ? "Included in" : "Excluded from") << "stats";
    return;
 }
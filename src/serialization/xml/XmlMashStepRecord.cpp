@@ -14,6 +14,7 @@
  * <http://www.gnu.org/licenses/>.
  ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
 #include "serialization/xml/XmlMashStepRecord.h"
+#include "Logging.h"
 #include "model/Mash.h"
 
 XmlRecord::ProcessingResult XmlMashStepRecord::normaliseAndStoreInDb(std::shared_ptr<NamedEntity> containingEntity,
@@ -47,7 +48,7 @@ XmlRecord::ProcessingResult XmlMashStepRecord::normaliseAndStoreInDb(std::shared
    //
    auto mashStep = std::static_pointer_cast<MashStep>(this->m_namedEntity);
    if (0 == mashStep->name().length()) {
-      qWarning() << Q_FUNC_INFO << "Setting default name on unnamed MASH_STEP record";
+      qCWarning(Logging::serialization) << Q_FUNC_INFO << "Setting default name on unnamed MASH_STEP record";
       // Note that tr() is a static member function of QObject.  We do not inherit from QObject, but MashStep does
       // (via NamedEntity).
       mashStep->setName(QString(MashStep::tr("Unnamed Mash Step")));
@@ -60,7 +61,7 @@ XmlRecord::ProcessingResult XmlMashStepRecord::normaliseAndStoreInDb(std::shared
 }
 
 void XmlMashStepRecord::setContainingEntity(std::shared_ptr<NamedEntity> containingEntity) {
-   qDebug() <<
+   qCDebug(Logging::serialization) <<
       Q_FUNC_INFO << "Setting" << containingEntity->metaObject()->className() << "ID" << containingEntity->key() <<
       "on" << this->m_namedEntity->metaObject()->className() << "#" << this->m_namedEntity->key();
 
@@ -78,8 +79,12 @@ void XmlMashStepRecord::setContainingEntity(std::shared_ptr<NamedEntity> contain
    return;
 }
 
+bool XmlMashStepRecord::canStoreInBatch() const {
+   return false;
+}
+
 int XmlMashStepRecord::storeNamedEntityInDb() {
-   qDebug() <<
+   qCDebug(Logging::serialization) <<
       Q_FUNC_INFO << "Skipping store in DB as already done and MashStep has ID" << this->m_namedEntity->key() <<
       "and step number" << std::static_pointer_cast<MashStep>(this->m_namedEntity)->stepNumber();
    return this->m_namedEntity->key();
@@ -48,5 +48,11 @@ protected:
     */
    virtual int storeNamedEntityInDb();
 
+   /**
+    * \brief Mash steps have to be stored one at a time, in order, by \c Mash::addStep() (see
+    *        \c setContainingEntity()), so they can't be stored in a batch.
+    */
+   virtual bool canStoreInBatch() const;
+
 };
 #endif
@@ -18,6 +18,7 @@
 #include <cstring>
 #include <functional>
 
+#include "Logging.h"
 #include "model/Boil.h"
 #include "model/Equipment.h"
 #include "model/Fermentable.h"
@@ -210,6 +211,10 @@
 //}
 
 
+bool XmlRecipeRecord::canStoreInBatch() const {
+   return false;
+}
+
 XmlRecord::ProcessingResult XmlRecipeRecord::normaliseAndStoreInDb(std::shared_ptr<NamedEntity> containingEntity,
                                                                    QTextStream & userMessage,
                                                                    ImportRecordCount & stats) {
@@ -233,7 +238,8 @@ XmlRecord::ProcessingResult XmlRecipeRecord::normaliseAndStoreInDb(std::shared_p
       return result;
    }
 
-   qDebug() << Q_FUNC_INFO << "Final tidy up for Recipe #" << recipe->key() << "(" << recipe->name() << ")";
+   qCDebug(Logging::serialization) <<
+      Q_FUNC_INFO << "Final tidy up for Recipe #" << recipe->key() << "(" << recipe->name() << ")";
 
    //
    // We now need to tie some other things together
@@ -277,7 +283,8 @@ XmlRecord::ProcessingResult XmlRecipeRecord::normaliseAndStoreInDb(std::shared_p
       // This call will also ensure the boil gets saved in the DB
       recipe->setBoil(boil);
 
-      qDebug() << Q_FUNC_INFO << "Created Boil #" << boil->key() << "on Recipe #" << recipe->key();
+      qCDebug(Logging::serialization) <<
+         Q_FUNC_INFO << "Created Boil #" << boil->key() << "on Recipe #" << recipe->key();
    }
    if (this->m_namedParameterBundle.containsBundle(PropertyNames::Recipe::fermentation)) {
       // It's a coding error if the recipe already has a fermentation
@@ -296,7 +303,8 @@ XmlRecord::ProcessingResult XmlRecipeRecord::normaliseAndStoreInDb(std::shared_p
       // This call will also ensure the fermentation gets saved in the DB
       recipe->setFermentation(fermentation);
 
-      qDebug() << Q_FUNC_INFO << "Created Fermentation #" << fermentation->key() << "on Recipe #" << recipe->key();
+      qCDebug(Logging::serialization) <<
+         Q_FUNC_INFO << "Created Fermentation #" << fermentation->key() << "on Recipe #" << recipe->key();
 
       //
       // Now we handle RECIPE > PRIMARY_AGE / PRIMARY_TEMP / SECONDARY_AGE / SECONDARY_TEMP / TERTIARY_AGE /
@@ -309,7 +317,7 @@ XmlRecord::ProcessingResult XmlRecipeRecord::normaliseAndStoreInDb(std::shared_p
       //
       if (fermentationBundle.containsBundle(PropertyNames::Fermentation::primary)) {
          auto primaryBundle {fermentationBundle.getBundle(PropertyNames::Fermentation::primary)};
-         qDebug() << Q_FUNC_INFO << primaryBundle;
+         qCDebug(Logging::serialization) << Q_FUNC_INFO << primaryBundle;
          if (!primaryBundle.contains(PropertyNames::NamedEntity::name)) {
             primaryBundle.insert(PropertyNames::NamedEntity::name,
                                  QObject::tr("Primary Fermentation Step for %1").arg(recipe->name()));
@@ -407,7 +415,8 @@ void XmlRecipeRecord::subRecordToXml(XmlRecordDefinition::FieldDefinition const
    if (this->childrenToXml(fieldDefinition, subRecord, recipe, out, indentLevel, indentString, PropertyNames::Recipe::brewNotes           , &Recipe::brewNotes           )) { return; }
 
    // It's a coding error if we get here
-   qCritical() << Q_FUNC_INFO << "Don't know how to export Recipe property " << fieldDefinition.propertyPath.asXPath();
+   qCCritical(Logging::serialization) <<
+      Q_FUNC_INFO << "Don't know how to export Recipe property " << fieldDefinition.propertyPath.asXPath();
    Q_ASSERT(false); // Stop in a debug build
    return;          // Soldier on in a production build
 }
@@ -39,6 +39,11 @@ protected:
                                                              QTextStream & userMessage,
                                                              ImportRecordCount & stats);
 
+   /**
+    * \brief Because we override \c normaliseAndStoreInDb, recipes can't be stored in a batch
+    */
+   virtual bool canStoreInBatch() const;
+
    /**
     * \brief We need to override \c XmlRecord::propertiesToXml for similar reasons that we override
     *        \c normaliseAndStoreInDb()
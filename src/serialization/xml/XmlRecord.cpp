@@ -15,18 +15,23 @@
  ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
 #include "serialization/xml/XmlRecord.h"
 
+#include <algorithm>
+
 #include <QDate>
 #include <QDebug>
-#include <QXmlStreamWriter>
 
 #include <xalanc/XalanDOM/XalanNodeList.hpp>
 #include <xalanc/XPath/NodeRefList.hpp>
 #include <xalanc/XPath/XPathEvaluator.hpp>
 #include <xalanc/XalanDOM/XalanNamedNodeMap.hpp>
 
+#include "Logging.h"
 #include "serialization/xml/XmlCoding.h"
+#include "utils/ImportPhaseTimings.h"
 #include "utils/OptionalHelpers.h"
 #include "utils/ObjectAddressStringMapping.h"
+#include "utils/StringPool.h"
+#include "utils/Tracing.h"
 
 //
 // Variables and constant definitions that we need only in this file
@@ -53,6 +58,34 @@ namespace {
    /**
     * \brief Helper function for writing multiple indents
     */
+   /**
+    * \brief Escape "&" to "&amp;" and so on in string content, in one pass over the string.  This gives the same
+    *        result as \c QXmlStreamWriter::writeCharacters, but without the cost of constructing a \c QXmlStreamWriter
+    *        for each field we write.
+    */
+   QString escapeXmlText(QString const & text) {
+      QString escaped;
+      escaped.reserve(text.size());
+      for (QChar const cc : text) {
+         switch (cc.unicode()) {
+            case '<' : escaped.append(QLatin1String{"&lt;"  }); break;
+            case '>' : escaped.append(QLatin1String{"&gt;"  }); break;
+            case '&' : escaped.append(QLatin1String{"&amp;" }); break;
+            case '"' : escaped.append(QLatin1String{"&quot;"}); break;
+            case '\t':
+            case '\n':
+            case '\r': escaped.append(cc);                      break;
+            default  :
+               // Other control characters are not allowed in XML, so, like QXmlStreamWriter, we drop them
+               if (cc.unicode() > 0x1f && cc.unicode() < 0xfffe) {
+                  escaped.append(cc);
+               }
+               break;
+         }
+      }
+      return escaped;
+   }
+
    void writeIndents(QTextStream & out,
                      int indentLevel,
                      char const * const indentString) {
@@ -68,7 +101,8 @@ XmlRecord::XmlRecord(XmlCoding           const & xmlCoding,
    SerializationRecord{},
    m_coding{xmlCoding},
    m_recordDefinition{recordDefinition},
-   m_childRecordSets{} {
+   m_childRecordSets{},
+   m_streamedFields{} {
    return;
 }
 
@@ -77,6 +111,7 @@ XmlRecord::~XmlRecord() = default;
 bool XmlRecord::load(xalanc::DOMSupport & domSupport,
                      xalanc::XalanNode * rootNodeOfRecord,
                      QTextStream & userMessage) {
+   Tracing::Span span{"XmlRecord::load"};
    xalanc::XPathEvaluator xPathEvaluator;
    //
    // Loop through all the fields that we know/care about.  Anything else is intentionally ignored.  (We won't know
@@ -85,7 +120,7 @@ bool XmlRecord::load(xalanc::DOMSupport & domSupport,
    // Note that it's a coding error if there are no fields in the record definition.  (This usually means a template
    // specialisation was omitted in serialization/xml/BeerXml.cpp.)
    //
-   qDebug() <<
+   qCDebug(Logging::serialization) <<
       Q_FUNC_INFO << "Examining" << this->m_recordDefinition.fieldDefinitions.size() << "field definitions for" <<
       this->m_recordDefinition.m_recordName;
    Q_ASSERT(this->m_recordDefinition.fieldDefinitions.size() > 0);
@@ -165,7 +200,7 @@ bool XmlRecord::load(xalanc::DOMSupport & domSupport,
          // there are any though, we'll ignore them.
          //
          if (numChildNodes > 1) {
-            qWarning() <<
+            qCWarning(Logging::serialization) <<
                Q_FUNC_INFO << numChildNodes << " nodes found with path " << fieldDefinition.xPath << ".  Taking value "
                "only of the first one.";
          }
@@ -174,11 +209,11 @@ bool XmlRecord::load(xalanc::DOMSupport & domSupport,
          // Normally the node for the tag will be type ELEMENT_NODE and will not have a value in and of itself.
          // To get the "contents", we need to look at the value of the child node, which, for strings and numbers etc,
          // should be type TEXT_NODE (and name "#text").
-         XQString fieldName{fieldContainerNode->getNodeName()};
+         QStringView const fieldName = XQString::view(fieldContainerNode->getNodeName());
          xalanc::XalanNodeList const * fieldContents = fieldContainerNode->getChildNodes();
          int numChildrenOfContainerNode = fieldContents->getLength();
          // Normally keep this log statement commented out otherwise it generates too many lines in the log file
-         qDebug() <<
+         qCDebug(Logging::serialization) <<
             Q_FUNC_INFO << "Node " << fieldDefinition.xPath << "(" << fieldName << ":" <<
             XALAN_NODE_TYPES[fieldContainerNode->getNodeType()] << ") has " <<
             numChildrenOfContainerNode << " children";
@@ -193,314 +228,28 @@ bool XmlRecord::load(xalanc::DOMSupport & domSupport,
                if (numChildrenOfContainerNode > 1) {
                   // This is probably a coding error, as it would mean the XML node had child nodes, rather than just
                   // text content, which should have already generated an error during XSD validation.
-                  qWarning() <<
+                  qCWarning(Logging::serialization) <<
                      Q_FUNC_INFO << "Node " << fieldDefinition.xPath << " has " <<
                      numChildrenOfContainerNode << " children.  Taking value only of the first one.";
                }
                xalanc::XalanNode * valueNode = fieldContents->item(0);
-               XQString value(valueNode->getNodeValue());
+               QStringView const value = XQString::view(valueNode->getNodeValue());
                // Normally keep this log statement commented out otherwise it generates too many lines in the log file
 //               qDebug() << Q_FUNC_INFO << "Value " << value;
 
-               bool parsedValueOk = false;
-               QVariant parsedValue;
-
-               // A field should have an enumMapping if and only if it's of type Enum
-               // Anything else is a coding error at the caller
-               Q_ASSERT((XmlRecordDefinition::FieldType::Enum == fieldDefinition.type) ==
-                        std::holds_alternative<EnumStringMapping const *>(fieldDefinition.valueDecoder));
-
-               // Same applies for a unit field
-               Q_ASSERT((XmlRecordDefinition::FieldType::Unit == fieldDefinition.type) ==
-                        std::holds_alternative<Measurement::UnitStringMapping const *>(fieldDefinition.valueDecoder));
-
-               //
-               // We're going to need to know whether this field is "optional" in our internal data model.  If it is,
-               // then, for whatever underlying type T it is, we need the parsedValue QVariant to hold std::optional<T>
-               // instead of just T.
-               //
-               // (Note we can't do this mapping inside NamedParameterBundle, as we don't have the type information
-               // there.  We could conceivably do it in the constructors that take a NamedParameterBundle parameter, but
-               // I think it gets messy to have different types there than on the QProperty setters.  It's not much
-               // overhead to do things here IMHO.)
-               //
-               // Note that:
-               //    - propertyName is not actually a property name when fieldType is RequiredConstant
-               //    - when propertyName is not set, there is nothing to look up (because this is a field we don't
-               //      support, usually an "Extension tag")
-               //
-               bool const propertyIsOptional {
-                  (fieldDefinition.type == XmlRecordDefinition::FieldType::RequiredConstant ||
-                   fieldDefinition.propertyPath.isNull()) ?
-                     false :
-                     fieldDefinition.propertyPath.getTypeInfo(*this->m_recordDefinition.m_typeLookup).isOptional()
-               };
-
-               // Normally keep this log statement commented out otherwise it generates too many lines in the log file
-               qDebug() << Q_FUNC_INFO << "Value " << value << "; optional=" << (propertyIsOptional ? "true" : "false");
-
-               switch (fieldDefinition.type) {
-
-                  case XmlRecordDefinition::FieldType::Bool:
-                     // Unlike other XML documents, boolean fields in BeerXML are caps, so we have to accommodate that
-                     if (value.toLower() == "true") {
-                        parsedValue = Optional::variantFromRaw(true, propertyIsOptional);
-                        parsedValueOk = true;
-                     } else if (value.toLower() == "false") {
-                        parsedValue = Optional::variantFromRaw(false, propertyIsOptional);
-                        parsedValueOk = true;
-                     } else {
-                        // This is almost certainly a coding error, as we should have already validated that the field
-                        // via XSD parsing.
-                        qWarning() <<
-                           Q_FUNC_INFO << "Ignoring " << this->m_recordDefinition.m_namedEntityClassName << " node " <<
-                           fieldDefinition.xPath << "=" << value << " as could not be parsed as BOOLEAN";
-                     }
-                     break;
-
-                  case XmlRecordDefinition::FieldType::Int:
-                     {
-                        // QString's toInt method will report success/failure of parsing straight back into our flag
-                        auto const rawValue = value.toInt(&parsedValueOk);
-                        parsedValue = Optional::variantFromRaw(rawValue, propertyIsOptional);
-                        if (!parsedValueOk) {
-                           // This is almost certainly a coding error, as we should have already validated the field via
-                           // XSD parsing.
-                           qWarning() <<
-                              Q_FUNC_INFO << "Ignoring " << this->m_recordDefinition.m_namedEntityClassName << " node " <<
-                              fieldDefinition.xPath << "=" << value << " as could not be parsed as integer";
-                        }
-                     }
-                     break;
-
-                  case XmlRecordDefinition::FieldType::UInt:
-                     {
-                        // QString's toUInt method will report success/failure of parsing straight back into our flag
-                        auto const rawValue = value.toUInt(&parsedValueOk);
-                        parsedValue = Optional::variantFromRaw(rawValue, propertyIsOptional);
-                        if (!parsedValueOk) {
-                           // This is almost certainly a coding error, as we should have already validated the field via
-                           // XSD parsing.
-                           qWarning() <<
-                              Q_FUNC_INFO << "Ignoring " << this->m_recordDefinition.m_namedEntityClassName << " node " <<
-                              fieldDefinition.xPath << "=" << value << " as could not be parsed as unsigned integer";
-                        }
-                     }
-                     break;
-
-                  case XmlRecordDefinition::FieldType::Double:
-                     {
-                        // QString's toDouble method will report success/failure of parsing straight back into our flag
-                        auto rawValue = value.toDouble(&parsedValueOk);
-                        if (!parsedValueOk) {
-                           //
-                           // Although it is not explicitly stated in the BeerXML 1.0 standard, it is clear from the
-                           // sample files downloadable from www.beerxml.com that some "ignorable" percentage and decimal
-                           // values can be specified as "-".  I haven't found a straightforward way to filter or
-                           // transform these during XSD validation.  Nor, as yet, do I know whether it's possible from a
-                           // xalanc::XalanNode to get back to the Post-Schema-Validation Infoset (PSVI) information in
-                           // Xerces that might allow us to examine the XSD rules applied to the current node.
-                           //
-                           // For the moment, we assume that, if a "-" didn't get filtered out by XSD then it's allowed
-                           // and should be interpreted as NULL, which therefore means we store 0.0.
-                           //
-                           qInfo() <<
-                              Q_FUNC_INFO << "Treating " << this->m_recordDefinition.m_namedEntityClassName << " node " <<
-                              fieldDefinition.xPath << "=" << value << " as 0.0";
-                           parsedValueOk = true;
-                           rawValue = 0.0;
-                        }
-                        parsedValue = Optional::variantFromRaw(rawValue, propertyIsOptional);
-                     }
-                     break;
-
-                  case XmlRecordDefinition::FieldType::Date:
-                     {
-                        //
-                        // Extra braces here as we have a variable (date) that is only used in this case of the switch,
-                        // so we need to restrict its scope, otherwise the compiler will complain about the variable
-                        // initialisation being "jumped over" in the other case labels.
-                        //
-                        // Dates are a bit annoying because, in some cases, fields are not restricted to using the One
-                        // True Date Format™ (aka ISO 8601).  Eg, in the BeerXML 1.0 standard, for the DATE field of a
-                        // Recipe, it merely says 'Date brewed in a easily recognizable format such as “3 Dec 04”', yet
-                        // internally we want to store this as a date rather than just a text field.
-                        //
-                        // So, we make several attempts to parse a date, using various different "standard" encodings.
-                        // There is a risk that certain formats are ambiguous - eg 01/04/2021 is 4 January 2021 in
-                        // the USA, but 1 April 2021 in most of the rest of the world (except the enlightened countries
-                        // that use the One True Date Format) - but there is little we can do about this.
-                        //
-                        // Start by trying ISO 8601, which is the most logical format :-)
-                        //
-                        QDate date = QDate::fromString(value, Qt::ISODate);
-                        parsedValueOk = date.isValid();
-                        if (!parsedValueOk) {
-                           // If not ISO 8601, try RFC 2822 Internet Message Format, which is horrible because it
-                           // assumes everyone speaks English, but (a) widely used and (b) unambiguous
-                           date = QDate::fromString(value, Qt::RFC2822Date);
-                           parsedValueOk = date.isValid();
-                        }
-                        if (!parsedValueOk) {
-                           // Next we'll try Qt's "default" date format, which is good for display but not for file
-                           // interchange, as it's locale-specific
-                           date = QDate::fromString(value, Qt::TextDate);
-                           parsedValueOk = date.isValid();
-                        }
-                        if (!parsedValueOk) {
-                           // Now we're rolling our own formats.  See https://doc.qt.io/qt-5/qdate.html for details of
-                           // the codes in the format strings.
-                           //
-                           // Try USA / Philippines numeric format next, though NB this could mis-parse some
-                           // non-USA-format dates per example above.  (Historically we assumed USA format dates before
-                           // non-USA-format ones, so we're retaining existing behaviour by trying things in this
-                           // order.)
-                           date = QDate::fromString(value, "M/d/yyyy");
-                           parsedValueOk = date.isValid();
-                        }
-                        if (!parsedValueOk) {
-                           // Now try the numeric version that is widely used outside the USA & the Philippines
-                           date = QDate::fromString(value, "d/M/yyyy");
-                           parsedValueOk = date.isValid();
-                        }
-                        if (!parsedValueOk) {
-                           // Now try the numeric version that is widely used outside the USA & the Philippines
-                           date = QDate::fromString(value, "d/M/yyyy");
-                           parsedValueOk = date.isValid();
-                        }
-                        if (!parsedValueOk) {
-                           // Now try the example "easily recognizable" format from the BeerXML 1.0 standard.
-                           //
-                           // Of course, this is a horrible format because it is not Y2K compliant.  So the actual date
-                           // we store may be out by 100 years.  Hopefully the user will notice and correct this, and
-                           // then if we export we can use a non-ambiguous format.
-                           date = QDate::fromString(value, "d MMM yy");
-                           parsedValueOk = date.isValid();
-                        }
-                        // .:TBD:. Maybe we could try some more formats here
-                        parsedValue = Optional::variantFromRaw(date, propertyIsOptional);
-                     }
-                     if (!parsedValueOk) {
-                        // This is almost certainly a coding error, as we should have already validated the field via
-                        // XSD parsing.
-                        qWarning() <<
-                           Q_FUNC_INFO << "Ignoring " << this->m_recordDefinition.m_namedEntityClassName << " node " <<
-                           fieldDefinition.xPath << "=" << value << " as could not be parsed as ISO 8601 date";
-                     }
-                     break;
-
-                  case XmlRecordDefinition::FieldType::Enum:
-                     // It's definitely a coding error if there is no stringToEnum mapping for a field declared as Enum!
-                     Q_ASSERT(std::holds_alternative<EnumStringMapping const *>(fieldDefinition.valueDecoder));
-                     Q_ASSERT(std::get              <EnumStringMapping const *>(fieldDefinition.valueDecoder));
-                     {
-                        auto match =
-                           std::get<EnumStringMapping const *>(fieldDefinition.valueDecoder)->stringToEnumAsInt(value);
-                        if (!match) {
-                           // This is probably a coding error as the XSD parsing should already have verified that the
-                           // contents of the node are one of the expected values.
-                           qWarning() <<
-                              Q_FUNC_INFO << "Ignoring " << this->m_recordDefinition.m_namedEntityClassName << " node " <<
-                              fieldDefinition.xPath << "=" << value << " as value not recognised";
-                        } else {
-                           auto const rawValue = match.value();
-                           parsedValue = Optional::variantFromRaw(rawValue, propertyIsOptional);
-                           parsedValueOk = true;
-                        }
-                     }
-                     break;
-
-                  case XmlRecordDefinition::FieldType::Unit:
-                     // It's definitely a coding error if there is no mapping for a field declared as Unit
-                     Q_ASSERT(std::holds_alternative<Measurement::UnitStringMapping const *>(fieldDefinition.valueDecoder));
-                     Q_ASSERT(std::get              <Measurement::UnitStringMapping const *>(fieldDefinition.valueDecoder));
-                     {
-                        auto const unitMapping =
-                           std::get<Measurement::UnitStringMapping const *>(fieldDefinition.valueDecoder);
-                        auto match = unitMapping->stringToObjectAddress(value);
-                        if (!match) {
-                           // This is probably a coding error as the XSD parsing should already have verified that the
-                           // contents of the node are one of the expected values.
-                           qWarning() <<
-                              Q_FUNC_INFO << "Ignoring " << this->m_recordDefinition.m_namedEntityClassName << " node " <<
-                              fieldDefinition.xPath << "=" << value << " as value not recognised";
-                        } else {
-                           // We don't currently support Qt Properties holding optional Unit
-                           Q_ASSERT(!propertyIsOptional);
-                           // parsedValue = Optional::variantFromRaw(match, propertyIsOptional);
-                           parsedValue = QVariant::fromValue<Measurement::Unit const *>(match);
-                           parsedValueOk = true;
-                        }
-                     }
-                     break;
-
-                  case XmlRecordDefinition::FieldType::RequiredConstant:
-                     //
-                     // This is a field that is required to be in the XML, but whose value we don't need (and for which
-                     // we always write a constant value on output).  At the moment it's only needed for the VERSION tag
-                     // in BeerXML.
-                     //
-                     // Note that, because we abuse the propertyName field to hold the default value (ie what we write
-                     // out), we can't carry on to normal processing below.  So jump straight to processing the next
-                     // node in the loop (via continue).
-                     //
-                     // Normally keep this log statement commented out otherwise it generates too many lines in the log file
-//                     qDebug() <<
-//                        Q_FUNC_INFO << "Skipping " << this->m_recordDefinition.m_namedEntityClassName << " node " <<
-//                        fieldDefinition.xPath << "=" << value << "(" << fieldDefinition.propertyPath.asXPath() <<
-//                        ") as not useful";
-                     continue; // NB: _NOT_break here.  We want to jump straight to the next run through the for loop.
-
-                  // By default we assume it's a string
-                  case XmlRecordDefinition::FieldType::String:
-                  default:
-                     {
-                        if (fieldDefinition.type != XmlRecordDefinition::FieldType::String) {
-                           // This is almost certainly a coding error in this class as we should be able to parse all the
-                           // types callers need us to.
-                           qWarning() <<
-                              Q_FUNC_INFO << "Treating " << this->m_recordDefinition.m_namedEntityClassName << " node " <<
-                              fieldDefinition.xPath << "=" << value << " as string because did not recognise requested "
-                              "parse type " << static_cast<int>(fieldDefinition.type);
-                        }
-                        auto const rawValue = static_cast<QString>(value);
-                        parsedValue = Optional::variantFromRaw(rawValue, propertyIsOptional);
-                        parsedValueOk = true;
-                     }
-                     break;
-               }
-
-               // Normally keep this log statement commented out otherwise it generates too many lines in the log file
-               qDebug() <<
-                  Q_FUNC_INFO << "parsedValue:" << parsedValue << "; parsedValueOk:" << parsedValueOk <<
-                  "; fieldDefinition.propertyPath:" << fieldDefinition.propertyPath;
-
-               //
-               // What we do if we couldn't parse the value depends.  If it was a value that we didn't need to set on
-               // the supplied Hop/Yeast/Recipe/Etc object, then we can just ignore the problem and carry on processing.
-               // But, if this was a field we were expecting to use, then it's a problem that we couldn't parse it and
-               // we should bail.
-               //
-               if (!parsedValueOk && !fieldDefinition.propertyPath.isNull()) {
-                  userMessage <<
-                     "Could not parse " << this->m_recordDefinition.m_namedEntityClassName << " node " <<
-                     fieldDefinition.xPath << "=" << value << " into " << fieldDefinition.propertyPath.asXPath();
+               if (!this->loadValue(fieldDefinition, value, userMessage)) {
                   return false;
                }
-
-               //
-               // So we've either parsed the value OK or we don't need it (or both)
-               //
-               // If we do need it, we now store the value
-               //
-               if (!fieldDefinition.propertyPath.isNull()) {
-                  this->m_namedParameterBundle.insert(fieldDefinition.propertyPath, parsedValue);
-               }
             }
          }
       }
    }
 
+   this->constructLoadedNamedEntity();
+   return true;
+}
+
+void XmlRecord::constructLoadedNamedEntity() {
    //
    // For everything but the root record, we now construct a suitable object (Hop, Recipe, etc) from the
    // NamedParameterBundle (which will be empty for the root record).
@@ -512,13 +261,315 @@ bool XmlRecord::load(xalanc::DOMSupport & domSupport,
    //
    if (!this->m_namedParameterBundle.isEmpty()) {
       // Normally keep this log statement commented out otherwise it generates too many lines in the log file
-      qDebug() <<
+      qCDebug(Logging::serialization) <<
          Q_FUNC_INFO << "Constructing " << this->m_recordDefinition.m_namedEntityClassName << " from " <<
          this->m_namedParameterBundle;
 
       this->constructNamedEntity();
    }
 
+   return;
+}
+
+bool XmlRecord::loadValue(XmlRecordDefinition::FieldDefinition const & fieldDefinition,
+                          QStringView const value,
+                          QTextStream & userMessage) {
+   bool parsedValueOk = false;
+   QVariant parsedValue;
+
+   // A field should have an enumMapping if and only if it's of type Enum
+   // Anything else is a coding error at the caller
+   Q_ASSERT((XmlRecordDefinition::FieldType::Enum == fieldDefinition.type) ==
+            std::holds_alternative<EnumStringMapping const *>(fieldDefinition.valueDecoder));
+
+   // Same applies for a unit field
+   Q_ASSERT((XmlRecordDefinition::FieldType::Unit == fieldDefinition.type) ==
+            std::holds_alternative<Measurement::UnitStringMapping const *>(fieldDefinition.valueDecoder));
+
+   //
+   // We're going to need to know whether this field is "optional" in our internal data model.  If it is,
+   // then, for whatever underlying type T it is, we need the parsedValue QVariant to hold std::optional<T>
+   // instead of just T.
+   //
+   // (Note we can't do this mapping inside NamedParameterBundle, as we don't have the type information
+   // there.  We could conceivably do it in the constructors that take a NamedParameterBundle parameter, but
+   // I think it gets messy to have different types there than on the QProperty setters.  It's not much
+   // overhead to do things here IMHO.)
+   //
+   // Note that:
+   //    - propertyName is not actually a property name when fieldType is RequiredConstant
+   //    - when propertyName is not set, there is nothing to look up (because this is a field we don't
+   //      support, usually an "Extension tag")
+   //
+   bool const propertyIsOptional {
+      (fieldDefinition.type == XmlRecordDefinition::FieldType::RequiredConstant ||
+       fieldDefinition.propertyPath.isNull()) ?
+         false :
+         fieldDefinition.propertyPath.getTypeInfo(*this->m_recordDefinition.m_typeLookup).isOptional()
+   };
+
+   // Normally keep this log statement commented out otherwise it generates too many lines in the log file
+   qCDebug(Logging::serialization) <<
+      Q_FUNC_INFO << "Value " << value << "; optional=" << (propertyIsOptional ? "true" : "false");
+
+   switch (fieldDefinition.type) {
+
+      case XmlRecordDefinition::FieldType::Bool:
+         // Unlike other XML documents, boolean fields in BeerXML are caps, so we have to accommodate that
+         if (value.compare(QStringView{u"true"}, Qt::CaseInsensitive) == 0) {
+            parsedValue = Optional::variantFromRaw(true, propertyIsOptional);
+            parsedValueOk = true;
+         } else if (value.compare(QStringView{u"false"}, Qt::CaseInsensitive) == 0) {
+            parsedValue = Optional::variantFromRaw(false, propertyIsOptional);
+            parsedValueOk = true;
+         } else {
+            // This is almost certainly a coding error, as we should have already validated that the field
+            // via XSD parsing.
+            qCWarning(Logging::serialization) <<
+               Q_FUNC_INFO << "Ignoring " << this->m_recordDefinition.m_namedEntityClassName << " node " <<
+               fieldDefinition.xPath << "=" << value << " as could not be parsed as BOOLEAN";
+         }
+         break;
+
+      case XmlRecordDefinition::FieldType::Int:
+         {
+            // QString's toInt method will report success/failure of parsing straight back into our flag
+            auto const rawValue = value.toString().toInt(&parsedValueOk);
+            parsedValue = Optional::variantFromRaw(rawValue, propertyIsOptional);
+            if (!parsedValueOk) {
+               // This is almost certainly a coding error, as we should have already validated the field via
+               // XSD parsing.
+               qCWarning(Logging::serialization) <<
+                  Q_FUNC_INFO << "Ignoring " << this->m_recordDefinition.m_namedEntityClassName << " node " <<
+                  fieldDefinition.xPath << "=" << value << " as could not be parsed as integer";
+            }
+         }
+         break;
+
+      case XmlRecordDefinition::FieldType::UInt:
+         {
+            // QString's toUInt method will report success/failure of parsing straight back into our flag
+            auto const rawValue = value.toString().toUInt(&parsedValueOk);
+            parsedValue = Optional::variantFromRaw(rawValue, propertyIsOptional);
+            if (!parsedValueOk) {
+               // This is almost certainly a coding error, as we should have already validated the field via
+               // XSD parsing.
+               qCWarning(Logging::serialization) <<
+                  Q_FUNC_INFO << "Ignoring " << this->m_recordDefinition.m_namedEntityClassName << " node " <<
+                  fieldDefinition.xPath << "=" << value << " as could not be parsed as unsigned integer";
+            }
+         }
+         break;
+
+      case XmlRecordDefinition::FieldType::Double:
+         {
+            // QString's toDouble method will report success/failure of parsing straight back into our flag
+            auto rawValue = value.toString().toDouble(&parsedValueOk);
+            if (!parsedValueOk) {
+               //
+               // Although it is not explicitly stated in the BeerXML 1.0 standard, it is clear from the
+               // sample files downloadable from www.beerxml.com that some "ignorable" percentage and decimal
+               // values can be specified as "-".  I haven't found a straightforward way to filter or
+               // transform these during XSD validation.  Nor, as yet, do I know whether it's possible from a
+               // xalanc::XalanNode to get back to the Post-Schema-Validation Infoset (PSVI) information in
+               // Xerces that might allow us to examine the XSD rules applied to the current node.
+               //
+               // For the moment, we assume that, if a "-" didn't get filtered out by XSD then it's allowed
+               // and should be interpreted as NULL, which therefore means we store 0.0.
+               //
+               qCInfo(Logging::serialization) <<
+                  Q_FUNC_INFO << "Treating " << this->m_recordDefinition.m_namedEntityClassName << " node " <<
+                  fieldDefinition.xPath << "=" << value << " as 0.0";
+               parsedValueOk = true;
+               rawValue = 0.0;
+            }
+            parsedValue = Optional::variantFromRaw(rawValue, propertyIsOptional);
+         }
+         break;
+
+      case XmlRecordDefinition::FieldType::Date:
+         {
+            //
+            // Extra braces here as we have a variable (date) that is only used in this case of the switch,
+            // so we need to restrict its scope, otherwise the compiler will complain about the variable
+            // initialisation being "jumped over" in the other case labels.
+            //
+            // Dates are a bit annoying because, in some cases, fields are not restricted to using the One
+            // True Date Format™ (aka ISO 8601).  Eg, in the BeerXML 1.0 standard, for the DATE field of a
+            // Recipe, it merely says 'Date brewed in a easily recognizable format such as “3 Dec 04”', yet
+            // internally we want to store this as a date rather than just a text field.
+            //
+            // So, we make several attempts to parse a date, using various different "standard" encodings.
+            // There is a risk that certain formats are ambiguous - eg 01/04/2021 is 4 January 2021 in
+            // the USA, but 1 April 2021 in most of the rest of the world (except the enlightened countries
+            // that use the One True Date Format) - but there is little we can do about this.
+            //
+            // Start by trying ISO 8601, which is the most logical format :-)
+            //
+            QString const text = value.toString();
+            QDate date = QDate::fromString(text, Qt::ISODate);
+            parsedValueOk = date.isValid();
+            if (!parsedValueOk) {
+               // If not ISO 8601, try RFC 2822 Internet Message Format, which is horrible because it
+               // assumes everyone speaks English, but (a) widely used and (b) unambiguous
+               date = QDate::fromString(text, Qt::RFC2822Date);
+               parsedValueOk = date.isValid();
+            }
+            if (!parsedValueOk) {
+               // Next we'll try Qt's "default" date format, which is good for display but not for file
+               // interchange, as it's locale-specific
+               date = QDate::fromString(text, Qt::TextDate);
+               parsedValueOk = date.isValid();
+            }
+            if (!parsedValueOk) {
+               // Now we're rolling our own formats.  See https://doc.qt.io/qt-5/qdate.html for details of
+               // the codes in the format strings.
+               //
+               // Try USA / Philippines numeric format next, though NB this could mis-parse some
+               // non-USA-format dates per example above.  (Historically we assumed USA format dates before
+               // non-USA-format ones, so we're retaining existing behaviour by trying things in this
+               // order.)
+               date = QDate::fromString(text, "M/d/yyyy");
+               parsedValueOk = date.isValid();
+            }
+            if (!parsedValueOk) {
+               // Now try the numeric version that is widely used outside the USA & the Philippines
+               date = QDate::fromString(text, "d/M/yyyy");
+               parsedValueOk = date.isValid();
+            }
+            if (!parsedValueOk) {
+               // Now try the numeric version that is widely used outside the USA & the Philippines
+               date = QDate::fromString(text, "d/M/yyyy");
+               parsedValueOk = date.isValid();
+            }
+            if (!parsedValueOk) {
+               // Now try the example "easily recognizable" format from the BeerXML 1.0 standard.
+               //
+               // Of course, this is a horrible format because it is not Y2K compliant.  So the actual date
+               // we store may be out by 100 years.  Hopefully the user will notice and correct this, and
+               // then if we export we can use a non-ambiguous format.
+               date = QDate::fromString(text, "d MMM yy");
+               parsedValueOk = date.isValid();
+            }
+            // .:TBD:. Maybe we could try some more formats here
+            parsedValue = Optional::variantFromRaw(date, propertyIsOptional);
+         }
+         if (!parsedValueOk) {
+            // This is almost certainly a coding error, as we should have already validated the field via
+            // XSD parsing.
+            qCWarning(Logging::serialization) <<
+               Q_FUNC_INFO << "Ignoring " << this->m_recordDefinition.m_namedEntityClassName << " node " <<
+               fieldDefinition.xPath << "=" << value << " as could not be parsed as ISO 8601 date";
+         }
+         break;
+
+      case XmlRecordDefinition::FieldType::Enum:
+         // It's definitely a coding error if there is no stringToEnum mapping for a field declared as Enum!
+         Q_ASSERT(std::holds_alternative<EnumStringMapping const *>(fieldDefinition.valueDecoder));
+         Q_ASSERT(std::get              <EnumStringMapping const *>(fieldDefinition.valueDecoder));
+         {
+            auto match =
+               std::get<EnumStringMapping const *>(fieldDefinition.valueDecoder)->stringToEnumAsInt(value);
+            if (!match) {
+               // This is probably a coding error as the XSD parsing should already have verified that the
+               // contents of the node are one of the expected values.
+               qCWarning(Logging::serialization) <<
+                  Q_FUNC_INFO << "Ignoring " << this->m_recordDefinition.m_namedEntityClassName << " node " <<
+                  fieldDefinition.xPath << "=" << value << " as value not recognised";
+            } else {
+               auto const rawValue = match.value();
+               parsedValue = Optional::variantFromRaw(rawValue, propertyIsOptional);
+               parsedValueOk = true;
+            }
+         }
+         break;
+
+      case XmlRecordDefinition::FieldType::Unit:
+         // It's definitely a coding error if there is no mapping for a field declared as Unit
+         Q_ASSERT(std::holds_alternative<Measurement::UnitStringMapping const *>(fieldDefinition.valueDecoder));
+         Q_ASSERT(std::get              <Measurement::UnitStringMapping const *>(fieldDefinition.valueDecoder));
+         {
+            auto const unitMapping =
+               std::get<Measurement::UnitStringMapping const *>(fieldDefinition.valueDecoder);
+            auto match = unitMapping->stringToObjectAddress(value.toString());
+            if (!match) {
+               // This is probably a coding error as the XSD parsing should already have verified that the
+               // contents of the node are one of the expected values.
+               qCWarning(Logging::serialization) <<
+                  Q_FUNC_INFO << "Ignoring " << this->m_recordDefinition.m_namedEntityClassName << " node " <<
+                  fieldDefinition.xPath << "=" << value << " as value not recognised";
+            } else {
+               // We don't currently support Qt Properties holding optional Unit
+               Q_ASSERT(!propertyIsOptional);
+               // parsedValue = Optional::variantFromRaw(match, propertyIsOptional);
+               parsedValue = QVariant::fromValue<Measurement::Unit const *>(match);
+               parsedValueOk = true;
+            }
+         }
+         break;
+
+      case XmlRecordDefinition::FieldType::RequiredConstant:
+         //
+         // This is a field that is required to be in the XML, but whose value we don't need (and for which
+         // we always write a constant value on output).  At the moment it's only needed for the VERSION tag
+         // in BeerXML.
+         //
+         // Note that, because we abuse the propertyName field to hold the default value (ie what we write
+         // out), we can't carry on to normal processing below.  So we just return.
+         //
+         // Normally keep this log statement commented out otherwise it generates too many lines in the log file
+//         qDebug() <<
+//            Q_FUNC_INFO << "Skipping " << this->m_recordDefinition.m_namedEntityClassName << " node " <<
+//            fieldDefinition.xPath << "=" << value << "(" << fieldDefinition.propertyPath.asXPath() <<
+//            ") as not useful";
+         return true; // NB: _NOT_break here.  We want to skip the normal processing below.
+
+      // By default we assume it's a string
+      case XmlRecordDefinition::FieldType::String:
+      default:
+         {
+            if (fieldDefinition.type != XmlRecordDefinition::FieldType::String) {
+               // This is almost certainly a coding error in this class as we should be able to parse all the
+               // types callers need us to.
+               qCWarning(Logging::serialization) <<
+                  Q_FUNC_INFO << "Treating " << this->m_recordDefinition.m_namedEntityClassName << " node " <<
+                  fieldDefinition.xPath << "=" << value << " as string because did not recognise requested "
+                  "parse type " << static_cast<int>(fieldDefinition.type);
+            }
+            auto const rawValue = StringPool::intern(value.toString());
+            parsedValue = Optional::variantFromRaw(rawValue, propertyIsOptional);
+            parsedValueOk = true;
+         }
+         break;
+   }
+
+   // Normally keep this log statement commented out otherwise it generates too many lines in the log file
+   qCDebug(Logging::serialization) <<
+      Q_FUNC_INFO << "parsedValue:" << parsedValue << "; parsedValueOk:" << parsedValueOk <<
+      "; fieldDefinition.propertyPath:" << fieldDefinition.propertyPath;
+
+   //
+   // What we do if we couldn't parse the value depends.  If it was a value that we didn't need to set on
+   // the supplied Hop/Yeast/Recipe/Etc object, then we can just ignore the problem and carry on processing.
+   // But, if this was a field we were expecting to use, then it's a problem that we couldn't parse it and
+   // we should bail.
+   //
+   if (!parsedValueOk && !fieldDefinition.propertyPath.isNull()) {
+      userMessage <<
+         "Could not parse " << this->m_recordDefinition.m_namedEntityClassName << " node " <<
+         fieldDefinition.xPath << "=" << value << " into " << fieldDefinition.propertyPath.asXPath();
+      return false;
+   }
+
+   //
+   // So we've either parsed the value OK or we don't need it (or both)
+   //
+   // If we do need it, we now store the value
+   //
+   if (!fieldDefinition.propertyPath.isNull()) {
+      this->m_namedParameterBundle.insert(fieldDefinition.propertyPath, parsedValue);
+   }
+
    return true;
 }
 
@@ -526,36 +577,11 @@ XmlRecord::ProcessingResult XmlRecord::normaliseAndStoreInDb(std::shared_ptr<Nam
                                                              QTextStream & userMessage,
                                                              ImportRecordCount & stats) {
    if (this->m_namedEntity) {
-      qDebug() <<
-         Q_FUNC_INFO << "Normalise and store " << this->m_recordDefinition.m_namedEntityClassName << "(" <<
-         this->m_namedEntity->metaObject()->className() << "):" << this->m_namedEntity->name();
-
-      //
-      // If the object we are reading in is a duplicate of something we already have (and duplicates are not allowed)
-      // then skip over this record (and any records it contains).  (This is _not_ an error, so we return true not
-      // false in this event.)
-      //
-      // Note, however, that some objects -- in particular those such as Recipe that contain other objects -- need
-      // to be further along in their construction (ie have had all their contained objects added) before we can
-      // determine whether they are duplicates.  This is why we check again, after storing in the DB, below.
-      //
-      if (this->isDuplicate()) {
-         qDebug() <<
-            Q_FUNC_INFO << "(Early found) duplicate" << this->m_recordDefinition.m_namedEntityClassName <<
-            (this->m_includeInStats ? " will" : " won't") << " be included in stats";
-         if (this->m_includeInStats) {
-            stats.skipped(*this->m_recordDefinition.m_namedEntityClassName);
-         }
-         return XmlRecord::ProcessingResult::FoundDuplicate;
+      XmlRecord::ProcessingResult const preparationResult = this->prepareToStoreInDb(containingEntity, stats);
+      if (XmlRecord::ProcessingResult::Succeeded != preparationResult) {
+         return preparationResult;
       }
 
-      this->normaliseName();
-
-      // Some classes of object are owned by their containing entity and can't sensibly be saved without knowing what it
-      // is.  Subclasses of XmlRecord will override setContainingEntity() to pass the info in if it is needed (or ignore
-      // it if not).
-      this->setContainingEntity(containingEntity);
-
       // Now we're ready to store in the DB
       int id = this->storeNamedEntityInDb();
       if (id <= 0) {
@@ -565,6 +591,49 @@ XmlRecord::ProcessingResult XmlRecord::normaliseAndStoreInDb(std::shared_ptr<Nam
       }
    }
 
+   return this->finishStoringInDb(userMessage, stats);
+}
+
+XmlRecord::ProcessingResult XmlRecord::prepareToStoreInDb(std::shared_ptr<NamedEntity> containingEntity,
+                                                          ImportRecordCount & stats) {
+   // It's a coding error to call this for the root record
+   Q_ASSERT(this->m_namedEntity);
+
+   qCDebug(Logging::serialization) <<
+      Q_FUNC_INFO << "Normalise and store " << this->m_recordDefinition.m_namedEntityClassName << "(" <<
+      this->m_namedEntity->metaObject()->className() << "):" << this->m_namedEntity->name();
+
+   //
+   // If the object we are reading in is a duplicate of something we already have (and duplicates are not allowed)
+   // then skip over this record (and any records it contains).  (This is _not_ an error, so we return true not
+   // false in this event.)
+   //
+   // Note, however, that some objects -- in particular those such as Recipe that contain other objects -- need
+   // to be further along in their construction (ie have had all their contained objects added) before we can
+   // determine whether they are duplicates.  This is why we check again, after storing in the DB, in
+   // finishStoringInDb().
+   //
+   if (this->timedIsDuplicate()) {
+      qCDebug(Logging::serialization) <<
+         Q_FUNC_INFO << "(Early found) duplicate" << this->m_recordDefinition.m_namedEntityClassName <<
+         (this->m_includeInStats ? " will" : " won't") << " be included in stats";
+      if (this->m_includeInStats) {
+         stats.skipped(*this->m_recordDefinition.m_namedEntityClassName);
+      }
+      return XmlRecord::ProcessingResult::FoundDuplicate;
+   }
+
+   this->normaliseName();
+
+   // Some classes of object are owned by their containing entity and can't sensibly be saved without knowing what it
+   // is.  Subclasses of XmlRecord will override setContainingEntity() to pass the info in if it is needed (or ignore
+   // it if not).
+   this->setContainingEntity(containingEntity);
+
+   return XmlRecord::ProcessingResult::Succeeded;
+}
+
+XmlRecord::ProcessingResult XmlRecord::finishStoringInDb(QTextStream & userMessage, ImportRecordCount & stats) {
    XmlRecord::ProcessingResult processingResult;
 
    //
@@ -584,7 +653,7 @@ XmlRecord::ProcessingResult XmlRecord::normaliseAndStoreInDb(std::shared_ptr<Nam
          // required.
          return XmlRecord::ProcessingResult::Succeeded;
       }
-      processingResult = this->isDuplicate() ? XmlRecord::ProcessingResult::FoundDuplicate :
+      processingResult = this->timedIsDuplicate() ? XmlRecord::ProcessingResult::FoundDuplicate :
                                                XmlRecord::ProcessingResult::Succeeded;
    } else {
       // There was a problem with one of our child records
@@ -596,7 +665,7 @@ XmlRecord::ProcessingResult XmlRecord::normaliseAndStoreInDb(std::shared_ptr<Nam
       // We potentially do stats for everything except failure
       //
       if (XmlRecord::ProcessingResult::FoundDuplicate == processingResult) {
-         qDebug() <<
+         qCDebug(Logging::serialization) <<
             Q_FUNC_INFO << "(Late found) duplicate" << this->m_recordDefinition.m_namedEntityClassName << "(" <<
             this->m_recordDefinition.m_localisedEntityName << ")" << (this->m_includeInStats ? " will" : " won't") <<
             " be included in stats";
@@ -621,7 +690,7 @@ XmlRecord::ProcessingResult XmlRecord::normaliseAndStoreInDb(std::shared_ptr<Nam
          // and 2 MashSteps before hitting an error on the 3rd MashStep, then deleting the Mash from the DB will also
          // result in those 2 stored MashSteps getting deleted from the DB.)
          //
-         qDebug() <<
+         qCDebug(Logging::serialization) <<
             Q_FUNC_INFO << "Deleting stored" << this->m_recordDefinition.m_namedEntityClassName << "as" <<
             (XmlRecord::ProcessingResult::FoundDuplicate == processingResult ? "duplicate" : "failed to read all child records");
          this->deleteNamedEntityFromDb();
@@ -631,6 +700,97 @@ XmlRecord::ProcessingResult XmlRecord::normaliseAndStoreInDb(std::shared_ptr<Nam
    return processingResult;
 }
 
+bool XmlRecord::normaliseAndStoreChildRecordBatchInDb(std::vector< std::unique_ptr<XmlRecord> > & childRecords,
+                                                      QList<std::shared_ptr<NamedEntity>> & processedChildren,
+                                                      QTextStream & userMessage,
+                                                      ImportRecordCount & stats) {
+   qCDebug(Logging::serialization) <<
+      Q_FUNC_INFO << "Storing" << childRecords.size() <<
+      childRecords.front()->m_recordDefinition.m_namedEntityClassName << "children of" <<
+      this->m_recordDefinition.m_namedEntityClassName;
+
+   //
+   // First we do the duplicate checks and name normalisation for all the records, in order.  The records before the
+   // current one in the batch aren't in the object store yet, so isDuplicate() and normaliseName() need to be told
+   // about them.
+   //
+   QList<std::shared_ptr<NamedEntity>> namedEntitiesToStore;
+   QList<std::shared_ptr<NamedEntity>> completeNamedEntitiesToStore;
+   QList<SerializationRecord const *> recordsToStore;
+   std::vector<XmlRecord::ProcessingResult> preparationResults;
+   preparationResults.reserve(childRecords.size());
+   for (auto & childRecord : childRecords) {
+      if (stats.isCancelled()) {
+         return false;
+      }
+      childRecord->m_earlierInBatch         = &namedEntitiesToStore;
+      childRecord->m_completeEarlierInBatch = &completeNamedEntitiesToStore;
+      preparationResults.push_back(childRecord->prepareToStoreInDb(this->m_namedEntity, stats));
+      childRecord->m_earlierInBatch         = nullptr;
+      childRecord->m_completeEarlierInBatch = nullptr;
+      if (XmlRecord::ProcessingResult::Succeeded == preparationResults.back()) {
+         namedEntitiesToStore.append(childRecord->m_namedEntity);
+         recordsToStore.append(childRecord.get());
+         bool const hasChildRecords = std::any_of(
+            childRecord->m_childRecordSets.cbegin(),
+            childRecord->m_childRecordSets.cend(),
+            [](auto const & grandchildRecordSet) { return !grandchildRecordSet.records.empty(); }
+         );
+         if (!hasChildRecords) {
+            completeNamedEntitiesToStore.append(childRecord->m_namedEntity);
+         }
+      }
+   }
+
+   //
+   // Then we store all the ones that aren't duplicates in one go.  insertMany keeps them in order, so, eg, the IDs of
+   // mash steps are in the same order as the steps themselves.
+   //
+   if (!recordsToStore.isEmpty()) {
+      QVector<int> const ids = childRecords.front()->storeNamedEntitiesInDb(recordsToStore);
+      if (ids.size() != recordsToStore.size()) {
+         userMessage << "Error storing " << namedEntitiesToStore.first()->metaObject()->className() <<
+         " records in database.  See logs for more details";
+         return false;
+      }
+   }
+
+   //
+   // Finally we do the rest of the processing for each record in turn.  If we have to bail out part way through, the
+   // records we stored above but haven't yet got to would not otherwise get cleaned up.
+   //
+   auto const deleteStoredFrom = [&childRecords, &preparationResults](std::size_t const first) {
+      for (std::size_t jj = first; jj < childRecords.size(); ++jj) {
+         if (XmlRecord::ProcessingResult::Succeeded == preparationResults[jj]) {
+            childRecords[jj]->deleteNamedEntityFromDb();
+         }
+      }
+      return;
+   };
+   for (std::size_t ii = 0; ii < childRecords.size(); ++ii) {
+      auto & childRecord = childRecords[ii];
+      XmlRecord::ProcessingResult result = preparationResults[ii];
+      if (XmlRecord::ProcessingResult::Succeeded == result) {
+         if (stats.isCancelled()) {
+            deleteStoredFrom(ii);
+            return false;
+         }
+         result = childRecord->finishStoringInDb(userMessage, stats);
+         if (XmlRecord::ProcessingResult::Failed == result) {
+            deleteStoredFrom(ii + 1);
+            return false;
+         }
+      }
+      if (!this->m_namedEntity && XmlRecord::ProcessingResult::Succeeded == result) {
+         // We're the root record, so the child is a top-level record
+         stats.storedTopLevel(childRecord->namedEntityDeleter());
+      }
+      processedChildren.append(childRecord->m_namedEntity);
+   }
+
+   return true;
+}
+
 bool XmlRecord::normaliseAndStoreChildRecordsInDb(QTextStream & userMessage,
                                                   ImportRecordCount & stats) {
    //
@@ -646,16 +806,17 @@ bool XmlRecord::normaliseAndStoreChildRecordsInDb(QTextStream & userMessage,
    // items that share the same key in the opposite order to which they were inserted and don't offer STL reverse
    // iterators, so going backwards would be a bit clunky.)
    //
-   qDebug() <<
+   qCDebug(Logging::serialization) <<
       Q_FUNC_INFO << "this->m_childRecordSets for" << this->m_recordDefinition << "has" <<
       this->m_childRecordSets.size() << "entries";
    for (auto & childRecordSet : this->m_childRecordSets) {
       if (childRecordSet.parentFieldDefinition) {
-         qDebug() <<
+         qCDebug(Logging::serialization) <<
             Q_FUNC_INFO << this->m_recordDefinition << ": childRecordSet" << *childRecordSet.parentFieldDefinition <<
             "now holds" << childRecordSet.records.size() << "record(s)";
       } else {
-         qDebug() << Q_FUNC_INFO << "Top-level record has" << childRecordSet.records.size() << "entries";
+         qCDebug(Logging::serialization) <<
+            Q_FUNC_INFO << "Top-level record has" << childRecordSet.records.size() << "entries";
       }
 
       // If the list of children is empty, there is no work to do.  Explicitly move on to the next loop item.  (This
@@ -665,17 +826,37 @@ bool XmlRecord::normaliseAndStoreChildRecordsInDb(QTextStream & userMessage,
       }
 
       QList< std::shared_ptr<NamedEntity> > processedChildren;
-      for (auto & childRecord : childRecordSet.records) {
-         // The childRecord variable is a reference to a std::unique_ptr (because the vector we're looping over owns the
-         // records it contains), which is why we have all the "member of pointer" (->) operators below.
-         qDebug() <<
-            Q_FUNC_INFO << "Storing" << childRecord->m_recordDefinition.m_namedEntityClassName << "child of" <<
-            this->m_recordDefinition.m_namedEntityClassName << ":" << this->m_namedEntity;
-         if (XmlRecord::ProcessingResult::Failed ==
-            childRecord->normaliseAndStoreInDb(this->m_namedEntity, userMessage, stats)) {
+      if (childRecordSet.records.size() > 1 && childRecordSet.records.front()->canStoreInBatch()) {
+         // Eg all the hop additions in a recipe, or all the hops in a file of hop varieties
+         if (!this->normaliseAndStoreChildRecordBatchInDb(childRecordSet.records,
+                                                          processedChildren,
+                                                          userMessage,
+                                                          stats)) {
             return false;
          }
-         processedChildren.append(childRecord->m_namedEntity);
+      } else {
+         for (auto & childRecord : childRecordSet.records) {
+            // The childRecord variable is a reference to a std::unique_ptr (because the vector we're looping over owns
+            // the records it contains), which is why we have all the "member of pointer" (->) operators below.
+            qCDebug(Logging::serialization) <<
+               Q_FUNC_INFO << "Storing" << childRecord->m_recordDefinition.m_namedEntityClassName << "child of" <<
+               this->m_recordDefinition.m_namedEntityClassName << ":" << this->m_namedEntity;
+            // If the user has cancelled the import, returning failure here means partially stored records get cleaned
+            // up in the same way as for any other problem
+            if (stats.isCancelled()) {
+               return false;
+            }
+            XmlRecord::ProcessingResult const result =
+               childRecord->normaliseAndStoreInDb(this->m_namedEntity, userMessage, stats);
+            if (XmlRecord::ProcessingResult::Failed == result) {
+               return false;
+            }
+            if (!this->m_namedEntity && XmlRecord::ProcessingResult::Succeeded == result) {
+               // We're the root record, so the child is a top-level record
+               stats.storedTopLevel(childRecord->namedEntityDeleter());
+            }
+            processedChildren.append(childRecord->m_namedEntity);
+         }
       }
 
       //
@@ -710,7 +891,7 @@ bool XmlRecord::normaliseAndStoreChildRecordsInDb(QTextStream & userMessage,
             if (fieldDefinition.type != XmlRecordDefinition::FieldType::ListOfRecords) {
                // It's a coding error if we ended up with more than on child when there's only supposed to be one!
                if (processedChildren.size() > 1) {
-                  qCritical() <<
+                  qCCritical(Logging::serialization) <<
                      Q_FUNC_INFO << "Only expecting one record for" << propertyPath << "property on" <<
                      this->m_recordDefinition.m_namedEntityClassName << "object, but found" << processedChildren.size();
                   Q_ASSERT(false);
@@ -752,13 +933,13 @@ bool XmlRecord::normaliseAndStoreChildRecordsInDb(QTextStream & userMessage,
                   childRecordSet.records.at(0)->m_recordDefinition.m_upAndDownCasters.m_listUpcaster(processedChildren);
             }
 
-            qDebug() <<
+            qCDebug(Logging::serialization) <<
                Q_FUNC_INFO << "Setting" << propertyPath << "property on" <<
                this->m_recordDefinition.m_namedEntityClassName << "with" << processedChildren.size() << "value(s):" <<
                valueToSet;
             if (!propertyPath.setValue(*this->m_namedEntity, valueToSet)) {
                // It's a coding error if we could not set the property we use to pass in the child records
-               qCritical() <<
+               qCCritical(Logging::serialization) <<
                   Q_FUNC_INFO << "Could not write" << propertyPath << "property on" <<
                   this->m_recordDefinition.m_namedEntityClassName;
                Q_ASSERT(false);
@@ -791,7 +972,7 @@ bool XmlRecord::normaliseAndStoreChildRecordsInDb(QTextStream & userMessage,
    //
    auto constructorWrapper = childRecordDefinition.xmlRecordConstructorWrapper;
    this->m_childRecordSets.push_back(XmlRecord::ChildRecordSet{&parentFieldDefinition, {}});
-   qDebug() <<
+   qCDebug(Logging::serialization) <<
       Q_FUNC_INFO << "childRecordDefinition" << childRecordDefinition << ". m_childRecordSets for" <<
       this->m_recordDefinition << "has" << this->m_childRecordSets.size() << "entries";
    XmlRecord::ChildRecordSet & childRecordSet = this->m_childRecordSets.back();
@@ -812,7 +993,7 @@ bool XmlRecord::normaliseAndStoreChildRecordsInDb(QTextStream & userMessage,
       //    </RECIPE>
       // Requesting the HOPS/HOP subpath of RECIPE will not return FOO or BAR
       //
-      XQString childRecordName{childRecordNode->getNodeName()};
+      QStringView const childRecordName = XQString::view(childRecordNode->getNodeName());
       // Normally keep this log statement commented out otherwise it generates too many lines in the log file
 //      qDebug() << Q_FUNC_INFO << childRecordName;
 
@@ -824,14 +1005,14 @@ bool XmlRecord::normaliseAndStoreChildRecordsInDb(QTextStream & userMessage,
       // The return value of xalanc::XalanNode::getIndex() doesn't have an instantly obvious direct meaning, but AFAICT
       // higher values are for nodes that were later in the input file, so useful to log.
       //
-      qDebug() <<
+      qCDebug(Logging::serialization) <<
          Q_FUNC_INFO << "Loading child record" << childRecordName << "with index" << childRecordNode->getIndex() <<
          "for" << childRecordDefinition.m_namedEntityClassName;
       if (!childRecord->load(domSupport, childRecordNode, userMessage)) {
          return false;
       }
       childRecordSet.records.push_back(std::move(childRecord));
-      qDebug() <<
+      qCDebug(Logging::serialization) <<
          Q_FUNC_INFO << this->m_recordDefinition << ": childRecordSet" << *childRecordSet.parentFieldDefinition <<
          "now holds" << childRecordSet.records.size() << "record(s)";
    }
@@ -839,6 +1020,237 @@ bool XmlRecord::normaliseAndStoreChildRecordsInDb(QTextStream & userMessage,
    return true;
 }
 
+bool XmlRecord::load(QXmlStreamReader & reader, QTextStream & userMessage) {
+   Tracing::Span span{"XmlRecord::load"};
+   // It's a coding error to call this other than at the start of the record's element
+   Q_ASSERT(reader.isStartElement());
+   this->prepareStreamedLoad();
+   if (!this->loadStreamedElements(reader, userMessage, nullptr)) {
+      return false;
+   }
+   this->finishStreamedLoad();
+   return true;
+}
+
+bool XmlRecord::loadNormaliseAndStoreInDb(QXmlStreamReader & reader,
+                                          QTextStream & userMessage,
+                                          ImportRecordCount & stats) {
+   // Only the root record has no NamedEntity to hold its contents, so it's a coding error to call this on any other
+   Q_ASSERT(!this->m_namedEntity);
+   this->prepareStreamedLoad();
+   return this->loadStreamedElements(reader, userMessage, &stats);
+}
+
+void XmlRecord::prepareStreamedLoad() {
+   //
+   // In XmlRecord::load(xalanc::DOMSupport &, ...) above, we add one entry to m_childRecordSets for every record field,
+   // in the order of our field definitions, regardless of whether there are any records for that field in the
+   // document.  Subclasses (eg XmlRecipeRecord) rely on this, so we do the same here.  The difference is that we have
+   // to create the entries before we start reading, because child records will turn up in document order, not field
+   // definition order.
+   //
+   // Records using the "Base Record" trick (ie with an empty XPath) are read from the same element as us, so we create
+   // them up-front too, and feed them each child element as we read it.
+   //
+   Q_ASSERT(this->m_recordDefinition.fieldDefinitions.size() > 0);
+   this->m_childRecordSets.reserve(this->m_recordDefinition.fieldDefinitions.size());
+   for (auto const & fieldDefinition : this->m_recordDefinition.fieldDefinitions) {
+      if (XmlRecordDefinition::FieldType::Record        != fieldDefinition.type &&
+          XmlRecordDefinition::FieldType::ListOfRecords != fieldDefinition.type) {
+         continue;
+      }
+      this->m_childRecordSets.push_back(XmlRecord::ChildRecordSet{&fieldDefinition, {}});
+      if (fieldDefinition.xPath.isEmpty()) {
+         Q_ASSERT(std::holds_alternative<XmlRecordDefinition const *>(fieldDefinition.valueDecoder));
+         XmlRecordDefinition const & baseRecordDefinition{
+            *std::get<XmlRecordDefinition const *>(fieldDefinition.valueDecoder)
+         };
+         std::unique_ptr<XmlRecord> baseRecord{
+            baseRecordDefinition.xmlRecordConstructorWrapper(this->m_coding, baseRecordDefinition)
+         };
+         baseRecord->prepareStreamedLoad();
+         this->m_childRecordSets.back().records.push_back(std::move(baseRecord));
+      }
+   }
+   return;
+}
+
+void XmlRecord::finishStreamedLoad() {
+   for (auto & childRecordSet : this->m_childRecordSets) {
+      if (childRecordSet.parentFieldDefinition && childRecordSet.parentFieldDefinition->xPath.isEmpty()) {
+         for (auto & baseRecord : childRecordSet.records) {
+            baseRecord->finishStreamedLoad();
+         }
+      }
+   }
+   this->constructLoadedNamedEntity();
+   return;
+}
+
+void XmlRecord::getStreamedRecords(std::vector<XmlRecord *> & records) {
+   records.push_back(this);
+   for (auto & childRecordSet : this->m_childRecordSets) {
+      if (childRecordSet.parentFieldDefinition && childRecordSet.parentFieldDefinition->xPath.isEmpty()) {
+         for (auto & baseRecord : childRecordSet.records) {
+            baseRecord->getStreamedRecords(records);
+         }
+      }
+   }
+   return;
+}
+
+bool XmlRecord::loadStreamedElements(QXmlStreamReader & reader,
+                                     QTextStream & userMessage,
+                                     ImportRecordCount * statsForImmediateStore) {
+   //
+   // The records that get to see each child element of our element: us, plus any base records (and their base records)
+   //
+   std::vector<XmlRecord *> records;
+   this->getStreamedRecords(records);
+
+   //
+   // In BeerXML, the XPaths in our field definitions are only ever a child tag (eg "NAME"), a record set tag plus a
+   // record tag (eg "HOPS/HOP", which is only used for record fields), or empty (the base record trick handled in
+   // prepareStreamedLoad).  So we only need to look one or, for record sets, two levels down.
+   //
+   // Each record definition has hashes from tag name to field definition, so each element costs one lookup per record
+   // rather than a comparison with every field.
+   //
+   while (reader.readNextStartElement()) {
+      QString const tagName = reader.name().toString();
+
+      //
+      // First see whether it's a record or a set of records
+      //
+      XmlRecord * owningRecord = nullptr;
+      XmlRecord::ChildRecordSet * childRecordSet = nullptr;
+      QStringRef recordTagName;
+      for (XmlRecord * record : records) {
+         int const fieldIndex = record->m_recordDefinition.recordFieldForTag(tagName);
+         if (fieldIndex < 0) {
+            continue;
+         }
+         auto const & fieldDefinition = record->m_recordDefinition.fieldDefinitions[fieldIndex];
+         auto match = std::find_if(
+            record->m_childRecordSets.begin(),
+            record->m_childRecordSets.end(),
+            [&](auto const & candidate) { return candidate.parentFieldDefinition == &fieldDefinition; }
+         );
+         if (match != record->m_childRecordSets.end()) {
+            QString const & xPath = fieldDefinition.xPath;
+            int const slashPosition = xPath.indexOf('/');
+            Q_ASSERT(xPath.indexOf('/', slashPosition + 1) < 0);
+            owningRecord = record;
+            childRecordSet = &(*match);
+            recordTagName = slashPosition < 0 ? QStringRef{} : xPath.midRef(slashPosition + 1);
+            break;
+         }
+      }
+      if (childRecordSet) {
+         if (recordTagName.isNull()) {
+            if (!owningRecord->loadStreamedChildRecord(reader, *childRecordSet, userMessage, statsForImmediateStore)) {
+               return false;
+            }
+            continue;
+         }
+         // As in loadChildRecords, anything inside the record set that isn't one of the records is ignored
+         while (reader.readNextStartElement()) {
+            if (reader.name() != recordTagName) {
+               reader.skipCurrentElement();
+               continue;
+            }
+            if (!owningRecord->loadStreamedChildRecord(reader, *childRecordSet, userMessage, statsForImmediateStore)) {
+               return false;
+            }
+         }
+         continue;
+      }
+
+      //
+      // Otherwise it's a simple value, which may be needed by more than one record (eg the NAME of a hop addition in a
+      // recipe).  As elsewhere, if there are several instances of a simple field, only the first one is used.
+      //
+      std::vector<std::pair<XmlRecord *, XmlRecordDefinition::FieldDefinition const *>> fields;
+      for (XmlRecord * record : records) {
+         for (int const fieldIndex : record->m_recordDefinition.simpleFieldsForTag(tagName)) {
+            auto const & fieldDefinition = record->m_recordDefinition.fieldDefinitions[fieldIndex];
+            if (record->m_streamedFields.contains(&fieldDefinition)) {
+               qCWarning(Logging::serialization) <<
+                  Q_FUNC_INFO << "Multiple nodes found with path " << fieldDefinition.xPath << ".  Taking value "
+                  "only of the first one.";
+            } else {
+               fields.push_back({record, &fieldDefinition});
+            }
+         }
+      }
+      if (fields.empty()) {
+         // Anything we don't know/care about is intentionally ignored, just as in the XPath-based version of load()
+         reader.skipCurrentElement();
+         continue;
+      }
+
+      //
+      // With the DOM, Xerces does "datatype normalization" for us during validation, which, amongst other things,
+      // strips leading and trailing whitespace from non-string values.  Here we have to do it ourselves.
+      //
+      QString const value = reader.readElementText(QXmlStreamReader::SkipChildElements);
+      for (auto const & [record, fieldDefinition] : fields) {
+         record->m_streamedFields.insert(fieldDefinition);
+         QString const normalisedValue{
+            XmlRecordDefinition::FieldType::String == fieldDefinition->type ? value : value.trimmed()
+         };
+         // An empty element is the same as an absent one
+         if (!normalisedValue.isEmpty() && !record->loadValue(*fieldDefinition, normalisedValue, userMessage)) {
+            return false;
+         }
+      }
+   }
+
+   return !reader.hasError();
+}
+
+bool XmlRecord::loadStreamedChildRecord(QXmlStreamReader & reader,
+                                        XmlRecord::ChildRecordSet & childRecordSet,
+                                        QTextStream & userMessage,
+                                        ImportRecordCount * statsForImmediateStore) {
+   Q_ASSERT(std::holds_alternative<XmlRecordDefinition const *>(childRecordSet.parentFieldDefinition->valueDecoder));
+   XmlRecordDefinition const & childRecordDefinition{
+      *std::get<XmlRecordDefinition const *>(childRecordSet.parentFieldDefinition->valueDecoder)
+   };
+   std::unique_ptr<XmlRecord> childRecord{
+      childRecordDefinition.xmlRecordConstructorWrapper(this->m_coding, childRecordDefinition)
+   };
+
+   if (!statsForImmediateStore) {
+      if (!childRecord->load(reader, userMessage)) {
+         return false;
+      }
+      childRecordSet.records.push_back(std::move(childRecord));
+      return true;
+   }
+
+   //
+   // This is a top-level record, so we store it straight away, rather than holding on to it until we've read the rest
+   // of the document.  This is what keeps memory use bounded for large files.
+   //
+   {
+      ImportPhaseTimings::ScopedTimer loadTimer{ImportPhaseTimings::Phase::Load};
+      if (!childRecord->load(reader, userMessage)) {
+         return false;
+      }
+   }
+   if (statsForImmediateStore->isCancelled()) {
+      return false;
+   }
+   ImportPhaseTimings::ScopedTimer storeTimer{ImportPhaseTimings::Phase::NormaliseAndStoreInDb};
+   XmlRecord::ProcessingResult const result =
+      childRecord->normaliseAndStoreInDb(this->m_namedEntity, userMessage, *statsForImmediateStore);
+   if (XmlRecord::ProcessingResult::Succeeded == result) {
+      statsForImmediateStore->storedTopLevel(childRecord->namedEntityDeleter());
+   }
+   return XmlRecord::ProcessingResult::Failed != result;
+}
+
 void XmlRecord::toXml(NamedEntity const & namedEntityToExport,
                       QTextStream & out,
                       bool const includeRecordNameTags,
@@ -846,7 +1258,7 @@ void XmlRecord::toXml(NamedEntity const & namedEntityToExport,
                       char const * const indentString) const {
    // Callers are not allowed to supply null indent string
    Q_ASSERT(nullptr != indentString);
-   qDebug() <<
+   qCDebug(Logging::serialization) <<
       Q_FUNC_INFO << "Exporting XML for" << namedEntityToExport.metaObject()->className() << "#" <<
       namedEntityToExport.key();
    if (includeRecordNameTags) {
@@ -892,14 +1304,14 @@ void XmlRecord::toXml(NamedEntity const & namedEntityToExport,
          // records" comment in serialization/json/JsonRecordDefinition.h on JsonRecordDefinition::FieldType::Record.
          // In this case, numContainingTags will be -1.
          //
-         QStringList xPathElements = fieldDefinition.xPath.split("/");
+         QStringList const & xPathElements = fieldDefinition.xPathElements;
          Q_ASSERT(xPathElements.size() >= 1);
          int numContainingTags = xPathElements.size() - 1;
          for (int ii = 0; ii < numContainingTags; ++ii) {
             writeIndents(out, indentLevel + 1 + ii, indentString);
             out << "<" << xPathElements.at(ii) << ">\n";
          }
-         qDebug() <<
+         qCDebug(Logging::serialization) <<
             Q_FUNC_INFO << "Creating XmlRecord for" << fieldDefinition.propertyPath << ".  XPath:" << xPathElements <<
             ";" << xPathElements.last();
          std::unique_ptr<XmlRecord> subRecord{childRecordDefinition.makeRecord(this->m_coding)};
@@ -983,9 +1395,9 @@ void XmlRecord::toXml(NamedEntity const & namedEntityToExport,
          valueAsText = fieldDefinition.propertyPath.asXPath();
       } else {
          // Uncomment this if the assert below is firing
-         qDebug() <<
-            Q_FUNC_INFO << "To write" << fieldDefinition.xPath << ", reading property" <<
-            fieldDefinition.propertyPath << "from" << namedEntityToExport;
+//         qDebug() <<
+//            Q_FUNC_INFO << "To write" << fieldDefinition.xPath << ", reading property" <<
+//            fieldDefinition.propertyPath << "from" << namedEntityToExport;
          QVariant value = fieldDefinition.propertyPath.getValue(namedEntityToExport);
          //
          // In older versions of the code, when we were accessing properties directly, it would be a valid to assert at
@@ -1010,7 +1422,7 @@ void XmlRecord::toXml(NamedEntity const & namedEntityToExport,
 
          // It's a coding error if we are trying here to write out some field with a complex XPath
          if (fieldDefinition.xPath.contains("/")) {
-            qCritical() << Q_FUNC_INFO <<
+            qCCritical(Logging::serialization) << Q_FUNC_INFO <<
                "Invalid use of non-trivial XPath (" << fieldDefinition.xPath << ") for output of property" <<
                fieldDefinition.propertyPath.asXPath() << "of" << namedEntityToExport.metaObject()->className();
             Q_ASSERT(false); // Stop here on a debug build
@@ -1115,16 +1527,15 @@ void XmlRecord::toXml(NamedEntity const & namedEntityToExport,
             case XmlRecordDefinition::FieldType::String:
             default:
                if (Optional::removeOptionalWrapperIfPresent<QString>(value, propertyIsOptional)) {
-                  // We use this to escape "&" to "&amp;" and so on in string content.  (Other data types should not
+                  // We need to escape "&" to "&amp;" and so on in string content.  (Other data types should not
                   // have anything in their string representation that needs escaping in XML.)
-                  QXmlStreamWriter qXmlStreamWriter(&valueAsText);
-                  qXmlStreamWriter.writeCharacters(value.toString());
+                  valueAsText = escapeXmlText(value.toString());
                }
                break;
          }
 
          if (propertyIsOptional && value.isNull()) {
-            qDebug() <<
+            qCDebug(Logging::serialization) <<
                Q_FUNC_INFO << "Not writing XPath" << fieldDefinition.xPath << "as property" <<
                fieldDefinition.propertyPath.asXPath() << "is unset, ie set to std::nullopt";
             continue;
@@ -1132,7 +1543,7 @@ void XmlRecord::toXml(NamedEntity const & namedEntityToExport,
       }
 
       writeIndents(out, indentLevel + 1, indentString);
-      out << "<" << fieldDefinition.xPath << ">" << valueAsText << "</" << fieldDefinition.xPath << ">\n";
+      out << fieldDefinition.openingTag << valueAsText << fieldDefinition.closingTag;
    }
 
    if (includeRecordNameTags) {
@@ -1151,7 +1562,7 @@ void XmlRecord::subRecordToXml(XmlRecordDefinition::FieldDefinition const & fiel
    // Base class does not know how to handle nested records
    // It's a coding error if we get here as this virtual member function should be overridden classes that have nested
    // records.
-   qCritical() << Q_FUNC_INFO <<
+   qCCritical(Logging::serialization) << Q_FUNC_INFO <<
       "Coding error: cannot export" << namedEntityToExport.metaObject()->className() << "(" <<
       this->m_recordDefinition.m_namedEntityClassName << ") property" << fieldDefinition.propertyPath.asXPath() <<
       "to <" << fieldDefinition.xPath << "> from base class XmlRecord";
@@ -1169,7 +1580,7 @@ void XmlRecord::writeNone(XmlRecord const & subRecord,
    // XML coding.  Eg, we allow a recipe to exist without a style, equipment or mash, but, in BeerXML, only the latter
    // two of these three are optional.  For the moment we just log what's going on.
    //
-   qInfo() <<
+   qCInfo(Logging::serialization) <<
       Q_FUNC_INFO << "Skipping" << subRecord.m_recordDefinition.m_recordName << "tag while exporting" <<
       this->m_recordDefinition.m_recordName << "XML record for" << namedEntityToExport.metaObject()->className() <<
       "as no data to write";
@@ -19,8 +19,11 @@
 
 #include <vector>
 
+#include <QSet>
+#include <QStringView>
 #include <QTextStream>
 #include <QVector>
+#include <QXmlStreamReader>
 
 #include <xalanc/DOMSupport/DOMSupport.hpp>
 #include <xalanc/XalanDOM/XalanNode.hpp>
@@ -86,6 +89,39 @@ public:
              xalanc::XalanNode * rootNodeOfRecord,
              QTextStream & userMessage);
 
+   /**
+    * \brief Alternative to the above that loads the record from a pull parser rather than a DOM tree, using the same
+    *        field definitions.  This is what we use for files that are too large to comfortably hold in memory.
+    *
+    *        NB: Unlike the DOM version, there is no validation here, so the caller needs to have already validated the
+    *        document (eg by streaming it through a validating SAX parser).
+    *
+    * \param reader Must be positioned at the start element of this record.  On successful return, it will be
+    *               positioned at the corresponding end element.
+    * \param userMessage Where to append any error messages that we want the user to see on the screen
+    *
+    * \return \b true if load succeeded, \b false if there was an error
+    */
+   bool load(QXmlStreamReader & reader, QTextStream & userMessage);
+
+   /**
+    * \brief For the root record only, load the contents of the document from a pull parser, storing each top-level
+    *        record (and everything inside it) in the DB as soon as it is read, rather than after the whole document
+    *        has been read.  This means we only ever hold one top-level record in memory at a time.
+    *
+    *        Note that this means top-level records are stored in document order, rather than grouped by type in field
+    *        definition order as they are when we load the whole document first.
+    *
+    * \param reader Must be positioned at the start element of the root record
+    * \param userMessage Where to append any error messages that we want the user to see on the screen
+    * \param stats This object keeps tally of how many records (of each type) we skipped or stored
+    *
+    * \return \b true if everything succeeded, \b false if there was an error
+    */
+   bool loadNormaliseAndStoreInDb(QXmlStreamReader & reader,
+                                  QTextStream & userMessage,
+                                  ImportRecordCount & stats);
+
    /**
     * \brief Once the record (including all its sub-records) is loaded into memory, we this function does any final
     *        validation and data correction before then storing the object(s) in the database.  Most validation should
@@ -136,6 +172,43 @@ private:
                          std::vector<xalanc::XalanNode *> & nodesForCurrentXPath,
                          QTextStream & userMessage);
 
+   /**
+    * \brief Parse the text of a simple (ie non-record) field and, if it's one we use, add it to
+    *        \c m_namedParameterBundle
+    *
+    *        \c value is usually a view onto the text of a DOM node.  We only copy it into a \c QString where we need to
+    *        (ie for string fields, which we store, and for the parsing functions that only take \c QString).
+    *
+    * \return \b false if we could not parse a value that we needed, \b true otherwise
+    */
+   bool loadValue(XmlRecordDefinition::FieldDefinition const & fieldDefinition,
+                  QStringView const value,
+                  QTextStream & userMessage);
+
+   /**
+    * \brief Once all the fields are loaded, construct the \c NamedEntity (if any) from \c m_namedParameterBundle
+    */
+   void constructLoadedNamedEntity();
+
+   //! \brief Set up \c m_childRecordSets, including any base records, before we start reading from a pull parser
+   void prepareStreamedLoad();
+
+   //! \brief Construct the \c NamedEntity objects for us and our base records once the pull parser is done with us
+   void finishStreamedLoad();
+
+   //! \brief Get us plus all our base records (recursively), ie the records that read from our element
+   void getStreamedRecords(std::vector<XmlRecord *> & records);
+
+   /**
+    * \brief Read all the child elements of the current element from the pull parser
+    *
+    * \param statsForImmediateStore If not \c nullptr, child records are stored in the DB as soon as they are read,
+    *                               and then discarded, rather than being added to \c m_childRecordSets
+    */
+   bool loadStreamedElements(QXmlStreamReader & reader,
+                             QTextStream & userMessage,
+                             ImportRecordCount * statsForImmediateStore);
+
 protected:
    bool normaliseAndStoreChildRecordsInDb(QTextStream & userMessage,
                                           ImportRecordCount & stats);
@@ -198,6 +271,50 @@ protected:
    };
 
    std::vector<ChildRecordSet> m_childRecordSets;
+
+   /**
+    * \brief When reading from a pull parser, this tells us which simple fields we have already seen, so that, as with
+    *        XPath, only the first instance of each is used.
+    */
+   QSet<XmlRecordDefinition::FieldDefinition const *> m_streamedFields;
+
+private:
+   /**
+    * \brief Read one child record from the pull parser and either add it to \c childRecordSet or, if
+    *        \c statsForImmediateStore is not \c nullptr, store it in the DB.
+    */
+   bool loadStreamedChildRecord(QXmlStreamReader & reader,
+                                ChildRecordSet & childRecordSet,
+                                QTextStream & userMessage,
+                                ImportRecordCount * statsForImmediateStore);
+
+   /**
+    * \brief The first part of \c normaliseAndStoreInDb: the early duplicate check, name normalisation and setting of
+    *        the containing entity, ie everything that needs doing before our \c NamedEntity is stored in the DB.
+    *
+    * \return \b Succeeded if the \c NamedEntity should now be stored, \b FoundDuplicate if it should be skipped
+    */
+   ProcessingResult prepareToStoreInDb(std::shared_ptr<NamedEntity> containingEntity, ImportRecordCount & stats);
+
+   /**
+    * \brief The last part of \c normaliseAndStoreInDb, once our \c NamedEntity (if any) is stored in the DB: storing
+    *        our child records, the late duplicate check, stats and, if need be, clean-up.
+    */
+   ProcessingResult finishStoringInDb(QTextStream & userMessage, ImportRecordCount & stats);
+
+   /**
+    * \brief Equivalent of calling \c normaliseAndStoreInDb on each of the supplied child records (which must all be of
+    *        the same type and have \c canStoreInBatch() \c true) in turn, except that the new objects are all stored
+    *        with one \c ObjectStore::insertMany call.
+    *
+    * \param processedChildren Where to append, in order, the stored objects (or the existing ones they duplicate)
+    *
+    * \return \b true if everything succeeded, \b false if there was an error
+    */
+   bool normaliseAndStoreChildRecordBatchInDb(std::vector< std::unique_ptr<XmlRecord> > & childRecords,
+                                              QList<std::shared_ptr<NamedEntity>> & processedChildren,
+                                              QTextStream & userMessage,
+                                              ImportRecordCount & stats);
 };
 
 #endif
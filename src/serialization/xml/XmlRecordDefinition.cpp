@@ -42,7 +42,10 @@ XmlRecordDefinition::FieldDefinition::FieldDefinition(FieldType    type,
    type{type},
    xPath{xPath},
    propertyPath{propertyPath},
-   valueDecoder{valueDecoder} {
+   valueDecoder{valueDecoder},
+   xPathElements{xPath.split("/")},
+   openingTag{QString{"<%1>"}.arg(xPath)},
+   closingTag{QString{"</%1>\n"}.arg(xPath)} {
    // An XmlRecordDefinition address should be in the valueDecoder if and only if the record type is Record or
    // ListOfRecords.  Otherwise there's a coding error in the mappings in BeerXML.cpp.  We assert this also when we're
    // processing an XML file, but the advantage of doing so here is that we'll get a start-up error, so bugs will be
@@ -67,7 +70,10 @@ XmlRecordDefinition::XmlRecordDefinition(
 ) :
    SerializationRecordDefinition{recordName, typeLookup, namedEntityClassName, localisedEntityName, upAndDownCasters},
    xmlRecordConstructorWrapper{xmlRecordConstructorWrapper},
-   fieldDefinitions{fieldDefinitions} {
+   fieldDefinitions{fieldDefinitions},
+   m_simpleFieldsByTag{},
+   m_recordFieldsByTag{} {
+   this->buildTagLookups();
    return;
 }
 
@@ -82,7 +88,9 @@ XmlRecordDefinition::XmlRecordDefinition(
 ) :
    SerializationRecordDefinition{recordName, typeLookup, namedEntityClassName, localisedEntityName, upAndDownCasters},
    xmlRecordConstructorWrapper{xmlRecordConstructorWrapper},
-   fieldDefinitions{} {
+   fieldDefinitions{},
+   m_simpleFieldsByTag{},
+   m_recordFieldsByTag{} {
    // This is a bit clunky, but it works and the inefficiency is a one-off cost at start-up
    for (auto const & list : fieldDefinitionLists) {
       // After you've initialised a const, you can't modify it, even in the constructor, unless you cast away the
@@ -93,6 +101,7 @@ XmlRecordDefinition::XmlRecordDefinition(
       // You can't do the following with QVector, which is why we're using std::vector here
       myFieldDefinitions.insert(myFieldDefinitions.end(), list.begin(), list.end());
    }
+   this->buildTagLookups();
    return;
 }
 
@@ -100,6 +109,37 @@ std::unique_ptr<XmlRecord> XmlRecordDefinition::makeRecord(XmlCoding const & xml
    return this->xmlRecordConstructorWrapper(xmlCoding, *this);
 }
 
+QVector<int> const & XmlRecordDefinition::simpleFieldsForTag(QString const & tagName) const {
+   static QVector<int> const noFields{};
+   auto const match = this->m_simpleFieldsByTag.constFind(tagName);
+   return match == this->m_simpleFieldsByTag.cend() ? noFields : *match;
+}
+
+int XmlRecordDefinition::recordFieldForTag(QString const & tagName) const {
+   return this->m_recordFieldsByTag.value(tagName, -1);
+}
+
+void XmlRecordDefinition::buildTagLookups() {
+   for (int ii = 0; ii < static_cast<int>(this->fieldDefinitions.size()); ++ii) {
+      FieldDefinition const & fieldDefinition = this->fieldDefinitions[ii];
+      if (fieldDefinition.xPath.isEmpty()) {
+         // Base records are handled separately (see XmlRecord::prepareStreamedLoad)
+         continue;
+      }
+      if (FieldType::Record        == fieldDefinition.type ||
+          FieldType::ListOfRecords == fieldDefinition.type) {
+         // If two record fields start with the same tag, the first one is used
+         QString const & firstTag = fieldDefinition.xPathElements.first();
+         if (!this->m_recordFieldsByTag.contains(firstTag)) {
+            this->m_recordFieldsByTag.insert(firstTag, ii);
+         }
+      } else {
+         this->m_simpleFieldsByTag[fieldDefinition.xPath].append(ii);
+      }
+   }
+   return;
+}
+
 
 template<class S>
 S & operator<<(S & stream, XmlRecordDefinition::FieldType const fieldType) {
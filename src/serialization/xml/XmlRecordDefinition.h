@@ -21,6 +21,11 @@
 #include <utility> // For std::in_place_type_t
 #include <variant>
 
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
 #include "measurement/Unit.h"
 #include "serialization/xml/XQString.h"
 #include "serialization/SerializationRecordDefinition.h"
@@ -82,6 +87,16 @@ public:
                       double                         >;        // Default value (for fields that are required in the XML
                                                                // but optional in our internal data model).
       ValueDecoder valueDecoder;
+      /**
+       * These are all derived from \c xPath, and are worked out once, in the constructor, so that we don't have to
+       * rebuild them for every field of every record we export:
+       *    - \c xPathElements is \c xPath split on '/'
+       *    - \c openingTag and \c closingTag are what we write either side of the value of a simple (ie non-record)
+       *      field.  Note that \c closingTag includes the end-of-line.
+       */
+      QStringList xPathElements;
+      QString     openingTag;
+      QString     closingTag;
       /**
        * Defining a constructor allows us to control the default value of valueDecoder
        */
@@ -194,10 +209,34 @@ public:
     */
    std::unique_ptr<XmlRecord> makeRecord(XmlCoding const & xmlCoding) const;
 
+   /**
+    * \brief When we are reading a record with a pull parser, this gives us, in one hash lookup, the (positions in
+    *        \c fieldDefinitions of the) simple fields whose XPath is \c tagName.  There can be more than one because
+    *        we allow the same XPath to map to more than one property.
+    */
+   QVector<int> const & simpleFieldsForTag(QString const & tagName) const;
+
+   /**
+    * \brief Similarly, returns the position in \c fieldDefinitions of the \c Record or \c ListOfRecords field whose
+    *        XPath starts with \c tagName (eg "HOPS" for "HOPS/HOP"), or -1 if there is none.
+    */
+   int recordFieldForTag(QString const & tagName) const;
+
+private:
+   /**
+    * \brief Called from the constructors to fill in \c m_simpleFieldsByTag and \c m_recordFieldsByTag.  We store
+    *        positions rather than pointers so that nothing breaks if the definition gets copied.
+    */
+   void buildTagLookups();
+
 public:
    XmlRecordConstructorWrapper xmlRecordConstructorWrapper;
 
    std::vector<FieldDefinition> const fieldDefinitions;
+
+private:
+   QHash<QString, QVector<int>> m_simpleFieldsByTag;
+   QHash<QString, int>          m_recordFieldsByTag;
 };
 
 
@@ -16,9 +16,6 @@
  ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
 #include "sortFilterProxyModels/EquipmentSortFilterProxyModel.h"
 
-#include "measurement/Measurement.h"
-#include "measurement/PhysicalQuantity.h"
-
 bool EquipmentSortFilterProxyModel::isLessThan(EquipmentTableModel::ColumnIndex const columnIndex,
                                                QVariant const & leftItem,
                                                QVariant const & rightItem) const {
@@ -29,8 +26,7 @@ bool EquipmentSortFilterProxyModel::isLessThan(EquipmentTableModel::ColumnIndex
       case EquipmentTableModel::ColumnIndex::MashTunVolume:
       case EquipmentTableModel::ColumnIndex::KettleVolume   :
       case EquipmentTableModel::ColumnIndex::FermenterVolume:
-         return (Measurement::qStringToSI( leftItem.toString(), Measurement::PhysicalQuantity::Volume) <
-                 Measurement::qStringToSI(rightItem.toString(), Measurement::PhysicalQuantity::Volume));
+         return leftItem.toDouble() < rightItem.toDouble();
 
       // No default case as we want the compiler to warn us if we missed one
    }
@@ -22,9 +22,6 @@
  ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
 #include "sortFilterProxyModels/FermentableSortFilterProxyModel.h"
 
-#include "measurement/Measurement.h"
-#include "measurement/PhysicalQuantity.h"
-
 bool FermentableSortFilterProxyModel::isLessThan(FermentableTableModel::ColumnIndex const columnIndex,
                                                  QVariant const & leftItem,
                                                  QVariant const & rightItem) const {
@@ -35,16 +32,13 @@ bool FermentableSortFilterProxyModel::isLessThan(FermentableTableModel::ColumnIn
          return leftItem.toString() < rightItem.toString();
 
       case FermentableTableModel::ColumnIndex::TotalInventory:
-         return Measurement::qStringToSI( leftItem.toString(), Measurement::PhysicalQuantity::Mass) <
-                Measurement::qStringToSI(rightItem.toString(), Measurement::PhysicalQuantity::Mass);
+         return leftItem.toDouble() < rightItem.toDouble();
 
       case FermentableTableModel::ColumnIndex::Yield:
-         return Measurement::extractRawFromString<double>( leftItem.toString()) <
-                Measurement::extractRawFromString<double>(rightItem.toString());
+         return leftItem.toDouble() < rightItem.toDouble();
 
       case FermentableTableModel::ColumnIndex::Color:
-         return Measurement::qStringToSI( leftItem.toString(), Measurement::PhysicalQuantity::Color) <
-                Measurement::qStringToSI(rightItem.toString(), Measurement::PhysicalQuantity::Color);
+         return leftItem.toDouble() < rightItem.toDouble();
 
       // No default case as we want the compiler to warn us if we missed one
    }
@@ -21,9 +21,6 @@
  ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
 #include "sortFilterProxyModels/HopSortFilterProxyModel.h"
 
-#include "measurement/Measurement.h"
-#include "measurement/PhysicalQuantity.h"
-
 bool HopSortFilterProxyModel::isLessThan(HopTableModel::ColumnIndex const columnIndex,
                                          QVariant const & leftItem,
                                          QVariant const & rightItem) const {
@@ -35,12 +32,10 @@ bool HopSortFilterProxyModel::isLessThan(HopTableModel::ColumnIndex const column
          return leftItem.toString() < rightItem.toString();
 
       case HopTableModel::ColumnIndex::Alpha:
-         return Measurement::extractRawFromString<double>( leftItem.toString()) <
-                Measurement::extractRawFromString<double>(rightItem.toString());
+         return leftItem.toDouble() < rightItem.toDouble();
 
       case HopTableModel::ColumnIndex::TotalInventory:
-         return Measurement::qStringToSI( leftItem.toString(), Measurement::PhysicalQuantity::Mass) <
-                Measurement::qStringToSI(rightItem.toString(), Measurement::PhysicalQuantity::Mass);
+         return leftItem.toDouble() < rightItem.toDouble();
 
       // No default case as we want the compiler to warn us if we missed one
    }
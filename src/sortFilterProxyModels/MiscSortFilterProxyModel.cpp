@@ -20,9 +20,6 @@
  ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
 #include "sortFilterProxyModels/MiscSortFilterProxyModel.h"
 
-#include "measurement/Measurement.h"
-#include "measurement/PhysicalQuantity.h"
-
 bool MiscSortFilterProxyModel::isLessThan(MiscTableModel::ColumnIndex const columnIndex,
                                           QVariant const & leftItem,
                                           QVariant const & rightItem) const {
@@ -34,14 +31,13 @@ bool MiscSortFilterProxyModel::isLessThan(MiscTableModel::ColumnIndex const colu
          return leftItem.toString() < rightItem.toString();
 
       case MiscTableModel::ColumnIndex::TotalInventory:
-         // It's probably wrong to assume everything is mass, but OTOH, it's not instantly obvious how to sort a mixture
-         // of masses and volumes
-         return Measurement::qStringToSI( leftItem.toString(), Measurement::PhysicalQuantity::Mass) <
-                Measurement::qStringToSI(rightItem.toString(), Measurement::PhysicalQuantity::Mass);
+         // The sort key is the quantity in canonical units, so masses sort amongst themselves correctly, as do volumes.
+         // It's not instantly obvious how to sort a mixture of masses and volumes, so we don't try to do anything
+         // clever there.
+         return leftItem.toDouble() < rightItem.toDouble();
 
 ///      case MiscTableModel::ColumnIndex::Time:
-///         return (Measurement::qStringToSI( leftItem.toString(), Measurement::PhysicalQuantity::Time) <
-///                 Measurement::qStringToSI(rightItem.toString(), Measurement::PhysicalQuantity::Time));
+///         return leftItem.toDouble() < rightItem.toDouble();
 
       // No default case as we want the compiler to warn us if we missed one
    }
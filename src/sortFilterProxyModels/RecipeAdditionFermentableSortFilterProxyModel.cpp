@@ -21,9 +21,6 @@
  ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
 #include "sortFilterProxyModels/RecipeAdditionFermentableSortFilterProxyModel.h"
 
-#include "measurement/Measurement.h"
-#include "measurement/PhysicalQuantity.h"
-
 bool RecipeAdditionFermentableSortFilterProxyModel::isLessThan(RecipeAdditionFermentableTableModel::ColumnIndex const columnIndex,
                                                                QVariant const & leftItem,
                                                                QVariant const & rightItem) const {
@@ -36,20 +33,16 @@ bool RecipeAdditionFermentableSortFilterProxyModel::isLessThan(RecipeAdditionFer
 
       case RecipeAdditionFermentableTableModel::ColumnIndex::TotalInventory:
       case RecipeAdditionFermentableTableModel::ColumnIndex::Amount:
-         return Measurement::qStringToSI( leftItem.toString(), Measurement::PhysicalQuantity::Mass) <
-                Measurement::qStringToSI(rightItem.toString(), Measurement::PhysicalQuantity::Mass);
+         return leftItem.toDouble() < rightItem.toDouble();
 
       case RecipeAdditionFermentableTableModel::ColumnIndex::Time:
-         return Measurement::qStringToSI( leftItem.toString(), Measurement::PhysicalQuantity::Time) <
-                Measurement::qStringToSI(rightItem.toString(), Measurement::PhysicalQuantity::Time);
+         return leftItem.toDouble() < rightItem.toDouble();
 
       case RecipeAdditionFermentableTableModel::ColumnIndex::Yield:
-         return Measurement::extractRawFromString<double>( leftItem.toString()) <
-                Measurement::extractRawFromString<double>(rightItem.toString());
+         return leftItem.toDouble() < rightItem.toDouble();
 
       case RecipeAdditionFermentableTableModel::ColumnIndex::Color:
-         return Measurement::qStringToSI( leftItem.toString(), Measurement::PhysicalQuantity::Color) <
-                Measurement::qStringToSI(rightItem.toString(), Measurement::PhysicalQuantity::Color);
+         return leftItem.toDouble() < rightItem.toDouble();
 
       // No default case as we want the compiler to warn us if we missed one
    }
@@ -21,9 +21,6 @@
  ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
 #include "sortFilterProxyModels/RecipeAdditionHopSortFilterProxyModel.h"
 
-#include "measurement/Measurement.h"
-#include "measurement/PhysicalQuantity.h"
-
 bool RecipeAdditionHopSortFilterProxyModel::isLessThan(RecipeAdditionHopTableModel::ColumnIndex const columnIndex,
                                                        QVariant const & leftItem,
                                                        QVariant const & rightItem) const {
@@ -36,17 +33,14 @@ bool RecipeAdditionHopSortFilterProxyModel::isLessThan(RecipeAdditionHopTableMod
          return leftItem.toString() < rightItem.toString();
 
       case RecipeAdditionHopTableModel::ColumnIndex::Alpha:
-         return Measurement::extractRawFromString<double>( leftItem.toString()) <
-                Measurement::extractRawFromString<double>(rightItem.toString());
+         return leftItem.toDouble() < rightItem.toDouble();
 
       case RecipeAdditionHopTableModel::ColumnIndex::TotalInventory:
       case RecipeAdditionHopTableModel::ColumnIndex::Amount:
-         return Measurement::qStringToSI( leftItem.toString(), Measurement::PhysicalQuantity::Mass) <
-                Measurement::qStringToSI(rightItem.toString(), Measurement::PhysicalQuantity::Mass);
+         return leftItem.toDouble() < rightItem.toDouble();
 
       case RecipeAdditionHopTableModel::ColumnIndex::Time:
-         return Measurement::qStringToSI( leftItem.toString(), Measurement::PhysicalQuantity::Time) <
-                Measurement::qStringToSI(rightItem.toString(), Measurement::PhysicalQuantity::Time);
+         return leftItem.toDouble() < rightItem.toDouble();
 
       // No default case as we want the compiler to warn us if we missed one
    }
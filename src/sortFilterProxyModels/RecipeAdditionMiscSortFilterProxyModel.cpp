@@ -21,9 +21,6 @@
  ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
 #include "sortFilterProxyModels/RecipeAdditionMiscSortFilterProxyModel.h"
 
-#include "measurement/Measurement.h"
-#include "measurement/PhysicalQuantity.h"
-
 bool RecipeAdditionMiscSortFilterProxyModel::isLessThan(RecipeAdditionMiscTableModel::ColumnIndex const columnIndex,
                                                        QVariant const & leftItem,
                                                        QVariant const & rightItem) const {
@@ -36,12 +33,10 @@ bool RecipeAdditionMiscSortFilterProxyModel::isLessThan(RecipeAdditionMiscTableM
 
       case RecipeAdditionMiscTableModel::ColumnIndex::TotalInventory:
       case RecipeAdditionMiscTableModel::ColumnIndex::Amount:
-         return Measurement::qStringToSI( leftItem.toString(), Measurement::PhysicalQuantity::Mass) <
-                Measurement::qStringToSI(rightItem.toString(), Measurement::PhysicalQuantity::Mass);
+         return leftItem.toDouble() < rightItem.toDouble();
 
       case RecipeAdditionMiscTableModel::ColumnIndex::Time:
-         return Measurement::qStringToSI( leftItem.toString(), Measurement::PhysicalQuantity::Time) <
-                Measurement::qStringToSI(rightItem.toString(), Measurement::PhysicalQuantity::Time);
+         return leftItem.toDouble() < rightItem.toDouble();
 
       // No default case as we want the compiler to warn us if we missed one
    }
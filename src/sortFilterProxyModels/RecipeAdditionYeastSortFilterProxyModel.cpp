@@ -21,9 +21,6 @@
  ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
 #include "sortFilterProxyModels/RecipeAdditionYeastSortFilterProxyModel.h"
 
-#include "measurement/Measurement.h"
-#include "measurement/PhysicalQuantity.h"
-
 bool RecipeAdditionYeastSortFilterProxyModel::isLessThan(RecipeAdditionYeastTableModel::ColumnIndex const columnIndex,
                                                          QVariant const & leftItem,
                                                          QVariant const & rightItem) const {
@@ -39,19 +36,11 @@ bool RecipeAdditionYeastSortFilterProxyModel::isLessThan(RecipeAdditionYeastTabl
          return leftItem.toString() < rightItem.toString();
 
       case RecipeAdditionYeastTableModel::ColumnIndex::Attenuation:
-         // Attenuation on a RecipeAdditionYeast is std::optional<double> in the underlying model.  But here, the
-         // leftItem and rightItem QVariants will contain QString eg "75.0 %" or "" (for std::nullopt).
-         //
-         // Measurement::extractRawFromString does pretty much what we want though TODO we should explicitly tell it
-         // blanks are OK.
-         //
-         return Measurement::extractRawFromString<double>( leftItem.toString()) <
-                Measurement::extractRawFromString<double>(rightItem.toString());
-
+         // Attenuation on a RecipeAdditionYeast is std::optional<double> in the underlying model.  Unset values come
+         // through here as an invalid QVariant, which converts to 0.0, so they sort before everything else.
       case RecipeAdditionYeastTableModel::ColumnIndex::TotalInventory:
       case RecipeAdditionYeastTableModel::ColumnIndex::Amount:
-         return Measurement::qStringToSI( leftItem.toString(), Measurement::PhysicalQuantity::Mass) <
-                Measurement::qStringToSI(rightItem.toString(), Measurement::PhysicalQuantity::Mass);
+         return leftItem.toDouble() < rightItem.toDouble();
 
       // No default case as we want the compiler to warn us if we missed one
    }
@@ -18,7 +18,14 @@
 #define SORTFILTERPROXYMODELS_SORTFILTERPROXYMODELBASE_H
 #pragma once
 
+#include <QAbstractItemModel>
 #include <QDebug>
+#include <QHash>
+#include <QSet>
+#include <QString>
+#include <QVariant>
+
+#include "tableModels/BtTableModel.h"
 #include "utils/CuriouslyRecurringTemplateBase.h"
 
 /**
@@ -37,7 +44,11 @@ template<class Derived, class NeTableModel, class NeListModel>
 class SortFilterProxyModelBase : public CuriouslyRecurringTemplateBase<SortFilterProxyModelPhantom, Derived> {
 public:
    SortFilterProxyModelBase(bool filter) :
-      m_filter{filter} {
+      m_filter{filter},
+      m_sortKeyCache{},
+      m_nameFilterText{},
+      m_nameFilterMatches{},
+      m_nameFilterMatchesStale{false} {
       return;
    }
 
@@ -75,10 +86,16 @@ protected:
       //
       NeTableModel * tableModel = qobject_cast<NeTableModel *>(this->derived().sourceModel());
       if (tableModel) {
-         QModelIndex index = tableModel->index(source_row, 0, source_parent);
+         if (!m_filter) {
+            return true;
+         }
 
-         return !m_filter || (tableModel->data(index).toString().contains(this->derived().filterRegExp()) &&
-                              tableModel->getRow(source_row)->display());
+         auto row = tableModel->getRow(source_row);
+         if (!row) {
+            return true;
+         }
+
+         return row->display() && this->nameFilterAccepts(*tableModel, row.get());
       }
 
       NeListModel* listModel = qobject_cast<NeListModel*>(this->derived().sourceModel());
@@ -97,12 +114,8 @@ protected:
    }
 
    bool doLessThan(QModelIndex const & left, QModelIndex const & right) const {
-      QAbstractItemModel * source = this->derived().sourceModel();
-      QVariant leftItem, rightItem;
-      if (source) {
-         leftItem = source->data(left);
-         rightItem = source->data(right);
-      }
+      QVariant const leftItem  = this->sortKey(left );
+      QVariant const rightItem = this->sortKey(right);
 
       // As per more detailed comment in tableModels/ItemDelegate.h, we need "typename" here only until Apple ship Clang
       // 16 or later as their standard C++ compiler.
@@ -110,8 +123,98 @@ protected:
       return this->derived().isLessThan(columnIndex, leftItem, rightItem);
    }
 
+   /**
+    * \brief Called from the derived class's override of \c QSortFilterProxyModel::setSourceModel.  We connect to the
+    *        source model's signals before the base class does, so that our sort key cache is always cleared before
+    *        \c QSortFilterProxyModel tries to re-sort in response to a change.
+    */
+   void connectSourceModel(QAbstractItemModel * sourceModel) {
+      this->m_sortKeyCache.clear();
+      this->m_nameFilterMatchesStale = true;
+      if (sourceModel) {
+         auto clearCache = [this]() {
+            this->m_sortKeyCache.clear();
+            this->m_nameFilterMatchesStale = true;
+            return;
+         };
+         Derived & derived = this->derived();
+         QObject::connect(sourceModel, &QAbstractItemModel::dataChanged           , &derived, clearCache);
+         QObject::connect(sourceModel, &QAbstractItemModel::rowsAboutToBeInserted , &derived, clearCache);
+         QObject::connect(sourceModel, &QAbstractItemModel::rowsAboutToBeRemoved  , &derived, clearCache);
+         QObject::connect(sourceModel, &QAbstractItemModel::rowsAboutToBeMoved    , &derived, clearCache);
+         QObject::connect(sourceModel, &QAbstractItemModel::layoutAboutToBeChanged, &derived, clearCache);
+         QObject::connect(sourceModel, &QAbstractItemModel::modelAboutToBeReset   , &derived, clearCache);
+      }
+      return;
+   }
+
+   /**
+    * \brief Show only rows whose name contains \c searchText (ignoring case and accents), or all rows if it is empty.
+    *        This is what catalog search boxes use.
+    *
+    *        Rather than run a regexp over every row, we ask the table model which rows match (see
+    *        \c TableModelBase::nameMatches) once per change of search text or source model, and then just look each
+    *        row up in the result.
+    */
+   void doSetNameFilter(QString const & searchText) {
+      this->m_nameFilterText = searchText;
+      this->m_nameFilterMatchesStale = true;
+      this->derived().invalidateFilter();
+      return;
+   }
+
 private:
+   bool nameFilterAccepts(NeTableModel const & tableModel, NamedEntity const * entity) const {
+      if (this->m_nameFilterText.isEmpty()) {
+         return true;
+      }
+      if (this->m_nameFilterMatchesStale) {
+         this->m_nameFilterMatches = tableModel.nameMatches(this->m_nameFilterText);
+         this->m_nameFilterMatchesStale = false;
+      }
+      return this->m_nameFilterMatches.contains(entity);
+   }
+
+   /**
+    * \brief Returns the value to sort on for the given cell of the source model.
+    *
+    *        For a table model, this is what it returns for \c BtTableModel::SortRole (ie a raw value, typically in
+    *        canonical units), which saves us parsing display strings (with units, thousands separators etc) back into
+    *        numbers on every comparison.  Since a sort does O(n log n) comparisons, we cache these per cell until the
+    *        source model next changes.
+    *
+    *        List models only have the one column, so we just use the display string there.
+    */
+   QVariant sortKey(QModelIndex const & index) const {
+      QAbstractItemModel * source = this->derived().sourceModel();
+      if (!source) {
+         return QVariant{};
+      }
+
+      if (!qobject_cast<NeTableModel *>(source)) {
+         return source->data(index);
+      }
+
+      quint64 const cacheKey = (static_cast<quint64>(index.row()) << 32) | static_cast<quint32>(index.column());
+      auto cached = this->m_sortKeyCache.constFind(cacheKey);
+      if (cached != this->m_sortKeyCache.constEnd()) {
+         return *cached;
+      }
+
+      QVariant sortKey = source->data(index, BtTableModel::SortRole);
+      this->m_sortKeyCache.insert(cacheKey, sortKey);
+      return sortKey;
+   }
+
    bool const m_filter;
+
+   //! Sort keys (see \c sortKey) indexed by (row << 32 | column) of the source model
+   mutable QHash<quint64, QVariant> m_sortKeyCache;
+
+   QString m_nameFilterText;
+   //! Result of \c TableModelBase::nameMatches for \c m_nameFilterText, unless \c m_nameFilterMatchesStale is set
+   mutable QSet<NamedEntity const *> m_nameFilterMatches;
+   mutable bool m_nameFilterMatchesStale;
 };
 
 
@@ -137,6 +240,11 @@ private:
       virtual bool filterAcceptsRow(int source_row, QModelIndex const & source_parent) const;   \
       /* Override QSortFilterProxyModel::lessThan                                  */           \
       virtual bool lessThan(QModelIndex const & left, QModelIndex const & right) const;         \
+   public:                                                                                      \
+      /* Override QSortFilterProxyModel::setSourceModel                            */           \
+      virtual void setSourceModel(QAbstractItemModel * sourceModel) override;                   \
+      /* See SortFilterProxyModelBase::doSetNameFilter                             */           \
+      void setNameFilter(QString const & searchText);                                           \
    private:                                                                                     \
       /* Called from lessThan to do the work specific to this class                */           \
       bool isLessThan(NeName##TableModel::ColumnIndex const columnIndex,                        \
@@ -165,5 +273,14 @@ private:
                                                QModelIndex const & right) const {                 \
       return this->doLessThan(left, right);                                                       \
    }                                                                                              \
+   void NeName##SortFilterProxyModel::setSourceModel(QAbstractItemModel * sourceModel) {          \
+      this->connectSourceModel(sourceModel);                                                      \
+      this->QSortFilterProxyModel::setSourceModel(sourceModel);                                   \
+      return;                                                                                     \
+   }                                                                                              \
+   void NeName##SortFilterProxyModel::setNameFilter(QString const & searchText) {                 \
+      this->doSetNameFilter(searchText);                                                          \
+      return;                                                                                     \
+   }                                                                                              \
 
 #endif
@@ -19,9 +19,6 @@
 
 #include <iostream>
 
-#include "measurement/Measurement.h"
-#include "measurement/PhysicalQuantity.h"
-
 bool WaterSortFilterProxyModel::isLessThan(WaterTableModel::ColumnIndex const columnIndex,
                                            QVariant const & leftItem,
                                            QVariant const & rightItem) const {
@@ -30,8 +27,7 @@ bool WaterSortFilterProxyModel::isLessThan(WaterTableModel::ColumnIndex const co
          return leftItem.toString() < rightItem.toString();
 
 ///      case WaterTableModel::ColumnIndex::Amount:
-///         return Measurement::qStringToSI( leftItem.toString(), Measurement::PhysicalQuantity::Volume) <
-///                Measurement::qStringToSI(rightItem.toString(), Measurement::PhysicalQuantity::Volume);
+///         return leftItem.toDouble() < rightItem.toDouble();
 
       case WaterTableModel::ColumnIndex::Calcium    :
       case WaterTableModel::ColumnIndex::Bicarbonate:
@@ -39,8 +35,7 @@ bool WaterSortFilterProxyModel::isLessThan(WaterTableModel::ColumnIndex const co
       case WaterTableModel::ColumnIndex::Chloride   :
       case WaterTableModel::ColumnIndex::Sodium     :
       case WaterTableModel::ColumnIndex::Magnesium  :
-         return Measurement::qStringToSI( leftItem.toString(), Measurement::PhysicalQuantity::MassFractionOrConc) <
-                Measurement::qStringToSI(rightItem.toString(), Measurement::PhysicalQuantity::MassFractionOrConc);
+         return leftItem.toDouble() < rightItem.toDouble();
 
       // No default case as we want the compiler to warn us if we missed one
    }
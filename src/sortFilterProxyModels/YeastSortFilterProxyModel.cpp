@@ -20,9 +20,6 @@
  ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
 #include "sortFilterProxyModels/YeastSortFilterProxyModel.h"
 
-#include "measurement/Measurement.h"
-#include "measurement/PhysicalQuantity.h"
-
 bool YeastSortFilterProxyModel::isLessThan(YeastTableModel::ColumnIndex const columnIndex,
                                            QVariant const & leftItem,
                                            QVariant const & rightItem) const {
@@ -36,11 +33,9 @@ bool YeastSortFilterProxyModel::isLessThan(YeastTableModel::ColumnIndex const co
          return leftItem.toString() < rightItem.toString();
 
       case YeastTableModel::ColumnIndex::TotalInventory:
-         // This is a lie. I need to figure out if they are weights or volumes.
-         // and then figure some reasonable way to compare weights to volumes.
-         // Maybe lying isn't such a bad idea
-         return Measurement::qStringToSI( leftItem.toString(), Measurement::PhysicalQuantity::Volume) <
-                Measurement::qStringToSI(rightItem.toString(), Measurement::PhysicalQuantity::Volume);
+         // The sort key is the quantity in canonical units, which is fine for comparing weights with weights and
+         // volumes with volumes.  We don't attempt to do anything clever when comparing weights with volumes.
+         return leftItem.toDouble() < rightItem.toDouble();
 
       // No default case as we want the compiler to warn us if we missed one
    }
@@ -199,6 +199,18 @@ class BtTableModel : public QAbstractTableModel {
    template<class Derived, class NE> friend class TableModelBase;
 
 public:
+   /**
+    * \brief Custom item data role for sorting.  Whereas \c Qt::DisplayRole gives a formatted string (eg "4.5 %" or
+    *        "1.2 kg"), this gives the "raw" value (in canonical units) that sort proxies (see
+    *        sortFilterProxyModels/SortFilterProxyModelBase.h) can compare directly, without having to parse anything:
+    *           - for numbers, including amounts, a \c double (in canonical units)
+    *           - for enums and bools, the same display string as for \c Qt::DisplayRole, so that sort order matches
+    *             what the user sees
+    *           - for an unset optional value, an invalid \c QVariant
+    *           - for anything else, eg strings, the value as-is
+    */
+   static constexpr int SortRole = Qt::UserRole + 1;
+
    /**
     * \brief Extra info stored in \c ColumnInfo (see below) for enum types
     */
@@ -0,0 +1,313 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * tableModels/PagedCatalogModel.h is part of Brewtarget, and is copyright the following authors 2024:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#ifndef TABLEMODELS_PAGEDCATALOGMODEL_H
+#define TABLEMODELS_PAGEDCATALOGMODEL_H
+#pragma once
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+
+#include <QAbstractTableModel>
+#include <QCache>
+#include <QHash>
+#include <QModelIndex>
+#include <QTimer>
+#include <QVariant>
+#include <QVector>
+
+#include "database/ObjectStoreTyped.h"
+#include "database/ObjectStoreWrapper.h"
+#include "model/NamedEntity.h"
+
+/**
+ * \brief An alternative to putting a \c NeTableModel (eg \c HopTableModel) behind a sort/filter proxy for catalogs of
+ *        very large ingredient libraries.  Rather than holding a row for every object in the store, this model asks
+ *        the database (via \c ObjectStore::countPaged and \c ObjectStore::idsOfPage) for the IDs of one page of
+ *        matching rows at a time, with the filtering and sorting done in SQL.
+ *
+ *        We only get the objects for rows that are actually shown, and only keep the most recently shown ones.  With
+ *        the \c lazyObjectLoading setting on, this means we only create objects for rows the user has looked at.
+ *
+ *        Display formatting, flags and headers all come from \c NeTableModel, so that the table looks the same as the
+ *        normal catalog.  The supplied \c NeTableModel must not be observing the database or a recipe; we use it to
+ *        hold the objects we currently have cached, in whatever order they were fetched, and just map our rows to its.
+ *
+ *        This isn't a \c Q_OBJECT, as moc can't handle templates, but it doesn't need any signals or slots of its own.
+ */
+template<class NeTableModel, class NE>
+class PagedCatalogModel : public QAbstractTableModel {
+public:
+   //! Number of rows we fetch IDs for in one query
+   static constexpr int pageSize = 200;
+   //! Number of pages of IDs we remember
+   static constexpr int maxCachedPages = 25;
+   //! Number of objects we hold on to (in \c m_formattingModel).  When we have more, we drop the least recently shown.
+   static constexpr int maxCachedObjects = 1000;
+
+   PagedCatalogModel(NeTableModel & formattingModel, QObject * parent) :
+      QAbstractTableModel{parent},
+      m_formattingModel{formattingModel},
+      m_pageQuery{},
+      m_numRows{0},
+      m_pages{maxCachedPages},
+      m_objects{},
+      m_showCount{0},
+      m_refreshPending{false} {
+      ObjectStoreTyped<NE> & objectStore = ObjectStoreTyped<NE>::getInstance();
+      QObject::connect(&objectStore, &ObjectStore::signalObjectInserted, this, [this]() {
+         this->scheduleRefresh();
+         return;
+      });
+      QObject::connect(&objectStore, &ObjectStore::signalObjectDeleted, this, [this](int id) {
+         this->forgetObject(id);
+         this->scheduleRefresh();
+         return;
+      });
+      QObject::connect(&objectStore,
+                       &ObjectStore::signalPropertyChanged,
+                       this,
+                       [this](int, BtStringConst const & propertyName) {
+                          // Other changes just need a repaint, which m_formattingModel takes care of
+                          if (propertyName == PropertyNames::NamedEntity::name    ||
+                              propertyName == PropertyNames::NamedEntity::deleted ||
+                              propertyName == PropertyNames::NamedEntity::display ||
+                              (this->m_pageQuery.sortProperty && propertyName == *this->m_pageQuery.sortProperty)) {
+                             this->scheduleRefresh();
+                          }
+                          return;
+                       });
+      QObject::connect(&objectStore, &ObjectStore::signalObjectsChangedInBulk, this, [this]() {
+         this->scheduleRefresh();
+         return;
+      });
+
+      QObject::connect(&m_formattingModel, &QAbstractItemModel::dataChanged, this, [this]() {
+         this->allDataChanged();
+         return;
+      });
+      QObject::connect(&m_formattingModel,
+                       &QAbstractItemModel::headerDataChanged,
+                       this,
+                       &QAbstractItemModel::headerDataChanged);
+
+      this->refresh();
+      return;
+   }
+   ~PagedCatalogModel() = default;
+
+   //! \brief Reimplemented from QAbstractTableModel
+   int rowCount(QModelIndex const & parent = QModelIndex()) const override {
+      return parent.isValid() ? 0 : this->m_numRows;
+   }
+
+   //! \brief Reimplemented from QAbstractTableModel
+   int columnCount(QModelIndex const & parent = QModelIndex()) const override {
+      return parent.isValid() ? 0 : this->m_formattingModel.columnCount();
+   }
+
+   //! \brief Reimplemented from QAbstractTableModel
+   QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override {
+      if (orientation == Qt::Vertical) {
+         return this->QAbstractTableModel::headerData(section, orientation, role);
+      }
+      return this->m_formattingModel.headerData(section, orientation, role);
+   }
+
+   //! \brief Reimplemented from QAbstractTableModel
+   QVariant data(QModelIndex const & index, int role = Qt::DisplayRole) const override {
+      QModelIndex const formattingIndex = this->formattingIndexFor(index);
+      if (!formattingIndex.isValid()) {
+         return QVariant();
+      }
+      return this->m_formattingModel.data(formattingIndex, role);
+   }
+
+   //! \brief Reimplemented from QAbstractTableModel
+   Qt::ItemFlags flags(QModelIndex const & index) const override {
+      QModelIndex const formattingIndex = this->formattingIndexFor(index);
+      if (!formattingIndex.isValid()) {
+         return Qt::NoItemFlags;
+      }
+      return this->m_formattingModel.flags(formattingIndex);
+   }
+
+   /**
+    * \brief Reimplemented from QAbstractItemModel.  We can only sort by columns that are stored in the primary table
+    *        of \c NE's store (see \c ObjectStore::PageQuery::sortProperty); anything else sorts by name.
+    */
+   void sort(int column, Qt::SortOrder order = Qt::AscendingOrder) override {
+      auto const & propertyPath = this->m_formattingModel.getColumnInfo(static_cast<size_t>(column)).propertyPath;
+      auto const & properties = propertyPath.properties();
+      this->m_pageQuery.sortProperty = properties.size() == 1 ? properties.at(0) : nullptr;
+      this->m_pageQuery.ascending = (order == Qt::AscendingOrder);
+      this->refresh();
+      return;
+   }
+
+   /**
+    * \brief Only show rows whose name contains \c searchText (ignoring case)
+    */
+   void setNameFilter(QString const & searchText) {
+      if (searchText == this->m_pageQuery.nameContains) {
+         return;
+      }
+      this->m_pageQuery.nameContains = searchText;
+      this->refresh();
+      return;
+   }
+
+   /**
+    * \return The object shown in row \c row, or \c nullptr if there isn't one
+    */
+   std::shared_ptr<NE> getRow(int const row) const {
+      if (row < 0 || row >= this->m_numRows) {
+         return nullptr;
+      }
+
+      int const pageNumber = row / pageSize;
+      QVector<int> const * pageIds = this->m_pages.object(pageNumber);
+      if (!pageIds) {
+         auto fetchedIds = new QVector<int>{
+            ObjectStoreTyped<NE>::getInstance().idsOfPage(this->m_pageQuery, pageNumber * pageSize, pageSize)
+         };
+         pageIds = fetchedIds;
+         // QCache takes ownership, and drops the least recently used page if it's full
+         this->m_pages.insert(pageNumber, fetchedIds);
+      }
+      int const rowInPage = row % pageSize;
+      if (rowInPage >= pageIds->size()) {
+         // Rows have been removed since we counted them, and we haven't refreshed yet
+         return nullptr;
+      }
+      int const id = pageIds->at(rowInPage);
+
+      auto cached = this->m_objects.find(id);
+      if (cached != this->m_objects.end()) {
+         cached->lastShown = ++this->m_showCount;
+         return cached->object;
+      }
+
+      auto item = ObjectStoreWrapper::getById<NE>(id);
+      if (item) {
+         this->m_objects.insert(id, CachedObject{item, ++this->m_showCount});
+         this->m_formattingModel.add(item);
+         this->dropLeastRecentlyShown();
+      }
+      return item;
+   }
+
+private:
+   struct CachedObject {
+      std::shared_ptr<NE> object;
+      //! Value of m_showCount when the object's row was last shown
+      quint64 lastShown;
+   };
+
+   QModelIndex formattingIndexFor(QModelIndex const & index) const {
+      if (!index.isValid()) {
+         return QModelIndex();
+      }
+      auto item = this->getRow(index.row());
+      if (!item) {
+         return QModelIndex();
+      }
+      int const formattingRow = this->m_formattingModel.findIndexOf(item.get());
+      if (formattingRow < 0) {
+         return QModelIndex();
+      }
+      return this->m_formattingModel.index(formattingRow, index.column());
+   }
+
+   /**
+    * \brief If we are holding more than \c maxCachedObjects, drop the least recently shown quarter of them.  (Doing a
+    *        quarter at a time means we don't have to do this every time a new row is shown.)
+    */
+   void dropLeastRecentlyShown() const {
+      if (this->m_objects.size() <= maxCachedObjects) {
+         return;
+      }
+      QVector<std::pair<quint64, int>> byLastShown;
+      byLastShown.reserve(this->m_objects.size());
+      for (auto ii = this->m_objects.cbegin(); ii != this->m_objects.cend(); ++ii) {
+         byLastShown.append(std::make_pair(ii.value().lastShown, ii.key()));
+      }
+      int const numToDrop = static_cast<int>(byLastShown.size()) - maxCachedObjects * 3 / 4;
+      std::nth_element(byLastShown.begin(), byLastShown.begin() + numToDrop, byLastShown.end());
+      for (int ii = 0; ii < numToDrop; ++ii) {
+         this->forgetObject(byLastShown.at(ii).second);
+      }
+      return;
+   }
+
+   void forgetObject(int const id) const {
+      auto cached = this->m_objects.find(id);
+      if (cached != this->m_objects.end()) {
+         this->m_formattingModel.remove(cached->object);
+         this->m_objects.erase(cached);
+      }
+      return;
+   }
+
+   /**
+    * \brief Changes often come in bunches (eg an import adding thousands of hops), so we wait until control returns
+    *        to the event loop and then re-query once.
+    */
+   void scheduleRefresh() {
+      if (!this->m_refreshPending) {
+         this->m_refreshPending = true;
+         QTimer::singleShot(0, this, [this]() { this->refresh(); return; });
+      }
+      return;
+   }
+
+   void refresh() {
+      this->m_refreshPending = false;
+      this->beginResetModel();
+      this->m_pages.clear();
+      this->m_numRows = std::max(ObjectStoreTyped<NE>::getInstance().countPaged(this->m_pageQuery), 0);
+      this->endResetModel();
+      return;
+   }
+
+   void allDataChanged() {
+      if (this->m_numRows > 0) {
+         emit this->dataChanged(this->index(0, 0), this->index(this->m_numRows - 1, this->columnCount() - 1));
+      }
+      return;
+   }
+
+   //================================================ Member Variables =================================================
+
+   NeTableModel & m_formattingModel;
+
+   ObjectStore::PageQuery m_pageQuery;
+
+   //! Number of rows matching m_pageQuery when we last counted
+   int m_numRows;
+
+   //! IDs of the rows on each page, by page number.  QCache does the least-recently-used bookkeeping for us.
+   mutable QCache<int, QVector<int>> m_pages;
+
+   //! The objects we are holding on to (which are also the rows of m_formattingModel), by ID
+   mutable QHash<int, CachedObject> m_objects;
+   //! Incremented every time a row is shown
+   mutable quint64 m_showCount;
+
+   bool m_refreshPending;
+};
+
+#endif
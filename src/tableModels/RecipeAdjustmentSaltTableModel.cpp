@@ -71,7 +71,10 @@ RecipeAdjustmentSaltTableModel::RecipeAdjustmentSaltTableModel(QTableView* paren
                                                                                                    PropertyNames::Salt::percentAcid         }}),
       }
    },
-   TableModelBase<RecipeAdjustmentSaltTableModel, RecipeAdjustmentSalt>{} {
+   TableModelBase<RecipeAdjustmentSaltTableModel, RecipeAdjustmentSalt>{},
+   m_cachedRows{},
+   m_totals{},
+   m_spargeSettings{} {
    setObjectName("saltTable");
 
    QHeaderView* headerView = m_parentTableWidget->horizontalHeader();
@@ -85,6 +88,13 @@ RecipeAdjustmentSaltTableModel::~RecipeAdjustmentSaltTableModel() = default;
 
 void RecipeAdjustmentSaltTableModel::added  ([[maybe_unused]] std::shared_ptr<RecipeAdjustmentSalt> item) { return; }
 void RecipeAdjustmentSaltTableModel::removed(std::shared_ptr<RecipeAdjustmentSalt> item) {
+   // Take the row out of the totals now, as rows are identified by address and this one is about to go away
+   auto cached = this->m_cachedRows.find(item.get());
+   if (cached != this->m_cachedRows.end()) {
+      this->applyToTotals(cached->contribution, -1.0);
+      this->m_cachedRows.erase(cached);
+   }
+
    // Dead salts do not malinger in the database. This will
    // delete the thing, not just mark it deleted
    if (item->key() > 0) {
@@ -95,7 +105,10 @@ void RecipeAdjustmentSaltTableModel::removed(std::shared_ptr<RecipeAdjustmentSal
    emit newTotals();
    return;
 }
-void RecipeAdjustmentSaltTableModel::updateTotals() { return; }
+void RecipeAdjustmentSaltTableModel::updateTotals() {
+   this->refreshTotals();
+   return;
+}
 
 void RecipeAdjustmentSaltTableModel::catchSalt() {
    // TODO: Need to give the saltAdjustment a Salt, which needs to be something that exists in the DB
@@ -125,61 +138,137 @@ double RecipeAdjustmentSaltTableModel::multiplier(RecipeAdjustmentSalt & salt) c
    return ret * 1000.0;
 }
 
+std::optional<std::pair<bool, double>> RecipeAdjustmentSaltTableModel::spargeSettings() const {
+   if (!this->recObs || !this->recObs->mash()) {
+      return std::nullopt;
+   }
+   auto mash = this->recObs->mash();
+   if (!mash->hasSparge()) {
+      return std::make_pair(false, 0.0);
+   }
+   double const infusion_l = mash->totalInfusionAmount_l();
+   return std::make_pair(true, infusion_l > 0.0 ? mash->totalSpargeAmount_l() / infusion_l : 0.0);
+}
+
+RecipeAdjustmentSaltTableModel::Contribution RecipeAdjustmentSaltTableModel::contributionOf(
+   RecipeAdjustmentSalt & saltAdjustment
+) const {
+   Salt const * salt = saltAdjustment.salt();
+   if (!salt || !this->recObs || !this->recObs->mash()) {
+      // Newly-added row where the user hasn't yet chosen the salt, or nothing to add it to
+      return Contribution{};
+   }
+
+   double const amount = this->multiplier(saltAdjustment) * saltAdjustment.amount().quantity;
+   return Contribution{
+      .Ca         = amount * salt->massConcPpm_Ca_perGramPerLiter  (),
+      .Cl         = amount * salt->massConcPpm_Cl_perGramPerLiter  (),
+      .CO3        = amount * salt->massConcPpm_CO3_perGramPerLiter (),
+      .HCO3       = amount * salt->massConcPpm_HCO3_perGramPerLiter(),
+      .Mg         = amount * salt->massConcPpm_Mg_perGramPerLiter  (),
+      .Na         = amount * salt->massConcPpm_Na_perGramPerLiter  (),
+      .SO4        = amount * salt->massConcPpm_SO4_perGramPerLiter (),
+      .type       = salt->type(),
+      .amount     = amount,
+      .acidWeight = saltAdjustment.amount().quantity * this->acidWeightPerUnitAmount(saltAdjustment),
+   };
+}
+
+void RecipeAdjustmentSaltTableModel::applyToTotals(Contribution const & contribution, double const sign) const {
+   this->m_totals.Ca   += sign * contribution.Ca  ;
+   this->m_totals.Cl   += sign * contribution.Cl  ;
+   this->m_totals.CO3  += sign * contribution.CO3 ;
+   this->m_totals.HCO3 += sign * contribution.HCO3;
+   this->m_totals.Mg   += sign * contribution.Mg  ;
+   this->m_totals.Na   += sign * contribution.Na  ;
+   this->m_totals.SO4  += sign * contribution.SO4 ;
+   if (contribution.type) {
+      this->m_totals.amount    [*contribution.type] += sign * contribution.amount;
+      this->m_totals.acidWeight[*contribution.type] += sign * contribution.acidWeight;
+   }
+   return;
+}
+
+void RecipeAdjustmentSaltTableModel::refreshTotals() const {
+   // If the mash settings have changed, every row's multiplier might have, so we start again from scratch
+   auto const currentSpargeSettings = this->spargeSettings();
+   if (currentSpargeSettings != this->m_spargeSettings) {
+      this->m_cachedRows.clear();
+      this->m_totals = Totals{};
+      this->m_spargeSettings = currentSpargeSettings;
+   }
+
+   for (auto cached = this->m_cachedRows.begin(); cached != this->m_cachedRows.end(); ) {
+      if (this->findIndexOf(cached.key()) < 0) {
+         this->applyToTotals(cached->contribution, -1.0);
+         cached = this->m_cachedRows.erase(cached);
+      } else {
+         ++cached;
+      }
+   }
+   if (this->m_cachedRows.isEmpty()) {
+      // Start from exact zeros rather than whatever rounding errors the removals above have left
+      this->m_totals = Totals{};
+   }
+
+   for (auto const & saltAdjustment : this->rows) {
+      Salt const * salt = saltAdjustment->salt();
+      unsigned int const saltChangeCount = salt ? salt->changeCount() : 0;
+      auto cached = this->m_cachedRows.find(saltAdjustment.get());
+      if (cached != this->m_cachedRows.end()) {
+         if (cached->changeCount     == saltAdjustment->changeCount() &&
+             cached->salt            == salt                          &&
+             cached->saltChangeCount == saltChangeCount) {
+            continue;
+         }
+         this->applyToTotals(cached->contribution, -1.0);
+      }
+      CachedRow const row{
+         .changeCount     = saltAdjustment->changeCount(),
+         .salt            = salt,
+         .saltChangeCount = saltChangeCount,
+         .contribution    = this->contributionOf(*saltAdjustment),
+      };
+      this->applyToTotals(row.contribution, 1.0);
+      this->m_cachedRows.insert(saltAdjustment.get(), row);
+   }
+   return;
+}
+
 // total salt in ppm. Not sure this is helping.
 double RecipeAdjustmentSaltTableModel::total_Ca() const {
-   double ret = 0.0;
-   for (auto saltAdjustment : this->rows) {
-      ret += this->multiplier(*saltAdjustment) * saltAdjustment->salt()->massConcPpm_Ca_perGramPerLiter();
-   }
-   return ret;
+   this->refreshTotals();
+   return this->m_totals.Ca;
 }
 
 double RecipeAdjustmentSaltTableModel::total_Cl() const {
-   double ret = 0.0;
-   for (auto saltAdjustment : this->rows) {
-      ret += this->multiplier(*saltAdjustment) * saltAdjustment->salt()->massConcPpm_Cl_perGramPerLiter();
-   }
-   return ret;
+   this->refreshTotals();
+   return this->m_totals.Cl;
 }
 
 double RecipeAdjustmentSaltTableModel::total_CO3() const {
-   double ret = 0.0;
-   for (auto saltAdjustment : this->rows) {
-      ret += this->multiplier(*saltAdjustment) * saltAdjustment->salt()->massConcPpm_CO3_perGramPerLiter();
-   }
-   return ret;
+   this->refreshTotals();
+   return this->m_totals.CO3;
 }
 
 double RecipeAdjustmentSaltTableModel::total_HCO3() const {
-   double ret = 0.0;
-   for (auto saltAdjustment : this->rows) {
-      ret += this->multiplier(*saltAdjustment) * saltAdjustment->salt()->massConcPpm_HCO3_perGramPerLiter();
-   }
-   return ret;
+   this->refreshTotals();
+   return this->m_totals.HCO3;
 }
 
 double RecipeAdjustmentSaltTableModel::total_Mg() const {
-   double ret = 0.0;
-   for (auto saltAdjustment : this->rows) {
-      ret += this->multiplier(*saltAdjustment) * saltAdjustment->salt()->massConcPpm_Mg_perGramPerLiter();
-   }
-   return ret;
+   this->refreshTotals();
+   return this->m_totals.Mg;
 }
 
 double RecipeAdjustmentSaltTableModel::total_Na() const {
-   double ret = 0.0;
-   for (auto saltAdjustment : this->rows) {
-      ret += this->multiplier(*saltAdjustment) * saltAdjustment->salt()->massConcPpm_Na_perGramPerLiter();
-   }
-   return ret;
+   this->refreshTotals();
+   return this->m_totals.Na;
 }
 
 double RecipeAdjustmentSaltTableModel::total_SO4() const {
-   double ret = 0.0;
-   for (auto saltAdjustment : this->rows) {
-      ret += this->multiplier(*saltAdjustment) * saltAdjustment->salt()->massConcPpm_SO4_perGramPerLiter();
-   }
-   return ret;
+   this->refreshTotals();
+   return this->m_totals.SO4;
 }
 
 double RecipeAdjustmentSaltTableModel::total(Water::Ion ion) const {
@@ -197,45 +286,54 @@ double RecipeAdjustmentSaltTableModel::total(Water::Ion ion) const {
 
 double RecipeAdjustmentSaltTableModel::total(Salt::Type type) const {
    // .:TBD:. Some assumptions in here that mass and volume are interchangeable... :-/
-   double ret = 0.0;
-   for (auto saltAdjustment : this->rows) {
-      if (saltAdjustment->salt()->type() == type) {
-         ret += this->multiplier(*saltAdjustment) * saltAdjustment->amount().quantity;
-      }
-   }
-   return ret;
+   this->refreshTotals();
+   auto const total = this->m_totals.amount.find(type);
+   return total == this->m_totals.amount.end() ? 0.0 : total->second;
 }
 
-double RecipeAdjustmentSaltTableModel::totalAcidWeight(Salt::Type type) const {
+double RecipeAdjustmentSaltTableModel::acidWeightPerUnitAmount(RecipeAdjustmentSalt & saltAdjustment) const {
    constexpr double H3PO4_density  = 1.685;
    constexpr double lactic_density = 1.2;
 
    // .:TODO:. There are assumptions in here about measurement being by weight or by volume.  We should check or assert
    //          these.
-   double ret = 0.0;
-   for (auto saltAdjustment : this->rows) {
-      auto salt = saltAdjustment->salt();
-      if (salt->type() == type) {
-         double mult  = multiplier(*saltAdjustment);
-         if (type == Salt::Type::AcidulatedMalt) {
-            // Acid malts are easy
-            Q_ASSERT(salt->percentAcid());
-            ret += 1000.0 * saltAdjustment->amount().quantity * *salt->percentAcid();
-         } else if (type == Salt::Type::LacticAcid) {
+   auto salt = saltAdjustment.salt();
+   switch (salt->type()) {
+      case Salt::Type::AcidulatedMalt:
+         // Acid malts are easy
+         Q_ASSERT(salt->percentAcid());
+         return 1000.0 * *salt->percentAcid();
+      case Salt::Type::LacticAcid:
+         {
             // Lactic acid isn't quite so easy
             Q_ASSERT(salt->percentAcid());
             double density = *salt->percentAcid()/88.0 * (lactic_density - 1.0) + 1.0;
-            double lactic_wgt = 1000.0 * saltAdjustment->amount().quantity * mult * density;
-            ret += (*salt->percentAcid()/100.0) * lactic_wgt;
-         } else if (type == Salt::Type::H3PO4) {
+            double lactic_wgt = 1000.0 * this->multiplier(saltAdjustment) * density;
+            return (*salt->percentAcid()/100.0) * lactic_wgt;
+         }
+      case Salt::Type::H3PO4:
+         {
             Q_ASSERT(salt->percentAcid());
             double density = *salt->percentAcid()/85.0 * (H3PO4_density - 1.0) + 1.0;
-            double H3PO4_wgt = 1000.0 * saltAdjustment->amount().quantity * density;
-            ret += (*salt->percentAcid()/100.0) * H3PO4_wgt;
+            double H3PO4_wgt = 1000.0 * density;
+            return (*salt->percentAcid()/100.0) * H3PO4_wgt;
          }
-      }
+      case Salt::Type::CaCl2:
+      case Salt::Type::CaCO3:
+      case Salt::Type::CaSO4:
+      case Salt::Type::MgSO4:
+      case Salt::Type::NaCl:
+      case Salt::Type::NaHCO3:
+         break;
+      // No default case as we want the compiler to warn us if we missed one
    }
-   return ret;
+   return 0.0;
+}
+
+double RecipeAdjustmentSaltTableModel::totalAcidWeight(Salt::Type type) const {
+   this->refreshTotals();
+   auto const total = this->m_totals.acidWeight.find(type);
+   return total == this->m_totals.acidWeight.end() ? 0.0 : total->second;
 }
 
 QVariant RecipeAdjustmentSaltTableModel::data(QModelIndex const & index, int role) const {
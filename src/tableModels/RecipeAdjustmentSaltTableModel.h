@@ -20,6 +20,11 @@
 #define TABLEMODELS_RECIPEADJUSTMENTSALTTABLEMODEL_H
 #pragma once
 
+#include <map>
+#include <optional>
+#include <utility>
+
+#include <QHash>
 #include <QItemDelegate>
 #include <QList>
 #include <QMetaProperty>
@@ -59,6 +64,10 @@ template <> struct TableModelTraits<RecipeAdjustmentSaltTableModel> {
  * \class RecipeAdjustmentSaltTableModel
  *
  * \brief Table model for salts.
+ *
+ *        The totals (of each ion, of each type of salt, and of acid) are kept as running sums, along with what each row
+ *        contributed to them.  When one row changes, we just take off its old contribution and add on its new one,
+ *        rather than going back over all the rows for every total the water dialog asks for.
  */
 class RecipeAdjustmentSaltTableModel :
    public BtTableModelRecipeObserver,
@@ -80,6 +89,18 @@ public:
    double total(Salt::Type type) const;
    double totalAcidWeight(Salt::Type type) const;
 
+   /**
+    * \brief How many grams (or millilitres) of salt one unit of \c salt's amount adds to the brewing water as a whole,
+    *        taking into account whether it is added to the mash, the sparge or both.
+    */
+   double multiplier(RecipeAdjustmentSalt & salt) const;
+
+   /**
+    * \brief The weight of acid contributed by one unit of \c salt's amount.  Zero if the salt is not an acid.  (This is
+    *        what \c totalAcidWeight sums, scaled by each addition's amount.)
+    */
+   double acidWeightPerUnitAmount(RecipeAdjustmentSalt & salt) const;
+
    void saveAndClose();
 
 public slots:
@@ -89,8 +110,62 @@ signals:
    void newTotals();
 
 private:
-///   double spargePct;
-   double multiplier(RecipeAdjustmentSalt & salt) const;
+   //! What one row adds to the totals
+   struct Contribution {
+      double Ca   = 0.0;
+      double Cl   = 0.0;
+      double CO3  = 0.0;
+      double HCO3 = 0.0;
+      double Mg   = 0.0;
+      double Na   = 0.0;
+      double SO4  = 0.0;
+      std::optional<Salt::Type> type = std::nullopt;
+      double amount     = 0.0;
+      double acidWeight = 0.0;
+   };
+
+   //! The sums of all the rows' contributions
+   struct Totals {
+      double Ca   = 0.0;
+      double Cl   = 0.0;
+      double CO3  = 0.0;
+      double HCO3 = 0.0;
+      double Mg   = 0.0;
+      double Na   = 0.0;
+      double SO4  = 0.0;
+      std::map<Salt::Type, double> amount     = {};
+      std::map<Salt::Type, double> acidWeight = {};
+   };
+
+   //! A row's contribution, along with what we need to know to tell whether it is still valid
+   struct CachedRow {
+      unsigned int changeCount;
+      Salt const * salt;
+      unsigned int saltChangeCount;
+      Contribution contribution;
+   };
+
+   Contribution contributionOf(RecipeAdjustmentSalt & saltAdjustment) const;
+
+   //! \param sign +1.0 to add \c contribution to the totals, -1.0 to take it off
+   void applyToTotals(Contribution const & contribution, double const sign) const;
+
+   /**
+    * \return Whether the mash has a sparge and, if so, the ratio of sparge to infusion water, or \c std::nullopt if
+    *         there is no mash.  These are the mash settings that \c multiplier depends on, so, if they change, every
+    *         row's contribution needs to be worked out again.
+    */
+   std::optional<std::pair<bool, double>> spargeSettings() const;
+
+   /**
+    * \brief Bring the totals up to date.  Only rows that have been added, removed or changed since the last call are
+    *        looked at in any detail.
+    */
+   void refreshTotals() const;
+
+   mutable QHash<RecipeAdjustmentSalt const *, CachedRow> m_cachedRows;
+   mutable Totals m_totals;
+   mutable std::optional<std::pair<bool, double>> m_spargeSettings;
 };
 
 //======================================= CLASS RecipeAdjustmentSaltItemDelegate =======================================
@@ -17,6 +17,8 @@
 #define TABLEMODELS_STEPTABLEMODELBASE_H
 #pragma once
 
+#include <algorithm>
+
 #include <QDebug>
 
 #include "utils/CuriouslyRecurringTemplateBase.h"
@@ -53,6 +55,7 @@ protected:
             this->derived().disconnect(step.get(), nullptr, &this->derived(), nullptr);
          }
          this->derived().rows.clear();
+         this->derived().reindexRows();
          this->derived().endRemoveRows();
       }
 
@@ -80,6 +83,7 @@ protected:
                "rows";
             this->derived().beginInsertRows(QModelIndex(), 0, tmpSteps.size() - 1);
             this->derived().rows = tmpSteps;
+            this->derived().reindexRows();
             for (auto step : this->derived().rows) {
                this->derived().connect(step.get(), &NamedEntity::changed, &this->derived(), &Derived::stepChanged);
             }
@@ -101,7 +105,7 @@ protected:
 
    //! \returns true if \c step is successfully found and removed.
    bool doRemoveStep(std::shared_ptr<StepClass> step) {
-      int ii {this->derived().rows.indexOf(step)};
+      int ii {this->derived().findIndexOf(step.get())};
       if (ii >= 0) {
          qDebug() <<
             Q_FUNC_INFO << "Removing" << StepClass::staticMetaObject.className() << step->name() << "(#" <<
@@ -109,6 +113,7 @@ protected:
          this->derived().beginRemoveRows(QModelIndex(), ii, ii);
          this->derived().disconnect(step.get(), nullptr, &this->derived(), nullptr);
          this->derived().rows.removeAt(ii);
+         this->derived().reindexRows(ii, step.get());
          //reset(); // Tell everybody the table has changed.
          this->derived().endRemoveRows();
 
@@ -165,6 +170,7 @@ protected:
 #else
       this->derived().rows.swapItemsAt(current, current + doSomething);
 #endif
+      this->derived().reindexRows(std::min(current, current + doSomething));
       this->derived().endMoveRows();
       return;
    }
@@ -212,6 +218,7 @@ protected:
 
          int ii = this->derived().findIndexOf(stepSender);
          if (ii >= 0) {
+            this->derived().forgetDisplayStrings(stepSender);
             if (prop.name() == PropertyNames::Step::stepNumber) {
                this->reorderStep(this->derived().rows.at(ii), ii);
             }
@@ -0,0 +1,469 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * tableModels/StyleConformanceTableModel.cpp is part of Brewtarget, and is copyright the following authors 2024:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#include "tableModels/StyleConformanceTableModel.h"
+
+#include <QBrush>
+#include <QCoreApplication>
+#include <QDebug>
+#include <QHash>
+#include <QMetaProperty>
+#include <QPalette>
+#include <QPointer>
+#include <QRunnable>
+#include <QSet>
+#include <QThread>
+#include <QThreadPool>
+#include <QTimer>
+
+#include "database/ObjectStoreWrapper.h"
+#include "Logging.h"
+#include "model/Recipe.h"
+#include "model/Style.h"
+#include "RecipeEvaluator.h"
+
+namespace {
+   /**
+    * \brief How long to wait after a recipe changes before rescanning it.  A single edit usually results in a burst of
+    *        signals (eg the recipe recalculating several values), and we only want to scan once for all of them.
+    */
+   int constexpr rescanDelay_ms = 250;
+
+   //! We don't report on recipes the user can't see (eg old versions or ones that have been deleted)
+   bool isScannable(Recipe const & recipe) {
+      return recipe.display() && !recipe.deleted();
+   }
+
+   //! \return Number of decimal places to show for \c parameter
+   int decimalsFor(StyleConformance::Parameter const parameter) {
+      switch (parameter) {
+         case StyleConformance::Parameter::og       :
+         case StyleConformance::Parameter::fg       : return 3;
+         case StyleConformance::Parameter::ibu      : return 0;
+         case StyleConformance::Parameter::color_srm:
+         case StyleConformance::Parameter::abv_pct  : return 1;
+      }
+      return 1;
+   }
+
+   QString formatValue(StyleConformance::Parameter const parameter, std::optional<double> const value) {
+      if (!value) {
+         return QStringLiteral("-");
+      }
+      return QString::number(*value, 'f', decimalsFor(parameter));
+   }
+
+   /**
+    * \brief The bits of a recipe we need on the GUI thread once its snapshot has been evaluated.  These are captured
+    *        at the same time as the snapshot so that the result reflects a single point in time.
+    */
+   struct PendingScan {
+      int          recipeId;
+      unsigned int scanNumber;
+      QString      recipeName;
+      QString      styleName;
+      std::array<StyleConformance::Range, StyleConformance::numParameters> ranges;
+   };
+}
+
+// This private implementation class holds all private non-virtual members of StyleConformanceTableModel
+class StyleConformanceTableModel::impl {
+public:
+   impl(StyleConformanceTableModel & self) :
+      m_self{self},
+      m_rows{},
+      m_rowOfRecipe{},
+      m_latestScanOfRecipe{},
+      m_latestScanNumber{0},
+      m_numScansInProgress{0},
+      m_recipesToRescan{},
+      m_observedRecipes{},
+      m_rescanTimer{} {
+      this->m_rescanTimer.setSingleShot(true);
+      this->m_rescanTimer.setInterval(rescanDelay_ms);
+      QObject::connect(&this->m_rescanTimer, &QTimer::timeout, &this->m_self, [this]() {
+         QList<int> const recipeIds = this->m_recipesToRescan.values();
+         this->m_recipesToRescan.clear();
+         this->scan(recipeIds);
+         return;
+      });
+      return;
+   }
+
+   ~impl() = default;
+
+   /**
+    * \brief Ask for a recipe to be rescanned once things have settled down
+    */
+   void scheduleRescan(int const recipeId) {
+      this->m_recipesToRescan.insert(recipeId);
+      this->m_rescanTimer.start();
+      return;
+   }
+
+   /**
+    * \brief Snapshot the supplied recipes and evaluate them in the background.  Recipes that no longer exist, or that
+    *        should not be shown, have their rows removed straight away.
+    */
+   void scan(QList<int> const & recipeIds) {
+      // It's a coding error to call this other than on the GUI thread, as that's the thread that owns the recipes
+      Q_ASSERT(QThread::currentThread() == QCoreApplication::instance()->thread());
+
+      unsigned int const scanNumber = ++this->m_latestScanNumber;
+
+      QVector<PendingScan>               pendingScans;
+      QVector<RecipeEvaluator::Snapshot> snapshots;
+      pendingScans.reserve(recipeIds.size());
+      snapshots   .reserve(recipeIds.size());
+      for (int const recipeId : recipeIds) {
+         Recipe * recipe = ObjectStoreWrapper::getByIdRaw<Recipe>(recipeId);
+         if (!recipe || !isScannable(*recipe)) {
+            this->removeRow(recipeId);
+            continue;
+         }
+
+         PendingScan pendingScan{recipeId, scanNumber, recipe->name(), QString{}, {}};
+         std::shared_ptr<Style> const style = recipe->style();
+         if (style) {
+            pendingScan.styleName = style->name();
+            pendingScan.ranges    = StyleConformance::rangesOf(*style);
+         }
+         pendingScans.append(pendingScan);
+         snapshots   .append(RecipeEvaluator::snapshotOf(*recipe));
+         this->m_latestScanOfRecipe.insert(recipeId, scanNumber);
+         this->observe(*recipe);
+      }
+
+      if (pendingScans.isEmpty()) {
+         return;
+      }
+      qCDebug(Logging::recipe) << Q_FUNC_INFO << "Scan" << scanNumber << "of" << pendingScans.size() << "recipes";
+
+      ++this->m_numScansInProgress;
+      QPointer<StyleConformanceTableModel> model{&this->m_self};
+      QThreadPool::globalInstance()->start(QRunnable::create([model, pendingScans, snapshots]() {
+         QVector<RecipeEvaluator::Results> const results = RecipeEvaluator::evaluateEach(snapshots);
+
+         QMetaObject::invokeMethod(
+            QCoreApplication::instance(),
+            [model, pendingScans, results]() {
+               // The model might have been destroyed while we were working
+               if (model) {
+                  model->pimpl->publish(pendingScans, results);
+               }
+               return;
+            },
+            Qt::QueuedConnection
+         );
+         return;
+      }));
+
+      return;
+   }
+
+   /**
+    * \brief Put the results of a scan into the model, ignoring any recipes that have been rescanned (or removed) since
+    *        the scan started
+    */
+   void publish(QVector<PendingScan> const & pendingScans, QVector<RecipeEvaluator::Results> const & results) {
+      Q_ASSERT(pendingScans.size() == results.size());
+      --this->m_numScansInProgress;
+
+      int numPublished = 0;
+      for (int ii = 0; ii < pendingScans.size(); ++ii) {
+         PendingScan const & pendingScan = pendingScans.at(ii);
+         if (this->m_latestScanOfRecipe.value(pendingScan.recipeId) != pendingScan.scanNumber) {
+            continue;
+         }
+
+         StyleConformance::RecipeResult result{
+            pendingScan.recipeId,
+            pendingScan.recipeName,
+            pendingScan.styleName,
+            StyleConformance::check(results.at(ii), pendingScan.ranges)
+         };
+
+         auto const existingRow = this->m_rowOfRecipe.constFind(pendingScan.recipeId);
+         if (existingRow != this->m_rowOfRecipe.cend()) {
+            int const row = *existingRow;
+            this->m_rows[row] = std::move(result);
+            emit this->m_self.dataChanged(this->m_self.index(row, 0), this->m_self.index(row, numColumns - 1));
+         } else {
+            int const row = this->m_rows.size();
+            this->m_self.beginInsertRows(QModelIndex(), row, row);
+            this->m_rows.append(std::move(result));
+            this->m_rowOfRecipe.insert(pendingScan.recipeId, row);
+            this->m_self.endInsertRows();
+         }
+         ++numPublished;
+      }
+
+      qCDebug(Logging::recipe) <<
+         Q_FUNC_INFO << "Published" << numPublished << "of" << pendingScans.size() << "scanned recipes";
+      emit this->m_self.scanFinished(numPublished);
+      return;
+   }
+
+   void removeRow(int const recipeId) {
+      // Any scan of this recipe that is still running is now irrelevant
+      this->m_latestScanOfRecipe.remove(recipeId);
+
+      auto const existingRow = this->m_rowOfRecipe.constFind(recipeId);
+      if (existingRow == this->m_rowOfRecipe.cend()) {
+         return;
+      }
+      int const row = *existingRow;
+      this->m_self.beginRemoveRows(QModelIndex(), row, row);
+      this->m_rows.removeAt(row);
+      this->m_rowOfRecipe.remove(recipeId);
+      // Rows after the removed one have all moved up by one
+      for (int ii = row; ii < this->m_rows.size(); ++ii) {
+         this->m_rowOfRecipe.insert(this->m_rows.at(ii).recipeId, ii);
+      }
+      this->m_self.endRemoveRows();
+      return;
+   }
+
+   /**
+    * \brief Rescan \c recipe whenever it changes.  Besides edits to the recipe itself, this catches changes to its
+    *        ingredients, equipment etc, because the recipe then recalculates itself and emits \c changed() for the
+    *        values that moved.
+    *
+    *        We only connect to recipes once we have scanned them, so that a model that is never shown costs nothing.
+    */
+   void observe(Recipe const & recipe) {
+      if (this->m_observedRecipes.contains(recipe.key())) {
+         return;
+      }
+      this->m_observedRecipes.insert(recipe.key());
+      int const recipeId = recipe.key();
+      QObject::connect(&recipe, &NamedEntity::changed, &this->m_self, [this, recipeId](QMetaProperty, QVariant) {
+         this->scheduleRescan(recipeId);
+         return;
+      });
+      return;
+   }
+
+   /**
+    * \brief Rescan all the recipes that use a style, eg because one of the style's ranges was edited
+    */
+   void rescanRecipesWithStyle(int const styleId) {
+      for (StyleConformance::RecipeResult const & result : this->m_rows) {
+         Recipe const * recipe = ObjectStoreWrapper::getByIdRaw<Recipe>(result.recipeId);
+         if (recipe && recipe->getStyleId() == styleId) {
+            this->scheduleRescan(result.recipeId);
+         }
+      }
+      return;
+   }
+
+   void clear() {
+      this->m_self.beginResetModel();
+      this->m_rows.clear();
+      this->m_rowOfRecipe.clear();
+      this->m_latestScanOfRecipe.clear();
+      this->m_recipesToRescan.clear();
+      this->m_rescanTimer.stop();
+      this->m_self.endResetModel();
+      return;
+   }
+
+   //! \return Display text, tooltip, etc for the cell showing \c parameter of \c result
+   QVariant parameterData(StyleConformance::RecipeResult const & result,
+                          StyleConformance::Parameter const parameter,
+                          int const role) const {
+      StyleConformance::Check const & check = result.check(parameter);
+      switch (role) {
+         case Qt::DisplayRole:
+            return formatValue(parameter, check.value);
+         case Qt::ToolTipRole:
+            if (!check.range.isSet()) {
+               return StyleConformanceTableModel::tr("No style range to check against");
+            }
+            return StyleConformanceTableModel::tr("Style range: %1 to %2").arg(
+               formatValue(parameter, check.range.min), formatValue(parameter, check.range.max)
+            );
+         case Qt::ForegroundRole:
+            if (check.isOutOfRange()) {
+               return QBrush(Qt::red);
+            }
+            return QVariant();
+         case Qt::TextAlignmentRole:
+            return static_cast<int>(Qt::AlignRight | Qt::AlignVCenter);
+         case StyleConformanceTableModel::SortRole:
+            return check.deviation();
+         default:
+            return QVariant();
+      }
+   }
+
+   //================================================ Member variables =================================================
+   StyleConformanceTableModel & m_self;
+
+   QVector<StyleConformance::RecipeResult> m_rows;
+   //! Recipe ID -> index in \c m_rows
+   QHash<int, int> m_rowOfRecipe;
+
+   /**
+    * \brief Recipe ID -> number of the latest scan that included it.  A scan's results for a recipe are only used if
+    *        no later scan has been started for it in the meantime.
+    */
+   QHash<int, unsigned int> m_latestScanOfRecipe;
+   unsigned int m_latestScanNumber;
+   int m_numScansInProgress;
+
+   //! Recipes waiting for \c m_rescanTimer to fire
+   QSet<int> m_recipesToRescan;
+   //! Recipes whose \c changed() signal we are connected to
+   QSet<int> m_observedRecipes;
+   QTimer m_rescanTimer;
+};
+
+StyleConformanceTableModel::StyleConformanceTableModel(QObject * parent) :
+   QAbstractTableModel{parent},
+   pimpl{std::make_unique<impl>(*this)} {
+
+   auto & recipeStore = ObjectStoreTyped<Recipe>::getInstance();
+   connect(&recipeStore, &ObjectStoreTyped<Recipe>::signalObjectInserted, this, [this](int recipeId) {
+      this->pimpl->scheduleRescan(recipeId);
+      return;
+   });
+   connect(&recipeStore, &ObjectStoreTyped<Recipe>::signalObjectDeleted, this, [this](int recipeId,
+                                                                                       std::shared_ptr<QObject>) {
+      this->pimpl->m_recipesToRescan.remove(recipeId);
+      this->pimpl->removeRow(recipeId);
+      return;
+   });
+   // Changes to stored properties (name, style, batch size etc) also come through NamedEntity::changed, which we pick
+   // up in impl::observe, so we only need this for recipes we haven't scanned yet (eg ones not previously displayed).
+   connect(&recipeStore, &ObjectStoreTyped<Recipe>::signalPropertyChanged, this, [this](int recipeId,
+                                                                                         BtStringConst const &) {
+      if (!this->pimpl->m_observedRecipes.contains(recipeId)) {
+         this->pimpl->scheduleRescan(recipeId);
+      }
+      return;
+   });
+   // Eg after RecipeEvaluator::recalculateAllRecipes, everything probably changed
+   connect(&recipeStore, &ObjectStoreTyped<Recipe>::signalObjectsChangedInBulk, this, [this]() {
+      this->rescanAll();
+      return;
+   });
+
+   connect(&ObjectStoreTyped<Style>::getInstance(), &ObjectStoreTyped<Style>::signalPropertyChanged, this,
+           [this](int styleId, BtStringConst const &) {
+      this->pimpl->rescanRecipesWithStyle(styleId);
+      return;
+   });
+
+   return;
+}
+
+// See https://herbsutter.com/gotw/_100/ for why we need to explicitly define the destructor here (and not in the
+// header file)
+StyleConformanceTableModel::~StyleConformanceTableModel() = default;
+
+void StyleConformanceTableModel::rescanAll() {
+   this->pimpl->clear();
+
+   QList<int> recipeIds;
+   for (Recipe const * recipe : ObjectStoreWrapper::getAllRaw<Recipe>()) {
+      recipeIds.append(recipe->key());
+   }
+   this->pimpl->scan(recipeIds);
+   return;
+}
+
+StyleConformance::RecipeResult const & StyleConformanceTableModel::resultAt(int const row) const {
+   Q_ASSERT(row >= 0 && row < this->pimpl->m_rows.size());
+   return this->pimpl->m_rows.at(row);
+}
+
+bool StyleConformanceTableModel::isScanning() const {
+   return this->pimpl->m_numScansInProgress > 0 || this->pimpl->m_rescanTimer.isActive();
+}
+
+int StyleConformanceTableModel::rowCount(QModelIndex const & parent) const {
+   if (parent.isValid()) {
+      return 0;
+   }
+   return this->pimpl->m_rows.size();
+}
+
+int StyleConformanceTableModel::columnCount(QModelIndex const & parent) const {
+   if (parent.isValid()) {
+      return 0;
+   }
+   return numColumns;
+}
+
+QVariant StyleConformanceTableModel::data(QModelIndex const & index, int role) const {
+   if (!index.isValid() || index.row() >= this->pimpl->m_rows.size() || index.column() >= numColumns) {
+      return QVariant();
+   }
+
+   StyleConformance::RecipeResult const & result = this->pimpl->m_rows.at(index.row());
+   auto const columnIndex = static_cast<ColumnIndex>(index.column());
+   switch (columnIndex) {
+      case ColumnIndex::Recipe:
+         if (role == Qt::DisplayRole || role == SortRole) {
+            return result.recipeName;
+         }
+         return QVariant();
+
+      case ColumnIndex::Style:
+         if (role == Qt::DisplayRole || role == SortRole) {
+            return result.styleName;
+         }
+         return QVariant();
+
+      case ColumnIndex::Og   : return this->pimpl->parameterData(result, StyleConformance::Parameter::og       , role);
+      case ColumnIndex::Fg   : return this->pimpl->parameterData(result, StyleConformance::Parameter::fg       , role);
+      case ColumnIndex::Ibu  : return this->pimpl->parameterData(result, StyleConformance::Parameter::ibu      , role);
+      case ColumnIndex::Color: return this->pimpl->parameterData(result, StyleConformance::Parameter::color_srm, role);
+      case ColumnIndex::Abv  : return this->pimpl->parameterData(result, StyleConformance::Parameter::abv_pct  , role);
+
+      case ColumnIndex::NumOutOfRange:
+         if (role == Qt::DisplayRole || role == SortRole) {
+            return result.numOutOfRange();
+         }
+         if (role == Qt::TextAlignmentRole) {
+            return static_cast<int>(Qt::AlignRight | Qt::AlignVCenter);
+         }
+         return QVariant();
+   }
+
+   // It's a coding error if we get here
+   qCritical() << Q_FUNC_INFO << "Bad column:" << index.column();
+   Q_ASSERT(false);
+   return QVariant();
+}
+
+QVariant StyleConformanceTableModel::headerData(int section, Qt::Orientation orientation, int role) const {
+   if (orientation != Qt::Horizontal || role != Qt::DisplayRole || section < 0 || section >= numColumns) {
+      return QVariant();
+   }
+
+   switch (static_cast<ColumnIndex>(section)) {
+      case ColumnIndex::Recipe       : return tr("Recipe");
+      case ColumnIndex::Style        : return tr("Style");
+      case ColumnIndex::Og           : return StyleConformance::parameterName(StyleConformance::Parameter::og       );
+      case ColumnIndex::Fg           : return StyleConformance::parameterName(StyleConformance::Parameter::fg       );
+      case ColumnIndex::Ibu          : return StyleConformance::parameterName(StyleConformance::Parameter::ibu      );
+      case ColumnIndex::Color        : return tr("Color (SRM)");
+      case ColumnIndex::Abv          : return tr("ABV (%)");
+      case ColumnIndex::NumOutOfRange: return tr("Out of Range");
+   }
+   return QVariant();
+}
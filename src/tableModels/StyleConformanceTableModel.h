@@ -0,0 +1,98 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * tableModels/StyleConformanceTableModel.h is part of Brewtarget, and is copyright the following authors 2024:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#ifndef TABLEMODELS_STYLECONFORMANCETABLEMODEL_H
+#define TABLEMODELS_STYLECONFORMANCETABLEMODEL_H
+#pragma once
+
+#include <memory> // For PImpl
+
+#include <QAbstractTableModel>
+#include <QModelIndex>
+#include <QVariant>
+
+#include "StyleConformance.h"
+
+/**
+ * \brief Read-only model with one row per \c Recipe in the library, showing how each recipe's calculated OG, FG, IBU,
+ *        color and ABV compare with the ranges of its \c Style.
+ *
+ *        Unlike the other table models, this one is not for editing anything, so it is a plain
+ *        \c QAbstractTableModel rather than being built on \c TableModelBase.
+ *
+ *        Recipes are snapshotted on the GUI thread and then evaluated with \c RecipeEvaluator::evaluateEach on the
+ *        global thread pool, so scanning thousands of recipes does not block the GUI.  After the initial scan (see
+ *        \c rescanAll), only recipes that change (or whose style changes) are rescanned.  Changes arriving in quick
+ *        succession (eg all the \c changed() signals from one recipe recalculating itself) are batched into a single
+ *        scan.
+ *
+ *        To sort the table, put a \c QSortFilterProxyModel in front of this model and set its sort role to
+ *        \c SortRole.  The values in the parameter columns sort by how far outside the range they are (see
+ *        \c StyleConformance::Check::deviation), so the worst offenders are at either end.
+ */
+class StyleConformanceTableModel : public QAbstractTableModel {
+   Q_OBJECT
+
+public:
+   enum class ColumnIndex {
+      Recipe       ,
+      Style        ,
+      Og           ,
+      Fg           ,
+      Ibu          ,
+      Color        ,
+      Abv          ,
+      NumOutOfRange,
+   };
+   static int constexpr numColumns = static_cast<int>(ColumnIndex::NumOutOfRange) + 1;
+
+   //! Role that returns the raw value to sort on for each cell
+   static int constexpr SortRole = Qt::UserRole;
+
+   StyleConformanceTableModel(QObject * parent = nullptr);
+   virtual ~StyleConformanceTableModel();
+
+   //! \brief Throw away all results and scan every recipe again.  This must be called on the GUI thread.
+   void rescanAll();
+
+   //! \return The result shown on \c row, which must be valid
+   StyleConformance::RecipeResult const & resultAt(int const row) const;
+
+   //! \return \c true if there are scans in progress whose results have not yet been published
+   bool isScanning() const;
+
+   //! \name Overrides of QAbstractTableModel
+   //! @{
+   virtual int rowCount(QModelIndex const & parent = QModelIndex()) const override;
+   virtual int columnCount(QModelIndex const & parent = QModelIndex()) const override;
+   virtual QVariant data(QModelIndex const & index, int role = Qt::DisplayRole) const override;
+   virtual QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+   //! @}
+
+signals:
+   /**
+    * \brief Emitted on the GUI thread each time a scan's results have been published into the model
+    *
+    * \param numRecipes Number of recipes whose rows were updated by the scan
+    */
+   void scanFinished(int numRecipes);
+
+private:
+   // Private implementation details - see https://herbsutter.com/gotw/_100/
+   class impl;
+   std::unique_ptr<impl> pimpl;
+};
+
+#endif
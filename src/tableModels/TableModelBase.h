@@ -17,10 +17,18 @@
 #define TABLEMODELS_TABLEMODELBASE_H
 #pragma once
 
-#include  <type_traits>
+#include <algorithm>
+#include <memory>
+#include <type_traits>
+#include <utility>
 
+#include <QHash>
 #include <QList>
 #include <QModelIndex>
+#include <QPair>
+#include <QSet>
+#include <QTimer>
+#include <QVector>
 
 #include "database/ObjectStoreTyped.h"
 #include "database/ObjectStoreWrapper.h"
@@ -32,6 +40,7 @@
 ///#include "tableModels/BtTableModelInventory.h"
 #include "utils/CuriouslyRecurringTemplateBase.h"
 #include "utils/MetaTypes.h"
+#include "utils/NameFilterIndex.h"
 
 // TODO: We would like to change "Add to Recipe" to "Set for Recipe" for things where the recipe only has one of them, eg Style or Equipment
 
@@ -135,7 +144,17 @@ public:
    using ColumnIndex = typename TableModelTraits<Derived>::ColumnIndex;
 
 protected:
-   TableModelBase() : rows{} {
+   TableModelBase() :
+      rows{},
+      rowIndexes{},
+      changedRows{},
+      nameFilterIndex{},
+      displayStrings{},
+      displayStringsGeneration{Measurement::displaySettingsGeneration()},
+      recentRecipes{},
+      inBulkDelivery{false},
+      bulkInsertedIds{},
+      bulkDeletedRows{} {
       return;
    }
    // Need a virtual destructor as we have a virtual member function
@@ -164,6 +183,7 @@ public:
             Q_FUNC_INFO << "Unobserve Recipe #" << this->derived().recObs->key() << "(" <<
             this->derived().recObs->name() << ")";
          this->derived().disconnect(this->derived().recObs, nullptr, &this->derived(), nullptr);
+         this->rememberRecipeRows(*this->derived().recObs);
          this->removeAll();
       }
 
@@ -177,6 +197,7 @@ public:
          // TBD: Commented out version doesn't compile on GCC
          // this->addItems(this->derived().recObs->getAll<NE>());
          this->addItems(rec->getAll<NE>());
+         this->restoreRecipeRows(*rec);
       }
       qDebug() << Q_FUNC_INFO << "Now have" << this->rows.size() << "rows";
       return;
@@ -198,6 +219,14 @@ public:
          this->removeAll();
          this->derived().connect(&ObjectStoreTyped<NE>::getInstance(), &ObjectStoreTyped<NE>::signalObjectInserted, &this->derived(), &Derived::addItem);
          this->derived().connect(&ObjectStoreTyped<NE>::getInstance(), &ObjectStoreTyped<NE>::signalObjectDeleted , &this->derived(), &Derived::removeItem);
+         this->derived().connect(&ObjectStoreTyped<NE>::getInstance(),
+                                 &ObjectStoreTyped<NE>::signalBulkDeliveryStarting,
+                                 &this->derived(),
+                                 [this]() { this->inBulkDelivery = true; return; });
+         this->derived().connect(&ObjectStoreTyped<NE>::getInstance(),
+                                 &ObjectStoreTyped<NE>::signalBulkDeliveryFinished,
+                                 &this->derived(),
+                                 [this]() { this->endBulkDelivery(); return; });
          this->addItems(ObjectStoreWrapper::getAll<NE>());
       } else {
          this->derived().disconnect(&ObjectStoreTyped<NE>::getInstance(), nullptr, &this->derived(), nullptr);
@@ -234,7 +263,7 @@ public:
          if (!recipe && (ii->deleted() || !ii->display())) {
             continue;
          }
-         if (!this->rows.contains(ii) ) {
+         if (this->findIndexOf(ii.get()) < 0) {
             tmp.append(ii);
          }
       }
@@ -252,7 +281,7 @@ public:
          if (!recipe && ii->deleted() ) {
             continue;
          }
-         if (!this->rows.contains(ii) ) {
+         if (this->findIndexOf(ii.get()) < 0) {
             tmp.append(ii);
          }
       }
@@ -273,23 +302,70 @@ public:
     *
     *        Function name is for consistency with \c QList::indexOf
     *
+    *        This is called for every \c propertyChanged signal from every row, so it's a hash look-up (in \c rowIndexes)
+    *        rather than a search through \c rows.
+    *
     * \param object  what to search for
     * \return index of object in this->rows or -1 if it's not found
     */
    int findIndexOf(NE const * object) const {
-      for (int index = 0; index < this->rows.size(); ++index) {
-         if (this->rows.at(index).get() == object) {
+      //
+      // Code that modifies this->rows directly (rather than via add, remove etc) should call reindexRows afterwards,
+      // but we also cope if it doesn't.  If the look-up gives the wrong row, or the number of rows does not match the
+      // size of the index, then the index is out of date and we rebuild it.
+      //
+      if (this->rowIndexes.size() == this->rows.size()) {
+         auto cached = this->rowIndexes.constFind(object);
+         if (cached == this->rowIndexes.cend()) {
+            return -1;
+         }
+         int const index = *cached;
+         if (index < this->rows.size() && this->rows.at(index).get() == object) {
             return index;
          }
       }
-      return -1;
+
+      this->reindexRows();
+      return this->rowIndexes.value(object, -1);
+   }
+
+   /**
+    * \brief Listen for changes to one of our rows.  There can be a lot of these, and all we need to know is which
+    *        property changed, so we use the compact \c NamedEntity::propertyChanged signal rather than
+    *        \c NamedEntity::changed.  (The connection's context is \c Derived, so the usual
+    *        \c disconnect(item, nullptr, &derived, nullptr) still undoes it.)
+    */
+   void connectItem(NE * item) {
+      this->derived().connect(item,
+                              &NamedEntity::propertyChanged,
+                              &this->derived(),
+                              [this, item]([[maybe_unused]] int key, int propertyIndex) {
+                                 this->itemPropertyChanged(item, propertyIndex);
+                              });
+      return;
+   }
+
+   //! \brief Called (via \c connectItem) when a property of one of our rows changes
+   void itemPropertyChanged(NE * item, int const propertyIndex) {
+      if (this->findIndexOf(item) < 0) {
+         return;
+      }
+
+      // Keep the filter index up-to-date before telling anyone (eg a filter proxy) that the row changed
+      static int const nameIndex = NamedEntity::propertyIndex<NE>(PropertyNames::NamedEntity::name);
+      if (propertyIndex == nameIndex) {
+         this->nameFilterIndex.update(item);
+      }
+
+      this->rowChanged(item);
+      return;
    }
 
    void add(std::shared_ptr<NE> item) {
       qDebug() << Q_FUNC_INFO << item->name();
 
       // Check to see if it's already in the list
-      if (this->rows.contains(item)) {
+      if (this->findIndexOf(item.get()) >= 0) {
          return;
       }
 
@@ -310,7 +386,9 @@ public:
       int size = this->rows.size();
       this->derived().beginInsertRows(QModelIndex(), size, size);
       this->rows.append(item);
-      this->derived().connect(item.get(), &NamedEntity::changed, &this->derived(), &Derived::changed);
+      this->rowIndexes.insert(item.get(), size);
+      this->nameFilterIndex.update(item.get());
+      this->connectItem(item.get());
       this->derived().added(item);
       //reset(); // Tell everybody that the table has changed.
       this->derived().endInsertRows();
@@ -318,6 +396,12 @@ public:
    }
 
    void addById(int itemId) {
+      // See endBulkDelivery
+      if (this->inBulkDelivery) {
+         this->bulkInsertedIds.append(itemId);
+         return;
+      }
+
       auto itemToAdd = ObjectStoreWrapper::getById<NE>(itemId);
       if (!itemToAdd) {
          // Not sure this should ever happen in practice, but, if there ever is no item with the
@@ -331,13 +415,73 @@ public:
       return;
    }
 
+   /**
+    * \brief Called when \c item has been deleted from its \c ObjectStore
+    */
+   void removeDeleted(std::shared_ptr<NE> item) {
+      // See endBulkDelivery
+      if (this->inBulkDelivery) {
+         this->bulkDeletedRows.insert(item.get());
+         return;
+      }
+      this->remove(item);
+      return;
+   }
+
+   /**
+    * \brief Called at the end of a delivery of queued insertions and deletions from our \c ObjectStore (see
+    *        \c ObjectStoreSignalBatch).  Rather than insert or remove one row at a time, each of which would make any
+    *        sorting proxy re-sort and any view repaint, we remove all the deleted rows in one reset and then add all
+    *        the new ones in one insert.
+    */
+   void endBulkDelivery() {
+      this->inBulkDelivery = false;
+
+      // The ObjectStore keeps the deleted objects alive until after it has told us the delivery is finished, so the
+      // pointers in bulkDeletedRows are still valid here.
+      if (!this->bulkDeletedRows.isEmpty()) {
+         QList<std::shared_ptr<NE>> remainingRows;
+         QList<std::shared_ptr<NE>> removedRows;
+         for (auto const & row : this->rows) {
+            if (this->bulkDeletedRows.contains(row.get())) {
+               removedRows.append(row);
+            } else {
+               remainingRows.append(row);
+            }
+         }
+         this->bulkDeletedRows.clear();
+
+         if (!removedRows.isEmpty()) {
+            this->derived().beginResetModel();
+            this->rows = remainingRows;
+            this->reindexRows();
+            for (auto const & item : removedRows) {
+               this->derived().disconnect(item.get(), nullptr, &this->derived(), nullptr);
+               this->changedRows.remove(item.get());
+               this->nameFilterIndex.remove(item.get());
+               this->forgetDisplayStrings(item.get());
+               this->derived().removed(item);
+            }
+            this->derived().endResetModel();
+         }
+      }
+
+      if (!this->bulkInsertedIds.isEmpty()) {
+         this->addItems(ObjectStoreWrapper::getByIds<NE>(std::exchange(this->bulkInsertedIds, {})));
+      }
+      return;
+   }
+
    //! \returns true if \c item is successfully found and removed.
    bool remove(std::shared_ptr<NE> item) {
-      int rowNum = this->rows.indexOf(item);
+      int rowNum = this->findIndexOf(item.get());
       if (rowNum >= 0)  {
          this->derived().beginRemoveRows(QModelIndex(), rowNum, rowNum);
          this->derived().disconnect(item.get(), nullptr, &this->derived(), nullptr);
          this->rows.removeAt(rowNum);
+         this->reindexRows(rowNum, item.get());
+         this->nameFilterIndex.remove(item.get());
+         this->forgetDisplayStrings(item.get());
 
          this->derived().removed(item);
 
@@ -366,6 +510,17 @@ public:
       return this->remove(this->rows[index.row()]);
    }
 
+   /**
+    * \brief Used by the sort/filter proxy (see sortFilterProxyModels/SortFilterProxyModelBase.h) to filter rows on
+    *        what the user types in a search box.  This is a look-up in an index (which we keep up-to-date as rows are
+    *        added, removed or renamed) rather than a search through all the rows.
+    *
+    * \return The rows whose name contains \c searchText, ignoring case and accents
+    */
+   QSet<NamedEntity const *> nameMatches(QString const & searchText) const {
+      return this->nameFilterIndex.matching(searchText);
+   }
+
 protected:
 
    template<class Caller>
@@ -396,9 +551,11 @@ protected:
          this->derived().beginInsertRows(QModelIndex(), size, size + tmp.size() - 1);
 
          this->rows.append(tmp);
+         this->reindexRows(size);
 
          for (auto item : tmp) {
-            this->derived().connect(item.get(), &NamedEntity::changed, &this->derived(), &Derived::changed);
+            this->nameFilterIndex.update(item.get());
+            this->connectItem(item.get());
             this->derived().added(item);
          }
 
@@ -419,6 +576,10 @@ protected:
             this->derived().disconnect(item.get(), nullptr, &this->derived(), nullptr);
             //this->derived().removed(item); // Shouldn't be necessary as we call updateTotals() below
          }
+         this->rowIndexes.clear();
+         this->changedRows.clear();
+         this->nameFilterIndex.clear();
+         this->displayStrings.clear();
          this->derived().endRemoveRows();
          this->derived().updateTotals();
       }
@@ -429,6 +590,69 @@ protected:
       return std::static_pointer_cast<NamedEntity>(this->getRow(ii));
    }
 
+   /**
+    * \brief Update \c rowIndexes for the rows from \c firstRow onwards.  Needs to be called after anything that adds,
+    *        removes or moves rows.
+    *
+    * \param removedItem If not \c nullptr, an item that was removed from \c this->rows and should be dropped from the
+    *                    index
+    */
+   void reindexRows(int const firstRow = 0, NE const * removedItem = nullptr) const {
+      if (firstRow == 0) {
+         this->rowIndexes.clear();
+      }
+      if (removedItem) {
+         this->rowIndexes.remove(removedItem);
+      }
+      for (int index = firstRow; index < this->rows.size(); ++index) {
+         this->rowIndexes.insert(this->rows.at(index).get(), index);
+      }
+      return;
+   }
+
+   /**
+    * \brief Called when \c item (one of our rows) has changed.  Rather than tell the views straight away, we wait until
+    *        control returns to the event loop, so that, eg, a bulk edit of several thousand rows results in one call
+    *        to \c updateTotals and one \c dataChanged signal (for the range of rows that changed) rather than several
+    *        thousand of each.
+    */
+   void rowChanged(NE const * item) {
+      // The row's display strings are out of date now, even though we haven't told the views yet
+      this->forgetDisplayStrings(item);
+      bool const alreadyScheduled = !this->changedRows.isEmpty();
+      this->changedRows.insert(item);
+      if (!alreadyScheduled) {
+         QTimer::singleShot(0, &this->derived(), [this]() { this->emitChangedRows(); return; });
+      }
+      return;
+   }
+
+   void emitChangedRows() {
+      if (this->changedRows.isEmpty()) {
+         return;
+      }
+
+      int firstRow = this->rows.size();
+      int lastRow = -1;
+      for (NE const * item : this->changedRows) {
+         // Item may have been removed since it was changed, in which case we ignore it
+         int const index = this->findIndexOf(item);
+         if (index >= 0) {
+            firstRow = std::min(firstRow, index);
+            lastRow  = std::max(lastRow , index);
+         }
+      }
+      this->changedRows.clear();
+
+      this->derived().updateTotals();
+      if (lastRow >= 0) {
+         emit this->derived().dataChanged(this->derived().createIndex(firstRow, 0),
+                                          this->derived().createIndex(lastRow, this->derived().columnCount() - 1));
+         emit this->derived().headerDataChanged(Qt::Vertical, firstRow, lastRow);
+      }
+      return;
+   }
+
    /**
     * \brief Check that supplied index is within bounds.
     */
@@ -468,7 +692,7 @@ protected:
          return false;
       }
 
-      if (role != Qt::DisplayRole && role != Qt::EditRole) {
+      if (role != Qt::DisplayRole && role != Qt::EditRole && role != BtTableModel::SortRole) {
          // No need to log anything here, as it's perfectly normal to get called with other roles
          return false;
       }
@@ -482,11 +706,138 @@ protected:
     *
     *        Caller is expected to have called \c indexAndRoleOk before calling this function.
     *
+    *        Formatting a cell for display (eg converting an amount to the user's preferred units) happens on every
+    *        repaint and scroll, so we cache display strings per row and column.  A row's strings are dropped when it
+    *        changes (see \c rowChanged), and all of them when the display unit settings change (see
+    *        \c Measurement::displaySettingsGeneration).  We only cache columns that are properties of the row object
+    *        itself though: for, eg, the hop's alpha acid in a table of hop additions, we don't get told when the
+    *        underlying hop changes.
+    */
+   QVariant readDataFromModel(QModelIndex const & index, int const role) const {
+      if (role != Qt::DisplayRole ||
+          this->get_ColumnInfo(static_cast<ColumnIndex>(index.column())).propertyPath.properties().size() != 1) {
+         return this->formatDataFromModel(index, role);
+      }
+
+      unsigned int const generation = Measurement::displaySettingsGeneration();
+      if (generation != this->displayStringsGeneration) {
+         this->displayStrings.clear();
+         this->displayStringsGeneration = generation;
+      }
+
+      QPair<NE const *, int> const cacheKey{this->rows[index.row()].get(), index.column()};
+      auto cached = this->displayStrings.constFind(cacheKey);
+      if (cached != this->displayStrings.constEnd()) {
+         return *cached;
+      }
+
+      QVariant displayString = this->formatDataFromModel(index, role);
+      this->displayStrings.insert(cacheKey, displayString);
+      return displayString;
+   }
+
+   /**
+    * \brief Called when we stop observing \c recipe, to remember the display strings we have cached for its rows (see
+    *        \c readDataFromModel), so that, if the user switches back to it soon, we don't have to reformat every cell.
+    */
+   void rememberRecipeRows(Recipe const & recipe) {
+      this->forgetRecipeRows(recipe.key());
+      if (recipe.key() <= 0 || this->displayStrings.isEmpty()) {
+         return;
+      }
+
+      RecentRecipe recent{recipe.key(), this->displayStringsGeneration, this->displayStrings, {}};
+      recent.rowStates.reserve(this->rows.size());
+      for (auto const & row : this->rows) {
+         recent.rowStates.insert(row.get(), {row, row->changeCount()});
+      }
+      this->recentRecipes.prepend(std::move(recent));
+      while (this->recentRecipes.size() > numRecentRecipes) {
+         this->recentRecipes.removeLast();
+      }
+      return;
+   }
+
+   /**
+    * \brief Called when we start observing \c recipe (after its rows have been added), to reinstate whatever display
+    *        strings we remembered in \c rememberRecipeRows that are still valid.  A string is only reused if the
+    *        display settings have not changed in the meantime and its row object still exists, is still in the recipe
+    *        and has not emitted \c changed since (see \c NamedEntity::changeCount).
+    */
+   void restoreRecipeRows(Recipe const & recipe) {
+      auto recent = std::find_if(
+         this->recentRecipes.begin(),
+         this->recentRecipes.end(),
+         [&recipe](RecentRecipe const & ii) { return ii.recipeKey == recipe.key(); }
+      );
+      if (recent == this->recentRecipes.end()) {
+         return;
+      }
+      RecentRecipe const remembered = std::move(*recent);
+      this->recentRecipes.erase(recent);
+
+      unsigned int const generation = Measurement::displaySettingsGeneration();
+      if (remembered.displayStringsGeneration != generation) {
+         return;
+      }
+      if (this->displayStringsGeneration != generation) {
+         this->displayStrings.clear();
+         this->displayStringsGeneration = generation;
+      }
+
+      for (auto ii = remembered.displayStrings.cbegin(); ii != remembered.displayStrings.cend(); ++ii) {
+         NE const * rowObject = ii.key().first;
+         auto const state = remembered.rowStates.constFind(rowObject);
+         if (state == remembered.rowStates.cend()) {
+            continue;
+         }
+         // Checking the weak pointer still points to rowObject guards against the address having been reused
+         std::shared_ptr<NE> const stillAlive = state->first.lock();
+         if (stillAlive.get() == rowObject &&
+             stillAlive->changeCount() == state->second &&
+             this->findIndexOf(rowObject) >= 0 &&
+             !this->displayStrings.contains(ii.key())) {
+            this->displayStrings.insert(ii.key(), ii.value());
+         }
+      }
+      return;
+   }
+
+   /**
+    * \brief Drop anything remembered by \c rememberRecipeRows for the recipe with the supplied key
+    */
+   void forgetRecipeRows(int const recipeKey) {
+      this->recentRecipes.erase(
+         std::remove_if(this->recentRecipes.begin(),
+                        this->recentRecipes.end(),
+                        [recipeKey](RecentRecipe const & ii) { return ii.recipeKey == recipeKey; }),
+         this->recentRecipes.end()
+      );
+      return;
+   }
+
+   /**
+    * \brief Drop any cached display strings (see \c readDataFromModel) for \c item
+    */
+   void forgetDisplayStrings(NE const * item) const {
+      if (this->displayStrings.isEmpty()) {
+         return;
+      }
+      int const numColumns = this->derived().columnCount();
+      for (int column = 0; column < numColumns; ++column) {
+         this->displayStrings.remove(QPair<NE const *, int>{item, column});
+      }
+      return;
+   }
+
+   /**
+    * \brief Does the work for \c readDataFromModel when we don't have a cached value
+    *
     * NOTE: The debug logging in this function is commented out because the function gets called A LOT.  I tend to
     *       uncomment these lines only when working on a problem in this area of the code, otherwise the log file fills
     *       up too quickly!
     */
-   QVariant readDataFromModel(QModelIndex const & index, int const role) const {
+   QVariant formatDataFromModel(QModelIndex const & index, int const role) const {
       //
       // We assume we are always being called from the Derived::data() member function (eg HopTableModel::data(), etc).
       // Often the call stack is along the following lines (albeit with some of the functions optimised away in
@@ -510,6 +861,10 @@ protected:
          Q_ASSERT(false); // Stop here on debug builds
       }
 
+      if (role == BtTableModel::SortRole) {
+         return this->sortKey(columnInfo, modelData);
+      }
+
       //
       // Unlike in an editor, in the table model, the edit control is only shown when you are actually editing a field.
       // Normally there's a separate control flow for just displaying the modelData otherwise.  We'll get called in both
@@ -689,6 +1044,58 @@ protected:
       return modelData;
    }
 
+   /**
+    * \brief Called from \c readDataFromModel for \c BtTableModel::SortRole.  See comment on that for what we return.
+    *
+    * \param modelData The value read from the model
+    */
+   QVariant sortKey(BtTableModel::ColumnInfo const & columnInfo, QVariant modelData) const {
+      TypeInfo const & typeInfo = columnInfo.typeInfo;
+
+      if (typeInfo.isOptional()) {
+         bool hasValue = false;
+         Optional::removeOptionalWrapper(modelData, typeInfo, &hasValue);
+         if (!hasValue) {
+            return QVariant{};
+         }
+      }
+
+      if (std::holds_alternative<NonPhysicalQuantity>(*typeInfo.fieldType)) {
+         auto const nonPhysicalQuantity = std::get<NonPhysicalQuantity>(*typeInfo.fieldType);
+         if (nonPhysicalQuantity == NonPhysicalQuantity::Enum) {
+            BtTableModel::EnumInfo const & enumInfo = std::get<BtTableModel::EnumInfo>(*columnInfo.extras);
+            return enumInfo.displayNames.enumAsIntToString(modelData.toInt()).value_or(QString{});
+         }
+         if (nonPhysicalQuantity == NonPhysicalQuantity::Bool) {
+            BtTableModel::BoolInfo const & info = std::get<BtTableModel::BoolInfo>(*columnInfo.extras);
+            return modelData.toBool() ? info.setDisplay : info.unsetDisplay;
+         }
+         if (nonPhysicalQuantity == NonPhysicalQuantity::Percentage) {
+            return modelData.toDouble();
+         }
+         return modelData;
+      }
+
+      // A double is already in canonical units -- see comment in readDataFromModel
+      if (typeInfo.typeIndex == typeid(double)) {
+         return modelData.toDouble();
+      }
+
+      if (modelData.canConvert<Measurement::Amount>()) {
+         Measurement::Amount const amount = modelData.value<Measurement::Amount>();
+         if (!amount.isValid()) {
+            return QVariant{};
+         }
+         if (columnInfo.extras && std::holds_alternative<Measurement::ChoiceOfPhysicalQuantity>(*columnInfo.extras)) {
+            // This is the drop-down for the PhysicalQuantity of the Amount, so we sort on what's displayed
+            return Measurement::physicalQuantityDisplayNames.enumToString(amount.unit->getPhysicalQuantity());
+         }
+         return amount.unit->toCanonical(amount.quantity).quantity;
+      }
+
+      return modelData;
+   }
+
    /**
     * \brief Child classes should call this from their \c setData() member function (overriding
     *        \c QAbstractTableModel::setData()) to write data for any column that does not require special handling
@@ -720,6 +1127,9 @@ protected:
       auto row = this->rows[index.row()];
       auto const columnIndex = static_cast<ColumnIndex>(index.column());
       auto const & columnInfo = this->get_ColumnInfo(columnIndex);
+      // Setters that go through the undo stack tell us about the change anyway, but this saves us showing the old
+      // value if a view repaints before that happens
+      this->forgetDisplayStrings(row.get());
 
       TypeInfo const & typeInfo = columnInfo.typeInfo;
 
@@ -846,17 +1256,25 @@ protected:
                                                                                  CanHaveInventory<NE> {
       // Substantive version
       if (propertyName == PropertyNames::IngredientAmount::amount) {
-         for (int ii = 0; ii < this->rows.size(); ++ii) {
-            std::shared_ptr<NE> ingredient = this->rows.at(ii);
-            if (InventoryTools::hasInventory<NE>(*ingredient)) {
-               std::shared_ptr<typename NE::InventoryClass> inventory = InventoryTools::getInventory(*ingredient);
-               if (inventory->key() == invKey) {
-                  emit this->derived().dataChanged(
-                     this->derived().createIndex(ii, static_cast<int>(Derived::ColumnIndex::TotalInventory)),
-                     this->derived().createIndex(ii, static_cast<int>(Derived::ColumnIndex::TotalInventory))
-                  );
-               }
-            }
+         //
+         // The inventory knows which ingredient it is for, so we can go straight to that ingredient's row, rather than
+         // looking up the inventory of every row.
+         //
+         auto const * inventory = ObjectStoreWrapper::getByIdRaw<typename NE::InventoryClass>(invKey);
+         if (!inventory) {
+            return;
+         }
+         NE const * ingredient = ObjectStoreWrapper::getByIdRaw<NE>(inventory->ingredientId());
+         if (!ingredient) {
+            return;
+         }
+         int const ii = this->findIndexOf(ingredient);
+         if (ii >= 0) {
+            this->forgetDisplayStrings(ingredient);
+            emit this->derived().dataChanged(
+               this->derived().createIndex(ii, static_cast<int>(Derived::ColumnIndex::TotalInventory)),
+               this->derived().createIndex(ii, static_cast<int>(Derived::ColumnIndex::TotalInventory))
+            );
          }
       }
       return;
@@ -873,10 +1291,24 @@ protected:
    void checkRecipeItems(Recipe * recipe) requires IsTableModel<Caller> && ObservesRecipe<Caller>{
       qDebug() << Q_FUNC_INFO;
       if (recipe == this->derived().recObs) {
-         this->removeAll();
+         //
+         // Rather than clear the table and add everything back, we just remove the rows that are no longer in the
+         // recipe and then add any new ones (which addItems does as one insert).  As well as being quicker, this means
+         // views do not lose their selection and scroll position every time an addition is added or removed.
+         //
          // TBD: Commented out version doesn't compile on GCC
          // this->addItems(this->derived().recObs->getAll<NE>());
-         this->addItems(recipe->getAll<NE>());
+         auto const items = recipe->getAll<NE>();
+         QSet<NE const *> itemsInRecipe;
+         for (auto const & item : items) {
+            itemsInRecipe.insert(item.get());
+         }
+         for (int rowNum = this->rows.size() - 1; rowNum >= 0; --rowNum) {
+            if (!itemsInRecipe.contains(this->rows.at(rowNum).get())) {
+               this->remove(this->rows.at(rowNum));
+            }
+         }
+         this->addItems(items);
          if (this->derived().rowCount() > 0) {
             emit this->derived().headerDataChanged(Qt::Vertical, 0, this->derived().rowCount() - 1);
          }
@@ -891,7 +1323,8 @@ protected:
    }
 
    /**
-    * \brief Called from \c Derived::changed slot
+    * \brief Called from \c Derived::changed slot, which is connected to the observed \c Recipe, if any.  (Changes to
+    *        our rows come via \c connectItem instead.)
     *
     * \param propNameOfOurAdditionsInRecipe  This needs to be something valid in all cases, but is only used if Derived is a
     *                                  recipe observer.
@@ -910,21 +1343,6 @@ protected:
 //      qDebug() <<
 //         Q_FUNC_INFO << "Sender:" << senderClassName << "; property:" << prop.name() << "; val:" << val <<
 //         "; propNameOfOurAdditionsInRecipe:" << propNameOfOurAdditionsInRecipe;
-      // Is sender one of our items?
-      NE * itemSender = qobject_cast<NE *>(rawSender);
-      if (itemSender) {
-         int ii = this->findIndexOf(itemSender);
-         if (ii < 0) {
-            return;
-         }
-
-         this->derived().updateTotals();
-         emit this->derived().dataChanged(this->derived().createIndex(ii, 0),
-                                     this->derived().createIndex(ii, this->derived().columnCount() - 1));
-         emit this->derived().headerDataChanged(Qt::Vertical, ii, ii);
-         return;
-      }
-
       // See if our recipe gained or lost items.
       Recipe * recSender = qobject_cast<Recipe *>(rawSender);
       if (recSender && prop.name() == propNameOfOurAdditionsInRecipe) {
@@ -937,6 +1355,43 @@ protected:
    //================================================ Member Variables =================================================
 
    QList< std::shared_ptr<NE> > rows;
+
+   //! Index in \c rows of each row -- see \c findIndexOf
+   mutable QHash<NE const *, int> rowIndexes;
+
+   //! Rows that have changed since we last emitted \c dataChanged -- see \c rowChanged
+   QSet<NE const *> changedRows;
+
+   //! Names of everything in \c rows, for filtering -- see \c nameMatches
+   NameFilterIndex nameFilterIndex;
+
+   //! Cached display strings, indexed by row object and column -- see \c readDataFromModel
+   mutable QHash<QPair<NE const *, int>, QVariant> displayStrings;
+
+   //! Value of \c Measurement::displaySettingsGeneration when \c displayStrings was last valid
+   mutable unsigned int displayStringsGeneration;
+
+   /**
+    * \brief What \c rememberRecipeRows keeps about a recipe we were recently observing
+    */
+   struct RecentRecipe {
+      int recipeKey;
+      unsigned int displayStringsGeneration;
+      QHash<QPair<NE const *, int>, QVariant> displayStrings;
+      //! For each row object, a weak pointer to it and its \c NamedEntity::changeCount when we stopped observing
+      QHash<NE const *, std::pair<std::weak_ptr<NE>, unsigned int>> rowStates;
+   };
+
+   //! How many recently-observed recipes we remember the display strings for
+   static constexpr int numRecentRecipes = 4;
+
+   //! Recently-observed recipes, most recent first -- see \c rememberRecipeRows
+   QList<RecentRecipe> recentRecipes;
+
+   //! Set while our \c ObjectStore is delivering queued signals -- see \c endBulkDelivery
+   bool inBulkDelivery;
+   QVector<int> bulkInsertedIds;
+   QSet<NE const *> bulkDeletedRows;
 };
 
 /**
@@ -1012,7 +1467,7 @@ protected:
       return;                                                                                           \
    }                                                                                                    \
    void NeName##TableModel::removeItem([[maybe_unused]] int itemId, std::shared_ptr<QObject> object) {  \
-      this->remove(std::static_pointer_cast<NeName>(object));                                           \
+      this->removeDeleted(std::static_pointer_cast<NeName>(object));                                    \
       return;                                                                                           \
    }                                                                                                    \
    void NeName##TableModel::changed(QMetaProperty prop, QVariant val) {                                 \
@@ -228,6 +228,21 @@ QVariant WaterTableModel::data(const QModelIndex & index, int role) const {
    auto row = this->rows[index.row()];
 
    auto const columnIndex = static_cast<WaterTableModel::ColumnIndex>(index.column());
+   if (role == BtTableModel::SortRole) {
+      // See comment in tableModels/BtTableModel.h for what we return for sorting
+      switch (columnIndex) {
+         case WaterTableModel::ColumnIndex::Name       : return QVariant(row->name());
+         case WaterTableModel::ColumnIndex::Calcium    : return QVariant(row->calcium_ppm());
+         case WaterTableModel::ColumnIndex::Bicarbonate: return QVariant(row->bicarbonate_ppm());
+         case WaterTableModel::ColumnIndex::Sulfate    : return QVariant(row->sulfate_ppm());
+         case WaterTableModel::ColumnIndex::Chloride   : return QVariant(row->chloride_ppm());
+         case WaterTableModel::ColumnIndex::Sodium     : return QVariant(row->sodium_ppm());
+         case WaterTableModel::ColumnIndex::Magnesium  : return QVariant(row->magnesium_ppm());
+         default:
+            break;
+      }
+   }
+
    switch (columnIndex) {
       case WaterTableModel::ColumnIndex::Name:
          return QVariant(row->name());
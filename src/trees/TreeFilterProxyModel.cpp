@@ -17,7 +17,12 @@
  ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
 #include "trees/TreeFilterProxyModel.h"
 
+#include <optional>
+#include <type_traits>
+
+#include <QDate>
 #include <QDebug>
+#include <QMetaType>
 
 #include "model/Folder.h"
 #include "trees/TreeModel.h"
@@ -33,18 +38,31 @@
 
 namespace {
 
-   template<class T> bool lessThan(TreeModel * model,
-                                   QModelIndex const & left,
-                                   QModelIndex const & right,
-                                   T * lhs,
-                                   T * rhs) {
-      return TreeItemNode<T>::lessThan(*model, left, right, *lhs, *rhs);
+   /**
+    * \brief Ordering of sort keys (see \c TreeNode::sortKey).  Invalid keys (eg unset optional values) sort first.
+    */
+   bool sortKeyLessThan(QVariant const & lhs, QVariant const & rhs) {
+      if (!lhs.isValid() || !rhs.isValid()) {
+         return !lhs.isValid() && rhs.isValid();
+      }
+      if (lhs.userType() == QMetaType::QString || rhs.userType() == QMetaType::QString) {
+         return lhs.toString() < rhs.toString();
+      }
+      if (lhs.userType() == QMetaType::QDate || rhs.userType() == QMetaType::QDate) {
+         return lhs.toDate() < rhs.toDate();
+      }
+      return lhs.toDouble() < rhs.toDouble();
    }
 
+   /**
+    * \brief Handles the parts of sorting that depend on the sort of node rather than the sort key.
+    *
+    * \return The result of the comparison, or \c std::nullopt if it should be decided on the sort keys
+    */
    template<class T>
-   bool isLessThan(TreeModel * model,
-                 QModelIndex const & left,
-                 QModelIndex const & right) {
+   std::optional<bool> nodeLessThan(TreeModel * model,
+                                    QModelIndex const & left,
+                                    QModelIndex const & right) {
       // As the models get more complex, so does the sort algorithm
       // Try to sort folders first.
       if (model->type(left) == TreeNode::Type::Folder && model->type(right) == TreeNode::typeOf<T>()) {
@@ -60,20 +78,94 @@ namespace {
          return leftTee->name() < rightFolder->fullPath();
       }
 
-      if (model->type(right) == TreeNode::Type::Folder && model->type(left) == TreeNode::Type::Folder) {
-         auto rightFolder = model->getItem<Folder>(right);
-         auto leftFolder = model->getItem<Folder>(left);
-         return leftFolder->fullPath() < rightFolder->fullPath();
+      // Folder versus folder is just a comparison of full paths, which is what their sort keys are
+
+      // Snapshots of a recipe are shown newest first
+      if constexpr (std::is_same_v<T, Recipe>) {
+         if (model->showChild(left) && model->showChild(right)) {
+            auto leftRecipe  = model->getItem<Recipe>(left);
+            auto rightRecipe = model->getItem<Recipe>(right);
+            if (leftRecipe && rightRecipe) {
+               return leftRecipe->key() > rightRecipe->key();
+            }
+         }
       }
 
-      return lessThan(model, left, right, model->getItem<T>(left), model->getItem<T>(right));
+      return std::nullopt;
    }
 }
 
 TreeFilterProxyModel::TreeFilterProxyModel(QObject * parent,
                                            TreeModel::TypeMasks mask) :
    QSortFilterProxyModel{parent},
-   m_treeMask{mask} {
+   m_treeMask{mask},
+   m_sortKeyCache{} {
+   return;
+}
+
+void TreeFilterProxyModel::setSourceModel(QAbstractItemModel * sourceModel) {
+   this->m_sortKeyCache.clear();
+   if (sourceModel) {
+      // Changed nodes get new sort keys; inserted ones don't affect anyone else's
+      connect(sourceModel, &QAbstractItemModel::dataChanged, this,
+              [this](QModelIndex const & topLeft, QModelIndex const & bottomRight) {
+                 this->forgetSortKeys(topLeft.parent(), topLeft.row(), bottomRight.row(), false);
+                 return;
+              });
+      // Removed nodes are deleted, and we don't want a new node at the same address to pick up the old node's keys
+      connect(sourceModel, &QAbstractItemModel::rowsAboutToBeRemoved, this,
+              [this](QModelIndex const & parent, int first, int last) {
+                 this->forgetSortKeys(parent, first, last, true);
+                 return;
+              });
+      auto clearCache = [this]() {
+         this->m_sortKeyCache.clear();
+         return;
+      };
+      connect(sourceModel, &QAbstractItemModel::layoutAboutToBeChanged, this, clearCache);
+      connect(sourceModel, &QAbstractItemModel::modelAboutToBeReset   , this, clearCache);
+   }
+   this->QSortFilterProxyModel::setSourceModel(sourceModel);
+   return;
+}
+
+QVariant TreeFilterProxyModel::sortKey(QModelIndex const & index) const {
+   QPair<void const *, int> const cacheKey{index.internalPointer(), index.column()};
+   auto cached = this->m_sortKeyCache.constFind(cacheKey);
+   if (cached != this->m_sortKeyCache.constEnd()) {
+      return *cached;
+   }
+
+   QVariant sortKey = this->sourceModel()->data(index, TreeModel::SortRole);
+   this->m_sortKeyCache.insert(cacheKey, sortKey);
+   return sortKey;
+}
+
+void TreeFilterProxyModel::forgetSortKeys(QModelIndex const & parent,
+                                          int const first,
+                                          int const last,
+                                          bool const includeDescendants) {
+   if (this->m_sortKeyCache.isEmpty()) {
+      return;
+   }
+
+   QAbstractItemModel const * model = this->sourceModel();
+   int const numColumns = model->columnCount(parent);
+   for (int row = first; row <= last; ++row) {
+      QModelIndex const index = model->index(row, 0, parent);
+      if (!index.isValid()) {
+         continue;
+      }
+      for (int column = 0; column < numColumns; ++column) {
+         this->m_sortKeyCache.remove(QPair<void const *, int>{index.internalPointer(), column});
+      }
+      if (includeDescendants) {
+         int const numChildren = model->rowCount(index);
+         if (numChildren > 0) {
+            this->forgetSortKeys(index, 0, numChildren - 1, true);
+         }
+      }
+   }
    return;
 }
 
@@ -82,28 +174,32 @@ bool TreeFilterProxyModel::lessThan(const QModelIndex & left,
 
    TreeModel * model = qobject_cast<TreeModel *>(sourceModel());
 
-   if (this->m_treeMask.testFlag(TreeModel::TypeMask::Recipe)) {
+   auto const & mask = this->m_treeMask;
+   std::optional<bool> result;
+   if (mask.testFlag(TreeModel::TypeMask::Recipe)) {
       // We don't want to sort brewnotes with the recipes, so only do this if
       // both sides are brewnotes
       if (model->type(left) == TreeNode::Type::BrewNote || model->type(right) == TreeNode::Type::BrewNote) {
-         BrewNote * leftBn = model->getItem<BrewNote>(left);
-         BrewNote * rightBn = model->getItem<BrewNote>(right);
-         if (leftBn && rightBn) {
-            return leftBn->brewDate() < rightBn->brewDate();
+         if (model->type(left) != model->type(right)) {
+            return false;
          }
-         return false;
+         return sortKeyLessThan(this->sortKey(left), this->sortKey(right));
       }
-      return isLessThan<Recipe>(model, left, right);
+      result = nodeLessThan<Recipe>(model, left, right);
+   }
+   else if (mask.testFlag(TreeModel::TypeMask::Equipment  )) { result = nodeLessThan<Equipment  >(model, left, right); }
+   else if (mask.testFlag(TreeModel::TypeMask::Fermentable)) { result = nodeLessThan<Fermentable>(model, left, right); }
+   else if (mask.testFlag(TreeModel::TypeMask::Hop        )) { result = nodeLessThan<Hop        >(model, left, right); }
+   else if (mask.testFlag(TreeModel::TypeMask::Misc       )) { result = nodeLessThan<Misc       >(model, left, right); }
+   else if (mask.testFlag(TreeModel::TypeMask::Yeast      )) { result = nodeLessThan<Yeast      >(model, left, right); }
+   else if (mask.testFlag(TreeModel::TypeMask::Style      )) { result = nodeLessThan<Style      >(model, left, right); }
+   else if (mask.testFlag(TreeModel::TypeMask::Water      )) { result = nodeLessThan<Water      >(model, left, right); }
+   else                                                     { result = nodeLessThan<Recipe     >(model, left, right); }
+   if (result) {
+      return *result;
    }
 
-   if (this->m_treeMask.testFlag(TreeModel::TypeMask::Equipment  )) { return isLessThan<Equipment  >(model, left, right); }
-   if (this->m_treeMask.testFlag(TreeModel::TypeMask::Fermentable)) { return isLessThan<Fermentable>(model, left, right); }
-   if (this->m_treeMask.testFlag(TreeModel::TypeMask::Hop        )) { return isLessThan<Hop        >(model, left, right); }
-   if (this->m_treeMask.testFlag(TreeModel::TypeMask::Misc       )) { return isLessThan<Misc       >(model, left, right); }
-   if (this->m_treeMask.testFlag(TreeModel::TypeMask::Yeast      )) { return isLessThan<Yeast      >(model, left, right); }
-   if (this->m_treeMask.testFlag(TreeModel::TypeMask::Style      )) { return isLessThan<Style      >(model, left, right); }
-   if (this->m_treeMask.testFlag(TreeModel::TypeMask::Water      )) { return isLessThan<Water      >(model, left, right); }
-   return isLessThan<Recipe>(model, left, right);
+   return sortKeyLessThan(this->sortKey(left), this->sortKey(right));
 }
 
 bool TreeFilterProxyModel::filterAcceptsRow(int source_row, const QModelIndex & source_parent) const {
@@ -19,8 +19,11 @@
 #define TREES_TREEFILTERPROXYMODEL_H
 #pragma once
 
+#include <QHash>
 #include <QModelIndex>
+#include <QPair>
 #include <QSortFilterProxyModel>
+#include <QVariant>
 
 #include "trees/TreeModel.h"
 
@@ -35,12 +38,32 @@ class TreeFilterProxyModel : public QSortFilterProxyModel {
 public:
    TreeFilterProxyModel(QObject *parent, TreeModel::TypeMasks mask);
 
+   /**
+    * \brief Reimplemented from QSortFilterProxyModel, so that we can connect to the source model's signals (before the
+    *        base class does) to keep our sort key cache up to date.
+    */
+   virtual void setSourceModel(QAbstractItemModel * sourceModel) override;
+
 protected:
    bool lessThan(const QModelIndex &left, const QModelIndex &right) const;
    bool filterAcceptsRow( int source_row, const QModelIndex &source_parent) const;
 
 private:
+   /**
+    * \brief What the source model returns for \c TreeModel::SortRole at \c index.  Sorting a tree does O(n log n)
+    *        comparisons per folder, so we cache these per node and column, rather than go back to the underlying
+    *        objects each time, until the source model tells us the node has changed or gone away.
+    */
+   QVariant sortKey(QModelIndex const & index) const;
+
+   //! \brief Drop cached sort keys for the nodes in rows \c first to \c last of \c parent and, optionally, everything
+   //!        below them
+   void forgetSortKeys(QModelIndex const & parent, int first, int last, bool includeDescendants);
+
    TreeModel::TypeMasks m_treeMask;
+
+   //! Sort keys (see \c sortKey) indexed by source \c TreeNode and column
+   mutable QHash<QPair<void const *, int>, QVariant> m_sortKeyCache;
 };
 
 #endif
@@ -19,10 +19,15 @@
  ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
 #include "trees/TreeModel.h"
 
+#include <algorithm>
 #include <cstring>
+#include <functional>
 
 #include <QAbstractItemModel>
+#include <QHash>
+#include <QMultiHash>
 #include <QList>
+#include <QMap>
 #include <QMessageBox>
 #include <QMimeData>
 #include <QModelIndex>
@@ -32,6 +37,9 @@
 #include <QVariant>
 
 #include "AncestorDialog.h"
+#include "database/Database.h"
+#include "database/DbTransaction.h"
+#include "Logging.h"
 #include "model/Folder.h"
 #include "trees/TreeView.h"
 #include "RecipeFormatter.h"
@@ -47,6 +55,7 @@
 #include "model/Water.h"
 #include "utils/BtStringConst.h"
 #include "PersistentSettings.h"
+#include "utils/Tracing.h"
 
 namespace {
    NamedEntity * getElement(TreeNode::Type oType, int id) {
@@ -67,6 +76,23 @@ namespace {
 
       return nullptr;
    }
+
+   ObjectStore * getObjectStore(TreeNode::Type oType) {
+      switch (oType) {
+         case TreeNode::Type::Recipe     : return &ObjectStoreTyped<Recipe     >::getInstance();
+         case TreeNode::Type::Equipment  : return &ObjectStoreTyped<Equipment  >::getInstance();
+         case TreeNode::Type::Fermentable: return &ObjectStoreTyped<Fermentable>::getInstance();
+         case TreeNode::Type::Hop        : return &ObjectStoreTyped<Hop        >::getInstance();
+         case TreeNode::Type::Misc       : return &ObjectStoreTyped<Misc       >::getInstance();
+         case TreeNode::Type::Style      : return &ObjectStoreTyped<Style      >::getInstance();
+         case TreeNode::Type::Yeast      : return &ObjectStoreTyped<Yeast      >::getInstance();
+         case TreeNode::Type::Water      : return &ObjectStoreTyped<Water      >::getInstance();
+         case TreeNode::Type::BrewNote   : return &ObjectStoreTyped<BrewNote   >::getInstance();
+         case TreeNode::Type::Folder     : break;
+      }
+
+      return nullptr;
+   }
 }
 
 namespace FolderUtils {
@@ -99,7 +125,7 @@ namespace FolderUtils {
 
          bool succeeded = ne->setProperty(*PropertyNames::FolderBase::folder, val);
          if (!succeeded) {
-            qCritical() <<
+            qCCritical(Logging::tree) <<
                Q_FUNC_INFO << "Error trying to set" << PropertyNames::FolderBase::folder << "on" <<
                neMetaObject->className() << "to" << val << "; property type =" <<
                neMetaProperty.typeName() << "; writable =" << neMetaProperty.isWritable();
@@ -114,21 +140,37 @@ namespace FolderUtils {
 // ============================ CLASS STUFF ================================
 // =========================================================================
 
+template<class NE> void TreeModel::followBulkDeliveries() {
+   connect(&ObjectStoreTyped<NE>::getInstance(), &ObjectStoreTyped<NE>::signalBulkDeliveryStarting, this, [this]() {
+      this->beginBulkChange();
+      return;
+   });
+   connect(&ObjectStoreTyped<NE>::getInstance(), &ObjectStoreTyped<NE>::signalBulkDeliveryFinished, this, [this]() {
+      this->endBulkChange();
+      return;
+   });
+   return;
+}
+
 TreeModel::TreeModel(TreeView * parent, TreeModel::TypeMasks types) :
    QAbstractItemModel(parent) {
    // Initialize the tree structure
    int items = 0;
    this->rootItem = new TreeNode();
+   this->m_bulkChangeDepth = 0;
 
    if (types.testFlag(TreeModel::TypeMask::Recipe)) {
       rootItem->insertChildren(items, 1, TreeNode::Type::Recipe);
       connect(&ObjectStoreTyped<Recipe>::getInstance(), &ObjectStoreTyped<Recipe>::signalObjectInserted, this, &TreeModel::elementAddedRecipe);
       connect(&ObjectStoreTyped<Recipe>::getInstance(), &ObjectStoreTyped<Recipe>::signalObjectDeleted,  this, &TreeModel::elementRemovedRecipe);
+      this->followBulkDeliveries<Recipe>();
       // Brewnotes need love too!
       connect(&ObjectStoreTyped<BrewNote>::getInstance(), &ObjectStoreTyped<BrewNote>::signalObjectInserted, this, &TreeModel::elementAddedBrewNote);
       connect(&ObjectStoreTyped<BrewNote>::getInstance(), &ObjectStoreTyped<BrewNote>::signalObjectDeleted,  this, &TreeModel::elementRemovedBrewNote);
+      this->followBulkDeliveries<BrewNote>();
       // And some versioning stuff, because why not?
       connect(&ObjectStoreTyped<Recipe>::getInstance(), &ObjectStoreTyped<Recipe>::signalPropertyChanged, this, &TreeModel::recipePropertyChanged);
+      connect(&ObjectStoreTyped<Recipe>::getInstance(), &ObjectStoreTyped<Recipe>::signalObjectsChangedInBulk, this, &TreeModel::recipesChangedInBulk);
       this->nodeType = TreeNode::Type::Recipe;
       m_mimeType = "application/x-brewtarget-recipe";
       m_maxColumns = static_cast<int>(TreeItemNode<Recipe>::Info::NumberOfColumns);
@@ -136,6 +178,7 @@ TreeModel::TreeModel(TreeView * parent, TreeModel::TypeMasks types) :
       rootItem->insertChildren(items, 1, TreeNode::Type::Equipment);
       connect(&ObjectStoreTyped<Equipment>::getInstance(), &ObjectStoreTyped<Equipment>::signalObjectInserted, this, &TreeModel::elementAddedEquipment);
       connect(&ObjectStoreTyped<Equipment>::getInstance(), &ObjectStoreTyped<Equipment>::signalObjectDeleted,  this, &TreeModel::elementRemovedEquipment);
+      this->followBulkDeliveries<Equipment>();
       this->nodeType = TreeNode::Type::Equipment;
       m_mimeType = "application/x-brewtarget-recipe";
       m_maxColumns = static_cast<int>(TreeItemNode<Equipment>::Info::NumberOfColumns);
@@ -143,6 +186,7 @@ TreeModel::TreeModel(TreeView * parent, TreeModel::TypeMasks types) :
       rootItem->insertChildren(items, 1, TreeNode::Type::Fermentable);
       connect(&ObjectStoreTyped<Fermentable>::getInstance(), &ObjectStoreTyped<Fermentable>::signalObjectInserted, this, &TreeModel::elementAddedFermentable);
       connect(&ObjectStoreTyped<Fermentable>::getInstance(), &ObjectStoreTyped<Fermentable>::signalObjectDeleted,  this, &TreeModel::elementRemovedFermentable);
+      this->followBulkDeliveries<Fermentable>();
       this->nodeType = TreeNode::Type::Fermentable;
       m_mimeType = "application/x-brewtarget-ingredient";
       m_maxColumns = static_cast<int>(TreeItemNode<Fermentable>::Info::NumberOfColumns);
@@ -150,6 +194,7 @@ TreeModel::TreeModel(TreeView * parent, TreeModel::TypeMasks types) :
       rootItem->insertChildren(items, 1, TreeNode::Type::Hop);
       connect(&ObjectStoreTyped<Hop>::getInstance(), &ObjectStoreTyped<Hop>::signalObjectInserted, this, &TreeModel::elementAddedHop);
       connect(&ObjectStoreTyped<Hop>::getInstance(), &ObjectStoreTyped<Hop>::signalObjectDeleted,  this, &TreeModel::elementRemovedHop);
+      this->followBulkDeliveries<Hop>();
       this->nodeType = TreeNode::Type::Hop;
       m_mimeType = "application/x-brewtarget-ingredient";
       m_maxColumns = static_cast<int>(TreeItemNode<Hop>::Info::NumberOfColumns);
@@ -157,6 +202,7 @@ TreeModel::TreeModel(TreeView * parent, TreeModel::TypeMasks types) :
       rootItem->insertChildren(items, 1, TreeNode::Type::Misc);
       connect(&ObjectStoreTyped<Misc>::getInstance(), &ObjectStoreTyped<Misc>::signalObjectInserted, this, &TreeModel::elementAddedMisc);
       connect(&ObjectStoreTyped<Misc>::getInstance(), &ObjectStoreTyped<Misc>::signalObjectDeleted,  this, &TreeModel::elementRemovedMisc);
+      this->followBulkDeliveries<Misc>();
       this->nodeType = TreeNode::Type::Misc;
       m_mimeType = "application/x-brewtarget-ingredient";
       m_maxColumns = static_cast<int>(TreeItemNode<Misc>::Info::NumberOfColumns);
@@ -164,6 +210,7 @@ TreeModel::TreeModel(TreeView * parent, TreeModel::TypeMasks types) :
       rootItem->insertChildren(items, 1, TreeNode::Type::Style);
       connect(&ObjectStoreTyped<Style>::getInstance(), &ObjectStoreTyped<Style>::signalObjectInserted, this, &TreeModel::elementAddedStyle);
       connect(&ObjectStoreTyped<Style>::getInstance(), &ObjectStoreTyped<Style>::signalObjectDeleted,  this, &TreeModel::elementRemovedStyle);
+      this->followBulkDeliveries<Style>();
       this->nodeType = TreeNode::Type::Style;
       m_mimeType = "application/x-brewtarget-recipe";
       m_maxColumns = static_cast<int>(TreeItemNode<Style>::Info::NumberOfColumns);
@@ -171,6 +218,7 @@ TreeModel::TreeModel(TreeView * parent, TreeModel::TypeMasks types) :
       rootItem->insertChildren(items, 1, TreeNode::Type::Yeast);
       connect(&ObjectStoreTyped<Yeast>::getInstance(), &ObjectStoreTyped<Yeast>::signalObjectInserted, this, &TreeModel::elementAddedYeast);
       connect(&ObjectStoreTyped<Yeast>::getInstance(), &ObjectStoreTyped<Yeast>::signalObjectDeleted,  this, &TreeModel::elementRemovedYeast);
+      this->followBulkDeliveries<Yeast>();
       this->nodeType = TreeNode::Type::Yeast;
       m_mimeType = "application/x-brewtarget-ingredient";
       m_maxColumns = static_cast<int>(TreeItemNode<Yeast>::Info::NumberOfColumns);
@@ -178,11 +226,12 @@ TreeModel::TreeModel(TreeView * parent, TreeModel::TypeMasks types) :
       rootItem->insertChildren(items, 1, TreeNode::Type::Water);
       connect(&ObjectStoreTyped<Water>::getInstance(), &ObjectStoreTyped<Water>::signalObjectInserted, this, &TreeModel::elementAddedWater);
       connect(&ObjectStoreTyped<Water>::getInstance(), &ObjectStoreTyped<Water>::signalObjectDeleted,  this, &TreeModel::elementRemovedWater);
+      this->followBulkDeliveries<Water>();
       this->nodeType = TreeNode::Type::Water;
       m_mimeType = "application/x-brewtarget-ingredient";
       m_maxColumns = static_cast<int>(TreeItemNode<Water>::Info::NumberOfColumns);
    } else {
-      qWarning() << Q_FUNC_INFO << "Invalid treemask:" << types;
+      qCWarning(Logging::tree) << Q_FUNC_INFO << "Invalid treemask:" << types;
    }
 
    this->m_treeMask = types;
@@ -306,6 +355,8 @@ QVariant TreeModel::data(const QModelIndex & index, int role) const {
          return toolTipData(index);
       case Qt::DisplayRole:
          return itm->data(index.column());
+      case TreeModel::SortRole:
+         return itm->sortKey(index.column());
       case Qt::DecorationRole:
          if (index.column() == 0 && itm->type() == TreeNode::Type::Folder) {
             return QIcon(":images/folder.png");
@@ -319,19 +370,37 @@ QVariant TreeModel::data(const QModelIndex & index, int role) const {
 }
 
 QVariant TreeModel::toolTipData(const QModelIndex & index) const {
-   // .:TBD:. This looks like a memory leak...
-   RecipeFormatter * rf = new RecipeFormatter();
+   //
+   // Tooltips are big chunks of HTML, and, for recipes, they can involve calculated values, so we don't want to build
+   // them every time the mouse moves over an item.  Instead we keep them until the item changes (see forgetToolTip).
+   //
+   NamedEntity * element = this->thing(index);
+   if (element) {
+      auto cached = this->m_toolTips.constFind(element);
+      if (cached != this->m_toolTips.cend()) {
+         return *cached;
+      }
+   }
 
-   if (m_treeMask.testFlag(TreeModel::TypeMask::Recipe     )) { return rf->getToolTip(qobject_cast<Recipe *     >(thing(index))); }
-   if (m_treeMask.testFlag(TreeModel::TypeMask::Style      )) { return rf->getToolTip(qobject_cast<Style *      >(thing(index))); }
-   if (m_treeMask.testFlag(TreeModel::TypeMask::Equipment  )) { return rf->getToolTip(qobject_cast<Equipment *  >(thing(index))); }
-   if (m_treeMask.testFlag(TreeModel::TypeMask::Fermentable)) { return rf->getToolTip(qobject_cast<Fermentable *>(thing(index))); }
-   if (m_treeMask.testFlag(TreeModel::TypeMask::Hop        )) { return rf->getToolTip(qobject_cast<Hop *        >(thing(index))); }
-   if (m_treeMask.testFlag(TreeModel::TypeMask::Misc       )) { return rf->getToolTip(qobject_cast<Misc *       >(thing(index))); }
-   if (m_treeMask.testFlag(TreeModel::TypeMask::Yeast      )) { return rf->getToolTip(qobject_cast<Yeast *      >(thing(index))); }
-   if (m_treeMask.testFlag(TreeModel::TypeMask::Water      )) { return rf->getToolTip(qobject_cast<Water *      >(thing(index))); }
+   RecipeFormatter rf;
+   QString toolTip;
+   auto const & mask = this->m_treeMask;
+   if      (mask.testFlag(TypeMask::Recipe     )) { toolTip = rf.getToolTip(qobject_cast<Recipe *     >(element)); }
+   else if (mask.testFlag(TypeMask::Style      )) { toolTip = rf.getToolTip(qobject_cast<Style *      >(element)); }
+   else if (mask.testFlag(TypeMask::Equipment  )) { toolTip = rf.getToolTip(qobject_cast<Equipment *  >(element)); }
+   else if (mask.testFlag(TypeMask::Fermentable)) { toolTip = rf.getToolTip(qobject_cast<Fermentable *>(element)); }
+   else if (mask.testFlag(TypeMask::Hop        )) { toolTip = rf.getToolTip(qobject_cast<Hop *        >(element)); }
+   else if (mask.testFlag(TypeMask::Misc       )) { toolTip = rf.getToolTip(qobject_cast<Misc *       >(element)); }
+   else if (mask.testFlag(TypeMask::Yeast      )) { toolTip = rf.getToolTip(qobject_cast<Yeast *      >(element)); }
+   else if (mask.testFlag(TypeMask::Water      )) { toolTip = rf.getToolTip(qobject_cast<Water *      >(element)); }
+   else {
+      return item(index)->name();
+   }
 
-   return item(index)->name();
+   if (element) {
+      this->m_toolTips.insert(element, toolTip);
+   }
+   return toolTip;
 }
 
 // This is much better, assuming the rest can be made to work
@@ -373,9 +442,13 @@ bool TreeModel::insertRow(int row,
       type = (victimType ? *victimType : type);
       TreeNode * added = pItem->child(row);
       added->setData(type, victim);
+      this->indexSubtree(added);
    }
    endInsertRows();
 
+   // Once somebody explicitly puts children under a node, it's up to them to put all of them there (see fetchMore)
+   this->m_unfetchedChildren.remove(pItem);
+
    return success;
 }
 
@@ -383,47 +456,82 @@ bool TreeModel::removeRows(int row, int count, const QModelIndex & parent) {
    TreeNode * pItem = item(parent);
 
    this->beginRemoveRows(parent, row, row + count - 1);
+   // The nodes are about to be deleted, so they need to come out of the index first
+   for (int ii = row; ii < row + count && ii < pItem->childCount(); ++ii) {
+      this->unindexSubtree(pItem->child(ii));
+   }
    bool success = pItem->removeChildren(row, count);
    this->endRemoveRows();
 
    return success;
 }
 
+void TreeModel::indexSubtree(TreeNode * node) {
+   NamedEntity const * thing = node->thing();
+   if (thing) {
+      this->m_nodesByElement.insert(thing, node);
+   }
+   for (int ii = 0; ii < node->childCount(); ++ii) {
+      this->indexSubtree(node->child(ii));
+   }
+   return;
+}
+
+void TreeModel::unindexSubtree(TreeNode * node) {
+   NamedEntity const * thing = node->thing();
+   if (thing) {
+      this->m_nodesByElement.remove(thing, node);
+   }
+   this->m_unfetchedChildren.remove(node);
+   this->m_pendingRemovals.remove(node);
+   for (int ii = 0; ii < node->childCount(); ++ii) {
+      this->unindexSubtree(node->child(ii));
+   }
+   return;
+}
+
 // One find method for all things. This .. is nice
 QModelIndex TreeModel::findElement(NamedEntity * thing, TreeNode * parent) {
    TreeNode * pItem = parent ? parent : this->rootItem->child(0);
 
-
    if (! thing) {
       return createIndex(0, 0, pItem);
    }
 
-   if (pItem) {
-      qDebug() << Q_FUNC_INFO << "Find" << *thing << "in" << pItem->name();
-   }
-
-   QList<TreeNode *> folders;
-   folders.append(pItem);
-
-   // Recursion. Wonderful.
-   while (! folders.isEmpty()) {
-      TreeNode * target = folders.takeFirst();
-      for (int i = 0; i < target->childCount(); ++i) {
-         // If we've found what we are looking for, return
-         if (target->child(i)->thing() == thing) {
-            qDebug() << Q_FUNC_INFO << "Found at" << i;
-            return createIndex(i, 0, target->child(i));
-         }
-
-         // If we have a folder, or we are looking for a brewnote and have a
-         // recipe in hand, push the child onto the stack
-         if (target->child(i)->type() == TreeNode::Type::Folder ||
-             (qobject_cast<BrewNote *>(thing) && target->child(i)->type() == TreeNode::Type::Recipe)) {
-            folders.append(target->child(i));
+   //
+   // We used to do a breadth-first search from pItem, descending into folders (and, when looking for a brewnote, into
+   // recipes).  Now we look thing up in m_nodesByElement, but we keep the same rules about where we look: the same
+   // element can be in the tree more than once (eg an ancestor Recipe is also shown under its descendants), and the
+   // search would have found the one shallowest below pItem, so that's what we return.
+   //
+   bool const isBrewNote = qobject_cast<BrewNote *>(thing) != nullptr;
+   TreeNode * found = nullptr;
+   int foundDepth = 0;
+   for (auto ii = this->m_nodesByElement.constFind(thing);
+        ii != this->m_nodesByElement.cend() && ii.key() == thing;
+        ++ii) {
+      TreeNode * node = ii.value();
+      int depth = 1;
+      TreeNode * ancestor = node->parent();
+      while (ancestor && ancestor != pItem) {
+         if (ancestor->type() != TreeNode::Type::Folder &&
+             !(isBrewNote && ancestor->type() == TreeNode::Type::Recipe)) {
+            ancestor = nullptr;
+            break;
          }
+         ancestor = ancestor->parent();
+         ++depth;
+      }
+      if (ancestor && (!found || depth < foundDepth)) {
+         found = node;
+         foundDepth = depth;
       }
    }
-   return QModelIndex();
+
+   if (!found) {
+      return QModelIndex();
+   }
+   return createIndex(found->childNumber(), 0, found);
 }
 
 QList<NamedEntity *> TreeModel::elements() {
@@ -466,81 +574,297 @@ QList<NamedEntity *> TreeModel::elements() {
          elements.append(elem);
       }
    } else {
-      qWarning() << Q_FUNC_INFO << "Invalid treemask:" << this->m_treeMask;
+      qCWarning(Logging::tree) << Q_FUNC_INFO << "Invalid treemask:" << this->m_treeMask;
    }
    return elements;
 }
 
-void TreeModel::loadTreeModel() {
-   int i;
+namespace {
+   //! \return \c path in the form "/a/b/c" (ie what \c Folder::fullPath gives), or empty string for the root folder
+   QString normalisedFolderPath(QString const & path) {
+#if QT_VERSION < QT_VERSION_CHECK(5,15,0)
+      QStringList const dirs = path.simplified().split("/", QString::SkipEmptyParts);
+#else
+      QStringList const dirs = path.simplified().split("/", Qt::SkipEmptyParts);
+#endif
+      QString normalisedPath;
+      for (QString const & dir : dirs) {
+         normalisedPath += QString{"/"} % dir;
+      }
+      return normalisedPath;
+   }
+
+   /**
+    * \brief Append a node for \c thing to \c parent, without telling any views -- see \c TreeModel::loadTreeModel
+    *
+    * \return the new node
+    */
+   TreeNode * appendNode(TreeNode & parent, TreeNode::Type const type, QObject * thing) {
+      int const row = parent.childCount();
+      parent.insertChildren(row, 1, type);
+      TreeNode * node = parent.child(row);
+      node->setData(type, thing);
+      return node;
+   }
+
+   /**
+    * \brief Return the node for the folder with the supplied path, creating it (and any missing parent folders) if
+    *        necessary, without telling any views.  This is the equivalent of \c TreeModel::findFolder for when we are
+    *        building the tree from scratch.
+    *
+    * \param folderNodes Folder nodes created so far, indexed by normalised full path
+    */
+   TreeNode * folderNode(QString const & path, TreeNode & root, QHash<QString, TreeNode *> & folderNodes) {
+      QString const fullPath = normalisedFolderPath(path);
+      if (fullPath.isEmpty()) {
+         return &root;
+      }
 
-   QModelIndex ndxLocal;
-   TreeNode * local = nullptr;
+      auto existing = folderNodes.constFind(fullPath);
+      if (existing != folderNodes.cend()) {
+         return *existing;
+      }
+
+      int const lastSlash = fullPath.lastIndexOf('/');
+      TreeNode * parent = folderNode(fullPath.left(lastSlash), root, folderNodes);
+      Folder * folder = new Folder();
+      folder->setfullPath(fullPath);
+      TreeNode * node = appendNode(*parent, TreeNode::Type::Folder, folder);
+      folderNodes.insert(fullPath, node);
+      return node;
+   }
+}
+
+void TreeModel::loadTreeModel() {
+   Tracing::Span span{"TreeModel::loadTreeModel"};
    QList<NamedEntity *> elems = this->elements();
 
-   qDebug() << Q_FUNC_INFO << "Got " << elems.length() << "elements matching type mask" << this->m_treeMask;
+   qCDebug(Logging::tree) <<
+      Q_FUNC_INFO << "Got " << elems.length() << "elements matching type mask" << this->m_treeMask;
+
+   //
+   // With thousands of items in hundreds of folders, it's a lot quicker to build the tree directly and then tell any
+   // views about it in one go than it is to insert one row at a time (each with its own beginInsertRows /
+   // endInsertRows, and its own search through the tree for the right folder).
+   //
+   bool const showSnapshots = PersistentSettings::value(PersistentSettings::Names::showsnapshots, false).toBool();
+   TreeNode * root = this->rootItem->child(0);
+   QHash<QString, TreeNode *> folderNodes;
 
+   this->beginResetModel();
    for (NamedEntity * elem : elems) {
       // TODO: At some point we should refactor this code so that we have separate handling for objects that have
       //       folders from ones that don't.
       auto folder = FolderUtils::getFolder(elem);
-      if (folder && !folder->isEmpty()) {
-         ndxLocal = findFolder(*folder, rootItem->child(0), true);
-         // I cannot imagine this failing, but what the hell
-         if (! ndxLocal.isValid()) {
-            qWarning() << Q_FUNC_INFO << "Invalid return from findFolder in loadTreeModel()";
-            continue;
+      TreeNode * local = (folder && !folder->isEmpty()) ? folderNode(*folder, *root, folderNodes) : root;
+      TreeNode * elemNode = appendNode(*local, this->nodeType, elem);
+
+      // Brewnotes (and snapshots) don't get created until the recipe is expanded -- see fetchMore
+      if (m_treeMask & TreeModel::TypeMask::Recipe) {
+         Recipe * holdmebeer = qobject_cast<Recipe *>(elem);
+         if (showSnapshots && holdmebeer->hasAncestors()) {
+            local->setShowMe(true);
+            this->deferChildren(elemNode, ChildrenToFetch::AncestorsAndBrewNotes);
+         } else {
+            this->deferChildren(elemNode, ChildrenToFetch::BrewNotesIncludingAncestors);
          }
-         local = item(ndxLocal);
-         i = local->childCount();
-      } else {
-         local = rootItem->child(0);
-         i = local->childCount();
-         ndxLocal = createIndex(i, 0, local);
       }
+   }
+   this->indexSubtree(root);
+   this->endResetModel();
+
+   // Top-level items are on show straight away.  Everything else gets observed when its parent is first expanded.
+   this->observeChildren(QModelIndex{});
+   return;
+}
+
+void TreeModel::observeChildren(QModelIndex const & parent) {
+   TreeNode * root = this->rootItem->child(0);
+   TreeNode * node = parent.isValid() ? this->item(parent) : root;
+   if (!node) {
+      return;
+   }
 
-      if (!this->insertRow(i, ndxLocal, elem, this->nodeType)) {
-         qWarning() << Q_FUNC_INFO << "Insert failed in loadTreeModel()";
+   //
+   // Items that aren't on show don't get observed (see observeElement), which means we might have missed a change to
+   // the folder of one of the items we're about to show.  Where that's the case, we move it now.
+   //
+   bool const isFolderNode = (node == root || node->type() == TreeNode::Type::Folder);
+   QString const nodeFolderPath = (node == root || !isFolderNode) ? QString{} : node->getData<Folder>()->fullPath();
+   QList<NamedEntity *> movedElements;
+   for (int ii = 0; ii < node->childCount(); ++ii) {
+      TreeNode * child = node->child(ii);
+      if (child->type() == TreeNode::Type::Folder) {
          continue;
       }
+      NamedEntity * elem = child->thing();
+      this->observeElement(elem);
+      if (isFolderNode && elem) {
+         auto folder = FolderUtils::getFolder(elem);
+         if (folder && normalisedFolderPath(*folder) != normalisedFolderPath(nodeFolderPath)) {
+            movedElements.append(elem);
+         }
+      }
+   }
 
-      // If we have brewnotes, set them up here.
-      if (m_treeMask & TreeModel::TypeMask::Recipe) {
-         Recipe * holdmebeer = qobject_cast<Recipe *>(elem);
-         if (PersistentSettings::value(PersistentSettings::Names::showsnapshots, false).toBool() && holdmebeer->hasAncestors()) {
-            setShowChild(ndxLocal, true);
-            addAncestoralTree(holdmebeer, i, local);
-            addBrewNoteSubTree(holdmebeer, i, local, false);
-         } else {
-            addBrewNoteSubTree(holdmebeer, i, local);
+   //
+   // By the same token, something we weren't observing might have changed in a way that affects how it sorts, so we
+   // tell the views (and in particular TreeFilterProxyModel, which caches sort keys) to take another look.
+   //
+   if (node->childCount() > 0) {
+      QModelIndex const nodeIndex = (node == root) ? this->createIndex(0, 0, root) : parent;
+      emit this->dataChanged(this->index(0, 0, nodeIndex),
+                             this->index(node->childCount() - 1, this->m_maxColumns - 1, nodeIndex));
+   }
+
+   for (NamedEntity * elem : movedElements) {
+      this->folderChanged(elem);
+   }
+   return;
+}
+
+void TreeModel::deferChildren(TreeNode * node, ChildrenToFetch const children) {
+   Recipe const * recipe = node->getData<Recipe>();
+   if (!recipe) {
+      return;
+   }
+
+   bool hasChildren = !recipe->brewNotes().isEmpty();
+   if (!hasChildren && children == ChildrenToFetch::AncestorsAndBrewNotes) {
+      hasChildren = recipe->hasAncestors();
+   }
+   if (!hasChildren && children == ChildrenToFetch::BrewNotesIncludingAncestors) {
+      for (Recipe const * ancestor : recipe->ancestors()) {
+         if (!ancestor->brewNotes().isEmpty()) {
+            hasChildren = true;
+            break;
          }
       }
-      observeElement(elem);
+   }
+
+   if (hasChildren) {
+      this->m_unfetchedChildren.insert(node, children);
    }
    return;
 }
 
-void TreeModel::addAncestoralTree(Recipe * rec, int i, TreeNode * parent) {
-   TreeNode * temp = parent->child(i);
-   int j = 0;
+TreeModel::ChildrenToFetch TreeModel::childrenToFetch(TreeNode * node) {
+   // This mirrors the cases in loadTreeModel, showAncestors and hideAncestors
+   for (int ii = 0; ii < node->childCount(); ++ii) {
+      if (node->child(ii)->type() == TreeNode::Type::Recipe) {
+         return ChildrenToFetch::AncestorsAndBrewNotes;
+      }
+   }
+   if (node->parent() && node->parent()->type() == TreeNode::Type::Recipe) {
+      return ChildrenToFetch::BrewNotes;
+   }
+   return ChildrenToFetch::BrewNotesIncludingAncestors;
+}
 
-   for (Recipe * stor : rec->ancestors()) {
-      // insert the ancestor. This is most of magic. One day, I understood it.
-      // Now I simply copy/paste it
-      if (! insertRow(j, createIndex(i, 0, temp), stor, TreeNode::Type::Recipe)) {
-         qWarning() << Q_FUNC_INFO << "Ancestor insert failed in loadTreeModel()";
-         continue;
+bool TreeModel::hasChildren(QModelIndex const & parent) const {
+   return this->canFetchMore(parent) || this->rowCount(parent) > 0;
+}
+
+bool TreeModel::canFetchMore(QModelIndex const & parent) const {
+   return parent.isValid() && this->m_unfetchedChildren.contains(this->item(parent));
+}
+
+void TreeModel::fetchMore(QModelIndex const & parent) {
+   if (!parent.isValid()) {
+      return;
+   }
+   TreeNode * node = this->item(parent);
+   auto unfetched = this->m_unfetchedChildren.find(node);
+   if (unfetched == this->m_unfetchedChildren.end()) {
+      return;
+   }
+   ChildrenToFetch const children = *unfetched;
+   this->m_unfetchedChildren.erase(unfetched);
+
+   Recipe * recipe = node->getData<Recipe>();
+   QList<Recipe *> ancestors;
+   QList<BrewNote *> notes;
+   switch (children) {
+      case ChildrenToFetch::BrewNotesIncludingAncestors:
+         notes = RecipeHelper::brewNotesForRecipeAndAncestors(*recipe);
+         break;
+      case ChildrenToFetch::AncestorsAndBrewNotes:
+         ancestors = recipe->ancestors();
+         notes = recipe->brewNotes();
+         break;
+      case ChildrenToFetch::BrewNotes:
+         notes = recipe->brewNotes();
+         break;
+   }
+   if (ancestors.isEmpty() && notes.isEmpty()) {
+      return;
+   }
+
+   int const firstRow = node->childCount();
+   this->beginInsertRows(this->createIndex(node->childNumber(), 0, node),
+                         firstRow,
+                         firstRow + ancestors.size() + notes.size() - 1);
+   for (Recipe * ancestor : ancestors) {
+      TreeNode * ancestorNode = appendNode(*node, TreeNode::Type::Recipe, ancestor);
+      ancestorNode->setShowMe(true);
+      this->indexSubtree(ancestorNode);
+      this->deferChildren(ancestorNode, ChildrenToFetch::BrewNotes);
+   }
+   for (BrewNote * note : notes) {
+      this->indexSubtree(appendNode(*node, TreeNode::Type::BrewNote, note));
+   }
+   this->endInsertRows();
+   return;
+}
+
+void TreeModel::fetchNodesFor(NamedEntity const * thing) {
+   BrewNote const * note = qobject_cast<BrewNote const *>(thing);
+   if (!note) {
+      return;
+   }
+
+   //
+   // A brew note is shown under its own recipe and, unless we're showing snapshots, under that recipe's descendants.
+   // Fetching the children of a recipe whose snapshots are shown creates more unfetched nodes (for the ancestors), so
+   // we keep going until there's nothing left that the note could be under.
+   //
+   int const recipeId = note->recipeId();
+   for (;;) {
+      QList<TreeNode *> nodesToFetch;
+      for (auto ii = this->m_unfetchedChildren.cbegin(); ii != this->m_unfetchedChildren.cend(); ++ii) {
+         Recipe const * recipe = ii.key()->getData<Recipe>();
+         bool matches = recipe->key() == recipeId;
+         if (!matches && ii.value() != ChildrenToFetch::BrewNotes) {
+            QList<Recipe *> const ancestors = recipe->ancestors();
+            matches = std::any_of(ancestors.cbegin(), ancestors.cend(),
+                                  [recipeId](Recipe const * ancestor) { return ancestor->key() == recipeId; });
+         }
+         if (matches) {
+            nodesToFetch.append(ii.key());
+         }
       }
-      // we need to find the index of what we just inserted
-      QModelIndex cIndex = findElement(stor, temp);
-      // and set showChild on it
-      setShowChild(cIndex, true);
+      if (nodesToFetch.isEmpty()) {
+         break;
+      }
+      for (TreeNode * node : nodesToFetch) {
+         this->fetchMore(this->createIndex(node->childNumber(), 0, node));
+      }
+   }
+   return;
+}
 
-      // finally, add this ancestors brewnotes but do not recurse
-      addBrewNoteSubTree(stor, j, temp, false);
-      observeElement(stor);
-      ++j;
+void TreeModel::unloadChildren(QModelIndex const & parent) {
+   if (!parent.isValid()) {
+      return;
+   }
+   TreeNode * node = this->item(parent);
+   if (node->type() != TreeNode::Type::Recipe || node->childCount() == 0) {
+      return;
    }
+
+   ChildrenToFetch const children = this->childrenToFetch(node);
+   this->removeRows(0, node->childCount(), this->createIndex(node->childNumber(), 0, node));
+   this->deferChildren(node, children);
    return;
 }
 
@@ -554,7 +878,7 @@ void TreeModel::addBrewNoteSubTree(Recipe * rec, int i, TreeNode * parent, bool
       // In previous insert loops, we ignore the error and soldier on. So we
       // will do that here too
       if (! insertRow(j, createIndex(i, 0, temp), note, TreeNode::Type::BrewNote)) {
-         qWarning() << Q_FUNC_INFO << "Brewnote insert failed in loadTreeModel()";
+         qCWarning(Logging::tree) << Q_FUNC_INFO << "Brewnote insert failed in loadTreeModel()";
          continue;
       }
       observeElement(note);
@@ -615,100 +939,100 @@ int TreeModel::mask() {
    return m_treeMask;
 }
 
+namespace {
+   /**
+    * \brief Make copies, with the supplied names, of the items (all of type \c NE) at the supplied indexes and store
+    *        them all in one go (see \c ObjectStore::insertMany)
+    *
+    * \return \c false if the copies could not be stored (in which case none of them is)
+    */
+   template<class NE>
+   bool copyItems(TreeModel const & model, QList<QPair<QModelIndex, QString>> const & toBeCopied) {
+      QList<std::shared_ptr<NE>> copies;
+      copies.reserve(toBeCopied.size());
+      for (auto const & thisPair : toBeCopied) {
+         auto copy = ObjectStoreWrapper::copy(*model.getItem<NE>(thisPair.first)); // Create a deep copy.
+         copy->setName(thisPair.second);
+         copies.append(copy);
+      }
+      return !ObjectStoreWrapper::insertBatch(copies).isEmpty();
+   }
+}
+
 void TreeModel::copySelected(QList< QPair<QModelIndex, QString>> toBeCopied) {
-   bool failed = false;
-   while (! toBeCopied.isEmpty()) {
-      QPair<QModelIndex, QString> thisPair = toBeCopied.takeFirst();
-      QModelIndex ndx = thisPair.first;
-      QString name = thisPair.second;
-
-      //
-      // Note that the type of the local variable copy is different in each case statement (std::shared_ptr<Equipment>,
-      // std::shared_ptr<Fermentable>, etc) which is why the setName and insert calls cannot be pulled out of the
-      // switch.
-      //
-      auto theType = type(ndx);
+   //
+   // Copying hundreds of items one at a time, each in its own DB transaction and then moved into its folder in the
+   // tree with its own removeRows and insertRow, is slow.  So we store all the copies of each type in one go, and hold
+   // back the updates to the tree until the end (see beginBulkChange()), which puts each copy straight into its folder.
+   //
+   // Note that the type of the copies is different for each type of item (Equipment, Fermentable, etc) which is why
+   // copyItems is a template and we need the switch statement below.
+   //
+   QMap<TreeNode::Type, QList<QPair<QModelIndex, QString>>> toBeCopiedByType;
+   for (auto const & thisPair : toBeCopied) {
+      auto theType = type(thisPair.first);
       if (!theType) {
-         qWarning() << Q_FUNC_INFO << "Unknown type for ndx" << ndx;
-      } else {
-         switch (*theType) {
-            case TreeNode::Type::Equipment: {
-                  auto copy = ObjectStoreWrapper::copy(*this->getItem<Equipment>(ndx)); // Create a deep copy.
-                  copy->setName(name);
-                  ObjectStoreWrapper::insert(copy);
-                  this->folderChanged(copy.get());
-               }
-               break;
-            case TreeNode::Type::Fermentable: {
-                  auto copy = ObjectStoreWrapper::copy(*this->getItem<Fermentable>(ndx)); // Create a deep copy.
-                  copy->setName(name);
-                  ObjectStoreWrapper::insert(copy);
-                  this->folderChanged(copy.get());
-               }
-               break;
-            case TreeNode::Type::Hop: {
-                  auto copy = ObjectStoreWrapper::copy(*this->getItem<Hop>(ndx)); // Create a deep copy.
-                  copy->setName(name);
-                  ObjectStoreWrapper::insert(copy);
-                  this->folderChanged(copy.get());
-               }
-               break;
-            case TreeNode::Type::Misc: {
-                  auto copy = ObjectStoreWrapper::copy(*this->getItem<Misc>(ndx)); // Create a deep copy.
-                  copy->setName(name);
-                  ObjectStoreWrapper::insert(copy);
-                  this->folderChanged(copy.get());
-               }
-               break;
-            case TreeNode::Type::Recipe: {
-                  auto copy = ObjectStoreWrapper::copy(*this->getItem<Recipe>(ndx)); // Create a deep copy.
-                  qDebug() <<
-                     Q_FUNC_INFO << "display:" <<  copy->display() << "isLocked:" << copy->locked() <<
-                     "hasDescendants:" << copy->hasDescendants();
-                  copy->setName(name);
-                  ObjectStoreWrapper::insert(copy);
-                  this->folderChanged(copy.get());
-               }
-               break;
-            case TreeNode::Type::Style: {
-                  auto copy = ObjectStoreWrapper::copy(*this->getItem<Style>(ndx)); // Create a deep copy.
-                  copy->setName(name);
-                  ObjectStoreWrapper::insert(copy);
-                  this->folderChanged(copy.get());
-               }
-               break;
-            case TreeNode::Type::Yeast: {
-                  auto copy = ObjectStoreWrapper::copy(*this->getItem<Yeast>(ndx)); // Create a deep copy.
-                  copy->setName(name);
-                  ObjectStoreWrapper::insert(copy);
-                  this->folderChanged(copy.get());
-               }
-               break;
-            case TreeNode::Type::Water: {
-                  auto copy = ObjectStoreWrapper::copy(*this->getItem<Water>(ndx)); // Create a deep copy.
-                  copy->setName(name);
-                  ObjectStoreWrapper::insert(copy);
-                  this->folderChanged(copy.get());
-               }
-               break;
-            case TreeNode::Type::BrewNote:
-            case TreeNode::Type::Folder:
-               // These cases shouldn't arise (I think!) but the compiler will emit a warning if we don't explicitly
-               // have code to handle them (which is good!).
-               qWarning() << Q_FUNC_INFO << "Unexpected item type" << static_cast<int>(*theType);
-               break;
-         }
+         qCWarning(Logging::tree) << Q_FUNC_INFO << "Unknown type for ndx" << thisPair.first;
+         continue;
       }
-      if (failed) {
+      toBeCopiedByType[*theType].append(thisPair);
+   }
+
+   this->beginBulkChange();
+   for (auto ii = toBeCopiedByType.cbegin(); ii != toBeCopiedByType.cend(); ++ii) {
+      bool succeeded = true;
+      switch (ii.key()) {
+         case TreeNode::Type::Equipment  : succeeded = copyItems<Equipment  >(*this, ii.value()); break;
+         case TreeNode::Type::Fermentable: succeeded = copyItems<Fermentable>(*this, ii.value()); break;
+         case TreeNode::Type::Hop        : succeeded = copyItems<Hop        >(*this, ii.value()); break;
+         case TreeNode::Type::Misc       : succeeded = copyItems<Misc       >(*this, ii.value()); break;
+         case TreeNode::Type::Recipe     : succeeded = copyItems<Recipe     >(*this, ii.value()); break;
+         case TreeNode::Type::Style      : succeeded = copyItems<Style      >(*this, ii.value()); break;
+         case TreeNode::Type::Yeast      : succeeded = copyItems<Yeast      >(*this, ii.value()); break;
+         case TreeNode::Type::Water      : succeeded = copyItems<Water      >(*this, ii.value()); break;
+         case TreeNode::Type::BrewNote:
+         case TreeNode::Type::Folder:
+            // These cases shouldn't arise (I think!) but the compiler will emit a warning if we don't explicitly
+            // have code to handle them (which is good!).
+            qCWarning(Logging::tree) << Q_FUNC_INFO << "Unexpected item type" << static_cast<int>(ii.key());
+            break;
+      }
+      if (!succeeded) {
+         this->endBulkChange();
+         QStringList names;
+         for (auto const & thisPair : ii.value()) {
+            names.append(thisPair.second);
+         }
          QMessageBox::warning(nullptr,
                               tr("Could not copy"),
-                              tr("There was an unexpected error creating %1").arg(name));
+                              tr("There was an unexpected error creating %1").arg(names.join(", ")));
          return;
       }
    }
+   this->endBulkChange();
+   return;
 }
 
 void TreeModel::deleteSelected(QModelIndexList victims) {
+   //
+   // Each soft delete is a couple of property updates, each of which would otherwise be its own DB transaction, and
+   // each removal from the tree would be its own beginRemoveRows / endRemoveRows.  Deleting hundreds of old recipes or
+   // brew notes that way is slow, so we do all the DB updates in one transaction (see DbTransaction for how the
+   // transactions of the individual updates nest inside it), and hold back the updates to the tree until the end.
+   //
+   Database & database = Database::instance();
+   QSqlDatabase connection = database.sqlDatabase();
+   DbTransaction dbTransaction{database, connection, QString("Delete %1 tree items").arg(victims.size())};
+   NamedEntityChangeBatch changeBatch;
+
+   this->beginBulkChange();
+   this->deleteItems(victims);
+   dbTransaction.commit();
+   this->endBulkChange();
+   return;
+}
+
+void TreeModel::deleteItems(QModelIndexList victims) {
    QModelIndexList toBeDeleted = victims; // trust me
 
    // There are black zones of shadow close to our daily paths,
@@ -718,7 +1042,7 @@ void TreeModel::deleteSelected(QModelIndexList victims) {
       QModelIndex ndx = toBeDeleted.takeFirst();
       auto theType = type(ndx);
       if (!theType) {
-         qWarning() << Q_FUNC_INFO << "Unknown type for ndx" << ndx;
+         qCWarning(Logging::tree) << Q_FUNC_INFO << "Unknown type for ndx" << ndx;
          continue;
       }
       switch (*theType) {
@@ -761,11 +1085,120 @@ void TreeModel::deleteSelected(QModelIndexList victims) {
             ObjectStoreWrapper::softDelete(*this->getItem<Water>(ndx));
             break;
          case TreeNode::Type::Folder:
-            // We want to delete the contents of the folder (and remove it from from the model) before remove the folder
-            // itself, otherwise the QModelIndex values for the contents will not be valid.
-            this->deleteSelected(allChildren(ndx));
-            this->removeFolder(ndx);
+            // The folder node itself is removed from the model along with everything else, in endBulkChange(), so
+            // the QModelIndex values for its contents are still valid here.
+            this->deleteItems(this->allChildren(ndx));
+            this->m_pendingRemovals.insert(this->item(ndx), nullptr);
+            break;
+      }
+   }
+   return;
+}
+
+void TreeModel::beginBulkChange() {
+   ++this->m_bulkChangeDepth;
+   return;
+}
+
+void TreeModel::endBulkChange() {
+   Q_ASSERT(this->m_bulkChangeDepth > 0);
+   if (--this->m_bulkChangeDepth > 0) {
+      return;
+   }
+
+   //
+   // First the removals.  Anything under another node we're removing goes with that node.  For the rest, we remove
+   // each run of adjacent rows under the same parent in one go, working from the bottom up so that removing one run
+   // doesn't change the row numbers of the others.
+   //
+   QHash<TreeNode *, NamedEntity *> removals;
+   removals.swap(this->m_pendingRemovals);
+   QHash<TreeNode *, QVector<int>> rowsByParent;
+   for (auto ii = removals.cbegin(); ii != removals.cend(); ++ii) {
+      TreeNode * node = ii.key();
+      bool underAnotherRemoval = false;
+      for (TreeNode * ancestor = node->parent(); ancestor; ancestor = ancestor->parent()) {
+         if (removals.contains(ancestor)) {
+            underAnotherRemoval = true;
             break;
+         }
+      }
+      if (!underAnotherRemoval && node->parent()) {
+         rowsByParent[node->parent()].append(node->childNumber());
+      }
+   }
+   for (auto ii = rowsByParent.begin(); ii != rowsByParent.end(); ++ii) {
+      TreeNode * parentNode = ii.key();
+      QVector<int> & rows = ii.value();
+      std::sort(rows.begin(), rows.end(), std::greater<int>());
+      QModelIndex const parentIndex = this->createIndex(parentNode->childNumber(), 0, parentNode);
+      for (int runStart = 0; runStart < rows.size(); ) {
+         int runEnd = runStart + 1;
+         while (runEnd < rows.size() && rows.at(runEnd) == rows.at(runEnd - 1) - 1) {
+            ++runEnd;
+         }
+         if (!this->removeRows(rows.at(runEnd - 1), runEnd - runStart, parentIndex)) {
+            qCWarning(Logging::tree) <<
+               Q_FUNC_INFO << "Could not remove" << (runEnd - runStart) << "rows from row" << rows.at(runEnd - 1);
+         }
+         runStart = runEnd;
+      }
+   }
+   for (NamedEntity * victim : removals) {
+      if (victim) {
+         this->m_toolTips.remove(victim);
+         disconnect(victim, nullptr, this, nullptr);
+      }
+   }
+
+   //
+   // Then the additions, which go straight into their folders, with one beginInsertRows / endInsertRows per folder.
+   // Brew notes go under their recipe, which elementAdded() already knows how to do.
+   //
+   QList<NamedEntity *> additions;
+   additions.swap(this->m_pendingAdditions);
+   TreeNode * root = this->rootItem->child(0);
+   QList<TreeNode *> parentNodes;
+   QHash<TreeNode *, QList<NamedEntity *>> additionsByParent;
+   for (NamedEntity * elem : additions) {
+      if (qobject_cast<BrewNote *>(elem)) {
+         this->elementAdded(elem);
+         continue;
+      }
+      TreeNode * parentNode = root;
+      // TODO: At some point we should refactor this code so that we have separate handling for objects that have
+      //       folders from ones that don't.
+      auto folder = FolderUtils::getFolder(elem);
+      if (folder && !folder->isEmpty()) {
+         QModelIndex const folderIndex = this->findFolder(*folder, root, true);
+         if (folderIndex.isValid()) {
+            parentNode = this->item(folderIndex);
+         }
+      }
+      if (!additionsByParent.contains(parentNode)) {
+         parentNodes.append(parentNode);
+      }
+      additionsByParent[parentNode].append(elem);
+   }
+   for (TreeNode * parentNode : parentNodes) {
+      QList<NamedEntity *> const & elems = additionsByParent[parentNode];
+      int const firstRow = parentNode->childCount();
+      QModelIndex const parentIndex = this->createIndex(parentNode->childNumber(), 0, parentNode);
+      this->beginInsertRows(parentIndex, firstRow, firstRow + elems.size() - 1);
+      for (NamedEntity * elem : elems) {
+         TreeNode * elemNode = appendNode(*parentNode, this->nodeType, elem);
+         this->indexSubtree(elemNode);
+         // As in loadTreeModel, brewnotes don't get created until the recipe is expanded
+         if (m_treeMask & TreeModel::TypeMask::Recipe) {
+            this->deferChildren(elemNode, ChildrenToFetch::BrewNotesIncludingAncestors);
+         }
+      }
+      this->endInsertRows();
+      for (NamedEntity * elem : elems) {
+         this->observeElement(elem);
+      }
+      if (parentNode != root) {
+         emit expandFolder(m_treeMask, parentIndex);
       }
    }
    return;
@@ -781,7 +1214,7 @@ void TreeModel::deleteSelected(QModelIndexList victims) {
 // index after we have removed the recipe. BAD THINGS happen otherwise.
 //
 void TreeModel::folderChanged(QString name) {
-   qDebug() << Q_FUNC_INFO << name;
+   qCDebug(Logging::tree) << Q_FUNC_INFO << name;
 
    NamedEntity * test = qobject_cast<NamedEntity *>(sender());
    if (test) {
@@ -792,12 +1225,19 @@ void TreeModel::folderChanged(QString name) {
 }
 
 void TreeModel::folderChanged(NamedEntity * test) {
-   qDebug() << Q_FUNC_INFO << test;
+   qCDebug(Logging::tree) << Q_FUNC_INFO << test;
+
+   // In a bulk change, the move is just a removal and an addition, which endBulkChange() does per folder
+   if (this->m_bulkChangeDepth > 0) {
+      this->elementRemoved(test);
+      this->elementAdded(test);
+      return;
+   }
 
    // Find it.
    QModelIndex ndx = findElement(test);
    if (! ndx.isValid()) {
-      qWarning() << Q_FUNC_INFO << "Could not find element";
+      qCWarning(Logging::tree) << Q_FUNC_INFO << "Could not find element";
       return;
    }
 
@@ -813,7 +1253,7 @@ void TreeModel::folderChanged(NamedEntity * test) {
    int ii = item(ndx)->childNumber();
    // Remove it
    if (!this->removeRows(ii, 1, pIndex)) {
-      qWarning() << Q_FUNC_INFO << "Could not remove row" << ii;
+      qCWarning(Logging::tree) << Q_FUNC_INFO << "Could not remove row" << ii;
       return;
    }
 
@@ -837,7 +1277,7 @@ void TreeModel::folderChanged(NamedEntity * test) {
    int jj = local->childCount();
 
    if (!insertRow(jj, newNdx, test, this->nodeType)) {
-      qWarning() << Q_FUNC_INFO << "Could not insert row" << jj;
+      qCWarning(Logging::tree) << Q_FUNC_INFO << "Could not insert row" << jj;
       return;
    }
    // If we have brewnotes, set them up here.
@@ -904,67 +1344,73 @@ QModelIndexList TreeModel::allChildren(QModelIndex ndx) {
 
 bool TreeModel::renameFolder(Folder * victim, QString newName) {
    QModelIndex ndx = findFolder(victim->fullPath(), nullptr, false);
-   QModelIndex pInd;
-   QString targetPath = newName % "/" % victim->name();
-   QPair<QString, TreeNode *> f;
-   QList<QPair<QString, TreeNode *>> folders;
-   // This space is important       ^
-   int i, kids, src;
-
    if (! ndx.isValid()) {
       return false;
    }
 
-   pInd = parent(ndx);
+   QModelIndex pInd = parent(ndx);
    if (! pInd.isValid()) {
       return false;
    }
 
+   //
+   // Renaming a folder means changing the folder of everything in it and in its subfolders.  Rather than one DB write
+   // and one move in the tree per item, we work out from the tree where each item is going, then update all the items
+   // of each type together (see ObjectStore::setPropertyInBulk) in one transaction, and hold back the changes to the
+   // tree until the end, as in deleteSelected().
+   //
+   // We don't find the items with a LIKE on the old folder path, because the folder strings stored on items are not
+   // all in the same form (eg some have a leading or trailing slash), whereas the tree is what the user is looking at.
+   //
    TreeNode * start = item(ndx);
-   f.first  = targetPath;
-   f.second = start;
-
-   folders.append(f);
-
+   QMap<TreeNode::Type, QMap<QString, QVector<int>>> idsByTypeAndFolder;
+   QList<NamedEntity *> itemsToMove;
+   QList<QPair<QString, TreeNode *>> folders;
+   folders.append(qMakePair(QString{newName % "/" % victim->name()}, start));
    while (! folders.isEmpty()) {
-      // This looks weird, but it is needed for later
-      f = folders.takeFirst();
-      targetPath = f.first;
-      TreeNode * target = f.second;
-
-      // As we move things, childCount changes. This makes sure we loop
-      // through all of the kids
-      kids = target->childCount();
-      src = 0;
-      // Ok. We have a start and an index.
-      for (i = 0; i < kids; ++i) {
-         // This looks weird and it is. As we move children out, the 0 items
-         // changes to the next child. In the case of a folder, though, we
-         // don't move it, so we need to get the item beyond that.
-         TreeNode * next = target->child(src);
-         // If a folder, push it onto the folders stack for latter processing
+      QPair<QString, TreeNode *> const folder = folders.takeFirst();
+      QString const & targetPath = folder.first;
+      for (int ii = 0; ii < folder.second->childCount(); ++ii) {
+         TreeNode * next = folder.second->child(ii);
+         // If a folder, push it onto the folders stack for later processing
          if (next->type() == TreeNode::Type::Folder) {
-            QPair<QString, TreeNode *> newTarget;
-            newTarget.first = targetPath % "/" % next->name();
-            newTarget.second = next;
-            folders.append(newTarget);
-            src++;
-         } else {
-            // Leafnode
-            //
-            // TODO: At some point we should refactor this code so that we have separate handling for objects that have
-            //       folders from ones that don't.
-            auto item = next->thing();
-            auto folder = FolderUtils::getFolder(item);
-            if (folder) {
-               FolderUtils::setFolder(item, targetPath);
-            }
+            folders.append(qMakePair(QString{targetPath % "/" % next->name()}, next));
+            continue;
+         }
+         // Leafnode
+         //
+         // TODO: At some point we should refactor this code so that we have separate handling for objects that have
+         //       folders from ones that don't.
+         NamedEntity * thing = next->thing();
+         if (FolderUtils::getFolder(thing)) {
+            idsByTypeAndFolder[next->type()][targetPath].append(thing->key());
+            itemsToMove.append(thing);
          }
       }
    }
-   // Last thing is to remove the victim.
-   i = start->childNumber();
-   return removeRows(i, 1, pInd);
+
+   Database & database = Database::instance();
+   QSqlDatabase connection = database.sqlDatabase();
+   DbTransaction dbTransaction{database, connection, QString("Rename folder %1").arg(victim->fullPath())};
+   NamedEntityChangeBatch changeBatch;
+
+   this->beginBulkChange();
+   bool succeeded = true;
+   for (auto ii = idsByTypeAndFolder.cbegin(); succeeded && ii != idsByTypeAndFolder.cend(); ++ii) {
+      ObjectStore * objectStore = getObjectStore(ii.key());
+      succeeded = objectStore && objectStore->setPropertyInBulk(PropertyNames::FolderBase::folder, ii.value());
+   }
+   succeeded = succeeded && dbTransaction.commit();
+   if (succeeded) {
+      // Each item is removed from its old place in the tree and added under its new folder in endBulkChange()
+      for (NamedEntity * thing : itemsToMove) {
+         this->folderChanged(thing);
+      }
+      // Last thing is to remove the victim.
+      this->m_pendingRemovals.insert(start, nullptr);
+   }
+   this->endBulkChange();
+   return succeeded;
 }
 
 QModelIndex TreeModel::createFolderTree(QStringList dirs, TreeNode * parent, QString pPath) {
@@ -1095,6 +1541,14 @@ QModelIndex TreeModel::findFolder(QString name, TreeNode * parent, bool create)
 // ============================ SLOT STUFF ===============================
 // =========================================================================
 
+void TreeModel::forgetToolTip() {
+   NamedEntity const * d = qobject_cast<NamedEntity const *>(sender());
+   if (d) {
+      this->m_toolTips.remove(d);
+   }
+   return;
+}
+
 void TreeModel::elementChanged() {
    NamedEntity * d = qobject_cast<NamedEntity *>(sender());
    if (!d) {
@@ -1110,6 +1564,35 @@ void TreeModel::elementChanged() {
    emit dataChanged(ndxLeft, ndxRight);
 }
 
+void TreeModel::recipeValueChanged(int recipeKey, int propertyIndex) {
+   using ColumnIndex = TreeItemNode<Recipe>::ColumnIndex;
+   static QHash<int, ColumnIndex> const columnsByPropertyIndex {
+      {NamedEntity::propertyIndex<Recipe>(PropertyNames::Recipe::og         ), ColumnIndex::Og       },
+      {NamedEntity::propertyIndex<Recipe>(PropertyNames::Recipe::fg         ), ColumnIndex::Fg       },
+      {NamedEntity::propertyIndex<Recipe>(PropertyNames::Recipe::IBU        ), ColumnIndex::Ibu      },
+      {NamedEntity::propertyIndex<Recipe>(PropertyNames::Recipe::ABV_pct    ), ColumnIndex::Abv      },
+      {NamedEntity::propertyIndex<Recipe>(PropertyNames::Recipe::color_srm  ), ColumnIndex::Color    },
+      {NamedEntity::propertyIndex<Recipe>(PropertyNames::Recipe::batchSize_l), ColumnIndex::BatchSize},
+   };
+   auto column = columnsByPropertyIndex.constFind(propertyIndex);
+   if (column == columnsByPropertyIndex.cend()) {
+      return;
+   }
+
+   // The connection is queued (see observeElement), so the recipe might have gone by the time we get here
+   Recipe * recipe = ObjectStoreWrapper::getByIdRaw<Recipe>(recipeKey);
+   if (!recipe) {
+      return;
+   }
+   QModelIndex const ndx = this->findElement(recipe);
+   if (!ndx.isValid()) {
+      return;
+   }
+   QModelIndex const cell = this->createIndex(ndx.row(), static_cast<int>(*column), ndx.internalPointer());
+   emit dataChanged(cell, cell);
+   return;
+}
+
 /* I don't like this part, but Qt's signal/slot mechanism are pretty
  * simplistic and do a string compare on signatures. Each one of these one
  * liners is required to give the right signature and to be able to call
@@ -1150,6 +1633,11 @@ void TreeModel::elementAdded(NamedEntity * victim) {
       return;
    }
 
+   if (this->m_bulkChangeDepth > 0) {
+      this->m_pendingAdditions.append(victim);
+      return;
+   }
+
    QModelIndex pIdx;
    auto lType = this->nodeType;
    if (qobject_cast<BrewNote *>(victim)) {
@@ -1165,6 +1653,11 @@ void TreeModel::elementAdded(NamedEntity * victim) {
       return;
    }
 
+   // If the recipe's brewnotes haven't been created yet, the new one will be created along with the rest of them
+   if (this->canFetchMore(pIdx)) {
+      return;
+   }
+
    int breadth = rowCount(pIdx);
    if (!insertRow(breadth, pIdx, victim, lType)) {
       return;
@@ -1227,6 +1720,11 @@ void TreeModel::elementRemoved(NamedEntity * victim) {
       return;
    }
 
+   if (this->m_bulkChangeDepth > 0) {
+      this->m_pendingRemovals.insert(this->item(index), victim);
+      return;
+   }
+
    QModelIndex pIndex = parent(index);
    if (!pIndex.isValid()) {
       return;
@@ -1236,35 +1734,49 @@ void TreeModel::elementRemoved(NamedEntity * victim) {
       return;
    }
 
+   this->m_toolTips.remove(victim);
    disconnect(victim, nullptr, this, nullptr);
    return;
 }
 
+void TreeModel::recipesChangedInBulk() {
+   //
+   // Only the values shown in the tree have changed, not its structure, so, rather than a full model reset (which would
+   // collapse all the folders and lose the selection), we tell the views the layout changed.  This gets them to
+   // re-query everything they're showing in one go, whilst keeping all the existing indexes valid.
+   //
+   emit this->layoutAboutToBeChanged();
+   emit this->layoutChanged();
+   return;
+}
+
 void TreeModel::recipePropertyChanged(int recipeId, BtStringConst const & propertyName) {
    // If a Recipe's ancestor ID has changed then it might be because a new ancestor has been created
    // .:TBD:. We could probably get away with propertyName == PropertyNames::Recipe::ancestorId here because
    // we always use the same constants for property names.
    if (propertyName != PropertyNames::Recipe::ancestorId) {
-      qDebug() << Q_FUNC_INFO << "Ignoring change to" << propertyName << "on Recipe" << recipeId;
+      qCDebug(Logging::tree) << Q_FUNC_INFO << "Ignoring change to" << propertyName << "on Recipe" << recipeId;
       return;
    }
 
    Recipe * descendant = ObjectStoreWrapper::getByIdRaw<Recipe>(recipeId);
    if (!descendant) {
-      qCritical() << Q_FUNC_INFO << "Unable to find Recipe" << recipeId << "to check its change to" << propertyName;
+      qCCritical(Logging::tree) <<
+         Q_FUNC_INFO << "Unable to find Recipe" << recipeId << "to check its change to" << propertyName;
       return;
    }
 
    int ancestorId = descendant->getAncestorId();
 
    if (ancestorId <= 0 || ancestorId == descendant->key()) {
-      qDebug() << Q_FUNC_INFO << "No ancestor (" << ancestorId << ") on Recipe" << recipeId;
+      qCDebug(Logging::tree) << Q_FUNC_INFO << "No ancestor (" << ancestorId << ") on Recipe" << recipeId;
       return;
    }
 
    Recipe * ancestor = ObjectStoreWrapper::getByIdRaw<Recipe>(ancestorId);
    if (!ancestor) {
-      qCritical() << Q_FUNC_INFO << "Unable to find Recipe" << ancestorId << "set as ancestor to Recipe" << recipeId;
+      qCCritical(Logging::tree) <<
+         Q_FUNC_INFO << "Unable to find Recipe" << ancestorId << "set as ancestor to Recipe" << recipeId;
       return;
    }
 
@@ -1279,11 +1791,30 @@ void TreeModel::observeElement(NamedEntity * d) {
       return;
    }
 
+   // Since we can be asked to observe the same element more than once (see observeChildren), we need to make sure we
+   // don't end up with duplicate connections.
    if (qobject_cast<BrewNote *>(d)) {
-      connect(qobject_cast<BrewNote *>(d), &BrewNote::brewDateChanged, this, &TreeModel::elementChanged);
+      connect(qobject_cast<BrewNote *>(d), &BrewNote::brewDateChanged, this, &TreeModel::elementChanged,
+              Qt::UniqueConnection);
    } else {
-      connect(d, &NamedEntity::changedName,   this, &TreeModel::elementChanged);
-      connect(d, &NamedEntity::changedFolder, this, static_cast<void (TreeModel::*)(QString)>(&TreeModel::folderChanged));
+      connect(d, &NamedEntity::propertyChanged, this, &TreeModel::forgetToolTip,  Qt::UniqueConnection);
+      connect(d, &NamedEntity::changedName,     this, &TreeModel::elementChanged, Qt::UniqueConnection);
+      if (qobject_cast<Recipe *>(d)) {
+         //
+         // Calculated values usually change as a result of something asking for them, which, for the tree, can be in
+         // the middle of sorting.  So we queue the notification rather than change the model under the sort.
+         //
+         connect(d,
+                 &NamedEntity::propertyChanged,
+                 this,
+                 &TreeModel::recipeValueChanged,
+                 static_cast<Qt::ConnectionType>(Qt::QueuedConnection | Qt::UniqueConnection));
+      }
+      connect(d,
+              &NamedEntity::changedFolder,
+              this,
+              static_cast<void (TreeModel::*)(QString)>(&TreeModel::folderChanged),
+              Qt::UniqueConnection);
    }
 }
 
@@ -1297,7 +1828,7 @@ bool TreeModel::dropMimeData(QMimeData const * data,
                                [[maybe_unused]] int column,
                                QModelIndex const & parent) {
    // See https://en.wikipedia.org/wiki/Media_type for more on MIME types (now called media types)
-   qDebug() <<
+   qCDebug(Logging::tree) <<
       Q_FUNC_INFO << "MIME Data:" << (data ? data->text() : "NULL") << ".  "
       "Parent" << (parent.isValid() ? "valid" : "invalid");
 
@@ -1308,7 +1839,7 @@ bool TreeModel::dropMimeData(QMimeData const * data,
    } else if (data->hasFormat("application/x-brewtarget-folder")) {
       encodedData = data->data("application/x-brewtarget-folder");
    } else {
-      qDebug() << Q_FUNC_INFO << "Unrecognised MIME type";
+      qCDebug(Logging::tree) << Q_FUNC_INFO << "Unrecognised MIME type";
       return false;   // Don't know what we got, but we don't want it
    }
 
@@ -1316,7 +1847,7 @@ bool TreeModel::dropMimeData(QMimeData const * data,
       return false;
    }
 
-   qDebug() << Q_FUNC_INFO << "Parent row:" << parent.row() << ", column:" << parent.column();
+   qCDebug(Logging::tree) << Q_FUNC_INFO << "Parent row:" << parent.row() << ", column:" << parent.column();
 
    QString target = "";
    if (this->itemIs<Folder>(parent)) {
@@ -1328,18 +1859,18 @@ bool TreeModel::dropMimeData(QMimeData const * data,
       // actually drop things there? If somebody drops something there, don't
       // do anything
       if (! something) {
-         qDebug() << Q_FUNC_INFO << "Invalid drop location";
+         qCDebug(Logging::tree) << Q_FUNC_INFO << "Invalid drop location";
          return false;
       }
       auto folder = FolderUtils::getFolder(something);
       if (!folder) {
-         qDebug() << Q_FUNC_INFO << "Dragged element" << something << "cannot have folder";
+         qCDebug(Logging::tree) << Q_FUNC_INFO << "Dragged element" << something << "cannot have folder";
          return false;
       }
       target = *folder;
    }
 
-   qDebug() << Q_FUNC_INFO << "Target:" << target;
+   qCDebug(Logging::tree) << Q_FUNC_INFO << "Target:" << target;
 
    // Pull the stream apart and do that which needs done. Late binding ftw!
    for (QDataStream stream{&encodedData, QIODevice::ReadOnly}; !stream.atEnd(); ) {
@@ -1348,18 +1879,18 @@ bool TreeModel::dropMimeData(QMimeData const * data,
       QString name = "";
       stream >> oTypeRaw >> id >> name;
       TreeNode::Type oType = static_cast<TreeNode::Type>(oTypeRaw);
-      qDebug() << Q_FUNC_INFO << "Name:" << name << ", ID:" << id << ", Type:" << oTypeRaw;
+      qCDebug(Logging::tree) << Q_FUNC_INFO << "Name:" << name << ", ID:" << id << ", Type:" << oTypeRaw;
 
       auto item = getElement(oType, id);
       auto folder = FolderUtils::getFolder(item);
       if (!folder) {
-         qDebug() << Q_FUNC_INFO << "No matching element";
+         qCDebug(Logging::tree) << Q_FUNC_INFO << "No matching element";
          return false;
       }
 
       // this is the work.
       if (oType != TreeNode::Type::Folder) {
-         qDebug() <<
+         qCDebug(Logging::tree) <<
             Q_FUNC_INFO << "Moving" << item << "from folder" << folder << "to folder" << target;
          // Dropping an item in a folder just means setting the folder name on that item
          FolderUtils::setFolder(item, target);
@@ -1398,13 +1929,13 @@ void TreeModel::revertRecipeToPreviousVersion(QModelIndex ndx) {
 
    // Put the ancestor into the tree
    if (! insertRow(pIndex.row(), pIndex, ancestor, TreeNode::Type::Recipe)) {
-      qWarning() << Q_FUNC_INFO << "Could not add ancestor to tree";
+      qCWarning(Logging::tree) << Q_FUNC_INFO << "Could not add ancestor to tree";
    }
 
    // Find the ancestor in the tree
    QModelIndex ancNdx = findElement(ancestor);
    if (! ancNdx.isValid()) {
-      qWarning() << Q_FUNC_INFO << "Couldn't find the ancestor";
+      qCWarning(Logging::tree) << Q_FUNC_INFO << "Couldn't find the ancestor";
    }
 
    // Add the ancestor's brewnotes to the descendant
@@ -1447,13 +1978,13 @@ void TreeModel::orphanRecipe(QModelIndex ndx) {
 
    // Put the ancestor into the tree
    if ( ! insertRow(pIndex.row(), pIndex, ancestor, TreeNode::Type::Recipe) ) {
-      qWarning() << Q_FUNC_INFO << "Could not add ancestor to tree";
+      qCWarning(Logging::tree) << Q_FUNC_INFO << "Could not add ancestor to tree";
    }
 
    // Find the ancestor in the tree
    QModelIndex ancNdx = findElement(ancestor);
    if ( ! ancNdx.isValid() ) {
-      qWarning() << Q_FUNC_INFO << "Couldn't find the ancestor";
+      qCWarning(Logging::tree) << Q_FUNC_INFO << "Couldn't find the ancestor";
    }
 
    // Add the ancestor's brewnotes to the descendant
@@ -1471,7 +2002,7 @@ void TreeModel::spawnRecipe(QModelIndex ndx) {
    ObjectStoreWrapper::insert<Recipe>(descendant);
    // ...then we can connect it to the one it was copied from
    descendant->setAncestor(*ancestor);
-   qDebug() <<
+   qCDebug(Logging::tree) <<
       Q_FUNC_INFO << "Created descendant Recipe" << descendant->key() << "of Recipe" << ancestor->key() <<
       "(at position" << ndx.row() << ")";
 
@@ -1483,7 +2014,7 @@ void TreeModel::spawnRecipe(QModelIndex ndx) {
    //
    ndx = this->findElement(ancestor);
    if (!removeRows(ndx.row(), 1, this->parent(ndx))) {
-      qCritical() << Q_FUNC_INFO << "Could not find Recipe" << ancestor->key() << "in display tree";
+      qCCritical(Logging::tree) << Q_FUNC_INFO << "Could not find Recipe" << ancestor->key() << "in display tree";
    }
 
    // Now we need to find the descendant in the tree. This has to be done
@@ -1498,12 +2029,13 @@ void TreeModel::spawnRecipe(QModelIndex ndx) {
 }
 
 void TreeModel::versionedRecipe(Recipe * ancestor, Recipe * descendant) {
-   qDebug() << Q_FUNC_INFO << "Updating tree now that Recipe" << descendant->key() << "has ancestor Recipe" << ancestor->key();
+   qCDebug(Logging::tree) <<
+      Q_FUNC_INFO << "Updating tree now that Recipe" << descendant->key() << "has ancestor Recipe" << ancestor->key();
 
    // like before, remove the ancestor
    QModelIndex ndx = findElement(ancestor);
    if (!removeRows(ndx.row(), 1, this->parent(ndx))) {
-      qCritical() << Q_FUNC_INFO << "Could not find Recipe" << ancestor->key() << "in display tree";
+      qCCritical(Logging::tree) << Q_FUNC_INFO << "Could not find Recipe" << ancestor->key() << "in display tree";
    }
 
    // add the descendant in, but get the index only after we removed the
@@ -1572,7 +2104,7 @@ void TreeModel::showAncestors(QModelIndex ndx) {
    for (auto ancestor : ancestors) {
       int j = node->childCount();
       if (! insertRow(j, ndx, ancestor, TreeNode::Type::Recipe)) {
-         qWarning() << "Could not add ancestoral brewnotes";
+         qCWarning(Logging::tree) << "Could not add ancestoral brewnotes";
       }
       QModelIndex cIndex = findElement(ancestor, node);
       setShowChild(cIndex, true);
@@ -25,9 +25,11 @@
 
 #include <QAbstractItemModel>
 #include <QFlags> // For Q_DECLARE_FLAGS
+#include <QHash>
 #include <QList>
 #include <QMetaProperty>
 #include <QModelIndex>
+#include <QMultiHash>
 #include <QObject>
 //#include <QSqlRelationalTableModel>
 #include <QVariant>
@@ -77,6 +79,12 @@ public:
    };
    Q_DECLARE_FLAGS(TypeMasks, TypeMask)
 
+   /**
+    * \brief Role for the raw value on which a cell is sorted (eg a date rather than a formatted date string), as
+    *        opposed to what is displayed.  See \c TreeNode::sortKey and \c TreeFilterProxyModel::lessThan.
+    */
+   static constexpr int SortRole = Qt::UserRole + 1;
+
    TreeModel(TreeView * parent = nullptr, TypeMasks type = TypeMask::Recipe);
    virtual ~TreeModel();
 
@@ -96,6 +104,18 @@ public:
    //! \brief Reimplemented from QAbstractItemModel
    virtual QModelIndex parent(const QModelIndex & index) const;
 
+   //! \brief Reimplemented from QAbstractItemModel, so that recipes whose children we haven't yet created (see
+   //!        \c fetchMore) can still be expanded
+   virtual bool hasChildren(const QModelIndex & parent = QModelIndex()) const;
+   //! \brief Reimplemented from QAbstractItemModel
+   virtual bool canFetchMore(const QModelIndex & parent) const;
+   /**
+    * \brief Reimplemented from QAbstractItemModel.  A recipe can have hundreds of brew notes (and, if we are showing
+    *        snapshots, ancestors, each with their own brew notes), so we don't create the child nodes of a recipe until
+    *        the view asks for them, which is normally when the recipe is first expanded.
+    */
+   virtual void fetchMore(const QModelIndex & parent);
+
    //! \brief Reimplemented from QAbstractItemModel
    bool insertRow(int row,
                   QModelIndex const & parent = QModelIndex(),
@@ -126,9 +146,17 @@ public:
    // I'm trying to shove some complexity down a few layers.
    // \!brief returns the name of whatever is at idx
    QString name(const QModelIndex & idx);
-   //! \brief delete things from the tree/db
+   /**
+    * \brief delete things from the tree/db.  All the DB updates are done in one transaction, and the tree is updated
+    *        once at the end, with one \c removeRows call per run of adjacent rows under the same parent.
+    */
    void deleteSelected(QModelIndexList victims);
 
+   /**
+    * \brief Copy the items at the supplied indexes, giving each copy the supplied name.  The copies of each type of
+    *        item are stored in one go (see \c ObjectStore::insertMany), and added to the tree with one
+    *        \c beginInsertRows / \c endInsertRows per folder.
+    */
    void copySelected(QList< QPair<QModelIndex, QString>> toBeCopied);
 
    /**
@@ -145,6 +173,13 @@ public:
    //! \brief one find method to find them all, and in darkness bind them
    QModelIndex findElement(NamedEntity * thing, TreeNode * parent = nullptr);
 
+   /**
+    * \brief If \c thing is a \c BrewNote, create the children (see \c fetchMore) of any recipe nodes it would be shown
+    *        under, so that \c findElement can find it.  Nothing else gets created lazily, so, for anything else, this
+    *        does nothing.
+    */
+   void fetchNodesFor(NamedEntity const * thing);
+
    //! \brief Get index of \c Folder
    QModelIndex findFolder(QString folder, TreeNode * parent = nullptr, bool create = false);
    //! \brief a new folder .
@@ -179,6 +214,19 @@ public slots:
    void versionedRecipe(Recipe * ancestor, Recipe * descendant);
    void catchAncestors(bool showem);
 
+   /**
+    * \brief Start observing (see \c observeElement) the children of \c parent (or of the root if \c parent is
+    *        invalid).  We don't observe everything in the tree up-front, as that can be a lot of signal connections
+    *        for items that the user never looks at.  Instead, the view calls this when it expands a node.
+    */
+   void observeChildren(QModelIndex const & parent);
+
+   /**
+    * \brief Remove the children of the recipe at \c parent, to be recreated by \c fetchMore if it's needed again.
+    *        The view calls this when it collapses a node.  Does nothing for other types of node.
+    */
+   void unloadChildren(QModelIndex const & parent);
+
 private slots:
    //! \brief slot to catch a changed folder signal. Folders are odd, because they
    // can hold .. anything, including other folders. So I need the most generic
@@ -198,6 +246,14 @@ private slots:
    void elementAddedWater      (int victimId);
 
    void elementChanged();
+   //! \brief The sender has changed, so we need to rebuild its tooltip next time it's asked for
+   void forgetToolTip();
+   /**
+    * \brief Receives \c NamedEntity::propertyChanged from recipes, so that we can update the calculated value columns
+    *        (OG, IBU etc).  Only the affected cell is marked changed, so views don't re-sort unless they are sorted on
+    *        that column.
+    */
+   void recipeValueChanged(int recipeKey, int propertyIndex);
 
    void elementRemovedRecipe     (int victimId, std::shared_ptr<QObject> victim);
    void elementRemovedEquipment  (int victimId, std::shared_ptr<QObject> victim);
@@ -211,19 +267,59 @@ private slots:
 
    void recipePropertyChanged(int recipeId, BtStringConst const & propertyName);
 
+   //! \brief Refresh the whole tree after all the recipes have been changed at once
+   void recipesChangedInBulk();
+
 signals:
    void expandFolder(TreeModel::TypeMasks kindofThing, QModelIndex fIdx);
    void recipeSpawn(Recipe * descendant);
 
 private:
+   //! \brief What \c fetchMore needs to create under a recipe node whose children have not yet been created
+   enum class ChildrenToFetch {
+      //! The brew notes of the recipe and all its ancestors -- ie how a recipe is shown when snapshots are hidden
+      BrewNotesIncludingAncestors,
+      //! A node for each ancestor of the recipe, followed by the recipe's own brew notes
+      AncestorsAndBrewNotes,
+      //! Just the recipe's own brew notes -- eg for an ancestor shown under its descendant
+      BrewNotes
+   };
+
    //! \brief Loads the tree.
    void loadTreeModel();
 
+   /**
+    * \brief Work out what the children of \c node would be, if it is a recipe node, so that \c unloadChildren can
+    *        remove them and record how to put them back.
+    */
+   ChildrenToFetch childrenToFetch(TreeNode * node);
+
+   //! \brief Record that \c node (a recipe node with no children yet) should get \c children when \c fetchMore is
+   //!        called -- unless it turns out there aren't any, in which case there's nothing to record
+   void deferChildren(TreeNode * node, ChildrenToFetch children);
+
    //! \brief add and remove an element from the, respectively. All of the
    //slots actually call these two methods
    void elementAdded(NamedEntity * victim);
    void elementRemoved(NamedEntity * victim);
 
+   //! \brief Does the work of \c deleteSelected, recursing into folders
+   void deleteItems(QModelIndexList victims);
+
+   /**
+    * \brief Between calls to \c beginBulkChange and \c endBulkChange (which can be nested), \c elementAdded and
+    *        \c elementRemoved just note what needs doing to the tree.  The outermost \c endBulkChange then does it
+    *        all, with one update of the model per parent node rather than one per item.
+    */
+   void beginBulkChange();
+   void endBulkChange();
+
+   /**
+    * \brief Make the queued insertions and deletions that \c ObjectStoreTyped<NE> delivers when an
+    *        \c ObjectStoreSignalBatch closes (eg at the end of an import) into one bulk change.
+    */
+   template<class NE> void followBulkDeliveries();
+
    //! \brief connects the changedName() signal and changedFolder() signals to
    //! the proper methods for most things, and the same for changedBrewDate
    //! and brewNotes
@@ -245,7 +341,11 @@ private:
    void addBrewNoteSubTree(Recipe * rec, int i, TreeNode * parent, bool recurse = true);
    //! \b flip the switch to show descendants
    void setShowChild(QModelIndex child, bool val);
-   void addAncestoralTree(Recipe * rec, int i, TreeNode * parent);
+
+   //! \brief Add \c node and everything under it to \c m_nodesByElement
+   void indexSubtree(TreeNode * node);
+   //! \brief Remove \c node and everything under it from \c m_nodesByElement
+   void unindexSubtree(TreeNode * node);
 
    TreeNode * rootItem;
    TreeView * parentTree;
@@ -254,6 +354,25 @@ private:
    int m_maxColumns;
    QString m_mimeType;
 
+   //! Every node in the tree that holds a \c NamedEntity, so that \c findElement doesn't have to search the tree
+   QMultiHash<NamedEntity const *, TreeNode *> m_nodesByElement;
+
+   //! Tooltips we have already built -- see \c toolTipData
+   mutable QHash<NamedEntity const *, QString> m_toolTips;
+
+   //! Recipe nodes that have children we have not yet created, and what those children are.  See \c fetchMore.
+   QHash<TreeNode *, ChildrenToFetch> m_unfetchedChildren;
+
+   //! Number of \c beginBulkChange calls not yet matched by \c endBulkChange
+   int m_bulkChangeDepth;
+   //! Elements to add to the tree at the end of the current bulk change
+   QList<NamedEntity *> m_pendingAdditions;
+   /**
+    * Nodes to remove from the tree at the end of the current bulk change, and the element each one holds (or
+    * \c nullptr for a folder).  The elements will have been soft deleted, so they are still in their object stores.
+    */
+   QHash<TreeNode *, NamedEntity *> m_pendingRemovals;
+
 };
 
 // This is a bit ugly, but will ultimately be refactored away, once we stop having to decide at runtime whether
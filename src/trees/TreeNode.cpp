@@ -21,6 +21,9 @@
  ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
 #include "trees/TreeNode.h"
 
+#include <optional>
+#include <type_traits>
+
 #include <QDateTime>
 #include <QDebug>
 #include <QHash>
@@ -30,6 +33,7 @@
 #include <QVariant>
 #include <QVector>
 
+#include "Logging.h"
 #include "model/Folder.h"
 #include "Localization.h"
 #include "measurement/Measurement.h"
@@ -51,6 +55,12 @@ template<> EnumStringMapping const TreeItemNode<Recipe>::columnDisplayNames {
    {TreeItemNode<Recipe>::ColumnIndex::NumberOfAncestors, Recipe::tr("Snapshots")},
    {TreeItemNode<Recipe>::ColumnIndex::BrewDate         , Recipe::tr("Brew Date")},
    {TreeItemNode<Recipe>::ColumnIndex::Style            , Recipe::tr("Style"    )},
+   {TreeItemNode<Recipe>::ColumnIndex::Og               , Recipe::tr("OG"       )},
+   {TreeItemNode<Recipe>::ColumnIndex::Fg               , Recipe::tr("FG"       )},
+   {TreeItemNode<Recipe>::ColumnIndex::Ibu              , Recipe::tr("IBU"      )},
+   {TreeItemNode<Recipe>::ColumnIndex::Abv              , Recipe::tr("ABV"      )},
+   {TreeItemNode<Recipe>::ColumnIndex::Color            , Recipe::tr("Color"    )},
+   {TreeItemNode<Recipe>::ColumnIndex::BatchSize        , Recipe::tr("Batch Size")},
 };
 
 template<> EnumStringMapping const TreeItemNode<Equipment>::columnDisplayNames {
@@ -111,148 +121,139 @@ template<> EnumStringMapping const TreeFolderNode<Hop>::columnDisplayNames {
    {TreeFolderNode<Hop>::ColumnIndex::FullPath, Folder::tr("FULLPATH")},
 };
 
-template<> bool TreeItemNode<Recipe>::isLessThan(TreeModel const & model,
-                                                 QModelIndex const & left,
-                                                 QModelIndex const & right,
-                                                 TreeItemTraits<TreeItemNode<Recipe>>::ColumnIndex section,
-                                                 Recipe const & lhs,
-                                                 Recipe const & rhs) {
-   if (model.showChild(left) && model.showChild(right)) {
-      return lhs.key() > rhs.key();
+namespace {
+   //
+   // Sort keys are compared by TreeFilterProxyModel as strings, dates or numbers, with an invalid QVariant (eg for an
+   // unset optional value) sorting before everything else.  Enums sort by their numerical value.
+   //
+   template<typename T>
+   QVariant sortKeyOf(T const & val) {
+      if constexpr (std::is_enum_v<T>) {
+         return QVariant{static_cast<int>(val)};
+      } else {
+         return QVariant{val};
+      }
    }
 
-   switch (section) {
-      case TreeItemNode<Recipe>::ColumnIndex::Name:
-         return lhs.name() < rhs.name();
-
-      case TreeItemNode<Recipe>::ColumnIndex::BrewDate:
-         return lhs.date() < rhs.date();
-
-      case TreeItemNode<Recipe>::ColumnIndex::Style:
-         if (!lhs.style()) {
-            return true;
-         }
-         if (!rhs.style()) {
-            return false;
-         }
-         return lhs.style()->name() < rhs.style()->name();
+   template<typename T>
+   QVariant sortKeyOf(std::optional<T> const & val) {
+      return val ? sortKeyOf(*val) : QVariant{};
+   }
+}
 
-      case TreeItemNode<Recipe>::ColumnIndex::NumberOfAncestors:
-         return lhs.ancestors().length() < rhs.ancestors().length();
+template<> QVariant TreeItemNode<Recipe>::sortKey(Recipe const & item,
+                                                  TreeItemTraits<TreeItemNode<Recipe>>::ColumnIndex section) {
+   //
+   // The getters for calculated values aren't const because they calculate on demand (or, more usually, pick up the
+   // values stored by RecipeCalculationCache).  TreeFilterProxyModel remembers the keys we return, so each recipe only
+   // gets asked once per column until it changes.
+   //
+   Recipe & recipe = const_cast<Recipe &>(item);
+   switch (section) {
+      case TreeItemNode<Recipe>::ColumnIndex::Name             : return sortKeyOf(item.name());
+      case TreeItemNode<Recipe>::ColumnIndex::BrewDate         : return sortKeyOf(item.date());
+      // No style sorts first
+      case TreeItemNode<Recipe>::ColumnIndex::Style            : return item.style() ? sortKeyOf(item.style()->name()) :
+                                                                                       QVariant{};
+      case TreeItemNode<Recipe>::ColumnIndex::NumberOfAncestors: return sortKeyOf(item.ancestors().length());
+      case TreeItemNode<Recipe>::ColumnIndex::Og               : return sortKeyOf(recipe.og());
+      case TreeItemNode<Recipe>::ColumnIndex::Fg               : return sortKeyOf(recipe.fg());
+      case TreeItemNode<Recipe>::ColumnIndex::Ibu              : return sortKeyOf(recipe.IBU());
+      case TreeItemNode<Recipe>::ColumnIndex::Abv              : return sortKeyOf(recipe.ABV_pct());
+      case TreeItemNode<Recipe>::ColumnIndex::Color            : return sortKeyOf(recipe.color_srm());
+      case TreeItemNode<Recipe>::ColumnIndex::BatchSize        : return sortKeyOf(item.batchSize_l());
    }
 
    // Default will be to just do a name sort. This doesn't likely make sense, but it will prevent a lot of warnings.
-   return lhs.name() < rhs.name();
+   return sortKeyOf(item.name());
 }
 
-template<> bool TreeItemNode<Equipment>::isLessThan([[maybe_unused]] TreeModel const & model,
-                                                    [[maybe_unused]] QModelIndex const & left,
-                                                    [[maybe_unused]] QModelIndex const & right,
-                                                    TreeItemTraits<TreeItemNode<Equipment>>::ColumnIndex section,
-                                                    Equipment const & lhs,
-                                                    Equipment const & rhs) {
-   switch (section) {
-      case TreeItemNode<Equipment>::ColumnIndex::Name:
-         return lhs.name() < rhs.name();
+template<> QVariant TreeItemNode<BrewNote>::sortKey(
+   BrewNote const & item,
+   [[maybe_unused]] TreeItemTraits<TreeItemNode<BrewNote>>::ColumnIndex section
+) {
+   // Whatever column we're sorting the recipes on, brewnotes are always in date order
+   return sortKeyOf(item.brewDate());
+}
 
+template<> QVariant TreeItemNode<Equipment>::sortKey(Equipment const & item,
+                                                     TreeItemTraits<TreeItemNode<Equipment>>::ColumnIndex section) {
+   switch (section) {
+      case TreeItemNode<Equipment>::ColumnIndex::Name    : return sortKeyOf(item.name());
       case TreeItemNode<Equipment>::ColumnIndex::BoilTime:
-         return lhs.boilTime_min().value_or(Equipment::default_boilTime_mins) < rhs.boilTime_min().value_or(Equipment::default_boilTime_mins);
+         return sortKeyOf(item.boilTime_min().value_or(Equipment::default_boilTime_mins));
    }
 
-   return lhs.name() < rhs.name();
+   return sortKeyOf(item.name());
 }
 
-template<> bool TreeItemNode<Fermentable>::isLessThan([[maybe_unused]] TreeModel const & model,
-                                                      [[maybe_unused]] QModelIndex const & left,
-                                                      [[maybe_unused]] QModelIndex const & right,
-                                                      TreeItemTraits<TreeItemNode<Fermentable>>::ColumnIndex section,
-                                                      Fermentable const & lhs,
-                                                      Fermentable const & rhs) {
+template<> QVariant TreeItemNode<Fermentable>::sortKey(Fermentable const & item,
+                                                       TreeItemTraits<TreeItemNode<Fermentable>>::ColumnIndex section) {
    switch (section) {
-      case TreeItemNode<Fermentable>::ColumnIndex::Name : return lhs.name()      < rhs.name();
-      case TreeItemNode<Fermentable>::ColumnIndex::Type : return lhs.type()      < rhs.type();
-      case TreeItemNode<Fermentable>::ColumnIndex::Color: return lhs.color_srm() < rhs.color_srm();
+      case TreeItemNode<Fermentable>::ColumnIndex::Name : return sortKeyOf(item.name()     );
+      case TreeItemNode<Fermentable>::ColumnIndex::Type : return sortKeyOf(item.type()     );
+      case TreeItemNode<Fermentable>::ColumnIndex::Color: return sortKeyOf(item.color_srm());
    }
-   return lhs.name() < rhs.name();
+   return sortKeyOf(item.name());
 }
 
-template<> bool TreeItemNode<Hop>::isLessThan([[maybe_unused]] TreeModel const & model,
-                                              [[maybe_unused]] QModelIndex const & left,
-                                              [[maybe_unused]] QModelIndex const & right,
-                                              TreeItemTraits<TreeItemNode<Hop>>::ColumnIndex section,
-                                              Hop const & lhs,
-                                              Hop const & rhs) {
+template<> QVariant TreeItemNode<Hop>::sortKey(Hop const & item,
+                                               TreeItemTraits<TreeItemNode<Hop>>::ColumnIndex section) {
    switch (section) {
-      case TreeItemNode<Hop>::ColumnIndex::Name    : return lhs.name()      < rhs.name();
-      case TreeItemNode<Hop>::ColumnIndex::Form    : return lhs.form()      < rhs.form();
-      case TreeItemNode<Hop>::ColumnIndex::AlphaPct: return lhs.alpha_pct() < rhs.alpha_pct();
-      case TreeItemNode<Hop>::ColumnIndex::Origin  : return lhs.origin()    < rhs.origin();
+      case TreeItemNode<Hop>::ColumnIndex::Name    : return sortKeyOf(item.name()     );
+      case TreeItemNode<Hop>::ColumnIndex::Form    : return sortKeyOf(item.form()     );
+      case TreeItemNode<Hop>::ColumnIndex::AlphaPct: return sortKeyOf(item.alpha_pct());
+      case TreeItemNode<Hop>::ColumnIndex::Origin  : return sortKeyOf(item.origin()   );
    }
-   return lhs.name() < rhs.name();
+   return sortKeyOf(item.name());
 }
 
-template<> bool TreeItemNode<Misc>::isLessThan([[maybe_unused]] TreeModel const & model,
-                                               [[maybe_unused]] QModelIndex const & left,
-                                               [[maybe_unused]] QModelIndex const & right,
-                                               TreeItemTraits<TreeItemNode<Misc>>::ColumnIndex section,
-                                               Misc const & lhs,
-                                               Misc const & rhs) {
+template<> QVariant TreeItemNode<Misc>::sortKey(Misc const & item,
+                                                TreeItemTraits<TreeItemNode<Misc>>::ColumnIndex section) {
    switch (section) {
-      case TreeItemNode<Misc>::ColumnIndex::Name: return lhs.name() < rhs.name();
-      case TreeItemNode<Misc>::ColumnIndex::Type: return lhs.type() < rhs.type();
+      case TreeItemNode<Misc>::ColumnIndex::Name: return sortKeyOf(item.name());
+      case TreeItemNode<Misc>::ColumnIndex::Type: return sortKeyOf(item.type());
    }
-   return lhs.name() < rhs.name();
+   return sortKeyOf(item.name());
 }
 
-template<> bool TreeItemNode<Style>::isLessThan([[maybe_unused]] TreeModel const & model,
-                                                [[maybe_unused]] QModelIndex const & left,
-                                                [[maybe_unused]] QModelIndex const & right,
-                                                TreeItemTraits<TreeItemNode<Style>>::ColumnIndex section,
-                                                Style const & lhs,
-                                                Style const & rhs) {
+template<> QVariant TreeItemNode<Style>::sortKey(Style const & item,
+                                                 TreeItemTraits<TreeItemNode<Style>>::ColumnIndex section) {
    switch (section) {
-      case TreeItemNode<Style>::ColumnIndex::Name          : return lhs.name()           < rhs.name();
-      case TreeItemNode<Style>::ColumnIndex::Category      : return lhs.category()       < rhs.category();
-      case TreeItemNode<Style>::ColumnIndex::CategoryNumber: return lhs.categoryNumber() < rhs.categoryNumber();
-      case TreeItemNode<Style>::ColumnIndex::CategoryLetter: return lhs.styleLetter()    < rhs.styleLetter();
-      case TreeItemNode<Style>::ColumnIndex::StyleGuide    : return lhs.styleGuide()     < rhs.styleGuide();
+      case TreeItemNode<Style>::ColumnIndex::Name          : return sortKeyOf(item.name()          );
+      case TreeItemNode<Style>::ColumnIndex::Category      : return sortKeyOf(item.category()      );
+      case TreeItemNode<Style>::ColumnIndex::CategoryNumber: return sortKeyOf(item.categoryNumber());
+      case TreeItemNode<Style>::ColumnIndex::CategoryLetter: return sortKeyOf(item.styleLetter()   );
+      case TreeItemNode<Style>::ColumnIndex::StyleGuide    : return sortKeyOf(item.styleGuide()    );
    }
-   return lhs.name() < rhs.name();
+   return sortKeyOf(item.name());
 }
 
-template<> bool TreeItemNode<Yeast>::isLessThan([[maybe_unused]] TreeModel const & model,
-                                                [[maybe_unused]] QModelIndex const & left,
-                                                [[maybe_unused]] QModelIndex const & right,
-                                                TreeItemTraits<TreeItemNode<Yeast>>::ColumnIndex section,
-                                                Yeast const & lhs,
-                                                Yeast const & rhs) {
+template<> QVariant TreeItemNode<Yeast>::sortKey(Yeast const & item,
+                                                 TreeItemTraits<TreeItemNode<Yeast>>::ColumnIndex section) {
    switch (section) {
-      case TreeItemNode<Yeast>::ColumnIndex::Name      : return lhs.name()       < rhs.name();
-      case TreeItemNode<Yeast>::ColumnIndex::Laboratory: return lhs.laboratory() < rhs.laboratory();
-      case TreeItemNode<Yeast>::ColumnIndex::ProductId : return lhs.productId()  < rhs.productId();
-      case TreeItemNode<Yeast>::ColumnIndex::Type      : return lhs.type()       < rhs.type();
-      case TreeItemNode<Yeast>::ColumnIndex::Form      : return lhs.form()       < rhs.form();
+      case TreeItemNode<Yeast>::ColumnIndex::Name      : return sortKeyOf(item.name()      );
+      case TreeItemNode<Yeast>::ColumnIndex::Laboratory: return sortKeyOf(item.laboratory());
+      case TreeItemNode<Yeast>::ColumnIndex::ProductId : return sortKeyOf(item.productId() );
+      case TreeItemNode<Yeast>::ColumnIndex::Type      : return sortKeyOf(item.type()      );
+      case TreeItemNode<Yeast>::ColumnIndex::Form      : return sortKeyOf(item.form()      );
    }
-   return lhs.name() < rhs.name();
+   return sortKeyOf(item.name());
 }
 
-template<> bool TreeItemNode<Water>::isLessThan([[maybe_unused]] TreeModel const & model,
-                                                [[maybe_unused]] QModelIndex const & left,
-                                                [[maybe_unused]] QModelIndex const & right,
-                                                TreeItemTraits<TreeItemNode<Water>>::ColumnIndex section,
-                                                Water const & lhs,
-                                                Water const & rhs) {
+template<> QVariant TreeItemNode<Water>::sortKey(Water const & item,
+                                                 TreeItemTraits<TreeItemNode<Water>>::ColumnIndex section) {
    switch (section) {
-      case TreeItemNode<Water>::ColumnIndex::Name       : return lhs.name()            < rhs.name();
-      case TreeItemNode<Water>::ColumnIndex::pH         : return lhs.ph()              < rhs.ph();
-      case TreeItemNode<Water>::ColumnIndex::Bicarbonate: return lhs.bicarbonate_ppm() < rhs.bicarbonate_ppm();
-      case TreeItemNode<Water>::ColumnIndex::Sulfate    : return lhs.sulfate_ppm()     < rhs.sulfate_ppm();
-      case TreeItemNode<Water>::ColumnIndex::Chloride   : return lhs.chloride_ppm()    < rhs.chloride_ppm();
-      case TreeItemNode<Water>::ColumnIndex::Sodium     : return lhs.sodium_ppm()      < rhs.sodium_ppm();
-      case TreeItemNode<Water>::ColumnIndex::Magnesium  : return lhs.magnesium_ppm()   < rhs.magnesium_ppm();
-      case TreeItemNode<Water>::ColumnIndex::Calcium    : return lhs.calcium_ppm()     < rhs.calcium_ppm();
+      case TreeItemNode<Water>::ColumnIndex::Name       : return sortKeyOf(item.name()           );
+      case TreeItemNode<Water>::ColumnIndex::pH         : return sortKeyOf(item.ph()             );
+      case TreeItemNode<Water>::ColumnIndex::Bicarbonate: return sortKeyOf(item.bicarbonate_ppm());
+      case TreeItemNode<Water>::ColumnIndex::Sulfate    : return sortKeyOf(item.sulfate_ppm()    );
+      case TreeItemNode<Water>::ColumnIndex::Chloride   : return sortKeyOf(item.chloride_ppm()   );
+      case TreeItemNode<Water>::ColumnIndex::Sodium     : return sortKeyOf(item.sodium_ppm()     );
+      case TreeItemNode<Water>::ColumnIndex::Magnesium  : return sortKeyOf(item.magnesium_ppm()  );
+      case TreeItemNode<Water>::ColumnIndex::Calcium    : return sortKeyOf(item.calcium_ppm()    );
    }
-   return lhs.name() < rhs.name();
+   return sortKeyOf(item.name());
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -339,7 +340,7 @@ int TreeNode::columnCount(TreeNode::Type nodeType) const {
       case TreeNode::Type::Folder:      return static_cast<int>(TreeFolderNode<      Hop>::Info::NumberOfColumns);
       case TreeNode::Type::Water:       return static_cast<int>(TreeItemNode<      Water>::Info::NumberOfColumns);
       default:
-         qWarning() << Q_FUNC_INFO << "Bad column:" << static_cast<int>(nodeType);
+         qCWarning(Logging::tree) << Q_FUNC_INFO << "Bad column:" << static_cast<int>(nodeType);
          return 0;
    }
 }
@@ -358,11 +359,40 @@ QVariant TreeNode::data(/*TreeNode::Type nodeType, */int column) {
       case TreeNode::Type::Folder:      return dataFolder     (column);
       case TreeNode::Type::Water:       return dataWater      (column);
       default:
-         qWarning() << Q_FUNC_INFO << "Bad column:" << static_cast<int>(nodeType);
+         qCWarning(Logging::tree) << Q_FUNC_INFO << "Bad column:" << static_cast<int>(nodeType);
          return QVariant();
    }
 }
 
+namespace {
+   template<class NE>
+   QVariant nodeSortKey(TreeNode & node, int const column) {
+      NE const * item = node.getData<NE>();
+      return item ? TreeItemNode<NE>::sortKeyFor(*item, column) : QVariant{};
+   }
+}
+
+QVariant TreeNode::sortKey(int column) {
+   switch (this->nodeType) {
+      case TreeNode::Type::Recipe:      return nodeSortKey<Recipe     >(*this, column);
+      case TreeNode::Type::Equipment:   return nodeSortKey<Equipment  >(*this, column);
+      case TreeNode::Type::Fermentable: return nodeSortKey<Fermentable>(*this, column);
+      case TreeNode::Type::Hop:         return nodeSortKey<Hop        >(*this, column);
+      case TreeNode::Type::Misc:        return nodeSortKey<Misc       >(*this, column);
+      case TreeNode::Type::Yeast:       return nodeSortKey<Yeast      >(*this, column);
+      case TreeNode::Type::Style:       return nodeSortKey<Style      >(*this, column);
+      case TreeNode::Type::BrewNote:    return nodeSortKey<BrewNote   >(*this, column);
+      case TreeNode::Type::Water:       return nodeSortKey<Water      >(*this, column);
+      case TreeNode::Type::Folder:
+         {
+            // Folders sort on their full path, whatever the column
+            Folder const * folder = this->getData<Folder>();
+            return folder ? QVariant{folder->fullPath()} : QVariant{};
+         }
+   }
+   return QVariant{};
+}
+
 int TreeNode::childNumber() const {
    if (this->parentItem) {
       return parentItem->childItems.indexOf(const_cast<TreeNode *>(this));
@@ -380,7 +410,8 @@ bool TreeNode::insertChildren(int position, int count, TreeNode::Type nodeType)
 //      Q_FUNC_INFO << "Inserting" << count << "children of type" << nodeType << "(" <<
 //      this->itemTypeToString(static_cast<TreeNode::Type>(nodeType)) << ") at position" << position;
    if (position < 0  || position > this->childItems.size()) {
-      qWarning() << Q_FUNC_INFO << "Position" << position << "outside range (0, " << this->childItems.size() << ")";
+      qCWarning(Logging::tree) <<
+         Q_FUNC_INFO << "Position" << position << "outside range (0, " << this->childItems.size() << ")";
       return false;
    }
 
@@ -431,8 +462,38 @@ QVariant TreeNode::dataRecipe(int column) {
             return QVariant(recipe->style()->name());
          }
          break;
+      case TreeItemNode<Recipe>::ColumnIndex::Og:
+         if (recipe) {
+            return Measurement::displayAmount(Measurement::Amount{recipe->og(), Measurement::Units::specificGravity}, 3);
+         }
+         break;
+      case TreeItemNode<Recipe>::ColumnIndex::Fg:
+         if (recipe) {
+            return Measurement::displayAmount(Measurement::Amount{recipe->fg(), Measurement::Units::specificGravity}, 3);
+         }
+         break;
+      case TreeItemNode<Recipe>::ColumnIndex::Ibu:
+         if (recipe) {
+            return Measurement::displayQuantity(recipe->IBU(), 1);
+         }
+         break;
+      case TreeItemNode<Recipe>::ColumnIndex::Abv:
+         if (recipe) {
+            return QString("%1%").arg(Measurement::displayQuantity(recipe->ABV_pct(), 1));
+         }
+         break;
+      case TreeItemNode<Recipe>::ColumnIndex::Color:
+         if (recipe) {
+            return Measurement::displayAmount(Measurement::Amount{recipe->color_srm(), Measurement::Units::srm}, 0);
+         }
+         break;
+      case TreeItemNode<Recipe>::ColumnIndex::BatchSize:
+         if (recipe) {
+            return Measurement::displayAmount(Measurement::Amount{recipe->batchSize_l(), Measurement::Units::liters}, 1);
+         }
+         break;
       default :
-         qWarning() << QString("TreeNode::dataRecipe Bad column: %1").arg(column);
+         qCWarning(Logging::tree) << QString("TreeNode::dataRecipe Bad column: %1").arg(column);
    }
    return QVariant();
 }
@@ -452,7 +513,7 @@ QVariant TreeNode::dataEquipment(int column) {
          }
          break;
       default :
-         qWarning() << QString("TreeNode::dataEquipment Bad column: %1").arg(column);
+         qCWarning(Logging::tree) << QString("TreeNode::dataEquipment Bad column: %1").arg(column);
    }
    return QVariant();
 }
@@ -479,7 +540,7 @@ QVariant TreeNode::dataFermentable(int column) {
          }
          break;
       default :
-         qWarning() << Q_FUNC_INFO << "Bad column:" << column;
+         qCWarning(Logging::tree) << Q_FUNC_INFO << "Bad column:" << column;
          break;
    }
    return QVariant();
@@ -510,7 +571,7 @@ QVariant TreeNode::dataHop(int column) {
          }
          break;
       default :
-         qWarning() << Q_FUNC_INFO << "Bad column:" << column;
+         qCWarning(Logging::tree) << Q_FUNC_INFO << "Bad column:" << column;
    }
    return QVariant();
 }
@@ -536,7 +597,7 @@ QVariant TreeNode::dataMisc(int column) {
 ///         }
 ///         break;
       default :
-         qWarning() << QString("TreeNode::dataMisc Bad column: %1").arg(column);
+         qCWarning(Logging::tree) << QString("TreeNode::dataMisc Bad column: %1").arg(column);
    }
    return QVariant();
 }
@@ -571,7 +632,7 @@ QVariant TreeNode::dataYeast(int column) {
          }
          break;
       default :
-         qWarning() << QString("TreeNode::dataYeast Bad column: %1").arg(column);
+         qCWarning(Logging::tree) << QString("TreeNode::dataYeast Bad column: %1").arg(column);
    }
    return QVariant();
 }
@@ -605,7 +666,7 @@ QVariant TreeNode::dataStyle(int column) {
          case TreeItemNode<Style>::ColumnIndex::StyleGuide:
             return QVariant(style->styleGuide());
          default :
-            qWarning() << QString("TreeNode::dataStyle Bad column: %1").arg(column);
+            qCWarning(Logging::tree) << QString("TreeNode::dataStyle Bad column: %1").arg(column);
       }
    }
    return QVariant();
@@ -654,7 +715,7 @@ QVariant TreeNode::dataWater(int column) {
          case TreeItemNode<Water>::ColumnIndex::pH:
             return water->ph() ? QVariant(*water->ph()) : QVariant();
          default :
-            qWarning() << QString("TreeNode::dataWater Bad column: %1").arg(column);
+            qCWarning(Logging::tree) << QString("TreeNode::dataWater Bad column: %1").arg(column);
       }
    }
 
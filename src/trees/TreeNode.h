@@ -25,6 +25,7 @@
 #include <QVariant>
 
 #include "Localization.h"
+#include "Logging.h"
 #include "model/Equipment.h"
 #include "model/Fermentable.h"
 #include "model/Folder.h"
@@ -111,12 +112,11 @@ public:
       return QVariant(Derived::columnDisplayNames[section]);
    }
 
-   static bool lessThan(TreeModel const & model,
-                        QModelIndex const & left,
-                        QModelIndex const & right,
-                        NE const & lhs,
-                        NE const & rhs) {
-      return Derived::isLessThan(model, left, right, static_cast<ColumnIndex>(left.column()), lhs, rhs);
+   /**
+    * \brief The value on which to sort \c item for the supplied column.  See \c TreeModel::SortRole.
+    */
+   static QVariant sortKeyFor(NE const & item, int column) {
+      return Derived::sortKey(item, static_cast<ColumnIndex>(column));
    }
 
    //! \brief flag this node to override display() or not
@@ -164,7 +164,8 @@ public:
    bool insertChildren(std::size_t position, int count) requires IsSubstantiveVariant<ChildPtrTypes> {
       if (position > this->m_children.size()) {
          // This is probably a coding error, but we can probably recover by just not doing the insert
-         qWarning() << Q_FUNC_INFO << "Position" << position << "outside range (0, " << this->m_children.size() << ")";
+         qCWarning(Logging::tree) <<
+            Q_FUNC_INFO << "Position" << position << "outside range (0, " << this->m_children.size() << ")";
          return false;
       }
 
@@ -176,7 +177,7 @@ public:
    }
 
    bool insertChildren(std::size_t position, int count) requires IsNullVariant<ChildPtrTypes> {
-      qWarning() << Q_FUNC_INFO << "Should not be called!";
+      qCWarning(Logging::tree) << Q_FUNC_INFO << "Should not be called!";
       return false;
    }
 
@@ -188,7 +189,8 @@ public:
    bool removeChildren(int position, int count) requires IsSubstantiveVariant<ChildPtrTypes> {
       if (position < 0  || position > this->m_children.size()) {
          // This is probably a coding error, but we can probably recover by just not doing the remove
-         qWarning() << Q_FUNC_INFO << "Position" << position << "outside range (0, " << this->m_children.size() << ")";
+         qCWarning(Logging::tree) <<
+            Q_FUNC_INFO << "Position" << position << "outside range (0, " << this->m_children.size() << ")";
          return false;
       }
 
@@ -199,7 +201,7 @@ public:
    }
 
    bool removeChildren(int position, int count) requires IsNullVariant<ChildPtrTypes> {
-      qWarning() << Q_FUNC_INFO << "Should not be called!";
+      qCWarning(Logging::tree) << Q_FUNC_INFO << "Should not be called!";
       return false;
    }
 
@@ -292,12 +294,7 @@ public:
    TreeItemNode();
    virtual ~TreeItemNode();
    static EnumStringMapping const columnDisplayNames;
-   static bool isLessThan(TreeModel const & model,
-                          QModelIndex const & left,
-                          QModelIndex const & right,
-                          TreeItemTraits<TreeItemNode<NE>>::ColumnIndex section,
-                          NE const & lhs,
-                          NE const & rhs);
+   static QVariant sortKey(NE const & item, TreeItemTraits<TreeItemNode<NE>>::ColumnIndex section);
 };
 
 class BrewNote;
@@ -317,8 +314,15 @@ template<> struct TreeItemTraits<TreeItemNode<Recipe>> {
       NumberOfAncestors,
       BrewDate         ,
       Style            ,
+      // Calculated values.  These are hidden unless the user asks for them -- see RecipeTreeView
+      Og               ,
+      Fg               ,
+      Ibu              ,
+      Abv              ,
+      Color            ,
+      BatchSize        ,
    };
-   enum class Info { NumberOfColumns = 4 };
+   enum class Info { NumberOfColumns = 10 };
    using ParentType = TreeFolderNode<Recipe>;
    using ChildPtrTypes = std::variant<std::shared_ptr<TreeItemNode<BrewNote>>, std::shared_ptr<TreeItemNode<Recipe>>>;
 };
@@ -476,6 +480,8 @@ public:
    int columnCount(TreeNode::Type nodeType) const;
    //! \brief returns the data of the item of \c type at \c column
    QVariant data(/*TreeNode::Type nodeType, */int column);
+   //! \brief returns the sort key (see \c TreeModel::SortRole) of the item at \c column
+   QVariant sortKey(int column);
    //! \brief returns the index of the item in it's parents list
    int childNumber() const;
 
@@ -36,6 +36,7 @@
 #include "editors/EquipmentEditor.h"
 #include "editors/StyleEditor.h"
 #include "editors/WaterEditor.h"
+#include "Logging.h"
 #include "model/BrewNote.h"
 #include "model/Equipment.h"
 #include "model/Fermentable.h"
@@ -51,7 +52,7 @@
 TreeView::TreeView(QWidget * parent, TreeModel::TypeMasks type) :
    QTreeView{parent},
    m_type{type} {
-   qDebug() << Q_FUNC_INFO << "type=" << type;
+   qCDebug(Logging::tree) << Q_FUNC_INFO << "type=" << type;
    // Set some global properties that all the kids will use.
    setAllColumnsShowFocus(true);
    setContextMenuPolicy(Qt::CustomContextMenu);
@@ -76,6 +77,16 @@ TreeView::TreeView(QWidget * parent, TreeModel::TypeMasks type) :
 
    // and one wee connection
    connect(m_model, &TreeModel::expandFolder, this, &TreeView::expandFolder);
+   // and another, so that the model knows what's on show
+   connect(this, &QTreeView::expanded, this, [this](QModelIndex const & index) {
+      this->m_model->observeChildren(this->m_filter->mapToSource(index));
+      return;
+   });
+   // and one more, so that a recipe's brewnotes don't hang around once they're not on show
+   connect(this, &QTreeView::collapsed, this, [this](QModelIndex const & index) {
+      this->m_model->unloadChildren(this->m_filter->mapToSource(index));
+      return;
+   });
    return;
 }
 
@@ -136,6 +147,8 @@ QString TreeView::folderName(QModelIndex index) {
 }
 
 QModelIndex TreeView::findElement(NamedEntity * thing) {
+   // We might be asked for a brewnote under a recipe that has not yet been expanded
+   this->m_model->fetchNodesFor(thing);
    return m_filter->mapFromSource(m_model->findElement(thing));
 }
 
@@ -252,7 +265,7 @@ QMimeData * TreeView::mimeData(QModelIndexList indexes) {
       auto nodeType = this->type(index);
       if (nodeType != TreeNode::Type::Folder) {
          if (m_model->thing(m_filter->mapToSource(index)) == nullptr) {
-            qWarning() << Q_FUNC_INFO << QString("Couldn't map that thing");
+            qCWarning(Logging::tree) << Q_FUNC_INFO << QString("Couldn't map that thing");
             id = -1;
          } else {
             id   = m_model->thing(m_filter->mapToSource(index))->key();
@@ -327,7 +340,7 @@ void TreeView::newNamedEntity() {
    if (m_type.testFlag(TreeModel::TypeMask::Yeast      )) { qobject_cast<YeastEditor       *>(m_editor)->newEditItem(folder); return; }
    if (m_type.testFlag(TreeModel::TypeMask::Water      )) { qobject_cast<WaterEditor       *>(m_editor)->newWater   (folder); return; }
 
-   qWarning() << Q_FUNC_INFO << "Unrecognized mask" << m_type;
+   qCWarning(Logging::tree) << Q_FUNC_INFO << "Unrecognized mask" << m_type;
    return;
 }
 
@@ -444,6 +457,9 @@ void TreeView::setupContextMenu(QWidget * top, QWidget * editor) {
 
       m_contextMenu->addSeparator();
       m_brewItAction = m_contextMenu->addAction(tr("Brew It!"), top, SLOT(brewItHelper()));
+      m_findSimilarAction = m_contextMenu->addAction(tr("Find Similar Recipes"), top, SLOT(findSimilarRecipes()));
+      m_contextMenu->addAction(tr("Compare Selected Recipes"), top, SLOT(compareRecipes()));
+      m_contextMenu->addAction(tr("Recalculate Brew Notes"), top, SLOT(recalculateBrewNotes()));
       m_contextMenu->addSeparator();
 
       subMenu->addAction(tr("Brew Again"), top, SLOT(brewAgainHelper()));
@@ -460,7 +476,7 @@ void TreeView::setupContextMenu(QWidget * top, QWidget * editor) {
    else if (m_type.testFlag(TreeModel::TypeMask::Yeast      )) { newMenu->addAction(tr("Yeast"      ), this, SLOT(newNamedEntity())); }
    else if (m_type.testFlag(TreeModel::TypeMask::Water      )) { newMenu->addAction(tr("Water"      ), this, SLOT(newNamedEntity())); }
    else {
-      qWarning() << Q_FUNC_INFO << "Unrecognized mask" << m_type;
+      qCWarning(Logging::tree) << Q_FUNC_INFO << "Unrecognized mask" << m_type;
    }
 
    m_contextMenu->addSeparator();
@@ -473,6 +489,10 @@ void TreeView::setupContextMenu(QWidget * top, QWidget * editor) {
    m_contextMenu->addSeparator();
    m_exportMenu->setTitle(tr("Export"));
    m_exportMenu->addAction(tr("To File (BeerXML or BeerJSON)"), top, SLOT(exportSelected()));
+   if (m_type.testFlag(TreeModel::TypeMask::Recipe)) {
+      m_exportMenu->addAction(tr("To Recipe Book (PDF)"), top, SLOT(exportSelectedRecipeBook()));
+      m_exportMenu->addAction(tr("Shopping List (HTML or JSON)"), top, SLOT(exportShoppingList()));
+   }
 //   m_exportMenu->addAction(tr("To HTML"), top, SLOT(exportSelectedHtml()));
    m_contextMenu->addMenu(m_exportMenu);
    m_contextMenu->addAction(tr("Import"), top, SLOT(importFiles()));
@@ -516,6 +536,7 @@ QMenu * TreeView::contextMenu(QModelIndex selected) {
          m_exportMenu->setEnabled(true);
          m_copyAction->setEnabled(true);
          m_brewItAction->setEnabled(true);
+         m_findSimilarAction->setEnabled(true);
       } else {
          // This case will happen if user Right-click the top most item in the list, as that will yield a rec == nullptr.
          // In this case we will treat it like a folder and disable a bunch of options.
@@ -531,6 +552,7 @@ QMenu * TreeView::contextMenu(QModelIndex selected) {
          m_exportMenu->setEnabled( false );
          m_copyAction->setEnabled( false );
          m_brewItAction->setEnabled( false );
+         m_findSimilarAction->setEnabled( false );
       }
    }
 
@@ -584,7 +606,7 @@ void TreeView::copySelected(QModelIndexList selected) {
       // Otherwise prompt
       auto nodeType = this->m_model->type(trans);
       if (!nodeType) {
-         qWarning() << Q_FUNC_INFO << "Unknown type";
+         qCWarning(Logging::tree) << Q_FUNC_INFO << "Unknown type";
       } else {
          switch (*nodeType) {
             case TreeNode::Type::Equipment:
@@ -615,7 +637,7 @@ void TreeView::copySelected(QModelIndexList selected) {
             case TreeNode::Type::Folder:
                // These cases shouldn't arise (I think!) but the compiler will emit a warning if we don't explicitly
                // have code to handle them (which is good!).
-               qWarning() << Q_FUNC_INFO << "Unexpected item type" << static_cast<int>(*nodeType);
+               qCWarning(Logging::tree) << Q_FUNC_INFO << "Unexpected item type" << static_cast<int>(*nodeType);
                break;
          }
       }
@@ -673,7 +695,7 @@ void TreeView::deleteSelected(QModelIndexList selected) {
       // Otherwise prompt
       auto nodeType = this->m_model->type(trans);
       if (!nodeType) {
-         qWarning() << Q_FUNC_INFO << "Unknown type";
+         qCWarning(Logging::tree) << Q_FUNC_INFO << "Unknown type";
       } else {
          switch (*nodeType) {
             case TreeNode::Type::Recipe:
@@ -747,6 +769,32 @@ void TreeView::versionedRecipe(Recipe * descendant) {
 
 RecipeTreeView::RecipeTreeView(QWidget * parent) : TreeView(parent, TreeModel::TypeMask::Recipe) {
    connect(m_model, &TreeModel::recipeSpawn, this, &TreeView::versionedRecipe);
+
+   //
+   // The calculated value columns start off hidden.  The user can show or hide any column except the name from the
+   // header's context menu.  MainWindow saves and restores the header state, so their choice is remembered.
+   //
+   QHeaderView * columnHeader = this->header();
+   int const numColumns = static_cast<int>(TreeItemNode<Recipe>::Info::NumberOfColumns);
+   for (int column = static_cast<int>(TreeItemNode<Recipe>::ColumnIndex::Og); column < numColumns; ++column) {
+      columnHeader->hideSection(column);
+   }
+   columnHeader->setContextMenuPolicy(Qt::CustomContextMenu);
+   connect(columnHeader, &QWidget::customContextMenuRequested, this, [columnHeader, numColumns](QPoint const & point) {
+      QMenu menu;
+      for (int column = static_cast<int>(TreeItemNode<Recipe>::ColumnIndex::Name) + 1; column < numColumns; ++column) {
+         QAction * action = menu.addAction(TreeItemNode<Recipe>::header(column).toString());
+         action->setCheckable(true);
+         action->setChecked(!columnHeader->isSectionHidden(column));
+         connect(action, &QAction::toggled, columnHeader, [columnHeader, column](bool const checked) {
+            columnHeader->setSectionHidden(column, !checked);
+            return;
+         });
+      }
+      menu.exec(columnHeader->mapToGlobal(point));
+      return;
+   });
+   return;
 }
 
 EquipmentTreeView::EquipmentTreeView(QWidget * parent)
@@ -166,7 +166,8 @@ private:
            * m_orphanAction,
            * m_spawnAction,
            * m_copyAction,
-           * m_brewItAction;
+           * m_brewItAction,
+           * m_findSimilarAction;
    QPoint dragStart;
    QWidget * m_editor;
 
@@ -20,6 +20,11 @@
 
 #include "Logging.h"
 
+namespace {
+   //! Returned by \c SimpleUndoableUpdate::id.  Any value other than -1 (which means "never merge") would do.
+   int constexpr simpleUndoableUpdateId = 1;
+}
+
 SimpleUndoableUpdate::SimpleUndoableUpdate(NamedEntity & updatee,
                                            TypeInfo const & typeInfo,
                                            QVariant newValue,
@@ -74,6 +79,25 @@ void SimpleUndoableUpdate::undo() {
    return;
 }
 
+int SimpleUndoableUpdate::id() const {
+   return simpleUndoableUpdateId;
+}
+
+bool SimpleUndoableUpdate::mergeWith(QUndoCommand const * other) {
+   // QUndoStack only calls us for commands with the same ID, ie other SimpleUndoableUpdate objects
+   auto const & otherUpdate = static_cast<SimpleUndoableUpdate const &>(*other);
+   if (&otherUpdate.m_updatee != &this->m_updatee ||
+       otherUpdate.m_propertyPath.properties() != this->m_propertyPath.properties() ||
+       this->childCount() > 0 ||
+       otherUpdate.childCount() > 0) {
+      return false;
+   }
+
+   this->m_newValue = otherUpdate.m_newValue;
+   this->setObsolete(this->m_newValue == this->m_oldValue);
+   return true;
+}
+
 bool SimpleUndoableUpdate::undoOrRedo(bool const isUndo) {
    // This is where we call the setter for propertyName on updatee, via the magic of the Qt Property System
    bool success = this->m_propertyPath.setValue(this->m_updatee, isUndo ? this->m_oldValue : this->m_newValue);
@@ -161,6 +161,22 @@ public:
     */
    void undo();
 
+   /*!
+    * \brief All \c SimpleUndoableUpdate objects share the same ID, so that \c QUndoStack will offer to merge
+    *        consecutive ones via \c mergeWith
+    */
+   int id() const override;
+
+   /*!
+    * \brief Successive edits of the same property of the same object (eg typing a recipe name one character at a
+    *        time) are merged into a single update that goes from the first old value to the last new value.  If that
+    *        takes the property back to where it started, the merged update is marked obsolete and \c QUndoStack drops
+    *        it.
+    *
+    * \return \c true if \c other was merged into this update
+    */
+   bool mergeWith(QUndoCommand const * other) override;
+
 private:
    /*!
     * \brief Undo or redo applying the update
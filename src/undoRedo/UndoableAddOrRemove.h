@@ -41,6 +41,10 @@ class MainWindow;
  *        (because Mash inherits from StepOwnerBase<Mash, MashStep>).  Fortunately, callers don't have to worry about
  *        this as the compiler works everything out for us.
  *
+ *        A removed object is kept alive only by our copy of its shared pointer (see \c whatToAddOrRemove below), so it
+ *        is released when the \c QUndoStack deletes us, eg because we dropped off the bottom once the stack reached its
+ *        undo limit.
+ *
  *        TBD: As of C++20 I think we can replace the slightly cumbersome \c std::enable_if_t syntax with concepts, but
  *             I haven't yet got my head around the exact syntax to do so!
  */
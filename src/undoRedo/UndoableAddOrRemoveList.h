@@ -23,12 +23,20 @@
 #include <QUndoCommand>
 #include <QVariant>
 
+#include "database/Database.h"
+#include "database/DbTransaction.h"
+#include "model/NamedEntity.h"
+#include "model/Recipe.h"
 #include "undoRedo/UndoableAddOrRemove.h"
 
 /*!
  * \class UndoableAddOrRemoveList
  *
- * \brief A version of \c that handles adding/removing lists of things to/from a recipe etc.
+ * \brief A version of \c UndoableAddOrRemove that handles adding/removing lists of things to/from a recipe etc.
+ *
+ *        The whole list is done (or undone) as one batch: one database transaction, one set of "changed" signals (so,
+ *        eg, a table model showing the recipe's additions gets one update for all of them) and, when the updatee is a
+ *        \c Recipe, one recalculation at the end rather than one per item.
  */
 template<class BB, class UU, class VV, std::enable_if_t<std::is_base_of_v<BB, UU>, bool> = true>
 class UndoableAddOrRemoveList : public QUndoCommand {
@@ -57,7 +65,9 @@ public:
                            void (MainWindow::*doCallback)(std::shared_ptr<VV>),
                            void (MainWindow::*undoCallback)(std::shared_ptr<VV>),
                            QString const & description,
-                           QUndoCommand * parent = nullptr) : QUndoCommand(parent) {
+                           QUndoCommand * parent = nullptr) :
+      QUndoCommand(parent),
+      updatee(updatee) {
       // Parent class handles storing description and making it accessible to the undo stack etc - we just have to give
       // it the text.
       this->setText(description);
@@ -94,7 +104,9 @@ public:
                            void (MainWindow::*doCallback)(std::shared_ptr<VV>),
                            void (MainWindow::*undoCallback)(std::shared_ptr<VV>),
                            QString const & description,
-                           QUndoCommand * parent = nullptr) : QUndoCommand(parent) {
+                           QUndoCommand * parent = nullptr) :
+      QUndoCommand(parent),
+      updatee(updatee) {
       this->setText(description);
       for (auto ii : listToAddOrRemove) {
          new UndoableAddOrRemove<BB, UU, VV>(updatee,
@@ -112,7 +124,51 @@ public:
 
    ~UndoableAddOrRemoveList() = default;
 
+   /*!
+    * \brief Apply all the additions/removals
+    */
+   void redo() {
+      this->inOneBatch([this]() { this->QUndoCommand::redo(); });
+      return;
+   }
+
+   /*!
+    * \brief Undo all the additions/removals
+    */
+   void undo() {
+      this->inOneBatch([this]() { this->QUndoCommand::undo(); });
+      return;
+   }
+
 private:
+   /*!
+    * \brief Run \c action, which invokes our child commands (see constructors), as a single batch
+    */
+   template<class Functor>
+   void inOneBatch(Functor && action) {
+      NamedEntityChangeBatch changeBatch;
+
+      Database & database = Database::instance();
+      QSqlDatabase connection = database.sqlDatabase();
+      DbTransaction dbTransaction{database, connection, this->text()};
+
+      if constexpr (std::is_base_of_v<Recipe, UU>) {
+         bool const calcsWereEnabled = this->updatee.calcsEnabled();
+         this->updatee.setCalcsEnabled(false);
+         action();
+         this->updatee.setCalcsEnabled(calcsWereEnabled);
+         if (calcsWereEnabled) {
+            this->updatee.recalcAll();
+         }
+      } else {
+         action();
+      }
+
+      dbTransaction.commit();
+      return;
+   }
+
+   UU & updatee;
 };
 
 
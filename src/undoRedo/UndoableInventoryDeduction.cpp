@@ -0,0 +1,139 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * undoRedo/UndoableInventoryDeduction.cpp is part of Brewtarget, and is copyright the following authors 2024:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#include "undoRedo/UndoableInventoryDeduction.h"
+
+#include <algorithm>
+
+#include <QDebug>
+#include <QHash>
+
+#include "database/Database.h"
+#include "database/DbTransaction.h"
+#include "database/ObjectStoreWrapper.h"
+#include "measurement/Unit.h"
+#include "model/InventoryFermentable.h"
+#include "model/InventoryHop.h"
+#include "model/InventoryMisc.h"
+#include "model/InventorySalt.h"
+#include "model/InventoryYeast.h"
+#include "model/Recipe.h"
+#include "model/RecipeAdditionFermentable.h"
+#include "model/RecipeAdditionHop.h"
+#include "model/RecipeAdditionMisc.h"
+#include "model/RecipeAdditionYeast.h"
+#include "model/RecipeAdjustmentSalt.h"
+
+namespace {
+   /**
+    * \brief Work out the new inventory amounts for ingredients of type \c Ingr used in \c recipes and append them to
+    *        \c changes
+    */
+   template<class RA, class Ingr>
+   void appendChanges(QList<Recipe *> const & recipes,
+                      QList<std::shared_ptr<RA>> (Recipe::*additionsOf)() const,
+                      QVector<UndoableInventoryDeduction::Change> & changes) {
+      using Inv = typename Ingr::InventoryClass;
+      // Inventory ID -> index in changes
+      QHash<int, int> changeIndexes;
+      for (Recipe const * recipe : recipes) {
+         for (std::shared_ptr<RA> const & addition : (recipe->*additionsOf)()) {
+            std::shared_ptr<Ingr> const ingredient = addition->ingredient();
+            if (!ingredient) {
+               continue;
+            }
+            auto inventory = InventoryTools::firstInventory<Inv, Ingr>(*ingredient);
+            if (!inventory) {
+               continue;
+            }
+            auto changeIndex = changeIndexes.constFind(inventory->key());
+            if (changeIndex == changeIndexes.cend()) {
+               Measurement::Amount const amount = inventory->amount();
+               changeIndex = changeIndexes.insert(inventory->key(), changes.size());
+               changes.append(UndoableInventoryDeduction::Change{inventory, amount, amount});
+            }
+
+            //
+            // The addition and the inventory may be in different units (eg grams and kilograms), so we subtract in the
+            // inventory's units.  If they don't measure the same thing (eg one is by weight and the other by volume),
+            // we can't subtract at all.
+            //
+            Measurement::Amount & after = changes[*changeIndex].after;
+            Measurement::Amount const used = addition->amount();
+            if (used.unit->getPhysicalQuantity() != after.unit->getPhysicalQuantity()) {
+               qWarning() <<
+                  Q_FUNC_INFO << "Can't take" << used << "of" << ingredient->name() << "from inventory of" << after;
+               continue;
+            }
+            double const used_canonical = used.unit->toCanonical(used.quantity).quantity;
+            double const after_canonical = after.unit->toCanonical(after.quantity).quantity;
+            after.quantity = after.unit->fromCanonical(std::max(0.0, after_canonical - used_canonical));
+         }
+      }
+      return;
+   }
+}
+
+UndoableInventoryDeduction::UndoableInventoryDeduction(QList<Recipe *> const & recipes,
+                                                       QString const & description,
+                                                       QUndoCommand * parent) :
+   QUndoCommand{parent},
+   m_changes{} {
+   this->setText(description);
+   appendChanges<RecipeAdditionFermentable, Fermentable>(recipes, &Recipe::fermentableAdditions, this->m_changes);
+   appendChanges<RecipeAdditionHop        , Hop        >(recipes, &Recipe::hopAdditions        , this->m_changes);
+   appendChanges<RecipeAdditionMisc       , Misc       >(recipes, &Recipe::miscAdditions       , this->m_changes);
+   appendChanges<RecipeAdditionYeast      , Yeast      >(recipes, &Recipe::yeastAdditions      , this->m_changes);
+   appendChanges<RecipeAdjustmentSalt     , Salt       >(recipes, &Recipe::saltAdjustments     , this->m_changes);
+   // There's no point writing amounts that haven't changed (eg for ingredients that were already out of stock)
+   this->m_changes.erase(
+      std::remove_if(this->m_changes.begin(),
+                     this->m_changes.end(),
+                     [](Change const & change) { return change.after == change.before; }),
+      this->m_changes.end()
+   );
+   return;
+}
+
+UndoableInventoryDeduction::~UndoableInventoryDeduction() = default;
+
+bool UndoableInventoryDeduction::isEmpty() const {
+   return this->m_changes.isEmpty();
+}
+
+void UndoableInventoryDeduction::redo() {
+   this->apply(true);
+   return;
+}
+
+void UndoableInventoryDeduction::undo() {
+   this->apply(false);
+   return;
+}
+
+void UndoableInventoryDeduction::apply(bool const deduct) {
+   NamedEntityChangeBatch changeBatch;
+
+   Database & database = Database::instance();
+   QSqlDatabase connection = database.sqlDatabase();
+   DbTransaction dbTransaction{database, connection, this->text()};
+   for (Change const & change : this->m_changes) {
+      change.inventory->setAmount(deduct ? change.after : change.before);
+   }
+   dbTransaction.commit();
+   qDebug() <<
+      Q_FUNC_INFO << (deduct ? "Deducted" : "Restored") << this->m_changes.size() << "inventory amounts";
+   return;
+}
@@ -0,0 +1,75 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * undoRedo/UndoableInventoryDeduction.h is part of Brewtarget, and is copyright the following authors 2024:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#ifndef UNDOREDO_UNDOABLEINVENTORYDEDUCTION_H
+#define UNDOREDO_UNDOABLEINVENTORYDEDUCTION_H
+#pragma once
+
+#include <memory>
+
+#include <QList>
+#include <QString>
+#include <QUndoCommand>
+#include <QVector>
+
+#include "measurement/Amount.h"
+
+class Inventory;
+class Recipe;
+
+/*!
+ * \class UndoableInventoryDeduction
+ *
+ * \brief Undoable removal from inventory of the ingredients used to brew one or more recipes.
+ *
+ *        All the new inventory amounts are worked out up front, in memory, when the command is constructed: amounts
+ *        for the same ingredient are added together (across additions and recipes) and then taken off that
+ *        ingredient's existing inventory, never going below zero.  Ingredients with no inventory are left alone, so,
+ *        unlike editing an ingredient's total inventory, this never creates \c Inventory objects.
+ *
+ *        As with \c UndoableAddOrRemoveList, doing or undoing the whole deduction is one batch: one database
+ *        transaction and one set of "changed" signals.
+ */
+class UndoableInventoryDeduction : public QUndoCommand {
+public:
+   /*!
+    * \param recipes What is being brewed
+    * \param description Short text we can show on undo/redo menu to describe this update eg "Brew It!"
+    * \param parent This is for grouping updates together.
+    */
+   UndoableInventoryDeduction(QList<Recipe *> const & recipes,
+                              QString const & description,
+                              QUndoCommand * parent = nullptr);
+   ~UndoableInventoryDeduction();
+
+   //! \return \c true if brewing the recipes wouldn't change any inventory
+   bool isEmpty() const;
+
+   void redo();
+   void undo();
+
+   struct Change {
+      std::shared_ptr<Inventory> inventory;
+      Measurement::Amount        before;
+      Measurement::Amount        after;
+   };
+
+private:
+   void apply(bool const deduct);
+
+   QVector<Change> m_changes;
+};
+
+#endif
@@ -0,0 +1,63 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * unitTests/AllocationGuard.cpp is part of Brewtarget, and is copyright the following authors 2024:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#include "unitTests/AllocationGuard.h"
+
+#include <cstdlib>
+#include <new>
+
+//
+// We replace the global allocation functions to count calls.  (The standard says the default versions of all the
+// other non-aligned forms of new and delete end up calling these.)  The counter is a plain thread-local integer, so it
+// is safe to use before main() and costs next to nothing.
+//
+namespace {
+   thread_local std::size_t allocationCount = 0;
+}
+
+void * operator new(std::size_t size) {
+   ++allocationCount;
+   // Per the standard, operator new must return a unique non-null pointer even for a zero-size request
+   void * ptr = std::malloc(size ? size : 1);
+   if (!ptr) {
+      throw std::bad_alloc{};
+   }
+   return ptr;
+}
+void * operator new[](std::size_t size) {
+   return ::operator new(size);
+}
+void operator delete(void * ptr) noexcept {
+   std::free(ptr);
+   return;
+}
+void operator delete[](void * ptr) noexcept {
+   ::operator delete(ptr);
+   return;
+}
+
+AllocationGuard::AllocationGuard() : m_start{allocationCount} {
+   return;
+}
+
+AllocationGuard::~AllocationGuard() = default;
+
+std::size_t AllocationGuard::allocations() const {
+   return allocationCount - this->m_start;
+}
+
+std::size_t AllocationGuard::totalAllocations() {
+   return allocationCount;
+}
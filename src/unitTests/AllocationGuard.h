@@ -0,0 +1,50 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * unitTests/AllocationGuard.h is part of Brewtarget, and is copyright the following authors 2024:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#ifndef UNITTESTS_ALLOCATIONGUARD_H
+#define UNITTESTS_ALLOCATIONGUARD_H
+#pragma once
+
+#include <cstddef>
+
+/**
+ * \brief Counts the heap allocations made on the current thread while it is in scope, so that tests can check that a
+ *        hot path does not allocate (or allocates no more than some fixed number of times), eg:
+ *
+ *           AllocationGuard guard;
+ *           Localization::splitAmount(input);
+ *           QCOMPARE(guard.allocations(), 0);
+ *
+ *        The counting is done by replacements for the global allocation functions in AllocationGuard.cpp, so it only
+ *        works in executables that link in that file (ie the unit test runner and benchmarks, not the application
+ *        itself).  Only the current thread's allocations are counted, so work that Qt or the logging does on other
+ *        threads doesn't get in the way.  Guards can be nested.
+ */
+class AllocationGuard {
+public:
+   AllocationGuard();
+   ~AllocationGuard();
+
+   //! \return Number of allocations made on this thread since the guard was constructed
+   std::size_t allocations() const;
+
+   //! \return Number of allocations made on this thread since it started
+   static std::size_t totalAllocations();
+
+private:
+   std::size_t const m_start;
+};
+
+#endif
@@ -0,0 +1,233 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * unitTests/Benchmark.cpp is part of Brewtarget, and is copyright the following authors 2024:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+
+//
+// This is a stand-alone benchmark for the recipe calculation chain, ie the RecipeEvaluator functions that Recipe uses
+// to work out its derived values.  It builds synthetic recipe snapshots of controlled size, and then, for each IBU
+// formula, reports how long each stage of the calculation takes and how many heap allocations it makes.
+//
+// Working on snapshots means we don't need a database, and what we measure is just the calculations themselves.  (The
+// length of the mash schedule only gets into the calculations via the total mash water, so it makes no difference to
+// the timings here.)
+//
+// Usage: brewtarget_benchmark [--fermentables N] [--hops M] [--iterations R]
+//
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+
+#include <boost/json/src.hpp> // Needs to be included exactly once in the code to use header-only version of Boost.JSON
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QString>
+#include <QTextStream>
+#include <QVector>
+
+#include "measurement/IbuMethods.h"
+#include "RecipeEvaluator.h"
+#include "unitTests/AllocationGuard.h"
+
+namespace {
+
+   /**
+    * \brief Make a plausible looking recipe snapshot with the requested number of fermentable and hop additions.
+    *
+    *        We cycle through the different types of fermentable and stage of hop addition so that all the branches in
+    *        the calculations get exercised.
+    */
+   RecipeEvaluator::Snapshot makeSnapshot(int const numFermentables, int const numHops) {
+      RecipeEvaluator::Snapshot snapshot{
+         .batchSize_l          = 23.0,
+         .efficiency_pct       = 72.0,
+         .equipment            = RecipeEvaluator::EquipmentInputs{
+            .mashTunGrainAbsorption_LKg = 1.086,
+            .lauteringDeadspaceLoss_l   = 1.0,
+            .topUpKettle_l              = 0.0,
+            .topUpWater_l               = 0.0,
+            .kettleTrubChillerLoss_l    = 1.5,
+            .boilTime_min               = 60.0,
+            .kettleEvaporationPerHour_l = 4.0,
+            .hopUtilization_pct         = 100.0,
+            .kettleInternalDiameter_cm  = 35.0,
+            .kettleOpeningDiameter_cm   = 35.0,
+         },
+         .boil                 = RecipeEvaluator::BoilInputs{
+            .preBoilSize_l = 28.0,
+            .boilTime_mins = 60.0,
+            .coolTime_mins = 10.0,
+         },
+         .mashTotalWater_l     = 30.0,
+         .grainBill            = {},
+         .grainBillTotals      = {},
+         .hopAdditions         = {},
+         .yeastAdditions       = {},
+      };
+
+      Fermentable::Type const fermentableTypes[] {
+         Fermentable::Type::Grain,
+         Fermentable::Type::Grain,
+         Fermentable::Type::Grain,
+         Fermentable::Type::Sugar,
+         Fermentable::Type::Extract,
+         Fermentable::Type::Dry_Extract,
+      };
+      int const numFermentableTypes = sizeof(fermentableTypes) / sizeof(fermentableTypes[0]);
+      snapshot.grainBill.reserve(numFermentables);
+      for (int ii = 0; ii < numFermentables; ++ii) {
+         Fermentable::Type const type = fermentableTypes[ii % numFermentableTypes];
+         bool const isGrain = (type == Fermentable::Type::Grain);
+         double const quantity_kg = 5.0 / numFermentables;
+         snapshot.grainBill.append(
+            RecipeEvaluator::FermentableAdditionInputs{
+               .type               = type,
+               .stage              = isGrain ? RecipeAddition::Stage::Mash : RecipeAddition::Stage::Boil,
+               .amountIsWeight     = true,
+               .quantity           = quantity_kg,
+               .addAfterBoil       = (ii % 7 == 6),
+               .equivSucrose_kg    = quantity_kg * (isGrain ? 0.78 : 0.95),
+               .isSugar            = (type == Fermentable::Type::Sugar),
+               .isExtract          = (type == Fermentable::Type::Extract || type == Fermentable::Type::Dry_Extract),
+               .isFermentableSugar = true,
+               .color_srm          = 2.0 + (ii % 10) * 5.0,
+               .ibuGalPerLb        = std::nullopt,
+            }
+         );
+      }
+      snapshot.grainBillTotals = RecipeEvaluator::grainBillTotals(snapshot.grainBill);
+
+      snapshot.hopAdditions.reserve(numHops);
+      for (int ii = 0; ii < numHops; ++ii) {
+         bool const isMashHop   = (ii % 11 == 10);
+         bool const isFirstWort = (ii %  9 ==  8);
+         snapshot.hopAdditions.append(
+            RecipeEvaluator::HopAdditionInputs{
+               .alpha_pct      = 4.0 + (ii % 8),
+               .quantity       = 0.060 / numHops,
+               .addAtTime_mins = 60.0 - (ii * 60.0 / numHops),
+               .isFirstWort    = isFirstWort,
+               .stage          = isMashHop ? RecipeAddition::Stage::Mash : RecipeAddition::Stage::Boil,
+               .form           = (ii % 2) ? Hop::Form::Pellet : Hop::Form::Leaf,
+            }
+         );
+      }
+
+      snapshot.yeastAdditions.append(
+         RecipeEvaluator::YeastAdditionInputs{
+            .additionAttenuation_pct     = std::nullopt,
+            .yeastAttenuationTypical_pct = 75.0,
+         }
+      );
+
+      return snapshot;
+   }
+
+   /**
+    * \brief Run \c stage the requested number of times and print the average time and number of allocations per run
+    */
+   template<typename Functor>
+   void timeStage(QTextStream & out, char const * const stageName, int const iterations, Functor const & stage) {
+      // Accumulate results here so the optimiser can't decide the calls are pointless
+      static volatile double sink = 0.0;
+
+      AllocationGuard const allocationGuard;
+      QElapsedTimer timer;
+      timer.start();
+      for (int ii = 0; ii < iterations; ++ii) {
+         sink = sink + stage();
+      }
+      qint64 const elapsed_ns = timer.nsecsElapsed();
+      std::size_t const allocations = allocationGuard.allocations();
+
+      out <<
+         QString("   %1 %2 ns/call %3 allocations/call\n").arg(stageName, -20)
+                                                          .arg(static_cast<double>(elapsed_ns) / iterations, 12, 'f', 1)
+                                                          .arg(static_cast<double>(allocations) / iterations, 8, 'f', 2);
+      return;
+   }
+
+   //! Suppress debug logging from the code under test, as otherwise we'd mostly be timing the logging
+   void messageHandler(QtMsgType type, QMessageLogContext const & context, QString const & message) {
+      if (type != QtDebugMsg && type != QtInfoMsg) {
+         std::fprintf(stderr, "%s\n", qPrintable(qFormatLogMessage(type, context, message)));
+      }
+      return;
+   }
+
+}
+
+int main(int argc, char ** argv) {
+   QCoreApplication app(argc, argv);
+   qInstallMessageHandler(messageHandler);
+
+   QCommandLineParser parser;
+   parser.setApplicationDescription("Benchmark for the recipe calculation chain");
+   parser.addHelpOption();
+   QCommandLineOption const fermentablesOption{"fermentables", "Number of fermentable additions", "N", "10"};
+   QCommandLineOption const hopsOption        {"hops"        , "Number of hop additions"        , "M", "6" };
+   QCommandLineOption const iterationsOption  {"iterations"  , "Number of times to run each stage", "R", "10000"};
+   parser.addOption(fermentablesOption);
+   parser.addOption(hopsOption);
+   parser.addOption(iterationsOption);
+   parser.process(app);
+
+   int const numFermentables = std::max(parser.value(fermentablesOption).toInt(), 0);
+   int const numHops         = std::max(parser.value(hopsOption        ).toInt(), 0);
+   int const iterations      = std::max(parser.value(iterationsOption  ).toInt(), 1);
+
+   QTextStream out{stdout};
+   out <<
+      "Recipe calculation benchmark: " << numFermentables << " fermentables, " << numHops << " hops, " <<
+      iterations << " iterations per stage\n";
+
+   RecipeEvaluator::Snapshot const snapshot = makeSnapshot(numFermentables, numHops);
+   auto const grains    = RecipeEvaluator::grains         (snapshot);
+   auto const volumes   = RecipeEvaluator::volumeEstimates(snapshot, grains);
+   auto const gravities = RecipeEvaluator::gravities      (snapshot, volumes);
+
+   //
+   // The stages up to and including gravities don't depend on the IBU formula, so we only need to time them once
+   //
+   out << "Formula-independent stages\n";
+   timeStage(out, "grainBillTotals", iterations, [&]() {
+      return RecipeEvaluator::grainBillTotals(snapshot.grainBill).grains_kg;
+   });
+   timeStage(out, "grains"         , iterations, [&]() { return RecipeEvaluator::grains(snapshot).grains_kg; });
+   timeStage(out, "volumeEstimates", iterations, [&]() {
+      return RecipeEvaluator::volumeEstimates(snapshot, grains).finalVolume_l;
+   });
+   timeStage(out, "color_srm"      , iterations, [&]() { return RecipeEvaluator::color_srm(snapshot, volumes); });
+   timeStage(out, "ogFg"           , iterations, [&]() { return RecipeEvaluator::gravities(snapshot, volumes).og; });
+   timeStage(out, "ABV_pct"        , iterations, [&]() { return RecipeEvaluator::ABV_pct(gravities); });
+   timeStage(out, "boilGrav"       , iterations, [&]() { return RecipeEvaluator::boilGrav(snapshot); });
+   timeStage(out, "caloriesPerLiter", iterations, [&]() { return RecipeEvaluator::caloriesPerLiter(gravities); });
+
+   for (auto const formula : {IbuMethods::IbuFormula::Tinseth,
+                              IbuMethods::IbuFormula::Rager  ,
+                              IbuMethods::IbuFormula::Noonan ,
+                              IbuMethods::IbuFormula::mIbu   ,
+                              IbuMethods::IbuFormula::Smph   }) {
+      IbuMethods::ibuFormula = formula;
+      out << "IBU formula " << IbuMethods::formulaStringMapping[formula] << "\n";
+      timeStage(out, "IBU"     , iterations, [&]() {
+         return RecipeEvaluator::IBU(snapshot, gravities.og, volumes);
+      });
+      timeStage(out, "evaluate", iterations, [&]() { return RecipeEvaluator::evaluate(snapshot).IBU; });
+   }
+
+   return EXIT_SUCCESS;
+}
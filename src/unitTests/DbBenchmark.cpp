@@ -0,0 +1,365 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * unitTests/DbBenchmark.cpp is part of Brewtarget, and is copyright the following authors 2024:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+
+//
+// This is a stand-alone benchmark for ObjectStore throughput.  For each table size (by default 1k, 10k and 100k rows),
+// it creates a scratch database (which goes through DatabaseSchemaHelper::create in the normal way) and then measures,
+// in rows per second:
+//    - bulk insert (ObjectStore::insertMany)
+//    - property update (ObjectStore::updateProperty, via a normal setter)
+//    - load (ObjectStore::loadAll)
+//    - hard delete (ObjectStore::defaultHardDelete)
+// along with the peak resident set size.  Results are written to stdout as JSON.
+//
+// An ObjectStore can only be loaded once per process, so each table size is done in two child processes: the first
+// creates the DB and does the inserts and updates; the second loads what the first one wrote, and then deletes it.
+//
+// By default the scratch DB is SQLite in a temporary directory.  To benchmark PostgreSQL, use --settings-dir to point
+// at a directory whose settings are configured to use it (in which case the rows are written to that DB, and the delete
+// step removes them again).
+//
+// For SQLite, each table size is run with each of the connection profiles given by --sqlite-profiles (see
+// sqlitePragmas() in database/Database.cpp), so we can compare them.
+//
+// Alternatively, --migrate-db times upgrading a copy of an existing SQLite DB with an older schema (eg a big DB from a
+// long-time user) to the current schema, by opening it in a child process in the normal way.
+//
+// Usage: brewtarget_dbBenchmark [--rows 1000,10000,100000] [--settings-dir DIR] [--sqlite-profiles exclusive,wal]
+//        brewtarget_dbBenchmark --migrate-db FILE
+//
+#include <boost/json/src.hpp> // Needs to be included exactly once in the code to use header-only version of Boost.JSON
+#include <xercesc/util/PlatformUtils.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QProcess>
+#include <QSqlDatabase>
+#include <QString>
+#include <QTemporaryDir>
+
+#if !defined(Q_OS_WIN)
+#include <sys/resource.h>
+#endif
+
+#include "Application.h"
+#include "config.h"
+#include "database/Database.h"
+#include "database/DatabaseSchemaHelper.h"
+#include "database/ObjectStore.h"
+#include "database/ObjectStoreWrapper.h"
+#include "model/Hop.h"
+#include "PersistentSettings.h"
+
+namespace {
+
+   //! All the hops we create are given this name, so we can find them again
+   QString const benchmarkHopName{"DbBenchmark hop"};
+
+   //! \return Peak resident set size of this process in kilobytes, or a null value if we don't know how to get it
+   QJsonValue peakRss_kB() {
+#if defined(Q_OS_WIN)
+      return QJsonValue{};
+#else
+      struct rusage usage;
+      if (getrusage(RUSAGE_SELF, &usage) != 0) {
+         return QJsonValue{};
+      }
+#if defined(Q_OS_MACOS)
+      // On Mac, ru_maxrss is in bytes; on Linux it's in kilobytes
+      return static_cast<qint64>(usage.ru_maxrss / 1024);
+#else
+      return static_cast<qint64>(usage.ru_maxrss);
+#endif
+#endif
+   }
+
+   double rowsPerSecond(int const rows, QElapsedTimer const & timer) {
+      qint64 const elapsed_ns = std::max(timer.nsecsElapsed(), static_cast<qint64>(1));
+      return static_cast<double>(rows) * 1.0e9 / static_cast<double>(elapsed_ns);
+   }
+
+   //! Suppress debug and info logging from the code under test, as otherwise we'd mostly be timing the logging
+   void messageHandler(QtMsgType type, QMessageLogContext const & context, QString const & message) {
+      if (type != QtDebugMsg && type != QtInfoMsg) {
+         std::fprintf(stderr, "%s\n", qPrintable(qFormatLogMessage(type, context, message)));
+      }
+      return;
+   }
+
+   /**
+    * \brief Set things up in the same way as the unit tests do (see \c Testing::initTestCase), using the supplied
+    *        directory for settings and, unless the settings say otherwise, for the SQLite DB.
+    *
+    * \param sqliteProfile If not empty, which SQLite connection profile to use
+    */
+   bool initialise(QString const & settingsDir, QString const & sqliteProfile) {
+      try {
+         xercesc::XMLPlatformUtils::Initialize();
+      } catch (xercesc::XMLException const & xercesInitException) {
+         qCritical() << Q_FUNC_INFO << "Xerces XML Parser Initialisation Failed: " << xercesInitException.getMessage();
+         return false;
+      }
+
+      // Don't clobber the settings of a real installation
+      QCoreApplication::setOrganizationDomain(QString{"%1/dbBenchmark"}.arg(CONFIG_ORGANIZATION_DOMAIN));
+      QCoreApplication::setApplicationName(QString{"%1-dbBenchmark"}.arg(CONFIG_APPLICATION_NAME_LC));
+      PersistentSettings::initialise(settingsDir);
+      if (!sqliteProfile.isEmpty()) {
+         PersistentSettings::insert(PersistentSettings::Names::sqliteConnectionProfile, sqliteProfile);
+      }
+      Application::setInteractive(false);
+      return Application::initialize();
+   }
+
+   void terminate() {
+      Application::cleanup();
+      xercesc::XMLPlatformUtils::Terminate();
+      return;
+   }
+
+   /**
+    * \brief First child process step: insert \c rows new hops in one go, then change a property on each of them
+    */
+   QJsonObject writeStep(int const rows) {
+      QList<std::shared_ptr<Hop>> hops;
+      hops.reserve(rows);
+      for (int ii = 0; ii < rows; ++ii) {
+         auto hop = std::make_shared<Hop>(benchmarkHopName);
+         hop->setAlpha_pct(5.0);
+         hops.append(hop);
+      }
+
+      QElapsedTimer timer;
+      timer.start();
+      int const numInserted = ObjectStoreWrapper::insertBatch(hops).size();
+      double const insertRate = rowsPerSecond(numInserted, timer);
+
+      timer.start();
+      for (auto hop : hops) {
+         hop->setAlpha_pct(6.5);
+      }
+      // In write-behind mode, the updates are only queued above, so we need to include writing them out
+      ObjectStore::flushPendingPropertyUpdates();
+      double const updateRate = rowsPerSecond(hops.size(), timer);
+
+      return QJsonObject{
+         {"dbType"                   , Database::instance().dbType() == Database::DbType::PGSQL ? "PGSQL" : "SQLITE"},
+         {"inserted"                 , numInserted },
+         {"insert_rowsPerSec"        , insertRate  },
+         {"updateProperty_rowsPerSec", updateRate  },
+         {"write_peakRss_kB"         , peakRss_kB()},
+      };
+   }
+
+   /**
+    * \brief Second child process step: load the hop table, then hard delete everything the first step inserted
+    */
+   QJsonObject readStep() {
+      QElapsedTimer timer;
+      timer.start();
+      // The first access to the store is what triggers loadAll
+      int const numLoaded = ObjectStoreTyped<Hop>::getInstance().getAllRaw().size();
+      double const loadRate = rowsPerSecond(numLoaded, timer);
+
+      QList<int> idsToDelete;
+      for (Hop const * hop : ObjectStoreWrapper::getAllRaw<Hop>()) {
+         if (hop->name() == benchmarkHopName) {
+            idsToDelete.append(hop->key());
+         }
+      }
+
+      timer.start();
+      for (int const id : idsToDelete) {
+         ObjectStoreWrapper::hardDelete<Hop>(id);
+      }
+      double const deleteRate = rowsPerSecond(idsToDelete.size(), timer);
+
+      return QJsonObject{
+         {"loaded"               , numLoaded         },
+         {"loadAll_rowsPerSec"   , loadRate          },
+         {"deleted"              , idsToDelete.size()},
+         {"hardDelete_rowsPerSec", deleteRate        },
+         {"read_peakRss_kB"      , peakRss_kB()      },
+      };
+   }
+
+   /**
+    * \brief Child process step for --migrate-db: the work was all done when we opened the DB, so we just report on it
+    */
+   QJsonObject migrateStep(qint64 const initialise_ms) {
+      QSqlDatabase connection = Database::instance().sqlDatabase();
+      return QJsonObject{
+         {"initialise_ms"     , initialise_ms                                   },
+         {"schemaVersionAfter", DatabaseSchemaHelper::schemaVersion(connection)},
+         {"migrate_peakRss_kB", peakRss_kB()                                    },
+      };
+   }
+
+   //! \return Schema version of the SQLite DB in \c fileName, or -1 if it can't be read
+   int sqliteSchemaVersion(QString const & fileName) {
+      int version = -1;
+      {
+         QSqlDatabase connection = QSqlDatabase::addDatabase("QSQLITE", "dbBenchmarkSchemaVersion");
+         connection.setDatabaseName(fileName);
+         if (connection.open()) {
+            version = DatabaseSchemaHelper::schemaVersion(connection);
+            connection.close();
+         }
+      }
+      QSqlDatabase::removeDatabase("dbBenchmarkSchemaVersion");
+      return version;
+   }
+
+   /**
+    * \brief Run ourselves as a child process to do one step, and return the JSON object it writes out
+    */
+   QJsonObject runStep(QStringList const & arguments) {
+      QProcess child;
+      child.setProcessChannelMode(QProcess::ForwardedErrorChannel);
+      child.start(QCoreApplication::applicationFilePath(), arguments);
+      if (!child.waitForFinished(-1) || child.exitStatus() != QProcess::NormalExit || child.exitCode() != 0) {
+         qCritical() << Q_FUNC_INFO << "Benchmark step" << arguments << "failed:" << child.errorString();
+         return QJsonObject{};
+      }
+      return QJsonDocument::fromJson(child.readAllStandardOutput()).object();
+   }
+
+}
+
+int main(int argc, char ** argv) {
+   QApplication app(argc, argv);
+   qInstallMessageHandler(messageHandler);
+
+   QCommandLineParser parser;
+   parser.setApplicationDescription("Benchmark for ObjectStore load, insert, update and delete throughput");
+   parser.addHelpOption();
+   QCommandLineOption const rowsOption       {"rows"        , "Comma-separated list of table sizes", "N,N,...",
+                                              "1000,10000,100000"};
+   QCommandLineOption const settingsDirOption{"settings-dir", "Use settings (and DB) from this directory", "DIR"};
+   QCommandLineOption const migrateDbOption  {"migrate-db"  , "Time upgrading a copy of this SQLite DB", "FILE"};
+   QCommandLineOption const profilesOption   {"sqlite-profiles", "Comma-separated list of SQLite connection profiles",
+                                              "PROFILE,...", "exclusive,wal"};
+   // These are only for the child processes
+   QCommandLineOption const stepOption       {"step"        , "Internal: which step to run", "write|read|migrate"};
+   parser.addOption(rowsOption);
+   parser.addOption(settingsDirOption);
+   parser.addOption(profilesOption);
+   parser.addOption(migrateDbOption);
+   parser.addOption(stepOption);
+   parser.process(app);
+
+   if (parser.isSet(stepOption)) {
+      //
+      // We're a child process
+      //
+      QElapsedTimer initialiseTimer;
+      initialiseTimer.start();
+      if (!initialise(parser.value(settingsDirOption), parser.value(profilesOption))) {
+         qCritical() << "Unable to initialise database";
+         return EXIT_FAILURE;
+      }
+      qint64 const initialise_ms = initialiseTimer.elapsed();
+      QString const step = parser.value(stepOption);
+      QJsonObject result = (step == "write")   ? writeStep(parser.value(rowsOption).toInt()) :
+                           (step == "migrate") ? migrateStep(initialise_ms)                 : readStep();
+      if (Database::instance().dbType() == Database::DbType::SQLITE) {
+         result.insert("sqliteProfile", parser.value(profilesOption));
+      }
+      std::fputs(QJsonDocument{result}.toJson(QJsonDocument::Compact).constData(), stdout);
+      terminate();
+      return EXIT_SUCCESS;
+   }
+
+   if (parser.isSet(migrateDbOption)) {
+      // Don't touch the original!
+      QTemporaryDir scratchDir;
+      QString const dbCopy = QDir{scratchDir.path()}.filePath("database.sqlite");
+      if (!QFile::copy(parser.value(migrateDbOption), dbCopy)) {
+         qCritical() << "Unable to copy" << parser.value(migrateDbOption) << "to" << dbCopy;
+         return EXIT_FAILURE;
+      }
+      QJsonObject migration{
+         {"dbFileSize_bytes"   , QFileInfo{dbCopy}.size()    },
+         {"schemaVersionBefore", sqliteSchemaVersion(dbCopy) },
+      };
+      QJsonObject const migrateResult = runStep({"--step", "migrate", "--settings-dir", scratchDir.path(),
+                                                 "--sqlite-profiles", "exclusive"});
+      for (auto ii = migrateResult.constBegin(); ii != migrateResult.constEnd(); ++ii) {
+         migration.insert(ii.key(), ii.value());
+      }
+      QJsonObject const report{
+         {"benchmark", "SchemaMigration"    },
+         {"version"  , CONFIG_VERSION_STRING},
+         {"results"  , migration            },
+      };
+      std::fputs(QJsonDocument{report}.toJson(QJsonDocument::Indented).constData(), stdout);
+      return EXIT_SUCCESS;
+   }
+
+   QJsonArray results;
+   for (QString const & rowsString : parser.value(rowsOption).split(',', Qt::SkipEmptyParts)) {
+      int const rows = rowsString.trimmed().toInt();
+      if (rows <= 0) {
+         continue;
+      }
+
+      for (QString const & profileString : parser.value(profilesOption).split(',', Qt::SkipEmptyParts)) {
+         QString const profile = profileString.trimmed();
+
+         // Each run gets a fresh scratch directory, unless we were told which settings to use
+         QTemporaryDir scratchDir;
+         QString const settingsDir =
+            parser.isSet(settingsDirOption) ? parser.value(settingsDirOption) : scratchDir.path();
+
+         QJsonObject result{{"rows", rows}};
+         QJsonObject const writeResult = runStep({"--step", "write", "--rows", QString::number(rows),
+                                                  "--settings-dir", settingsDir, "--sqlite-profiles", profile});
+         QJsonObject const readResult  = runStep({"--step", "read", "--settings-dir", settingsDir,
+                                                  "--sqlite-profiles", profile});
+         for (auto ii = writeResult.constBegin(); ii != writeResult.constEnd(); ++ii) {
+            result.insert(ii.key(), ii.value());
+         }
+         for (auto ii = readResult.constBegin(); ii != readResult.constEnd(); ++ii) {
+            result.insert(ii.key(), ii.value());
+         }
+         results.append(result);
+
+         // The SQLite profile makes no difference to PostgreSQL, so there's no point running it more than once
+         if (writeResult.value("dbType").toString() == "PGSQL") {
+            break;
+         }
+      }
+   }
+
+   QJsonObject const report{
+      {"benchmark", "ObjectStore"        },
+      {"version"  , CONFIG_VERSION_STRING},
+      {"results"  , results              },
+   };
+   std::fputs(QJsonDocument{report}.toJson(QJsonDocument::Indented).constData(), stdout);
+   return EXIT_SUCCESS;
+}
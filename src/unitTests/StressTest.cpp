@@ -0,0 +1,426 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * unitTests/StressTest.cpp is part of Brewtarget, and is copyright the following authors 2024:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+
+//
+// This is a stand-alone stress test for the parts of the code that get used from more than one thread at once.  It
+// sets up a scratch database (in the same way as DbBenchmark), and then, for a fixed time, a number of worker threads
+// each do a random mix of:
+//    - reading the latest ObjectStore::Snapshot of hops that the main thread has handed over, and checking it makes
+//      sense
+//    - querying the DB through their own connection (so exercising the per-thread connection naming in
+//      Database::sqlDatabase, and Diagnostics' SQL statistics)
+//    - logging (through Logging's message handler, and thus its mutex)
+//    - recording signals in Diagnostics and interning strings in StringPool
+//    - calculating recipes from snapshots (RecipeEvaluator::evaluate, as the background recalculation does)
+// whilst the main thread makes random changes to hops and recipes (some written behind and some through insertAsync /
+// updateAsync, which use the DB worker thread), hands over new snapshots, starts background recalculations (which
+// publish their results through RecipeCalculationCache) and runs the event loop.
+//
+// Anything that doesn't make sense is logged as a critical error, and makes the exit code non-zero.  Just as
+// importantly, the test gives ThreadSanitizer something to look at.  To use it, configure a separate build directory
+// with `meson setup -Db_sanitize=thread` or `cmake -DSANITIZE_THREAD=ON` and run with, eg,
+// TSAN_OPTIONS="halt_on_error=1 second_deadlock_stack=1".  (Qt itself is not built with ThreadSanitizer, so races
+// inside Qt won't be seen, but anything we do to our own data, including through Qt's atomics, will be.)
+//
+// Every run uses a different random seed unless --seed is given.  The seed is printed at the start, so a failure can
+// be rerun with the same one (though, of course, thread scheduling will still differ from one run to the next).
+//
+// Usage: brewtarget_stressTest [--threads N] [--seconds S] [--seed X]
+//
+#include <boost/json/src.hpp> // Needs to be included exactly once in the code to use header-only version of Boost.JSON
+#include <xercesc/util/PlatformUtils.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QDeadlineTimer>
+#include <QDir>
+#include <QFuture>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QRandomGenerator>
+#include <QSqlDatabase>
+#include <QSqlError>
+#include <QString>
+#include <QTemporaryDir>
+#include <QThread>
+
+#include "Application.h"
+#include "config.h"
+#include "database/BtSqlQuery.h"
+#include "database/Database.h"
+#include "database/ObjectStore.h"
+#include "database/ObjectStoreWrapper.h"
+#include "database/SyntheticData.h"
+#include "Logging.h"
+#include "model/Hop.h"
+#include "model/Recipe.h"
+#include "PersistentSettings.h"
+#include "RecipeEvaluator.h"
+#include "utils/Diagnostics.h"
+#include "utils/StringPool.h"
+
+namespace {
+
+   //! Number of hops we create before starting, so that the workers have something to look at from the outset
+   int constexpr numInitialHops = 200;
+
+   //! Number of recipes \c SyntheticData makes for us
+   int constexpr numRecipes = 20;
+
+   //! All the hops the main thread changes are given alpha acids in this range, so that workers can check what they see
+   double constexpr minAlpha_pct = 1.0;
+   double constexpr maxAlpha_pct = 20.0;
+
+   //! Total number of problems found, by any thread
+   std::atomic<int> numFailures{0};
+
+   //! Set by the main thread to tell the workers to finish
+   std::atomic<bool> stopping{false};
+
+   void fail(QString const & message) {
+      ++numFailures;
+      qCritical().noquote() << "Stress test failure:" << message;
+      return;
+   }
+
+   /**
+    * \brief What the main thread hands over to the workers.  Replaced (rather than modified) each time, so a worker
+    *        can take a copy of the shared pointer and then read it at leisure.
+    */
+   struct SharedData {
+      ObjectStore::Snapshot hops;
+      QVector<RecipeEvaluator::Snapshot> recipes;
+   };
+
+   QMutex sharedDataMutex;
+   std::shared_ptr<SharedData const> sharedData;
+
+   std::shared_ptr<SharedData const> latestSharedData() {
+      QMutexLocker locker(&sharedDataMutex);
+      return sharedData;
+   }
+
+   //! Called on the main thread
+   void publishSharedData() {
+      auto newData = std::make_shared<SharedData>();
+      newData->hops = ObjectStoreTyped<Hop>::getInstance().snapshot();
+      for (Recipe * recipe : ObjectStoreWrapper::getAllRaw<Recipe>()) {
+         newData->recipes.append(RecipeEvaluator::snapshotOf(*recipe));
+      }
+      QMutexLocker locker(&sharedDataMutex);
+      sharedData = std::move(newData);
+      return;
+   }
+
+   //! So that workers can check what they get from the string pool
+   QStringList const poolStrings{
+      "Pellet", "Leaf", "Plug", "Bittering", "Aroma", "Cascade", "Saaz", "Hallertau", "Fuggle", "Mosaic",
+   };
+
+   /**
+    * \brief What each worker thread does until told to stop
+    */
+   void workerLoop(int const workerNumber, quint32 const seed) {
+      QRandomGenerator random{seed + static_cast<quint32>(workerNumber)};
+      qint64 numOperations = 0;
+      bool usedDb = false;
+
+      while (!stopping.load(std::memory_order_relaxed)) {
+         ++numOperations;
+         switch (random.bounded(5)) {
+            case 0:
+               {
+                  auto const data = latestSharedData();
+                  QList<int> const ids = data->hops.ids();
+                  if (ids.size() != data->hops.size()) {
+                     fail(QString{"Snapshot has %1 IDs but size %2"}.arg(ids.size()).arg(data->hops.size()));
+                  }
+                  if (!ids.isEmpty()) {
+                     int const id = ids.at(random.bounded(ids.size()));
+                     bool ok = false;
+                     double const alpha_pct = data->hops.value(id, PropertyNames::Hop::alpha_pct).toDouble(&ok);
+                     if (!ok || alpha_pct < 0.0 || alpha_pct > 100.0) {
+                        fail(QString{"Hop #%1 has alpha %2 in snapshot"}.arg(id).arg(alpha_pct));
+                     }
+                  }
+                  data->hops.isCurrent();
+               }
+               break;
+
+            case 1:
+               {
+                  usedDb = true;
+                  QSqlDatabase connection = Database::instance().sqlDatabase();
+                  BtSqlQuery query{connection};
+                  if (!query.exec("SELECT COUNT(*) FROM hop") || !query.next()) {
+                     fail(QString{"Worker %1 could not count hops: %2"}.arg(workerNumber)
+                                                                      .arg(query.lastError().text()));
+                  } else if (query.value(0).toInt() < numInitialHops) {
+                     fail(QString{"Worker %1 counted only %2 hops"}.arg(workerNumber).arg(query.value(0).toInt()));
+                  }
+               }
+               break;
+
+            case 2:
+               // Most of these are below the logging level, so that we don't fill the disk
+               if (random.bounded(100) != 0) {
+                  qDebug() << Q_FUNC_INFO << "Worker" << workerNumber << "operation" << numOperations;
+               } else {
+                  qCInfo(Logging::database) << Q_FUNC_INFO << "Worker" << workerNumber << "operation" << numOperations;
+               }
+               break;
+
+            case 3:
+               {
+                  Diagnostics::recordSignalEmitted("StressTest", "workerSignal");
+                  QString const & text = poolStrings.at(random.bounded(poolStrings.size()));
+                  // Make a separate copy, so that intern has something to do
+                  QString const interned = StringPool::intern(QString{text.constData(), text.size()});
+                  if (interned != text) {
+                     fail(QString{"Interning \"%1\" gave \"%2\""}.arg(text, interned));
+                  }
+               }
+               break;
+
+            case 4:
+               {
+                  auto const data = latestSharedData();
+                  if (!data->recipes.isEmpty()) {
+                     RecipeEvaluator::Results const results =
+                        RecipeEvaluator::evaluate(data->recipes.at(random.bounded(data->recipes.size())));
+                     if (std::isnan(results.gravities.og) || std::isnan(results.IBU)) {
+                        fail(QString{"Worker %1 calculated OG %2, IBU %3"}.arg(workerNumber)
+                                                                           .arg(results.gravities.og)
+                                                                           .arg(results.IBU));
+                     }
+                  }
+               }
+               break;
+         }
+      }
+
+      //
+      // Connections have to be removed on the thread that made them, and only once nothing is using them (see comments
+      // on Database::sqlDatabase).
+      //
+      if (usedDb) {
+         QString connectionName;
+         {
+            connectionName = Database::instance().sqlDatabase().connectionName();
+         }
+         QSqlDatabase::removeDatabase(connectionName);
+      }
+      qInfo() << Q_FUNC_INFO << "Worker" << workerNumber << "did" << numOperations << "operations";
+      return;
+   }
+
+   /**
+    * \brief What the main thread does while the workers are running
+    */
+   void mainLoop(QDeadlineTimer const & deadline, quint32 const seed) {
+      QRandomGenerator random{seed};
+      QList<Hop *> const initialHops = ObjectStoreWrapper::findAllMatchingRaw<Hop>([](Hop const * hop) {
+         return hop->name().startsWith("Stress test hop");
+      });
+      QList<Recipe *> const recipes = ObjectStoreWrapper::getAllRaw<Recipe>();
+
+      // Objects that we're not allowed to modify until the DB worker thread has finished with them
+      QVector<QPair<QFuture<int>, std::shared_ptr<Hop>>> pendingInserts;
+      QVector<QPair<QFuture<bool>, Hop *>> pendingUpdates;
+      auto const isPending = [&pendingUpdates](Hop const * hop) {
+         return std::any_of(pendingUpdates.cbegin(), pendingUpdates.cend(), [hop](auto const & pending) {
+            return pending.second == hop;
+         });
+      };
+
+      int numInserted = 0;
+      while (!deadline.hasExpired()) {
+         Hop * hop = initialHops.at(random.bounded(initialHops.size()));
+         switch (random.bounded(7)) {
+            case 0:
+               if (!isPending(hop)) {
+                  hop->setAlpha_pct(minAlpha_pct + random.bounded(maxAlpha_pct - minAlpha_pct));
+               }
+               break;
+
+            case 1:
+               ObjectStore::flushPendingPropertyUpdates();
+               break;
+
+            case 2:
+               {
+                  auto newHop = std::make_shared<Hop>(QString{"Stress test new hop %1"}.arg(numInserted++));
+                  newHop->setAlpha_pct(minAlpha_pct);
+                  pendingInserts.append({ObjectStoreWrapper::insertAsync(newHop), newHop});
+               }
+               break;
+
+            case 3:
+               if (!isPending(hop)) {
+                  hop->setAlpha_pct(minAlpha_pct + random.bounded(maxAlpha_pct - minAlpha_pct));
+                  QFuture<bool> future = ObjectStoreWrapper::updateAsync(ObjectStoreWrapper::getSharedFromRaw(hop));
+                  pendingUpdates.append({future, hop});
+               }
+               break;
+
+            case 4:
+               publishSharedData();
+               break;
+
+            case 5:
+               RecipeEvaluator::recalculateAllRecipes();
+               break;
+
+            case 6:
+               {
+                  Recipe * recipe = recipes.at(random.bounded(recipes.size()));
+                  recipe->setBatchSize_l(15.0 + random.bounded(10.0));
+               }
+               break;
+         }
+
+         for (auto const & [future, insertedHop] : pendingInserts) {
+            if (future.isFinished() && future.result() <= 0) {
+               fail(QString{"Async insert of %1 failed"}.arg(insertedHop->name()));
+            }
+         }
+         pendingInserts.erase(std::remove_if(pendingInserts.begin(), pendingInserts.end(), [](auto const & pending) {
+            return pending.first.isFinished();
+         }), pendingInserts.end());
+         for (auto const & [future, updatedHop] : pendingUpdates) {
+            if (future.isFinished() && !future.result()) {
+               fail(QString{"Async update of hop #%1 failed"}.arg(updatedHop->key()));
+            }
+         }
+         pendingUpdates.erase(std::remove_if(pendingUpdates.begin(), pendingUpdates.end(), [](auto const & pending) {
+            return pending.first.isFinished();
+         }), pendingUpdates.end());
+
+         QCoreApplication::processEvents();
+      }
+
+      // Let everything we started finish
+      while (!pendingInserts.isEmpty() || !pendingUpdates.isEmpty()) {
+         QCoreApplication::processEvents(QEventLoop::AllEvents, 10);
+         pendingInserts.erase(std::remove_if(pendingInserts.begin(), pendingInserts.end(), [](auto const & pending) {
+            return pending.first.isFinished();
+         }), pendingInserts.end());
+         pendingUpdates.erase(std::remove_if(pendingUpdates.begin(), pendingUpdates.end(), [](auto const & pending) {
+            return pending.first.isFinished();
+         }), pendingUpdates.end());
+      }
+      ObjectStore::flushPendingPropertyUpdates();
+      qInfo() << Q_FUNC_INFO << "Main thread inserted" << numInserted << "hops";
+      return;
+   }
+
+   /**
+    * \brief Set things up in the same way as the unit tests do (see \c Testing::initTestCase), using the supplied
+    *        directory for settings, the SQLite DB and the logs
+    */
+   bool initialise(QString const & scratchDir) {
+      try {
+         xercesc::XMLPlatformUtils::Initialize();
+      } catch (xercesc::XMLException const & xercesInitException) {
+         qCritical() << Q_FUNC_INFO << "Xerces XML Parser Initialisation Failed: " << xercesInitException.getMessage();
+         return false;
+      }
+
+      // Don't clobber the settings of a real installation
+      QCoreApplication::setOrganizationDomain(QString{"%1/stressTest"}.arg(CONFIG_ORGANIZATION_DOMAIN));
+      QCoreApplication::setApplicationName(QString{"%1-stressTest"}.arg(CONFIG_APPLICATION_NAME_LC));
+      PersistentSettings::initialise(scratchDir);
+      // The exclusive profile would stop the workers' connections reading the DB at all
+      PersistentSettings::insert(PersistentSettings::Names::sqliteConnectionProfile, "wal");
+      Logging::initializeLogging();
+      Logging::setLogLevel(Logging::LogLevel_INFO);
+      Logging::setDirectory(QDir{scratchDir}, Logging::NewDirectoryIsTemporary);
+      Logging::setLoggingToStderr(false);
+      Application::setInteractive(false);
+      return Application::initialize();
+   }
+
+}
+
+int main(int argc, char ** argv) {
+   QApplication app(argc, argv);
+
+   QCommandLineParser parser;
+   parser.setApplicationDescription("Stress test for code used from more than one thread");
+   parser.addHelpOption();
+   QCommandLineOption const threadsOption{"threads", "Number of worker threads", "N",
+                                          QString::number(std::max(QThread::idealThreadCount(), 4))};
+   QCommandLineOption const secondsOption{"seconds", "How long to run for", "S", "10"};
+   QCommandLineOption const seedOption   {"seed"   , "Random seed", "X"};
+   parser.addOption(threadsOption);
+   parser.addOption(secondsOption);
+   parser.addOption(seedOption);
+   parser.process(app);
+
+   int const numThreads = std::max(parser.value(threadsOption).toInt(), 1);
+   int const numSeconds = std::max(parser.value(secondsOption).toInt(), 1);
+   quint32 const seed = parser.isSet(seedOption) ? parser.value(seedOption).toUInt() :
+                                                   QRandomGenerator::global()->generate();
+   std::printf("Stress test: %d worker threads for %d seconds, seed %u\n", numThreads, numSeconds, seed);
+
+   QTemporaryDir scratchDir;
+   if (!initialise(scratchDir.path())) {
+      std::fprintf(stderr, "Unable to initialise database\n");
+      return EXIT_FAILURE;
+   }
+
+   QList<std::shared_ptr<Hop>> hops;
+   for (int ii = 0; ii < numInitialHops; ++ii) {
+      auto hop = std::make_shared<Hop>(QString{"Stress test hop %1"}.arg(ii));
+      hop->setAlpha_pct(minAlpha_pct);
+      hops.append(hop);
+   }
+   if (ObjectStoreWrapper::insertBatch(hops).size() != numInitialHops ||
+       !SyntheticData::generate(SyntheticData::Parameters{numRecipes, seed}).succeeded) {
+      std::fprintf(stderr, "Unable to create test data\n");
+      return EXIT_FAILURE;
+   }
+   publishSharedData();
+
+   std::vector<std::unique_ptr<QThread>> workers;
+   for (int ii = 0; ii < numThreads; ++ii) {
+      workers.emplace_back(QThread::create(workerLoop, ii, seed));
+      workers.back()->start();
+   }
+
+   mainLoop(QDeadlineTimer{static_cast<qint64>(numSeconds) * 1000}, seed);
+
+   stopping = true;
+   for (auto const & worker : workers) {
+      worker->wait();
+   }
+   // Let any background recalculation that was still going deliver its results
+   QCoreApplication::processEvents();
+
+   Application::cleanup();
+   xercesc::XMLPlatformUtils::Terminate();
+
+   std::printf("Stress test: %d failures\n", numFailures.load());
+   return numFailures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -21,13 +21,17 @@
  ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
 #include "unitTests/Testing.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cmath>
 #include <cstdint>
 #include <exception>
 #include <filesystem>
+#include <functional>
 #include <iostream>
 #include <iostream> // For std::cout
 #include <math.h>
+#include <numbers>
 #include <sstream>
 #include <thread>
 
@@ -35,20 +39,35 @@
 
 #include <xercesc/util/PlatformUtils.hpp>
 
+#include <QBuffer>
 #include <QDebug>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QHash>
+#include <QJsonDocument>
+#include <QJsonObject>
 #include <QString>
 #include <QtTest/QtTest>
 #include <QRandomGenerator>
+#include <QRegExp>
+#include <QRunnable>
+#include <QThreadPool>
 #include <QVector>
 
 #include "Application.h"
 #include "Logging.h"
 #include "Algorithms.h"
 #include "config.h"
+#include "database/EnumCodes.h"
+#include "database/ObjectStoreTyped.h"
 #include "database/ObjectStoreWrapper.h"
+#include "database/SyntheticData.h"
+#include "GrainBillSolver.h"
 #include "Localization.h"
 #include "Logging.h"
+#include "measurement/IbuMethods.h"
 #include "measurement/Measurement.h"
+#include "measurement/SucroseConversion.h"
 #include "measurement/Unit.h"
 #include "measurement/UnitSystem.h"
 #include "model/Boil.h"
@@ -62,6 +81,17 @@
 #include "model/RecipeAdditionFermentable.h"
 #include "model/RecipeAdditionHop.h"
 #include "PersistentSettings.h"
+#include "RecipeEvaluator.h"
+#include "serialization/ImportExport.h"
+#include "serialization/json/BeerJson.h"
+#include "serialization/json/JsonSchema.h"
+#include "serialization/xml/BeerXml.h"
+#include "serialization/xml/XmlCoding.h"
+#include "trees/TreeModel.h"
+#include "unitTests/AllocationGuard.h"
+#include "utils/BtException.h"
+#include "utils/Compression.h"
+#include "utils/ImportPhaseTimings.h"
 #include "utils/ErrorCodeToStream.h"
 #include "utils/FileSystemHelpers.h"
 
@@ -746,6 +776,16 @@ void Testing::testUnitConversions() {
       "Unit conversion error (EBC to SRM)"
    );
 
+   // Bulk conversions should give the same answers as one-at-a-time ones, including where there's an offset
+   double temperatures[] {32.0, 212.0, 152.6};
+   Measurement::Units::fahrenheit.toCanonical(temperatures);
+   QVERIFY2(fuzzyComp(temperatures[0],   0.0, 0.001), "Unit conversion error (F to C v1)");
+   QVERIFY2(fuzzyComp(temperatures[1], 100.0, 0.001), "Unit conversion error (F to C v2)");
+   QVERIFY2(fuzzyComp(temperatures[2], Measurement::Units::fahrenheit.toCanonical(152.6).quantity, 0.001),
+            "Unit conversion error (F to C v3)");
+   Measurement::Units::fahrenheit.fromCanonical(temperatures);
+   QVERIFY2(fuzzyComp(temperatures[2], 152.6, 0.001), "Unit conversion error (C to F)");
+
    return;
 }
 
@@ -825,6 +865,12 @@ void Testing::testNumberDisplayAndParsing() {
    QVERIFY(1    == Measurement::extractRawFromString<int>   ("1,23 %"));
    QVERIFY(3    == Measurement::extractRawFromString<int>   ("  03,45 srm  "));
    QVERIFY(6    == Measurement::extractRawFromString<int>   ("\t6,78000000    bananas!"));
+   QVERIFY(fuzzyComp(0.5, Measurement::extractRawFromString<double>(",5 kg"), 0.0000000001));
+   QVERIFY(Measurement::Unit::splitAmountString("  03,45 srm  ").second == "srm");
+   QVERIFY(Measurement::Unit::splitAmountString("2,5L/kg").second == "L/kg");
+   QVERIFY( Localization::hasUnits("03,45 srm"));
+   QVERIFY(!Localization::hasUnits("03,45"));
+   QVERIFY(!Localization::hasUnits("1,23 %"));
    return;
 }
 
@@ -844,6 +890,121 @@ void Testing::testAlgorithms() {
          "Error converting Specific Gravity to Brix"
       );
    }
+
+   //
+   // Brix <-> SG conversions look up the USDA table in constant time, so check they still hit the rows exactly and
+   // interpolate between them in the same way as the original binary search.
+   //
+   for (size_t ii = 0; ii + 1 < Measurement::sucroseConversions_size; ++ii) {
+      auto const & row  = Measurement::sucroseConversions[ii];
+      auto const & next = Measurement::sucroseConversions[ii + 1];
+      if (row.apparentSgAt2020C > 1.0) {
+         QVERIFY2(fuzzyComp(Algorithms::SgAt20CToBrix(row.apparentSgAt2020C), row.degreesBrix, 1e-9),
+                  "Error converting tabulated Specific Gravity to Brix");
+      }
+      QVERIFY2(fuzzyComp(Algorithms::BrixToSgAt20C(row.degreesBrix), row.apparentSgAt2020C, 1e-9),
+               "Error converting tabulated Brix to Specific Gravity");
+      QVERIFY2(fuzzyComp(Algorithms::BrixToSgAt20C((row.degreesBrix + next.degreesBrix) / 2.0),
+                         (row.apparentSgAt2020C + next.apparentSgAt2020C) / 2.0,
+                         1e-9),
+               "Error interpolating Brix to Specific Gravity");
+   }
+
+   //
+   // Plato -> SG interpolates a table built by root finding, so check it stays within the root-finding precision of
+   // doing it directly, both on and between the table points.
+   //
+   Polynomial const platoFromSg{Polynomial() << -616.868 << 1111.14 << -630.272 << 135.997};
+   for (double plato = -5.0; plato <= 32.0; plato += 0.0137) {
+      Polynomial poly{platoFromSg};
+      poly[0] -= plato;
+      double const expectedSg = poly.rootFind(0.900, 1.150);
+      QVERIFY2(fuzzyComp(Algorithms::PlatoToSG_20C20C(plato), expectedSg, 1e-6), "Error converting Plato to SG");
+      QVERIFY2(fuzzyComp(Algorithms::SG_20C20C_toPlato(expectedSg), plato, 1e-4), "Error converting SG to Plato");
+   }
+
+   // Same again for the apparent to current Plato conversion
+   for (double og = 1.030; og <= 1.100; og += 0.0071) {
+      for (double fg = 0.996; fg <= 1.030; fg += 0.0033) {
+         double const sp = Algorithms::SG_20C20C_toPlato(og);
+         Polynomial const poly{
+            Polynomial() << 1.001843 - 0.002318474*sp - 0.000007775*sp*sp - 0.000000034*sp*sp*sp - fg
+                         << 0.00574 << 0.00003344 << 0.000000086
+         };
+         QVERIFY2(fuzzyComp(Algorithms::ogFgToPlato(og, fg), poly.rootFind(3, 5), 1e-4), "Error in OG/FG to Plato");
+      }
+   }
+
+   // Batch conversions should give the same answers as one-at-a-time ones
+   std::vector<double> const gravities{1.000, 1.012, 1.048, 1.0575, 1.100};
+   std::vector<double> converted(gravities.size());
+   Algorithms::SgAt20CToBrix(gravities, converted);
+   for (size_t ii = 0; ii < gravities.size(); ++ii) {
+      QVERIFY2(converted[ii] == Algorithms::SgAt20CToBrix(gravities[ii]), "Error in batch SG to Brix");
+   }
+   Algorithms::SG_20C20C_toPlato(gravities, converted);
+   Algorithms::PlatoToSG_20C20C(converted, converted);
+   for (size_t ii = 0; ii < gravities.size(); ++ii) {
+      QVERIFY2(fuzzyComp(converted[ii], gravities[ii], 1e-6), "Error in batch SG to Plato and back");
+   }
+
+   // Same for batch IBU calculations, with each formula
+   std::vector<IbuMethods::IbuCalculationParms> ibuParms;
+   for (double boilTime_minutes = 0.0; boilTime_minutes <= 90.0; boilTime_minutes += 15.0) {
+      ibuParms.push_back({.AArating              = 0.055,
+                          .hops_grams            = 28.0,
+                          .postBoilVolume_liters = 21.0,
+                          .wortGravity_sg        = 1.040 + boilTime_minutes / 1000.0,
+                          .boilTime_minutes      = boilTime_minutes});
+   }
+   std::vector<double> ibus(ibuParms.size());
+   IbuMethods::IbuFormula const savedIbuFormula = IbuMethods::ibuFormula;
+   for (auto const formula : {IbuMethods::IbuFormula::Tinseth,
+                              IbuMethods::IbuFormula::Rager,
+                              IbuMethods::IbuFormula::Noonan,
+                              IbuMethods::IbuFormula::mIbu}) {
+      IbuMethods::ibuFormula = formula;
+      IbuMethods::getIbus(ibuParms, ibus);
+      for (size_t ii = 0; ii < ibuParms.size(); ++ii) {
+         QVERIFY2(ibus[ii] == IbuMethods::getIbus(ibuParms[ii]), "Error in batch IBU calculation");
+      }
+   }
+
+   //
+   // The mIBU post-boil utilization used to be integrated in 0.001 minute steps.  It's now done by adaptive Simpson's
+   // rule, which should agree with the old brute-force result to well within 0.1%.  With no cooling time, mIBU is the
+   // same as Tinseth.
+   //
+   IbuMethods::ibuFormula = IbuMethods::IbuFormula::mIbu;
+   for (double coolTime_minutes : {0.0, 3.0, 10.0, 20.0, 45.0}) {
+      for (double boilTime_minutes : {0.0, 2.0, 5.0, 15.0, 60.0}) {
+         IbuMethods::IbuCalculationParms const parms{.AArating                  = 0.055,
+                                                     .hops_grams                = 28.0,
+                                                     .postBoilVolume_liters     = 21.0,
+                                                     .wortGravity_sg            = 1.050,
+                                                     .boilTime_minutes          = boilTime_minutes,
+                                                     .coolTime_minutes          = coolTime_minutes,
+                                                     .kettleInternalDiameter_cm = 40.0,
+                                                     .kettleOpeningDiameter_cm  = 30.0};
+         double const effectiveArea_cm2 = std::sqrt(std::numbers::pi * 20.0 * 20.0 * std::numbers::pi * 15.0 * 15.0);
+         double const b = (0.0002925 * effectiveArea_cm2 / parms.postBoilVolume_liters) + 0.00538;
+         double const bignessFactor = 1.65 * std::pow(0.000125, parms.wortGravity_sg - 1.0);
+         double utilization = bignessFactor * (1.0 - std::exp(-0.04 * boilTime_minutes)) / 4.15;
+         for (double time_minutes = boilTime_minutes;
+              time_minutes < boilTime_minutes + coolTime_minutes;
+              time_minutes += 0.001) {
+            double const temp_degK = 53.70 * std::exp(-1.0 * b * (time_minutes - boilTime_minutes)) + 319.55;
+            double const degreeOfUtilization =
+               (time_minutes < 5.0) ? 1.0 : 2.39 * std::pow(10.0, 11.0) * std::exp(-9773.0 / temp_degK);
+            utilization += bignessFactor * 0.04 * std::exp(-0.04 * time_minutes) / 4.15 * degreeOfUtilization * 0.001;
+         }
+         double const expectedIbus = utilization * parms.AArating * parms.hops_grams * 1000.0 /
+                                     parms.postBoilVolume_liters;
+         QVERIFY2(fuzzyComp(IbuMethods::getIbus(parms), expectedIbus, std::max(expectedIbus * 0.001, 1e-9)),
+                  "Error in mIBU calculation");
+      }
+   }
+   IbuMethods::ibuFormula = savedIbuFormula;
    return;
 }
 
@@ -892,6 +1053,775 @@ void Testing::testLogRotation() {
    return;
 }
 
+void Testing::benchmarkImport() {
+   bool sizeOk = false;
+   int numRecords = qEnvironmentVariableIntValue("BREWTARGET_IMPORT_BENCHMARK_RECORDS", &sizeOk);
+   if (!sizeOk || numRecords <= 0) {
+      numRecords = 2000;
+   }
+
+   // We don't want to be timing debug logging
+   Logging::Level const savedLogLevel = Logging::getLogLevel();
+   Logging::setLogLevel(Logging::LogLevel_WARNING);
+   Logging::setLoggingToStderr(false);
+
+   for (QString const format : {"xml", "json"}) {
+      //
+      // Make the ingredients we're going to export.  We don't store them in the DB, so the first import of the file
+      // will find no duplicates.  Names include the format, so that the BeerJSON import doesn't find the ones we
+      // already read in from BeerXML.
+      //
+      QList<std::shared_ptr<Hop>>         hops;
+      QList<std::shared_ptr<Fermentable>> fermentables;
+      QList<Hop         const *>          hopsToExport;
+      QList<Fermentable const *>          fermentablesToExport;
+      for (int ii = 0; ii < numRecords; ++ii) {
+         auto hop = std::make_shared<Hop>(QString{"Import benchmark %1 hop %2"}.arg(format).arg(ii));
+         hop->setAlpha_pct(2.0 + (ii % 150) / 10.0);
+         hop->setType(Hop::Type::AromaAndBittering);
+         hop->setForm(Hop::Form::Pellet);
+         hops.append(hop);
+         hopsToExport.append(hop.get());
+
+         auto fermentable = std::make_shared<Fermentable>(QString{"Import benchmark %1 grain %2"}.arg(format).arg(ii));
+         fermentable->setType(Fermentable::Type::Grain);
+         fermentable->setColor_srm(1.0 + (ii % 500) / 10.0);
+         fermentable->setFineGrindYield_pct(70.0 + (ii % 100) / 10.0);
+         fermentables.append(fermentable);
+         fermentablesToExport.append(fermentable.get());
+      }
+
+      QString const fileName = this->pimpl->m_tempDir.filePath(QString{"importBenchmark.%1"}.arg(format));
+      {
+         QFile outFile{fileName};
+         QVERIFY2(outFile.open(QIODevice::WriteOnly | QIODevice::Truncate), "Unable to open benchmark file");
+         if (format == "xml") {
+            BeerXML & beerXml = BeerXML::getInstance();
+            beerXml.createXmlFile(outFile);
+            beerXml.toXml(hopsToExport, outFile);
+            beerXml.toXml(fermentablesToExport, outFile);
+         } else {
+            QString exportMessage;
+            QTextStream exportMessageAsStream{&exportMessage};
+            BeerJson::Exporter exporter{outFile, exportMessageAsStream};
+            exporter.add(hopsToExport);
+            exporter.add(fermentablesToExport);
+            exporter.close();
+         }
+      }
+      std::cout <<
+         "Import benchmark: " << format.toStdString() << " document with " << numRecords << " hops and " <<
+         numRecords << " fermentables is " << QFileInfo{fileName}.size() << " bytes" << std::endl;
+
+      //
+      // The first pass stores everything; the second finds that everything is a duplicate
+      //
+      for (char const * const pass : {"new records", "all duplicates"}) {
+         QString userMessage;
+         QTextStream userMessageAsStream{&userMessage};
+         ImportPhaseTimings::reset();
+         QElapsedTimer timer;
+         timer.start();
+         bool const succeeded = (format == "xml") ?
+            BeerXML::getInstance().importFromXML(fileName, userMessageAsStream) :
+            BeerJson::import(fileName, userMessageAsStream);
+         qint64 const total_ns = timer.nsecsElapsed();
+         QVERIFY2(succeeded, qPrintable(userMessage));
+
+         std::cout << "Import benchmark: " << format.toStdString() << " (" << pass << "): total " <<
+                      total_ns / 1000000 << " ms";
+         for (auto const phase : {ImportPhaseTimings::Phase::Validation,
+                                  ImportPhaseTimings::Phase::Load,
+                                  ImportPhaseTimings::Phase::NormaliseAndStoreInDb,
+                                  ImportPhaseTimings::Phase::DuplicateDetection}) {
+            std::cout << ", " << ImportPhaseTimings::name(phase).toStdString() << " " <<
+                         ImportPhaseTimings::total_ns(phase) / 1000000 << " ms";
+         }
+         std::cout << std::endl;
+      }
+   }
+
+   // Every BeerXML import above should have reused the schema compiled by the first one
+   std::cout << "Import benchmark: XML schema compilations " << XmlCoding::schemaCompilationCount() << std::endl;
+   QVERIFY(XmlCoding::schemaCompilationCount() <= 1);
+   std::cout << "Import benchmark: JSON schema compilations " << JsonSchema::compilationCount() << std::endl;
+   QVERIFY(JsonSchema::compilationCount() <= 1);
+
+   Logging::setLoggingToStderr(true);
+   Logging::setLogLevel(savedLogLevel);
+   return;
+}
+
+void Testing::benchmarkAmountParsing() {
+   // Per comment above, we should be in French locale here, so use decimal comma
+   QStringList const inputs{
+      "5", "1,23 %", "  03,45 srm  ", "4,5 oz", "1.234,5 g", ",5 kg", "2,5L/kg", "66 °C", "no number at all",
+   };
+   int const iterations = 20000;
+
+   // We don't want to be timing debug logging
+   Logging::Level const savedLogLevel = Logging::getLogLevel();
+   Logging::setLogLevel(Logging::LogLevel_WARNING);
+
+   //
+   // This is what Localization::hasUnits used to do on every call (and Measurement::Unit::splitAmountString did with a
+   // static QRegExp)
+   //
+   auto const regExpHasUnits = [](QString const & input) {
+      QString decimal = QRegExp::escape(Localization::getLocale().decimalPoint());
+      QString grouping = QRegExp::escape(Localization::getLocale().groupSeparator());
+      QRegExp amtUnit("((?:\\d+" + grouping + ")?\\d+(?:" + decimal + "\\d+)?|" + decimal + "\\d+)\\s*(\\w+)?");
+      amtUnit.indexIn(input);
+      return amtUnit.cap(2).size() > 0;
+   };
+
+   //
+   // And this is what Localization::toDouble used to do on every call
+   //
+   auto const localeToDouble = [](QString const & input, bool * ok) {
+      double result = QLocale().toDouble(input, ok);
+      if (!*ok) {
+         result = input.toDouble(ok);
+      }
+      return result;
+   };
+
+   auto const time = [&](char const * const name, QStringList const & timedInputs, auto const & parse) {
+      std::size_t found = 0;
+      QElapsedTimer timer;
+      timer.start();
+      for (int ii = 0; ii < iterations; ++ii) {
+         for (QString const & input : timedInputs) {
+            found += parse(input) ? 1 : 0;
+         }
+      }
+      qint64 const elapsed_ns = timer.nsecsElapsed();
+      std::cout <<
+         "Amount parsing benchmark: " << name << " " << elapsed_ns / (iterations * timedInputs.size()) <<
+         " ns/call (" << found / iterations << " of " << timedInputs.size() << " inputs matched)" << std::endl;
+      return;
+   };
+
+   time("hasUnits (old regular expression)", inputs, regExpHasUnits);
+   time("hasUnits"                         , inputs, [](QString const & input) {
+      return Localization::hasUnits(input);
+   });
+   time("splitAmountString"                , inputs, [](QString const & input) {
+      return !Measurement::Unit::splitAmountString(input).second.isEmpty();
+   });
+
+   QStringList const numbers{"5", "1,23", "-03,45", "+4,5", "1.234,5", " 2,5", "1,5e3", "66.6", "abc"};
+   time("toDouble (old QLocale construction)", numbers, [&](QString const & input) {
+      bool ok = false;
+      localeToDouble(input, &ok);
+      return ok;
+   });
+   time("toDouble"                           , numbers, [](QString const & input) {
+      bool ok = false;
+      Localization::toDouble(input, &ok);
+      return ok;
+   });
+
+   // The new code should give the same answers as the old
+   for (QString const & input : inputs) {
+      QVERIFY2(Localization::hasUnits(input) == regExpHasUnits(input), qPrintable(input));
+   }
+   for (QString const & input : numbers) {
+      bool oldOk = false;
+      bool newOk = false;
+      double const oldResult = localeToDouble(input, &oldOk);
+      double const newResult = Localization::toDouble(input, &newOk);
+      QVERIFY2(oldOk == newOk, qPrintable(input));
+      if (oldOk) {
+         QVERIFY2(oldResult == newResult, qPrintable(input));
+      }
+   }
+
+   Logging::setLogLevel(savedLogLevel);
+   return;
+}
+
+void Testing::testSyntheticData() {
+   bool sizeOk = false;
+   int numRecipes = qEnvironmentVariableIntValue("BREWTARGET_SYNTHETIC_RECIPES", &sizeOk);
+   if (!sizeOk || numRecipes <= 0) {
+      numRecipes = 50;
+   }
+
+   // We don't want to be timing debug logging
+   Logging::Level const savedLogLevel = Logging::getLogLevel();
+   Logging::setLogLevel(Logging::LogLevel_WARNING);
+
+   QElapsedTimer timer;
+   timer.start();
+   SyntheticData::Summary const first = SyntheticData::generate(SyntheticData::Parameters{numRecipes, 42});
+   qint64 const elapsed_ms = timer.elapsed();
+   SyntheticData::Summary const second  = SyntheticData::generate(SyntheticData::Parameters{numRecipes, 42});
+   SyntheticData::Summary const another = SyntheticData::generate(SyntheticData::Parameters{numRecipes, 43});
+   Logging::setLogLevel(savedLogLevel);
+
+   QVERIFY(first.succeeded && second.succeeded && another.succeeded);
+   QVERIFY(first.recipes >= numRecipes);
+   QCOMPARE(first.recipes - first.oldVersions, numRecipes);
+   QCOMPARE(second.recipes    , first.recipes    );
+   QCOMPARE(second.additions  , first.additions  );
+   QCOMPARE(second.brewNotes  , first.brewNotes  );
+   QCOMPARE(second.fingerprint, first.fingerprint);
+   QVERIFY(another.fingerprint != first.fingerprint);
+
+   std::cout <<
+      "Synthetic data: " << first.recipes << " recipes, " << first.additions << " additions, " << first.brewNotes <<
+      " brew notes in " << elapsed_ms << " ms" << std::endl;
+   return;
+}
+
+void Testing::testEnumCodes() {
+   for (ObjectStore const * objectStore : GetAllObjectStores()) {
+      for (ObjectStore::TableField const & fieldDefn : objectStore->primaryTableFields()) {
+         if (!fieldDefn.isStoredAsCode()) {
+            continue;
+         }
+         EnumCodes::Codec const * codec = EnumCodes::codecFor(fieldDefn);
+         QVERIFY(codec);
+         if (auto const enumMapping = std::get_if<EnumStringMapping const *>(&fieldDefn.valueDecoder)) {
+            for (EnumAndItsString const & entry : **enumMapping) {
+               std::optional<int> const code = codec->code(entry.native);
+               QVERIFY(code);
+               QVERIFY(codec->enumValue(*code) == entry.native);
+               QVERIFY(codec->codeForString(entry.string) == code);
+            }
+         } else if (auto const unitMapping =
+                       std::get_if<Measurement::UnitStringMapping const *>(&fieldDefn.valueDecoder)) {
+            for (auto const & entry : (*unitMapping)->entries()) {
+               std::optional<int> const code = codec->code(entry.address);
+               QVERIFY(code);
+               QVERIFY(codec->unit(*code) == entry.address);
+            }
+         }
+      }
+   }
+   return;
+}
+
+void Testing::testAllocations() {
+   //
+   // Localization::splitAmount only returns views into its input, so, once the first call has cached the locale's
+   // separators, it should not allocate at all.
+   //
+   QString const amount{"1,5 kg"};
+   Localization::splitAmount(amount);
+   {
+      AllocationGuard const guard;
+      for (int ii = 0; ii < 100; ++ii) {
+         Localization::splitAmount(amount);
+      }
+      QCOMPARE(guard.allocations(), std::size_t{0});
+   }
+
+   //
+   // The IBU calculation allocates a few working arrays on each call, but the number of allocations should not depend
+   // on how many hop additions there are.
+   //
+   RecipeEvaluator::VolumeEstimates const volumes{
+      .wortFromMash_l        = 25.0,
+      .boilVolume_l          = 28.0,
+      .finalVolume_l         = 23.0,
+      .finalVolumeNoLosses_l = 23.0,
+      .postBoilVolume_l      = 24.0,
+   };
+   auto const ibuAllocations = [&volumes](int const numHops) {
+      RecipeEvaluator::Snapshot snapshot{
+         .batchSize_l      = 23.0,
+         .efficiency_pct   = 72.0,
+         .equipment        = std::nullopt,
+         .boil             = RecipeEvaluator::BoilInputs{
+            .preBoilSize_l = 28.0,
+            .boilTime_mins = 60.0,
+            .coolTime_mins = 10.0,
+         },
+         .mashTotalWater_l = std::nullopt,
+         .grainBill        = {},
+         .grainBillTotals  = {},
+         .hopAdditions     = {},
+         .yeastAdditions   = {},
+      };
+      for (int ii = 0; ii < numHops; ++ii) {
+         snapshot.hopAdditions.append(
+            RecipeEvaluator::HopAdditionInputs{
+               .alpha_pct      = 4.0 + (ii % 8),
+               .quantity       = 0.060 / numHops,
+               .addAtTime_mins = 60.0 - (ii * 60.0 / numHops),
+               .isFirstWort    = false,
+               .stage          = RecipeAddition::Stage::Boil,
+               .form           = Hop::Form::Pellet,
+            }
+         );
+      }
+      RecipeEvaluator::IBU(snapshot, 1.050, volumes);
+      AllocationGuard const guard;
+      RecipeEvaluator::IBU(snapshot, 1.050, volumes);
+      return guard.allocations();
+   };
+   std::size_t const fewHopsAllocations  = ibuAllocations(2);
+   std::size_t const manyHopsAllocations = ibuAllocations(50);
+   std::cout <<
+      "Allocations: IBU with 2 hop additions " << fewHopsAllocations << ", with 50 hop additions " <<
+      manyHopsAllocations << std::endl;
+   QCOMPARE(manyHopsAllocations, fewHopsAllocations);
+   return;
+}
+
+void Testing::testCompression() {
+   // Big enough to need several chunks each way
+   QByteArray original;
+   for (int ii = 0; ii < 20000; ++ii) {
+      original.append(QString{"<HOP><NAME>Hop %1</NAME><ALPHA>%2</ALPHA></HOP>\n"}.arg(ii).arg(ii % 17).toUtf8());
+   }
+
+   QString const gzipFileName = this->pimpl->m_tempDir.filePath("testCompression.xml.gz");
+   {
+      Compression::GzipFile gzipFile{gzipFileName};
+      QVERIFY(gzipFile.open(QIODevice::WriteOnly | QIODevice::Truncate));
+      // Write in uneven pieces, as the exporters do
+      for (int offset = 0; offset < original.size(); offset += 1000) {
+         QCOMPARE(gzipFile.write(original.mid(offset, 1000)), static_cast<qint64>(original.mid(offset, 1000).size()));
+      }
+   }
+   QFile gzipFile{gzipFileName};
+   QVERIFY(gzipFile.open(QIODevice::ReadOnly));
+   QByteArray const compressed = gzipFile.readAll();
+   QVERIFY(Compression::isGzip(compressed));
+   QVERIFY(compressed.size() < original.size());
+   gzipFile.seek(0);
+   QCOMPARE(Compression::gunzip(gzipFile, gzipFileName), original);
+
+   QBuffer truncated;
+   truncated.setData(compressed.left(compressed.size() / 2));
+   truncated.open(QIODevice::ReadOnly);
+   QVERIFY_EXCEPTION_THROWN(static_cast<void>(Compression::gunzip(truncated, "truncated")), BtException);
+
+   //
+   // A minimal zip archive with one stored (ie uncompressed) entry and one directory, which should not be listed
+   //
+   auto const crc32 = [](QByteArray const & data) {
+      quint32 crc = 0xFFFFFFFF;
+      for (char const byte : data) {
+         crc ^= static_cast<quint8>(byte);
+         for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+         }
+      }
+      return ~crc;
+   };
+   auto const append = [](QByteArray & data, quint32 const value, int const numBytes) {
+      for (int ii = 0; ii < numBytes; ++ii) {
+         data.append(static_cast<char>((value >> (8 * ii)) & 0xFF));
+      }
+   };
+   QByteArray const entryData = original.left(5000);
+   QByteArray archive;
+   QByteArray centralDirectory;
+   for (QByteArray const & entryName : {QByteArray{"recipes/"}, QByteArray{"recipes/hops.xml"}}) {
+      bool const isDirectory = entryName.endsWith('/');
+      QByteArray const data = isDirectory ? QByteArray{} : entryData;
+      quint32 const localHeaderOffset = archive.size();
+      append(archive, 0x04034b50, 4);
+      append(archive, 20, 2);                 // Version needed to extract
+      append(archive, 0, 2);                  // Flags
+      append(archive, 0, 2);                  // Method = stored
+      append(archive, 0, 4);                  // Modification time and date
+      append(archive, crc32(data), 4);
+      append(archive, data.size(), 4);        // Compressed size
+      append(archive, data.size(), 4);        // Uncompressed size
+      append(archive, entryName.size(), 2);
+      append(archive, 0, 2);                  // Extra field length
+      archive.append(entryName);
+      archive.append(data);
+
+      append(centralDirectory, 0x02014b50, 4);
+      append(centralDirectory, 20, 2);        // Version made by
+      append(centralDirectory, 20, 2);        // Version needed to extract
+      append(centralDirectory, 0, 2);         // Flags
+      append(centralDirectory, 0, 2);         // Method = stored
+      append(centralDirectory, 0, 4);         // Modification time and date
+      append(centralDirectory, crc32(data), 4);
+      append(centralDirectory, data.size(), 4);
+      append(centralDirectory, data.size(), 4);
+      append(centralDirectory, entryName.size(), 2);
+      append(centralDirectory, 0, 2);         // Extra field length
+      append(centralDirectory, 0, 2);         // Comment length
+      append(centralDirectory, 0, 2);         // Disk number
+      append(centralDirectory, 0, 2);         // Internal attributes
+      append(centralDirectory, 0, 4);         // External attributes
+      append(centralDirectory, localHeaderOffset, 4);
+      centralDirectory.append(entryName);
+   }
+   quint32 const centralDirectoryOffset = archive.size();
+   archive.append(centralDirectory);
+   append(archive, 0x06054b50, 4);
+   append(archive, 0, 4);                     // Disk numbers
+   append(archive, 2, 2);                     // Entries on this disk
+   append(archive, 2, 2);                     // Total entries
+   append(archive, centralDirectory.size(), 4);
+   append(archive, centralDirectoryOffset, 4);
+   append(archive, 0, 2);                     // Comment length
+
+   QString const zipFileName = this->pimpl->m_tempDir.filePath("testCompression.zip");
+   {
+      QFile zipFile{zipFileName};
+      QVERIFY(zipFile.open(QIODevice::WriteOnly | QIODevice::Truncate));
+      QCOMPARE(zipFile.write(archive), static_cast<qint64>(archive.size()));
+   }
+   QVector<Compression::ZipEntry> const entries = Compression::zipEntries(zipFileName);
+   QCOMPARE(entries.size(), 1);
+   QCOMPARE(entries[0].name, QString{"recipes/hops.xml"});
+   QCOMPARE(Compression::readZipEntry(zipFileName, entries[0]), entryData);
+   return;
+}
+
+void Testing::testParallelExport() {
+   // Plenty more than ParallelRender::minRecordsForParallel, and, between them, more notes than the lazy text cache
+   // holds
+   int const numRecipes = 100;
+   QList<std::shared_ptr<Recipe>> recipes;
+   QList<Recipe const *> recipesToExport;
+   QHash<int, QString> notesById;
+   for (int ii = 0; ii < numRecipes; ++ii) {
+      auto recipe = std::make_shared<Recipe>(QString{"Parallel export recipe %1"}.arg(ii));
+      QString const notes = QString{"Parallel export notes %1 "}.arg(ii).repeated(150);
+      recipe->setNotes(notes);
+      QVERIFY(ObjectStoreWrapper::insert(recipe) > 0);
+      notesById.insert(recipe->key(), notes);
+      recipes.append(recipe);
+      recipesToExport.append(recipe.get());
+   }
+   ObjectStore::flushPendingPropertyUpdates();
+
+   ObjectStore const & recipeStore = ObjectStoreTyped<Recipe>::getInstance();
+   std::atomic<int> numMismatches{0};
+   std::atomic<bool> exportsDone{false};
+   QThreadPool threadPool;
+   for (int thread = 0; thread < 4; ++thread) {
+      threadPool.start(QRunnable::create([&recipeStore, &notesById, &numMismatches, &exportsDone, thread]() {
+         // Each thread goes through the recipes in a different order, so that they're not all asking for the same one
+         QList<int> const ids = notesById.keys();
+         do {
+            for (int ii = 0; ii < ids.size(); ++ii) {
+               int const id = ids[(ii * (thread + 1)) % ids.size()];
+               if (recipeStore.lazyTextValue(id, PropertyNames::Recipe::notes) != notesById.value(id)) {
+                  ++numMismatches;
+               }
+            }
+         } while (!exportsDone);
+         return;
+      }));
+   }
+
+   for (QString const format : {"xml", "json"}) {
+      QString const fileName = this->pimpl->m_tempDir.filePath(QString{"testParallelExport.%1"}.arg(format));
+      QVERIFY(ImportExport::exportToNamedFile(fileName, &recipesToExport));
+      QFile exportFile{fileName};
+      QVERIFY(exportFile.open(QIODevice::ReadOnly));
+      QString const exported = QString::fromUtf8(exportFile.readAll());
+      for (QString const & notes : notesById) {
+         QVERIFY2(exported.contains(notes), qPrintable(QString{"Notes missing from %1 export"}.arg(format)));
+      }
+   }
+   exportsDone = true;
+   threadPool.waitForDone();
+   QCOMPARE(numMismatches.load(), 0);
+   return;
+}
+
+namespace {
+   /**
+    * \brief A recipe snapshot with \c grain_kg of pale malt in the mash and \c extract_kg of dark dry malt extract in
+    *        the boil
+    */
+   RecipeEvaluator::Snapshot makeGrainBillSnapshot(double const grain_kg, double const extract_kg) {
+      RecipeEvaluator::Snapshot snapshot{
+         .batchSize_l          = 23.0,
+         .efficiency_pct       = 72.0,
+         .equipment            = RecipeEvaluator::EquipmentInputs{
+            .mashTunGrainAbsorption_LKg = 1.086,
+            .lauteringDeadspaceLoss_l   = 1.0,
+            .topUpKettle_l              = 0.0,
+            .topUpWater_l               = 0.0,
+            .kettleTrubChillerLoss_l    = 1.5,
+            .boilTime_min               = 60.0,
+            .kettleEvaporationPerHour_l = 4.0,
+            .hopUtilization_pct         = 100.0,
+            .kettleInternalDiameter_cm  = 35.0,
+            .kettleOpeningDiameter_cm   = 35.0,
+         },
+         .boil                 = RecipeEvaluator::BoilInputs{
+            .preBoilSize_l = 28.0,
+            .boilTime_mins = 60.0,
+            .coolTime_mins = 10.0,
+         },
+         .mashTotalWater_l     = 15.0,
+         .grainBill            = {},
+         .grainBillTotals      = {},
+         .hopAdditions         = {},
+         .yeastAdditions       = {},
+      };
+      snapshot.grainBill.append(
+         RecipeEvaluator::FermentableAdditionInputs{
+            .type               = Fermentable::Type::Grain,
+            .stage              = RecipeAddition::Stage::Mash,
+            .amountIsWeight     = true,
+            .quantity           = grain_kg,
+            .addAfterBoil       = false,
+            .equivSucrose_kg    = grain_kg * 0.78,
+            .isSugar            = false,
+            .isExtract          = false,
+            .isFermentableSugar = true,
+            .color_srm          = 2.0,
+            .ibuGalPerLb        = std::nullopt,
+         }
+      );
+      snapshot.grainBill.append(
+         RecipeEvaluator::FermentableAdditionInputs{
+            .type               = Fermentable::Type::Dry_Extract,
+            .stage              = RecipeAddition::Stage::Boil,
+            .amountIsWeight     = true,
+            .quantity           = extract_kg,
+            .addAfterBoil       = false,
+            .equivSucrose_kg    = extract_kg * 0.95,
+            .isSugar            = false,
+            .isExtract          = true,
+            .isFermentableSugar = true,
+            .color_srm          = 40.0,
+            .ibuGalPerLb        = std::nullopt,
+         }
+      );
+      snapshot.grainBillTotals = RecipeEvaluator::grainBillTotals(snapshot.grainBill);
+      snapshot.yeastAdditions.append(
+         RecipeEvaluator::YeastAdditionInputs{
+            .additionAttenuation_pct     = std::nullopt,
+            .yeastAttenuationTypical_pct = 75.0,
+         }
+      );
+      return snapshot;
+   }
+}
+
+void Testing::testGrainBillSolver() {
+   // The targets are what 4 kg of malt and 1 kg of extract give, so there is an exact answer
+   auto const targetResults = RecipeEvaluator::evaluate(makeGrainBillSnapshot(4.0, 1.0));
+   GrainBillSolver::Targets const targets{
+      .og              = targetResults.gravities.og,
+      .color_srm       = targetResults.color_srm,
+      .typePercentages = {{Fermentable::Type::Grain, 80.0}},
+   };
+
+   // The solver doesn't look at the additions themselves, so we don't need real ones
+   GrainBillSolver::Inputs const inputs{
+      .snapshot       = makeGrainBillSnapshot(3.0, 2.0),
+      .additions      = QVector<std::shared_ptr<RecipeAdditionFermentable>>(2),
+      .types          = {Fermentable::Type::Grain, Fermentable::Type::Dry_Extract},
+      .quantities     = {3.0, 2.0},
+      .amountIsWeight = {true, true},
+      .adjustable     = {true, true},
+   };
+   GrainBillSolver::Solution const solution = GrainBillSolver::solve(inputs, targets);
+   qDebug() <<
+      Q_FUNC_INFO << "Solved" << solution.quantities << "for OG" << *targets.og << "and color" << *targets.color_srm <<
+      "; got OG" << solution.og << "and color" << solution.color_srm;
+
+   QCOMPARE(solution.quantities.size(), 2);
+   QVERIFY2(fuzzyComp(solution.og, *targets.og, 0.001), "Wrong OG");
+   QVERIFY2(fuzzyComp(solution.color_srm, *targets.color_srm, 0.5), "Wrong color");
+   QVERIFY2(fuzzyComp(solution.typePercentages.at(Fermentable::Type::Grain), 80.0, 1.0), "Wrong base malt percentage");
+   QVERIFY2(fuzzyComp(solution.typePercentages.at(Fermentable::Type::Dry_Extract), 20.0, 1.0),
+            "Wrong extract percentage");
+
+   // With no targets, we should get back what we started with
+   GrainBillSolver::Solution const unchanged = GrainBillSolver::solve(inputs, GrainBillSolver::Targets{});
+   QVERIFY(fuzzyComp(unchanged.quantities.at(0), 3.0, 1.0e-9));
+   QVERIFY(fuzzyComp(unchanged.quantities.at(1), 2.0, 1.0e-9));
+   return;
+}
+
+void Testing::perfRegressionCheck() {
+   bool repeatsOk = false;
+   int repeats = qEnvironmentVariableIntValue("BREWTARGET_PERF_REPEATS", &repeatsOk);
+   if (!repeatsOk || repeats <= 0) {
+      repeats = 5;
+   }
+   bool const writeBaseline = qEnvironmentVariableIntValue("BREWTARGET_PERF_WRITE_BASELINE") != 0;
+   QString baselineFileName = qEnvironmentVariable("BREWTARGET_PERF_BASELINE");
+   if (baselineFileName.isEmpty()) {
+      baselineFileName = QFINDTESTDATA("perfBaseline.json");
+   }
+   QVERIFY2(!baselineFileName.isEmpty(), "Unable to find perfBaseline.json");
+
+   QJsonObject baseline;
+   {
+      QFile baselineFile{baselineFileName};
+      if (baselineFile.open(QIODevice::ReadOnly)) {
+         baseline = QJsonDocument::fromJson(baselineFile.readAll()).object();
+      }
+   }
+   double tolerance_pct = baseline.value("tolerance_pct").toDouble(25.0);
+   bool toleranceOk = false;
+   double const toleranceOverride_pct = qEnvironmentVariable("BREWTARGET_PERF_TOLERANCE_PCT").toDouble(&toleranceOk);
+   if (toleranceOk && toleranceOverride_pct >= 0.0) {
+      tolerance_pct = toleranceOverride_pct;
+   }
+   QJsonObject const baselineMedians = baseline.value("medians_ms").toObject();
+
+   // We don't want to be timing debug logging
+   Logging::Level const savedLogLevel = Logging::getLogLevel();
+   Logging::setLogLevel(Logging::LogLevel_WARNING);
+   Logging::setLoggingToStderr(false);
+
+   //
+   // Data for the cases to work on.  The sizes are fixed, as the baseline medians are only meaningful for the sizes
+   // they were recorded with.
+   //
+   int const numHops = 500;
+   QList<std::shared_ptr<Hop>> perfHops;
+   QList<Hop const *> hopsToExport;
+   for (int ii = 0; ii < numHops; ++ii) {
+      auto hop = std::make_shared<Hop>(QString{"Perf check hop %1"}.arg(ii));
+      hop->setAlpha_pct(2.0 + (ii % 150) / 10.0);
+      perfHops.append(hop);
+      hopsToExport.append(hop.get());
+   }
+   QCOMPARE(ObjectStoreWrapper::insertBatch(perfHops).size(), numHops);
+   QVERIFY(SyntheticData::generate(SyntheticData::Parameters{20, 42}).succeeded);
+   QList<Recipe *> const recipes = ObjectStoreWrapper::getAllRaw<Recipe>();
+   QString const exportFileName = this->pimpl->m_tempDir.filePath("perfRegressionCheck.json");
+
+   int insertRun = 0;
+   struct PerfCase {
+      char const * name;
+      std::function<void()> run;
+   };
+   std::vector<PerfCase> const perfCases {
+      {"objectStoreInsert", [&]() {
+         QList<std::shared_ptr<Hop>> hops;
+         for (int ii = 0; ii < numHops; ++ii) {
+            hops.append(std::make_shared<Hop>(QString{"Perf check insert %1 hop %2"}.arg(insertRun).arg(ii)));
+         }
+         ++insertRun;
+         ObjectStoreWrapper::insertBatch(hops);
+      }},
+      {"objectStoreUpdate", [&]() {
+         for (auto const & hop : perfHops) {
+            hop->setAlpha_pct(hop->alpha_pct() + 0.1);
+         }
+         ObjectStore::flushPendingPropertyUpdates();
+      }},
+      {"objectStoreFind", [&]() {
+         for (int ii = 0; ii < 50; ++ii) {
+            ObjectStoreWrapper::findAllMatchingRaw<Hop>([](Hop const * hop) {
+               return hop->name().startsWith("Perf check hop");
+            });
+         }
+      }},
+      {"recipeCalc", [&]() {
+         for (Recipe * recipe : recipes) {
+            recipe->recalcAll();
+         }
+      }},
+      {"beerJsonExport", [&]() {
+         QFile outFile{exportFileName};
+         outFile.open(QIODevice::WriteOnly | QIODevice::Truncate);
+         QString exportMessage;
+         QTextStream exportMessageAsStream{&exportMessage};
+         BeerJson::Exporter exporter{outFile, exportMessageAsStream};
+         exporter.add(hopsToExport);
+         exporter.close();
+      }},
+      {"beerJsonImport", [&]() {
+         // The export case has already run, and everything in the file is a duplicate of something in the DB
+         QString userMessage;
+         QTextStream userMessageAsStream{&userMessage};
+         BeerJson::import(exportFileName, userMessageAsStream);
+      }},
+      {"treeBuild", []() {
+         TreeModel model{nullptr, TreeModel::TypeMask::Recipe};
+      }},
+   };
+
+   //
+   // Each case gets one untimed run first, so that we're not measuring things that only happen the first time (eg
+   // schema compilation or filling caches).
+   //
+   QJsonObject measuredMedians;
+   QStringList report;
+   bool regressed = false;
+   QStringList casesWithoutBaseline;
+   report << QString{"%1 %2 %3 %4"}.arg("Case", -20).arg("Baseline ms", 12).arg("Median ms", 12).arg("Change", 9);
+   for (PerfCase const & perfCase : perfCases) {
+      perfCase.run();
+      std::vector<double> times_ms;
+      for (int ii = 0; ii < repeats; ++ii) {
+         QElapsedTimer timer;
+         timer.start();
+         perfCase.run();
+         times_ms.push_back(static_cast<double>(timer.nsecsElapsed()) / 1000000.0);
+      }
+      std::sort(times_ms.begin(), times_ms.end());
+      std::size_t const middle = times_ms.size() / 2;
+      double const median_ms = (times_ms.size() % 2) ? times_ms[middle] : (times_ms[middle - 1] + times_ms[middle]) / 2;
+      measuredMedians.insert(perfCase.name, median_ms);
+
+      QString line = QString{"%1 "}.arg(perfCase.name, -20);
+      if (!baselineMedians.contains(perfCase.name)) {
+         line += QString{"%1 %2   (no baseline)"}.arg("-", 12).arg(median_ms, 12, 'f', 2);
+         casesWithoutBaseline << perfCase.name;
+      } else {
+         double const baseline_ms = baselineMedians.value(perfCase.name).toDouble();
+         double const change_pct = baseline_ms > 0.0 ? 100.0 * (median_ms - baseline_ms) / baseline_ms : 0.0;
+         line += QString{"%1 %2 %3%"}.arg(baseline_ms, 12, 'f', 2)
+                                     .arg(median_ms, 12, 'f', 2)
+                                     .arg(change_pct, 8, 'f', 1);
+         //
+         // Very quick cases are at the mercy of timer resolution and scheduling, so a regression also has to be more
+         // than a minimum absolute amount.
+         //
+         if (change_pct > tolerance_pct && median_ms - baseline_ms > 0.5) {
+            line += "   REGRESSED";
+            regressed = true;
+         }
+      }
+      report << line;
+   }
+
+   Logging::setLoggingToStderr(true);
+   Logging::setLogLevel(savedLogLevel);
+
+   QString const reportText = QString{"Medians of %1 runs, tolerance %2%:\n%3"}.arg(repeats)
+                                                                             .arg(tolerance_pct)
+                                                                             .arg(report.join("\n"));
+   std::cout << "Performance check: " << reportText.toStdString() << std::endl;
+
+   if (writeBaseline) {
+      baseline.insert("tolerance_pct", tolerance_pct);
+      baseline.insert("medians_ms", measuredMedians);
+      QFile baselineFile{baselineFileName};
+      QVERIFY2(baselineFile.open(QIODevice::WriteOnly | QIODevice::Truncate), qPrintable(baselineFileName));
+      baselineFile.write(QJsonDocument{baseline}.toJson(QJsonDocument::Indented));
+      std::cout << "Performance check: wrote new baseline to " << baselineFileName.toStdString() << std::endl;
+      return;
+   }
+
+   if (!casesWithoutBaseline.isEmpty()) {
+      QFAIL(qPrintable(QString{"No baseline median in %1 for: %2.  Record one on the reference machine by running "
+                               "with BREWTARGET_PERF_WRITE_BASELINE=1.  "}.arg(baselineFileName)
+                                                                         .arg(casesWithoutBaseline.join(", ")) +
+                       reportText));
+   }
+
+   if (regressed) {
+      QFAIL(qPrintable("Performance regression.  " + reportText));
+   }
+   return;
+}
+
 void Testing::cleanupTestCase() {
    Application::cleanup();
    Logging::terminateLogging();
@@ -86,6 +86,80 @@ private slots:
    //! \brief Verify Log rotation is working
    void testLogRotation();
 
+   /**
+    * \brief Not a test as such, but a benchmark: writes out large BeerXML and BeerJSON documents, then times reading
+    *        them back in, broken down by phase.  (See \c ImportPhaseTimings.)
+    *
+    *        The number of hops and fermentables in each document defaults to 2000 and can be changed with the
+    *        BREWTARGET_IMPORT_BENCHMARK_RECORDS environment variable.
+    */
+   void benchmarkImport();
+
+   /**
+    * \brief Another benchmark: times \c Localization::hasUnits, \c Measurement::Unit::splitAmountString and
+    *        \c Localization::toDouble on a mix of typical input strings, alongside the code they replaced, for
+    *        comparison.
+    */
+   void benchmarkAmountParsing();
+
+   /**
+    * \brief Checks that \c SyntheticData gives the same data each time for the same seed (and different data for a
+    *        different one), and reports how long it takes.  The number of recipes defaults to 50 and can be changed
+    *        with the BREWTARGET_SYNTHETIC_RECIPES environment variable.
+    */
+   void testSyntheticData();
+
+   /**
+    * \brief Checks that every enum and unit field stored as a code has its codes loaded, and that every value in its
+    *        mapping makes the round trip to a code and back.
+    */
+   void testEnumCodes();
+
+   /**
+    * \brief Uses \c AllocationGuard to check that hot paths don't allocate more than they should, eg that amount
+    *        parsing doesn't allocate at all, and that the IBU calculation doesn't allocate per hop addition.
+    */
+   void testAllocations();
+
+   /**
+    * \brief Round trip through \c Compression::GzipFile and \c Compression::gunzip, and reading an entry from a zip
+    *        archive that we put together by hand
+    */
+   void testCompression();
+
+   /**
+    * \brief Exports, as BeerXML and BeerJSON, enough recipes with notes that the records get rendered on several
+    *        threads (see utils/ParallelRender.h), while, at the same time, other threads read the notes through
+    *        \c ObjectStore::lazyTextValue, which is how the getters read notes that weren't loaded at start-up.  The
+    *        notes are long enough that the lazy text cache has to drop some of them while all this is going on.
+    */
+   void testParallelExport();
+
+   /**
+    * \brief Checks that \c GrainBillSolver::solve finds the amounts of a base malt and an extract that give a target
+    *        OG, color and percentage of base malt, starting from amounts that give none of them.
+    */
+   void testGrainBillSolver();
+
+   /**
+    * \brief Performance regression check: times ObjectStore inserts, updates and searches, recipe calculations,
+    *        BeerJSON export and import, and building the recipe tree, and fails if the median time of any of them is
+    *        more than a tolerance above the one in the baseline file, printing a table of baseline and measured
+    *        medians either way.
+    *
+    *        The baseline file is src/unitTests/perfBaseline.json unless BREWTARGET_PERF_BASELINE says otherwise.
+    *        A case with no baseline median fails the check, so that an empty or out-of-date baseline can't pass
+    *        unnoticed.  Other environment variables:
+    *          - BREWTARGET_PERF_REPEATS - number of timed runs of each case (default 5)
+    *          - BREWTARGET_PERF_TOLERANCE_PCT - overrides the tolerance in the baseline file
+    *          - BREWTARGET_PERF_WRITE_BASELINE - if set to 1, write the measured medians to the baseline file
+    *            instead of checking them
+    *
+    *        Baselines are only meaningful on the machine they were recorded on, so this is not one of the default
+    *        tests.
+    */
+   void perfRegressionCheck();
+
 };
 
 #endif
@@ -0,0 +1,112 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * utils/BoundedMpscQueue.h is part of Brewtarget, and is copyright the following authors 2024:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#ifndef UTILS_BOUNDEDMPSCQUEUE_H
+#define UTILS_BOUNDEDMPSCQUEUE_H
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+/**
+ * \brief Bounded lock-free queue with many producers (any thread) and a single consumer.  This is the well-known scheme
+ *        where each slot in a ring buffer has a sequence number that tells producers and the consumer whose turn it is
+ *        to use the slot, so producers only have to agree (via compare-and-swap) on who gets the next position.
+ *
+ *        \c T needs to be default-constructible and move-assignable.  The queue is too big to put on the stack, so
+ *        it's usually a static or owned via a pointer.
+ */
+template<class T, std::size_t capacity>
+class BoundedMpscQueue {
+public:
+   BoundedMpscQueue() {
+      for (std::size_t ii = 0; ii < capacity; ++ii) {
+         this->slots[ii].sequence.store(ii, std::memory_order_relaxed);
+      }
+      return;
+   }
+
+   /**
+    * \brief Can be called from any thread
+    *
+    * \param item Only moved from if we succeed
+    * \param position Set to the position of the item in the queue (ie the number of items queued before it)
+    *
+    * \return \c false if the queue is full
+    */
+   bool tryPush(T & item, std::size_t & position) {
+      std::size_t pos = this->enqueuePosition.load(std::memory_order_relaxed);
+      for (;;) {
+         Slot & slot = this->slots[pos % capacity];
+         std::size_t const sequence = slot.sequence.load(std::memory_order_acquire);
+         auto const difference = static_cast<std::ptrdiff_t>(sequence - pos);
+         if (difference == 0) {
+            if (this->enqueuePosition.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+               slot.item = std::move(item);
+               slot.sequence.store(pos + 1, std::memory_order_release);
+               position = pos;
+               return true;
+            }
+         } else if (difference < 0) {
+            // The consumer hasn't yet taken the item that was in this slot last time round the ring
+            return false;
+         } else {
+            // Another producer got this position before us
+            pos = this->enqueuePosition.load(std::memory_order_relaxed);
+         }
+      }
+   }
+
+   /**
+    * \brief Must only be called from one thread at a time
+    *
+    * \return \c false if the queue is empty
+    */
+   bool tryPop(T & item) {
+      Slot & slot = this->slots[this->dequeuePosition % capacity];
+      std::size_t const sequence = slot.sequence.load(std::memory_order_acquire);
+      if (sequence != this->dequeuePosition + 1) {
+         return false;
+      }
+      item = std::move(slot.item);
+      slot.sequence.store(this->dequeuePosition + capacity, std::memory_order_release);
+      ++this->dequeuePosition;
+      return true;
+   }
+
+   //! Must only be called from the consumer thread
+   bool isEmpty() const {
+      return this->slots[this->dequeuePosition % capacity].sequence.load(std::memory_order_acquire) !=
+             this->dequeuePosition + 1;
+   }
+
+   //! Number of items taken off the queue so far.  Must only be called from the consumer thread.
+   std::size_t numPopped() const {
+      return this->dequeuePosition;
+   }
+
+private:
+   struct Slot {
+      std::atomic<std::size_t> sequence;
+      T item;
+   };
+   Slot slots[capacity];
+   // Keep the producers' and the consumer's positions on separate cache lines
+   alignas(64) std::atomic<std::size_t> enqueuePosition{0};
+   alignas(64) std::size_t dequeuePosition{0};
+};
+
+#endif
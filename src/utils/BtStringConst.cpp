@@ -16,15 +16,45 @@
 #include "utils/BtStringConst.h"
 
 #include <cstring>
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
 
 #include <QDebug>
 #include <QString>
 #include <QTextStream>
 
+namespace {
+   /**
+    * \brief Mutex and table for \c BtStringConst::intern.  Most interning happens during static initialisation, so
+    *        these are function-local statics to avoid depending on static initialisation order.  They are deliberately
+    *        never destroyed, in case some other static \c BtStringConst gets constructed during program shut-down.
+    */
+   std::mutex & internMutex() {
+      static std::mutex * mutex = new std::mutex{};
+      return *mutex;
+   }
+
+   std::unordered_map<std::string_view, char const *> & internTable() {
+      static auto * table = new std::unordered_map<std::string_view, char const *>{};
+      return *table;
+   }
+}
+
 BtStringConst const BtString::NULL_STR{static_cast<char const *>(nullptr)};
 BtStringConst const BtString::EMPTY_STR{""};
 
-BtStringConst::BtStringConst(char const * const cString) : cString(cString) {
+char const * BtStringConst::intern(char const * const cString) {
+   if (!cString) {
+      return nullptr;
+   }
+   std::lock_guard<std::mutex> lock(internMutex());
+   // If the string is already in the table, try_emplace leaves it alone and gives us the existing entry
+   auto const [entry, inserted] = internTable().try_emplace(std::string_view{cString}, cString);
+   return entry->second;
+}
+
+BtStringConst::BtStringConst(char const * const cString) : cString(BtStringConst::intern(cString)) {
    return;
 }
 
@@ -34,18 +64,8 @@ BtStringConst::BtStringConst(BtStringConst &&) = default;
 BtStringConst::~BtStringConst() = default;
 
 bool BtStringConst::operator==(BtStringConst const & rhs) const {
-   // A very common case of equality should be that two strings are in fact the same constant, so checking whether the
-   // addresses match is the first thing we do.
-   //
-   // Note, however, that we cannot guarantee the reverse of this.  Two strings at different memory addresses might be
-   // the same eg if they are defined in headers that are included in multiple translation units and the compiler does
-   // not optimise that away.
-   if (this == &rhs) {
-      return true;
-   }
-   if (this->cString == nullptr && rhs.cString == nullptr) { return true;  }
-   if (this->cString == nullptr || rhs.cString == nullptr) { return false; }
-   return 0 == std::strcmp(this->cString, rhs.cString);
+   // Both sides are interned, so identical strings always have the same pointer (and two null pointers are equal)
+   return this->cString == rhs.cString;
 }
 
 bool BtStringConst::isNull() const {
@@ -57,11 +77,19 @@ char const * BtStringConst::operator*() const {
 }
 
 bool operator==(char const * const lhs, BtStringConst const & rhs) {
-   return BtStringConst(lhs) == rhs;
+   // We don't construct a BtStringConst from lhs here, because we can't assume it points to something with static
+   // storage duration, so it mustn't go in the interning table.
+   if (lhs == *rhs) {
+      return true;
+   }
+   if (lhs == nullptr || rhs.isNull()) {
+      return false;
+   }
+   return 0 == std::strcmp(lhs, *rhs);
 }
 
 bool operator==(BtStringConst const & lhs, char const * const rhs) {
-   return lhs == BtStringConst(rhs);
+   return rhs == lhs;
 }
 
 bool operator==(QString const & lhs, BtStringConst const & rhs) {
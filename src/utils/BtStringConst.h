@@ -17,6 +17,9 @@
 #define UTILS_BTSTRINGCONST_H
 #pragma once
 
+#include <cstddef>
+#include <functional>
+
 class QDebug;
 class QString;
 class QTextStream;
@@ -42,6 +45,16 @@ class QTextStream;
  *        QString and never a problem.  In practice, you have to be careful about, say, a struct containing
  *        QString const &, as you can break the reference-counting logic and get a segfault (at least on Clang on Mac OS
  *        with Qt 5.9.5).
+ *
+ *        Each distinct string is interned on construction: the first \c BtStringConst constructed with a given string
+ *        registers its \c char \c const \c * as the canonical one, and every later \c BtStringConst with the same
+ *        contents holds that same pointer.  This means that, even though a constant such as
+ *        \c PropertyNames::Hop::alpha_pct exists separately in every translation unit that includes its header, all the
+ *        copies wrap the same pointer, so comparing two \c BtStringConst is a pointer comparison, and the pointer can
+ *        be used for hashing (see \c std::hash specialisation below).
+ *
+ *        Because the pointer is kept in the interning table for the life of the program, \c BtStringConst must only be
+ *        constructed from strings with static storage duration (eg string literals), which is what it's for anyway.
  */
 class BtStringConst {
 public:
@@ -54,9 +67,8 @@ public:
    ~BtStringConst();
 
    /**
-    * \brief Compare two \c BtStringConst for equality using \c std::strcmp internally after doing short-cut checks (eg
-    *        are lhs and rhs references to the same object, does either/both sides contain null pointer to its C
-    *        string).
+    * \brief Compare two \c BtStringConst for equality.  Because both sides are interned, this is just a comparison of
+    *        the contained pointers.
     *
     *        Note that, in general, it's best \b not to compare \b pointers to \c BtStringConst because it's not
     *        possible to provide an overload for operator== that handles such a case (and we might have two instances of
@@ -102,6 +114,12 @@ public:
    }
 
 private:
+   /**
+    * \brief Returns the canonical pointer for the string \c cString, registering \c cString as canonical if this is
+    *        the first time we've seen its contents.
+    */
+   static char const * intern(char const * const cString);
+
    char const * const cString;
 
    //! No assignment operator
@@ -163,4 +181,15 @@ bool operator==(BtStringConst const & lhs, QString const & rhs);
  */
 bool operator!=(QString const & lhs, BtStringConst const & rhs);
 
+/**
+ * \brief Hash of a \c BtStringConst is the hash of its (interned) pointer, so we never need to look at the characters
+ */
+namespace std {
+   template<> struct hash<BtStringConst> {
+      std::size_t operator()(BtStringConst const & btStringConst) const noexcept {
+         return std::hash<char const *>{}(*btStringConst);
+      }
+   };
+}
+
 #endif
@@ -0,0 +1,336 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * utils/Compression.cpp is part of Brewtarget, and is copyright the following authors 2024:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#include "utils/Compression.h"
+
+#include <algorithm>
+#include <array>
+
+#include <QObject>
+
+#include <zlib.h>
+
+#include "Logging.h"
+#include "utils/BtException.h"
+
+namespace {
+   constexpr qint64 chunkSize = 64 * 1024;
+
+   // Adding 16 to the window size tells zlib to expect or write a gzip header and trailer; making it negative means
+   // raw deflate data with no header or trailer at all (which is what is in a zip archive).
+   constexpr int gzipWindowBits       = 16 + MAX_WBITS;
+   constexpr int rawDeflateWindowBits = -MAX_WBITS;
+
+   // See https://pkware.cachefly.net/webdocs/casestudies/APPNOTE.TXT for the zip file format
+   constexpr quint32 zipLocalHeaderSignature       = 0x04034b50;
+   constexpr quint32 zipCentralDirectorySignature  = 0x02014b50;
+   constexpr quint32 zipEndOfCentralDirSignature   = 0x06054b50;
+   constexpr int     zipLocalHeaderSize            = 30;
+   constexpr int     zipCentralDirectoryHeaderSize = 46;
+   constexpr int     zipEndOfCentralDirSize        = 22;
+   // The end of central directory record can be followed by a comment of up to this many bytes
+   constexpr int     zipMaxCommentSize             = 0xFFFF;
+   constexpr quint16 zipMethodStored               = 0;
+   constexpr quint16 zipMethodDeflated             = 8;
+   constexpr quint16 zipFlagEncrypted              = 0x0001;
+
+   [[noreturn]] void throwError(QString const & name, QString const & problem) {
+      qCWarning(Logging::serialization) << Q_FUNC_INFO << "Error reading" << name << ":" << problem;
+      throw BtException(QObject::tr("Could not decompress %1 (%2)").arg(name, problem));
+   }
+
+   //! Zip archives store everything little-endian
+   template<typename T>
+   T readLittleEndian(QByteArray const & data, int const offset) {
+      T value = 0;
+      for (int ii = static_cast<int>(sizeof(T)) - 1; ii >= 0; --ii) {
+         value = static_cast<T>((value << 8) | static_cast<quint8>(data.at(offset + ii)));
+      }
+      return value;
+   }
+
+   /**
+    * \brief Makes sure \c inflateEnd gets called however we leave \c inflateFrom
+    */
+   struct InflateStream {
+      InflateStream(QString const & name, int const windowBits) : stream{} {
+         if (inflateInit2(&this->stream, windowBits) != Z_OK) {
+            throwError(name, "could not initialise zlib");
+         }
+         return;
+      }
+      ~InflateStream() {
+         inflateEnd(&this->stream);
+         return;
+      }
+      z_stream stream;
+   };
+
+   /**
+    * \brief Decompress from \c input until the end of the compressed stream, reading at most \c inputSize bytes (or, if
+    *        \c inputSize is negative, as many as it takes).
+    *
+    * \param expectedSize If known, the size of the output, so we can allocate it in one go
+    */
+   QByteArray inflateFrom(QIODevice & input,
+                          qint64 inputSize,
+                          int const windowBits,
+                          QString const & name,
+                          qint64 const expectedSize = 0) {
+      InflateStream inflateStream{name, windowBits};
+      z_stream & stream = inflateStream.stream;
+
+      QByteArray output;
+      if (expectedSize > 0) {
+         output.reserve(static_cast<int>(expectedSize));
+      }
+      QByteArray inputChunk;
+      std::array<char, chunkSize> outputChunk;
+      // If zlib filled the output chunk last time round, it may still have more output without needing more input
+      bool outputChunkFilled = false;
+      for (int result = Z_OK; result != Z_STREAM_END; ) {
+         if (stream.avail_in == 0 && !outputChunkFilled) {
+            inputChunk = input.read(inputSize < 0 ? chunkSize : std::min(inputSize, chunkSize));
+            if (inputChunk.isEmpty()) {
+               throwError(name, "data is truncated");
+            }
+            if (inputSize >= 0) {
+               inputSize -= inputChunk.size();
+            }
+            stream.next_in  = reinterpret_cast<Bytef *>(inputChunk.data());
+            stream.avail_in = static_cast<uInt>(inputChunk.size());
+         }
+         stream.next_out  = reinterpret_cast<Bytef *>(outputChunk.data());
+         stream.avail_out = static_cast<uInt>(outputChunk.size());
+         result = inflate(&stream, Z_NO_FLUSH);
+         // Z_BUF_ERROR just means zlib couldn't make any progress without more input, so isn't an error here
+         if (result != Z_OK && result != Z_STREAM_END && result != Z_BUF_ERROR) {
+            throwError(name, stream.msg ? QString{stream.msg} : QString::number(result));
+         }
+         outputChunkFilled = (stream.avail_out == 0);
+         output.append(outputChunk.data(), static_cast<int>(outputChunk.size() - stream.avail_out));
+      }
+      return output;
+   }
+}
+
+bool Compression::isGzip(QByteArray const & data) {
+   return data.size() >= 2 && static_cast<quint8>(data.at(0)) == 0x1f && static_cast<quint8>(data.at(1)) == 0x8b;
+}
+
+[[nodiscard]] QByteArray Compression::gunzip(QIODevice & input, QString const & name) {
+   return inflateFrom(input, -1, gzipWindowBits, name);
+}
+
+[[nodiscard]] QVector<Compression::ZipEntry> Compression::zipEntries(QString const & archiveName) {
+   QFile archive{archiveName};
+   if (!archive.open(QIODevice::ReadOnly)) {
+      throwError(archiveName, archive.errorString());
+   }
+
+   //
+   // The central directory, which lists all the entries, is found via the "end of central directory" record at the
+   // end of the file.  Because that record can be followed by a comment, we have to search back for its signature.
+   //
+   qint64 const tailSize = std::min<qint64>(archive.size(), zipEndOfCentralDirSize + zipMaxCommentSize);
+   if (tailSize < zipEndOfCentralDirSize || !archive.seek(archive.size() - tailSize)) {
+      throwError(archiveName, "not a zip archive");
+   }
+   QByteArray const tail = archive.read(tailSize);
+   int endOfCentralDir = -1;
+   for (int ii = tail.size() - zipEndOfCentralDirSize; ii >= 0; --ii) {
+      if (readLittleEndian<quint32>(tail, ii) == zipEndOfCentralDirSignature) {
+         endOfCentralDir = ii;
+         break;
+      }
+   }
+   if (endOfCentralDir < 0) {
+      throwError(archiveName, "not a zip archive");
+   }
+   quint16 const numEntries       = readLittleEndian<quint16>(tail, endOfCentralDir + 10);
+   quint32 const centralDirSize   = readLittleEndian<quint32>(tail, endOfCentralDir + 12);
+   quint32 const centralDirOffset = readLittleEndian<quint32>(tail, endOfCentralDir + 16);
+   if (numEntries == 0xFFFF || centralDirOffset == 0xFFFFFFFF) {
+      throwError(archiveName, "zip64 archives are not supported");
+   }
+
+   if (!archive.seek(centralDirOffset)) {
+      throwError(archiveName, "central directory is missing");
+   }
+   QByteArray const centralDir = archive.read(centralDirSize);
+   QVector<Compression::ZipEntry> entries;
+   entries.reserve(numEntries);
+   for (int offset = 0, ii = 0; ii < numEntries; ++ii) {
+      if (offset + zipCentralDirectoryHeaderSize > centralDir.size() ||
+          readLittleEndian<quint32>(centralDir, offset) != zipCentralDirectorySignature) {
+         throwError(archiveName, "central directory is corrupt");
+      }
+      quint16 const flags         = readLittleEndian<quint16>(centralDir, offset +  8);
+      quint16 const nameLength    = readLittleEndian<quint16>(centralDir, offset + 28);
+      quint16 const extraLength   = readLittleEndian<quint16>(centralDir, offset + 30);
+      quint16 const commentLength = readLittleEndian<quint16>(centralDir, offset + 32);
+      if (offset + zipCentralDirectoryHeaderSize + nameLength > centralDir.size()) {
+         throwError(archiveName, "central directory is corrupt");
+      }
+      Compression::ZipEntry entry{
+         .name              = QString::fromUtf8(centralDir.mid(offset + zipCentralDirectoryHeaderSize, nameLength)),
+         .method            = readLittleEndian<quint16>(centralDir, offset + 10),
+         .checksum          = readLittleEndian<quint32>(centralDir, offset + 16),
+         .compressedSize    = readLittleEndian<quint32>(centralDir, offset + 20),
+         .uncompressedSize  = readLittleEndian<quint32>(centralDir, offset + 24),
+         .localHeaderOffset = readLittleEndian<quint32>(centralDir, offset + 42),
+      };
+      offset += zipCentralDirectoryHeaderSize + nameLength + extraLength + commentLength;
+      if (entry.name.endsWith('/')) {
+         continue;
+      }
+      if (flags & zipFlagEncrypted) {
+         // Mark it as something we can't read, rather than leave it out, so that the user gets told about it
+         entry.method = 0xFFFF;
+      }
+      entries.append(entry);
+   }
+   return entries;
+}
+
+[[nodiscard]] QByteArray Compression::readZipEntry(QString const & archiveName,
+                                                   Compression::ZipEntry const & entry) {
+   QString const name = QString{"%1/%2"}.arg(archiveName, entry.name);
+   if (entry.method != zipMethodStored && entry.method != zipMethodDeflated) {
+      throwError(name, "unsupported compression method or encryption");
+   }
+
+   QFile archive{archiveName};
+   if (!archive.open(QIODevice::ReadOnly)) {
+      throwError(name, archive.errorString());
+   }
+   //
+   // The local header repeats most of what's in the central directory, but its name and extra fields can have
+   // different lengths, so we need to read it to find where the data starts.
+   //
+   QByteArray const localHeader = archive.seek(entry.localHeaderOffset) ? archive.read(zipLocalHeaderSize) :
+                                                                         QByteArray{};
+   if (localHeader.size() < zipLocalHeaderSize ||
+       readLittleEndian<quint32>(localHeader, 0) != zipLocalHeaderSignature) {
+      throwError(name, "local header is corrupt");
+   }
+   qint64 const dataOffset = static_cast<qint64>(entry.localHeaderOffset) + zipLocalHeaderSize +
+                             readLittleEndian<quint16>(localHeader, 26) + readLittleEndian<quint16>(localHeader, 28);
+   if (!archive.seek(dataOffset)) {
+      throwError(name, "data is truncated");
+   }
+
+   QByteArray contents;
+   if (entry.method == zipMethodStored) {
+      contents = archive.read(entry.compressedSize);
+   } else {
+      contents = inflateFrom(archive, entry.compressedSize, rawDeflateWindowBits, name, entry.uncompressedSize);
+   }
+   if (static_cast<quint32>(contents.size()) != entry.uncompressedSize ||
+       crc32(0, reinterpret_cast<Bytef const *>(contents.constData()), static_cast<uInt>(contents.size())) !=
+          entry.checksum) {
+      throwError(name, "data is corrupt");
+   }
+   return contents;
+}
+
+class Compression::GzipFile::impl {
+public:
+   impl() : m_stream{}, m_streamOpen{false} {
+      return;
+   }
+
+   ~impl() = default;
+
+   z_stream m_stream;
+   bool m_streamOpen;
+};
+
+Compression::GzipFile::GzipFile(QString const & name) : QFile{name}, pimpl{std::make_unique<impl>()} {
+   return;
+}
+
+Compression::GzipFile::~GzipFile() {
+   // The base class destructor would close the file, but too late for us to write the gzip trailer
+   this->close();
+   return;
+}
+
+bool Compression::GzipFile::open(QIODevice::OpenMode mode) {
+   // It's a coding error to try to read from, or append to, one of these
+   if (mode & (QIODevice::ReadOnly | QIODevice::Append)) {
+      qCritical() << Q_FUNC_INFO << "GzipFile only supports writing, not" << mode;
+      Q_ASSERT(false);
+      return false;
+   }
+   if (!this->QFile::open(mode)) {
+      return false;
+   }
+   if (deflateInit2(&this->pimpl->m_stream,
+                    Z_DEFAULT_COMPRESSION,
+                    Z_DEFLATED,
+                    gzipWindowBits,
+                    8, // Default memory level
+                    Z_DEFAULT_STRATEGY) != Z_OK) {
+      qCWarning(Logging::serialization) << Q_FUNC_INFO << "Could not initialise zlib for" << this->fileName();
+      this->QFile::close();
+      return false;
+   }
+   this->pimpl->m_streamOpen = true;
+   return true;
+}
+
+void Compression::GzipFile::close() {
+   if (this->pimpl->m_streamOpen) {
+      // Flush whatever zlib is still holding on to, plus the gzip trailer
+      this->writeData(nullptr, 0);
+      deflateEnd(&this->pimpl->m_stream);
+      this->pimpl->m_streamOpen = false;
+   }
+   this->QFile::close();
+   return;
+}
+
+qint64 Compression::GzipFile::readData([[maybe_unused]] char * data, [[maybe_unused]] qint64 maxSize) {
+   return -1;
+}
+
+qint64 Compression::GzipFile::writeData(char const * data, qint64 maxSize) {
+   if (!this->pimpl->m_streamOpen) {
+      return -1;
+   }
+   //
+   // A call with no data is how close() tells us to finish off the stream.  Otherwise, zlib decides when it has enough
+   // input to be worth writing anything out.
+   //
+   z_stream & stream = this->pimpl->m_stream;
+   int const flush = (data ? Z_NO_FLUSH : Z_FINISH);
+   // zlib doesn't modify its input, but, for compatibility with old C code, next_in isn't a pointer to const
+   stream.next_in  = reinterpret_cast<Bytef *>(const_cast<char *>(data));
+   stream.avail_in = static_cast<uInt>(maxSize);
+   std::array<char, chunkSize> outputChunk;
+   int result = Z_OK;
+   do {
+      stream.next_out  = reinterpret_cast<Bytef *>(outputChunk.data());
+      stream.avail_out = static_cast<uInt>(outputChunk.size());
+      result = deflate(&stream, flush);
+      Q_ASSERT(result != Z_STREAM_ERROR);
+      qint64 const compressedSize = static_cast<qint64>(outputChunk.size() - stream.avail_out);
+      if (compressedSize > 0 && this->QFile::writeData(outputChunk.data(), compressedSize) != compressedSize) {
+         return -1;
+      }
+   } while (flush == Z_FINISH ? result != Z_STREAM_END : stream.avail_out == 0);
+   return maxSize;
+}
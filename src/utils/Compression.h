@@ -0,0 +1,106 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * utils/Compression.h is part of Brewtarget, and is copyright the following authors 2024:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#ifndef UTILS_COMPRESSION_H
+#define UTILS_COMPRESSION_H
+#pragma once
+
+#include <memory>
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+#include <QVector>
+
+/**
+ * \brief Reading gzip files and zip archives, and writing gzip files, so that we can import from, and export to,
+ *        compressed files directly (see \c ImportExport).  We use zlib for this, which Qt itself already depends on.
+ *
+ *        Everything here is safe to call from several threads at once, as long as they are not sharing a device.
+ */
+namespace Compression {
+
+   /**
+    * \return \c true if \c data starts with the gzip magic number
+    */
+   bool isGzip(QByteArray const & data);
+
+   /**
+    * \brief Decompress the gzip data read from \c input, which should be positioned at the start of the gzip header.
+    *        The input is read a chunk at a time, so only the output needs to be held in memory.
+    *
+    * \param name Used in error messages
+    *
+    * \throw BtException containing text that can be displayed to the user
+    */
+   [[nodiscard]] QByteArray gunzip(QIODevice & input, QString const & name);
+
+   /**
+    * \brief One entry (ie file) in a zip archive, as listed in the archive's central directory
+    */
+   struct ZipEntry {
+      //! Path of the entry inside the archive, eg "recipes/IPA.xml"
+      QString name;
+      quint16 method;
+      //! CRC-32 of the uncompressed data
+      quint32 checksum;
+      quint32 compressedSize;
+      quint32 uncompressedSize;
+      quint32 localHeaderOffset;
+   };
+
+   /**
+    * \brief List the files in a zip archive.  Directories are omitted.  We only support what is needed for the sorts of
+    *        archives people send each other, ie stored and deflated entries, without encryption or zip64 extensions.
+    *        (Entries with an unsupported method are still listed, but \c readZipEntry will throw for them.)
+    *
+    * \throw BtException containing text that can be displayed to the user
+    */
+   [[nodiscard]] QVector<ZipEntry> zipEntries(QString const & archiveName);
+
+   /**
+    * \brief Decompress one entry of a zip archive into memory.  Each call opens the archive separately, so this can be
+    *        called from several threads at once to read different entries in parallel.
+    *
+    * \throw BtException containing text that can be displayed to the user
+    */
+   [[nodiscard]] QByteArray readZipEntry(QString const & archiveName, ZipEntry const & entry);
+
+   /**
+    * \brief A \c QFile that gzip-compresses everything written to it, so it can be given to code that writes a
+    *        \c QFile (eg \c BeerJson::Exporter or \c BeerXML::toXml) to get compressed output without an intermediate
+    *        file.  Write-only, and must not be seeked (as \c pos counts uncompressed bytes).  The gzip
+    *        trailer is written by \c close, which is also called by the destructor.
+    */
+   class GzipFile : public QFile {
+   public:
+      GzipFile(QString const & name);
+      ~GzipFile();
+
+      bool open(QIODevice::OpenMode mode) override;
+      void close() override;
+
+   protected:
+      qint64 readData(char * data, qint64 maxSize) override;
+      qint64 writeData(char const * data, qint64 maxSize) override;
+
+   private:
+      class impl;
+      std::unique_ptr<impl> pimpl;
+   };
+
+}
+
+#endif
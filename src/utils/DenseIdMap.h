@@ -0,0 +1,167 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * utils/DenseIdMap.h is part of Brewtarget, and is copyright the following authors 2024:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#ifndef UTILS_DENSEIDMAP_H
+#define UTILS_DENSEIDMAP_H
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#include <QList>
+#include <QtGlobal>
+
+/**
+ * \brief Map from integer ID to \c T, for when IDs are (mostly) dense small positive integers, as DB primary keys
+ *        usually are.  Values are stored in a vector indexed by ID, so look-up is a bounds check and an array access,
+ *        and iterating over everything is a walk along contiguous memory.  Iteration is in ascending order of ID.
+ *
+ *        The interface is the subset of \c QHash<int, T> that \c ObjectStore uses, so the two are interchangeable
+ *        there.
+ *
+ *        A "null" \c T (ie one for which \c static_cast<bool> gives \c false, such as an empty \c std::shared_ptr)
+ *        marks an unused slot, so it's a coding error to insert one.
+ */
+template<class T>
+class DenseIdMap {
+public:
+   class const_iterator {
+   public:
+      using iterator_category = std::forward_iterator_tag;
+      using value_type        = T;
+      using difference_type   = std::ptrdiff_t;
+      using pointer           = T const *;
+      using reference         = T const &;
+
+      const_iterator() = default;
+      const_iterator(std::vector<T> const * slots, std::size_t index) : m_slots{slots}, m_index{index} {
+         this->skipUnusedSlots();
+         return;
+      }
+
+      int       key  () const { return static_cast<int>(this->m_index); }
+      reference value() const { return (*this->m_slots)[this->m_index]; }
+      reference operator*() const { return this->value(); }
+      pointer   operator->() const { return &this->value(); }
+
+      const_iterator & operator++() {
+         ++this->m_index;
+         this->skipUnusedSlots();
+         return *this;
+      }
+      const_iterator operator++(int) {
+         const_iterator previous{*this};
+         ++*this;
+         return previous;
+      }
+
+      bool operator==(const_iterator const & rhs) const { return this->m_index == rhs.m_index; }
+      bool operator!=(const_iterator const & rhs) const { return this->m_index != rhs.m_index; }
+
+   private:
+      void skipUnusedSlots() {
+         while (this->m_index < this->m_slots->size() && !(*this->m_slots)[this->m_index]) {
+            ++this->m_index;
+         }
+         return;
+      }
+
+      std::vector<T> const * m_slots = nullptr;
+      std::size_t m_index = 0;
+   };
+
+   DenseIdMap() : m_slots{}, m_size{0} {
+      return;
+   }
+
+   int size() const { return this->m_size; }
+   bool isEmpty() const { return this->m_size == 0; }
+
+   bool contains(int const id) const {
+      return id >= 0 && static_cast<std::size_t>(id) < this->m_slots.size() && this->m_slots[id];
+   }
+
+   //! \return Value for \c id, or a default-constructed \c T if there isn't one
+   T value(int const id) const {
+      return this->contains(id) ? this->m_slots[id] : T{};
+   }
+
+   //! As with \c QHash::insert, replaces any existing value for \c id
+   void insert(int const id, T value) {
+      // IDs are never negative, and we can't store null values (see above)
+      Q_ASSERT(id >= 0);
+      Q_ASSERT(value);
+      if (static_cast<std::size_t>(id) >= this->m_slots.size()) {
+         this->m_slots.resize(static_cast<std::size_t>(id) + 1);
+      }
+      if (!this->m_slots[id]) {
+         ++this->m_size;
+      }
+      this->m_slots[id] = std::move(value);
+      return;
+   }
+
+   //! Removes the value for \c id and returns it, or returns a default-constructed \c T if there isn't one
+   T take(int const id) {
+      if (!this->contains(id)) {
+         return T{};
+      }
+      T value = std::move(this->m_slots[id]);
+      this->m_slots[id] = T{};
+      --this->m_size;
+      return value;
+   }
+
+   //! \return Number of items removed (0 or 1)
+   int remove(int const id) {
+      if (!this->contains(id)) {
+         return 0;
+      }
+      this->m_slots[id] = T{};
+      --this->m_size;
+      return 1;
+   }
+
+   QList<int> keys() const {
+      QList<int> keys;
+      keys.reserve(this->m_size);
+      for (auto ii = this->cbegin(); ii != this->cend(); ++ii) {
+         keys.append(ii.key());
+      }
+      return keys;
+   }
+
+   QList<T> values() const {
+      QList<T> values;
+      values.reserve(this->m_size);
+      for (auto ii = this->cbegin(); ii != this->cend(); ++ii) {
+         values.append(ii.value());
+      }
+      return values;
+   }
+
+   const_iterator cbegin() const { return const_iterator{&this->m_slots, 0}; }
+   const_iterator cend  () const { return const_iterator{&this->m_slots, this->m_slots.size()}; }
+   const_iterator begin () const { return this->cbegin(); }
+   const_iterator end   () const { return this->cend(); }
+
+private:
+   std::vector<T> m_slots;
+   int m_size;
+};
+
+#endif
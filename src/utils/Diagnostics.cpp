@@ -0,0 +1,592 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * utils/Diagnostics.cpp is part of Brewtarget, and is copyright the following authors 2024:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#include "utils/Diagnostics.h"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cmath>
+#include <utility>
+
+#include <QCoreApplication>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QRegularExpression>
+#include <QTextStream>
+#include <QThread>
+
+#include "database/ObjectStoreTyped.h"
+#include "Logging.h"
+#include "utils/StringPool.h"
+
+namespace {
+   // Started when this translation unit is initialised, which is close enough to application start for our purposes
+   struct StartTime {
+      StartTime() {
+         this->timer.start();
+         return;
+      }
+      QElapsedTimer timer;
+   } const startTime;
+
+   QMutex sqlMutex;
+   QHash<QString, Diagnostics::TimedCount> sqlByTable;
+   QHash<QString, Diagnostics::StatementStatistics> sqlByStatement;
+   qint64 slowSqlStatements = 0;
+   std::atomic<int> slowSqlThreshold_ms{Diagnostics::defaultSlowSqlThreshold_ms};
+
+   /**
+    * \brief Statement shapes should be few, but, in case something generates lots of different SQL (eg with a varying
+    *        number of columns), we lump everything after this many into one entry rather than grow without limit.
+    */
+   int constexpr maxStatementShapes = 1000;
+   char const * const otherStatementShapes = "(other statements)";
+
+   //! Number of statements to show in the statement shape table
+   int constexpr numStatementShapesToShow = 20;
+   //! Statements are elided to this many characters in the report
+   int constexpr maxStatementShapeLength = 160;
+
+   std::size_t durationBucketOf(qint64 const duration_ns) {
+      quint64 const duration_us = duration_ns > 0 ? static_cast<quint64>(duration_ns / 1000) : 0;
+      return std::min<std::size_t>(std::bit_width(duration_us), Diagnostics::numDurationBuckets - 1);
+   }
+
+   // Keyed by pointer (to string literal) as there are only a few stages, and this saves constructing a QString for
+   // each calculation done
+   QMutex recalcMutex;
+   QHash<char const *, Diagnostics::TimedCount> recalcByStage;
+
+   // Similarly keyed by pointer to string literal
+   QMutex startupPhaseMutex;
+   QHash<char const *, Diagnostics::TimedCount> startupByPhase;
+
+   //! One run of a startup phase, for \c Diagnostics::startupSummary
+   struct StartupPhaseRun {
+      char const * phaseName;
+      qint64       start_ns;
+      qint64       duration_ns;
+      int          depth;
+   };
+   /**
+    * \brief Some phases (eg loading translations) can also happen after startup, so we stop remembering individual
+    *        runs after this many rather than grow without limit.  (They still go into \c startupByPhase.)
+    */
+   int constexpr maxStartupPhaseRuns = 200;
+   // Protected by startupPhaseMutex
+   QVector<StartupPhaseRun> startupPhaseRuns;
+
+   // Only used on the GUI thread, so does not need a mutex
+   std::function<void(char const *)> startupPhaseListener;
+
+   thread_local int startupPhaseDepth = 0;
+
+   std::atomic<qint64> signalsEmitted{0};
+
+   //! What \c Diagnostics::recordSignalEmitted is told about a signal
+   struct SignalSource {
+      char const * senderClass;
+      char const * signalName;
+      char const * propertyName;
+
+      bool operator==(SignalSource const & other) const = default;
+   };
+
+   uint qHash(SignalSource const & source, uint const seed = 0) {
+      return ::qHash(source.senderClass, seed) ^ (::qHash(source.signalName, seed) * 31) ^
+             (::qHash(source.propertyName, seed) * 131);
+   }
+
+   int constexpr numSignalSourcesToShow = 15;
+
+   QMutex signalMutex;
+   QHash<SignalSource, qint64> signalsBySource;
+   // Signals emitted since the event loop last got control
+   QHash<SignalSource, qint64> currentSignalBurst;
+   qint64 currentSignalBurstSize = 0;
+   qint64 lastSignalBurstSize    = 0;
+   QHash<SignalSource, qint64> biggestSignalBurst;
+   qint64 biggestSignalBurstSize = 0;
+
+   //! Called (via the event loop) once the signals of the current burst have been dealt with
+   void endSignalBurst() {
+      QMutexLocker locker(&signalMutex);
+      lastSignalBurstSize = currentSignalBurstSize;
+      if (currentSignalBurstSize > biggestSignalBurstSize) {
+         biggestSignalBurstSize = currentSignalBurstSize;
+         biggestSignalBurst = std::exchange(currentSignalBurst, {});
+      } else {
+         currentSignalBurst.clear();
+      }
+      currentSignalBurstSize = 0;
+      return;
+   }
+
+   /**
+    * \brief Sums the counts in \c bySource by the text of the source.  (Because callers just pass us pointers, the
+    *        same source can, in principle, be recorded under more than one key.)
+    */
+   QMap<QString, qint64> signalCountsByText(QHash<SignalSource, qint64> const & bySource) {
+      QMap<QString, qint64> counts;
+      for (auto ii = bySource.cbegin(); ii != bySource.cend(); ++ii) {
+         SignalSource const & source = ii.key();
+         QString text = QString{"%1 %2"}.arg(source.senderClass, source.signalName);
+         if (source.propertyName) {
+            text += QString{" %1"}.arg(source.propertyName);
+         }
+         counts[text] += ii.value();
+      }
+      return counts;
+   }
+
+   /**
+    * \brief Formats \c count of something over \c interval_ms as a rate
+    */
+   QString perSecond(qint64 const count, qint64 const interval_ms) {
+      if (interval_ms <= 0) {
+         return "-";
+      }
+      return QString::number(static_cast<double>(count) * 1000.0 / static_cast<double>(interval_ms), 'f', 1);
+   }
+
+   QString meanMicroseconds(Diagnostics::TimedCount const & timedCount) {
+      if (timedCount.count == 0) {
+         return "-";
+      }
+      return QString::number(static_cast<double>(timedCount.total_ns) / static_cast<double>(timedCount.count) / 1000.0,
+                             'f',
+                             1);
+   }
+
+   /**
+    * \brief Writes the table of timed counts (eg SQL statements per table)
+    */
+   void formatTimedCounts(QTextStream & output,
+                          QString const & heading,
+                          QMap<QString, Diagnostics::TimedCount> const & current,
+                          QMap<QString, Diagnostics::TimedCount> const * previous,
+                          qint64 const interval_ms) {
+      output << "\n" << heading << "\n";
+      output << QString{"   %1 %2 %3 %4\n"}.arg("", -32)
+                                             .arg("Count", 10)
+                                             .arg("Mean µs", 10)
+                                             .arg(previous ? "Per sec" : "", 10);
+      Diagnostics::TimedCount total;
+      for (auto ii = current.cbegin(); ii != current.cend(); ++ii) {
+         total.count    += ii.value().count;
+         total.total_ns += ii.value().total_ns;
+         QString rate;
+         if (previous) {
+            rate = perSecond(ii.value().count - previous->value(ii.key()).count, interval_ms);
+         }
+         output << QString{"   %1 %2 %3 %4\n"}.arg(ii.key().isEmpty() ? "(none)" : ii.key(), -32)
+                                                .arg(ii.value().count, 10)
+                                                .arg(meanMicroseconds(ii.value()), 10)
+                                                .arg(rate, 10);
+      }
+      output << QString{"   %1 %2 %3\n"}.arg("Total", -32)
+                                         .arg(total.count, 10)
+                                         .arg(meanMicroseconds(total), 10);
+      return;
+   }
+
+   /**
+    * \brief Writes the table of the signal sources (see \c Diagnostics::recordSignalEmitted) with the highest counts
+    */
+   void formatSignalCounts(QTextStream & output,
+                           QString const & heading,
+                           QMap<QString, qint64> const & current,
+                           QMap<QString, qint64> const * previous,
+                           qint64 const interval_ms) {
+      QVector<QMap<QString, qint64>::const_iterator> sources;
+      sources.reserve(current.size());
+      for (auto ii = current.cbegin(); ii != current.cend(); ++ii) {
+         sources.append(ii);
+      }
+      std::sort(sources.begin(), sources.end(), [](auto const & lhs, auto const & rhs) {
+         return lhs.value() > rhs.value();
+      });
+      if (sources.size() > numSignalSourcesToShow) {
+         sources.resize(numSignalSourcesToShow);
+      }
+
+      output << "\n" << heading << "\n";
+      output << QString{"   %1 %2  %3\n"}.arg("Count", 10).arg(previous ? "Per sec" : "", 10).arg("Source");
+      for (auto const & source : sources) {
+         QString rate;
+         if (previous) {
+            rate = perSecond(source.value() - previous->value(source.key()), interval_ms);
+         }
+         output << QString{"   %1 %2  %3\n"}.arg(source.value(), 10).arg(rate, 10).arg(source.key());
+      }
+      return;
+   }
+
+   /**
+    * \brief Writes the table of the statement shapes that took the most time in total
+    */
+   void formatStatementStatistics(QTextStream & output,
+                                  QMap<QString, Diagnostics::StatementStatistics> const & sqlByStatement) {
+      QVector<QMap<QString, Diagnostics::StatementStatistics>::const_iterator> statements;
+      statements.reserve(sqlByStatement.size());
+      for (auto ii = sqlByStatement.cbegin(); ii != sqlByStatement.cend(); ++ii) {
+         statements.append(ii);
+      }
+      std::sort(statements.begin(), statements.end(), [](auto const & lhs, auto const & rhs) {
+         return lhs.value().timedCount.total_ns > rhs.value().timedCount.total_ns;
+      });
+      if (statements.size() > numStatementShapesToShow) {
+         statements.resize(numStatementShapesToShow);
+      }
+
+      output << "\nSQL statements taking the most time (percentiles are upper bounds)\n";
+      output << QString{"   %1 %2 %3 %4 %5 %6  %7\n"}.arg("Count", 10)
+                                                      .arg("Mean µs", 10)
+                                                      .arg("p50 µs", 8)
+                                                      .arg("p95 µs", 8)
+                                                      .arg("p99 µs", 8)
+                                                      .arg("Max µs", 10)
+                                                      .arg("Statement");
+      for (auto const & statement : statements) {
+         Diagnostics::StatementStatistics const & statistics = statement.value();
+         QString shape = statement.key();
+         if (shape.size() > maxStatementShapeLength) {
+            shape = shape.left(maxStatementShapeLength - 3) + "...";
+         }
+         output << QString{"   %1 %2 %3 %4 %5 %6  %7\n"}.arg(statistics.timedCount.count, 10)
+                                                         .arg(meanMicroseconds(statistics.timedCount), 10)
+                                                         .arg(statistics.percentile_us(0.50), 8)
+                                                         .arg(statistics.percentile_us(0.95), 8)
+                                                         .arg(statistics.percentile_us(0.99), 8)
+                                                         .arg(statistics.max_ns / 1000, 10)
+                                                         .arg(shape);
+      }
+      return;
+   }
+}
+
+void Diagnostics::setSlowSqlThreshold_ms(int const threshold_ms) {
+   slowSqlThreshold_ms.store(std::max(threshold_ms, 0), std::memory_order_relaxed);
+   return;
+}
+
+bool Diagnostics::recordSqlStatement(QString const & tableName,
+                                     QString const & statementShape,
+                                     qint64 const duration_ns) {
+   int const threshold_ms = slowSqlThreshold_ms.load(std::memory_order_relaxed);
+   bool const isSlow = threshold_ms > 0 && duration_ns >= static_cast<qint64>(threshold_ms) * 1000000;
+
+   QMutexLocker locker(&sqlMutex);
+   Diagnostics::TimedCount & timedCount = sqlByTable[tableName];
+   ++timedCount.count;
+   timedCount.total_ns += duration_ns;
+
+   auto statementStatistics = sqlByStatement.find(statementShape);
+   if (statementStatistics == sqlByStatement.end()) {
+      statementStatistics = sqlByStatement.size() < maxStatementShapes ?
+         sqlByStatement.insert(statementShape, Diagnostics::StatementStatistics{}) :
+         sqlByStatement.find(otherStatementShapes);
+      if (statementStatistics == sqlByStatement.end()) {
+         statementStatistics = sqlByStatement.insert(otherStatementShapes, Diagnostics::StatementStatistics{});
+      }
+   }
+   ++statementStatistics->timedCount.count;
+   statementStatistics->timedCount.total_ns += duration_ns;
+   statementStatistics->max_ns = std::max(statementStatistics->max_ns, duration_ns);
+   ++statementStatistics->durationBuckets[durationBucketOf(duration_ns)];
+
+   if (isSlow) {
+      ++slowSqlStatements;
+   }
+   return isSlow;
+}
+
+QString Diagnostics::statementShapeOf(QString const & sql) {
+   // The look-behind on placeholders stops us treating PostgreSQL casts (eg "::text") as placeholders
+   static QRegularExpression const stringLiterals   {"'(?:[^']|'')*'"};
+   static QRegularExpression const placeholders     {"(?<![:\\w]):[A-Za-z_]\\w*"};
+   static QRegularExpression const numericLiterals  {"\\b\\d+(?:\\.\\d+)?\\b"};
+   static QRegularExpression const lists            {"\\?(?:\\s*,\\s*\\?)+"};
+   static QRegularExpression const whitespace       {"\\s+"};
+   QString shape{sql};
+   shape.replace(stringLiterals , "?");
+   shape.replace(placeholders   , "?");
+   shape.replace(numericLiterals, "?");
+   shape.replace(lists          , "?, ...");
+   shape.replace(whitespace     , " ");
+   return shape.trimmed();
+}
+
+qint64 Diagnostics::StatementStatistics::percentile_us(double const fraction) const {
+   qint64 const target = static_cast<qint64>(std::ceil(fraction * static_cast<double>(this->timedCount.count)));
+   qint64 cumulative = 0;
+   for (std::size_t ii = 0; ii < numDurationBuckets; ++ii) {
+      cumulative += this->durationBuckets[ii];
+      if (cumulative >= target) {
+         return qint64{1} << ii;
+      }
+   }
+   return qint64{1} << (numDurationBuckets - 1);
+}
+
+QString Diagnostics::tableNameFromSql(QString const & sql) {
+   static QRegularExpression const tableNameRegExp{"\\b(?:FROM|INTO|UPDATE)\\s+\"?(\\w+)",
+                                                   QRegularExpression::CaseInsensitiveOption};
+   QRegularExpressionMatch const match = tableNameRegExp.match(sql);
+   if (!match.hasMatch()) {
+      return "";
+   }
+   return match.captured(1);
+}
+
+void Diagnostics::recordRecalc(char const * stageName, qint64 const duration_ns) {
+   QMutexLocker locker(&recalcMutex);
+   Diagnostics::TimedCount & timedCount = recalcByStage[stageName];
+   ++timedCount.count;
+   timedCount.total_ns += duration_ns;
+   return;
+}
+
+void Diagnostics::recordStartupPhase(char const * phaseName, qint64 const duration_ns) {
+   QMutexLocker locker(&startupPhaseMutex);
+   Diagnostics::TimedCount & timedCount = startupByPhase[phaseName];
+   ++timedCount.count;
+   timedCount.total_ns += duration_ns;
+   return;
+}
+
+void Diagnostics::setStartupPhaseListener(std::function<void(char const * phaseName)> listener) {
+   startupPhaseListener = std::move(listener);
+   return;
+}
+
+QString Diagnostics::startupSummary() {
+   QVector<StartupPhaseRun> runs;
+   {
+      QMutexLocker locker(&startupPhaseMutex);
+      runs = startupPhaseRuns;
+   }
+   // Runs are recorded as they finish, so an outer phase comes after the ones inside it until we sort by start time
+   std::stable_sort(
+      runs.begin(),
+      runs.end(),
+      [](StartupPhaseRun const & lhs, StartupPhaseRun const & rhs) { return lhs.start_ns < rhs.start_ns; }
+   );
+
+   QString summary = QString{"Startup took %1 ms"}.arg(startTime.timer.elapsed());
+   int previousDepth = -1;
+   for (StartupPhaseRun const & run : runs) {
+      if (previousDepth < 0) {
+         summary += ": ";
+      } else if (run.depth > previousDepth) {
+         summary += " (";
+      } else {
+         for (int ii = run.depth; ii < previousDepth; ++ii) {
+            summary += ")";
+         }
+         summary += ", ";
+      }
+      summary += QString{"%1 %2 ms"}.arg(run.phaseName).arg(run.duration_ns / 1000000);
+      previousDepth = run.depth;
+   }
+   for (int ii = 0; ii < previousDepth; ++ii) {
+      summary += ")";
+   }
+   return summary;
+}
+
+void Diagnostics::recordSignalEmitted(char const * senderClass, char const * signalName, char const * propertyName) {
+   signalsEmitted.fetch_add(1, std::memory_order_relaxed);
+   SignalSource const source{senderClass, signalName, propertyName};
+   bool startedBurst = false;
+   {
+      QMutexLocker locker(&signalMutex);
+      ++signalsBySource[source];
+      ++currentSignalBurst[source];
+      startedBurst = (currentSignalBurstSize++ == 0);
+   }
+   //
+   // A queued call gets run once the event loop has dealt with whatever it was doing when the burst started, which
+   // ends the burst.  If there is no event loop (eg in batch mode), bursts just never end, which doesn't matter.
+   //
+   if (startedBurst) {
+      if (QCoreApplication * application = QCoreApplication::instance()) {
+         QMetaObject::invokeMethod(application, &endSignalBurst, Qt::QueuedConnection);
+      }
+   }
+   return;
+}
+
+Diagnostics::ScopedRecalcTimer::ScopedRecalcTimer(char const * stageName) : m_stageName{stageName}, m_timer{} {
+   this->m_timer.start();
+   return;
+}
+
+Diagnostics::ScopedRecalcTimer::~ScopedRecalcTimer() {
+   Diagnostics::recordRecalc(this->m_stageName, this->m_timer.nsecsElapsed());
+   return;
+}
+
+Diagnostics::ScopedStartupPhaseTimer::ScopedStartupPhaseTimer(char const * phaseName) :
+   m_phaseName{phaseName},
+   m_span{phaseName},
+   m_depth{startupPhaseDepth++},
+   m_start_ns{0} {
+   QCoreApplication const * application = QCoreApplication::instance();
+   if (startupPhaseListener && application && QThread::currentThread() == application->thread()) {
+      startupPhaseListener(phaseName);
+   }
+   // Start timing after the listener, so that repainting the splash screen doesn't count towards the phase
+   this->m_start_ns = startTime.timer.nsecsElapsed();
+   return;
+}
+
+Diagnostics::ScopedStartupPhaseTimer::~ScopedStartupPhaseTimer() {
+   qint64 const duration_ns = startTime.timer.nsecsElapsed() - this->m_start_ns;
+   --startupPhaseDepth;
+   Diagnostics::recordStartupPhase(this->m_phaseName, duration_ns);
+   QMutexLocker locker(&startupPhaseMutex);
+   if (startupPhaseRuns.size() < maxStartupPhaseRuns) {
+      startupPhaseRuns.append(StartupPhaseRun{this->m_phaseName, this->m_start_ns, duration_ns, this->m_depth});
+   }
+   return;
+}
+
+Diagnostics::Snapshot Diagnostics::takeSnapshot() {
+   Diagnostics::Snapshot snapshot;
+   snapshot.taken_ms = startTime.timer.elapsed();
+
+   for (ObjectStore const * objectStore : GetAllObjectStores()) {
+      snapshot.stores.append(Diagnostics::StoreStatistics{*objectStore->primaryTableName(),
+                                                          objectStore->numCachedObjects(),
+                                                          objectStore->estimatedCacheBytes()});
+   }
+
+   {
+      QMutexLocker locker(&sqlMutex);
+      for (auto ii = sqlByTable.cbegin(); ii != sqlByTable.cend(); ++ii) {
+         snapshot.sqlByTable.insert(ii.key(), ii.value());
+      }
+      for (auto ii = sqlByStatement.cbegin(); ii != sqlByStatement.cend(); ++ii) {
+         snapshot.sqlByStatement.insert(ii.key(), ii.value());
+      }
+      snapshot.slowSqlStatements = slowSqlStatements;
+   }
+   snapshot.slowSqlThreshold_ms = slowSqlThreshold_ms.load(std::memory_order_relaxed);
+   {
+      QMutexLocker locker(&recalcMutex);
+      for (auto ii = recalcByStage.cbegin(); ii != recalcByStage.cend(); ++ii) {
+         snapshot.recalcByStage.insert(QString{ii.key()}, ii.value());
+      }
+   }
+   {
+      QMutexLocker locker(&startupPhaseMutex);
+      for (auto ii = startupByPhase.cbegin(); ii != startupByPhase.cend(); ++ii) {
+         snapshot.startupByPhase.insert(QString{ii.key()}, ii.value());
+      }
+   }
+
+   snapshot.signalsEmitted      = signalsEmitted.load(std::memory_order_relaxed);
+   {
+      QMutexLocker locker(&signalMutex);
+      snapshot.signalsBySource            = signalCountsByText(signalsBySource);
+      snapshot.lastSignalBurst            = lastSignalBurstSize;
+      snapshot.biggestSignalBurst         = biggestSignalBurstSize;
+      snapshot.biggestSignalBurstBySource = signalCountsByText(biggestSignalBurst);
+   }
+   StringPool::Statistics const stringPoolStatistics = StringPool::statistics();
+   snapshot.internedStrings     = stringPoolStatistics.distinctStrings;
+   snapshot.internedBytesSaved  = stringPoolStatistics.bytesSaved;
+   snapshot.logMessagesWritten  = Logging::getNumMessagesLogged();
+   snapshot.logMessagesFiltered = Logging::getNumMessagesFiltered();
+   return snapshot;
+}
+
+QString Diagnostics::format(Diagnostics::Snapshot const & current, Diagnostics::Snapshot const * previous) {
+   qint64 const interval_ms = previous ? current.taken_ms - previous->taken_ms : 0;
+
+   QString report;
+   QTextStream output{&report};
+   output << "Up " << QString::number(static_cast<double>(current.taken_ms) / 1000.0, 'f', 1) << "s\n";
+
+   output << "\nObject stores\n";
+   output << QString{"   %1 %2 %3\n"}.arg("", -32).arg("Objects", 10).arg("Est. KiB", 10);
+   int totalObjects = 0;
+   std::size_t totalBytes = 0;
+   for (Diagnostics::StoreStatistics const & store : current.stores) {
+      totalObjects += store.numObjects;
+      totalBytes   += store.estimatedBytes;
+      output << QString{"   %1 %2 %3\n"}.arg(store.tableName, -32)
+                                         .arg(store.numObjects, 10)
+                                         .arg(static_cast<qulonglong>(store.estimatedBytes / 1024), 10);
+   }
+   output << QString{"   %1 %2 %3\n"}.arg("Total", -32)
+                                      .arg(totalObjects, 10)
+                                      .arg(static_cast<qulonglong>(totalBytes / 1024), 10);
+
+   formatTimedCounts(output,
+                     "SQL statements by table",
+                     current.sqlByTable,
+                     previous ? &previous->sqlByTable : nullptr,
+                     interval_ms);
+   formatStatementStatistics(output, current.sqlByStatement);
+   output << "\nSlow SQL statements";
+   if (current.slowSqlThreshold_ms > 0) {
+      output << " (over " << current.slowSqlThreshold_ms << " ms, see log for details): " << current.slowSqlStatements;
+   } else {
+      output << ": not being looked for";
+   }
+   output << "\n";
+
+   formatTimedCounts(output,
+                     "Recipe calculations by stage",
+                     current.recalcByStage,
+                     previous ? &previous->recalcByStage : nullptr,
+                     interval_ms);
+
+   formatTimedCounts(output,
+                     "Startup phases",
+                     current.startupByPhase,
+                     previous ? &previous->startupByPhase : nullptr,
+                     interval_ms);
+
+   output << "\nSignals emitted: " << current.signalsEmitted;
+   if (previous) {
+      output << " (" << perSecond(current.signalsEmitted - previous->signalsEmitted, interval_ms) << "/s)";
+   }
+   formatSignalCounts(output,
+                      "Signals by sender, signal and property",
+                      current.signalsBySource,
+                      previous ? &previous->signalsBySource : nullptr,
+                      interval_ms);
+   output << "\nSignals in last burst: " << current.lastSignalBurst << "\n";
+   formatSignalCounts(output,
+                      QString{"Biggest burst of signals: %1"}.arg(current.biggestSignalBurst),
+                      current.biggestSignalBurstBySource,
+                      nullptr,
+                      0);
+
+   output << "\nInterned strings: " << current.internedStrings << " (saving " <<
+             current.internedBytesSaved / 1024 << " KiB)";
+   output << "\nLog messages written: " << current.logMessagesWritten;
+   if (previous) {
+      output << " (" << perSecond(current.logMessagesWritten - previous->logMessagesWritten, interval_ms) << "/s)";
+   }
+   output << "\nLog messages below logging level: " << current.logMessagesFiltered << "\n";
+   output.flush();
+   return report;
+}
@@ -0,0 +1,228 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * utils/Diagnostics.h is part of Brewtarget, and is copyright the following authors 2024:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#ifndef UTILS_DIAGNOSTICS_H
+#define UTILS_DIAGNOSTICS_H
+#pragma once
+
+#include <array>
+#include <functional>
+
+#include <QElapsedTimer>
+#include <QMap>
+#include <QString>
+#include <QVector>
+
+#include "utils/Tracing.h"
+
+/**
+ * \brief Always-on counters that tell maintainers (and anyone else diagnosing a field report) what the application is
+ *        doing: how many objects are cached, how much SQL we are running and how long it takes, how often recipes are
+ *        being recalculated, how many change signals are being emitted (and by what), how much is being logged, and
+ *        how long the one-off bits of startup work (such as loading translations and fonts) took.
+ *
+ *        Recording is cheap enough to leave on all the time: an atomic increment for log messages, and a short
+ *        mutex-protected update for signals, SQL statements and recalculation stages (each of which costs far more
+ *        than the update).
+ *
+ *        The counters can be viewed live in \c DiagnosticsDialog, or dumped to stdout at exit with the --diagnostics
+ *        command-line option (which also works in batch mode).
+ *
+ *        As well as totals per table, SQL statements are timed per "shape" (see \c statementShapeOf), with a histogram
+ *        of durations from which we give approximate percentiles.  Any statement that takes longer than the slow-query
+ *        threshold is logged, along with its bound values, by \c BtSqlQuery::exec.
+ *
+ *        Signals are counted per sender class, signal and property, both in total and per "burst", ie all the signals
+ *        emitted between two returns to the event loop, which is usually the cascade that follows one user action.
+ *        The biggest burst so far is kept, so that feedback loops (where a change to one object leads to a change to
+ *        another that leads back to the first) stand out.
+ *
+ *        Startup phases are marked with \c ScopedStartupPhaseTimer, which, as well as adding to the counters, shows
+ *        the phase on the splash screen (via \c setStartupPhaseListener), records it as a span for \c Tracing, and
+ *        remembers it for the one-line \c startupSummary that we log once the main window is up.
+ */
+namespace Diagnostics {
+
+   //! Used if neither the slowSqlThresholdMs setting nor the --slow-sql-ms command-line option says otherwise
+   int constexpr defaultSlowSqlThreshold_ms = 200;
+
+   /**
+    * \brief Set how long, in milliseconds, a SQL statement has to take before it counts as slow.  0 means none do.
+    */
+   void setSlowSqlThreshold_ms(int const threshold_ms);
+
+   /**
+    * \brief Record one SQL statement having been executed
+    *
+    * \param tableName As returned by \c tableNameFromSql
+    * \param statementShape As returned by \c statementShapeOf
+    *
+    * \return \c true if the statement was slow (see \c setSlowSqlThreshold_ms), in which case it is up to the caller
+    *         to log it, as only the caller knows the bound values
+    */
+   bool recordSqlStatement(QString const & tableName, QString const & statementShape, qint64 const duration_ns);
+
+   /**
+    * \return \c sql with anything that varies from one execution to the next stripped out, so that we can group
+    *         statistics by the "shape" of a statement.  String and numeric literals and bind-value placeholders all
+    *         become \c ?, lists of them (eg in an IN clause) become \c "?, ...", and runs of whitespace become one
+    *         space.  Worked out once per query we prepare, rather than every time it is executed.
+    */
+   QString statementShapeOf(QString const & sql);
+
+   /**
+    * \return Our best guess at the (main) table that a SQL statement acts on, ie the first name after FROM, INTO or
+    *         UPDATE, or an empty string if there isn't one (eg for PRAGMA or BEGIN statements).  This is only for
+    *         grouping statistics, so doesn't have to be perfect.
+    */
+   QString tableNameFromSql(QString const & sql);
+
+   /**
+    * \brief Record one recipe calculation stage having been done
+    *
+    * \param stageName Must be a string literal (or otherwise live for the duration of the program)
+    */
+   void recordRecalc(char const * stageName, qint64 const duration_ns);
+
+   /**
+    * \brief Record one piece of one-off work of the sort done at startup (eg loading translations) having been done
+    *
+    * \param phaseName Must be a string literal (or otherwise live for the duration of the program)
+    */
+   void recordStartupPhase(char const * phaseName, qint64 const duration_ns);
+
+   /**
+    * \brief Set the function to call, on the GUI thread, at the start of each startup phase (so that it can be shown
+    *        as progress on the splash screen).  Pass an empty function to stop calling it.
+    */
+   void setStartupPhaseListener(std::function<void(char const * phaseName)> listener);
+
+   /**
+    * \return One line saying how long startup has taken so far and how long each startup phase took, in the order
+    *         they started, with any phases done inside another one in brackets after it
+    */
+   QString startupSummary();
+
+   /**
+    * \brief Record one change signal (eg \c NamedEntity::propertyChanged or \c ObjectStore::signalPropertyChanged)
+    *        having been emitted
+    *
+    * \param senderClass Class name of the sending object, or of the objects an \c ObjectStore is storing
+    * \param signalName
+    * \param propertyName The property the signal is about, or \c nullptr if it isn't about a single property
+    *
+    *        All three must be string literals (or otherwise live for the duration of the program), such as we get from
+    *        \c QMetaObject::className, \c QMetaProperty::name or \c BtStringConst.
+    */
+   void recordSignalEmitted(char const * senderClass, char const * signalName, char const * propertyName = nullptr);
+
+   /**
+    * \brief RAII timer that calls \c recordRecalc with the time between its construction and destruction
+    */
+   class ScopedRecalcTimer {
+   public:
+      ScopedRecalcTimer(char const * stageName);
+      ~ScopedRecalcTimer();
+   private:
+      char const * const m_stageName;
+      QElapsedTimer m_timer;
+   };
+
+   /**
+    * \brief RAII timer that calls \c recordStartupPhase with the time between its construction and destruction.
+    *        Phases can be nested.
+    */
+   class ScopedStartupPhaseTimer {
+   public:
+      ScopedStartupPhaseTimer(char const * phaseName);
+      ~ScopedStartupPhaseTimer();
+   private:
+      char const * const m_phaseName;
+      Tracing::Span m_span;
+      //! How many other phases this one is inside
+      int const m_depth;
+      //! Nanoseconds since the application started
+      qint64 m_start_ns;
+   };
+
+   //! Number of times something was done, and how long it took in total
+   struct TimedCount {
+      qint64 count    = 0;
+      qint64 total_ns = 0;
+   };
+
+   /**
+    * \brief Bucket \c ii of \c StatementStatistics::durationBuckets counts statements that took less than 2^ii µs (and
+    *        at least 2^(ii-1) µs).  The last bucket also counts anything slower.
+    */
+   std::size_t constexpr numDurationBuckets = 32;
+
+   struct StatementStatistics {
+      TimedCount                                timedCount;
+      qint64                                    max_ns = 0;
+      std::array<qint64, numDurationBuckets>    durationBuckets = {};
+
+      /**
+       * \return Duration, in µs, that at least \c fraction (eg 0.95) of the executions did not exceed.  Because this
+       *         comes from the histogram in \c durationBuckets, it is a power of two that is at most twice the exact
+       *         value.
+       */
+      qint64 percentile_us(double const fraction) const;
+   };
+
+   struct StoreStatistics {
+      QString     tableName;
+      int         numObjects;
+      std::size_t estimatedBytes;
+   };
+
+   /**
+    * \brief The values of all the counters at one moment.  Comparing two snapshots gives us rates.
+    */
+   struct Snapshot {
+      //! Milliseconds since the application started
+      qint64                    taken_ms = 0;
+      QVector<StoreStatistics>  stores;
+      QMap<QString, TimedCount> sqlByTable;
+      //! Keyed by statement shape (see \c statementShapeOf)
+      QMap<QString, StatementStatistics> sqlByStatement;
+      qint64                    slowSqlStatements   = 0;
+      int                       slowSqlThreshold_ms = 0;
+      QMap<QString, TimedCount> recalcByStage;
+      QMap<QString, TimedCount> startupByPhase;
+      qint64                    signalsEmitted      = 0;
+      //! Keyed by sender class, signal and property (see \c recordSignalEmitted)
+      QMap<QString, qint64>     signalsBySource;
+      //! Number of signals in the most recently completed burst (see above)
+      qint64                    lastSignalBurst     = 0;
+      qint64                    biggestSignalBurst  = 0;
+      QMap<QString, qint64>     biggestSignalBurstBySource;
+      //! See \c StringPool::Statistics
+      qint64                    internedStrings     = 0;
+      qint64                    internedBytesSaved  = 0;
+      qint64                    logMessagesWritten  = 0;
+      qint64                    logMessagesFiltered = 0;
+   };
+
+   Snapshot takeSnapshot();
+
+   /**
+    * \brief Human-readable (plain text, laid out for a fixed-width font) report of \c current.  If \c previous is
+    *        supplied, we also show rates per second since then.
+    */
+   QString format(Snapshot const & current, Snapshot const * previous = nullptr);
+}
+
+#endif
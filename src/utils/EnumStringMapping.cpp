@@ -29,8 +29,12 @@ EnumAndItsString::EnumAndItsString(int native, QString string) :
    return;
 }
 
-EnumStringMapping::EnumStringMapping(std::initializer_list<EnumAndItsString> args, bool const isRegularEnum) {
+EnumStringMapping::EnumStringMapping(std::initializer_list<EnumAndItsString> args, bool const isRegularEnum) :
+   m_exactStrings{},
+   m_foldedStrings{} {
    this->reserve(args.size());
+   this->m_exactStrings.reserve(args.size());
+   this->m_foldedStrings.reserve(args.size());
    for (auto arg : args) {
       // Uncomment this block for debugging -- eg if you are hitting the assert below at start-up!
 //      qDebug().noquote() <<
@@ -44,6 +48,12 @@ EnumStringMapping::EnumStringMapping(std::initializer_list<EnumAndItsString> arg
       //
       Q_ASSERT((arg.native == this->size()) || !isRegularEnum);
       this->append(arg);
+      //
+      // If two entries have the same string (or the same string apart from case), we want the first one, as that's
+      // what we got when we searched the list in order.  Fortunately, emplace does not overwrite an existing entry.
+      //
+      this->m_exactStrings.emplace(arg.string, arg.native);
+      this->m_foldedStrings.emplace(arg.string.toCaseFolded(), arg.native);
    }
    return;
 }
@@ -53,28 +63,31 @@ FlagEnumStringMapping::FlagEnumStringMapping(std::initializer_list<EnumAndItsStr
    return;
 }
 
-std::optional<int> EnumStringMapping::stringToEnumAsInt(QString const & stringValue,
+std::optional<int> EnumStringMapping::stringToEnumAsInt(QStringView const stringValue,
                                                         bool const caseInensitiveFallback) const {
-   auto match = std::find_if(this->begin(),
-                             this->end(),
-                             [stringValue](EnumAndItsString const & ii){return stringValue == ii.string;});
+   auto match = this->m_exactStrings.find(stringValue);
+   if (match != this->m_exactStrings.end()) {
+      return std::optional<int>{match->second};
+   }
+
    //
    // If we didn't find an exact match, we'll try a case-insensitive one if so-configured.  (We don't do this by
-   // default as the assumption is that it's rare we'll need the case insensitivity.)
+   // default as the assumption is that it's rare we'll need the case insensitivity.)  This is the only place we need
+   // to make a new string, as the keys we're comparing against were folded at construction.
    //
-   if (match == this->end() && caseInensitiveFallback) {
-      match = std::find_if(
-         this->begin(),
-         this->end(),
-         [stringValue](EnumAndItsString const & ii){return stringValue.toLower() == ii.string.toLower();}
-      );
+   if (caseInensitiveFallback) {
+      match = this->m_foldedStrings.find(stringValue.toString().toCaseFolded());
+      if (match != this->m_foldedStrings.end()) {
+         return std::optional<int>{match->second};
+      }
    }
 
-   if (match == this->end()) {
-      return std::nullopt;
-   }
+   return std::nullopt;
+}
 
-   return std::optional<int>{match->native};
+std::optional<int> EnumStringMapping::stringToEnumAsInt(QString const & stringValue,
+                                                        bool const caseInensitiveFallback) const {
+   return this->stringToEnumAsInt(QStringView{stringValue}, caseInensitiveFallback);
 }
 
 std::optional<QString> EnumStringMapping::enumAsIntToString(int const enumValue) const {
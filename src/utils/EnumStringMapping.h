@@ -19,9 +19,12 @@
 
 #include <optional>
 #include <stdexcept>
+#include <unordered_map>
 
 #include <QDebug>
+#include <QHash>
 #include <QString>
+#include <QStringView>
 #include <QVector>
 
 #include "Logging.h"
@@ -59,9 +62,15 @@ struct EnumAndItsString {
 /**
  * \class EnumStringMapping
  *
- *        We don't actually bother creating hashmaps or similar between enum values and string representations
- *        because it's usually going to be a short list that we can search through pretty quickly (probably faster
- *        than calculating the hash of a key!)
+ *        Going from enum value to string is just an index into the vector (see below).  Going from string to enum
+ *        value, which we do for every enum field of every record we read from the DB or from a BeerXML/BeerJSON file,
+ *        uses two hash maps built at construction: one on the exact strings and one on their case-folded forms (so the
+ *        case-insensitive fallback does not have to lower-case every candidate on every look-up).  Both maps are keyed
+ *        so that they can be searched with a \c QStringView, meaning callers holding part of a larger string do not
+ *        need to make a copy to look it up.
+ *
+ *        Because of these maps, the contents of the mapping must not be modified after construction.  (Nothing does,
+ *        as all the mappings are constants.)
  *
  *        In theory, it would suffice to use an array here rather than a vector, because the data for the mapping is
  *        always known at compile-time.  This would also allow us to make more things const or constexpr.  In practice,
@@ -94,6 +103,9 @@ public:
     * \param caseInensitiveFallback If \c true (the default), this means we'll do a case-insensitive search if we didn't
     *                               find \c stringValue as a case-sensitive match.
     */
+   std::optional<int> stringToEnumAsInt(QStringView const stringValue, bool const caseInensitiveFallback = true) const;
+
+   //! Overload so that existing callers with a \c QString do not have to think about which version to call
    std::optional<int> stringToEnumAsInt(QString const & stringValue, bool const caseInensitiveFallback = true) const;
 
    /**
@@ -167,6 +179,26 @@ public:
       std::optional<int> result = this->stringToEnumAsInt(stringValue);
       return result ? std::optional<E>{static_cast<E>(*result)} : std::optional<E>{std::nullopt};
    }
+
+private:
+   /**
+    * \brief Hash and equality for looking up \c QString keys with either a \c QString or a \c QStringView (which
+    *        needs \c is_transparent on both).
+    */
+   struct StringViewHash {
+      using is_transparent = void;
+      std::size_t operator()(QStringView const value) const noexcept { return qHash(value); }
+   };
+   struct StringViewEqual {
+      using is_transparent = void;
+      bool operator()(QStringView const lhs, QStringView const rhs) const noexcept { return lhs == rhs; }
+   };
+   using StringToEnumMap = std::unordered_map<QString, int, StringViewHash, StringViewEqual>;
+
+   //! Each string (exactly as given) to its enum value
+   StringToEnumMap m_exactStrings;
+   //! Each string, case-folded, to its enum value
+   StringToEnumMap m_foldedStrings;
 };
 
 class FlagEnumStringMapping : public EnumStringMapping {
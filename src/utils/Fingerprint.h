@@ -0,0 +1,67 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * utils/Fingerprint.h is part of Brewtarget, and is copyright the following authors 2024:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#ifndef UTILS_FINGERPRINT_H
+#define UTILS_FINGERPRINT_H
+#pragma once
+
+#include <cstddef>
+#include <optional>
+
+#include <QHash>
+#include <QString>
+
+#include "utils/TypeTraits.h"
+
+namespace Utils {
+   /**
+    * \brief Mix one field into a fingerprint (see \c NamedEntity::fingerprint) in the same way as boost::hash_combine.
+    *
+    *        The overloads here mirror \c Utils::AutoCompare: for any type where \c AutoCompare does an exact comparison,
+    *        equal values give equal fingerprints.  There is deliberately no overload for \c double (or optional
+    *        \c double) because \c AutoCompare compares those fuzzily, so two "equal" values can have different bit
+    *        patterns.
+    */
+   inline std::size_t fingerprintMix(std::size_t const seed, std::size_t const value) {
+      return seed ^ (value + 0x9e3779b9 + (seed << 6) + (seed >> 2));
+   }
+
+   // AutoCompare ignores leading and trailing whitespace on strings, so we must too
+   inline std::size_t fingerprintCombine(std::size_t const seed, QString const & value) {
+      return fingerprintMix(seed, qHash(value.trimmed()));
+   }
+   inline std::size_t fingerprintCombine(std::size_t const seed, int  const value) {
+      return fingerprintMix(seed, static_cast<std::size_t>(value));
+   }
+   inline std::size_t fingerprintCombine(std::size_t const seed, bool const value) {
+      return fingerprintMix(seed, value ? 1 : 0);
+   }
+
+   template<typename E, std::enable_if_t<IsRequiredEnum<E>>* = nullptr>
+   std::size_t fingerprintCombine(std::size_t const seed, E const value) {
+      return fingerprintMix(seed, static_cast<std::size_t>(value));
+   }
+
+   template<typename E, std::enable_if_t<IsRequiredEnum<E>>* = nullptr>
+   std::size_t fingerprintCombine(std::size_t const seed, std::optional<E> const value) {
+      // Offset by one so that "not set" is distinct from the first enum value
+      return fingerprintMix(seed, value ? static_cast<std::size_t>(*value) + 1 : 0);
+   }
+
+   std::size_t fingerprintCombine(std::size_t, double) = delete;
+   std::size_t fingerprintCombine(std::size_t, std::optional<double>) = delete;
+}
+
+#endif
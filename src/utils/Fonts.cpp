@@ -18,11 +18,14 @@
 #include <QDebug>
 #include <QFontDatabase>
 
+#include "utils/Diagnostics.h"
+
 namespace {
    /**
     * \brief Loads the specified font family file (typically from our resource bundle) and returns its name
     */
    QString loadFontFamily(char const * const fileName) {
+      Diagnostics::ScopedStartupPhaseTimer phaseTimer{"Font registration"};
       int id = QFontDatabase::addApplicationFont(fileName);
       if (id < 0) {
          // This is a coding error
@@ -33,24 +36,25 @@ namespace {
    }
 }
 
-Fonts const & Fonts::getInstance() {
-   // Per https://isocpp.org/wiki/faq/ctors#static-init-order, we use the "Construct On First Use Idiom", aka a Meyers
-   // Singleton, to ensure we initialise after main() is invoked.  This is thread-safe since C++11 (see
-   // https://www.modernescpp.com/index.php/thread-safe-initialization-of-a-singleton#h3-guarantees-of-the-c-runtime).
-   //
-   // We are not worried about the Fonts class being used during application shutdown, so we do not use a pointer here.
-   // (See the isocpp.org link above for more discussion about this.)
-   static Fonts const instance{};
-   return instance;
+// Initialisation of function-local statics is thread-safe since C++11 (see
+// https://www.modernescpp.com/index.php/thread-safe-initialization-of-a-singleton#h3-guarantees-of-the-c-runtime), so
+// each font file is loaded at most once.
+QString const & Fonts::TexGyreSchola_BoldItalic() {
+   static QString const familyName{loadFontFamily(":/fonts/TexGyreSchola-BoldItalic.otf")};
+   return familyName;
 }
 
-Fonts::Fonts() :
-   TexGyreSchola_BoldItalic{loadFontFamily(":/fonts/TexGyreSchola-BoldItalic.otf")},
-   TexGyreSchola_Bold      {loadFontFamily(":/fonts/TexGyreSchola-Bold.otf"      )},
-   TexGyreSchola_Italic    {loadFontFamily(":/fonts/TexGyreSchola-Italic.otf"    )},
-   TexGyreSchola_Regular   {loadFontFamily(":/fonts/TexGyreSchola-Regular.otf"   )} {
+QString const & Fonts::TexGyreSchola_Bold() {
+   static QString const familyName{loadFontFamily(":/fonts/TexGyreSchola-Bold.otf")};
+   return familyName;
+}
 
-   return;
+QString const & Fonts::TexGyreSchola_Italic() {
+   static QString const familyName{loadFontFamily(":/fonts/TexGyreSchola-Italic.otf")};
+   return familyName;
 }
 
-Fonts::~Fonts() = default;
+QString const & Fonts::TexGyreSchola_Regular() {
+   static QString const familyName{loadFontFamily(":/fonts/TexGyreSchola-Regular.otf")};
+   return familyName;
+}
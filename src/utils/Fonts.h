@@ -19,52 +19,30 @@
 
 #include <QString>
 
-#include "utils/NoCopy.h"
-
 /**
- * \class Fonts  Holds info about open source fonts that we ship with the application.
+ * \brief Info about the open source fonts that we ship with the application.
  *
- *        This is a bit of a nothing singleton class, but it's a mechanism for having constant values
- *        (\c Fonts::TexGyreSchola_Regular etc) that are initialised after the program starts running.
+ *        Each function returns the name of a font family, which is obtained from the font file itself the first time
+ *        the function is called.  So we only register a font (with \c QFontDatabase::addApplicationFont) when
+ *        something actually asks for it, rather than registering all of them up front and slowing down startup.
  *
- *        We we cannot rely on automatic initialisation of the font family name variables, because there isn't an easy
+ *        We cannot use automatically-initialised global variables for the family names, because there isn't an easy
  *        way for the compiler to know that it would need to initialise the Qt resource system before initialising
- *        \c Fonts::TexGyreSchola_Regular etc.
- *
- *        We rely on the constructor being called after \c main is invoked (the first time \c getInstance is called) so
- *        that we can read in the font resources at a time they are definitely available.
+ *        them.  Function-local statics are fine, because, per https://doc.qt.io/qt-6/resources.html, "Resources
+ *        embedded in C++ executable or library code are automatically registered to the Qt resource system in a
+ *        constructor of an internal global variable.  Since the global variables are initialized before main() runs,
+ *        the resources are available when the program starts to run."
  *
- *        It doesn't matter how early in the program execution you call \c Fonts::getInstance because, per
- *        https://doc.qt.io/qt-6/resources.html, "Resources embedded in C++ executable or library code are
- *        automatically registered to the Qt resource system in a constructor of an internal global variable.  Since
- *        the global variables are initialized before main() runs, the resources are available when the program
- *        starts to run."
+ *        Note however that \c QFontDatabase needs a \c QGuiApplication, so these must not be called before that has
+ *        been constructed.
  */
-class Fonts {
-public:
-   static Fonts const & getInstance();
-
-   /**
-    * \brief Names of the font families we ship.  We must call \c Fonts::init() early in the application to initialise
-    *        these values (which are obtained from the font files themselves after they are loaded in).
-    *
-    *        In a perfect world, these would be \c const but, because they have to be initialised at
-    */
+namespace Fonts {
    //! @{
-   QString const TexGyreSchola_BoldItalic;
-   QString const TexGyreSchola_Bold      ;
-   QString const TexGyreSchola_Italic    ;
-   QString const TexGyreSchola_Regular   ;
+   QString const & TexGyreSchola_BoldItalic();
+   QString const & TexGyreSchola_Bold      ();
+   QString const & TexGyreSchola_Italic    ();
+   QString const & TexGyreSchola_Regular   ();
    //! @}
-
-private:
-   //! Hidden constructor.
-   Fonts();
-   //! Destructor hidden.
-   ~Fonts();
-
-   // Insert all the usual boilerplate to prevent copy/assignment/move
-   NO_COPY_DECLARATIONS(Fonts)
-};
+}
 
 #endif
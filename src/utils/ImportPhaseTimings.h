@@ -0,0 +1,72 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * utils/ImportPhaseTimings.h is part of Brewtarget, and is copyright the following authors 2024:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#ifndef UTILS_IMPORTPHASETIMINGS_H
+#define UTILS_IMPORTPHASETIMINGS_H
+#pragma once
+
+#include <array>
+
+#include <QElapsedTimer>
+#include <QString>
+
+/**
+ * \brief Accumulates how much time is spent in each phase of importing a BeerXML or BeerJSON document, so that the
+ *        import benchmark (see \c Testing::benchmarkImport) can report them separately.
+ *
+ *        The totals are atomic, as validation can happen on worker threads.  The overhead of the timers is a couple
+ *        of clock reads per phase, which is negligible compared with what they are measuring.
+ */
+namespace ImportPhaseTimings {
+   enum class Phase {
+      //! Schema validation: Xerces parse-and-validate for BeerXML; Valijson for BeerJSON
+      Validation,
+      //! \c XmlRecord::load / \c JsonRecord::load
+      Load,
+      //! \c XmlRecord::normaliseAndStoreInDb / \c JsonRecord::normaliseAndStoreInDb (includes DuplicateDetection)
+      NormaliseAndStoreInDb,
+      //! Calls to \c SerializationRecord::isDuplicate (and its overrides)
+      DuplicateDetection,
+   };
+
+   //! All the phases, in the order they happen
+   inline constexpr std::array<Phase, 4> allPhases{Phase::Validation,
+                                                   Phase::Load,
+                                                   Phase::NormaliseAndStoreInDb,
+                                                   Phase::DuplicateDetection};
+
+   //! \brief Zero all the totals
+   void reset();
+
+   //! \return Total time, in nanoseconds, spent in \c phase since the last call to \c reset()
+   qint64 total_ns(Phase const phase);
+
+   //! \return Human-readable name of \c phase, for benchmark output
+   QString name(Phase const phase);
+
+   /**
+    * \brief RAII timer that adds the time between its construction and destruction to the total for one phase
+    */
+   class ScopedTimer {
+   public:
+      ScopedTimer(Phase const phase);
+      ~ScopedTimer();
+   private:
+      Phase const m_phase;
+      QElapsedTimer m_timer;
+   };
+}
+
+#endif
@@ -15,7 +15,43 @@
  ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
 #include "utils/ImportRecordCount.h"
 
-ImportRecordCount::ImportRecordCount() : skips{}, oks{} {
+#include <algorithm>
+
+#include <QDebug>
+
+namespace {
+   //! The currently-installed progress callback, if any.  Imports only load records on the GUI thread, so there is no
+   //  need for locking.
+   std::function<bool(int const)> progressCallback;
+
+   //! Minimum time between calls to progressCallback, so that updating the UI doesn't slow the import down noticeably
+   constexpr qint64 progressInterval_ms = 200;
+}
+
+ImportRecordCount::ImportRecordCount() :
+   skips{},
+   oks{},
+   timer{},
+   lastProgressReport_ms{0},
+   phaseTotalsAtStart_ns{},
+   topLevelDeleters{},
+   cancelled{false} {
+   this->timer.start();
+   for (auto const phase : ImportPhaseTimings::allPhases) {
+      this->phaseTotalsAtStart_ns[static_cast<std::size_t>(phase)] = ImportPhaseTimings::total_ns(phase);
+   }
+   return;
+}
+
+ImportRecordCount::ScopedProgressCallback::ScopedProgressCallback(std::function<bool(int const numRecords)> callback) {
+   // It's a coding error to try to have two progress callbacks at once
+   Q_ASSERT(!progressCallback);
+   progressCallback = callback;
+   return;
+}
+
+ImportRecordCount::ScopedProgressCallback::~ScopedProgressCallback() {
+   progressCallback = nullptr;
    return;
 }
 
@@ -24,6 +60,7 @@ void ImportRecordCount::skipped(QString recordName) {
    // If QMap holds an item with key recordName then insert() will just replace its existing value
    this->skips.insert(recordName,
                       this->skips.contains(recordName) ? (this->skips.value(recordName) + 1) : 1);
+   this->recordCounted();
    return;
 }
 
@@ -32,10 +69,88 @@ void ImportRecordCount::processedOk(QString recordName) {
    // function
    this->oks.insert(recordName,
                     this->oks.contains(recordName) ? (this->oks.value(recordName) + 1) : 1);
+   this->recordCounted();
+   return;
+}
+
+void ImportRecordCount::recordCounted() {
+   if (!progressCallback || this->cancelled) {
+      return;
+   }
+   qint64 const elapsed_ms = this->timer.elapsed();
+   if (elapsed_ms - this->lastProgressReport_ms < progressInterval_ms) {
+      return;
+   }
+   this->lastProgressReport_ms = elapsed_ms;
+   if (!progressCallback(this->numProcessedOk() + this->numSkipped())) {
+      qInfo() << Q_FUNC_INFO << "Import cancelled by user";
+      this->cancelled = true;
+   }
+   return;
+}
+
+void ImportRecordCount::storedTopLevel(std::function<void()> deleter) {
+   this->topLevelDeleters.push_back(deleter);
+   return;
+}
+
+bool ImportRecordCount::isCancelled() const {
+   return this->cancelled;
+}
+
+void ImportRecordCount::rollBack(QTextStream & userMessage) {
+   qInfo() <<
+      Q_FUNC_INFO << "Rolling back" << this->topLevelDeleters.size() << "top-level records after" <<
+      this->timer.elapsed() << "ms";
+   // Going backwards means that anything that refers to an earlier record (eg a recipe that uses a hop we read in
+   // previously) is deleted before the thing it refers to.
+   std::for_each(this->topLevelDeleters.rbegin(), this->topLevelDeleters.rend(), [](auto & deleter) { deleter(); });
+   this->topLevelDeleters.clear();
+   this->logThroughput();
+   userMessage << tr("Import cancelled.  Nothing was imported from this file.");
+   return;
+}
+
+int ImportRecordCount::numProcessedOk() const {
+   int total = 0;
+   for (int const count : this->oks) {
+      total += count;
+   }
+   return total;
+}
+
+int ImportRecordCount::numSkipped() const {
+   int total = 0;
+   for (int const count : this->skips) {
+      total += count;
+   }
+   return total;
+}
+
+double ImportRecordCount::recordsPerSecond() const {
+   qint64 const elapsed_ns = std::max(this->timer.nsecsElapsed(), static_cast<qint64>(1));
+   return static_cast<double>(this->numProcessedOk() + this->numSkipped()) * 1.0e9 / static_cast<double>(elapsed_ns);
+}
+
+qint64 ImportRecordCount::phase_ns(ImportPhaseTimings::Phase const phase) const {
+   return ImportPhaseTimings::total_ns(phase) - this->phaseTotalsAtStart_ns[static_cast<std::size_t>(phase)];
+}
+
+void ImportRecordCount::logThroughput() const {
+   QString phaseTimes;
+   QTextStream phaseTimesAsStream{&phaseTimes};
+   for (auto const phase : ImportPhaseTimings::allPhases) {
+      phaseTimesAsStream << " " << ImportPhaseTimings::name(phase) << " " << this->phase_ns(phase) / 1000000 << "ms";
+   }
+   phaseTimesAsStream.flush();
+   qInfo().noquote() <<
+      Q_FUNC_INFO << this->numProcessedOk() << "records stored," << this->numSkipped() << "duplicates skipped in" <<
+      this->timer.elapsed() << "ms (" << this->recordsPerSecond() << "records/s );" << phaseTimes;
    return;
 }
 
 bool ImportRecordCount::writeToUserMessage(QTextStream & userMessage) {
+   this->logThroughput();
 
    if (this->oks.isEmpty() && this->skips.isEmpty()) {
       //
@@ -17,11 +17,18 @@
 #define UTILS_IMPORTRECORDCOUNT_H
 #pragma once
 
+#include <array>
+#include <functional>
+#include <vector>
+
 #include <QCoreApplication> // For Q_DECLARE_TR_FUNCTIONS
+#include <QElapsedTimer>
 #include <QMap>
 #include <QString>
 #include <QTextStream>
 
+#include "utils/ImportPhaseTimings.h"
+
 /**
  * \brief This class keeps tallies of records processed in loading a JSON or XML document so that we can tell the
  *        user how many objects (hops, recipes, etc) we (a) skipped over (eg because they were duplicates) and (b)
@@ -30,6 +37,11 @@
  *
  * Note that we use a QMap and not a QHash here as it's nice to be able to run through the keys in alphabetical
  * order when generating the summary message for the user.  (See eg code in xml/XmlCoding.cpp that does this.)
+ *
+ * Since every processed record passes through here, this is also where we report progress (see
+ * \c ScopedProgressCallback), note whether the user has asked to cancel the import, and keep track of how to undo it
+ * if they have.  We also log throughput (records/s and time per phase) at the end of each import, so that it is
+ * possible to see from the logs which files, or which phases of importing them, are slow.
  */
 class ImportRecordCount {
    // Per https://doc.qt.io/qt-5/i18n-source-translation.html#translating-non-qt-classes, this gives us a tr() function
@@ -37,8 +49,31 @@ class ImportRecordCount {
    Q_DECLARE_TR_FUNCTIONS(ImportRecordCount)
 
 public:
+   /**
+    * \brief Constructing an \c ImportRecordCount marks the start of an import, for the purposes of timing it
+    */
    ImportRecordCount();
 
+   /**
+    * \brief While an object of this class exists, its callback is called (on the GUI thread, and at most every few
+    *        tenths of a second) as records are counted, with the number of records processed so far in the current
+    *        import.  The callback returns \c false if the user has asked to cancel the import.
+    *
+    *        Typically the callback will update a progress dialog and process events.  Only one callback can be active
+    *        at a time.
+    */
+   class ScopedProgressCallback {
+   public:
+      ScopedProgressCallback(std::function<bool(int const numRecords)> callback);
+      ~ScopedProgressCallback();
+   private:
+      // RAII class shouldn't be getting copied or moved
+      ScopedProgressCallback(ScopedProgressCallback const &) = delete;
+      ScopedProgressCallback & operator=(ScopedProgressCallback const &) = delete;
+      ScopedProgressCallback(ScopedProgressCallback &&) = delete;
+      ScopedProgressCallback & operator=(ScopedProgressCallback &&) = delete;
+   };
+
    /**
     * \brief Call this to mark that we skipped over a record
     * \param recordName The name of the record (typically the class name of the object being read in).  This will be
@@ -55,17 +90,64 @@ public:
     */
    void processedOk(QString recordName);
 
+   /**
+    * \brief Call this when a top-level record (ie one not contained in another) has been successfully stored in the DB
+    *
+    * \param deleter Function that will delete the stored object from the DB, which we call if the import is cancelled
+    */
+   void storedTopLevel(std::function<void()> deleter);
+
+   /**
+    * \brief Whether the user has asked (via the progress callback) to cancel the import.  Once this returns \c true,
+    *        callers should stop processing records and return failure up the call stack, so that partially-stored
+    *        records are cleaned up in the same way as for any other error.  The top-level caller should then call
+    *        \c rollBack.
+    */
+   bool isCancelled() const;
+
+   /**
+    * \brief Delete from the DB all the top-level records stored in this import (in the reverse order to which they
+    *        were stored), and write a message saying so.
+    */
+   void rollBack(QTextStream & userMessage);
+
+   //! \return Number of records successfully stored so far
+   int numProcessedOk() const;
+
+   //! \return Number of records skipped (as duplicates) so far
+   int numSkipped() const;
+
+   //! \return Records (stored or skipped) per second since construction
+   double recordsPerSecond() const;
+
+   //! \return Time spent in \c phase since construction
+   qint64 phase_ns(ImportPhaseTimings::Phase const phase) const;
+
    /**
     * \brief Construct a user-readable string summarising how many records of each type were skipped and/or successfully
     *        processed.
     * \param userMessage Where to write the text suitable for showing on-screen to the user
+    *        Also logs the throughput stats for the import.
+    *
     * \return \b false if no records at all were skipped or processed, \b true otherwise
     */
    bool writeToUserMessage(QTextStream & userMessage);
 
 private:
+   //! Called each time a record is counted
+   void recordCounted();
+
+   //! Write records/s, duplicates skipped and time per phase to the log
+   void logThroughput() const;
+
    QMap<QString, int> skips;
    QMap<QString, int> oks;
+   QElapsedTimer timer;
+   qint64 lastProgressReport_ms;
+   //! Values of the \c ImportPhaseTimings totals when we were constructed, indexed by \c ImportPhaseTimings::Phase
+   std::array<qint64, ImportPhaseTimings::allPhases.size()> phaseTotalsAtStart_ns;
+   std::vector<std::function<void()>> topLevelDeleters;
+   bool cancelled;
 };
 
 #endif
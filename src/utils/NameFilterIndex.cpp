@@ -0,0 +1,132 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * utils/NameFilterIndex.cpp is part of Brewtarget, and is copyright the following authors 2024:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#include "utils/NameFilterIndex.h"
+
+#include "model/NamedEntity.h"
+
+namespace {
+   constexpr int trigramLength = 3;
+}
+
+NameFilterIndex::NameFilterIndex() :
+   m_foldedNames{},
+   m_trigrams{} {
+   return;
+}
+
+NameFilterIndex::~NameFilterIndex() = default;
+
+QString NameFilterIndex::fold(QString const & text) {
+   //
+   // Compatibility decomposition splits accented characters into base character plus combining mark(s) (eg "ä" becomes
+   // "a" followed by U+0308 COMBINING DIAERESIS), so we can then just drop the marks.
+   //
+   QString const decomposed = text.normalized(QString::NormalizationForm_KD);
+   QString stripped;
+   stripped.reserve(decomposed.size());
+   for (QChar const character : decomposed) {
+      QChar::Category const category = character.category();
+      if (category != QChar::Mark_NonSpacing &&
+          category != QChar::Mark_SpacingCombining &&
+          category != QChar::Mark_Enclosing) {
+         stripped.append(character);
+      }
+   }
+   return stripped.toCaseFolded();
+}
+
+void NameFilterIndex::update(NamedEntity const * entity) {
+   QString const foldedName = NameFilterIndex::fold(entity->name());
+
+   auto existing = this->m_foldedNames.find(entity);
+   if (existing != this->m_foldedNames.end()) {
+      if (*existing == foldedName) {
+         return;
+      }
+      this->removeTrigrams(entity, *existing);
+   }
+
+   for (int ii = 0; ii + trigramLength <= foldedName.size(); ++ii) {
+      this->m_trigrams[foldedName.mid(ii, trigramLength)].insert(entity);
+   }
+   this->m_foldedNames.insert(entity, foldedName);
+   return;
+}
+
+void NameFilterIndex::remove(NamedEntity const * entity) {
+   auto existing = this->m_foldedNames.find(entity);
+   if (existing == this->m_foldedNames.end()) {
+      return;
+   }
+   this->removeTrigrams(entity, *existing);
+   this->m_foldedNames.erase(existing);
+   return;
+}
+
+void NameFilterIndex::clear() {
+   this->m_foldedNames.clear();
+   this->m_trigrams.clear();
+   return;
+}
+
+QSet<NamedEntity const *> NameFilterIndex::matching(QString const & searchText) const {
+   QString const foldedText = NameFilterIndex::fold(searchText);
+   QSet<NamedEntity const *> matches;
+
+   if (foldedText.size() < trigramLength) {
+      for (auto ii = this->m_foldedNames.cbegin(); ii != this->m_foldedNames.cend(); ++ii) {
+         if (ii.value().contains(foldedText)) {
+            matches.insert(ii.key());
+         }
+      }
+      return matches;
+   }
+
+   //
+   // Every match has to contain every trigram of the search text, so the set of entities for the least common of those
+   // trigrams is the shortest list of candidates.  If any trigram is not in the index at all, there are no matches.
+   //
+   QSet<NamedEntity const *> const * candidates = nullptr;
+   for (int ii = 0; ii + trigramLength <= foldedText.size(); ++ii) {
+      auto entry = this->m_trigrams.constFind(foldedText.mid(ii, trigramLength));
+      if (entry == this->m_trigrams.cend()) {
+         return matches;
+      }
+      if (!candidates || entry->size() < candidates->size()) {
+         candidates = &(*entry);
+      }
+   }
+
+   for (NamedEntity const * candidate : *candidates) {
+      if (this->m_foldedNames.value(candidate).contains(foldedText)) {
+         matches.insert(candidate);
+      }
+   }
+   return matches;
+}
+
+void NameFilterIndex::removeTrigrams(NamedEntity const * entity, QString const & foldedName) {
+   for (int ii = 0; ii + trigramLength <= foldedName.size(); ++ii) {
+      auto entry = this->m_trigrams.find(foldedName.mid(ii, trigramLength));
+      if (entry != this->m_trigrams.end()) {
+         entry->remove(entity);
+         if (entry->isEmpty()) {
+            this->m_trigrams.erase(entry);
+         }
+      }
+   }
+   return;
+}
@@ -0,0 +1,75 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * utils/NameFilterIndex.h is part of Brewtarget, and is copyright the following authors 2024:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#ifndef UTILS_NAMEFILTERINDEX_H
+#define UTILS_NAMEFILTERINDEX_H
+#pragma once
+
+#include <QHash>
+#include <QSet>
+#include <QString>
+
+class NamedEntity;
+
+/**
+ * \brief Index of the names of a set of \c NamedEntity objects (typically the rows of a table model), so that a search
+ *        box can find the ones whose name contains a given piece of text without having to format and search every
+ *        name on every keystroke.
+ *
+ *        Matching ignores case and accents (so "marzen" finds "Märzen").  Names are indexed by trigram (ie every
+ *        sequence of three consecutive characters of the folded name).  To find the names containing some text, we
+ *        take the smallest set of names containing one of the text's trigrams and then only need to check those.
+ *        Text shorter than a trigram is just checked against every (already-folded) name.
+ *
+ *        Objects are identified by address, so it's up to the owner of the index to call \c remove before an object
+ *        is destroyed, and \c update when its name changes.
+ */
+class NameFilterIndex {
+public:
+   NameFilterIndex();
+   ~NameFilterIndex();
+
+   /**
+    * \brief Returns \c text case-folded and with accents (and other combining marks) stripped.  This is what we
+    *        compare when matching.
+    */
+   static QString fold(QString const & text);
+
+   /**
+    * \brief Add \c entity to the index, or, if it is already there, re-index it under its current name
+    */
+   void update(NamedEntity const * entity);
+
+   void remove(NamedEntity const * entity);
+
+   void clear();
+
+   /**
+    * \return All entities in the index whose name contains \c searchText, ignoring case and accents.  Callers will
+    *         usually want to special-case empty \c searchText (which matches everything) rather than call this.
+    */
+   QSet<NamedEntity const *> matching(QString const & searchText) const;
+
+private:
+   void removeTrigrams(NamedEntity const * entity, QString const & foldedName);
+
+   //! Folded name of each entity in the index
+   QHash<NamedEntity const *, QString> m_foldedNames;
+
+   //! For each trigram, the entities whose folded name contains it
+   QHash<QString, QSet<NamedEntity const *>> m_trigrams;
+};
+
+#endif
@@ -1,5 +1,5 @@
 /*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
- * utils/OStreamWriterForQFile.cpp is part of Brewtarget, and is copyright the following authors 2022:
+ * utils/OStreamWriterForQFile.cpp is part of Brewtarget, and is copyright the following authors 2022-2024:
  *   • Matt Young <mfsy@yahoo.com>
  *
  * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
@@ -15,17 +15,34 @@
  ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
 #include "utils/OStreamWriterForQFile.h"
 
-OStreamWriterForQFile::OStreamWriterForQFile(QFile & qFile) : std::ostream{this}, qFile{qFile} {
+OStreamWriterForQFile::OStreamWriterForQFile(QFile & qFile) : std::ostream{this}, qFile{qFile}, buffer{} {
+   this->setp(this->buffer.data(), this->buffer.data() + this->buffer.size());
    return;
 }
 
-OStreamWriterForQFile::~OStreamWriterForQFile() = default;
+OStreamWriterForQFile::~OStreamWriterForQFile() {
+   this->writeBuffer();
+   return;
+}
 
 int OStreamWriterForQFile::overflow(int c) {
-   this->putChar(c);
-   return 0;
+   if (!this->writeBuffer()) {
+      return traits_type::eof();
+   }
+   if (!traits_type::eq_int_type(c, traits_type::eof())) {
+      *this->pptr() = traits_type::to_char_type(c);
+      this->pbump(1);
+   }
+   return traits_type::not_eof(c);
 }
-void OStreamWriterForQFile::putChar(char c) {
-   this->qFile.putChar(c);
-   return;
+
+int OStreamWriterForQFile::sync() {
+   return this->writeBuffer() ? 0 : -1;
+}
+
+bool OStreamWriterForQFile::writeBuffer() {
+   qint64 const numBytes = this->pptr() - this->pbase();
+   bool const succeeded = (numBytes == 0 || this->qFile.write(this->pbase(), numBytes) == numBytes);
+   this->setp(this->buffer.data(), this->buffer.data() + this->buffer.size());
+   return succeeded;
 }
@@ -1,5 +1,5 @@
 /*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
- * utils/OStreamWriterForQFile.h is part of Brewtarget, and is copyright the following authors 2022:
+ * utils/OStreamWriterForQFile.h is part of Brewtarget, and is copyright the following authors 2022-2024:
  *   • Matt Young <mfsy@yahoo.com>
  *
  * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
@@ -17,6 +17,7 @@
 #define UTILS_OSTREAMWRITERFORQFILE_H
 #pragma once
 
+#include <array>
 #include <iostream>
 #include <QFile>
 
@@ -24,6 +25,10 @@
  * \brief Class that inherits from \c std::ostream and writes to \c QFile
  *
  *        See https://stackoverflow.com/questions/772355/how-to-inherit-from-stdostream for the inspiration.
+ *
+ *        Output is collected in a small fixed-size buffer and handed to the \c QFile a block at a time (rather than a
+ *        character at a time), so it is reasonable to stream large documents through this class.  The buffer is
+ *        written out when it is full, when the stream is flushed, and in the destructor.
  */
 class OStreamWriterForQFile : private std::streambuf, public std::ostream {
 public:
@@ -32,9 +37,16 @@ public:
 
 private:
    int overflow(int c) override;
-   void putChar(char c);
+   int sync() override;
+
+   /**
+    * \brief Write out whatever is in the buffer
+    * \return \c false if there was an error writing to the file
+    */
+   bool writeBuffer();
 
    QFile & qFile;
+   std::array<char, 4096> buffer;
 };
 
 
@@ -116,6 +116,13 @@ public:
       return match->string;
    }
 
+   /**
+    * \brief All the entries in the mapping, in the order they were given to the constructor
+    */
+   std::vector<ObjectAddressAndItsString> const & entries() const {
+      return this->m_map;
+   }
+
 private:
    // I'm not sure the exact container we use makes that much difference given the typically small number of entries
    // we're storing.  There's an advantage to using std::vector over QVector in that the former does not require
@@ -0,0 +1,137 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * utils/ParallelRender.h is part of Brewtarget, and is copyright the following authors 2024:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#ifndef UTILS_PARALLELRENDER_H
+#define UTILS_PARALLELRENDER_H
+#pragma once
+
+#include <algorithm>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <QList>
+#include <QRunnable>
+#include <QThreadPool>
+
+/**
+ * \brief Helper for exporting lots of records at once, eg when a user exports their whole recipe library.
+ *
+ *        Turning each record into text (XML or JSON) only reads the objects being exported, so it can be done on
+ *        several threads at once.  Writing the text, however, has to be done in order, on the calling thread.
+ *
+ *        To keep memory use bounded, we don't render everything and then write it.  Instead, we work in "waves": a few
+ *        chunks of records per thread are rendered in parallel, then written out in order, then the next wave is
+ *        rendered, and so on.
+ *
+ *        NB: It is the caller's responsibility to ensure nothing is going to modify the objects being rendered while
+ *            this is running.  In particular, anything that would otherwise be created or calculated on first access
+ *            (see \c HydrateAllObjectStores) needs to have been done beforehand.  Note too that we do not process
+ *            events while waiting for the worker threads, as a queued signal could then change an object that a
+ *            worker thread is reading.
+ */
+namespace ParallelRender {
+   //! By default, below this many records, it is not worth the overhead of farming out the work
+   inline constexpr int minRecordsForParallel = 64;
+
+   //! Default number of records rendered by each job
+   inline constexpr int recordsPerChunk = 16;
+
+   //! Number of chunks per thread in each wave
+   inline constexpr int chunksPerThreadPerWave = 4;
+
+   /**
+    * \brief Render each of \c items with \c renderItem (possibly on another thread) and pass the results in the same
+    *        order as \c items to \c writeItem (always on the calling thread).
+    *
+    * \param renderItem Callable taking \c Item \c const \c & and returning \c std::optional of the rendered output
+    *                   (eg \c QString), or \c std::nullopt if there was an error.  Must be safe to call concurrently.
+    * \param writeItem  Callable taking the rendered output (by const reference)
+    * \param minItemsForParallel Below this many items, everything is rendered on the calling thread.  The default
+    *                            suits lots of small records; callers with a few expensive items (eg whole recipes
+    *                            formatted for printing) will want something lower.
+    * \param itemsPerChunk Number of items rendered by each job
+    *
+    * \return \c true if all items were rendered and written, \c false if we stopped at an item that could not be
+    *         rendered.  (As with a sequential export, everything before the failed item will have been written.)
+    */
+   template<class Item, class RenderItem, class WriteItem>
+   bool renderAndWrite(QList<Item> const & items,
+                       RenderItem renderItem,
+                       WriteItem writeItem,
+                       int const minItemsForParallel = minRecordsForParallel,
+                       int const itemsPerChunk = recordsPerChunk) {
+      using Output = typename std::invoke_result_t<RenderItem, Item const &>::value_type;
+
+      int const numThreads = QThreadPool::globalInstance()->maxThreadCount();
+      if (items.size() < minItemsForParallel || numThreads <= 1) {
+         for (Item const & item : items) {
+            std::optional<Output> output = renderItem(item);
+            if (!output) {
+               return false;
+            }
+            writeItem(*output);
+         }
+         return true;
+      }
+
+      //
+      // Each chunk is rendered by one job.  The jobs only write into their own chunk (and its failure flag), so there
+      // is no need for any locking.
+      //
+      struct Chunk {
+         std::vector<Output> outputs;
+         bool failed = false;
+      };
+      int const recordsPerWave = itemsPerChunk * chunksPerThreadPerWave * numThreads;
+      QThreadPool threadPool;
+      threadPool.setMaxThreadCount(numThreads);
+      for (int waveStart = 0; waveStart < items.size(); waveStart += recordsPerWave) {
+         int const waveEnd = std::min(waveStart + recordsPerWave, static_cast<int>(items.size()));
+         std::vector<Chunk> chunks((waveEnd - waveStart + itemsPerChunk - 1) / itemsPerChunk);
+         for (std::size_t chunkNum = 0; chunkNum < chunks.size(); ++chunkNum) {
+            int const chunkStart = waveStart + static_cast<int>(chunkNum) * itemsPerChunk;
+            int const chunkEnd   = std::min(chunkStart + itemsPerChunk, waveEnd);
+            Chunk & chunk = chunks[chunkNum];
+            threadPool.start(QRunnable::create([&items, &renderItem, &chunk, chunkStart, chunkEnd]() {
+               chunk.outputs.reserve(chunkEnd - chunkStart);
+               for (int ii = chunkStart; ii < chunkEnd; ++ii) {
+                  std::optional<Output> output = renderItem(items.at(ii));
+                  if (!output) {
+                     chunk.failed = true;
+                     return;
+                  }
+                  chunk.outputs.push_back(std::move(*output));
+               }
+               return;
+            }));
+         }
+         threadPool.waitForDone();
+
+         for (Chunk const & chunk : chunks) {
+            for (Output const & output : chunk.outputs) {
+               writeItem(output);
+            }
+            if (chunk.failed) {
+               return false;
+            }
+         }
+      }
+      return true;
+   }
+}
+
+#endif
@@ -0,0 +1,97 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * utils/PoolAllocator.cpp is part of Brewtarget, and is copyright the following authors 2024:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#include "utils/PoolAllocator.h"
+
+#include <algorithm>
+
+#include <QtGlobal>
+
+namespace {
+   //! We aim for each slab to be about this size, subject to the minimum number of blocks below
+   constexpr std::size_t targetSlabSize = 64 * 1024;
+   constexpr std::size_t minBlocksPerSlab = 16;
+
+   std::size_t roundUpToMultiple(std::size_t const value, std::size_t const multiple) {
+      return ((value + multiple - 1) / multiple) * multiple;
+   }
+}
+
+FixedSizePool::FixedSizePool(std::size_t const blockSize, std::size_t const blockAlignment) :
+   // Each block needs to be big enough, and aligned enough, to hold the free list pointer when it's not in use.  Block
+   // size also has to be a multiple of the alignment so that every block in a slab is correctly aligned.
+   m_blockAlignment{std::max(blockAlignment, alignof(void *))},
+   m_blockSize{roundUpToMultiple(std::max(blockSize, sizeof(void *)), this->m_blockAlignment)},
+   m_blocksPerSlab{std::max(minBlocksPerSlab, targetSlabSize / this->m_blockSize)},
+   m_mutex{},
+   m_slabs{},
+   m_freeList{nullptr},
+   m_numBlocksInUse{0} {
+   return;
+}
+
+FixedSizePool::~FixedSizePool() {
+   // It's a coding error to destroy the pool while some of its blocks are still in use
+   Q_ASSERT(this->m_numBlocksInUse == 0);
+   for (void * slab : this->m_slabs) {
+      ::operator delete(slab, std::align_val_t{this->m_blockAlignment});
+   }
+   return;
+}
+
+void FixedSizePool::addSlab() {
+   // Caller should already hold the mutex
+   auto * slab = static_cast<std::byte *>(
+      ::operator new(this->m_blockSize * this->m_blocksPerSlab, std::align_val_t{this->m_blockAlignment})
+   );
+   this->m_slabs.push_back(slab);
+   //
+   // Thread the new blocks onto the free list in reverse order, so that they come back out in address order, which
+   // means objects created one after another end up next to each other.
+   //
+   for (std::size_t ii = this->m_blocksPerSlab; ii > 0; --ii) {
+      void * block = slab + (ii - 1) * this->m_blockSize;
+      *static_cast<void **>(block) = this->m_freeList;
+      this->m_freeList = block;
+   }
+   return;
+}
+
+void * FixedSizePool::allocate() {
+   std::lock_guard<std::mutex> lock(this->m_mutex);
+   if (!this->m_freeList) {
+      this->addSlab();
+   }
+   void * block = this->m_freeList;
+   this->m_freeList = *static_cast<void **>(block);
+   ++this->m_numBlocksInUse;
+   return block;
+}
+
+void FixedSizePool::deallocate(void * block) {
+   if (!block) {
+      return;
+   }
+   std::lock_guard<std::mutex> lock(this->m_mutex);
+   *static_cast<void **>(block) = this->m_freeList;
+   this->m_freeList = block;
+   --this->m_numBlocksInUse;
+   return;
+}
+
+std::size_t FixedSizePool::numBlocksInUse() const {
+   std::lock_guard<std::mutex> lock(this->m_mutex);
+   return this->m_numBlocksInUse;
+}
@@ -0,0 +1,117 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * utils/PoolAllocator.h is part of Brewtarget, and is copyright the following authors 2024:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#ifndef UTILS_POOLALLOCATOR_H
+#define UTILS_POOLALLOCATOR_H
+#pragma once
+
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <vector>
+
+#include "utils/NoCopy.h"
+
+/**
+ * \brief A pool of fixed-size memory blocks, carved out of larger "slabs" so that we make one heap allocation per slab
+ *        rather than one per block, and so that blocks allocated one after another (eg objects created while loading a
+ *        DB table) sit next to each other in memory.
+ *
+ *        Freed blocks go on a free list for reuse.  Slabs are never given back to the heap, which is fine for what we
+ *        use this for (objects cached by \c ObjectStore, whose number only grows much during the life of the program).
+ *
+ *        Thread-safe, because the last \c std::shared_ptr to an object can be released on any thread.
+ */
+class FixedSizePool {
+public:
+   FixedSizePool(std::size_t const blockSize, std::size_t const blockAlignment);
+   ~FixedSizePool();
+
+   void * allocate();
+   void deallocate(void * block);
+
+   //! \return Number of blocks currently allocated (ie not on the free list)
+   std::size_t numBlocksInUse() const;
+
+private:
+   void addSlab();
+
+   std::size_t const m_blockAlignment;
+   std::size_t const m_blockSize;
+   std::size_t const m_blocksPerSlab;
+   mutable std::mutex m_mutex;
+   std::vector<void *> m_slabs;
+   //! Each free block holds a pointer to the next one
+   void * m_freeList;
+   std::size_t m_numBlocksInUse;
+
+   // Insert all the usual boilerplate to prevent copy/assignment/move
+   NO_COPY_DECLARATIONS(FixedSizePool)
+};
+
+/**
+ * \brief Standard-library-compatible allocator that takes single objects from a \c FixedSizePool shared by all
+ *        allocators of the same type.  The intended use is with \c std::allocate_shared, eg
+ *
+ *           std::shared_ptr<Hop> hop = std::allocate_shared<Hop>(PoolAllocator<Hop>{}, namedParameterBundle);
+ *
+ *        Note that \c std::allocate_shared rebinds the allocator to its internal control block type (which holds the
+ *        object and the reference counts), so the pool that gets used is that of the control block type.  That's what
+ *        we want, as it means object and reference counts come out of one block.
+ *
+ *        Requests for more than one object (which \c std::allocate_shared never makes) go to the normal heap.
+ */
+template<class T>
+class PoolAllocator {
+public:
+   using value_type = T;
+
+   PoolAllocator() noexcept = default;
+   template<class U> PoolAllocator(PoolAllocator<U> const &) noexcept {
+      return;
+   }
+
+   T * allocate(std::size_t const numObjects) {
+      if (numObjects == 1) {
+         return static_cast<T *>(PoolAllocator::pool().allocate());
+      }
+      return static_cast<T *>(::operator new(numObjects * sizeof(T), std::align_val_t{alignof(T)}));
+   }
+
+   void deallocate(T * const object, std::size_t const numObjects) noexcept {
+      if (numObjects == 1) {
+         PoolAllocator::pool().deallocate(object);
+         return;
+      }
+      ::operator delete(object, std::align_val_t{alignof(T)});
+      return;
+   }
+
+   //! All allocators share the same pool(s), so any two are interchangeable
+   template<class U> bool operator==(PoolAllocator<U> const &) const noexcept { return true; }
+   template<class U> bool operator!=(PoolAllocator<U> const &) const noexcept { return false; }
+
+private:
+   static FixedSizePool & pool() {
+      //
+      // The pool is deliberately never destroyed, because objects allocated from it can be held by shared pointers in
+      // other static objects (eg ObjectStore singletons) whose destruction order relative to this we don't control.
+      //
+      static FixedSizePool * const fixedSizePool = new FixedSizePool{sizeof(T), alignof(T)};
+      return *fixedSizePool;
+   }
+};
+
+#endif
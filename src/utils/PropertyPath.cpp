@@ -15,8 +15,75 @@
  ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
 #include "utils/PropertyPath.h"
 
+#include <functional>
+#include <unordered_map>
+#include <utility>
+
+#include <QMetaProperty>
+
 #include "model/NamedEntity.h"
 
+namespace {
+   /**
+    * \brief What we need to know about one property of one class to follow a \c PropertyPath through it without any
+    *        name-based look-ups
+    */
+   struct ResolvedProperty {
+      QMetaProperty metaProperty;
+      //! Only filled in (on demand) for properties that are not at the end of a path
+      TypeInfo const * typeInfo = nullptr;
+   };
+
+   using ClassAndProperty = std::pair<QMetaObject const *, char const *>;
+
+   struct ClassAndPropertyHash {
+      std::size_t operator()(ClassAndProperty const & key) const noexcept {
+         return std::hash<QMetaObject const *>{}(key.first) ^ (std::hash<char const *>{}(key.second) << 1);
+      }
+   };
+
+   /**
+    * \brief Resolves \c property on the class of \c ne, the first time we see that combination of class and property,
+    *        and returns the cached answer thereafter.
+    *
+    *        Without this, each step of each get or set does a string search of the class's meta-object properties
+    *        (\c QMetaObject::indexOfProperty, and again inside \c QObject::property or \c QObject::setProperty), which
+    *        adds up when we're serialising or displaying every field of every record.  Since \c BtStringConst strings
+    *        are interned, the property name pointer identifies the property.
+    *
+    *        The cache is per-thread (file validation during import runs on worker threads) so that it needs no locking.
+    *        Entries never go stale, as classes and their properties are fixed for the life of the program.
+    */
+   ResolvedProperty & resolve(NamedEntity const & ne, BtStringConst const & property) {
+      thread_local std::unordered_map<ClassAndProperty, ResolvedProperty, ClassAndPropertyHash> cache;
+
+      QMetaObject const * metaObject = ne.metaObject();
+      auto [entry, inserted] = cache.try_emplace(ClassAndProperty{metaObject, *property});
+      if (inserted) {
+         // It's a coding error if we're trying to get or set a non-existent property on the NamedEntity subclass for
+         // this record.
+         int const propertyIndex = metaObject->indexOfProperty(*property);
+         if (propertyIndex < 0) {
+            qCritical() << Q_FUNC_INFO << "No property" << *property << "on" << metaObject->className();
+            Q_ASSERT(false);
+         }
+         entry->second.metaProperty = metaObject->property(propertyIndex);
+      }
+      return entry->second;
+   }
+
+   /**
+    * \brief As \c resolve, but also ensures the \c TypeInfo is filled in
+    */
+   ResolvedProperty const & resolveWithTypeInfo(NamedEntity const & ne, BtStringConst const & property) {
+      ResolvedProperty & resolved = resolve(ne, property);
+      if (!resolved.typeInfo) {
+         resolved.typeInfo = &ne.getTypeLookup().getType(property);
+      }
+      return resolved;
+   }
+}
+
 PropertyPath::PropertyPath(BtStringConst const & singleProperty) :
    m_properties{1, &singleProperty}, m_path{*singleProperty} {
    return;
@@ -99,12 +166,7 @@ TypeInfo const & PropertyPath::getTypeInfo(TypeLookup const & baseTypeLookup) co
    for (auto const property : this->m_properties) {
       if (property == this->m_properties.last()) {
 
-         // It's a coding error if we're trying to set a non-existent property on the NamedEntity subclass for this
-         // record.
-         QMetaObject const * neMetaObject = ne->metaObject();
-         int propertyIndex = neMetaObject->indexOfProperty(**property);
-         Q_ASSERT(propertyIndex >= 0);
-         QMetaProperty neMetaProperty = neMetaObject->property(propertyIndex);
+         QMetaProperty const & neMetaProperty = resolve(*ne, *property).metaProperty;
 
       // Normally keep this log statement commented out otherwise it generates too many lines in the log file
 //         qDebug() <<
@@ -113,7 +175,7 @@ TypeInfo const & PropertyPath::getTypeInfo(TypeLookup const & baseTypeLookup) co
 //            "; writable =" << neMetaProperty.isWritable();
 
          if (neMetaProperty.isWritable()) {
-            bool succeeded = ne->setProperty(**property, val);
+            bool succeeded = neMetaProperty.write(ne, val);
             if (!succeeded) {
                // Caller needs to decide what to do, but we assume it's a coding error that the property could not be
                // set.
@@ -144,17 +206,12 @@ QVariant PropertyPath::getValue(NamedEntity const & obj) const {
          //
          // We've chained through the properties and found the end one that we want the actual value of
          //
-         QMetaObject const * neMetaObject = ne->metaObject();
-         // Uncomment the next line if the assert below is firing
+         // Uncomment the next line if the assert in resolve() is firing
 //         qDebug() <<
 //            Q_FUNC_INFO << "Request to get" << this->m_path << "on" << obj.metaObject()->className() << "(=" <<
 //            *property << "on" << ne->metaObject()->className() << ")";
 
-         // It's a coding error if we're trying to get a non-existent property on the NamedEntity subclass for this
-         // record.
-         int propertyIndex = neMetaObject->indexOfProperty(**property);
-         Q_ASSERT(propertyIndex >= 0);
-         QMetaProperty neMetaProperty = neMetaObject->property(propertyIndex);
+         QMetaProperty const & neMetaProperty = resolve(*ne, *property).metaProperty;
 
          // Normally keep this log statement commented out otherwise it generates too many lines in the log file
 //         qDebug() <<
@@ -163,12 +220,11 @@ QVariant PropertyPath::getValue(NamedEntity const & obj) const {
 //            "; readable =" << neMetaProperty.isReadable();
 
          if (neMetaProperty.isReadable()) {
-            retVal = ne->property(**property);
+            retVal = neMetaProperty.read(ne);
             if (!retVal.isValid()) {
-               auto mo = ne->metaObject();
                qWarning() <<
-                  Q_FUNC_INFO << "Property" << *property << "on" << mo->className() << "#" << ne->key() <<
-                  "not readable.  Property Index =" << mo->indexOfProperty(**property);
+                  Q_FUNC_INFO << "Property" << *property << "on" << ne->metaObject()->className() << "#" <<
+                  ne->key() << "not readable.  Property Index =" << neMetaProperty.propertyIndex();
             }
          }
          break;
@@ -187,8 +243,9 @@ QVariant PropertyPath::getValue(NamedEntity const & obj) const {
       // complicated and we need some help from TypeInfo to obtain a `NamedEntity *`.  Either way, we need to get the
       // TypeInfo object first to find out what sort of pointer we're dealing with.
       //
-      QVariant containedNe = ne->property(**property);
-      TypeInfo const & typeInfo = ne->getTypeLookup().getType(*property);
+      ResolvedProperty const & resolved = resolveWithTypeInfo(*ne, *property);
+      QVariant containedNe = resolved.metaProperty.read(ne);
+      TypeInfo const & typeInfo = *resolved.typeInfo;
       switch (typeInfo.pointerType) {
          case TypeInfo::PointerType::RawPointer:
             // In this case, what we are expecting inside the containedNe QVariant is `NamedEntity *`.  It's OK for
@@ -0,0 +1,57 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * utils/StringPool.cpp is part of Brewtarget, and is copyright the following authors 2024:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#include "utils/StringPool.h"
+
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSet>
+
+namespace {
+   //
+   // Roughly, the header Qt allocates alongside the characters of each string buffer.  We don't need to be exact, as
+   // this is only used for the memory-saved statistic.
+   //
+   constexpr qint64 bufferOverheadBytes = 24;
+
+   QMutex poolMutex;
+   QSet<QString> pool;
+   StringPool::Statistics poolStatistics;
+}
+
+QString StringPool::intern(QString const & text) {
+   // Null and empty strings don't allocate anyway
+   if (text.isEmpty()) {
+      return text;
+   }
+
+   QMutexLocker locker(&poolMutex);
+   ++poolStatistics.lookups;
+   auto existing = pool.constFind(text);
+   if (existing == pool.cend()) {
+      pool.insert(text);
+      ++poolStatistics.distinctStrings;
+      return text;
+   }
+   if (existing->constData() != text.constData()) {
+      poolStatistics.bytesSaved += static_cast<qint64>(sizeof(QChar)) * (text.size() + 1) + bufferOverheadBytes;
+   }
+   return *existing;
+}
+
+StringPool::Statistics StringPool::statistics() {
+   QMutexLocker locker(&poolMutex);
+   return poolStatistics;
+}
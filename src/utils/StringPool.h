@@ -0,0 +1,52 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * utils/StringPool.h is part of Brewtarget, and is copyright the following authors 2024:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#ifndef UTILS_STRINGPOOL_H
+#define UTILS_STRINGPOOL_H
+#pragma once
+
+#include <QString>
+#include <QtGlobal>
+
+/**
+ * \brief Pool of interned strings, so that the same text read many times (eg the origin, supplier, notes etc of all the
+ *        child copies of an ingredient, or of the same ingredient in many imported recipes) is held in one implicitly
+ *        shared \c QString buffer rather than one allocation per copy.
+ *
+ *        Strings stay in the pool for the life of the program, but, since the pool's copy shares its buffer with all
+ *        the objects using the text, this costs little more than the pool's own hash table.
+ *
+ *        Thread-safe, as the DB and import code that uses it can run on worker threads.
+ */
+namespace StringPool {
+
+   /**
+    * \return A string equal to \c text, sharing its buffer with every other string returned for the same text
+    */
+   QString intern(QString const & text);
+
+   struct Statistics {
+      //! Number of different strings in the pool
+      qint64 distinctStrings = 0;
+      //! Number of calls to \c intern
+      qint64 lookups         = 0;
+      //! Memory not allocated because \c intern returned a shared buffer instead of the caller keeping its own copy
+      qint64 bytesSaved      = 0;
+   };
+
+   Statistics statistics();
+}
+
+#endif
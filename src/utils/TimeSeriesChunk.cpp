@@ -0,0 +1,312 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * utils/TimeSeriesChunk.cpp is part of Brewtarget, and is copyright the following authors 2024:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#include "utils/TimeSeriesChunk.h"
+
+#include <algorithm>
+#include <bit>
+#include <limits>
+
+namespace {
+   //
+   // Buckets for the timestamp delta of delta: a prefix of 1s terminated by a 0 (or, for the last bucket, just four
+   // 1s), then the value in the given number of bits, offset so that it's non-negative.  A zero delta of delta is
+   // just the single bit 0.
+   //
+   struct DeltaOfDeltaBucket {
+      int prefix;
+      int prefixBits;
+      int valueBits;
+   };
+   DeltaOfDeltaBucket constexpr deltaOfDeltaBuckets[] {
+      {0b10  , 2,  7},
+      {0b110 , 3,  9},
+      {0b1110, 4, 12},
+      {0b1111, 4, 64},
+   };
+
+   //! Number of bits used to store the number of leading zeros of a value XOR.  (Counts above 31 are stored as 31.)
+   int constexpr leadingZeroBits = 5;
+   //! Number of bits used to store the length, less one, of the meaningful bits of a value XOR
+   int constexpr meaningfulLengthBits = 6;
+
+   class BitWriter {
+   public:
+      //! \param numBits must be between 1 and 64
+      void write(quint64 const value, int const numBits) {
+         quint64 const masked = numBits == 64 ? value : value & ((quint64{1} << numBits) - 1);
+         int const freeBits = 64 - this->m_usedBits;
+         if (numBits <= freeBits) {
+            this->m_word |= masked << (freeBits - numBits);
+            this->m_usedBits += numBits;
+         } else {
+            int const overflowBits = numBits - freeBits;
+            this->m_word |= masked >> overflowBits;
+            this->m_usedBits = 64;
+            this->flushWord();
+            this->m_word = masked << (64 - overflowBits);
+            this->m_usedBits = overflowBits;
+         }
+         if (this->m_usedBits == 64) {
+            this->flushWord();
+         }
+         return;
+      }
+
+      QByteArray finish() {
+         for (int shift = 56; this->m_usedBits > 0; shift -= 8, this->m_usedBits -= 8) {
+            this->m_data.append(static_cast<char>(this->m_word >> shift));
+         }
+         return this->m_data;
+      }
+
+   private:
+      void flushWord() {
+         for (int shift = 56; shift >= 0; shift -= 8) {
+            this->m_data.append(static_cast<char>(this->m_word >> shift));
+         }
+         this->m_word = 0;
+         this->m_usedBits = 0;
+         return;
+      }
+
+      QByteArray m_data;
+      quint64 m_word = 0;
+      int m_usedBits = 0;
+   };
+
+   class BitReader {
+   public:
+      BitReader(QByteArray const & data) :
+         m_data{reinterpret_cast<unsigned char const *>(data.constData())},
+         m_numBits{static_cast<qint64>(data.size()) * 8} {
+         return;
+      }
+
+      //! \return \c false if there are fewer than \c numBits bits left
+      bool read(int const numBits, quint64 & value) {
+         if (this->m_bitPosition + numBits > this->m_numBits) {
+            return false;
+         }
+         value = 0;
+         for (int remaining = numBits; remaining > 0; ) {
+            int const bitInByte = static_cast<int>(this->m_bitPosition & 7);
+            int const numToTake = std::min(8 - bitInByte, remaining);
+            unsigned int const byte = this->m_data[this->m_bitPosition >> 3];
+            value = (value << numToTake) | ((byte >> (8 - bitInByte - numToTake)) & ((1u << numToTake) - 1));
+            remaining -= numToTake;
+            this->m_bitPosition += numToTake;
+         }
+         return true;
+      }
+
+      //! \return Number of consecutive 1 bits read (stopping after a 0 or after \c maxOnes), or -1 if we ran out
+      int readOnes(int const maxOnes) {
+         int numOnes = 0;
+         quint64 bit = 0;
+         while (numOnes < maxOnes) {
+            if (!this->read(1, bit)) {
+               return -1;
+            }
+            if (!bit) {
+               break;
+            }
+            ++numOnes;
+         }
+         return numOnes;
+      }
+
+   private:
+      unsigned char const * m_data;
+      qint64 const m_numBits;
+      qint64 m_bitPosition = 0;
+   };
+
+   //! Previous value of one series and the window of meaningful bits of its last stored XOR
+   struct ValueState {
+      quint64 previous     = 0;
+      int     leadingZeros = -1;
+      int     trailingZeros = 0;
+   };
+
+   void writeValue(BitWriter & writer, ValueState & state, double const value) {
+      quint64 const bits = std::bit_cast<quint64>(value);
+      quint64 const xorWithPrevious = bits ^ state.previous;
+      state.previous = bits;
+      if (xorWithPrevious == 0) {
+         writer.write(0b0, 1);
+         return;
+      }
+
+      int const leadingZeros = std::min(std::countl_zero(xorWithPrevious), (1 << leadingZeroBits) - 1);
+      int const trailingZeros = std::countr_zero(xorWithPrevious);
+      if (state.leadingZeros >= 0 && leadingZeros >= state.leadingZeros && trailingZeros >= state.trailingZeros) {
+         // The differing bits fit in the same window as last time, so we don't need to say where the window is
+         writer.write(0b10, 2);
+         writer.write(xorWithPrevious >> state.trailingZeros, 64 - state.leadingZeros - state.trailingZeros);
+         return;
+      }
+
+      int const meaningfulLength = 64 - leadingZeros - trailingZeros;
+      writer.write(0b11, 2);
+      writer.write(static_cast<quint64>(leadingZeros), leadingZeroBits);
+      writer.write(static_cast<quint64>(meaningfulLength - 1), meaningfulLengthBits);
+      writer.write(xorWithPrevious >> trailingZeros, meaningfulLength);
+      state.leadingZeros = leadingZeros;
+      state.trailingZeros = trailingZeros;
+      return;
+   }
+
+   bool readValue(BitReader & reader, ValueState & state, double & value) {
+      int const prefixOnes = reader.readOnes(2);
+      if (prefixOnes < 0) {
+         return false;
+      }
+      if (prefixOnes == 1) {
+         if (state.leadingZeros < 0) {
+            return false;
+         }
+         quint64 meaningfulBits = 0;
+         if (!reader.read(64 - state.leadingZeros - state.trailingZeros, meaningfulBits)) {
+            return false;
+         }
+         state.previous ^= meaningfulBits << state.trailingZeros;
+      } else if (prefixOnes == 2) {
+         quint64 leadingZeros = 0;
+         quint64 meaningfulLengthLessOne = 0;
+         quint64 meaningfulBits = 0;
+         if (!reader.read(leadingZeroBits, leadingZeros) ||
+             !reader.read(meaningfulLengthBits, meaningfulLengthLessOne)) {
+            return false;
+         }
+         int const meaningfulLength = static_cast<int>(meaningfulLengthLessOne) + 1;
+         int const trailingZeros = 64 - static_cast<int>(leadingZeros) - meaningfulLength;
+         if (trailingZeros < 0 || !reader.read(meaningfulLength, meaningfulBits)) {
+            return false;
+         }
+         state.previous ^= meaningfulBits << trailingZeros;
+         state.leadingZeros = static_cast<int>(leadingZeros);
+         state.trailingZeros = trailingZeros;
+      }
+      value = std::bit_cast<double>(state.previous);
+      return true;
+   }
+}
+
+QByteArray TimeSeriesChunk::encode(TimeSeriesChunk::Columns const & columns) {
+   int const numReadings = columns.timestamps_ms.size();
+   int const numSeries = columns.values.size();
+   // It's a coding error if the columns are not all the same length
+   Q_ASSERT(numReadings > 0);
+   Q_ASSERT(std::all_of(columns.values.cbegin(), columns.values.cend(), [numReadings](QVector<double> const & series) {
+      return series.size() == numReadings;
+   }));
+
+   BitWriter writer;
+   writer.write(static_cast<quint64>(numReadings), 32);
+   writer.write(static_cast<quint64>(numSeries), 8);
+   writer.write(static_cast<quint64>(columns.timestamps_ms[0]), 64);
+
+   QVector<ValueState> valueStates(numSeries);
+   for (int seriesIndex = 0; seriesIndex < numSeries; ++seriesIndex) {
+      double const value = columns.values[seriesIndex][0];
+      writer.write(std::bit_cast<quint64>(value), 64);
+      valueStates[seriesIndex].previous = std::bit_cast<quint64>(value);
+   }
+
+   qint64 previousDelta = 0;
+   for (int ii = 1; ii < numReadings; ++ii) {
+      qint64 const delta = columns.timestamps_ms[ii] - columns.timestamps_ms[ii - 1];
+      qint64 const deltaOfDelta = delta - previousDelta;
+      previousDelta = delta;
+      if (deltaOfDelta == 0) {
+         writer.write(0b0, 1);
+      } else {
+         for (auto const & bucket : deltaOfDeltaBuckets) {
+            qint64 const offset = bucket.valueBits == 64 ? 0 : (qint64{1} << (bucket.valueBits - 1)) - 1;
+            qint64 const maxValue = bucket.valueBits == 64 ? std::numeric_limits<qint64>::max() : offset + 1;
+            if (bucket.valueBits == 64 || (deltaOfDelta >= -offset && deltaOfDelta <= maxValue)) {
+               writer.write(static_cast<quint64>(bucket.prefix), bucket.prefixBits);
+               writer.write(static_cast<quint64>(deltaOfDelta + offset), bucket.valueBits);
+               break;
+            }
+         }
+      }
+
+      for (int seriesIndex = 0; seriesIndex < numSeries; ++seriesIndex) {
+         writeValue(writer, valueStates[seriesIndex], columns.values[seriesIndex][ii]);
+      }
+   }
+   return writer.finish();
+}
+
+bool TimeSeriesChunk::decode(QByteArray const & data, TimeSeriesChunk::Columns & columns) {
+   BitReader reader{data};
+   quint64 numReadings = 0;
+   quint64 numSeries = 0;
+   quint64 firstTimestamp = 0;
+   if (!reader.read(32, numReadings) || !reader.read(8, numSeries) || !reader.read(64, firstTimestamp)) {
+      return false;
+   }
+   // Every reading after the first takes at least one bit per series plus one for the timestamp
+   if (numReadings == 0 || (numReadings - 1) * (numSeries + 1) > static_cast<quint64>(data.size()) * 8) {
+      return false;
+   }
+
+   // Sizing the output up front means the loop below is just appends into memory we already have
+   int const size = static_cast<int>(numReadings);
+   columns.timestamps_ms.resize(size);
+   columns.values.resize(static_cast<int>(numSeries));
+   for (auto & series : columns.values) {
+      series.resize(size);
+   }
+   qint64 * timestamps = columns.timestamps_ms.data();
+
+   timestamps[0] = static_cast<qint64>(firstTimestamp);
+   QVector<ValueState> valueStates(static_cast<int>(numSeries));
+   for (int seriesIndex = 0; seriesIndex < static_cast<int>(numSeries); ++seriesIndex) {
+      if (!reader.read(64, valueStates[seriesIndex].previous)) {
+         return false;
+      }
+      columns.values[seriesIndex][0] = std::bit_cast<double>(valueStates[seriesIndex].previous);
+   }
+
+   qint64 previousDelta = 0;
+   for (int ii = 1; ii < size; ++ii) {
+      int const prefixOnes = reader.readOnes(4);
+      if (prefixOnes < 0) {
+         return false;
+      }
+      qint64 deltaOfDelta = 0;
+      if (prefixOnes > 0) {
+         auto const & bucket = deltaOfDeltaBuckets[prefixOnes - 1];
+         qint64 const offset = bucket.valueBits == 64 ? 0 : (qint64{1} << (bucket.valueBits - 1)) - 1;
+         quint64 storedValue = 0;
+         if (!reader.read(bucket.valueBits, storedValue)) {
+            return false;
+         }
+         deltaOfDelta = static_cast<qint64>(storedValue) - offset;
+      }
+      previousDelta += deltaOfDelta;
+      timestamps[ii] = timestamps[ii - 1] + previousDelta;
+
+      for (int seriesIndex = 0; seriesIndex < static_cast<int>(numSeries); ++seriesIndex) {
+         if (!readValue(reader, valueStates[seriesIndex], columns.values[seriesIndex][ii])) {
+            return false;
+         }
+      }
+   }
+   return true;
+}
@@ -0,0 +1,64 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * utils/TimeSeriesChunk.h is part of Brewtarget, and is copyright the following authors 2024:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#ifndef UTILS_TIMESERIESCHUNK_H
+#define UTILS_TIMESERIESCHUNK_H
+#pragma once
+
+#include <QByteArray>
+#include <QtGlobal>
+#include <QVector>
+
+/**
+ * \brief Compact encoding of a run of timestamped readings -- one timestamp and a fixed number of \c double values
+ *        per reading -- as used for fermentation sensor data (see \c SensorReadings).
+ *
+ *        This is the scheme from Facebook's "Gorilla" time series database (Pelkonen et al, VLDB 2015).  Timestamps
+ *        are stored as the change in the difference between successive timestamps ("delta of delta"), which, for
+ *        readings taken at regular intervals, is nearly always zero and so takes one bit.  Each value is XORed with
+ *        the previous value of the same series, and only the bits that differ are stored, which is usually a small
+ *        fraction of the 64 for slowly-changing quantities like gravity and temperature.  Typical sensor data comes out
+ *        at a byte or two per reading rather than the 24 we'd need uncompressed.
+ *
+ *        A missing value should be stored as NaN.
+ */
+namespace TimeSeriesChunk {
+
+   /**
+    * \brief Readings as columns (so callers can scan the timestamps without touching the values and vice versa).
+    *        \c values has one entry per series, each the same length as \c timestamps_ms.
+    */
+   struct Columns {
+      QVector<qint64>           timestamps_ms;
+      QVector<QVector<double> > values;
+   };
+
+   /**
+    * \brief Encode \c columns, which must have at least one reading, with timestamps in non-decreasing order.  (Out of
+    *        order timestamps still come back as they went in, but take more space.)
+    */
+   QByteArray encode(Columns const & columns);
+
+   /**
+    * \brief Decode data written by \c encode
+    *
+    * \return \c false if \c data is truncated or otherwise not valid, in which case the contents of \c columns are
+    *         undefined
+    */
+   bool decode(QByteArray const & data, Columns & columns);
+
+}
+
+#endif
@@ -0,0 +1,296 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * utils/Tracing.cpp is part of Brewtarget, and is copyright the following authors 2024:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#include "utils/Tracing.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+#include <QByteArray>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QVector>
+
+#include "config.h"
+#include "Logging.h"
+
+namespace {
+   //
+   // Layout of the trace file is:
+   //    FileHeader
+   //    Name table: maxNames × nameLength bytes, each entry a NUL-terminated span name
+   //    Ring buffer: recordCapacity × SpanRecord
+   //
+   char const fileMagic[8] = {'B', 'T', 'T', 'R', 'A', 'C', 'E', '1'};
+   quint32 constexpr fileVersion = 1;
+   quint32 constexpr maxNames = 128;
+   quint32 constexpr nameLength = 64;
+   // 64K records at 24 bytes each is 1.5MB, which is enough for a good few minutes of fairly heavy use
+   quint32 constexpr recordCapacity = 64 * 1024;
+
+   struct FileHeader {
+      char    magic[8];
+      quint32 version;
+      quint32 maxNames;
+      quint32 nameLength;
+      quint32 recordCapacity;
+      //! Wall clock time at which tracing started, so we can relate spans to log messages
+      qint64  startedAt_msecsSinceEpoch;
+   };
+
+   struct SpanRecord {
+      //! Nanoseconds since tracing started
+      qint64  start_ns;
+      qint64  duration_ns;
+      //! Index in the name table plus one, so that 0 means the slot has not been used
+      quint32 nameId;
+      quint32 threadNumber;
+   };
+
+   qint64 constexpr namesOffset   = sizeof(FileHeader);
+   qint64 constexpr recordsOffset = namesOffset + maxNames * nameLength;
+   qint64 constexpr fileSize      = recordsOffset + static_cast<qint64>(recordCapacity) * sizeof(SpanRecord);
+
+   std::atomic<bool> active{false};
+   QElapsedTimer clock;
+   QFile traceFile;
+   uchar * mappedFile = nullptr;
+   std::atomic<quint64> nextRecord{0};
+
+   //
+   // Name table lookup.  Each thread caches lookups by pointer, so it only has to take the mutex the first time it
+   // sees a particular span name.  The global table is keyed by content, as the same literal in different translation
+   // units need not have the same address.
+   //
+   QMutex namesMutex;
+   QHash<QByteArray, quint32> nameIds;
+   thread_local QHash<char const *, quint32> nameIdCache;
+
+   // Give each thread a small number, which is more readable in the trace viewer than a thread ID
+   std::atomic<quint32> nextThreadNumber{1};
+   thread_local quint32 const threadNumber = nextThreadNumber++;
+
+   SpanRecord * records() {
+      return reinterpret_cast<SpanRecord *>(mappedFile + recordsOffset);
+   }
+
+   char * nameEntry(quint32 const index) {
+      return reinterpret_cast<char *>(mappedFile + namesOffset + index * nameLength);
+   }
+
+   /**
+    * \return The ID to store in \c SpanRecord::nameId for \c name, or 0 if the name table is full
+    */
+   quint32 nameIdFor(char const * name) {
+      auto cached = nameIdCache.constFind(name);
+      if (cached != nameIdCache.cend()) {
+         return *cached;
+      }
+
+      QMutexLocker locker(&namesMutex);
+      QByteArray const nameBytes{name};
+      quint32 nameId = nameIds.value(nameBytes, 0);
+      if (nameId == 0 && static_cast<quint32>(nameIds.size()) < maxNames) {
+         quint32 const index = nameIds.size();
+         std::strncpy(nameEntry(index), name, nameLength - 1);
+         nameId = index + 1;
+         nameIds.insert(nameBytes, nameId);
+      }
+      nameIdCache.insert(name, nameId);
+      return nameId;
+   }
+
+}
+
+QString Tracing::defaultTraceFilePath() {
+   return Logging::getDirectory().filePath(QString{"%1.trace"}.arg(CONFIG_APPLICATION_NAME_LC));
+}
+
+bool Tracing::start(QString const & traceFilePath) {
+   if (active) {
+      return true;
+   }
+
+   // Keep the trace from the last run, as that's probably the one with the problem in it
+   if (QFile::exists(traceFilePath)) {
+      QFileInfo const fileInfo{traceFilePath};
+      QString const previousFilePath =
+         fileInfo.dir().filePath(QString{"%1_previous.%2"}.arg(fileInfo.completeBaseName(), fileInfo.suffix()));
+      QFile::remove(previousFilePath);
+      if (!QFile::rename(traceFilePath, previousFilePath)) {
+         qWarning() << Q_FUNC_INFO << "Could not rename" << traceFilePath << "to" << previousFilePath;
+         QFile::remove(traceFilePath);
+      }
+   }
+
+   traceFile.setFileName(traceFilePath);
+   if (!traceFile.open(QIODevice::ReadWrite | QIODevice::Truncate)) {
+      qCritical() << Q_FUNC_INFO << "Could not open" << traceFilePath << ":" << traceFile.errorString();
+      return false;
+   }
+   // Resizing the file zero-fills it, so every record starts out as unused
+   if (!traceFile.resize(fileSize)) {
+      qCritical() << Q_FUNC_INFO << "Could not resize" << traceFilePath << ":" << traceFile.errorString();
+      traceFile.close();
+      return false;
+   }
+   mappedFile = traceFile.map(0, fileSize);
+   if (!mappedFile) {
+      qCritical() << Q_FUNC_INFO << "Could not memory-map" << traceFilePath << ":" << traceFile.errorString();
+      traceFile.close();
+      return false;
+   }
+
+   FileHeader header;
+   std::memcpy(header.magic, fileMagic, sizeof(header.magic));
+   header.version        = fileVersion;
+   header.maxNames       = maxNames;
+   header.nameLength     = nameLength;
+   header.recordCapacity = recordCapacity;
+   header.startedAt_msecsSinceEpoch = QDateTime::currentMSecsSinceEpoch();
+   std::memcpy(mappedFile, &header, sizeof(header));
+
+   //
+   // NB: We never unmap the file, because a span on another thread could always be just about to write to it.  The
+   //     mapping goes away, and the OS writes out whatever hasn't already been written, when the process exits.
+   //
+   clock.start();
+   active.store(true, std::memory_order_release);
+   qInfo() << Q_FUNC_INFO << "Tracing to" << traceFilePath;
+   return true;
+}
+
+bool Tracing::isActive() {
+   return active.load(std::memory_order_acquire);
+}
+
+bool Tracing::exportChromeTrace(QString const & traceFilePath, QString const & jsonFilePath) {
+   QFile inputFile{traceFilePath};
+   if (!inputFile.open(QIODevice::ReadOnly)) {
+      qCritical() << Q_FUNC_INFO << "Could not open" << traceFilePath << ":" << inputFile.errorString();
+      return false;
+   }
+   QByteArray const contents = inputFile.readAll();
+
+   FileHeader header;
+   if (contents.size() < static_cast<qint64>(sizeof(header))) {
+      qCritical() << Q_FUNC_INFO << traceFilePath << "is too short to be a trace file";
+      return false;
+   }
+   std::memcpy(&header, contents.constData(), sizeof(header));
+   if (std::memcmp(header.magic, fileMagic, sizeof(header.magic)) != 0 || header.version != fileVersion) {
+      qCritical() << Q_FUNC_INFO << traceFilePath << "is not a trace file we can read";
+      return false;
+   }
+   qint64 const namesStart   = sizeof(FileHeader);
+   qint64 const recordsStart = namesStart + static_cast<qint64>(header.maxNames) * header.nameLength;
+   qint64 const expectedSize =
+      recordsStart + static_cast<qint64>(header.recordCapacity) * static_cast<qint64>(sizeof(SpanRecord));
+   if (contents.size() < expectedSize) {
+      qCritical() << Q_FUNC_INFO << traceFilePath << "is truncated (" << contents.size() << "bytes)";
+      return false;
+   }
+
+   QVector<QString> names;
+   names.reserve(header.maxNames);
+   for (quint32 ii = 0; ii < header.maxNames; ++ii) {
+      char const * entry = contents.constData() + namesStart + ii * header.nameLength;
+      names.append(QString::fromLatin1(entry, static_cast<int>(qstrnlen(entry, header.nameLength))));
+   }
+
+   QVector<SpanRecord> spans;
+   spans.reserve(header.recordCapacity);
+   for (quint32 ii = 0; ii < header.recordCapacity; ++ii) {
+      SpanRecord record;
+      std::memcpy(&record, contents.constData() + recordsStart + ii * sizeof(SpanRecord), sizeof(record));
+      if (record.nameId != 0 && record.nameId <= header.maxNames) {
+         spans.append(record);
+      }
+   }
+   // The ring buffer will have wrapped round if there were lots of spans, so get them back into time order
+   std::sort(spans.begin(), spans.end(), [](SpanRecord const & lhs, SpanRecord const & rhs) {
+      return lhs.start_ns < rhs.start_ns;
+   });
+
+   //
+   // See https://docs.google.com/document/d/1CvAClvFfyA5R-PhYUmn5OOQtYMH4h6I0nSsKchNAySU for the format.  "X" events
+   // are "complete" events, ie ones with a start and a duration.  Timestamps are in microseconds.
+   //
+   QJsonArray traceEvents;
+   for (SpanRecord const & span : spans) {
+      traceEvents.append(QJsonObject{
+         {"name", names.at(span.nameId - 1)},
+         {"ph"  , "X"},
+         {"ts"  , static_cast<double>(span.start_ns   ) / 1000.0},
+         {"dur" , static_cast<double>(span.duration_ns) / 1000.0},
+         {"pid" , 1},
+         {"tid" , static_cast<qint64>(span.threadNumber)},
+      });
+   }
+   QJsonObject const trace{
+      {"traceEvents", traceEvents},
+      {"displayTimeUnit", "ms"},
+      {"otherData", QJsonObject{
+         {"startedAt", QDateTime::fromMSecsSinceEpoch(header.startedAt_msecsSinceEpoch).toString(Qt::ISODateWithMs)}
+      }},
+   };
+
+   QFile outputFile{jsonFilePath};
+   if (!outputFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+      qCritical() << Q_FUNC_INFO << "Could not open" << jsonFilePath << "for writing:" << outputFile.errorString();
+      return false;
+   }
+   outputFile.write(QJsonDocument{trace}.toJson(QJsonDocument::Compact));
+   qInfo() << Q_FUNC_INFO << "Exported" << spans.size() << "spans from" << traceFilePath << "to" << jsonFilePath;
+   return true;
+}
+
+Tracing::Span::Span(char const * name) :
+   m_name{name},
+   m_start_ns{active.load(std::memory_order_acquire) ? clock.nsecsElapsed() : -1} {
+   return;
+}
+
+Tracing::Span::~Span() {
+   if (this->m_start_ns < 0) {
+      return;
+   }
+   qint64 const duration_ns = clock.nsecsElapsed() - this->m_start_ns;
+   quint32 const nameId = nameIdFor(this->m_name);
+   if (nameId == 0) {
+      return;
+   }
+
+   // If the ring has wrapped round, we're overwriting the oldest record, which is what we want
+   SpanRecord & record = records()[nextRecord.fetch_add(1, std::memory_order_relaxed) % recordCapacity];
+   // Clear the name first so that, if we crash part way through, the export skips the part-written record
+   record.nameId       = 0;
+   record.start_ns     = this->m_start_ns;
+   record.duration_ns  = duration_ns;
+   record.threadNumber = threadNumber;
+   record.nameId       = nameId;
+   return;
+}
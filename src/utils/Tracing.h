@@ -0,0 +1,86 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * utils/Tracing.h is part of Brewtarget, and is copyright the following authors 2024:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#ifndef UTILS_TRACING_H
+#define UTILS_TRACING_H
+#pragma once
+
+#include <QtGlobal>
+#include <QString>
+
+/**
+ * \brief Optional, low-overhead tracing of how long the main hot paths take, for when the text log isn't enough to
+ *        see where the time went (eg when a user reports that the app froze for a few seconds).
+ *
+ *        Code to be traced creates a \c Tracing::Span on the stack.  When tracing is off, this costs one atomic load.
+ *        When it is on, the span's start time, duration, name and thread are written, as one fixed-size record, to a
+ *        memory-mapped ring buffer file.  There's no locking on this path, and, because the file is memory-mapped, the
+ *        records survive the application crashing or being killed.  Once the ring is full, the oldest records are
+ *        overwritten, so the file always holds the most recent activity.
+ *
+ *        The trace file can be converted to Chrome's trace-event JSON format (viewable in chrome://tracing or
+ *        https://ui.perfetto.dev) with \c exportChromeTrace (which is what the --export-trace command-line option
+ *        does).  The trace file uses native byte order, so it's meant to be exported on the machine that wrote it.
+ */
+namespace Tracing {
+
+   /**
+    * \return Where we write the trace file by default -- which is alongside the log files
+    */
+   QString defaultTraceFilePath();
+
+   /**
+    * \brief Start tracing to \c traceFilePath.  Any existing file of that name is renamed with a "_previous" suffix
+    *        first, so that starting the app again after a crash doesn't immediately lose the trace of what happened.
+    *
+    *        Tracing then stays on until the application exits.
+    *
+    * \return \c true if succeeded, \c false otherwise (in which case an error will have been logged)
+    */
+   bool start(QString const & traceFilePath);
+
+   /**
+    * \return \c true if \c start has been called successfully
+    */
+   bool isActive();
+
+   /**
+    * \brief Write out the records in the trace file \c traceFilePath as Chrome trace-event JSON to \c jsonFilePath
+    *
+    * \return \c true if succeeded, \c false otherwise (in which case an error will have been logged)
+    */
+   bool exportChromeTrace(QString const & traceFilePath, QString const & jsonFilePath);
+
+   /**
+    * \brief RAII object that records the time between its construction and destruction as a span in the trace (if we
+    *        are tracing).
+    */
+   class Span {
+   public:
+      /**
+       * \param name Must be a string literal (or otherwise live for the duration of the program), as we only store
+       *             the pointer.  Use the fully-qualified function name, eg "ObjectStore::loadAll", as this is what
+       *             shows up in the trace viewer.
+       */
+      Span(char const * name);
+      ~Span();
+   private:
+      char const * const m_name;
+      //! Nanoseconds since tracing started, or -1 if tracing was not active when the span started
+      qint64 m_start_ns;
+   };
+}
+
+#endif
@@ -51,28 +51,37 @@ TypeLookup::TypeLookup(char       const * const
                        std::initializer_list<TypeLookup const *>                parentClassLookups) :
    m_className{className},
    m_lookupMap{initializerList},
-   m_parentClassLookups{parentClassLookups} {
+   m_parentClassLookups{parentClassLookups},
+   m_flattenOnce{},
+   m_flattened{} {
    return;
 }
 
-TypeInfo const * TypeLookup::typeInfoFor(BtStringConst const & propertyName) const {
-   auto match = std::find_if(
-      this->m_lookupMap.begin(),
-      this->m_lookupMap.end(),
-      [& propertyName](auto const & record) { return propertyName == *record.first; }
-   );
-
-   if (match != this->m_lookupMap.end()) {
-      return &match->second;
-   }
-
-   for (auto parentClassLookup : this->m_parentClassLookups) {
-      auto result = parentClassLookup->typeInfoFor(propertyName);
-      if (result) {
-         return result;
+TypeLookup::FlattenedLookup const & TypeLookup::flattened() const {
+   std::call_once(this->m_flattenOnce, [this]() {
+      //
+      // Our own properties come first, then those of each parent class in turn, so, if a name appears more than once,
+      // try_emplace keeps the same one that a search of this class and then its parents would find.
+      //
+      for (auto const & [propertyName, typeInfo] : this->m_lookupMap) {
+         this->m_flattened.try_emplace(**propertyName, &typeInfo);
       }
-   }
+      for (TypeLookup const * parentClassLookup : this->m_parentClassLookups) {
+         for (auto const & [propertyName, typeInfo] : parentClassLookup->flattened()) {
+            this->m_flattened.try_emplace(propertyName, typeInfo);
+         }
+      }
+      return;
+   });
+   return this->m_flattened;
+}
 
+TypeInfo const * TypeLookup::typeInfoFor(BtStringConst const & propertyName) const {
+   FlattenedLookup const & lookup = this->flattened();
+   auto const match = lookup.find(*propertyName);
+   if (match != lookup.end()) {
+      return match->second;
+   }
    return nullptr;
 }
 
@@ -19,10 +19,12 @@
 
 #include <concepts>
 #include <map>
+#include <mutex>        // For std::once_flag
 #include <optional>
 #include <typeindex>
 #include <typeinfo>
 #include <type_traits>
+#include <unordered_map>
 #include <vector>
 
 #include "BtFieldType.h"
@@ -230,13 +232,32 @@ public:
 
 private:
    /**
-    * \brief Used by \c getType when doing parent class lookup
+    * \brief Used by \c getType
     */
    TypeInfo const * typeInfoFor(BtStringConst const & propertyName) const;
 
+   /**
+    * \brief All the properties of the class, including inherited ones, so that lookups are a single hash table look-up
+    *        rather than a search of this class's map and then (recursively) those of its parent classes.
+    *
+    *        The key is the interned pointer held by the \c BtStringConst, rather than the address of the
+    *        \c BtStringConst itself, as the latter differs between translation units (see comments in
+    *        utils/BtStringConst.h).
+    */
+   using FlattenedLookup = std::unordered_map<char const *, TypeInfo const *>;
+
+   /**
+    * \brief Returns \c m_flattened, building it first if necessary.  We can't build it in the constructor, because
+    *        the parent classes' \c TypeLookup objects are static objects in other translation units, so might not have
+    *        been constructed yet.
+    */
+   FlattenedLookup const & flattened() const;
+
    char const * const m_className;
    LookupMap const m_lookupMap;
    std::vector<TypeLookup const *> const m_parentClassLookups;
+   mutable std::once_flag m_flattenOnce;
+   mutable FlattenedLookup m_flattened;
 };
 
 /**
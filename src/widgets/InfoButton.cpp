@@ -48,7 +48,7 @@ namespace {
       // QFonts are specified in point size, so the hard-coded numbers are fine here, even on HDPI displays
       // Note that if QFont::Black is specified as third parameter to QFont constructor, it is a weight (beyond
       // ExtraBold) not a colour!  Final (boolean) parameter is whether or not the font should be italic.
-      static QFont const displayFont{Fonts::getInstance().TexGyreSchola_BoldItalic, 11, QFont::Bold, true};
+      static QFont const displayFont{Fonts::TexGyreSchola_BoldItalic(), 11, QFont::Bold, true};
       return displayFont;
    }
 }
@@ -98,6 +98,7 @@ void SmartAmounts::setForcedSystemOfMeasurement(char const * const owningWindowN
                                  owningWindowName,
                                  PersistentSettings::Extension::UNIT);
    }
+   Measurement::displaySettingsChanged();
    return;
 }
 
@@ -114,6 +115,7 @@ void SmartAmounts::setForcedRelativeScale(char const * const owningWindowName,
                                  owningWindowName,
                                  PersistentSettings::Extension::SCALE);
    }
+   Measurement::displaySettingsChanged();
    return;
 }
 